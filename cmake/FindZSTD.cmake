@@ -0,0 +1,26 @@
+# - Try to find the Zstandard library
+# This module defines:
+#  ZSTD_FOUND            - system has the Zstandard library
+#  ZSTD_INCLUDE_DIR      - the Zstandard include directory
+#  ZSTD_LIBRARIES        - Link these to use Zstandard
+
+include(FindPackageHandleStandardArgs)
+
+find_path(ZSTD_INCLUDE_DIR
+  NAMES zstd.h
+  HINTS ENV ZSTD_INC_DIR
+        ENV ZSTD_DIR
+        $ENV{ZSTD_DIR}/include
+  PATH_SUFFIXES include
+  DOC "The directory containing the Zstandard header files"
+)
+
+find_library(ZSTD_LIBRARIES NAMES zstd libzstd
+  HINTS ENV ZSTD_LIB_DIR
+        ENV ZSTD_DIR
+        $ENV{ZSTD_DIR}/lib
+  PATH_SUFFIXES lib
+  DOC "Path to the Zstandard library"
+)
+
+find_package_handle_standard_args(ZSTD "DEFAULT_MSG" ZSTD_LIBRARIES ZSTD_INCLUDE_DIR)
@@ -74,6 +74,31 @@ CMR_ERROR CMRbalancedStatsPrint(
   const char* prefix          /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
 
+/**
+ * \brief Prints statistics for recognition algorithm for [balanced](\ref balanced) matrices as a JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRbalancedStatsPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRbalancedStatsPrintJson(
+  FILE* stream,              /**< File stream to print to. */
+  CMR_BALANCED_STATS* stats  /**< Pointer to statistics. */
+);
+
+/**
+ * \brief Adds the statistics \p source for balancedness computations to \p target.
+ *
+ * This merges the statistics that were collected separately, e.g., by several workers.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRbalancedStatsAdd(
+  CMR_BALANCED_STATS* target, /**< Statistics to add to. */
+  CMR_BALANCED_STATS* source  /**< Statistics to be added. */
+);
+
 /**
  * \brief Tests a matrix \f$ M \f$ for being [balanced](\ref balanced).
  *
@@ -82,7 +107,7 @@ CMR_ERROR CMRbalancedStatsPrint(
  *
  * If \f$ M \f$ is not balanced and \p psubmatrix != \c NULL, then \p *psubmatrix will indicate a submatrix
  * of \f$ M \f$ with exactly two nonzeros in each row and in each column and with determinant \f$ -2 \f$ or \f$ 2 \f$.
- */CMR_SP_STATISTICS seriesParallel;     /**< Statistics for series-parallel algorithm. */
+ */
 
 CMR_EXPORT
 CMR_ERROR CMRbalancedTest(
@@ -95,6 +120,33 @@ CMR_ERROR CMRbalancedTest(
   double timeLimit              /**< Time limit to impose. */
 );
 
+/**
+ * \brief Tests a binary matrix \f$ M \f$ for being [totally balanced](\ref totally-balanced).
+ *
+ * Computes a doubly lexical ordering of \f$ M \f$, i.e., orders of the rows and columns such that, reading each row
+ * and each column from its last entry, the rows are lexicographically nondecreasing and so are the columns.
+ * Then \f$ M \f$ is totally balanced if and only if the ordered matrix does not contain
+ * \f$ \Gamma = \begin{pmatrix} 1 & 1 \\ 1 & 0 \end{pmatrix} \f$ as a submatrix.
+ *
+ * If \f$ M \f$ is not totally balanced and \p psubmatrix != \c NULL, then \p *psubmatrix will indicate an occurrence of
+ * \f$ \Gamma \f$ whose rows and columns are in the returned order. If \f$ M \f$ is not binary, then it will
+ * indicate a non-binary entry instead.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtotallyBalancedTest(
+  CMR* cmr,                     /**< \ref CMR environment */
+  CMR_CHRMAT* matrix,           /**< Matrix \f$ M \f$. */
+  bool* pisTotallyBalanced,     /**< Pointer for storing whether \f$ M \f$ is totally balanced. */
+  size_t* rowsOrder,            /**< Array of length equal to the number of rows for storing the rows in the doubly
+                                 **  lexical ordering (may be \c NULL). */
+  size_t* columnsOrder,         /**< Array of length equal to the number of columns for storing the columns in the
+                                 **  doubly lexical ordering (may be \c NULL). */
+  CMR_SUBMAT** psubmatrix,      /**< Pointer for storing an occurrence of \f$ \Gamma \f$ (may be \c NULL). */
+  CMR_BALANCED_STATS* stats,    /**< Statistics for the computation (may be \c NULL). */
+  double timeLimit              /**< Time limit to impose. */
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -52,6 +52,31 @@ CMR_ERROR CMRcamionStatsPrint(
   const char* prefix            /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
 
+/**
+ * \brief Prints statistics for [Camion-signing](\ref camion) algorithm as a JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRcamionStatsPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRcamionStatsPrintJson(
+  FILE* stream,                 /**< File stream to print to. */
+  CMR_CAMION_STATISTICS* stats  /**< Pointer to statistics. */
+);
+
+/**
+ * \brief Adds the statistics \p source for Camion signing computations to \p target.
+ *
+ * This merges the statistics that were collected separately, e.g., by several workers.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRcamionStatsAdd(
+  CMR_CAMION_STATISTICS* target, /**< Statistics to add to. */
+  CMR_CAMION_STATISTICS* source  /**< Statistics to be added. */
+);
+
 
 /**
  * \brief Tests a matrix \f$ M \f$ for being a [Camion-signed](\ref camion).
@@ -0,0 +1,56 @@
+#ifndef CMR_CONSECUTIVE_ONES_H
+#define CMR_CONSECUTIVE_ONES_H
+
+/**
+ * \file consecutive_ones.h
+ *
+ * \author Matthias Walter
+ *
+ * \brief Recognition of matrices with the [consecutive ones property](\ref consecutive-ones).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <cmr/env.h>
+#include <cmr/matrix.h>
+
+/**
+ * \brief Tests the support of \p matrix for the [consecutive ones property for columns](\ref consecutive-ones).
+ *
+ * The test is based on the PQ-trees of Booth and Lueker. If the property holds and \p columnsOrder is not \c NULL,
+ * then \p columnsOrder is filled with the columns in an order in which the nonzeros of each row are consecutive.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRconsecutiveOnesTestColumns(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,         /**< Matrix. */
+  bool* phasConsecutiveOnes,  /**< Pointer for storing whether the support of \p matrix has the property. */
+  size_t* columnsOrder        /**< Array of length equal to the number of columns of \p matrix for storing the
+                               **  columns in their consecutive order (may be \c NULL). */
+);
+
+/**
+ * \brief Tests the support of \p matrix for the [consecutive ones property for rows](\ref consecutive-ones).
+ *
+ * This is the test of \ref CMRconsecutiveOnesTestColumns for the transpose of \p matrix. If the property holds and
+ * \p rowsOrder is not \c NULL, then \p rowsOrder is filled with the rows in an order in which the nonzeros of each
+ * column are consecutive.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRconsecutiveOnesTestRows(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,         /**< Matrix. */
+  bool* phasConsecutiveOnes,  /**< Pointer for storing whether the support of \p matrix has the property. */
+  size_t* rowsOrder           /**< Array of length equal to the number of rows of \p matrix for storing the rows
+                               **  in their consecutive order (may be \c NULL). */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_CONSECUTIVE_ONES_H */
@@ -64,6 +64,20 @@ CMR_ERROR CMRstatsComplementTotalUnimodularityPrint(
   const char* prefix        /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
 
+/**
+ * \brief Prints statistics for recognition algorithm for [complement totally unimodular](\ref ctu) matrices as a
+ *        JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRstatsComplementTotalUnimodularityPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRstatsComplementTotalUnimodularityPrintJson(
+  FILE* stream,              /**< File stream to print to. */
+  CMR_CTU_STATISTICS* stats  /**< Pointer to statistics. */
+);
+
 /**
  * \brief Carries out a row- and column-complement operations on the binary matrix.
  */
@@ -86,6 +100,10 @@ CMR_ERROR CMRcomplementRowColumn(
  * \p pcomplementColumn != \c NULL, then \p *pcomplementRow and \p *pcomplementColumn will indicate the row and column
  * that need to be complemented for obtaining a matrix that is not [totally unimodular](\ref tu).
  * If no row/column needs to be complemented, then the respective variables are set to \c SIZE_MAX.
+ *
+ * If the environment has several threads (see \ref CMRsetNumThreads), the \f$ (m+1) \cdot (n+1) \f$ complemented
+ * matrices are tested in parallel and all workers stop on the first non-totally unimodular one. The reported row and
+ * column are the same as for a sequential run.
  */
 
 CMR_EXPORT
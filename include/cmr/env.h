@@ -16,6 +16,7 @@ extern "C" {
 #include <cmr/config.h>
 #include <cmr/export.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
@@ -85,6 +86,34 @@ CMR_ERROR CMRcreateEnvironment(
   CMR** pcmr  /**< Pointer at which the \ref CMR environment shall be allocated. */
 );
 
+/**
+ * \brief Allocator that provides the heap memory of a \ref CMR environment.
+ *
+ * The functions have the semantics of \c malloc, \c realloc and \c free and receive \ref data as their last argument.
+ * They may be called by several threads at the same time if the environment is used by several threads.
+ */
+
+typedef struct
+{
+  void* (*allocate)(size_t size, void* data);               /**< \brief Allocates \p size bytes. */
+  void* (*reallocate)(void* ptr, size_t size, void* data);  /**< \brief Resizes \p ptr to \p size bytes. */
+  void (*release)(void* ptr, void* data);                   /**< \brief Frees \p ptr. */
+  void* data;                                               /**< \brief User data passed to the functions. */
+} CMR_ALLOCATOR;
+
+/**
+ * \brief Allocates and initializes a default \ref CMR environment whose memory is provided by \p allocator.
+ *
+ * The environment itself, all block memory and all stack memory are obtained from \p allocator, which is copied.
+ * Memory that a caller receives from the library, e.g., a matrix, must be freed before the environment.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRcreateEnvironmentAllocator(
+  CMR** pcmr,                     /**< Pointer at which the \ref CMR environment shall be allocated. */
+  const CMR_ALLOCATOR* allocator  /**< Allocator to use, or \c NULL for \c malloc, \c realloc and \c free. */
+);
+
 /**
  * \brief Frees a \ref CMR environment.
  */
@@ -94,6 +123,317 @@ CMR_ERROR CMRfreeEnvironment(
   CMR** pcmr  /**< Pointer to \ref CMR environment. */
 );
 
+/**
+ * \brief Sets the number of threads that computations in \p cmr may use.
+ *
+ * The default is 1. If the library was compiled without multi-threading support, all computations are carried out
+ * sequentially regardless of this setting.
+ *
+ * Each thread that uses \p cmr gets its own stack memory, i.e., an environment may be shared by several threads.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRsetNumThreads(
+  CMR* cmr,       /**< \ref CMR environment. */
+  int numThreads  /**< Number of threads, or 0 for the number of available processors. */
+);
+
+/**
+ * \brief Returns the number of threads that computations in \p cmr may use.
+ */
+
+CMR_EXPORT
+int CMRgetNumThreads(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Sets whether the workers of parallel computations in \p cmr are bound to processors.
+ *
+ * With pinning, worker \f$ w \f$ of a parallel computation such as \ref CMRtuTestBatch runs on the
+ * \f$ w \f$-th processor that the calling thread may use, where processors are grouped by their NUMA node. Hence,
+ * consecutive workers share a node, and since each worker only reuses stack memory and block pools of earlier workers
+ * on the same processor, the memory it works with stays local to its node. The default is \c false. Without
+ * multi-threading support or on platforms other than Linux, the setting has no effect.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRsetThreadPinning(
+  CMR* cmr,     /**< \ref CMR environment. */
+  bool pinning  /**< Whether to bind workers to processors. */
+);
+
+/**
+ * \brief Returns whether the workers of parallel computations in \p cmr are bound to processors.
+ */
+
+CMR_EXPORT
+bool CMRgetThreadPinning(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Hardware performance counters accumulated over the invocations of a phase of an algorithm.
+ *
+ * They are only recorded if enabled via \ref CMRsetHardwareCounters. A phase is measured on the thread that runs it,
+ * i.e., work of other workers of a parallel computation is not included.
+ */
+
+typedef struct
+{
+  uint64_t cycles;        /**< \brief Number of processor cycles. */
+  uint64_t instructions;  /**< \brief Number of retired instructions. */
+  uint64_t cacheMisses;   /**< \brief Number of last-level cache misses. */
+  uint64_t branchMisses;  /**< \brief Number of mispredicted branches. */
+} CMR_COUNTERS;
+
+/**
+ * \brief Sets whether hardware performance counters are recorded for the phases of algorithms in \p cmr.
+ *
+ * If enabled, the statistics of graphicness tests, of the series-parallel reduction and of the regularity test contain
+ * \ref CMR_COUNTERS for those phases that also have a time, and the corresponding print functions show them. The
+ * counters are read via Linux' \c perf_event_open, once at the start and once at the end of every invocation of a
+ * phase. If the kernel denies access to them, e.g., due to \c /proc/sys/kernel/perf_event_paranoid, they remain 0.
+ * The default is \c false.
+ *
+ * \returns \ref CMR_ERROR_INPUT if \p enable is \c true and the platform does not support performance counters.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRsetHardwareCounters(
+  CMR* cmr,     /**< \ref CMR environment. */
+  bool enable   /**< Whether to record hardware performance counters. */
+);
+
+/**
+ * \brief Returns whether hardware performance counters are recorded for the phases of algorithms in \p cmr.
+ */
+
+CMR_EXPORT
+bool CMRgetHardwareCounters(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Sets the maximum number of bytes that computations in \p cmr may allocate.
+ *
+ * The limit applies to all block and stack memory of \p cmr, i.e., to every computation that uses it, including
+ * \ref CMRregularTest, \ref CMRtuTest and \ref CMRequimodularTest. When it is nearly reached, algorithms switch to
+ * strategies that need less memory. An allocation that would exceed it fails with \ref CMR_ERROR_MEMORY. The default
+ * is 0, which means that there is no limit.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRsetMemoryLimit(
+  CMR* cmr,     /**< \ref CMR environment. */
+  size_t limit  /**< Maximum number of bytes, or 0 for no limit. */
+);
+
+/**
+ * \brief Returns the memory limit of \p cmr in bytes, or 0 if there is none.
+ */
+
+CMR_EXPORT
+size_t CMRgetMemoryLimit(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Returns the number of bytes of block and stack memory that \p cmr currently uses.
+ */
+
+CMR_EXPORT
+size_t CMRgetMemoryUsage(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Returns the maximum number of bytes of block and stack memory that \p cmr used so far.
+ */
+
+CMR_EXPORT
+size_t CMRgetMemoryPeak(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Makes the stack memory of every thread that uses \p cmr a single reservation of \p size bytes of virtual
+ *        memory, or restores the default if \p size is 0.
+ *
+ * By default, stack memory consists of stacks of increasing sizes that are allocated when needed. With a reservation,
+ * the first stack that is needed beyond the initial one is a mapping of \p size bytes whose pages are only committed
+ * by the operating system when they are used; they count towards the limit of \ref CMRsetMemoryLimit in steps of 1 MB.
+ * The mapping does not use the allocator of \ref CMRcreateEnvironmentAllocator. A thread that already has further
+ * stacks keeps them and maps the reservation when it needs another one.
+ *
+ * \returns \ref CMR_ERROR_INPUT if \p size is positive and the platform does not support memory mappings.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRsetStackReservation(
+  CMR* cmr,   /**< \ref CMR environment. */
+  size_t size /**< Number of bytes to reserve per thread, or 0. */
+);
+
+/**
+ * \brief Ensures that the calling thread can allocate \p size bytes of stack memory in \p cmr without allocating
+ *        further stacks.
+ *
+ * Top-level functions such as \ref CMRregularTest call this with an estimate derived from their input, which avoids
+ * allocating a long sequence of small stacks for large inputs.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRreserveStack(
+  CMR* cmr,   /**< \ref CMR environment. */
+  size_t size /**< Number of bytes. */
+);
+
+/**
+ * \brief Statistics about the memory used by a \ref CMR environment.
+ */
+
+typedef struct
+{
+  size_t numBlockAllocations; /**< \brief Number of allocations and reallocations of block memory. */
+  size_t blockMemory;         /**< \brief Number of bytes of block memory that are currently allocated. */
+  size_t numStackAllocations; /**< \brief Number of allocations of stack memory. */
+  size_t stackMemory;         /**< \brief Number of bytes that are reserved for stack memory beyond the first stack of
+                               **  each thread. */
+  size_t stackPeak;           /**< \brief Maximum number of bytes of stack memory that a single thread used. */
+  size_t memoryPeak;          /**< \brief Maximum number of bytes of block memory and reserved stack memory. */
+} CMR_MEMORY_STATS;
+
+/**
+ * \brief Returns the memory statistics of \p cmr, counted since its creation or since \ref CMRresetMemoryStats.
+ *
+ * Must not be called while computations are running.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgetMemoryStats(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_MEMORY_STATS* stats /**< Pointer for storing the statistics. */
+);
+
+/**
+ * \brief Resets the memory statistics of \p cmr such that they only count what happens afterwards.
+ *
+ * The numbers of allocations are set to 0 and the peaks to the current usage. This makes it possible to measure the
+ * memory needed by a single call. Must not be called while computations are running.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRresetMemoryStats(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Prints the memory statistics \p stats to \p stream.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmemoryStatsPrint(
+  FILE* stream,             /**< File stream to print to. */
+  CMR_MEMORY_STATS* stats,  /**< Memory statistics. */
+  const char* prefix        /**< Prefix string to prepend to each printed line (may be \c NULL). */
+);
+
+/**
+ * \brief Progress of a long-running computation.
+ */
+
+typedef struct
+{
+  size_t numProcessedNodes; /**< \brief Number of decomposition nodes processed so far. */
+  size_t queueLength;       /**< \brief Number of decomposition nodes waiting to be processed. */
+} CMR_PROGRESS;
+
+/**
+ * \brief Callback that is informed about the progress of a computation.
+ *
+ * The callback may be invoked by worker threads, but never by two threads at the same time. It may call
+ * \ref CMRinterrupt, but no other function on \p cmr.
+ */
+
+typedef void (*CMR_PROGRESS_CALLBACK)(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  const CMR_PROGRESS* progress, /**< Current progress. */
+  void* data                    /**< User data passed to \ref CMRsetProgressCallback. */
+);
+
+/**
+ * \brief Sets the callback that is informed about the progress of computations in \p cmr.
+ *
+ * Currently, the processing of decomposition nodes in \ref CMRregularTest and in all functions based on it is
+ * reported.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRsetProgressCallback(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  CMR_PROGRESS_CALLBACK callback, /**< Callback, or \c NULL to disable progress reports. */
+  void* data                      /**< User data that is passed to \p callback. */
+);
+
+/**
+ * \brief Requests that all computations in \p cmr stop as soon as possible.
+ *
+ * May be called from any thread, in particular from a progress callback. The interrupted functions stop at the points
+ * at which they check their time limit and return \ref CMR_ERROR_TIMEOUT as if it was exceeded. Until
+ * \ref CMRclearInterrupt is called, subsequent computations stop immediately as well.
+ */
+
+CMR_EXPORT
+void CMRinterrupt(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Clears a request made by \ref CMRinterrupt.
+ */
+
+CMR_EXPORT
+void CMRclearInterrupt(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Returns \c true if and only if \ref CMRinterrupt was called for \p cmr and not cleared since.
+ */
+
+CMR_EXPORT
+bool CMRisInterrupted(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Starts writing a trace of the computations in \p cmr to \p stream.
+ *
+ * The trace is a JSON array of events in the Chrome trace-event format, which can be inspected with
+ * <tt>chrome://tracing</tt> or Perfetto. Currently, the processing of each decomposition node in \ref CMRregularTest
+ * and in all functions based on it is traced, together with the phase that is carried out and the dimensions of the
+ * node's matrix. A running trace is stopped first. Must not be called while computations are running.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtraceStart(
+  CMR* cmr,     /**< \ref CMR environment. */
+  FILE* stream  /**< Stream to write the events to; it is not closed by the library. */
+);
+
+/**
+ * \brief Stops writing the trace started by \ref CMRtraceStart, completing the JSON array.
+ *
+ * Does nothing if no trace is running. It is called automatically by \ref CMRfreeEnvironment. Must not be called
+ * while computations are running.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtraceStop(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
 /**
  * \brief Allocates block memory for *\p ptr.
  *
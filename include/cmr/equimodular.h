@@ -65,12 +65,38 @@ CMR_ERROR CMRequimodularStatsPrint(
   const char* prefix                  /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
 
+/**
+ * \brief Prints statistics for recognition algorithm for [equimodular](\ref equimodular) matrices as a JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRequimodularStatsPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRequimodularStatsPrintJson(
+  FILE* stream,                 /**< File stream to print to. */
+  CMR_EQUIMODULAR_STATS* stats  /**< Pointer to statistics. */
+);
+
+/**
+ * \brief Adds the statistics \p source for equimodularity computations to \p target.
+ *
+ * This merges the statistics that were collected separately, e.g., by several workers.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRequimodularStatsAdd(
+  CMR_EQUIMODULAR_STATS* target, /**< Statistics to add to. */
+  CMR_EQUIMODULAR_STATS* source  /**< Statistics to be added. */
+);
+
 /**
  * \brief Tests a matrix \f$ M \f$ for being [equimodular](\ref equimodular) (for determinant gcd \f$ k \f$).
  *
  * Tests if matrix \f$ M \f$ is equimodular for determinant gcd \f$ k \f$ and sets \p *pisEquimodular accordingly.
  * If \p pgcdDet is not \c NULL, the behavior is as follows.
- * If \p *pgcdDet is positive, then it tests only for that particular value of \f$ k \f$.
+ * If \p *pgcdDet is positive, then it tests only for that particular value of \f$ k \f$, and the elimination stops
+ * as soon as a pivot shows that the found basis cannot have determinant \f$ \pm k \f$.
  * Otherwise, \p *pgcdDet is set to \f$ k \f$ if \f$ M \f$ is equimodular for determinant gcd \f$ k \f$, and to \f$ 0 \f$ if \f$ M \f$ is not equimodular.
  */
 
@@ -93,6 +119,10 @@ CMR_ERROR CMRequimodularTest(
  * If \p *pgcdDet is positive, then it tests only for that particular value of \f$ k \f$.
  * Otherwise, \p *pgcdDet is set to \f$ k \f$ if \f$ M \f$ is strongly equimodular for determinant gcd \f$ k \f$,
  * and to \f$ 0 \f$ if \f$ M \f$ is not strongly equimodular.
+ *
+ * If several threads are allowed, \f$ M \f$ and \f$ M^{\textsf{T}} \f$ are tested concurrently. Otherwise,
+ * \f$ M^{\textsf{T}} \f$ is only tested if \f$ M \f$ is equimodular, and its elimination stops at the rank of
+ * \f$ M \f$.
  */
 
 CMR_EXPORT
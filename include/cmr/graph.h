@@ -177,6 +177,40 @@ CMR_ERROR CMRgraphClear(
   CMR_GRAPH* graph /**< Graph structure. */
 );
 
+/**
+ * \brief Creates a graph with nodes \f$ 0, 1, \dotsc, n-1 \f$ and the given edges.
+ *
+ * Edge \f$ e \f$ connects nodes \p edgesU[\f$ e \f$] and \p edgesV[\f$ e \f$]. The result is the same as if the
+ * nodes and then the edges were added one by one via \ref CMRgraphAddNode and \ref CMRgraphAddEdge, but the memory is
+ * allocated only once and the incidence lists are filled in a single pass.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphCreateFromEdges(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  CMR_GRAPH** pgraph,           /**< Pointer for storing the graph. */
+  size_t numNodes,              /**< Number \f$ n \f$ of nodes. */
+  size_t numEdges,              /**< Number of edges. */
+  const CMR_GRAPH_NODE* edgesU, /**< Array with the first end node of each edge. */
+  const CMR_GRAPH_NODE* edgesV  /**< Array with the second end node of each edge. */
+);
+
+/**
+ * \brief Replaces the nodes and edges of \p graph like \ref CMRgraphCreateFromEdges.
+ *
+ * The memory of \p graph is reused and enlarged at most once.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphAssignEdges(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  CMR_GRAPH* graph,             /**< Graph structure. */
+  size_t numNodes,              /**< Number \f$ n \f$ of nodes. */
+  size_t numEdges,              /**< Number of edges. */
+  const CMR_GRAPH_NODE* edgesU, /**< Array with the first end node of each edge. */
+  const CMR_GRAPH_NODE* edgesV  /**< Array with the second end node of each edge. */
+);
+
 /**
  * \brief Adds a node to a graph.
  *
@@ -502,6 +536,117 @@ CMR_ERROR CMRgraphCreateFromEdgeList(
   FILE* stream              /**< File stream to read from. */
 );
 
+/**
+ * \brief Incidence of a \ref CMR_GRAPH_FROZEN.
+ */
+
+typedef struct
+{
+  CMR_GRAPH_ITER arc;     /**< \brief Arc of the graph, i.e., the corresponding iterator of \ref CMRgraphIncFirst. */
+  CMR_GRAPH_NODE target;  /**< \brief End node of the arc. */
+} CMR_GRAPH_FROZEN_INC;
+
+/**
+ * \brief Compact read-only adjacency representation of a \ref CMR_GRAPH.
+ *
+ * The incidences of each node are stored consecutively, in the order in which \ref CMRgraphIncFirst and
+ * \ref CMRgraphIncNext visit them. It becomes invalid when the graph is modified.
+ */
+
+typedef struct
+{
+  size_t memNodes;                  /**< \brief Number of nodes for which memory is allocated in the graph. */
+  size_t* nodesFirst;               /**< \brief Array mapping each node to its first incidence, followed by the number
+                                     **         of incidences. */
+  CMR_GRAPH_FROZEN_INC* incidences; /**< \brief Array with the incidences of all nodes. */
+} CMR_GRAPH_FROZEN;
+
+/**
+ * \brief Creates the compact adjacency representation of \p graph.
+ *
+ * If the incidence lists of all nodes are sorted by decreasing arcs, which is the case if no edge was deleted, the
+ * arcs are distributed to the nodes by a single scan over them. Otherwise, the incidence lists are traversed.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphFreeze(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_GRAPH* graph,           /**< Graph. */
+  CMR_GRAPH_FROZEN** pfrozen  /**< Pointer for storing the adjacency representation. */
+);
+
+/**
+ * \brief Frees a compact adjacency representation.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphFrozenFree(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_GRAPH_FROZEN** pfrozen  /**< Pointer to adjacency representation. */
+);
+
+/**
+ * \brief Returns the index of the first incidence of node \p v.
+ *
+ * The incidences of \p v are those with indices up to \ref CMRgraphFrozenIncBeyond, excluding the latter.
+ */
+
+static inline
+size_t CMRgraphFrozenIncFirst(
+  CMR_GRAPH_FROZEN* frozen, /**< Adjacency representation. */
+  CMR_GRAPH_NODE v          /**< Node. */
+)
+{
+  assert(frozen);
+
+  return frozen->nodesFirst[v];
+}
+
+/**
+ * \brief Returns the index beyond the last incidence of node \p v.
+ */
+
+static inline
+size_t CMRgraphFrozenIncBeyond(
+  CMR_GRAPH_FROZEN* frozen, /**< Adjacency representation. */
+  CMR_GRAPH_NODE v          /**< Node. */
+)
+{
+  assert(frozen);
+
+  return frozen->nodesFirst[v + 1];
+}
+
+/**
+ * \brief Returns the edge of incidence \p i.
+ */
+
+static inline
+CMR_GRAPH_EDGE CMRgraphFrozenIncEdge(
+  CMR_GRAPH_FROZEN* frozen, /**< Adjacency representation. */
+  size_t i                  /**< Index of incidence. */
+)
+{
+  assert(frozen);
+
+  return frozen->incidences[i].arc / 2;
+}
+
+/**
+ * \brief Returns the end node of incidence \p i.
+ */
+
+static inline
+CMR_GRAPH_NODE CMRgraphFrozenIncTarget(
+  CMR_GRAPH_FROZEN* frozen, /**< Adjacency representation. */
+  size_t i                  /**< Index of incidence. */
+)
+{
+  assert(frozen);
+
+  return frozen->incidences[i].target;
+}
+
 /**@}*/
 
 #ifdef __cplusplus
@@ -40,6 +40,8 @@ typedef struct
   double applyTime;         /**< Time of column additions. */
   uint32_t transposeCount;  /**< Number of matrix transpositions. */
   double transposeTime;     /**< Time for matrix transpositions. */
+  CMR_COUNTERS checkCounters; /**< Hardware counters of check algorithm calls; see \ref CMRsetHardwareCounters. */
+  CMR_COUNTERS applyCounters; /**< Hardware counters of column additions; see \ref CMRsetHardwareCounters. */
 } CMR_GRAPHIC_STATISTICS;
 
 /**
@@ -62,6 +64,31 @@ CMR_ERROR CMRgraphicStatsPrint(
   const char* prefix              /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
 
+/**
+ * \brief Prints statistics for graphicness computations as a JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRgraphicStatsPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicStatsPrintJson(
+  FILE* stream,                  /**< File stream to print to. */
+  CMR_GRAPHIC_STATISTICS* stats  /**< Pointer to statistics. */
+);
+
+/**
+ * \brief Adds the statistics \p source for graphicness computations to \p target.
+ *
+ * This merges the statistics that were collected separately, e.g., by several workers.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicStatsAdd(
+  CMR_GRAPHIC_STATISTICS* target, /**< Statistics to add to. */
+  CMR_GRAPHIC_STATISTICS* source  /**< Statistics to be added. */
+);
+
 /**
  * \brief Computes the graphic matrix of a given graph \f$ G = (V,E) \f$.
  *
@@ -89,6 +116,28 @@ CMR_ERROR CMRgraphicComputeMatrix(
                                    **  (may be \c NULL). */
 );
 
+/**
+ * \brief Verifies that a matrix \f$ M \f$ is the [graphic matrix](\ref graphic) of a given graph and spanning forest.
+ *
+ * Sets \p *pisGraphic to \c true if and only if \f$ T \f$ is a spanning forest of \f$ G = (V,E) \f$ and the support
+ * of \f$ M \f$ is equal to \f$ M(G,T) \f$, where the rows are ordered as \p forestEdges and the columns as
+ * \p coforestEdges. This is useful if a graph of \f$ M \f$ is already known, e.g., from an earlier call to
+ * \ref CMRgraphicTestMatrix or from \ref CMRgraphicComputeMatrix. The running time is
+ * \f$ \mathcal{O}( |V| + |E| + \text{nnz}(M) ) \f$.
+ *
+ * \note If \p *pisGraphic is \c false, then \f$ M \f$ may still be graphic, but for a different graph.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicVerifyMatrix(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,             /**< Matrix \f$ M \f$. */
+  CMR_GRAPH* graph,               /**< Graph \f$ G = (V,E) \f$. */
+  CMR_GRAPH_EDGE* forestEdges,    /**< \f$ T \f$, indexed by the rows of \f$ M \f$. */
+  CMR_GRAPH_EDGE* coforestEdges,  /**< \f$ E \setminus T \f$, indexed by the columns of \f$ M \f$. */
+  bool* pisGraphic                /**< Pointer for storing whether \f$ M = M(G,T) \f$. */
+);
+
 /**
  * \brief Tests a matrix \f$ M \f$ for being a [graphic matrix](\ref graphic).
  *
@@ -96,8 +145,9 @@ CMR_ERROR CMRgraphicComputeMatrix(
  * \f$ G \f$ and sets \p *pisGraphic accordingly.
  *
  * \note If a column-wise representation of \f$ M \f$ is available, it is recommended to call
- *       \ref CMRtestCographicMatrix() for that. In fact, the implementation explicitly constructs
- *       \f$ M^{\mathsf{T}} \f$ before calling this function.
+ *       \ref CMRgraphicTestTranspose() for that. Otherwise, the implementation only constructs a temporary
+ *       column-wise view of the support of \f$ M \f$; \f$ M^{\mathsf{T}} \f$ is only constructed explicitly if a
+ *       non-graphic submatrix is requested.
  *
  * If \f$ M \f$ is a graphic matrix and \p pgraph != \c NULL, then one possible graph \f$ G \f$ is computed and
  * stored in \p *pgraph. The caller must release its memory via \ref CMRgraphFree.
@@ -155,6 +205,208 @@ CMR_ERROR CMRgraphicTestTranspose(
   double timeLimit                  /**< Time limit to impose. */
 );
 
+/**
+ * \brief Order in which the columns of a matrix are added to the decomposition of a graphicness test.
+ *
+ * The result does not depend on the order, but the sizes of the intermediate decompositions and hence the running
+ * time do.
+ */
+
+typedef enum
+{
+  CMR_GRAPHIC_ORDER_INPUT = 0,      /**< Columns are added in the order of the input. */
+  CMR_GRAPHIC_ORDER_CONNECTED = 1,  /**< Columns are added in breadth-first search order of the graph in which two
+                                     **  columns are adjacent if they share a row. Each connected component is started
+                                     **  at its densest column, such that every further column shares a row with an
+                                     **  earlier one. */
+  CMR_GRAPHIC_ORDER_REJECT = 2      /**< Intended for matrices that are likely not graphic. Each connected component
+                                     **  is started at its densest column, and then the next column is always one
+                                     **  with the most nonzeros in rows covered by earlier columns. This way, a dense
+                                     **  core is built first and the most constrained columns, which are most likely
+                                     **  to violate graphicness, follow early. */
+} CMR_GRAPHIC_ORDER;
+
+/**
+ * \brief Tests a matrix \f$ M \f$ for being a [graphic matrix](\ref graphic), adding its columns in the given
+ *        \p order.
+ *
+ * Like \ref CMRgraphicTestMatrix, which uses \ref CMR_GRAPHIC_ORDER_INPUT. The graph, forest and coforest always
+ * refer to the original indices of the rows and columns of \f$ M \f$.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicTestMatrixOrdered(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,               /**< Matrix \f$ M \f$. */
+  CMR_GRAPHIC_ORDER order,          /**< Order in which the columns are processed. */
+  bool* pisGraphic,                 /**< Pointer for storing \c true if and only if \f$ M \f$ is a graphic matrix. */
+  CMR_GRAPH** pgraph,               /**< Pointer for storing the graph \f$ G \f$ (if \f$ M \f$ is graphic). */
+  CMR_GRAPH_EDGE** pforestEdges,    /**< Pointer for storing \f$ T \f$, indexed by the rows of \f$ M \f$ (if \f$ M \f$
+                                     **  is graphic).  */
+  CMR_GRAPH_EDGE** pcoforestEdges,  /**< Pointer for storing \f$ E \setminus T \f$, indexed by the columns of \f$ M \f$
+                                     **  (if \f$ M \f$ is graphic). */
+  CMR_SUBMAT** psubmatrix,          /**< Pointer for storing a minimal non-graphic submatrix (if \f$ M \f$ is not
+                                     **  graphic). */
+  CMR_GRAPHIC_STATISTICS* stats,    /**< Pointer to statistics (may be \c NULL). */
+  double timeLimit                  /**< Time limit to impose. */
+);
+
+/**
+ * \brief Tests a matrix \f$ M \f$ for being a [cographic matrix](\ref graphic), adding the rows of \f$ M \f$, i.e.,
+ *        the columns of \f$ M^{\mathsf{T}} \f$, in the given \p order.
+ *
+ * Like \ref CMRgraphicTestTranspose, which uses \ref CMR_GRAPHIC_ORDER_INPUT. Orders other than the input order
+ * require \f$ M^{\mathsf{T}} \f$, which is obtained via \ref CMRchrmatGetTranspose.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicTestTransposeOrdered(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,               /**< Matrix \f$ M \f$ */
+  CMR_GRAPHIC_ORDER order,          /**< Order in which the rows are processed. */
+  bool* pisCographic,               /**< Returns true if and only if \f$ M \f$ is a cographic matrix. */
+  CMR_GRAPH** pgraph,               /**< Pointer for storing the graph \f$ G \f$ (if \f$ M \f$ is graphic). */
+  CMR_GRAPH_EDGE** pforestEdges,    /**< Pointer for storing \f$ T \f$, indexed by the rows of \f$ M \f$ (if \f$ M \f$
+                                     **  is graphic).  */
+  CMR_GRAPH_EDGE** pcoforestEdges,  /**< Pointer for storing \f$ E \setminus T \f$, indexed by the columns of \f$ M \f$
+                                     **  (if \f$ M \f$ is graphic). */
+  CMR_SUBMAT** psubmatrix,          /**< Pointer for storing a minimal non-graphic submatrix (if \f$ M \f$ is not
+                                     **  graphic). */
+  CMR_GRAPHIC_STATISTICS* stats,    /**< Pointer to statistics (may be \c NULL). */
+  double timeLimit                  /**< Time limit to impose. */
+);
+
+/**
+ * \brief Tests a matrix \f$ M \f$ with 32-bit indices for being a [graphic matrix](\ref graphic).
+ *
+ * Like \ref CMRgraphicTestMatrix, but works directly on the compact representation. Retrieval of minimal non-graphic
+ * submatrices is not supported.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicTestMatrix32(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  CMR_CHRMAT32* matrix,             /**< Matrix \f$ M \f$. */
+  bool* pisGraphic,                 /**< Pointer for storing \c true if and only if \f$ M \f$ is a graphic matrix. */
+  CMR_GRAPH** pgraph,               /**< Pointer for storing the graph \f$ G \f$ (if \f$ M \f$ is graphic). */
+  CMR_GRAPH_EDGE** pforestEdges,    /**< Pointer for storing \f$ T \f$, indexed by the rows of \f$ M \f$ (if \f$ M \f$
+                                     **  is graphic).  */
+  CMR_GRAPH_EDGE** pcoforestEdges,  /**< Pointer for storing \f$ E \setminus T \f$, indexed by the columns of \f$ M \f$
+                                     **  (if \f$ M \f$ is graphic). */
+  CMR_GRAPHIC_STATISTICS* stats,    /**< Pointer to statistics (may be \c NULL). */
+  double timeLimit                  /**< Time limit to impose. */
+);
+
+/**
+ * \brief Tests a matrix \f$ M \f$ with 32-bit indices for being a [cographic matrix](\ref graphic).
+ *
+ * Like \ref CMRgraphicTestTranspose, but works directly on the compact representation. Retrieval of minimal
+ * non-cographic submatrices is not supported.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicTestTranspose32(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  CMR_CHRMAT32* matrix,             /**< Matrix \f$ M \f$. */
+  bool* pisCographic,               /**< Pointer for storing \c true if and only if \f$ M \f$ is a cographic matrix. */
+  CMR_GRAPH** pgraph,               /**< Pointer for storing the graph \f$ G \f$ (if \f$ M \f$ is cographic). */
+  CMR_GRAPH_EDGE** pforestEdges,    /**< Pointer for storing \f$ T \f$, indexed by the rows of \f$ M \f$ (if \f$ M \f$
+                                     **  is cographic).  */
+  CMR_GRAPH_EDGE** pcoforestEdges,  /**< Pointer for storing \f$ E \setminus T \f$, indexed by the columns of \f$ M \f$
+                                     **  (if \f$ M \f$ is cographic). */
+  CMR_GRAPHIC_STATISTICS* stats,    /**< Pointer to statistics (may be \c NULL). */
+  double timeLimit                  /**< Time limit to impose. */
+);
+
+/**
+ * \brief Decomposition for testing graphicness of a matrix whose columns are added one by one.
+ *
+ * The matrix \f$ M \f$ has a fixed number of rows and initially no columns. For each new column, one first calls
+ * \ref CMRgraphicOnlineTryColumn to find out whether \f$ M \f$ remains graphic. If so, the column can be added via
+ * \ref CMRgraphicOnlineAddColumn. The graph of the current matrix can be extracted at any time via
+ * \ref CMRgraphicOnlineComputeGraph. The total running time for all columns is the same as that of
+ * \ref CMRgraphicTestMatrix for the final matrix.
+ */
+
+typedef struct _CMR_GRAPHIC_ONLINE CMR_GRAPHIC_ONLINE;
+
+/**
+ * \brief Creates a \ref CMR_GRAPHIC_ONLINE structure for a matrix with \p numRows rows and no columns.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicOnlineCreate(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  CMR_GRAPHIC_ONLINE** ponline,   /**< Pointer for storing the new structure. */
+  size_t numRows                  /**< Number of rows of \f$ M \f$. */
+);
+
+/**
+ * \brief Frees a \ref CMR_GRAPHIC_ONLINE structure.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicOnlineFree(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  CMR_GRAPHIC_ONLINE** ponline  /**< Pointer to the structure (may be \c NULL). */
+);
+
+/**
+ * \brief Returns the number of columns of \f$ M \f$ that were added so far.
+ */
+
+CMR_EXPORT
+size_t CMRgraphicOnlineNumColumns(
+  CMR_GRAPHIC_ONLINE* online  /**< Online graphicness structure. */
+);
+
+/**
+ * \brief Tests whether \f$ M \f$ remains graphic when appending a new column.
+ *
+ * The column is given by the rows of its nonzero entries, which must be distinct. Only a subsequent call to
+ * \ref CMRgraphicOnlineAddColumn actually appends it.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicOnlineTryColumn(
+  CMR_GRAPHIC_ONLINE* online, /**< Online graphicness structure. */
+  size_t numEntries,          /**< Number of nonzeros of the new column. */
+  size_t* rows,               /**< Array with the rows of the nonzeros of the new column. */
+  bool* pisGraphic            /**< Pointer for storing whether \f$ M \f$ with the new column is graphic. */
+);
+
+/**
+ * \brief Appends the column to \f$ M \f$ that was tested last via \ref CMRgraphicOnlineTryColumn.
+ *
+ * The arguments must be the same as for that call, which must have reported graphicness. Otherwise,
+ * \ref CMR_ERROR_INVALID is returned.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicOnlineAddColumn(
+  CMR_GRAPHIC_ONLINE* online, /**< Online graphicness structure. */
+  size_t numEntries,          /**< Number of nonzeros of the new column. */
+  size_t* rows                /**< Array with the rows of the nonzeros of the new column. */
+);
+
+/**
+ * \brief Computes a graph \f$ G \f$ and a spanning forest \f$ T \f$ with \f$ M = M(G,T) \f$ for the current
+ *        matrix \f$ M \f$.
+ *
+ * The memory is handled as for \ref CMRgraphicTestMatrix. A column that was only tried must be tried again before
+ * adding it.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicOnlineComputeGraph(
+  CMR_GRAPHIC_ONLINE* online,       /**< Online graphicness structure. */
+  CMR_GRAPH** pgraph,               /**< Pointer for storing the graph \f$ G \f$. */
+  CMR_GRAPH_EDGE** pforestEdges,    /**< Pointer for storing \f$ T \f$, indexed by the rows of \f$ M \f$
+                                     **  (may be \c NULL). */
+  CMR_GRAPH_EDGE** pcoforestEdges   /**< Pointer for storing \f$ E \setminus T \f$, indexed by the columns of
+                                     **  \f$ M \f$ (may be \c NULL). */
+);
+
 /**
  * \brief Finds an inclusion-wise maximal subset of columns that induces a graphic submatrix.
  *
@@ -171,6 +423,46 @@ CMR_ERROR CMRgraphicTestColumnSubmatrixGreedy(
   CMR_SUBMAT** psubmatrix  /**< Pointer for storing the submatrix. */
 );
 
+/**
+ * \brief Finds an inclusion-wise maximal subset of columns that induces a graphic submatrix by trying several orders.
+ *
+ * Like \ref CMRgraphicTestColumnSubmatrixGreedy, but tries to append the columns in each of the \p numOrders orders
+ * and returns the largest subset found. All orders must start with the same \p numPrefixColumns columns, which are
+ * processed only once. For each further order, the decomposition is rolled back to the state after the prefix
+ * instead of being rebuilt.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicTestColumnSubmatrixGreedyOrders(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* transpose,    /**< \f$ M^{\mathsf{T}} \f$ */
+  size_t numOrders,         /**< Number of orders. */
+  size_t** orderedColumns,  /**< Array of \p numOrders permutations of column indices of \f$ M \f$. */
+  size_t numPrefixColumns,  /**< Length of the prefix that all orders have in common. */
+  CMR_SUBMAT** psubmatrix   /**< Pointer for storing the submatrix. */
+);
+
+/**
+ * \brief Finds a large inclusion-wise maximal subset of columns that induces a graphic submatrix by running greedy
+ *        searches for several column orders in parallel.
+ *
+ * Like \ref CMRgraphicTestColumnSubmatrixGreedy for \p numOrders different orders, each with its own decomposition.
+ * The orders are distributed among the threads of \p cmr (see \ref CMRsetNumThreads). Order 0 is by decreasing
+ * number of nonzeros, order 1 adds columns in breadth-first search order of the bipartite row-column graph, such that
+ * each column shares rows with earlier ones, order 2 is the natural one, and all further orders are random ones that
+ * only depend on \p seed. The submatrix of the first largest subset is returned, which does not depend on the number
+ * of threads.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRgraphicTestColumnSubmatrixPortfolio(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* transpose,    /**< \f$ M^{\mathsf{T}} \f$ */
+  size_t numOrders,         /**< Number of column orders to try. */
+  unsigned int seed,        /**< Seed for the random orders. */
+  CMR_SUBMAT** psubmatrix   /**< Pointer for storing the submatrix. */
+);
+
 /**@}*/
 
 #ifdef __cplusplus
@@ -29,6 +29,9 @@ CMR_ERROR CMRchrmatDeterminant(
 
 /**
  * \brief Computes the determinant of an int matrix.
+ *
+ * The determinant is computed modulo sufficiently many word-size primes to exceed twice Hadamard's bound and then
+ * reconstructed via the Chinese remainder theorem. Returns \ref CMR_ERROR_OVERFLOW if it does not fit into 64 bits.
  */
 
 CMR_EXPORT
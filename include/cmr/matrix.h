@@ -12,6 +12,7 @@
 #include <cmr/env.h>
 
 #include <stdio.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -210,6 +211,181 @@ typedef struct
   char* entryValues;    /**< \brief Array mapping each entry to its value. */
 } CMR_CHRMAT;
 
+/**
+ * \brief Row-wise representation of sparse char matrix with 32-bit indices.
+ *
+ * The layout is the same as that of \ref CMR_CHRMAT, but the row slices and column indices are stored as 32-bit
+ * integers, which reduces the memory per nonzero from 9 to 5 bytes. Hence, the number of rows and columns must be at
+ * most \c UINT32_MAX and the number of nonzeros must be less than \c UINT32_MAX;
+ * see \ref CMRchrmat32Fits.
+ */
+
+typedef struct
+{
+  size_t numRows;         /**< \brief Number of rows. */
+  size_t numColumns;      /**< \brief Number of columns. */
+  size_t numNonzeros;     /**< \brief Number of and memory allocated for nonzeros. */
+  uint32_t* rowSlice;     /**< \brief Array mapping each row to the index of its first entry. */
+  uint32_t* entryColumns; /**< \brief Array mapping each entry to its column.*/
+  char* entryValues;      /**< \brief Array mapping each entry to its value. */
+} CMR_CHRMAT32;
+
+/**
+ * \brief Returns \c true if and only if a matrix of the given dimensions can be stored as a \ref CMR_CHRMAT32.
+ */
+
+CMR_EXPORT
+bool CMRchrmat32Fits(
+  size_t numRows,     /**< Number of rows. */
+  size_t numColumns,  /**< Number of columns. */
+  size_t numNonzeros  /**< Number of nonzeros. */
+);
+
+/**
+ * \brief Creates a char matrix with 32-bit indices of given size.
+ *
+ * Only allocates the memory. Returns \ref CMR_ERROR_INPUT if the dimensions are too large; see \ref CMRchrmat32Fits.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmat32Create(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT32** presult, /**< Pointer for storing the created matrix. */
+  size_t numRows,         /**< Number of rows. */
+  size_t numColumns,      /**< Number of columns. */
+  size_t numNonzeros      /**< Number of nonzeros. */
+);
+
+/**
+ * \brief Frees the memory of a char matrix with 32-bit indices.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmat32Free(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT32** pmatrix  /**< Pointer to matrix. */
+);
+
+/**
+ * \brief Creates a copy of the char \p matrix with 32-bit indices.
+ *
+ * Returns \ref CMR_ERROR_INPUT if the dimensions of \p matrix are too large; see \ref CMRchrmat32Fits.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatToCompact(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,     /**< A matrix. */
+  CMR_CHRMAT32** presult  /**< Pointer for storing the copy. */
+);
+
+/**
+ * \brief Creates a copy of the char \p matrix with 32-bit indices as a \ref CMR_CHRMAT.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmat32ToChrmat(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_CHRMAT32* matrix, /**< A matrix. */
+  CMR_CHRMAT** presult  /**< Pointer for storing the copy. */
+);
+
+/**
+ * \brief Creates the transpose of a char matrix with 32-bit indices.
+ *
+ * Runs in time linear in the size of the matrix.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmat32Transpose(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT32* matrix,   /**< A matrix. */
+  CMR_CHRMAT32** presult  /**< Pointer for storing the transpose of \p matrix. */
+);
+
+/**
+ * \brief Checks whether a char matrix with 32-bit indices and a char matrix are equal.
+ */
+
+CMR_EXPORT
+bool CMRchrmat32CheckEqual(
+  CMR_CHRMAT32* matrix1,  /**< First matrix. */
+  CMR_CHRMAT* matrix2     /**< Second matrix. */
+);
+
+/**
+ * \brief Checks a char matrix with 32-bit indices for consistency.
+ *
+ * Returns \c NULL if consistent. Otherwise, an explanation string is returned, which must be freed via \c free().
+ */
+
+CMR_EXPORT
+char* CMRchrmat32Consistency(
+  CMR_CHRMAT32* matrix  /**< A matrix. */
+);
+
+/**
+ * \brief Types of the values of \ref CMR_SPARSE_BUFFERS.
+ */
+
+typedef enum
+{
+  CMR_BUFFER_VALUES_CHAR = 0,   /**< Values are of type \c char. */
+  CMR_BUFFER_VALUES_INT = 1,    /**< Values are of type \c int. */
+  CMR_BUFFER_VALUES_DOUBLE = 2  /**< Values are of type \c double. */
+} CMR_BUFFER_VALUES;
+
+/**
+ * \brief Sparse matrix in compressed row (CSR) or compressed column (CSC) buffers that are owned by the user.
+ *
+ * In CSR orientation, the nonzeros of row \c r are those at positions \f$ p \f$ with
+ * \ref slice[r] \f$ \leq p < \f$ \ref slice[r+1], where \ref indices[\f$ p \f$] is the column and
+ * \ref values[\f$ p \f$] is the entry. In CSC orientation, the roles of rows and columns are exchanged. The slice
+ * and index arrays consist of 32-bit or 64-bit signed integers, as used by Eigen, SciPy and most solver interfaces.
+ */
+
+typedef struct
+{
+  size_t numRows;               /**< \brief Number of rows. */
+  size_t numColumns;            /**< \brief Number of columns. */
+  bool columnWise;              /**< \brief Whether the buffers are in CSC instead of CSR orientation. */
+  bool sorted;                  /**< \brief Whether the indices of each row (resp. column) are strictly increasing. */
+  bool indices64;               /**< \brief Whether \ref slice and \ref indices are \c int64_t instead of \c int32_t
+                                 **  arrays. */
+  const void* slice;            /**< \brief Array of length \ref numRows + 1 (resp. \ref numColumns + 1) with the
+                                 **  first position of each row (resp. column). */
+  const void* indices;          /**< \brief Array with the column (resp. row) of each position. */
+  CMR_BUFFER_VALUES valueType;  /**< \brief Type of the values. */
+  const void* values;           /**< \brief Array with the value of each position. */
+} CMR_SPARSE_BUFFERS;
+
+/**
+ * \brief Creates a char matrix from sparse buffers, borrowing them if possible.
+ *
+ * The buffers are borrowed, i.e., not copied, if they have 64-bit indices, are \ref CMR_SPARSE_BUFFERS::sorted,
+ * start at position 0 and have \c char values that are all nonzero. In this case the buffers must stay valid and
+ * unchanged until \p *presult is freed via \ref CMRchrmatFree, which does not free them. The recognition algorithms
+ * never modify their input matrices. Otherwise, the buffers are converted in a single pass, in which explicit zeros
+ * are dropped, unsorted rows are sorted and values that are not integers in the range of \c char lead to
+ * \ref CMR_ERROR_INPUT.
+ *
+ * Buffers in CSC orientation are naturally the CSR buffers of the transpose. If \p ptransposed is not \c NULL, then
+ * the transpose may be returned instead, in which case \p *ptransposed is set to \c true. This avoids any conversion
+ * for callers of recognition algorithms whose outcome does not change under transposition, e.g.,
+ * \ref CMRtuTest or \ref CMRregularTest. If \p ptransposed is \c NULL, then the CSC buffers are converted by a
+ * counting sort, and if they can be borrowed, they are cached as the transpose of \p *presult, which makes
+ * \ref CMRchrmatGetTranspose free.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatCreateFromBuffers(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  const CMR_SPARSE_BUFFERS* buffers,  /**< Sparse buffers. */
+  CMR_CHRMAT** presult,               /**< Pointer for storing the matrix. */
+  bool* ptransposed                   /**< Pointer for storing whether \p *presult is the transpose of the matrix of
+                                       **  \p buffers (may be \c NULL). */
+);
+
 /**
  * \brief Creates a double matrix of with \p numRows rows, \p numColumns columns and \p numNonzeros nonzeros.
  *        The actual arrays are allocated but not initialized.
@@ -412,6 +588,34 @@ CMR_ERROR CMRchrmatTranspose(
   CMR_CHRMAT** presult  /**< Pointer for storing the transpose of \p matrix. */
 );
 
+/**
+ * \brief Returns the transpose of a char matrix, which is computed on the first request and cached afterwards.
+ *
+ * The transpose is owned by \p matrix and shared by all callers; it must neither be modified nor be freed. It is
+ * freed together with \p matrix, and it is invalidated by \ref CMRchrmatChangeNumNonzeros(),
+ * \ref CMRcamionComputeSigns() and \ref CMRchrmatInvalidateTranspose(). The latter must be called after modifying
+ * the entries of \p matrix directly.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatGetTranspose(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,       /**< Given matrix. */
+  CMR_CHRMAT** ptranspose   /**< Pointer for storing the cached transpose of \p matrix. */
+);
+
+/**
+ * \brief Frees the cached transpose of a char matrix, if any.
+ *
+ * \see \ref CMRchrmatGetTranspose().
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatInvalidateTranspose(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix  /**< Given matrix. */
+);
+
 /**
  * \brief Creates the double matrix obtained from \p matrix by applying row- and column-permutations.
  */
@@ -607,6 +811,59 @@ CMR_ERROR CMRchrmatCreateFromSparseFile(
   CMR_CHRMAT** presult    /**< Pointer for storing the matrix. */
 );
 
+/**
+ * \brief Function that receives the dimensions of a matrix read by \ref CMRchrmatStreamSparseColumns.
+ */
+
+typedef CMR_ERROR (*CMR_SPARSE_HEADER_FUNCTION)(
+  CMR* cmr,           /**< \ref CMR environment. */
+  size_t numRows,     /**< Number of rows of the matrix. */
+  size_t numColumns,  /**< Number of columns of the matrix. */
+  size_t numNonzeros, /**< Number of nonzeros of the matrix as stated in the input. */
+  void* data,         /**< User data. */
+  bool* pstop         /**< Pointer for storing whether no columns shall be read; initially \c false. */
+);
+
+/**
+ * \brief Function that receives a column of a matrix read by \ref CMRchrmatStreamSparseColumns.
+ *
+ * The arrays \p rows and \p values are only valid during the call.
+ */
+
+typedef CMR_ERROR (*CMR_SPARSE_COLUMN_FUNCTION)(
+  CMR* cmr,           /**< \ref CMR environment. */
+  size_t column,      /**< Column. */
+  size_t numEntries,  /**< Number of nonzeros of the column. */
+  size_t* rows,       /**< Rows of the nonzeros of the column in the order of the input. */
+  char* values,       /**< Values of the nonzeros of the column. */
+  void* data,         /**< User data. */
+  bool* pstop         /**< Pointer for storing whether no further columns shall be read; initially \c false. */
+);
+
+/**
+ * \brief Reads a char matrix from a file name \p fileName in sparse format column by column.
+ *
+ * The nonzeros must be sorted by column, while the order within a column is arbitrary. The matrix is never stored
+ * completely. Instead, each column, including empty ones, is passed to \p columnFunction in increasing order as soon
+ * as its last nonzero was read. If the environment has several threads (see \ref CMRsetNumThreads), then parsing of
+ * the input overlaps with the calls to \p columnFunction, which are still made one at a time. A compressed input is
+ * decompressed completely before parsing.
+ *
+ * Returns \ref CMR_ERROR_INPUT in case of errors, in particular if the nonzeros are not sorted by column. Columns
+ * before the error may have been passed on already. Errors returned by \p headerFunction or \p columnFunction are
+ * passed through.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatStreamSparseColumns(
+  CMR* cmr,                                   /**< \ref CMR environment. */
+  const char* fileName,                       /**< File name to read from. */
+  const char* stdinName,                      /**< If not \c NULL, indicates which file name represents stdin. */
+  CMR_SPARSE_HEADER_FUNCTION headerFunction,  /**< Function receiving the dimensions (may be \c NULL). */
+  CMR_SPARSE_COLUMN_FUNCTION columnFunction,  /**< Function receiving each column. */
+  void* data                                  /**< User data passed to the functions. */
+);
+
 /**
  * \brief Reads a double matrix from a file \p stream in dense format.
  *
@@ -691,6 +948,402 @@ CMR_ERROR CMRchrmatCreateFromDenseFile(
   CMR_CHRMAT** presult    /**< Pointer for storing the matrix. */
 );
 
+/**
+ * \brief Writes a double matrix to \p stream in the [binary format](\ref binary-matrix).
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRdblmatPrintBinary(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_DBLMAT* matrix, /**< A matrix. */
+  FILE* stream        /**< File stream to write to; must be opened in binary mode. */
+);
+
+/**
+ * \brief Writes an int matrix to \p stream in the [binary format](\ref binary-matrix).
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRintmatPrintBinary(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_INTMAT* matrix, /**< A matrix. */
+  FILE* stream        /**< File stream to write to; must be opened in binary mode. */
+);
+
+/**
+ * \brief Writes a char matrix to \p stream in the [binary format](\ref binary-matrix).
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatPrintBinary(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix, /**< A matrix. */
+  FILE* stream        /**< File stream to write to; must be opened in binary mode. */
+);
+
+/**
+ * \brief Reads a double matrix from a file \p stream in the [binary format](\ref binary-matrix).
+ *
+ * The values are converted if the file stores values of a different type. Returns \ref CMR_ERROR_INPUT in case of
+ * errors, in particular if a value cannot be represented. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRdblmatCreateFromBinaryStream(
+  CMR* cmr,             /**< \ref CMR environment. */
+  FILE* stream,         /**< File stream to read from. */
+  CMR_DBLMAT** presult  /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Reads an int matrix from a file \p stream in the [binary format](\ref binary-matrix).
+ *
+ * The values are converted if the file stores values of a different type. Returns \ref CMR_ERROR_INPUT in case of
+ * errors, in particular if a value cannot be represented. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRintmatCreateFromBinaryStream(
+  CMR* cmr,             /**< \ref CMR environment. */
+  FILE* stream,         /**< File stream to read from. */
+  CMR_INTMAT** presult  /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Reads a char matrix from a file \p stream in the [binary format](\ref binary-matrix).
+ *
+ * The values are converted if the file stores values of a different type. Returns \ref CMR_ERROR_INPUT in case of
+ * errors, in particular if a value cannot be represented. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatCreateFromBinaryStream(
+  CMR* cmr,             /**< \ref CMR environment. */
+  FILE* stream,         /**< File stream to read from. */
+  CMR_CHRMAT** presult  /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Reads a double matrix from a file name \p fileName in the [binary format](\ref binary-matrix).
+ *
+ * If the file is a regular file whose values have the matching type, and if the platform is little-endian with
+ * 64-bit \c size_t, then the file is mapped into memory and the arrays of *\p presult point into the mapping, i.e.,
+ * the data is not copied. Such a matrix must not be resized; the mapping is released by the corresponding free
+ * function. Otherwise, the file is read as by \ref CMRdblmatCreateFromBinaryStream.
+ *
+ * Returns \ref CMR_ERROR_INPUT in case of errors. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRdblmatCreateFromBinaryFile(
+  CMR* cmr,               /**< \ref CMR environment. */
+  const char* fileName,   /**< File name to read from. */
+  const char* stdinName,  /**< If not \c NULL, indicates which file name represents stdin. */
+  CMR_DBLMAT** presult    /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Reads an int matrix from a file name \p fileName in the [binary format](\ref binary-matrix).
+ *
+ * If the file is a regular file whose values have the matching type, and if the platform is little-endian with
+ * 64-bit \c size_t, then the file is mapped into memory and the arrays of *\p presult point into the mapping, i.e.,
+ * the data is not copied. Such a matrix must not be resized; the mapping is released by the corresponding free
+ * function. Otherwise, the file is read as by \ref CMRintmatCreateFromBinaryStream.
+ *
+ * Returns \ref CMR_ERROR_INPUT in case of errors. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRintmatCreateFromBinaryFile(
+  CMR* cmr,               /**< \ref CMR environment. */
+  const char* fileName,   /**< File name to read from. */
+  const char* stdinName,  /**< If not \c NULL, indicates which file name represents stdin. */
+  CMR_INTMAT** presult    /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Reads a char matrix from a file name \p fileName in the [binary format](\ref binary-matrix).
+ *
+ * If the file is a regular file whose values have the matching type, and if the platform is little-endian with
+ * 64-bit \c size_t, then the file is mapped into memory and the arrays of *\p presult point into the mapping, i.e.,
+ * the data is not copied. Such a matrix must not be resized; the mapping is released by the corresponding free
+ * function. Otherwise, the file is read as by \ref CMRchrmatCreateFromBinaryStream.
+ *
+ * Returns \ref CMR_ERROR_INPUT in case of errors. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatCreateFromBinaryFile(
+  CMR* cmr,               /**< \ref CMR environment. */
+  const char* fileName,   /**< File name to read from. */
+  const char* stdinName,  /**< If not \c NULL, indicates which file name represents stdin. */
+  CMR_CHRMAT** presult    /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Writer of a [matrix container](\ref matrix-container) file.
+ *
+ * Each added matrix is written immediately as a record, while the index with the names and metadata is written by
+ * \ref CMRmatrixContainerWriterFinish.
+ */
+
+typedef struct CMR_MATRIX_CONTAINER_WRITER CMR_MATRIX_CONTAINER_WRITER;
+
+/**
+ * \brief Creates a writer of a [matrix container](\ref matrix-container) and writes its header to \p stream.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmatrixContainerWriterCreate(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  FILE* stream,                         /**< File stream to write to; must be opened in binary mode. */
+  CMR_MATRIX_CONTAINER_WRITER** pwriter /**< Pointer for storing the writer. */
+);
+
+/**
+ * \brief Writes the index of a [matrix container](\ref matrix-container) and frees the writer.
+ *
+ * The stream is not closed.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmatrixContainerWriterFinish(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_MATRIX_CONTAINER_WRITER** pwriter /**< Pointer to the writer. */
+);
+
+/**
+ * \brief Adds a double matrix as the next record of a [matrix container](\ref matrix-container).
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRdblmatAddToContainer(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_DBLMAT* matrix,                   /**< A matrix. */
+  CMR_MATRIX_CONTAINER_WRITER* writer,  /**< Container writer. */
+  const char* name,                     /**< Name of the record (may be \c NULL). */
+  const char* metadata                  /**< Metadata of the record (may be \c NULL). */
+);
+
+/**
+ * \brief Adds an int matrix as the next record of a [matrix container](\ref matrix-container).
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRintmatAddToContainer(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_INTMAT* matrix,                   /**< A matrix. */
+  CMR_MATRIX_CONTAINER_WRITER* writer,  /**< Container writer. */
+  const char* name,                     /**< Name of the record (may be \c NULL). */
+  const char* metadata                  /**< Metadata of the record (may be \c NULL). */
+);
+
+/**
+ * \brief Adds a char matrix as the next record of a [matrix container](\ref matrix-container).
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatAddToContainer(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,                   /**< A matrix. */
+  CMR_MATRIX_CONTAINER_WRITER* writer,  /**< Container writer. */
+  const char* name,                     /**< Name of the record (may be \c NULL). */
+  const char* metadata                  /**< Metadata of the record (may be \c NULL). */
+);
+
+/**
+ * \brief Opened [matrix container](\ref matrix-container) file that provides random access to its records.
+ *
+ * Records are only read and never modified, so several threads may create matrices from the same container at once,
+ * as long as each uses its own \ref CMR environment.
+ */
+
+typedef struct CMR_MATRIX_CONTAINER CMR_MATRIX_CONTAINER;
+
+/**
+ * \brief Opens the [matrix container](\ref matrix-container) file \p fileName.
+ *
+ * Regular files are mapped into memory if possible and otherwise read completely, like stdin. The index and the
+ * headers of all records are checked. Returns \ref CMR_ERROR_INPUT in case of errors. In this case,
+ * *\p pcontainer will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmatrixContainerOpen(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  const char* fileName,             /**< File name to read from. */
+  const char* stdinName,            /**< If not \c NULL, indicates which file name represents stdin. */
+  CMR_MATRIX_CONTAINER** pcontainer /**< Pointer for storing the container. */
+);
+
+/**
+ * \brief Closes a [matrix container](\ref matrix-container).
+ *
+ * Matrices created from its records remain valid.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmatrixContainerFree(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  CMR_MATRIX_CONTAINER** pcontainer /**< Pointer to the container. */
+);
+
+/**
+ * \brief Returns the number of records of a [matrix container](\ref matrix-container).
+ */
+
+CMR_EXPORT
+size_t CMRmatrixContainerNumRecords(
+  CMR_MATRIX_CONTAINER* container /**< Container. */
+);
+
+/**
+ * \brief Returns the name of record \p record of a [matrix container](\ref matrix-container).
+ *
+ * The string is empty if the record has no name and remains valid until the container is freed.
+ */
+
+CMR_EXPORT
+const char* CMRmatrixContainerRecordName(
+  CMR_MATRIX_CONTAINER* container,  /**< Container. */
+  size_t record                     /**< Index of the record. */
+);
+
+/**
+ * \brief Returns the metadata of record \p record of a [matrix container](\ref matrix-container).
+ *
+ * The string is empty if the record has no metadata and remains valid until the container is freed.
+ */
+
+CMR_EXPORT
+const char* CMRmatrixContainerRecordMetadata(
+  CMR_MATRIX_CONTAINER* container,  /**< Container. */
+  size_t record                     /**< Index of the record. */
+);
+
+/**
+ * \brief Creates a double matrix from record \p record of a [matrix container](\ref matrix-container).
+ *
+ * The values are converted if the record stores values of a different type. Returns \ref CMR_ERROR_INPUT in case of
+ * errors. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRdblmatCreateFromContainer(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  CMR_MATRIX_CONTAINER* container,/**< Container. */
+  size_t record,                  /**< Index of the record. */
+  CMR_DBLMAT** presult            /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Creates an int matrix from record \p record of a [matrix container](\ref matrix-container).
+ *
+ * The values are converted if the record stores values of a different type. Returns \ref CMR_ERROR_INPUT in case of
+ * errors, in particular if a value cannot be represented. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRintmatCreateFromContainer(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  CMR_MATRIX_CONTAINER* container,/**< Container. */
+  size_t record,                  /**< Index of the record. */
+  CMR_INTMAT** presult            /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Creates a char matrix from record \p record of a [matrix container](\ref matrix-container).
+ *
+ * The values are converted if the record stores values of a different type. Returns \ref CMR_ERROR_INPUT in case of
+ * errors, in particular if a value cannot be represented. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatCreateFromContainer(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  CMR_MATRIX_CONTAINER* container,/**< Container. */
+  size_t record,                  /**< Index of the record. */
+  CMR_CHRMAT** presult            /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief File formats of optimization models.
+ */
+
+typedef enum
+{
+  CMR_MODEL_FORMAT_AUTO = 0,  /**< LP format for file names ending with \c .lp, \c .lp.gz or \c .lp.zst; MPS otherwise. */
+  CMR_MODEL_FORMAT_MPS = 1,   /**< Fixed or free MPS format; names must not contain spaces. */
+  CMR_MODEL_FORMAT_LP = 2     /**< CPLEX LP format. */
+} CMR_MODEL_FORMAT;
+
+/**
+ * \brief Selection of the constraints of an optimization model.
+ */
+
+typedef enum
+{
+  CMR_MODEL_ROWS_ALL = 0,         /**< All constraints. */
+  CMR_MODEL_ROWS_EQUALITIES = 1,  /**< Only equality constraints. */
+  CMR_MODEL_ROWS_INEQUALITIES = 2 /**< Only inequality constraints. */
+} CMR_MODEL_ROWS;
+
+/**
+ * \brief Parameters for reading the constraint matrix of an optimization model.
+ */
+
+typedef struct
+{
+  CMR_MODEL_FORMAT format;  /**< \brief File format. */
+  CMR_MODEL_ROWS rows;      /**< \brief Constraints that are turned into rows. */
+  bool integerColumnsOnly;  /**< \brief Whether only variables with integrality constraints are turned into columns. */
+} CMR_MODEL_PARAMS;
+
+/**
+ * \brief Initializes the default parameters for reading the constraint matrix of an optimization model.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmodelParamsInit(
+  CMR_MODEL_PARAMS* params  /**< Pointer to parameters. */
+);
+
+/**
+ * \brief Reads the constraint matrix of the optimization model in file \p fileName.
+ *
+ * The rows correspond to the selected constraints and the columns to the selected variables, both in the order of
+ * their first appearance. Objective functions and free rows are ignored, as well as right-hand sides, ranges and
+ * bounds, except that the latter can declare variables as integer or binary. Quadratic, indicator and other general
+ * constraints are not supported. Files compressed in gzip or Zstandard format are decompressed.
+ *
+ * Returns \ref CMR_ERROR_INPUT in case of errors. In this case, *\p presult will be \c NULL.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRdblmatCreateFromModelFile(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  const char* fileName,     /**< File name to read from. */
+  const char* stdinName,    /**< If not \c NULL, indicates which file name represents stdin. */
+  CMR_MODEL_PARAMS* params, /**< Parameters (may be \c NULL for defaults). */
+  CMR_DBLMAT** presult      /**< Pointer for storing the matrix. */
+);
+
+/**
+ * \brief Reads the constraint matrix of the optimization model in file \p fileName as an int matrix.
+ *
+ * Like \ref CMRdblmatCreateFromModelFile, but returns \ref CMR_ERROR_INPUT if a coefficient is not an integer that is
+ * representable as an \c int.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRintmatCreateFromModelFile(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  const char* fileName,     /**< File name to read from. */
+  const char* stdinName,    /**< If not \c NULL, indicates which file name represents stdin. */
+  CMR_MODEL_PARAMS* params, /**< Parameters (may be \c NULL for defaults). */
+  CMR_INTMAT** presult      /**< Pointer for storing the matrix. */
+);
+
 /**
  * \brief Checks whether two double matrices are equal.
  */
@@ -844,6 +1497,154 @@ CMR_ERROR CMRchrmatZoomSubmat(
   CMR_CHRMAT** presult    /**< Pointer for storing the resulting double matrix. */
 );
 
+/**
+ * \brief Row-wise view of a submatrix of a char matrix that does not copy any nonzeros.
+ *
+ * The view consists of the parent matrix together with index maps for its rows and columns. Rows and columns of the
+ * view can be hidden without changing the index space. The nonzeros of (visible) view row \c row are those entries
+ * \c e of parent row \c rows[row] for which \c parentColumns[entryColumns[e]] is not \c SIZE_MAX; the latter is
+ * then the view column of the entry. Note that the nonzeros of a view row are only sorted by column if \c columns is
+ * sorted.
+ *
+ * A view becomes invalid as soon as its parent matrix is modified or freed.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* parent;     /**< \brief Matrix that is viewed. */
+  size_t numRows;         /**< \brief Number of rows of the view. */
+  size_t numColumns;      /**< \brief Number of columns of the view. */
+  size_t* rows;           /**< \brief Maps each view row to a row of \ref parent. */
+  size_t* columns;        /**< \brief Maps each view column to a column of \ref parent. */
+  size_t* parentColumns;  /**< \brief Maps each column of \ref parent to its view column, or to \c SIZE_MAX if the
+                           **  column is not part of the view or hidden. */
+  uint64_t* rowFilter;    /**< \brief Bitmap of hidden view rows; \c NULL if no row was ever hidden. */
+} CMR_CHRMAT_VIEW;
+
+/**
+ * \brief Creates a view of the submatrix \p submatrix of \p matrix.
+ *
+ * Only the index maps are allocated, which requires \f$ \mathcal{O}(m + n) \f$ time for an \f$ m \times n \f$
+ * matrix.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatViewCreate(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,       /**< Parent matrix. */
+  CMR_SUBMAT* submatrix,    /**< Submatrix of \p matrix to be viewed; \c NULL for the whole matrix. */
+  CMR_CHRMAT_VIEW** pview   /**< Pointer for storing the view. */
+);
+
+/**
+ * \brief Frees the memory of a view (but not of its parent matrix).
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatViewFree(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT_VIEW** pview /**< Pointer to view. */
+);
+
+/**
+ * \brief Creates a view of the submatrix \p submatrix of the view \p view.
+ *
+ * The resulting view refers to the parent matrix of \p view directly. Hidden rows and columns of \p view that are
+ * part of \p submatrix remain hidden. This replaces \ref CMRsubmatZoomSubmat() followed by
+ * \ref CMRchrmatZoomSubmat() without copying any nonzeros.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatViewRestrict(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT_VIEW* view,    /**< A view. */
+  CMR_SUBMAT* submatrix,    /**< Submatrix of \p view. */
+  CMR_CHRMAT_VIEW** presult /**< Pointer for storing the restricted view. */
+);
+
+/**
+ * \brief Hides or shows row \p row of the view \p view.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatViewSetRowHidden(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT_VIEW* view,  /**< A view. */
+  size_t row,             /**< Row of \p view. */
+  bool hidden             /**< Whether the row shall be hidden. */
+);
+
+/**
+ * \brief Hides or shows column \p column of the view \p view.
+ */
+
+CMR_EXPORT
+void CMRchrmatViewSetColumnHidden(
+  CMR_CHRMAT_VIEW* view,  /**< A view. */
+  size_t column,          /**< Column of \p view. */
+  bool hidden             /**< Whether the column shall be hidden. */
+);
+
+/**
+ * \brief Returns \c true if and only if row \p row of the view \p view is hidden.
+ */
+
+static inline
+bool CMRchrmatViewIsRowHidden(
+  CMR_CHRMAT_VIEW* view,  /**< A view. */
+  size_t row              /**< Row of \p view. */
+)
+{
+  return view->rowFilter && ((view->rowFilter[row / 64] >> (row % 64)) & 1);
+}
+
+/**
+ * \brief Returns \c true if and only if column \p column of the view \p view is hidden.
+ */
+
+static inline
+bool CMRchrmatViewIsColumnHidden(
+  CMR_CHRMAT_VIEW* view,  /**< A view. */
+  size_t column           /**< Column of \p view. */
+)
+{
+  return view->parentColumns[view->columns[column]] == SIZE_MAX;
+}
+
+/**
+ * \brief Returns the number of nonzeros of the view \p view, ignoring hidden rows and columns.
+ */
+
+CMR_EXPORT
+size_t CMRchrmatViewNumNonzeros(
+  CMR_CHRMAT_VIEW* view /**< A view. */
+);
+
+/**
+ * \brief Creates the submatrix of the parent matrix that consists of the visible rows and columns of \p view.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatViewToSubmat(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT_VIEW* view,  /**< A view. */
+  CMR_SUBMAT** psubmatrix /**< Pointer for storing the submatrix. */
+);
+
+/**
+ * \brief Creates the matrix represented by \p view as an explicit matrix.
+ *
+ * Hidden rows and columns are kept as zero rows and columns, so that the index space of the result is that of
+ * \p view.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRchrmatViewMaterialize(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT_VIEW* view,  /**< A view. */
+  CMR_CHRMAT** presult    /**< Pointer for storing the explicit matrix. */
+);
+
 /**
  * \brief Checks if a double matrix has only entries in \f$ \{0,1\} \f$ with absolute error tolerance \p epsilon.
  */
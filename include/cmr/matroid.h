@@ -58,7 +58,8 @@ CMR_ERROR CMRchrmatTernaryPivot(
 /**
  * \brief Applies a sequence of pivots to \p matrix and returns the resulting matrix in \p *presult.
  *
- * Calculations are done over the binary field.
+ * Calculations are done over the binary field. As soon as the (intermediate) matrix is sufficiently dense, the
+ * remaining pivots are carried out on bit-packed rows.
  */
 
 CMR_EXPORT
@@ -74,7 +75,8 @@ CMR_ERROR CMRchrmatBinaryPivots(
 /**
  * \brief Applies a sequence of pivots to \p matrix and returns the resulting matrix in \p *presult.
  *
- * Calculations are done over the ternary field.
+ * Calculations are done over the ternary field. As soon as the (intermediate) matrix is sufficiently dense, the
+ * remaining pivots are carried out on bit-packed rows, using two bit planes.
  */
 
 CMR_EXPORT
@@ -539,6 +541,35 @@ bool* CMRmatroiddecCographArcsReversed(
   CMR_MATROID_DEC* dec  /**< Decomposition node. */
 );
 
+/**
+ * \brief Constructs the graph of a graphic/network node unless it is already available.
+ *
+ * Reruns the graphicness test (resp. the network test) for the matrix of \p dec and keeps the resulting graph, its
+ * forest, its coforest and, for ternary nodes, the reversed arcs, such that \ref CMRmatroiddecGraph and related
+ * functions return them afterward. This allows to skip the construction during the regularity test via
+ * \ref CMR_REGULAR_PARAMS::graphs and to construct the graphs of nodes that are inspected later.
+ *
+ * Returns \ref CMR_ERROR_INPUT if \p dec is not graphic/network. Concurrent calls for the same node are not allowed.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmatroiddecConstructGraph(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec  /**< Decomposition node. */
+);
+
+/**
+ * \brief Constructs the cograph of a cographic/conetwork node unless it is already available.
+ *
+ * The analogue of \ref CMRmatroiddecConstructGraph for \ref CMRmatroiddecCograph and related functions.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmatroiddecConstructCograph(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec  /**< Decomposition node. */
+);
+
 /**
  * \brief Returns the number of pivots (if available).
  */
@@ -584,6 +615,34 @@ CMR_ERROR CMRmatroiddecPrint(
   bool printPivots              /**< Whether to print pivots. */
 );
 
+/**
+ * \brief Writes the decomposition tree rooted at \p dec to \p stream in a binary format.
+ *
+ * The format stores all nodes including their intermediate state, e.g., nested minors of unfinished nodes. All node
+ * matrices are stored in the binary matrix format (see \ref CMRchrmatPrintBinary) at offsets that are multiples of 8,
+ * such that they can be mapped into memory. The format is described in \ref file-formats.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmatroiddecPrintBinary(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec, /**< Decomposition node. */
+  FILE* stream          /**< File stream to write to. */
+);
+
+/**
+ * \brief Reads a decomposition tree written by \ref CMRmatroiddecPrintBinary from \p stream.
+ *
+ * Returns \ref CMR_ERROR_INPUT if the input is truncated or inconsistent.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRmatroiddecCreateFromBinaryStream(
+  CMR* cmr,               /**< \ref CMR environment. */
+  FILE* stream,           /**< File stream to read from. */
+  CMR_MATROID_DEC** pdec  /**< Pointer for storing the decomposition tree. */
+);
+
 /**
  * \brief Frees a decomposition node and all its (grand-)children.
  */
@@ -59,6 +59,31 @@ CMR_ERROR CMRnetworkStatsPrint(
   CMR_NETWORK_STATISTICS* stats,  /**< Pointer to statistics. */
   const char* prefix              /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
+
+/**
+ * \brief Prints statistics for recognition algorithm for [network matrices](\ref network) as a JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRnetworkStatsPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRnetworkStatsPrintJson(
+  FILE* stream,                  /**< File stream to print to. */
+  CMR_NETWORK_STATISTICS* stats  /**< Pointer to statistics. */
+);
+
+/**
+ * \brief Adds the statistics \p source for network computations to \p target.
+ *
+ * This merges the statistics that were collected separately, e.g., by several workers.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRnetworkStatsAdd(
+  CMR_NETWORK_STATISTICS* target, /**< Statistics to add to. */
+  CMR_NETWORK_STATISTICS* source  /**< Statistics to be added. */
+);
   
 /**
  * \brief Computes the network matrix of a given digraph \f$ D = (V,A) \f$.
@@ -101,6 +126,10 @@ CMR_ERROR CMRnetworkComputeMatrix(
  *       \ref CMRtestConetworkMatrix() for that. In fact, the implementation explicitly constructs
  *       \f$ M^{\mathsf{T}} \f$ before calling this function.
  *
+ * If \p psupportIsGraphic is \c NULL, then the signs of prefixes of the columns are checked while the support is
+ * tested for graphicness, such that a matrix with a non-Camion submatrix is rejected before the whole support is
+ * processed.
+ *
  * If \f$ M \f$ is a network matrix and \p pdigraph != \c NULL, then one possible digraph \f$ D \f$ is computed and
  * stored in \p *pdigraph. The caller must release its memory via \ref CMRgraphFree.
  * If in addition to \p pdigraph also \p pforestArcs != \c NULL (resp. \p pcoforestArcs != \c NULL), then a
@@ -141,6 +170,10 @@ CMR_ERROR CMRnetworkTestMatrix(
  * corresponding (directed) spanning forest \f$ T \f$ (resp.\ its complement \f$ A \setminus T \f$) is stored in
  * \p *pforestArcs (resp. \p *pcoforestArcs). The caller must release this memory via \ref CMRfreeBlockArray.
  *
+ * If \p psupportIsCographic is \c NULL, then the signs of prefixes of the rows are checked while the support is tested
+ * for cographicness, such that a matrix with a non-Camion submatrix is rejected before the whole support is
+ * processed.
+ *
  * \note Retrieval of minimal non-conetwork submatrices via \p *psubmatrix is not implemented, yet.
  */
 
@@ -163,6 +196,25 @@ CMR_ERROR CMRnetworkTestTranspose(
   double timeLimit                /**< Time limit to impose. */
 );
 
+/**
+ * \brief Finds a large subset of columns that induces a network submatrix by running greedy searches for several
+ *        column orders in parallel.
+ *
+ * For each order of \ref CMRgraphicTestColumnSubmatrixPortfolio, the columns of an inclusion-wise maximal graphic
+ * subset of the support are found greedily. As long as the corresponding submatrix is not
+ * [Camion-signed](\ref camion), the last appended column of a non-Camion submatrix is removed. The resulting
+ * submatrices are network matrices, and that of the first largest subset is returned.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRnetworkTestColumnSubmatrixPortfolio(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* transpose,    /**< \f$ M^{\mathsf{T}} \f$ */
+  size_t numOrders,         /**< Number of column orders to try. */
+  unsigned int seed,        /**< Seed for the random orders. */
+  CMR_SUBMAT** psubmatrix   /**< Pointer for storing the submatrix. */
+);
+
 /**@}*/
 
 #ifdef __cplusplus
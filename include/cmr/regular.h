@@ -21,19 +21,183 @@ extern "C" {
 #include <cmr/graphic.h>
 #include <cmr/network.h>
 
+/**
+ * \brief Specifies the order in which the nodes of a decomposition tree are processed.
+ *
+ * The order does not affect the result, but it affects how quickly a test that does not compute a complete
+ * decomposition tree finds a non-regular node. The size of a node is the sum of its numbers of rows and columns.
+ */
+
+typedef enum
+{
+  CMR_REGULAR_SCHEDULE_DEPTH_FIRST = 0,       /**< The most recently created node is processed first. */
+  CMR_REGULAR_SCHEDULE_SMALLEST_FIRST = 1,    /**< A node of minimum size is processed first. */
+  CMR_REGULAR_SCHEDULE_LARGEST_FIRST = 2,     /**< A node of maximum size is processed first, which balances the load
+                                               **  of parallel workers. */
+  CMR_REGULAR_SCHEDULE_SMALL_DENSE_FIRST = 3, /**< A node of minimum size divided by density is processed first. */
+} CMR_REGULAR_SCHEDULE;
+
+/**
+ * \brief Specifies for which nodes of a decomposition tree the (co)graphs are kept.
+ *
+ * With \ref CMR_DEC_CONSTRUCT_NONE, the (co)graphicness tests do not construct the (co)graphs at all, which saves time
+ * and memory, while with \ref CMR_DEC_CONSTRUCT_LEAVES, the (co)graphs of inner nodes are freed once the node is
+ * processed. Graphs that are not kept can be constructed later via \ref CMRmatroiddecConstructGraph and
+ * \ref CMRmatroiddecConstructCograph.
+ */
+
 typedef enum
 {
-  CMR_DEC_CONSTRUCT_NONE = 0,
-  CMR_DEC_CONSTRUCT_LEAVES = 1,
-  CMR_DEC_CONSTRUCT_ALL = 2,
+  CMR_DEC_CONSTRUCT_NONE = 0,   /**< No node keeps its (co)graph. */
+  CMR_DEC_CONSTRUCT_LEAVES = 1, /**< Only nodes without children keep their (co)graphs. */
+  CMR_DEC_CONSTRUCT_ALL = 2,    /**< All nodes keep their (co)graphs. */
 } CMR_DEC_CONSTRUCT;
 
+/**
+ * \brief Cache of regular leaves of decompositions.
+ *
+ * Decompositions of block-structured matrices often have many leaves whose matrices agree up to row and column
+ * permutations. If a cache is passed via \ref CMR_REGULAR_PARAMS::cache, each graphic, cographic or \f$ R_{10} \f$
+ * leaf is stored together with its (co)graphs (if they were constructed), and a later node with the same matrix, which
+ * may stem from another regularity test, becomes such a leaf without being tested again. Matrices are compared
+ * exactly, but some permutations of highly symmetric matrices may not be recognized as equal.
+ */
+
+typedef struct CMR_REGULAR_CACHE CMR_REGULAR_CACHE;
+
+/**
+ * \brief Creates an empty cache for regularity tests.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularCacheCreate(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE** pcache  /**< Pointer for storing the cache. */
+);
+
+/**
+ * \brief Frees a cache for regularity tests.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularCacheFree(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE** pcache  /**< Pointer to the cache. */
+);
+
+/**
+ * \brief Returns the number of leaves stored in a cache for regularity tests.
+ */
+
+CMR_EXPORT
+size_t CMRregularCacheNumEntries(
+  CMR_REGULAR_CACHE* cache  /**< Cache. */
+);
+
+/**
+ * \brief Writes all leaves stored in a cache for regularity tests to \p stream in a binary format.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularCacheWrite(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE* cache, /**< Cache. */
+  FILE* stream              /**< File stream to write to. */
+);
+
+/**
+ * \brief Adds the leaves written by \ref CMRregularCacheWrite from \p stream to a cache for regularity tests.
+ *
+ * Leaves whose matrices are already stored are skipped. Returns \ref CMR_ERROR_INPUT if the data is invalid, in
+ * which case the leaves read so far remain in the cache.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularCacheRead(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE* cache, /**< Cache. */
+  FILE* stream              /**< File stream to read from. */
+);
+
+/**
+ * \brief State of a regularity test that was stopped due to its time limit.
+ *
+ * If a checkpoint is passed via \ref CMR_REGULAR_PARAMS::checkpoint and the test returns \ref CMR_ERROR_TIMEOUT
+ * (also due to \ref CMRinterrupt), the checkpoint takes over the partial decomposition tree together with the nodes
+ * that still have to be processed. Since every node records how far its processing got, a later test of the same
+ * matrix with the same checkpoint continues from there instead of starting over, and empties the checkpoint. A
+ * checkpoint can be written to a file in order to continue in another process.
+ */
+
+typedef struct CMR_REGULAR_CHECKPOINT CMR_REGULAR_CHECKPOINT;
+
+/**
+ * \brief Creates an empty checkpoint for regularity tests.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularCheckpointCreate(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_REGULAR_CHECKPOINT** pcheckpoint  /**< Pointer for storing the checkpoint. */
+);
+
+/**
+ * \brief Frees a checkpoint for regularity tests, including a stored state.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularCheckpointFree(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_REGULAR_CHECKPOINT** pcheckpoint  /**< Pointer to the checkpoint. */
+);
+
+/**
+ * \brief Returns the number of decomposition nodes whose processing is pending in a checkpoint.
+ *
+ * This is 0 if and only if the checkpoint is empty.
+ */
+
+CMR_EXPORT
+size_t CMRregularCheckpointNumPending(
+  CMR_REGULAR_CHECKPOINT* checkpoint  /**< Checkpoint. */
+);
+
+/**
+ * \brief Writes the state stored in a non-empty checkpoint to \p stream in a binary format.
+ *
+ * The format consists of the pending nodes followed by the decomposition tree as written by
+ * \ref CMRmatroiddecPrintBinary.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularCheckpointWrite(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  CMR_REGULAR_CHECKPOINT* checkpoint, /**< Checkpoint. */
+  FILE* stream                        /**< File stream to write to. */
+);
+
+/**
+ * \brief Replaces the state of a checkpoint by the one written by \ref CMRregularCheckpointWrite to \p stream.
+ *
+ * Returns \ref CMR_ERROR_INPUT if the data is invalid, in which case the checkpoint is empty.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularCheckpointRead(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  CMR_REGULAR_CHECKPOINT* checkpoint, /**< Checkpoint. */
+  FILE* stream                        /**< File stream to read from. */
+);
+
 typedef struct
 {
   bool directGraphicness;
   /**< \brief Whether to use fast graphicness routines; default: \c true */
   bool seriesParallel;
   /**< \brief Whether to allow series-parallel operations in the decomposition tree; default: \c true */
+  bool directTwoSums;
+  /**< \brief Whether to split off 2-sums at cut vertices of the support graph before the series-parallel reductions;
+   *          default: \c true */
   bool planarityCheck;
   /**< \brief Whether minors identified as graphic should still be checked for cographicness; default: \c false. */
   bool completeTree;
@@ -73,7 +237,39 @@ typedef struct
    ** distribution. */
 
   CMR_DEC_CONSTRUCT graphs;
-  /**< \brief Which (co)graphs to construct; default: \ref CMR_DEC_CONSTRUCT_NONE. */
+  /**< \brief Which (co)graphs to keep in the decomposition tree; default: \ref CMR_DEC_CONSTRUCT_ALL. */
+  bool keepIntermediate;
+  /**< \brief Whether finished decomposition nodes keep the data that is only needed while they are processed, e.g.,
+   ** transposes and sequences of nested minors; default: \c false. It is ignored close to the memory limit set by
+   ** \ref CMRsetMemoryLimit. */
+  CMR_REGULAR_SCHEDULE schedule;
+  /**< \brief Order in which decomposition nodes are processed; default: \ref CMR_REGULAR_SCHEDULE_DEPTH_FIRST. */
+  bool deterministic;
+  /**< \brief Whether the (partial) decomposition tree shall not depend on the number of threads; default: \c false.
+   **
+   ** If \ref completeTree is \c false, then the workers stop as soon as some node is found to be irregular, which
+   ** leaves a tree that depends on the timing. In deterministic mode, the tree is the one of a single-threaded
+   ** \ref CMR_REGULAR_SCHEDULE_DEPTH_FIRST processing: the workers continue with all nodes that precede the first
+   ** irregular node in that order, and nodes processed beyond it are restored afterwards. The schedule then only
+   ** determines the order in which the workers pick the nodes. */
+  CMR_REGULAR_CACHE* cache;
+  /**< \brief Cache of regular leaves to use and extend (may be \c NULL); default: \c NULL. */
+  CMR_REGULAR_CHECKPOINT* checkpoint;
+  /**< \brief Checkpoint that receives the state of a test that runs out of time and from which a test of the same
+   **         matrix continues (may be \c NULL); default: \c NULL. */
+  double nodeTimeLimit;
+  /**< \brief Time limit in seconds for each processing step of a single decomposition node, or 0 for none;
+   **         default: 0.
+   **
+   ** A node whose processing step exceeds this budget is skipped, i.e., it remains a leaf of type
+   ** \ref CMR_MATROID_DEC_TYPE_UNKNOWN, and the remaining nodes are processed as usual. A complete decomposition then
+   ** returns a tree in which only the skipped subtrees are unknown. A test whose result depends on a skipped node
+   ** returns \ref CMR_ERROR_TIMEOUT, and a \ref checkpoint takes over the skipped nodes such that they can be
+   ** processed later with a larger budget. The budget is ignored in \ref deterministic mode since it makes the tree
+   ** depend on the timing. */
+  bool smallMatrices;
+  /**< \brief Whether matrices with at most 16 rows and columns are first tested by an enumeration on bitmasks with a
+   **         bounded amount of work, unless a decomposition or a minor is requested; default: \c true. */
 } CMR_REGULAR_PARAMS;
 
 /**
@@ -87,8 +283,81 @@ CMR_ERROR CMRregularParamsInit(
   CMR_REGULAR_PARAMS* params  /**< Pointer to parameters. */
 );
 
+/**
+ * \brief Phases of the processing of a node of the decomposition tree in a regularity test.
+ */
+
+typedef enum
+{
+  CMR_REGULAR_PHASE_ONE_SUM = 0,            /**< Search for 1-separations. */
+  CMR_REGULAR_PHASE_GRAPHIC = 1,            /**< Direct test for graphicness or being network. */
+  CMR_REGULAR_PHASE_COGRAPHIC = 2,          /**< Direct test for cographicness or being conetwork. */
+  CMR_REGULAR_PHASE_R10 = 3,                /**< Test for being \f$ R_{10} \f$. */
+  CMR_REGULAR_PHASE_SERIES_PARALLEL = 4,    /**< Series-parallel reductions. */
+  CMR_REGULAR_PHASE_SEQUENCE_EXTENSION = 5, /**< Construction of a sequence of nested minors. */
+  CMR_REGULAR_PHASE_SEQUENCE_GRAPHIC = 6,   /**< Graphicness and cographicness tests along the sequence of nested
+                                             **  minors, which share one traversal. */
+  CMR_REGULAR_PHASE_SEQUENCE_COGRAPHIC = 7, /**< Cographicness test along the sequence of nested minors if
+                                             **  graphicness was already decided. */
+  CMR_REGULAR_PHASE_THREE_SEPARATION = 8,   /**< Search for 3-separations along the sequence of nested minors. */
+  CMR_REGULAR_PHASE_TWO_SUM = 9,            /**< Search for 2-separations at cut vertices of the support graph. */
+} CMR_REGULAR_PHASE;
+
+#define CMR_REGULAR_NUM_PHASES 10     /**< Number of values of \ref CMR_REGULAR_PHASE. */
+#define CMR_REGULAR_HISTOGRAM_BINS 32 /**< Number of bins of the histograms in \ref CMR_REGULAR_PHASE_STATS. */
+
+/**
+ * \brief Returns the name of \p phase as used in the statistics output.
+ */
+
+CMR_EXPORT
+const char* CMRregularPhaseName(
+  CMR_REGULAR_PHASE phase /**< Phase. */
+);
+
+/**
+ * \brief Statistics for one phase of the processing of decomposition nodes.
+ *
+ * Bin 0 of \ref sizeHistogram counts nodes whose matrix has no nonzeros and bin \f$ k \geq 1 \f$ counts those with
+ * between \f$ 2^{k-1} \f$ and \f$ 2^k - 1 \f$ nonzeros. Similarly, bin 0 of \ref timeHistogram counts nodes processed
+ * in less than a microsecond and bin \f$ k \geq 1 \f$ counts those that took between \f$ 2^{k-1} \f$ and
+ * \f$ 2^k \f$ microseconds. The last bin of each histogram also counts all larger values.
+ */
+
+typedef struct
+{
+  uint32_t count;                                 /**< Number of processed nodes. */
+  double time;                                    /**< Total time of processing these nodes. */
+  double maxTime;                                 /**< Maximum time of processing a single node. */
+  uint32_t sizeHistogram[CMR_REGULAR_HISTOGRAM_BINS]; /**< Histogram of the numbers of nonzeros of the nodes. */
+  uint32_t timeHistogram[CMR_REGULAR_HISTOGRAM_BINS]; /**< Histogram of the processing times of the nodes. */
+} CMR_REGULAR_PHASE_STATS;
+
+#define CMR_REGULAR_MAX_WORKERS 64 /**< Number of workers for which \ref CMR_REGULAR_STATS keeps separate
+                                   **  statistics. */
+
+/**
+ * \brief Statistics for one worker of the parallel processing of decomposition nodes.
+ */
+
+typedef struct
+{
+  uint32_t count; /**< Number of nodes processed by the worker. */
+  double time;    /**< Total time of processing these nodes. */
+} CMR_REGULAR_WORKER_STATS;
+
 /**
  * \brief Statistics for regular matroid recognition algorithm.
+ *
+ * If \ref nodeLog is not \c NULL, then each processing of a decomposition node appends one line with comma-separated
+ * values to it. These are the phase name, the numbers of rows, columns and nonzeros of the node's matrix, the
+ * processing time in seconds, and the \ref CMR_MATROID_DEC_TYPE and the regularity of the node afterwards, where the
+ * latter is positive for regular, negative for irregular, and 0 if unknown. \ref CMRregularNodeLogHeader prints a
+ * matching header line.
+ *
+ * If the nodes are processed by several workers, then \ref workers contains the nodes and the processing time of each
+ * worker, which indicates how well the work was balanced. Worker \f$ w \f$ is counted at index
+ * \f$ w \bmod \f$ \ref CMR_REGULAR_MAX_WORKERS.
  */
 
 typedef struct
@@ -101,13 +370,35 @@ typedef struct
   CMR_CAMION_STATISTICS camion;         /**< Statistics for Camion signing. */
   uint32_t sequenceExtensionCount;      /**< Number of extensions of sequences of nested minors. */
   double sequenceExtensionTime;         /**< Time of extensions of sequences of nested minors. */
+  CMR_COUNTERS sequenceExtensionCounters; /**< Hardware counters of extensions of sequences of nested minors; see
+                                           **  \ref CMRsetHardwareCounters. */
   uint32_t sequenceGraphicCount;        /**< Number (co)graphicness tests applied to sequence of nested minors. */
   double sequenceGraphicTime;           /**< Time of (co)graphicness tests applied to sequence of nested minors. */
   uint32_t enumerationCount;            /**< Number of calls to enumeration algorithm for candidate 3-separations. */
   double enumerationTime;               /**< Time of enumeration of candidate 3-separations. */
+  CMR_COUNTERS enumerationCounters;     /**< Hardware counters of the calling thread of enumerations of candidate
+                                         **  3-separations; see \ref CMRsetHardwareCounters. */
   uint32_t enumerationCandidatesCount;  /**< Number of enumerated candidates for 3-separations. */
+  uint32_t cacheLookupCount;            /**< Number of nodes looked up in \ref CMR_REGULAR_PARAMS::cache. */
+  uint32_t cacheHitCount;               /**< Number of nodes found in \ref CMR_REGULAR_PARAMS::cache. */
+  uint32_t skippedCount;                /**< Number of nodes skipped due to
+                                         **  \ref CMR_REGULAR_PARAMS::nodeTimeLimit. */
+  CMR_REGULAR_PHASE_STATS phases[CMR_REGULAR_NUM_PHASES]; /**< Statistics for each \ref CMR_REGULAR_PHASE. */
+  uint32_t numWorkers;                  /**< Number of valid entries of \ref workers; 0 if no node was processed
+                                         **  by several workers. */
+  CMR_REGULAR_WORKER_STATS workers[CMR_REGULAR_MAX_WORKERS]; /**< Statistics for each worker. */
+  FILE* nodeLog;                        /**< Stream for logging each processed node (default: \c NULL). */
 } CMR_REGULAR_STATS;
 
+/**
+ * \brief Prints the header line of the node log described at \ref CMR_REGULAR_STATS.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularNodeLogHeader(
+  FILE* stream  /**< File stream to print to. */
+);
+
 
 /**
  * \brief Initializes all statistics for regularity test computations.
@@ -128,6 +419,31 @@ CMR_ERROR CMRregularStatsPrint(
   CMR_REGULAR_STATS* stats, /**< Pointer to statistics. */
   const char* prefix        /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
+
+/**
+ * \brief Prints statistics for regularity test computations as a JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRregularStatsPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularStatsPrintJson(
+  FILE* stream,             /**< File stream to print to. */
+  CMR_REGULAR_STATS* stats  /**< Pointer to statistics. */
+);
+
+/**
+ * \brief Adds the statistics \p source for regularity test computations to \p target.
+ *
+ * This merges the statistics that were collected separately, e.g., by several workers.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRregularStatsAdd(
+  CMR_REGULAR_STATS* target, /**< Statistics to add to. */
+  CMR_REGULAR_STATS* source  /**< Statistics to be added. */
+);
   
 /**
  * \brief Tests binary linear matroid for regularity.
@@ -137,7 +453,9 @@ CMR_ERROR CMRregularStatsPrint(
  * information in order to determine regularity.
  *
  * If \p pminor is not \c NULL and \p matrix is not regular, then an \f$ F_7 \f$ or \f$ F_7^\star \f$ minor is searched.
- * This causes additional computational effort!
+ * The search only considers the small nested minor of the irregular node of the decomposition tree that is neither
+ * graphic nor cographic, and maps the minor found there back to \p matrix. Hence, \c *pminor may remain \c NULL,
+ * e.g., if the path to that node involves a 3-sum.
  */
 
 CMR_EXPORT
@@ -146,7 +464,7 @@ CMR_ERROR CMRregularTest(
   CMR_CHRMAT* matrix,         /**< Input matrix. */
   bool *pisRegular,           /**< Pointer for storing whether \p matrix is regular. */
   CMR_MATROID_DEC** pdec,     /**< Pointer for storing the decomposition tree (may be \c NULL). */
-  CMR_MINOR** pminor,         /**< Pointer for storing an \f$ F_7 \f$ or \f$ F_7^\star \f$ minor. */
+  CMR_MINOR** pminor,         /**< Pointer for storing an \f$ F_7 \f$ or \f$ F_7^\star \f$ minor (may be \c NULL). */
   CMR_REGULAR_PARAMS* params, /**< Parameters for the computation (may be \c NULL for defaults). */
   CMR_REGULAR_STATS* stats,   /**< Statistics for the computation (may be \c NULL). */
   double timeLimit            /**< Time limit to impose. */
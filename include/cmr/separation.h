@@ -310,6 +310,50 @@ CMR_ERROR CMRthreeSum(
   CMR_CHRMAT** presult        /**< Pointer for storing the result. */
 );
 
+/**
+ * \brief Edge of a tree of 2-sums as used by \ref CMRtwoSumTree.
+ *
+ * It joins the matrices with indices \ref first and \ref second via \ref firstMarker and \ref secondMarker, of which
+ * one must be a row and the other a column, as for \ref CMRtwoSum.
+ */
+
+typedef struct
+{
+  size_t first;             /**< \brief Index of first matrix. */
+  size_t second;            /**< \brief Index of second matrix. */
+  CMR_ELEMENT firstMarker;  /**< \brief Marker element of first matrix. */
+  CMR_ELEMENT secondMarker; /**< \brief Marker element of second matrix. */
+} CMR_TWOSUM_EDGE;
+
+/**
+ * \brief Constructs the matrix composed of \p matrices by 2-sums along \p edges and by 1-sums of the remaining
+ *        components.
+ *
+ * The edges must form a forest on the matrices and each marker element may belong to only one edge. The rows of the
+ * result are the non-marker rows of the matrices in the order of the matrices, and the same holds for the columns.
+ * Hence, the result agrees with the one obtained by adding the matrices one at a time via \ref CMRtwoSum and
+ * \ref CMRoneSum in the order of their indices, where each marker refers to the corresponding row or column of the
+ * matrix built so far. In contrast to that, the nonzeros are counted first and the result is created at once, and
+ * each of its rows is written in a single pass. The entry of a row \f$ r \f$ and column \f$ c \f$ of different
+ * matrices is the product of the entries of the markers along the tree path between them.
+ * The calculations are done modulo \p characteristic, where the value \f$ 3 \f$ yields numbers from \f$ \{-1,0,+1\} \f$.
+ *
+ * The resulting matrix is created and stored in \p *presult.
+ *
+ * \returns \ref CMR_ERROR_INPUT if \p edges do not form a forest or if a marker is invalid.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtwoSumTree(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  size_t numMatrices,       /**< Number of matrices. */
+  CMR_CHRMAT** matrices,    /**< Array with the matrices. */
+  size_t numEdges,          /**< Number of edges. */
+  CMR_TWOSUM_EDGE* edges,   /**< Array with the edges of the forest (may be \c NULL if \p numEdges is 0). */
+  int8_t characteristic,    /**< Field characteristic. */
+  CMR_CHRMAT** presult      /**< Pointer for storing the result. */
+);
+
 
 #ifdef __cplusplus
 }
@@ -31,6 +31,7 @@ typedef struct
   double wheelTime;       /**< Time of wheel matrix searches. */
   uint32_t nonbinaryCount;  /**< Number of searches for \f$ M_2 \f$ matrix. */
   double nonbinaryTime;   /**< Time of searches for \f$ M_2 \f$ matrix. */
+  CMR_COUNTERS reduceCounters; /**< Hardware counters of reduction algorithm calls; see \ref CMRsetHardwareCounters. */
 } CMR_SP_STATISTICS;
 
 /**
@@ -53,6 +54,31 @@ CMR_ERROR CMRspStatsPrint(
   const char* prefix        /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
 
+/**
+ * \brief Prints statistics for series-parallel computations as a JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRspStatsPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRspStatsPrintJson(
+  FILE* stream,             /**< File stream to print to. */
+  CMR_SP_STATISTICS* stats  /**< Pointer to statistics. */
+);
+
+/**
+ * \brief Adds the statistics \p source for series-parallel computations to \p target.
+ *
+ * This merges the statistics that were collected separately, e.g., by several workers.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRspStatsAdd(
+  CMR_SP_STATISTICS* target, /**< Statistics to add to. */
+  CMR_SP_STATISTICS* source  /**< Statistics to be added. */
+);
+
 /**
  * \brief Represents a series-parallel reduction
  */
@@ -28,7 +28,18 @@ typedef enum
 typedef struct
 {
   CMR_TU_ALGORITHM algorithm; /**< \brief Algorithm to use. */
-  bool directCamion;          /**< \brief Whether to directly test signing of matrix (default: \c false). */
+  bool directCamion;          /**< \brief Whether to directly test signing of matrix (default: \c false).
+                               **
+                               **  The signs are only tested on the ternary series-parallel reduced submatrix. Unless
+                               **  a decomposition is requested, the regularity test is then also applied to that
+                               **  submatrix only. */
+  bool directTwoByTwo;        /**< \brief Whether to first search for 2-by-2 submatrices with determinant -2 or +2,
+                               **  which takes time quadratic in the numbers of nonzeros per column
+                               **  (default: \c false). */
+  bool directConsecutiveOnes; /**< \brief Whether to first test a binary matrix for the
+                               **  [consecutive ones property](\ref consecutive-ones) for rows or columns, which
+                               **  implies total unimodularity; skipped if a decomposition is requested
+                               **  (default: \c false). */
   CMR_REGULAR_PARAMS regular; /**< \brief Parameters for regularity test. */
 } CMR_TU_PARAMS;
 
@@ -81,6 +92,31 @@ CMR_ERROR CMRtuStatsPrint(
   const char* prefix        /**< Prefix string to prepend to each printed line (may be \c NULL). */
 );
 
+/**
+ * \brief Prints statistics for recognition algorithm for [totally unimodular](\ref tu) matrices as a JSON object.
+ *
+ * The members correspond to the lines printed by \ref CMRtuStatsPrint.
+ * Each count with a time is an object with members \c count and \c time.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtuStatsPrintJson(
+  FILE* stream,        /**< File stream to print to. */
+  CMR_TU_STATS* stats  /**< Pointer to statistics. */
+);
+
+/**
+ * \brief Adds the statistics \p source for total unimodularity test computations to \p target.
+ *
+ * This merges the statistics that were collected separately, e.g., by several workers.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtuStatsAdd(
+  CMR_TU_STATS* target, /**< Statistics to add to. */
+  CMR_TU_STATS* source  /**< Statistics to be added. */
+);
+
 /**
  * \brief Tests a matrix \f$ M \f$ for being [totally unimodular](\ref tu).
  *
@@ -105,6 +141,32 @@ CMR_ERROR CMRtuTest(
   double timeLimit            /**< Time limit to impose. */
 );
 
+/**
+ * \brief Tests each of the matrices \f$ M_1, M_2, \dotsc, M_k \f$ for being [totally unimodular](\ref tu).
+ *
+ * Sets \p isTotallyUnimodular[i] according to whether \p matrices[i] is totally unimodular. If the environment has
+ * several threads (see \ref CMRsetNumThreads), the matrices are distributed dynamically among the workers, and each
+ * worker keeps its stack memory for all matrices it tests. This is intended for many small matrices, for which the
+ * setup of individual calls to \ref CMRtuTest would dominate the running time.
+ *
+ * If \p stats is not \c NULL, then it must be an array with \p numMatrices initialized statistics, and
+ * \p stats[i] is updated by the test of \p matrices[i].
+ *
+ * The time limit applies to the whole batch. If it is exceeded, \ref CMR_ERROR_TIMEOUT is returned and the results of
+ * the matrices that were not tested yet are undefined.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtuTestBatch(
+  CMR* cmr,                   /**< \ref CMR environment */
+  size_t numMatrices,         /**< Number \f$ k \f$ of matrices. */
+  CMR_CHRMAT** matrices,      /**< Array of matrices \f$ M_1, M_2, \dotsc, M_k \f$. */
+  bool* isTotallyUnimodular,  /**< Array for storing whether each matrix is totally unimodular. */
+  CMR_TU_PARAMS* params,      /**< Parameters for the computation (may be \c NULL for defaults). */
+  CMR_TU_STATS* stats,        /**< Array of statistics for each matrix (may be \c NULL). */
+  double timeLimit            /**< Time limit to impose for the whole batch. */
+);
+
 /**
  * \brief Completes a subtree of an existing decomposition tree.
  *
@@ -123,6 +185,95 @@ CMR_ERROR CMRtuCompleteDecomposition(
   double timeLimit        /**< Time limit to impose. */
 );
 
+/**
+ * \brief Structure for maintaining total unimodularity of a matrix whose columns are added and removed.
+ *
+ * The matrix \f$ M \f$ has a fixed number of rows and initially no columns. The structure maintains the 1-sum
+ * decomposition of \f$ M \f$, i.e., its connected components, and whether each of them is totally unimodular. When
+ * a column is added via \ref CMRtuOnlineAddColumn, only the components that it touches are merged and re-tested. If it
+ * touches a single component whose support is graphic, the graph of that component is extended as for
+ * \ref CMRgraphicOnlineAddColumn and only the signs are checked via \ref CMRcamionTestSigns. When a column is removed
+ * via \ref CMRtuOnlineRemoveColumn, only its component is split, and it is only re-tested if it was not totally
+ * unimodular before. All other components are kept as they are.
+ */
+
+typedef struct _CMR_TU_ONLINE CMR_TU_ONLINE;
+
+/**
+ * \brief Creates a \ref CMR_TU_ONLINE structure for a matrix with \p numRows rows and no columns.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtuOnlineCreate(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_TU_ONLINE** ponline,  /**< Pointer for storing the new structure. */
+  size_t numRows,           /**< Number of rows of \f$ M \f$. */
+  CMR_TU_PARAMS* params     /**< Parameters for the re-tests of components (may be \c NULL for defaults); must have
+                             **  \ref CMR_TU_ALGORITHM_DECOMPOSITION as algorithm. */
+);
+
+/**
+ * \brief Frees a \ref CMR_TU_ONLINE structure.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtuOnlineFree(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_TU_ONLINE** ponline   /**< Pointer to the structure (may be \c NULL). */
+);
+
+/**
+ * \brief Returns the number of columns of \f$ M \f$.
+ */
+
+CMR_EXPORT
+size_t CMRtuOnlineNumColumns(
+  CMR_TU_ONLINE* online /**< Online total unimodularity structure. */
+);
+
+/**
+ * \brief Returns the number of connected components of \f$ M \f$ that have at least one nonzero.
+ */
+
+CMR_EXPORT
+size_t CMRtuOnlineNumComponents(
+  CMR_TU_ONLINE* online /**< Online total unimodularity structure. */
+);
+
+/**
+ * \brief Appends a column to \f$ M \f$ and tests whether the resulting matrix is totally unimodular.
+ *
+ * The column is given by the rows of its nonzero entries, which must be distinct, and their values, which must be
+ * \f$ -1 \f$ or \f$ +1 \f$. The column is appended even if \f$ M \f$ is not totally unimodular afterwards.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtuOnlineAddColumn(
+  CMR_TU_ONLINE* online,      /**< Online total unimodularity structure. */
+  size_t numEntries,          /**< Number of nonzeros of the new column. */
+  size_t* rows,               /**< Array with the rows of the nonzeros of the new column. */
+  char* values,               /**< Array with the values of the nonzeros of the new column. */
+  bool* pisTotallyUnimodular, /**< Pointer for storing whether \f$ M \f$ with the new column is totally unimodular. */
+  CMR_TU_STATS* stats,        /**< Statistics for the re-tests (may be \c NULL). */
+  double timeLimit            /**< Time limit to impose. */
+);
+
+/**
+ * \brief Removes a column from \f$ M \f$ and tests whether the resulting matrix is totally unimodular.
+ *
+ * The columns after \p column are shifted by one, i.e., column indices are always those of the current matrix.
+ */
+
+CMR_EXPORT
+CMR_ERROR CMRtuOnlineRemoveColumn(
+  CMR_TU_ONLINE* online,      /**< Online total unimodularity structure. */
+  size_t column,              /**< Column of \f$ M \f$ to remove. */
+  bool* pisTotallyUnimodular, /**< Pointer for storing whether \f$ M \f$ without the column is totally
+                               **  unimodular. */
+  CMR_TU_STATS* stats,        /**< Statistics for the re-tests (may be \c NULL). */
+  double timeLimit            /**< Time limit to impose. */
+);
+
 #ifdef __cplusplus
 }
 #endif
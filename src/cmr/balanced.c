@@ -10,11 +10,15 @@
 #include "sort.h"
 #include "matrix_internal.h"
 #include "camion_internal.h"
+#include "threads.h"
+#include "bitset.h"
+#include "deadline.h"
+#include "intersect.h"
+#include "small_matrix.h"
 
 #include <stdlib.h>
 #include <stdint.h>
 #include <assert.h>
-#include <time.h>
 
 CMR_ERROR CMRbalancedParamsInit(CMR_BALANCED_PARAMS* params)
 {
@@ -61,6 +65,34 @@ CMR_ERROR CMRbalancedStatsPrint(FILE* stream, CMR_BALANCED_STATS* stats, const c
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRbalancedStatsPrintJson(FILE* stream, CMR_BALANCED_STATS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"series-parallel\":");
+  CMR_CALL( CMRspStatsPrintJson(stream, &stats->seriesParallel) );
+  fprintf(stream, ",\"enumerated-row-subsets\":%lu", (unsigned long)stats->enumeratedRowSubsets);
+  fprintf(stream, ",\"enumerated-column-subsets\":%lu", (unsigned long)stats->enumeratedColumnSubsets);
+  fprintf(stream, ",\"total\":{\"count\":%lu,\"time\":%.9g}}", (unsigned long)stats->totalCount, stats->totalTime);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRbalancedStatsAdd(CMR_BALANCED_STATS* target, CMR_BALANCED_STATS* source)
+{
+  assert(target);
+  assert(source);
+
+  target->totalCount += source->totalCount;
+  target->totalTime += source->totalTime;
+  CMR_CALL( CMRspStatsAdd(&target->seriesParallel, &source->seriesParallel) );
+  target->enumeratedRowSubsets += source->enumeratedRowSubsets;
+  target->enumeratedColumnSubsets += source->enumeratedColumnSubsets;
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Data for enumeration.
  */
@@ -69,13 +101,21 @@ typedef struct
 {
   CMR* cmr;                     /**< \ref CMR environment. */
   CMR_CHRMAT* matrix;           /**< Matrix \f$ M \f$. */
+  CMR_CHRMAT* transpose;        /**< Transpose of \f$ M \f$ (if more than 64 rows). */
+  size_t* commonRows;           /**< Array for the positions of a column's rows in \ref subsetRows. */
+  size_t* commonEntries;        /**< Array for the entries of \ref transpose in a column and in \ref subsetRows. */
   bool* pisBalanced;            /**< Pointer for storing whether \f$ M \f$ is balanced. */
   CMR_SUBMAT** psubmatrix;      /**< Pointer for storing a minimal nonbalanced submatrix (may be \c NULL). */
   CMR_BALANCED_STATS* stats;    /**< Statistics for the computation (may be \c NULL). */
-  double timeLimit;             /**< Time limit to impose. */
+  CMR_DEADLINE deadline;        /**< Deadline of the computation. */
+  size_t deadlineTicks;         /**< Counter for checking the deadline. */
+  bool timeout;                 /**< Whether the deadline has passed. */
   bool isTransposed;            /**< Whether we're dealing with the transposed matrix. */
-  clock_t startClock;           /**< Clock for when we started. */
   size_t cardinality;           /**< Current cardinality of row/column subsets. */
+  size_t firstRow;              /**< Row that is selected first, i.e., the top-level choice of the enumeration. */
+  bool* pcancel;                /**< Pointer to a flag that is set when the enumeration shall stop, accessed atomically. */
+  size_t* pwitnessFirstRow;     /**< Pointer to the smallest first row of a violator found so far, accessed
+                                 **  atomically. */
   size_t* subsetRows;           /**< Array for the enumerated row subset. */
   size_t* usableColumns;        /**< Array of columns usable for enumeration. */
   size_t numUsableColumns;      /**< Length of usableColumns. */
@@ -83,8 +123,38 @@ typedef struct
   size_t* columnsNumNonzeros;   /**< Array with the number of nonzeros per column. */
   size_t* rowsNumNonzeros;      /**< Array with the number of nonzeros per row. */
   int sumEntries;               /**< Sum of the entries of the selected submatrix. */
+  uint64_t* columnsPositive;    /**< Array with the bitset of rows with a +1-entry per column (if at most 64 rows). */
+  uint64_t* columnsNegative;    /**< Array with the bitset of rows with a -1-entry per column (if at most 64 rows). */
+  uint64_t rowSubset;           /**< Bitset of the enumerated row subset (if at most 64 rows). */
 } CMR_BALANCED_ENUMERATION;
 
+/**
+ * \brief Stores the currently enumerated submatrix as the violator.
+ */
+
+static
+CMR_ERROR balancedTestStoreViolator(
+  CMR_BALANCED_ENUMERATION* enumeration /**< Enumeration information. */
+)
+{
+  assert(enumeration);
+
+  *(enumeration->pisBalanced) = false;
+  if (enumeration->psubmatrix)
+  {
+    CMR_SUBMAT* submatrix = NULL;
+    CMR_CALL( CMRsubmatCreate(enumeration->cmr, enumeration->cardinality, enumeration->cardinality, &submatrix) );
+    for (size_t i = 0; i < enumeration->cardinality; ++i)
+    {
+      submatrix->rows[i] = enumeration->subsetRows[i];
+      submatrix->columns[i] = enumeration->usableColumns[enumeration->subsetUsable[i]];
+    }
+
+    *(enumeration->psubmatrix) = submatrix;
+  }
+
+  return CMR_OKAY;
+}
 
 /**
  * \brief Recursive enumeration of column subsets and subsequent testing of balancedness.
@@ -115,18 +185,18 @@ CMR_ERROR balancedTestEnumerateColumns(
 
       /* Increment row nonzero counters. */
       bool tooManyNonzeros = false;
-      for (size_t i = 0; i < enumeration->cardinality; ++i)
+      CMR_CHRMAT* transpose = enumeration->transpose;
+      size_t first = transpose->rowSlice[column];
+      size_t numCommon = CMRintersectEmit(enumeration->subsetRows, enumeration->cardinality,
+        &transpose->entryColumns[first], transpose->rowSlice[column + 1] - first, enumeration->commonRows,
+        enumeration->commonEntries);
+      for (size_t i = 0; i < numCommon; ++i)
       {
-        size_t row = enumeration->subsetRows[i];
-        size_t entry;
-        CMRchrmatFindEntry(enumeration->matrix, row, column, &entry);
-        if (entry != SIZE_MAX)
-        {
-          enumeration->sumEntries += enumeration->matrix->entryValues[entry];
-          enumeration->rowsNumNonzeros[row]++;
-          if (enumeration->rowsNumNonzeros[row] > 2)
-            tooManyNonzeros = true;
-        }
+        size_t row = enumeration->subsetRows[enumeration->commonRows[i]];
+        enumeration->sumEntries += transpose->entryValues[first + enumeration->commonEntries[i]];
+        enumeration->rowsNumNonzeros[row]++;
+        if (enumeration->rowsNumNonzeros[row] > 2)
+          tooManyNonzeros = true;
       }
 
       CMRdbgMsg(12 + enumeration->cardinality + numColumns, "Some row has too many nonzeros.\n");
@@ -139,17 +209,14 @@ CMR_ERROR balancedTestEnumerateColumns(
           return CMR_OKAY;
       }
 
-      /* Decrement row nonzero counters. */
-      for (size_t i = 0; i < enumeration->cardinality; ++i)
+      /* Decrement row nonzero counters; the recursion has overwritten the common entries. */
+      numCommon = CMRintersectEmit(enumeration->subsetRows, enumeration->cardinality,
+        &transpose->entryColumns[first], transpose->rowSlice[column + 1] - first, enumeration->commonRows,
+        enumeration->commonEntries);
+      for (size_t i = 0; i < numCommon; ++i)
       {
-        size_t row = enumeration->subsetRows[i];
-        size_t entry;
-        CMRchrmatFindEntry(enumeration->matrix, row, column, &entry);
-        if (entry != SIZE_MAX)
-        {
-          enumeration->sumEntries -= enumeration->matrix->entryValues[entry];
-          enumeration->rowsNumNonzeros[row]--;
-        }
+        enumeration->sumEntries -= transpose->entryValues[first + enumeration->commonEntries[i]];
+        enumeration->rowsNumNonzeros[enumeration->subsetRows[enumeration->commonRows[i]]]--;
       }
     }
   }
@@ -166,22 +233,68 @@ CMR_ERROR balancedTestEnumerateColumns(
     CMRdbgMsg(12 + 2 * enumeration->cardinality, "Sum over nonzeros is %d.\n", enumeration->sumEntries);
 
     if (enumeration->sumEntries % 4 != 0)
+      CMR_CALL( balancedTestStoreViolator(enumeration) );
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Recursive enumeration of column subsets and subsequent testing of balancedness, based on bitsets.
+ *
+ * Variant of \ref balancedTestEnumerateColumns for matrices with at most 64 rows. The selected rows with at least one
+ * and with at least two nonzeros are maintained as bitsets, such that adding a column requires only a few word
+ * operations and two population counts.
+ */
+
+static
+CMR_ERROR balancedTestEnumerateBitsColumns(
+  CMR_BALANCED_ENUMERATION* enumeration,  /**< Enumeration information. */
+  size_t numColumns,                      /**< Number of already selected columns. */
+  uint64_t rowsOnce,                      /**< Bitset of selected rows with at least one nonzero so far. */
+  uint64_t rowsTwice,                     /**< Bitset of selected rows with two nonzeros so far. */
+  int sumEntries                          /**< Sum of the entries of the selected submatrix so far. */
+)
+{
+  assert(enumeration);
+
+  if (numColumns < enumeration->cardinality)
+  {
+    /* Recursion step: pick one column and enumerate over the other columns. */
+
+    size_t firstUsable = (numColumns == 0) ? 0 : enumeration->subsetUsable[numColumns - 1] + 1;
+    size_t beyondUsable = enumeration->numUsableColumns - enumeration->cardinality + numColumns + 1;
+    for (size_t usable = firstUsable; usable < beyondUsable; ++usable)
     {
-      *(enumeration->pisBalanced) = false;
-      if (enumeration->psubmatrix)
-      {
-        CMR_SUBMAT* submatrix = NULL;
-        CMR_CALL( CMRsubmatCreate(enumeration->cmr, enumeration->cardinality, enumeration->cardinality, &submatrix) );
-        for (size_t i = 0; i < enumeration->cardinality; ++i)
-        {
-          submatrix->rows[i] = enumeration->subsetRows[i];
-          submatrix->columns[i] = enumeration->usableColumns[enumeration->subsetUsable[i]];
-        }
+      size_t column = enumeration->usableColumns[usable];
+      uint64_t positive = enumeration->columnsPositive[column] & enumeration->rowSubset;
+      uint64_t negative = enumeration->columnsNegative[column] & enumeration->rowSubset;
+      uint64_t support = positive | negative;
 
-        *(enumeration->psubmatrix) = submatrix;
-      }
+      /* Skip the column if some row would get a third nonzero. */
+      if (support & rowsTwice)
+        continue;
+
+      enumeration->subsetUsable[numColumns] = usable;
+      CMR_CALL( balancedTestEnumerateBitsColumns(enumeration, numColumns + 1, rowsOnce | support,
+        rowsTwice | (rowsOnce & support), sumEntries + (int) CMRbitsetCount(positive) - (int) CMRbitsetCount(negative)) );
+      if (!*enumeration->pisBalanced)
+        return CMR_OKAY;
     }
   }
+  else
+  {
+    if (enumeration->stats)
+    {
+      if (enumeration->isTransposed)
+        enumeration->stats->enumeratedRowSubsets++;
+      else
+        enumeration->stats->enumeratedColumnSubsets++;
+    }
+
+    if (sumEntries % 4 != 0)
+      CMR_CALL( balancedTestStoreViolator(enumeration) );
+  }
 
   return CMR_OKAY;
 }
@@ -189,11 +302,11 @@ CMR_ERROR balancedTestEnumerateColumns(
 /**
  * \brief Recursive enumeration of row subsets and subsequent testing of balancedness.
  *
- * \returns \c true if we can stop (due to time limit or a found violating submatrix).
+ * The first selected row is always \p enumeration->firstRow.
  */
 
 static
-bool balancedTestEnumerateRows(
+CMR_ERROR balancedTestEnumerateRows(
   CMR_BALANCED_ENUMERATION* enumeration,  /**< Enumeration information. */
   size_t numRows                          /**< Number of already selected rows. */
 )
@@ -204,8 +317,9 @@ bool balancedTestEnumerateRows(
   {
     /* Recursion step: pick one row and enumerate over the other rows. */
 
-    size_t firstRow = (numRows == 0) ? 0 : enumeration->subsetRows[numRows - 1] + 1;
-    size_t beyondRow = enumeration->matrix->numRows - enumeration->cardinality + numRows + 1;
+    size_t firstRow = (numRows == 0) ? enumeration->firstRow : enumeration->subsetRows[numRows - 1] + 1;
+    size_t beyondRow = (numRows == 0) ? enumeration->firstRow + 1
+      : enumeration->matrix->numRows - enumeration->cardinality + numRows + 1;
     for (size_t row = firstRow; row < beyondRow; ++row)
     {
       CMRdbgMsg(10 + numRows, "Selecting row %zu as row #%zu.\n", row, numRows);
@@ -214,17 +328,31 @@ bool balancedTestEnumerateRows(
       /* Iterate over chosen row and increment column nonzero counters. */
       size_t first = enumeration->matrix->rowSlice[row];
       size_t beyond = enumeration->matrix->rowSlice[row + 1];
-      for (size_t e = first; e < beyond; ++e)
-        enumeration->columnsNumNonzeros[enumeration->matrix->entryColumns[e]]++;
+      if (enumeration->columnsPositive)
+        enumeration->rowSubset |= ((uint64_t) 1) << row;
+      else
+      {
+        for (size_t e = first; e < beyond; ++e)
+          enumeration->columnsNumNonzeros[enumeration->matrix->entryColumns[e]]++;
+      }
 
       /* Recurse. */
       CMR_CALL( balancedTestEnumerateRows(enumeration, numRows + 1) );
-      if (!*(enumeration->pisBalanced) || enumeration->timeLimit <= 0)
-        return CMR_OKAY;
 
       /* Decrement column nonzero counters again. */
-      for (size_t e = first; e < beyond; ++e)
-        enumeration->columnsNumNonzeros[enumeration->matrix->entryColumns[e]]--;
+      if (enumeration->columnsPositive)
+        enumeration->rowSubset &= ~(((uint64_t) 1) << row);
+      else
+      {
+        for (size_t e = first; e < beyond; ++e)
+          enumeration->columnsNumNonzeros[enumeration->matrix->entryColumns[e]]--;
+      }
+
+      if (!*(enumeration->pisBalanced) || enumeration->timeout || CMRatomicLoadFlag(enumeration->pcancel)
+        || CMRatomicLoad(enumeration->pwitnessFirstRow) < enumeration->firstRow)
+      {
+        return CMR_OKAY;
+      }
     }
   }
   else
@@ -237,22 +365,34 @@ bool balancedTestEnumerateRows(
         enumeration->stats->enumeratedRowSubsets++;
     }
 
-    double remainingTime = enumeration->timeLimit - (clock() - enumeration->startClock) * 1.0 / CLOCKS_PER_SEC;
-    if (remainingTime <= 0)
+    if (CMRdeadlineTick(&enumeration->deadline, &enumeration->deadlineTicks))
     {
-      enumeration->timeLimit = 0;
+      enumeration->timeout = true;
       return CMR_OKAY;
     }
 
-    assert(enumeration->sumEntries == 0);
-    for (size_t i = 0; i < enumeration->cardinality; ++i)
-      assert( enumeration->rowsNumNonzeros[enumeration->subsetRows[i]] == 0 );
-
     enumeration->numUsableColumns = 0;
-    for (size_t column = 0; column < enumeration->matrix->numColumns; ++column)
+    if (enumeration->columnsPositive)
     {
-      if (enumeration->columnsNumNonzeros[column] == 2)
-        enumeration->usableColumns[enumeration->numUsableColumns++] = column;
+      for (size_t column = 0; column < enumeration->matrix->numColumns; ++column)
+      {
+        uint64_t support = (enumeration->columnsPositive[column] | enumeration->columnsNegative[column])
+          & enumeration->rowSubset;
+        if (CMRbitsetCount(support) == 2)
+          enumeration->usableColumns[enumeration->numUsableColumns++] = column;
+      }
+    }
+    else
+    {
+      assert(enumeration->sumEntries == 0);
+      for (size_t i = 0; i < enumeration->cardinality; ++i)
+        assert( enumeration->rowsNumNonzeros[enumeration->subsetRows[i]] == 0 );
+
+      for (size_t column = 0; column < enumeration->matrix->numColumns; ++column)
+      {
+        if (enumeration->columnsNumNonzeros[column] == 2)
+          enumeration->usableColumns[enumeration->numUsableColumns++] = column;
+      }
     }
 
     CMRdbgMsg(10 + numRows, "Number of columns with 2 nonzeros: %zu.\n", enumeration->numUsableColumns);
@@ -260,10 +400,136 @@ bool balancedTestEnumerateRows(
     /* Skip enumeraton of columns if the number of columns with 2 nonzeros is too low. */
     if (enumeration->numUsableColumns >= enumeration->cardinality)
     {
-      CMR_CALL( balancedTestEnumerateColumns(enumeration, 0) );
+      if (enumeration->columnsPositive)
+        CMR_CALL( balancedTestEnumerateBitsColumns(enumeration, 0, 0, 0, 0) );
+      else
+        CMR_CALL( balancedTestEnumerateColumns(enumeration, 0) );
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Data shared by all workers of the enumeration algorithm for a fixed cardinality.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* matrix;               /**< \brief Matrix \f$ M \f$. */
+  bool isTransposed;                /**< \brief Whether we're dealing with the transposed matrix. */
+  CMR_DEADLINE deadline;            /**< \brief Deadline of the computation. */
+  size_t cardinality;               /**< \brief Cardinality of row/column subsets. */
+  uint64_t* columnsPositive;        /**< \brief Bitsets of rows with +1-entries per column, or \c NULL. */
+  uint64_t* columnsNegative;        /**< \brief Bitsets of rows with -1-entries per column, or \c NULL. */
+  CMR_CHRMAT* transpose;            /**< \brief Transpose of \f$ M \f$ if there are no bitsets. */
+  size_t nextFirstRow;              /**< \brief Next top-level row to be enumerated, accessed atomically. */
+  bool cancel;                      /**< \brief Whether all workers shall stop, accessed atomically. */
+  size_t witnessFirstRow;           /**< \brief Smallest first row of a violator found so far, or \c SIZE_MAX,
+                                     **         accessed atomically. */
+  bool* workerIsBalanced;           /**< \brief Array with the result of each worker. */
+  bool* workerTimeout;              /**< \brief Array indicating whether each worker hit the time limit. */
+  size_t* workerFirstRow;           /**< \brief Array with the first row of each worker's violator. */
+  CMR_SUBMAT** workerSubmatrices;   /**< \brief Array with each worker's violator, or \c NULL. */
+  CMR_BALANCED_STATS* workerStats;  /**< \brief Array with each worker's statistics, or \c NULL. */
+} BalancedSearch;
+
+/**
+ * \brief Worker of the enumeration algorithm that processes top-level row choices for a fixed cardinality.
+ */
+
+static
+CMR_ERROR balancedTestEnumerateWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref BalancedSearch. */
+)
+{
+  assert(cmr);
+
+  BalancedSearch* search = (BalancedSearch*) data;
+  CMR_CHRMAT* matrix = search->matrix;
+
+  CMR_BALANCED_ENUMERATION enumeration;
+  enumeration.cmr = cmr;
+  enumeration.matrix = matrix;
+  enumeration.transpose = search->transpose;
+  enumeration.commonRows = NULL;
+  enumeration.commonEntries = NULL;
+  enumeration.pisBalanced = &search->workerIsBalanced[worker];
+  enumeration.psubmatrix = search->workerSubmatrices ? &search->workerSubmatrices[worker] : NULL;
+  enumeration.stats = search->workerStats ? &search->workerStats[worker] : NULL;
+  enumeration.deadline = search->deadline;
+  enumeration.deadlineTicks = 0;
+  enumeration.timeout = false;
+  enumeration.isTransposed = search->isTransposed;
+  enumeration.cardinality = search->cardinality;
+  enumeration.pcancel = &search->cancel;
+  enumeration.pwitnessFirstRow = &search->witnessFirstRow;
+  enumeration.sumEntries = 0;
+  enumeration.columnsPositive = search->columnsPositive;
+  enumeration.columnsNegative = search->columnsNegative;
+  enumeration.rowSubset = 0;
+  enumeration.subsetRows = NULL;
+  enumeration.usableColumns = NULL;
+  enumeration.subsetUsable = NULL;
+  enumeration.rowsNumNonzeros = NULL;
+  enumeration.columnsNumNonzeros = NULL;
+
+  CMR_CALL( CMRallocStackArray(cmr, &enumeration.subsetRows, matrix->numRows) );
+  CMR_CALL( CMRallocStackArray(cmr, &enumeration.usableColumns, matrix->numColumns) );
+  CMR_CALL( CMRallocStackArray(cmr, &enumeration.subsetUsable, matrix->numColumns) );
+  CMR_CALL( CMRallocStackArray(cmr, &enumeration.rowsNumNonzeros, matrix->numRows) );
+  CMR_CALL( CMRallocStackArray(cmr, &enumeration.columnsNumNonzeros, matrix->numColumns) );
+  for (size_t row = 0; row < matrix->numRows; ++row)
+    enumeration.rowsNumNonzeros[row] = 0;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+    enumeration.columnsNumNonzeros[column] = 0;
+  if (search->transpose)
+  {
+    CMR_CALL( CMRallocStackArray(cmr, &enumeration.commonRows, matrix->numRows) );
+    CMR_CALL( CMRallocStackArray(cmr, &enumeration.commonEntries, matrix->numRows) );
+  }
+
+  size_t beyondFirstRow = matrix->numRows - search->cardinality + 1;
+  while (!CMRatomicLoadFlag(&search->cancel))
+  {
+    enumeration.firstRow = CMRatomicFetchAdd(&search->nextFirstRow, 1);
+    if (enumeration.firstRow >= beyondFirstRow || enumeration.firstRow > CMRatomicLoad(&search->witnessFirstRow))
+      break;
+
+    CMR_CALL( balancedTestEnumerateRows(&enumeration, 0) );
+    if (!*enumeration.pisBalanced)
+    {
+      /* Workers with smaller first rows continue such that the violator does not depend on the timing. */
+      search->workerFirstRow[worker] = enumeration.firstRow;
+      size_t witness = CMRatomicLoad(&search->witnessFirstRow);
+      while (enumeration.firstRow < witness
+        && !CMRatomicCompareExchange(&search->witnessFirstRow, witness, enumeration.firstRow))
+      {
+        witness = CMRatomicLoad(&search->witnessFirstRow);
+      }
+      break;
+    }
+    if (enumeration.timeout)
+    {
+      search->workerTimeout[worker] = true;
+      CMRatomicStoreFlag(&search->cancel, true);
+      break;
     }
   }
 
+  if (search->transpose)
+  {
+    CMR_CALL( CMRfreeStackArray(cmr, &enumeration.commonEntries) );
+    CMR_CALL( CMRfreeStackArray(cmr, &enumeration.commonRows) );
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.columnsNumNonzeros) );
+  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.rowsNumNonzeros) );
+  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.subsetUsable) );
+  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.usableColumns) );
+  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.subsetRows) );
+
   return CMR_OKAY;
 }
 
@@ -271,8 +537,13 @@ bool balancedTestEnumerateRows(
  * \brief Tests a connected series-parallel reduced matrix \f$ M \f$ for being [balanced](\ref balanced) using the
  *        enumeration algorithm.
  *
+ * The submatrices are enumerated by increasing cardinality. For each cardinality, the choices of the first row are
+ * distributed among the workers. If the matrix has at most 64 rows (after transposing), the supports of the columns
+ * are stored as bitsets.
+ *
  * If \f$ M \f$ is not balanced and \p psubmatrix != \c NULL, then \p *psubmatrix will indicate a submatrix
  * of \f$ M \f$ with exactly two nonzeros in each row and in each column and with determinant \f$ -2 \f$ or \f$ 2 \f$.
+ * With several threads, it is the one with the smallest first row, i.e., the same as with a single thread.
  */
 
 static
@@ -282,14 +553,14 @@ CMR_ERROR balancedTestEnumerate(
   bool* pisBalanced,            /**< Pointer for storing whether \f$ M \f$ is balanced. */
   CMR_SUBMAT** psubmatrix,      /**< Pointer for storing a minimal nonbalanced submatrix (may be \c NULL). */
   CMR_BALANCED_STATS* stats,    /**< Statistics for the computation (may be \c NULL). */
-  double timeLimit,             /**< Time limit to impose. */
+  const CMR_DEADLINE* deadline, /**< Deadline of the computation. */
   bool isTransposed             /**< Whether we're dealing with the transposed matrix. */
 )
 {
   assert(cmr);
   assert(matrix);
   assert(pisBalanced);
-  assert(timeLimit > 0);
+  assert(deadline);
 
   CMRassertStackConsistency(cmr);
 
@@ -301,71 +572,147 @@ CMR_ERROR balancedTestEnumerate(
     assert(!isTransposed);
 
     CMR_CHRMAT* transpose = NULL;
-    CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+    CMR_CALL( CMRchrmatGetTranspose(cmr, matrix, &transpose) );
 
     CMRdbgMsg(6, "Transposing matrix to have fewer rows than columns.\n");
 
-    error = balancedTestEnumerate(cmr, transpose, pisBalanced, psubmatrix, stats, timeLimit, true);
+    error = balancedTestEnumerate(cmr, transpose, pisBalanced, psubmatrix, stats, deadline, true);
 
     /* Transpose the violator. */
     if (psubmatrix && *psubmatrix)
       CMR_CALL( CMRsubmatTranspose(*psubmatrix) );
 
-    CMR_CALL( CMRchrmatFree(cmr, &transpose) );
     return error;
   }
 
-  CMR_BALANCED_ENUMERATION enumeration;
-  enumeration.cmr = cmr;
-  enumeration.matrix = matrix;
-  enumeration.pisBalanced = pisBalanced;
-  enumeration.psubmatrix = psubmatrix;
-  enumeration.stats = stats;
-  enumeration.timeLimit = timeLimit;
-  enumeration.isTransposed = isTransposed;
-  enumeration.startClock = clock();
-  enumeration.subsetRows = NULL;
-  enumeration.usableColumns = NULL;
-  enumeration.subsetUsable = NULL;
-  enumeration.rowsNumNonzeros = NULL;
-  enumeration.columnsNumNonzeros = NULL;
-  enumeration.sumEntries = 0;
+  BalancedSearch search;
+  search.matrix = matrix;
+  search.isTransposed = isTransposed;
+  search.deadline = *deadline;
+  search.columnsPositive = NULL;
+  search.columnsNegative = NULL;
+  search.transpose = NULL;
 
-  CMR_CALL( CMRallocStackArray(cmr, &enumeration.subsetRows, matrix->numRows) );
-  CMR_CALL( CMRallocStackArray(cmr, &enumeration.usableColumns, matrix->numColumns) );
-  CMR_CALL( CMRallocStackArray(cmr, &enumeration.subsetUsable, matrix->numColumns) );
-  CMR_CALL( CMRallocStackArray(cmr, &enumeration.rowsNumNonzeros, matrix->numRows) );
-  CMR_CALL( CMRallocStackArray(cmr, &enumeration.columnsNumNonzeros, matrix->numColumns) );
-  for (size_t row = 0; row < matrix->numRows; ++row)
-    enumeration.rowsNumNonzeros[row] = 0;
-  for (size_t column = 0; column < matrix->numColumns; ++column)
-    enumeration.columnsNumNonzeros[column] = 0;
+  /* If the rows fit into a word, we store the columns as bitsets. */
+  if (matrix->numRows <= 64)
+  {
+    CMR_CALL( CMRallocStackArray(cmr, &search.columnsPositive, matrix->numColumns) );
+    CMR_CALL( CMRallocStackArray(cmr, &search.columnsNegative, matrix->numColumns) );
+    for (size_t column = 0; column < matrix->numColumns; ++column)
+    {
+      search.columnsPositive[column] = 0;
+      search.columnsNegative[column] = 0;
+    }
+    for (size_t row = 0; row < matrix->numRows; ++row)
+    {
+      size_t first = matrix->rowSlice[row];
+      size_t beyond = matrix->rowSlice[row + 1];
+      for (size_t e = first; e < beyond; ++e)
+      {
+        uint64_t* columns = (matrix->entryValues[e] > 0) ? search.columnsPositive : search.columnsNegative;
+        columns[matrix->entryColumns[e]] |= ((uint64_t) 1) << row;
+      }
+    }
+  }
+  else
+  {
+    /* The rows of a column that are in the subset are found by intersecting the sorted arrays. */
+    CMR_CALL( CMRchrmatTranspose(cmr, matrix, &search.transpose) );
+  }
 
-  CMRdbgMsg(6, "Starting enumeration algorithm with a time limit of %g.\n", timeLimit);
+  size_t maxWorkers = CMRthreadsNumWorkers(cmr, matrix->numRows);
+  search.workerIsBalanced = NULL;
+  search.workerTimeout = NULL;
+  search.workerFirstRow = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &search.workerIsBalanced, maxWorkers) );
+  CMR_CALL( CMRallocStackArray(cmr, &search.workerTimeout, maxWorkers) );
+  CMR_CALL( CMRallocStackArray(cmr, &search.workerFirstRow, maxWorkers) );
+  search.workerSubmatrices = NULL;
+  if (psubmatrix)
+    CMR_CALL( CMRallocStackArray(cmr, &search.workerSubmatrices, maxWorkers) );
+  search.workerStats = NULL;
+  if (stats)
+  {
+    CMR_CALL( CMRallocStackArray(cmr, &search.workerStats, maxWorkers) );
+    for (size_t w = 0; w < maxWorkers; ++w)
+      CMR_CALL( CMRbalancedStatsInit(&search.workerStats[w]) );
+  }
+
+  CMRdbgMsg(6, "Starting enumeration algorithm with a time limit of %g.\n", CMRdeadlineRemaining(deadline));
 
   CMRassertStackConsistency(cmr);
 
-  for (enumeration.cardinality = 2; enumeration.cardinality <= matrix->numRows; enumeration.cardinality++)
+  *pisBalanced = true;
+  bool timeout = false;
+  for (search.cardinality = 2; search.cardinality <= matrix->numRows; search.cardinality++)
   {
-    CMRassertStackConsistency(cmr);
-    CMRdbgMsg(8, "Considering submatrices of size %zux%zu.\n", enumeration.cardinality, enumeration.cardinality);
-    CMRassertStackConsistency(cmr);
-    CMR_CALL( balancedTestEnumerateRows(&enumeration, 0) );
-    if (!*pisBalanced || enumeration.timeLimit <= 0)
+    CMRdbgMsg(8, "Considering submatrices of size %zux%zu.\n", search.cardinality, search.cardinality);
+
+    size_t numWorkers = CMRthreadsNumWorkers(cmr, matrix->numRows - search.cardinality + 1);
+    search.nextFirstRow = 0;
+    search.cancel = false;
+    search.witnessFirstRow = SIZE_MAX;
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+      search.workerIsBalanced[w] = true;
+      search.workerTimeout[w] = false;
+      search.workerFirstRow[w] = SIZE_MAX;
+      if (search.workerSubmatrices)
+        search.workerSubmatrices[w] = NULL;
+    }
+
+    CMR_CALL( CMRthreadsRun(cmr, numWorkers, balancedTestEnumerateWorker, &search) );
+
+    /* Take the violator with the smallest first row. */
+    size_t bestWorker = SIZE_MAX;
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+      if (search.workerTimeout[w])
+        timeout = true;
+      if (!search.workerIsBalanced[w]
+        && (bestWorker == SIZE_MAX || search.workerFirstRow[w] < search.workerFirstRow[bestWorker]))
+      {
+        bestWorker = w;
+      }
+    }
+    for (size_t w = 0; w < numWorkers && search.workerSubmatrices; ++w)
+    {
+      if (w == bestWorker)
+        *psubmatrix = search.workerSubmatrices[w];
+      else
+        CMR_CALL( CMRsubmatFree(cmr, &search.workerSubmatrices[w]) );
+    }
+
+    if (bestWorker != SIZE_MAX)
+      *pisBalanced = false;
+    if (!*pisBalanced || timeout)
       break;
   }
 
   CMRassertStackConsistency(cmr);
 
-  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.columnsNumNonzeros) );
-  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.rowsNumNonzeros) );
-  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.subsetUsable) );
-  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.usableColumns) );
-  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.subsetRows) );
+  if (stats)
+  {
+    for (size_t w = 0; w < maxWorkers; ++w)
+      CMR_CALL( CMRbalancedStatsAdd(stats, &search.workerStats[w]) );
+    CMR_CALL( CMRfreeStackArray(cmr, &search.workerStats) );
+  }
+  if (search.workerSubmatrices)
+    CMR_CALL( CMRfreeStackArray(cmr, &search.workerSubmatrices) );
+  CMR_CALL( CMRfreeStackArray(cmr, &search.workerFirstRow) );
+  CMR_CALL( CMRfreeStackArray(cmr, &search.workerTimeout) );
+  CMR_CALL( CMRfreeStackArray(cmr, &search.workerIsBalanced) );
+  if (search.columnsPositive)
+  {
+    CMR_CALL( CMRfreeStackArray(cmr, &search.columnsNegative) );
+    CMR_CALL( CMRfreeStackArray(cmr, &search.columnsPositive) );
+  }
+  else
+    CMR_CALL( CMRchrmatFree(cmr, &search.transpose) );
 
   CMRassertStackConsistency(cmr);
 
-  if (enumeration.timeLimit <= 0)
+  if (timeout && *pisBalanced)
     return CMR_ERROR_TIMEOUT;
 
   return CMR_OKAY;
@@ -387,7 +734,7 @@ CMR_ERROR balancedTestGraph(
   CMR_SUBMAT** psubmatrix,      /**< Pointer for storing a minimal nonbalanced submatrix (may be \c NULL). */
   CMR_BALANCED_PARAMS* params,  /**< Parameters for the computation. */
   CMR_BALANCED_STATS* stats,    /**< Statistics for the computation (may be \c NULL). */
-  double timeLimit              /**< Time limit to impose. */
+  const CMR_DEADLINE* deadline  /**< Deadline of the computation. */
 )
 {
   assert(cmr);
@@ -396,7 +743,7 @@ CMR_ERROR balancedTestGraph(
   assert(psubmatrix);
   assert(params);
   assert(stats);
-  assert(timeLimit > 0);
+  assert(deadline);
 
   assert(!"Not implemented");
 
@@ -420,7 +767,7 @@ CMR_ERROR balancedTestChooseAlgorithm(
   CMR_SUBMAT** psubmatrix,      /**< Pointer for storing a minimal nonbalanced submatrix (may be \c NULL). */
   CMR_BALANCED_PARAMS* params,  /**< Parameters for the computation. */
   CMR_BALANCED_STATS* stats,    /**< Statistics for the computation (may be \c NULL). */
-  double timeLimit              /**< Time limit to impose. */
+  const CMR_DEADLINE* deadline  /**< Deadline of the computation. */
 )
 {
   assert(cmr);
@@ -437,7 +784,7 @@ CMR_ERROR balancedTestChooseAlgorithm(
 
   if (algorithm == CMR_BALANCED_ALGORITHM_GRAPH)
   {
-    error = balancedTestGraph(cmr, matrix, pisBalanced, psubmatrix, params, stats, timeLimit);
+    error = balancedTestGraph(cmr, matrix, pisBalanced, psubmatrix, params, stats, deadline);
     if (error != CMR_ERROR_TIMEOUT)
       CMR_CALL(error);
 
@@ -446,7 +793,7 @@ CMR_ERROR balancedTestChooseAlgorithm(
   else
   {
     assert(algorithm == CMR_BALANCED_ALGORITHM_SUBMATRIX);
-    error = balancedTestEnumerate(cmr, matrix, pisBalanced, psubmatrix, stats, timeLimit, false);
+    error = balancedTestEnumerate(cmr, matrix, pisBalanced, psubmatrix, stats, deadline, false);
     if (error != CMR_ERROR_TIMEOUT)
       CMR_CALL(error);
 
@@ -473,15 +820,13 @@ CMR_ERROR balancedTestConnected(
   CMR_SUBMAT** psubmatrix,      /**< Pointer for storing a minimal nonbalanced submatrix (may be \c NULL). */
   CMR_BALANCED_PARAMS* params,  /**< Parameters for the computation. */
   CMR_BALANCED_STATS* stats,    /**< Statistics for the computation (may be \c NULL). */
-  double timeLimit              /**< Time limit to impose. */
+  const CMR_DEADLINE* deadline  /**< Deadline of the computation. */
 )
 {
   assert(cmr);
   assert(matrix);
   assert(params);
 
-  clock_t startClock = clock();
-
   CMR_ERROR error = CMR_OKAY;
   bool isSeriesParallel = true;
   CMR_SUBMAT* reducedSubmatrix = NULL;
@@ -494,7 +839,7 @@ CMR_ERROR balancedTestConnected(
     /* TODO: Consider 2-separations as well; to this end, use CMRdecomposeTernarySeriesParallel instead. */
 
     CMR_CALL( CMRtestTernarySeriesParallel(cmr, matrix, &isSeriesParallel, NULL, NULL, &reducedSubmatrix,
-      &violatorSubmatrix, stats ? &stats->seriesParallel : NULL, timeLimit) );
+      &violatorSubmatrix, stats ? &stats->seriesParallel : NULL, CMRdeadlineRemaining(deadline)) );
 
     /* Stop if the matrix is actually series-parallel. */
     if (isSeriesParallel)
@@ -568,8 +913,7 @@ CMR_ERROR balancedTestConnected(
     CMR_CHRMAT* reducedMatrix = NULL;
     CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, reducedSubmatrix, &reducedMatrix) );
 
-    double time = (clock() - startClock) * 1.0 / CLOCKS_PER_SEC;
-    if (time >= timeLimit)
+    if (CMRdeadlinePassed(deadline))
     {
       CMR_CALL( CMRchrmatFree(cmr, &reducedMatrix) );
       CMR_CALL( CMRsubmatFree(cmr, &reducedSubmatrix) );
@@ -578,7 +922,7 @@ CMR_ERROR balancedTestConnected(
 
     CMR_SUBMAT* submatrix = NULL;
     error = balancedTestChooseAlgorithm(cmr, reducedMatrix, pisBalanced, psubmatrix ? &submatrix : NULL, params,
-      stats, timeLimit - time);
+      stats, deadline);
     if (error != CMR_ERROR_TIMEOUT)
       CMR_CALL(error);
 
@@ -596,7 +940,7 @@ CMR_ERROR balancedTestConnected(
   }
   else
   {
-    error = balancedTestChooseAlgorithm(cmr, matrix, pisBalanced, psubmatrix, params, stats, timeLimit);
+    error = balancedTestChooseAlgorithm(cmr, matrix, pisBalanced, psubmatrix, params, stats, deadline);
 
     CMRdbgMsg(4, "Matrix %s balanced.\n", (*pisBalanced) ? "IS" : "is NOT" );
 
@@ -608,18 +952,24 @@ CMR_ERROR balancedTestConnected(
 }
 
 /**
- * \brief Compares two matrix blocks according to min(#rows, #columns).
+ * \brief Returns min(#rows, #columns) of a matrix block.
  */
 
-int compareBlockComponents(const void* a, const void* b)
+static inline
+size_t blockSize(CMR_BLOCK* block)
 {
-  CMR_BLOCK* ca = (CMR_BLOCK*)a;
-  CMR_BLOCK* cb = (CMR_BLOCK*)b;
-  int min_a = (int)(ca->matrix->numRows < ca->matrix->numColumns ? ca->matrix->numRows : ca->matrix->numColumns);
-  int min_b = (int)(cb->matrix->numRows < cb->matrix->numColumns ? cb->matrix->numRows : cb->matrix->numColumns);
-  return min_a - min_b;
+  return block->matrix->numRows < block->matrix->numColumns ? block->matrix->numRows : block->matrix->numColumns;
 }
 
+/**
+ * \brief Orders matrix blocks by ascending min(#rows, #columns); ties are broken by the order of the blocks.
+ */
+
+#define BLOCK_COMPONENT_LESS(a, b) \
+  (blockSize(a) < blockSize(b) || (blockSize(a) == blockSize(b) && (a) < (b)))
+
+CMR_SORT_DEFINE(sortBlockComponents, CMR_BLOCK*, BLOCK_COMPONENT_LESS)
+
 CMR_ERROR CMRbalancedTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisBalanced, CMR_SUBMAT** psubmatrix,
   CMR_BALANCED_PARAMS* params, CMR_BALANCED_STATS* stats, double timeLimit)
 {
@@ -636,24 +986,40 @@ CMR_ERROR CMRbalancedTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisBalanced, CMR_S
 
   CMRdbgMsg(0, "Called CMRbalancedTest for a %zux%zu matrix.\n", matrix->numRows, matrix->numColumns);
 
-  clock_t startClock = clock();
+  double startClock = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
 
   if (!CMRchrmatIsTernary(cmr, matrix, psubmatrix))
   {
     if (stats)
     {
       stats->totalCount++;
-      stats->totalTime += (clock() - startClock) * 1.0 / CLOCKS_PER_SEC;
+      stats->totalTime += CMRclockNow() - startClock;
     }
     return CMR_OKAY;
   }
 
+  if (params->algorithm == CMR_BALANCED_ALGORITHM_AUTO && CMRsmallFits(matrix) && !CMRdeadlinePassed(&deadline))
+  {
+    bool decided;
+    CMR_CALL( CMRsmallTestBalanced(cmr, matrix, &decided, pisBalanced, psubmatrix) );
+    if (decided)
+    {
+      if (stats)
+      {
+        stats->totalCount++;
+        stats->totalTime += CMRclockNow() - startClock;
+      }
+      return CMR_OKAY;
+    }
+  }
+
   /* Perform a block decomposition. */
 
-  size_t numComponents;
-  CMR_BLOCK* components = NULL;
-  CMR_CALL( CMRdecomposeBlocks(cmr, (CMR_MATRIX*) matrix, sizeof(char), sizeof(char), &numComponents, &components, NULL,
-    NULL, NULL, NULL) );
+  CMR_BLOCK_LAYOUT* layout = NULL;
+  CMR_CALL( CMRdecomposeBlocksContiguous(cmr, matrix, &layout) );
+  size_t numComponents = layout->numBlocks;
+  CMR_BLOCK* components = layout->blocks;
 
   CMRdbgMsg(2, "Found %zu blocks.\n", numComponents);
 
@@ -663,21 +1029,19 @@ CMR_ERROR CMRbalancedTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisBalanced, CMR_S
   CMR_CALL( CMRallocStackArray(cmr, &orderedComponents, numComponents) );
   for (size_t comp = 0; comp < numComponents; ++comp)
     orderedComponents[comp] = &components[comp];
-  CMR_CALL( CMRsort(cmr, numComponents, orderedComponents, sizeof(CMR_BLOCK*), &compareBlockComponents) );
+  sortBlockComponents(orderedComponents, numComponents);
 
   *pisBalanced = true;
   for (size_t comp = 0; comp < numComponents; ++comp)
   {
     CMR_BLOCK* component = orderedComponents[comp];
     CMR_CHRMAT* matrix = (CMR_CHRMAT*) component->matrix;
-    CMR_CHRMAT* transpose = (CMR_CHRMAT*) component->transpose;
 
     CMRdbgMsg(2, "Processing block %zu.\n", comp);
 
-    double time = ((clock() - startClock) * 1.0 / CLOCKS_PER_SEC);
-    if (*pisBalanced && time < timeLimit)
+    if (*pisBalanced && !CMRdeadlinePassed(&deadline))
     {
-      CMR_CALL( balancedTestConnected(cmr, matrix, pisBalanced, psubmatrix, params, stats, timeLimit - time) );
+      CMR_CALL( balancedTestConnected(cmr, matrix, pisBalanced, psubmatrix, params, stats, &deadline) );
 
       /* If the component was not balanced, then we modify its violating submatrix to be one of the input matrix. */
       if (!*pisBalanced && psubmatrix)
@@ -689,23 +1053,17 @@ CMR_ERROR CMRbalancedTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisBalanced, CMR_S
           submatrix->columns[column] = component->columnsToOriginal[submatrix->columns[column]];
       }
     }
-
-    CMR_CALL( CMRchrmatFree(cmr, &matrix) );
-    CMR_CALL( CMRchrmatFree(cmr, &transpose) );
-    CMR_CALL( CMRfreeBlockArray(cmr, &component->rowsToOriginal) );
-    CMR_CALL( CMRfreeBlockArray(cmr, &component->columnsToOriginal) );
   }
 
   CMR_CALL( CMRfreeStackArray(cmr, &orderedComponents) );
-  CMR_CALL( CMRfreeBlockArray(cmr, &components) );
+  CMR_CALL( CMRblockLayoutFree(cmr, &layout) );
 
-  double time = ((clock() - startClock) * 1.0 / CLOCKS_PER_SEC);
   if (stats)
   {
     stats->totalCount++;
-    stats->totalTime += time;
+    stats->totalTime += CMRclockNow() - startClock;
   }
 
-  return time < timeLimit ? CMR_OKAY : CMR_ERROR_TIMEOUT;
+  return CMRdeadlinePassed(&deadline) ? CMR_ERROR_TIMEOUT : CMR_OKAY;
 }
 
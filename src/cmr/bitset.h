@@ -0,0 +1,60 @@
+#ifndef CMR_BITSET_INTERNAL_H
+#define CMR_BITSET_INTERNAL_H
+
+/**
+ * \file bitset.h
+ *
+ * \brief Helpers for sets that are stored as bits of 64-bit words.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Returns the number of bits that are set in \p word.
+ *
+ * Uses the population count instruction where the compiler provides it.
+ */
+
+static inline
+size_t CMRbitsetCount(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t) __builtin_popcountll(word);
+#else
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (size_t) ((word * 0x0101010101010101ULL) >> 56);
+#endif /* __GNUC__ || __clang__ */
+}
+
+/**
+ * \brief Returns the index of the lowest bit that is set in \p word, which must be nonzero.
+ */
+
+static inline
+size_t CMRbitsetLowest(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t) __builtin_ctzll(word);
+#else
+  size_t index = 0;
+  while (!(word & 1))
+  {
+    word >>= 1;
+    ++index;
+  }
+  return index;
+#endif /* __GNUC__ || __clang__ */
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_BITSET_INTERNAL_H */
@@ -8,177 +8,469 @@
 #include <limits.h>
 
 #include "env_internal.h"
+#include "threads.h"
+
+#define BLOCKS_PARALLEL_THRESHOLD (1UL << 18) /**< Minimum number of nonzeros for decomposing in parallel. */
+#define LARGE_BLOCK_NONZEROS (1UL << 16)      /**< Minimum number of nonzeros of a block that is transposed by
+                                               **  \ref CMRmatrixTransposeInto. */
 
 struct GraphNode
 {
-  int adjacencyStart; /**< \brief Index of first outgoing arc. */
+  int degreeSum;      /**< \brief Index of first adjacency, which is the sum of the degrees of all previous nodes. */
   int component;      /**< \brief Index of component of matrix. */
-  int degree;         /**< \brief Used to count the degree. */
   int order;          /**< \brief Corresponding row/column in component. */
 };
 typedef struct GraphNode GRAPH_NODE;
 
-CMR_ERROR CMRdecomposeBlocks(CMR* cmr, CMR_MATRIX* matrix, size_t matrixType, size_t targetType,
-  size_t* pnumBlocks, CMR_BLOCK** pblocks, size_t* rowsToBlock, size_t* columnsToBlock, size_t* rowsToBlockRows,
-  size_t* columnsToBlockColumns)
-{
-  GRAPH_NODE* graphNodes = NULL;
-  int* graphAdjacencies = NULL;
-  int* queue = NULL;
-  int queueLength = 0;
-  int numNodes = matrix->numRows + matrix->numColumns;
-  size_t countBlocks = 0;
-  const int firstColumnNode = matrix->numRows;
-  int i;
-
-  assert(cmr);
-  assert(matrix);
-  assert(pnumBlocks);
-  assert(pblocks);
+/**
+ * \brief Returns \c true if and only if entry \p e of \p matrix is nonzero.
+ */
 
-#if defined(CMR_DEBUG)
-  CMRdbgMsg(0, "CMRchrmatDecomposeBlocks:\n");
+static inline
+bool isEntryNonzero(
+  CMR_MATRIX* matrix, /**< Matrix. */
+  size_t matrixType,  /**< Size of base type of matrix. */
+  size_t e            /**< Index of entry. */
+)
+{
   if (matrixType == sizeof(double))
-    CMRdblmatPrintDense(stdout, (CMR_DBLMAT*) matrix, '0', true);
+    return ((double*)matrix->entryValues)[e] != 0.0;
   else if (matrixType == sizeof(int))
-    CMRintmatPrintDense(stdout, (CMR_INTMAT*) matrix, '0', true);
-  else if (matrixType == sizeof(char))
-    CMRchrmatPrintDense(stdout, (CMR_CHRMAT*) matrix, '0', true);
-#endif
+    return ((int*)matrix->entryValues)[e] != 0;
+  assert(matrixType == sizeof(char));
+  return ((char*)matrix->entryValues)[e] != 0;
+}
 
-  CMR_CALL( CMRallocStackArray(cmr, &graphNodes, numNodes + 1) );
-  CMR_CALL( CMRallocStackArray(cmr, &graphAdjacencies, 2 * matrix->numNonzeros) );
-  CMR_CALL( CMRallocStackArray(cmr, &queue, numNodes) );
+/**
+ * \brief Returns the root of the union-find tree containing \p node, halving the path to it.
+ *
+ * Since every non-root only ever points to one of its ancestors, concurrent calls are safe.
+ */
 
-  for (int node = 0; node < numNodes; ++node)
+static inline
+size_t findRoot(
+  size_t* parents,  /**< Union-find parent of each node. */
+  size_t node       /**< Node. */
+)
+{
+  while (true)
   {
-    graphNodes[node].component = -1;
-    graphNodes[node].degree = 0;
+    size_t parent = CMRatomicLoad(&parents[node]);
+    if (parent == node)
+      return node;
+    size_t grandparent = CMRatomicLoad(&parents[parent]);
+    if (grandparent != parent)
+      CMRatomicStore(&parents[node], grandparent);
+    node = grandparent;
   }
+}
 
-  /* Count degrees */
-  for (size_t row = 0; row < matrix->numRows; ++row)
+/**
+ * \brief Unites the union-find trees containing \p u and \p v.
+ *
+ * The larger root is linked to the smaller one, such that every root is the smallest node of its tree, regardless of
+ * the order of the unions.
+ */
+
+static inline
+void uniteNodes(
+  size_t* parents,  /**< Union-find parent of each node. */
+  size_t u,         /**< First node. */
+  size_t v          /**< Second node. */
+)
+{
+  while (true)
   {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    for (size_t e = first; e < beyond; ++e)
+    u = findRoot(parents, u);
+    v = findRoot(parents, v);
+    if (u == v)
+      return;
+    if (u < v)
     {
-      bool isNonzero;
-      if (matrixType == sizeof(double))
-        isNonzero = ((double*)matrix->entryValues)[e] != 0.0;
-      else if (matrixType == sizeof(int))
-        isNonzero = ((int*)matrix->entryValues)[e] != 0;
-      else
-      {
-        assert(matrixType == sizeof(char));
-        isNonzero = ((char*)matrix->entryValues)[e] != 0;
-      }
-      if (isNonzero)
+      size_t temp = u;
+      u = v;
+      v = temp;
+    }
+    if (CMRatomicCompareExchange(&parents[u], u, v))
+      return;
+  }
+}
+
+/**
+ * \brief Assigns \p component to all nodes reachable from \p startNode and orders them by a depth-first search.
+ *
+ * The nodes are ordered in the sequence in which they are discovered, separately for rows and columns.
+ */
+
+static
+void searchComponent(
+  GRAPH_NODE* graphNodes, /**< Array with the nodes. */
+  int* graphAdjacencies,  /**< Array with the adjacencies of all nodes. */
+  int firstColumnNode,    /**< First node of a column. */
+  int startNode,          /**< Smallest node of the component. */
+  int component,          /**< Index of the component. */
+  int* queue              /**< Array that can hold all nodes of the component. */
+)
+{
+  int currentOrderRow = 0;
+  int currentOrderColumn = 0;
+
+  graphNodes[startNode].component = component;
+  graphNodes[startNode].order = 0;
+  if (startNode < firstColumnNode)
+    currentOrderRow++;
+  else
+    currentOrderColumn++;
+  int queueLength = 1;
+  queue[0] = startNode;
+  while (queueLength > 0)
+  {
+    int currentNode = queue[--queueLength];
+    int start = graphNodes[currentNode].degreeSum;
+    int end = graphNodes[currentNode + 1].degreeSum;
+
+    for (int i = start; i < end; ++i)
+    {
+      int endNode = graphAdjacencies[i];
+      if (graphNodes[endNode].order < 0)
       {
-        int column = matrix->entryColumns[e];
-        graphNodes[row].degree++;
-        graphNodes[firstColumnNode + column].degree++;
+        graphNodes[endNode].component = component;
+        if (endNode < firstColumnNode)
+          graphNodes[endNode].order = currentOrderRow++;
+        else
+          graphNodes[endNode].order = currentOrderColumn++;
+        queue[queueLength] = endNode;
+        ++queueLength;
       }
     }
   }
+}
 
-  /* Compute ranges for adjacencies */
-  i = 0;
-  for (int node = 0; node < numNodes; ++node)
+/**
+ * \brief Data shared by the workers of a component search.
+ */
+
+typedef struct
+{
+  CMR_MATRIX* matrix;       /**< \brief Matrix. */
+  size_t matrixType;        /**< \brief Size of base type of matrix. */
+  GRAPH_NODE* graphNodes;   /**< \brief Array with the nodes. */
+  int* graphAdjacencies;    /**< \brief Array with the adjacencies of all nodes. */
+  size_t* parents;          /**< \brief Union-find parent of each node, or \c NULL if the search is sequential. */
+  size_t numWorkers;        /**< \brief Number of workers. */
+  size_t* firstRows;        /**< \brief Array with the first row of each worker, followed by the number of rows. */
+  size_t** columnPositions; /**< \brief Array with each worker's number of nonzeros per column, later turned into
+                             **         their positions in \ref graphAdjacencies. */
+  int* componentRoots;      /**< \brief Array with the smallest node of each component. */
+  size_t numComponents;     /**< \brief Number of components. */
+  size_t nextComponent;     /**< \brief Next component to be searched, accessed atomically. */
+} ComponentSearch;
+
+/**
+ * \brief Counts the degrees of the rows of a worker as well as the nonzeros per column and, in parallel searches,
+ *        unites the row and column nodes of each nonzero.
+ */
+
+static
+CMR_ERROR componentsCountWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref ComponentSearch. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  ComponentSearch* search = (ComponentSearch*) data;
+  CMR_MATRIX* matrix = search->matrix;
+  size_t* parents = search->parents;
+  size_t* columnCounts = search->columnPositions[worker];
+  const size_t firstColumnNode = matrix->numRows;
+
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+    columnCounts[column] = 0;
+  for (size_t row = search->firstRows[worker]; row < search->firstRows[worker + 1]; ++row)
+  {
+    int degree = 0;
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t e = matrix->rowSlice[row]; e < beyond; ++e)
+    {
+      if (!isEntryNonzero(matrix, search->matrixType, e))
+        continue;
+      size_t column = matrix->entryColumns[e];
+      ++degree;
+      columnCounts[column]++;
+      if (parents)
+        uniteNodes(parents, row, firstColumnNode + column);
+    }
+    search->graphNodes[row].degreeSum = degree;
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Stores the adjacencies of the nonzeros in the rows of a worker and, in parallel searches, lets every node
+ *        of a worker's range point directly to its root.
+ *
+ * Since the workers' rows are consecutive, the adjacencies of every column are sorted.
+ */
+
+static
+CMR_ERROR componentsAdjacencyWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref ComponentSearch. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  ComponentSearch* search = (ComponentSearch*) data;
+  CMR_MATRIX* matrix = search->matrix;
+  GRAPH_NODE* graphNodes = search->graphNodes;
+  int* graphAdjacencies = search->graphAdjacencies;
+  size_t* columnPositions = search->columnPositions[worker];
+  const size_t firstColumnNode = matrix->numRows;
+
+  for (size_t row = search->firstRows[worker]; row < search->firstRows[worker + 1]; ++row)
+  {
+    int rowPosition = graphNodes[row].degreeSum;
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t e = matrix->rowSlice[row]; e < beyond; ++e)
+    {
+      if (!isEntryNonzero(matrix, search->matrixType, e))
+        continue;
+      size_t column = matrix->entryColumns[e];
+      graphAdjacencies[rowPosition++] = firstColumnNode + column;
+      graphAdjacencies[columnPositions[column]++] = row;
+    }
+  }
+
+  if (search->parents)
+  {
+    size_t numNodes = matrix->numRows + matrix->numColumns;
+    size_t first = numNodes * worker / search->numWorkers;
+    size_t beyond = numNodes * (worker + 1) / search->numWorkers;
+    for (size_t node = first; node < beyond; ++node)
+      CMRatomicStore(&search->parents[node], findRoot(search->parents, node));
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Orders the nodes of components until all are processed.
+ */
+
+static
+CMR_ERROR componentsSearchWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref ComponentSearch. */
+)
+{
+  CMR_UNUSED(worker);
+
+  ComponentSearch* search = (ComponentSearch*) data;
+  int* queue = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &queue, search->matrix->numRows + search->matrix->numColumns) );
+
+  while (true)
+  {
+    size_t comp = CMRatomicFetchAdd(&search->nextComponent, 1);
+    if (comp >= search->numComponents)
+      break;
+    searchComponent(search->graphNodes, search->graphAdjacencies, search->matrix->numRows,
+      search->componentRoots[comp], comp, queue);
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &queue) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the number of workers for decomposing \p matrix.
+ */
+
+static
+size_t decompositionNumWorkers(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_MATRIX* matrix  /**< Matrix. */
+)
+{
+  size_t numNonzeros = matrix->rowSlice[matrix->numRows];
+  if (numNonzeros < BLOCKS_PARALLEL_THRESHOLD || matrix->numRows < 2)
+    return 1;
+
+  /* Every worker needs a count per column, so we only use many workers if there are many nonzeros per column. */
+  size_t maxWorkers = numNonzeros / (BLOCKS_PARALLEL_THRESHOLD / 4);
+  if (matrix->numColumns > 0 && maxWorkers > numNonzeros / matrix->numColumns)
+    maxWorkers = numNonzeros / matrix->numColumns;
+  return maxWorkers > 1 ? CMRthreadsNumWorkers(cmr, maxWorkers) : 1;
+}
+
+/**
+ * \brief Computes the connected components of the bipartite graph of the nonzeros of \p matrix.
+ *
+ * Rows are nodes \f$ 0, \dotsc, m-1 \f$ and columns are nodes \f$ m, \dotsc, m+n-1 \f$. Components are numbered by
+ * their smallest nodes, and the nodes of each component are ordered by a depth-first search from its smallest node.
+ * The adjacencies are built by several workers that are assigned consecutive rows with similar numbers of nonzeros.
+ * In that case, the components are first identified by a union-find over the nonzeros, such that the depth-first
+ * searches of distinct components run in parallel. The result does not depend on the number of workers. Afterwards,
+ * each node knows its component, its order within the component and the sum of the degrees of all previous nodes.
+ */
+
+static
+CMR_ERROR computeComponents(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_MATRIX* matrix,     /**< Matrix. */
+  size_t matrixType,      /**< Size of base type of matrix. */
+  GRAPH_NODE* graphNodes, /**< Array of size \f$ m + n + 1 \f$ for the nodes. */
+  int* graphAdjacencies,  /**< Array of size twice the number of nonzeros for the adjacencies. */
+  size_t* pnumBlocks      /**< Pointer for storing the number of components. */
+)
+{
+  const size_t numNodes = matrix->numRows + matrix->numColumns;
+  const size_t firstColumnNode = matrix->numRows;
+
+  ComponentSearch search;
+  search.matrix = matrix;
+  search.matrixType = matrixType;
+  search.graphNodes = graphNodes;
+  search.graphAdjacencies = graphAdjacencies;
+  search.parents = NULL;
+  search.numWorkers = decompositionNumWorkers(cmr, matrix);
+  search.firstRows = NULL;
+  search.columnPositions = NULL;
+  search.componentRoots = NULL;
+  search.numComponents = 0;
+  search.nextComponent = 0;
+  CMR_CALL( CMRallocBlockArray(cmr, &search.firstRows, search.numWorkers + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &search.columnPositions, search.numWorkers) );
+  for (size_t w = 0; w < search.numWorkers; ++w)
+  {
+    search.columnPositions[w] = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &search.columnPositions[w], matrix->numColumns) );
+  }
+  if (search.numWorkers > 1)
   {
-    graphNodes[node].adjacencyStart = i;
-    i += graphNodes[node].degree;
+    CMR_CALL( CMRallocBlockArray(cmr, &search.parents, numNodes) );
+    for (size_t node = 0; node < numNodes; ++node)
+      search.parents[node] = node;
   }
-  graphNodes[numNodes].adjacencyStart = i;
+  CMRthreadsSplitRows(matrix->rowSlice, matrix->numRows, NULL, search.numWorkers, search.firstRows);
+
+  if (search.numWorkers > 1)
+    CMR_CALL( CMRthreadsRun(cmr, search.numWorkers, componentsCountWorker, &search) );
+  else
+    CMR_CALL( componentsCountWorker(cmr, 0, &search) );
 
-  /* Scan entries and create adjacencies. */
+  /* Compute the ranges of the adjacencies and each worker's first position in every column's range. */
+  int degreeSum = 0;
   for (size_t row = 0; row < matrix->numRows; ++row)
   {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row+1];
-    for (size_t e = first; e < beyond; ++e)
+    int degree = graphNodes[row].degreeSum;
+    graphNodes[row].degreeSum = degreeSum;
+    degreeSum += degree;
+  }
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+  {
+    graphNodes[firstColumnNode + column].degreeSum = degreeSum;
+    for (size_t w = 0; w < search.numWorkers; ++w)
     {
-      bool isNonzero = false;
-      if (matrixType == sizeof(double))
-        isNonzero = ((double*)matrix->entryValues)[e] != 0.0;
-      else if (matrixType == sizeof(int))
-        isNonzero = ((int*)matrix->entryValues)[e] != 0;
-      else if (matrixType == sizeof(char))
-        isNonzero = ((char*)matrix->entryValues)[e] != 0;
-      else
-        assert("Invalid matrixType parameter." == 0);
-
-      if (isNonzero)
-      {
-        int column = matrix->entryColumns[e];
-        int columnNode = firstColumnNode + column;
-        CMRdbgMsg(2, "Nonzero (%d,%d) with row node %d (%d neighbors missing) and column node %d (%d neighbors missing).\n",
-          row, column, row, graphNodes[row].degree, columnNode, graphNodes[columnNode].degree);
-        graphAdjacencies[graphNodes[row + 1].adjacencyStart - graphNodes[row].degree] = columnNode;
-        graphNodes[row].degree--;
-        graphAdjacencies[graphNodes[columnNode + 1].adjacencyStart - graphNodes[columnNode].degree] = row;
-        graphNodes[columnNode].degree--;
-      }
+      size_t count = search.columnPositions[w][column];
+      search.columnPositions[w][column] = degreeSum;
+      degreeSum += count;
     }
   }
+  graphNodes[numNodes].degreeSum = degreeSum;
 
-  /*
-   * We decremented the degree entries, so they should be 0. From now on we can query
-   * graphNodes[node+1].adjacencyStart - graphNodes[node].adjacencyStart if necessary.
-   *
-   * TODO: make degree a union with something else to save memory and improve cache behavior.
-   */
+  if (search.numWorkers > 1)
+    CMR_CALL( CMRthreadsRun(cmr, search.numWorkers, componentsAdjacencyWorker, &search) );
+  else
+    CMR_CALL( componentsAdjacencyWorker(cmr, 0, &search) );
 
-  for (int node = 0; node < numNodes; ++node)
-    assert(graphNodes[node].degree == 0);
+  for (size_t node = 0; node < numNodes; ++node)
+    graphNodes[node].order = -1;
 
-  /* Run DFS. */
-  for (int startNode = 0; startNode < numNodes; ++startNode)
+  if (search.parents)
   {
-    if (graphNodes[startNode].component < 0)
+    /* Every root is the smallest node of its component, i.e., components are numbered as by sequential searches. */
+    for (size_t node = 0; node < numNodes; ++node)
     {
-      /* Start a new component. */
-      int currentOrderRow = 0;
-      int currentOrderColumn = 0;
-
-      graphNodes[startNode].component = countBlocks;
-      graphNodes[startNode].order = 0;
-      if (startNode < firstColumnNode)
-        currentOrderRow++;
-      else
-        currentOrderColumn++;
-      queueLength = 1;
-      queue[0] = startNode;
-      while (queueLength > 0)
-      {
-        int currentNode = queue[--queueLength];
-        int start = graphNodes[currentNode].adjacencyStart;
-        int end = graphNodes[currentNode + 1].adjacencyStart;
+      if (search.parents[node] == node)
+        search.numComponents++;
+    }
+    CMR_CALL( CMRallocBlockArray(cmr, &search.componentRoots, search.numComponents) );
+    size_t comp = 0;
+    for (size_t node = 0; node < numNodes; ++node)
+    {
+      if (search.parents[node] == node)
+        search.componentRoots[comp++] = node;
+    }
 
-        for (int i = start; i < end; ++i)
-        {
-          int endNode = graphAdjacencies[i];
-          if (graphNodes[endNode].component < 0)
-          {
-            graphNodes[endNode].component = countBlocks;
-            if (endNode < firstColumnNode)
-              graphNodes[endNode].order = currentOrderRow++;
-            else
-              graphNodes[endNode].order = currentOrderColumn++;
-            queue[queueLength] = endNode;
-            ++queueLength;
-          }
-        }
-      }
+    CMR_CALL( CMRthreadsRun(cmr, CMRthreadsNumWorkers(cmr, search.numComponents), componentsSearchWorker,
+      &search) );
 
-      ++countBlocks;
+    CMR_CALL( CMRfreeBlockArray(cmr, &search.componentRoots) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &search.parents) );
+  }
+  else
+  {
+    int* queue = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &queue, numNodes) );
+    for (size_t startNode = 0; startNode < numNodes; ++startNode)
+    {
+      if (graphNodes[startNode].order < 0)
+        searchComponent(graphNodes, graphAdjacencies, firstColumnNode, startNode, search.numComponents++, queue);
     }
+    CMR_CALL( CMRfreeStackArray(cmr, &queue) );
   }
 
+  for (size_t w = 0; w < search.numWorkers; ++w)
+    CMR_CALL( CMRfreeBlockArray(cmr, &search.columnPositions[w]) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &search.columnPositions) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &search.firstRows) );
+
+  *pnumBlocks = search.numComponents;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRdecomposeBlocks(CMR* cmr, CMR_MATRIX* matrix, size_t matrixType, size_t targetType,
+  size_t* pnumBlocks, CMR_BLOCK** pblocks, size_t* rowsToBlock, size_t* columnsToBlock, size_t* rowsToBlockRows,
+  size_t* columnsToBlockColumns)
+{
+  GRAPH_NODE* graphNodes = NULL;
+  int* graphAdjacencies = NULL;
+  int numNodes = matrix->numRows + matrix->numColumns;
+  size_t countBlocks = 0;
+  const int firstColumnNode = matrix->numRows;
+
+  assert(cmr);
+  assert(matrix);
+  assert(pnumBlocks);
+  assert(pblocks);
+
+#if defined(CMR_DEBUG)
+  CMRdbgMsg(0, "CMRchrmatDecomposeBlocks:\n");
+  if (matrixType == sizeof(double))
+    CMRdblmatPrintDense(stdout, (CMR_DBLMAT*) matrix, '0', true);
+  else if (matrixType == sizeof(int))
+    CMRintmatPrintDense(stdout, (CMR_INTMAT*) matrix, '0', true);
+  else if (matrixType == sizeof(char))
+    CMRchrmatPrintDense(stdout, (CMR_CHRMAT*) matrix, '0', true);
+#endif
+
+  CMR_CALL( CMRallocStackArray(cmr, &graphNodes, numNodes + 1) );
+  CMR_CALL( CMRallocStackArray(cmr, &graphAdjacencies, 2 * matrix->rowSlice[matrix->numRows]) );
+
+  CMR_CALL( computeComponents(cmr, matrix, matrixType, graphNodes, graphAdjacencies, &countBlocks) );
+
   *pnumBlocks = countBlocks;
 
 #if defined(CMR_DEBUG)
-  printf("DFS found %d components.\n", countBlocks);
+  printf("Found %zu components.\n", countBlocks);
   for (int node = 0; node < numNodes; ++node)
   {
     printf("Node %d has component %d.\n", node, graphNodes[node].component);
@@ -202,8 +494,8 @@ CMR_ERROR CMRdecomposeBlocks(CMR* cmr, CMR_MATRIX* matrix, size_t matrixType, si
   for (int node = 0; node < numNodes; ++node)
   {
     int comp = graphNodes[node].component;
-    int start = graphNodes[node].adjacencyStart;
-    int end = graphNodes[node + 1].adjacencyStart;
+    int start = graphNodes[node].degreeSum;
+    int end = graphNodes[node + 1].degreeSum;
     assert(comp >= 0);
     if (node < firstColumnNode)
     {
@@ -295,7 +587,7 @@ CMR_ERROR CMRdecomposeBlocks(CMR* cmr, CMR_MATRIX* matrix, size_t matrixType, si
       printf("Component %d's column %d (row of transposed) starts at component entry %d.\n", comp, compColumn,
         countNonzeros);
 #endif
-      countNonzeros += graphNodes[node+1].adjacencyStart - graphNodes[node].adjacencyStart;
+      countNonzeros += graphNodes[node+1].degreeSum - graphNodes[node].degreeSum;
     }
 
     /* Fill the slices. To ensure that it is sorted, we iterate row-wise. */
@@ -411,7 +703,7 @@ CMR_ERROR CMRdecomposeBlocks(CMR* cmr, CMR_MATRIX* matrix, size_t matrixType, si
       int row = blocks[comp].rowsToOriginal[compRow];
       int node = row;
       compMatrix->rowSlice[compRow] = countNonzeros;
-      countNonzeros += graphNodes[node+1].adjacencyStart - graphNodes[node].adjacencyStart;
+      countNonzeros += graphNodes[node+1].degreeSum - graphNodes[node].degreeSum;
     }
 
     /* Fill the slices. To ensure that it is sorted, we iterate column-wise. */
@@ -492,9 +784,346 @@ CMR_ERROR CMRdecomposeBlocks(CMR* cmr, CMR_MATRIX* matrix, size_t matrixType, si
             columnsToBlockColumns[column] = graphNodes[firstColumnNode + column].order;
   }
 
-  CMR_CALL( CMRfreeStackArray(cmr, &queue) );
   CMR_CALL( CMRfreeStackArray(cmr, &graphAdjacencies) );
   CMR_CALL( CMRfreeStackArray(cmr, &graphNodes) );
 
   return CMR_OKAY;
 }
+
+/**
+ * \brief Data shared by the workers that fill a \ref CMR_BLOCK_LAYOUT.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* matrix;       /**< \brief Matrix. */
+  GRAPH_NODE* graphNodes;   /**< \brief Array with the nodes. */
+  CMR_BLOCK_LAYOUT* layout; /**< \brief Layout to be filled. */
+  size_t* firstRows;        /**< \brief Array with the first permuted row of each worker, followed by the number of
+                             **         rows. */
+  size_t nextBlock;         /**< \brief Next block to be filled, accessed atomically. */
+} LayoutFill;
+
+/**
+ * \brief Copies the permuted rows of a worker that belong to large blocks into the matrices of their blocks.
+ *
+ * The columns of a block are not ordered as in the matrix, i.e., the rows of the large blocks are not sorted yet.
+ */
+
+static
+CMR_ERROR layoutRowsWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref LayoutFill. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  LayoutFill* fill = (LayoutFill*) data;
+  CMR_CHRMAT* matrix = fill->matrix;
+  CMR_BLOCK_LAYOUT* layout = fill->layout;
+  GRAPH_NODE* graphNodes = fill->graphNodes;
+  const size_t firstColumnNode = matrix->numRows;
+
+  for (size_t permutedRow = fill->firstRows[worker]; permutedRow < fill->firstRows[worker + 1]; ++permutedRow)
+  {
+    size_t row = layout->rowsToOriginal[permutedRow];
+    int comp = graphNodes[row].component;
+    CMR_CHRMAT* blockMatrix = &layout->matrices[comp];
+    if (blockMatrix->numNonzeros < LARGE_BLOCK_NONZEROS)
+      continue;
+
+    size_t blockEntry = blockMatrix->rowSlice[permutedRow - layout->rowOffsets[comp]];
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t e = matrix->rowSlice[row]; e < beyond; ++e)
+    {
+      if (!matrix->entryValues[e])
+        continue;
+      blockMatrix->entryColumns[blockEntry] = graphNodes[firstColumnNode + matrix->entryColumns[e]].order;
+      blockMatrix->entryValues[blockEntry] = matrix->entryValues[e];
+      ++blockEntry;
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Fills the matrices and transposes of blocks that are not large until all are processed.
+ */
+
+static
+CMR_ERROR layoutBlocksWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref LayoutFill. */
+)
+{
+  CMR_UNUSED(cmr);
+  CMR_UNUSED(worker);
+
+  LayoutFill* fill = (LayoutFill*) data;
+  CMR_CHRMAT* matrix = fill->matrix;
+  CMR_BLOCK_LAYOUT* layout = fill->layout;
+  GRAPH_NODE* graphNodes = fill->graphNodes;
+  const size_t firstColumnNode = matrix->numRows;
+
+  while (true)
+  {
+    size_t b = CMRatomicFetchAdd(&fill->nextBlock, 1);
+    if (b >= layout->numBlocks)
+      break;
+    CMR_CHRMAT* blockMatrix = &layout->matrices[b];
+    CMR_CHRMAT* blockTranspose = &layout->transposes[b];
+    if (blockMatrix->numNonzeros >= LARGE_BLOCK_NONZEROS)
+      continue;
+
+    /* The slices are shifted by one entry since they are incremented while filling. */
+    size_t* blockColumnsToOriginal = layout->blocks[b].columnsToOriginal;
+    size_t countNonzeros = 0;
+    for (size_t blockColumn = 0; blockColumn < blockTranspose->numRows; ++blockColumn)
+    {
+      size_t node = firstColumnNode + blockColumnsToOriginal[blockColumn];
+      blockTranspose->rowSlice[blockColumn + 1] = countNonzeros;
+      countNonzeros += graphNodes[node + 1].degreeSum - graphNodes[node].degreeSum;
+    }
+    blockTranspose->rowSlice[0] = 0;
+
+    /* Fill the transpose. To ensure that it is sorted, we iterate row-wise in the order of the block's rows. */
+    size_t* blockRowsToOriginal = layout->blocks[b].rowsToOriginal;
+    for (size_t blockRow = 0; blockRow < blockMatrix->numRows; ++blockRow)
+    {
+      size_t row = blockRowsToOriginal[blockRow];
+      size_t beyond = matrix->rowSlice[row + 1];
+      for (size_t e = matrix->rowSlice[row]; e < beyond; ++e)
+      {
+        if (!matrix->entryValues[e])
+          continue;
+        size_t blockColumn = graphNodes[firstColumnNode + matrix->entryColumns[e]].order;
+        size_t blockEntry = blockTranspose->rowSlice[blockColumn + 1]++;
+        blockTranspose->entryColumns[blockEntry] = blockRow;
+        blockTranspose->entryValues[blockEntry] = matrix->entryValues[e];
+      }
+    }
+
+    /* Fill the matrix from the transpose, which again ensures sortedness. */
+    for (size_t blockRow = blockMatrix->numRows; blockRow > 0; --blockRow)
+      blockMatrix->rowSlice[blockRow] = blockMatrix->rowSlice[blockRow - 1];
+    for (size_t blockColumn = 0; blockColumn < blockTranspose->numRows; ++blockColumn)
+    {
+      size_t beyond = blockTranspose->rowSlice[blockColumn + 1];
+      for (size_t e = blockTranspose->rowSlice[blockColumn]; e < beyond; ++e)
+      {
+        size_t blockEntry = blockMatrix->rowSlice[blockTranspose->entryColumns[e] + 1]++;
+        blockMatrix->entryColumns[blockEntry] = blockColumn;
+        blockMatrix->entryValues[blockEntry] = blockTranspose->entryValues[e];
+      }
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRdecomposeBlocksContiguous(CMR* cmr, CMR_CHRMAT* matrix, CMR_BLOCK_LAYOUT** playout)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(playout);
+
+  GRAPH_NODE* graphNodes = NULL;
+  int* graphAdjacencies = NULL;
+  const size_t numRows = matrix->numRows;
+  const size_t numColumns = matrix->numColumns;
+  const size_t firstColumnNode = numRows;
+
+  CMR_CALL( CMRallocStackArray(cmr, &graphNodes, numRows + numColumns + 1) );
+  CMR_CALL( CMRallocStackArray(cmr, &graphAdjacencies, 2 * matrix->rowSlice[numRows]) );
+
+  size_t numBlocks;
+  CMR_CALL( computeComponents(cmr, (CMR_MATRIX*) matrix, sizeof(char), graphNodes, graphAdjacencies, &numBlocks) );
+  size_t numNonzeros = graphNodes[numRows].degreeSum;
+
+  CMR_CALL( CMRfreeStackArray(cmr, &graphAdjacencies) );
+
+  CMRdbgMsg(0, "CMRdecomposeBlocksContiguous found %zu blocks.\n", numBlocks);
+
+  CMR_CALL( CMRallocBlock(cmr, playout) );
+  CMR_BLOCK_LAYOUT* layout = *playout;
+  layout->numBlocks = numBlocks;
+  layout->blocks = NULL;
+  layout->rowOffsets = NULL;
+  layout->columnOffsets = NULL;
+  layout->nonzeroOffsets = NULL;
+  layout->rowsToOriginal = NULL;
+  layout->columnsToOriginal = NULL;
+  layout->matrices = NULL;
+  layout->transposes = NULL;
+  layout->rowSlices = NULL;
+  layout->entryColumns = NULL;
+  layout->entryValues = NULL;
+  layout->transposeRowSlices = NULL;
+  layout->transposeEntryColumns = NULL;
+  layout->transposeEntryValues = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->blocks, numBlocks) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->rowOffsets, numBlocks + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->columnOffsets, numBlocks + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->nonzeroOffsets, numBlocks + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->rowsToOriginal, numRows) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->columnsToOriginal, numColumns) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->matrices, numBlocks) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->transposes, numBlocks) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->rowSlices, numRows + numBlocks) );
+  CMR_CALL( CMRallocBlockArray(cmr, &layout->transposeRowSlices, numColumns + numBlocks) );
+  if (numNonzeros > 0)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, &layout->entryColumns, numNonzeros) );
+    CMR_CALL( CMRallocBlockArray(cmr, &layout->entryValues, numNonzeros) );
+    CMR_CALL( CMRallocBlockArray(cmr, &layout->transposeEntryColumns, numNonzeros) );
+    CMR_CALL( CMRallocBlockArray(cmr, &layout->transposeEntryValues, numNonzeros) );
+  }
+
+  /* Count the rows, columns and nonzeros of each block and compute the offsets. */
+  size_t* rowOffsets = layout->rowOffsets;
+  size_t* columnOffsets = layout->columnOffsets;
+  size_t* nonzeroOffsets = layout->nonzeroOffsets;
+  for (size_t b = 0; b <= numBlocks; ++b)
+  {
+    rowOffsets[b] = 0;
+    columnOffsets[b] = 0;
+    nonzeroOffsets[b] = 0;
+  }
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    int comp = graphNodes[row].component;
+    rowOffsets[comp + 1]++;
+    nonzeroOffsets[comp + 1] += graphNodes[row + 1].degreeSum - graphNodes[row].degreeSum;
+  }
+  for (size_t column = 0; column < numColumns; ++column)
+    columnOffsets[graphNodes[firstColumnNode + column].component + 1]++;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    rowOffsets[b + 1] += rowOffsets[b];
+    columnOffsets[b + 1] += columnOffsets[b];
+    nonzeroOffsets[b + 1] += nonzeroOffsets[b];
+  }
+
+  /* Fill the permutations. */
+  for (size_t row = 0; row < numRows; ++row)
+    layout->rowsToOriginal[rowOffsets[graphNodes[row].component] + graphNodes[row].order] = row;
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    GRAPH_NODE* node = &graphNodes[firstColumnNode + column];
+    layout->columnsToOriginal[columnOffsets[node->component] + node->order] = column;
+  }
+
+  /* Create the views. The row slices of block b start at index offset + b since each block has a sentinel entry. */
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    CMR_CHRMAT* blockMatrix = &layout->matrices[b];
+    blockMatrix->numRows = rowOffsets[b + 1] - rowOffsets[b];
+    blockMatrix->numColumns = columnOffsets[b + 1] - columnOffsets[b];
+    blockMatrix->numNonzeros = nonzeroOffsets[b + 1] - nonzeroOffsets[b];
+    blockMatrix->rowSlice = &layout->rowSlices[rowOffsets[b] + b];
+    blockMatrix->entryColumns = layout->entryColumns ? &layout->entryColumns[nonzeroOffsets[b]] : NULL;
+    blockMatrix->entryValues = layout->entryValues ? &layout->entryValues[nonzeroOffsets[b]] : NULL;
+
+    CMR_CHRMAT* blockTranspose = &layout->transposes[b];
+    blockTranspose->numRows = blockMatrix->numColumns;
+    blockTranspose->numColumns = blockMatrix->numRows;
+    blockTranspose->numNonzeros = blockMatrix->numNonzeros;
+    blockTranspose->rowSlice = &layout->transposeRowSlices[columnOffsets[b] + b];
+    blockTranspose->entryColumns = layout->transposeEntryColumns ? &layout->transposeEntryColumns[nonzeroOffsets[b]]
+      : NULL;
+    blockTranspose->entryValues = layout->transposeEntryValues ? &layout->transposeEntryValues[nonzeroOffsets[b]]
+      : NULL;
+
+    layout->blocks[b].matrix = (CMR_MATRIX*) blockMatrix;
+    layout->blocks[b].transpose = (CMR_MATRIX*) blockTranspose;
+    layout->blocks[b].rowsToOriginal = &layout->rowsToOriginal[rowOffsets[b]];
+    layout->blocks[b].columnsToOriginal = &layout->columnsToOriginal[columnOffsets[b]];
+
+    /* Compute the row slices of the block. */
+    size_t countNonzeros = 0;
+    for (size_t blockRow = 0; blockRow < blockMatrix->numRows; ++blockRow)
+    {
+      size_t row = layout->blocks[b].rowsToOriginal[blockRow];
+      blockMatrix->rowSlice[blockRow] = countNonzeros;
+      countNonzeros += graphNodes[row + 1].degreeSum - graphNodes[row].degreeSum;
+    }
+    blockMatrix->rowSlice[blockMatrix->numRows] = countNonzeros;
+  }
+
+  /* The rows of large blocks are scattered in parallel, while distinct workers fill the other blocks. */
+  LayoutFill fill;
+  fill.matrix = matrix;
+  fill.graphNodes = graphNodes;
+  fill.layout = layout;
+  fill.firstRows = NULL;
+  fill.nextBlock = 0;
+  size_t numWorkers = decompositionNumWorkers(cmr, (CMR_MATRIX*) matrix);
+  CMR_CALL( CMRallocBlockArray(cmr, &fill.firstRows, numWorkers + 1) );
+  CMRthreadsSplitRows(matrix->rowSlice, matrix->numRows, layout->rowsToOriginal, numWorkers, fill.firstRows);
+  if (numWorkers > 1)
+  {
+    CMR_CALL( CMRthreadsRun(cmr, numWorkers, layoutRowsWorker, &fill) );
+    CMR_CALL( CMRthreadsRun(cmr, CMRthreadsNumWorkers(cmr, numBlocks), layoutBlocksWorker, &fill) );
+  }
+  else
+  {
+    CMR_CALL( layoutRowsWorker(cmr, 0, &fill) );
+    CMR_CALL( layoutBlocksWorker(cmr, 0, &fill) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &fill.firstRows) );
+
+  /* Large blocks are transposed twice by a counting sort that runs in parallel by itself, which sorts the rows. */
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    if (layout->matrices[b].numNonzeros >= LARGE_BLOCK_NONZEROS)
+    {
+      CMR_CALL( CMRmatrixTransposeInto(cmr, layout->blocks[b].matrix, sizeof(char), layout->blocks[b].transpose) );
+      CMR_CALL( CMRmatrixTransposeInto(cmr, layout->blocks[b].transpose, sizeof(char), layout->blocks[b].matrix) );
+    }
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    CMRconsistencyAssert( CMRchrmatConsistency(&layout->matrices[b]) );
+    CMRconsistencyAssert( CMRchrmatConsistency(&layout->transposes[b]) );
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &graphNodes) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRblockLayoutFree(CMR* cmr, CMR_BLOCK_LAYOUT** playout)
+{
+  assert(cmr);
+  assert(playout);
+
+  CMR_BLOCK_LAYOUT* layout = *playout;
+  if (!layout)
+    return CMR_OKAY;
+
+  /* Transposes of the views may have been cached. */
+  for (size_t b = 0; b < layout->numBlocks; ++b)
+    CMR_CALL( CMRchrmatInvalidateTranspose(cmr, &layout->matrices[b]) );
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->transposeEntryValues) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->transposeEntryColumns) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->transposeRowSlices) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->entryValues) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->entryColumns) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->rowSlices) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->transposes) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->matrices) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->columnsToOriginal) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->rowsToOriginal) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->nonzeroOffsets) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->columnOffsets) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->rowOffsets) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &layout->blocks) );
+  CMR_CALL( CMRfreeBlock(cmr, playout) );
+
+  return CMR_OKAY;
+}
@@ -40,6 +40,56 @@ CMR_ERROR CMRdecomposeBlocks(
   size_t* columnsToBlockColumns /**< Mapping of columns to columns of the component (may be \c NULL). */
 );
 
+/**
+ * \brief Block decomposition of a char matrix whose blocks are stored contiguously.
+ *
+ * The rows (resp. columns) of block \f$ b \f$ are those mapped to by entries \f$ rowOffsets[b], \dotsc,
+ * rowOffsets[b+1]-1 \f$ of \ref rowsToOriginal (resp. \ref columnsToOriginal). The matrices and transposes of all
+ * blocks are views into four shared buffers, i.e., the members of \ref blocks must not be freed individually.
+ */
+
+typedef struct
+{
+  size_t numBlocks;               /**< \brief Number of blocks. */
+  CMR_BLOCK* blocks;              /**< \brief Array with the blocks; their members point into the buffers below. */
+  size_t* rowOffsets;             /**< \brief Array mapping each block to its first row in \ref rowsToOriginal. */
+  size_t* columnOffsets;          /**< \brief Array mapping each block to its first column in \ref columnsToOriginal. */
+  size_t* nonzeroOffsets;         /**< \brief Array mapping each block to its first nonzero in the entry buffers. */
+  size_t* rowsToOriginal;         /**< \brief Permutation of the rows such that each block's rows are consecutive. */
+  size_t* columnsToOriginal;      /**< \brief Permutation of the columns such that each block's columns are
+                                   **         consecutive. */
+  CMR_CHRMAT* matrices;           /**< \brief Array with the views of the blocks' matrices. */
+  CMR_CHRMAT* transposes;         /**< \brief Array with the views of the blocks' transposed matrices. */
+  size_t* rowSlices;              /**< \brief Buffer with the row slices of all matrices. */
+  size_t* entryColumns;           /**< \brief Buffer with the entry columns of all matrices. */
+  char* entryValues;              /**< \brief Buffer with the entry values of all matrices. */
+  size_t* transposeRowSlices;     /**< \brief Buffer with the row slices of all transposed matrices. */
+  size_t* transposeEntryColumns;  /**< \brief Buffer with the entry columns of all transposed matrices. */
+  char* transposeEntryValues;     /**< \brief Buffer with the entry values of all transposed matrices. */
+} CMR_BLOCK_LAYOUT;
+
+/**
+ * \brief Decomposes a char matrix into 1-connected submatrices that are stored contiguously.
+ *
+ * In contrast to \ref CMRdecomposeBlocks, the number of allocations does not depend on the number of blocks. The
+ * layout has to be freed with \ref CMRblockLayoutFree.
+ */
+
+CMR_ERROR CMRdecomposeBlocksContiguous(
+  CMR* cmr,                   /**< \ref CMR environment */
+  CMR_CHRMAT* matrix,         /**< Matrix */
+  CMR_BLOCK_LAYOUT** playout  /**< Pointer for storing the layout. */
+);
+
+/**
+ * \brief Frees a block layout computed by \ref CMRdecomposeBlocksContiguous.
+ */
+
+CMR_ERROR CMRblockLayoutFree(
+  CMR* cmr,                   /**< \ref CMR environment */
+  CMR_BLOCK_LAYOUT** playout  /**< Pointer to the layout. */
+);
+
 #ifdef __cplusplus
 }
 #endif
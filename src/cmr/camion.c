@@ -6,6 +6,9 @@
 #include "matrix_internal.h"
 #include "block_decomposition.h"
 #include "env_internal.h"
+#include "entry_index.h"
+#include "sort.h"
+#include "threads.h"
 
 #if defined(CMR_DEBUG)
 #include <cmr/graphic.h>
@@ -14,7 +17,6 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdint.h>
-#include <time.h>
 
 CMR_ERROR CMRcamionStatsInit(CMR_CAMION_STATISTICS* stats)
 {
@@ -47,6 +49,33 @@ CMR_ERROR CMRcamionStatsPrint(FILE* stream, CMR_CAMION_STATISTICS* stats, const
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRcamionStatsPrintJson(FILE* stream, CMR_CAMION_STATISTICS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"general\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->generalCount, stats->generalTime);
+  fprintf(stream, ",\"graph\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->graphCount, stats->graphTime);
+  fprintf(stream, ",\"total\":{\"count\":%lu,\"time\":%.9g}}", (unsigned long)stats->totalCount, stats->totalTime);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRcamionStatsAdd(CMR_CAMION_STATISTICS* target, CMR_CAMION_STATISTICS* source)
+{
+  assert(target);
+  assert(source);
+
+  target->generalCount += source->generalCount;
+  target->generalTime += source->generalTime;
+  target->graphCount += source->graphCount;
+  target->graphTime += source->graphTime;
+  target->totalCount += source->totalCount;
+  target->totalTime += source->totalTime;
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Graph node for BFS in signing algorithm.
  */
@@ -66,7 +95,7 @@ CMR_ERROR CMRcamionComputeSignSequentiallyConnected(
   bool change,              /**< Whether to modify the matrix. */
   char* pmodification,      /**< Pointer for storing which matrix was modified.*/
   CMR_SUBMAT** psubmatrix,  /**< Pointer for storing a submatrix with bad determinant (may be \c NULL). */
-  double timeLimit          /**< Time limit to impose. */
+  const CMR_DEADLINE* deadline  /**< Deadline of the computation. */
 )
 {
   assert(cmr);
@@ -83,7 +112,7 @@ CMR_ERROR CMRcamionComputeSignSequentiallyConnected(
   if (matrix->numRows > matrix->numColumns)
   {
     CMR_CALL( CMRcamionComputeSignSequentiallyConnected(cmr, transpose, matrix, change, pmodification, psubmatrix,
-      timeLimit) );
+      deadline) );
     assert(*pmodification == 0 || *pmodification == 'm');
     if (psubmatrix && *psubmatrix)
     {
@@ -105,17 +134,22 @@ CMR_ERROR CMRcamionComputeSignSequentiallyConnected(
   int* bfsQueue = NULL;
   int bfsQueueBegin = 0;
   int bfsQueueEnd = 0;
-  clock_t time = clock();
 
   CMR_CALL(CMRallocStackArray(cmr, &graphNodes, matrix->numColumns + matrix->numRows));
   CMR_CALL(CMRallocStackArray(cmr, &bfsQueue, matrix->numColumns + matrix->numRows));
 
+  /* Index of the transpose's entries, which is created at the first sign change. */
+  CMR_ENTRY_INDEX transposeIndex;
+  transposeIndex.matrix = NULL;
+
   /* Main loop iterates over the rows. */
   size_t clockRows = matrix->numRows / 100 + 1;
   for (size_t row = 1; row < matrix->numRows; ++row)
   {
-    if ((row % clockRows) == 0 && ((clock() - time) * 1.0 / CLOCKS_PER_SEC > timeLimit))
+    if ((row % clockRows) == 0 && CMRdeadlinePassed(deadline))
     {
+      if (transposeIndex.matrix)
+        CMR_CALL( CMRentryIndexFree(cmr, &transposeIndex) );
       CMRfreeStackArray(cmr, &bfsQueue);
       CMRfreeStackArray(cmr, &graphNodes);
       return CMR_ERROR_TIMEOUT;
@@ -291,8 +325,9 @@ CMR_ERROR CMRcamionComputeSignSequentiallyConnected(
         {
           CMRdbgMsg(2, "Sign change at r%d,c%d.\n", row+1, column+1);
           matrix->entryValues[e] = graphNodes[column].targetValue;
-          size_t entry = SIZE_MAX;
-          CMR_CALL( CMRchrmatFindEntry(transpose, column, row, &entry) );
+          if (!transposeIndex.matrix)
+            CMR_CALL( CMRentryIndexCreate(cmr, transpose, &transposeIndex) );
+          size_t entry = CMRentryIndexFind(&transposeIndex, column, row);
           assert(entry < SIZE_MAX);
           assert(transpose->entryValues[entry] == -graphNodes[column].targetValue);
           transpose->entryValues[entry] = graphNodes[column].targetValue;
@@ -309,6 +344,8 @@ CMR_ERROR CMRcamionComputeSignSequentiallyConnected(
   }
 #endif /* CMR_DEBUG */
 
+  if (transposeIndex.matrix)
+    CMR_CALL( CMRentryIndexFree(cmr, &transposeIndex) );
   CMRfreeStackArray(cmr, &bfsQueue);
   CMRfreeStackArray(cmr, &graphNodes);
 
@@ -316,55 +353,124 @@ CMR_ERROR CMRcamionComputeSignSequentiallyConnected(
 }
 
 /**
- * \brief Signs a given matrix.
+ * \brief Data shared by the workers that sign the blocks of a matrix.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* matrix;       /**< \brief Matrix \f$ M \f$. */
+  CMR_BLOCK* blocks;        /**< \brief Array with the 1-connected blocks of \f$ M \f$. */
+  size_t* blockOrder;       /**< \brief Order in which the blocks are processed. */
+  size_t numBlocks;         /**< \brief Number of blocks. */
+  bool change;              /**< \brief Whether the signs of \f$ M \f$ shall be modified. */
+  bool findSubmatrix;       /**< \brief Whether a non-camion submatrix shall be found. */
+  CMR_DEADLINE deadline;    /**< \brief Deadline of the computation. */
+  size_t nextBlock;         /**< \brief Next entry of \ref blockOrder to be processed, accessed atomically. */
+  size_t witnessBlock;      /**< \brief Smallest index of a block that is not Camion-signed, or \c SIZE_MAX. */
+  CMR_SUBMAT* submatrix;    /**< \brief Non-camion submatrix of block \ref witnessBlock, or \c NULL. */
+  bool cancel;              /**< \brief Whether all workers shall stop, accessed atomically. */
+  CMR_MUTEX mutex;          /**< \brief Mutex for \ref witnessBlock and \ref submatrix. */
+} CamionSigning;
+
+/**
+ * \brief Copies the signs of a modified block back to the matrix.
+ *
+ * Distinct blocks have disjoint nonzeros, so blocks may be copied back concurrently.
  */
 
 static
-CMR_ERROR signCamion(
-  CMR* cmr,                     /**< \ref CMR environment. */
-  CMR_CHRMAT* matrix,           /**< Matrix \f$ M \f$. */
-  bool change,                  /**< Whether the signs of \f$ M \f$ shall be modified. */
-  bool* pisCamionSigned,        /**< Pointer for storing whether \f$ M \f$ was already [Camion-signed](\ref camion). */
-  CMR_SUBMAT** psubmatrix,      /**< Pointer for storing a non-camion submatrix (may be \c NULL). */
-  CMR_CAMION_STATISTICS* stats, /**< Statistics for the computation (may be \c NULL). */
-  double timeLimit              /**< Time limit to impose. */
+void copyBlockSigns(
+  CMR_CHRMAT* matrix,   /**< Matrix \f$ M \f$. */
+  CMR_BLOCK* block,     /**< Block of \f$ M \f$. */
+  bool copyTranspose    /**< Whether the transpose of the block was modified instead of the block itself. */
 )
 {
-  assert(cmr);
-  assert(matrix);
-  assert(!psubmatrix || !*psubmatrix);
+  /* Either the matrix or its transposed was modified. */
+  CMR_CHRMAT* sourceMatrix = copyTranspose ? (CMR_CHRMAT*) block->transpose : (CMR_CHRMAT*) block->matrix;
 
-  clock_t totalClock = clock();
+  for (size_t sourceRow = 0; sourceRow < sourceMatrix->numRows; ++sourceRow)
+  {
+    size_t sourceFirst = sourceMatrix->rowSlice[sourceRow];
+    size_t sourceBeyond = sourceMatrix->rowSlice[sourceRow + 1];
+    for (size_t  sourceEntry = sourceFirst; sourceEntry < sourceBeyond; ++sourceEntry)
+    {
+      size_t sourceColumn = sourceMatrix->entryColumns[sourceEntry];
+      size_t compRow = copyTranspose ? sourceColumn : sourceRow;
+      size_t compColumn = copyTranspose ? sourceRow : sourceColumn;
+      size_t row = block->rowsToOriginal[compRow];
+      size_t column = block->columnsToOriginal[compColumn];
 
-  size_t numBlocks;
-  CMR_BLOCK* blocks = NULL;
+      CMRdbgMsg(4, "Searching entry for row %d and column %d.\n", row, column);
 
-  assert(CMRchrmatIsTernary(cmr, matrix, NULL));
+      /* Perform binary search in row of original matrix to find the column. */
 
-#if defined(CMR_DEBUG)
-  CMRdbgMsg(0, "signCamion:\n");
-  CMRchrmatPrintDense(cmr, matrix, stdout, '0', true);
-#endif /* CMR_DEBUG */
+      size_t lower = matrix->rowSlice[row];
+      size_t upper = matrix->rowSlice[row + 1];
+      while (lower < upper)
+      {
+        size_t entry = (lower + upper) / 2;
+        size_t searchColumn = matrix->entryColumns[entry];
+        if (column < searchColumn)
+          upper = entry;
+        else if (column > searchColumn)
+          lower = entry + 1;
+        else
+        {
+          CMRdbgMsg(4, "Original matrix entry %d (%d) is replaced by source matrix entry %d (%d).\n", entry,
+            matrix->entryValues[entry], sourceEntry, sourceMatrix->entryValues[sourceEntry]);
+          matrix->entryValues[entry] = sourceMatrix->entryValues[sourceEntry];
+          break;
+        }
+      }
+      assert(lower < upper);
+    }
+  }
+}
 
-  /* Decompose into 1-connected components. */
+/**
+ * \brief Signs blocks until all are processed or the computation is canceled.
+ *
+ * If the matrix shall not be modified, blocks beyond the first block that is not Camion-signed are skipped.
+ */
+
+static
+CMR_ERROR camionSignWorker(
+  CMR* cmr,       /**< \ref CMR environment of the worker. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref CamionSigning. */
+)
+{
+  CMR_UNUSED(worker);
 
-  CMR_CALL( CMRdecomposeBlocks(cmr, (CMR_MATRIX*) matrix, sizeof(char), sizeof(char), &numBlocks, &blocks, NULL,
-    NULL, NULL, NULL) );
+  CamionSigning* signing = (CamionSigning*) data;
+  CMR_ERROR error = CMR_OKAY;
 
-  if (pisCamionSigned)
-    *pisCamionSigned = true;
-  for (size_t comp = 0; comp < numBlocks; ++comp)
+  while (!CMRatomicLoadFlag(&signing->cancel))
   {
-    CMR_SUBMAT* compSubmatrix = NULL;
+    size_t next = CMRatomicFetchAdd(&signing->nextBlock, 1);
+    if (next >= signing->numBlocks)
+      break;
+    size_t comp = signing->blockOrder[next];
+    CMR_BLOCK* block = &signing->blocks[comp];
 
-    CMRdbgMsg(2, "-> Block %d of size %dx%d\n", comp, blocks[comp].matrix->numRows,
-      blocks[comp].matrix->numColumns);
+    if (!signing->change)
+    {
+      CMRmutexLock(&signing->mutex);
+      bool pending = comp < signing->witnessBlock;
+      CMRmutexUnlock(&signing->mutex);
+      if (!pending)
+        continue;
+    }
+
+    CMRdbgMsg(2, "-> Block %d of size %dx%d\n", comp, block->matrix->numRows, block->matrix->numColumns);
 
-    double remainingTime = timeLimit - ((clock() - totalClock) * 1.0 / CLOCKS_PER_SEC);
     char modified;
-    CMR_CALL( CMRcamionComputeSignSequentiallyConnected(cmr, (CMR_CHRMAT*) blocks[comp].matrix,
-      (CMR_CHRMAT*) blocks[comp].transpose, change, &modified,
-      (psubmatrix && !*psubmatrix) ? &compSubmatrix : NULL, remainingTime) );
+    CMR_SUBMAT* compSubmatrix = NULL;
+    error = CMRcamionComputeSignSequentiallyConnected(cmr, (CMR_CHRMAT*) block->matrix,
+      (CMR_CHRMAT*) block->transpose, signing->change, &modified, signing->findSubmatrix ? &compSubmatrix : NULL,
+      &signing->deadline);
+    if (error)
+      break;
 
     CMRdbgMsg(2, "-> Block %d yields: %c\n", comp, modified ? modified : '0');
 
@@ -374,79 +480,143 @@ CMR_ERROR signCamion(
       continue;
     }
 
-    if (pisCamionSigned)
-      *pisCamionSigned = false;
-
-    /* If we found a submatrix for the first time: */
     if (compSubmatrix)
     {
-      assert(psubmatrix && !*psubmatrix);
       /* Translate component indices to indices of whole matrix and sort them again. */
       for (size_t r = 0; r < compSubmatrix->numRows; ++r)
-        compSubmatrix->rows[r] = blocks[comp].rowsToOriginal[compSubmatrix->rows[r]];
+        compSubmatrix->rows[r] = block->rowsToOriginal[compSubmatrix->rows[r]];
       for (size_t c = 0; c < compSubmatrix->numColumns; ++c)
-        compSubmatrix->columns[c] = blocks[comp].columnsToOriginal[compSubmatrix->columns[c]];
+        compSubmatrix->columns[c] = block->columnsToOriginal[compSubmatrix->columns[c]];
       CMRsortSubmatrix(cmr, compSubmatrix);
-      *psubmatrix = compSubmatrix;
     }
 
-    /* As we don't modify, we can abort early. */
-    if (!change)
+    /* The submatrix of the first block that is not Camion-signed is reported. */
+    CMRmutexLock(&signing->mutex);
+    if (comp < signing->witnessBlock)
     {
-      CMRdbgMsg(2, "Aborting early because we don't change the matrix.\n");
-      break;
+      signing->witnessBlock = comp;
+      CMR_SUBMAT* swap = signing->submatrix;
+      signing->submatrix = compSubmatrix;
+      compSubmatrix = swap;
+    }
+    CMRmutexUnlock(&signing->mutex);
+    if (compSubmatrix)
+    {
+      error = CMRsubmatFree(cmr, &compSubmatrix);
+      if (error)
+        break;
     }
-
-    assert(modified == 'm' || modified == 't');
-    bool copyTranspose = modified == 't';
-
-    /* Either the matrix or its transposed was modified. */
-    CMR_CHRMAT* sourceMatrix = copyTranspose ?
-      (CMR_CHRMAT*) blocks[comp].transpose :
-      (CMR_CHRMAT*) blocks[comp].matrix;
 
     /* We have to copy the changes back to the original matrix. */
-    for (size_t sourceRow = 0; sourceRow < sourceMatrix->numRows; ++sourceRow)
+    if (signing->change)
     {
-      size_t sourceFirst = sourceMatrix->rowSlice[sourceRow];
-      size_t sourceBeyond = sourceMatrix->rowSlice[sourceRow + 1];
-      for (size_t  sourceEntry = sourceFirst; sourceEntry < sourceBeyond; ++sourceEntry)
-      {
-        size_t sourceColumn = sourceMatrix->entryColumns[sourceEntry];
-        size_t compRow = copyTranspose ? sourceColumn : sourceRow;
-        size_t compColumn = copyTranspose ? sourceRow : sourceColumn;
-        size_t row = blocks[comp].rowsToOriginal[compRow];
-        size_t column = blocks[comp].columnsToOriginal[compColumn];
+      assert(modified == 'm' || modified == 't');
+      copyBlockSigns(signing->matrix, block, modified == 't');
+    }
+  }
 
-        CMRdbgMsg(4, "Searching entry for row %d and column %d.\n", row, column);
+  /* A failing worker stops all others. */
+  if (error)
+    CMRatomicStoreFlag(&signing->cancel, true);
 
-        /* Perform binary search in row of original matrix to find the column. */
+  return error;
+}
 
-        size_t lower = matrix->rowSlice[row];
-        size_t upper = matrix->rowSlice[row + 1];
-        while (lower < upper)
-        {
-          size_t entry = (lower + upper) / 2;
-          size_t searchColumn = matrix->entryColumns[entry];
-          if (column < searchColumn)
-            upper = entry;
-          else if (column > searchColumn)
-            lower = entry + 1;
-          else
-          {
-            CMRdbgMsg(4, "Original matrix entry %d (%d) is replaced by source matrix entry %d (%d).\n", entry,
-              matrix->entryValues[entry], sourceEntry, sourceMatrix->entryValues[sourceEntry]);
-            matrix->entryValues[entry] = sourceMatrix->entryValues[sourceEntry];
-            break;
-          }
-        }
-        assert(lower < upper);
-      }
-    }
+/**
+ * \brief Orders blocks by descending number of nonzeros.
+ */
+
+#define BLOCK_NONZEROS_LESS(a, b) ((a) > (b))
+
+CMR_SORT_DEFINE_PAIRS(sortBlocksNonzeros, size_t, size_t, BLOCK_NONZEROS_LESS)
+
+/**
+ * \brief Signs a given matrix.
+ *
+ * The 1-connected blocks of the matrix are independent and signed concurrently. The largest blocks are started first
+ * to balance the work among the workers.
+ */
+
+static
+CMR_ERROR signCamion(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,           /**< Matrix \f$ M \f$. */
+  bool change,                  /**< Whether the signs of \f$ M \f$ shall be modified. */
+  bool* pisCamionSigned,        /**< Pointer for storing whether \f$ M \f$ was already [Camion-signed](\ref camion). */
+  CMR_SUBMAT** psubmatrix,      /**< Pointer for storing a non-camion submatrix (may be \c NULL). */
+  CMR_CAMION_STATISTICS* stats, /**< Statistics for the computation (may be \c NULL). */
+  double timeLimit              /**< Time limit to impose. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(!psubmatrix || !*psubmatrix);
+
+  double totalClock = CMRclockNow();
+
+  assert(CMRchrmatIsTernary(cmr, matrix, NULL));
+
+#if defined(CMR_DEBUG)
+  CMRdbgMsg(0, "signCamion:\n");
+  CMRchrmatPrintDense(cmr, matrix, stdout, '0', true);
+#endif /* CMR_DEBUG */
+
+  /* Decompose into 1-connected components. */
+
+  CMR_BLOCK_LAYOUT* layout = NULL;
+  CMR_CALL( CMRdecomposeBlocksContiguous(cmr, matrix, &layout) );
+  size_t numBlocks = layout->numBlocks;
+  CMR_BLOCK* blocks = layout->blocks;
+
+  CamionSigning signing;
+  signing.matrix = matrix;
+  signing.blocks = blocks;
+  signing.blockOrder = NULL;
+  signing.numBlocks = numBlocks;
+  signing.change = change;
+  signing.findSubmatrix = psubmatrix != NULL;
+  signing.deadline = CMRdeadlineCreate(cmr, timeLimit);
+  signing.nextBlock = 0;
+  signing.witnessBlock = SIZE_MAX;
+  signing.submatrix = NULL;
+  signing.cancel = false;
+  CMRmutexInit(&signing.mutex);
+
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, numBlocks);
+  CMR_CALL( CMRallocBlockArray(cmr, &signing.blockOrder, numBlocks) );
+  for (size_t comp = 0; comp < numBlocks; ++comp)
+    signing.blockOrder[comp] = comp;
+  if (numWorkers > 1)
+  {
+    size_t* blockNonzeros = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &blockNonzeros, numBlocks) );
+    for (size_t comp = 0; comp < numBlocks; ++comp)
+      blockNonzeros[comp] = ((CMR_CHRMAT*) blocks[comp].matrix)->numNonzeros;
+    sortBlocksNonzeros(blockNonzeros, signing.blockOrder, numBlocks);
+    CMR_CALL( CMRfreeStackArray(cmr, &blockNonzeros) );
+  }
+
+  CMR_ERROR error = CMRthreadsRun(cmr, numWorkers, camionSignWorker, &signing);
+
+  CMRmutexFree(&signing.mutex);
+  CMR_CALL( CMRfreeBlockArray(cmr, &signing.blockOrder) );
+
+  if (!error)
+  {
+    if (pisCamionSigned)
+      *pisCamionSigned = signing.witnessBlock == SIZE_MAX;
+    if (psubmatrix)
+      *psubmatrix = signing.submatrix;
   }
+  else if (signing.submatrix)
+    CMR_CALL( CMRsubmatFree(cmr, &signing.submatrix) );
+
+  /* A cached transpose of the original matrix may no longer be its transpose. */
+  if (change)
+    CMR_CALL( CMRchrmatInvalidateTranspose(cmr, matrix) );
 
 #if defined(CMR_DEBUG)
-  if (pisCamionSigned && !*pisCamionSigned && change)
+  if (!error && signing.witnessBlock != SIZE_MAX && change)
   {
     CMRdbgMsg(0, "Modified original matrix:\n");
     CMRchrmatPrintDense(cmr, matrix, stdout, ' ', true);
@@ -455,18 +625,14 @@ CMR_ERROR signCamion(
 
   /* Clean-up */
 
-  for (size_t c = 0; c < numBlocks; ++c)
-  {
-    CMRchrmatFree(cmr, (CMR_CHRMAT**) &blocks[c].matrix);
-    CMRchrmatFree(cmr, (CMR_CHRMAT**) &blocks[c].transpose);
-    CMRfreeBlockArray(cmr, &blocks[c].rowsToOriginal);
-    CMRfreeBlockArray(cmr, &blocks[c].columnsToOriginal);
-  }
-  CMRfreeBlockArray(cmr, &blocks);
+  CMR_CALL( CMRblockLayoutFree(cmr, &layout) );
+
+  if (error)
+    return error;
 
   if (stats)
   {
-    double time = (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
+    double time = CMRclockNow() - totalClock;
     stats->generalCount++;
     stats->generalTime += time;
     stats->totalCount++;
@@ -605,7 +771,7 @@ CMR_ERROR CMRcamionCographicOrient(CMR* cmr, CMR_CHRMAT* matrix, CMR_GRAPH* cogr
   assert(pisCamionSigned);
   assert(!psubmatrix || !*psubmatrix);
 
-  clock_t totalClock = clock();
+  double totalClock = CMRclockNow();
 
 #if defined(CMR_DEBUG)
 
@@ -663,10 +829,10 @@ CMR_ERROR CMRcamionCographicOrient(CMR* cmr, CMR_CHRMAT* matrix, CMR_GRAPH* cogr
 #endif /* CMR_DEBUG */
 
   /* Decompose into blocks. */
-  size_t numBlocks;
-  CMR_BLOCK* blocks = NULL;
-  CMR_CALL( CMRdecomposeBlocks(cmr, (CMR_MATRIX*) matrix, sizeof(char), sizeof(char), &numBlocks, &blocks, NULL,
-    NULL, NULL, NULL) );
+  CMR_BLOCK_LAYOUT* layout = NULL;
+  CMR_CALL( CMRdecomposeBlocksContiguous(cmr, matrix, &layout) );
+  size_t numBlocks = layout->numBlocks;
+  CMR_BLOCK* blocks = layout->blocks;
 
   /* Allocate and initialize auxiliary data for nodes. */
   OrientationSearchNodeData* nodeData = NULL;
@@ -705,6 +871,10 @@ CMR_ERROR CMRcamionCographicOrient(CMR* cmr, CMR_CHRMAT* matrix, CMR_GRAPH* cogr
   CMR_CALL(CMRallocStackArray(cmr, &queue, matrix->numColumns + matrix->numRows));
   CMRassertStackConsistency(cmr);
 
+  /* The searches only read the cograph, so we traverse a compact copy of its incidence lists. */
+  CMR_GRAPH_FROZEN* frozen = NULL;
+  CMR_CALL( CMRgraphFreeze(cmr, cograph, &frozen) );
+
   /* Process each block separately. */
   for (size_t b = 0; b < numBlocks; ++b)
   {
@@ -748,17 +918,15 @@ CMR_ERROR CMRcamionCographicOrient(CMR* cmr, CMR_CHRMAT* matrix, CMR_GRAPH* cogr
       ++queueFirst;
       CMRdbgMsg(6, "Processing node %d.\n", v);
       nodeData[v].stage = COMPLETED;
-      for (CMR_GRAPH_ITER i = CMRgraphIncFirst(cograph, v); CMRgraphIncValid(cograph, i);
-        i = CMRgraphIncNext(cograph, i))
+      for (size_t i = CMRgraphFrozenIncFirst(frozen, v); i < CMRgraphFrozenIncBeyond(frozen, v); ++i)
       {
-        assert(CMRgraphIncSource(cograph, i) == v);
-        CMR_GRAPH_NODE w = CMRgraphIncTarget(cograph, i);
+        CMR_GRAPH_NODE w = CMRgraphFrozenIncTarget(frozen, i);
 
         /* Skip if already completed. */
         if (nodeData[w].stage == COMPLETED)
           continue;
 
-        CMR_GRAPH_EDGE e = CMRgraphIncEdge(cograph, i);
+        CMR_GRAPH_EDGE e = CMRgraphFrozenIncEdge(frozen, i);
 
         /* We skip cotree edges. */
         if (CMRelementIsRow(edgeData[e].element))
@@ -962,6 +1130,7 @@ CMR_ERROR CMRcamionCographicOrient(CMR* cmr, CMR_CHRMAT* matrix, CMR_GRAPH* cogr
 cleanup:
 
   /* Free search data. */
+  CMR_CALL( CMRgraphFrozenFree(cmr, &frozen) );
   CMRassertStackConsistency(cmr);
   CMR_CALL( CMRfreeStackArray(cmr, &queue) );
   CMR_CALL( CMRfreeStackArray(cmr, &edgeData) );
@@ -969,18 +1138,11 @@ cleanup:
   CMRassertStackConsistency(cmr);
 
   /* Free memory of block decomposition. */
-  for (size_t c = 0; c < numBlocks; ++c)
-  {
-    CMRchrmatFree(cmr, (CMR_CHRMAT**) &blocks[c].matrix);
-    CMRchrmatFree(cmr, (CMR_CHRMAT**) &blocks[c].transpose);
-    CMRfreeBlockArray(cmr, &blocks[c].rowsToOriginal);
-    CMRfreeBlockArray(cmr, &blocks[c].columnsToOriginal);
-  }
-  CMRfreeBlockArray(cmr, &blocks);
+  CMR_CALL( CMRblockLayoutFree(cmr, &layout) );
 
   if (stats)
   {
-    double time = (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
+    double time = CMRclockNow() - totalClock;
     stats->graphCount++;
     stats->graphTime += time;
     stats->totalCount++;
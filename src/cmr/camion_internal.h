@@ -4,6 +4,8 @@
 #include <cmr/env.h>
 #include <cmr/matrix.h>
 
+#include "deadline.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -26,7 +28,7 @@ CMR_ERROR CMRcamionComputeSignSequentiallyConnected(
   bool change,              /**< Whether signs of \p matrix should be changed if necessary. */
   char* pmodification,      /**< Pointer for storing which matrix was modified. */
   CMR_SUBMAT** psubmatrix,  /**< Pointer for storing a submatrix with a bad determinant (may be \c NULL). */
-  double timeLimit          /**< Time limit to impose. */
+  const CMR_DEADLINE* deadline  /**< Deadline of the computation. */
 );
 
 #ifdef __cplusplus
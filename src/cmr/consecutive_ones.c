@@ -0,0 +1,692 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/consecutive_ones.h>
+
+#include "env_internal.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * \file consecutive_ones.c
+ *
+ * The rows are reduced one after another in a PQ-tree whose leaves are the columns, following Booth and Lueker
+ * (Testing for the consecutive ones property, interval graphs, and graph planarity using PQ-tree algorithms, Journal of
+ * Computer and System Sciences, 1976). The nodes of the pertinent subtree, i.e., of the smallest subtree that contains
+ * all leaves of the row, are processed bottom-up and replaced according to the templates. In contrast to the original
+ * algorithm, every child of a Q-node knows its parent. Hence, the marking of a row walks up to the root of the tree,
+ * and merging a Q-node into its parent takes time linear in the number of its children instead of constant time.
+ */
+
+#define NONE SIZE_MAX /**< Marker for a missing node. */
+
+typedef enum
+{
+  C1P_LEAF = 0,   /**< Leaf, i.e., a column. */
+  C1P_PNODE = 1,  /**< P-node, whose children can be permuted arbitrarily. */
+  C1P_QNODE = 2   /**< Q-node, whose children can only be reversed. */
+} C1P_NODE_TYPE;
+
+typedef enum
+{
+  C1P_FULL = 1,     /**< All leaves of the subtree belong to the row. */
+  C1P_PARTIAL = 2   /**< Some leaves of the subtree belong to the row; the node is then a Q-node whose first children
+                     **  are empty and whose last children are full. */
+} C1P_LABEL;
+
+/**
+ * \brief Node of a PQ-tree.
+ */
+
+typedef struct
+{
+  C1P_NODE_TYPE type;           /**< \brief Type of node. */
+  size_t parent;                /**< \brief Parent node or \ref NONE for the root. */
+  size_t prev;                  /**< \brief Previous sibling or \ref NONE. */
+  size_t next;                  /**< \brief Next sibling or \ref NONE. */
+  size_t first;                 /**< \brief First child or \ref NONE. */
+  size_t last;                  /**< \brief Last child or \ref NONE. */
+  size_t numChildren;           /**< \brief Number of children. */
+  size_t stamp;                 /**< \brief Row for which the remaining members are valid. */
+  size_t numMarkedChildren;     /**< \brief Number of children that contain leaves of the row. */
+  size_t numProcessedChildren;  /**< \brief Number of these children that are already processed. */
+  size_t numLeaves;             /**< \brief Number of leaves of the row in the subtree. */
+  C1P_LABEL label;              /**< \brief Label after processing. */
+  size_t fullChildren;          /**< \brief First of the full children, which are linked via \ref nextListed. */
+  size_t numFullChildren;       /**< \brief Number of full children. */
+  size_t partialChildren;       /**< \brief First of the partial children, which are linked via \ref nextListed. */
+  size_t numPartialChildren;    /**< \brief Number of partial children. */
+  size_t nextListed;            /**< \brief Next node in the list of full or partial children of the parent. */
+} C1PNode;
+
+/**
+ * \brief PQ-tree.
+ */
+
+typedef struct
+{
+  C1PNode* nodes;       /**< \brief Array of nodes; the first ones are the leaves. */
+  size_t memNodes;      /**< \brief Memory for nodes. */
+  size_t firstFree;     /**< \brief First unused node; the unused nodes are linked via their \ref C1PNode::next. */
+  size_t root;          /**< \brief Root node. */
+  size_t* queue;        /**< \brief Queue of nodes whose marked children are all processed. */
+} PQTree;
+
+/**
+ * \brief Returns a new node of type \p type without children.
+ */
+
+static
+size_t pqNewNode(
+  PQTree* tree,       /**< PQ-tree. */
+  C1P_NODE_TYPE type, /**< Type of the node. */
+  size_t stamp        /**< Current row. */
+)
+{
+  size_t node = tree->firstFree;
+  assert(node != NONE);
+  C1PNode* data = &tree->nodes[node];
+  tree->firstFree = data->next;
+  data->type = type;
+  data->parent = NONE;
+  data->prev = NONE;
+  data->next = NONE;
+  data->first = NONE;
+  data->last = NONE;
+  data->numChildren = 0;
+  data->stamp = stamp;
+  data->numMarkedChildren = 0;
+  data->numProcessedChildren = 0;
+  data->numLeaves = 0;
+  data->fullChildren = NONE;
+  data->numFullChildren = 0;
+  data->partialChildren = NONE;
+  data->numPartialChildren = 0;
+  data->nextListed = NONE;
+
+  return node;
+}
+
+/**
+ * \brief Releases \p node, which must have neither a parent nor children.
+ */
+
+static
+void pqFreeNode(
+  PQTree* tree, /**< PQ-tree. */
+  size_t node   /**< Node. */
+)
+{
+  assert(tree->nodes[node].parent == NONE);
+  assert(tree->nodes[node].numChildren == 0);
+
+  tree->nodes[node].next = tree->firstFree;
+  tree->firstFree = node;
+}
+
+/**
+ * \brief Removes \p node from the list of children of its parent.
+ */
+
+static
+void pqUnlink(
+  PQTree* tree, /**< PQ-tree. */
+  size_t node   /**< Node. */
+)
+{
+  C1PNode* data = &tree->nodes[node];
+  size_t parent = data->parent;
+  assert(parent != NONE);
+
+  if (data->prev == NONE)
+    tree->nodes[parent].first = data->next;
+  else
+    tree->nodes[data->prev].next = data->next;
+  if (data->next == NONE)
+    tree->nodes[parent].last = data->prev;
+  else
+    tree->nodes[data->next].prev = data->prev;
+  tree->nodes[parent].numChildren--;
+  data->parent = NONE;
+  data->prev = NONE;
+  data->next = NONE;
+}
+
+/**
+ * \brief Inserts \p node, which has no parent, as a child of \p parent before \p sibling, or as its last child if
+ *        \p sibling is \ref NONE.
+ */
+
+static
+void pqInsertBefore(
+  PQTree* tree,   /**< PQ-tree. */
+  size_t parent,  /**< New parent. */
+  size_t node,    /**< Node. */
+  size_t sibling  /**< Child of \p parent or \ref NONE. */
+)
+{
+  C1PNode* data = &tree->nodes[node];
+  C1PNode* parentData = &tree->nodes[parent];
+  assert(data->parent == NONE);
+
+  data->parent = parent;
+  data->next = sibling;
+  if (sibling == NONE)
+  {
+    data->prev = parentData->last;
+    parentData->last = node;
+  }
+  else
+  {
+    assert(tree->nodes[sibling].parent == parent);
+    data->prev = tree->nodes[sibling].prev;
+    tree->nodes[sibling].prev = node;
+  }
+  if (data->prev == NONE)
+    parentData->first = node;
+  else
+    tree->nodes[data->prev].next = node;
+  parentData->numChildren++;
+}
+
+/**
+ * \brief Puts \p replacement, which has no parent, at the position of \p node, which is removed from the tree.
+ */
+
+static
+void pqReplace(
+  PQTree* tree,       /**< PQ-tree. */
+  size_t node,        /**< Node to be replaced. */
+  size_t replacement  /**< Replacing node. */
+)
+{
+  size_t parent = tree->nodes[node].parent;
+  if (parent == NONE)
+  {
+    assert(tree->root == node);
+    tree->root = replacement;
+    return;
+  }
+
+  size_t next = tree->nodes[node].next;
+  pqUnlink(tree, node);
+  pqInsertBefore(tree, parent, replacement, next);
+}
+
+/**
+ * \brief Removes the \p count nodes listed from \p listed from their parent and returns a node that represents them.
+ *
+ * This is a new P-node with these children or, if \p count is 1, that node itself.
+ */
+
+static
+size_t pqGroup(
+  PQTree* tree,   /**< PQ-tree. */
+  size_t listed,  /**< First listed node. */
+  size_t count,   /**< Number of listed nodes. */
+  size_t stamp    /**< Current row. */
+)
+{
+  assert(count > 0);
+
+  if (count == 1)
+  {
+    pqUnlink(tree, listed);
+    return listed;
+  }
+
+  size_t group = pqNewNode(tree, C1P_PNODE, stamp);
+  for (size_t node = listed; node != NONE; )
+  {
+    size_t nextListed = tree->nodes[node].nextListed;
+    pqUnlink(tree, node);
+    pqInsertBefore(tree, group, node, NONE);
+    node = nextListed;
+  }
+  assert(tree->nodes[group].numChildren == count);
+
+  return group;
+}
+
+/**
+ * \brief Replaces the Q-node child \p child of \p node by its children, keeping their order if \p forward is \c true
+ *        and reversing it otherwise.
+ */
+
+static
+void pqMerge(
+  PQTree* tree, /**< PQ-tree. */
+  size_t node,  /**< Q-node. */
+  size_t child, /**< Q-node child. */
+  bool forward  /**< Whether the order of the children of \p child is kept. */
+)
+{
+  assert(tree->nodes[node].type == C1P_QNODE);
+  assert(tree->nodes[child].type == C1P_QNODE);
+
+  while (tree->nodes[child].numChildren > 0)
+  {
+    size_t grandchild = forward ? tree->nodes[child].first : tree->nodes[child].last;
+    pqUnlink(tree, grandchild);
+    pqInsertBefore(tree, node, grandchild, child);
+  }
+  pqUnlink(tree, child);
+  pqFreeNode(tree, child);
+}
+
+/**
+ * \brief Reverses the children of \p node.
+ */
+
+static
+void pqReverse(
+  PQTree* tree, /**< PQ-tree. */
+  size_t node   /**< Node. */
+)
+{
+  C1PNode* data = &tree->nodes[node];
+  for (size_t child = data->first; child != NONE; )
+  {
+    C1PNode* childData = &tree->nodes[child];
+    size_t next = childData->next;
+    childData->next = childData->prev;
+    childData->prev = next;
+    child = next;
+  }
+  size_t first = data->first;
+  data->first = data->last;
+  data->last = first;
+}
+
+/**
+ * \brief Returns \c true if and only if \p node contains leaves of the current row.
+ */
+
+static inline
+bool pqIsPertinent(
+  PQTree* tree, /**< PQ-tree. */
+  size_t node,  /**< Node. */
+  size_t stamp  /**< Current row. */
+)
+{
+  return node != NONE && tree->nodes[node].stamp == stamp;
+}
+
+/**
+ * \brief Applies the template for the P-node \p node all of whose pertinent children are processed.
+ *
+ * \returns \c false if the row cannot be made consecutive.
+ */
+
+static
+bool pqReducePNode(
+  PQTree* tree,   /**< PQ-tree. */
+  size_t node,    /**< P-node. */
+  bool isRoot,    /**< Whether \p node is the root of the pertinent subtree. */
+  size_t stamp,   /**< Current row. */
+  size_t* presult /**< Pointer for storing the node that replaces \p node. */
+)
+{
+  C1PNode* data = &tree->nodes[node];
+  size_t numFull = data->numFullChildren;
+  size_t numPartial = data->numPartialChildren;
+  size_t numLeaves = data->numLeaves;
+  *presult = node;
+
+  if (numPartial == 0 && numFull == data->numChildren)
+  {
+    data->label = C1P_FULL;
+    return true;
+  }
+  if (numPartial > (isRoot ? 2 : 1))
+    return false;
+
+  size_t fullGroup = numFull ? pqGroup(tree, data->fullChildren, numFull, stamp) : NONE;
+  data = &tree->nodes[node];
+
+  if (isRoot)
+  {
+    if (numPartial == 0)
+    {
+      /* Template P2: the full children are grouped below the root. */
+      pqInsertBefore(tree, node, fullGroup, NONE);
+      return true;
+    }
+
+    /* Templates P4 and P6: the full children are put between the partial children. */
+    size_t partial = data->partialChildren;
+    if (fullGroup != NONE)
+      pqInsertBefore(tree, partial, fullGroup, NONE);
+    if (numPartial == 2)
+    {
+      size_t other = tree->nodes[partial].nextListed;
+      while (tree->nodes[other].numChildren > 0)
+      {
+        size_t grandchild = tree->nodes[other].last;
+        pqUnlink(tree, grandchild);
+        pqInsertBefore(tree, partial, grandchild, NONE);
+      }
+      pqUnlink(tree, other);
+      pqFreeNode(tree, other);
+    }
+    if (tree->nodes[node].numChildren == 1)
+    {
+      pqUnlink(tree, partial);
+      pqReplace(tree, node, partial);
+      pqFreeNode(tree, node);
+      *presult = partial;
+    }
+    return true;
+  }
+
+  /* Templates P3 and P5: the node becomes a partial Q-node with the empty children first and the full ones last. */
+  size_t result;
+  if (numPartial == 0)
+  {
+    result = pqNewNode(tree, C1P_QNODE, stamp);
+    pqReplace(tree, node, result);
+  }
+  else
+  {
+    result = data->partialChildren;
+    pqUnlink(tree, result);
+    pqReplace(tree, node, result);
+  }
+
+  data = &tree->nodes[node];
+  size_t emptyGroup = node;
+  if (data->numChildren <= 1)
+  {
+    emptyGroup = data->first;
+    if (emptyGroup != NONE)
+      pqUnlink(tree, emptyGroup);
+    pqFreeNode(tree, node);
+  }
+  if (emptyGroup != NONE)
+    pqInsertBefore(tree, result, emptyGroup, tree->nodes[result].first);
+  if (fullGroup != NONE)
+    pqInsertBefore(tree, result, fullGroup, NONE);
+
+  tree->nodes[result].label = C1P_PARTIAL;
+  tree->nodes[result].numLeaves = numLeaves;
+  *presult = result;
+
+  return true;
+}
+
+/**
+ * \brief Applies the template for the Q-node \p node all of whose pertinent children are processed.
+ *
+ * \returns \c false if the row cannot be made consecutive.
+ */
+
+static
+bool pqReduceQNode(
+  PQTree* tree, /**< PQ-tree. */
+  size_t node,  /**< Q-node. */
+  bool isRoot,  /**< Whether \p node is the root of the pertinent subtree. */
+  size_t stamp  /**< Current row. */
+)
+{
+  C1PNode* data = &tree->nodes[node];
+  size_t numFull = data->numFullChildren;
+  size_t numPartial = data->numPartialChildren;
+
+  if (numPartial == 0 && numFull == data->numChildren)
+  {
+    data->label = C1P_FULL;
+    return true;
+  }
+  if (numPartial > (isRoot ? 2 : 1))
+    return false;
+
+  /* The pertinent children must be consecutive. */
+  size_t start = (numFull > 0) ? data->fullChildren : data->partialChildren;
+  size_t left = start;
+  size_t right = start;
+  size_t numPertinent = 1;
+  while (pqIsPertinent(tree, tree->nodes[left].prev, stamp))
+  {
+    left = tree->nodes[left].prev;
+    ++numPertinent;
+  }
+  while (pqIsPertinent(tree, tree->nodes[right].next, stamp))
+  {
+    right = tree->nodes[right].next;
+    ++numPertinent;
+  }
+  if (numPertinent != numFull + numPartial)
+    return false;
+
+  /* Partial children may only appear at the ends of the pertinent children. */
+  size_t partials[2] = { NONE, NONE };
+  size_t partial = data->partialChildren;
+  for (size_t p = 0; p < numPartial; ++p, partial = tree->nodes[partial].nextListed)
+  {
+    if (partial != left && partial != right)
+      return false;
+    partials[p] = partial;
+  }
+
+  if (isRoot)
+  {
+    /* Template Q3: the full children of the partial ones are turned towards the full ones. */
+    for (size_t p = 0; p < numPartial; ++p)
+      pqMerge(tree, node, partials[p], partials[p] == left);
+    return true;
+  }
+
+  /* Template Q2: the full children must be at one end and the node is turned such that this is its last end. */
+  partial = partials[0];
+  bool forward = (right == data->last) && (partial == NONE || partial == left);
+  if (!forward)
+  {
+    if (left != data->first || (partial != NONE && partial != right))
+      return false;
+    pqReverse(tree, node);
+  }
+  if (partial != NONE)
+    pqMerge(tree, node, partial, true);
+  tree->nodes[node].label = C1P_PARTIAL;
+
+  return true;
+}
+
+/**
+ * \brief Reduces the PQ-tree with the columns \p columns of a row.
+ *
+ * \returns \c false if no order of the tree makes the columns consecutive.
+ */
+
+static
+bool pqReduce(
+  PQTree* tree,       /**< PQ-tree. */
+  size_t numColumns,  /**< Number of columns of the row. */
+  size_t* columns,    /**< Columns of the row, i.e., the leaves. */
+  size_t stamp        /**< Current row. */
+)
+{
+  /* Mark the nodes on the paths from the leaves to the root. */
+  for (size_t i = 0; i < numColumns; ++i)
+  {
+    size_t node = columns[i];
+    C1PNode* data = &tree->nodes[node];
+    data->stamp = stamp;
+    data->numLeaves = 1;
+    data->label = C1P_FULL;
+    while (data->parent != NONE)
+    {
+      C1PNode* parentData = &tree->nodes[data->parent];
+      if (parentData->stamp == stamp)
+      {
+        parentData->numMarkedChildren++;
+        break;
+      }
+      parentData->stamp = stamp;
+      parentData->numMarkedChildren = 1;
+      parentData->numProcessedChildren = 0;
+      parentData->numLeaves = 0;
+      parentData->fullChildren = NONE;
+      parentData->numFullChildren = 0;
+      parentData->partialChildren = NONE;
+      parentData->numPartialChildren = 0;
+      data = parentData;
+    }
+  }
+
+  /* Process the nodes bottom-up, starting with the leaves. */
+  size_t queueBegin = 0;
+  size_t queueEnd = 0;
+  for (size_t i = 0; i < numColumns; ++i)
+    tree->queue[queueEnd++] = columns[i];
+  while (queueBegin < queueEnd)
+  {
+    size_t node = tree->queue[queueBegin++];
+    C1PNode* data = &tree->nodes[node];
+    bool isRoot = data->numLeaves == numColumns;
+
+    if (data->type == C1P_PNODE)
+    {
+      if (!pqReducePNode(tree, node, isRoot, stamp, &node))
+        return false;
+    }
+    else if (data->type == C1P_QNODE)
+    {
+      if (!pqReduceQNode(tree, node, isRoot, stamp))
+        return false;
+    }
+
+    if (isRoot)
+      return true;
+
+    data = &tree->nodes[node];
+    assert(data->parent != NONE);
+    C1PNode* parentData = &tree->nodes[data->parent];
+    if (data->label == C1P_FULL)
+    {
+      data->nextListed = parentData->fullChildren;
+      parentData->fullChildren = node;
+      parentData->numFullChildren++;
+    }
+    else
+    {
+      data->nextListed = parentData->partialChildren;
+      parentData->partialChildren = node;
+      parentData->numPartialChildren++;
+    }
+    parentData->numLeaves += data->numLeaves;
+    if (++parentData->numProcessedChildren == parentData->numMarkedChildren)
+      tree->queue[queueEnd++] = data->parent;
+  }
+
+  assert(false);
+  return false;
+}
+
+CMR_ERROR CMRconsecutiveOnesTestColumns(CMR* cmr, CMR_CHRMAT* matrix, bool* phasConsecutiveOnes,
+  size_t* columnsOrder)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(phasConsecutiveOnes);
+
+  CMRdbgMsg(0, "Testing a %zux%zu matrix for the consecutive ones property for columns.\n", matrix->numRows,
+    matrix->numColumns);
+
+  size_t numColumns = matrix->numColumns;
+  PQTree tree;
+  tree.memNodes = 2 * numColumns + 4;
+  tree.nodes = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.nodes, tree.memNodes) );
+  tree.queue = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.queue, tree.memNodes) );
+  size_t* columns = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columns, numColumns) );
+
+  /* The leaves are the first nodes and all other nodes are unused. */
+  for (size_t node = 0; node < tree.memNodes; ++node)
+    tree.nodes[node].next = (node + 1 < tree.memNodes) ? (node + 1) : NONE;
+  tree.firstFree = 0;
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    size_t leaf = pqNewNode(&tree, C1P_LEAF, SIZE_MAX);
+    CMR_UNUSED(leaf);
+    assert(leaf == column);
+  }
+  if (numColumns >= 2)
+  {
+    tree.root = pqNewNode(&tree, C1P_PNODE, SIZE_MAX);
+    for (size_t column = 0; column < numColumns; ++column)
+      pqInsertBefore(&tree, tree.root, column, NONE);
+  }
+  else
+    tree.root = numColumns ? 0 : NONE;
+
+  bool hasConsecutiveOnes = true;
+  for (size_t row = 0; row < matrix->numRows && hasConsecutiveOnes; ++row)
+  {
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    size_t numRowColumns = 0;
+    for (size_t e = first; e < beyond; ++e)
+    {
+      if (matrix->entryValues[e])
+        columns[numRowColumns++] = matrix->entryColumns[e];
+    }
+
+    /* Rows with at most one or with all columns are always consecutive. */
+    if (numRowColumns <= 1 || numRowColumns == numColumns)
+      continue;
+
+    CMRdbgMsg(2, "Reducing row r%zu with %zu nonzeros.\n", row+1, numRowColumns);
+    hasConsecutiveOnes = pqReduce(&tree, numRowColumns, columns, row);
+  }
+
+  CMRdbgMsg(2, "The matrix %s the consecutive ones property for columns.\n", hasConsecutiveOnes ? "has" : "lacks");
+  *phasConsecutiveOnes = hasConsecutiveOnes;
+
+  /* The leaves of a depth-first search yield the order. */
+  if (hasConsecutiveOnes && columnsOrder && numColumns > 0)
+  {
+    size_t numOrdered = 0;
+    size_t node = tree.root;
+    while (node != NONE)
+    {
+      C1PNode* data = &tree.nodes[node];
+      if (data->type == C1P_LEAF)
+      {
+        columnsOrder[numOrdered++] = node;
+
+        /* Go up until we find a next sibling. */
+        while (node != NONE && tree.nodes[node].next == NONE)
+          node = tree.nodes[node].parent;
+        if (node != NONE)
+          node = tree.nodes[node].next;
+      }
+      else
+        node = data->first;
+    }
+    assert(numOrdered == numColumns);
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &columns) );
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.queue) );
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.nodes) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRconsecutiveOnesTestRows(CMR* cmr, CMR_CHRMAT* matrix, bool* phasConsecutiveOnes, size_t* rowsOrder)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(phasConsecutiveOnes);
+
+  CMR_CHRMAT* transpose = NULL;
+  CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+  CMR_CALL( CMRconsecutiveOnesTestColumns(cmr, transpose, phasConsecutiveOnes, rowsOrder) );
+  CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+
+  return CMR_OKAY;
+}
@@ -0,0 +1,204 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include "counters.h"
+#include "env_internal.h"
+#include "threads.h"
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/perf_event.h>)
+#define CMR_WITH_PERF_EVENTS
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif /* __has_include(<linux/perf_event.h>) */
+#endif /* __linux__ && __has_include */
+
+void CMRcountersInit(CMR_COUNTERS* counters)
+{
+  assert(counters);
+
+  counters->cycles = 0;
+  counters->instructions = 0;
+  counters->cacheMisses = 0;
+  counters->branchMisses = 0;
+}
+
+void CMRcountersAdd(CMR_COUNTERS* target, CMR_COUNTERS* source)
+{
+  assert(target);
+  assert(source);
+
+  target->cycles += source->cycles;
+  target->instructions += source->instructions;
+  target->cacheMisses += source->cacheMisses;
+  target->branchMisses += source->branchMisses;
+}
+
+void CMRcountersPrint(FILE* stream, CMR_COUNTERS* counters, const char* prefix, const char* name)
+{
+  assert(stream);
+  assert(counters);
+  assert(prefix);
+  assert(name);
+
+  if (!counters->cycles && !counters->instructions && !counters->cacheMisses && !counters->branchMisses)
+    return;
+
+  double instructionsPerCycle = counters->cycles ? counters->instructions * 1.0 / counters->cycles : 0.0;
+  fprintf(stream, "%s%s counters: %llu cycles, %llu instructions (%.2f per cycle), %llu LLC misses, %llu branch "
+    "misses\n", prefix, name, (unsigned long long) counters->cycles, (unsigned long long) counters->instructions,
+    instructionsPerCycle, (unsigned long long) counters->cacheMisses, (unsigned long long) counters->branchMisses);
+}
+
+CMR_ERROR CMRsetHardwareCounters(CMR* cmr, bool enable)
+{
+  assert(cmr);
+
+#if !defined(CMR_WITH_PERF_EVENTS)
+  if (enable)
+    return CMR_ERROR_INPUT;
+#endif /* !CMR_WITH_PERF_EVENTS */
+
+  cmr->hardwareCounters = enable;
+
+  return CMR_OKAY;
+}
+
+bool CMRgetHardwareCounters(CMR* cmr)
+{
+  assert(cmr);
+
+  return cmr->hardwareCounters;
+}
+
+#if defined(CMR_WITH_PERF_EVENTS)
+
+static CMR_THREAD_LOCAL int counterFds[CMR_NUM_COUNTERS] = { -1, -1, -1, -1 }; /**< Perf events of this thread. */
+static CMR_THREAD_LOCAL bool countersFailed = false; /**< Whether opening the perf events of this thread failed. */
+
+/**
+ * \brief Opens the group of perf events of the calling thread unless this was done or failed before.
+ *
+ * Returns \c true if the group is open.
+ */
+
+static
+bool openCounters(void)
+{
+  if (counterFds[0] >= 0)
+    return true;
+  if (countersFailed)
+    return false;
+
+  /* Order as in CMR_COUNTERS. */
+  static const uint64_t configs[CMR_NUM_COUNTERS] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+  for (int c = 0; c < CMR_NUM_COUNTERS; ++c)
+  {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = configs[c];
+    attributes.read_format = PERF_FORMAT_GROUP;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    long fd = syscall(SYS_perf_event_open, &attributes, 0, -1, c == 0 ? -1 : counterFds[0], 0);
+    if (fd < 0)
+    {
+      CMRdbgMsg(0, "Opening perf event %d failed.\n", c);
+      CMRcountersCloseThread();
+      countersFailed = true;
+      return false;
+    }
+    counterFds[c] = (int) fd;
+  }
+
+  return true;
+}
+
+/**
+ * \brief Reads the group of perf events of the calling thread into \p values.
+ *
+ * Returns \c true on success.
+ */
+
+static
+bool readCounters(
+  uint64_t* values  /**< Array of length \ref CMR_NUM_COUNTERS for storing the values. */
+)
+{
+  if (!openCounters())
+    return false;
+
+  uint64_t data[1 + CMR_NUM_COUNTERS];
+  if (read(counterFds[0], data, sizeof(data)) != (ssize_t) sizeof(data) || data[0] != CMR_NUM_COUNTERS)
+    return false;
+
+  for (int c = 0; c < CMR_NUM_COUNTERS; ++c)
+    values[c] = data[1 + c];
+
+  return true;
+}
+
+void CMRcountersStart(CMR* cmr, CMR_COUNTERS_SAMPLE* sample)
+{
+  assert(cmr);
+  assert(sample);
+
+  sample->valid = cmr->hardwareCounters && readCounters(sample->values);
+}
+
+void CMRcountersStop(CMR_COUNTERS_SAMPLE* sample, CMR_COUNTERS* counters)
+{
+  assert(sample);
+  assert(counters);
+
+  uint64_t values[CMR_NUM_COUNTERS];
+  if (!sample->valid || !readCounters(values))
+    return;
+
+  counters->cycles += values[0] - sample->values[0];
+  counters->instructions += values[1] - sample->values[1];
+  counters->cacheMisses += values[2] - sample->values[2];
+  counters->branchMisses += values[3] - sample->values[3];
+}
+
+void CMRcountersCloseThread(void)
+{
+  for (int c = CMR_NUM_COUNTERS - 1; c >= 0; --c)
+  {
+    if (counterFds[c] >= 0)
+      close(counterFds[c]);
+    counterFds[c] = -1;
+  }
+  countersFailed = false;
+}
+
+#else
+
+void CMRcountersStart(CMR* cmr, CMR_COUNTERS_SAMPLE* sample)
+{
+  assert(cmr);
+  assert(sample);
+
+  CMR_UNUSED(cmr);
+  sample->valid = false;
+}
+
+void CMRcountersStop(CMR_COUNTERS_SAMPLE* sample, CMR_COUNTERS* counters)
+{
+  CMR_UNUSED(sample);
+  CMR_UNUSED(counters);
+}
+
+void CMRcountersCloseThread(void)
+{
+}
+
+#endif /* CMR_WITH_PERF_EVENTS */
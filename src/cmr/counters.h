@@ -0,0 +1,94 @@
+#ifndef CMR_COUNTERS_INTERNAL_H
+#define CMR_COUNTERS_INTERNAL_H
+
+/**
+ * \file counters.h
+ *
+ * \brief Hardware performance counters for the phases of algorithms.
+ *
+ * If enabled via \ref CMRsetHardwareCounters, every thread that measures a phase opens one group of Linux perf events
+ * on its first use. The events count permanently, and a phase is measured by reading the group at its start via
+ * \ref CMRcountersStart and at its end via \ref CMRcountersStop, which costs two system calls.
+ */
+
+#include <cmr/env.h>
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMR_NUM_COUNTERS 4 /**< Number of counters in \ref CMR_COUNTERS. */
+
+/**
+ * \brief Values of the counters at the start of a phase.
+ */
+
+typedef struct
+{
+  bool valid;                         /**< \brief Whether the counters could be read. */
+  uint64_t values[CMR_NUM_COUNTERS];  /**< \brief Values of the counters. */
+} CMR_COUNTERS_SAMPLE;
+
+/**
+ * \brief Initializes \p counters with zeros.
+ */
+
+void CMRcountersInit(
+  CMR_COUNTERS* counters  /**< Counters. */
+);
+
+/**
+ * \brief Adds \p source to \p target.
+ */
+
+void CMRcountersAdd(
+  CMR_COUNTERS* target, /**< Counters to add to. */
+  CMR_COUNTERS* source  /**< Counters to add. */
+);
+
+/**
+ * \brief Prints \p counters of the phase \p name as a single line that starts with \p prefix, unless they are all 0.
+ */
+
+void CMRcountersPrint(
+  FILE* stream,           /**< File stream to print to. */
+  CMR_COUNTERS* counters, /**< Counters. */
+  const char* prefix,     /**< Prefix string to prepend to the line. */
+  const char* name        /**< Name of the phase. */
+);
+
+/**
+ * \brief Reads the counters of the calling thread at the start of a phase if they are enabled for \p cmr.
+ */
+
+void CMRcountersStart(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_COUNTERS_SAMPLE* sample /**< Pointer for storing the counter values. */
+);
+
+/**
+ * \brief Reads the counters of the calling thread at the end of a phase and adds the differences to \p counters.
+ *
+ * Does nothing if \p sample is not valid.
+ */
+
+void CMRcountersStop(
+  CMR_COUNTERS_SAMPLE* sample,  /**< Counter values from \ref CMRcountersStart. */
+  CMR_COUNTERS* counters        /**< Counters to add the differences to. */
+);
+
+/**
+ * \brief Closes the perf events of the calling thread, if any.
+ *
+ * Must be called by every thread that used \ref CMRcountersStart before it terminates.
+ */
+
+void CMRcountersCloseThread(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_COUNTERS_INTERNAL_H */
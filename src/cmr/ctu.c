@@ -5,10 +5,12 @@
 #include <cmr/tu.h>
 
 #include "env_internal.h"
+#include "regularity_internal.h"
+#include "threads.h"
+#include "deadline.h"
 
 #include <assert.h>
 #include <stdint.h>
-#include <time.h>
 #include <float.h>
 
 CMR_ERROR CMRctuParamsInit(CMR_CTU_PARAMS* params)
@@ -52,6 +54,18 @@ CMR_ERROR CMRstatsComplementTotalUnimodularityPrint(FILE* stream, CMR_CTU_STATIS
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRstatsComplementTotalUnimodularityPrintJson(FILE* stream, CMR_CTU_STATISTICS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"tu\":");
+  CMR_CALL( CMRtuStatsPrintJson(stream, &stats->tu) );
+  fprintf(stream, ",\"total\":{\"count\":%lu,\"time\":%.9g}}", (unsigned long)stats->totalCount, stats->totalTime);
+
+  return CMR_OKAY;
+}
+
 
 CMR_ERROR CMRcomplementRowColumn(CMR* cmr, CMR_CHRMAT* matrix, size_t complementRow, size_t complementColumn,
   CMR_CHRMAT** presult)
@@ -145,7 +159,7 @@ CMR_ERROR CMRcomplementRowColumn(CMR* cmr, CMR_CHRMAT* matrix, size_t complement
         }
         else
         {
-          if (complementRowColumn1 + complementColumnEntries[row] + complementRowEntries[column] % 2 == 1)
+          if ((complementRowColumn1 + complementColumnEntries[row] + complementRowEntries[column]) % 2 == 1)
             isNonzero = !isNonzero;
         }
       }
@@ -176,6 +190,223 @@ CMR_ERROR CMRcomplementRowColumn(CMR* cmr, CMR_CHRMAT* matrix, size_t complement
   return CMR_OKAY;
 }
 
+/**
+ * \brief Number of bits of a word of a bit-packed row.
+ */
+
+#define BITS_PER_WORD 64
+
+/**
+ * \brief Data shared by all workers of the complement enumeration.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* matrix;           /**< \brief Input matrix. */
+  size_t numWords;              /**< \brief Number of words per bit-packed row. */
+  uint64_t* rowBits;            /**< \brief Bit-packed rows of the input matrix. */
+  CMR_CTU_PARAMS* params;       /**< \brief Parameters for the computation. */
+  CMR_TU_STATS* workerStats;    /**< \brief Array with TU statistics for each worker, or \c NULL. */
+  CMR_DEADLINE deadline;        /**< \brief Deadline of the computation. */
+  size_t numPairs;              /**< \brief Number of (row, column) pairs to be considered. */
+  size_t nextPair;              /**< \brief Index of the next pair to be considered, accessed atomically. */
+  size_t witnessPair;           /**< \brief Smallest index of a pair yielding a non-TU matrix, or \c SIZE_MAX. */
+  bool cancel;                  /**< \brief Whether all workers shall stop, accessed atomically. */
+  CMR_MUTEX mutex;              /**< \brief Mutex for \ref witnessPair. */
+} CtuEnumeration;
+
+/**
+ * \brief Returns the bit of \p column in the bit-packed \p row.
+ */
+
+static inline
+bool getRowBit(
+  uint64_t* row,  /**< Bit-packed row. */
+  size_t column   /**< Column. */
+)
+{
+  return (row[column / BITS_PER_WORD] >> (column % BITS_PER_WORD)) & 1;
+}
+
+/**
+ * \brief Builds the matrix obtained from complementing \p complementRow and \p complementColumn.
+ *
+ * For a row \f$ i \f$ other than the complemented one, the entries outside the complemented column are toggled where
+ * the complemented row has a 1 if \f$ M_{i,c} + M_{r,c} \f$ is even, and where it has a 0 otherwise. Hence, every row
+ * is computed word by word from the bit-packed rows. Rows that do not change at all are copied from the input matrix.
+ */
+
+static
+void ctuComplement(
+  CtuEnumeration* enumeration,    /**< Complement enumeration. */
+  size_t complementRow,           /**< Row to be complemented, or \c numRows for none. */
+  size_t complementColumn,        /**< Column to be complemented, or \c numColumns for none. */
+  uint64_t* pattern,              /**< Workspace for a bit-packed row. */
+  CMR_CHRMAT* complementedMatrix  /**< Complemented matrix. */
+)
+{
+  assert(enumeration);
+  assert(pattern);
+  assert(complementedMatrix);
+
+  CMR_CHRMAT* matrix = enumeration->matrix;
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+  size_t numWords = enumeration->numWords;
+  bool hasComplementRow = complementRow < numRows;
+  bool hasComplementColumn = complementColumn < numColumns;
+  uint64_t lastMask = ~((uint64_t) 0);
+  if (numColumns % BITS_PER_WORD)
+    lastMask = (((uint64_t) 1) << (numColumns % BITS_PER_WORD)) - 1;
+
+  /* The pattern is the complemented row, or 0 if no row is complemented. */
+  bool isZeroPattern = true;
+  for (size_t w = 0; w < numWords; ++w)
+  {
+    pattern[w] = hasComplementRow ? enumeration->rowBits[numWords * complementRow + w] : 0;
+    if (pattern[w])
+      isZeroPattern = false;
+  }
+
+  /* Indicator for entry in complementRow, complementColumn. */
+  bool complementRowColumn1 = hasComplementRow && hasComplementColumn && getRowBit(pattern, complementColumn);
+
+  size_t numNonzeros = 0;
+  complementedMatrix->rowSlice[0] = 0;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    uint64_t* rowBits = &enumeration->rowBits[numWords * row];
+    bool rowColumn1 = hasComplementColumn && getRowBit(rowBits, complementColumn);
+    bool invertPattern = row != complementRow && complementRowColumn1 != rowColumn1;
+
+    if (isZeroPattern && !invertPattern && row != complementRow)
+    {
+      /* The row is not affected. Note that complementRowColumn1 is false. */
+      size_t first = matrix->rowSlice[row];
+      size_t beyond = matrix->rowSlice[row + 1];
+      for (size_t entry = first; entry < beyond; ++entry)
+        complementedMatrix->entryColumns[numNonzeros++] = matrix->entryColumns[entry];
+      complementedMatrix->rowSlice[row + 1] = numNonzeros;
+      continue;
+    }
+
+    for (size_t w = 0; w < numWords; ++w)
+    {
+      uint64_t word;
+      if (row == complementRow)
+        word = complementRowColumn1 ? ~rowBits[w] : rowBits[w];
+      else
+        word = rowBits[w] ^ (invertPattern ? ~pattern[w] : pattern[w]);
+      if (w + 1 == numWords)
+        word &= lastMask;
+
+      /* The entry in the complemented column is toggled iff complementRowColumn1 holds, except for complementRow. */
+      if (hasComplementColumn && complementColumn / BITS_PER_WORD == w)
+      {
+        uint64_t bit = ((uint64_t) 1) << (complementColumn % BITS_PER_WORD);
+        bool isNonzero = rowColumn1;
+        if (row != complementRow && complementRowColumn1)
+          isNonzero = !isNonzero;
+        word = isNonzero ? (word | bit) : (word & ~bit);
+      }
+
+      for (size_t column = w * BITS_PER_WORD; word; word >>= 1, ++column)
+      {
+        if (word & 1)
+          complementedMatrix->entryColumns[numNonzeros++] = column;
+      }
+    }
+    complementedMatrix->rowSlice[row + 1] = numNonzeros;
+  }
+  complementedMatrix->numNonzeros = numNonzeros;
+}
+
+/**
+ * \brief Worker of the complement enumeration.
+ *
+ * Pairs are fetched in increasing order of their index \f$ (n+1) \cdot \mathtt{row} + \mathtt{column} \f$. A worker
+ * only stops at a witness if no pair with a smaller index is pending, which makes the reported witness independent of
+ * the number of workers.
+ */
+
+static
+CMR_ERROR ctuWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref CtuEnumeration. */
+)
+{
+  assert(cmr);
+
+  CtuEnumeration* enumeration = (CtuEnumeration*) data;
+  size_t numRows = enumeration->matrix->numRows;
+  size_t numColumns = enumeration->matrix->numColumns;
+  CMR_ERROR error = CMR_OKAY;
+
+  /* Each worker has its own complemented matrix. */
+  CMR_CHRMAT* complementedMatrix = NULL;
+  CMR_CALL( CMRchrmatCreate(cmr, &complementedMatrix, numRows, numColumns, numRows * numColumns) );
+  for (size_t i = 0; i < numRows * numColumns; ++i)
+    complementedMatrix->entryValues[i] = 1;
+  uint64_t* pattern = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &pattern, enumeration->numWords) );
+
+  while (!CMRatomicLoadFlag(&enumeration->cancel))
+  {
+    size_t pair = CMRatomicFetchAdd(&enumeration->nextPair, 1);
+    if (pair >= enumeration->numPairs)
+      break;
+
+    CMRmutexLock(&enumeration->mutex);
+    bool pending = pair < enumeration->witnessPair;
+    CMRmutexUnlock(&enumeration->mutex);
+    if (!pending)
+      break;
+
+    size_t complementRow = pair / (numColumns + 1);
+    size_t complementColumn = pair % (numColumns + 1);
+    ctuComplement(enumeration, complementRow, complementColumn, pattern, complementedMatrix);
+
+    double remainingTime = CMRdeadlineRemaining(&enumeration->deadline);
+    if (remainingTime <= 0)
+    {
+      error = CMR_ERROR_TIMEOUT;
+      break;
+    }
+
+#if defined(CMR_DEBUG)
+    CMRdbgMsg(2, "Matrix after complementing r%zu and c%zu:\n", complementRow, complementColumn);
+    CMR_CALL( CMRchrmatPrintDense(cmr, complementedMatrix, stdout, '0', true) );
+#endif /* CMR_DEBUG */
+
+    bool isTU = false;
+    error = CMRtuTest(cmr, complementedMatrix, &isTU, NULL, NULL, &enumeration->params->tu,
+      enumeration->workerStats ? &enumeration->workerStats[worker] : NULL, remainingTime);
+    if (error)
+      break;
+
+    CMRdbgMsg(2, "-> %sTU.\n", isTU ? "IS " : "is NOT ");
+
+    if (!isTU)
+    {
+      CMRmutexLock(&enumeration->mutex);
+      if (pair < enumeration->witnessPair)
+        enumeration->witnessPair = pair;
+      CMRmutexUnlock(&enumeration->mutex);
+      break;
+    }
+  }
+
+  /* A failing worker stops all others. */
+  if (error)
+    CMRatomicStoreFlag(&enumeration->cancel, true);
+
+  CMR_CALL( CMRfreeStackArray(cmr, &pattern) );
+  CMR_CALL( CMRchrmatFree(cmr, &complementedMatrix) );
+
+  return error;
+}
+
 CMR_ERROR CMRctuTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisComplementTotallyUnimodular,
   size_t* pcomplementRow, size_t* pcomplementColumn, CMR_CTU_PARAMS* params, CMR_CTU_STATISTICS* stats,
   double timeLimit)
@@ -191,121 +422,84 @@ CMR_ERROR CMRctuTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisComplementTotallyUni
     params = &defaultParams;
   }
 
-  CMR_ERROR error = CMR_OKAY;
-  clock_t totalClock = clock();
+  double totalClock = CMRclockNow();
   
-  /* Create a dense version on the stack. */
+  /* Create bit-packed rows on the stack. */
 
   size_t numRows = matrix->numRows;
   size_t numColumns = matrix->numColumns;
-  char* dense = NULL;
-  size_t sizeDense = numRows * numColumns;
-  CMR_CALL( CMRallocStackArray(cmr, &dense, sizeDense) );
-  for (size_t i = 0; i < sizeDense; ++i)
-    dense[i] = 0;
+  size_t numWords = (numColumns + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  if (numWords == 0)
+    numWords = 1;
+  uint64_t* rowBits = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowBits, numRows * numWords) );
+  for (size_t i = 0; i < numRows * numWords; ++i)
+    rowBits[i] = 0;
   for (size_t row = 0; row < numRows; ++row)
   {
     size_t first = matrix->rowSlice[row];
     size_t beyond = matrix->rowSlice[row + 1];
     for (size_t entry = first; entry < beyond; ++entry)
-      dense[numColumns * row + matrix->entryColumns[entry]] = matrix->entryValues[entry];
+    {
+      size_t column = matrix->entryColumns[entry];
+      rowBits[numWords * row + column / BITS_PER_WORD] |= ((uint64_t) 1) << (column % BITS_PER_WORD);
+    }
   }
 
-  /* Create complemented matrices and call test for total unimodularity. */
-  CMR_CHRMAT* complementedMatrix = NULL;
-  CMR_CALL( CMRchrmatCreate(cmr, &complementedMatrix, numRows, numColumns, sizeDense) );
-  for (size_t i = 0; i < sizeDense; ++i)
-    complementedMatrix->entryValues[i] = 1;
-  *pisComplementTotallyUnimodular = true;
-  for (size_t complementRow = 0; complementRow <= numRows && *pisComplementTotallyUnimodular; ++complementRow)
+  /* Create complemented matrices and call test for total unimodularity, distributing the (row, column) pairs among
+   * the workers. */
+
+  CtuEnumeration enumeration;
+  enumeration.matrix = matrix;
+  enumeration.numWords = numWords;
+  enumeration.rowBits = rowBits;
+  enumeration.params = params;
+  enumeration.deadline = CMRdeadlineCreate(cmr, timeLimit);
+  enumeration.numPairs = (numRows + 1) * (numColumns + 1);
+  enumeration.nextPair = 0;
+  enumeration.witnessPair = SIZE_MAX;
+  enumeration.cancel = false;
+  CMRmutexInit(&enumeration.mutex);
+
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, enumeration.numPairs);
+  enumeration.workerStats = NULL;
+  if (stats)
   {
-    bool hasComplementRow = complementRow < numRows;
-    for (size_t complementColumn = 0; complementColumn <= numColumns; ++complementColumn)
+    CMR_CALL( CMRallocBlockArray(cmr, &enumeration.workerStats, numWorkers) );
+    for (size_t w = 0; w < numWorkers; ++w)
     {
-      bool hasComplementColumn = complementColumn < numColumns;
-
-      /* Indicator for entry in complementRow, complementColumn. */
-      char complementRowColumn1 = hasComplementRow && hasComplementColumn ?
-        dense[numColumns * complementRow + complementColumn] : 0;
-
-      /* Fill complemented matrix as a sparse char matrix. */
-      complementedMatrix->numNonzeros = 0;
-      complementedMatrix->rowSlice[0] = 0;
-      for (size_t row = 0; row < numRows; ++row)
-      {
-        for (size_t column = 0; column < numColumns; ++column)
-        {
-          bool isNonzero = dense[numColumns * row + column];
-          if (row == complementRow)
-          {
-            if (column != complementColumn && complementRowColumn1)
-              isNonzero = !isNonzero;
-          }
-          else
-          {
-            if (column == complementColumn)
-            {
-              if (complementRowColumn1)
-                isNonzero = !isNonzero;
-            }
-            else
-            {
-              if ((complementRowColumn1 + (hasComplementColumn ? dense[numColumns * row + complementColumn] : 0)
-                + (hasComplementRow ? dense[numColumns * complementRow + column] : 0)) % 2 == 1)
-              {
-                isNonzero = !isNonzero;
-              }
-            }
-          }
-
-          if (isNonzero)
-          {
-            complementedMatrix->entryColumns[complementedMatrix->numNonzeros] = column;
-            complementedMatrix->numNonzeros++;
-          }
-        }
-        complementedMatrix->rowSlice[row + 1] = complementedMatrix->numNonzeros;
-      }
-
-      double remainingTime = timeLimit - (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
-      if (remainingTime <= 0)
-      {
-        error = CMR_ERROR_TIMEOUT;
-        goto cleanup;
-      }
-
-#if defined(CMR_DEBUG)
-      CMRdbgMsg(2, "Matrix after complementing r%zu and c%zu:\n", complementRow, complementColumn);
-      CMR_CALL( CMRchrmatPrintDense(cmr, complementedMatrix, stdout, '0', true) );
-#endif /* CMR_DEBUG */
-
-      bool isTU = false;
-      CMR_CALL( CMRtuTest(cmr, complementedMatrix, &isTU, NULL, NULL, &params->tu,
-        stats ? &stats->tu : NULL, remainingTime) );
+      CMR_CALL( CMRtuStatsInit(&enumeration.workerStats[w]) );
+      enumeration.workerStats[w].decomposition.nodeLog = stats->tu.decomposition.nodeLog;
+    }
+  }
 
-      CMRdbgMsg(2, "-> %sTU.\n", isTU ? "IS " : "is NOT ");
+  CMR_ERROR error = CMRthreadsRun(cmr, numWorkers, ctuWorker, &enumeration);
 
-      if (!isTU)
-      {
-        if (pcomplementRow)
-          *pcomplementRow = complementRow;
-        if (pcomplementColumn)
-          *pcomplementColumn = complementColumn;
+  CMRmutexFree(&enumeration.mutex);
+  if (stats)
+  {
+    for (size_t w = 0; w < numWorkers; ++w)
+      CMR_CALL( CMRtuStatsAdd(&stats->tu, &enumeration.workerStats[w]) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &enumeration.workerStats) );
+  }
 
-        *pisComplementTotallyUnimodular = false;
-        break;
-      }
-    }
+  *pisComplementTotallyUnimodular = enumeration.witnessPair == SIZE_MAX;
+  if (!*pisComplementTotallyUnimodular)
+  {
+    size_t complementRow = enumeration.witnessPair / (numColumns + 1);
+    size_t complementColumn = enumeration.witnessPair % (numColumns + 1);
+    if (pcomplementRow)
+      *pcomplementRow = complementRow < numRows ? complementRow : SIZE_MAX;
+    if (pcomplementColumn)
+      *pcomplementColumn = complementColumn < numColumns ? complementColumn : SIZE_MAX;
   }
 
-cleanup:
-  CMR_CALL( CMRchrmatFree(cmr, &complementedMatrix) );
-  CMR_CALL( CMRfreeStackArray(cmr, &dense) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowBits) );
 
   if (stats)
   {
     stats->totalCount++;
-    stats->totalTime += (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
+    stats->totalTime += CMRclockNow() - totalClock;
   }
 
   return error;
@@ -0,0 +1,33 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 199309L
+#endif /* !_WIN32 */
+
+#include "deadline.h"
+#include "env_internal.h"
+
+#include <assert.h>
+#include <time.h>
+
+double CMRclockNow(void)
+{
+#if defined(_WIN32)
+  /* On Windows, clock() measures the wall-clock time since the start of the process. */
+  return clock() * 1.0 / CLOCKS_PER_SEC;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1.0e-9;
+#endif /* _WIN32 */
+}
+
+CMR_DEADLINE CMRdeadlineCreate(CMR* cmr, double timeLimit)
+{
+  assert(cmr);
+
+  CMR_DEADLINE deadline;
+  deadline.end = CMRclockNow() + timeLimit;
+  deadline.interrupted = &cmr->interrupted;
+  return deadline;
+}
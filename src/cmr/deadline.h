@@ -0,0 +1,126 @@
+#ifndef CMR_DEADLINE_INTERNAL_H
+#define CMR_DEADLINE_INTERNAL_H
+
+/**
+ * \file deadline.h
+ *
+ * \brief Monotonic wall-clock time and deadlines for time limits.
+ *
+ * A top-level function creates one \ref CMR_DEADLINE from its time limit and passes it down. A deadline also counts
+ * as passed as soon as \ref CMRinterrupt is called for the environment it was created with. A deadline is never
+ * modified after its initialization, so it can be shared by several workers. Checks in inner loops use
+ * \ref CMRdeadlineTick with a counter owned by the caller such that the clock is only read every
+ * \ref CMR_DEADLINE_TICKS calls.
+ */
+
+#include <cmr/env.h>
+
+#include "threads.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMR_DEADLINE_TICKS 1024 /**< Number of calls to \ref CMRdeadlineTick per reading of the clock. */
+
+/**
+ * \brief Returns the current time in seconds according to a monotonic wall clock.
+ *
+ * Only differences of two returned values are meaningful.
+ */
+
+double CMRclockNow(void);
+
+/**
+ * \brief Point in time at which a computation must stop.
+ */
+
+typedef struct
+{
+  double end;       /**< \brief Value of \ref CMRclockNow at which the time limit is exceeded. */
+  bool* interrupted; /**< \brief Interruption flag of the environment. */
+} CMR_DEADLINE;
+
+/**
+ * \brief Returns the deadline that lies \p timeLimit seconds in the future and that is interrupted together with
+ *        \p cmr.
+ */
+
+CMR_DEADLINE CMRdeadlineCreate(
+  CMR* cmr,         /**< \ref CMR environment. */
+  double timeLimit  /**< Time limit in seconds. */
+);
+
+/**
+ * \brief Returns \c true if and only if the environment of \p deadline was interrupted.
+ */
+
+static inline
+bool CMRdeadlineInterrupted(
+  const CMR_DEADLINE* deadline  /**< Deadline. */
+)
+{
+  return CMRatomicLoadFlag(deadline->interrupted);
+}
+
+/**
+ * \brief Returns the number of seconds until \p deadline, which is non-positive if it has passed or if the
+ *        environment was interrupted.
+ */
+
+static inline
+double CMRdeadlineRemaining(
+  const CMR_DEADLINE* deadline  /**< Deadline. */
+)
+{
+  return CMRdeadlineInterrupted(deadline) ? 0.0 : deadline->end - CMRclockNow();
+}
+
+/**
+ * \brief Returns \c true if and only if \p deadline has passed at time \p now, which was obtained by
+ *        \ref CMRclockNow.
+ */
+
+static inline
+bool CMRdeadlinePassedAt(
+  const CMR_DEADLINE* deadline, /**< Deadline. */
+  double now                    /**< Current time. */
+)
+{
+  return now > deadline->end || CMRdeadlineInterrupted(deadline);
+}
+
+/**
+ * \brief Returns \c true if and only if \p deadline has passed.
+ */
+
+static inline
+bool CMRdeadlinePassed(
+  const CMR_DEADLINE* deadline  /**< Deadline. */
+)
+{
+  return CMRdeadlinePassedAt(deadline, CMRclockNow());
+}
+
+/**
+ * \brief Returns \c true if and only if \p deadline has passed, but only reads the clock every
+ *        \ref CMR_DEADLINE_TICKS calls; otherwise it returns \c false.
+ */
+
+static inline
+bool CMRdeadlineTick(
+  const CMR_DEADLINE* deadline, /**< Deadline. */
+  size_t* pticks                /**< Pointer to a counter owned by the caller; must be initialized with 0. */
+)
+{
+  if (++(*pticks) < CMR_DEADLINE_TICKS)
+    return false;
+  *pticks = 0;
+  return CMRdeadlinePassed(deadline);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_DEADLINE_INTERNAL_H */
@@ -6,6 +6,12 @@
 #include <assert.h>
 #include <stdint.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif /* __AVX2__ || __ARM_NEON */
+
 
 CMR_ERROR CMRdensebinmatrixCreate(CMR* cmr, size_t numRows, size_t numColumns, DenseBinaryMatrix** presult)
 {
@@ -13,16 +19,19 @@ CMR_ERROR CMRdensebinmatrixCreate(CMR* cmr, size_t numRows, size_t numColumns, D
 
   CMR_CALL( CMRallocBlock(cmr, presult) );
   DenseBinaryMatrix* matrix = *presult;
-  
-  size_t size = (numRows * numColumns + (8 * sizeof(size_t)) - 1) / (8 * sizeof(size_t));
-  CMRdbgMsg(10, "Creating %zux%zu DenseBinaryMatrix using %zu blocks each of which having %zu bytes.\n", numRows,
-    numColumns, size, sizeof(size_t));
+
+  size_t stride = (numColumns + 63) / 64;
+  stride = (stride + CMR_DENSEBINMATRIX_ROW_ALIGNMENT - 1) / CMR_DENSEBINMATRIX_ROW_ALIGNMENT
+    * CMR_DENSEBINMATRIX_ROW_ALIGNMENT;
+  size_t size = numRows * stride;
+  CMRdbgMsg(10, "Creating %zux%zu DenseBinaryMatrix using %zu words per row.\n", numRows, numColumns, stride);
   matrix->numRows = numRows;
   matrix->numColumns = numColumns;
+  matrix->stride = stride;
   matrix->data = NULL;
   CMR_CALL( CMRallocBlockArray(cmr, &matrix->data, size) );
   for (size_t i = 0; i < size; ++i)
-    matrix->data[i] = 0UL;
+    matrix->data[i] = 0;
 
   return CMR_OKAY;
 }
@@ -36,7 +45,35 @@ CMR_ERROR CMRdensebinmatrixFree(CMR* cmr, DenseBinaryMatrix** pmatrix)
     return CMR_OKAY;
 
   CMR_CALL( CMRfreeBlockArray(cmr, &(*pmatrix)->data) );
-  CMR_CALL( CMRfreeBlockArray(cmr, pmatrix) );
+  CMR_CALL( CMRfreeBlock(cmr, pmatrix) );
 
   return CMR_OKAY;
 }
+
+void CMRdensebinmatrixRowXor(DenseBinaryMatrix* matrix, size_t targetRow, size_t sourceRow)
+{
+  assert(matrix);
+  assert(targetRow != sourceRow);
+
+  uint64_t* target = CMRdensebinmatrixRow(matrix, targetRow);
+  const uint64_t* source = CMRdensebinmatrixRow(matrix, sourceRow);
+
+  /* The stride is a multiple of 4 words, i.e., of 256 bits. */
+  assert(matrix->stride % CMR_DENSEBINMATRIX_ROW_ALIGNMENT == 0);
+  for (size_t w = 0; w < matrix->stride; w += CMR_DENSEBINMATRIX_ROW_ALIGNMENT)
+  {
+#if defined(__AVX2__)
+    __m256i x = _mm256_loadu_si256((const __m256i*) &target[w]);
+    __m256i y = _mm256_loadu_si256((const __m256i*) &source[w]);
+    _mm256_storeu_si256((__m256i*) &target[w], _mm256_xor_si256(x, y));
+#elif defined(__ARM_NEON)
+    vst1q_u64(&target[w], veorq_u64(vld1q_u64(&target[w]), vld1q_u64(&source[w])));
+    vst1q_u64(&target[w + 2], veorq_u64(vld1q_u64(&target[w + 2]), vld1q_u64(&source[w + 2])));
+#else
+    target[w] ^= source[w];
+    target[w + 1] ^= source[w + 1];
+    target[w + 2] ^= source[w + 2];
+    target[w + 3] ^= source[w + 3];
+#endif /* __AVX2__ || __ARM_NEON */
+  }
+}
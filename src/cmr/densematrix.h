@@ -2,22 +2,36 @@
 #define CMR_DENSEMATRIX_INTERNAL_H
 
 #include "env_internal.h"
+#include "bitset.h"
 
 #include <cmr/matrix.h>
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * \brief Dense matrix.
+ * \brief Number of 64-bit words by which the row stride of a \ref DenseBinaryMatrix is rounded up.
+ *
+ * Each row therefore occupies a whole number of 256-bit vectors, such that row operations need no remainder loops.
+ */
+
+#define CMR_DENSEBINMATRIX_ROW_ALIGNMENT 4
+
+/**
+ * \brief Dense binary matrix.
+ *
+ * Each row starts at a word boundary and occupies \ref stride 64-bit words; the bits beyond the last column are 0.
  */
 
 typedef struct
 {
-  size_t* data;
-  size_t numRows;
-  size_t numColumns;
+  uint64_t* data;     /**< \brief Bits of the matrix; bit \c j of row \c i is in word \c i*stride + j/64. */
+  size_t numRows;     /**< \brief Number of rows. */
+  size_t numColumns;  /**< \brief Number of columns. */
+  size_t stride;      /**< \brief Number of words per row. */
 } DenseBinaryMatrix;
 
 CMR_ERROR CMRdensebinmatrixCreate(
@@ -32,6 +46,20 @@ CMR_ERROR CMRdensebinmatrixFree(
   DenseBinaryMatrix** pmatrix /**< Pointer for storing the result. */
 );
 
+/**
+ * \brief Returns the words of row \p row of \p matrix.
+ */
+
+static inline
+uint64_t* CMRdensebinmatrixRow(
+  DenseBinaryMatrix* matrix,  /**< Matrix. */
+  size_t row                  /**< Row index. */
+)
+{
+  assert(row < matrix->numRows);
+  return &matrix->data[row * matrix->stride];
+}
+
 static inline
 bool CMRdensebinmatrixGet(
   DenseBinaryMatrix* matrix,  /**< Matrix. */
@@ -39,12 +67,8 @@ bool CMRdensebinmatrixGet(
   size_t column               /**< Column index. */
 )
 {
-  size_t index = row * matrix->numColumns + column;
-  size_t block = matrix->data[index / (8 * sizeof(size_t))];
-//   CMRdbgMsg(8, "CMRdensebinmatrixGet(%zu,%zu) uses index %zu in block %zu at %zu -> %d\n", row, column, index,
-//     index / (8 * sizeof(size_t)), (index % (8 * sizeof(size_t))),
-//     (block & (1UL << (index % (8 * sizeof(size_t))))) ? 1 : 0);
-  return block & (1UL << (index % (8 * sizeof(size_t))));
+  assert(column < matrix->numColumns);
+  return (CMRdensebinmatrixRow(matrix, row)[column / 64] >> (column % 64)) & 1;
 }
 
 static inline
@@ -54,11 +78,8 @@ void CMRdensebinmatrixSet0(
   size_t column               /**< Column index. */
 )
 {
-  size_t index = row * matrix->numColumns + column;
-//   CMRdbgMsg(8, "CMRdensebinmatrixSet0(%zu,%zu) uses index %zu in block %zu at %zu.\n", row, column, index,
-//     index / (8 * sizeof(size_t)), (index % (8 * sizeof(size_t))));
-  size_t* pblock = &matrix->data[index / (8 * sizeof(size_t))];
-  *pblock &= ~(1UL << (index % (8 * sizeof(size_t))));
+  assert(column < matrix->numColumns);
+  CMRdensebinmatrixRow(matrix, row)[column / 64] &= ~(UINT64_C(1) << (column % 64));
 }
 
 static inline
@@ -68,11 +89,8 @@ void CMRdensebinmatrixSet1(
   size_t column               /**< Column index. */
 )
 {
-  size_t index = row * matrix->numColumns + column;
-//   CMRdbgMsg(8, "CMRdensebinmatrixSet1(%zu,%zu) uses index %zu in block %zu at %zu.\n", row, column, index,
-//     index / (8 * sizeof(size_t)), (index % (8 * sizeof(size_t))));
-  size_t* pblock = &matrix->data[index / (8 * sizeof(size_t))];
-  *pblock |= (1UL << (index % (8 * sizeof(size_t))));
+  assert(column < matrix->numColumns);
+  CMRdensebinmatrixRow(matrix, row)[column / 64] |= UINT64_C(1) << (column % 64);
 }
 
 static inline
@@ -83,18 +101,12 @@ void CMRdensebinmatrixSet(
   bool value                  /**< Value. */
 )
 {
-  size_t index = row * matrix->numColumns + column;
-  CMRdbgMsg(8, "CMRdensebinmatrixSet(%zu,%zu,%d) uses index %zu in block %zu at %zu.\n", row, column, value ? 1 : 0, index,
-    index / (8 * sizeof(size_t)), (index % (8 * sizeof(size_t))));
-  size_t* pblock = &matrix->data[index / (8 * sizeof(size_t))];
-  size_t mask = (1UL << (index % (8 * sizeof(size_t))));
   if (value)
-    *pblock |= mask;
+    CMRdensebinmatrixSet1(matrix, row, column);
   else
-    *pblock &= ~mask;
+    CMRdensebinmatrixSet0(matrix, row, column);
 }
 
-
 static inline
 void CMRdensebinmatrixFlip(
   DenseBinaryMatrix* matrix,  /**< Matrix. */
@@ -102,19 +114,87 @@ void CMRdensebinmatrixFlip(
   size_t column               /**< Column index. */
 )
 {
-  size_t index = row * matrix->numColumns + column;
-//   CMRdbgMsg(8, "CMRdensebinmatrixFlip(%zu,%zu) uses index %zu in block %zu at %zu.\n", row, column, index,
-//     index / (8 * sizeof(size_t)), (index % (8 * sizeof(size_t))));
-  size_t* pblock = &matrix->data[index / (8 * sizeof(size_t))];
-  size_t mask = (1UL << (index % (8 * sizeof(size_t))));
-  if (*pblock & mask)
-    *pblock &= ~mask;
-  else
-    *pblock |= mask;
+  assert(column < matrix->numColumns);
+  CMRdensebinmatrixRow(matrix, row)[column / 64] ^= UINT64_C(1) << (column % 64);
+}
+
+/**
+ * \brief Adds row \p sourceRow to row \p targetRow over GF(2).
+ *
+ * Uses AVX2 or NEON instructions if the library is compiled for a target that supports them.
+ */
+
+void CMRdensebinmatrixRowXor(
+  DenseBinaryMatrix* matrix,  /**< Matrix. */
+  size_t targetRow,           /**< Row that is modified. */
+  size_t sourceRow            /**< Row that is added; must differ from \p targetRow. */
+);
+
+/**
+ * \brief Returns the number of nonzeros of row \p row.
+ */
+
+static inline
+size_t CMRdensebinmatrixRowCount(
+  DenseBinaryMatrix* matrix,  /**< Matrix. */
+  size_t row                  /**< Row index. */
+)
+{
+  const uint64_t* words = CMRdensebinmatrixRow(matrix, row);
+  size_t count = 0;
+  for (size_t w = 0; w < matrix->stride; ++w)
+    count += CMRbitsetCount(words[w]);
+  return count;
+}
+
+/**
+ * \brief Returns the number of columns in which both rows \p row1 and \p row2 have a nonzero.
+ */
+
+static inline
+size_t CMRdensebinmatrixRowAndCount(
+  DenseBinaryMatrix* matrix,  /**< Matrix. */
+  size_t row1,                /**< First row index. */
+  size_t row2                 /**< Second row index. */
+)
+{
+  const uint64_t* words1 = CMRdensebinmatrixRow(matrix, row1);
+  const uint64_t* words2 = CMRdensebinmatrixRow(matrix, row2);
+  size_t count = 0;
+  for (size_t w = 0; w < matrix->stride; ++w)
+    count += CMRbitsetCount(words1[w] & words2[w]);
+  return count;
+}
+
+/**
+ * \brief Returns the first column at least \p column in which row \p row has a nonzero, or \c SIZE_MAX if
+ *        there is none.
+ */
+
+static inline
+size_t CMRdensebinmatrixRowFindNext(
+  DenseBinaryMatrix* matrix,  /**< Matrix. */
+  size_t row,                 /**< Row index. */
+  size_t column               /**< First column to consider. */
+)
+{
+  if (column >= matrix->numColumns)
+    return SIZE_MAX;
+
+  const uint64_t* words = CMRdensebinmatrixRow(matrix, row);
+  size_t w = column / 64;
+  uint64_t word = words[w] & (~UINT64_C(0) << (column % 64));
+  while (!word)
+  {
+    if (++w == matrix->stride)
+      return SIZE_MAX;
+    word = words[w];
+  }
+  return 64 * w + CMRbitsetLowest(word);
 }
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* CMR_LISTMATRIX_INTERNAL_H */
+#endif /* CMR_DENSEMATRIX_INTERNAL_H */
@@ -0,0 +1,110 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include "entry_index.h"
+
+#include <assert.h>
+
+#include "env_internal.h"
+
+/**
+ * \brief Matrices with at most this many bitmap words per nonzero use the bitmaps.
+ */
+
+#define BITMAP_WORDS_PER_NONZERO 4
+
+CMR_ERROR CMRentryIndexCreate(CMR* cmr, CMR_CHRMAT* matrix, CMR_ENTRY_INDEX* index)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(index);
+
+  index->matrix = matrix;
+  index->bitmaps = NULL;
+  index->counts = NULL;
+  index->keys = NULL;
+  index->entries = NULL;
+
+  size_t numWords = (matrix->numColumns + 63) / 64;
+  if (numWords == 0)
+    numWords = 1;
+  if (matrix->numRows * numWords <= BITMAP_WORDS_PER_NONZERO * (matrix->numNonzeros + 1)
+    && matrix->numNonzeros < UINT32_MAX)
+  {
+    CMRdbgMsg(0, "Creating bitmap index for %zux%zu matrix.\n", matrix->numRows, matrix->numColumns);
+
+    index->numWords = numWords;
+    CMR_CALL( CMRallocBlockArray(cmr, &index->bitmaps, matrix->numRows * numWords) );
+    CMR_CALL( CMRallocBlockArray(cmr, &index->counts, matrix->numRows * numWords) );
+    for (size_t row = 0; row < matrix->numRows; ++row)
+    {
+      uint64_t* bitmaps = &index->bitmaps[row * numWords];
+      uint32_t* counts = &index->counts[row * numWords];
+      for (size_t w = 0; w < numWords; ++w)
+        bitmaps[w] = 0;
+
+      size_t first = matrix->rowSlice[row];
+      size_t beyond = matrix->rowSlice[row + 1];
+      for (size_t entry = first; entry < beyond; ++entry)
+      {
+        size_t column = matrix->entryColumns[entry];
+        assert(entry == first || matrix->entryColumns[entry - 1] < column);
+        bitmaps[column / 64] |= 1ULL << (column % 64);
+      }
+
+      uint32_t count = 0;
+      for (size_t w = 0; w < numWords; ++w)
+      {
+        counts[w] = count;
+        count += (uint32_t) CMRbitsetCount(bitmaps[w]);
+      }
+    }
+
+    return CMR_OKAY;
+  }
+
+  CMRdbgMsg(0, "Creating hashtable index for %zux%zu matrix.\n", matrix->numRows, matrix->numColumns);
+
+  /* At most half of the slots are used. */
+  index->numWords = 0;
+  size_t numSlots = 2;
+  index->slotsShift = 63;
+  while (numSlots < 2 * matrix->numNonzeros)
+  {
+    numSlots *= 2;
+    index->slotsShift--;
+  }
+  index->slotsMask = numSlots - 1;
+  CMR_CALL( CMRallocBlockArray(cmr, &index->keys, numSlots) );
+  CMR_CALL( CMRallocBlockArray(cmr, &index->entries, numSlots) );
+  for (size_t slot = 0; slot < numSlots; ++slot)
+    index->keys[slot] = SIZE_MAX;
+
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t entry = matrix->rowSlice[row]; entry < beyond; ++entry)
+    {
+      size_t key = row * matrix->numColumns + matrix->entryColumns[entry];
+      size_t slot = CMRentryIndexHash(index, key);
+      while (index->keys[slot] != SIZE_MAX)
+        slot = (slot + 1) & index->slotsMask;
+      index->keys[slot] = key;
+      index->entries[slot] = entry;
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRentryIndexFree(CMR* cmr, CMR_ENTRY_INDEX* index)
+{
+  assert(cmr);
+  assert(index);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &index->entries) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &index->keys) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &index->counts) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &index->bitmaps) );
+
+  return CMR_OKAY;
+}
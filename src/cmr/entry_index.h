@@ -0,0 +1,112 @@
+#ifndef CMR_ENTRY_INDEX_INTERNAL_H
+#define CMR_ENTRY_INDEX_INTERNAL_H
+
+/**
+ * \file entry_index.h
+ *
+ * \brief Index for looking up the entries of a sparse char matrix by row and column in constant time.
+ */
+
+#include <cmr/matrix.h>
+
+#include "bitset.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Index of the nonzeros of a \ref CMR_CHRMAT whose rows are sorted by column.
+ *
+ * It replaces the binary searches of \ref CMRchrmatFindEntry for callers that look up many entries of the same matrix.
+ * For matrices that are not too sparse, each row has a bitmap of its columns together with the number of nonzeros
+ * before each of its words, and an entry is found by a population count. Otherwise, an open-addressing hashtable maps
+ * each pair of row and column to its entry. Modifying the nonzeros of the matrix invalidates the index, while values
+ * may be changed.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* matrix; /**< \brief Indexed matrix. */
+  size_t numWords;    /**< \brief Number of bitmap words per row, or 0 if the hashtable is used. */
+  uint64_t* bitmaps;  /**< \brief Array with the \ref numWords bitmap words of each row. */
+  uint32_t* counts;   /**< \brief Array with the number of nonzeros of a row before each of its bitmap words. */
+  size_t* keys;       /**< \brief Array with row times number of columns plus column of each slot, or \c SIZE_MAX. */
+  size_t* entries;    /**< \brief Array with the entry of each slot. */
+  size_t slotsMask;   /**< \brief Number of slots minus 1, which is a power of 2 minus 1. */
+  int slotsShift;     /**< \brief Number of bits by which a hash value is shifted to obtain a slot. */
+} CMR_ENTRY_INDEX;
+
+/**
+ * \brief Creates an index of the entries of \p matrix, whose rows must be sorted.
+ *
+ * Takes \f$ \mathcal{O}(m + k) \f$ time in the bitmap case and expected \f$ \mathcal{O}(m + k) \f$ time otherwise
+ * for an \f$ m \times n \f$ matrix with \f$ k \f$ nonzeros.
+ */
+
+CMR_ERROR CMRentryIndexCreate(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,     /**< Matrix. */
+  CMR_ENTRY_INDEX* index  /**< Index to initialize. */
+);
+
+/**
+ * \brief Frees the arrays of \p index.
+ */
+
+CMR_ERROR CMRentryIndexFree(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_ENTRY_INDEX* index  /**< Index. */
+);
+
+/**
+ * \brief Returns the hash value of a key of \ref CMR_ENTRY_INDEX::keys.
+ */
+
+static inline
+size_t CMRentryIndexHash(
+  const CMR_ENTRY_INDEX* index, /**< Index. */
+  size_t key                    /**< Key. */
+)
+{
+  return (size_t) (((uint64_t) key * 0x9E3779B97F4A7C15ULL) >> index->slotsShift);
+}
+
+/**
+ * \brief Returns the entry of \p index's matrix at \p row and \p column, or \c SIZE_MAX if it is zero.
+ */
+
+static inline
+size_t CMRentryIndexFind(
+  const CMR_ENTRY_INDEX* index, /**< Index. */
+  size_t row,                   /**< Row. */
+  size_t column                 /**< Column. */
+)
+{
+  if (index->numWords)
+  {
+    size_t word = row * index->numWords + column / 64;
+    uint64_t bit = 1ULL << (column % 64);
+    uint64_t bitmap = index->bitmaps[word];
+    if (!(bitmap & bit))
+      return SIZE_MAX;
+    return index->matrix->rowSlice[row] + index->counts[word] + CMRbitsetCount(bitmap & (bit - 1));
+  }
+
+  size_t key = row * index->matrix->numColumns + column;
+  for (size_t slot = CMRentryIndexHash(index, key); ; slot = (slot + 1) & index->slotsMask)
+  {
+    if (index->keys[slot] == key)
+      return index->entries[slot];
+    if (index->keys[slot] == SIZE_MAX)
+      return SIZE_MAX;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_ENTRY_INDEX_INTERNAL_H */
@@ -3,6 +3,7 @@
 // #define REPLACE_STACK_BY_MALLOC /* Uncomment to not use a stack at all, which may help to detect memory corruption. */
 
 #include "env_internal.h"
+#include "matrix_internal.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -10,49 +11,240 @@
 #include <stdarg.h>
 #include <string.h>
 
+#if defined(CMR_WITH_THREADS)
+#include <unistd.h>
+#endif /* CMR_WITH_THREADS */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CMR_WITH_MMAP
+#include <sys/mman.h>
+#endif /* __unix__ || __APPLE__ */
+
 static const size_t FIRST_STACK_SIZE = 4096L; /**< Size of the first stack. */
 static const int INITIAL_MEM_STACKS = 16;     /**< Initial number of allocated stacks. */
+static const size_t STACK_COMMIT_SIZE = 1L << 20; /**< Granularity in which mapped stacks count as used memory. */
 
 #if !defined(NDEBUG) && !defined(REPLACE_STACK_BY_MALLOC)
 static const int PROTECTION = INT_MIN / 42;   /**< Protection bytes to detect corruption. */
 #endif /* !NDEBUG */
 
+static
+void* defaultAllocate(size_t size, void* data)
+{
+  CMR_UNUSED(data);
+
+  return malloc(size);
+}
+
+static
+void* defaultReallocate(void* ptr, size_t size, void* data)
+{
+  CMR_UNUSED(data);
+
+  return realloc(ptr, size);
+}
+
+static
+void defaultRelease(void* ptr, void* data)
+{
+  CMR_UNUSED(data);
+
+  free(ptr);
+}
+
+static const CMR_ALLOCATOR defaultAllocator = { defaultAllocate, defaultReallocate, defaultRelease, NULL };
+
+/**
+ * \brief Allocates \p size bytes using the allocator of \p cmr.
+ */
+
+static inline
+void* envAllocate(
+  CMR* cmr,   /**< \ref CMR environment. */
+  size_t size /**< Number of bytes. */
+)
+{
+  return cmr->allocator.allocate(size, cmr->allocator.data);
+}
+
+/**
+ * \brief Resizes \p ptr to \p size bytes using the allocator of \p cmr.
+ */
+
+static inline
+void* envReallocate(
+  CMR* cmr,   /**< \ref CMR environment. */
+  void* ptr,  /**< Memory to resize. */
+  size_t size /**< Number of bytes. */
+)
+{
+  return cmr->allocator.reallocate(ptr, size, cmr->allocator.data);
+}
+
+/**
+ * \brief Frees \p ptr using the allocator of \p cmr.
+ */
+
+static inline
+void envRelease(
+  CMR* cmr, /**< \ref CMR environment. */
+  void* ptr /**< Memory to free. */
+)
+{
+  cmr->allocator.release(ptr, cmr->allocator.data);
+}
+
+/**
+ * \brief Allocates a stack chain with a single stack of size \ref FIRST_STACK_SIZE.
+ */
+
+static
+CMR_STACK_CHAIN* createStackChain(
+  CMR* cmr  /**< \ref CMR environment. */
+)
+{
+  CMR_STACK_CHAIN* chain = envAllocate(cmr, sizeof(CMR_STACK_CHAIN));
+  if (!chain)
+    return NULL;
+
+  chain->stacks = envAllocate(cmr, INITIAL_MEM_STACKS * sizeof(CMR_STACK));
+  if (!chain->stacks)
+  {
+    envRelease(cmr, chain);
+    return NULL;
+  }
+  chain->stacks[0].memory = envAllocate(cmr, FIRST_STACK_SIZE * sizeof(char));
+  if (!chain->stacks[0].memory)
+  {
+    envRelease(cmr, chain->stacks);
+    envRelease(cmr, chain);
+    return NULL;
+  }
+  chain->stacks[0].top = FIRST_STACK_SIZE;
+  chain->stacks[0].size = FIRST_STACK_SIZE;
+  chain->stacks[0].isMapped = false;
+  chain->stacks[0].committed = 0;
+  chain->memStacks = INITIAL_MEM_STACKS;
+  chain->numStacks = 1;
+  chain->currentStack = 0;
+  chain->usage = 0;
+  chain->peakUsage = 0;
+  chain->numAllocations = 0;
+  for (int pool = 0; pool < CMR_NUM_BLOCK_POOLS; ++pool)
+  {
+    chain->blockPools[pool] = NULL;
+    chain->blockPoolLengths[pool] = 0;
+  }
+#if defined(CMR_WITH_THREADS)
+  chain->hasOwner = false;
+  chain->processor = CMRthreadsProcessor();
+#endif /* CMR_WITH_THREADS */
+
+  return chain;
+}
+
+/**
+ * \brief Frees a stack chain.
+ */
+
+static
+void freeStackChain(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_STACK_CHAIN* chain  /**< Stack chain. */
+)
+{
+  for (int pool = 0; pool < CMR_NUM_BLOCK_POOLS; ++pool)
+  {
+    while (chain->blockPools[pool])
+    {
+      void* memory = chain->blockPools[pool];
+      chain->blockPools[pool] = *((void**) memory);
+      envRelease(cmr, memory);
+    }
+  }
+  for (size_t s = 0; s < chain->numStacks; ++s)
+  {
+#if defined(CMR_WITH_MMAP)
+    if (chain->stacks[s].isMapped)
+    {
+      munmap(chain->stacks[s].memory, chain->stacks[s].size);
+      continue;
+    }
+#endif /* CMR_WITH_MMAP */
+    envRelease(cmr, chain->stacks[s].memory);
+  }
+  envRelease(cmr, chain->stacks);
+  envRelease(cmr, chain);
+}
+
+static size_t nextEnvironmentId = 1; /**< Identifier for the next environment to be created. */
+
 CMR_ERROR CMRcreateEnvironment(CMR** pcmr)
+{
+  return CMRcreateEnvironmentAllocator(pcmr, NULL);
+}
+
+CMR_ERROR CMRcreateEnvironmentAllocator(CMR** pcmr, const CMR_ALLOCATOR* allocator)
 {
   if (!pcmr)
     return CMR_ERROR_INPUT;
+  if (!allocator)
+    allocator = &defaultAllocator;
+  if (!allocator->allocate || !allocator->reallocate || !allocator->release)
+    return CMR_ERROR_INPUT;
 
-  *pcmr = (CMR*) malloc(sizeof(CMR));
+  *pcmr = (CMR*) allocator->allocate(sizeof(CMR), allocator->data);
   CMR* cmr = *pcmr;
   if (!cmr)
     return CMR_ERROR_MEMORY;
 
+  cmr->allocator = *allocator;
   cmr->errorMessage = NULL;
   cmr->output = stdout;
   cmr->closeOutput = false;
   cmr->numThreads = 1;
+  cmr->pinThreads = false;
+  cmr->hardwareCounters = false;
+  cmr->memoryLimit = SIZE_MAX;
+  cmr->memoryUsage = 0;
+  cmr->memoryPeak = 0;
+  cmr->stackMemory = 0;
+  cmr->numBlockAllocations = 0;
+  cmr->stackReservation = 0;
   cmr->verbosity = 1;
+  cmr->id = CMRatomicFetchAdd(&nextEnvironmentId, 1);
 
-  /* Initialize stack memory. */
-  cmr->stacks = malloc(INITIAL_MEM_STACKS * sizeof(CMR_STACK));
-  if (!cmr->stacks)
+  /* Initialize stack memory of the creating thread. */
+  cmr->stackChains = envAllocate(cmr, sizeof(CMR_STACK_CHAIN*));
+  if (cmr->stackChains)
+    cmr->stackChains[0] = createStackChain(cmr);
+  if (!cmr->stackChains || !cmr->stackChains[0])
   {
-    free(*pcmr);
+    if (cmr->stackChains)
+      envRelease(cmr, cmr->stackChains);
+    allocator->release(cmr, allocator->data);
     *pcmr = NULL;
     return CMR_ERROR_MEMORY;
   }
-  cmr->stacks[0].memory = malloc(FIRST_STACK_SIZE * sizeof(char));
-  if (!cmr->stacks[0].memory)
-  {
-    free(cmr->stacks);
-    free(cmr);
-    *pcmr = NULL;
-    return CMR_ERROR_MEMORY;
-  }
-  cmr->stacks[0].top = FIRST_STACK_SIZE;
-  cmr->memStacks = INITIAL_MEM_STACKS;
-  cmr->numStacks = 1;
-  cmr->currentStack = 0;
+  cmr->numStackChains = 1;
+  cmr->memStackChains = 1;
+#if defined(CMR_WITH_THREADS)
+  cmr->stackChains[0]->hasOwner = true;
+  cmr->stackChains[0]->owner = pthread_self();
+#endif /* CMR_WITH_THREADS */
+  CMRmutexInit(&cmr->mutex);
+  cmr->mappings = NULL;
+  cmr->hasMappings = false;
+  cmr->transposes = NULL;
+  cmr->hasTransposes = false;
+  cmr->interrupted = false;
+  cmr->progressCallback = NULL;
+  cmr->progressData = NULL;
+  cmr->trace = NULL;
+  cmr->traceId = 0;
+  cmr->traceStart = 0.0;
+  cmr->traceNumEvents = 0;
+  cmr->traceNumThreads = 0;
 
   return CMR_OKAY;
 }
@@ -64,42 +256,386 @@ CMR_ERROR CMRfreeEnvironment(CMR** pcmr)
 
   CMR* cmr = *pcmr;
 
+  CMR_CALL( CMRtraceStop(cmr) );
+
   if (cmr->errorMessage)
-    free(cmr->errorMessage);
+    envRelease(cmr, cmr->errorMessage);
 
   if (cmr->closeOutput)
     fclose(cmr->output);
 
-  for (size_t s = 0; s < cmr->numStacks; ++s)
-    free(cmr->stacks[s].memory);
-  free(cmr->stacks);
-  free(*pcmr);
+  CMRmatrixReleaseAllTransposes(cmr);
+  CMRmatrixReleaseAllMappings(cmr);
+
+  for (size_t c = 0; c < cmr->numStackChains; ++c)
+    freeStackChain(cmr, cmr->stackChains[c]);
+  envRelease(cmr, cmr->stackChains);
+  CMRmutexFree(&cmr->mutex);
+  CMR_ALLOCATOR allocator = cmr->allocator;
+  allocator.release(cmr, allocator.data);
   *pcmr = NULL;
 
   return CMR_OKAY;
 }
 
-CMR_ERROR _CMRallocBlock(CMR* cmr, void** ptr, size_t size)
+CMR_ERROR CMRsetNumThreads(CMR* cmr, int numThreads)
 {
-  CMR_UNUSED(cmr);
+  assert(cmr);
+
+  if (numThreads < 0)
+    return CMR_ERROR_INPUT;
+
+  if (numThreads == 0)
+  {
+#if defined(CMR_WITH_THREADS) && defined(_SC_NPROCESSORS_ONLN)
+    long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+    numThreads = (numProcessors > 0 && numProcessors < INT_MAX) ? (int) numProcessors : 1;
+#else
+    numThreads = 1;
+#endif /* CMR_WITH_THREADS && _SC_NPROCESSORS_ONLN */
+  }
+
+  cmr->numThreads = numThreads;
+
+  return CMR_OKAY;
+}
+
+int CMRgetNumThreads(CMR* cmr)
+{
+  assert(cmr);
+
+#if defined(CMR_WITH_THREADS)
+  return cmr->numThreads;
+#else
+  return 1;
+#endif /* CMR_WITH_THREADS */
+}
+
+CMR_ERROR CMRsetThreadPinning(CMR* cmr, bool pinning)
+{
+  assert(cmr);
+
+  cmr->pinThreads = pinning;
+
+  return CMR_OKAY;
+}
+
+bool CMRgetThreadPinning(CMR* cmr)
+{
+  assert(cmr);
+
+  return cmr->pinThreads;
+}
+
+CMR_ERROR CMRsetMemoryLimit(CMR* cmr, size_t limit)
+{
+  assert(cmr);
+
+  cmr->memoryLimit = limit ? limit : SIZE_MAX;
+
+  return CMR_OKAY;
+}
+
+size_t CMRgetMemoryLimit(CMR* cmr)
+{
+  assert(cmr);
+
+  return cmr->memoryLimit == SIZE_MAX ? 0 : cmr->memoryLimit;
+}
+
+size_t CMRgetMemoryUsage(CMR* cmr)
+{
+  assert(cmr);
+
+  return CMRatomicLoad(&cmr->memoryUsage);
+}
+
+size_t CMRgetMemoryPeak(CMR* cmr)
+{
+  assert(cmr);
+
+  return CMRatomicLoad(&cmr->memoryPeak);
+}
+
+CMR_ERROR CMRsetStackReservation(CMR* cmr, size_t size)
+{
+  assert(cmr);
+
+#if defined(CMR_WITH_MMAP) && !defined(REPLACE_STACK_BY_MALLOC)
+  cmr->stackReservation = size;
+
+  return CMR_OKAY;
+#else
+  return size ? CMR_ERROR_INPUT : CMR_OKAY;
+#endif /* CMR_WITH_MMAP && !REPLACE_STACK_BY_MALLOC */
+}
+
+CMR_ERROR CMRgetMemoryStats(CMR* cmr, CMR_MEMORY_STATS* stats)
+{
+  assert(cmr);
+  assert(stats);
+
+  size_t stackMemory = CMRatomicLoad(&cmr->stackMemory);
+  stats->numBlockAllocations = CMRatomicLoad(&cmr->numBlockAllocations);
+  stats->blockMemory = CMRatomicLoad(&cmr->memoryUsage) - stackMemory;
+  stats->numStackAllocations = 0;
+  stats->stackMemory = stackMemory;
+  stats->stackPeak = 0;
+  stats->memoryPeak = CMRatomicLoad(&cmr->memoryPeak);
+
+  CMRmutexLock(&cmr->mutex);
+  for (size_t c = 0; c < cmr->numStackChains; ++c)
+  {
+    CMR_STACK_CHAIN* chain = cmr->stackChains[c];
+    stats->numStackAllocations += chain->numAllocations;
+    if (chain->peakUsage > stats->stackPeak)
+      stats->stackPeak = chain->peakUsage;
+  }
+  CMRmutexUnlock(&cmr->mutex);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRresetMemoryStats(CMR* cmr)
+{
+  assert(cmr);
+
+  CMRatomicStore(&cmr->numBlockAllocations, 0);
+  CMRatomicStore(&cmr->memoryPeak, CMRatomicLoad(&cmr->memoryUsage));
+
+  CMRmutexLock(&cmr->mutex);
+  for (size_t c = 0; c < cmr->numStackChains; ++c)
+  {
+    CMR_STACK_CHAIN* chain = cmr->stackChains[c];
+    chain->numAllocations = 0;
+    chain->peakUsage = chain->usage;
+  }
+  CMRmutexUnlock(&cmr->mutex);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmemoryStatsPrint(FILE* stream, CMR_MEMORY_STATS* stats, const char* prefix)
+{
+  assert(stream);
+  assert(stats);
+
+  if (!prefix)
+  {
+    fprintf(stream, "Memory:\n");
+    prefix = "  ";
+  }
+  fprintf(stream, "%sblock allocations: %lu with %lu bytes in use\n", prefix, (unsigned long)stats->numBlockAllocations,
+    (unsigned long)stats->blockMemory);
+  fprintf(stream, "%sstack allocations: %lu with %lu bytes reserved and at most %lu bytes per thread in use\n",
+    prefix, (unsigned long)stats->numStackAllocations, (unsigned long)stats->stackMemory,
+    (unsigned long)stats->stackPeak);
+  fprintf(stream, "%speak: %lu bytes\n", prefix, (unsigned long)stats->memoryPeak);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Accounts for the allocation of \p size bytes, failing if this would exceed the memory limit.
+ */
+
+static
+CMR_ERROR reserveMemory(
+  CMR* cmr,   /**< \ref CMR environment. */
+  size_t size /**< Number of bytes. */
+)
+{
+  size_t usage = CMRatomicFetchAdd(&cmr->memoryUsage, size) + size;
+  if (usage < size || usage > cmr->memoryLimit)
+  {
+    CMRatomicFetchAdd(&cmr->memoryUsage, -size);
+    return CMR_ERROR_MEMORY;
+  }
+
+  size_t peak = CMRatomicLoad(&cmr->memoryPeak);
+  while (usage > peak && !CMRatomicCompareExchange(&cmr->memoryPeak, peak, usage))
+    peak = CMRatomicLoad(&cmr->memoryPeak);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Accounts for the release of \p size bytes.
+ */
+
+static inline
+void releaseMemory(
+  CMR* cmr,   /**< \ref CMR environment. */
+  size_t size /**< Number of bytes. */
+)
+{
+  CMRatomicFetchAdd(&cmr->memoryUsage, -size);
+}
+
+CMR_ERROR CMRsetProgressCallback(CMR* cmr, CMR_PROGRESS_CALLBACK callback, void* data)
+{
+  assert(cmr);
+
+  cmr->progressCallback = callback;
+  cmr->progressData = data;
+
+  return CMR_OKAY;
+}
+
+void CMRinterrupt(CMR* cmr)
+{
+  assert(cmr);
+
+  CMRatomicStoreFlag(&cmr->interrupted, true);
+}
+
+void CMRclearInterrupt(CMR* cmr)
+{
+  assert(cmr);
+
+  CMRatomicStoreFlag(&cmr->interrupted, false);
+}
+
+bool CMRisInterrupted(CMR* cmr)
+{
+  assert(cmr);
+
+  return CMRatomicLoadFlag(&cmr->interrupted);
+}
+
+/*
+ * Every block is preceded by a header that stores its size such that freeing and reallocating it can be accounted
+ * for. The header size keeps the alignment guaranteed by malloc.
+ */
+
+#define BLOCK_HEADER_SIZE 16
+
+/*
+ * Small blocks are rounded up to multiples of 16 bytes. When freed, they are kept in a per-thread pool of their size
+ * and handed out again in LIFO order, which avoids the allocator for the many small objects of a decomposition, e.g.,
+ * tasks, submatrices and separations. The pools are bounded and only emptied when the environment is freed. They are
+ * disabled with REPLACE_STACK_BY_MALLOC such that memory debuggers see every allocation.
+ */
 
+#define BLOCK_POOL_MAX_SIZE (16 * CMR_NUM_BLOCK_POOLS)  /**< Maximum size of a block that is pooled. */
+#define BLOCK_POOL_MAX_LENGTH 256                       /**< Maximum number of blocks in a pool. */
+
+/**
+ * \brief Returns the number of bytes that are allocated for a block of \p size bytes, excluding its header.
+ */
+
+static inline
+size_t blockCapacity(
+  size_t size /**< Number of bytes requested for the block. */
+)
+{
+  if (size > BLOCK_POOL_MAX_SIZE)
+    return size;
+
+  return size ? (size + 15) & ~((size_t) 15) : 16;
+}
+
+#if !defined(REPLACE_STACK_BY_MALLOC)
+
+static CMR_STACK_CHAIN* getStackChain(CMR* cmr);
+
+#endif /* !REPLACE_STACK_BY_MALLOC */
+
+/**
+ * \brief Allocates a block of \p size bytes after its header.
+ */
+
+static
+CMR_ERROR allocateBlock(
+  CMR* cmr,     /**< \ref CMR environment. */
+  void** ptr,   /**< Pointer for storing the block. */
+  size_t size   /**< Number of bytes. */
+)
+{
+  if (size > SIZE_MAX - BLOCK_HEADER_SIZE)
+    return CMR_ERROR_MEMORY;
+
+  CMR_CALL( reserveMemory(cmr, size + BLOCK_HEADER_SIZE) );
+  CMRatomicFetchAdd(&cmr->numBlockAllocations, 1);
+
+  char* memory = NULL;
+  size_t capacity = blockCapacity(size);
+#if !defined(REPLACE_STACK_BY_MALLOC)
+  if (size <= BLOCK_POOL_MAX_SIZE)
+  {
+    CMR_STACK_CHAIN* chain = getStackChain(cmr);
+    size_t pool = capacity / 16 - 1;
+    if (chain && chain->blockPools[pool])
+    {
+      memory = chain->blockPools[pool];
+      chain->blockPools[pool] = *((void**) memory);
+      --chain->blockPoolLengths[pool];
+    }
+  }
+#endif /* !REPLACE_STACK_BY_MALLOC */
+  if (!memory)
+    memory = envAllocate(cmr, capacity + BLOCK_HEADER_SIZE);
+  if (!memory)
+  {
+    releaseMemory(cmr, size + BLOCK_HEADER_SIZE);
+    return CMR_ERROR_MEMORY;
+  }
+
+  *((size_t*) memory) = size;
+  *ptr = memory + BLOCK_HEADER_SIZE;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Frees the block \p ptr together with its header, keeping it in a pool if it is small.
+ */
+
+static
+void freeBlock(
+  CMR* cmr, /**< \ref CMR environment. */
+  void* ptr /**< Block. */
+)
+{
+  char* memory = ((char*) ptr) - BLOCK_HEADER_SIZE;
+  size_t size = *((size_t*) memory);
+  releaseMemory(cmr, size + BLOCK_HEADER_SIZE);
+
+#if !defined(REPLACE_STACK_BY_MALLOC)
+  if (size <= BLOCK_POOL_MAX_SIZE)
+  {
+    CMR_STACK_CHAIN* chain = getStackChain(cmr);
+    size_t pool = blockCapacity(size) / 16 - 1;
+    if (chain && chain->blockPoolLengths[pool] < BLOCK_POOL_MAX_LENGTH)
+    {
+      *((void**) memory) = chain->blockPools[pool];
+      chain->blockPools[pool] = memory;
+      ++chain->blockPoolLengths[pool];
+      return;
+    }
+  }
+#endif /* !REPLACE_STACK_BY_MALLOC */
+
+  envRelease(cmr, memory);
+}
+
+CMR_ERROR _CMRallocBlock(CMR* cmr, void** ptr, size_t size)
+{
   assert(cmr);
   assert(ptr);
   assert(*ptr == NULL);
-  *ptr = malloc(size);
 
-  return *ptr ? CMR_OKAY : CMR_ERROR_MEMORY;
+  return allocateBlock(cmr, ptr, size);
 }
 
 CMR_ERROR _CMRfreeBlock(CMR* cmr, void** ptr, size_t size)
 {
-  CMR_UNUSED(cmr);
   CMR_UNUSED(size);
 
   assert(cmr);
   assert(ptr);
   assert(*ptr);
-  free(*ptr);
+  freeBlock(cmr, *ptr);
   *ptr = NULL;
 
   return CMR_OKAY;
@@ -107,26 +643,52 @@ CMR_ERROR _CMRfreeBlock(CMR* cmr, void** ptr, size_t size)
 
 CMR_ERROR _CMRallocBlockArray(CMR* cmr, void** ptr, size_t size, size_t length)
 {
-  CMR_UNUSED(cmr);
-
   assert(cmr);
   assert(ptr);
   assert(*ptr == NULL);
-  *ptr = malloc(size * length);
 
-  return *ptr ? CMR_OKAY : CMR_ERROR_MEMORY;
+  if (length && size > SIZE_MAX / length)
+    return CMR_ERROR_MEMORY;
+
+  return allocateBlock(cmr, ptr, size * length);
 }
 
 
 CMR_ERROR _CMRreallocBlockArray(CMR* cmr, void** ptr, size_t size, size_t length)
 {
-  CMR_UNUSED(cmr);
-
   assert(cmr);
   assert(ptr);
-  *ptr = realloc(*ptr, size * length);
 
-  return *ptr ? CMR_OKAY : CMR_ERROR_MEMORY;
+  if (!*ptr)
+    return _CMRallocBlockArray(cmr, ptr, size, length);
+
+  if ((length && size > SIZE_MAX / length) || size * length > SIZE_MAX - BLOCK_HEADER_SIZE)
+    return CMR_ERROR_MEMORY;
+
+  char* memory = ((char*) *ptr) - BLOCK_HEADER_SIZE;
+  size_t oldSize = *((size_t*) memory);
+  size_t newSize = size * length;
+  if (newSize > oldSize)
+    CMR_CALL( reserveMemory(cmr, newSize - oldSize) );
+  CMRatomicFetchAdd(&cmr->numBlockAllocations, 1);
+
+  /* Since small blocks are rounded up, the block may already be large enough. */
+  char* newMemory = memory;
+  if (blockCapacity(newSize) != blockCapacity(oldSize))
+    newMemory = envReallocate(cmr, memory, blockCapacity(newSize) + BLOCK_HEADER_SIZE);
+  if (!newMemory)
+  {
+    if (newSize > oldSize)
+      releaseMemory(cmr, newSize - oldSize);
+    return CMR_ERROR_MEMORY;
+  }
+  if (newSize < oldSize)
+    releaseMemory(cmr, oldSize - newSize);
+
+  *((size_t*) newMemory) = newSize;
+  *ptr = newMemory + BLOCK_HEADER_SIZE;
+
+  return CMR_OKAY;
 }
 
 CMR_ERROR _CMRduplicateBlockArray(CMR* cmr, void** ptr, size_t size, size_t length, void* source)
@@ -145,11 +707,10 @@ CMR_ERROR _CMRduplicateBlockArray(CMR* cmr, void** ptr, size_t size, size_t leng
 
 CMR_ERROR _CMRfreeBlockArray(CMR* cmr, void** ptr)
 {
-  CMR_UNUSED(cmr);
-
   assert(cmr);
   assert(ptr);
-  free(*ptr);
+  if (*ptr)
+    freeBlock(cmr, *ptr);
   *ptr = NULL;
 
   return CMR_OKAY;
@@ -170,7 +731,7 @@ CMR_ERROR _CMRallocStack(
   if (size < 4)
     size = 4;
 
-  *ptr = malloc(size);
+  *ptr = envAllocate(cmr, size);
 
   return *ptr ? CMR_OKAY : CMR_ERROR_MEMORY;
 }
@@ -184,7 +745,7 @@ CMR_ERROR _CMRfreeStack(
   assert(ptr);
   assert(*ptr);
 
-  free(*ptr);
+  envRelease(cmr, *ptr);
 
   return CMR_OKAY;
 }
@@ -194,6 +755,14 @@ void CMRassertStackConsistency(CMR* cmr)
   CMR_UNUSED(cmr);
 }
 
+CMR_ERROR CMRreserveStack(CMR* cmr, size_t size)
+{
+  CMR_UNUSED(cmr);
+  CMR_UNUSED(size);
+
+  return CMR_OKAY;
+}
+
 size_t CMRgetStackUsage(CMR* cmr)
 {
   CMR_UNUSED(cmr);
@@ -201,10 +770,260 @@ size_t CMRgetStackUsage(CMR* cmr)
   return 0;
 }
 
+CMR_ERROR CMRstackMark(CMR* cmr, CMR_STACK_MARK* pmark)
+{
+  CMR_UNUSED(cmr);
+  assert(pmark);
+
+  pmark->stack = 0;
+  pmark->top = 0;
+  pmark->usage = 0;
+
+  return CMR_OKAY;
+}
+
+void CMRstackRestore(CMR* cmr, const CMR_STACK_MARK* mark)
+{
+  CMR_UNUSED(cmr);
+  CMR_UNUSED(mark);
+
+  /* Chunks obtained via malloc cannot be found anymore, so they are leaked. */
+}
+
+void CMRreleaseStackChain(CMR* cmr)
+{
+  CMR_UNUSED(cmr);
+}
+
 #else
 
-#define STACK_SIZE(k) \
-  (FIRST_STACK_SIZE << k)
+#if defined(CMR_WITH_THREADS)
+
+static CMR_THREAD_LOCAL size_t cachedEnvironmentId = 0;       /**< Identifier of environment last used by this thread. */
+static CMR_THREAD_LOCAL CMR_STACK_CHAIN* cachedStackChain = NULL; /**< Stack chain of this thread in that environment. */
+
+/**
+ * \brief Returns the stack chain of the calling thread, claiming or creating one if necessary.
+ *
+ * Returns \c NULL if memory allocation failed.
+ */
+
+static
+CMR_STACK_CHAIN* getStackChain(
+  CMR* cmr  /**< \ref CMR environment. */
+)
+{
+  if (cachedEnvironmentId == cmr->id)
+    return cachedStackChain;
+
+  pthread_t self = pthread_self();
+  size_t processor = CMRthreadsProcessor();
+  CMR_STACK_CHAIN* chain = NULL;
+
+  CMRmutexLock(&cmr->mutex);
+
+  /* Search for a chain owned by this thread, or otherwise for a free one. A pinned worker only takes a chain that was
+   * created on its processor such that its memory is local to the worker's node. */
+  CMR_STACK_CHAIN* freeChain = NULL;
+  for (size_t c = 0; c < cmr->numStackChains; ++c)
+  {
+    CMR_STACK_CHAIN* candidate = cmr->stackChains[c];
+    if (candidate->hasOwner && pthread_equal(candidate->owner, self))
+    {
+      chain = candidate;
+      break;
+    }
+    else if (!candidate->hasOwner && !freeChain && (!processor || candidate->processor == processor))
+      freeChain = candidate;
+  }
+
+  if (!chain && freeChain)
+    chain = freeChain;
+  else if (!chain)
+  {
+    if (cmr->numStackChains == cmr->memStackChains)
+    {
+      size_t newMemStackChains = 2 * cmr->memStackChains;
+      CMR_STACK_CHAIN** newStackChains = envReallocate(cmr, cmr->stackChains,
+        newMemStackChains * sizeof(CMR_STACK_CHAIN*));
+      if (newStackChains)
+      {
+        cmr->stackChains = newStackChains;
+        cmr->memStackChains = newMemStackChains;
+      }
+    }
+    if (cmr->numStackChains < cmr->memStackChains)
+    {
+      chain = createStackChain(cmr);
+      if (chain)
+        cmr->stackChains[cmr->numStackChains++] = chain;
+    }
+  }
+
+  if (chain)
+  {
+    chain->hasOwner = true;
+    chain->owner = self;
+    cachedEnvironmentId = cmr->id;
+    cachedStackChain = chain;
+  }
+
+  CMRmutexUnlock(&cmr->mutex);
+
+  return chain;
+}
+
+void CMRreleaseStackChain(CMR* cmr)
+{
+  assert(cmr);
+
+  if (cachedEnvironmentId != cmr->id)
+    return;
+
+  CMR_STACK_CHAIN* chain = cachedStackChain;
+  assert(chain->currentStack == 0 && chain->stacks[0].top == FIRST_STACK_SIZE);
+
+  CMRmutexLock(&cmr->mutex);
+  chain->hasOwner = false;
+  CMRmutexUnlock(&cmr->mutex);
+
+  cachedEnvironmentId = 0;
+  cachedStackChain = NULL;
+}
+
+#else
+
+static inline
+CMR_STACK_CHAIN* getStackChain(
+  CMR* cmr  /**< \ref CMR environment. */
+)
+{
+  return cmr->stackChains[0];
+}
+
+void CMRreleaseStackChain(CMR* cmr)
+{
+  CMR_UNUSED(cmr);
+}
+
+#endif /* CMR_WITH_THREADS */
+
+/**
+ * \brief Appends a stack with at least \p requiredSpace bytes to \p chain.
+ *
+ * Stacks grow geometrically, but a stack that is too small for \p requiredSpace is skipped instead of being allocated.
+ * If a stack reservation is set, the first appended stack is a mapping of that size.
+ */
+
+static
+CMR_ERROR appendStack(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_STACK_CHAIN* chain, /**< Stack chain. */
+  size_t requiredSpace    /**< Number of bytes that the stack must be able to hold. */
+)
+{
+  /* If necessary, enlarge the stacks array. */
+  if (chain->numStacks == chain->memStacks)
+  {
+    size_t newMemStacks = 2 * chain->memStacks;
+    CMR_STACK* newStacks = envReallocate(cmr, chain->stacks, newMemStacks * sizeof(CMR_STACK));
+    if (!newStacks)
+      return CMR_ERROR_MEMORY;
+    chain->stacks = newStacks;
+    chain->memStacks = newMemStacks;
+  }
+
+  CMR_STACK* stack = &chain->stacks[chain->numStacks];
+  stack->isMapped = false;
+  stack->committed = 0;
+
+#if defined(CMR_WITH_MMAP)
+  bool hasMapped = false;
+  for (size_t s = 0; s < chain->numStacks; ++s)
+    hasMapped = hasMapped || chain->stacks[s].isMapped;
+  size_t reservation = cmr->stackReservation;
+  if (reservation >= requiredSpace && !hasMapped)
+  {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+#endif /* MAP_NORESERVE */
+    void* address = mmap(NULL, reservation, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (address != MAP_FAILED)
+    {
+      stack->memory = address;
+      stack->size = reservation;
+      stack->top = reservation;
+      stack->isMapped = true;
+      ++chain->numStacks;
+      return CMR_OKAY;
+    }
+  }
+#endif /* CMR_WITH_MMAP */
+
+  size_t stackSize = 2 * chain->stacks[chain->numStacks - 1].size;
+  while (stackSize < requiredSpace)
+    stackSize *= 2;
+
+  /* Stacks are kept until the environment is freed, so they count as used memory from now on. */
+  CMR_CALL( reserveMemory(cmr, stackSize) );
+  stack->memory = envAllocate(cmr, stackSize * sizeof(char));
+  if (!stack->memory)
+  {
+    releaseMemory(cmr, stackSize);
+    return CMR_ERROR_MEMORY;
+  }
+  CMRatomicFetchAdd(&cmr->stackMemory, stackSize);
+  stack->size = stackSize;
+  stack->top = stackSize;
+  ++chain->numStacks;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Counts the used part of the mapped \p stack as used memory, in steps of \ref STACK_COMMIT_SIZE.
+ */
+
+static
+CMR_ERROR commitMappedStack(
+  CMR* cmr,         /**< \ref CMR environment. */
+  CMR_STACK* stack  /**< Mapped stack. */
+)
+{
+  size_t used = stack->size - stack->top;
+  size_t committed = (used + STACK_COMMIT_SIZE - 1) / STACK_COMMIT_SIZE * STACK_COMMIT_SIZE;
+  if (committed > stack->size)
+    committed = stack->size;
+
+  CMR_CALL( reserveMemory(cmr, committed - stack->committed) );
+  CMRatomicFetchAdd(&cmr->stackMemory, committed - stack->committed);
+  stack->committed = committed;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRreserveStack(CMR* cmr, size_t size)
+{
+  assert(cmr);
+
+  CMR_STACK_CHAIN* chain = getStackChain(cmr);
+  if (!chain)
+    return CMR_ERROR_MEMORY;
+
+  /* All stacks after the current one are empty. */
+  if (chain->stacks[chain->currentStack].top >= size)
+    return CMR_OKAY;
+  for (size_t s = chain->currentStack + 1; s < chain->numStacks; ++s)
+  {
+    if (chain->stacks[s].size >= size)
+      return CMR_OKAY;
+  }
+
+  CMR_CALL( appendStack(cmr, chain, size) );
+
+  return CMR_OKAY;
+}
 
 CMR_ERROR _CMRallocStack(
   CMR* cmr,
@@ -218,6 +1037,10 @@ CMR_ERROR _CMRallocStack(
 
   assert(("Tried to allocate at least 1 TB." == 0) || size < (1L << 40)); /* We should not allocate more than a terabyte. */
 
+  CMR_STACK_CHAIN* chain = getStackChain(cmr);
+  if (!chain)
+    return CMR_ERROR_MEMORY;
+
   /* Avoid allocation of zero bytes. */
   if (size < 4)
     size = 4;
@@ -229,42 +1052,33 @@ CMR_ERROR _CMRallocStack(
 
 #if defined(DEBUG_STACK)
   printf("CMRallocStack() called for %ld bytes; current stack: %ld, numStacks: %ld, memStack: %ld.\n",
-    size, cmr->currentStack, cmr->numStacks, cmr->memStacks);
+    size, chain->currentStack, chain->numStacks, chain->memStacks);
   fflush(stdout);
   printf("Current stack has capacity %ld and %ld free bytes.\n",
-    FIRST_STACK_SIZE << cmr->currentStack, cmr->stacks[cmr->currentStack].top);
+    chain->stacks[chain->currentStack].size, chain->stacks[chain->currentStack].top);
   fflush(stdout);
 #endif /* DEBUG_STACK */
 
-  while (cmr->stacks[cmr->currentStack].top < requiredSpace)
+  size_t oldCurrentStack = chain->currentStack;
+  while (chain->stacks[chain->currentStack].top < requiredSpace)
   {
-    ++cmr->currentStack;
-    if (cmr->currentStack == cmr->numStacks)
+    if (chain->currentStack + 1 == chain->numStacks)
     {
-      /* If necessary, enlarge the slacks array. */
-      if (cmr->numStacks == cmr->memStacks)
+      CMR_ERROR error = appendStack(cmr, chain, requiredSpace);
+      if (error)
       {
-        cmr->stacks = realloc(cmr->stacks, 2 * cmr->memStacks * sizeof(CMR_STACK));
-        size_t newSize = 2*cmr->memStacks;
-        for (size_t s = cmr->memStacks; s < newSize; ++s)
-        {
-          cmr->stacks[s].memory = NULL;
-          cmr->stacks[s].top = FIRST_STACK_SIZE << s;
-        }
-        cmr->memStacks = newSize;
+        chain->currentStack = oldCurrentStack;
+        return error;
       }
-
-      cmr->stacks[cmr->numStacks].top = FIRST_STACK_SIZE << cmr->numStacks;
-      cmr->stacks[cmr->numStacks].memory = malloc(cmr->stacks[cmr->numStacks].top * sizeof(char));
-      ++cmr->numStacks;
     }
+    ++chain->currentStack;
 
-    assert(cmr->stacks[cmr->currentStack].top == (FIRST_STACK_SIZE << cmr->currentStack));
+    assert(chain->stacks[chain->currentStack].top == chain->stacks[chain->currentStack].size);
   }
 
   /* The chunk fits into the last stack. */
 
-  CMR_STACK* pstack = &cmr->stacks[cmr->currentStack];
+  CMR_STACK* pstack = &chain->stacks[chain->currentStack];
   pstack->top -= size;
   *ptr = &pstack->memory[pstack->top];
 #if !defined(NDEBUG)
@@ -273,6 +1087,24 @@ CMR_ERROR _CMRallocStack(
 #endif /* !NDEBUG */
   pstack->top -= sizeof(void*);
   *((size_t*) &pstack->memory[pstack->top]) = size;
+  chain->usage += requiredSpace;
+  if (chain->usage > chain->peakUsage)
+    chain->peakUsage = chain->usage;
+  ++chain->numAllocations;
+
+  if (pstack->isMapped && pstack->size - pstack->top > pstack->committed)
+  {
+    CMR_ERROR error = commitMappedStack(cmr, pstack);
+    if (error)
+    {
+      pstack->top += requiredSpace;
+      chain->usage -= requiredSpace;
+      *ptr = NULL;
+      while (pstack->top == pstack->size && chain->currentStack > 0)
+        pstack = &chain->stacks[--chain->currentStack];
+      return error;
+    }
+  }
 
 #if defined(DEBUG_STACK)
   printf("Writing size %ld to %p.\n", size, &pstack->memory[pstack->top]);
@@ -287,8 +1119,10 @@ CMR_ERROR _CMRfreeStack(CMR* cmr, void** ptr)
   assert(ptr);
   assert(*ptr);
 
-  CMR_STACK* stack = &cmr->stacks[cmr->currentStack];
-  CMRdbgMsg(0, "CMRfreeStack called for pointer %p. Last stack is %d.\n", *ptr, cmr->currentStack);
+  CMR_STACK_CHAIN* chain = getStackChain(cmr);
+  assert(chain);
+  CMR_STACK* stack = &chain->stacks[chain->currentStack];
+  CMRdbgMsg(0, "CMRfreeStack called for pointer %p. Last stack is %d.\n", *ptr, chain->currentStack);
   size_t size = *((size_t*) &stack->memory[stack->top]);
 
 #if defined(DEBUG_STACK)
@@ -297,7 +1131,7 @@ CMR_ERROR _CMRfreeStack(CMR* cmr, void** ptr)
   fflush(stdout);
 #endif /* DEBUG_STACK */
 
-  assert(size < (FIRST_STACK_SIZE << cmr->numStacks));
+  assert(size < stack->size);
 
 #if !defined(NDEBUG)
   if (*((int*) (&stack->memory[stack->top] + sizeof(void*))) != PROTECTION)
@@ -319,21 +1153,60 @@ CMR_ERROR _CMRfreeStack(CMR* cmr, void** ptr)
   }
 #endif /* !NDEBUG */
 
-  stack->top += size + sizeof(void*);
+  size_t chunkSpace = size + sizeof(void*);
 #if !defined(NDEBUG)
-  stack->top += sizeof(int);
+  chunkSpace += sizeof(int);
 #endif /* !NDEBUG */
+  stack->top += chunkSpace;
+  chain->usage -= chunkSpace;
 
-  while (stack->top == (FIRST_STACK_SIZE << cmr->currentStack) && cmr->currentStack > 0)
+  while (stack->top == stack->size && chain->currentStack > 0)
   {
-    --cmr->currentStack;
-    stack = &cmr->stacks[cmr->currentStack];
+    --chain->currentStack;
+    stack = &chain->stacks[chain->currentStack];
   }
   *ptr = NULL;
 
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRstackMark(CMR* cmr, CMR_STACK_MARK* pmark)
+{
+  assert(cmr);
+  assert(pmark);
+
+  CMR_STACK_CHAIN* chain = getStackChain(cmr);
+  if (!chain)
+    return CMR_ERROR_MEMORY;
+
+  pmark->stack = chain->currentStack;
+  pmark->top = chain->stacks[chain->currentStack].top;
+  pmark->usage = chain->usage;
+
+  return CMR_OKAY;
+}
+
+void CMRstackRestore(CMR* cmr, const CMR_STACK_MARK* mark)
+{
+  assert(cmr);
+  assert(mark);
+
+  CMR_STACK_CHAIN* chain = getStackChain(cmr);
+  assert(chain);
+  assert(mark->stack < chain->numStacks);
+  assert(mark->stack < chain->currentStack || mark->top >= chain->stacks[chain->currentStack].top);
+
+  for (size_t s = mark->stack + 1; s <= chain->currentStack; ++s)
+    chain->stacks[s].top = chain->stacks[s].size;
+  chain->currentStack = mark->stack;
+  chain->stacks[mark->stack].top = mark->top;
+  chain->usage = mark->usage;
+
+  CMR_STACK* stack = &chain->stacks[chain->currentStack];
+  while (stack->top == stack->size && chain->currentStack > 0)
+    stack = &chain->stacks[--chain->currentStack];
+}
+
 #if !defined(NDEBUG)
 
 void CMRassertStackConsistency(
@@ -342,14 +1215,16 @@ void CMRassertStackConsistency(
 {
   assert(cmr);
 
-  for (size_t s = 0; s <= cmr->currentStack; ++s)
+  CMR_STACK_CHAIN* chain = getStackChain(cmr);
+  assert(chain);
+  for (size_t s = 0; s <= chain->currentStack; ++s)
   {
-    CMR_STACK* stack = &cmr->stacks[s];
+    CMR_STACK* stack = &chain->stacks[s];
 
     char* ptr = &stack->memory[stack->top];
-    CMRdbgMsg(2, "Stack %d of size %d has memory range [%p,%p). top is %p\n", s, STACK_SIZE(s), stack->memory,
-      stack->memory + STACK_SIZE(s), ptr);
-    while (ptr < (char*)stack->memory + STACK_SIZE(s))
+    CMRdbgMsg(2, "Stack %d of size %d has memory range [%p,%p). top is %p\n", s, stack->size, stack->memory,
+      stack->memory + stack->size, ptr);
+    while (ptr < (char*)stack->memory + stack->size)
     {
       CMRdbgMsg(4, "pointer is %p.", ptr);
       size_t size = *((size_t*) ptr);
@@ -365,10 +1240,14 @@ void CMRassertStackConsistency(
   
 size_t CMRgetStackUsage(CMR* cmr)
 { 
+  CMR_STACK_CHAIN* chain = getStackChain(cmr);
+  if (!chain)
+    return 0;
+
   size_t result = 0;
-  for (size_t stack = 0; stack < cmr->currentStack; ++stack)
-    result += (FIRST_STACK_SIZE << stack);
-  result += (FIRST_STACK_SIZE << cmr->currentStack) - cmr->stacks[cmr->currentStack].top; 
+  for (size_t stack = 0; stack < chain->currentStack; ++stack)
+    result += chain->stacks[stack].size;
+  result += chain->stacks[chain->currentStack].size - chain->stacks[chain->currentStack].top;
 
   return result;
 }
@@ -380,7 +1259,9 @@ void CMRraiseErrorMessage(CMR* cmr, const char* format, ...)
 {
   va_list args;
 
-  cmr->errorMessage = (char*) realloc(cmr->errorMessage, 256);
+  CMRmutexLock(&cmr->mutex);
+
+  cmr->errorMessage = (char*) envReallocate(cmr, cmr->errorMessage, 256);
 
   va_start(args, format);
   int written = vsnprintf(cmr->errorMessage, 256, format, args);
@@ -388,11 +1269,13 @@ void CMRraiseErrorMessage(CMR* cmr, const char* format, ...)
 
   if (written >= 256)
   {
-    cmr->errorMessage = (char*) realloc(cmr->errorMessage, written + 1);
+    cmr->errorMessage = (char*) envReallocate(cmr, cmr->errorMessage, written + 1);
     va_start(args, format);
     vsnprintf(cmr->errorMessage, written+1, format, args);
     va_end(args);
   }
+
+  CMRmutexUnlock(&cmr->mutex);
 }
 
 char* CMRgetErrorMessage(CMR* cmr)
@@ -404,7 +1287,7 @@ void CMRclearErrorMessage(CMR* cmr)
 {
   if (cmr->errorMessage)
   {
-    free(cmr->errorMessage);
+    envRelease(cmr, cmr->errorMessage);
     cmr->errorMessage = NULL;
   }
 }
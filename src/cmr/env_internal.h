@@ -4,9 +4,12 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stdint.h>
 
 #include <cmr/env.h>
 
+#include "threads.h"
+
 #if defined(CMR_DEBUG)
 
 static inline
@@ -37,25 +40,123 @@ void CMRdbgMsg(int indent, const char* format, ...)
 
 typedef struct
 {
-  char* memory; /**< \brief Raw memory. */
-  size_t top;   /**< \brief First used byte. */
+  char* memory;     /**< \brief Raw memory. */
+  size_t top;       /**< \brief First used byte. */
+  size_t size;      /**< \brief Number of bytes of \ref memory. */
+  bool isMapped;    /**< \brief Whether \ref memory is a reservation of virtual memory whose pages are committed on
+                     **  first use. */
+  size_t committed; /**< \brief For a mapped stack, the number of bytes at its end that count as used memory. */
 } CMR_STACK;
 
-struct CMR_ENVIRONMENT
-{
-  char* errorMessage;   /**< \brief Error message. */
+#define CMR_NUM_BLOCK_POOLS 16  /**< Number of pools for freed blocks; pool \c i holds blocks of <tt>16(i+1)</tt> bytes. */
 
-  FILE* output;         /**< \brief Output stream or \c NULL if silent. */
-  bool closeOutput;     /**< \brief Whether to close the output stream at the end. */
-  int verbosity;        /**< \brief Verbosity level. */
-  int numThreads;       /**< \brief Number of threads to use. */
+/**
+ * \brief Chain of stacks of increasing sizes used by a single thread.
+ *
+ * It also holds the pools of freed small blocks of that thread.
+ */
 
-  size_t numStacks;     /**< \brief Number of allocated stacks in stack array. */
-  size_t memStacks;     /**< \brief Memory for stack array. */
-  size_t currentStack;  /**< \brief Index of last used stack. */
+typedef struct
+{
+  size_t numStacks;      /**< \brief Number of allocated stacks in stack array. */
+  size_t memStacks;      /**< \brief Memory for stack array. */
+  size_t currentStack;   /**< \brief Index of last used stack. */
   CMR_STACK* stacks;     /**< \brief Array of stacks. */
+  size_t usage;          /**< \brief Number of bytes of all chunks on the stacks, including their headers. */
+  size_t peakUsage;      /**< \brief Maximum of \ref usage since the memory statistics were reset. */
+  size_t numAllocations; /**< \brief Number of chunks allocated since the memory statistics were reset. */
+  void* blockPools[CMR_NUM_BLOCK_POOLS];      /**< \brief Lists of freed small blocks, linked via their first bytes. */
+  size_t blockPoolLengths[CMR_NUM_BLOCK_POOLS]; /**< \brief Numbers of blocks in \ref blockPools. */
+#if defined(CMR_WITH_THREADS)
+  bool hasOwner;         /**< \brief Whether the chain is currently used by some thread. */
+  pthread_t owner;       /**< \brief Thread that uses this chain if \ref hasOwner is \c true. */
+  size_t processor;      /**< \brief Processor plus 1 of the pinned worker that created this chain, or 0. */
+#endif /* CMR_WITH_THREADS */
+} CMR_STACK_CHAIN;
+
+/**
+ * \brief Memory-mapped file or external buffers whose contents are used by a matrix.
+ */
+
+typedef struct CMR_MAPPING
+{
+  void* matrix;             /**< \brief Matrix whose arrays point into the mapped memory. */
+  void* address;            /**< \brief Start of the mapped memory, or \c NULL for buffers owned by the user. */
+  size_t size;              /**< \brief Size of the mapped memory in bytes. */
+  struct CMR_MAPPING* next; /**< \brief Next mapping in the list of the environment. */
+} CMR_MAPPING;
+
+/**
+ * \brief Transpose of a char matrix that is cached on behalf of that matrix.
+ *
+ * Besides the matrix, its arrays and number of nonzeros are stored such that a matrix that reuses the memory of a
+ * matrix freed without \ref CMRchrmatFree() is not mistaken for the latter.
+ */
+
+typedef struct CMR_TRANSPOSE_CACHE
+{
+  void* matrix;                     /**< \brief Matrix whose transpose is cached. */
+  size_t* rowSlice;                 /**< \brief \c rowSlice array of \ref matrix at the time of caching. */
+  size_t* entryColumns;             /**< \brief \c entryColumns array of \ref matrix at the time of caching. */
+  size_t numNonzeros;               /**< \brief Number of nonzeros of \ref matrix at the time of caching. */
+  void* transpose;                  /**< \brief Cached transpose. */
+  struct CMR_TRANSPOSE_CACHE* next; /**< \brief Next cached transpose in the list of the environment. */
+} CMR_TRANSPOSE_CACHE;
+
+struct CMR_ENVIRONMENT
+{
+  CMR_ALLOCATOR allocator;        /**< \brief Allocator for heap memory. */
+  char* errorMessage;             /**< \brief Error message. */
+
+  FILE* output;                   /**< \brief Output stream or \c NULL if silent. */
+  bool closeOutput;               /**< \brief Whether to close the output stream at the end. */
+  int verbosity;                  /**< \brief Verbosity level. */
+  int numThreads;                 /**< \brief Number of threads to use. */
+  bool pinThreads;                /**< \brief Whether workers are bound to processors. */
+  bool hardwareCounters;          /**< \brief Whether hardware performance counters are recorded. */
+  size_t memoryLimit;             /**< \brief Maximum number of bytes of block and stack memory, or \c SIZE_MAX. */
+  size_t memoryUsage;             /**< \brief Number of bytes of block and stack memory in use; accessed atomically. */
+  size_t memoryPeak;              /**< \brief Maximum of \ref memoryUsage so far; accessed atomically. */
+  size_t stackMemory;             /**< \brief Number of bytes of \ref memoryUsage that are stacks; accessed atomically. */
+  size_t numBlockAllocations;     /**< \brief Number of block (re)allocations; accessed atomically. */
+  size_t stackReservation;        /**< \brief Size of the virtual memory reserved for the stack of a thread, or 0. */
+
+  size_t id;                      /**< \brief Identifier that is unique among all environments ever created. */
+  size_t numStackChains;          /**< \brief Number of stack chains, i.e., of threads that used this environment. */
+  size_t memStackChains;          /**< \brief Memory for \ref stackChains. */
+  CMR_STACK_CHAIN** stackChains;  /**< \brief Array of stack chains; the first one belongs to the creating thread. */
+  CMR_MUTEX mutex;                /**< \brief Mutex protecting \ref stackChains, \ref errorMessage, \ref mappings and
+                                   **  \ref transposes. */
+  CMR_MAPPING* mappings;          /**< \brief List of memory-mapped matrix files. */
+  bool hasMappings;               /**< \brief Whether a matrix file was ever mapped into memory. */
+  CMR_TRANSPOSE_CACHE* transposes;/**< \brief List of cached transposes. */
+  bool hasTransposes;             /**< \brief Whether a transpose was ever cached. */
+  bool interrupted;               /**< \brief Whether \ref CMRinterrupt was called; accessed atomically. */
+  CMR_PROGRESS_CALLBACK progressCallback; /**< \brief Progress callback (may be \c NULL). */
+  void* progressData;             /**< \brief User data for \ref progressCallback. */
+  FILE* trace;                    /**< \brief Stream for trace events, or \c NULL if tracing is disabled. */
+  size_t traceId;                 /**< \brief Identifier of the current trace that is unique among all traces. */
+  double traceStart;              /**< \brief Time at which the current trace was started. */
+  size_t traceNumEvents;          /**< \brief Number of events written to \ref trace; protected by \ref mutex. */
+  size_t traceNumThreads;         /**< \brief Number of threads that wrote to \ref trace; protected by \ref mutex. */
 };
 
+/**
+ * \brief Reports \p progress to the progress callback of \p cmr, if any.
+ *
+ * The caller must ensure that no two threads report at the same time.
+ */
+
+static inline
+void CMRreportProgress(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  const CMR_PROGRESS* progress  /**< Current progress. */
+)
+{
+  if (cmr->progressCallback)
+    cmr->progressCallback(cmr, progress, cmr->progressData);
+}
+
 #include <cmr/env.h>
 
 /**
@@ -144,10 +245,78 @@ void CMRraiseErrorMessage(
   const char* format, ... /**< \ref Variadic arguments in printf-style. */
 );
 
+/**
+ * \brief Returns whether the memory limit of \p cmr is nearly reached if \p size further bytes are allocated.
+ *
+ * Algorithms use this to switch to strategies that need less memory before an allocation actually fails, which is
+ * the case once less than a quarter of the limit would remain.
+ */
+
+static inline
+bool CMRisMemoryShort(
+  CMR* cmr,   /**< \ref CMR environment. */
+  size_t size /**< Number of bytes that are about to be allocated. */
+)
+{
+  if (cmr->memoryLimit == SIZE_MAX)
+    return false;
+
+  size_t usage = CMRatomicLoad(&cmr->memoryUsage);
+  return size >= cmr->memoryLimit || usage >= cmr->memoryLimit - size
+    || cmr->memoryLimit - size - usage < cmr->memoryLimit / 4;
+}
+
+/**
+ * \brief Returns the number of bytes of stack memory that are in use by the calling thread.
+ */
+
 size_t CMRgetStackUsage(
   CMR* cmr  /**< \ref CMR environment. */
 );
 
+/**
+ * \brief Position on the stack memory of a thread, obtained by \ref CMRstackMark.
+ */
+
+typedef struct
+{
+  size_t stack; /**< \brief Index of the current stack. */
+  size_t top;   /**< \brief First used byte of the current stack. */
+  size_t usage; /**< \brief Number of bytes of all chunks on the stacks. */
+} CMR_STACK_MARK;
+
+/**
+ * \brief Stores the current position on the stack memory of the calling thread in \p *pmark.
+ */
+
+CMR_ERROR CMRstackMark(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_STACK_MARK* pmark /**< Pointer for storing the position. */
+);
+
+/**
+ * \brief Frees all stack memory that the calling thread allocated after \p mark was taken.
+ *
+ * This recovers from errors such as \ref CMR_ERROR_TIMEOUT, after which the chunks allocated by the aborted calls
+ * were not freed. Their pointers become invalid.
+ */
+
+void CMRstackRestore(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  const CMR_STACK_MARK* mark  /**< Position taken by \ref CMRstackMark on the same thread. */
+);
+
+/**
+ * \brief Makes the stack chain of the calling thread available to other threads.
+ *
+ * Must be called by threads that used \p cmr but terminate before \p cmr is freed. All stack memory of the calling
+ * thread must have been freed.
+ */
+
+void CMRreleaseStackChain(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
 char* CMRconsistencyMessage(const char* format, ...);
 
 #if !defined(NDEBUG)
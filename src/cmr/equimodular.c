@@ -5,11 +5,12 @@
 
 #include <assert.h>
 #include <float.h>
-#include <time.h>
 #include <inttypes.h>
 
 #include "env_internal.h"
 #include "linear_algebra_internal.h"
+#include "deadline.h"
+#include "threads.h"
 
 CMR_ERROR CMRequimodularParamsInit(CMR_EQUIMODULAR_PARAMS* params)
 {
@@ -54,13 +55,54 @@ CMR_ERROR CMRequimodularStatsPrint(FILE* stream, CMR_EQUIMODULAR_STATS* stats, c
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRequimodularTest(CMR* cmr, CMR_INTMAT* matrix, bool* pisEquimodular, int64_t* pgcdDet,
-  CMR_EQUIMODULAR_PARAMS* params, CMR_EQUIMODULAR_STATS* stats, double timeLimit)
+CMR_ERROR CMRequimodularStatsPrintJson(FILE* stream, CMR_EQUIMODULAR_STATS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"linear-algebra-time\":%.9g", stats->linalgTime);
+  fprintf(stream, ",\"tu\":");
+  CMR_CALL( CMRtuStatsPrintJson(stream, &stats->tu) );
+  fprintf(stream, ",\"total\":{\"count\":%lu,\"time\":%.9g}}", (unsigned long)stats->totalCount, stats->totalTime);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRequimodularStatsAdd(CMR_EQUIMODULAR_STATS* target, CMR_EQUIMODULAR_STATS* source)
+{
+  assert(target);
+  assert(source);
+
+  target->totalCount += source->totalCount;
+  target->totalTime += source->totalTime;
+  target->linalgTime += source->linalgTime;
+  CMR_CALL( CMRtuStatsAdd(&target->tu, &source->tu) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Tests a matrix for being equimodular, exploiting a known bound on its rank.
+ */
+
+static
+CMR_ERROR testEquimodular(
+  CMR* cmr,                       /**< \ref CMR environment */
+  CMR_INTMAT* matrix,             /**< Matrix \f$ M \f$. */
+  size_t rankBound,               /**< Upper bound on the rank of \f$ M \f$, or \c SIZE_MAX if unknown. */
+  size_t* prank,                  /**< Pointer for storing the rank of \f$ M \f$ (may be \c NULL). */
+  int64_t* pbasisDet,             /**< Pointer for storing the absolute determinant of the found basis, even if
+                                   **  \f$ M \f$ is not equimodular (may be \c NULL). */
+  bool* pisEquimodular,           /**< Pointer for storing whether \f$ M \f$ is equimodular. */
+  int64_t* pgcdDet,               /**< Pointer for supplying/storing the determinant gcd (may be \c NULL). */
+  CMR_EQUIMODULAR_PARAMS* params, /**< Parameters for the computation (may be \c NULL for defaults). */
+  CMR_EQUIMODULAR_STATS* stats,   /**< Statistics for the computation (may be \c NULL). */
+  double timeLimit                /**< Time limit to impose. */
+)
 {
   assert(cmr);
   assert(matrix);
   assert(pisEquimodular);
-  CMRconsistencyAssert( CMRintmatConsistency(matrix) );
 
   CMR_EQUIMODULAR_PARAMS defaultParams;
   if (!params)
@@ -73,18 +115,31 @@ CMR_ERROR CMRequimodularTest(CMR* cmr, CMR_INTMAT* matrix, bool* pisEquimodular,
 
   CMR_ERROR result = CMR_OKAY;
 
-  clock_t totalClock = clock();
+  double totalClock = CMRclockNow();
 
-  /* Transform matrix to upper-diagonal matrix with diagonally dominant columns. */
+  /* Transform matrix to upper-diagonal matrix with diagonally dominant columns. For a prescribed determinant gcd
+   * the elimination stops at the first pivot that rules it out. */
   size_t rank;
+  bool stopped = false;
+  int64_t targetDet = (pgcdDet && *pgcdDet > 0 && !pbasisDet) ? *pgcdDet : 0;
   CMR_SUBMAT* basisPermutation = NULL;
   CMR_INTMAT* transformed_matrix = NULL;
   CMR_INTMAT* transformed_transpose = NULL;
-  CMR_ERROR error = CMRintmatComputeUpperDiagonal(cmr, matrix, true, &rank, &basisPermutation, &transformed_matrix,
-    &transformed_transpose);
+  CMR_ERROR error = CMRintmatComputeUpperDiagonal(cmr, matrix, true, rankBound, targetDet, &rank, &stopped,
+    &basisPermutation, &transformed_matrix, NULL);
   if (error == CMR_ERROR_OVERFLOW)
     return CMR_ERROR_OVERFLOW;
   CMR_CALL(error);
+  if (stopped)
+  {
+    CMRdbgMsg(2, "Elimination stopped after %zu pivots since the determinant gcd is not %" PRId64 ".\n", rank,
+      targetDet);
+    *pisEquimodular = false;
+    *pgcdDet = 0;
+    goto cleanup;
+  }
+  if (prank)
+    *prank = rank;
 
 #if defined(CMR_DEBUG)
   CMRdbgMsg(0, "Transformed matrix has rank %ld.\n", rank);
@@ -112,15 +167,21 @@ CMR_ERROR CMRequimodularTest(CMR* cmr, CMR_INTMAT* matrix, bool* pisEquimodular,
     }
   }
 
+  if (pbasisDet)
+    *pbasisDet = gcdDet;
+
   /* Test for a particular determinant gcd if requested. */
   CMRdbgMsg(2, "The determinant gcd is %" PRId64 ".\n", gcdDet);
   if (pgcdDet && *pgcdDet && *pgcdDet != gcdDet)
   {
     *pisEquimodular = false;
-    *pgcdDet = gcdDet;
+    *pgcdDet = 0;
     goto cleanup;
   }
 
+  /* The transpose of the transformed matrix is only needed from here on. */
+  CMR_CALL( CMRintmatTranspose(cmr, transformed_matrix, &transformed_transpose) );
+
   /* Construct the transpose (since we create it column-wises) of the pseudo-inverse that we feed into the TU test. */
   int64_t* denseColumn = NULL;
   CMR_CALL( CMRallocStackArray(cmr, &denseColumn, matrix->numColumns) );
@@ -167,6 +228,8 @@ CMR_ERROR CMRequimodularTest(CMR* cmr, CMR_INTMAT* matrix, bool* pisEquimodular,
       {
         /* Resulting entry is not in {-1, 0, +1}. */
         *pisEquimodular = false;
+        if (pgcdDet)
+          *pgcdDet = 0;
         CMR_CALL( CMRfreeStackArray(cmr, &denseColumnNonzeros) );
         CMR_CALL( CMRfreeStackArray(cmr, &denseColumn) );
         CMRchrmatFree(cmr, &transposed_pseudo_inverse);
@@ -206,7 +269,7 @@ CMR_ERROR CMRequimodularTest(CMR* cmr, CMR_INTMAT* matrix, bool* pisEquimodular,
   CMR_CALL( CMRfreeStackArray(cmr, &denseColumnNonzeros) );
   CMR_CALL( CMRfreeStackArray(cmr, &denseColumn) );
 
-  double linalgTime = (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
+  double linalgTime = CMRclockNow() - totalClock;
   if (stats)
     stats->linalgTime += linalgTime;
   double remainingTime = timeLimit - linalgTime;
@@ -232,10 +295,68 @@ cleanup:
   CMRsubmatFree(cmr, &basisPermutation);
 
   if (stats)
-    stats->totalTime += (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
+    stats->totalTime += CMRclockNow() - totalClock;
 
   return result;
-  
+}
+
+CMR_ERROR CMRequimodularTest(CMR* cmr, CMR_INTMAT* matrix, bool* pisEquimodular, int64_t* pgcdDet,
+  CMR_EQUIMODULAR_PARAMS* params, CMR_EQUIMODULAR_STATS* stats, double timeLimit)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pisEquimodular);
+  CMRconsistencyAssert( CMRintmatConsistency(matrix) );
+
+  CMR_CALL( testEquimodular(cmr, matrix, SIZE_MAX, NULL, NULL, pisEquimodular, pgcdDet, params, stats, timeLimit) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief One of the two equimodularity tests carried out for strong equimodularity.
+ */
+
+typedef struct
+{
+  CMR_INTMAT* matrix;           /**< \brief Matrix to test. */
+  bool isEquimodular;           /**< \brief Whether \ref matrix is equimodular. */
+  int64_t gcdDet;               /**< \brief Supplied and resulting determinant gcd. */
+  int64_t basisDet;             /**< \brief Absolute determinant of the found basis. */
+  CMR_EQUIMODULAR_STATS stats;  /**< \brief Statistics of the test. */
+  CMR_ERROR error;              /**< \brief Error of the test. */
+} StrongEquimodularHalf;
+
+/**
+ * \brief Data shared by the workers of the strong equimodularity test.
+ */
+
+typedef struct
+{
+  StrongEquimodularHalf halves[2];  /**< \brief Tests of the matrix and of its transpose. */
+  CMR_EQUIMODULAR_PARAMS* params;   /**< \brief Parameters for the computation. */
+  double timeLimit;                 /**< \brief Time limit to impose on each test. */
+} StrongEquimodularity;
+
+/**
+ * \brief Tests the matrix (worker 0) or its transpose (worker 1) for being equimodular.
+ */
+
+static
+CMR_ERROR strongEquimodularWorker(
+  CMR* cmr,       /**< \ref CMR environment of the worker. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref StrongEquimodularity. */
+)
+{
+  StrongEquimodularity* strong = (StrongEquimodularity*) data;
+  StrongEquimodularHalf* half = &strong->halves[worker];
+
+  /* The error is reported through the half, such that the other test is not affected. */
+  half->error = testEquimodular(cmr, half->matrix, SIZE_MAX, NULL, &half->basisDet, &half->isEquimodular,
+    &half->gcdDet, strong->params, &half->stats, strong->timeLimit);
+
+  return CMR_OKAY;
 }
 
 CMR_ERROR CMRequimodularTestStrong(CMR* cmr, CMR_INTMAT* matrix, bool* pisStronglyEquimodular, int64_t* pgcdDet,
@@ -253,19 +374,74 @@ CMR_ERROR CMRequimodularTestStrong(CMR* cmr, CMR_INTMAT* matrix, bool* pisStrong
   if (!pgcdDet)
     pgcdDet = &gcdDet;
 
-  clock_t startClock = clock();
-  CMR_CALL( CMRequimodularTest(cmr, matrix, pisStronglyEquimodular, pgcdDet, params, stats, timeLimit) );
-  double remainingTime = timeLimit - ((clock() - startClock) * 1.0 / CLOCKS_PER_SEC);
-  if (remainingTime <= 0)
-    return CMR_ERROR_TIMEOUT;
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
+  CMR_INTMAT* transpose = NULL;
+  CMR_CALL( CMRintmatTranspose(cmr, matrix, &transpose) );
 
-  /* If it is equimodular, then we also test the transpose. */
-  if (*pisStronglyEquimodular)
+  if (CMRthreadsNumWorkers(cmr, 2) < 2)
   {
-    CMR_INTMAT* transpose = NULL;
-    CMR_CALL( CMRintmatTranspose(cmr, matrix, &transpose) );
-    CMR_CALL( CMRequimodularTest(cmr, transpose, pisStronglyEquimodular, pgcdDet, params, stats, remainingTime) );
+    /* The transpose is only tested if the matrix is equimodular, with the rank of the matrix as a bound. */
+    size_t rank;
+    CMR_ERROR error = testEquimodular(cmr, matrix, SIZE_MAX, &rank, NULL, pisStronglyEquimodular, pgcdDet, params,
+      stats, timeLimit);
+    double remainingTime = CMRdeadlineRemaining(&deadline);
+    if (!error && remainingTime <= 0)
+      error = CMR_ERROR_TIMEOUT;
+    if (!error && *pisStronglyEquimodular)
+    {
+      error = testEquimodular(cmr, transpose, rank, NULL, NULL, pisStronglyEquimodular, pgcdDet, params, stats,
+        remainingTime);
+    }
     CMR_CALL( CMRintmatFree(cmr, &transpose) );
+
+    return error;
+  }
+
+  /* The matrix and its transpose are tested concurrently, both for the supplied determinant gcd. */
+  StrongEquimodularity strong;
+  strong.params = params;
+  strong.timeLimit = CMRdeadlineRemaining(&deadline);
+  strong.halves[0].matrix = matrix;
+  strong.halves[1].matrix = transpose;
+  for (size_t h = 0; h < 2; ++h)
+  {
+    strong.halves[h].isEquimodular = false;
+    strong.halves[h].gcdDet = *pgcdDet;
+    strong.halves[h].basisDet = 0;
+    strong.halves[h].error = CMR_OKAY;
+    CMR_CALL( CMRequimodularStatsInit(&strong.halves[h].stats) );
+  }
+  CMR_CALL( CMRthreadsRun(cmr, 2, strongEquimodularWorker, &strong) );
+  CMR_CALL( CMRintmatFree(cmr, &transpose) );
+
+  /* Combine the results as if the transpose had been tested after the matrix and only if it is equimodular. */
+  StrongEquimodularHalf* first = &strong.halves[0];
+  StrongEquimodularHalf* second = &strong.halves[1];
+  CMR_CALL( CMRequimodularStatsAdd(stats, &first->stats) );
+  if (first->error)
+    return first->error;
+  if (CMRdeadlineRemaining(&deadline) <= 0)
+    return CMR_ERROR_TIMEOUT;
+
+  *pisStronglyEquimodular = first->isEquimodular;
+  *pgcdDet = first->gcdDet;
+  if (first->isEquimodular)
+  {
+    CMR_CALL( CMRequimodularStatsAdd(stats, &second->stats) );
+    if (second->error)
+      return second->error;
+
+    if (second->basisDet != first->gcdDet)
+    {
+      /* The transpose has a different determinant gcd. */
+      *pisStronglyEquimodular = false;
+      *pgcdDet = 0;
+    }
+    else
+    {
+      *pisStronglyEquimodular = second->isEquimodular;
+      *pgcdDet = second->gcdDet;
+    }
   }
 
   return CMR_OKAY;
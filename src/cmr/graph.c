@@ -178,6 +178,87 @@ CMR_ERROR CMRgraphClear(CMR* cmr, CMR_GRAPH* graph)
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRgraphAssignEdges(CMR* cmr, CMR_GRAPH* graph, size_t numNodes, size_t numEdges,
+  const CMR_GRAPH_NODE* edgesU, const CMR_GRAPH_NODE* edgesV)
+{
+  assert(cmr);
+  assert(graph);
+  assert(numEdges == 0 || (edgesU && edgesV));
+
+  CMRdbgMsg(0, "CMRgraphAssignEdges(|V|=%zu, |E|=%zu).\n", numNodes, numEdges);
+
+  if (graph->memNodes < numNodes)
+  {
+    CMR_CALL( CMRreallocBlockArray(cmr, &graph->nodes, numNodes) );
+    graph->memNodes = numNodes;
+  }
+  if (graph->memEdges < numEdges)
+  {
+    CMR_CALL( CMRreallocBlockArray(cmr, &graph->arcs, 2 * numEdges) );
+    graph->memEdges = numEdges;
+  }
+
+  /* Like repeated calls to CMRgraphAddNode, the list of nodes is n-1, ..., 1, 0. */
+  graph->numNodes = numNodes;
+  graph->firstNode = numNodes > 0 ? (CMR_GRAPH_NODE) numNodes - 1 : -1;
+  for (size_t v = 0; v < numNodes; ++v)
+  {
+    graph->nodes[v].firstOut = -1;
+    graph->nodes[v].prev = (v + 1 < numNodes) ? (CMR_GRAPH_NODE) v + 1 : -1;
+    graph->nodes[v].next = (CMR_GRAPH_NODE) v - 1;
+  }
+  graph->freeNode = (numNodes < graph->memNodes) ? (CMR_GRAPH_NODE) numNodes : -1;
+  for (size_t v = numNodes; v < graph->memNodes; ++v)
+    graph->nodes[v].next = (v + 1 < graph->memNodes) ? (CMR_GRAPH_NODE) v + 1 : -1;
+
+  /* Prepending the arcs in increasing order yields the same incidence lists as repeated calls to CMRgraphAddEdge. */
+  graph->numEdges = numEdges;
+  for (size_t e = 0; e < numEdges; ++e)
+  {
+    CMR_GRAPH_NODE u = edgesU[e];
+    CMR_GRAPH_NODE v = edgesV[e];
+    assert(u >= 0 && (size_t) u < numNodes);
+    assert(v >= 0 && (size_t) v < numNodes);
+
+    int arc = 2 * e;
+    graph->arcs[arc].target = v;
+    graph->arcs[arc].prev = -1;
+    graph->arcs[arc].next = graph->nodes[u].firstOut;
+    if (isValid(graph->nodes[u].firstOut))
+      graph->arcs[graph->nodes[u].firstOut].prev = arc;
+    graph->nodes[u].firstOut = arc;
+
+    ++arc;
+    graph->arcs[arc].target = u;
+    graph->arcs[arc].prev = -1;
+    graph->arcs[arc].next = graph->nodes[v].firstOut;
+    if (isValid(graph->nodes[v].firstOut))
+      graph->arcs[graph->nodes[v].firstOut].prev = arc;
+    graph->nodes[v].firstOut = arc;
+  }
+  graph->freeEdge = (numEdges < graph->memEdges) ? (CMR_GRAPH_EDGE) numEdges : -1;
+  for (size_t e = numEdges; e < graph->memEdges; ++e)
+    graph->arcs[2*e].next = (e + 1 < graph->memEdges) ? (int) e + 1 : -1;
+
+#if defined(CMR_DEBUG_CONSISTENCY)
+  CMRgraphEnsureConsistent(cmr, graph);
+#endif /* CMR_DEBUG_CONSISTENCY */
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgraphCreateFromEdges(CMR* cmr, CMR_GRAPH** pgraph, size_t numNodes, size_t numEdges,
+  const CMR_GRAPH_NODE* edgesU, const CMR_GRAPH_NODE* edgesV)
+{
+  assert(cmr);
+  assert(pgraph);
+
+  CMR_CALL( CMRgraphCreateEmpty(cmr, pgraph, (int) numNodes, (int) numEdges) );
+  CMR_CALL( CMRgraphAssignEdges(cmr, *pgraph, numNodes, numEdges, edgesU, edgesV) );
+
+  return CMR_OKAY;
+}
+
 CMR_ERROR CMRgraphAddNode(CMR* cmr, CMR_GRAPH *graph, CMR_GRAPH_NODE* pnode)
 {
   assert(cmr);
@@ -427,6 +508,100 @@ CMR_ERROR CMRgraphMergeNodes(CMR* cmr, CMR_GRAPH* graph, CMR_GRAPH_NODE u, CMR_G
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRgraphFreeze(CMR* cmr, CMR_GRAPH* graph, CMR_GRAPH_FROZEN** pfrozen)
+{
+  assert(cmr);
+  assert(graph);
+  assert(pfrozen);
+
+  CMR_CALL( CMRallocBlock(cmr, pfrozen) );
+  CMR_GRAPH_FROZEN* frozen = *pfrozen;
+  size_t memNodes = graph->memNodes;
+  int memArcs = 2 * graph->memEdges;
+  frozen->memNodes = memNodes;
+  frozen->nodesFirst = NULL;
+  frozen->incidences = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &frozen->nodesFirst, memNodes + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &frozen->incidences, 2 * graph->numEdges + 1) );
+
+  /* Mark the arcs of edges in the free list. */
+  bool* arcsFree = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &arcsFree, memArcs + 1) );
+  for (int a = 0; a < memArcs; ++a)
+    arcsFree[a] = false;
+  for (CMR_GRAPH_EDGE e = graph->freeEdge; isValid(e); e = graph->arcs[2*e].next)
+  {
+    arcsFree[2*e] = true;
+    arcsFree[2*e + 1] = true;
+  }
+
+  /* Count the incidences of each node, skipping the second arcs of loops like CMRgraphIncFirst does. */
+  for (size_t v = 0; v <= memNodes; ++v)
+    frozen->nodesFirst[v] = 0;
+  bool isDecreasing = true;
+  for (int a = 0; a < memArcs; ++a)
+  {
+    if (arcsFree[a] || ((a & 0x1) && graph->arcs[a].target == graph->arcs[a ^ 1].target))
+      continue;
+    frozen->nodesFirst[graph->arcs[a ^ 1].target + 1]++;
+    if (graph->arcs[a].next > a)
+      isDecreasing = false;
+  }
+  for (size_t v = 0; v < memNodes; ++v)
+    frozen->nodesFirst[v + 1] += frozen->nodesFirst[v];
+
+  if (isDecreasing)
+  {
+    /* Every incidence list is sorted by decreasing arcs, so we distribute the arcs in that order. */
+    size_t* positions = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &positions, memNodes + 1) );
+    for (size_t v = 0; v < memNodes; ++v)
+      positions[v] = frozen->nodesFirst[v];
+    for (int a = memArcs - 1; a >= 0; --a)
+    {
+      if (arcsFree[a] || ((a & 0x1) && graph->arcs[a].target == graph->arcs[a ^ 1].target))
+        continue;
+      CMR_GRAPH_FROZEN_INC* incidence = &frozen->incidences[positions[graph->arcs[a ^ 1].target]++];
+      incidence->arc = a;
+      incidence->target = graph->arcs[a].target;
+    }
+    CMR_CALL( CMRfreeStackArray(cmr, &positions) );
+  }
+  else
+  {
+    for (CMR_GRAPH_NODE v = CMRgraphNodesFirst(graph); CMRgraphNodesValid(graph, v); v = CMRgraphNodesNext(graph, v))
+    {
+      size_t position = frozen->nodesFirst[v];
+      for (CMR_GRAPH_ITER i = CMRgraphIncFirst(graph, v); CMRgraphIncValid(graph, i); i = CMRgraphIncNext(graph, i))
+      {
+        frozen->incidences[position].arc = i;
+        frozen->incidences[position].target = CMRgraphIncTarget(graph, i);
+        ++position;
+      }
+      assert(position == frozen->nodesFirst[v + 1]);
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &arcsFree) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgraphFrozenFree(CMR* cmr, CMR_GRAPH_FROZEN** pfrozen)
+{
+  assert(pfrozen);
+
+  CMR_GRAPH_FROZEN* frozen = *pfrozen;
+  if (!frozen)
+    return CMR_OKAY;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &frozen->incidences) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &frozen->nodesFirst) );
+  CMR_CALL( CMRfreeBlock(cmr, pfrozen) );
+
+  return CMR_OKAY;
+}
+
 CMR_ERROR CMRgraphCreateFromEdgeList(CMR* cmr, CMR_GRAPH** pgraph, CMR_ELEMENT** pedgeElements, char*** pnodeLabels,
   FILE* stream)
 {
@@ -2,20 +2,22 @@
 // #define CMR_DEBUG_DOT /* Uncomment to write dot files of t-decompositions. */
 // #define CMR_DEBUG_CONSISTENCY /* Uncomment to check consistency of t-decompositions. */
 
-#include <cmr/graphic.h>
+#include "graphic_internal.h"
 
 #include "env_internal.h"
 #include "matrix_internal.h"
 #include "block_decomposition.h"
-#include "heap.h"
 #include "sort.h"
 #include "hereditary_property.h"
+#include "deadline.h"
+#include "threads.h"
+#include "counters.h"
 
 #include <assert.h>
 #include <limits.h>
 #include <stdlib.h>
 #include <stdint.h>
-#include <time.h>
+#include <string.h>
 
 #define SWAP_INTS(a, b) \
   do \
@@ -38,6 +40,8 @@ CMR_ERROR CMRgraphicStatsInit(CMR_GRAPHIC_STATISTICS* stats)
   stats->applyTime = 0.0;
   stats->transposeCount = 0;
   stats->transposeTime = 0.0;
+  CMRcountersInit(&stats->checkCounters);
+  CMRcountersInit(&stats->applyCounters);
 
   return CMR_OKAY;
 }
@@ -55,56 +59,226 @@ CMR_ERROR CMRgraphicStatsPrint(FILE* stream, CMR_GRAPHIC_STATISTICS* stats, cons
   fprintf(stream, "%stranspositions: %lu in %f seconds\n", prefix, (unsigned long)stats->transposeCount,
     stats->transposeTime);
   fprintf(stream, "%scolumn checks: %lu in %f seconds\n", prefix, (unsigned long)stats->checkCount, stats->checkTime);
+  CMRcountersPrint(stream, &stats->checkCounters, prefix, "column checks");
   fprintf(stream, "%scolumn additions: %lu in %f seconds\n", prefix, (unsigned long)stats->applyCount,
     stats->applyTime);
+  CMRcountersPrint(stream, &stats->applyCounters, prefix, "column additions");
   fprintf(stream, "%stotal: %lu in %f seconds\n", prefix, (unsigned long)stats->totalCount, stats->totalTime);
 
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRgraphicStatsPrintJson(FILE* stream, CMR_GRAPHIC_STATISTICS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"transpositions\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->transposeCount,
+    stats->transposeTime);
+  fprintf(stream, ",\"column-checks\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->checkCount,
+    stats->checkTime);
+  fprintf(stream, ",\"column-additions\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->applyCount,
+    stats->applyTime);
+  fprintf(stream, ",\"total\":{\"count\":%lu,\"time\":%.9g}}", (unsigned long)stats->totalCount, stats->totalTime);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgraphicStatsAdd(CMR_GRAPHIC_STATISTICS* target, CMR_GRAPHIC_STATISTICS* source)
+{
+  assert(target);
+  assert(source);
+
+  target->totalCount += source->totalCount;
+  target->totalTime += source->totalTime;
+  target->checkCount += source->checkCount;
+  target->checkTime += source->checkTime;
+  target->applyCount += source->applyCount;
+  target->applyTime += source->applyTime;
+  target->transposeCount += source->transposeCount;
+  target->transposeTime += source->transposeTime;
+  CMRcountersAdd(&target->checkCounters, &source->checkCounters);
+  CMRcountersAdd(&target->applyCounters, &source->applyCounters);
+
+  return CMR_OKAY;
+}
+
 typedef enum
 {
   UNKNOWN = 0,    /**< \brief The node was not considered by the shortest-path, yet. */
   SEEN = 1,       /**< \brief Some path to the node is known. */
   COMPLETED = 2,  /**< \brief The shortest path to the node is known. */
   BASIC = 3,      /**< \brief The rootEdge of that node belongs to the spanning forest. */
-} DIJKSTRA_STAGE;
+} SEARCH_STAGE;
 
 /**
- * \brief Node information for shortest-path computation in \ref CMRcomputeRepresentationMatrix().
+ * \brief Node information for the shortest-path computation in \ref CMRcomputeRepresentationMatrix().
  */
 
 typedef struct
 {
-  DIJKSTRA_STAGE stage;     /**< \brief At which stage of the algorithm is this node? */
+  SEARCH_STAGE stage;       /**< \brief At which stage of the algorithm is this node? */
   int predecessor;          /**< \brief Predecessor node in shortest-path branching, or -1 for a root. */
   CMR_GRAPH_EDGE rootEdge;  /**< \brief The actual edge towards the predecessor, or -1 for a root./ */
   bool reversed;            /**< \brief Whether the edge towards the predecessor is reversed. */
-} DijkstraNodeData;
+  int distance;             /**< \brief Number of non-forest edges on the known path to the root. */
+  int depth;                /**< \brief Number of edges on the path to the root in the branching. */
+} SearchNodeData;
 
-CMR_ERROR CMRcomputeRepresentationMatrix(CMR* cmr, CMR_GRAPH* digraph, bool ternary, CMR_CHRMAT** ptranspose,
-  bool* arcsReversed, int numForestArcs, CMR_GRAPH_EDGE* forestArcs, int numCoforestArcs, CMR_GRAPH_EDGE* coforestArcs,
-  bool* pisCorrectForest)
+/**
+ * \brief Returns a pseudo-random priority of the edge from \p v to \p w for breaking ties between shortest paths.
+ *
+ * Always choosing the first shortest path found leads to long fundamental cycles, e.g., in grid graphs.
+ */
+
+static inline
+uint32_t searchTiePriority(
+  CMR_GRAPH_NODE v, /**< Predecessor node. */
+  CMR_GRAPH_NODE w  /**< Node. */
+)
+{
+  uint64_t hash = ((uint64_t) (uint32_t) v << 32) | (uint32_t) w;
+  hash *= UINT64_C(0x9E3779B97F4A7C15);
+  return (uint32_t) (hash >> 32);
+}
+
+#define REPRESENTATION_WORKER_COLUMNS 4096 /**< Minimum number of columns per worker for computing a representation
+                                            **< matrix in parallel. */
+
+/**
+ * \brief Data shared by the workers that compute the columns of a representation matrix.
+ */
+
+typedef struct
+{
+  CMR_GRAPH* digraph;           /**< \brief Digraph. */
+  bool ternary;                 /**< \brief Whether we need to compute correct signs. */
+  bool* arcsReversed;           /**< \brief Indicates, for each edge, whether it is reversed (may be \c NULL). */
+  SearchNodeData* nodeData;     /**< \brief Node data of the spanning forest. */
+  CMR_GRAPH_NODE* nodesRows;    /**< \brief Maps each non-root node to the row of the edge towards its predecessor. */
+  char* nodesReversed;          /**< \brief Maps each non-root node to the sign of the edge towards its predecessor. */
+  size_t numColumns;            /**< \brief Number of columns. */
+  CMR_GRAPH_EDGE* columnEdges;  /**< \brief Maps each column to its edge. */
+  size_t numWorkers;            /**< \brief Number of workers. */
+  size_t* columnSlice;          /**< \brief First, the length of each column's path; then, the first entry of each
+                                 **< column. */
+  CMR_CHRMAT* transpose;        /**< \brief Transpose of the representation matrix, or \c NULL while counting. */
+} RepresentationColumns;
+
+/**
+ * \brief Walks along the fundamental cycle of the edge of \p column.
+ *
+ * The tree path is walked from both end nodes up to their least common ancestor, which takes time linear in its
+ * length. If \p transpose is not \c NULL, the nonzeros are stored in its arrays starting at \p firstEntry.
+ *
+ * \returns The number of edges on the path.
+ */
+
+static
+size_t representationWalkColumn(
+  RepresentationColumns* columns, /**< Data of the representation matrix. */
+  size_t column,                  /**< Column. */
+  CMR_CHRMAT* transpose,          /**< Transpose for storing the nonzeros (may be \c NULL). */
+  size_t firstEntry               /**< First entry of \p transpose to use. */
+)
+{
+  SearchNodeData* nodeData = columns->nodeData;
+  CMR_GRAPH_EDGE e = columns->columnEdges[column];
+  CMR_GRAPH_NODE u = CMRgraphEdgeU(columns->digraph, e);
+  CMR_GRAPH_NODE v = CMRgraphEdgeV(columns->digraph, e);
+  if (columns->arcsReversed && columns->arcsReversed[e])
+    SWAP_INTS(u, v);
+
+  size_t entry = firstEntry;
+  while (u != v)
+  {
+    /* Advance the deeper node, which cannot be the least common ancestor. */
+    if (nodeData[u].depth >= nodeData[v].depth)
+    {
+      assert(nodeData[u].predecessor >= 0);
+      if (transpose)
+      {
+        assert(columns->nodesRows[u] >= 0);
+        transpose->entryColumns[entry] = columns->nodesRows[u];
+        transpose->entryValues[entry] = columns->ternary ? -columns->nodesReversed[u] : 1;
+      }
+      u = nodeData[u].predecessor;
+    }
+    else
+    {
+      assert(nodeData[v].predecessor >= 0);
+      if (transpose)
+      {
+        assert(columns->nodesRows[v] >= 0);
+        transpose->entryColumns[entry] = columns->nodesRows[v];
+        transpose->entryValues[entry] = columns->ternary ? columns->nodesReversed[v] : 1;
+      }
+      v = nodeData[v].predecessor;
+    }
+    ++entry;
+  }
+
+  return entry - firstEntry;
+}
+
+/**
+ * \brief Counts the nonzeros or creates the nonzeros of the columns of a worker.
+ */
+
+static
+CMR_ERROR representationColumnsWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref RepresentationColumns. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  RepresentationColumns* columns = (RepresentationColumns*) data;
+  size_t first = columns->numColumns * worker / columns->numWorkers;
+  size_t beyond = columns->numColumns * (worker + 1) / columns->numWorkers;
+  for (size_t column = first; column < beyond; ++column)
+  {
+    if (columns->transpose)
+    {
+      size_t length = representationWalkColumn(columns, column, columns->transpose, columns->columnSlice[column]);
+      CMR_UNUSED(length);
+      assert(length == columns->columnSlice[column + 1] - columns->columnSlice[column]);
+    }
+    else
+      columns->columnSlice[column] = representationWalkColumn(columns, column, NULL, 0);
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRcomputeRepresentationMatrix(CMR* cmr, CMR_GRAPH* digraph, bool ternary, CMR_CHRMAT** pmatrix,
+  CMR_CHRMAT** ptranspose, bool* arcsReversed, int numForestArcs, CMR_GRAPH_EDGE* forestArcs, int numCoforestArcs,
+  CMR_GRAPH_EDGE* coforestArcs, bool* pisCorrectForest)
 {
   assert(cmr);
   assert(digraph);
-  assert(ptranspose && !*ptranspose);
+  assert(pmatrix || ptranspose);
+  assert(!pmatrix || !*pmatrix);
+  assert(!ptranspose || !*ptranspose);
   assert(numForestArcs == 0 || forestArcs);
   assert(numForestArcs == 0 || coforestArcs);
   CMRassertStackConsistency(cmr);
 
   CMRdbgMsg(0, "Computing %s representation matrix.\n", ternary ? "ternary" : "binary");
 
-  DijkstraNodeData* nodeData = NULL;
+  SearchNodeData* nodeData = NULL;
   CMR_CALL( CMRallocStackArray(cmr, &nodeData, CMRgraphMemNodes(digraph)) );
-  CMR_INTHEAP heap;
-  CMR_CALL( CMRintheapInitStack(cmr, &heap, CMRgraphMemNodes(digraph)) );
+  CMR_GRAPH_NODE* queues[2] = { NULL, NULL }; /* Queues for the current and the next distance, swapped in turn. */
+  CMR_CALL( CMRallocStackArray(cmr, &queues[0], CMRgraphMemNodes(digraph)) );
+  CMR_CALL( CMRallocStackArray(cmr, &queues[1], CMRgraphMemNodes(digraph)) );
   int* lengths = NULL;
   CMR_CALL( CMRallocStackArray(cmr, &lengths, CMRgraphMemEdges(digraph)) );
   for (CMR_GRAPH_NODE v = CMRgraphNodesFirst(digraph); CMRgraphNodesValid(digraph, v);
     v = CMRgraphNodesNext(digraph, v))
   {
     nodeData[v].stage = UNKNOWN;
+    nodeData[v].distance = INT_MAX;
   }
   for (CMR_GRAPH_ITER i = CMRgraphEdgesFirst(digraph); CMRgraphEdgesValid(digraph, i);
     i = CMRgraphEdgesNext(digraph, i))
@@ -124,7 +298,11 @@ CMR_ERROR CMRcomputeRepresentationMatrix(CMR* cmr, CMR_GRAPH* digraph, bool tern
 
   CMRassertStackConsistency(cmr);
 
-  /* Start Dijkstra's algorithm at each node. */
+  /* Start a breadth-first search at each node. Since all lengths are 0 or 1, the nodes at distance d are processed
+   * from one queue, to which nodes reached via forest edges are appended, while those reached via other edges are
+   * collected in the queue for distance d+1. */
+  CMR_GRAPH_FROZEN* frozen = NULL;
+  CMR_CALL( CMRgraphFreeze(cmr, digraph, &frozen) );
   int countComponents = 0;
   for (CMR_GRAPH_NODE s = CMRgraphNodesFirst(digraph); CMRgraphNodesValid(digraph, s);
     s = CMRgraphNodesNext(digraph, s))
@@ -132,48 +310,81 @@ CMR_ERROR CMRcomputeRepresentationMatrix(CMR* cmr, CMR_GRAPH* digraph, bool tern
     if (nodeData[s].stage != UNKNOWN)
       continue;
 
-    CMRdbgMsg(2, "Executing Dijkstra at starting node %d.\n", s);
+    CMRdbgMsg(2, "Executing breadth-first search at starting node %d.\n", s);
+    nodeData[s].stage = SEEN;
     nodeData[s].predecessor = -1;
     nodeData[s].rootEdge = -1;
+    nodeData[s].distance = 0;
     ++countComponents;
-    CMRintheapInsert(&heap, s, 0);
-    while (!CMRintheapEmpty(&heap))
+    CMR_GRAPH_NODE* queue = queues[0];
+    CMR_GRAPH_NODE* nextQueue = queues[1];
+    size_t queueLength = 1;
+    queue[0] = s;
+    for (int distance = 0; queueLength > 0; ++distance)
     {
-      int distance = CMRintheapMinimumValue(&heap);
-      CMR_GRAPH_NODE v = CMRintheapExtractMinimum(&heap);
-      CMRdbgMsg(4, "Processing node %d at distance %d.\n", v, distance);
-      nodeData[v].stage = COMPLETED;
-      for (CMR_GRAPH_ITER i = CMRgraphIncFirst(digraph, v); CMRgraphIncValid(digraph, i);
-        i = CMRgraphIncNext(digraph, i))
+      size_t nextQueueLength = 0;
+      for (size_t q = 0; q < queueLength; ++q)
       {
-        assert(CMRgraphIncSource(digraph, i) == v);
-        CMR_GRAPH_NODE w = CMRgraphIncTarget(digraph, i);
+        CMR_GRAPH_NODE v = queue[q];
 
-        /* Skip if already completed. */
-        if (nodeData[w].stage == COMPLETED)
+        /* Skip if reached via forest edges before being processed at a larger distance. */
+        if (nodeData[v].stage == COMPLETED)
           continue;
 
-        CMR_GRAPH_EDGE e = CMRgraphIncEdge(digraph, i);
-        int newDistance = distance + lengths[e];
-        if (newDistance < CMRintheapGetValueInfinity(&heap, w))
+        CMRdbgMsg(4, "Processing node %d at distance %d.\n", v, distance);
+        assert(nodeData[v].distance == distance);
+        nodeData[v].stage = COMPLETED;
+        nodeData[v].depth = nodeData[v].predecessor >= 0 ? nodeData[nodeData[v].predecessor].depth + 1 : 0;
+        for (size_t i = CMRgraphFrozenIncFirst(frozen, v); i < CMRgraphFrozenIncBeyond(frozen, v); ++i)
         {
-          CMRdbgMsg(6, "Updating distance of (%d,%d) from %d to %d.\n", v, w, CMRintheapGetValueInfinity(&heap, w),
-            newDistance);
-          nodeData[w].stage = SEEN;
-          nodeData[w].predecessor = v;
-          nodeData[w].rootEdge = e;
-          nodeData[w].reversed = arcsReversed ? arcsReversed[e] : false;
-          if (w == CMRgraphEdgeU(digraph, e))
-            nodeData[w].reversed = !nodeData[w].reversed;
-          CMRintheapDecreaseInsert(&heap, w, newDistance);
+          CMR_GRAPH_NODE w = CMRgraphFrozenIncTarget(frozen, i);
+
+          /* Skip if already completed. */
+          if (nodeData[w].stage == COMPLETED)
+            continue;
+
+          CMR_GRAPH_EDGE e = CMRgraphFrozenIncEdge(frozen, i);
+          int newDistance = distance + lengths[e];
+          if (newDistance < nodeData[w].distance)
+          {
+            CMRdbgMsg(6, "Updating distance of (%d,%d) from %d to %d.\n", v, w, nodeData[w].distance, newDistance);
+            nodeData[w].stage = SEEN;
+            nodeData[w].predecessor = v;
+            nodeData[w].rootEdge = e;
+            nodeData[w].reversed = arcsReversed ? arcsReversed[e] : false;
+            if (w == CMRgraphEdgeU(digraph, e))
+              nodeData[w].reversed = !nodeData[w].reversed;
+            nodeData[w].distance = newDistance;
+            if (newDistance == distance)
+              queue[queueLength++] = w;
+            else
+              nextQueue[nextQueueLength++] = w;
+          }
+          else if (newDistance == nodeData[w].distance && lengths[e] && lengths[nodeData[w].rootEdge]
+            && searchTiePriority(v, w) < searchTiePriority(nodeData[w].predecessor, w))
+          {
+            /* Another shortest path via a non-forest edge. */
+            nodeData[w].predecessor = v;
+            nodeData[w].rootEdge = e;
+            nodeData[w].reversed = arcsReversed ? arcsReversed[e] : false;
+            if (w == CMRgraphEdgeU(digraph, e))
+              nodeData[w].reversed = !nodeData[w].reversed;
+          }
         }
       }
+
+      CMR_GRAPH_NODE* temp = queue;
+      queue = nextQueue;
+      nextQueue = temp;
+      queueLength = nextQueueLength;
     }
   }
 
+  CMR_CALL( CMRgraphFrozenFree(cmr, &frozen) );
   CMRassertStackConsistency(cmr);
   CMR_CALL( CMRfreeStackArray(cmr, &lengths) );
-  CMR_CALL( CMRintheapClearStack(cmr, &heap) );
+  CMR_CALL( CMRfreeStackArray(cmr, &queues[1]) );
+  CMR_CALL( CMRfreeStackArray(cmr, &queues[0]) );
 
   /* Now nodeData[.].predecessor is an arborescence for each connected component. */
 
@@ -242,11 +453,10 @@ CMR_ERROR CMRcomputeRepresentationMatrix(CMR* cmr, CMR_GRAPH* digraph, bool tern
 
   CMRassertStackConsistency(cmr);
 
-  CMR_CALL( CMRchrmatCreate(cmr, ptranspose, CMRgraphNumEdges(digraph) - numRows, numRows,
-    16 * numRows) );
-  CMR_CHRMAT* transpose = *ptranspose;
-  size_t numNonzeros = 0; /* Current number of nonzeros. transpose->numNonzeros is the memory. */
+  /* Determine the order of the columns. */
   size_t numColumns = 0;
+  CMR_GRAPH_EDGE* columnEdges = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnEdges, CMRgraphNumEdges(digraph) - numRows) );
   CMR_GRAPH_EDGE* edgeColumns = NULL;
   CMR_CALL( CMRallocStackArray(cmr, &edgeColumns, CMRgraphMemEdges(digraph)) );
   for (CMR_GRAPH_ITER i = CMRgraphEdgesFirst(digraph); CMRgraphEdgesValid(digraph, i);
@@ -258,10 +468,6 @@ CMR_ERROR CMRcomputeRepresentationMatrix(CMR* cmr, CMR_GRAPH* digraph, bool tern
     edgeColumns[CMRgraphEdgesEdge(digraph, i)] =
       (nodeData[u].rootEdge == e || nodeData[v].rootEdge == e) ? -1 : -2;
   }
-  CMR_GRAPH_NODE* uPath = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &uPath, numRows) );
-  CMR_GRAPH_NODE* vPath = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &vPath, numRows) );
   CMR_GRAPH_ITER iter = CMRgraphEdgesFirst(digraph);
   int cobasicIndex = 0;
   while (CMRgraphEdgesValid(digraph, iter))
@@ -281,97 +487,75 @@ CMR_ERROR CMRcomputeRepresentationMatrix(CMR* cmr, CMR_GRAPH* digraph, bool tern
     if (edgeColumns[e] >= -1)
       continue;
 
-    CMR_GRAPH_NODE u = CMRgraphEdgeU(digraph, e);
-    CMR_GRAPH_NODE v = CMRgraphEdgeV(digraph, e);
-    if (arcsReversed && arcsReversed[e])
-      SWAP_INTS(u, v);
-    CMRdbgMsg(4, "Edge %d = (%d,%d) (including reverse)\n", e, u, v);
-
-    transpose->rowSlice[numColumns] = numNonzeros;
+    CMRdbgMsg(4, "Edge %d = {%d,%d} is column %zu.\n", e, CMRgraphEdgeU(digraph, e), CMRgraphEdgeV(digraph, e),
+      numColumns);
     edgeColumns[e] = numColumns;
-
-    /* Enlarge space for nonzeros if necessary. */
-    if (numNonzeros + numRows > transpose->numNonzeros)
-      CMR_CALL( CMRchrmatChangeNumNonzeros(cmr, transpose, 2 * transpose->numNonzeros) );
-
-    /* Compute u-root path. */
-    int uPathLength = 0;
-    CMR_GRAPH_NODE w = u;
-    while (nodeData[w].predecessor != -1)
-    {
-      uPath[uPathLength] = w;
-      ++uPathLength;
-      w = nodeData[w].predecessor;
-    }
-
-    /* Compute v-root path. */
-    int vPathLength = 0;
-    w = v;
-    while (nodeData[w].predecessor != -1)
-    {
-      vPath[vPathLength] = w;
-      ++vPathLength;
-      w = nodeData[w].predecessor;
-    }
-
-    /* Remove common part of u-root path and v-root path. */
-    while (uPathLength > 0 && vPathLength > 0 && uPath[uPathLength-1] == vPath[vPathLength-1])
-    {
-      --uPathLength;
-      --vPathLength;
-    }
-
-    /* Create nonzeros. */
-    for (int j = 0; j < uPathLength; ++j)
-    {
-      assert(nodesRows[uPath[j]] >= 0);
-      transpose->entryColumns[numNonzeros] = nodesRows[uPath[j]];
-      transpose->entryValues[numNonzeros] = ternary ? -nodesReversed[uPath[j]] : 1;
-      CMRdbgMsg(4, "u: row %d. nodesReversed = %d, result = %d\n", nodesRows[uPath[j]],
-        nodesReversed[uPath[j]], transpose->entryValues[numNonzeros]);
-      ++numNonzeros;
-    }
-    for (int j = 0; j < vPathLength; ++j)
-    {
-      assert(nodesRows[vPath[j]] >= 0);
-      transpose->entryColumns[numNonzeros] = nodesRows[vPath[j]];
-      transpose->entryValues[numNonzeros] = ternary ? nodesReversed[vPath[j]] : 1;
-      CMRdbgMsg(4, "v: row %d. nodesReversed = %d, result = %d\n", nodesRows[vPath[j]],
-        nodesReversed[vPath[j]], transpose->entryValues[numNonzeros]);
-      ++numNonzeros;
-    }
-
+    columnEdges[numColumns] = e;
     ++numColumns;
   }
-  transpose->rowSlice[numColumns] = numNonzeros;
-  transpose->numNonzeros = numNonzeros;
-
-  CMR_CALL( CMRchrmatSortNonzeros(cmr, transpose) );
-
-  CMRassertStackConsistency(cmr);
-
-  CMR_CALL( CMRfreeStackArray(cmr, &vPath) );
-  CMR_CALL( CMRfreeStackArray(cmr, &uPath) );
   CMR_CALL( CMRfreeStackArray(cmr, &edgeColumns) );
 
-  if (numNonzeros == 0 && transpose->numNonzeros > 0)
+  /* Compute the columns, which are independent given the spanning forest, first counting and then creating the
+   * nonzeros. */
+  RepresentationColumns columns;
+  columns.digraph = digraph;
+  columns.ternary = ternary;
+  columns.arcsReversed = arcsReversed;
+  columns.nodeData = nodeData;
+  columns.nodesRows = nodesRows;
+  columns.nodesReversed = nodesReversed;
+  columns.numColumns = numColumns;
+  columns.columnEdges = columnEdges;
+  columns.numWorkers = CMRthreadsNumWorkers(cmr, numColumns / REPRESENTATION_WORKER_COLUMNS + 1);
+  columns.columnSlice = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columns.columnSlice, numColumns + 1) );
+  columns.transpose = NULL;
+  CMR_CALL( CMRthreadsRun(cmr, columns.numWorkers, representationColumnsWorker, &columns) );
+
+  size_t numNonzeros = 0;
+  for (size_t column = 0; column < numColumns; ++column)
   {
-    CMR_CALL( CMRfreeBlockArray(cmr, &transpose->entryColumns) );
-    CMR_CALL( CMRfreeBlockArray(cmr, &transpose->entryValues) );
+    size_t length = columns.columnSlice[column];
+    columns.columnSlice[column] = numNonzeros;
+    numNonzeros += length;
   }
-  transpose->numNonzeros = numNonzeros;
+  columns.columnSlice[numColumns] = numNonzeros;
 
-  /* We now process the nonbasic edges. */
+  CMR_CHRMAT* transpose = NULL;
+  CMR_CALL( CMRchrmatCreate(cmr, &transpose, numColumns, numRows, numNonzeros) );
+  for (size_t column = 0; column <= numColumns; ++column)
+    transpose->rowSlice[column] = columns.columnSlice[column];
+  columns.transpose = transpose;
+  CMR_CALL( CMRthreadsRun(cmr, columns.numWorkers, representationColumnsWorker, &columns) );
 
   CMRassertStackConsistency(cmr);
+
+  CMR_CALL( CMRfreeStackArray(cmr, &columns.columnSlice) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnEdges) );
   CMR_CALL( CMRfreeStackArray(cmr, &nodesReversed) );
-  CMRassertStackConsistency(cmr);
   CMR_CALL( CMRfreeStackArray(cmr, &nodesRows) );
-  CMRassertStackConsistency(cmr);
   CMR_CALL( CMRfreeStackArray(cmr, &nodeData) );
 
   CMRassertStackConsistency(cmr);
 
+  /* The rows of a transpose are always sorted, so the matrix is obtained by one pass over the nonzeros. */
+  if (pmatrix)
+  {
+    CMR_CALL( CMRchrmatCreate(cmr, pmatrix, numRows, numColumns, numNonzeros) );
+    CMR_CALL( CMRmatrixTransposeInto(cmr, (CMR_MATRIX*) transpose, sizeof(char), (CMR_MATRIX*) *pmatrix) );
+  }
+
+  if (ptranspose)
+  {
+    if (pmatrix)
+      CMR_CALL( CMRmatrixTransposeInto(cmr, (CMR_MATRIX*) *pmatrix, sizeof(char), (CMR_MATRIX*) transpose) );
+    else
+      CMR_CALL( CMRchrmatSortNonzeros(cmr, transpose) );
+    *ptranspose = transpose;
+  }
+  else
+    CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+
   return CMR_OKAY;
 }
 
@@ -385,18 +569,184 @@ CMR_ERROR CMRgraphicComputeMatrix(CMR* cmr, CMR_GRAPH* graph, CMR_CHRMAT** pmatr
   assert(!pmatrix || !*pmatrix);
   assert(!ptranspose || !*ptranspose);
 
-  CMR_CHRMAT* transpose = NULL;
-  CMR_CALL( CMRcomputeRepresentationMatrix(cmr, graph, false, &transpose, NULL, numForestEdges, forestEdges,
-    numCoforestEdges, coforestEdges, pisCorrectForest) );
+  CMR_CALL( CMRcomputeRepresentationMatrix(cmr, graph, false, pmatrix, ptranspose, NULL, numForestEdges,
+    forestEdges, numCoforestEdges, coforestEdges, pisCorrectForest) );
 
-  if (pmatrix)
-    CMR_CALL( CMRchrmatTranspose(cmr, transpose, pmatrix) );
+  return CMR_OKAY;
+}
 
-  /* Return or free the transpose matrix. */
-  if (ptranspose)
-    *ptranspose = transpose;
-  else
-    CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+CMR_ERROR CMRgraphicVerifyMatrix(CMR* cmr, CMR_CHRMAT* matrix, CMR_GRAPH* graph, CMR_GRAPH_EDGE* forestEdges,
+  CMR_GRAPH_EDGE* coforestEdges, bool* pisGraphic)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(graph);
+  assert(forestEdges);
+  assert(coforestEdges);
+  assert(pisGraphic);
+
+  CMRassertStackConsistency(cmr);
+
+  *pisGraphic = false;
+  if (matrix->numRows + matrix->numColumns != CMRgraphNumEdges(graph))
+    return CMR_OKAY;
+
+  /* Map edges to rows and columns of M; every edge must appear exactly once. */
+  size_t memEdges = CMRgraphMemEdges(graph);
+  size_t* edgesElement = NULL; /* Row r is stored as r, column c as numRows + c. */
+  CMR_CALL( CMRallocStackArray(cmr, &edgesElement, memEdges) );
+  for (size_t e = 0; e < memEdges; ++e)
+    edgesElement[e] = SIZE_MAX;
+  bool isValid = true;
+  for (size_t element = 0; element < matrix->numRows + matrix->numColumns && isValid; ++element)
+  {
+    CMR_GRAPH_EDGE e = (element < matrix->numRows) ? forestEdges[element] : coforestEdges[element - matrix->numRows];
+    if (e < 0 || (size_t) e >= memEdges || edgesElement[e] != SIZE_MAX)
+      isValid = false;
+    else
+      edgesElement[e] = element;
+  }
+
+  /* Root the forest T in every component via a depth-first search along forest edges, detecting cycles. */
+  size_t memNodes = CMRgraphMemNodes(graph);
+  size_t* nodesDepth = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &nodesDepth, memNodes) );
+  CMR_GRAPH_EDGE* nodesParentEdge = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &nodesParentEdge, memNodes) );
+  CMR_GRAPH_NODE* nodesRoot = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &nodesRoot, memNodes) );
+  CMR_GRAPH_NODE* queue = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &queue, memNodes) );
+  for (size_t v = 0; v < memNodes; ++v)
+    nodesDepth[v] = SIZE_MAX;
+  for (CMR_GRAPH_NODE s = CMRgraphNodesFirst(graph); isValid && CMRgraphNodesValid(graph, s);
+    s = CMRgraphNodesNext(graph, s))
+  {
+    if (nodesDepth[s] != SIZE_MAX)
+      continue;
+
+    nodesDepth[s] = 0;
+    nodesParentEdge[s] = -1;
+    nodesRoot[s] = s;
+    size_t queueLength = 1;
+    queue[0] = s;
+    while (queueLength > 0 && isValid)
+    {
+      CMR_GRAPH_NODE v = queue[--queueLength];
+      for (CMR_GRAPH_ITER i = CMRgraphIncFirst(graph, v); CMRgraphIncValid(graph, i); i = CMRgraphIncNext(graph, i))
+      {
+        CMR_GRAPH_EDGE e = CMRgraphIncEdge(graph, i);
+        if (edgesElement[e] >= matrix->numRows || e == nodesParentEdge[v])
+          continue;
+
+        CMR_GRAPH_NODE w = CMRgraphIncTarget(graph, i);
+        if (nodesDepth[w] != SIZE_MAX)
+        {
+          /* The forest edge closes a cycle. */
+          isValid = false;
+          break;
+        }
+        nodesDepth[w] = nodesDepth[v] + 1;
+        nodesParentEdge[w] = e;
+        nodesRoot[w] = s;
+        queue[queueLength++] = w;
+      }
+    }
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &queue) );
+
+  /* Compute all pairs (row, column) of fundamental cycles, bucketed by rows, stopping as soon as there are too many. */
+  size_t* pairsColumn = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &pairsColumn, matrix->numNonzeros) );
+  size_t* rowsFirstPair = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsFirstPair, matrix->numRows + 1) );
+  for (size_t row = 0; row <= matrix->numRows; ++row)
+    rowsFirstPair[row] = 0;
+  size_t numPairs = 0;
+  for (int pass = 0; pass < 2 && isValid; ++pass)
+  {
+    /* The first pass counts the pairs per row and the second one stores them. */
+    for (size_t column = 0; column < matrix->numColumns && isValid; ++column)
+    {
+      CMR_GRAPH_EDGE e = coforestEdges[column];
+      CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
+      CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
+      if (nodesRoot[u] != nodesRoot[v])
+      {
+        /* T is not a spanning forest. */
+        isValid = false;
+        break;
+      }
+
+      while (u != v)
+      {
+        if (nodesDepth[u] < nodesDepth[v])
+        {
+          CMR_GRAPH_NODE w = u;
+          u = v;
+          v = w;
+        }
+        CMR_GRAPH_EDGE f = nodesParentEdge[u];
+        size_t row = edgesElement[f];
+        if (pass == 0)
+        {
+          if (++numPairs > matrix->numNonzeros)
+          {
+            isValid = false;
+            break;
+          }
+          rowsFirstPair[row + 1]++;
+        }
+        else
+          pairsColumn[rowsFirstPair[row]++] = column;
+        u = (CMRgraphEdgeU(graph, f) == u) ? CMRgraphEdgeV(graph, f) : CMRgraphEdgeU(graph, f);
+      }
+    }
+
+    if (pass == 0)
+    {
+      if (numPairs != matrix->numNonzeros)
+        isValid = false;
+      for (size_t row = 0; row < matrix->numRows; ++row)
+        rowsFirstPair[row + 1] += rowsFirstPair[row];
+    }
+  }
+
+  /* Now the pairs of row r are those from rowsFirstPair[r-1] to rowsFirstPair[r]. Since there are as many pairs as
+   * nonzeros, it suffices to check that each pair is a nonzero of M. */
+  if (isValid)
+  {
+    size_t* columnsMark = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &columnsMark, matrix->numColumns) );
+    for (size_t column = 0; column < matrix->numColumns; ++column)
+      columnsMark[column] = SIZE_MAX;
+    for (size_t row = 0; row < matrix->numRows && isValid; ++row)
+    {
+      size_t first = (row == 0) ? 0 : rowsFirstPair[row - 1];
+      for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+        columnsMark[matrix->entryColumns[e]] = row;
+      for (size_t p = first; p < rowsFirstPair[row]; ++p)
+      {
+        if (columnsMark[pairsColumn[p]] != row)
+        {
+          isValid = false;
+          break;
+        }
+      }
+    }
+    CMR_CALL( CMRfreeStackArray(cmr, &columnsMark) );
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsFirstPair) );
+  CMR_CALL( CMRfreeStackArray(cmr, &pairsColumn) );
+  CMR_CALL( CMRfreeStackArray(cmr, &nodesRoot) );
+  CMR_CALL( CMRfreeStackArray(cmr, &nodesParentEdge) );
+  CMR_CALL( CMRfreeStackArray(cmr, &nodesDepth) );
+  CMR_CALL( CMRfreeStackArray(cmr, &edgesElement) );
+
+  CMRassertStackConsistency(cmr);
+
+  *pisGraphic = isValid;
 
   return CMR_OKAY;
 }
@@ -1280,6 +1630,46 @@ CMR_ERROR createMember(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Removes all members, edges, nodes, rows and columns of the decomposition \p dec but keeps its memory.
+ */
+
+static
+void decClear(
+  Dec* dec  /**< Decomposition. */
+)
+{
+  assert(dec);
+
+  dec->numMembers = 0;
+
+  dec->numNodes = 0;
+  for (size_t v = 0; v < dec->memNodes; ++v)
+    dec->nodes[v].representativeNode = v+1;
+  dec->nodes[dec->memNodes-1].representativeNode = SIZE_MAX;
+  dec->firstFreeNode = 0;
+
+  dec->numEdges = 0;
+  dec->numMarkerPairs = 0;
+  dec->parallelParentChildVisit = 0;
+
+  /* Initialize free list with unused edges. */
+  for (size_t e = 0; e < dec->memEdges; ++e)
+  {
+    dec->edges[e].next = e+1;
+    dec->edges[e].member = -1;
+  }
+  dec->edges[dec->memEdges-1].next = -1;
+  dec->firstFreeEdge = 0;
+
+  dec->numRows = 0;
+  dec->numColumns = 0;
+
+#if defined(CMR_DEBUG_CONSISTENCY)
+  CMRconsistencyAssert( decConsistency(dec) );
+#endif /* CMR_DEBUG_CONSISTENCY */
+}
+
 /**
  * \brief Creates an empty decomposition.
  */
@@ -1302,7 +1692,6 @@ CMR_ERROR decCreate(
   Dec* dec = *pdec;
   dec->cmr = cmr;
   dec->memMembers = memMembers;
-  dec->numMembers = 0;
   dec->members = NULL;
   CMR_CALL( CMRallocBlockArray(cmr, &dec->members, dec->memMembers) );
 
@@ -1311,71 +1700,67 @@ CMR_ERROR decCreate(
   dec->memNodes = memNodes;
   dec->nodes = NULL;
   CMR_CALL( CMRallocBlockArray(cmr, &dec->nodes, memNodes) );
-  dec->numNodes = 0;
-  for (size_t v = 0; v < memNodes; ++v)
-    dec->nodes[v].representativeNode = v+1;
-  dec->nodes[memNodes-1].representativeNode = SIZE_MAX;
-  dec->firstFreeNode = 0;
 
   if (memEdges < 1)
     memEdges = 1;
   dec->memEdges = memEdges;
   dec->edges = NULL;
   CMR_CALL( CMRallocBlockArray(cmr, &dec->edges, memEdges) );
-  dec->numEdges = 0;
-  dec->numMarkerPairs = 0;
-  dec->parallelParentChildVisit = 0;
-
-  /* Initialize free list with unused edges. */
-  if (memEdges > dec->numEdges)
-  {
-    for (size_t e = dec->numEdges; e < memEdges; ++e)
-    {
-      dec->edges[e].next = e+1;
-      dec->edges[e].member = -1;
-    }
-    dec->edges[memEdges-1].next = -1;
-    dec->firstFreeEdge = dec->numEdges;
-  }
-  else
-    dec->firstFreeEdge = -1;
 
-  dec->numRows = 0;
   dec->memRows = memRows;
   dec->rowEdges = NULL;
   CMR_CALL( CMRallocBlockArray(cmr, &dec->rowEdges, dec->memRows) );
-  for (size_t r = 0; r < dec->numRows; ++r)
-    dec->rowEdges[r].edge = -1;
 
-  dec->numColumns = 0;
   dec->memColumns = memColumns;
   dec->columnEdges = NULL;
   CMR_CALL( CMRallocBlockArray(cmr, &dec->columnEdges, dec->memColumns) );
-  for (size_t c = 0; c < dec->numColumns; ++c)
-    dec->columnEdges[c].edge = -1;
 
-#if defined(CMR_DEBUG_CONSISTENCY)
-  CMRconsistencyAssert( decConsistency(dec) );
-#endif /* CMR_DEBUG_CONSISTENCY */
+  decClear(dec);
 
   return CMR_OKAY;
 }
 
 /**
- * \brief Frees the decomposition \p *pdec.
+ * \brief Creates an empty decomposition whose memory suffices for adding all columns of a matrix.
+ *
+ * Every row and every column of the matrix (that appears in some nonzero) corresponds to one edge of the
+ * decomposition. The number of members and nodes is at most the number of these elements and each member has at most
+ * two marker edges, which is why there is no reallocation in most cases.
  */
 
-CMR_ERROR decFree(
-  Dec** pdec /**< Pointer to decomposition. */
+static
+CMR_ERROR decCreateForMatrix(
+  CMR* cmr,           /**< \ref CMR environment. */
+  Dec** pdec,         /**< Pointer to new decomposition. .*/
+  size_t numRows,     /**< Number of rows of the matrix. */
+  size_t numColumns,  /**< Number of columns of the matrix that will be added to the decomposition. */
+  size_t numNonzeros  /**< Number of nonzeros of the matrix. */
 )
 {
-  assert(pdec);
-  assert(*pdec);
+  size_t numElements = numRows + numColumns;
+  if (numElements > 2 * numNonzeros)
+    numElements = 2 * numNonzeros;
 
-  Dec* dec = *pdec;
-  CMR_CALL( CMRfreeBlockArray(dec->cmr, &dec->members) );
-  CMR_CALL( CMRfreeBlockArray(dec->cmr, &dec->edges) );
-  CMR_CALL( CMRfreeBlockArray(dec->cmr, &dec->nodes) );
+  CMR_CALL( decCreate(cmr, pdec, 3 * numElements + 16, numElements + 16, numElements + 16, numRows, numColumns) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Frees the decomposition \p *pdec.
+ */
+
+CMR_ERROR decFree(
+  Dec** pdec /**< Pointer to decomposition. */
+)
+{
+  assert(pdec);
+  assert(*pdec);
+
+  Dec* dec = *pdec;
+  CMR_CALL( CMRfreeBlockArray(dec->cmr, &dec->members) );
+  CMR_CALL( CMRfreeBlockArray(dec->cmr, &dec->edges) );
+  CMR_CALL( CMRfreeBlockArray(dec->cmr, &dec->nodes) );
   CMR_CALL( CMRfreeBlockArray(dec->cmr, &dec->rowEdges) );
   CMR_CALL( CMRfreeBlockArray(dec->cmr, &dec->columnEdges) );
   CMR_CALL( CMRfreeBlock(dec->cmr, pdec) );
@@ -1383,8 +1768,165 @@ CMR_ERROR decFree(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Copy of the state of a decomposition to which it can be rolled back.
+ *
+ * Since all data of a decomposition is stored in flat arrays, a checkpoint consists of copies of their used parts.
+ */
+
+typedef struct
+{
+  Dec state;                  /**< \brief Copy of the decomposition's scalar data; its arrays are the copies below. */
+  DEC_MEMBER_DATA* members;   /**< \brief Copy of the members. */
+  DecEdgeData* edges;         /**< \brief Copy of the edges, including the free ones. */
+  DecNodeData* nodes;         /**< \brief Copy of the nodes, including the free ones. */
+  DecRowData* rowEdges;       /**< \brief Copy of the row edges. */
+  DecColumnData* columnEdges; /**< \brief Copy of the column edges. */
+} DecCheckpoint;
+
+/**
+ * \brief Creates a checkpoint of \p dec, to which it can be rolled back via \ref decRollback.
+ */
+
+static
+CMR_ERROR decCheckpointCreate(
+  Dec* dec,                   /**< Decomposition. */
+  DecCheckpoint** pcheckpoint /**< Pointer for storing the checkpoint. */
+)
+{
+  assert(dec);
+  assert(pcheckpoint);
+
+  CMR_CALL( CMRallocBlock(dec->cmr, pcheckpoint) );
+  DecCheckpoint* checkpoint = *pcheckpoint;
+  checkpoint->state = *dec;
+  checkpoint->members = NULL;
+  CMR_CALL( CMRallocBlockArray(dec->cmr, &checkpoint->members, dec->numMembers + 1) );
+  memcpy(checkpoint->members, dec->members, dec->numMembers * sizeof(DEC_MEMBER_DATA));
+  checkpoint->edges = NULL;
+  CMR_CALL( CMRduplicateBlockArray(dec->cmr, &checkpoint->edges, dec->memEdges, dec->edges) );
+  checkpoint->nodes = NULL;
+  CMR_CALL( CMRduplicateBlockArray(dec->cmr, &checkpoint->nodes, dec->memNodes, dec->nodes) );
+  checkpoint->rowEdges = NULL;
+  CMR_CALL( CMRallocBlockArray(dec->cmr, &checkpoint->rowEdges, dec->numRows + 1) );
+  memcpy(checkpoint->rowEdges, dec->rowEdges, dec->numRows * sizeof(DecRowData));
+  checkpoint->columnEdges = NULL;
+  CMR_CALL( CMRallocBlockArray(dec->cmr, &checkpoint->columnEdges, dec->numColumns + 1) );
+  memcpy(checkpoint->columnEdges, dec->columnEdges, dec->numColumns * sizeof(DecColumnData));
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Frees the checkpoint \p *pcheckpoint.
+ */
+
+static
+CMR_ERROR decCheckpointFree(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  DecCheckpoint** pcheckpoint /**< Pointer to checkpoint. */
+)
+{
+  assert(pcheckpoint);
+
+  DecCheckpoint* checkpoint = *pcheckpoint;
+  if (!checkpoint)
+    return CMR_OKAY;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &checkpoint->columnEdges) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &checkpoint->rowEdges) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &checkpoint->nodes) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &checkpoint->edges) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &checkpoint->members) );
+  CMR_CALL( CMRfreeBlock(cmr, pcheckpoint) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Rolls \p dec back to the state stored in \p checkpoint, which must have been created for \p dec.
+ *
+ * The arrays of \p dec keep their current sizes. Nodes and edges that were allocated after the checkpoint are added to
+ * the free lists, such that repeated rollbacks do not enlarge the memory. A \ref DEC_NEWCOLUMN structure that was used
+ * for \p dec must be cleared via \ref newcolumnClear afterwards.
+ */
+
+static
+CMR_ERROR decRollback(
+  Dec* dec,                 /**< Decomposition. */
+  DecCheckpoint* checkpoint /**< Checkpoint of \p dec. */
+)
+{
+  assert(dec);
+  assert(checkpoint);
+
+  const Dec* state = &checkpoint->state;
+  assert(dec->cmr == state->cmr);
+  assert(dec->memMembers >= state->memMembers);
+  assert(dec->memEdges >= state->memEdges);
+  assert(dec->memNodes >= state->memNodes);
+  assert(dec->memRows >= state->numRows);
+  assert(dec->memColumns >= state->numColumns);
+
+  memcpy(dec->members, checkpoint->members, state->numMembers * sizeof(DEC_MEMBER_DATA));
+  memcpy(dec->edges, checkpoint->edges, state->memEdges * sizeof(DecEdgeData));
+  memcpy(dec->nodes, checkpoint->nodes, state->memNodes * sizeof(DecNodeData));
+  memcpy(dec->rowEdges, checkpoint->rowEdges, state->numRows * sizeof(DecRowData));
+  memcpy(dec->columnEdges, checkpoint->columnEdges, state->numColumns * sizeof(DecColumnData));
+
+  dec->numMembers = state->numMembers;
+  dec->numEdges = state->numEdges;
+  dec->firstFreeEdge = state->firstFreeEdge;
+  for (size_t e = state->memEdges; e < dec->memEdges; ++e)
+  {
+    dec->edges[e].next = dec->firstFreeEdge;
+    dec->edges[e].member = -1;
+    dec->firstFreeEdge = e;
+  }
+  dec->numNodes = state->numNodes;
+  dec->firstFreeNode = state->firstFreeNode;
+  for (size_t v = state->memNodes; v < dec->memNodes; ++v)
+  {
+    dec->nodes[v].representativeNode = dec->firstFreeNode;
+    dec->firstFreeNode = v;
+  }
+  dec->numRows = state->numRows;
+  dec->numColumns = state->numColumns;
+  dec->numMarkerPairs = state->numMarkerPairs;
+
+  /* The visit counter must not be reset since the members' counters may have been increased since the checkpoint. */
+
+#if defined(CMR_DEBUG_CONSISTENCY)
+  CMRconsistencyAssert( decConsistency(dec) );
+#endif /* CMR_DEBUG_CONSISTENCY */
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the representative of \p node in the union-find forest \p nodesParent, halving the paths.
+ */
+
+static inline
+CMR_GRAPH_NODE findGraphNodeRepresentative(
+  CMR_GRAPH_NODE* nodesParent,  /**< Array that maps nodes to their parents or to -1 for roots. */
+  CMR_GRAPH_NODE node           /**< Node. */
+)
+{
+  while (nodesParent[node] >= 0)
+  {
+    if (nodesParent[nodesParent[node]] >= 0)
+      nodesParent[node] = nodesParent[nodesParent[node]];
+    node = nodesParent[node];
+  }
+  return node;
+}
+
 /**
  * \brief Creates a graph represented by given decomposition.
+ *
+ * The edges of all members are collected first, where the nodes that are identified when merging markers are
+ * united in a union-find forest. The graph is then filled at once via \ref CMRgraphAssignEdges.
  */
 
 static
@@ -1404,31 +1946,30 @@ CMR_ERROR decToGraph(
   CMRconsistencyAssert( decConsistency(dec) );
 #endif /* CMR_DEBUG_CONSISTENCY */
 
-
   CMRdbgMsg(0, "CMRdecToGraph for t-decomposition.\n");
 
-  CMR_CALL( CMRgraphClear(dec->cmr, graph) );
-
-  CMR_ELEMENT* localEdgeElements = NULL;
-  if (edgeElements)
-    localEdgeElements = edgeElements;
-  else if (forestEdges || coforestEdges)
-    CMR_CALL( CMRallocStackArray(dec->cmr, &localEdgeElements, dec->memEdges) );
-  CMR_GRAPH_NODE* decNodesToGraphNodes = NULL;
-  CMR_CALL( CMRallocStackArray(dec->cmr, &decNodesToGraphNodes, dec->memNodes) );
-  CMR_GRAPH_EDGE* decEdgesToGraphEdges = NULL;
-  CMR_CALL( CMRallocStackArray(dec->cmr, &decEdgesToGraphEdges, dec->memEdges) );
-
+  /* Every decomposition edge belongs to one member, and each member creates at most two nodes per edge. */
+  size_t memNodes = dec->memNodes + 2 * dec->memEdges;
+  CMR_GRAPH_NODE* decNodesToNodes = NULL;
+  CMR_CALL( CMRallocStackArray(dec->cmr, &decNodesToNodes, dec->memNodes) );
+  CMR_GRAPH_EDGE* decEdgesToEdges = NULL;
+  CMR_CALL( CMRallocStackArray(dec->cmr, &decEdgesToEdges, dec->memEdges) );
+  CMR_GRAPH_NODE* nodesParent = NULL;
+  CMR_CALL( CMRallocStackArray(dec->cmr, &nodesParent, memNodes) );
+  CMR_GRAPH_NODE* edgesU = NULL;
+  CMR_CALL( CMRallocStackArray(dec->cmr, &edgesU, dec->memEdges + 1) );
+  CMR_GRAPH_NODE* edgesV = NULL;
+  CMR_CALL( CMRallocStackArray(dec->cmr, &edgesV, dec->memEdges + 1) );
+  DEC_EDGE* edgesDecEdge = NULL;
+  CMR_CALL( CMRallocStackArray(dec->cmr, &edgesDecEdge, dec->memEdges + 1) );
+  CMR_GRAPH_NODE* nodesGraphNode = NULL;
+  CMR_CALL( CMRallocStackArray(dec->cmr, &nodesGraphNode, memNodes) );
+
+  size_t numNodes = 0;
   for (size_t v = 0; v < dec->memNodes; ++v)
-  {
-    if (dec->nodes[v].representativeNode == SIZE_MAX)
-    {
-      CMR_CALL( CMRgraphAddNode(dec->cmr, graph, &decNodesToGraphNodes[v]) );
-    }
-    else
-      decNodesToGraphNodes[v] = -1;
-  }
+    decNodesToNodes[v] = (dec->nodes[v].representativeNode == SIZE_MAX) ? (CMR_GRAPH_NODE) numNodes++ : -1;
 
+  size_t numEdges = 0;
   for (DEC_MEMBER member = 0; member < dec->numMembers; ++member)
   {
     if (!isRepresentativeMember(dec, member))
@@ -1437,130 +1978,133 @@ CMR_ERROR decToGraph(
     DEC_MEMBER_TYPE type = dec->members[member].type;
     CMRdbgMsg(2, "Member %d is %s with %d edges.\n", member, memberTypeString(type), dec->members[member].numEdges);
 
-    CMR_GRAPH_EDGE graphEdge;
     DEC_EDGE edge = dec->members[member].firstEdge;
     if (type == DEC_MEMBER_TYPE_RIGID)
     {
       do
       {
-        DEC_NODE head = findEdgeHead(dec, edge);
-        DEC_NODE tail = findEdgeTail(dec, edge);
-        CMR_CALL( CMRgraphAddEdge(dec->cmr, graph, decNodesToGraphNodes[head], decNodesToGraphNodes[tail],
-          &graphEdge) );
-        decEdgesToGraphEdges[edge] = graphEdge;
-        if (localEdgeElements)
-          localEdgeElements[graphEdge] = dec->edges[edge].element;
+        edgesU[numEdges] = decNodesToNodes[findEdgeHead(dec, edge)];
+        edgesV[numEdges] = decNodesToNodes[findEdgeTail(dec, edge)];
+        edgesDecEdge[numEdges] = edge;
+        decEdgesToEdges[edge] = numEdges++;
         edge = dec->edges[edge].next;
       }
       while (edge != dec->members[member].firstEdge);
     }
     else if (type == DEC_MEMBER_TYPE_PARALLEL)
     {
-      CMR_GRAPH_NODE graphHead, graphTail;
-      CMR_CALL( CMRgraphAddNode(dec->cmr, graph, &graphHead) );
-      CMR_CALL( CMRgraphAddNode(dec->cmr, graph, &graphTail) );
+      CMR_GRAPH_NODE head = numNodes++;
+      CMR_GRAPH_NODE tail = numNodes++;
       do
       {
-        CMR_CALL( CMRgraphAddEdge(dec->cmr, graph, graphHead, graphTail, &graphEdge) );
-        decEdgesToGraphEdges[edge] = graphEdge;
-        if (localEdgeElements)
-          localEdgeElements[graphEdge] = dec->edges[edge].element;
+        edgesU[numEdges] = head;
+        edgesV[numEdges] = tail;
+        edgesDecEdge[numEdges] = edge;
+        decEdgesToEdges[edge] = numEdges++;
         edge = dec->edges[edge].next;
       }
       while (edge != dec->members[member].firstEdge);
     }
     else if (type == DEC_MEMBER_TYPE_SERIES)
     {
-      CMR_GRAPH_NODE firstNode, v;
-      CMR_CALL( CMRgraphAddNode(dec->cmr, graph, &firstNode) );
-      v = firstNode;
+      CMR_GRAPH_NODE firstNode = numNodes++;
+      CMR_GRAPH_NODE v = firstNode;
       edge = dec->edges[edge].next;
       while (edge != dec->members[member].firstEdge)
       {
-        CMR_GRAPH_NODE w;
-        CMR_CALL( CMRgraphAddNode(dec->cmr, graph, &w) );
-        CMR_CALL( CMRgraphAddEdge(dec->cmr, graph, v, w, &graphEdge) );
-        decEdgesToGraphEdges[edge] = graphEdge;
-        if (localEdgeElements)
-          localEdgeElements[graphEdge] = dec->edges[edge].element;
-
+        CMR_GRAPH_NODE w = numNodes++;
+        edgesU[numEdges] = v;
+        edgesV[numEdges] = w;
+        edgesDecEdge[numEdges] = edge;
+        decEdgesToEdges[edge] = numEdges++;
         edge = dec->edges[edge].next;
         v = w;
       }
-      CMR_CALL( CMRgraphAddEdge(dec->cmr, graph, v, firstNode, &graphEdge) );
-      decEdgesToGraphEdges[edge] = graphEdge;
-      if (localEdgeElements)
-        localEdgeElements[graphEdge] = dec->edges[edge].element;
+      edgesU[numEdges] = v;
+      edgesV[numEdges] = firstNode;
+      edgesDecEdge[numEdges] = edge;
+      decEdgesToEdges[edge] = numEdges++;
     }
     else
     {
       assert(type == DEC_MEMBER_TYPE_LOOP);
 
-      CMR_GRAPH_NODE v;
-      CMR_CALL( CMRgraphAddNode(dec->cmr, graph, &v) );
-      CMR_CALL( CMRgraphAddEdge(dec->cmr, graph, v, v, &graphEdge) );
-      decEdgesToGraphEdges[edge] = graphEdge;
-      if (localEdgeElements)
-        localEdgeElements[graphEdge] = dec->edges[edge].element;
+      CMR_GRAPH_NODE v = numNodes++;
+      edgesU[numEdges] = v;
+      edgesV[numEdges] = v;
+      edgesDecEdge[numEdges] = edge;
+      decEdgesToEdges[edge] = numEdges++;
     }
   }
+  assert(numNodes <= memNodes);
 
-  /* Merge respective parent and child edges. */
+  for (size_t v = 0; v < numNodes; ++v)
+    nodesParent[v] = -1;
+
+  /* Identify the end nodes of corresponding parent and child markers, which are removed. We use edgesDecEdge to mark
+   * the removed edges. */
 
   if (merge)
   {
-    CMRdbgMsg(2, "Before merging, the graph has %d nodes and %d edges.\n", CMRgraphNumNodes(graph),
-      CMRgraphNumEdges(graph));
+    CMRdbgMsg(2, "Before merging, the graph has %zu nodes and %zu edges.\n", numNodes, numEdges);
 
     for (size_t m = 0; m < dec->numMembers; ++m)
     {
       if (!isRepresentativeMember(dec, m) || dec->members[m].parentMember == SIZE_MAX)
         continue;
 
-      CMR_GRAPH_EDGE parent = decEdgesToGraphEdges[dec->members[m].markerOfParent];
-      CMR_GRAPH_EDGE child = decEdgesToGraphEdges[dec->members[m].markerToParent];
-      CMR_GRAPH_NODE parentU = CMRgraphEdgeU(graph, parent);
-      CMR_GRAPH_NODE parentV = CMRgraphEdgeV(graph, parent);
-      CMR_GRAPH_NODE childU = CMRgraphEdgeU(graph, child);
-      CMR_GRAPH_NODE childV = CMRgraphEdgeV(graph, child);
+      CMR_GRAPH_EDGE parent = decEdgesToEdges[dec->members[m].markerOfParent];
+      CMR_GRAPH_EDGE child = decEdgesToEdges[dec->members[m].markerToParent];
 
-      CMRdbgMsg(2, "Merging edges %d = {%d,%d} <%s>", parent, parentU, parentV,
+      CMRdbgMsg(2, "Merging edges %d = {%d,%d} <%s>", parent, edgesU[parent], edgesV[parent],
         CMRelementString(dec->edges[dec->members[m].markerOfParent].element, NULL));
-      CMRdbgMsg(0, " and %d = {%d,%d} <%s>.\n", child, childU, childV,
+      CMRdbgMsg(0, " and %d = {%d,%d} <%s>.\n", child, edgesU[child], edgesV[child],
         CMRelementString(dec->edges[dec->members[m].markerToParent].element, NULL));
 
-      CMR_CALL( CMRgraphMergeNodes(dec->cmr, graph, parentU, childU) );
-      CMR_CALL( CMRgraphDeleteNode(dec->cmr, graph, childU) );
-      CMR_CALL( CMRgraphMergeNodes(dec->cmr, graph, parentV, childV) );
-      CMR_CALL( CMRgraphDeleteNode(dec->cmr, graph, childV) );
+      for (int end = 0; end < 2; ++end)
+      {
+        CMR_GRAPH_NODE parentRoot = findGraphNodeRepresentative(nodesParent, end ? edgesV[parent] : edgesU[parent]);
+        CMR_GRAPH_NODE childRoot = findGraphNodeRepresentative(nodesParent, end ? edgesV[child] : edgesU[child]);
+        if (parentRoot != childRoot)
+          nodesParent[childRoot] = parentRoot;
+      }
 
-      CMR_CALL( CMRgraphDeleteEdge(dec->cmr, graph, parent) );
-      CMR_CALL( CMRgraphDeleteEdge(dec->cmr, graph, child) );
+      edgesDecEdge[parent] = SIZE_MAX;
+      edgesDecEdge[child] = SIZE_MAX;
     }
   }
 
-  // TODO: Remove nodes with degree 0 or 1?!
-  bool* nodesUsed = NULL;
-  CMR_CALL( CMRallocStackArray(dec->cmr, &nodesUsed, CMRgraphMemNodes(graph)) );
-  for (CMR_GRAPH_NODE v = CMRgraphNodesFirst(graph); CMRgraphNodesValid(graph, v); v = CMRgraphNodesNext(graph, v))
-    nodesUsed[v] = false;
-  for (CMR_GRAPH_ITER i = CMRgraphEdgesFirst(graph); CMRgraphEdgesValid(graph, i); i = CMRgraphEdgesNext(graph, i))
+  /* Number the representatives of nodes that are incident to remaining edges in the order of their first occurence
+   * and compress the list of edges. Nodes of degree 0 are thus not part of the graph. */
+
+  for (size_t v = 0; v < numNodes; ++v)
+    nodesGraphNode[v] = -1;
+  size_t numGraphNodes = 0;
+  size_t numGraphEdges = 0;
+  for (size_t e = 0; e < numEdges; ++e)
   {
-    CMR_GRAPH_EDGE e = CMRgraphEdgesEdge(graph, i);
-    nodesUsed[CMRgraphEdgeU(graph, e)] = true;
-    nodesUsed[CMRgraphEdgeV(graph, e)] = true;
+    if (edgesDecEdge[e] == SIZE_MAX)
+      continue;
+
+    CMR_GRAPH_NODE u = findGraphNodeRepresentative(nodesParent, edgesU[e]);
+    if (nodesGraphNode[u] < 0)
+      nodesGraphNode[u] = numGraphNodes++;
+    CMR_GRAPH_NODE v = findGraphNodeRepresentative(nodesParent, edgesV[e]);
+    if (nodesGraphNode[v] < 0)
+      nodesGraphNode[v] = numGraphNodes++;
+    edgesU[numGraphEdges] = nodesGraphNode[u];
+    edgesV[numGraphEdges] = nodesGraphNode[v];
+    edgesDecEdge[numGraphEdges] = edgesDecEdge[e];
+    ++numGraphEdges;
   }
-  for (CMR_GRAPH_NODE v = CMRgraphNodesFirst(graph); CMRgraphNodesValid(graph, v); )
+
+  CMR_CALL( CMRgraphAssignEdges(dec->cmr, graph, numGraphNodes, numGraphEdges, edgesU, edgesV) );
+
+  if (edgeElements)
   {
-    CMR_GRAPH_NODE next = CMRgraphNodesNext(graph, v);
-    if (!nodesUsed[v])
-    {
-      CMRdbgMsg(2, "Removing degree-0 node %d.\n", v);
-      CMRgraphDeleteNode(dec->cmr, graph, v);
-    }
-    v = next;
+    for (size_t e = 0; e < numGraphEdges; ++e)
+      edgeElements[e] = dec->edges[edgesDecEdge[e]].element;
   }
-  CMR_CALL( CMRfreeStackArray(dec->cmr, &nodesUsed) );
 
   /* Construct (co)forest. */
 
@@ -1568,46 +2112,46 @@ CMR_ERROR decToGraph(
   {
 #if !defined(NDEBUG)
     /* This is only relevant if a 1-separation exists. */
-    for (size_t r = 0; r < dec->numRows; ++r)
-      forestEdges[r] = INT_MIN;
-    for (size_t c = 0; c < dec->numColumns; ++c)
-      coforestEdges[c] = INT_MIN;
+    if (forestEdges)
+    {
+      for (size_t r = 0; r < dec->numRows; ++r)
+        forestEdges[r] = INT_MIN;
+    }
+    if (coforestEdges)
+    {
+      for (size_t c = 0; c < dec->numColumns; ++c)
+        coforestEdges[c] = INT_MIN;
+    }
 #endif /* !NDEBUG */
 
-    for (CMR_GRAPH_ITER i = CMRgraphEdgesFirst(graph); CMRgraphEdgesValid(graph, i);
-      i = CMRgraphEdgesNext(graph, i))
+    for (size_t e = 0; e < numGraphEdges; ++e)
     {
-      CMR_GRAPH_EDGE e = CMRgraphEdgesEdge(graph, i);
+      CMR_ELEMENT element = dec->edges[edgesDecEdge[e]].element;
 
-      CMRdbgMsg(2, "Graph edge %d = {%d,%d} <%s>\n", e, CMRgraphEdgeU(graph, e), CMRgraphEdgeV(graph, e),
-        CMRelementString(localEdgeElements[e], NULL));
+      CMRdbgMsg(2, "Graph edge %zu = {%d,%d} <%s>\n", e, edgesU[e], edgesV[e], CMRelementString(element, NULL));
 
-      CMR_ELEMENT element = localEdgeElements[e];
       if (CMRelementIsRow(element) && forestEdges)
-      {
-        CMRdbgMsg(0, "Edge corresponds to element %d = row %d.\n", element, CMRelementToRowIndex(element));
         forestEdges[CMRelementToRowIndex(element)] = e;
-      }
       else if (CMRelementIsColumn(element) && coforestEdges)
-      {
-        CMRdbgMsg(0, "Edge corresponds to element %d = column %d.\n", element, CMRelementToColumnIndex(element));
         coforestEdges[CMRelementToColumnIndex(element)] = e;
-      }
     }
 
 #if !defined(NDEBUG)
     /* These assertions indicate a 1-separable input matrix. */
-    for (size_t r = 0; r < dec->numRows; ++r)
+    for (size_t r = 0; forestEdges && r < dec->numRows; ++r)
       assert(forestEdges[r] >= 0);
-    for (size_t c = 0; c < dec->numColumns; ++c)
+    for (size_t c = 0; coforestEdges && c < dec->numColumns; ++c)
       assert(coforestEdges[c] >= 0);
 #endif /* !NDEBUG */
   }
 
-  CMR_CALL( CMRfreeStackArray(dec->cmr, &decEdgesToGraphEdges) );
-  CMR_CALL( CMRfreeStackArray(dec->cmr, &decNodesToGraphNodes) );
-  if (localEdgeElements != edgeElements)
-    CMR_CALL( CMRfreeStackArray(dec->cmr, &localEdgeElements) );
+  CMR_CALL( CMRfreeStackArray(dec->cmr, &nodesGraphNode) );
+  CMR_CALL( CMRfreeStackArray(dec->cmr, &edgesDecEdge) );
+  CMR_CALL( CMRfreeStackArray(dec->cmr, &edgesV) );
+  CMR_CALL( CMRfreeStackArray(dec->cmr, &edgesU) );
+  CMR_CALL( CMRfreeStackArray(dec->cmr, &nodesParent) );
+  CMR_CALL( CMRfreeStackArray(dec->cmr, &decEdgesToEdges) );
+  CMR_CALL( CMRfreeStackArray(dec->cmr, &decNodesToNodes) );
 
   return CMR_OKAY;
 }
@@ -1847,6 +2391,38 @@ CMR_ERROR newcolumnFree(
 }
 
 
+/**
+ * \brief Resets a \ref DEC_NEWCOLUMN structure such that it can be used for a different decomposition.
+ *
+ * In contrast to \ref newcolumnFree and \ref newcolumnCreate, the memory is kept.
+ */
+
+static
+void newcolumnClear(
+  DEC_NEWCOLUMN* newcolumn  /**< newcolumn. */
+)
+{
+  assert(newcolumn);
+
+  newcolumn->remainsGraphic = true;
+  newcolumn->numReducedMembers = 0;
+  newcolumn->numReducedComponents = 0;
+  newcolumn->numPathEdges = 0;
+  newcolumn->firstPathEdge = NULL;
+  newcolumn->usedChildrenStorage = 0;
+
+  /* The marks refer to the previous decomposition, so we reset all of them. */
+  for (size_t m = 0; m < newcolumn->memReducedMembers; ++m)
+  {
+    newcolumn->memberInfo[m].reducedMember = NULL;
+    newcolumn->memberInfo[m].rootDepthMinimizer = NULL;
+  }
+  for (size_t i = 0; i < newcolumn->memNodesDegree; ++i)
+    newcolumn->nodesDegree[i] = 0;
+  for (size_t e = 0; e < newcolumn->memEdgesInPath; ++e)
+    newcolumn->edgesInPath[e] = false;
+}
+
 /**
  * \brief Removes all path edges.
  */
@@ -3395,6 +3971,10 @@ CMR_ERROR addColumnCheck(
   /* Reset \ref nodesDegree to 0 and edgesInPath to false by inspecting path edges from previous iteration. */
   CMR_CALL( removeAllPathEdges(dec, newcolumn) );
 
+  /* The previous check may have been rejected, in which case the reduced decomposition was not cleared. */
+  newcolumn->numReducedMembers = 0;
+  newcolumn->numReducedComponents = 0;
+
 #if defined(CMR_DEBUG)
   for (size_t e = 0; e < newcolumn->memEdgesInPath; ++e)
   {
@@ -5188,51 +5768,77 @@ CMR_ERROR addColumnApply(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Decomposition and newcolumn structure that are reused by several calls of \ref cographicnessTest.
+ */
+
+typedef struct
+{
+  Dec* dec;                 /**< \brief Decomposition, or \c NULL if not created yet. */
+  DEC_NEWCOLUMN* newcolumn; /**< \brief newcolumn structure, or \c NULL if not created yet. */
+} CographicnessTestMemory;
+
 static
 CMR_ERROR cographicnessTest(
   CMR* cmr,                 /**< \ref CMR environment. */
   CMR_CHRMAT* matrix,       /**< Some matrix to be tested for cographicness. */
-  void* data,               /**< Additional data (must be \c NULL). */
+  void* data,               /**< Pointer to a \ref CographicnessTestMemory to be reused (may be \c NULL). */
   bool* pisCographic,       /**< Pointer for storing whether \p matrix is cographic. */
   CMR_SUBMAT** psubmatrix,  /**< Pointer for storing a proper non-cographic submatrix of \p matrix. */
   double timeLimit          /**< Time limit to impose. */
 )
 {
   CMR_UNUSED(cmr);
-  CMR_UNUSED(data);
 
   assert(cmr);
   assert(matrix);
-  assert(!data);
   assert(pisCographic);
   assert(!psubmatrix || !*psubmatrix);
 
-  /* TODO: Algorithm for finding a bad minor. */
-  CMR_UNUSED(psubmatrix);
-
 #if defined(CMR_DEBUG)
   CMRdbgMsg(0, "cographicnessTest called for a %dx%d matrix\n", matrix->numRows, matrix->numColumns);
   CMRchrmatPrintDense(cmr, matrix, stdout, '0', false);
 #endif /* CMR_DEBUG */
 
+  CographicnessTestMemory* memory = (CographicnessTestMemory*) data;
+
   *pisCographic = true;
   Dec* dec = NULL;
-  clock_t time = clock();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
   if (matrix->numNonzeros > 0)
   {
-    CMR_CALL( decCreate(cmr, &dec, 4096, 1024, 256, 256, 256) );
+    DEC_NEWCOLUMN* newcolumn = NULL;
+    if (memory && memory->dec)
+    {
+      dec = memory->dec;
+      decClear(dec);
+    }
+    else
+      CMR_CALL( decCreateForMatrix(cmr, &dec, matrix->numColumns, matrix->numRows, matrix->numNonzeros) );
+    if (memory && memory->newcolumn)
+    {
+      newcolumn = memory->newcolumn;
+      newcolumnClear(newcolumn);
+    }
+    else
+      CMR_CALL( newcolumnCreate(cmr, &newcolumn) );
+    if (memory)
+    {
+      memory->dec = dec;
+      memory->newcolumn = newcolumn;
+    }
 
     /* Process each column. */
-    DEC_NEWCOLUMN* newcolumn = NULL;
-    CMR_CALL( newcolumnCreate(cmr, &newcolumn) );
     size_t columnTimeFactor = matrix->numRows / 100 + 1;
     for (size_t column = 0; column < matrix->numRows && *pisCographic; ++column)
     {
-      if ((column % columnTimeFactor == 0) && (clock() - time) * 1.0 / CLOCKS_PER_SEC > timeLimit)
+      if ((column % columnTimeFactor == 0) && CMRdeadlinePassed(&deadline))
       {
-        CMR_CALL( newcolumnFree(cmr, &newcolumn) );
-        if (dec)
+        if (!memory)
+        {
+          CMR_CALL( newcolumnFree(cmr, &newcolumn) );
           CMR_CALL( decFree(&dec) );
+        }
         return CMR_ERROR_TIMEOUT;
       }
       
@@ -5245,204 +5851,980 @@ CMR_ERROR cographicnessTest(
           matrix->rowSlice[column+1] - matrix->rowSlice[column]) );
       }
       else
+      {
         *pisCographic = false;
+
+        /* The rows processed so far already form a non-cographic submatrix. */
+        if (psubmatrix && matrix->rowSlice[column + 1] < matrix->numNonzeros)
+        {
+          CMR_CALL( CMRsubmatCreate(cmr, column + 1, matrix->numColumns, psubmatrix) );
+          for (size_t row = 0; row <= column; ++row)
+            (*psubmatrix)->rows[row] = row;
+          for (size_t c = 0; c < matrix->numColumns; ++c)
+            (*psubmatrix)->columns[c] = c;
+        }
+      }
     }
 
-    CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+    if (!memory)
+    {
+      CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+      CMR_CALL( decFree(&dec) );
+    }
   }
 
-  if (dec)
-    CMR_CALL( decFree(&dec) );
-
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRgraphicTestTranspose(CMR* cmr, CMR_CHRMAT* matrix, bool* pisCographic, CMR_GRAPH** pgraph,
-  CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_SUBMAT** psubmatrix,
-  CMR_GRAPHIC_STATISTICS* stats, double timeLimit)
+/**
+ * \brief Computes the graph represented by the decomposition \p dec of a matrix.
+ *
+ * Rows of the matrix that are not present in \p dec are added as single-edge members first.
+ */
+
+static
+CMR_ERROR decComputeGraph(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  Dec* dec,                       /**< Decomposition, or \c NULL if the matrix has no nonzeros. */
+  size_t numRows,                 /**< Number of rows of the matrix. */
+  size_t numColumns,              /**< Number of columns of the matrix. */
+  CMR_GRAPH* graph,               /**< Graph to be filled. */
+  CMR_GRAPH_EDGE* forest,         /**< If not \c NULL, the edges of a spanning tree are stored here. */
+  CMR_GRAPH_EDGE* coforest        /**< If not \c NULL, the non-basis edges are stored here. */
+)
 {
   assert(cmr);
-  assert(matrix);
-  assert(!psubmatrix || !*psubmatrix);
-  assert(!pforestEdges || pgraph);
-  assert(!pcoforestEdges || pgraph);
-  assert(pisCographic);
-
-#if defined(CMR_DEBUG)
-  CMRdbgMsg(0, "CMRgraphicTestTranspose called for a %dx%d matrix\n", matrix->numRows, matrix->numColumns);
-  CMRchrmatPrintDense(cmr, matrix, stdout, '0', true);
-#endif /* CMR_DEBUG */
-
-  clock_t time = clock();
-  *pisCographic = true;
+  assert(graph);
 
-  Dec* dec = NULL;
-  if (matrix->numNonzeros > 0)
+  if (dec)
   {
-    CMR_CALL( decCreate(cmr, &dec, 4096, 1024, 256, 256, 256) );
-
-    /* Process each column. */
-    DEC_NEWCOLUMN* newcolumn = NULL;
-    CMR_CALL( newcolumnCreate(cmr, &newcolumn) );
-    for (size_t column = 0; column < matrix->numRows && *pisCographic; ++column)
+    /* Add members and edges for empty rows. */
+    if (dec->numRows < numRows)
     {
-      clock_t checkClock = clock();
-      double remainingTime = timeLimit - (checkClock - time) * 1.0 / CLOCKS_PER_SEC;
-      if (remainingTime < 0)
-      {
-        CMR_CALL( newcolumnFree(cmr, &newcolumn) );
-        if (dec)
-          CMR_CALL( decFree(&dec) );
-        return CMR_ERROR_TIMEOUT;
-      }
-      CMR_CALL( addColumnCheck(dec, newcolumn, &matrix->entryColumns[matrix->rowSlice[column]],
-        matrix->rowSlice[column+1] - matrix->rowSlice[column]) );
-      if (stats)
+      /* Reallocate if necessary. */
+      if (dec->memRows < numRows)
       {
-        stats->checkCount++;
-        stats->checkTime += (clock() - checkClock) * 1.0 / CLOCKS_PER_SEC;
+        CMR_CALL( CMRreallocBlockArray(cmr, &dec->rowEdges, numRows) );
+        dec->memRows = numRows;
       }
 
-      debugDot(dec, newcolumn);
-
-      if (newcolumn->remainsGraphic)
+      /* Add single-edge parallel for each missing row. */
+      for (size_t r = dec->numRows; r < numRows; ++r)
       {
-        clock_t applyClock = (stats ? clock() : 0);
+        DEC_MEMBER member;
+        CMR_CALL( createMember(dec, DEC_MEMBER_TYPE_PARALLEL, &member) );
 
-        CMR_CALL( addColumnApply(dec, newcolumn, column, &matrix->entryColumns[matrix->rowSlice[column]],
-          matrix->rowSlice[column+1] - matrix->rowSlice[column]) );
+        DEC_EDGE edge;
+        CMR_CALL( createEdge(dec, member, &edge) );
+        CMR_CALL( addEdgeToMembersEdgeList(dec, edge) );
+        dec->edges[edge].element = CMRrowToElement(r);
+        dec->edges[edge].head = -1;
+        dec->edges[edge].tail = -1;
+        dec->edges[edge].childMember = -1;
 
-        if (stats)
-        {
-          stats->applyCount++;
-          stats->applyTime += (clock() - applyClock) * 1.0 / CLOCKS_PER_SEC;
-        }
+        CMRdbgMsg(8, "New empty row %d is edge %d of member %d.\n", r, edge, member);
+
+        dec->rowEdges[r].edge = edge;
       }
-      else
-        *pisCographic = false;
+
+      dec->numRows = numRows;
     }
 
-    CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+    CMR_CALL( decToGraph(dec, graph, true, forest, coforest, NULL) );
   }
-
-  if (*pisCographic)
+  else
   {
-    /* Allocate memory for graph, forest and coforest. */
-
-    CMR_GRAPH* graph = NULL;
-    if (pgraph)
-    {
-      if (!*pgraph)
-      {
-        CMR_CALL( CMRgraphCreateEmpty(cmr, pgraph, matrix->numColumns + 2 * matrix->numRows,
-          matrix->numColumns + 3 * matrix->numRows) );
-      }
-      graph = *pgraph;
-    }
-
-    int* forest = NULL;
-    if (pforestEdges)
+    /* Construct a path with numRows edges and with numColumns loops at 0. */
+    size_t numEdges = numColumns + numRows;
+    CMR_GRAPH_NODE* edgesU = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &edgesU, numEdges + 1) );
+    CMR_GRAPH_NODE* edgesV = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &edgesV, numEdges + 1) );
+    for (size_t c = 0; c < numColumns; ++c)
     {
-      if (!*pforestEdges)
-        CMR_CALL( CMRallocBlockArray(cmr, pforestEdges, matrix->numColumns) );
-      forest = *pforestEdges;
+      edgesU[c] = 0;
+      edgesV[c] = 0;
+      if (coforest)
+        coforest[c] = c;
     }
-    int* coforest = NULL;
-    if (pcoforestEdges)
+    for (size_t r = 0; r < numRows; ++r)
     {
-      if (!*pcoforestEdges)
-        CMR_CALL( CMRallocBlockArray(cmr, pcoforestEdges, matrix->numRows) );
-      coforest = *pcoforestEdges;
+      edgesU[numColumns + r] = r;
+      edgesV[numColumns + r] = r + 1;
+      if (forest)
+        forest[r] = numColumns + r;
     }
+    CMR_CALL( CMRgraphAssignEdges(cmr, graph, numRows + 1, numEdges, edgesU, edgesV) );
+    CMR_CALL( CMRfreeStackArray(cmr, &edgesV) );
+    CMR_CALL( CMRfreeStackArray(cmr, &edgesU) );
 
-    if (graph)
-    {
-      if (matrix->numNonzeros > 0)
-      {
-        /* Add members and edges for empty rows. */
-        if (dec->numRows < matrix->numColumns)
-        {
-          /* Reallocate if necessary. */
-          if (dec->memRows < matrix->numColumns)
-          {
-            CMRreallocBlockArray(cmr, &dec->rowEdges, matrix->numColumns);
-            dec->memRows = matrix->numColumns;
-          }
-
-          /* Add single-edge parallel for each missing row. */
-          for (size_t r = dec->numRows; r < matrix->numColumns; ++r)
-          {
-            DEC_MEMBER member;
-            CMR_CALL( createMember(dec, DEC_MEMBER_TYPE_PARALLEL, &member) );
-
-            DEC_EDGE edge;
-            CMR_CALL( createEdge(dec, member, &edge) );
-            CMR_CALL( addEdgeToMembersEdgeList(dec, edge) );
-            dec->edges[edge].element = CMRrowToElement(r);
-            dec->edges[edge].head = -1;
-            dec->edges[edge].tail = -1;
-            dec->edges[edge].childMember = -1;
+    CMRdbgMsg(0, "Constructed graph with %d nodes and %d edges.\n", CMRgraphNumNodes(graph), CMRgraphNumEdges(graph));
+  }
 
-            CMRdbgMsg(8, "New empty row %d is edge %d of member %d.\n", r, edge, member);
+  return CMR_OKAY;
+}
 
-            dec->rowEdges[r].edge = edge;
+/**
+ * \brief Computes the order of the columns of \ref CMR_GRAPHIC_ORDER_CONNECTED.
+ *
+ * The columns are bucketed by decreasing number of nonzeros, stably. Then a breadth-first search on the bipartite
+ * row-column graph is started at the densest unvisited column, such that columns sharing rows with earlier ones come
+ * first. The matrix is given column-wise by \p columnSlice and \p columnRows (or their 32-bit versions) and row-wise
+ * by \p rowSlice and \p rowColumns.
+ */
+
+static
+CMR_ERROR computeConnectedColumnOrder(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  size_t numRows,           /**< Number of rows of the matrix. */
+  size_t numColumns,        /**< Number of columns of the matrix. */
+  size_t* columnSlice,      /**< Array with the first entry of each column and the total count, or \c NULL if the
+                             **  32-bit arrays are given. */
+  size_t* columnRows,       /**< Array with the rows of all entries. */
+  uint32_t* columnSlice32,  /**< Like \p columnSlice, but with 32-bit indices (used if \p columnSlice is \c NULL). */
+  uint32_t* columnRows32,   /**< Like \p columnRows, but with 32-bit indices. */
+  size_t* rowSlice,         /**< Array with the first entry of each row and the total count. */
+  size_t* rowColumns,       /**< Array with the columns of all entries. */
+  size_t* order             /**< Array for storing the order. */
+)
+{
+  assert(cmr);
+  assert(columnSlice || columnSlice32);
+  assert(rowSlice);
+  assert(order);
+
+  size_t* bucketStart = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &bucketStart, numRows + 2) );
+  for (size_t length = 0; length <= numRows + 1; ++length)
+    bucketStart[length] = 0;
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    size_t length = columnSlice ? columnSlice[column + 1] - columnSlice[column]
+      : columnSlice32[column + 1] - columnSlice32[column];
+    bucketStart[numRows - length + 1]++;
+  }
+  for (size_t b = 1; b <= numRows + 1; ++b)
+    bucketStart[b] += bucketStart[b - 1];
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    size_t length = columnSlice ? columnSlice[column + 1] - columnSlice[column]
+      : columnSlice32[column + 1] - columnSlice32[column];
+    order[bucketStart[numRows - length]++] = column;
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &bucketStart) );
+
+  bool* columnsVisited = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsVisited, numColumns + 1) );
+  bool* rowsVisited = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsVisited, numRows + 1) );
+  size_t* queue = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &queue, numColumns + 1) );
+  for (size_t column = 0; column < numColumns; ++column)
+    columnsVisited[column] = false;
+  for (size_t row = 0; row < numRows; ++row)
+    rowsVisited[row] = false;
+  size_t queueBeyond = 0;
+  for (size_t c = 0; c < numColumns; ++c)
+  {
+    if (columnsVisited[order[c]])
+      continue;
+
+    columnsVisited[order[c]] = true;
+    size_t queueFirst = queueBeyond;
+    queue[queueBeyond++] = order[c];
+    while (queueFirst < queueBeyond)
+    {
+      size_t column = queue[queueFirst++];
+      size_t first = columnSlice ? columnSlice[column] : columnSlice32[column];
+      size_t beyond = columnSlice ? columnSlice[column + 1] : columnSlice32[column + 1];
+      for (size_t e = first; e < beyond; ++e)
+      {
+        size_t row = columnRows ? columnRows[e] : columnRows32[e];
+        if (rowsVisited[row])
+          continue;
+        rowsVisited[row] = true;
+        for (size_t f = rowSlice[row]; f < rowSlice[row + 1]; ++f)
+        {
+          size_t neighbor = rowColumns[f];
+          if (!columnsVisited[neighbor])
+          {
+            columnsVisited[neighbor] = true;
+            queue[queueBeyond++] = neighbor;
           }
+        }
+      }
+    }
+  }
+  assert(queueBeyond == numColumns);
+  for (size_t c = 0; c < numColumns; ++c)
+    order[c] = queue[c];
+  CMR_CALL( CMRfreeStackArray(cmr, &queue) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsVisited) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsVisited) );
 
-          dec->numRows = matrix->numColumns;
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Computes the order of the columns of \ref CMR_GRAPHIC_ORDER_REJECT.
+ *
+ * Each connected component is started at its densest column. Then the next column is always one with the most
+ * nonzeros in rows that are already covered by earlier columns. These columns are maintained in buckets by this
+ * number, which only increases, such that the order is computed in linear time. The matrix is given as for
+ * \ref computeConnectedColumnOrder.
+ */
+
+static
+CMR_ERROR computeRejectColumnOrder(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  size_t numRows,           /**< Number of rows of the matrix. */
+  size_t numColumns,        /**< Number of columns of the matrix. */
+  size_t* columnSlice,      /**< Array with the first entry of each column and the total count, or \c NULL if the
+                             **  32-bit arrays are given. */
+  size_t* columnRows,       /**< Array with the rows of all entries. */
+  uint32_t* columnSlice32,  /**< Like \p columnSlice, but with 32-bit indices (used if \p columnSlice is \c NULL). */
+  uint32_t* columnRows32,   /**< Like \p columnRows, but with 32-bit indices. */
+  size_t* rowSlice,         /**< Array with the first entry of each row and the total count. */
+  size_t* rowColumns,       /**< Array with the columns of all entries. */
+  size_t* order             /**< Array for storing the order. */
+)
+{
+  assert(cmr);
+  assert(columnSlice || columnSlice32);
+  assert(rowSlice);
+  assert(order);
+
+  /* The densest columns come first in densityOrder, from which new components are started. */
+  size_t* densityOrder = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &densityOrder, numColumns + 1) );
+  size_t* bucketStart = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &bucketStart, numRows + 2) );
+  for (size_t length = 0; length <= numRows + 1; ++length)
+    bucketStart[length] = 0;
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    size_t length = columnSlice ? columnSlice[column + 1] - columnSlice[column]
+      : columnSlice32[column + 1] - columnSlice32[column];
+    bucketStart[numRows - length + 1]++;
+  }
+  for (size_t b = 1; b <= numRows + 1; ++b)
+    bucketStart[b] += bucketStart[b - 1];
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    size_t length = columnSlice ? columnSlice[column + 1] - columnSlice[column]
+      : columnSlice32[column + 1] - columnSlice32[column];
+    densityOrder[bucketStart[numRows - length]++] = column;
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &bucketStart) );
+
+  /* Unprocessed columns with a positive number of covered nonzeros are in doubly-linked bucket lists. */
+  size_t* columnsCovered = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsCovered, numColumns + 1) );
+  size_t* columnsNext = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsNext, numColumns + 1) );
+  size_t* columnsPrevious = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsPrevious, numColumns + 1) );
+  bool* columnsProcessed = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsProcessed, numColumns + 1) );
+  size_t* bucketFirst = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &bucketFirst, numRows + 2) );
+  bool* rowsCovered = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsCovered, numRows + 1) );
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    columnsCovered[column] = 0;
+    columnsProcessed[column] = false;
+  }
+  for (size_t b = 0; b <= numRows + 1; ++b)
+    bucketFirst[b] = SIZE_MAX;
+  for (size_t row = 0; row < numRows; ++row)
+    rowsCovered[row] = false;
+
+  size_t maxBucket = 0;
+  size_t nextDense = 0;
+  for (size_t c = 0; c < numColumns; ++c)
+  {
+    while (maxBucket > 0 && bucketFirst[maxBucket] == SIZE_MAX)
+      --maxBucket;
+
+    size_t column;
+    if (maxBucket > 0)
+    {
+      column = bucketFirst[maxBucket];
+      bucketFirst[maxBucket] = columnsNext[column];
+      if (columnsNext[column] != SIZE_MAX)
+        columnsPrevious[columnsNext[column]] = SIZE_MAX;
+    }
+    else
+    {
+      while (columnsProcessed[densityOrder[nextDense]])
+        ++nextDense;
+      column = densityOrder[nextDense];
+    }
+    columnsProcessed[column] = true;
+    order[c] = column;
+
+    size_t first = columnSlice ? columnSlice[column] : columnSlice32[column];
+    size_t beyond = columnSlice ? columnSlice[column + 1] : columnSlice32[column + 1];
+    for (size_t e = first; e < beyond; ++e)
+    {
+      size_t row = columnRows ? columnRows[e] : columnRows32[e];
+      if (rowsCovered[row])
+        continue;
+      rowsCovered[row] = true;
+
+      /* Move all unprocessed columns of this row to the next bucket. */
+      for (size_t f = rowSlice[row]; f < rowSlice[row + 1]; ++f)
+      {
+        size_t neighbor = rowColumns[f];
+        if (columnsProcessed[neighbor])
+          continue;
+
+        size_t bucket = columnsCovered[neighbor];
+        if (bucket > 0)
+        {
+          if (columnsPrevious[neighbor] == SIZE_MAX)
+            bucketFirst[bucket] = columnsNext[neighbor];
+          else
+            columnsNext[columnsPrevious[neighbor]] = columnsNext[neighbor];
+          if (columnsNext[neighbor] != SIZE_MAX)
+            columnsPrevious[columnsNext[neighbor]] = columnsPrevious[neighbor];
         }
+        ++bucket;
+        columnsCovered[neighbor] = bucket;
+        columnsPrevious[neighbor] = SIZE_MAX;
+        columnsNext[neighbor] = bucketFirst[bucket];
+        if (bucketFirst[bucket] != SIZE_MAX)
+          columnsPrevious[bucketFirst[bucket]] = neighbor;
+        bucketFirst[bucket] = neighbor;
+        if (bucket > maxBucket)
+          maxBucket = bucket;
+      }
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsCovered) );
+  CMR_CALL( CMRfreeStackArray(cmr, &bucketFirst) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsProcessed) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsPrevious) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsNext) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsCovered) );
+  CMR_CALL( CMRfreeStackArray(cmr, &densityOrder) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Computes the order of the columns for \p order, which must not be \ref CMR_GRAPHIC_ORDER_INPUT.
+ */
 
-        CMR_CALL( decToGraph(dec, graph, true, forest, coforest, NULL) );
+static
+CMR_ERROR computeColumnOrder(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_GRAPHIC_ORDER order,  /**< Requested order. */
+  size_t numRows,           /**< Number of rows of the matrix. */
+  size_t numColumns,        /**< Number of columns of the matrix. */
+  size_t* columnSlice,      /**< Array with the first entry of each column and the total count, or \c NULL if the
+                             **  32-bit arrays are given. */
+  size_t* columnRows,       /**< Array with the rows of all entries. */
+  uint32_t* columnSlice32,  /**< Like \p columnSlice, but with 32-bit indices (used if \p columnSlice is \c NULL). */
+  uint32_t* columnRows32,   /**< Like \p columnRows, but with 32-bit indices. */
+  size_t* rowSlice,         /**< Array with the first entry of each row and the total count. */
+  size_t* rowColumns,       /**< Array with the columns of all entries. */
+  size_t* columnOrder       /**< Array for storing the order. */
+)
+{
+  assert(cmr);
+  assert(columnOrder);
+
+  if (order == CMR_GRAPHIC_ORDER_CONNECTED)
+  {
+    CMR_CALL( computeConnectedColumnOrder(cmr, numRows, numColumns, columnSlice, columnRows, columnSlice32,
+      columnRows32, rowSlice, rowColumns, columnOrder) );
+  }
+  else
+  {
+    assert(order == CMR_GRAPHIC_ORDER_REJECT);
+    CMR_CALL( computeRejectColumnOrder(cmr, numRows, numColumns, columnSlice, columnRows, columnSlice32,
+      columnRows32, rowSlice, rowColumns, columnOrder) );
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Tests a matrix that is given column-wise for graphicness.
+ *
+ * The rows of column \f$ j \f$ are \p columnRows[\p columnSlice[j]], ..., \p columnRows[\p columnSlice[j+1]-1]. This
+ * way callers can pass the rows of a matrix (to test its transpose) or a column-wise view without creating a
+ * \ref CMR_CHRMAT. The decomposition and the newcolumn structure are returned to the caller, who must free them.
+ */
+
+static
+CMR_ERROR graphicTestColumns(
+  CMR* cmr,                               /**< \ref CMR environment. */
+  size_t numRows,                         /**< Number of rows of the matrix. */
+  size_t numColumns,                      /**< Number of columns of the matrix. */
+  size_t numNonzeros,                     /**< Number of nonzeros of the matrix. */
+  size_t* columnSlice,                    /**< Array with the first entry of each column and the total count, or
+                                           **  \c NULL if the 32-bit arrays are given. */
+  size_t* columnRows,                     /**< Array with the rows of all entries. */
+  uint32_t* columnSlice32,                /**< Like \p columnSlice, but with 32-bit indices (used if \p columnSlice is
+                                           **  \c NULL). */
+  uint32_t* columnRows32,                 /**< Like \p columnRows, but with 32-bit indices. */
+  size_t* columnOrder,                    /**< Order in which the columns are added (\c NULL for the input order). */
+  bool* pisGraphic,                       /**< Pointer for storing whether the matrix is graphic. */
+  CMR_GRAPH** pgraph,                     /**< Pointer for storing the graph (may be \c NULL). */
+  CMR_GRAPH_EDGE** pforestEdges,          /**< Pointer for storing the spanning forest (may be \c NULL). */
+  CMR_GRAPH_EDGE** pcoforestEdges,        /**< Pointer for storing the complementary edges (may be \c NULL). */
+  Dec** pdec,                             /**< Pointer for storing the decomposition (\c NULL if no nonzeros). */
+  DEC_NEWCOLUMN** pnewcolumn,             /**< Pointer for storing the newcolumn structure (if created). */
+  CMR_GRAPHIC_CHECKPOINT checkpoint,      /**< Callback for graphic prefixes of the columns (may be \c NULL). */
+  void* checkpointData,                   /**< User data passed to \p checkpoint. */
+  bool* pstopped,                         /**< Pointer for storing whether \p checkpoint stopped the test (may be
+                                           **  \c NULL if \p checkpoint is \c NULL). */
+  CMR_GRAPHIC_STATISTICS* stats,          /**< Statistics for the computation (may be \c NULL). */
+  const CMR_DEADLINE* deadline            /**< Deadline to impose. */
+)
+{
+  assert(cmr);
+  assert(columnSlice || columnSlice32);
+  assert(pisGraphic);
+  assert(pdec);
+  assert(pnewcolumn);
+  assert(!checkpoint || pstopped);
+  assert(!checkpoint || !columnOrder);
+
+  *pisGraphic = true;
+  *pdec = NULL;
+  *pnewcolumn = NULL;
+  if (pstopped)
+    *pstopped = false;
+
+  /* Graph, forest and coforest of the prefixes passed to the checkpoint callback. */
+  CMR_GRAPH* checkpointGraph = NULL;
+  CMR_GRAPH_EDGE* checkpointForest = NULL;
+  CMR_GRAPH_EDGE* checkpointCoforest = NULL;
+  size_t numPrefixNonzeros = 0;
+  size_t nextCheckpoint = numRows + numColumns;
+
+  if (numNonzeros > 0)
+  {
+    CMR_CALL( decCreateForMatrix(cmr, pdec, numRows, numColumns, numNonzeros) );
+    Dec* dec = *pdec;
+
+    /* With 32-bit indices, the rows of each column are expanded into a buffer that stays in cache. */
+    size_t* rowsBuffer = NULL;
+    if (!columnSlice)
+      CMR_CALL( CMRallocStackArray(cmr, &rowsBuffer, numRows > 0 ? numRows : 1) );
+
+    /* Process each column. */
+    CMR_CALL( newcolumnCreate(cmr, pnewcolumn) );
+    DEC_NEWCOLUMN* newcolumn = *pnewcolumn;
+    for (size_t c = 0; c < numColumns && *pisGraphic; ++c)
+    {
+      size_t column = columnOrder ? columnOrder[c] : c;
+      double checkClock = CMRclockNow();
+      CMR_COUNTERS_SAMPLE checkSample;
+      CMRcountersStart(cmr, &checkSample);
+      if (CMRdeadlinePassedAt(deadline, checkClock))
+      {
+        if (checkpointGraph)
+        {
+          CMR_CALL( CMRfreeBlockArray(cmr, &checkpointCoforest) );
+          CMR_CALL( CMRfreeBlockArray(cmr, &checkpointForest) );
+          CMR_CALL( CMRgraphFree(cmr, &checkpointGraph) );
+        }
+        if (rowsBuffer)
+          CMR_CALL( CMRfreeStackArray(cmr, &rowsBuffer) );
+        CMR_CALL( newcolumnFree(cmr, pnewcolumn) );
+        CMR_CALL( decFree(pdec) );
+        return CMR_ERROR_TIMEOUT;
+      }
+
+      size_t* rows;
+      size_t numColumnRows;
+      if (columnSlice)
+      {
+        rows = &columnRows[columnSlice[column]];
+        numColumnRows = columnSlice[column+1] - columnSlice[column];
       }
       else
       {
-        CMR_CALL( CMRgraphClear(cmr, graph) );
-        /* Construct a path with numRows edges and with numColumns loops at 0. */
+        rows = rowsBuffer;
+        numColumnRows = columnSlice32[column+1] - columnSlice32[column];
+        uint32_t* columnRows = &columnRows32[columnSlice32[column]];
+        for (size_t i = 0; i < numColumnRows; ++i)
+          rows[i] = columnRows[i];
+      }
+
+      CMR_CALL( addColumnCheck(dec, newcolumn, rows, numColumnRows) );
+      if (stats)
+      {
+        stats->checkCount++;
+        stats->checkTime += CMRclockNow() - checkClock;
+        CMRcountersStop(&checkSample, &stats->checkCounters);
+      }
+
+      debugDot(dec, newcolumn);
 
-        CMR_GRAPH_NODE s;
-        CMR_CALL( CMRgraphAddNode(cmr, graph, &s) );
-        for (size_t c = 0; c < matrix->numRows; ++c)
+      if (newcolumn->remainsGraphic)
+      {
+        double applyClock = (stats ? CMRclockNow() : 0.0);
+        CMR_COUNTERS_SAMPLE applySample;
+        CMRcountersStart(cmr, &applySample);
+
+        CMR_CALL( addColumnApply(dec, newcolumn, column, rows, numColumnRows) );
+
+        if (stats)
         {
-          CMR_GRAPH_EDGE e;
-          CMR_CALL( CMRgraphAddEdge(cmr, graph, s, s, &e) );
-          if (coforest)
-            *coforest++ = e;
+          stats->applyCount++;
+          stats->applyTime += CMRclockNow() - applyClock;
+          CMRcountersStop(&applySample, &stats->applyCounters);
         }
-        for (size_t r = 0; r < matrix->numColumns; ++r)
+
+        /* The graph of a prefix is obtained from the current decomposition, which is then extended further. Since
+         * this takes time linear in the size of the graph, the prefixes' numbers of nonzeros grow geometrically. */
+        numPrefixNonzeros += numColumnRows;
+        if (checkpoint && numPrefixNonzeros >= nextCheckpoint && column + 1 < numColumns)
         {
-          CMR_GRAPH_NODE t;
-          CMR_CALL( CMRgraphAddNode(cmr, graph, &t) );
-          CMR_GRAPH_EDGE e;
-          CMR_CALL( CMRgraphAddEdge(cmr, graph, s, t, &e) );
-          if (forest)
-            *forest++ = e;
-          s = t;
+          if (!checkpointGraph)
+          {
+            CMR_CALL( CMRgraphCreateEmpty(cmr, &checkpointGraph, numRows + 2 * numColumns,
+              numRows + 3 * numColumns) );
+            CMR_CALL( CMRallocBlockArray(cmr, &checkpointForest, numRows) );
+            CMR_CALL( CMRallocBlockArray(cmr, &checkpointCoforest, numColumns) );
+          }
+          CMR_CALL( decComputeGraph(cmr, dec, numRows, column + 1, checkpointGraph, checkpointForest,
+            checkpointCoforest) );
+          CMR_CALL( checkpoint(cmr, column + 1, checkpointGraph, checkpointForest, checkpointCoforest, checkpointData,
+            pstopped) );
+          nextCheckpoint = 2 * numPrefixNonzeros;
+          if (*pstopped)
+            break;
         }
-
-        CMRdbgMsg(0, "Constructed graph with %d nodes and %d edges.\n", CMRgraphNumNodes(graph), CMRgraphNumEdges(graph));
       }
+      else
+        *pisGraphic = false;
     }
+
+    if (checkpointGraph)
+    {
+      CMR_CALL( CMRfreeBlockArray(cmr, &checkpointCoforest) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &checkpointForest) );
+      CMR_CALL( CMRgraphFree(cmr, &checkpointGraph) );
+    }
+    if (rowsBuffer)
+      CMR_CALL( CMRfreeStackArray(cmr, &rowsBuffer) );
   }
 
-  if (dec)
-    CMR_CALL( decFree(&dec) );
+  if (*pisGraphic && !(pstopped && *pstopped))
+  {
+    /* Allocate memory for graph, forest and coforest. */
+
+    CMR_GRAPH* graph = NULL;
+    if (pgraph)
+    {
+      if (!*pgraph)
+        CMR_CALL( CMRgraphCreateEmpty(cmr, pgraph, numRows + 2 * numColumns, numRows + 3 * numColumns) );
+      graph = *pgraph;
+    }
+
+    int* forest = NULL;
+    if (pforestEdges)
+    {
+      if (!*pforestEdges)
+        CMR_CALL( CMRallocBlockArray(cmr, pforestEdges, numRows) );
+      forest = *pforestEdges;
+    }
+    int* coforest = NULL;
+    if (pcoforestEdges)
+    {
+      if (!*pcoforestEdges)
+        CMR_CALL( CMRallocBlockArray(cmr, pcoforestEdges, numColumns) );
+      coforest = *pcoforestEdges;
+    }
+
+    if (graph)
+      CMR_CALL( decComputeGraph(cmr, *pdec, numRows, numColumns, graph, forest, coforest) );
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Searches for a minimal non-cographic submatrix of \p matrix, reusing \p *pdec and \p *pnewcolumn.
+ */
+
+static
+CMR_ERROR cographicnessSearchSubmatrix(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,         /**< Non-cographic matrix. */
+  Dec** pdec,                 /**< Pointer to decomposition to be reused (may point to \c NULL). */
+  DEC_NEWCOLUMN** pnewcolumn, /**< Pointer to newcolumn structure to be reused (may point to \c NULL). */
+  CMR_SUBMAT** psubmatrix,    /**< Pointer for storing the submatrix. */
+  double timeLimit            /**< Time limit to impose. */
+)
+{
+  /* Worker 0 reuses the given structures, while the others create their own. */
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, matrix->numRows + matrix->numColumns);
+  CographicnessTestMemory* memory = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &memory, numWorkers) );
+  void** testData = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &testData, numWorkers) );
+  for (size_t w = 0; w < numWorkers; ++w)
+  {
+    memory[w].dec = w == 0 ? *pdec : NULL;
+    memory[w].newcolumn = w == 0 ? *pnewcolumn : NULL;
+    testData[w] = &memory[w];
+  }
+
+  CMR_ERROR error = CMRtestHereditaryPropertyParallel(cmr, matrix, cographicnessTest, numWorkers, testData,
+    psubmatrix, timeLimit);
+
+  *pdec = memory[0].dec;
+  *pnewcolumn = memory[0].newcolumn;
+  for (size_t w = 1; w < numWorkers; ++w)
+  {
+    if (memory[w].newcolumn)
+      CMR_CALL( newcolumnFree(cmr, &memory[w].newcolumn) );
+    if (memory[w].dec)
+      CMR_CALL( decFree(&memory[w].dec) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &testData) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &memory) );
+
+  return error;
+}
+
+/**
+ * \brief Creates a column-wise view of \p matrix that only stores the rows of the nonzeros.
+ *
+ * The arrays must be freed via \ref CMRfreeStackArray in reverse order.
+ */
+
+static
+CMR_ERROR createColumnView(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,     /**< Matrix. */
+  size_t** pcolumnSlice,  /**< Pointer for storing the first entry of each column and the total count. */
+  size_t** pcolumnRows    /**< Pointer for storing the rows of all entries. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+
+  CMR_CALL( CMRallocStackArray(cmr, pcolumnSlice, matrix->numColumns + 1) );
+  CMR_CALL( CMRallocStackArray(cmr, pcolumnRows, matrix->numNonzeros > 0 ? matrix->numNonzeros : 1) );
+  size_t* columnSlice = *pcolumnSlice;
+  size_t* columnRows = *pcolumnRows;
+  for (size_t column = 0; column <= matrix->numColumns; ++column)
+    columnSlice[column] = 0;
+  for (size_t e = 0; e < matrix->numNonzeros; ++e)
+    columnSlice[matrix->entryColumns[e] + 1]++;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+    columnSlice[column + 1] += columnSlice[column];
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+      columnRows[columnSlice[matrix->entryColumns[e]]++] = row;
+  }
+  for (size_t column = matrix->numColumns; column > 0; --column)
+    columnSlice[column] = columnSlice[column - 1];
+  columnSlice[0] = 0;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Tests a matrix for being cographic like \ref CMRgraphicTestTransposeCheckpoints, processing its rows in the
+ *        given \p order.
+ *
+ * Checkpoints refer to prefixes of the rows and are therefore only supported for \ref CMR_GRAPHIC_ORDER_INPUT.
+ */
+
+static
+CMR_ERROR graphicTestTranspose(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,                 /**< Matrix \f$ M \f$ */
+  CMR_GRAPHIC_ORDER order,            /**< Order in which the rows are processed. */
+  bool* pisCographic,                 /**< Returns true if and only if \f$ M \f$ is a cographic matrix. */
+  bool* pstopped,                     /**< Pointer for storing whether \p checkpoint stopped the test. */
+  CMR_GRAPH** pgraph,                 /**< Pointer for storing the graph \f$ G \f$ (if \f$ M \f$ is graphic). */
+  CMR_GRAPH_EDGE** pforestEdges,      /**< Pointer for storing \f$ T \f$ (if \f$ M \f$ is graphic). */
+  CMR_GRAPH_EDGE** pcoforestEdges,    /**< Pointer for storing \f$ E \setminus T \f$ (if \f$ M \f$ is graphic). */
+  CMR_SUBMAT** psubmatrix,            /**< Pointer for storing a minimal non-graphic submatrix. */
+  CMR_GRAPHIC_CHECKPOINT checkpoint,  /**< Callback for cographic prefixes (may be \c NULL). */
+  void* checkpointData,               /**< User data passed to \p checkpoint. */
+  CMR_GRAPHIC_STATISTICS* stats,      /**< Pointer to statistics (may be \c NULL). */
+  double timeLimit                    /**< Time limit to impose. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(!psubmatrix || !*psubmatrix);
+  assert(!pforestEdges || pgraph);
+  assert(!pcoforestEdges || pgraph);
+  assert(pisCographic);
+  assert(!checkpoint || pstopped);
+  assert(!checkpoint || order == CMR_GRAPHIC_ORDER_INPUT);
+
+#if defined(CMR_DEBUG)
+  CMRdbgMsg(0, "CMRgraphicTestTranspose called for a %dx%d matrix\n", matrix->numRows, matrix->numColumns);
+  CMRchrmatPrintDense(cmr, matrix, stdout, '0', true);
+#endif /* CMR_DEBUG */
+
+  double time = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
+
+  /* The rows of matrix are the columns of its transpose. Other orders than the input order need the columns of
+   * matrix as well, for which a transient view suffices. */
+  size_t* rowOrder = NULL;
+  if (order != CMR_GRAPHIC_ORDER_INPUT)
+  {
+    CMR_CALL( CMRallocStackArray(cmr, &rowOrder, matrix->numRows + 1) );
+    double transposeClock = CMRclockNow();
+    size_t* columnSlice = NULL;
+    size_t* columnRows = NULL;
+    CMR_CALL( createColumnView(cmr, matrix, &columnSlice, &columnRows) );
+    if (stats)
+    {
+      stats->transposeCount++;
+      stats->transposeTime += CMRclockNow() - transposeClock;
+    }
+
+    CMR_CALL( computeColumnOrder(cmr, order, matrix->numColumns, matrix->numRows, matrix->rowSlice,
+      matrix->entryColumns, NULL, NULL, columnSlice, columnRows, rowOrder) );
+    CMR_CALL( CMRfreeStackArray(cmr, &columnRows) );
+    CMR_CALL( CMRfreeStackArray(cmr, &columnSlice) );
+  }
+
+  Dec* dec = NULL;
+  DEC_NEWCOLUMN* newcolumn = NULL;
+  CMR_ERROR error = graphicTestColumns(cmr, matrix->numColumns, matrix->numRows, matrix->numNonzeros,
+    matrix->rowSlice, matrix->entryColumns, NULL, NULL, rowOrder, pisCographic, pgraph, pforestEdges, pcoforestEdges,
+    &dec, &newcolumn, checkpoint, checkpointData, pstopped, stats, &deadline);
+  if (rowOrder)
+    CMR_CALL( CMRfreeStackArray(cmr, &rowOrder) );
+  if (error)
+    return error;
+
+  if (!*pisCographic && psubmatrix)
+  {
+    double remainingTime = CMRdeadlineRemaining(&deadline);
+    error = cographicnessSearchSubmatrix(cmr, matrix, &dec, &newcolumn, psubmatrix, remainingTime);
+  }
+
+  if (newcolumn)
+    CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+  if (dec)
+    CMR_CALL( decFree(&dec) );
+
+  if (stats)
+  {
+    stats->totalCount++;
+    stats->totalTime += CMRclockNow() - time;
+  }
+
+  return error;
+}
+
+CMR_ERROR CMRgraphicTestTransposeCheckpoints(CMR* cmr, CMR_CHRMAT* matrix, bool* pisCographic, bool* pstopped,
+  CMR_GRAPH** pgraph, CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_SUBMAT** psubmatrix,
+  CMR_GRAPHIC_CHECKPOINT checkpoint, void* checkpointData, CMR_GRAPHIC_STATISTICS* stats, double timeLimit)
+{
+  return graphicTestTranspose(cmr, matrix, CMR_GRAPHIC_ORDER_INPUT, pisCographic, pstopped, pgraph, pforestEdges,
+    pcoforestEdges, psubmatrix, checkpoint, checkpointData, stats, timeLimit);
+}
+
+CMR_ERROR CMRgraphicTestTransposeOrdered(CMR* cmr, CMR_CHRMAT* matrix, CMR_GRAPHIC_ORDER order, bool* pisCographic,
+  CMR_GRAPH** pgraph, CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_SUBMAT** psubmatrix,
+  CMR_GRAPHIC_STATISTICS* stats, double timeLimit)
+{
+  return graphicTestTranspose(cmr, matrix, order, pisCographic, NULL, pgraph, pforestEdges, pcoforestEdges,
+    psubmatrix, NULL, NULL, stats, timeLimit);
+}
+
+CMR_ERROR CMRgraphicTestTranspose(CMR* cmr, CMR_CHRMAT* matrix, bool* pisCographic, CMR_GRAPH** pgraph,
+  CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_SUBMAT** psubmatrix,
+  CMR_GRAPHIC_STATISTICS* stats, double timeLimit)
+{
+  return graphicTestTranspose(cmr, matrix, CMR_GRAPHIC_ORDER_INPUT, pisCographic, NULL, pgraph, pforestEdges,
+    pcoforestEdges, psubmatrix, NULL, NULL, stats, timeLimit);
+}
+
+/**
+ * \brief Decomposition for testing graphicness of a matrix that grows column by column.
+ */
+
+struct _CMR_GRAPHIC_ONLINE
+{
+  CMR* cmr;                 /**< \brief \ref CMR environment. */
+  size_t numRows;           /**< \brief Number of rows of the matrix. */
+  size_t numColumns;        /**< \brief Number of columns added so far. */
+  Dec* dec;                 /**< \brief Decomposition of the columns added so far. */
+  DEC_NEWCOLUMN* newcolumn; /**< \brief newcolumn structure of the last column that was tried. */
+  bool isTriedGraphic;      /**< \brief Whether the last tried column can be added. */
+};
+
+CMR_ERROR CMRgraphicOnlineCreate(CMR* cmr, CMR_GRAPHIC_ONLINE** ponline, size_t numRows)
+{
+  assert(cmr);
+  assert(ponline);
+
+  CMR_CALL( CMRallocBlock(cmr, ponline) );
+  CMR_GRAPHIC_ONLINE* online = *ponline;
+  online->cmr = cmr;
+  online->numRows = numRows;
+  online->numColumns = 0;
+  online->dec = NULL;
+  online->newcolumn = NULL;
+  online->isTriedGraphic = false;
+
+  size_t numElements = numRows + 16;
+  CMR_CALL( decCreate(cmr, &online->dec, 3 * numElements, numElements, numElements, numRows, 0) );
+  CMR_CALL( newcolumnCreate(cmr, &online->newcolumn) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgraphicOnlineFree(CMR* cmr, CMR_GRAPHIC_ONLINE** ponline)
+{
+  assert(cmr);
+  assert(ponline);
+
+  if (!*ponline)
+    return CMR_OKAY;
+
+  CMR_GRAPHIC_ONLINE* online = *ponline;
+  CMR_CALL( newcolumnFree(cmr, &online->newcolumn) );
+  CMR_CALL( decFree(&online->dec) );
+  CMR_CALL( CMRfreeBlock(cmr, ponline) );
+
+  return CMR_OKAY;
+}
+
+size_t CMRgraphicOnlineNumColumns(CMR_GRAPHIC_ONLINE* online)
+{
+  assert(online);
+
+  return online->numColumns;
+}
+
+CMR_ERROR CMRgraphicOnlineTryColumn(CMR_GRAPHIC_ONLINE* online, size_t numEntries, size_t* rows, bool* pisGraphic)
+{
+  assert(online);
+  assert(rows || !numEntries);
+  assert(pisGraphic);
+
+  for (size_t i = 0; i < numEntries; ++i)
+  {
+    if (rows[i] >= online->numRows)
+    {
+      CMRraiseErrorMessage(online->cmr, "Row %zu of new column exceeds number %zu of rows.", rows[i],
+        online->numRows);
+      return CMR_ERROR_INPUT;
+    }
+  }
+
+  CMR_CALL( addColumnCheck(online->dec, online->newcolumn, rows, numEntries) );
+  online->isTriedGraphic = online->newcolumn->remainsGraphic;
+  *pisGraphic = online->isTriedGraphic;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgraphicOnlineAddColumn(CMR_GRAPHIC_ONLINE* online, size_t numEntries, size_t* rows)
+{
+  assert(online);
+  assert(rows || !numEntries);
+
+  if (!online->isTriedGraphic)
+  {
+    CMRraiseErrorMessage(online->cmr, "Adding a column requires a previous successful test of that column.");
+    return CMR_ERROR_INVALID;
+  }
+
+  CMR_CALL( addColumnApply(online->dec, online->newcolumn, online->numColumns, rows, numEntries) );
+  online->numColumns++;
+  online->isTriedGraphic = false;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgraphicOnlineComputeGraph(CMR_GRAPHIC_ONLINE* online, CMR_GRAPH** pgraph, CMR_GRAPH_EDGE** pforestEdges,
+  CMR_GRAPH_EDGE** pcoforestEdges)
+{
+  assert(online);
+  assert(pgraph);
 
-  if (!*pisCographic && psubmatrix)
+  CMR* cmr = online->cmr;
+  if (!*pgraph)
   {
-    /* Find submatrix. */
-    double remainingTime = timeLimit - (clock() - time) * 1.0 / CLOCKS_PER_SEC;
-    CMR_CALL( CMRtestHereditaryPropertySimple(cmr, matrix, cographicnessTest, NULL, psubmatrix, remainingTime) );
+    CMR_CALL( CMRgraphCreateEmpty(cmr, pgraph, online->numRows + 2 * online->numColumns,
+      online->numRows + 3 * online->numColumns) );
   }
+  if (pforestEdges && !*pforestEdges)
+    CMR_CALL( CMRallocBlockArray(cmr, pforestEdges, online->numRows) );
+  if (pcoforestEdges && !*pcoforestEdges)
+    CMR_CALL( CMRallocBlockArray(cmr, pcoforestEdges, online->numColumns) );
 
-  if (stats)
+  /* This may add rows to the decomposition, so a tried column must be tried again. */
+  CMR_CALL( decComputeGraph(cmr, online->dec, online->numRows, online->numColumns, *pgraph,
+    pforestEdges ? *pforestEdges : NULL, pcoforestEdges ? *pcoforestEdges : NULL) );
+  online->isTriedGraphic = false;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Tries to append the given columns to \p dec in their order, maintaining graphicness.
+ *
+ * The appended columns are stored in \p appendedColumns.
+ */
+
+static
+CMR_ERROR greedyAppendColumns(
+  Dec* dec,                   /**< Decomposition. */
+  DEC_NEWCOLUMN* newcolumn,   /**< New column structure. */
+  CMR_CHRMAT* transpose,      /**< \f$ M^{\mathsf{T}} \f$ */
+  size_t* columns,            /**< Array with the columns to try. */
+  size_t numColumns,          /**< Number of columns to try. */
+  size_t* appendedColumns,    /**< Array for storing the appended columns. */
+  size_t* pnumAppended        /**< Pointer for storing the number of appended columns. */
+)
+{
+  assert(dec);
+  assert(newcolumn);
+  assert(transpose);
+  assert(appendedColumns);
+  assert(pnumAppended);
+
+  size_t numAppended = 0;
+  for (size_t c = 0; c < numColumns; ++c)
   {
-    stats->totalCount++;
-    stats->totalTime += (clock() - time) * 1.0 / CLOCKS_PER_SEC;
+    size_t column = columns ? columns[c] : c;
+
+    CMRdbgMsg(0, "!!! Trying to append column %d.\n", column);
+
+    int lengthColumn = transpose->rowSlice[column+1] - transpose->rowSlice[column];
+    CMR_CALL( addColumnCheck(dec, newcolumn, &transpose->entryColumns[transpose->rowSlice[column]], lengthColumn) );
+
+    CMRdbgMsg(0, "!!! Appending column %s graphicness.\n", newcolumn->remainsGraphic ? "maintains" : " would destroy");
+
+    if (newcolumn->remainsGraphic)
+    {
+      CMR_CALL( addColumnApply(dec, newcolumn, column, &transpose->entryColumns[transpose->rowSlice[column]],
+        lengthColumn) );
+      appendedColumns[numAppended++] = column;
+    }
   }
+  *pnumAppended = numAppended;
 
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRtestBinaryGraphicColumnSubmatrixGreedy(CMR* cmr, CMR_CHRMAT* transpose, size_t* orderedColumns,
+CMR_ERROR CMRgraphicTestColumnSubmatrixGreedy(CMR* cmr, CMR_CHRMAT* transpose, size_t* orderedColumns,
   CMR_SUBMAT** psubmatrix)
 {
   assert(cmr);
@@ -5452,7 +6834,7 @@ CMR_ERROR CMRtestBinaryGraphicColumnSubmatrixGreedy(CMR* cmr, CMR_CHRMAT* transp
   size_t numRows = transpose->numColumns;
   size_t numColumns = transpose->numRows;
 
-  CMRdbgMsg(0, "CMRtestBinaryGraphicColumnSubmatrixGreedy for %dx%d matrix with transpose\n", numRows, numColumns);
+  CMRdbgMsg(0, "CMRgraphicTestColumnSubmatrixGreedy for %dx%d matrix with transpose\n", numRows, numColumns);
 #if defined(CMR_DEBUG)
   CMR_CALL( CMRchrmatPrintDense(cmr, transpose, stdout, '0', true) );
 #endif /* CMR_DEBUG */
@@ -5468,39 +6850,332 @@ CMR_ERROR CMRtestBinaryGraphicColumnSubmatrixGreedy(CMR* cmr, CMR_CHRMAT* transp
 
   /* Try to add each column. */
   Dec* dec = NULL;
-  CMR_CALL( decCreate(cmr, &dec, 4096, 1024, 256, 256, 256) );
+  CMR_CALL( decCreateForMatrix(cmr, &dec, numRows, numColumns, transpose->numNonzeros) );
+  DEC_NEWCOLUMN* newcolumn = NULL;
+  CMR_CALL( newcolumnCreate(cmr, &newcolumn) );
+  CMR_CALL( greedyAppendColumns(dec, newcolumn, transpose, orderedColumns, numColumns, submatrix->columns,
+    &submatrix->numColumns) );
+
+  CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+  CMR_CALL( decFree(&dec) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgraphicTestColumnSubmatrixGreedyOrders(CMR* cmr, CMR_CHRMAT* transpose, size_t numOrders,
+  size_t** orderedColumns, size_t numPrefixColumns, CMR_SUBMAT** psubmatrix)
+{
+  assert(cmr);
+  assert(transpose);
+  assert(psubmatrix);
+
+  size_t numRows = transpose->numColumns;
+  size_t numColumns = transpose->numRows;
+
+  if (numOrders == 0 || !orderedColumns)
+    return CMRgraphicTestColumnSubmatrixGreedy(cmr, transpose, NULL, psubmatrix);
+
+  if (numPrefixColumns > numColumns)
+  {
+    CMRraiseErrorMessage(cmr, "Prefix of %zu columns is longer than the %zu columns of the matrix.",
+      numPrefixColumns, numColumns);
+    return CMR_ERROR_INPUT;
+  }
+  for (size_t k = 1; k < numOrders; ++k)
+  {
+    for (size_t c = 0; c < numPrefixColumns; ++c)
+    {
+      if (orderedColumns[k][c] != orderedColumns[0][c])
+      {
+        CMRraiseErrorMessage(cmr, "Column orders #0 and #%zu differ at position %zu of the common prefix.", k, c);
+        return CMR_ERROR_INPUT;
+      }
+    }
+  }
+
+  CMRdbgMsg(0, "CMRgraphicTestColumnSubmatrixGreedyOrders for %zux%zu matrix with %zu orders and a prefix of %zu"
+    " columns.\n", numRows, numColumns, numOrders, numPrefixColumns);
+
+  CMR_CALL( CMRsubmatCreate(cmr, numRows, numColumns, psubmatrix) );
+  CMR_SUBMAT* submatrix = *psubmatrix;
+  for (size_t row = 0; row < numRows; ++row)
+    submatrix->rows[row] = row;
 
-  /* Process each column. */
+  Dec* dec = NULL;
+  CMR_CALL( decCreateForMatrix(cmr, &dec, numRows, numColumns, transpose->numNonzeros) );
   DEC_NEWCOLUMN* newcolumn = NULL;
   CMR_CALL( newcolumnCreate(cmr, &newcolumn) );
-  for (size_t c = 0; c < numColumns; ++c)
+
+  /* The prefix is processed only once and every order continues from the resulting checkpoint. */
+  size_t numPrefixAppended;
+  CMR_CALL( greedyAppendColumns(dec, newcolumn, transpose, orderedColumns[0], numPrefixColumns, submatrix->columns,
+    &numPrefixAppended) );
+  submatrix->numColumns = numPrefixAppended;
+  DecCheckpoint* checkpoint = NULL;
+  if (numOrders > 1)
+    CMR_CALL( decCheckpointCreate(dec, &checkpoint) );
+
+  size_t* candidateColumns = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &candidateColumns, numColumns - numPrefixColumns + 1) );
+  for (size_t k = 0; k < numOrders; ++k)
   {
-    size_t column = orderedColumns ? orderedColumns[c] : c;
+    if (k > 0)
+    {
+      /* The marks of newcolumn refer to the decomposition before the rollback. */
+      CMR_CALL( decRollback(dec, checkpoint) );
+      newcolumnClear(newcolumn);
+    }
 
-    CMRdbgMsg(0, "!!! Trying to append column %d.\n", column);
+    size_t numAppended;
+    CMR_CALL( greedyAppendColumns(dec, newcolumn, transpose, &orderedColumns[k][numPrefixColumns],
+      numColumns - numPrefixColumns, candidateColumns, &numAppended) );
 
-    int lengthColumn = transpose->rowSlice[column+1] - transpose->rowSlice[column];
-    CMR_CALL( addColumnCheck(dec, newcolumn, &transpose->entryColumns[transpose->rowSlice[column]], lengthColumn) );
+    CMRdbgMsg(2, "Order #%zu yields %zu columns.\n", k, numPrefixAppended + numAppended);
 
-    CMRdbgMsg(0, "!!! Appending column %s graphicness.\n", newcolumn->remainsGraphic ? "maintains" : " would destroy");
+    if (k == 0 || numPrefixAppended + numAppended > submatrix->numColumns)
+    {
+      for (size_t c = 0; c < numAppended; ++c)
+        submatrix->columns[numPrefixAppended + c] = candidateColumns[c];
+      submatrix->numColumns = numPrefixAppended + numAppended;
+    }
+  }
 
-    if (newcolumn->remainsGraphic)
+  CMR_CALL( CMRfreeStackArray(cmr, &candidateColumns) );
+  CMR_CALL( decCheckpointFree(cmr, &checkpoint) );
+  CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+  CMR_CALL( decFree(&dec) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Data of the workers of \ref CMRgraphicTestColumnSubmatrixPortfolioFilter.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* transpose;              /**< \brief \f$ M^{\mathsf{T}} \f$. */
+  CMR_CHRMAT* matrix;                 /**< \brief \f$ M \f$, used for the connectivity order. */
+  size_t numOrders;                   /**< \brief Number of orders to try. */
+  unsigned int seed;                  /**< \brief Seed for the random orders. */
+  CMR_GRAPHIC_GREEDY_FILTER filter;   /**< \brief Filter applied to each greedy solution (may be \c NULL). */
+  void* filterData;                   /**< \brief User data for \ref filter. */
+  size_t nextOrder;                   /**< \brief Next order to be processed by some worker. */
+  size_t* workersBestOrder;           /**< \brief Maps each worker to the order of its largest solution. */
+  size_t* workersBestNumColumns;      /**< \brief Maps each worker to the size of its largest solution. */
+  size_t* workersBestColumns;         /**< \brief Columns of each worker's largest solution, \c numColumns each. */
+} GreedyPortfolio;
+
+/**
+ * \brief Computes the column order \p k of \ref CMRgraphicTestColumnSubmatrixPortfolioFilter.
+ *
+ * Order 0 is by decreasing number of nonzeros, order 1 is a breadth-first search in the bipartite row-column graph,
+ * order 2 is the natural one and all further orders are random.
+ */
+
+static
+CMR_ERROR greedyPortfolioOrder(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  GreedyPortfolio* portfolio, /**< Portfolio. */
+  size_t k,                   /**< Index of the order. */
+  size_t* order               /**< Array for storing the order. */
+)
+{
+  CMR_CHRMAT* transpose = portfolio->transpose;
+  size_t numColumns = transpose->numRows;
+
+  if (k == 0)
+  {
+    /* Bucket the columns by decreasing number of nonzeros, stably. */
+    size_t* bucketStart = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &bucketStart, transpose->numColumns + 2) );
+    for (size_t length = 0; length <= transpose->numColumns + 1; ++length)
+      bucketStart[length] = 0;
+    for (size_t column = 0; column < numColumns; ++column)
     {
-      CMR_CALL( addColumnApply(dec, newcolumn, column, &transpose->entryColumns[transpose->rowSlice[column]],
-        lengthColumn) );
-      submatrix->columns[submatrix->numColumns] = column;
-      submatrix->numColumns++;
+      size_t length = transpose->rowSlice[column + 1] - transpose->rowSlice[column];
+      bucketStart[transpose->numColumns - length + 1]++;
+    }
+    for (size_t b = 1; b <= transpose->numColumns + 1; ++b)
+      bucketStart[b] += bucketStart[b - 1];
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      size_t length = transpose->rowSlice[column + 1] - transpose->rowSlice[column];
+      order[bucketStart[transpose->numColumns - length]++] = column;
+    }
+    CMR_CALL( CMRfreeStackArray(cmr, &bucketStart) );
+  }
+  else if (k == 1)
+  {
+    CMR_CALL( computeConnectedColumnOrder(cmr, transpose->numColumns, numColumns, transpose->rowSlice,
+      transpose->entryColumns, NULL, NULL, portfolio->matrix->rowSlice, portfolio->matrix->entryColumns, order) );
+  }
+  else
+  {
+    for (size_t c = 0; c < numColumns; ++c)
+      order[c] = c;
+
+    if (k > 2)
+    {
+      /* Fisher-Yates shuffle with a 64-bit linear congruential generator that depends only on the seed and k. */
+      uint64_t state = ((uint64_t) portfolio->seed << 32) ^ (uint64_t) k;
+      for (size_t c = numColumns; c > 1; --c)
+      {
+        state = 6364136223846793005ULL * state + 1442695040888963407ULL;
+        size_t d = (size_t) ((state >> 33) % c);
+        size_t temp = order[c - 1];
+        order[c - 1] = order[d];
+        order[d] = temp;
+      }
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Worker of \ref CMRgraphicTestColumnSubmatrixPortfolioFilter that processes orders with its own
+ *        decomposition.
+ */
+
+static
+CMR_ERROR greedyPortfolioWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref GreedyPortfolio. */
+)
+{
+  GreedyPortfolio* portfolio = (GreedyPortfolio*) data;
+  CMR_CHRMAT* transpose = portfolio->transpose;
+  size_t numRows = transpose->numColumns;
+  size_t numColumns = transpose->numRows;
+  size_t* bestColumns = &portfolio->workersBestColumns[worker * numColumns];
+  portfolio->workersBestOrder[worker] = SIZE_MAX;
+  portfolio->workersBestNumColumns[worker] = 0;
+
+  Dec* dec = NULL;
+  CMR_CALL( decCreateForMatrix(cmr, &dec, numRows, numColumns, transpose->numNonzeros) );
+  DEC_NEWCOLUMN* newcolumn = NULL;
+  CMR_CALL( newcolumnCreate(cmr, &newcolumn) );
+  size_t* order = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &order, numColumns + 1) );
+  size_t* candidateColumns = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &candidateColumns, numColumns + 1) );
+
+  size_t k;
+  while ((k = CMRatomicFetchAdd(&portfolio->nextOrder, 1)) < portfolio->numOrders)
+  {
+    CMR_CALL( greedyPortfolioOrder(cmr, portfolio, k, order) );
+
+    size_t numCandidateColumns;
+    CMR_CALL( greedyAppendColumns(dec, newcolumn, transpose, order, numColumns, candidateColumns,
+      &numCandidateColumns) );
+    if (portfolio->filter)
+    {
+      CMR_CALL( portfolio->filter(cmr, transpose, candidateColumns, &numCandidateColumns, portfolio->filterData) );
+    }
+
+    CMRdbgMsg(2, "Order #%zu yields %zu columns.\n", k, numCandidateColumns);
+
+    /* Orders are processed in increasing order by each worker, so ties are broken in favor of smaller orders. */
+    if (portfolio->workersBestOrder[worker] == SIZE_MAX || numCandidateColumns > portfolio->workersBestNumColumns[worker])
+    {
+      portfolio->workersBestOrder[worker] = k;
+      portfolio->workersBestNumColumns[worker] = numCandidateColumns;
+      for (size_t c = 0; c < numCandidateColumns; ++c)
+        bestColumns[c] = candidateColumns[c];
     }
+
+    decClear(dec);
+    newcolumnClear(newcolumn);
   }
 
+  CMR_CALL( CMRfreeStackArray(cmr, &candidateColumns) );
+  CMR_CALL( CMRfreeStackArray(cmr, &order) );
   CMR_CALL( newcolumnFree(cmr, &newcolumn) );
   CMR_CALL( decFree(&dec) );
 
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRgraphicTestMatrix(CMR* cmr, CMR_CHRMAT* matrix, bool* pisGraphic, CMR_GRAPH** pgraph,
-  CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_SUBMAT** psubmatrix,
+CMR_ERROR CMRgraphicTestColumnSubmatrixPortfolioFilter(CMR* cmr, CMR_CHRMAT* transpose, size_t numOrders,
+  unsigned int seed, CMR_GRAPHIC_GREEDY_FILTER filter, void* filterData, CMR_SUBMAT** psubmatrix)
+{
+  assert(cmr);
+  assert(transpose);
+  assert(psubmatrix);
+
+  size_t numRows = transpose->numColumns;
+  size_t numColumns = transpose->numRows;
+  if (numOrders == 0)
+    numOrders = 1;
+
+  CMRdbgMsg(0, "CMRgraphicTestColumnSubmatrixPortfolio for %zux%zu matrix with %zu orders.\n", numRows, numColumns,
+    numOrders);
+
+  GreedyPortfolio portfolio;
+  portfolio.transpose = transpose;
+  portfolio.matrix = NULL;
+  if (numOrders > 1)
+    CMR_CALL( CMRchrmatTranspose(cmr, transpose, &portfolio.matrix) );
+  portfolio.numOrders = numOrders;
+  portfolio.seed = seed;
+  portfolio.filter = filter;
+  portfolio.filterData = filterData;
+  portfolio.nextOrder = 0;
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, numOrders);
+  portfolio.workersBestOrder = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &portfolio.workersBestOrder, numWorkers) );
+  portfolio.workersBestNumColumns = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &portfolio.workersBestNumColumns, numWorkers) );
+  portfolio.workersBestColumns = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &portfolio.workersBestColumns, numWorkers * numColumns + 1) );
+
+  if (numWorkers > 1)
+    CMR_CALL( CMRthreadsRun(cmr, numWorkers, greedyPortfolioWorker, &portfolio) );
+  else
+    CMR_CALL( greedyPortfolioWorker(cmr, 0, &portfolio) );
+
+  /* The result does not depend on the number of workers since ties are broken in favor of smaller orders. */
+  size_t bestWorker = SIZE_MAX;
+  for (size_t worker = 0; worker < numWorkers; ++worker)
+  {
+    if (portfolio.workersBestOrder[worker] == SIZE_MAX)
+      continue;
+    if (bestWorker == SIZE_MAX
+      || portfolio.workersBestNumColumns[worker] > portfolio.workersBestNumColumns[bestWorker]
+      || (portfolio.workersBestNumColumns[worker] == portfolio.workersBestNumColumns[bestWorker]
+      && portfolio.workersBestOrder[worker] < portfolio.workersBestOrder[bestWorker]))
+    {
+      bestWorker = worker;
+    }
+  }
+  assert(bestWorker != SIZE_MAX);
+
+  CMR_CALL( CMRsubmatCreate(cmr, numRows, portfolio.workersBestNumColumns[bestWorker], psubmatrix) );
+  CMR_SUBMAT* submatrix = *psubmatrix;
+  for (size_t row = 0; row < numRows; ++row)
+    submatrix->rows[row] = row;
+  for (size_t c = 0; c < submatrix->numColumns; ++c)
+    submatrix->columns[c] = portfolio.workersBestColumns[bestWorker * numColumns + c];
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &portfolio.workersBestColumns) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &portfolio.workersBestNumColumns) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &portfolio.workersBestOrder) );
+  if (portfolio.matrix)
+    CMR_CALL( CMRchrmatFree(cmr, &portfolio.matrix) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgraphicTestColumnSubmatrixPortfolio(CMR* cmr, CMR_CHRMAT* transpose, size_t numOrders,
+  unsigned int seed, CMR_SUBMAT** psubmatrix)
+{
+  return CMRgraphicTestColumnSubmatrixPortfolioFilter(cmr, transpose, numOrders, seed, NULL, NULL, psubmatrix);
+}
+
+CMR_ERROR CMRgraphicTestMatrixOrdered(CMR* cmr, CMR_CHRMAT* matrix, CMR_GRAPHIC_ORDER order, bool* pisGraphic,
+  CMR_GRAPH** pgraph, CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_SUBMAT** psubmatrix,
   CMR_GRAPHIC_STATISTICS* stats, double timeLimit)
 {
   assert(cmr);
@@ -5515,34 +7190,188 @@ CMR_ERROR CMRgraphicTestMatrix(CMR* cmr, CMR_CHRMAT* matrix, bool* pisGraphic, C
   CMR_CALL( CMRchrmatPrintDense(cmr, matrix, stdout, '0', true) );
 #endif /* CMR_DEBUG */
 
-  /* Create transpose of matrix. */
-  clock_t transposeClock;
-  double transposeTime;
+  double time = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
+
+  /* Create a column-wise view of matrix. It only stores the rows of the nonzeros, and no values. If the dimensions
+   * allow, 32-bit indices are used, which halves the memory of the view. */
+  size_t* columnSlice = NULL;
+  size_t* columnRows = NULL;
+  uint32_t* columnSlice32 = NULL;
+  uint32_t* columnRows32 = NULL;
+  if (CMRchrmat32Fits(matrix->numRows, matrix->numColumns, matrix->numNonzeros))
+  {
+    CMR_CALL( CMRallocStackArray(cmr, &columnSlice32, matrix->numColumns + 1) );
+    CMR_CALL( CMRallocStackArray(cmr, &columnRows32, matrix->numNonzeros > 0 ? matrix->numNonzeros : 1) );
+    for (size_t column = 0; column <= matrix->numColumns; ++column)
+      columnSlice32[column] = 0;
+    for (size_t e = 0; e < matrix->numNonzeros; ++e)
+      columnSlice32[matrix->entryColumns[e] + 1]++;
+    for (size_t column = 0; column < matrix->numColumns; ++column)
+      columnSlice32[column + 1] += columnSlice32[column];
+    for (size_t row = 0; row < matrix->numRows; ++row)
+    {
+      for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+        columnRows32[columnSlice32[matrix->entryColumns[e]]++] = (uint32_t) row;
+    }
+    for (size_t column = matrix->numColumns; column > 0; --column)
+      columnSlice32[column] = columnSlice32[column - 1];
+    columnSlice32[0] = 0;
+  }
+  else
+    CMR_CALL( createColumnView(cmr, matrix, &columnSlice, &columnRows) );
+
   if (stats)
-    transposeClock = clock();
-  CMR_CHRMAT* transpose = NULL;
-  CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+  {
+    stats->transposeCount++;
+    stats->transposeTime += CMRclockNow() - time;
+  }
+
+  size_t* columnOrder = NULL;
+  if (order != CMR_GRAPHIC_ORDER_INPUT)
+  {
+    CMR_CALL( CMRallocStackArray(cmr, &columnOrder, matrix->numColumns + 1) );
+    CMR_CALL( computeColumnOrder(cmr, order, matrix->numRows, matrix->numColumns, columnSlice, columnRows,
+      columnSlice32, columnRows32, matrix->rowSlice, matrix->entryColumns, columnOrder) );
+  }
+
+  Dec* dec = NULL;
+  DEC_NEWCOLUMN* newcolumn = NULL;
+  CMR_ERROR error = graphicTestColumns(cmr, matrix->numRows, matrix->numColumns, matrix->numNonzeros, columnSlice,
+    columnRows, columnSlice32, columnRows32, columnOrder, pisGraphic, pgraph, pforestEdges, pcoforestEdges, &dec,
+    &newcolumn, NULL, NULL, NULL, stats, &deadline);
+
+  if (columnOrder)
+    CMR_CALL( CMRfreeStackArray(cmr, &columnOrder) );
+  if (columnSlice32)
+  {
+    CMR_CALL( CMRfreeStackArray(cmr, &columnRows32) );
+    CMR_CALL( CMRfreeStackArray(cmr, &columnSlice32) );
+  }
+  else
+  {
+    CMR_CALL( CMRfreeStackArray(cmr, &columnRows) );
+    CMR_CALL( CMRfreeStackArray(cmr, &columnSlice) );
+  }
+  if (error)
+    return error;
+
+  if (!*pisGraphic && psubmatrix)
+  {
+    /* The hereditary search works on explicit matrices, so only now we need the transpose. */
+    double transposeClock = CMRclockNow();
+    CMR_CHRMAT* transpose = NULL;
+    CMR_CALL( CMRchrmatGetTranspose(cmr, matrix, &transpose) );
+    if (stats)
+    {
+      stats->transposeCount++;
+      stats->transposeTime += CMRclockNow() - transposeClock;
+    }
+
+    double remainingTime = CMRdeadlineRemaining(&deadline);
+    error = cographicnessSearchSubmatrix(cmr, transpose, &dec, &newcolumn, psubmatrix, remainingTime);
+
+    /* Transpose minimal non-cographic matrix to become a minimal non-graphic matrix. */
+    if (!error && *psubmatrix)
+      CMR_CALL( CMRsubmatTranspose(*psubmatrix) );
+
+  }
+
+  if (newcolumn)
+    CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+  if (dec)
+    CMR_CALL( decFree(&dec) );
+
+  if (stats)
+  {
+    stats->totalCount++;
+    stats->totalTime += CMRclockNow() - time;
+  }
+
+  return error;
+}
+
+CMR_ERROR CMRgraphicTestMatrix(CMR* cmr, CMR_CHRMAT* matrix, bool* pisGraphic, CMR_GRAPH** pgraph,
+  CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_SUBMAT** psubmatrix,
+  CMR_GRAPHIC_STATISTICS* stats, double timeLimit)
+{
+  return CMRgraphicTestMatrixOrdered(cmr, matrix, CMR_GRAPHIC_ORDER_INPUT, pisGraphic, pgraph, pforestEdges,
+    pcoforestEdges, psubmatrix, stats, timeLimit);
+}
+
+CMR_ERROR CMRgraphicTestMatrix32(CMR* cmr, CMR_CHRMAT32* matrix, bool* pisGraphic, CMR_GRAPH** pgraph,
+  CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_GRAPHIC_STATISTICS* stats, double timeLimit)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(!pforestEdges || pgraph);
+  assert(!pcoforestEdges || pgraph);
+  assert(pisGraphic);
+
+  double time = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
 
+  /* The rows of the transpose are the columns of matrix. */
+  CMR_CHRMAT32* transpose = NULL;
+  CMR_CALL( CMRchrmat32Transpose(cmr, matrix, &transpose) );
   if (stats)
   {
     stats->transposeCount++;
-    transposeTime = (clock() - transposeClock) * 1.0 / CLOCKS_PER_SEC;
-    stats->transposeTime += transposeTime;
+    stats->transposeTime += CMRclockNow() - time;
   }
 
-  CMR_CALL( CMRgraphicTestTranspose(cmr, transpose, pisGraphic, pgraph, pforestEdges, pcoforestEdges, psubmatrix,
-    stats, timeLimit) );
+  Dec* dec = NULL;
+  DEC_NEWCOLUMN* newcolumn = NULL;
+  CMR_ERROR error = graphicTestColumns(cmr, matrix->numRows, matrix->numColumns, matrix->numNonzeros, NULL, NULL,
+    transpose->rowSlice, transpose->entryColumns, NULL, pisGraphic, pgraph, pforestEdges, pcoforestEdges, &dec, &newcolumn,
+    NULL, NULL, NULL, stats, &deadline);
+
+  CMR_CALL( CMRchrmat32Free(cmr, &transpose) );
+  if (newcolumn)
+    CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+  if (dec)
+    CMR_CALL( decFree(&dec) );
 
   if (stats)
-    stats->totalTime += transposeTime;
+  {
+    stats->totalCount++;
+    stats->totalTime += CMRclockNow() - time;
+  }
+
+  return error;
+}
+
+CMR_ERROR CMRgraphicTestTranspose32(CMR* cmr, CMR_CHRMAT32* matrix, bool* pisCographic, CMR_GRAPH** pgraph,
+  CMR_GRAPH_EDGE** pforestEdges, CMR_GRAPH_EDGE** pcoforestEdges, CMR_GRAPHIC_STATISTICS* stats, double timeLimit)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(!pforestEdges || pgraph);
+  assert(!pcoforestEdges || pgraph);
+  assert(pisCographic);
 
-  /* Transpose minimal non-cographic matrix to become a minimal non-graphic matrix. */
-  if (psubmatrix && *psubmatrix)
-    CMR_CALL( CMRsubmatTranspose(*psubmatrix) );
+  double time = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
 
-  CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+  /* The rows of matrix are the columns of its transpose. */
+  Dec* dec = NULL;
+  DEC_NEWCOLUMN* newcolumn = NULL;
+  CMR_ERROR error = graphicTestColumns(cmr, matrix->numColumns, matrix->numRows, matrix->numNonzeros, NULL, NULL,
+    matrix->rowSlice, matrix->entryColumns, NULL, pisCographic, pgraph, pforestEdges, pcoforestEdges, &dec,
+    &newcolumn, NULL, NULL, NULL, stats, &deadline);
 
-  return CMR_OKAY;
+  if (newcolumn)
+    CMR_CALL( newcolumnFree(cmr, &newcolumn) );
+  if (dec)
+    CMR_CALL( decFree(&dec) );
+
+  if (stats)
+  {
+    stats->totalCount++;
+    stats->totalTime += CMRclockNow() - time;
+  }
+
+  return error;
 }
 
 /**@}*/
@@ -8,6 +8,8 @@
  *
  * Computes the [network matrix](\ref network) \f$ M := M(D,T) \f$ for given \f$ D \f$ and optionally given (directed)
  * spanning forest \f$ T \subseteq A \f$ or the support matrix of \f$ M(D,T) \f$.
+ * The spanning forest is found by a breadth-first search that prefers the arcs of \f$ T \f$, and the columns are
+ * computed in parallel in time linear in their numbers of nonzeros.
  * If \f$ T \f$ is not given, an arbitrary (directed) spanning forest of \f$ D \f$ is used.
  * The direction of the edges is that of \p digraph, but may be flipped by specifying \p arcsReversed.
  * If \p forestArcs is \c NULL, an arbitrary (directed) spanning forest \f$ T \f$ of \f$ D \f$ is computed.
@@ -21,6 +23,7 @@ CMR_ERROR CMRcomputeRepresentationMatrix(
   CMR* cmr,                       /**< \ref CMR environment. */
   CMR_GRAPH* digraph,             /**< Digraph \f$ D = (V,A) \f$. */
   bool ternary,                   /**< Whether we need to compute correct signs. */
+  CMR_CHRMAT** pmatrix,           /**< Pointer for storing \f$ M \f$ (may be \c NULL). */
   CMR_CHRMAT** ptranspose,        /**< Pointer for storing \f$ M^{\mathsf{T}} \f$ (may be \c NULL). */
   bool* arcsReversed,             /**< Indicates, for each edge \f$ \{u, v\}\f$, whether we consider \f$ (u, v)\f$
                                    **  (if \c false) or \f$ (v,u)\f$  (if \c true). */
@@ -33,4 +36,80 @@ CMR_ERROR CMRcomputeRepresentationMatrix(
                                    **  \f$ D \f$'s underlying undirected graph (may be \c NULL). */
 );
 
+/**
+ * \brief Callback that is informed about a cographic prefix of the rows of a matrix.
+ *
+ * The graph, forest and coforest represent the first \p numRows rows of the matrix and are only valid during the
+ * call. Setting \p *pstop to \c true stops the cographicness test.
+ */
+
+typedef CMR_ERROR (*CMR_GRAPHIC_CHECKPOINT)(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  size_t numRows,                 /**< Number of rows of the prefix. */
+  CMR_GRAPH* graph,               /**< Graph of the prefix. */
+  CMR_GRAPH_EDGE* forestEdges,    /**< Spanning forest, indexed by the columns of the matrix. */
+  CMR_GRAPH_EDGE* coforestEdges,  /**< Complementary edges, indexed by the rows of the prefix. */
+  void* data,                     /**< User data passed to \ref CMRgraphicTestTransposeCheckpoints. */
+  bool* pstop                     /**< Pointer for storing whether the test shall be stopped. */
+);
+
+/**
+ * \brief Tests a matrix \f$ M \f$ for being a [cographic matrix](\ref graphic) like \ref CMRgraphicTestTranspose,
+ *        invoking \p checkpoint for cographic prefixes of its rows.
+ *
+ * The callback is invoked for prefixes whose numbers of nonzeros grow geometrically, starting at the number of rows
+ * plus columns, as long as rows remain. This way, properties that are inherited by submatrices can be checked before
+ * the whole matrix is processed, while callbacks that take time linear in the size of the prefix take at most about
+ * as long as one call for the whole matrix.
+ * If \p checkpoint stops the test, then \p *pstopped is set to \c true and neither a graph nor a submatrix is
+ * computed.
+ */
+
+CMR_ERROR CMRgraphicTestTransposeCheckpoints(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,               /**< Matrix \f$ M \f$ */
+  bool* pisCographic,               /**< Returns true if and only if \f$ M \f$ is a cographic matrix (or its tested
+                                     **  prefix if the test was stopped). */
+  bool* pstopped,                   /**< Pointer for storing whether \p checkpoint stopped the test (may be \c NULL
+                                     **  if \p checkpoint is \c NULL). */
+  CMR_GRAPH** pgraph,               /**< Pointer for storing the graph \f$ G \f$ (if \f$ M \f$ is graphic). */
+  CMR_GRAPH_EDGE** pforestEdges,    /**< Pointer for storing \f$ T \f$ (if \f$ M \f$ is graphic). */
+  CMR_GRAPH_EDGE** pcoforestEdges,  /**< Pointer for storing \f$ E \setminus T \f$ (if \f$ M \f$ is graphic). */
+  CMR_SUBMAT** psubmatrix,          /**< Pointer for storing a minimal non-graphic submatrix (if \f$ M \f$ is not
+                                     **  graphic). */
+  CMR_GRAPHIC_CHECKPOINT checkpoint,  /**< Callback for cographic prefixes (may be \c NULL). */
+  void* checkpointData,             /**< User data passed to \p checkpoint. */
+  CMR_GRAPHIC_STATISTICS* stats,    /**< Pointer to statistics (may be \c NULL). */
+  double timeLimit                  /**< Time limit to impose. */
+);
+
+/**
+ * \brief Callback that removes columns from a graphic column subset found by a greedy order.
+ *
+ * It is invoked on the \ref CMR environment of the worker that processed the order.
+ */
+
+typedef CMR_ERROR (*CMR_GRAPHIC_GREEDY_FILTER)(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT* transpose,  /**< \f$ M^{\mathsf{T}} \f$. */
+  size_t* columns,        /**< Array with the columns of the subset in the order of appending, to be modified. */
+  size_t* pnumColumns,    /**< Pointer to the number of columns of the subset, to be modified. */
+  void* data              /**< User data passed to \ref CMRgraphicTestColumnSubmatrixPortfolioFilter. */
+);
+
+/**
+ * \brief Runs \ref CMRgraphicTestColumnSubmatrixPortfolio, applying \p filter to the column subset of each order
+ *        before the subsets are compared.
+ */
+
+CMR_ERROR CMRgraphicTestColumnSubmatrixPortfolioFilter(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  CMR_CHRMAT* transpose,            /**< \f$ M^{\mathsf{T}} \f$ */
+  size_t numOrders,                 /**< Number of column orders to try. */
+  unsigned int seed,                /**< Seed for the random orders. */
+  CMR_GRAPHIC_GREEDY_FILTER filter, /**< Filter for the column subsets (may be \c NULL). */
+  void* filterData,                 /**< User data passed to \p filter. */
+  CMR_SUBMAT** psubmatrix           /**< Pointer for storing the submatrix. */
+);
+
 #endif /* CMR_GRAPHIC_INTERNAL_H */
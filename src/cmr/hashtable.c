@@ -241,6 +241,383 @@ CMR_ERROR CMRlinearhashtableArrayInsert(CMR* cmr, CMR_LINEARHASHTABLE_ARRAY* has
 }
 
 
+#if defined(CMR_LISTHASHTABLE_OPEN_ADDRESSING)
+
+/*
+ * If CMR_LISTHASHTABLE_OPEN_ADDRESSING is defined (via the cmake option LISTHASHTABLE_OPEN_ADDRESSING), the list hash
+ * table is implemented by open addressing with linear probing and Robin Hood insertion instead of separate chaining.
+ * Each slot stores the hash value together with the entry, so probing never visits the nodes, which store the values.
+ * Entries are indices of nodes and hence remain valid when entries move between slots. So far, separate chaining is
+ * faster for the sizes we benchmarked, which is why it remains the default.
+ *
+ * An entry never displaces one that is as far away from its home slot, so entries with equal hash values are enumerated
+ * from the least recently to the most recently inserted one. Separate chaining uses the opposite order.
+ */
+
+#define LISTHASHTABLE_MIN_SLOTS 16 /**< Minimum number of slots. */
+
+typedef struct
+{
+  CMR_LISTHASHTABLE_HASH hash;    /**< \brief Hash value of the node. */
+  CMR_LISTHASHTABLE_VALUE value;  /**< \brief Value of the node. */
+  CMR_LISTHASHTABLE_ENTRY next;  /**< \brief Next free node if this node is unused. */
+} ListhashtableNode;
+
+typedef struct
+{
+  CMR_LISTHASHTABLE_HASH hash;    /**< \brief Hash value of the entry. */
+  CMR_LISTHASHTABLE_ENTRY entry;  /**< \brief Entry stored in this slot, or \c SIZE_MAX if the slot is empty. */
+} ListhashtableSlot;
+
+struct _CMR_LISTHASHTABLE
+{
+  size_t numSlots;                    /**< \brief Number of slots; a power of 2. */
+  unsigned int shift;                 /**< \brief 64 minus the binary logarithm of \ref numSlots. */
+  ListhashtableSlot* slots;           /**< \brief Array with slots. */
+  size_t numEntries;                  /**< \brief Number of occupied slots. */
+
+  size_t memNodes;                    /**< \brief Memory allocated for nodes. */
+  ListhashtableNode* nodes;           /**< \brief Array with nodes. */
+  CMR_LISTHASHTABLE_ENTRY firstFree;  /**< \brief Start of free list. */
+};
+
+/**
+ * \brief Returns the home slot of \p hash.
+ *
+ * Multiplicative hashing spreads hash values that only differ in their high bits.
+ */
+
+static inline
+size_t listhashtableHome(CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_HASH hash)
+{
+  assert(hashtable);
+
+  return (size_t) (((uint64_t) hash * UINT64_C(0x9E3779B97F4A7C15)) >> hashtable->shift);
+}
+
+/**
+ * \brief Returns the distance of \p slot from the home slot of the entry stored there.
+ */
+
+static inline
+size_t listhashtableDistance(CMR_LISTHASHTABLE* hashtable, size_t slot)
+{
+  assert(hashtable);
+  assert(hashtable->slots[slot].entry != SIZE_MAX);
+
+  return (slot - listhashtableHome(hashtable, hashtable->slots[slot].hash)) & (hashtable->numSlots - 1);
+}
+
+/**
+ * \brief Places \p entry with \p hash into the slots.
+ *
+ * Starting at its home slot, the entry is placed in front of the first entry that is closer to its own home slot than
+ * the current slot is to the entry's home slot. That entry is then moved on in the same way.
+ */
+
+static
+void listhashtablePlace(CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_HASH hash, CMR_LISTHASHTABLE_ENTRY entry)
+{
+  assert(hashtable);
+  assert(hashtable->numEntries < hashtable->numSlots);
+
+  size_t mask = hashtable->numSlots - 1;
+  size_t slot = listhashtableHome(hashtable, hash);
+  size_t distance = 0;
+  while (hashtable->slots[slot].entry != SIZE_MAX)
+  {
+    size_t slotDistance = listhashtableDistance(hashtable, slot);
+    if (slotDistance < distance)
+    {
+      ListhashtableSlot displaced = hashtable->slots[slot];
+      hashtable->slots[slot].hash = hash;
+      hashtable->slots[slot].entry = entry;
+      hash = displaced.hash;
+      entry = displaced.entry;
+      distance = slotDistance;
+    }
+    slot = (slot + 1) & mask;
+    ++distance;
+  }
+  hashtable->slots[slot].hash = hash;
+  hashtable->slots[slot].entry = entry;
+}
+
+/**
+ * \brief Allocates \p numSlots empty slots.
+ */
+
+static
+CMR_ERROR listhashtableCreateSlots(CMR* cmr, CMR_LISTHASHTABLE* hashtable, size_t numSlots)
+{
+  assert(cmr);
+  assert(hashtable);
+  assert(numSlots == nextPower2(numSlots));
+
+  hashtable->numSlots = numSlots;
+  hashtable->shift = 64;
+  for (size_t n = numSlots; n > 1; n /= 2)
+    --hashtable->shift;
+  hashtable->slots = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &hashtable->slots, numSlots) );
+  for (size_t slot = 0; slot < numSlots; ++slot)
+    hashtable->slots[slot].entry = SIZE_MAX;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Doubles the number of slots.
+ */
+
+static
+CMR_ERROR listhashtableGrow(CMR* cmr, CMR_LISTHASHTABLE* hashtable)
+{
+  assert(cmr);
+  assert(hashtable);
+
+  size_t oldNumSlots = hashtable->numSlots;
+  ListhashtableSlot* oldSlots = hashtable->slots;
+  CMR_CALL( listhashtableCreateSlots(cmr, hashtable, 2 * oldNumSlots) );
+
+  /* Every run of occupied slots starts after an empty one. Reinserting each run from its start places the entries with
+   * equal hash values in the same order as before. */
+  size_t empty = 0;
+  while (oldSlots[empty].entry != SIZE_MAX)
+    ++empty;
+  for (size_t i = 1; i < oldNumSlots; ++i)
+  {
+    size_t slot = (empty + i) & (oldNumSlots - 1);
+    if (oldSlots[slot].entry != SIZE_MAX)
+      listhashtablePlace(hashtable, oldSlots[slot].hash, oldSlots[slot].entry);
+  }
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &oldSlots) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRlisthashtableCreate(CMR* cmr, CMR_LISTHASHTABLE** phashtable, size_t initialNumBuckets, size_t initialMemNodes)
+{
+  assert(cmr);
+  assert(phashtable);
+  assert(initialNumBuckets > 0);
+  assert(initialMemNodes > 0);
+
+  CMR_CALL( CMRallocBlock(cmr, phashtable) );
+  CMR_LISTHASHTABLE* hashtable = *phashtable;
+  assert(hashtable);
+
+  CMRdbgMsg(6, "Creating listhashtable with %zu buckets and memory for %zu nodes.\n", initialNumBuckets,
+    initialMemNodes);
+
+  /* Make sure that the nodes fit without growing. */
+  size_t numSlots = initialMemNodes + initialMemNodes / 3 + 1;
+  if (numSlots < initialNumBuckets)
+    numSlots = initialNumBuckets;
+  if (numSlots < LISTHASHTABLE_MIN_SLOTS)
+    numSlots = LISTHASHTABLE_MIN_SLOTS;
+  CMR_CALL( listhashtableCreateSlots(cmr, hashtable, nextPower2(numSlots)) );
+  hashtable->numEntries = 0;
+
+  hashtable->memNodes = initialMemNodes;
+  hashtable->nodes = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &hashtable->nodes, initialMemNodes) );
+  for (size_t i = 0; i < initialMemNodes-1; ++i)
+    hashtable->nodes[i].next = i+1;
+  hashtable->nodes[initialMemNodes-1].next = SIZE_MAX;
+  hashtable->firstFree = 0;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRlisthashtableFree(CMR* cmr, CMR_LISTHASHTABLE** phashtable)
+{
+  assert(cmr);
+  assert(phashtable);
+
+  CMR_LISTHASHTABLE* hashtable = *phashtable;
+  if (!hashtable)
+    return CMR_OKAY;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &hashtable->nodes) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &hashtable->slots) );
+  CMR_CALL( CMRfreeBlock(cmr, phashtable) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the slot of \p entry, or \c SIZE_MAX if it is not stored, and stores its distance in
+ *        \p *pdistance.
+ *
+ * Only the slots from the home slot of the entry's hash value on are scanned, i.e., the nodes need not know their
+ * slots, and entries can be moved between slots without touching the nodes.
+ */
+
+static inline
+size_t listhashtableSlot(CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_ENTRY entry, size_t* pdistance)
+{
+  assert(hashtable);
+
+  CMR_LISTHASHTABLE_HASH hash = hashtable->nodes[entry].hash;
+  size_t mask = hashtable->numSlots - 1;
+  size_t slot = listhashtableHome(hashtable, hash);
+  for (size_t distance = 0; hashtable->slots[slot].entry != SIZE_MAX; ++distance)
+  {
+    if (hashtable->slots[slot].entry == entry)
+    {
+      *pdistance = distance;
+      return slot;
+    }
+    if (listhashtableDistance(hashtable, slot) < distance)
+      break;
+    slot = (slot + 1) & mask;
+  }
+
+  return SIZE_MAX;
+}
+
+/**
+ * \brief Returns the first entry with \p hash in a slot from \p slot on, which has distance \p distance from the home
+ *        slot of \p hash.
+ */
+
+static inline
+CMR_LISTHASHTABLE_ENTRY listhashtableFindFrom(CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_HASH hash, size_t slot,
+  size_t distance)
+{
+  assert(hashtable);
+
+  size_t mask = hashtable->numSlots - 1;
+  while (true)
+  {
+    ListhashtableSlot* current = &hashtable->slots[slot];
+    if (current->entry == SIZE_MAX)
+      return SIZE_MAX;
+
+    if (current->hash == hash)
+      return current->entry;
+
+    /* An entry with hash would have displaced this one. */
+    if (listhashtableDistance(hashtable, slot) < distance)
+      return SIZE_MAX;
+
+    slot = (slot + 1) & mask;
+    ++distance;
+  }
+}
+
+CMR_LISTHASHTABLE_ENTRY CMRlisthashtableFindFirst(CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_HASH hash)
+{
+  assert(hashtable);
+
+  return listhashtableFindFrom(hashtable, hash, listhashtableHome(hashtable, hash), 0);
+}
+
+CMR_LISTHASHTABLE_ENTRY CMRlisthashtableFindNext(CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_HASH hash,
+  CMR_LISTHASHTABLE_ENTRY entry)
+{
+  assert(hashtable);
+  assert(entry < hashtable->memNodes);
+
+  size_t distance = 0;
+  size_t slot = listhashtableSlot(hashtable, entry, &distance);
+  assert(slot != SIZE_MAX);
+
+  return listhashtableFindFrom(hashtable, hash, (slot + 1) & (hashtable->numSlots - 1), distance + 1);
+}
+
+CMR_LISTHASHTABLE_VALUE CMRlisthashtableValue(CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_ENTRY entry)
+{
+  assert(hashtable);
+
+  return hashtable->nodes[entry].value;
+}
+
+CMR_LISTHASHTABLE_HASH CMRlisthashtableHash(CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_ENTRY entry)
+{
+  assert(hashtable);
+
+  return hashtable->nodes[entry].hash;
+}
+
+size_t CMRlisthashtableNumBuckets(CMR_LISTHASHTABLE* hashtable)
+{
+  return hashtable->numSlots;
+}
+
+CMR_ERROR CMRlisthashtableInsert(CMR* cmr, CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_HASH hash,
+  CMR_LISTHASHTABLE_VALUE value, CMR_LISTHASHTABLE_ENTRY* pentry)
+{
+  assert(cmr);
+  assert(hashtable);
+
+  /* If necessary, reallocate nodes */
+  if (hashtable->firstFree == SIZE_MAX)
+  {
+    size_t newMemNodes = 2 * hashtable->memNodes;
+    CMR_CALL( CMRreallocBlockArray(cmr, &hashtable->nodes, newMemNodes) );
+    for (size_t i = hashtable->memNodes; i+1 < newMemNodes; ++i)
+      hashtable->nodes[i].next = i+1;
+    hashtable->nodes[newMemNodes-1].next = SIZE_MAX;
+    hashtable->firstFree = hashtable->memNodes;
+    hashtable->memNodes = newMemNodes;
+  }
+
+  /* Keep the load factor at most 3/4. */
+  if (4 * (hashtable->numEntries + 1) > 3 * hashtable->numSlots)
+    CMR_CALL( listhashtableGrow(cmr, hashtable) );
+
+  CMR_LISTHASHTABLE_ENTRY entry = hashtable->firstFree;
+  ListhashtableNode* newNode = &hashtable->nodes[entry];
+  hashtable->firstFree = newNode->next;
+  newNode->hash = hash;
+  newNode->value = value;
+  listhashtablePlace(hashtable, hash, entry);
+  hashtable->numEntries++;
+  if (pentry)
+    *pentry = entry;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRlisthashtableRemove(CMR* cmr, CMR_LISTHASHTABLE* hashtable, CMR_LISTHASHTABLE_ENTRY entry)
+{
+  CMR_UNUSED(cmr);
+
+  assert(cmr);
+  assert(hashtable);
+
+  if (entry >= hashtable->memNodes)
+    return CMR_ERROR_INVALID;
+  size_t distance = 0;
+  size_t slot = listhashtableSlot(hashtable, entry, &distance);
+  if (slot == SIZE_MAX)
+    return CMR_ERROR_INVALID;
+
+  /* Shift the following entries of the run backwards. */
+  size_t mask = hashtable->numSlots - 1;
+  while (true)
+  {
+    size_t next = (slot + 1) & mask;
+    if (hashtable->slots[next].entry == SIZE_MAX || listhashtableDistance(hashtable, next) == 0)
+      break;
+
+    hashtable->slots[slot] = hashtable->slots[next];
+    slot = next;
+  }
+  hashtable->slots[slot].entry = SIZE_MAX;
+  hashtable->numEntries--;
+
+  hashtable->nodes[entry].next = hashtable->firstFree;
+  hashtable->firstFree = entry;
+
+  return CMR_OKAY;
+}
+
+#else
+
 typedef struct
 {
   CMR_LISTHASHTABLE_HASH hash;
@@ -434,3 +811,5 @@ CMR_ERROR CMRlisthashtableRemove(CMR* cmr, CMR_LISTHASHTABLE* hashtable, CMR_LIS
 
   return CMR_OKAY;
 }
+
+#endif /* CMR_LISTHASHTABLE_OPEN_ADDRESSING */
@@ -6,14 +6,19 @@
 #include <assert.h>
 #include <limits.h>
 
-CMR_ERROR CMRintheapInitStack(CMR* cmr, CMR_INTHEAP* heap, int memKeys)
+CMR_ERROR CMRintheapInitStackArity(CMR* cmr, CMR_INTHEAP* heap, int memKeys, int arity)
 {
   assert(cmr);
   assert(heap);
   assert(memKeys > 0);
+  assert(arity >= 2);
+  assert((arity & (arity - 1)) == 0);
 
   heap->memKeys = memKeys;
   heap->size = 0;
+  heap->logArity = 0;
+  while ((1 << heap->logArity) < arity)
+    ++heap->logArity;
   heap->positions = NULL;
   CMR_CALL( CMRallocStackArray(cmr, &heap->positions, memKeys) );
   for (int i = 0; i < memKeys; ++i)
@@ -26,6 +31,11 @@ CMR_ERROR CMRintheapInitStack(CMR* cmr, CMR_INTHEAP* heap, int memKeys)
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRintheapInitStack(CMR* cmr, CMR_INTHEAP* heap, int memKeys)
+{
+  return CMRintheapInitStackArity(cmr, heap, memKeys, 2);
+}
+
 CMR_ERROR CMRintheapClearStack(CMR* cmr, CMR_INTHEAP* heap)
 {
   assert(cmr);
@@ -59,40 +69,49 @@ void debugHeap(CMR_INTHEAP* heap)
 }
 #endif /* CMR_DEBUG_HEAP_CONTENT */
 
-CMR_ERROR CMRintheapInsert(CMR_INTHEAP* heap, int key, int value)
-{
-  assert(heap);
-  assert(key >= 0);
-  assert(key < heap->memKeys);
-  assert(heap->size < heap->memKeys);
-
-  CMRdbgMsg(20, "Heap insert: %d->%d.\n", key, value);
-
-  heap->data[heap->size] = key;
-  heap->positions[key] = heap->size;
-  heap->values[key] = value;
+/**
+ * \brief Moves \p key, which is stored at heap position \p current, upwards until its parent has a smaller value.
+ *
+ * Instead of swapping in each step, the parents are moved down and \p key is stored only at its final position.
+ */
 
-  int currentKey = key;
-  int current = heap->size;
-  int currentValue = value;
+static inline
+void siftUp(
+  CMR_INTHEAP* heap,  /**< Heap pointer. */
+  int key,            /**< Key of the element to move. */
+  int current         /**< Current heap position of \p key. */
+)
+{
+  int value = heap->values[key];
   while (current > 0)
   {
-    int parent = (current-1) / 2;
+    int parent = (current - 1) >> heap->logArity;
     int parentKey = heap->data[parent];
-    int parentValue = heap->values[parentKey];
-    if (parentValue <= currentValue)
+    CMRdbgMsg(22, "Parent: %d:%d->%d, child value: %d.\n", parent, parentKey, heap->values[parentKey], value);
+    if (heap->values[parentKey] <= value)
       break;
 
-    /* Move current upwards. */
-    heap->positions[currentKey] = parent;
+    /* Move parent downwards. */
+    heap->data[current] = parentKey;
     heap->positions[parentKey] = current;
-    heap->data[parent] = currentKey;
-    heap->data[current]  = parentKey;
     current = parent;
-    currentKey = parentKey;
-    currentValue = parentValue;
   }
+  heap->data[current] = key;
+  heap->positions[key] = current;
+}
+
+CMR_ERROR CMRintheapInsert(CMR_INTHEAP* heap, int key, int value)
+{
+  assert(heap);
+  assert(key >= 0);
+  assert(key < heap->memKeys);
+  assert(heap->size < heap->memKeys);
+  assert(heap->positions[key] < 0);
 
+  CMRdbgMsg(20, "Heap insert: %d->%d.\n", key, value);
+
+  heap->values[key] = value;
+  siftUp(heap, key, heap->size);
   ++heap->size;
 
   debugHeap(heap);
@@ -104,30 +123,12 @@ CMR_ERROR CMRintheapDecrease(CMR_INTHEAP* heap, int key, int newValue)
 {
   assert(heap);
   assert(heap->positions[key] >= 0);
+  assert(newValue <= heap->values[key]);
 
-  int currentKey = key;
-  int current = heap->positions[currentKey];
-  CMRdbgMsg(20, "Heap decrease: %d->%d to %d->%d.\n", key, heap->values[currentKey], key, newValue);
-  heap->values[currentKey] = newValue;
-  int currentValue = newValue;
-  while (current > 0)
-  {
-    int parent = (current-1) / 2;
-    int parentKey = heap->data[parent];
-    int parentValue = heap->values[parentKey];
-    CMRdbgMsg(12, "Parent: %d->%d.\n", parentKey, parentValue);
-    if (parentValue <= currentValue)
-      break;
+  CMRdbgMsg(20, "Heap decrease: %d->%d to %d->%d.\n", key, heap->values[key], key, newValue);
 
-    /* Move current upwards. */
-    heap->positions[currentKey] = parent;
-    heap->positions[parentKey] = current;
-    heap->data[parent] = currentKey;
-    heap->data[current]  = parentKey;
-    current = parent;
-    currentKey = parentKey;
-    currentValue = parentValue;
-  }
+  heap->values[key] = newValue;
+  siftUp(heap, key, heap->positions[key]);
 
   debugHeap(heap);
 
@@ -142,39 +143,13 @@ CMR_ERROR CMRintheapDecreaseInsert(CMR_INTHEAP* heap, int key, int newValue)
 
   CMRdbgMsg(20, "Heap decrease-insert: %d->%d.\n", key, newValue);
 
-  int currentKey = key;
-  int current;
-  if (heap->positions[key] >= 0)
-  {
-    current = heap->positions[currentKey];
-  }
+  int current = heap->positions[key];
+  if (current < 0)
+    current = heap->size++;
   else
-  {
-    current = heap->size;
-    heap->size++;
-    heap->positions[key] = current;
-    heap->data[current] = key;
-  }
-  heap->values[currentKey] = newValue;
-  int currentValue = newValue;
-  CMRdbgMsg(22, "Initial is %d:%d->%d.\n", current, currentKey, currentValue);
-
-  while (current > 0)
-  {
-    int parent = (current-1) / 2;
-    int parentKey = heap->data[parent];
-    int parentValue = heap->values[parentKey];
-    CMRdbgMsg(22, "Parent: %d:%d->%d, child value: %d.\n", parent, parentKey, parentValue, currentValue);
-    if (parentValue <= currentValue)
-      break;
-
-    /* Move current upwards. */
-    heap->positions[currentKey] = parent;
-    heap->positions[parentKey] = current;
-    heap->data[parent] = currentKey;
-    heap->data[current]  = parentKey;
-    current = parent;
-  }
+    assert(newValue <= heap->values[key]);
+  heap->values[key] = newValue;
+  siftUp(heap, key, current);
 
   debugHeap(heap);
 
@@ -184,54 +159,51 @@ CMR_ERROR CMRintheapDecreaseInsert(CMR_INTHEAP* heap, int key, int newValue)
 int CMRintheapExtractMinimum(CMR_INTHEAP* heap)
 {
   assert(heap);
+  assert(heap->size > 0);
 
   int extracted = heap->data[0];
   heap->positions[extracted] = -1;
-  heap->data[0] = heap->data[heap->size - 1];
-  heap->positions[heap->data[0]] = 0;
   --heap->size;
 
   CMRdbgMsg(20, "Heap extract: %d->%d.\n", extracted, heap->values[extracted]);
 
+  if (heap->size == 0)
+    return extracted;
+
+  /* Move the last element into the hole at the root, moving smaller children upwards. */
+  int key = heap->data[heap->size];
+  int value = heap->values[key];
   int current = 0;
-  int currentKey = heap->data[0];
-  int currentValue = heap->values[currentKey];
-  while (2*current+1 < heap->size)
+  while (true)
   {
-    int left = 2*current + 1;
-    int right = left+1;
-    int leftKey = heap->data[left];
-    int leftValue = heap->values[leftKey];
-    int rightKey = right < heap->size ? heap->data[right] : -1;
-    int rightValue = right < heap->size ? heap->values[rightKey] : INT_MAX;
-    if (leftValue < rightValue)
+    int first = (current << heap->logArity) + 1;
+    if (first >= heap->size)
+      break;
+    int beyond = first + (1 << heap->logArity);
+    if (beyond > heap->size)
+      beyond = heap->size;
+
+    int minChild = first;
+    int minValue = heap->values[heap->data[first]];
+    for (int child = first + 1; child < beyond; ++child)
     {
-      if (currentValue <= leftValue)
-        break;
-
-      CMRdbgMsg(22, "Swapping %d:%d->%d with left child %d:%d->%d.\n", current, currentKey, currentValue, left, leftKey,
-        leftValue);
-      heap->positions[leftKey] = current;
-      heap->positions[currentKey] = left;
-      heap->data[current] = leftKey;
-      heap->data[left] = currentKey;
-      current = left;
+      int childValue = heap->values[heap->data[child]];
+      if (childValue < minValue)
+      {
+        minChild = child;
+        minValue = childValue;
+      }
     }
-    else
-    {
-      if (currentValue <= rightValue)
-        break;
-
-      CMRdbgMsg(22, "Swapping %d:%d->%d with right child %d:%d->%d.\n", current, currentKey, currentValue, right, rightKey,
-        rightValue);
+    if (value <= minValue)
+      break;
 
-      heap->positions[rightKey] = current;
-      heap->positions[currentKey] = right;
-      heap->data[current] = rightKey;
-      heap->data[right] = currentKey;
-      current = right;
-    }
+    CMRdbgMsg(22, "Moving child %d:%d->%d upwards.\n", minChild, heap->data[minChild], minValue);
+    heap->data[current] = heap->data[minChild];
+    heap->positions[heap->data[current]] = current;
+    current = minChild;
   }
+  heap->data[current] = key;
+  heap->positions[key] = current;
 
   debugHeap(heap);
 
@@ -5,18 +5,22 @@
 #include "env_internal.h"
 #include <limits.h>
 
-#ifdef __cplus
+#ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
  * \brief Structure for min-heap with unsigned int values.
+ *
+ * Every heap node has 2^\c logArity children. The default is a binary heap, while a 4-ary heap is shallower and
+ * touches fewer cache lines per operation.
  */
 
 typedef struct
 {
   int size;       /**< \brief Current size of the heap. */
   int memKeys;    /**< \brief Memory for keys. */
+  int logArity;   /**< \brief Binary logarithm of the number of children of each heap node. */
   int* values;    /**< \brief Array that maps keys to values. */
   int* positions; /**< \brief Array that maps keys to heap positions. */
   int* data;      /**< \brief Array that maps heap positions to keys. */
@@ -32,6 +36,17 @@ CMR_ERROR CMRintheapInitStack(
   int memKeys       /**< Maximum number of elements and bound on key entries. */
 );
 
+/**
+ * \brief Initializes an empty heap whose nodes have \p arity children using stack memory.
+ */
+
+CMR_ERROR CMRintheapInitStackArity(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_INTHEAP* heap, /**< Heap pointer. */
+  int memKeys,      /**< Maximum number of elements and bound on key entries. */
+  int arity         /**< Number of children of each heap node; must be a power of 2. */
+);
+
 /**
  * \brief Clears the given \p heap.
  */
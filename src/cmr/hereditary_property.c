@@ -1,8 +1,122 @@
 // #define CMR_DEBUG /* Uncomment to debug. */
 
 #include "hereditary_property.h"
+#include "deadline.h"
+#include "matrix_internal.h"
+#include "threads.h"
+
 #include <stdint.h>
-#include <time.h>
+
+/**
+ * \brief Overwrites \p result by the nonzeros of \p view, except for those in excluded rows or columns.
+ *
+ * The view must have the index space of its parent matrix, which must have at most as many nonzeros as \p result
+ * has memory for.
+ */
+
+static
+void fillFromView(
+  CMR_CHRMAT_VIEW* view,  /**< View of a matrix with identity row and column maps. */
+  bool* rowExcluded,      /**< Array indicating which rows shall be excluded (may be \c NULL). */
+  bool* columnExcluded,   /**< Array indicating which columns shall be excluded (may be \c NULL). */
+  CMR_CHRMAT* result      /**< Matrix to be overwritten. */
+)
+{
+  CMR_CHRMAT* parent = view->parent;
+  result->numNonzeros = 0;
+  for (size_t row = 0; row < view->numRows; ++row)
+  {
+    result->rowSlice[row] = result->numNonzeros;
+    if (CMRchrmatViewIsRowHidden(view, row) || (rowExcluded && rowExcluded[row]))
+      continue;
+    size_t first = parent->rowSlice[row];
+    size_t beyond = parent->rowSlice[row + 1];
+    for (size_t e = first; e < beyond; ++e)
+    {
+      size_t column = view->parentColumns[parent->entryColumns[e]];
+      if (column == SIZE_MAX || (columnExcluded && columnExcluded[column]))
+        continue;
+      result->entryColumns[result->numNonzeros] = column;
+      result->entryValues[result->numNonzeros] = parent->entryValues[e];
+      result->numNonzeros++;
+    }
+  }
+  result->rowSlice[view->numRows] = result->numNonzeros;
+}
+
+/**
+ * \brief Hides every row and column of \p view that is not in \p submatrix.
+ */
+
+static
+CMR_ERROR restrictToSubmatrix(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT_VIEW* view,  /**< View of a matrix with identity row and column maps. */
+  CMR_SUBMAT* submatrix   /**< Submatrix of the matrix in the index space of its parent matrix. */
+)
+{
+  CMRdbgMsg(2, "The oracle reported a %zux%zu submatrix without the property.\n", submatrix->numRows,
+    submatrix->numColumns);
+  CMR_CALL( CMRsortSubmatrix(cmr, submatrix) );
+
+  size_t r = 0;
+  for (size_t row = 0; row < view->numRows; ++row)
+  {
+    while (r < submatrix->numRows && submatrix->rows[r] < row)
+      ++r;
+    if (r == submatrix->numRows || submatrix->rows[r] != row)
+      CMR_CALL( CMRchrmatViewSetRowHidden(cmr, view, row, true) );
+  }
+  size_t c = 0;
+  for (size_t column = 0; column < view->numColumns; ++column)
+  {
+    while (c < submatrix->numColumns && submatrix->columns[c] < column)
+      ++c;
+    if (c == submatrix->numColumns || submatrix->columns[c] != column)
+      CMRchrmatViewSetColumnHidden(view, column, true);
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Queries the test oracle for the matrix of \p current.
+ *
+ * If the oracle reports a submatrix without the property, then all other rows and columns are hidden in \p current.
+ */
+
+static
+CMR_ERROR queryOracle(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_CHRMAT_VIEW* current,             /**< View of the matrix to be tested. */
+  CMR_CHRMAT* candidateMatrix,          /**< Matrix to be overwritten by the matrix of \p current. */
+  HereditaryPropertyTest testFunction,  /**< Test function. */
+  void* testData,                       /**< Data to be forwarded to the test function. */
+  CMR_DEADLINE* deadline,               /**< Deadline of the computation. */
+  bool* phasProperty                    /**< Pointer for storing whether the matrix has the property. */
+)
+{
+  double remainingTime = CMRdeadlineRemaining(deadline);
+  if (remainingTime < 0)
+    return CMR_ERROR_TIMEOUT;
+
+  fillFromView(current, NULL, NULL, candidateMatrix);
+
+  CMRdbgMsg(2, "\n!!! Hereditary property test queries the test oracle!!!\n\n");
+  CMR_SUBMAT* submatrix = NULL;
+  CMR_CALL( testFunction(cmr, candidateMatrix, testData, phasProperty, &submatrix, remainingTime) );
+
+  CMRdbgMsg(2, "\n!!! Property %s present.\n\n", *phasProperty ? "IS" : "is NOT");
+
+  if (submatrix)
+  {
+    assert(!*phasProperty);
+    CMR_CALL( restrictToSubmatrix(cmr, current, submatrix) );
+    CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  }
+
+  return CMR_OKAY;
+}
 
 CMR_ERROR CMRtestHereditaryPropertySimple(CMR* cmr, CMR_CHRMAT* matrix, HereditaryPropertyTest testFunction,
   void* testData, CMR_SUBMAT** psubmatrix, double timeLimit)
@@ -12,14 +126,7 @@ CMR_ERROR CMRtestHereditaryPropertySimple(CMR* cmr, CMR_CHRMAT* matrix, Heredita
   assert(testFunction);
   assert(psubmatrix);
 
-  clock_t time = clock();
-  size_t* essentialRows = NULL;
-  size_t numEssentialRows = 0;
-  CMR_CALL( CMRallocStackArray(cmr, &essentialRows, matrix->numRows) );
-  size_t* essentialColumns = NULL;
-  size_t numEssentialColumns = 0;
-  CMR_CALL( CMRallocStackArray(cmr, &essentialColumns, matrix->numColumns) );
-  
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
   CMR_ELEMENT* candidates = NULL;
   size_t numCandidates = matrix->numRows + matrix->numColumns;
   CMR_CALL( CMRallocStackArray(cmr, &candidates, numCandidates) );
@@ -28,95 +135,351 @@ CMR_ERROR CMRtestHereditaryPropertySimple(CMR* cmr, CMR_CHRMAT* matrix, Heredita
   for (size_t column = 0; column < matrix->numColumns; ++column)
     candidates[matrix->numRows + column] = CMRcolumnToElement(column);
 
-  CMR_CHRMAT* current = NULL;
-  CMR_CALL( CMRchrmatCopy(cmr, matrix, &current) );
+  /* The current matrix is the input matrix with all removed rows and columns hidden. */
+  CMR_CHRMAT_VIEW* current = NULL;
+  CMR_CALL( CMRchrmatViewCreate(cmr, matrix, NULL, &current) );
 
   CMR_CHRMAT* candidateMatrix = NULL;
   CMR_CALL( CMRchrmatCreate(cmr, &candidateMatrix, matrix->numRows, matrix->numColumns, matrix->numNonzeros) );
   candidateMatrix->numNonzeros = 0;
 
+  CMR_ERROR error = CMR_OKAY;
   while (numCandidates > 0)
   {
     CMR_ELEMENT candidateElement = candidates[--numCandidates];
     size_t removedRow = SIZE_MAX;
     size_t removedColumn = SIZE_MAX;
     if (CMRelementIsRow(candidateElement))
+    {
       removedRow = CMRelementToRowIndex(candidateElement);
+      if (CMRchrmatViewIsRowHidden(current, removedRow))
+        continue;
+      CMR_CALL( CMRchrmatViewSetRowHidden(cmr, current, removedRow, true) );
+    }
     else
-      removedColumn = CMRelementToColumnIndex(candidateElement);
-
-    /* Copy current matrix to candidate matrix, except for removed row/column. */
-    candidateMatrix->numNonzeros = 0;
-    for (size_t row = 0; row < matrix->numRows; ++row)
     {
-      candidateMatrix->rowSlice[row] = candidateMatrix->numNonzeros;
-      if (row == removedRow)
+      removedColumn = CMRelementToColumnIndex(candidateElement);
+      if (CMRchrmatViewIsColumnHidden(current, removedColumn))
         continue;
-      size_t first = current->rowSlice[row];
-      size_t beyond = current->rowSlice[row + 1];
-      for (size_t e = first; e < beyond; ++e)
-      {
-        size_t column = current->entryColumns[e];
-        if (column == removedColumn)
-          continue;
-        candidateMatrix->entryColumns[candidateMatrix->numNonzeros] = column;
-        candidateMatrix->entryValues[candidateMatrix->numNonzeros] = current->entryValues[e];
-        candidateMatrix->numNonzeros++;
-      }
+      CMRchrmatViewSetColumnHidden(current, removedColumn, true);
     }
-    candidateMatrix->rowSlice[matrix->numRows] = candidateMatrix->numNonzeros;
 
-    /* Invoke test. */
+    /* The candidate matrix is the current view, which already excludes the removed row/column. */
     bool hasProperty;
-    CMR_SUBMAT* submatrix = NULL;
-    double remainingTime = timeLimit - (clock() - time) * 1.0 / CLOCKS_PER_SEC;
-    if (remainingTime < 0)
+    error = queryOracle(cmr, current, candidateMatrix, testFunction, testData, &deadline, &hasProperty);
+    if (error)
+      break;
+
+    if (hasProperty)
     {
-      CMR_CALL( CMRchrmatFree(cmr, &candidateMatrix) );
-      CMR_CALL( CMRchrmatFree(cmr, &current) );
-      CMR_CALL( CMRfreeStackArray(cmr, &candidates) );
-      CMR_CALL( CMRfreeStackArray(cmr, &essentialColumns) );
-      CMR_CALL( CMRfreeStackArray(cmr, &essentialRows) );
-      return CMR_ERROR_TIMEOUT;
+      /* The row/column is essential, so we show it again. */
+      if (removedRow < SIZE_MAX)
+        CMR_CALL( CMRchrmatViewSetRowHidden(cmr, current, removedRow, false) );
+      else
+        CMRchrmatViewSetColumnHidden(current, removedColumn, false);
     }
+  }
 
-    CMRdbgMsg(2, "\n!!! Hereditary property test queries the test oracle!!!\n\n");
-    CMR_CALL( testFunction(cmr, candidateMatrix, testData, &hasProperty, &submatrix, remainingTime) );
+  /* The essential rows and columns are those that are still shown. */
+  if (!error)
+    CMR_CALL( CMRchrmatViewToSubmat(cmr, current, psubmatrix) );
 
-    CMRdbgMsg(2, "\n!!! Property %s present.\n\n", hasProperty ? "IS" : "is NOT");
+  CMR_CALL( CMRchrmatFree(cmr, &candidateMatrix) );
+  CMR_CALL( CMRchrmatViewFree(cmr, &current) );
+  CMR_CALL( CMRfreeStackArray(cmr, &candidates) );
 
-    assert(!submatrix); // TODO: we cannot deal with this, yet.
+  return error;
+}
 
-    if (hasProperty)
+/**
+ * \brief Hides or shows the row or column \p element of \p view.
+ */
+
+static inline
+CMR_ERROR setElementHidden(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT_VIEW* view,  /**< View. */
+  CMR_ELEMENT element,    /**< Row or column. */
+  bool hidden             /**< Whether to hide the row or column. */
+)
+{
+  if (CMRelementIsRow(element))
+    CMR_CALL( CMRchrmatViewSetRowHidden(cmr, view, CMRelementToRowIndex(element), hidden) );
+  else
+    CMRchrmatViewSetColumnHidden(view, CMRelementToColumnIndex(element), hidden);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns \c true if and only if the row or column \p element of \p view is hidden.
+ */
+
+static inline
+bool isElementHidden(
+  CMR_CHRMAT_VIEW* view,  /**< View. */
+  CMR_ELEMENT element     /**< Row or column. */
+)
+{
+  if (CMRelementIsRow(element))
+    return CMRchrmatViewIsRowHidden(view, CMRelementToRowIndex(element));
+  else
+    return CMRchrmatViewIsColumnHidden(view, CMRelementToColumnIndex(element));
+}
+
+/**
+ * \brief Data shared by the workers that query the test oracle for several groups of rows and columns at once.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT_VIEW* current;             /**< \brief View of the current matrix. */
+  HereditaryPropertyTest testFunction;  /**< \brief Test function. */
+  void** testData;                      /**< \brief Array with the data for the test function of each worker. */
+  CMR_DEADLINE* deadline;               /**< \brief Deadline of the computation. */
+  bool** rowExcluded;                   /**< \brief Array with the rows of the group of each worker. */
+  bool** columnExcluded;                /**< \brief Array with the columns of the group of each worker. */
+  CMR_CHRMAT** candidateMatrices;       /**< \brief Array with the candidate matrix of each worker. */
+  bool* hasProperty;                    /**< \brief Array with the result of each worker. */
+  CMR_SUBMAT** submatrices;             /**< \brief Array with the submatrix reported to each worker, or \c NULL. */
+} HereditaryProbes;
+
+/**
+ * \brief Queries the test oracle for the current matrix without the group of rows and columns of the worker.
+ */
+
+static
+CMR_ERROR hereditaryProbeWorker(
+  CMR* cmr,       /**< \ref CMR environment of the worker. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref HereditaryProbes. */
+)
+{
+  HereditaryProbes* probes = (HereditaryProbes*) data;
+
+  double remainingTime = CMRdeadlineRemaining(probes->deadline);
+  if (remainingTime < 0)
+    return CMR_ERROR_TIMEOUT;
+
+  CMR_CHRMAT* candidateMatrix = probes->candidateMatrices[worker];
+  fillFromView(probes->current, probes->rowExcluded[worker], probes->columnExcluded[worker], candidateMatrix);
+
+  CMRdbgMsg(2, "\n!!! Hereditary property test queries the test oracle!!!\n\n");
+  CMR_CALL( probes->testFunction(cmr, candidateMatrix, probes->testData[worker], &probes->hasProperty[worker],
+    &probes->submatrices[worker], remainingTime) );
+
+  CMRdbgMsg(2, "\n!!! Property %s present.\n\n", probes->hasProperty[worker] ? "IS" : "is NOT");
+  assert(!probes->hasProperty[worker] || !probes->submatrices[worker]);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Marks the rows and columns of a group of \p candidates as excluded or not.
+ */
+
+static
+void setGroupExcluded(
+  CMR_ELEMENT* candidates,  /**< Array with the rows and columns of the group. */
+  size_t numCandidates,     /**< Number of rows and columns of the group. */
+  bool* rowExcluded,        /**< Array indicating which rows are excluded. */
+  bool* columnExcluded,     /**< Array indicating which columns are excluded. */
+  bool excluded             /**< Whether to exclude the group. */
+)
+{
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    if (CMRelementIsRow(candidates[c]))
+      rowExcluded[CMRelementToRowIndex(candidates[c])] = excluded;
+    else
+      columnExcluded[CMRelementToColumnIndex(candidates[c])] = excluded;
+  }
+}
+
+CMR_ERROR CMRtestHereditaryPropertyParallel(CMR* cmr, CMR_CHRMAT* matrix, HereditaryPropertyTest testFunction,
+  size_t numWorkers, void** testData, CMR_SUBMAT** psubmatrix, double timeLimit)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(testFunction);
+  assert(numWorkers >= 1);
+  assert(testData);
+  assert(psubmatrix);
+
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
+  CMR_ELEMENT* candidates = NULL;
+  size_t numCandidates = matrix->numRows + matrix->numColumns;
+  CMR_CALL( CMRallocStackArray(cmr, &candidates, numCandidates) );
+  for (size_t row = 0; row < matrix->numRows; ++row)
+    candidates[row] = CMRrowToElement(row);
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+    candidates[matrix->numRows + column] = CMRcolumnToElement(column);
+
+  /* The current matrix is the input matrix with all removed rows and columns hidden. */
+  CMR_CHRMAT_VIEW* current = NULL;
+  CMR_CALL( CMRchrmatViewCreate(cmr, matrix, NULL, &current) );
+
+  HereditaryProbes probes;
+  probes.current = current;
+  probes.testFunction = testFunction;
+  probes.testData = testData;
+  probes.deadline = &deadline;
+  probes.rowExcluded = NULL;
+  probes.columnExcluded = NULL;
+  probes.candidateMatrices = NULL;
+  probes.hasProperty = NULL;
+  probes.submatrices = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &probes.rowExcluded, numWorkers) );
+  CMR_CALL( CMRallocBlockArray(cmr, &probes.columnExcluded, numWorkers) );
+  CMR_CALL( CMRallocBlockArray(cmr, &probes.candidateMatrices, numWorkers) );
+  CMR_CALL( CMRallocBlockArray(cmr, &probes.hasProperty, numWorkers) );
+  CMR_CALL( CMRallocBlockArray(cmr, &probes.submatrices, numWorkers) );
+  for (size_t w = 0; w < numWorkers; ++w)
+  {
+    probes.rowExcluded[w] = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &probes.rowExcluded[w], matrix->numRows) );
+    for (size_t row = 0; row < matrix->numRows; ++row)
+      probes.rowExcluded[w][row] = false;
+    probes.columnExcluded[w] = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &probes.columnExcluded[w], matrix->numColumns) );
+    for (size_t column = 0; column < matrix->numColumns; ++column)
+      probes.columnExcluded[w][column] = false;
+    probes.candidateMatrices[w] = NULL;
+    CMR_CALL( CMRchrmatCreate(cmr, &probes.candidateMatrices[w], matrix->numRows, matrix->numColumns,
+      matrix->numNonzeros) );
+    probes.candidateMatrices[w]->numNonzeros = 0;
+    probes.submatrices[w] = NULL;
+  }
+
+  /* Queue of candidate ranges to be removed, starting with both halves. Since each range is split into two, at most
+   * 2 * numCandidates ranges are ever enqueued. */
+  size_t* rangeFirst = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rangeFirst, 2 * numCandidates + 2) );
+  size_t* rangeBeyond = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rangeBeyond, 2 * numCandidates + 2) );
+  size_t queueFirst = 0;
+  size_t queueBeyond = 0;
+  if (numCandidates > 0)
+  {
+    rangeFirst[queueBeyond] = 0;
+    rangeBeyond[queueBeyond++] = numCandidates / 2;
+  }
+  if (numCandidates > 1)
+  {
+    rangeFirst[queueBeyond] = numCandidates / 2;
+    rangeBeyond[queueBeyond++] = numCandidates;
+  }
+
+  CMR_ERROR error = CMR_OKAY;
+  while (queueFirst < queueBeyond)
+  {
+    /* Each worker tests the removal of one of the next ranges, restricted to the candidates that are still shown. */
+    size_t batchFirst = queueFirst;
+    size_t numProbes = 0;
+    while (queueFirst < queueBeyond && numProbes < numWorkers)
     {
-      if (removedRow < SIZE_MAX)
-        essentialRows[numEssentialRows++] = removedRow;
-      else
-        essentialColumns[numEssentialColumns++] = removedColumn;
+      size_t first = rangeFirst[queueFirst];
+      size_t numShown = 0;
+      for (size_t c = first; c < rangeBeyond[queueFirst]; ++c)
+      {
+        if (!isElementHidden(current, candidates[c]))
+          candidates[first + numShown++] = candidates[c];
+      }
+      rangeBeyond[queueFirst] = first + numShown;
+      if (numShown == 0)
+      {
+        /* Empty ranges are dropped by moving the ranges of this batch. */
+        for (size_t q = queueFirst; q > batchFirst; --q)
+        {
+          rangeFirst[q] = rangeFirst[q - 1];
+          rangeBeyond[q] = rangeBeyond[q - 1];
+        }
+        ++batchFirst;
+        ++queueFirst;
+        continue;
+      }
+
+      setGroupExcluded(&candidates[first], numShown, probes.rowExcluded[numProbes], probes.columnExcluded[numProbes],
+        true);
+      ++numProbes;
+      ++queueFirst;
     }
-    else
+    if (numProbes == 0)
+      break;
+
+    CMRdbgMsg(2, "Trying to remove %zu groups of rows and columns.\n", numProbes);
+
+    error = CMRthreadsRun(cmr, numProbes, hereditaryProbeWorker, &probes);
+
+    /* Process the results in the order of the queue. After the first removal, the matrix changed, so the results of
+     * the later ranges are discarded and these ranges are tested again. */
+    bool removed = false;
+    for (size_t p = 0; p < numProbes; ++p)
     {
-      /* Swap candidateMatrix and current. */
-      CMR_CHRMAT* temp = candidateMatrix;
-      candidateMatrix = current;
-      current = temp;
+      size_t q = batchFirst + p;
+      size_t first = rangeFirst[q];
+      size_t numShown = rangeBeyond[q] - first;
+      setGroupExcluded(&candidates[first], numShown, probes.rowExcluded[p], probes.columnExcluded[p], false);
+
+      if (error || removed)
+      {
+        if (probes.submatrices[p])
+          CMR_CALL( CMRsubmatFree(cmr, &probes.submatrices[p]) );
+        continue;
+      }
+
+      if (!probes.hasProperty[p])
+      {
+        /* The group is not needed, so we remove it. */
+        for (size_t c = first; c < first + numShown; ++c)
+          CMR_CALL( setElementHidden(cmr, current, candidates[c], true) );
+        if (probes.submatrices[p])
+        {
+          CMR_CALL( restrictToSubmatrix(cmr, current, probes.submatrices[p]) );
+          CMR_CALL( CMRsubmatFree(cmr, &probes.submatrices[p]) );
+        }
+        removed = true;
+        queueFirst = q + 1;
+      }
+      else if (numShown > 1)
+      {
+        /* Some row or column of the group is essential, so we refine the group. */
+        size_t middle = first + numShown / 2;
+        rangeFirst[queueBeyond] = first;
+        rangeBeyond[queueBeyond++] = middle;
+        rangeFirst[queueBeyond] = middle;
+        rangeBeyond[queueBeyond++] = first + numShown;
+      }
     }
+    if (error)
+      break;
   }
 
-  CMR_CALL( CMRchrmatFree(cmr, &candidateMatrix) );
-  CMR_CALL( CMRchrmatFree(cmr, &current) );
-
-  /* Extract the submatrix. */
-  CMR_CALL( CMRsubmatCreate(cmr, numEssentialRows, numEssentialColumns, psubmatrix) );
-  CMR_SUBMAT* submatrix = *psubmatrix;
-  for (size_t row = 0; row < submatrix->numRows; ++row)
-    submatrix->rows[row] = essentialRows[row];
-  for (size_t column = 0; column < submatrix->numColumns; ++column)
-    submatrix->columns[column] = essentialColumns[column];
+  /* The essential rows and columns are those that are still shown. */
+  if (!error)
+    CMR_CALL( CMRchrmatViewToSubmat(cmr, current, psubmatrix) );
 
+  CMR_CALL( CMRfreeStackArray(cmr, &rangeBeyond) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rangeFirst) );
+  for (size_t w = 0; w < numWorkers; ++w)
+  {
+    CMR_CALL( CMRchrmatFree(cmr, &probes.candidateMatrices[w]) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &probes.columnExcluded[w]) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &probes.rowExcluded[w]) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &probes.submatrices) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &probes.hasProperty) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &probes.candidateMatrices) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &probes.columnExcluded) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &probes.rowExcluded) );
+  CMR_CALL( CMRchrmatViewFree(cmr, &current) );
   CMR_CALL( CMRfreeStackArray(cmr, &candidates) );
-  CMR_CALL( CMRfreeStackArray(cmr, &essentialColumns) );
-  CMR_CALL( CMRfreeStackArray(cmr, &essentialRows) );
 
-  return CMR_OKAY;
+  return error;
+}
+
+CMR_ERROR CMRtestHereditaryPropertyGroups(CMR* cmr, CMR_CHRMAT* matrix, HereditaryPropertyTest testFunction,
+  void* testData, CMR_SUBMAT** psubmatrix, double timeLimit)
+{
+  return CMRtestHereditaryPropertyParallel(cmr, matrix, testFunction, 1, &testData, psubmatrix, timeLimit);
 }
@@ -6,7 +6,7 @@
 #include <cmr/matrix.h>
 #include <cmr/element.h>
 
-#ifdef __cplus
+#ifdef __cplusplus
 extern "C" {
 #endif
 
@@ -22,7 +22,8 @@ typedef CMR_ERROR (*HereditaryPropertyTest)(
 /**
  * \brief Tests a given \p matrix for the hereditary property defined by a given \p testFunction.
  *
- * The algorithm finds the submatrix by successively removing rows or columns.
+ * The algorithm finds the submatrix by successively removing rows or columns. If the test function reports a
+ * submatrix without the property, all other rows and columns are removed at once.
  */
 
 CMR_ERROR CMRtestHereditaryPropertySimple(
@@ -34,6 +35,45 @@ CMR_ERROR CMRtestHereditaryPropertySimple(
   double timeLimit                      /**< Time limit to impose. */
 );
 
+/**
+ * \brief Tests a given \p matrix for the hereditary property defined by a given \p testFunction.
+ *
+ * The algorithm finds the submatrix by removing groups of rows and columns, starting with two halves of all rows and
+ * columns. A group whose removal yields a matrix with the property is shown again and split into two halves, unless it
+ * consists of a single row or column, which is then essential. For a submatrix with \f$ k \f$ rows and columns, the
+ * test function is called \f$ \mathcal{O}(k \log(m+n)) \f$ times instead of \f$ m+n \f$ times. If the test function
+ * reports a submatrix without the property, all other rows and columns are removed at once.
+ */
+
+CMR_ERROR CMRtestHereditaryPropertyGroups(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,                   /**< Some matrix not having the hereditary property. */
+  HereditaryPropertyTest testFunction,  /**< Test function. */
+  void* testData,                       /**< Data to be forwarded to the test function. */
+  CMR_SUBMAT** psubmatrix,              /**< Pointer for storing a minimal submatrix not having the property. */
+  double timeLimit                      /**< Time limit to impose. */
+);
+
+/**
+ * \brief Tests a given \p matrix for the hereditary property like \ref CMRtestHereditaryPropertyGroups, but with
+ *        several calls of \p testFunction running concurrently.
+ *
+ * Each of the \p numWorkers workers tests the removal of one of the next groups of rows and columns, and the results
+ * are processed in the order in which \ref CMRtestHereditaryPropertyGroups would test the groups. After the first
+ * successful removal, the later results are discarded and these groups are tested again. Hence, the found submatrix
+ * does not depend on \p numWorkers.
+ */
+
+CMR_ERROR CMRtestHereditaryPropertyParallel(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,                   /**< Some matrix not having the hereditary property. */
+  HereditaryPropertyTest testFunction,  /**< Test function. */
+  size_t numWorkers,                    /**< Number of workers. */
+  void** testData,                      /**< Array with the data to be forwarded to the test function by each worker. */
+  CMR_SUBMAT** psubmatrix,              /**< Pointer for storing a minimal submatrix not having the property. */
+  double timeLimit                      /**< Time limit to impose. */
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,394 @@
+#ifndef CMR_HYBRID_INT_INTERNAL_H
+#define CMR_HYBRID_INT_INTERNAL_H
+
+/**
+ * \file hybrid_int.h
+ *
+ * \brief Integers that are stored inline as 64-bit values and only promoted to GMP integers when they do not fit.
+ */
+
+#include <cmr/env.h>
+
+#if defined(CMR_WITH_GMP)
+
+#include <gmp.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Integer that is either a 64-bit value or a GMP integer.
+ *
+ * The GMP integer is only initialized while it holds the value. Except for \f$ -2^{63} \f$, 64-bit values are stored
+ * inline, such that their absolute values are representable as well.
+ */
+
+typedef struct
+{
+  int64_t small;  /**< \brief Value if \ref isBig is \c false. */
+  bool isBig;     /**< \brief Whether the value is stored in \ref big. */
+  mpz_t big;      /**< \brief Value if \ref isBig is \c true. */
+} CMR_HYBRID_INT;
+
+/**
+ * \brief Sets the initialized GMP integer \p result to \p value, also if \c long has fewer than 64 bits.
+ */
+
+static inline
+void CMRmpzSetInt64(
+  mpz_ptr result, /**< Initialized GMP integer. */
+  int64_t value   /**< New value. */
+)
+{
+  if (value >= LONG_MIN && value <= LONG_MAX)
+    mpz_set_si(result, (long) value);
+  else
+  {
+    uint64_t absValue = value < 0 ? -(uint64_t) value : (uint64_t) value;
+    mpz_set_ui(result, (unsigned long) (absValue >> 32));
+    mpz_mul_2exp(result, result, 32);
+    mpz_add_ui(result, result, (unsigned long) (absValue & 0xffffffffUL));
+    if (value < 0)
+      mpz_neg(result, result);
+  }
+}
+
+/**
+ * \brief Initializes \p x to zero.
+ */
+
+static inline
+void CMRhybridInit(
+  CMR_HYBRID_INT* x /**< Integer. */
+)
+{
+  x->small = 0;
+  x->isBig = false;
+}
+
+/**
+ * \brief Frees the GMP integer of \p x, if any, and sets it to zero.
+ */
+
+static inline
+void CMRhybridClear(
+  CMR_HYBRID_INT* x /**< Integer. */
+)
+{
+  if (x->isBig)
+  {
+    mpz_clear(x->big);
+    x->isBig = false;
+  }
+  x->small = 0;
+}
+
+/**
+ * \brief Sets \p x to \p value.
+ */
+
+static inline
+void CMRhybridSetInt(
+  CMR_HYBRID_INT* x,  /**< Integer. */
+  int64_t value       /**< New value. */
+)
+{
+  if (value == INT64_MIN)
+  {
+    if (!x->isBig)
+      mpz_init(x->big);
+    x->isBig = true;
+    CMRmpzSetInt64(x->big, INT64_MIN);
+    return;
+  }
+
+  CMRhybridClear(x);
+  x->small = value;
+}
+
+/**
+ * \brief Moves the value of \p x inline if it fits.
+ */
+
+static inline
+void CMRhybridNormalize(
+  CMR_HYBRID_INT* x /**< Integer. */
+)
+{
+  /* On platforms with a 32-bit long, values that do not fit into a long remain stored as GMP integers. */
+  if (x->isBig && mpz_fits_slong_p(x->big))
+  {
+    long value = mpz_get_si(x->big);
+    if (value != INT64_MIN)
+    {
+      mpz_clear(x->big);
+      x->isBig = false;
+      x->small = value;
+    }
+  }
+}
+
+/**
+ * \brief Sets \p x to the GMP integer \p value.
+ */
+
+static inline
+void CMRhybridSetMpz(
+  CMR_HYBRID_INT* x,  /**< Integer. */
+  mpz_srcptr value    /**< New value. */
+)
+{
+  if (!x->isBig)
+    mpz_init(x->big);
+  x->isBig = true;
+  mpz_set(x->big, value);
+  CMRhybridNormalize(x);
+}
+
+/**
+ * \brief Sets \p x to \p value.
+ */
+
+static inline
+void CMRhybridSet(
+  CMR_HYBRID_INT* x,          /**< Integer. */
+  const CMR_HYBRID_INT* value /**< New value. */
+)
+{
+  if (value->isBig)
+    CMRhybridSetMpz(x, value->big);
+  else
+    CMRhybridSetInt(x, value->small);
+}
+
+/**
+ * \brief Swaps the values of \p x and \p y.
+ */
+
+static inline
+void CMRhybridSwap(
+  CMR_HYBRID_INT* x,  /**< First integer. */
+  CMR_HYBRID_INT* y   /**< Second integer. */
+)
+{
+  CMR_HYBRID_INT temp = *x;
+  *x = *y;
+  *y = temp;
+}
+
+/**
+ * \brief Stores the value of \p x in the initialized GMP integer \p result.
+ */
+
+static inline
+void CMRhybridGetMpz(
+  mpz_ptr result,           /**< Initialized GMP integer. */
+  const CMR_HYBRID_INT* x   /**< Integer. */
+)
+{
+  if (x->isBig)
+    mpz_set(result, x->big);
+  else
+    CMRmpzSetInt64(result, x->small);
+}
+
+/**
+ * \brief Returns the sign of \p x.
+ */
+
+static inline
+int CMRhybridSign(
+  const CMR_HYBRID_INT* x /**< Integer. */
+)
+{
+  if (x->isBig)
+    return mpz_sgn(x->big);
+  return (x->small > 0) - (x->small < 0);
+}
+
+/**
+ * \brief Negates \p x.
+ */
+
+static inline
+void CMRhybridNegate(
+  CMR_HYBRID_INT* x /**< Integer. */
+)
+{
+  if (x->isBig)
+    mpz_neg(x->big, x->big);
+  else
+    x->small = -x->small;
+}
+
+/**
+ * \brief Compares the absolute values of \p x and \p y like \c mpz_cmpabs.
+ */
+
+static inline
+int CMRhybridCompareAbs(
+  const CMR_HYBRID_INT* x,  /**< First integer. */
+  const CMR_HYBRID_INT* y   /**< Second integer. */
+)
+{
+  if (!x->isBig && !y->isBig)
+  {
+    int64_t absX = x->small >= 0 ? x->small : -x->small;
+    int64_t absY = y->small >= 0 ? y->small : -y->small;
+    return (absX > absY) - (absX < absY);
+  }
+
+  /* A big integer is larger in absolute value than every inline one. */
+  if (!x->isBig)
+    return -1;
+  if (!y->isBig)
+    return 1;
+  return mpz_cmpabs(x->big, y->big);
+}
+
+/**
+ * \brief Writes the decimal representation of \p x to \p buffer, which must be large enough.
+ */
+
+static inline
+char* CMRhybridGetStr(
+  char* buffer,           /**< Buffer. */
+  const CMR_HYBRID_INT* x /**< Integer. */
+)
+{
+  if (x->isBig)
+    return mpz_get_str(buffer, 10, x->big);
+  sprintf(buffer, "%" PRId64, x->small);
+  return buffer;
+}
+
+/**
+ * \brief Sets \p result to \f$ a x + b y \f$.
+ *
+ * The computation is carried out in 64 bits unless an intermediate result overflows. \p result may coincide with
+ * any of the operands.
+ */
+
+static inline
+void CMRhybridLinearCombination(
+  CMR_HYBRID_INT* result,   /**< Integer for storing the result. */
+  const CMR_HYBRID_INT* a,  /**< Coefficient \f$ a \f$. */
+  const CMR_HYBRID_INT* x,  /**< Integer \f$ x \f$. */
+  const CMR_HYBRID_INT* b,  /**< Coefficient \f$ b \f$. */
+  const CMR_HYBRID_INT* y   /**< Integer \f$ y \f$. */
+)
+{
+  if (!a->isBig && !x->isBig && !b->isBig && !y->isBig)
+  {
+    int64_t ax, by, sum;
+    if (!__builtin_mul_overflow(a->small, x->small, &ax) && !__builtin_mul_overflow(b->small, y->small, &by)
+      && !__builtin_add_overflow(ax, by, &sum))
+    {
+      CMRhybridSetInt(result, sum);
+      return;
+    }
+  }
+
+  mpz_t ax, by;
+  mpz_init(ax);
+  mpz_init(by);
+  CMRhybridGetMpz(ax, a);
+  CMRhybridGetMpz(by, x);
+  mpz_mul(ax, ax, by);
+  mpz_t temp;
+  mpz_init(temp);
+  CMRhybridGetMpz(by, b);
+  CMRhybridGetMpz(temp, y);
+  mpz_mul(by, by, temp);
+  mpz_add(ax, ax, by);
+  CMRhybridSetMpz(result, ax);
+  mpz_clear(temp);
+  mpz_clear(by);
+  mpz_clear(ax);
+}
+
+/**
+ * \brief Sets \p result to \f$ a x \f$.
+ *
+ * \p result may coincide with any of the operands.
+ */
+
+static inline
+void CMRhybridMul(
+  CMR_HYBRID_INT* result,   /**< Integer for storing the result. */
+  const CMR_HYBRID_INT* a,  /**< First factor. */
+  const CMR_HYBRID_INT* x   /**< Second factor. */
+)
+{
+  if (!a->isBig && !x->isBig)
+  {
+    int64_t ax;
+    if (!__builtin_mul_overflow(a->small, x->small, &ax))
+    {
+      CMRhybridSetInt(result, ax);
+      return;
+    }
+  }
+
+  mpz_t ax, temp;
+  mpz_init(ax);
+  mpz_init(temp);
+  CMRhybridGetMpz(ax, a);
+  CMRhybridGetMpz(temp, x);
+  mpz_mul(ax, ax, temp);
+  CMRhybridSetMpz(result, ax);
+  mpz_clear(temp);
+  mpz_clear(ax);
+}
+
+/**
+ * \brief Sets \p result to \f$ a / b \f$, rounded towards zero if \p floor is \c false and towards
+ *        \f$ -\infty \f$ otherwise.
+ *
+ * \p result may coincide with any of the operands.
+ */
+
+static inline
+void CMRhybridDivide(
+  CMR_HYBRID_INT* result,   /**< Integer for storing the result. */
+  const CMR_HYBRID_INT* a,  /**< Dividend. */
+  const CMR_HYBRID_INT* b,  /**< Nonzero divisor. */
+  bool floor                /**< Whether to round towards \f$ -\infty \f$. */
+)
+{
+  assert(CMRhybridSign(b) != 0);
+
+  if (!a->isBig && !b->isBig)
+  {
+    int64_t quotient = a->small / b->small;
+    if (floor && (a->small % b->small != 0) && ((a->small < 0) != (b->small < 0)))
+      --quotient;
+    CMRhybridSetInt(result, quotient);
+    return;
+  }
+
+  mpz_t quotient, divisor;
+  mpz_init(quotient);
+  mpz_init(divisor);
+  CMRhybridGetMpz(quotient, a);
+  CMRhybridGetMpz(divisor, b);
+  if (floor)
+    mpz_fdiv_q(quotient, quotient, divisor);
+  else
+    mpz_tdiv_q(quotient, quotient, divisor);
+  CMRhybridSetMpz(result, quotient);
+  mpz_clear(divisor);
+  mpz_clear(quotient);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_WITH_GMP */
+
+#endif /* CMR_HYBRID_INT_INTERNAL_H */
@@ -0,0 +1,189 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include "intersect.h"
+
+#include <assert.h>
+
+#if defined(__AVX2__) && SIZE_MAX == UINT64_MAX
+#define CMR_INTERSECT_AVX2
+#include <immintrin.h>
+#endif /* __AVX2__ && SIZE_MAX == UINT64_MAX */
+
+/**
+ * \brief If the longer array is at least this many times longer than the shorter one, then galloping is used.
+ */
+
+#define GALLOP_RATIO 16
+
+/**
+ * \brief Stores the positions of a common element in the output arrays.
+ */
+
+static inline
+void emitPositions(
+  size_t* firstPositions,   /**< Array for the positions in the first array (may be \c NULL). */
+  size_t* secondPositions,  /**< Array for the positions in the second array (may be \c NULL). */
+  size_t count,             /**< Index in the output arrays. */
+  size_t firstPosition,     /**< Position in the first array. */
+  size_t secondPosition     /**< Position in the second array. */
+)
+{
+  if (firstPositions)
+    firstPositions[count] = firstPosition;
+  if (secondPositions)
+    secondPositions[count] = secondPosition;
+}
+
+/**
+ * \brief Searches each element of \p shortArray in \p longArray by an exponential search followed by a binary search,
+ *        both starting at the position of the previous element.
+ */
+
+static
+size_t intersectGallop(
+  const size_t* shortArray,   /**< Shorter array. */
+  size_t shortLength,         /**< Length of \p shortArray. */
+  const size_t* longArray,    /**< Longer array. */
+  size_t longLength,          /**< Length of \p longArray. */
+  size_t maxCount,            /**< Maximum number of common elements to find. */
+  size_t* shortPositions,     /**< Array for storing the positions in \p shortArray (may be \c NULL). */
+  size_t* longPositions       /**< Array for storing the positions in \p longArray (may be \c NULL). */
+)
+{
+  size_t count = 0;
+  size_t lower = 0;
+  for (size_t i = 0; i < shortLength && lower < longLength; ++i)
+  {
+    size_t element = shortArray[i];
+
+    /* All elements before lower are smaller than element. */
+    size_t upper = lower;
+    size_t step = 1;
+    while (upper < longLength && longArray[upper] < element)
+    {
+      lower = upper + 1;
+      upper += step;
+      step *= 2;
+    }
+    if (upper > longLength)
+      upper = longLength;
+
+    while (lower < upper)
+    {
+      size_t middle = lower + (upper - lower) / 2;
+      if (longArray[middle] < element)
+        lower = middle + 1;
+      else
+        upper = middle;
+    }
+
+    if (lower < longLength && longArray[lower] == element)
+    {
+      emitPositions(shortPositions, longPositions, count, i, lower);
+      if (++count == maxCount)
+        break;
+      ++lower;
+    }
+  }
+
+  return count;
+}
+
+/**
+ * \brief Merges the ranges of \p first and \p second starting at \p *pfirstPosition and \p *psecondPosition up to
+ *        \p firstBeyond and \p secondBeyond, respectively.
+ *
+ * Advances both positions such that all common elements before them are found, unless \p maxCount is reached.
+ */
+
+static inline
+size_t intersectMerge(
+  const size_t* first,      /**< First array. */
+  size_t* pfirstPosition,   /**< Pointer to current position in \p first. */
+  size_t firstBeyond,       /**< Position beyond the range of \p first. */
+  const size_t* second,     /**< Second array. */
+  size_t* psecondPosition,  /**< Pointer to current position in \p second. */
+  size_t secondBeyond,      /**< Position beyond the range of \p second. */
+  size_t count,             /**< Number of common elements found so far. */
+  size_t maxCount,          /**< Maximum number of common elements to find. */
+  size_t* firstPositions,   /**< Array for storing the positions in \p first (may be \c NULL). */
+  size_t* secondPositions   /**< Array for storing the positions in \p second (may be \c NULL). */
+)
+{
+  size_t i = *pfirstPosition;
+  size_t j = *psecondPosition;
+  while (i < firstBeyond && j < secondBeyond && count < maxCount)
+  {
+    size_t x = first[i];
+    size_t y = second[j];
+    if (x == y)
+      emitPositions(firstPositions, secondPositions, count++, i, j);
+    i += (x <= y);
+    j += (y <= x);
+  }
+  *pfirstPosition = i;
+  *psecondPosition = j;
+
+  return count;
+}
+
+size_t CMRintersectSorted(const size_t* first, size_t firstLength, const size_t* second, size_t secondLength,
+  size_t maxCount, size_t* firstPositions, size_t* secondPositions)
+{
+  assert(first || !firstLength);
+  assert(second || !secondLength);
+
+  if (!firstLength || !secondLength || !maxCount)
+    return 0;
+
+  /* Disjoint ranges are detected immediately. */
+  if (first[firstLength - 1] < second[0] || second[secondLength - 1] < first[0])
+    return 0;
+
+  if (firstLength / GALLOP_RATIO >= secondLength)
+  {
+    return intersectGallop(second, secondLength, first, firstLength, maxCount, secondPositions,
+      firstPositions);
+  }
+  if (secondLength / GALLOP_RATIO >= firstLength)
+  {
+    return intersectGallop(first, firstLength, second, secondLength, maxCount, firstPositions,
+      secondPositions);
+  }
+
+  size_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+
+#if defined(CMR_INTERSECT_AVX2)
+  /* Compare each block of 4 elements of first with all rotations of the current block of second. */
+  while (i + 4 <= firstLength && j + 4 <= secondLength)
+  {
+    __m256i x = _mm256_loadu_si256((const __m256i*) &first[i]);
+    __m256i y = _mm256_loadu_si256((const __m256i*) &second[j]);
+    __m256i equal = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi64(x, y), _mm256_cmpeq_epi64(x, _mm256_permute4x64_epi64(y, 0x39))),
+      _mm256_or_si256(_mm256_cmpeq_epi64(x, _mm256_permute4x64_epi64(y, 0x4E)),
+      _mm256_cmpeq_epi64(x, _mm256_permute4x64_epi64(y, 0x93))));
+
+    size_t firstMax = first[i + 3];
+    size_t secondMax = second[j + 3];
+    if (!_mm256_testz_si256(equal, equal))
+    {
+      size_t blockFirst = i;
+      size_t blockSecond = j;
+      count = intersectMerge(first, &blockFirst, i + 4, second, &blockSecond, j + 4, count, maxCount, firstPositions,
+        secondPositions);
+      if (count == maxCount)
+        return count;
+    }
+
+    /* A block whose maximum is not larger than the other one's cannot meet any later block. */
+    i += (firstMax <= secondMax) ? 4 : 0;
+    j += (secondMax <= firstMax) ? 4 : 0;
+  }
+#endif /* CMR_INTERSECT_AVX2 */
+
+  return intersectMerge(first, &i, firstLength, second, &j, secondLength, count, maxCount, firstPositions,
+    secondPositions);
+}
@@ -0,0 +1,100 @@
+#ifndef CMR_INTERSECT_INTERNAL_H
+#define CMR_INTERSECT_INTERNAL_H
+
+/**
+ * \file intersect.h
+ *
+ * \brief Kernels for intersecting strictly increasing arrays of indices, e.g., the column slices of two rows.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Finds the common elements of the strictly increasing arrays \p first and \p second.
+ *
+ * Stops after \p maxCount common elements. For the \f$ i \f$'th common element, its position in \p first is stored in
+ * \p firstPositions[i] and its position in \p second is stored in \p secondPositions[i], where each of these arrays
+ * may be \c NULL. If one array is much longer than the other, then the elements of the shorter one are searched in
+ * the longer one by galloping. Otherwise, both arrays are merged, comparing blocks of 4 elements at once with AVX2
+ * if it is available.
+ *
+ * \returns the number of common elements found.
+ */
+
+size_t CMRintersectSorted(
+  const size_t* first,      /**< First array. */
+  size_t firstLength,       /**< Length of \p first. */
+  const size_t* second,     /**< Second array. */
+  size_t secondLength,      /**< Length of \p second. */
+  size_t maxCount,          /**< Maximum number of common elements to find. */
+  size_t* firstPositions,   /**< Array for storing the positions in \p first (may be \c NULL). */
+  size_t* secondPositions   /**< Array for storing the positions in \p second (may be \c NULL). */
+);
+
+/**
+ * \brief Returns the number of common elements of the strictly increasing arrays \p first and \p second.
+ */
+
+static inline
+size_t CMRintersectCount(
+  const size_t* first,  /**< First array. */
+  size_t firstLength,   /**< Length of \p first. */
+  const size_t* second, /**< Second array. */
+  size_t secondLength   /**< Length of \p second. */
+)
+{
+  return CMRintersectSorted(first, firstLength, second, secondLength, SIZE_MAX, NULL, NULL);
+}
+
+/**
+ * \brief Finds the smallest common element of the strictly increasing arrays \p first and \p second.
+ *
+ * \returns \c true if and only if there is a common element.
+ */
+
+static inline
+bool CMRintersectFirst(
+  const size_t* first,      /**< First array. */
+  size_t firstLength,       /**< Length of \p first. */
+  const size_t* second,     /**< Second array. */
+  size_t secondLength,      /**< Length of \p second. */
+  size_t* pfirstPosition,   /**< Pointer for storing its position in \p first (may be \c NULL). */
+  size_t* psecondPosition   /**< Pointer for storing its position in \p second (may be \c NULL). */
+)
+{
+  return CMRintersectSorted(first, firstLength, second, secondLength, 1, pfirstPosition, psecondPosition) > 0;
+}
+
+/**
+ * \brief Stores the positions of all common elements of the strictly increasing arrays \p first and \p second.
+ *
+ * The position arrays must have space for the length of the shorter array. Callers that need the values of the common
+ * nonzeros of two matrix slices read them at the stored positions.
+ *
+ * \returns the number of common elements.
+ */
+
+static inline
+size_t CMRintersectEmit(
+  const size_t* first,      /**< First array. */
+  size_t firstLength,       /**< Length of \p first. */
+  const size_t* second,     /**< Second array. */
+  size_t secondLength,      /**< Length of \p second. */
+  size_t* firstPositions,   /**< Array for storing the positions in \p first (may be \c NULL). */
+  size_t* secondPositions   /**< Array for storing the positions in \p second (may be \c NULL). */
+)
+{
+  return CMRintersectSorted(first, firstLength, second, secondLength, SIZE_MAX, firstPositions, secondPositions);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_INTERSECT_INTERNAL_H */
@@ -0,0 +1,95 @@
+#ifndef CMR_IO_INTERNAL_H
+#define CMR_IO_INTERNAL_H
+
+/**
+ * \file io_internal.h
+ *
+ * \brief Encoding of unsigned integers in little-endian byte order for the binary file formats.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Stores \p value with \p numBytes bytes in little-endian order in \p bytes.
+ */
+
+static inline
+void CMRstoreLittleEndian(
+  unsigned char* bytes, /**< Bytes to encode to. */
+  size_t numBytes,      /**< Number of bytes; at most 8. */
+  uint64_t value        /**< Value to encode. */
+)
+{
+  for (size_t i = 0; i < numBytes; ++i)
+  {
+    bytes[i] = value & 0xff;
+    value >>= 8;
+  }
+}
+
+/**
+ * \brief Returns the number stored with \p numBytes bytes in little-endian order in \p bytes.
+ */
+
+static inline
+uint64_t CMRloadLittleEndian(
+  const unsigned char* bytes, /**< Bytes to decode. */
+  size_t numBytes             /**< Number of bytes; at most 8. */
+)
+{
+  uint64_t result = 0;
+  for (size_t i = numBytes; i > 0; --i)
+    result = (result << 8) | bytes[i - 1];
+  return result;
+}
+
+/**
+ * \brief Writes \p value with \p numBytes bytes in little-endian order to \p stream.
+ *
+ * Errors are detected later via \c ferror.
+ */
+
+static inline
+void CMRwriteLittleEndian(
+  FILE* stream,     /**< File stream to write to. */
+  size_t numBytes,  /**< Number of bytes; at most 8. */
+  uint64_t value    /**< Value to write. */
+)
+{
+  unsigned char bytes[8];
+  CMRstoreLittleEndian(bytes, numBytes, value);
+  fwrite(bytes, 1, numBytes, stream);
+}
+
+/**
+ * \brief Reads a number with \p numBytes bytes in little-endian order from \p stream.
+ *
+ * \returns \c false if the stream ended prematurely.
+ */
+
+static inline
+bool CMRreadLittleEndian(
+  FILE* stream,     /**< File stream to read from. */
+  size_t numBytes,  /**< Number of bytes; at most 8. */
+  uint64_t* pvalue  /**< Pointer for storing the value. */
+)
+{
+  unsigned char bytes[8];
+  if (fread(bytes, 1, numBytes, stream) != numBytes)
+    return false;
+  *pvalue = CMRloadLittleEndian(bytes, numBytes);
+  return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_IO_INTERNAL_H */
@@ -5,9 +5,12 @@
 #include "sort.h"
 
 #include "env_internal.h"
+#include "threads.h"
+
 #include <assert.h>
 #include <stdint.h>
 #include <limits.h>
+#include <math.h>
 
 /**
  * TODO: Implement (transposed) HNF according to
@@ -76,12 +79,34 @@ typedef struct _RowInfo64
   long priority;
 } RowInfo64;
 
+#define ROW_INFO_LESS(a, b) ((a).priority < (b).priority)
+
+CMR_SORT_DEFINE(sortOtherRows64, RowInfo64, ROW_INFO_LESS)
+
+/**
+ * \brief Divides \p *premainingDet by the absolute value of the final diagonal entry \p diagonal if it is positive.
+ *
+ * \returns \c false if \p *premainingDet is positive and not divisible by \p diagonal.
+ */
+
 static
-int compareOtherRows64(const void* first, const void* second)
+bool divideRemainingDet(
+  int64_t* premainingDet, /**< Pointer to the remaining target determinant, or to 0 if there is none. */
+  int64_t diagonal        /**< Diagonal entry. */
+)
 {
-  const RowInfo64* row1 = (const RowInfo64*) first;
-  const RowInfo64* row2 = (const RowInfo64*) second;
-  return row1->priority - row2->priority;
+  assert(premainingDet);
+  assert(diagonal != 0);
+
+  if (*premainingDet <= 0)
+    return true;
+
+  diagonal = llabs(diagonal);
+  if (*premainingDet % diagonal != 0)
+    return false;
+
+  *premainingDet /= diagonal;
+  return true;
 }
 
 
@@ -90,20 +115,81 @@ int compareOtherRows64(const void* first, const void* second)
 typedef struct _RowInfoGMP
 {
   size_t row;
-  mpz_t value;
+  CMR_HYBRID_INT value;
   long priority;
 } RowInfoGMP;
 
+CMR_SORT_DEFINE(sortOtherRowsGMP, RowInfoGMP, ROW_INFO_LESS)
+
+/**
+ * \brief Computes the gcd \p g of \p a and \p b along with the Bezout coefficients \p s and \p t.
+ *
+ * Uses \ref gcdExt if both numbers are stored inline, and \c mpz_gcdext otherwise.
+ */
+
+static
+void hybridGcdExt(
+  CMR_HYBRID_INT* g,        /**< Integer for storing the gcd. */
+  CMR_HYBRID_INT* s,        /**< Integer for storing the first Bezout coefficient. */
+  CMR_HYBRID_INT* t,        /**< Integer for storing the second Bezout coefficient. */
+  const CMR_HYBRID_INT* a,  /**< First number. */
+  const CMR_HYBRID_INT* b   /**< Second number. */
+)
+{
+  if (!a->isBig && !b->isBig)
+  {
+    int64_t sValue, tValue;
+    int64_t gValue = gcdExt(a->small, b->small, &sValue, &tValue);
+    CMRhybridSetInt(g, gValue);
+    CMRhybridSetInt(s, sValue);
+    CMRhybridSetInt(t, tValue);
+    return;
+  }
+
+  mpz_t gValue, sValue, tValue, aValue, bValue;
+  mpz_init(gValue);
+  mpz_init(sValue);
+  mpz_init(tValue);
+  mpz_init(aValue);
+  mpz_init(bValue);
+  CMRhybridGetMpz(aValue, a);
+  CMRhybridGetMpz(bValue, b);
+  mpz_gcdext(gValue, sValue, tValue, aValue, bValue);
+  CMRhybridSetMpz(g, gValue);
+  CMRhybridSetMpz(s, sValue);
+  CMRhybridSetMpz(t, tValue);
+  mpz_clear(bValue);
+  mpz_clear(aValue);
+  mpz_clear(tValue);
+  mpz_clear(sValue);
+  mpz_clear(gValue);
+}
+
+/**
+ * \brief Divides \p *premainingDet by the absolute value of the final diagonal entry \p diagonal if it is positive.
+ *
+ * \returns \c false if \p *premainingDet is positive and not divisible by \p diagonal.
+ */
+
 static
-int compareOtherRowsGMP(const void* first, const void* second)
+bool divideRemainingDetHybrid(
+  int64_t* premainingDet,         /**< Pointer to the remaining target determinant, or to 0 if there is none. */
+  const CMR_HYBRID_INT* diagonal  /**< Diagonal entry. */
+)
 {
-  const RowInfoGMP* row1 = (const RowInfoGMP*) first;
-  const RowInfoGMP* row2 = (const RowInfoGMP*) second;
-  return row1->priority - row2->priority;
+  if (*premainingDet <= 0)
+    return true;
+
+  /* A big diagonal entry exceeds every 64-bit determinant. */
+  if (diagonal->isBig)
+    return false;
+
+  return divideRemainingDet(premainingDet, diagonal->small);
 }
 
-static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix, bool invert, size_t* prank,
-  CMR_SUBMAT* permutations, CMR_INTMAT** presult, CMR_INTMAT** ptranspose)
+static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix, bool invert, size_t rankBound,
+  int64_t targetDet, size_t* prank, bool* pstopped, CMR_SUBMAT* permutations, CMR_INTMAT** presult,
+  CMR_INTMAT** ptranspose)
 {
   assert(cmr);
   assert(matrix);
@@ -126,8 +212,10 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
   CMR_CALL( CMRlistmatGMPInitializeFromIntMatrix(cmr, listmatrix, matrix) );
 
   size_t maxRank = matrix->numRows < matrix->numColumns ? matrix->numRows : matrix->numColumns;
+  if (rankBound < maxRank)
+    maxRank = rankBound;
   size_t maxNumRowsColumns = matrix->numRows > matrix->numColumns ? matrix->numRows : matrix->numColumns;
-  mpz_t* densePivot = NULL; /* Dense representation of the pivot row / column. */
+  CMR_HYBRID_INT* densePivot = NULL; /* Dense representation of the pivot row / column. */
   CMR_CALL( CMRallocStackArray(cmr, &densePivot, maxNumRowsColumns) );
   bool* denseProcessed = NULL; /* Indicator whether a row/column appeared in pivot and other. */
   CMR_CALL( CMRallocStackArray(cmr, &denseProcessed, maxNumRowsColumns) );
@@ -145,22 +233,22 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
 
   for (size_t e = 0; e < maxNumRowsColumns; ++e)
   {
-    mpz_init(densePivot[e]);
+    CMRhybridInit(&densePivot[e]);
     denseProcessed[e] = false;
   }
 
   *prank = 0;
-  mpz_t minEntryValue;
-  mpz_t minEntryAbs;
-  mpz_t pivotValue;
-  mpz_init(minEntryValue);
-  mpz_init(minEntryAbs);
-  mpz_init(pivotValue);
+  bool stopped = false;
+  int64_t remainingDet = targetDet;
+  CMR_HYBRID_INT minEntryValue;
+  CMR_HYBRID_INT pivotValue;
+  CMRhybridInit(&minEntryValue);
+  CMRhybridInit(&pivotValue);
   while (*prank < maxRank)
   {
     /* TODO: maintain smallest elements instead of searching for them. */
 
-    mpz_set_si(minEntryAbs, 0);
+    CMRhybridSetInt(&minEntryValue, 0);
     size_t minEntryRow = SIZE_MAX;
     size_t minEntryColumn = SIZE_MAX;
     size_t minEntryArea = SIZE_MAX;
@@ -171,34 +259,27 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
       for (ListMatGMPNonzero* nz = listmatrix->rowElements[row].head.right; nz != &listmatrix->rowElements[row].head;
         nz = nz->right)
       {
-        mpz_t x;
-        mpz_init(x);
-        mpz_abs(x, nz->value);
-        int comparison = mpz_cmp(x, minEntryAbs);
-        if (mpz_sgn(minEntryAbs) > 0 && comparison > 0)
-        {
-          mpz_clear(x);
+        int comparison = CMRhybridCompareAbs(&nz->value, &minEntryValue);
+        bool haveMinEntry = CMRhybridSign(&minEntryValue) != 0;
+        if (haveMinEntry && comparison > 0)
           continue;
-        }
 
         size_t area = (listmatrix->rowElements[row].numNonzeros - 1)
           * (listmatrix->columnElements[nz->column].numNonzeros - 1);
-        if (mpz_sgn(minEntryAbs) <= 0 || comparison < 0 || (comparison == 0 && area < minEntryArea))
+        if (!haveMinEntry || comparison < 0 || (comparison == 0 && area < minEntryArea))
         {
           minEntryRow = row;
           minEntryColumn = nz->column;
           minEntryArea = area;
-          mpz_set(minEntryValue, nz->value);
-          mpz_abs(minEntryAbs, minEntryValue);
+          CMRhybridSet(&minEntryValue, &nz->value);
         }
-        mpz_clear(x);
       }
     }
 
 #if defined(CMR_DEBUG)
     char buffer[1024];
     CMRdbgMsg(2, "Pivot row %d, column %d has min nonzero %s and fill-in area %ld.\n", minEntryRow, minEntryColumn,
-      mpz_get_str(buffer, 10, minEntryValue), minEntryArea, minEntryArea);
+      CMRhybridGetStr(buffer, &minEntryValue), minEntryArea, minEntryArea);
     CMR_CALL( CMRlistmatGMPPrintDense(cmr, listmatrix, stdout) );
 #endif /* CMR_DEBUG */
 
@@ -206,7 +287,7 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
       break;
 
     /* Find the permuted row and column. */
-    mpz_set(pivotValue, minEntryValue);
+    CMRhybridSet(&pivotValue, &minEntryValue);
     size_t pivotRow = minEntryRow;
     size_t pivotColumn = minEntryColumn;
     size_t pivotPermutedRow = originalRowsToPermutedRows[pivotRow];
@@ -233,7 +314,7 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
 
     /* Go through the nonzeros in the pivot column and sort them to prioritize. */
     numOtherRows = 0;
-    bool scalePivotRow = mpz_sgn(pivotValue) < 0;
+    bool scalePivotRow = CMRhybridSign(&pivotValue) < 0;
     for (ListMatGMPNonzero* nz = listmatrix->columnElements[pivotColumn].head.below;
       nz != &listmatrix->columnElements[pivotColumn].head; nz = nz->below)
     {
@@ -243,27 +324,29 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
       }
       else if (originalRowsToPermutedRows[nz->row] > *prank)
       {
-        mpz_t s, t, g;
-        mpz_init(s);
-        mpz_init(t);
-        mpz_init(g);
-        mpz_gcdext(g, s, t, nz->value, pivotValue);
-        if (mpz_sgn(s) == 0)
+        CMR_HYBRID_INT s, t, g;
+        CMRhybridInit(&s);
+        CMRhybridInit(&t);
+        CMRhybridInit(&g);
+        hybridGcdExt(&g, &s, &t, &nz->value, &pivotValue);
+        if (CMRhybridSign(&s) == 0)
           otherRowInfos[numOtherRows].priority = 0; /* Highest priority since divisible by pivot value. */
         else
           otherRowInfos[numOtherRows].priority = listmatrix->rowElements[nz->row].numNonzeros;
         otherRowInfos[numOtherRows].row = nz->row;
-        mpz_init_set(otherRowInfos[numOtherRows].value, nz->value);
+        CMRhybridInit(&otherRowInfos[numOtherRows].value);
+        CMRhybridSet(&otherRowInfos[numOtherRows].value, &nz->value);
         ++numOtherRows;
         scalePivotRow = false;
-        mpz_clear(g);
-        mpz_clear(t);
-        mpz_clear(s);
+        CMRhybridClear(&g);
+        CMRhybridClear(&t);
+        CMRhybridClear(&s);
       }
       else if (invert)
       {
         otherRowInfos[numOtherRows].row = nz->row;
-        mpz_init_set(otherRowInfos[numOtherRows].value, nz->value);
+        CMRhybridInit(&otherRowInfos[numOtherRows].value);
+        CMRhybridSet(&otherRowInfos[numOtherRows].value, &nz->value);
         otherRowInfos[numOtherRows].priority = INT32_MAX; /* Lowest priority for top rows. */
         ++numOtherRows;
       }
@@ -279,25 +362,30 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
       for (ListMatGMPNonzero* nz = listmatrix->rowElements[pivotRow].head.right;
         nz != &listmatrix->rowElements[pivotRow].head; nz = nz->right)
       {
-        mpz_neg(nz->value, nz->value);
+        CMRhybridNegate(&nz->value);
       }
     }
 
     /* Continue if no updates are needed. */
     if (numOtherRows == 0)
     {
+      if (!divideRemainingDetHybrid(&remainingDet, &pivotValue))
+      {
+        stopped = true;
+        break;
+      }
       continue;
     }
 
     /* Sort other rows. */
-    CMR_CALL( CMRsort(cmr, numOtherRows, otherRowInfos, sizeof(RowInfoGMP), compareOtherRowsGMP) );
+    sortOtherRowsGMP(otherRowInfos, numOtherRows);
 
     /* Copy pivot row to densePivot array. */
     for (ListMatGMPNonzero* nz = listmatrix->rowElements[pivotRow].head.right;
       nz != &listmatrix->rowElements[pivotRow].head; nz = nz->right)
     {
-      mpz_set(densePivot[nz->column], nz->value);
-      CMRdbgMsg(4, "Copying %ld into densePivot[%ld]\n", nz->value, nz->column);
+      CMRhybridSet(&densePivot[nz->column], &nz->value);
+      CMRdbgMsg(4, "Copying %ld into densePivot[%ld]\n", nz->value.small, nz->column);
     }
 
     CMRdbgMsg(2, "Processing all other rows.\n");
@@ -305,26 +393,26 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
     /* Process every other row. */
     for (size_t i = 0; i < numOtherRows; ++i)
     {
-      mpz_set(pivotValue, densePivot[pivotColumn]);
+      CMRhybridSet(&pivotValue, &densePivot[pivotColumn]);
       size_t otherRow = otherRowInfos[i].row;
       char buffer[1024];
       CMRdbgMsg(4, "Other row %ld has value %s, priority %lld and %ld nonzeros.\n", otherRowInfos[i].row,
-        mpz_get_str(buffer, 10, otherRowInfos[i].value), otherRowInfos[i].priority, listmatrix->rowElements[otherRowInfos[i].row].numNonzeros);
-
-      mpz_t gcd;
-      mpz_t U_11;
-      mpz_t U_12;
-      mpz_t U_21;
-      mpz_t U_22;
-      mpz_init(gcd);
-      mpz_init(U_11);
-      mpz_init(U_12);
-      mpz_init(U_21);
-      mpz_init(U_22);
+        CMRhybridGetStr(buffer, &otherRowInfos[i].value), otherRowInfos[i].priority, listmatrix->rowElements[otherRowInfos[i].row].numNonzeros);
+
+      CMR_HYBRID_INT gcd;
+      CMR_HYBRID_INT U_11;
+      CMR_HYBRID_INT U_12;
+      CMR_HYBRID_INT U_21;
+      CMR_HYBRID_INT U_22;
+      CMRhybridInit(&gcd);
+      CMRhybridInit(&U_11);
+      CMRhybridInit(&U_12);
+      CMRhybridInit(&U_21);
+      CMRhybridInit(&U_22);
       if (otherRowInfos[i].priority < INT32_MAX)
       {
         /* Rows below the diagonal will have a zero in the pivot column. */
-        mpz_gcdext(gcd, U_12, U_11, otherRowInfos[i].value, pivotValue);
+        hybridGcdExt(&gcd, &U_12, &U_11, &otherRowInfos[i].value, &pivotValue);
 
 #if defined(CMR_DEBUG)
         char buffer1[1024];
@@ -336,24 +424,24 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
         char buffer7[1024];
         char buffer8[1024];
         CMRdbgMsg(6, "gcd is %s, s = %s, t = %s. Bezout: %s = %s * %s + %s * %s\n",
-          mpz_get_str(buffer1, 10, gcd), mpz_get_str(buffer2, 10, U_11), mpz_get_str(buffer3, 10, U_12),
-          mpz_get_str(buffer4, 10, gcd), mpz_get_str(buffer5, 10, U_11), mpz_get_str(buffer6, 10, pivotValue),
-          mpz_get_str(buffer7, 10, U_12), mpz_get_str(buffer8, 10, otherRowInfos[i].value));
+          CMRhybridGetStr(buffer1, &gcd), CMRhybridGetStr(buffer2, &U_11), CMRhybridGetStr(buffer3, &U_12),
+          CMRhybridGetStr(buffer4, &gcd), CMRhybridGetStr(buffer5, &U_11), CMRhybridGetStr(buffer6, &pivotValue),
+          CMRhybridGetStr(buffer7, &U_12), CMRhybridGetStr(buffer8, &otherRowInfos[i].value));
 #endif /* CMR_DEBUG */
 
-        mpz_div(U_21, otherRowInfos[i].value, gcd);
-        mpz_neg(U_21, U_21);
-        mpz_div(U_22, pivotValue, gcd);
+        CMRhybridDivide(&U_21, &otherRowInfos[i].value, &gcd, false);
+        CMRhybridNegate(&U_21);
+        CMRhybridDivide(&U_22, &pivotValue, &gcd, false);
       }
       else
       {
         /* For rows above the diagonal we cannot risk to modify the pivot row, but we still subtract an integer
          * multiple. */
-        mpz_set_si(U_11, 1);
-        mpz_set_si(U_12, 0);
-        mpz_fdiv_q(U_21, otherRowInfos[i].value, pivotValue);
-        mpz_neg(U_21, U_21);
-        mpz_set_si(U_22, 1);
+        CMRhybridSetInt(&U_11, 1);
+        CMRhybridSetInt(&U_12, 0);
+        CMRhybridDivide(&U_21, &otherRowInfos[i].value, &pivotValue, true);
+        CMRhybridNegate(&U_21);
+        CMRhybridSetInt(&U_22, 1);
       }
 
 
@@ -362,8 +450,8 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
       char buffer2[1024];
       char buffer3[1024];
       char buffer4[1024];
-      CMRdbgMsg(6, "U = [[%s, %s], [%s, %s]]\n", mpz_get_str(buffer1, 10, U_11), mpz_get_str(buffer2, 10, U_12),
-        mpz_get_str(buffer3, 10, U_21), mpz_get_str(buffer4, 10, U_22));
+      CMRdbgMsg(6, "U = [[%s, %s], [%s, %s]]\n", CMRhybridGetStr(buffer1, &U_11), CMRhybridGetStr(buffer2, &U_12),
+        CMRhybridGetStr(buffer3, &U_21), CMRhybridGetStr(buffer4, &U_22));
 #endif /* CMR_DEBUG */
 
       /*
@@ -388,45 +476,40 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
         denseProcessed[column] = true;
 
         /* Apply unimodular transformation to both entries. */
-        mpz_t p_old;
-        mpz_init_set(p_old, densePivot[column]);
+        CMR_HYBRID_INT p_old;
+        CMRhybridInit(&p_old);
+        CMRhybridSet(&p_old, &densePivot[column]);
         /* o_old is nz->value */
-        mpz_t temp, p_new, o_new;
-        mpz_init(temp);
-        mpz_init(p_new);
-        mpz_init(o_new);
-        mpz_mul(p_new, U_11, p_old);
-        mpz_mul(temp, U_12, nz->value);
-        mpz_add(p_new, p_new, temp);
-        mpz_mul(o_new, U_21, p_old);
-        mpz_mul(temp, U_22, nz->value);
-        mpz_add(o_new, o_new, temp);
+        CMR_HYBRID_INT p_new, o_new;
+        CMRhybridInit(&p_new);
+        CMRhybridInit(&o_new);
+        CMRhybridLinearCombination(&p_new, &U_11, &p_old, &U_12, &nz->value);
+        CMRhybridLinearCombination(&o_new, &U_21, &p_old, &U_22, &nz->value);
 
 #if defined(CMR_DEBUG)
         CMRdbgMsg(8, "Other row's nonzero %s vs. pivot %s -> %s and %s; all in column %ld.\n",
-          mpz_get_str(buffer1, 10, nz->value), mpz_get_str(buffer2, 10, p_old), mpz_get_str(buffer3, 10, o_new),
-          mpz_get_str(buffer4, 10, p_new), nz->column);
+          CMRhybridGetStr(buffer1, &nz->value), CMRhybridGetStr(buffer2, &p_old), CMRhybridGetStr(buffer3, &o_new),
+          CMRhybridGetStr(buffer4, &p_new), nz->column);
 #endif /* CMR_DEBUG */
 
-        mpz_set(densePivot[column], p_new);
-        mpz_set(nz->value, o_new);
-        if (mpz_sgn(p_old) == 0 && mpz_sgn(p_new) != 0)
+        CMRhybridSwap(&densePivot[column], &p_new);
+        CMRhybridSwap(&nz->value, &o_new);
+        if (CMRhybridSign(&p_old) == 0 && CMRhybridSign(&densePivot[column]) != 0)
         {
           /* A new nonzero in the pivot row is added as a 1 because we copy back from the dense vector anyhow. */
           ptrdiff_t memoryShift = 0;
           CMRdbgMsg(8, "Inserting a dummy 1 into pivot row %d in column %d.\n", pivotRow, column);
-          mpz_t temp;
-          mpz_init_set_si(temp, 1);
-          CMR_CALL( CMRlistmatGMPInsert(cmr, listmatrix, pivotRow, column, temp, 0, &memoryShift) );
-          mpz_clear(temp);
+          CMR_HYBRID_INT one;
+          CMRhybridInit(&one);
+          CMRhybridSetInt(&one, 1);
+          CMR_CALL( CMRlistmatGMPInsert(cmr, listmatrix, pivotRow, column, &one, 0, &memoryShift) );
           if (memoryShift)
             iter += memoryShift;
         }
 
-        mpz_clear(p_old);
-        mpz_clear(temp);
-        mpz_clear(p_new);
-        mpz_clear(o_new);
+        CMRhybridClear(&p_old);
+        CMRhybridClear(&p_new);
+        CMRhybridClear(&o_new);
       }
 
       /* Go through pivot row. */
@@ -438,24 +521,18 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
           continue;
 
         /* Apply unimodular transformation to both entries. */
-        mpz_t p_old, p_new, o_new;
-        mpz_init(p_old);
-        mpz_init(p_new);
-        mpz_init(o_new);
-        mpz_set(p_old, densePivot[column]);
-        mpz_mul(p_new, U_11, p_old);
-        mpz_mul(o_new, U_21, p_old);
-
-        mpz_set(densePivot[column], p_new);
+        CMR_HYBRID_INT o_new;
+        CMRhybridInit(&o_new);
+        CMRhybridMul(&o_new, &U_21, &densePivot[column]);
+        CMRhybridMul(&densePivot[column], &U_11, &densePivot[column]);
+
         ptrdiff_t memoryShift;
-        CMRdbgMsg(8, "Inserting into other row %ld in column %ld. Value is %ld\n", otherRow, column, o_new);
-        CMR_CALL( CMRlistmatGMPInsert(cmr, listmatrix, otherRow, column, o_new, 0, &memoryShift) );
+        CMRdbgMsg(8, "Inserting into other row %ld in column %ld. Value is %ld\n", otherRow, column, o_new.small);
+        CMR_CALL( CMRlistmatGMPInsert(cmr, listmatrix, otherRow, column, &o_new, 0, &memoryShift) );
         if (memoryShift)
           nz += memoryShift;
 
-        mpz_clear(p_old);
-        mpz_clear(p_new);
-        mpz_clear(o_new);
+        CMRhybridClear(&o_new);
       }
 
       /* Go through other row again to remove nonzeros with value 0. */
@@ -466,21 +543,24 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
         iter = iter->right;
         denseProcessed[nz->column] = false;
         CMRdbgMsg(8, "Deselecting nonzero at %ld,%ld\n", nz->row, nz->column);
-        if (mpz_sgn(nz->value) == 0)
+        if (CMRhybridSign(&nz->value) == 0)
         {
           CMRdbgMsg(8, "Removing nonzero at %ld,%ld\n", nz->row, nz->column);
           CMR_CALL( CMRlistmatGMPDelete(cmr, listmatrix, nz) );
         }
       }
 
-      mpz_clear(gcd);
-      mpz_clear(U_11);
-      mpz_clear(U_12);
-      mpz_clear(U_21);
-      mpz_clear(U_22);
+      CMRhybridClear(&gcd);
+      CMRhybridClear(&U_11);
+      CMRhybridClear(&U_12);
+      CMRhybridClear(&U_21);
+      CMRhybridClear(&U_22);
     }
     for (size_t i = 0; i < numOtherRows; ++i)
-      mpz_clear(otherRowInfos[i].value);
+      CMRhybridClear(&otherRowInfos[i].value);
+
+    /* The diagonal entry is final, which allows to stop if it does not fit to the target determinant. */
+    bool fitsTarget = divideRemainingDetHybrid(&remainingDet, &densePivot[pivotColumn]);
 
     /* Go through pivot row and update the linked list data. */
     for (ListMatGMPNonzero* iter = listmatrix->rowElements[pivotRow].head.right;
@@ -488,27 +568,36 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
     {
       ListMatGMPNonzero* nz = iter;
       iter = iter->right;
-      mpz_t entry;
-      mpz_init(entry);
-      mpz_swap(entry, densePivot[nz->column]);
+      CMR_HYBRID_INT entry;
+      CMRhybridInit(&entry);
+      CMRhybridSwap(&entry, &densePivot[nz->column]);
 
       char buffer[1024];
       CMRdbgMsg(6, "Updating entry in pivot row %ld, column %ld, value: %s\n\n", pivotRow, nz->column,
-        mpz_get_str(buffer, 10, entry));
-      if (mpz_sgn(entry) != 0)
-        mpz_swap(nz->value, entry);
+        CMRhybridGetStr(buffer, &entry));
+      if (CMRhybridSign(&entry) != 0)
+        CMRhybridSwap(&nz->value, &entry);
       else
         CMR_CALL( CMRlistmatGMPDelete(cmr, listmatrix, nz) );
-      mpz_clear(entry);
+      CMRhybridClear(&entry);
+    }
+
+    if (!fitsTarget)
+    {
+      stopped = true;
+      break;
     }
   }
-  mpz_clear(pivotValue);
-  mpz_clear(minEntryAbs);
-  mpz_clear(minEntryValue);
+  CMRhybridClear(&pivotValue);
+  CMRhybridClear(&minEntryValue);
+  for (size_t e = 0; e < maxNumRowsColumns; ++e)
+    CMRhybridClear(&densePivot[e]);
 
   /* If requested, write the resulting matrix back into an int matrix. */
   CMR_ERROR error = CMR_OKAY;
-  if (presult)
+  if (pstopped)
+    *pstopped = stopped;
+  if (presult && !stopped)
   {
     CMR_INTMAT* result = NULL;
     CMR_CALL( CMRintmatCreate(cmr, &result, listmatrix->numRows, listmatrix->numColumns, listmatrix->numNonzeros) );
@@ -521,18 +610,12 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
         nz != &listmatrix->rowElements[row].head; nz = nz->right)
       {
         size_t permColumn = originalColumnsToPermutedColumns[nz->column];
-        if (!mpz_fits_slong_p(nz->value))
-        {
-          error = CMR_ERROR_OVERFLOW;
-          break;
-        }
-        long value = mpz_get_si(nz->value);
-        if (value > INT_MAX || value < INT_MIN)
+        if (nz->value.isBig || nz->value.small > INT_MAX || nz->value.small < INT_MIN)
         {
           error = CMR_ERROR_OVERFLOW;
           break;
         }
-        result->entryValues[result->numNonzeros] = (int) value;
+        result->entryValues[result->numNonzeros] = (int) nz->value.small;
         result->entryColumns[result->numNonzeros] = permColumn;
         result->numNonzeros++;
       }
@@ -566,14 +649,242 @@ static CMR_ERROR CMRintmatComputeUpperDiagonalGMP(CMR* cmr, CMR_INTMAT* matrix,
 #endif /* CMR_WITH_GMP */
 
 
-CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool invert, size_t* prank,
-  CMR_SUBMAT** ppermutations, CMR_INTMAT** presult, CMR_INTMAT** ptranspose)
+/**
+ * \brief Rows or columns of the active submatrix, bucketed by their numbers of nonzeros.
+ */
+
+typedef struct
+{
+  size_t* first;    /**< \brief Array mapping each count to the first line with that count, or \c SIZE_MAX. */
+  size_t* next;     /**< \brief Array mapping each line to the next line with the same count, or \c SIZE_MAX. */
+  size_t* previous; /**< \brief Array mapping each line to the previous line with the same count, or \c SIZE_MAX. */
+  size_t* count;    /**< \brief Array mapping each line to its count, or \c SIZE_MAX if it is not stored. */
+  size_t maxCount;  /**< \brief Maximum count of a line. */
+} MarkowitzBuckets;
+
+/**
+ * \brief Initializes empty buckets for lines \f$ 0,1,\dotsc,\mathtt{numLines}-1 \f$.
+ */
+
+static
+CMR_ERROR markowitzBucketsInit(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  MarkowitzBuckets* buckets,  /**< Buckets. */
+  size_t numLines,            /**< Number of lines. */
+  size_t maxCount             /**< Maximum count of a line. */
+)
+{
+  buckets->first = NULL;
+  buckets->next = NULL;
+  buckets->previous = NULL;
+  buckets->count = NULL;
+  buckets->maxCount = maxCount;
+  CMR_CALL( CMRallocBlockArray(cmr, &buckets->first, maxCount + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &buckets->next, numLines) );
+  CMR_CALL( CMRallocBlockArray(cmr, &buckets->previous, numLines) );
+  CMR_CALL( CMRallocBlockArray(cmr, &buckets->count, numLines) );
+  for (size_t count = 0; count <= maxCount; ++count)
+    buckets->first[count] = SIZE_MAX;
+  for (size_t line = 0; line < numLines; ++line)
+    buckets->count[line] = SIZE_MAX;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Frees the buckets.
+ */
+
+static
+CMR_ERROR markowitzBucketsFree(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  MarkowitzBuckets* buckets /**< Buckets. */
+)
+{
+  CMR_CALL( CMRfreeBlockArray(cmr, &buckets->count) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &buckets->previous) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &buckets->next) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &buckets->first) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Removes \p line from its bucket, if any.
+ */
+
+static
+void markowitzBucketsRemove(
+  MarkowitzBuckets* buckets,  /**< Buckets. */
+  size_t line                 /**< Line to remove. */
+)
+{
+  size_t count = buckets->count[line];
+  if (count == SIZE_MAX)
+    return;
+
+  size_t next = buckets->next[line];
+  size_t previous = buckets->previous[line];
+  if (previous == SIZE_MAX)
+    buckets->first[count] = next;
+  else
+    buckets->next[previous] = next;
+  if (next != SIZE_MAX)
+    buckets->previous[next] = previous;
+  buckets->count[line] = SIZE_MAX;
+}
+
+/**
+ * \brief Moves \p line to the bucket for \p count; lines without nonzeros are not stored.
+ */
+
+static
+void markowitzBucketsUpdate(
+  MarkowitzBuckets* buckets,  /**< Buckets. */
+  size_t line,                /**< Line to update. */
+  size_t count                /**< New count of \p line. */
+)
+{
+  assert(count <= buckets->maxCount);
+
+  if (buckets->count[line] == count)
+    return;
+
+  markowitzBucketsRemove(buckets, line);
+  if (count == 0)
+    return;
+
+  size_t first = buckets->first[count];
+  buckets->next[line] = first;
+  buckets->previous[line] = SIZE_MAX;
+  if (first != SIZE_MAX)
+    buckets->previous[first] = line;
+  buckets->first[count] = line;
+  buckets->count[line] = count;
+}
+
+/**
+ * \brief Returns the count under which a column is stored in the Markowitz buckets.
+ *
+ * If rows above the diagonal are also transformed, then all nonzeros of the pivot column cause fill-in. Columns
+ * without nonzeros in active rows contain no pivot candidates and are not stored.
+ */
+
+static inline
+size_t markowitzColumnCount(
+  ListMat64* listmatrix,        /**< List matrix. */
+  size_t* activeColumnCounts,   /**< Array with the number of nonzeros of each column in active rows. */
+  bool invert,                  /**< Whether rows above the diagonal are transformed as well. */
+  size_t column                 /**< Column. */
+)
+{
+  if (!activeColumnCounts[column])
+    return 0;
+  return invert ? listmatrix->columnElements[column].numNonzeros : activeColumnCounts[column];
+}
+
+/**
+ * \brief Maximum number of rows and columns with a unit entry that the Markowitz search inspects.
+ */
+
+#define MARKOWITZ_SEARCH_LIMIT 4
+
+/**
+ * \brief Searches for a unit pivot entry of the active submatrix with small Markowitz count.
+ *
+ * Rows and columns are inspected by increasing numbers of nonzeros. For an entry in row \f$ r \f$ and column
+ * \f$ c \f$ of the active submatrix, the Markowitz count \f$ (|r| - 1) (|c| - 1) \f$ bounds the fill-in of the
+ * elimination, where \f$ |c| \f$ is the count from \ref markowitzColumnCount. The search stops as soon as no uninspected entry can have a smaller count, or when
+ * \ref MARKOWITZ_SEARCH_LIMIT rows and columns with unit entries were inspected. Returns \c false if no unit entry was
+ * found.
+ */
+
+static
+bool markowitzSearch(
+  ListMat64* listmatrix,                /**< List matrix. */
+  MarkowitzBuckets* rowBuckets,         /**< Active rows, bucketed by their numbers of nonzeros. */
+  MarkowitzBuckets* columnBuckets,      /**< Active columns, bucketed by \ref markowitzColumnCount. */
+  size_t* originalRowsToPermutedRows,   /**< Array that maps rows to permuted rows. */
+  size_t rank,                          /**< Number of pivots carried out so far. */
+  size_t* ppivotRow,                    /**< Pointer for storing the pivot row. */
+  size_t* ppivotColumn,                 /**< Pointer for storing the pivot column. */
+  int64_t* ppivotValue                  /**< Pointer for storing the pivot value. */
+)
+{
+  size_t bestCost = SIZE_MAX;
+  size_t numSearched = 0;
+  size_t maxCount = rowBuckets->maxCount > columnBuckets->maxCount ? rowBuckets->maxCount : columnBuckets->maxCount;
+  for (size_t count = 1; count <= maxCount; ++count)
+  {
+    /* Uninspected entries lie in rows and columns with at least count nonzeros. */
+    if (bestCost <= (count - 1) * (count - 1) || numSearched >= MARKOWITZ_SEARCH_LIMIT)
+      break;
+
+    for (size_t column = count <= columnBuckets->maxCount ? columnBuckets->first[count] : SIZE_MAX;
+      column != SIZE_MAX && numSearched < MARKOWITZ_SEARCH_LIMIT; column = columnBuckets->next[column])
+    {
+      bool found = false;
+      for (ListMat64Nonzero* nz = listmatrix->columnElements[column].head.below;
+        nz != &listmatrix->columnElements[column].head; nz = nz->below)
+      {
+        if (originalRowsToPermutedRows[nz->row] < rank || (nz->value != 1 && nz->value != -1))
+          continue;
+
+        found = true;
+        size_t cost = (listmatrix->rowElements[nz->row].numNonzeros - 1) * (count - 1);
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          *ppivotRow = nz->row;
+          *ppivotColumn = column;
+          *ppivotValue = nz->value;
+        }
+      }
+      if (found)
+        ++numSearched;
+    }
+
+    for (size_t row = count <= rowBuckets->maxCount ? rowBuckets->first[count] : SIZE_MAX;
+      row != SIZE_MAX && numSearched < MARKOWITZ_SEARCH_LIMIT; row = rowBuckets->next[row])
+    {
+      bool found = false;
+      for (ListMat64Nonzero* nz = listmatrix->rowElements[row].head.right; nz != &listmatrix->rowElements[row].head;
+        nz = nz->right)
+      {
+        if (nz->value != 1 && nz->value != -1)
+          continue;
+
+        assert(columnBuckets->count[nz->column] != SIZE_MAX);
+        found = true;
+        size_t cost = (count - 1) * (columnBuckets->count[nz->column] - 1);
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          *ppivotRow = row;
+          *ppivotColumn = nz->column;
+          *ppivotValue = nz->value;
+        }
+      }
+      if (found)
+        ++numSearched;
+    }
+  }
+
+  return bestCost < SIZE_MAX;
+}
+
+CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool invert, size_t rankBound,
+  int64_t targetDet, size_t* prank, bool* pstopped, CMR_SUBMAT** ppermutations, CMR_INTMAT** presult,
+  CMR_INTMAT** ptranspose)
 {
   assert(cmr);
   assert(matrix);
   assert(prank);
+  assert(targetDet <= 0 || pstopped);
 
   bool isIntTooSmall = false;
+  bool stopped = false;
+  int64_t remainingDet = targetDet;
 
 #if defined(CMR_DEBUG)
   CMRdbgMsg(0, "CMRintmatComputeUpperDiagonal for matrix.\n");
@@ -597,6 +908,8 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
   CMR_CALL( CMRlistmat64InitializeFromIntMatrix(cmr, listmatrix, matrix) );
 
   size_t maxRank = matrix->numRows < matrix->numColumns ? matrix->numRows : matrix->numColumns;
+  if (rankBound < maxRank)
+    maxRank = rankBound;
   size_t maxNumRowsColumns = matrix->numRows > matrix->numColumns ? matrix->numRows : matrix->numColumns;
   int64_t* densePivot = NULL; /* Dense representation of the pivot row / column. */
   CMR_CALL( CMRallocStackArray(cmr, &densePivot, maxNumRowsColumns) );
@@ -620,43 +933,62 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
     denseProcessed[e] = false;
   }
 
+  /* The active submatrix consists of the rows and columns that were not pivoted yet. */
+  size_t* activeColumnCounts = NULL; /* Array with the number of nonzeros of each column in active rows. */
+  CMR_CALL( CMRallocStackArray(cmr, &activeColumnCounts, matrix->numColumns) );
+  MarkowitzBuckets rowBuckets;
+  CMR_CALL( markowitzBucketsInit(cmr, &rowBuckets, matrix->numRows, matrix->numColumns) );
+  MarkowitzBuckets columnBuckets;
+  CMR_CALL( markowitzBucketsInit(cmr, &columnBuckets, matrix->numColumns, matrix->numRows) );
+  for (size_t row = 0; row < matrix->numRows; ++row)
+    markowitzBucketsUpdate(&rowBuckets, row, listmatrix->rowElements[row].numNonzeros);
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+  {
+    activeColumnCounts[column] = listmatrix->columnElements[column].numNonzeros;
+    markowitzBucketsUpdate(&columnBuckets, column,
+      markowitzColumnCount(listmatrix, activeColumnCounts, invert, column));
+  }
+
   *prank = 0;
   while (*prank < maxRank)
   {
-    /* TODO: maintain smallest elements instead of searching for them. */
-
     int64_t minEntryValue = INT64_MAX;
     size_t minEntryRow = SIZE_MAX;
     size_t minEntryColumn = SIZE_MAX;
-    size_t minEntryArea = SIZE_MAX;
-    for (size_t permutedRow = *prank; permutedRow < matrix->numRows; ++permutedRow)
+    if (!markowitzSearch(listmatrix, &rowBuckets, &columnBuckets, originalRowsToPermutedRows, *prank, &minEntryRow,
+      &minEntryColumn, &minEntryValue))
     {
-      size_t row = permutations->rows[permutedRow];
-      CMRdbgMsg(4, "Permuted row %ld is original row %ld\n", permutedRow, row);
-      for (ListMat64Nonzero* nz = listmatrix->rowElements[row].head.right; nz != &listmatrix->rowElements[row].head;
-        nz = nz->right)
+      /* Without unit entries we pick one of minimum absolute value, breaking ties by the fill-in area. */
+      size_t minEntryArea = SIZE_MAX;
+      for (size_t permutedRow = *prank; permutedRow < matrix->numRows; ++permutedRow)
       {
-        int64_t x = llabs(nz->value);
-        if (x > llabs(minEntryValue))
-          continue;
-
-        CMRdbgMsg(6, "Area for potential pivot row %ld with column %ld (abs value %ld) is %ldx%ld.\n", row, nz->column, x,
-          (listmatrix->rowElements[row].numNonzeros - 1), (listmatrix->columnElements[nz->column].numNonzeros - 1));
-        size_t area = (listmatrix->rowElements[row].numNonzeros - 1)
-          * (listmatrix->columnElements[nz->column].numNonzeros - 1);
-        if (x < llabs(minEntryValue) || (x == llabs(minEntryValue) && area < minEntryArea))
+        size_t row = permutations->rows[permutedRow];
+        CMRdbgMsg(4, "Permuted row %ld is original row %ld\n", permutedRow, row);
+        for (ListMat64Nonzero* nz = listmatrix->rowElements[row].head.right; nz != &listmatrix->rowElements[row].head;
+          nz = nz->right)
         {
-          minEntryRow = row;
-          minEntryColumn = nz->column;
-          minEntryArea = area;
-          minEntryValue = nz->value;
+          int64_t x = llabs(nz->value);
+          if (x > llabs(minEntryValue))
+            continue;
+
+          CMRdbgMsg(6, "Area for potential pivot row %ld with column %ld (abs value %ld) is %ldx%ld.\n", row,
+            nz->column, x, (listmatrix->rowElements[row].numNonzeros - 1),
+            (listmatrix->columnElements[nz->column].numNonzeros - 1));
+          size_t area = (listmatrix->rowElements[row].numNonzeros - 1)
+            * (listmatrix->columnElements[nz->column].numNonzeros - 1);
+          if (x < llabs(minEntryValue) || (x == llabs(minEntryValue) && area < minEntryArea))
+          {
+            minEntryRow = row;
+            minEntryColumn = nz->column;
+            minEntryArea = area;
+            minEntryValue = nz->value;
+          }
         }
       }
     }
 
 #if defined(CMR_DEBUG)
-    CMRdbgMsg(2, "Pivot row %d, column %d has min nonzero %ld and fill-in area %ld.\n", minEntryRow, minEntryColumn,
-      minEntryValue, minEntryArea, minEntryArea);
+    CMRdbgMsg(2, "Pivot row %d, column %d has min nonzero %ld.\n", minEntryRow, minEntryColumn, minEntryValue);
     CMR_CALL( CMRlistmat64PrintDense(cmr, listmatrix, stdout) );
 #endif /* CMR_DEBUG */
 
@@ -693,6 +1025,20 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
     CMRsubmatWriteToStream(cmr, permutations, matrix->numRows, matrix->numColumns, stdout);
 #endif /* CMR_DEBUG */
 
+    /* The pivot row and column leave the active submatrix. */
+    markowitzBucketsRemove(&rowBuckets, pivotRow);
+    markowitzBucketsRemove(&columnBuckets, pivotColumn);
+    for (ListMat64Nonzero* nz = listmatrix->rowElements[pivotRow].head.right;
+      nz != &listmatrix->rowElements[pivotRow].head; nz = nz->right)
+    {
+      --activeColumnCounts[nz->column];
+      if (nz->column != pivotColumn)
+      {
+        markowitzBucketsUpdate(&columnBuckets, nz->column,
+          markowitzColumnCount(listmatrix, activeColumnCounts, invert, nz->column));
+      }
+    }
+
     /* Go through the nonzeros in the pivot column and sort them to prioritize. */
     numOtherRows = 0;
     bool scalePivotRow = pivotValue < 0;
@@ -742,11 +1088,16 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
     /* Continue if no updates are needed. */
     if (numOtherRows == 0)
     {
+      if (!divideRemainingDet(&remainingDet, pivotValue))
+      {
+        stopped = true;
+        break;
+      }
       continue;
     }
 
     /* Sort other rows. */
-    CMR_CALL( CMRsort(cmr, numOtherRows, otherRowInfos, sizeof(RowInfo64), compareOtherRows64) );
+    sortOtherRows64(otherRowInfos, numOtherRows);
 
     /* Copy pivot row to densePivot array. */
     for (ListMat64Nonzero* nz = listmatrix->rowElements[pivotRow].head.right;
@@ -766,8 +1117,9 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
       CMRdbgMsg(4, "Other row %ld has value %lld, priority %lld and %ld nonzeros.\n", otherRowInfos[i].row,
         otherRowInfos[i].value, otherRowInfos[i].priority, listmatrix->rowElements[otherRowInfos[i].row].numNonzeros);
 
+      bool isActiveRow = otherRowInfos[i].priority < INT32_MAX;
       int64_t U_11, U_12, U_21, U_22;
-      if (otherRowInfos[i].priority < INT32_MAX)
+      if (isActiveRow)
       {
         /* Rows below the diagonal will have a zero in the pivot column. */
         int64_t gcd = gcdExt(otherRowInfos[i].value, pivotValue, &U_12, &U_11);
@@ -864,6 +1216,8 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
         CMR_CALL( CMRlistmat64Insert(cmr, listmatrix, otherRow, column, o_new, 0, &memoryShift) );
         if (memoryShift)
           nz += memoryShift;
+        if (isActiveRow)
+          ++activeColumnCounts[column];
       }
 
       /* Go through other row again to remove nonzeros with value 0. */
@@ -877,11 +1231,22 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
         if (nz->value == 0)
         {
           CMRdbgMsg(8, "Removing nonzero at %ld,%ld\n", nz->row, nz->column);
+          if (isActiveRow)
+            --activeColumnCounts[nz->column];
           CMR_CALL( CMRlistmat64Delete(cmr, listmatrix, nz) );
         }
       }
+      if (isActiveRow)
+        markowitzBucketsUpdate(&rowBuckets, otherRow, listmatrix->rowElements[otherRow].numNonzeros);
     }
 
+    /* The elimination is repeated with GMP or aborted. */
+    if (isIntTooSmall)
+      break;
+
+    /* The diagonal entry is final, which allows to stop if it does not fit to the target determinant. */
+    bool fitsTarget = divideRemainingDet(&remainingDet, densePivot[pivotColumn]);
+
     /* Go through pivot row and update the linked list data. */
     for (ListMat64Nonzero* iter = listmatrix->rowElements[pivotRow].head.right;
       iter != &listmatrix->rowElements[pivotRow].head; )
@@ -892,15 +1257,32 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
       densePivot[nz->column] = 0;
 
       CMRdbgMsg(6, "Updating entry in pivot row %ld, column %ld, value: %ld\n\n", pivotRow, nz->column, entry);
+      size_t column = nz->column;
       if (entry != 0)
         nz->value = entry;
       else
         CMR_CALL( CMRlistmat64Delete(cmr, listmatrix, nz) );
+
+      /* The other rows only changed in the columns of the pivot row. */
+      if (originalColumnsToPermutedColumns[column] >= *prank)
+      {
+        markowitzBucketsUpdate(&columnBuckets, column,
+          markowitzColumnCount(listmatrix, activeColumnCounts, invert, column));
+      }
+    }
+
+    if (!fitsTarget)
+    {
+      stopped = true;
+      break;
     }
   }
 
+  CMR_CALL( markowitzBucketsFree(cmr, &columnBuckets) );
+  CMR_CALL( markowitzBucketsFree(cmr, &rowBuckets) );
+
   /* If requested, write the resulting (transposed) matrix back into an int matrix. */
-  if (!isIntTooSmall && (presult || ptranspose))
+  if (!isIntTooSmall && !stopped && (presult || ptranspose))
   {
     CMR_INTMAT* result = NULL;
     CMR_CALL( CMRintmatCreate(cmr, &result, listmatrix->numRows, listmatrix->numColumns, listmatrix->numNonzeros) );
@@ -930,6 +1312,7 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
       CMR_CALL( CMRintmatFree(cmr, &result) );
   }
 
+  CMR_CALL( CMRfreeStackArray(cmr, &activeColumnCounts) );
   CMR_CALL( CMRfreeStackArray(cmr, &originalColumnsToPermutedColumns) );
   CMR_CALL( CMRfreeStackArray(cmr, &originalRowsToPermutedRows) );
   CMR_CALL( CMRfreeStackArray(cmr, &otherRowInfos) );
@@ -942,12 +1325,16 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
 
   if (isIntTooSmall)
   {
-    CMR_CALL( CMRintmatComputeUpperDiagonalGMP(cmr, matrix, invert, prank, *ppermutations, presult, ptranspose) );
+    CMR_CALL( CMRintmatComputeUpperDiagonalGMP(cmr, matrix, invert, rankBound, targetDet, prank, &stopped,
+      permutations, presult, ptranspose) );
     isIntTooSmall = false;
   }
 
 #endif /* CMR_WITH_GMP */
 
+  if (pstopped)
+    *pstopped = stopped;
+
   if (!ppermutations)
     CMR_CALL( CMRsubmatFree(cmr, &permutations) );
 
@@ -969,19 +1356,500 @@ CMR_ERROR CMRintmatComputeUpperDiagonal(CMR* cmr, CMR_INTMAT* matrix, bool inver
   return isIntTooSmall ? CMR_ERROR_OVERFLOW : CMR_OKAY;
 }
 
-CMR_ERROR CMRintmatDeterminant(CMR* cmr, CMR_INTMAT* matrix, int64_t* pdeterminant)
+/**
+ * \brief Word-size primes for the multi-modular determinant computation, in decreasing order.
+ *
+ * Since all primes are below \f$ 2^{31} \f$, products of two residues fit into 64 bits.
+ */
+
+static const uint32_t modularPrimes[] = {
+  2147483647U, 2147483629U, 2147483587U, 2147483579U, 2147483563U, 2147483549U, 2147483543U, 2147483497U,
+  2147483489U, 2147483477U, 2147483423U, 2147483399U, 2147483353U, 2147483323U, 2147483269U, 2147483249U
+};
+
+#define MODULAR_NUM_PRIMES (sizeof(modularPrimes) / sizeof(modularPrimes[0]))
+
+/**
+ * \brief Maximum number of entries of a matrix whose determinant is computed modulo primes.
+ *
+ * Each worker eliminates a dense copy of the matrix.
+ */
+
+#define MODULAR_MAX_ENTRIES ((size_t) 1 << 22)
+
+/**
+ * \brief Returns \f$ a b \bmod p \f$ for \f$ a, b < p \f$.
+ */
+
+static inline
+uint32_t mulMod(
+  uint32_t a, /**< First factor. */
+  uint32_t b, /**< Second factor. */
+  uint32_t p  /**< Modulus. */
+)
+{
+  return (uint32_t) (((uint64_t) a * b) % p);
+}
+
+/**
+ * \brief Returns \f$ a^{-1} \bmod p \f$ for a prime \f$ p \f$ and \f$ 0 < a < p \f$.
+ */
+
+static
+uint32_t invMod(
+  uint32_t a, /**< Number to invert. */
+  uint32_t p  /**< Prime modulus. */
+)
+{
+  /* Fermat's little theorem: a^{p-2} is the inverse. */
+  uint32_t result = 1;
+  uint32_t exponent = p - 2;
+  while (exponent)
+  {
+    if (exponent & 1)
+      result = mulMod(result, a, p);
+    a = mulMod(a, a, p);
+    exponent >>= 1;
+  }
+  return result;
+}
+
+/**
+ * \brief Returns the residue of \p x modulo \p p in \f$ \{0,1,\dotsc,p-1\} \f$.
+ */
+
+static inline
+uint32_t reduceMod(
+  int64_t x,  /**< Number to reduce. */
+  uint32_t p  /**< Modulus. */
+)
+{
+  int64_t r = x % (int64_t) p;
+  return (uint32_t) (r < 0 ? r + (int64_t) p : r);
+}
+
+/**
+ * \brief Data shared by the workers of the multi-modular determinant computation.
+ */
+
+typedef struct
+{
+  CMR_INTMAT* matrix;   /**< \brief Square matrix. */
+  size_t numPrimes;     /**< \brief Number of primes to use. */
+  uint32_t* residues;   /**< \brief Array with the determinant modulo every prime. */
+  size_t nextPrime;     /**< \brief Index of the next prime to be processed, accessed atomically. */
+  bool cancel;          /**< \brief Whether all workers shall stop, accessed atomically. */
+} ModularDeterminant;
+
+/**
+ * \brief Computes the determinant of a square matrix modulo a prime by dense Gaussian elimination.
+ */
+
+static
+void determinantModPrime(
+  CMR_INTMAT* matrix, /**< Square matrix. */
+  uint32_t p,         /**< Prime modulus. */
+  uint32_t* dense,    /**< Array of size \f$ n^2 \f$ for the dense matrix. */
+  uint32_t* presidue  /**< Pointer for storing the determinant modulo \p p. */
+)
+{
+  size_t n = matrix->numRows;
+  for (size_t i = 0; i < n * n; ++i)
+    dense[i] = 0;
+  for (size_t row = 0; row < n; ++row)
+  {
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t entry = matrix->rowSlice[row]; entry < beyond; ++entry)
+      dense[row * n + matrix->entryColumns[entry]] = reduceMod(matrix->entryValues[entry], p);
+  }
+
+  uint32_t det = 1;
+  for (size_t column = 0; column < n; ++column)
+  {
+    size_t pivotRow = column;
+    while (pivotRow < n && !dense[pivotRow * n + column])
+      ++pivotRow;
+    if (pivotRow == n)
+    {
+      *presidue = 0;
+      return;
+    }
+
+    uint32_t* pivot = &dense[column * n];
+    if (pivotRow != column)
+    {
+      uint32_t* other = &dense[pivotRow * n];
+      for (size_t c = column; c < n; ++c)
+      {
+        uint32_t swap = pivot[c];
+        pivot[c] = other[c];
+        other[c] = swap;
+      }
+      det = p - det;
+    }
+    det = mulMod(det, pivot[column], p);
+
+    uint32_t pivotInverse = invMod(pivot[column], p);
+    for (size_t row = column + 1; row < n; ++row)
+    {
+      uint32_t* current = &dense[row * n];
+      if (!current[column])
+        continue;
+
+      /* We add (p - factor) times the pivot row to the current row. */
+      uint32_t factor = p - mulMod(current[column], pivotInverse, p);
+      for (size_t c = column + 1; c < n; ++c)
+      {
+        if (pivot[c])
+          current[c] = (uint32_t) ((current[c] + (uint64_t) factor * pivot[c]) % p);
+      }
+      current[column] = 0;
+    }
+  }
+
+  *presidue = det;
+}
+
+/**
+ * \brief Computes the determinant modulo primes until all are processed or the computation is canceled.
+ */
+
+static
+CMR_ERROR modularDeterminantWorker(
+  CMR* cmr,       /**< \ref CMR environment of the worker. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref ModularDeterminant. */
+)
+{
+  CMR_UNUSED(worker);
+
+  ModularDeterminant* modular = (ModularDeterminant*) data;
+  size_t n = modular->matrix->numRows;
+  uint32_t* dense = NULL;
+  CMR_ERROR error = CMRallocBlockArray(cmr, &dense, n * n);
+
+  while (!error && !CMRatomicLoadFlag(&modular->cancel))
+  {
+    size_t next = CMRatomicFetchAdd(&modular->nextPrime, 1);
+    if (next >= modular->numPrimes)
+      break;
+    determinantModPrime(modular->matrix, modularPrimes[next], dense, &modular->residues[next]);
+  }
+
+  if (dense)
+    CMR_CALL( CMRfreeBlockArray(cmr, &dense) );
+
+  /* A failing worker stops all others. */
+  if (error)
+    CMRatomicStoreFlag(&modular->cancel, true);
+
+  return error;
+}
+
+/**
+ * \brief Reconstructs an integer from its residues modulo the first \p numPrimes primes using the Chinese remainder
+ *        theorem.
+ *
+ * The mixed-radix representation with symmetric digits is computed by Garner's algorithm. The result is the unique
+ * integer in \f$ (-P/2, P/2] \f$ with the given residues, where \f$ P \f$ is the product of the primes. Returns
+ * \ref CMR_ERROR_OVERFLOW if it does not fit into 64 bits.
+ */
+
+static
+CMR_ERROR reconstructChineseRemainder(
+  uint32_t* residues, /**< Array with the residues. */
+  size_t numPrimes,   /**< Number of primes. */
+  int64_t* presult    /**< Pointer for storing the integer. */
+)
+{
+  assert(numPrimes > 0);
+
+  int64_t result = residues[0] > modularPrimes[0] / 2 ? (int64_t) residues[0] - modularPrimes[0] : residues[0];
+  int64_t product = modularPrimes[0];
+  bool productFits = true;
+  for (size_t i = 1; i < numPrimes; ++i)
+  {
+    uint32_t p = modularPrimes[i];
+    uint32_t resultMod = reduceMod(result, p);
+    if (!productFits)
+    {
+      /* The product exceeds 2^63, so the result was already determined if it fits into 64 bits. */
+      if (resultMod != residues[i])
+        return CMR_ERROR_OVERFLOW;
+      continue;
+    }
+
+    uint32_t digit = mulMod((residues[i] + p - resultMod) % p, invMod(reduceMod(product, p), p), p);
+    int64_t symmetricDigit = digit > p / 2 ? (int64_t) digit - p : digit;
+    if (symmetricDigit)
+    {
+      int64_t absDigit = symmetricDigit > 0 ? symmetricDigit : -symmetricDigit;
+      if (product > INT64_MAX / absDigit)
+        return CMR_ERROR_OVERFLOW;
+      int64_t term = symmetricDigit * product;
+      if ((term > 0 && result > INT64_MAX - term) || (term < 0 && result < INT64_MIN - term))
+        return CMR_ERROR_OVERFLOW;
+      result += term;
+    }
+
+    if (product > INT64_MAX / p)
+      productFits = false;
+    else
+      product *= p;
+  }
+
+  *presult = result;
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Computes the determinant of a square matrix modulo several word-size primes and reconstructs it via the
+ *        Chinese remainder theorem.
+ *
+ * The number of primes is chosen such that their product exceeds twice Hadamard's bound on the absolute value of the
+ * determinant. The primes are processed concurrently. Sets \p *papplied to \c false if the matrix is too large or if
+ * the bound exceeds the product of all available primes.
+ */
+
+static
+CMR_ERROR determinantModular(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_INTMAT* matrix,     /**< Square matrix. */
+  bool* papplied,         /**< Pointer for storing whether the determinant was computed. */
+  int64_t* pdeterminant   /**< Pointer for storing the determinant. */
+)
 {
   assert(cmr);
   assert(matrix);
+  assert(matrix->numRows == matrix->numColumns);
+  assert(papplied);
   assert(pdeterminant);
-  CMRconsistencyAssert(CMRintmatConsistency(matrix));
 
-  if (matrix->numRows != matrix->numColumns)
-    return CMR_ERROR_INPUT;
+  size_t n = matrix->numRows;
+  *papplied = false;
+  if (n > 0 && n > MODULAR_MAX_ENTRIES / n)
+    return CMR_OKAY;
+
+  /* Hadamard's bound is the product of the Euclidean norms of the rows or of the columns, respectively. */
+  double* columnSquares = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnSquares, n) );
+  for (size_t column = 0; column < n; ++column)
+    columnSquares[column] = 0.0;
+  double logRowBound = 0.0;
+  bool hasZeroRow = false;
+  for (size_t row = 0; row < n; ++row)
+  {
+    double rowSquare = 0.0;
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t entry = matrix->rowSlice[row]; entry < beyond; ++entry)
+    {
+      double x = (double) matrix->entryValues[entry];
+      rowSquare += x * x;
+      columnSquares[matrix->entryColumns[entry]] += x * x;
+    }
+    if (rowSquare == 0.0)
+      hasZeroRow = true;
+    else
+      logRowBound += 0.5 * log2(rowSquare);
+  }
+  double logColumnBound = 0.0;
+  bool hasZeroColumn = false;
+  for (size_t column = 0; column < n; ++column)
+  {
+    if (columnSquares[column] == 0.0)
+      hasZeroColumn = true;
+    else
+      logColumnBound += 0.5 * log2(columnSquares[column]);
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &columnSquares) );
+
+  if (hasZeroRow || hasZeroColumn)
+  {
+    *papplied = true;
+    *pdeterminant = 0;
+    return CMR_OKAY;
+  }
+
+  /* We need a product of primes exceeding twice the bound; the small margin accounts for rounding errors. */
+  double logBound = logRowBound < logColumnBound ? logRowBound : logColumnBound;
+  size_t numPrimes = 0;
+  double logProduct = 0.0;
+  while (numPrimes < MODULAR_NUM_PRIMES && logProduct <= logBound + 1.001)
+    logProduct += log2((double) modularPrimes[numPrimes++]);
+  if (logProduct <= logBound + 1.001)
+    return CMR_OKAY;
+
+  CMRdbgMsg(2, "Computing the determinant modulo %zu primes for Hadamard's bound 2^%g.\n", numPrimes, logBound);
+
+  ModularDeterminant modular;
+  modular.matrix = matrix;
+  modular.numPrimes = numPrimes;
+  modular.residues = NULL;
+  modular.nextPrime = 0;
+  modular.cancel = false;
+  CMR_CALL( CMRallocStackArray(cmr, &modular.residues, numPrimes) );
+
+  CMR_ERROR error = CMRthreadsRun(cmr, CMRthreadsNumWorkers(cmr, numPrimes), modularDeterminantWorker, &modular);
+  if (!error)
+  {
+    error = reconstructChineseRemainder(modular.residues, numPrimes, pdeterminant);
+    *papplied = true;
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &modular.residues) );
+
+  return error;
+}
+
+/**
+ * \brief Maximum order of a matrix whose determinant is computed by dense fraction-free elimination.
+ */
+
+#define BAREISS_MAX_DIMENSION 64
+
+/**
+ * \brief Orders up to which dense fraction-free elimination is used regardless of the number of nonzeros.
+ */
+
+#define BAREISS_ALWAYS_DIMENSION 8
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 BareissWide; /**< 128-bit integer for products of two 64-bit entries. */
+#endif /* __SIZEOF_INT128__ */
+
+/**
+ * \brief Computes the determinant of a square matrix by fraction-free Gaussian elimination on a dense copy.
+ *
+ * Bareiss' algorithm replaces, in step \f$ k \f$, each remaining entry by \f$ (a_{ij} a_{kk} - a_{ik} a_{kj}) / p \f$,
+ * where \f$ p \f$ is the previous pivot and the division is exact. All intermediate entries are minors of the matrix.
+ * The products are formed with 128-bit integers if the compiler supports them and with overflow checks otherwise.
+ * Sets \p *papplied to \c false if the matrix is too large or too sparse, or if an entry does not fit into 64 bits.
+ */
+
+static
+CMR_ERROR determinantBareiss(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_INTMAT* matrix,     /**< Square matrix. */
+  bool* papplied,         /**< Pointer for storing whether the determinant was computed. */
+  int64_t* pdeterminant   /**< Pointer for storing the determinant. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(matrix->numRows == matrix->numColumns);
+  assert(papplied);
+  assert(pdeterminant);
+
+  size_t n = matrix->numRows;
+  *papplied = false;
+  if (n > BAREISS_MAX_DIMENSION || (n > BAREISS_ALWAYS_DIMENSION && 4 * matrix->numNonzeros < n * n))
+    return CMR_OKAY;
+  if (n == 0)
+  {
+    *papplied = true;
+    *pdeterminant = 1;
+    return CMR_OKAY;
+  }
+
+  int64_t* dense = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &dense, n * n) );
+  for (size_t i = 0; i < n * n; ++i)
+    dense[i] = 0;
+  for (size_t row = 0; row < n; ++row)
+  {
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t entry = matrix->rowSlice[row]; entry < beyond; ++entry)
+      dense[row * n + matrix->entryColumns[entry]] = matrix->entryValues[entry];
+  }
+
+  bool negate = false;
+  bool overflow = false;
+  int64_t previous = 1;
+  int64_t det = 0;
+  for (size_t column = 0; column < n && !overflow; ++column)
+  {
+    size_t pivotRow = column;
+    while (pivotRow < n && !dense[pivotRow * n + column])
+      ++pivotRow;
+    if (pivotRow == n)
+      break;
 
+    int64_t* pivot = &dense[column * n];
+    if (pivotRow != column)
+    {
+      int64_t* other = &dense[pivotRow * n];
+      for (size_t c = column; c < n; ++c)
+      {
+        int64_t swap = pivot[c];
+        pivot[c] = other[c];
+        other[c] = swap;
+      }
+      negate = !negate;
+    }
+
+    int64_t pivotValue = pivot[column];
+    if (column + 1 == n)
+    {
+      det = pivotValue;
+      break;
+    }
+
+    for (size_t row = column + 1; row < n && !overflow; ++row)
+    {
+      int64_t* current = &dense[row * n];
+      int64_t factor = current[column];
+      for (size_t c = column + 1; c < n; ++c)
+      {
+#if defined(__SIZEOF_INT128__)
+        BareissWide value = ((BareissWide) current[c] * pivotValue - (BareissWide) factor * pivot[c]) / previous;
+        if (value > INT64_MAX || value < INT64_MIN)
+        {
+          overflow = true;
+          break;
+        }
+        current[c] = (int64_t) value;
+#else /* !__SIZEOF_INT128__ */
+        int64_t first, second, difference;
+        if (__builtin_mul_overflow(current[c], pivotValue, &first)
+          || __builtin_mul_overflow(factor, pivot[c], &second)
+          || __builtin_sub_overflow(first, second, &difference))
+        {
+          overflow = true;
+          break;
+        }
+        current[c] = difference / previous;
+#endif /* __SIZEOF_INT128__ */
+      }
+      current[column] = 0;
+    }
+    previous = pivotValue;
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &dense) );
+
+  if (!overflow && !(negate && det == INT64_MIN))
+  {
+    *papplied = true;
+    *pdeterminant = negate ? -det : det;
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Computes the determinant of a square matrix from an integer upper-diagonal transformation.
+ */
+
+static
+CMR_ERROR determinantUpperDiagonal(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_INTMAT* matrix,     /**< Square matrix. */
+  int64_t* pdeterminant   /**< Pointer for storing the determinant. */
+)
+{
   CMR_INTMAT* transformed = NULL;
   size_t rank = SIZE_MAX;
-  CMR_CALL( CMRintmatComputeUpperDiagonal(cmr, matrix, false, &rank, NULL, &transformed, NULL) );
+  CMR_CALL( CMRintmatComputeUpperDiagonal(cmr, matrix, false, SIZE_MAX, 0, &rank, NULL, NULL, &transformed, NULL) );
   if (rank < matrix->numRows)
     *pdeterminant = 0;
   else
@@ -1007,6 +1875,26 @@ CMR_ERROR CMRintmatDeterminant(CMR* cmr, CMR_INTMAT* matrix, int64_t* pdetermina
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRintmatDeterminant(CMR* cmr, CMR_INTMAT* matrix, int64_t* pdeterminant)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pdeterminant);
+  CMRconsistencyAssert(CMRintmatConsistency(matrix));
+
+  if (matrix->numRows != matrix->numColumns)
+    return CMR_ERROR_INPUT;
+
+  bool applied;
+  CMR_CALL( determinantBareiss(cmr, matrix, &applied, pdeterminant) );
+  if (!applied)
+    CMR_CALL( determinantModular(cmr, matrix, &applied, pdeterminant) );
+  if (!applied)
+    CMR_CALL( determinantUpperDiagonal(cmr, matrix, pdeterminant) );
+
+  return CMR_OKAY;
+}
+
 
 CMR_ERROR CMRchrmatDeterminant(CMR* cmr, CMR_CHRMAT* matrix, int64_t* pdeterminant)
 {
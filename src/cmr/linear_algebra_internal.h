@@ -14,14 +14,24 @@ extern "C" {
  * The rank \f$ r \f$ is stored in \p *prank and the row- and column permutations are stored in \p *ppermutations,
  * such that the first \f$ r \f$ rows and columns of the resulting matrix form an invertible upper-diagonal matrix.
  * If \p invert is \c true then in this \f$ r \f$-by-\f$ r \f$ submatrix, the largest (in terms of absolute value)
- * entry in each column is on the diagonal.
+ * entry in each column is on the diagonal. If the rank is known in advance, e.g., from the transpose, then passing it
+ * as \p rankBound saves the search for further pivots.
+ *
+ * If \p targetDet is positive, the elimination stops as soon as the product of the absolute values of the final
+ * diagonal entries does not divide \p targetDet, i.e., as soon as the basis matrix cannot have determinant
+ * \f$ \pm \mathtt{targetDet} \f$. Then \p *pstopped is set to \c true, \p *prank is only the number of computed
+ * pivots and no resulting matrices are created.
  */
 
 CMR_ERROR CMRintmatComputeUpperDiagonal(
   CMR* cmr,                   /**< \ref CMR environment. */
   CMR_INTMAT* matrix,         /**< A matrix */
   bool invert,                /**< Whether the transformed basis columns shall be strictly diagonally dominant. */
+  size_t rankBound,           /**< Upper bound on the rank of \p matrix, or \c SIZE_MAX if unknown. */
+  int64_t targetDet,          /**< Positive determinant to stop the elimination early for, or 0. */
   size_t* prank,              /**< Pointer for storing the rank of the basis matrix. */
+  bool* pstopped,             /**< Pointer for storing whether the elimination stopped early (may be \c NULL if
+                               **  \p targetDet is 0). */
   CMR_SUBMAT** ppermutations, /**< Pointer for storing the row- and column permutations applied to \p matrix
                                **  (may be \c NULL). */
   CMR_INTMAT** presult,       /**< Pointer for storing the resulting int matrix (may be \c NULL). */
@@ -83,7 +83,7 @@ CMR_ERROR CMRlistmatGMPAlloc(CMR* cmr, size_t memRows, size_t memColumns, size_t
   result->nonzeros = NULL;
   CMR_CALL( CMRallocBlockArray(cmr, &result->nonzeros, memNonzeros) );
   for (size_t i = 0; i < memNonzeros; ++i)
-    mpz_init(result->nonzeros[i].value);
+    CMRhybridInit(&result->nonzeros[i].value);
 
   return CMR_OKAY;
 }
@@ -136,7 +136,7 @@ CMR_ERROR CMRlistmatGMPFree(CMR* cmr, ListMatGMP** plistmatrix)
     return CMR_OKAY;
 
   for (size_t i = 0; i < listmatrix->memNonzeros; ++i)
-    mpz_clear(listmatrix->nonzeros[i].value);
+    CMRhybridClear(&listmatrix->nonzeros[i].value);
 
   CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->nonzeros) );
   CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->rowElements) );
@@ -399,7 +399,7 @@ CMR_ERROR CMRlistmatGMPInitializeZero(CMR* cmr, ListMatGMP* listmatrix, size_t n
     listmatrix->rowElements[row].head.above = (row > 0) ? &listmatrix->rowElements[row - 1].head : &listmatrix->anchor;
     listmatrix->rowElements[row].head.below =
       (row + 1 < numRows) ? &listmatrix->rowElements[row + 1].head : &listmatrix->anchor;
-    mpz_init(listmatrix->rowElements[row].head.value);
+    CMRhybridInit(&listmatrix->rowElements[row].head.value);
     listmatrix->rowElements[row].head.special = 0;
   }
 
@@ -416,14 +416,14 @@ CMR_ERROR CMRlistmatGMPInitializeZero(CMR* cmr, ListMatGMP* listmatrix, size_t n
       (column > 0) ? &listmatrix->columnElements[column - 1].head : &listmatrix->anchor;
     listmatrix->columnElements[column].head.right
       = (column + 1 < numColumns) ? &listmatrix->columnElements[column + 1].head : &listmatrix->anchor;
-    mpz_init(listmatrix->columnElements[column].head.value);
+    CMRhybridInit(&listmatrix->columnElements[column].head.value);
     listmatrix->columnElements[column].head.special = 0;
   }
 
   /* Fill anchor data. */
   listmatrix->anchor.row = SIZE_MAX;
   listmatrix->anchor.column = SIZE_MAX;
-  mpz_init(listmatrix->anchor.value);
+  CMRhybridInit(&listmatrix->anchor.value);
   listmatrix->anchor.special = 0;
 
   /* Initialize linked list for rows. */
@@ -471,10 +471,10 @@ CMR_ERROR CMRlistmatGMPInitializeZero(CMR* cmr, ListMatGMP* listmatrix, size_t n
     for (size_t i = 0; i < listmatrix->memNonzeros - 1; ++i)
     {
       listmatrix->nonzeros[i].right = &listmatrix->nonzeros[i + 1];
-      mpz_init(listmatrix->nonzeros[i].value);
+      CMRhybridClear(&listmatrix->nonzeros[i].value);
     }
     listmatrix->nonzeros[listmatrix->memNonzeros-1].right = NULL;
-    mpz_init(listmatrix->nonzeros[listmatrix->memNonzeros-1].value);
+    CMRhybridClear(&listmatrix->nonzeros[listmatrix->memNonzeros-1].value);
   }
 
   return CMR_OKAY;
@@ -652,7 +652,7 @@ CMR_ERROR CMRlistmatGMPInitializeFromIntMatrix(CMR* cmr, ListMatGMP* listmatrix,
       size_t column = matrix->entryColumns[e];
       nonzero->row = row;
       nonzero->column = column;
-      mpz_set_si(nonzero->value, matrix->entryValues[e]);
+      CMRhybridSetInt(&nonzero->value, matrix->entryValues[e]);
       nonzero->special = 0;
       nonzero++;
       listmatrix->rowElements[row].numNonzeros++;
@@ -885,11 +885,11 @@ CMR_ERROR CMRlistmatGMPInitializeFromDoubleMatrix(CMR* cmr, ListMatGMP* listmatr
       nonzero->column = column;
       double rounded = round(matrix->entryValues[e]);
       if (rounded > 127 || rounded < -127 || fabs(rounded - matrix->entryValues[e]) > epsilon)
-        mpz_init_set_si(nonzero->value, -128);
+        CMRhybridSetInt(&nonzero->value, -128);
       else
       {
-        mpz_init_set_si(nonzero->value, (int8_t) rounded);
-        assert(mpz_cmp_si(nonzero->value, -128) != 0);
+        CMRhybridSetInt(&nonzero->value, (int8_t) rounded);
+        assert(nonzero->value.small != -128);
       }
       nonzero->special = 0;
       nonzero++;
@@ -1135,7 +1135,7 @@ CMR_ERROR CMRlistmatGMPInitializeFromIntSubmatrix(CMR* cmr, ListMatGMP* listmatr
 
       nonzero->row = row;
       nonzero->column = column;
-      mpz_init_set_si(nonzero->value, matrix->entryValues[e]);
+      CMRhybridSetInt(&nonzero->value, matrix->entryValues[e]);
       nonzero->special = 0;
       listmatrix->numNonzeros++;
 
@@ -1364,7 +1364,7 @@ CMR_ERROR CMRlistmatGMPInitializeFromIntSubmatrixComplement(CMR* cmr, ListMatGMP
 
       nonzero->row = row;
       nonzero->column = column;
-      mpz_init_set_si(nonzero->value, matrix->entryValues[e]);
+      CMRhybridSetInt(&nonzero->value, matrix->entryValues[e]);
       nonzero->special = 0;
       listmatrix->numNonzeros++;
 
@@ -1481,6 +1481,8 @@ CMR_ERROR CMRlistmatGMPPrintDense(CMR* cmr, ListMatGMP* listmatrix, FILE* stream
   CMR_CALL( CMRallocStackArray(cmr, &dense, listmatrix->numColumns) );
   for (size_t column = 0; column < listmatrix->numColumns; ++column)
     mpz_init(dense[column]);
+  mpz_t value;
+  mpz_init(value);
 
   for (size_t row = 0; row < listmatrix->numRows; ++row)
   {
@@ -1488,7 +1490,8 @@ CMR_ERROR CMRlistmatGMPPrintDense(CMR* cmr, ListMatGMP* listmatrix, FILE* stream
       nz != &listmatrix->rowElements[row].head; nz = nz->right)
     {
       assert(nz->row == row);
-      mpz_add(dense[nz->column], dense[nz->column], nz->value);
+      CMRhybridGetMpz(value, &nz->value);
+      mpz_add(dense[nz->column], dense[nz->column], value);
     }
     for (size_t column = 0; column < listmatrix->numColumns; ++column)
     {
@@ -1501,6 +1504,7 @@ CMR_ERROR CMRlistmatGMPPrintDense(CMR* cmr, ListMatGMP* listmatrix, FILE* stream
   }
   fflush(stream);
 
+  mpz_clear(value);
   for (size_t column = 0; column < listmatrix->numColumns; ++column)
     mpz_clear(dense[column]);
   CMR_CALL( CMRfreeStackArray(cmr, &dense) );
@@ -1565,8 +1569,8 @@ CMR_ERROR CMRlistmat8Insert(CMR* cmr, ListMat8* listmatrix, size_t row, size_t c
     /* Create free list. */
     listmatrix->firstFreeNonzero = &newNonzeros[listmatrix->numNonzeros];
     for (size_t i = listmatrix->numNonzeros; i < newSize - 1; ++i)
-      listmatrix->nonzeros[i].right = &listmatrix->nonzeros[i+1];
-    listmatrix->nonzeros[newSize-1].right = NULL;
+      newNonzeros[i].right = &newNonzeros[i+1];
+    newNonzeros[newSize-1].right = NULL;
 
     /* Move old nonzero array. */
     listmatrix->memNonzeros = newSize;
@@ -1609,7 +1613,7 @@ CMR_ERROR CMRlistmat64Insert(CMR* cmr, ListMat64* listmatrix, size_t row, size_t
   assert(cmr);
   assert(listmatrix);
   assert(row < listmatrix->numRows);
-  assert(row < listmatrix->numColumns);
+  assert(column < listmatrix->numColumns);
 
   CMRdbgMsg(10, "CMRlistmat64Insert for %ld of %ld possible nonzeros.\n", listmatrix->numNonzeros,
     listmatrix->memNonzeros);
@@ -1661,8 +1665,8 @@ CMR_ERROR CMRlistmat64Insert(CMR* cmr, ListMat64* listmatrix, size_t row, size_t
     /* Create free list. */
     listmatrix->firstFreeNonzero = &newNonzeros[listmatrix->numNonzeros];
     for (size_t i = listmatrix->numNonzeros; i < newSize - 1; ++i)
-      listmatrix->nonzeros[i].right = &listmatrix->nonzeros[i+1];
-    listmatrix->nonzeros[newSize-1].right = NULL;
+      newNonzeros[i].right = &newNonzeros[i+1];
+    newNonzeros[newSize-1].right = NULL;
 
     /* Move old nonzero array. */
     listmatrix->memNonzeros = newSize;
@@ -1709,13 +1713,13 @@ CMR_ERROR CMRlistmat64Insert(CMR* cmr, ListMat64* listmatrix, size_t row, size_t
 
 #if defined(CMR_WITH_GMP)
 
-CMR_ERROR CMRlistmatGMPInsert(CMR* cmr, ListMatGMP* listmatrix, size_t row, size_t column, mpz_srcptr value,
-  long special, ptrdiff_t* pmemoryShift)
+CMR_ERROR CMRlistmatGMPInsert(CMR* cmr, ListMatGMP* listmatrix, size_t row, size_t column,
+  const CMR_HYBRID_INT* value, long special, ptrdiff_t* pmemoryShift)
 {
   assert(cmr);
   assert(listmatrix);
   assert(row < listmatrix->numRows);
-  assert(row < listmatrix->numColumns);
+  assert(column < listmatrix->numColumns);
 
   CMRdbgMsg(10, "CMRlistmatGMPInsert for %ld of %ld possible nonzeros.\n", listmatrix->numNonzeros,
     listmatrix->memNonzeros);
@@ -1738,9 +1742,6 @@ CMR_ERROR CMRlistmatGMPInsert(CMR* cmr, ListMatGMP* listmatrix, size_t row, size
       newNonzeros[i].right += memoryShift;
       newNonzeros[i].above += memoryShift;
       newNonzeros[i].below += memoryShift;
-      mpz_init(newNonzeros[i].value);
-      mpz_swap(newNonzeros[i].value, listmatrix->nonzeros[i].value);
-      mpz_clear(listmatrix->nonzeros[i].value);
     }
 
     /* Also do this for the heads, but repair it for their predecessors / successors. */
@@ -1771,11 +1772,11 @@ CMR_ERROR CMRlistmatGMPInsert(CMR* cmr, ListMatGMP* listmatrix, size_t row, size
     listmatrix->firstFreeNonzero = &newNonzeros[listmatrix->numNonzeros];
     for (size_t i = listmatrix->numNonzeros; i < newSize - 1; ++i)
     {
-      listmatrix->nonzeros[i].right = &listmatrix->nonzeros[i+1];
-      mpz_init(listmatrix->nonzeros[i].value);
+      newNonzeros[i].right = &newNonzeros[i+1];
+      CMRhybridInit(&newNonzeros[i].value);
     }
-    listmatrix->nonzeros[newSize-1].right = NULL;
-    mpz_init(listmatrix->nonzeros[newSize-1].value);
+    newNonzeros[newSize-1].right = NULL;
+    CMRhybridInit(&newNonzeros[newSize-1].value);
 
     /* Move old nonzero array. */
     listmatrix->memNonzeros = newSize;
@@ -1794,7 +1795,7 @@ CMR_ERROR CMRlistmatGMPInsert(CMR* cmr, ListMatGMP* listmatrix, size_t row, size
   listmatrix->firstFreeNonzero = nz->right;
   nz->row = row;
   nz->column = column;
-  mpz_set(nz->value, value);
+  CMRhybridSet(&nz->value, value);
   nz->special = special;
 
   ListMatGMPNonzero* head = &listmatrix->rowElements[row].head;
@@ -1897,6 +1898,7 @@ CMR_ERROR CMRlistmatGMPDelete(CMR* cmr, ListMatGMP* listmatrix, ListMatGMPNonzer
   nz->right->left = nz->left;
   nz->above->below = nz->below;
   nz->below->above = nz->above;
+  CMRhybridClear(&nz->value);
   nz->right = listmatrix->firstFreeNonzero;
   listmatrix->firstFreeNonzero = nz;
 
@@ -1904,3 +1906,332 @@ CMR_ERROR CMRlistmatGMPDelete(CMR* cmr, ListMatGMP* listmatrix, ListMatGMPNonzer
 }
 
 #endif /* CMR_WITH_GMP */
+
+/**
+ * \brief Reallocates the node arrays of \p listmatrix for \p memNodes nodes.
+ */
+
+static
+CMR_ERROR listmat8CompactReallocNodes(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  size_t memNodes               /**< New number of nodes. */
+)
+{
+  assert(cmr);
+  assert(listmatrix);
+
+  CMR_CALL( CMRreallocBlockArray(cmr, &listmatrix->left, memNodes) );
+  CMR_CALL( CMRreallocBlockArray(cmr, &listmatrix->right, memNodes) );
+  CMR_CALL( CMRreallocBlockArray(cmr, &listmatrix->above, memNodes) );
+  CMR_CALL( CMRreallocBlockArray(cmr, &listmatrix->below, memNodes) );
+  CMR_CALL( CMRreallocBlockArray(cmr, &listmatrix->row, memNodes) );
+  CMR_CALL( CMRreallocBlockArray(cmr, &listmatrix->column, memNodes) );
+  CMR_CALL( CMRreallocBlockArray(cmr, &listmatrix->value, memNodes) );
+  CMR_CALL( CMRreallocBlockArray(cmr, &listmatrix->special, memNodes) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the index of the first nonzero node of \p listmatrix.
+ */
+
+static inline
+size_t listmat8CompactFirstNonzero(
+  ListMat8Compact* listmatrix /**< List matrix. */
+)
+{
+  return 1 + listmatrix->memRows + listmatrix->memColumns;
+}
+
+/**
+ * \brief Puts the nonzero nodes from \p first to \p beyond onto the free list.
+ */
+
+static
+void listmat8CompactFreeNodes(
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  size_t first,                 /**< First node. */
+  size_t beyond                 /**< Beyond the last node. */
+)
+{
+  for (size_t node = beyond; node > first; --node)
+  {
+    listmatrix->left[node - 1] = listmatrix->firstFreeNonzero;
+    listmatrix->firstFreeNonzero = (ListMat8Index) (node - 1);
+  }
+}
+
+CMR_ERROR CMRlistmat8CompactAlloc(CMR* cmr, size_t memRows, size_t memColumns, size_t memNonzeros,
+  ListMat8Compact** presult)
+{
+  assert(cmr);
+  assert(presult);
+
+  size_t memNodes = 1 + memRows + memColumns + memNonzeros;
+  if (memNodes < memNonzeros || memNodes >= LISTMAT8_NONE)
+  {
+    CMRraiseErrorMessage(cmr, "Matrix with %zu rows, %zu columns and %zu nonzeros is too large for 32-bit indices.",
+      memRows, memColumns, memNonzeros);
+    return CMR_ERROR_OVERFLOW;
+  }
+
+  CMR_CALL( CMRallocBlock(cmr, presult) );
+  ListMat8Compact* result = *presult;
+
+  result->numRows = 0;
+  result->memRows = memRows;
+  result->rowNumNonzeros = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &result->rowNumNonzeros, memRows) );
+
+  result->numColumns = 0;
+  result->memColumns = memColumns;
+  result->columnNumNonzeros = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &result->columnNumNonzeros, memColumns) );
+
+  result->numNonzeros = 0;
+  result->memNonzeros = memNonzeros;
+  result->left = NULL;
+  result->right = NULL;
+  result->above = NULL;
+  result->below = NULL;
+  result->row = NULL;
+  result->column = NULL;
+  result->value = NULL;
+  result->special = NULL;
+  CMR_CALL( listmat8CompactReallocNodes(cmr, result, memNodes) );
+  result->firstFreeNonzero = LISTMAT8_NONE;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRlistmat8CompactFree(CMR* cmr, ListMat8Compact** plistmatrix)
+{
+  assert(cmr);
+  assert(plistmatrix);
+
+  ListMat8Compact* listmatrix = *plistmatrix;
+  if (!listmatrix)
+    return CMR_OKAY;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->special) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->value) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->column) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->row) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->below) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->above) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->right) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->left) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->columnNumNonzeros) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &listmatrix->rowNumNonzeros) );
+  CMR_CALL( CMRfreeBlock(cmr, plistmatrix) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRlistmat8CompactInitializeZero(CMR* cmr, ListMat8Compact* listmatrix, size_t numRows, size_t numColumns)
+{
+  CMR_UNUSED(cmr);
+
+  assert(cmr);
+  assert(listmatrix);
+  assert(numRows <= listmatrix->memRows);
+  assert(numColumns <= listmatrix->memColumns);
+
+  listmatrix->numRows = numRows;
+  listmatrix->numColumns = numColumns;
+  listmatrix->numNonzeros = 0;
+
+  /* The anchor and the heads of the rows and columns form two cyclic lists. */
+  ListMat8Index anchor = CMRlistmat8CompactAnchor(listmatrix);
+  listmatrix->row[anchor] = LISTMAT8_NONE;
+  listmatrix->column[anchor] = LISTMAT8_NONE;
+  listmatrix->value[anchor] = 0;
+  listmatrix->special[anchor] = 0;
+  listmatrix->above[anchor] = anchor;
+  listmatrix->below[anchor] = anchor;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    ListMat8Index head = CMRlistmat8CompactRowHead(listmatrix, row);
+    listmatrix->rowNumNonzeros[row] = 0;
+    listmatrix->row[head] = (ListMat8Index) row;
+    listmatrix->column[head] = LISTMAT8_NONE;
+    listmatrix->value[head] = 0;
+    listmatrix->special[head] = 0;
+    listmatrix->left[head] = head;
+    listmatrix->right[head] = head;
+    listmatrix->above[head] = listmatrix->above[anchor];
+    listmatrix->below[head] = anchor;
+    listmatrix->below[listmatrix->above[anchor]] = head;
+    listmatrix->above[anchor] = head;
+  }
+
+  listmatrix->left[anchor] = anchor;
+  listmatrix->right[anchor] = anchor;
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    ListMat8Index head = CMRlistmat8CompactColumnHead(listmatrix, column);
+    listmatrix->columnNumNonzeros[column] = 0;
+    listmatrix->row[head] = LISTMAT8_NONE;
+    listmatrix->column[head] = (ListMat8Index) column;
+    listmatrix->value[head] = 0;
+    listmatrix->special[head] = 0;
+    listmatrix->above[head] = head;
+    listmatrix->below[head] = head;
+    listmatrix->left[head] = listmatrix->left[anchor];
+    listmatrix->right[head] = anchor;
+    listmatrix->right[listmatrix->left[anchor]] = head;
+    listmatrix->left[anchor] = head;
+  }
+
+  /* All nonzero nodes are free. */
+  size_t firstNonzero = listmat8CompactFirstNonzero(listmatrix);
+  listmatrix->firstFreeNonzero = LISTMAT8_NONE;
+  listmat8CompactFreeNodes(listmatrix, firstNonzero, firstNonzero + listmatrix->memNonzeros);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRlistmat8CompactInitializeFromChrMatrix(CMR* cmr, ListMat8Compact* listmatrix, CMR_CHRMAT* matrix)
+{
+  assert(cmr);
+  assert(listmatrix);
+  assert(matrix);
+
+  /* Reallocate if necessary. */
+  if (listmatrix->memNonzeros < matrix->numNonzeros)
+  {
+    size_t memNodes = listmat8CompactFirstNonzero(listmatrix) + matrix->numNonzeros;
+    if (memNodes >= LISTMAT8_NONE)
+    {
+      CMRraiseErrorMessage(cmr, "Matrix with %zu nonzeros is too large for 32-bit indices.", matrix->numNonzeros);
+      return CMR_ERROR_OVERFLOW;
+    }
+    CMR_CALL( listmat8CompactReallocNodes(cmr, listmatrix, memNodes) );
+    listmatrix->memNonzeros = matrix->numNonzeros;
+  }
+
+  CMR_CALL( CMRlistmat8CompactInitializeZero(cmr, listmatrix, matrix->numRows, matrix->numColumns) );
+
+  /* Fill the nonzero nodes and append each to its row and column. */
+  size_t node = listmat8CompactFirstNonzero(listmatrix);
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    ListMat8Index rowHead = CMRlistmat8CompactRowHead(listmatrix, row);
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t e = first; e < beyond; ++e, ++node)
+    {
+      size_t column = matrix->entryColumns[e];
+      ListMat8Index columnHead = CMRlistmat8CompactColumnHead(listmatrix, column);
+      listmatrix->row[node] = (ListMat8Index) row;
+      listmatrix->column[node] = (ListMat8Index) column;
+      listmatrix->value[node] = matrix->entryValues[e];
+      listmatrix->special[node] = 0;
+
+      listmatrix->left[node] = listmatrix->left[rowHead];
+      listmatrix->right[node] = rowHead;
+      listmatrix->right[listmatrix->left[rowHead]] = (ListMat8Index) node;
+      listmatrix->left[rowHead] = (ListMat8Index) node;
+
+      listmatrix->above[node] = listmatrix->above[columnHead];
+      listmatrix->below[node] = columnHead;
+      listmatrix->below[listmatrix->above[columnHead]] = (ListMat8Index) node;
+      listmatrix->above[columnHead] = (ListMat8Index) node;
+
+      listmatrix->columnNumNonzeros[column]++;
+    }
+    listmatrix->rowNumNonzeros[row] = beyond - first;
+  }
+  listmatrix->numNonzeros = matrix->numNonzeros;
+
+  /* Only the remaining nonzero nodes are free. */
+  listmatrix->firstFreeNonzero = LISTMAT8_NONE;
+  listmat8CompactFreeNodes(listmatrix, node, listmat8CompactFirstNonzero(listmatrix) + listmatrix->memNonzeros);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRlistmat8CompactInsert(CMR* cmr, ListMat8Compact* listmatrix, size_t row, size_t column, int8_t value,
+  uint8_t special, ListMat8Index* pnonzero)
+{
+  assert(cmr);
+  assert(listmatrix);
+  assert(row < listmatrix->numRows);
+  assert(column < listmatrix->numColumns);
+
+  if (listmatrix->firstFreeNonzero == LISTMAT8_NONE)
+  {
+    assert(listmatrix->numNonzeros == listmatrix->memNonzeros);
+    size_t newSize = 2 * listmatrix->memNonzeros;
+    if (newSize < 256)
+      newSize = 256;
+    size_t firstNonzero = listmat8CompactFirstNonzero(listmatrix);
+    if (firstNonzero + newSize >= LISTMAT8_NONE)
+      newSize = LISTMAT8_NONE - 1 - firstNonzero;
+    if (newSize <= listmatrix->memNonzeros)
+    {
+      CMRraiseErrorMessage(cmr, "List matrix with %zu nonzeros is too large for 32-bit indices.",
+        listmatrix->numNonzeros + 1);
+      return CMR_ERROR_OVERFLOW;
+    }
+
+    /* Since nodes are indices, no links need to be repaired. */
+    CMR_CALL( listmat8CompactReallocNodes(cmr, listmatrix, firstNonzero + newSize) );
+    listmat8CompactFreeNodes(listmatrix, firstNonzero + listmatrix->memNonzeros, firstNonzero + newSize);
+    listmatrix->memNonzeros = newSize;
+  }
+
+  /* Actually insert the nonzero. */
+  ListMat8Index nz = listmatrix->firstFreeNonzero;
+  listmatrix->firstFreeNonzero = listmatrix->left[nz];
+  listmatrix->row[nz] = (ListMat8Index) row;
+  listmatrix->column[nz] = (ListMat8Index) column;
+  listmatrix->value[nz] = value;
+  listmatrix->special[nz] = special;
+
+  ListMat8Index head = CMRlistmat8CompactRowHead(listmatrix, row);
+  listmatrix->left[nz] = head;
+  listmatrix->right[nz] = listmatrix->right[head];
+  listmatrix->left[listmatrix->right[head]] = nz;
+  listmatrix->right[head] = nz;
+
+  head = CMRlistmat8CompactColumnHead(listmatrix, column);
+  listmatrix->above[nz] = head;
+  listmatrix->below[nz] = listmatrix->below[head];
+  listmatrix->above[listmatrix->below[head]] = nz;
+  listmatrix->below[head] = nz;
+
+  listmatrix->numNonzeros++;
+  listmatrix->rowNumNonzeros[row]++;
+  listmatrix->columnNumNonzeros[column]++;
+  if (pnonzero)
+    *pnonzero = nz;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRlistmat8CompactDelete(CMR* cmr, ListMat8Compact* listmatrix, ListMat8Index nonzero)
+{
+  CMR_UNUSED(cmr);
+
+  assert(cmr);
+  assert(listmatrix);
+  assert(nonzero >= listmat8CompactFirstNonzero(listmatrix));
+  assert(listmatrix->row[nonzero] < listmatrix->numRows);
+  assert(listmatrix->column[nonzero] < listmatrix->numColumns);
+
+  listmatrix->numNonzeros--;
+  listmatrix->rowNumNonzeros[listmatrix->row[nonzero]]--;
+  listmatrix->columnNumNonzeros[listmatrix->column[nonzero]]--;
+
+  listmatrix->right[listmatrix->left[nonzero]] = listmatrix->right[nonzero];
+  listmatrix->left[listmatrix->right[nonzero]] = listmatrix->left[nonzero];
+  listmatrix->below[listmatrix->above[nonzero]] = listmatrix->below[nonzero];
+  listmatrix->above[listmatrix->below[nonzero]] = listmatrix->above[nonzero];
+  listmatrix->left[nonzero] = listmatrix->firstFreeNonzero;
+  listmatrix->firstFreeNonzero = nonzero;
+
+  return CMR_OKAY;
+}
@@ -10,7 +10,7 @@
 #include "hashtable.h"
 
 #if defined(CMR_WITH_GMP)
-#include <gmp.h>
+#include "hybrid_int.h"
 #endif /* CMR_WITH_GMP */
 
 #ifdef __cplusplus
@@ -138,7 +138,7 @@ typedef struct _ListMatGMPNonzero
   struct _ListMatGMPNonzero* below;  /**< \brief Pointer to next nonzero in the same column. */
   size_t row;                       /**< \brief Row. */
   size_t column;                    /**< \brief Column. */
-  mpz_t value;                      /**< \brief Matrix entry. */
+  CMR_HYBRID_INT value;             /**< \brief Matrix entry; see \ref CMR_HYBRID_INT. */
   long special;                     /**< \brief May be used for a special purpose. */
 } ListMatGMPNonzero;
 
@@ -509,13 +509,13 @@ CMR_ERROR CMRlistmat64Insert(
  **/
 
 CMR_ERROR CMRlistmatGMPInsert(
-  CMR* cmr,               /**< \ref CMR environment. */
-  ListMatGMP* listmatrix, /**< List matrix. */
-  size_t row,             /**< Row of new element. */
-  size_t column,          /**< Column of new element. */
-  mpz_srcptr value,       /**< Value of new element. */
-  long special,           /**< Special entry of new element. */
-  ptrdiff_t* pmemoryShift /**< If not \c NULL, each nonzero's address is shifted by this value. */
+  CMR* cmr,                    /**< \ref CMR environment. */
+  ListMatGMP* listmatrix,      /**< List matrix. */
+  size_t row,                  /**< Row of new element. */
+  size_t column,               /**< Column of new element. */
+  const CMR_HYBRID_INT* value, /**< Value of new element. */
+  long special,                /**< Special entry of new element. */
+  ptrdiff_t* pmemoryShift      /**< If not \c NULL, each nonzero's address is shifted by this value. */
 );
 
 #endif /* CMR_WITH_GMP */
@@ -554,6 +554,170 @@ CMR_ERROR CMRlistmatGMPDelete(
 
 #endif /* CMR_WITH_GMP */
 
+/**
+ * \brief Index of a node of a \ref ListMat8Compact.
+ */
+
+typedef uint32_t ListMat8Index;
+
+#define LISTMAT8_NONE UINT32_MAX /**< \brief Row or column index of a head, and end of the free list. */
+
+/**
+ * \brief Linked-list representation of a matrix with 8-bit integer values whose links are 32-bit indices.
+ *
+ * It represents the same doubly-linked lists as a \ref ListMat8, but the fields of the nodes are stored in separate
+ * arrays, which are indexed by the nodes. Node 0 is the anchor, followed by the heads of the rows and those of the
+ * columns, which are obtained via \ref CMRlistmat8CompactRowHead and \ref CMRlistmat8CompactColumnHead. The remaining
+ * nodes are the nonzeros. A head has \ref LISTMAT8_NONE as its column (row) index, and the anchor has it as both.
+ *
+ * A nonzero needs 26 bytes instead of the 56 bytes of a \ref ListMat8Nonzero, and traversing a row (column) only
+ * touches the arrays that are needed for it. Indices of nodes remain valid when the arrays are reallocated. The total
+ * number of nodes must be less than \ref LISTMAT8_NONE.
+ */
+
+typedef struct
+{
+  size_t memRows;                     /**< \brief Memory for rows. */
+  size_t numRows;                     /**< \brief Number of rows. */
+  size_t* rowNumNonzeros;             /**< \brief Array with the number of nonzeros of each row. */
+  size_t memColumns;                  /**< \brief Memory for columns. */
+  size_t numColumns;                  /**< \brief Number of columns. */
+  size_t* columnNumNonzeros;          /**< \brief Array with the number of nonzeros of each column. */
+
+  size_t numNonzeros;                 /**< \brief Number of nonzeros. */
+  size_t memNonzeros;                 /**< \brief Amount of memory for nonzeros. */
+  ListMat8Index* left;                /**< \brief Array mapping each node to the previous node in its row. */
+  ListMat8Index* right;               /**< \brief Array mapping each node to the next node in its row. */
+  ListMat8Index* above;               /**< \brief Array mapping each node to the previous node in its column. */
+  ListMat8Index* below;               /**< \brief Array mapping each node to the next node in its column. */
+  ListMat8Index* row;                 /**< \brief Array mapping each node to its row. */
+  ListMat8Index* column;              /**< \brief Array mapping each node to its column. */
+  int8_t* value;                      /**< \brief Array mapping each node to its matrix entry. */
+  uint8_t* special;                   /**< \brief Array with a byte per node that may be used for a special purpose. */
+  ListMat8Index firstFreeNonzero;     /**< \brief Beginning of free list; uses \c left indices. */
+} ListMat8Compact;
+
+/**
+ * \brief Returns the anchor node of a \ref ListMat8Compact, which links the heads of all rows and columns.
+ */
+
+static inline
+ListMat8Index CMRlistmat8CompactAnchor(
+  ListMat8Compact* listmatrix /**< List matrix. */
+)
+{
+  CMR_UNUSED(listmatrix);
+
+  return 0;
+}
+
+/**
+ * \brief Returns the head node of \p row of a \ref ListMat8Compact.
+ */
+
+static inline
+ListMat8Index CMRlistmat8CompactRowHead(
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  size_t row                    /**< Row. */
+)
+{
+  CMR_UNUSED(listmatrix);
+  assert(row < listmatrix->memRows);
+
+  return (ListMat8Index) (1 + row);
+}
+
+/**
+ * \brief Returns the head node of \p column of a \ref ListMat8Compact.
+ */
+
+static inline
+ListMat8Index CMRlistmat8CompactColumnHead(
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  size_t column                 /**< Column. */
+)
+{
+  assert(column < listmatrix->memColumns);
+
+  return (ListMat8Index) (1 + listmatrix->memRows + column);
+}
+
+/**
+ * \brief Allocates memory for a compact 8-bit list matrix.
+ *
+ * Returns \ref CMR_ERROR_OVERFLOW if the nodes cannot be indexed by a \ref ListMat8Index.
+ */
+
+CMR_ERROR CMRlistmat8CompactAlloc(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  size_t memRows,           /**< Memory for rows. */
+  size_t memColumns,        /**< Memory for columns. */
+  size_t memNonzeros,       /**< Memory for nonzeros. */
+  ListMat8Compact** presult /**< Pointer for storing the created list matrix. */
+);
+
+/**
+ * \brief Frees a compact 8-bit list matrix.
+ */
+
+CMR_ERROR CMRlistmat8CompactFree(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  ListMat8Compact** plistmatrix /**< Pointer to list matrix. */
+);
+
+/**
+ * \brief Initializes a zero compact 8-bit list matrix.
+ *
+ * The numbers of rows and columns must not exceed the memory for them.
+ */
+
+CMR_ERROR CMRlistmat8CompactInitializeZero(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  size_t numRows,               /**< Number of rows. */
+  size_t numColumns             /**< Number of columns. */
+);
+
+/**
+ * \brief Copies \p matrix into \p listmatrix.
+ *
+ * The nonzeros of each row and of each column are sorted if those of the rows of \p matrix are sorted.
+ */
+
+CMR_ERROR CMRlistmat8CompactInitializeFromChrMatrix(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  CMR_CHRMAT* matrix            /**< Matrix to be copied to \p listmatrix. */
+);
+
+/**
+ * \brief Creates a new nonzero and inserts it as the first one of its row and of its column.
+ *
+ * The function may reallocate the node arrays, but the indices of existing nodes remain valid.
+ **/
+
+CMR_ERROR CMRlistmat8CompactInsert(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  size_t row,                   /**< Row of new nonzero. */
+  size_t column,                /**< Column of new nonzero. */
+  int8_t value,                 /**< Value of new nonzero. */
+  uint8_t special,              /**< Special entry of new nonzero. */
+  ListMat8Index* pnonzero       /**< Pointer for storing the new nonzero (may be \c NULL). */
+);
+
+/**
+ * \brief Deletes a nonzero.
+ *
+ * The \c right and \c below indices of \p nonzero are kept, i.e., a traversal of its row or column may continue.
+ **/
+
+CMR_ERROR CMRlistmat8CompactDelete(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  ListMat8Index nonzero         /**< Nonzero to delete. */
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,7 +11,7 @@
 
 #include "sort.h"
 #include "env_internal.h"
-#include "listmatrix.h"
+#include "matrix_internal.h"
 
 CMR_ERROR CMRsubmatCreate(CMR* cmr, size_t numRows, size_t numColumns, CMR_SUBMAT** psubmatrix)
 {
@@ -151,19 +151,33 @@ CMR_ERROR CMRsubmatZoomSubmat(CMR* cmr, CMR_SUBMAT* reference, CMR_SUBMAT* input
 
 CMR_ERROR CMRsubmatPrint(CMR* cmr, CMR_SUBMAT* submatrix, size_t numRows, size_t numColumns, FILE* stream)
 {
-  CMR_UNUSED(cmr);
-
   assert(cmr);
   assert(submatrix);
   assert(stream);
 
-  fprintf(stream, "%zu %zu %zu %zu\n", numRows, numColumns, submatrix->numRows, submatrix->numColumns);
+  CMR_TEXT_WRITER writer;
+  CMR_CALL( CMRtextWriterInit(cmr, &writer, stream) );
+  CMRtextWriterSize(&writer, numRows);
+  CMRtextWriterChar(&writer, ' ');
+  CMRtextWriterSize(&writer, numColumns);
+  CMRtextWriterChar(&writer, ' ');
+  CMRtextWriterSize(&writer, submatrix->numRows);
+  CMRtextWriterChar(&writer, ' ');
+  CMRtextWriterSize(&writer, submatrix->numColumns);
+  CMRtextWriterChar(&writer, '\n');
   for (size_t row = 0; row < submatrix->numRows; ++row)
-    fprintf(stream, "%zu ", submatrix->rows[row] + 1);
-  fputc('\n', stream);
+  {
+    CMRtextWriterSize(&writer, submatrix->rows[row] + 1);
+    CMRtextWriterChar(&writer, ' ');
+  }
+  CMRtextWriterChar(&writer, '\n');
   for (size_t column = 0; column < submatrix->numColumns; ++column)
-    fprintf(stream, "%zu ", submatrix->columns[column] + 1);
-  fputc('\n', stream);
+  {
+    CMRtextWriterSize(&writer, submatrix->columns[column] + 1);
+    CMRtextWriterChar(&writer, ' ');
+  }
+  CMRtextWriterChar(&writer, '\n');
+  CMR_CALL( CMRtextWriterFree(cmr, &writer) );
 
   return CMR_OKAY;
 }
@@ -242,18 +256,13 @@ CMR_ERROR CMRsubmatReadFromStream(CMR* cmr, CMR_SUBMAT ** psubmatrix, size_t* pn
 }
 
 
-static int CMRsortSubmatrixCompare(const void* p1, const void* p2)
-{
-  return *(size_t*)p1 - *(size_t*)p2;
-}
-
 CMR_ERROR CMRsortSubmatrix(CMR* cmr, CMR_SUBMAT* submatrix)
 {
   assert(cmr);
   assert(submatrix);
 
-  CMR_CALL( CMRsort(cmr, submatrix->numRows, submatrix->rows, sizeof(size_t), CMRsortSubmatrixCompare) );
-  CMR_CALL( CMRsort(cmr, submatrix->numColumns, submatrix->columns, sizeof(size_t), CMRsortSubmatrixCompare) );
+  CMR_CALL( CMRsortSizet(cmr, submatrix->rows, submatrix->numRows) );
+  CMR_CALL( CMRsortSizet(cmr, submatrix->columns, submatrix->numColumns) );
 
   return CMR_OKAY;
 }
@@ -271,14 +280,22 @@ CMR_ERROR CMRdblmatCreate(CMR* cmr, CMR_DBLMAT** matrix, int numRows, int numCol
   (*matrix)->rowSlice = NULL;
   (*matrix)->entryColumns = NULL;
   (*matrix)->entryValues = NULL;
-  CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->rowSlice, numRows + 1) );
-  if (numNonzeros > 0)
+  CMR_ERROR error = CMRallocBlockArray(cmr, &(*matrix)->rowSlice, numRows + 1);
+  if (!error && numNonzeros > 0)
   {
-    CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->entryColumns, numNonzeros) );
-    CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->entryValues, numNonzeros) );
+    error = CMRallocBlockArray(cmr, &(*matrix)->entryColumns, numNonzeros);
+    if (!error)
+      error = CMRallocBlockArray(cmr, &(*matrix)->entryValues, numNonzeros);
+  }
+  if (error)
+  {
+    /* A partially created matrix cannot be freed by the caller. */
+    CMR_CALL( CMRfreeBlockArray(cmr, &(*matrix)->entryColumns) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &(*matrix)->rowSlice) );
+    CMR_CALL( CMRfreeBlock(cmr, matrix) );
   }
 
-  return CMR_OKAY;
+  return error;
 }
 
 
@@ -294,14 +311,22 @@ CMR_ERROR CMRintmatCreate(CMR* cmr, CMR_INTMAT** matrix, int numRows, int numCol
   (*matrix)->rowSlice = NULL;
   (*matrix)->entryColumns = NULL;
   (*matrix)->entryValues = NULL;
-  CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->rowSlice, numRows + 1) );
-  if (numNonzeros > 0)
+  CMR_ERROR error = CMRallocBlockArray(cmr, &(*matrix)->rowSlice, numRows + 1);
+  if (!error && numNonzeros > 0)
   {
-    CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->entryColumns, numNonzeros) );
-    CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->entryValues, numNonzeros) );
+    error = CMRallocBlockArray(cmr, &(*matrix)->entryColumns, numNonzeros);
+    if (!error)
+      error = CMRallocBlockArray(cmr, &(*matrix)->entryValues, numNonzeros);
+  }
+  if (error)
+  {
+    /* A partially created matrix cannot be freed by the caller. */
+    CMR_CALL( CMRfreeBlockArray(cmr, &(*matrix)->entryColumns) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &(*matrix)->rowSlice) );
+    CMR_CALL( CMRfreeBlock(cmr, matrix) );
   }
 
-  return CMR_OKAY;
+  return error;
 }
 
 
@@ -317,14 +342,22 @@ CMR_ERROR CMRchrmatCreate(CMR* cmr, CMR_CHRMAT** matrix, int numRows, int numCol
   (*matrix)->rowSlice = NULL;
   (*matrix)->entryColumns = NULL;
   (*matrix)->entryValues = NULL;
-  CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->rowSlice, numRows + 1) );
-  if (numNonzeros > 0)
+  CMR_ERROR error = CMRallocBlockArray(cmr, &(*matrix)->rowSlice, numRows + 1);
+  if (!error && numNonzeros > 0)
+  {
+    error = CMRallocBlockArray(cmr, &(*matrix)->entryColumns, numNonzeros);
+    if (!error)
+      error = CMRallocBlockArray(cmr, &(*matrix)->entryValues, numNonzeros);
+  }
+  if (error)
   {
-    CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->entryColumns, numNonzeros) );
-    CMR_CALL( CMRallocBlockArray(cmr, &(*matrix)->entryValues, numNonzeros) );
+    /* A partially created matrix cannot be freed by the caller. */
+    CMR_CALL( CMRfreeBlockArray(cmr, &(*matrix)->entryColumns) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &(*matrix)->rowSlice) );
+    CMR_CALL( CMRfreeBlock(cmr, matrix) );
   }
 
-  return CMR_OKAY;
+  return error;
 }
 
 CMR_ERROR CMRdblmatFree(CMR* cmr, CMR_DBLMAT** pmatrix)
@@ -334,6 +367,15 @@ CMR_ERROR CMRdblmatFree(CMR* cmr, CMR_DBLMAT** pmatrix)
   if (!matrix)
     return CMR_OKAY;
 
+  /* Matrices read from binary files may use memory-mapped arrays. */
+  bool isMapped;
+  CMR_CALL( CMRmatrixReleaseMapping(cmr, matrix, &isMapped) );
+  if (isMapped)
+  {
+    CMR_CALL( CMRfreeBlock(cmr, pmatrix) );
+    return CMR_OKAY;
+  }
+
   assert(matrix->rowSlice);
   assert(matrix->numNonzeros == 0 || matrix->entryColumns);
   assert(matrix->numNonzeros == 0 || matrix->entryValues);
@@ -356,6 +398,15 @@ CMR_ERROR CMRintmatFree(CMR* cmr, CMR_INTMAT** pmatrix)
   if (!matrix)
     return CMR_OKAY;
 
+  /* Matrices read from binary files may use memory-mapped arrays. */
+  bool isMapped;
+  CMR_CALL( CMRmatrixReleaseMapping(cmr, matrix, &isMapped) );
+  if (isMapped)
+  {
+    CMR_CALL( CMRfreeBlock(cmr, pmatrix) );
+    return CMR_OKAY;
+  }
+
   assert(matrix->rowSlice);
   assert(matrix->numNonzeros == 0 || matrix->entryColumns);
   assert(matrix->numNonzeros == 0 || matrix->entryValues);
@@ -378,6 +429,17 @@ CMR_ERROR CMRchrmatFree(CMR* cmr, CMR_CHRMAT** pmatrix)
   if (!matrix)
     return CMR_OKAY;
 
+  CMR_CALL( CMRchrmatInvalidateTranspose(cmr, matrix) );
+
+  /* Matrices read from binary files may use memory-mapped arrays. */
+  bool isMapped;
+  CMR_CALL( CMRmatrixReleaseMapping(cmr, matrix, &isMapped) );
+  if (isMapped)
+  {
+    CMR_CALL( CMRfreeBlock(cmr, pmatrix) );
+    return CMR_OKAY;
+  }
+
   assert(matrix->rowSlice);
   assert(matrix->numNonzeros == 0 || matrix->entryColumns);
   assert(matrix->numNonzeros == 0 || matrix->entryValues);
@@ -422,6 +484,7 @@ CMR_ERROR CMRchrmatChangeNumNonzeros(CMR* cmr, CMR_CHRMAT* matrix, size_t newNum
   assert(cmr);
   assert(matrix);
 
+  CMR_CALL( CMRchrmatInvalidateTranspose(cmr, matrix) );
   CMR_CALL( CMRreallocBlockArray(cmr, &matrix->entryColumns, newNumNonzeros) );
   CMR_CALL( CMRreallocBlockArray(cmr, &matrix->entryValues, newNumNonzeros) );
   matrix->numNonzeros = newNumNonzeros;
@@ -429,43 +492,26 @@ CMR_ERROR CMRchrmatChangeNumNonzeros(CMR* cmr, CMR_CHRMAT* matrix, size_t newNum
   return CMR_OKAY;
 }
 
-static
-int compareEntries(const void** pa, const void** pb)
-{
-  size_t** a = (size_t**)(pa);
-  size_t** b = (size_t**)(pb);
-  return (**a < **b) ? -1 : (**a > **b ? 1 : 0);
-}
-
 CMR_ERROR CMRdblmatSortNonzeros(CMR* cmr, CMR_DBLMAT* matrix)
 {
   assert(cmr);
-  CMRconsistencyAssert( CMRdblmatConsistency(matrix) );
+  assert(matrix);
 
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    CMR_CALL( CMRsort2(cmr, beyond - first, &matrix->entryColumns[first], sizeof(size_t), &matrix->entryValues[first],
-      sizeof(double), compareEntries) );
-  }
+  CMR_CALL( CMRmatrixSortNonzeros(cmr, (CMR_MATRIX*) matrix, sizeof(double)) );
+
+  CMRconsistencyAssert( CMRdblmatConsistency(matrix) );
 
   return CMR_OKAY;
 }
 
-
 CMR_ERROR CMRintmatSortNonzeros(CMR* cmr, CMR_INTMAT* matrix)
 {
   assert(cmr);
   assert(matrix);
 
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    CMR_CALL( CMRsort2(cmr, beyond - first, &matrix->entryColumns[first], sizeof(size_t), &matrix->entryValues[first],
-      sizeof(int), compareEntries) );
-  }
+  CMR_CALL( CMRmatrixSortNonzeros(cmr, (CMR_MATRIX*) matrix, sizeof(int)) );
+
+  CMRconsistencyAssert( CMRintmatConsistency(matrix) );
 
   return CMR_OKAY;
 }
@@ -473,15 +519,9 @@ CMR_ERROR CMRintmatSortNonzeros(CMR* cmr, CMR_INTMAT* matrix)
 CMR_ERROR CMRchrmatSortNonzeros(CMR* cmr, CMR_CHRMAT* matrix)
 {
   assert(cmr);
+  assert(matrix);
 
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    CMRdbgMsg(2, "Sorting nonzero entries in range [%zu,%zu).\n", first, beyond);
-    CMR_CALL( CMRsort2(cmr, beyond - first, &matrix->entryColumns[first], sizeof(size_t), &matrix->entryValues[first],
-      sizeof(char), compareEntries) );
-  }
+  CMR_CALL( CMRmatrixSortNonzeros(cmr, (CMR_MATRIX*) matrix, sizeof(char)) );
 
   CMRconsistencyAssert( CMRchrmatConsistency(matrix) );
 
@@ -557,37 +597,7 @@ CMR_ERROR CMRdblmatTranspose(CMR* cmr, CMR_DBLMAT* matrix, CMR_DBLMAT** presult)
   CMRconsistencyAssert( CMRdblmatConsistency(matrix) );
 
   CMR_CALL( CMRdblmatCreate(cmr, presult, matrix->numColumns, matrix->numRows, matrix->numNonzeros) );
-  CMR_DBLMAT* result = *presult;
-
-  /* Count number of nonzeros in each column, storing in the next entry. */
-  for (size_t c = 0; c <= matrix->numColumns; ++c)
-    result->rowSlice[c] = 0;
-  for (size_t e = 0; e < matrix->numNonzeros; ++e)
-    result->rowSlice[matrix->entryColumns[e] + 1]++;
-
-  /* Compute start indices for columns. */
-  for (size_t c = 1; c < matrix->numColumns; ++c)
-    result->rowSlice[c] += result->rowSlice[c-1];
-
-  /* Create nonzeros. */
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    for (size_t entry = first; entry < beyond; ++entry)
-    {
-      size_t column = matrix->entryColumns[entry];
-      size_t transEntry = result->rowSlice[column];
-      result->entryColumns[transEntry] = row;
-      result->entryValues[transEntry] = matrix->entryValues[entry];
-      result->rowSlice[column]++;
-    }
-  }
-
-  /* We shifted rowSlice of result, so we shift it back. */
-  for (size_t c = matrix->numColumns; c > 0; --c)
-    result->rowSlice[c] = result->rowSlice[c-1];
-  result->rowSlice[0] = 0;
+  CMR_CALL( CMRmatrixTransposeInto(cmr, (CMR_MATRIX*) matrix, sizeof(double), (CMR_MATRIX*) *presult) );
 
   return CMR_OKAY;
 }
@@ -601,37 +611,7 @@ CMR_ERROR CMRintmatTranspose(CMR* cmr, CMR_INTMAT* matrix, CMR_INTMAT** presult)
   CMRconsistencyAssert( CMRintmatConsistency(matrix) );
 
   CMR_CALL( CMRintmatCreate(cmr, presult, matrix->numColumns, matrix->numRows, matrix->numNonzeros) );
-  CMR_INTMAT* result = *presult;
-
-  /* Count number of nonzeros in each column, storing in the next entry. */
-  for (size_t c = 0; c <= matrix->numColumns; ++c)
-    result->rowSlice[c] = 0;
-  for (size_t e = 0; e < matrix->numNonzeros; ++e)
-    result->rowSlice[matrix->entryColumns[e] + 1]++;
-
-  /* Compute start indices for columns. */
-  for (size_t c = 1; c < matrix->numColumns; ++c)
-    result->rowSlice[c] += result->rowSlice[c-1];
-
-  /* Create nonzeros. */
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    for (size_t entry = first; entry < beyond; ++entry)
-    {
-      size_t column = matrix->entryColumns[entry];
-      size_t transEntry = result->rowSlice[column];
-      result->entryColumns[transEntry] = row;
-      result->entryValues[transEntry] = matrix->entryValues[entry];
-      result->rowSlice[column]++;
-    }
-  }
-
-  /* We shifted rowSlice of result, so we shift it back. */
-  for (size_t c = matrix->numColumns; c > 0; --c)
-    result->rowSlice[c] = result->rowSlice[c-1];
-  result->rowSlice[0] = 0;
+  CMR_CALL( CMRmatrixTransposeInto(cmr, (CMR_MATRIX*) matrix, sizeof(int), (CMR_MATRIX*) *presult) );
 
   return CMR_OKAY;
 }
@@ -641,45 +621,171 @@ CMR_ERROR CMRchrmatTranspose(CMR* cmr, CMR_CHRMAT* matrix, CMR_CHRMAT** presult)
   assert(cmr);
   assert(matrix);
   assert(presult);
-  assert(!*presult);
+  assert(*presult == NULL);
   CMRconsistencyAssert( CMRchrmatConsistency(matrix) );
 
   CMR_CALL( CMRchrmatCreate(cmr, presult, matrix->numColumns, matrix->numRows, matrix->numNonzeros) );
-  CMR_CHRMAT* result = *presult;
+  CMR_CALL( CMRmatrixTransposeInto(cmr, (CMR_MATRIX*) matrix, sizeof(char), (CMR_MATRIX*) *presult) );
 
-  /* Count number of nonzeros in each column, storing in the next entry. */
-  for (size_t c = 0; c <= matrix->numColumns; ++c)
-    result->rowSlice[c] = 0;
-  for (size_t e = 0; e < matrix->numNonzeros; ++e)
-    result->rowSlice[matrix->entryColumns[e] + 1]++;
+  return CMR_OKAY;
+}
 
-  /* Compute start indices for columns. */
-  for (size_t c = 1; c < matrix->numColumns; ++c)
-    result->rowSlice[c] += result->rowSlice[c-1];
+/**
+ * \brief Removes the cached transpose of \p matrix from the list of the environment and returns it.
+ *
+ * The caller must hold the mutex of the environment.
+ */
 
-  /* Create nonzeros. */
-  for (size_t row = 0; row < matrix->numRows; ++row)
+static
+CMR_TRANSPOSE_CACHE* transposeCacheUnlink(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix  /**< Matrix. */
+)
+{
+  CMR_TRANSPOSE_CACHE** pcache = &cmr->transposes;
+  while (*pcache && (*pcache)->matrix != matrix)
+    pcache = &(*pcache)->next;
+  CMR_TRANSPOSE_CACHE* cache = *pcache;
+  if (cache)
+    *pcache = cache->next;
+  return cache;
+}
+
+/**
+ * \brief Frees a cached transpose.
+ */
+
+static
+CMR_ERROR transposeCacheFree(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  CMR_TRANSPOSE_CACHE** pcache  /**< Pointer to cached transpose. */
+)
+{
+  CMR_CALL( CMRchrmatFree(cmr, (CMR_CHRMAT**) &(*pcache)->transpose) );
+  CMR_CALL( CMRfreeBlock(cmr, pcache) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmatGetTranspose(CMR* cmr, CMR_CHRMAT* matrix, CMR_CHRMAT** ptranspose)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(ptranspose);
+
+  /* Look for a cached transpose. A cached transpose whose matrix no longer has the same arrays is stale. */
+  CMR_TRANSPOSE_CACHE* stale = NULL;
+  CMRmutexLock(&cmr->mutex);
+  CMR_TRANSPOSE_CACHE* cache = cmr->transposes;
+  while (cache && cache->matrix != matrix)
+    cache = cache->next;
+  if (cache && (cache->rowSlice != matrix->rowSlice || cache->entryColumns != matrix->entryColumns
+    || cache->numNonzeros != matrix->numNonzeros))
   {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    for (size_t entry = first; entry < beyond; ++entry)
-    {
-      size_t column = matrix->entryColumns[entry];
-      size_t transEntry = result->rowSlice[column];
-      result->entryColumns[transEntry] = row;
-      result->entryValues[transEntry] = matrix->entryValues[entry];
-      result->rowSlice[column]++;
-    }
+    stale = transposeCacheUnlink(cmr, matrix);
+    cache = NULL;
   }
+  CMR_CHRMAT* transpose = cache ? (CMR_CHRMAT*) cache->transpose : NULL;
+  CMRmutexUnlock(&cmr->mutex);
 
-  /* We shifted rowSlice of result, so we shift it back. */
-  for (size_t c = matrix->numColumns; c > 0; --c)
-    result->rowSlice[c] = result->rowSlice[c-1];
-  result->rowSlice[0] = 0;
+  if (stale)
+    CMR_CALL( transposeCacheFree(cmr, &stale) );
+
+  if (transpose)
+  {
+    *ptranspose = transpose;
+    return CMR_OKAY;
+  }
+
+  /* Compute the transpose without holding the mutex. */
+  CMR_CALL( CMRallocBlock(cmr, &cache) );
+  cache->matrix = matrix;
+  cache->rowSlice = matrix->rowSlice;
+  cache->entryColumns = matrix->entryColumns;
+  cache->numNonzeros = matrix->numNonzeros;
+  cache->transpose = NULL;
+  CMR_CALL( CMRchrmatTranspose(cmr, matrix, (CMR_CHRMAT**) &cache->transpose) );
+
+  /* Another thread may have cached a transpose in the meantime, in which case we use that one. */
+  CMRmutexLock(&cmr->mutex);
+  CMR_TRANSPOSE_CACHE* other = cmr->transposes;
+  while (other && other->matrix != matrix)
+    other = other->next;
+  if (other)
+    transpose = (CMR_CHRMAT*) other->transpose;
+  else
+  {
+    cache->next = cmr->transposes;
+    cmr->transposes = cache;
+    CMRatomicStoreFlag(&cmr->hasTransposes, true);
+    transpose = (CMR_CHRMAT*) cache->transpose;
+  }
+  CMRmutexUnlock(&cmr->mutex);
+
+  if (other)
+    CMR_CALL( transposeCacheFree(cmr, &cache) );
+
+  *ptranspose = transpose;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmatInvalidateTranspose(CMR* cmr, CMR_CHRMAT* matrix)
+{
+  assert(cmr);
+
+  if (!CMRatomicLoadFlag(&cmr->hasTransposes))
+    return CMR_OKAY;
+
+  CMRmutexLock(&cmr->mutex);
+  CMR_TRANSPOSE_CACHE* cache = transposeCacheUnlink(cmr, matrix);
+  CMRmutexUnlock(&cmr->mutex);
+
+  if (cache)
+    CMR_CALL( transposeCacheFree(cmr, &cache) );
 
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRchrmatCacheTranspose(CMR* cmr, CMR_CHRMAT* matrix, CMR_CHRMAT** ptranspose)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(ptranspose);
+  assert(*ptranspose);
+
+  CMR_CALL( CMRchrmatInvalidateTranspose(cmr, matrix) );
+
+  CMR_TRANSPOSE_CACHE* cache = NULL;
+  CMR_CALL( CMRallocBlock(cmr, &cache) );
+  cache->matrix = matrix;
+  cache->rowSlice = matrix->rowSlice;
+  cache->entryColumns = matrix->entryColumns;
+  cache->numNonzeros = matrix->numNonzeros;
+  cache->transpose = *ptranspose;
+  *ptranspose = NULL;
+
+  CMRmutexLock(&cmr->mutex);
+  cache->next = cmr->transposes;
+  cmr->transposes = cache;
+  CMRatomicStoreFlag(&cmr->hasTransposes, true);
+  CMRmutexUnlock(&cmr->mutex);
+
+  return CMR_OKAY;
+}
+
+void CMRmatrixReleaseAllTransposes(CMR* cmr)
+{
+  assert(cmr);
+
+  while (cmr->transposes)
+  {
+    CMR_TRANSPOSE_CACHE* cache = cmr->transposes;
+    cmr->transposes = cache->next;
+    transposeCacheFree(cmr, &cache);
+  }
+}
+
 CMR_ERROR CMRdblmatPermute(CMR* cmr, CMR_DBLMAT* matrix, size_t* rows, size_t* columns, CMR_DBLMAT** presult)
 {
   assert(cmr);
@@ -818,942 +924,292 @@ CMR_ERROR CMRchrmatPermute(CMR* cmr, CMR_CHRMAT* matrix, size_t* rows, size_t* c
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRdblmatPrintSparse(CMR* cmr, CMR_DBLMAT* matrix, FILE* stream)
-{
-  CMR_UNUSED(cmr);
-
-  assert(cmr);
-  assert(matrix);
-  assert(stream);
-
-  fprintf(stream, "%zu %zu %zu\n\n", matrix->numRows, matrix->numColumns, matrix->numNonzeros);
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row+1];
-    for (size_t entry = first; entry < beyond; ++entry)
-      fprintf(stream, "%zu %zu %g\n", row+1, matrix->entryColumns[entry]+1, matrix->entryValues[entry]);
-  }
-
-  return CMR_OKAY;
-}
-
-CMR_ERROR CMRintmatPrintSparse(CMR* cmr, CMR_INTMAT* matrix, FILE* stream)
-{
-  CMR_UNUSED(cmr);
-
-  assert(cmr);
-  assert(matrix);
-  assert(stream);
-
-  fprintf(stream, "%zu %zu %zu\n\n", matrix->numRows, matrix->numColumns, matrix->numNonzeros);
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row+1];
-    for (size_t entry = first; entry < beyond; ++entry)
-      fprintf(stream, "%zu %zu %d\n", row+1, matrix->entryColumns[entry]+1, matrix->entryValues[entry]);
-  }
-
-  return CMR_OKAY;
-}
-
-CMR_ERROR CMRchrmatPrintSparse(CMR* cmr, CMR_CHRMAT* matrix, FILE* stream)
-{
-  CMR_UNUSED(cmr);
-
-  assert(cmr);
-  assert(matrix);
-  assert(stream);
-
-  fprintf(stream, "%zu %zu %zu\n\n", matrix->numRows, matrix->numColumns, matrix->numNonzeros);
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row+1];
-    for (size_t entry = first; entry < beyond; ++entry)
-      fprintf(stream, "%zu %zu %d\n", row+1, matrix->entryColumns[entry]+1, matrix->entryValues[entry]);
-  }
-
-  return CMR_OKAY;
-}
-
-CMR_ERROR CMRdblmatPrintDense(CMR* cmr, CMR_DBLMAT* matrix, FILE* stream, char zeroChar, bool header)
-{
-  CMR_UNUSED(cmr);
-
-  assert(cmr);
-  assert(matrix);
-  assert(stream);
-
-  fprintf(stream, "%zu %zu\n", matrix->numRows, matrix->numColumns);
-  if (header)
-  {
-    fputs("   ", stream);
-    for (size_t column = 0; column < matrix->numColumns; ++column)
-      fprintf(stream, "%zu ", (column+1) % 10);
-    fputs("\n  ", stream);
-    for (size_t column = 0; column < matrix->numColumns; ++column)
-      fputs("--", stream);
-    fputc('\n', stream);
-  }
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    if (header)
-      fprintf(stream, "%zu| ", (row+1) % 10);
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    size_t column = 0;
-    for (size_t entry = first; entry < beyond; ++entry)
-    {
-      size_t entryColumn = matrix->entryColumns[entry];
-      for (; column < entryColumn; ++column)
-        fprintf(stream, "%c ", zeroChar);
-      fprintf(stream, "%g ", matrix->entryValues[entry]);
-      ++column;
-    }
-    for (; column < matrix->numColumns; ++column)
-      fprintf(stream, "%c ", zeroChar);
-    fputc('\n', stream);
-  }
-
-  return CMR_OKAY;
-}
-
-CMR_ERROR CMRintmatPrintDense(CMR* cmr, CMR_INTMAT* matrix, FILE* stream, char zeroChar, bool header)
-{
-  CMR_UNUSED(cmr);
-
-  assert(cmr);
-  assert(matrix);
-  assert(stream);
-
-  fprintf(stream, "%zu %zu\n", matrix->numRows, matrix->numColumns);
-  if (header)
-  {
-    fputs("   ", stream);
-    for (size_t column = 0; column < matrix->numColumns; ++column)
-      fprintf(stream, "%zu ", (column+1) % 10);
-    fputs("\n  ", stream);
-    for (size_t column = 0; column < matrix->numColumns; ++column)
-      fputs("--", stream);
-    fputc('\n', stream);
-  }
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    if (header)
-      fprintf(stream, "%zu| ", (row+1) % 10);
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    size_t column = 0;
-    for (size_t entry = first; entry < beyond; ++entry)
-    {
-      size_t entryColumn = matrix->entryColumns[entry];
-      for (; column < entryColumn; ++column)
-        fprintf(stream, "%c ", zeroChar);
-      fprintf(stream, "%d ", matrix->entryValues[entry]);
-      ++column;
-    }
-    for (; column < matrix->numColumns; ++column)
-      fprintf(stream, "%c ", zeroChar);
-    fputc('\n', stream);
-  }
-
-  return CMR_OKAY;
-}
-
-CMR_ERROR CMRchrmatPrintDense(CMR* cmr, CMR_CHRMAT* matrix, FILE* stream, char zeroChar, bool header)
-{
-  CMR_UNUSED(cmr);
-
-  assert(cmr);
-  assert(matrix);
-  assert(stream);
-
-  fprintf(stream, "%zu %zu\n", matrix->numRows, matrix->numColumns);
-  if (header)
-  {
-    fputs("   ", stream);
-#if defined(CMR_DEBUG)
-    for (size_t column = 0; column < matrix->numColumns; ++column)
-      fprintf(stream, "%2zu ", (column+1) % 10);
-#else /* !CMR_DEBUG */
-    for (size_t column = 0; column < matrix->numColumns; ++column)
-      fprintf(stream, "%zu ", (column+1) % 10);
-#endif /* CMR_DEBUG */
-    fputs("\n  ", stream);
-    for (size_t column = 0; column < matrix->numColumns; ++column)
-      fputs("--", stream);
-    fputc('\n', stream);
-  }
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    if (header)
-      fprintf(stream, "%zu| ", (row+1) % 10);
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    size_t column = 0;
-#if defined(CMR_DEBUG)
-    for (size_t entry = first; entry < beyond; ++entry)
-    {
-      size_t entryColumn = matrix->entryColumns[entry];
-      for (; column < entryColumn; ++column)
-        fprintf(stream, " %c ", zeroChar);
-      fprintf(stream, "%2d ", matrix->entryValues[entry]);
-      ++column;
-    }
-    for (; column < matrix->numColumns; ++column)
-      fprintf(stream, " %c ", zeroChar);
-#else /* !CMR_DEBUG */
-    for (size_t entry = first; entry < beyond; ++entry)
-    {
-      size_t entryColumn = matrix->entryColumns[entry];
-      for (; column < entryColumn; ++column)
-        fprintf(stream, "%c ", zeroChar);
-      fprintf(stream, "%d ", matrix->entryValues[entry]);
-      ++column;
-    }
-    for (; column < matrix->numColumns; ++column)
-      fprintf(stream, "%c ", zeroChar);
-#endif /* CMR_DEBUG */
-    fputc('\n', stream);
-  }
-  fflush(stream);
-
-  return CMR_OKAY;
-}
-
-
-
-typedef struct
-{
-  size_t row;
-  size_t column;
-  double value;
-} DblNonzero;
-
-static
-int compareDblNonzeros(const void* pa, const void* pb)
-{
-  size_t aRow = ((const DblNonzero*)pa)->row;
-  size_t bRow = ((const DblNonzero*)pb)->row;
-  if (aRow < bRow)
-    return -1;
-  else if (aRow > bRow)
-    return +1;
-
-  int aColumn = ((const DblNonzero*)pa)->column;
-  int bColumn = ((const DblNonzero*)pb)->column;
-  return aColumn - bColumn;
-}
-
-CMR_ERROR CMRdblmatCreateFromSparseStream(CMR* cmr, FILE* stream, CMR_DBLMAT** presult)
-{
-  assert(cmr);
-  assert(presult);
-  assert(!*presult);
-  assert(stream);
-
-  size_t numRows, numColumns, numNonzeros;
-  int numRead = fscanf(stream, "%zu %zu %zu", &numRows, &numColumns, &numNonzeros);
-  if (numRead < 3)
-  {
-    CMRraiseErrorMessage(cmr, "Could not read number of rows, columns and nonzeros.");
-    return CMR_ERROR_INPUT;
-  }
-
-  /* Read all nonzeros. */
-
-  DblNonzero* nonzeros = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &nonzeros, numNonzeros) );
-  size_t entry = 0;
-  for (size_t i = 0; i < numNonzeros; ++i)
-  {
-    size_t row;
-    size_t column;
-    double value;
-    numRead = fscanf(stream, "%zu %zu %lf", &row, &column, &value);
-    if (numRead < 3 || row == 0 || column == 0 || row > numRows || column > numColumns)
-    {
-      CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-      if (numRead == 2)
-        CMRraiseErrorMessage(cmr, "Could not read a double value of nonzero #%zu.", entry);
-      else
-        CMRraiseErrorMessage(cmr, "Could not read nonzero #%zu.", entry);
-      return CMR_ERROR_INPUT;
-    }
-    if (value != 0.0)
-    {
-      nonzeros[entry].row = row - 1;
-      nonzeros[entry].column = column - 1;
-      nonzeros[entry].value = value;
-      ++entry;
-    }
-  }
-  numNonzeros = entry;
-
-  /* We sort all nonzeros by row and then by column. */
-  CMR_CALL( CMRsort(cmr, numNonzeros, nonzeros, sizeof(DblNonzero), compareDblNonzeros) );
-
-  CMR_CALL( CMRdblmatCreate(cmr, presult, numRows, numColumns, numNonzeros) );
-  CMR_DBLMAT* result = *presult;
-  size_t previousRow = SIZE_MAX;
-  size_t previousColumn = SIZE_MAX;
-  size_t* pentryColumn = result->entryColumns;
-  double* pentryValue = result->entryValues;
-  for (size_t entry = 0; entry < numNonzeros; ++entry)
-  {
-    size_t row = nonzeros[entry].row;
-    size_t column = nonzeros[entry].column;
-    if (row == previousRow && column == previousColumn)
-    {
-      CMRraiseErrorMessage(cmr, "Duplicate nonzero at row %zu and column %zu.", row, column);
-      CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-      CMR_CALL( CMRdblmatFree(cmr, presult) );
-      return CMR_ERROR_INPUT;
-    }
-    while (previousRow < row || previousRow == SIZE_MAX)
-    {
-      ++previousRow;
-      result->rowSlice[previousRow] = entry;
-    }
-    *pentryColumn++ = nonzeros[entry].column;
-    *pentryValue++ = nonzeros[entry].value;
-    previousColumn = column;
-  }
-  while (previousRow < numRows || previousRow == SIZE_MAX)
-  {
-    ++previousRow;
-    result->rowSlice[previousRow] = numNonzeros;
-  }
-
-  CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-
-  return CMR_OKAY;
-}
-
-typedef struct
-{
-  size_t row;
-  size_t column;
-  int value;
-} IntNonzero;
+/**
+ * \brief Writes the header line "\p numRows \p numColumns \p numNonzeros" of the sparse format, followed by an empty
+ *        line.
+ */
 
 static
-int compareIntNonzeros(const void* pa, const void* pb)
-{
-  size_t  aRow = ((const IntNonzero*)pa)->row;
-  size_t  bRow = ((const IntNonzero*)pb)->row;
-  if (aRow < bRow)
-    return -1;
-  else if (aRow > bRow)
-    return +1;
-
-  size_t  aColumn = ((const IntNonzero*)pa)->column;
-  size_t  bColumn = ((const IntNonzero*)pb)->column;
-  return aColumn - bColumn;
-}
-
-CMR_ERROR CMRintmatCreateFromSparseStream(CMR* cmr, FILE* stream, CMR_INTMAT** presult)
-{
-  assert(cmr);
-  assert(presult);
-  assert(!*presult);
-  assert(stream);
-
-  size_t numRows, numColumns, numNonzeros;
-  int numRead = fscanf(stream, "%zu %zu %zu", &numRows, &numColumns, &numNonzeros);
-  if (numRead < 3)
-  {
-    CMRraiseErrorMessage(cmr, "Could not read number of rows, columns and nonzeros.");
-    return CMR_ERROR_INPUT;
-  }
-
-  /* Read all nonzeros. */
-
-  IntNonzero* nonzeros = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &nonzeros, numNonzeros) );
-  size_t entry = 0;
-  for (size_t i = 0; i < numNonzeros; ++i)
-  {
-    size_t row;
-    size_t column;
-    int value;
-    numRead = fscanf(stream, "%zu %zu %d", &row, &column, &value);
-    if (numRead < 3 || row == 0 || column == 0 || row > numRows || column > numColumns)
-    {
-      CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-      if (numRead == 2)
-        CMRraiseErrorMessage(cmr, "Could not read an integer value of nonzero #%zu.", entry);
-      else
-        CMRraiseErrorMessage(cmr, "Could not read nonzero #%zu.", entry);
-      return CMR_ERROR_INPUT;
-    }
-    if (value != 0)
-    {
-      nonzeros[entry].row = row - 1;
-      nonzeros[entry].column = column - 1;
-      nonzeros[entry].value = value;
-      ++entry;
-    }
-  }
-  numNonzeros = entry;
-
-  /* We sort all nonzeros by row and then by column. */
-  CMR_CALL( CMRsort(cmr, numNonzeros, nonzeros, sizeof(IntNonzero), compareIntNonzeros) );
-
-  CMR_CALL( CMRintmatCreate(cmr, presult, numRows, numColumns, numNonzeros) );
-  CMR_INTMAT* result = *presult;
-  size_t previousRow = SIZE_MAX;
-  size_t previousColumn = SIZE_MAX;
-  size_t* pentryColumn = result->entryColumns;
-  int* pentryValue = result->entryValues;
-  for (size_t entry = 0; entry < numNonzeros; ++entry)
-  {
-    size_t row = nonzeros[entry].row;
-    size_t column = nonzeros[entry].column;
-    if (row == previousRow && column == previousColumn)
-    {
-      CMRraiseErrorMessage(cmr, "Duplicate nonzero at row %zu and column %zu.", row, column);
-      CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-      CMR_CALL( CMRintmatFree(cmr, presult) );
-      return CMR_ERROR_INPUT;
-    }
-    while (previousRow < row || previousRow == SIZE_MAX)
-    {
-      ++previousRow;
-      result->rowSlice[previousRow] = entry;
-    }
-    *pentryColumn++ = nonzeros[entry].column;
-    *pentryValue++ = nonzeros[entry].value;
-    previousColumn = column;
-  }
-  while (previousRow < numRows || previousRow == SIZE_MAX)
-  {
-    ++previousRow;
-    result->rowSlice[previousRow] = numNonzeros;
-  }
-
-  CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-
-  return CMR_OKAY;
-}
-
-typedef struct
-{
-  size_t row;
-  size_t column;
-  char value;
-} ChrNonzero;
-
-static
-int compareChrNonzeros(const void* pa, const void* pb)
-{
-  size_t  aRow = ((const ChrNonzero*)pa)->row;
-  size_t  bRow = ((const ChrNonzero*)pb)->row;
-  if (aRow < bRow)
-    return -1;
-  else if (aRow > bRow)
-    return +1;
-
-  size_t  aColumn = ((const ChrNonzero*)pa)->column;
-  size_t  bColumn = ((const ChrNonzero*)pb)->column;
-  return aColumn - bColumn;
-}
-
-CMR_ERROR CMRchrmatCreateFromSparseStream(CMR* cmr, FILE* stream, CMR_CHRMAT** presult)
-{
-  assert(cmr);
-  assert(presult);
-  assert(!*presult);
-  assert(stream);
-
-  size_t numRows, numColumns, numNonzeros;
-  int numRead = fscanf(stream, "%zu %zu %zu", &numRows, &numColumns, &numNonzeros);
-  if (numRead < 3)
-  {
-    CMRraiseErrorMessage(cmr, "Could not read number of rows, columns and nonzeros.");
-    return CMR_ERROR_INPUT;
-  }
-
-  /* Read all nonzeros. */
-
-  ChrNonzero* nonzeros = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &nonzeros, numNonzeros) );
-  size_t entry = 0;
-  for (size_t i = 0; i < numNonzeros; ++i)
-  {
-    size_t row;
-    size_t column;
-    int value;
-    numRead = fscanf(stream, "%zu %zu %d", &row, &column, &value);
-    if (numRead < 3 || row == 0 || column == 0 || row > numRows || column > numColumns)
-    {
-      CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-      if (numRead == 2)
-        CMRraiseErrorMessage(cmr, "Could not read an integer value of nonzero #%zu.", entry);
-      else
-        CMRraiseErrorMessage(cmr, "Could not read nonzero #%zu.", entry);
-      return CMR_ERROR_INPUT;
-    }
-    if (value != 0)
-    {
-      nonzeros[entry].row = row - 1;
-      nonzeros[entry].column = column - 1;
-      nonzeros[entry].value = value;
-      ++entry;
-    }
-  }
-  numNonzeros = entry;
-
-  /* We sort all nonzeros by row and then by column. */
-  CMR_CALL( CMRsort(cmr, numNonzeros, nonzeros, sizeof(ChrNonzero), compareChrNonzeros) );
-
-  CMR_CALL( CMRchrmatCreate(cmr, presult, numRows, numColumns, numNonzeros) );
-  CMR_CHRMAT* result = *presult;
-  size_t previousRow = SIZE_MAX;
-  size_t previousColumn = SIZE_MAX;
-  size_t* pentryColumn = result->entryColumns;
-  char* pentryValue = result->entryValues;
-  for (size_t entry = 0; entry < numNonzeros; ++entry)
-  {
-    size_t row = nonzeros[entry].row;
-    size_t column = nonzeros[entry].column;
-    if (row == previousRow && column == previousColumn)
-    {
-      CMRraiseErrorMessage(cmr, "Duplicate nonzero at row %zu and column %zu.", row, column);
-      CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-      CMR_CALL( CMRchrmatFree(cmr, presult) );
-      return CMR_ERROR_INPUT;
-    }
-    while (previousRow < row || previousRow == SIZE_MAX)
-    {
-      ++previousRow;
-      result->rowSlice[previousRow] = entry;
-    }
-    *pentryColumn++ = nonzeros[entry].column;
-    *pentryValue++ = nonzeros[entry].value;
-    previousColumn = column;
-  }
-  while (previousRow < numRows || previousRow == SIZE_MAX)
-  {
-    ++previousRow;
-    result->rowSlice[previousRow] = numNonzeros;
-  }
-
-  CMR_CALL( CMRfreeStackArray(cmr, &nonzeros) );
-
-  return CMR_OKAY;
-}
-
-CMR_ERROR CMRdblmatCreateFromSparseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_DBLMAT** presult)
-{
-  FILE* inputFile = (!stdinName || strcmp(fileName, stdinName)) ? fopen(fileName, "r") : stdin;
-  if (!inputFile)
-  {
-    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
-    return CMR_ERROR_INPUT;
-  }
-
-  CMR_ERROR error = CMRdblmatCreateFromSparseStream(cmr, inputFile, presult);
-  if (!error)
-  {
-    /* Attempt to read another token. */
-    char token[16+4];
-    size_t numRead = fscanf(inputFile, "%16s", token);
-    if (numRead > 0 && strlen(token))
-    {
-      if (strlen(token) == 16)
-        strcat(token, "...");
-      CMRraiseErrorMessage(cmr, "Found unexpected token \"%s\" after having read a *sparse* %zux%zu matrix with %zu nonzeros.",
-        token, (*presult)->numRows, (*presult)->numColumns, (*presult)->numNonzeros);
-      CMRdblmatFree(cmr, presult);
-      error = CMR_ERROR_INPUT;
-    }
-  }
-
-  if (inputFile != stdin)
-    fclose(inputFile);
-
-  return error;
-}
-
-CMR_ERROR CMRintmatCreateFromSparseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_INTMAT** presult)
-{
-  FILE* inputFile = (!stdinName || strcmp(fileName, stdinName)) ? fopen(fileName, "r") : stdin;
-  if (!inputFile)
-  {
-    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
-    return CMR_ERROR_INPUT;
-  }
-
-  CMR_ERROR error = CMRintmatCreateFromSparseStream(cmr, inputFile, presult);
-  if (!error)
-  {
-    /* Attempt to read another token. */
-    char token[16+4];
-    size_t numRead = fscanf(inputFile, "%16s", token);
-    if (numRead > 0 && strlen(token))
-    {
-      if (strlen(token) == 16)
-        strcat(token, "...");
-      CMRraiseErrorMessage(cmr, "Found unexpected token \"%s\" after having read a *sparse* %zux%zu matrix with %zu nonzeros.",
-        token, (*presult)->numRows, (*presult)->numColumns, (*presult)->numNonzeros);
-      CMRintmatFree(cmr, presult);
-      error = CMR_ERROR_INPUT;
-    }
-  }
-
-  if (inputFile != stdin)
-    fclose(inputFile);
-
-  return error;
-}
-
-CMR_ERROR CMRchrmatCreateFromSparseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_CHRMAT** presult)
+void writeSparseHeader(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  size_t numRows,           /**< Number of rows. */
+  size_t numColumns,        /**< Number of columns. */
+  size_t numNonzeros        /**< Number of nonzeros. */
+)
 {
-  FILE* inputFile = (!stdinName || strcmp(fileName, stdinName)) ? fopen(fileName, "r") : stdin;
-  if (!inputFile)
-  {
-    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
-    return CMR_ERROR_INPUT;
-  }
-
-  CMR_ERROR error = CMRchrmatCreateFromSparseStream(cmr, inputFile, presult);
-  if (!error)
-  {
-    /* Attempt to read another token. */
-    char token[16+4];
-    size_t numRead = fscanf(inputFile, "%16s", token);
-    if (numRead > 0 && strlen(token))
-    {
-      if (strlen(token) == 16)
-        strcat(token, "...");
-      CMRraiseErrorMessage(cmr, "Found unexpected token \"%s\" after having read a *sparse* %zux%zu matrix with %zu nonzeros.",
-        token, (*presult)->numRows, (*presult)->numColumns, (*presult)->numNonzeros);
-      CMRchrmatFree(cmr, presult);
-      error = CMR_ERROR_INPUT;
-    }
-  }
-
-  if (inputFile != stdin)
-    fclose(inputFile);
-
-  return error;
+  CMRtextWriterSize(writer, numRows);
+  CMRtextWriterChar(writer, ' ');
+  CMRtextWriterSize(writer, numColumns);
+  CMRtextWriterChar(writer, ' ');
+  CMRtextWriterSize(writer, numNonzeros);
+  CMRtextWriterString(writer, "\n\n");
 }
 
-CMR_ERROR CMRdblmatCreateFromDenseStream(CMR* cmr, FILE* stream, CMR_DBLMAT** presult)
-{
-  assert(cmr);
-  assert(presult);
-  assert(!*presult);
-  assert(stream);
-
-  size_t numRows, numColumns;
-  int numRead = fscanf(stream, "%zu %zu", &numRows, &numColumns);
-  if (numRead < 2)
-  {
-    CMRraiseErrorMessage(cmr, "Could not read number of rows and columns.");
-    return CMR_ERROR_INPUT;
-  }
+/**
+ * \brief Writes the position "\p row \p column " of a nonzero in the sparse format using 1-based indices.
+ */
 
-  CMR_CALL( CMRdblmatCreate(cmr, presult, numRows, numColumns, 0) );
-  CMR_DBLMAT* result = *presult;
+static inline
+void writeSparsePosition(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  size_t row,               /**< Row. */
+  size_t column             /**< Column. */
+)
+{
+  CMRtextWriterSize(writer, row + 1);
+  CMRtextWriterChar(writer, ' ');
+  CMRtextWriterSize(writer, column + 1);
+  CMRtextWriterChar(writer, ' ');
+}
 
-  /* Initial memory. */
-  size_t memEntries = numRows * numColumns;
-  if (memEntries > 256)
-    memEntries = 256;
-  size_t* entryColumns = NULL;
-  double* entryValues = NULL;
-  CMR_CALL( CMRallocBlockArray(cmr, &entryColumns, memEntries) );
-  CMR_CALL( CMRallocBlockArray(cmr, &entryValues, memEntries) );
+/**
+ * \brief Writes the dimensions of a dense matrix and, if requested, the column header.
+ */
 
-  size_t entry = 0;
-  for (size_t row = 0; row < numRows; ++row)
+static
+void writeDenseHeader(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  size_t numRows,           /**< Number of rows. */
+  size_t numColumns,        /**< Number of columns. */
+  bool header,              /**< Whether to write the column header. */
+  bool wide                 /**< Whether each column takes 3 characters instead of 2. */
+)
+{
+  CMRtextWriterSize(writer, numRows);
+  CMRtextWriterChar(writer, ' ');
+  CMRtextWriterSize(writer, numColumns);
+  CMRtextWriterChar(writer, '\n');
+  if (header)
   {
-    result->rowSlice[row] = entry;
+    CMRtextWriterString(writer, "   ");
     for (size_t column = 0; column < numColumns; ++column)
     {
-      double x;
-      numRead = fscanf(stream, "%lf", &x);
-      if (numRead < 1)
-      {
-        CMRraiseErrorMessage(cmr, "Could not read matrix entry in row %zu and column %zu.", row, column);
-        return CMR_ERROR_INPUT;
-      }
-
-      if (x == 0.0)
-        continue;
-
-      if (entry == memEntries)
-      {
-        memEntries = 2*memEntries;
-        CMR_CALL( CMRreallocBlockArray(cmr, &entryColumns, memEntries) );
-        CMR_CALL( CMRreallocBlockArray(cmr, &entryValues, memEntries) );
-      }
-
-      entryColumns[entry] = column;
-      entryValues[entry] = x;
-      ++entry;
+      if (wide)
+        CMRtextWriterChar(writer, ' ');
+      CMRtextWriterChar(writer, (char) ('0' + (column+1) % 10));
+      CMRtextWriterChar(writer, ' ');
     }
+    CMRtextWriterString(writer, "\n  ");
+    for (size_t column = 0; column < numColumns; ++column)
+      CMRtextWriterString(writer, "--");
+    CMRtextWriterChar(writer, '\n');
   }
-  result->rowSlice[numRows] = entry;
+}
+
+/**
+ * \brief Writes the zero character of a dense matrix for each of the columns in the range [\p column, \p beyond).
+ */
 
-  /* Make arrays smaller again. */
-  if (entry < memEntries)
+static inline
+void writeDenseZeros(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  size_t column,            /**< First column. */
+  size_t beyond,            /**< Beyond the last column. */
+  char zeroChar,            /**< Zero character. */
+  bool wide                 /**< Whether each column takes 3 characters instead of 2. */
+)
+{
+  for (; column < beyond; ++column)
   {
-    CMR_CALL( CMRreallocBlockArray(cmr, &entryColumns, entry < 256 ? 256 : entry) );
-    CMR_CALL( CMRreallocBlockArray(cmr, &entryValues, entry < 256 ? 256 : entry) );
+    if (wide)
+      CMRtextWriterChar(writer, ' ');
+    CMRtextWriterChar(writer, zeroChar);
+    CMRtextWriterChar(writer, ' ');
   }
-
-  result->entryColumns = entryColumns;
-  result->entryValues = entryValues;
-  result->numNonzeros = entry;
-
-  return CMR_OKAY;
 }
 
-CMR_ERROR CMRintmatCreateFromDenseStream(CMR* cmr, FILE* stream, CMR_INTMAT** presult)
+CMR_ERROR CMRdblmatPrintSparse(CMR* cmr, CMR_DBLMAT* matrix, FILE* stream)
 {
   assert(cmr);
-  assert(presult);
-  assert(!*presult);
+  assert(matrix);
   assert(stream);
 
-  size_t numRows, numColumns;
-  int numRead = fscanf(stream, "%zu %zu", &numRows, &numColumns);
-  if (numRead < 2)
-  {
-    CMRraiseErrorMessage(cmr, "Could not read number of rows and columns.");
-    return CMR_ERROR_INPUT;
-  }
-
-  CMR_CALL( CMRintmatCreate(cmr, presult, numRows, numColumns, 0) );
-  CMR_INTMAT* result = *presult;
-
-  /* Initial memory. */
-  size_t memEntries = numRows * numColumns;
-  if (memEntries > 256)
-    memEntries = 256;
-  size_t* entryColumns = NULL;
-  int* entryValues = NULL;
-  CMR_CALL( CMRallocBlockArray(cmr, &entryColumns, memEntries) );
-  CMR_CALL( CMRallocBlockArray(cmr, &entryValues, memEntries) );
-
-  size_t entry = 0;
-  for (size_t row = 0; row < numRows; ++row)
+  CMR_TEXT_WRITER writer;
+  CMR_CALL( CMRtextWriterInit(cmr, &writer, stream) );
+  writeSparseHeader(&writer, matrix->numRows, matrix->numColumns, matrix->numNonzeros);
+  for (size_t row = 0; row < matrix->numRows; ++row)
   {
-    result->rowSlice[row] = entry;
-    for (size_t column = 0; column < numColumns; ++column)
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row+1];
+    for (size_t entry = first; entry < beyond; ++entry)
     {
-      int x;
-      numRead = fscanf(stream, "%d", &x);
-      if (numRead < 1)
-      {
-        CMRraiseErrorMessage(cmr, "Could not read matrix entry in row %zu and column %zu.", row, column);
-        return CMR_ERROR_INPUT;
-      }
-
-      if (x == 0.0)
-        continue;
-
-      if (entry == memEntries)
-      {
-        memEntries = 2*memEntries;
-        CMR_CALL( CMRreallocBlockArray(cmr, &entryColumns, memEntries) );
-        CMR_CALL( CMRreallocBlockArray(cmr, &entryValues, memEntries) );
-      }
-
-      entryColumns[entry] = column;
-      entryValues[entry] = x;
-      ++entry;
+      writeSparsePosition(&writer, row, matrix->entryColumns[entry]);
+      CMRtextWriterDouble(&writer, matrix->entryValues[entry]);
+      CMRtextWriterChar(&writer, '\n');
     }
   }
-  result->rowSlice[numRows] = entry;
-
-  /* Make arrays smaller again. */
-  if (entry < memEntries)
-  {
-    CMR_CALL( CMRreallocBlockArray(cmr, &entryColumns, entry < 256 ? 256 : entry) );
-    CMR_CALL( CMRreallocBlockArray(cmr, &entryValues, entry < 256 ? 256 : entry) );
-  }
-
-  result->entryColumns = entryColumns;
-  result->entryValues = entryValues;
-  result->numNonzeros = entry;
+  CMR_CALL( CMRtextWriterFree(cmr, &writer) );
 
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRchrmatCreateFromDenseStream(CMR* cmr, FILE* stream, CMR_CHRMAT** presult)
+CMR_ERROR CMRintmatPrintSparse(CMR* cmr, CMR_INTMAT* matrix, FILE* stream)
 {
   assert(cmr);
-  assert(presult);
-  assert(!*presult);
+  assert(matrix);
   assert(stream);
 
-  size_t numRows, numColumns;
-  int numRead = fscanf(stream, "%zu %zu", &numRows, &numColumns);
-  if (numRead < 2)
+  CMR_TEXT_WRITER writer;
+  CMR_CALL( CMRtextWriterInit(cmr, &writer, stream) );
+  writeSparseHeader(&writer, matrix->numRows, matrix->numColumns, matrix->numNonzeros);
+  for (size_t row = 0; row < matrix->numRows; ++row)
   {
-    CMRraiseErrorMessage(cmr, "Could not read number of rows and columns.");
-    return CMR_ERROR_INPUT;
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row+1];
+    for (size_t entry = first; entry < beyond; ++entry)
+    {
+      writeSparsePosition(&writer, row, matrix->entryColumns[entry]);
+      CMRtextWriterInt(&writer, matrix->entryValues[entry]);
+      CMRtextWriterChar(&writer, '\n');
+    }
   }
+  CMR_CALL( CMRtextWriterFree(cmr, &writer) );
 
-  CMR_CALL( CMRchrmatCreate(cmr, presult, numRows, numColumns, 0) );
-  CMR_CHRMAT* result = *presult;
+  return CMR_OKAY;
+}
 
-  /* Initial memory. */
-  size_t memEntries = numRows * numColumns;
-  if (memEntries > 256)
-    memEntries = 256;
-  size_t* entryColumns = NULL;
-  char* entryValues = NULL;
-  CMR_CALL( CMRallocBlockArray(cmr, &entryColumns, memEntries) );
-  CMR_CALL( CMRallocBlockArray(cmr, &entryValues, memEntries) );
+CMR_ERROR CMRchrmatPrintSparse(CMR* cmr, CMR_CHRMAT* matrix, FILE* stream)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(stream);
 
-  size_t entry = 0;
-  for (size_t row = 0; row < numRows; ++row)
+  CMR_TEXT_WRITER writer;
+  CMR_CALL( CMRtextWriterInit(cmr, &writer, stream) );
+  writeSparseHeader(&writer, matrix->numRows, matrix->numColumns, matrix->numNonzeros);
+  for (size_t row = 0; row < matrix->numRows; ++row)
   {
-    result->rowSlice[row] = entry;
-    for (size_t column = 0; column < numColumns; ++column)
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row+1];
+    for (size_t entry = first; entry < beyond; ++entry)
     {
-      double x;
-      numRead = fscanf(stream, "%lf", &x);
-      if (numRead < 1)
-      {
-        CMRraiseErrorMessage(cmr, "Could not read matrix entry in row %zu and column %zu.", row, column);
-        return CMR_ERROR_INPUT;
-      }
-
-      if (x == 0.0)
-        continue;
-
-      if (entry == memEntries)
-      {
-        memEntries = 2*memEntries;
-        CMR_CALL( CMRreallocBlockArray(cmr, &entryColumns, memEntries) );
-        CMR_CALL( CMRreallocBlockArray(cmr, &entryValues, memEntries) );
-      }
-
-      entryColumns[entry] = column;
-      entryValues[entry] = x;
-      ++entry;
+      writeSparsePosition(&writer, row, matrix->entryColumns[entry]);
+      CMRtextWriterInt(&writer, matrix->entryValues[entry]);
+      CMRtextWriterChar(&writer, '\n');
     }
   }
-  result->rowSlice[numRows] = entry;
-
-  /* Make arrays smaller again. */
-  if (entry < memEntries)
-  {
-    CMR_CALL( CMRreallocBlockArray(cmr, &entryColumns, entry < 256 ? 256 : entry) );
-    CMR_CALL( CMRreallocBlockArray(cmr, &entryValues, entry < 256 ? 256 : entry) );
-  }
-
-  result->entryColumns = entryColumns;
-  result->entryValues = entryValues;
-  result->numNonzeros = entry;
+  CMR_CALL( CMRtextWriterFree(cmr, &writer) );
 
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRdblmatCreateFromDenseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_DBLMAT** presult)
+CMR_ERROR CMRdblmatPrintDense(CMR* cmr, CMR_DBLMAT* matrix, FILE* stream, char zeroChar, bool header)
 {
-  FILE* inputFile = (!stdinName || strcmp(fileName, stdinName)) ? fopen(fileName, "r") : stdin;
-  if (!inputFile)
-  {
-    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
-    return CMR_ERROR_INPUT;
-  }
+  assert(cmr);
+  assert(matrix);
+  assert(stream);
 
-  CMR_ERROR error = CMRdblmatCreateFromDenseStream(cmr, inputFile, presult);
-  if (!error)
+  CMR_TEXT_WRITER writer;
+  CMR_CALL( CMRtextWriterInit(cmr, &writer, stream) );
+  writeDenseHeader(&writer, matrix->numRows, matrix->numColumns, header, false);
+  for (size_t row = 0; row < matrix->numRows; ++row)
   {
-    /* Attempt to read another token. */
-    char token[16+4];
-    int numRead = fscanf(inputFile, "%16s", token);
-    if (numRead != EOF && numRead > 0 && strlen(token))
+    if (header)
     {
-      if (strlen(token) == 16)
-        strcat(token, "...");
-      CMRraiseErrorMessage(cmr, "Found unexpected token \"%s\" after having read a *dense* %zux%zu matrix with %zu nonzeros.",
-        token, (*presult)->numRows, (*presult)->numColumns, (*presult)->numNonzeros);
-      CMRdblmatFree(cmr, presult);
-      error = CMR_ERROR_INPUT;
+      CMRtextWriterChar(&writer, (char) ('0' + (row+1) % 10));
+      CMRtextWriterString(&writer, "| ");
     }
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    size_t column = 0;
+    for (size_t entry = first; entry < beyond; ++entry)
+    {
+      size_t entryColumn = matrix->entryColumns[entry];
+      writeDenseZeros(&writer, column, entryColumn, zeroChar, false);
+      CMRtextWriterDouble(&writer, matrix->entryValues[entry]);
+      CMRtextWriterChar(&writer, ' ');
+      column = entryColumn + 1;
+    }
+    writeDenseZeros(&writer, column, matrix->numColumns, zeroChar, false);
+    CMRtextWriterChar(&writer, '\n');
   }
+  CMR_CALL( CMRtextWriterFree(cmr, &writer) );
 
-  if (inputFile != stdin)
-    fclose(inputFile);
-
-  return error;
+  return CMR_OKAY;
 }
 
-CMR_ERROR CMRintmatCreateFromDenseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_INTMAT** presult)
+CMR_ERROR CMRintmatPrintDense(CMR* cmr, CMR_INTMAT* matrix, FILE* stream, char zeroChar, bool header)
 {
-  FILE* inputFile = (!stdinName || strcmp(fileName, stdinName)) ? fopen(fileName, "r") : stdin;
-  if (!inputFile)
-  {
-    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
-    return CMR_ERROR_INPUT;
-  }
+  assert(cmr);
+  assert(matrix);
+  assert(stream);
 
-  CMR_ERROR error = CMRintmatCreateFromDenseStream(cmr, inputFile, presult);
-  if (!error)
+  CMR_TEXT_WRITER writer;
+  CMR_CALL( CMRtextWriterInit(cmr, &writer, stream) );
+  writeDenseHeader(&writer, matrix->numRows, matrix->numColumns, header, false);
+  for (size_t row = 0; row < matrix->numRows; ++row)
   {
-    /* Attempt to read another token. */
-    char token[16+4];
-    int numRead = fscanf(inputFile, "%16s", token);
-    if (numRead != EOF && numRead > 0 && strlen(token))
+    if (header)
+    {
+      CMRtextWriterChar(&writer, (char) ('0' + (row+1) % 10));
+      CMRtextWriterString(&writer, "| ");
+    }
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    size_t column = 0;
+    for (size_t entry = first; entry < beyond; ++entry)
     {
-      if (strlen(token) == 16)
-        strcat(token, "...");
-      CMRraiseErrorMessage(cmr, "Found unexpected token \"%s\" after having read a *dense* %zux%zu matrix with %zu nonzeros.",
-        token, (*presult)->numRows, (*presult)->numColumns, (*presult)->numNonzeros);
-      CMRintmatFree(cmr, presult);
-      error = CMR_ERROR_INPUT;
+      size_t entryColumn = matrix->entryColumns[entry];
+      writeDenseZeros(&writer, column, entryColumn, zeroChar, false);
+      CMRtextWriterInt(&writer, matrix->entryValues[entry]);
+      CMRtextWriterChar(&writer, ' ');
+      column = entryColumn + 1;
     }
+    writeDenseZeros(&writer, column, matrix->numColumns, zeroChar, false);
+    CMRtextWriterChar(&writer, '\n');
   }
+  CMR_CALL( CMRtextWriterFree(cmr, &writer) );
 
-  if (inputFile != stdin)
-    fclose(inputFile);
-
-  return error;
+  return CMR_OKAY;
 }
 
-CMR_ERROR CMRchrmatCreateFromDenseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_CHRMAT** presult)
+CMR_ERROR CMRchrmatPrintDense(CMR* cmr, CMR_CHRMAT* matrix, FILE* stream, char zeroChar, bool header)
 {
-  FILE* inputFile = (!stdinName || strcmp(fileName, stdinName)) ? fopen(fileName, "r") : stdin;
-  if (!inputFile)
-  {
-    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
-    return CMR_ERROR_INPUT;
-  }
+  assert(cmr);
+  assert(matrix);
+  assert(stream);
+
+#if defined(CMR_DEBUG)
+  /* In debug mode, entries are aligned in columns of width 3. */
+  const bool wide = true;
+#else /* !CMR_DEBUG */
+  const bool wide = false;
+#endif /* CMR_DEBUG */
 
-  CMR_ERROR error = CMRchrmatCreateFromDenseStream(cmr, inputFile, presult);
-  if (!error)
+  CMR_TEXT_WRITER writer;
+  CMR_CALL( CMRtextWriterInit(cmr, &writer, stream) );
+  writeDenseHeader(&writer, matrix->numRows, matrix->numColumns, header, wide);
+  for (size_t row = 0; row < matrix->numRows; ++row)
   {
-    /* Attempt to read another token. */
-    char token[16+4];
-    int numRead = fscanf(inputFile, "%16s", token);
-    if (numRead != EOF && numRead > 0 && strlen(token))
+    if (header)
+    {
+      CMRtextWriterChar(&writer, (char) ('0' + (row+1) % 10));
+      CMRtextWriterString(&writer, "| ");
+    }
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    size_t column = 0;
+    for (size_t entry = first; entry < beyond; ++entry)
     {
-      if (strlen(token) == 16)
-        strcat(token, "...");
-      CMRraiseErrorMessage(cmr, "Found unexpected token \"%s\" after having read a *dense* %zux%zu matrix with %zu nonzeros.",
-        token, (*presult)->numRows, (*presult)->numColumns, (*presult)->numNonzeros);
-      CMRchrmatFree(cmr, presult);
-      error = CMR_ERROR_INPUT;
+      size_t entryColumn = matrix->entryColumns[entry];
+      writeDenseZeros(&writer, column, entryColumn, zeroChar, wide);
+      if (wide && matrix->entryValues[entry] >= 0 && matrix->entryValues[entry] <= 9)
+        CMRtextWriterChar(&writer, ' ');
+      CMRtextWriterInt(&writer, matrix->entryValues[entry]);
+      CMRtextWriterChar(&writer, ' ');
+      column = entryColumn + 1;
     }
+    writeDenseZeros(&writer, column, matrix->numColumns, zeroChar, wide);
+    CMRtextWriterChar(&writer, '\n');
   }
+  CMR_CALL( CMRtextWriterFree(cmr, &writer) );
+  fflush(stream);
 
-  if (inputFile != stdin)
-    fclose(inputFile);
-
-  return error;
+  return CMR_OKAY;
 }
 
+
+
 bool CMRdblmatCheckEqual(CMR_DBLMAT* matrix1, CMR_DBLMAT* matrix2)
 {
   CMRconsistencyAssert( CMRdblmatConsistency(matrix1) );
@@ -2109,30 +1565,113 @@ char* CMRchrmatConsistency(CMR_CHRMAT* matrix)
   return NULL;
 }
 
-bool CMRdblmatIsBinary(CMR* cmr, CMR_DBLMAT* matrix, double epsilon, CMR_SUBMAT** psubmatrix)
+/**
+ * \brief Marks the values that are not within \p epsilon of 0 or 1, or of -1 if \p ternary is \c true.
+ *
+ * The result agrees with rounding each value to the nearest integer, but the loop has no branches, such that it is
+ * vectorized by the compiler.
+ *
+ * \returns Whether some value is marked.
+ */
+
+static
+bool classifyDoubleValues(
+  const double* values, /**< Array of values. */
+  size_t numValues,     /**< Number of values. */
+  double epsilon,       /**< Absolute error tolerance. */
+  bool ternary,         /**< Whether -1 is allowed. */
+  uint8_t* bad          /**< Array for storing whether each value is bad. */
+)
 {
-  assert(cmr);
-  CMRconsistencyAssert( CMRdblmatConsistency(matrix) );
-  assert(psubmatrix || !*psubmatrix);
+  const double lower = ternary ? -1.5 : -0.5;
+  const int allowMinusOne = ternary ? 1 : 0;
+  uint8_t anyBad = 0;
+  for (size_t i = 0; i < numValues; ++i)
+  {
+    double value = values[i];
+    int isGood = (value > lower) & (value < 1.5) & ((fabs(value) <= epsilon) | (fabs(value - 1.0) <= epsilon)
+      | (allowMinusOne & (fabs(value + 1.0) <= epsilon)));
+    bad[i] = (uint8_t) !isGood;
+    anyBad |= bad[i];
+  }
 
-  for (size_t row = 0; row < matrix->numRows; ++row)
+  return anyBad;
+}
+
+/**
+ * \brief Finds the first entry of \p matrix that is not within \p epsilon of 0 or 1, or of -1 if \p ternary is
+ *        \c true.
+ *
+ * The values are classified in blocks via \ref classifyDoubleValues.
+ *
+ * \returns The index of the entry or \c SIZE_MAX if there is none.
+ */
+
+static
+size_t findFirstBadDoubleEntry(
+  CMR_DBLMAT* matrix, /**< Matrix. */
+  double epsilon,     /**< Absolute error tolerance. */
+  bool ternary        /**< Whether -1 is allowed. */
+)
+{
+  uint8_t bad[256];
+  size_t beyond = matrix->rowSlice[matrix->numRows];
+  for (size_t first = matrix->rowSlice[0]; first < beyond; first += sizeof(bad))
   {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    for (size_t entry = first; entry < beyond; ++entry)
+    size_t length = beyond - first < sizeof(bad) ? beyond - first : sizeof(bad);
+    if (classifyDoubleValues(&matrix->entryValues[first], length, epsilon, ternary, bad))
     {
-      double value = matrix->entryValues[entry];
-      double rounded = round(value);
-      if (rounded < 0.0 || rounded > 1.0 || fabs(value - rounded) > epsilon)
+      for (size_t i = 0; i < length; ++i)
       {
-        if (psubmatrix)
-          CMR_CALL( CMRsubmatCreate1x1(cmr, row, matrix->entryColumns[entry], psubmatrix) );
-        return false;
+        if (bad[i])
+          return first + i;
       }
     }
   }
 
-  return true;
+  return SIZE_MAX;
+}
+
+/**
+ * \brief Returns the row of the given \p entry of \p matrix.
+ */
+
+static
+size_t findDoubleEntryRow(
+  CMR_DBLMAT* matrix, /**< Matrix. */
+  size_t entry        /**< Entry. */
+)
+{
+  /* Binary search for the last row whose slice starts at or before entry. */
+  size_t lower = 0;
+  size_t upper = matrix->numRows;
+  while (lower + 1 < upper)
+  {
+    size_t row = (lower + upper) / 2;
+    if (matrix->rowSlice[row] <= entry)
+      lower = row;
+    else
+      upper = row;
+  }
+  while (matrix->rowSlice[lower + 1] <= entry)
+    ++lower;
+
+  return lower;
+}
+
+bool CMRdblmatIsBinary(CMR* cmr, CMR_DBLMAT* matrix, double epsilon, CMR_SUBMAT** psubmatrix)
+{
+  assert(cmr);
+  CMRconsistencyAssert( CMRdblmatConsistency(matrix) );
+  assert(psubmatrix || !*psubmatrix);
+
+  size_t entry = findFirstBadDoubleEntry(matrix, epsilon, false);
+  if (entry == SIZE_MAX)
+    return true;
+
+  if (psubmatrix)
+    CMR_CALL( CMRsubmatCreate1x1(cmr, findDoubleEntryRow(matrix, entry), matrix->entryColumns[entry], psubmatrix) );
+  return false;
 }
 
 bool CMRintmatIsBinary(CMR* cmr, CMR_INTMAT* matrix, CMR_SUBMAT** psubmatrix)
@@ -2191,24 +1730,13 @@ bool CMRdblmatIsTernary(CMR* cmr, CMR_DBLMAT* matrix, double epsilon, CMR_SUBMAT
   CMRconsistencyAssert( CMRdblmatConsistency(matrix) );
   assert(!psubmatrix || !*psubmatrix);
 
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    size_t first = matrix->rowSlice[row];
-    size_t beyond = matrix->rowSlice[row + 1];
-    for (size_t entry = first; entry < beyond; ++entry)
-    {
-      double value = matrix->entryValues[entry];
-      double rounded = round(value);
-      if (rounded < -1.0 || rounded > 1.0 || fabs(value - rounded) > epsilon)
-      {
-        if (psubmatrix)
-          CMR_CALL( CMRsubmatCreate1x1(cmr, row, matrix->entryColumns[entry], psubmatrix) );
-        return false;
-      }
-    }
-  }
+  size_t entry = findFirstBadDoubleEntry(matrix, epsilon, true);
+  if (entry == SIZE_MAX)
+    return true;
 
-  return true;
+  if (psubmatrix)
+    CMR_CALL( CMRsubmatCreate1x1(cmr, findDoubleEntryRow(matrix, entry), matrix->entryColumns[entry], psubmatrix) );
+  return false;
 }
 
 bool CMRintmatIsTernary(CMR* cmr, CMR_INTMAT* matrix, CMR_SUBMAT** psubmatrix)
@@ -2788,106 +2316,198 @@ CMR_ERROR CMRchrmatFindEntry(CMR_CHRMAT* matrix, size_t row, size_t column, size
   return CMR_OKAY;
 }
 
+/**
+ * \brief Returns the one of the indices \p a and \p b with the larger count, preferring \p a in case of a tie.
+ *
+ * \c SIZE_MAX represents a missing index.
+ */
+
+static inline
+size_t maxTreeWinner(
+  const size_t* counts, /**< Array with the counts. */
+  size_t a,             /**< First index. */
+  size_t b              /**< Second index, larger than \p a. */
+)
+{
+  if (a == SIZE_MAX)
+    return b;
+  if (b == SIZE_MAX)
+    return a;
+  return counts[b] > counts[a] ? b : a;
+}
+
+/**
+ * \brief Builds a tournament tree for the \p n counts, whose root \p tree[1] is the smallest index of a maximum count.
+ *
+ * The tree has \p 2 * \p numLeaves nodes, where \p numLeaves is a power of 2 that is at least \p n.
+ */
+
 static
-size_t findMaximum(size_t* array, size_t length, size_t* pmaxIndex)
+void maxTreeBuild(
+  size_t* tree,         /**< Array of tree nodes. */
+  size_t numLeaves,     /**< Number of leaves. */
+  const size_t* counts, /**< Array with the counts. */
+  size_t n              /**< Number of counts. */
+)
 {
-  assert(length > 0);
+  for (size_t i = 0; i < numLeaves; ++i)
+    tree[numLeaves + i] = i < n ? i : SIZE_MAX;
+  for (size_t node = numLeaves - 1; node > 0; --node)
+    tree[node] = maxTreeWinner(counts, tree[2 * node], tree[2 * node + 1]);
+}
 
-  size_t maximum = array[0];
-  *pmaxIndex = 0;
+/**
+ * \brief Updates the tournament tree after \p counts[\p i] changed.
+ */
 
-  for (size_t i = 1; i < length; ++i)
-  {
-    if (array[i] > maximum)
-    {
-      maximum = array[i];
-      *pmaxIndex = i;
-    }
-  }
-  return maximum;
+static
+void maxTreeUpdate(
+  size_t* tree,         /**< Array of tree nodes. */
+  size_t numLeaves,     /**< Number of leaves. */
+  const size_t* counts, /**< Array with the counts. */
+  size_t i              /**< Index whose count changed. */
+)
+{
+  for (size_t node = (numLeaves + i) / 2; node > 0; node /= 2)
+    tree[node] = maxTreeWinner(counts, tree[2 * node], tree[2 * node + 1]);
 }
 
+/**
+ * \brief Finds a submatrix of \p matrix whose entries are within \p epsilon of 0 or 1, or of -1 if \p ternary is
+ *        \c true.
+ *
+ * As long as bad entries remain, a row or column with the maximum number of bad entries is removed, preferring rows
+ * and smaller indices. The numbers are maintained in tournament trees, such that removing a row or column takes time
+ * proportional to its number of bad entries times the logarithm of the dimensions.
+ */
+
 static
-CMR_ERROR findBadSubmatrixByMaximum(
-  CMR* cmr,
-  ListMat8* listmatrix,
-  CMR_SUBMAT** psubmatrix
+CMR_ERROR findGoodDoubleSubmatrix(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_DBLMAT* matrix,     /**< Matrix. */
+  double epsilon,         /**< Absolute error tolerance. */
+  bool ternary,           /**< Whether -1 is allowed. */
+  CMR_SUBMAT** psubmatrix /**< Pointer for storing the submatrix. */
 )
 {
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+  size_t firstEntry = matrix->rowSlice[0];
+  size_t numEntries = matrix->rowSlice[numRows] - firstEntry;
+
+  uint8_t* entriesBad = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &entriesBad, numEntries + 1) );
+  classifyDoubleValues(&matrix->entryValues[firstEntry], numEntries, epsilon, ternary, entriesBad);
+
+  /* Count the bad entries and store the rows of those of each column. */
   size_t* rowNumBadEntries = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowNumBadEntries, numRows + 1) );
   size_t* columnNumBadEntries = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &rowNumBadEntries, listmatrix->numRows) );
-  for (size_t row = 0; row < listmatrix->numRows; ++row)
-    rowNumBadEntries[row] = 0;
-  CMR_CALL( CMRallocStackArray(cmr, &columnNumBadEntries, listmatrix->numColumns) );
-  for (size_t column = 0; column < listmatrix->numColumns; ++column)
-    columnNumBadEntries[column] = 0;
-
-  for (size_t row = 0; row < listmatrix->numRows; ++row)
+  CMR_CALL( CMRallocStackArray(cmr, &columnNumBadEntries, numColumns + 1) );
+  size_t* columnBadSlice = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnBadSlice, numColumns + 1) );
+  for (size_t column = 0; column <= numColumns; ++column)
+    columnBadSlice[column] = 0;
+  size_t numBadEntries = 0;
+  for (size_t row = 0; row < numRows; ++row)
   {
-    for (ListMat8Nonzero* nonzero = listmatrix->rowElements[row].head.right;
-      nonzero != &listmatrix->rowElements[row].head; nonzero = nonzero->right)
+    rowNumBadEntries[row] = 0;
+    for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
     {
-      if (nonzero->special)
+      if (entriesBad[e - firstEntry])
       {
-        nonzero->special = 1;
-        assert(row == nonzero->row);
         rowNumBadEntries[row]++;
-        columnNumBadEntries[nonzero->column]++;
+        columnBadSlice[matrix->entryColumns[e] + 1]++;
+        ++numBadEntries;
       }
     }
   }
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    columnNumBadEntries[column] = columnBadSlice[column + 1];
+    columnBadSlice[column + 1] += columnBadSlice[column];
+  }
+  size_t* columnBadRows = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnBadRows, numBadEntries + 1) );
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+    {
+      if (entriesBad[e - firstEntry])
+        columnBadRows[columnBadSlice[matrix->entryColumns[e]]++] = row;
+    }
+  }
+  for (size_t column = numColumns; column > 0; --column)
+    columnBadSlice[column] = columnBadSlice[column - 1];
+  columnBadSlice[0] = 0;
+
+  size_t numRowLeaves = 1;
+  while (numRowLeaves < numRows)
+    numRowLeaves *= 2;
+  size_t numColumnLeaves = 1;
+  while (numColumnLeaves < numColumns)
+    numColumnLeaves *= 2;
+  size_t* rowTree = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowTree, 2 * numRowLeaves) );
+  maxTreeBuild(rowTree, numRowLeaves, rowNumBadEntries, numRows);
+  size_t* columnTree = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnTree, 2 * numColumnLeaves) );
+  maxTreeBuild(columnTree, numColumnLeaves, columnNumBadEntries, numColumns);
+  bool* rowsRemoved = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsRemoved, numRows + 1) );
+  for (size_t row = 0; row < numRows; ++row)
+    rowsRemoved[row] = false;
+  bool* columnsRemoved = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsRemoved, numColumns + 1) );
+  for (size_t column = 0; column < numColumns; ++column)
+    columnsRemoved[column] = false;
 
-  size_t rowMaximumIndex;
-  size_t columnMaximumIndex;
-  size_t numRemainingRows = listmatrix->numRows;
-  size_t numRemainingColumns = listmatrix->numColumns;
-  while (true)
+  size_t numRemainingRows = numRows;
+  size_t numRemainingColumns = numColumns;
+  while (numRows > 0)
   {
-    size_t rowMaximum = findMaximum(rowNumBadEntries, listmatrix->numRows, &rowMaximumIndex);
+    size_t rowMaximumIndex = rowTree[1];
+    size_t rowMaximum = rowNumBadEntries[rowMaximumIndex];
     if (rowMaximum == 0)
       break;
 
-    size_t columnMaximum = findMaximum(columnNumBadEntries, listmatrix->numColumns, &columnMaximumIndex);
-    
+    size_t columnMaximumIndex = columnTree[1];
+    size_t columnMaximum = columnNumBadEntries[columnMaximumIndex];
+
     CMRdbgMsg(2, "row/column maxima are %zu and %zu\n", rowMaximum, columnMaximum);
-    
+
     if (rowMaximum >= columnMaximum)
     {
-      for (ListMat8Nonzero* nz = listmatrix->rowElements[rowMaximumIndex].head.right;
-        nz != &listmatrix->rowElements[rowMaximumIndex].head; nz = nz->right)
+      for (size_t e = matrix->rowSlice[rowMaximumIndex]; e < matrix->rowSlice[rowMaximumIndex + 1]; ++e)
       {
-        CMRdbgMsg(4, "Removing nonzero at %zu,%zu with special %d.\n", nz->row, nz->column, nz->special);
-        if (nz->special)
+        size_t column = matrix->entryColumns[e];
+        if (entriesBad[e - firstEntry] && !columnsRemoved[column])
         {
-          assert(columnNumBadEntries[nz->column] > 0);
-          columnNumBadEntries[nz->column]--;
+          assert(columnNumBadEntries[column] > 0);
+          columnNumBadEntries[column]--;
+          maxTreeUpdate(columnTree, numColumnLeaves, columnNumBadEntries, column);
         }
-        nz->above->below = nz->below;
-        nz->below->above = nz->above;
       }
       rowNumBadEntries[rowMaximumIndex] = 0;
-      listmatrix->rowElements[rowMaximumIndex].head.above->below = listmatrix->rowElements[rowMaximumIndex].head.below;
-      listmatrix->rowElements[rowMaximumIndex].head.below->above = listmatrix->rowElements[rowMaximumIndex].head.above;
+      maxTreeUpdate(rowTree, numRowLeaves, rowNumBadEntries, rowMaximumIndex);
+      rowsRemoved[rowMaximumIndex] = true;
       numRemainingRows--;
     }
     else
     {
-      for (ListMat8Nonzero* nz = listmatrix->columnElements[columnMaximumIndex].head.below;
-        nz != &listmatrix->columnElements[columnMaximumIndex].head; nz = nz->below)
+      for (size_t i = columnBadSlice[columnMaximumIndex]; i < columnBadSlice[columnMaximumIndex + 1]; ++i)
       {
-        CMRdbgMsg(4, "Removing nonzero at %zu,%zu with special %d.\n", nz->row, nz->column, nz->special);
-        if (nz->special)
+        size_t row = columnBadRows[i];
+        if (!rowsRemoved[row])
         {
-          assert(rowNumBadEntries[nz->row] > 0);
-          rowNumBadEntries[nz->row]--;
+          assert(rowNumBadEntries[row] > 0);
+          rowNumBadEntries[row]--;
+          maxTreeUpdate(rowTree, numRowLeaves, rowNumBadEntries, row);
         }
-        nz->left->right = nz->right;
-        nz->right->left = nz->left;
       }
       columnNumBadEntries[columnMaximumIndex] = 0;
-      listmatrix->columnElements[columnMaximumIndex].head.left->right = listmatrix->columnElements[columnMaximumIndex].head.right;
-      listmatrix->columnElements[columnMaximumIndex].head.right->left = listmatrix->columnElements[columnMaximumIndex].head.left;
+      maxTreeUpdate(columnTree, numColumnLeaves, columnNumBadEntries, columnMaximumIndex);
+      columnsRemoved[columnMaximumIndex] = true;
       numRemainingColumns--;
     }
   }
@@ -2895,20 +2515,27 @@ CMR_ERROR findBadSubmatrixByMaximum(
   CMR_CALL( CMRsubmatCreate(cmr, numRemainingRows, numRemainingColumns, psubmatrix) );
   CMR_SUBMAT* submatrix = *psubmatrix;
   numRemainingRows = 0;
-  numRemainingColumns = 0;
-  for (ListMat8Nonzero* rowHead = listmatrix->anchor.below; rowHead != &listmatrix->anchor; rowHead = rowHead->below)
+  for (size_t row = 0; row < numRows; ++row)
   {
-    submatrix->rows[numRemainingRows++] = rowHead->row;
+    if (!rowsRemoved[row])
+      submatrix->rows[numRemainingRows++] = row;
   }
-  for (ListMat8Nonzero* columnHead = listmatrix->anchor.right; columnHead != &listmatrix->anchor;
-    columnHead = columnHead->right)
+  numRemainingColumns = 0;
+  for (size_t column = 0; column < numColumns; ++column)
   {
-    submatrix->columns[numRemainingColumns++] = columnHead->column;
+    if (!columnsRemoved[column])
+      submatrix->columns[numRemainingColumns++] = column;
   }
 
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsRemoved) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsRemoved) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnTree) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowTree) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnBadRows) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnBadSlice) );
   CMR_CALL( CMRfreeStackArray(cmr, &columnNumBadEntries) );
   CMR_CALL( CMRfreeStackArray(cmr, &rowNumBadEntries) );
-  CMR_CALL( CMRlistmat8Free(cmr, &listmatrix) );
+  CMR_CALL( CMRfreeStackArray(cmr, &entriesBad) );
 
   return CMR_OKAY;
 }
@@ -2920,23 +2547,7 @@ CMR_ERROR CMRdblmatFindBinarySubmatrix(CMR* cmr, CMR_DBLMAT* matrix, double epsi
   assert(epsilon >= 0.0);
   assert(psubmatrix);
 
-  ListMat8* listmatrix = NULL;
-  CMR_CALL( CMRlistmat8Alloc(cmr, matrix->numRows, matrix->numColumns, matrix->numNonzeros, &listmatrix) );
-  CMR_CALL( CMRlistmat8InitializeFromDoubleMatrix(cmr, listmatrix, matrix, epsilon) );
-
-  CMRdbgMsg(2, "List matrix has %zu nonzeros.\n", listmatrix->numNonzeros);
-
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    for (ListMat8Nonzero* nonzero = listmatrix->rowElements[row].head.right;
-      nonzero != &listmatrix->rowElements[row].head; nonzero = nonzero->right)
-    {
-      if (nonzero->value < 0 || nonzero->value > 1)
-        nonzero->special = 1;
-    }
-  }
-  
-  CMR_CALL( findBadSubmatrixByMaximum(cmr, listmatrix, psubmatrix) );
+  CMR_CALL( findGoodDoubleSubmatrix(cmr, matrix, epsilon, false, psubmatrix) );
 
   return CMR_OKAY;
 }
@@ -2948,23 +2559,7 @@ CMR_ERROR CMRdblmatFindTernarySubmatrix(CMR* cmr, CMR_DBLMAT* matrix, double eps
   assert(epsilon >= 0.0);
   assert(psubmatrix);
 
-  ListMat8* listmatrix = NULL;
-  CMR_CALL( CMRlistmat8Alloc(cmr, matrix->numRows, matrix->numColumns, matrix->numNonzeros, &listmatrix) );
-  CMR_CALL( CMRlistmat8InitializeFromDoubleMatrix(cmr, listmatrix, matrix, epsilon) );
-
-  CMRdbgMsg(2, "List matrix has %zu nonzeros.\n", listmatrix->numNonzeros);
-
-  for (size_t row = 0; row < matrix->numRows; ++row)
-  {
-    for (ListMat8Nonzero* nonzero = listmatrix->rowElements[row].head.right;
-      nonzero != &listmatrix->rowElements[row].head; nonzero = nonzero->right)
-    {
-      if (nonzero->value < -1 || nonzero->value > +1)
-        nonzero->special = 1;
-    }
-  }
-  
-  CMR_CALL( findBadSubmatrixByMaximum(cmr, listmatrix, psubmatrix) );
+  CMR_CALL( findGoodDoubleSubmatrix(cmr, matrix, epsilon, true, psubmatrix) );
 
   return CMR_OKAY;
 }
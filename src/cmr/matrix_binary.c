@@ -0,0 +1,1363 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/matrix.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+
+#include "env_internal.h"
+#include "io_internal.h"
+#include "matrix_internal.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CMR_WITH_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* __unix__ || __APPLE__ */
+
+/**
+ * \brief Magic bytes at the beginning of each binary matrix file.
+ */
+
+static const char BINARY_MAGIC[8] = { 'C', 'M', 'R', '-', 'C', 'S', 'R', '\n' };
+
+#define BINARY_VERSION 1      /**< Version of the binary matrix format written by this implementation. */
+#define BINARY_HEADER_SIZE 64 /**< Size of the header of a binary matrix file in bytes. */
+#define BINARY_CHUNK_SIZE 4096 /**< Number of array elements that are converted at once. */
+
+/**
+ * \brief Types of the values of a binary matrix file.
+ */
+
+typedef enum
+{
+  BINARY_VALUES_CHAR = 1,   /**< Values are 8-bit signed integers. */
+  BINARY_VALUES_INT = 2,    /**< Values are 32-bit signed integers. */
+  BINARY_VALUES_DOUBLE = 3  /**< Values are IEEE 754 double precision numbers. */
+} BinaryValueType;
+
+/**
+ * \brief Header of a binary matrix file.
+ */
+
+typedef struct
+{
+  uint32_t version;           /**< \brief Version of the format. */
+  BinaryValueType valueType;  /**< \brief Type of the values. */
+  size_t numRows;             /**< \brief Number of rows. */
+  size_t numColumns;          /**< \brief Number of columns. */
+  size_t numNonzeros;         /**< \brief Number of nonzeros. */
+} BinaryHeader;
+
+/**
+ * \brief Returns the number of bytes of a single value of type \p valueType.
+ */
+
+static
+size_t binaryValueSize(
+  BinaryValueType valueType /**< Type of the values. */
+)
+{
+  if (valueType == BINARY_VALUES_CHAR)
+    return 1;
+  else if (valueType == BINARY_VALUES_INT)
+    return 4;
+  else
+    return 8;
+}
+
+/**
+ * \brief Returns \c true if the arrays of a binary matrix file with values of type \p valueType can be used directly.
+ *
+ * This is the case if the platform is little-endian, uses 64-bit \c size_t and if the value type matches the C type.
+ */
+
+static
+bool binaryIsNative(
+  BinaryValueType valueType /**< Type of the values. */
+)
+{
+  const uint32_t one = 1;
+  if (sizeof(size_t) != 8 || *((const unsigned char*) &one) != 1)
+    return false;
+
+  if (valueType == BINARY_VALUES_INT)
+    return sizeof(int) == 4;
+  else if (valueType == BINARY_VALUES_DOUBLE)
+    return sizeof(double) == 8;
+  return true;
+}
+
+/**
+ * \brief Parses the header of a binary matrix file from \p bytes.
+ */
+
+static
+CMR_ERROR binaryParseHeader(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  const unsigned char* bytes, /**< The first \ref BINARY_HEADER_SIZE bytes of the file. */
+  BinaryHeader* header        /**< Header to be filled. */
+)
+{
+  if (memcmp(bytes, BINARY_MAGIC, sizeof(BINARY_MAGIC)))
+  {
+    CMRraiseErrorMessage(cmr, "Input is not a binary matrix file.");
+    return CMR_ERROR_INPUT;
+  }
+
+  header->version = (uint32_t) CMRloadLittleEndian(&bytes[8], 4);
+  uint32_t valueType = (uint32_t) CMRloadLittleEndian(&bytes[12], 4);
+  uint64_t numRows = CMRloadLittleEndian(&bytes[16], 8);
+  uint64_t numColumns = CMRloadLittleEndian(&bytes[24], 8);
+  uint64_t numNonzeros = CMRloadLittleEndian(&bytes[32], 8);
+
+  if (header->version != BINARY_VERSION)
+  {
+    CMRraiseErrorMessage(cmr, "Binary matrix file has unsupported version %u.", (unsigned int) header->version);
+    return CMR_ERROR_INPUT;
+  }
+  if (valueType < BINARY_VALUES_CHAR || valueType > BINARY_VALUES_DOUBLE)
+  {
+    CMRraiseErrorMessage(cmr, "Binary matrix file has unknown value type %u.", (unsigned int) valueType);
+    return CMR_ERROR_INPUT;
+  }
+  if (numRows >= SIZE_MAX / 8 || numColumns >= SIZE_MAX || numNonzeros >= SIZE_MAX / 16)
+  {
+    CMRraiseErrorMessage(cmr, "Binary matrix file has too large dimensions.");
+    return CMR_ERROR_INPUT;
+  }
+
+  header->valueType = (BinaryValueType) valueType;
+  header->numRows = (size_t) numRows;
+  header->numColumns = (size_t) numColumns;
+  header->numNonzeros = (size_t) numNonzeros;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the total size of a binary matrix file with the given \p header in bytes.
+ */
+
+static
+size_t binaryFileSize(
+  BinaryHeader* header  /**< Header. */
+)
+{
+  return BINARY_HEADER_SIZE + 8 * (header->numRows + 1) + 8 * header->numNonzeros
+    + binaryValueSize(header->valueType) * header->numNonzeros;
+}
+
+/**
+ * \brief Returns \c true if and only if a binary matrix file with the given \p header has exactly \p size bytes.
+ *
+ * In contrast to \ref binaryFileSize, the header fields are bounded by \p size before computing with them, such that
+ * crafted headers cannot cause an overflow.
+ */
+
+static
+bool binaryHasFileSize(
+  BinaryHeader* header, /**< Header. */
+  size_t size           /**< Size in bytes. */
+)
+{
+  if (size < BINARY_HEADER_SIZE)
+    return false;
+  size -= BINARY_HEADER_SIZE;
+  if (header->numRows + 1 > size / 8)
+    return false;
+  size -= 8 * (header->numRows + 1);
+
+  size_t entrySize = 8 + binaryValueSize(header->valueType);
+  return header->numNonzeros <= size / entrySize && entrySize * header->numNonzeros == size;
+}
+
+/**
+ * \brief Returns the value of entry \p e of an array of values of type \p valueType.
+ */
+
+static inline
+double binaryGetValue(
+  const void* values,         /**< Array of values in native representation. */
+  BinaryValueType valueType,  /**< Type of the values. */
+  size_t e                    /**< Index of entry. */
+)
+{
+  if (valueType == BINARY_VALUES_CHAR)
+    return ((const char*) values)[e];
+  else if (valueType == BINARY_VALUES_INT)
+    return ((const int*) values)[e];
+  else
+    return ((const double*) values)[e];
+}
+
+/**
+ * \brief Checks whether the arrays of \p matrix satisfy the requirements of a sparse matrix.
+ */
+
+static
+CMR_ERROR binaryCheckMatrix(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_MATRIX* matrix,       /**< Matrix with values of type \p valueType. */
+  BinaryValueType valueType /**< Type of the values. */
+)
+{
+  if (matrix->rowSlice[0] != 0 || matrix->rowSlice[matrix->numRows] != matrix->numNonzeros)
+  {
+    CMRraiseErrorMessage(cmr, "Binary matrix file has inconsistent row slices.");
+    return CMR_ERROR_INPUT;
+  }
+
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    if (first > beyond || beyond > matrix->numNonzeros)
+    {
+      CMRraiseErrorMessage(cmr, "Binary matrix file has inconsistent row slices.");
+      return CMR_ERROR_INPUT;
+    }
+    for (size_t e = first; e < beyond; ++e)
+    {
+      size_t column = matrix->entryColumns[e];
+      if (column >= matrix->numColumns || (e > first && column <= matrix->entryColumns[e - 1]))
+      {
+        CMRraiseErrorMessage(cmr, "Binary matrix file has invalid or unsorted column in row %zu.", row + 1);
+        return CMR_ERROR_INPUT;
+      }
+      if (binaryGetValue(matrix->entryValues, valueType, e) == 0.0)
+      {
+        CMRraiseErrorMessage(cmr, "Binary matrix file has a zero entry in row %zu.", row + 1);
+        return CMR_ERROR_INPUT;
+      }
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Decodes \p numElements little-endian elements from \p bytes.
+ *
+ * If \p values is not \c NULL, the elements are decoded as values of type \p valueType and stored with type
+ * \p targetType. Otherwise, they are decoded as indices and stored in \p indices.
+ */
+
+static
+CMR_ERROR binaryDecodeArray(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  const unsigned char* bytes, /**< Encoded elements. */
+  size_t numElements,         /**< Number of elements to decode. */
+  size_t* indices,            /**< Array for storing indices (may be \c NULL). */
+  BinaryValueType valueType,  /**< Type of the encoded values. */
+  void* values,               /**< Array for storing values (may be \c NULL). */
+  BinaryValueType targetType  /**< Type of the values in \p values. */
+)
+{
+  size_t elementSize = indices ? 8 : binaryValueSize(valueType);
+  for (size_t i = 0; i < numElements; ++i)
+  {
+    uint64_t raw = CMRloadLittleEndian(&bytes[i * elementSize], elementSize);
+    if (indices)
+    {
+      indices[i] = (size_t) raw;
+      continue;
+    }
+
+    double value;
+    if (valueType == BINARY_VALUES_CHAR)
+      value = (int8_t) raw;
+    else if (valueType == BINARY_VALUES_INT)
+      value = (int32_t) raw;
+    else
+      memcpy(&value, &raw, sizeof(double));
+
+    if (targetType == BINARY_VALUES_DOUBLE)
+      ((double*) values)[i] = value;
+    else
+    {
+      double lower = (targetType == BINARY_VALUES_CHAR) ? CHAR_MIN : INT_MIN;
+      double upper = (targetType == BINARY_VALUES_CHAR) ? CHAR_MAX : INT_MAX;
+      if (value != (double)(long long) value || value < lower || value > upper)
+      {
+        CMRraiseErrorMessage(cmr, "Binary matrix file has entry %g that cannot be represented.", value);
+        return CMR_ERROR_INPUT;
+      }
+      if (targetType == BINARY_VALUES_CHAR)
+        ((char*) values)[i] = (char) value;
+      else
+        ((int*) values)[i] = (int) value;
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads \p numElements elements from \p stream and decodes them as by \ref binaryDecodeArray.
+ */
+
+static
+CMR_ERROR binaryReadArray(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  FILE* stream,               /**< File stream to read from. */
+  size_t numElements,         /**< Number of elements to read. */
+  size_t* indices,            /**< Array for storing indices (may be \c NULL). */
+  BinaryValueType valueType,  /**< Type of the values in the stream. */
+  void* values,               /**< Array for storing values (may be \c NULL). */
+  BinaryValueType targetType  /**< Type of the values in \p values. */
+)
+{
+  size_t elementSize = indices ? 8 : binaryValueSize(valueType);
+  size_t targetSize = binaryValueSize(targetType);
+  unsigned char* buffer = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &buffer, BINARY_CHUNK_SIZE * elementSize) );
+
+  CMR_ERROR error = CMR_OKAY;
+  for (size_t start = 0; start < numElements && !error; start += BINARY_CHUNK_SIZE)
+  {
+    size_t count = numElements - start;
+    if (count > BINARY_CHUNK_SIZE)
+      count = BINARY_CHUNK_SIZE;
+    if (fread(buffer, elementSize, count, stream) != count)
+    {
+      CMRraiseErrorMessage(cmr, "Binary matrix file is truncated.");
+      error = CMR_ERROR_INPUT;
+      break;
+    }
+
+    error = binaryDecodeArray(cmr, buffer, count, indices ? &indices[start] : NULL, valueType,
+      values ? (char*) values + start * targetSize : NULL, targetType);
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &buffer) );
+
+  return error;
+}
+
+/**
+ * \brief Reads a matrix from a binary \p stream, converting the values to \p targetType.
+ */
+
+static
+CMR_ERROR binaryReadStream(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  FILE* stream,               /**< File stream to read from. */
+  BinaryValueType targetType, /**< Type of the values of the created matrix. */
+  CMR_MATRIX** presult        /**< Pointer for storing the matrix. */
+)
+{
+  unsigned char bytes[BINARY_HEADER_SIZE];
+  if (fread(bytes, 1, BINARY_HEADER_SIZE, stream) != BINARY_HEADER_SIZE)
+  {
+    CMRraiseErrorMessage(cmr, "Could not read header of binary matrix file.");
+    return CMR_ERROR_INPUT;
+  }
+  BinaryHeader header;
+  CMR_CALL( binaryParseHeader(cmr, bytes, &header) );
+  if (header.numRows > INT_MAX || header.numColumns > INT_MAX || header.numNonzeros > INT_MAX)
+  {
+    CMRraiseErrorMessage(cmr, "Binary matrix file has too large dimensions for reading it from a stream.");
+    return CMR_ERROR_INPUT;
+  }
+
+  if (targetType == BINARY_VALUES_CHAR)
+  {
+    CMR_CALL( CMRchrmatCreate(cmr, (CMR_CHRMAT**) presult, header.numRows, header.numColumns,
+      header.numNonzeros) );
+  }
+  else if (targetType == BINARY_VALUES_INT)
+  {
+    CMR_CALL( CMRintmatCreate(cmr, (CMR_INTMAT**) presult, header.numRows, header.numColumns,
+      header.numNonzeros) );
+  }
+  else
+  {
+    CMR_CALL( CMRdblmatCreate(cmr, (CMR_DBLMAT**) presult, header.numRows, header.numColumns,
+      header.numNonzeros) );
+  }
+  CMR_MATRIX* result = *presult;
+
+  CMR_ERROR error = binaryReadArray(cmr, stream, header.numRows + 1, result->rowSlice, header.valueType, NULL,
+    targetType);
+  if (!error)
+  {
+    error = binaryReadArray(cmr, stream, header.numNonzeros, result->entryColumns, header.valueType, NULL,
+      targetType);
+  }
+  if (!error)
+  {
+    error = binaryReadArray(cmr, stream, header.numNonzeros, NULL, header.valueType, result->entryValues,
+      targetType);
+  }
+  if (!error)
+    error = binaryCheckMatrix(cmr, result, targetType);
+
+  if (error)
+  {
+    if (targetType == BINARY_VALUES_CHAR)
+      CMR_CALL( CMRchrmatFree(cmr, (CMR_CHRMAT**) presult) );
+    else if (targetType == BINARY_VALUES_INT)
+      CMR_CALL( CMRintmatFree(cmr, (CMR_INTMAT**) presult) );
+    else
+      CMR_CALL( CMRdblmatFree(cmr, (CMR_DBLMAT**) presult) );
+  }
+
+  return error;
+}
+
+#if defined(CMR_WITH_MMAP)
+
+/**
+ * \brief Tries to map the binary matrix file \p fileName into memory.
+ *
+ * If the file has the native layout and values of type \p targetType, then \p *presult is a matrix whose arrays
+ * point into the mapping. Otherwise, \p *presult remains \c NULL.
+ */
+
+static
+CMR_ERROR binaryMapFile(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  const char* fileName,       /**< Name of the file. */
+  BinaryValueType targetType, /**< Type of the values of the created matrix. */
+  CMR_MATRIX** presult        /**< Pointer for storing the matrix. */
+)
+{
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0)
+  {
+    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
+    return CMR_ERROR_INPUT;
+  }
+
+  struct stat properties;
+  if (fstat(fd, &properties) != 0 || !S_ISREG(properties.st_mode) || properties.st_size < BINARY_HEADER_SIZE)
+  {
+    /* Not a regular file or too small; the caller uses the stream reader, which reports the details. */
+    close(fd);
+    return CMR_OKAY;
+  }
+
+  size_t size = (size_t) properties.st_size;
+  void* address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+    return CMR_OKAY;
+
+  BinaryHeader header;
+  CMR_ERROR error = binaryParseHeader(cmr, (const unsigned char*) address, &header);
+  if (!error && !binaryHasFileSize(&header, size))
+  {
+    CMRraiseErrorMessage(cmr, "Binary matrix file <%s> has %zu bytes, which does not match its header.", fileName,
+      size);
+    error = CMR_ERROR_INPUT;
+  }
+  if (error || header.valueType != targetType || !binaryIsNative(header.valueType))
+  {
+    munmap(address, size);
+    return error;
+  }
+
+  CMR_MATRIX* result = NULL;
+  error = CMRallocBlock(cmr, &result);
+  if (error)
+  {
+    munmap(address, size);
+    return error;
+  }
+  result->numRows = header.numRows;
+  result->numColumns = header.numColumns;
+  result->numNonzeros = header.numNonzeros;
+  result->rowSlice = (size_t*) ((char*) address + BINARY_HEADER_SIZE);
+  result->entryColumns = result->rowSlice + (header.numRows + 1);
+  result->entryValues = result->entryColumns + header.numNonzeros;
+
+  error = binaryCheckMatrix(cmr, result, targetType);
+  if (error)
+  {
+    munmap(address, size);
+    CMR_CALL( CMRfreeBlock(cmr, &result) );
+    return error;
+  }
+
+  /* Register the mapping such that freeing the matrix unmaps the file. */
+  CMR_MAPPING* mapping = NULL;
+  error = CMRallocBlock(cmr, &mapping);
+  if (error)
+  {
+    munmap(address, size);
+    CMR_CALL( CMRfreeBlock(cmr, &result) );
+    return error;
+  }
+  mapping->matrix = result;
+  mapping->address = address;
+  mapping->size = size;
+
+  CMRmutexLock(&cmr->mutex);
+  mapping->next = cmr->mappings;
+  cmr->mappings = mapping;
+  CMRatomicStoreFlag(&cmr->hasMappings, true);
+  CMRmutexUnlock(&cmr->mutex);
+
+  *presult = result;
+
+  return CMR_OKAY;
+}
+
+#endif /* CMR_WITH_MMAP */
+
+CMR_ERROR CMRmatrixReleaseMapping(CMR* cmr, void* matrix, bool* pisMapped)
+{
+  assert(cmr);
+  assert(pisMapped);
+
+  *pisMapped = false;
+  if (!CMRatomicLoadFlag(&cmr->hasMappings))
+    return CMR_OKAY;
+
+  CMRmutexLock(&cmr->mutex);
+  CMR_MAPPING** pmapping = &cmr->mappings;
+  while (*pmapping && (*pmapping)->matrix != matrix)
+    pmapping = &(*pmapping)->next;
+  CMR_MAPPING* mapping = *pmapping;
+  if (mapping)
+    *pmapping = mapping->next;
+  CMRmutexUnlock(&cmr->mutex);
+
+  if (!mapping)
+    return CMR_OKAY;
+
+#if defined(CMR_WITH_MMAP)
+  if (mapping->address)
+    munmap(mapping->address, mapping->size);
+#endif /* CMR_WITH_MMAP */
+  CMR_CALL( CMRfreeBlock(cmr, &mapping) );
+  *pisMapped = true;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmatrixRegisterBorrowed(CMR* cmr, void* matrix)
+{
+  assert(cmr);
+  assert(matrix);
+
+  CMR_MAPPING* mapping = NULL;
+  CMR_CALL( CMRallocBlock(cmr, &mapping) );
+  mapping->matrix = matrix;
+  mapping->address = NULL;
+  mapping->size = 0;
+
+  CMRmutexLock(&cmr->mutex);
+  mapping->next = cmr->mappings;
+  cmr->mappings = mapping;
+  CMRatomicStoreFlag(&cmr->hasMappings, true);
+  CMRmutexUnlock(&cmr->mutex);
+
+  return CMR_OKAY;
+}
+
+void CMRmatrixReleaseAllMappings(CMR* cmr)
+{
+  assert(cmr);
+
+  while (cmr->mappings)
+  {
+    CMR_MAPPING* mapping = cmr->mappings;
+    cmr->mappings = mapping->next;
+#if defined(CMR_WITH_MMAP)
+    if (mapping->address)
+      munmap(mapping->address, mapping->size);
+#endif /* CMR_WITH_MMAP */
+    CMRfreeBlockArray(cmr, &mapping->matrix);
+    CMRfreeBlock(cmr, &mapping);
+  }
+}
+
+/**
+ * \brief Reads a matrix from the binary file \p fileName, mapping it into memory if possible.
+ */
+
+static
+CMR_ERROR binaryReadFile(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  const char* fileName,       /**< Name of the file. */
+  const char* stdinName,      /**< If not \c NULL, indicates which file name represents stdin. */
+  BinaryValueType targetType, /**< Type of the values of the created matrix. */
+  CMR_MATRIX** presult        /**< Pointer for storing the matrix. */
+)
+{
+  assert(cmr);
+  assert(fileName);
+  assert(presult);
+  assert(!*presult);
+
+  bool isStdin = stdinName && !strcmp(fileName, stdinName);
+
+#if defined(CMR_WITH_MMAP)
+  if (!isStdin)
+  {
+    CMR_CALL( binaryMapFile(cmr, fileName, targetType, presult) );
+    if (*presult)
+      return CMR_OKAY;
+  }
+#endif /* CMR_WITH_MMAP */
+
+  FILE* inputFile = isStdin ? stdin : fopen(fileName, "rb");
+  if (!inputFile)
+  {
+    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
+    return CMR_ERROR_INPUT;
+  }
+
+  CMR_ERROR error = binaryReadStream(cmr, inputFile, targetType, presult);
+  if (!error && fgetc(inputFile) != EOF)
+  {
+    CMRraiseErrorMessage(cmr, "Found unexpected data after having read a *binary* %zux%zu matrix with %zu nonzeros.",
+      (*presult)->numRows, (*presult)->numColumns, (*presult)->numNonzeros);
+    if (targetType == BINARY_VALUES_CHAR)
+      CMRchrmatFree(cmr, (CMR_CHRMAT**) presult);
+    else if (targetType == BINARY_VALUES_INT)
+      CMRintmatFree(cmr, (CMR_INTMAT**) presult);
+    else
+      CMRdblmatFree(cmr, (CMR_DBLMAT**) presult);
+    error = CMR_ERROR_INPUT;
+  }
+
+  if (inputFile != stdin)
+    fclose(inputFile);
+
+  return error;
+}
+
+CMR_ERROR CMRdblmatCreateFromBinaryStream(CMR* cmr, FILE* stream, CMR_DBLMAT** presult)
+{
+  assert(cmr);
+  assert(stream);
+  assert(presult);
+  assert(!*presult);
+
+  return binaryReadStream(cmr, stream, BINARY_VALUES_DOUBLE, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRintmatCreateFromBinaryStream(CMR* cmr, FILE* stream, CMR_INTMAT** presult)
+{
+  assert(cmr);
+  assert(stream);
+  assert(presult);
+  assert(!*presult);
+
+  return binaryReadStream(cmr, stream, BINARY_VALUES_INT, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRchrmatCreateFromBinaryStream(CMR* cmr, FILE* stream, CMR_CHRMAT** presult)
+{
+  assert(cmr);
+  assert(stream);
+  assert(presult);
+  assert(!*presult);
+
+  return binaryReadStream(cmr, stream, BINARY_VALUES_CHAR, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRdblmatCreateFromBinaryFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_DBLMAT** presult)
+{
+  return binaryReadFile(cmr, fileName, stdinName, BINARY_VALUES_DOUBLE, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRintmatCreateFromBinaryFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_INTMAT** presult)
+{
+  return binaryReadFile(cmr, fileName, stdinName, BINARY_VALUES_INT, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRchrmatCreateFromBinaryFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_CHRMAT** presult)
+{
+  return binaryReadFile(cmr, fileName, stdinName, BINARY_VALUES_CHAR, (CMR_MATRIX**) presult);
+}
+
+/**
+ * \brief Writes \p numElements elements to \p stream, each encoded with \p elementSize bytes.
+ */
+
+static
+CMR_ERROR binaryWriteArray(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  FILE* stream,               /**< File stream to write to. */
+  size_t numElements,         /**< Number of elements to write. */
+  size_t* indices,            /**< Array of indices to write (may be \c NULL). */
+  void* values,               /**< Array of values to write if \p indices is \c NULL. */
+  BinaryValueType valueType   /**< Type of the values. */
+)
+{
+  if (binaryIsNative(valueType))
+  {
+    size_t elementSize = indices ? 8 : binaryValueSize(valueType);
+    if (fwrite(indices ? (void*) indices : values, elementSize, numElements, stream) != numElements)
+    {
+      CMRraiseErrorMessage(cmr, "Could not write binary matrix file.");
+      return CMR_ERROR_OUTPUT;
+    }
+    return CMR_OKAY;
+  }
+
+  size_t elementSize = indices ? 8 : binaryValueSize(valueType);
+  unsigned char* buffer = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &buffer, BINARY_CHUNK_SIZE * elementSize) );
+
+  CMR_ERROR error = CMR_OKAY;
+  for (size_t start = 0; start < numElements && !error; start += BINARY_CHUNK_SIZE)
+  {
+    size_t count = numElements - start;
+    if (count > BINARY_CHUNK_SIZE)
+      count = BINARY_CHUNK_SIZE;
+    for (size_t i = 0; i < count; ++i)
+    {
+      uint64_t raw;
+      if (indices)
+        raw = indices[start + i];
+      else if (valueType == BINARY_VALUES_CHAR)
+        raw = (uint64_t) (int64_t) ((char*) values)[start + i];
+      else if (valueType == BINARY_VALUES_INT)
+        raw = (uint64_t) (int64_t) ((int*) values)[start + i];
+      else
+        memcpy(&raw, &((double*) values)[start + i], sizeof(double));
+      CMRstoreLittleEndian(&buffer[i * elementSize], elementSize, raw);
+    }
+    if (fwrite(buffer, elementSize, count, stream) != count)
+    {
+      CMRraiseErrorMessage(cmr, "Could not write binary matrix file.");
+      error = CMR_ERROR_OUTPUT;
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &buffer) );
+
+  return error;
+}
+
+/**
+ * \brief Writes \p matrix with values of type \p valueType to \p stream in binary format.
+ */
+
+static
+CMR_ERROR binaryWrite(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_MATRIX* matrix,         /**< Matrix to write. */
+  BinaryValueType valueType,  /**< Type of the values of \p matrix. */
+  FILE* stream                /**< File stream to write to. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(stream);
+
+  unsigned char bytes[BINARY_HEADER_SIZE];
+  memset(bytes, 0, BINARY_HEADER_SIZE);
+  memcpy(bytes, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  CMRstoreLittleEndian(&bytes[8], 4, BINARY_VERSION);
+  CMRstoreLittleEndian(&bytes[12], 4, valueType);
+  CMRstoreLittleEndian(&bytes[16], 8, matrix->numRows);
+  CMRstoreLittleEndian(&bytes[24], 8, matrix->numColumns);
+  CMRstoreLittleEndian(&bytes[32], 8, matrix->rowSlice[matrix->numRows]);
+  if (fwrite(bytes, 1, BINARY_HEADER_SIZE, stream) != BINARY_HEADER_SIZE)
+  {
+    CMRraiseErrorMessage(cmr, "Could not write binary matrix file.");
+    return CMR_ERROR_OUTPUT;
+  }
+
+  /* The matrix may have more memory for nonzeros than it uses. */
+  size_t numNonzeros = matrix->rowSlice[matrix->numRows];
+  CMR_CALL( binaryWriteArray(cmr, stream, matrix->numRows + 1, matrix->rowSlice, NULL, valueType) );
+  CMR_CALL( binaryWriteArray(cmr, stream, numNonzeros, matrix->entryColumns, NULL, valueType) );
+  CMR_CALL( binaryWriteArray(cmr, stream, numNonzeros, NULL, matrix->entryValues, valueType) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRdblmatPrintBinary(CMR* cmr, CMR_DBLMAT* matrix, FILE* stream)
+{
+  return binaryWrite(cmr, (CMR_MATRIX*) matrix, BINARY_VALUES_DOUBLE, stream);
+}
+
+CMR_ERROR CMRintmatPrintBinary(CMR* cmr, CMR_INTMAT* matrix, FILE* stream)
+{
+  return binaryWrite(cmr, (CMR_MATRIX*) matrix, BINARY_VALUES_INT, stream);
+}
+
+CMR_ERROR CMRchrmatPrintBinary(CMR* cmr, CMR_CHRMAT* matrix, FILE* stream)
+{
+  return binaryWrite(cmr, (CMR_MATRIX*) matrix, BINARY_VALUES_CHAR, stream);
+}
+
+/**
+ * \brief Magic bytes at the beginning of each matrix container file.
+ */
+
+static const char CONTAINER_MAGIC[8] = { 'C', 'M', 'R', '-', 'P', 'A', 'C', 'K' };
+
+/**
+ * \brief Magic bytes at the beginning of the trailer of each matrix container file.
+ */
+
+static const char CONTAINER_TRAILER_MAGIC[8] = { 'C', 'M', 'R', '-', 'I', 'N', 'D', 'X' };
+
+#define CONTAINER_VERSION 1       /**< Version of the matrix container format written by this implementation. */
+#define CONTAINER_HEADER_SIZE 64  /**< Size of the header of a matrix container file in bytes. */
+#define CONTAINER_TRAILER_SIZE 24 /**< Size of the trailer of a matrix container file in bytes. */
+#define CONTAINER_ENTRY_WORDS 6   /**< Number of 64-bit integers of an index entry. */
+
+/**
+ * \brief Positions of the 64-bit integers of an index entry of a matrix container.
+ */
+
+typedef enum
+{
+  CONTAINER_ENTRY_OFFSET = 0,           /**< Offset of the record. */
+  CONTAINER_ENTRY_SIZE = 1,             /**< Size of the record without padding. */
+  CONTAINER_ENTRY_NAME_OFFSET = 2,      /**< Offset of the name. */
+  CONTAINER_ENTRY_NAME_LENGTH = 3,      /**< Length of the name. */
+  CONTAINER_ENTRY_METADATA_OFFSET = 4,  /**< Offset of the metadata. */
+  CONTAINER_ENTRY_METADATA_LENGTH = 5   /**< Length of the metadata. */
+} ContainerEntryWord;
+
+struct CMR_MATRIX_CONTAINER_WRITER
+{
+  FILE* stream;         /**< \brief File stream to write to. */
+  size_t position;      /**< \brief Number of bytes written so far. */
+  size_t numRecords;    /**< \brief Number of records written so far. */
+  size_t memRecords;    /**< \brief Number of records for which \ref entries has memory. */
+  size_t* entries;      /**< \brief Array with the index entries, where strings are relative to \ref strings. */
+  char* strings;        /**< \brief Array with all names and metadata, each terminated by a null character. */
+  size_t numStrings;    /**< \brief Number of bytes of \ref strings used so far. */
+  size_t memStrings;    /**< \brief Number of bytes of \ref strings. */
+};
+
+struct CMR_MATRIX_CONTAINER
+{
+  unsigned char* data;  /**< \brief Contents of the file. */
+  size_t size;          /**< \brief Size of the file in bytes. */
+  bool isMapped;        /**< \brief Whether \ref data is mapped into memory instead of being allocated. */
+  size_t numRecords;    /**< \brief Number of records. */
+  size_t* entries;      /**< \brief Array with the decoded index entries. */
+};
+
+/**
+ * \brief Writes \p numBytes zero bytes to \p stream.
+ */
+
+static
+CMR_ERROR containerWritePadding(
+  CMR* cmr,         /**< \ref CMR environment. */
+  FILE* stream,     /**< File stream to write to. */
+  size_t numBytes   /**< Number of zero bytes. */
+)
+{
+  static const unsigned char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  assert(numBytes <= sizeof(zeros));
+
+  if (fwrite(zeros, 1, numBytes, stream) != numBytes)
+  {
+    CMRraiseErrorMessage(cmr, "Could not write matrix container file.");
+    return CMR_ERROR_OUTPUT;
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Appends \p string and a null character to the strings of \p writer and returns its offset there.
+ */
+
+static
+CMR_ERROR containerAddString(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_MATRIX_CONTAINER_WRITER* writer,  /**< Container writer. */
+  const char* string,                   /**< String to add (may be \c NULL). */
+  size_t* poffset,                      /**< Pointer for storing the offset of the string. */
+  size_t* plength                       /**< Pointer for storing the length of the string. */
+)
+{
+  size_t length = string ? strlen(string) : 0;
+  if (writer->numStrings + length + 1 > writer->memStrings)
+  {
+    writer->memStrings = 2 * (writer->numStrings + length + 1);
+    CMR_CALL( CMRreallocBlockArray(cmr, &writer->strings, writer->memStrings) );
+  }
+  if (length)
+    memcpy(&writer->strings[writer->numStrings], string, length);
+  writer->strings[writer->numStrings + length] = '\0';
+  *poffset = writer->numStrings;
+  *plength = length;
+  writer->numStrings += length + 1;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmatrixContainerWriterCreate(CMR* cmr, FILE* stream, CMR_MATRIX_CONTAINER_WRITER** pwriter)
+{
+  assert(cmr);
+  assert(stream);
+  assert(pwriter);
+
+  unsigned char bytes[CONTAINER_HEADER_SIZE];
+  memset(bytes, 0, CONTAINER_HEADER_SIZE);
+  memcpy(bytes, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+  CMRstoreLittleEndian(&bytes[8], 4, CONTAINER_VERSION);
+  if (fwrite(bytes, 1, CONTAINER_HEADER_SIZE, stream) != CONTAINER_HEADER_SIZE)
+  {
+    CMRraiseErrorMessage(cmr, "Could not write matrix container file.");
+    return CMR_ERROR_OUTPUT;
+  }
+
+  CMR_CALL( CMRallocBlock(cmr, pwriter) );
+  CMR_MATRIX_CONTAINER_WRITER* writer = *pwriter;
+  writer->stream = stream;
+  writer->position = CONTAINER_HEADER_SIZE;
+  writer->numRecords = 0;
+  writer->memRecords = 16;
+  writer->entries = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &writer->entries, CONTAINER_ENTRY_WORDS * writer->memRecords) );
+  writer->numStrings = 0;
+  writer->memStrings = 256;
+  writer->strings = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &writer->strings, writer->memStrings) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Writes \p matrix with values of type \p valueType as the next record of a matrix container.
+ */
+
+static
+CMR_ERROR containerAddMatrix(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  CMR_MATRIX* matrix,                   /**< Matrix to write. */
+  BinaryValueType valueType,            /**< Type of the values of \p matrix. */
+  CMR_MATRIX_CONTAINER_WRITER* writer,  /**< Container writer. */
+  const char* name,                     /**< Name of the record (may be \c NULL). */
+  const char* metadata                  /**< Metadata of the record (may be \c NULL). */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(writer);
+
+  if (writer->numRecords == writer->memRecords)
+  {
+    writer->memRecords *= 2;
+    CMR_CALL( CMRreallocBlockArray(cmr, &writer->entries, CONTAINER_ENTRY_WORDS * writer->memRecords) );
+  }
+
+  /* Each record is a binary matrix file that is padded to a multiple of 8 bytes. */
+  CMR_CALL( binaryWrite(cmr, matrix, valueType, writer->stream) );
+  BinaryHeader header;
+  header.valueType = valueType;
+  header.numRows = matrix->numRows;
+  header.numNonzeros = matrix->rowSlice[matrix->numRows];
+  size_t size = binaryFileSize(&header);
+  CMR_CALL( containerWritePadding(cmr, writer->stream, (8 - size % 8) % 8) );
+
+  size_t* entry = &writer->entries[CONTAINER_ENTRY_WORDS * writer->numRecords];
+  entry[CONTAINER_ENTRY_OFFSET] = writer->position;
+  entry[CONTAINER_ENTRY_SIZE] = size;
+  CMR_CALL( containerAddString(cmr, writer, name, &entry[CONTAINER_ENTRY_NAME_OFFSET],
+    &entry[CONTAINER_ENTRY_NAME_LENGTH]) );
+  CMR_CALL( containerAddString(cmr, writer, metadata, &entry[CONTAINER_ENTRY_METADATA_OFFSET],
+    &entry[CONTAINER_ENTRY_METADATA_LENGTH]) );
+  writer->position += (size + 7) / 8 * 8;
+  writer->numRecords++;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRdblmatAddToContainer(CMR* cmr, CMR_DBLMAT* matrix, CMR_MATRIX_CONTAINER_WRITER* writer,
+  const char* name, const char* metadata)
+{
+  return containerAddMatrix(cmr, (CMR_MATRIX*) matrix, BINARY_VALUES_DOUBLE, writer, name, metadata);
+}
+
+CMR_ERROR CMRintmatAddToContainer(CMR* cmr, CMR_INTMAT* matrix, CMR_MATRIX_CONTAINER_WRITER* writer,
+  const char* name, const char* metadata)
+{
+  return containerAddMatrix(cmr, (CMR_MATRIX*) matrix, BINARY_VALUES_INT, writer, name, metadata);
+}
+
+CMR_ERROR CMRchrmatAddToContainer(CMR* cmr, CMR_CHRMAT* matrix, CMR_MATRIX_CONTAINER_WRITER* writer,
+  const char* name, const char* metadata)
+{
+  return containerAddMatrix(cmr, (CMR_MATRIX*) matrix, BINARY_VALUES_CHAR, writer, name, metadata);
+}
+
+CMR_ERROR CMRmatrixContainerWriterFinish(CMR* cmr, CMR_MATRIX_CONTAINER_WRITER** pwriter)
+{
+  assert(cmr);
+  assert(pwriter);
+
+  CMR_MATRIX_CONTAINER_WRITER* writer = *pwriter;
+  if (!writer)
+    return CMR_OKAY;
+
+  CMR_ERROR error = CMR_OKAY;
+  size_t stringsPosition = writer->position;
+  if (fwrite(writer->strings, 1, writer->numStrings, writer->stream) != writer->numStrings)
+  {
+    CMRraiseErrorMessage(cmr, "Could not write matrix container file.");
+    error = CMR_ERROR_OUTPUT;
+  }
+  if (!error)
+    error = containerWritePadding(cmr, writer->stream, (8 - writer->numStrings % 8) % 8);
+  size_t indexPosition = stringsPosition + (writer->numStrings + 7) / 8 * 8;
+
+  unsigned char bytes[8 * CONTAINER_ENTRY_WORDS];
+  for (size_t record = 0; record < writer->numRecords && !error; ++record)
+  {
+    size_t* entry = &writer->entries[CONTAINER_ENTRY_WORDS * record];
+    entry[CONTAINER_ENTRY_NAME_OFFSET] += stringsPosition;
+    entry[CONTAINER_ENTRY_METADATA_OFFSET] += stringsPosition;
+    for (size_t w = 0; w < CONTAINER_ENTRY_WORDS; ++w)
+      CMRstoreLittleEndian(&bytes[8 * w], 8, entry[w]);
+    if (fwrite(bytes, 1, sizeof(bytes), writer->stream) != sizeof(bytes))
+    {
+      CMRraiseErrorMessage(cmr, "Could not write matrix container file.");
+      error = CMR_ERROR_OUTPUT;
+    }
+  }
+
+  if (!error)
+  {
+    memcpy(bytes, CONTAINER_TRAILER_MAGIC, sizeof(CONTAINER_TRAILER_MAGIC));
+    CMRstoreLittleEndian(&bytes[8], 8, writer->numRecords);
+    CMRstoreLittleEndian(&bytes[16], 8, indexPosition);
+    if (fwrite(bytes, 1, CONTAINER_TRAILER_SIZE, writer->stream) != CONTAINER_TRAILER_SIZE)
+    {
+      CMRraiseErrorMessage(cmr, "Could not write matrix container file.");
+      error = CMR_ERROR_OUTPUT;
+    }
+  }
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &writer->strings) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &writer->entries) );
+  CMR_CALL( CMRfreeBlock(cmr, pwriter) );
+
+  return error;
+}
+
+/**
+ * \brief Reads the remainder of \p stream into a newly allocated array.
+ */
+
+static
+CMR_ERROR containerReadStream(
+  CMR* cmr,               /**< \ref CMR environment. */
+  FILE* stream,           /**< File stream to read from. */
+  unsigned char** pdata,  /**< Pointer for storing the contents. */
+  size_t* psize           /**< Pointer for storing the number of bytes read. */
+)
+{
+  size_t memory = 1 << 16;
+  size_t size = 0;
+  CMR_CALL( CMRallocBlockArray(cmr, pdata, memory) );
+  while (true)
+  {
+    size += fread(&(*pdata)[size], 1, memory - size, stream);
+    if (size < memory)
+      break;
+    memory *= 2;
+    CMR_CALL( CMRreallocBlockArray(cmr, pdata, memory) );
+  }
+  *psize = size;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Checks the header, trailer, index and record headers of \p container and decodes its index.
+ */
+
+static
+CMR_ERROR containerParse(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  CMR_MATRIX_CONTAINER* container /**< Container whose \ref data and \ref size are set. */
+)
+{
+  const unsigned char* data = container->data;
+  size_t size = container->size;
+  if (size < CONTAINER_HEADER_SIZE + CONTAINER_TRAILER_SIZE || memcmp(data, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC))
+    || memcmp(&data[size - CONTAINER_TRAILER_SIZE], CONTAINER_TRAILER_MAGIC, sizeof(CONTAINER_TRAILER_MAGIC)))
+  {
+    CMRraiseErrorMessage(cmr, "Input is not a complete matrix container file.");
+    return CMR_ERROR_INPUT;
+  }
+  uint32_t version = (uint32_t) CMRloadLittleEndian(&data[8], 4);
+  if (version != CONTAINER_VERSION)
+  {
+    CMRraiseErrorMessage(cmr, "Matrix container file has unsupported version %u.", (unsigned int) version);
+    return CMR_ERROR_INPUT;
+  }
+
+  uint64_t numRecords = CMRloadLittleEndian(&data[size - CONTAINER_TRAILER_SIZE + 8], 8);
+  uint64_t indexPosition = CMRloadLittleEndian(&data[size - CONTAINER_TRAILER_SIZE + 16], 8);
+  if (indexPosition > size || numRecords > (size - indexPosition) / (8 * CONTAINER_ENTRY_WORDS)
+    || indexPosition + 8 * CONTAINER_ENTRY_WORDS * numRecords + CONTAINER_TRAILER_SIZE != size)
+  {
+    CMRraiseErrorMessage(cmr, "Matrix container file has an inconsistent index.");
+    return CMR_ERROR_INPUT;
+  }
+
+  container->numRecords = (size_t) numRecords;
+  CMR_CALL( CMRallocBlockArray(cmr, &container->entries, CONTAINER_ENTRY_WORDS * container->numRecords + 1) );
+  for (size_t record = 0; record < container->numRecords; ++record)
+  {
+    size_t* entry = &container->entries[CONTAINER_ENTRY_WORDS * record];
+    for (size_t w = 0; w < CONTAINER_ENTRY_WORDS; ++w)
+      entry[w] = (size_t) CMRloadLittleEndian(&data[indexPosition + 8 * (CONTAINER_ENTRY_WORDS * record + w)], 8);
+
+    size_t offset = entry[CONTAINER_ENTRY_OFFSET];
+    BinaryHeader header;
+    if (offset < CONTAINER_HEADER_SIZE || offset > indexPosition || entry[CONTAINER_ENTRY_SIZE] < BINARY_HEADER_SIZE
+      || entry[CONTAINER_ENTRY_SIZE] > indexPosition - offset
+      || binaryParseHeader(cmr, &data[offset], &header) != CMR_OKAY
+      || !binaryHasFileSize(&header, entry[CONTAINER_ENTRY_SIZE]))
+    {
+      CMRraiseErrorMessage(cmr, "Matrix container file has an invalid record #%zu.", record + 1);
+      return CMR_ERROR_INPUT;
+    }
+
+    for (int s = 0; s < 2; ++s)
+    {
+      size_t stringOffset = entry[s ? CONTAINER_ENTRY_METADATA_OFFSET : CONTAINER_ENTRY_NAME_OFFSET];
+      size_t stringLength = entry[s ? CONTAINER_ENTRY_METADATA_LENGTH : CONTAINER_ENTRY_NAME_LENGTH];
+      if (stringOffset >= indexPosition || stringLength >= indexPosition - stringOffset
+        || data[stringOffset + stringLength] != '\0')
+      {
+        CMRraiseErrorMessage(cmr, "Matrix container file has an invalid %s of record #%zu.", s ? "metadata" : "name",
+          record + 1);
+        return CMR_ERROR_INPUT;
+      }
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmatrixContainerOpen(CMR* cmr, const char* fileName, const char* stdinName,
+  CMR_MATRIX_CONTAINER** pcontainer)
+{
+  assert(cmr);
+  assert(fileName);
+  assert(pcontainer);
+  assert(!*pcontainer);
+
+  CMR_CALL( CMRallocBlock(cmr, pcontainer) );
+  CMR_MATRIX_CONTAINER* container = *pcontainer;
+  container->data = NULL;
+  container->size = 0;
+  container->isMapped = false;
+  container->numRecords = 0;
+  container->entries = NULL;
+
+  bool isStdin = stdinName && !strcmp(fileName, stdinName);
+  CMR_ERROR error = CMR_OKAY;
+
+#if defined(CMR_WITH_MMAP)
+  if (!isStdin)
+  {
+    int fd = open(fileName, O_RDONLY);
+    struct stat properties;
+    if (fd >= 0 && fstat(fd, &properties) == 0 && S_ISREG(properties.st_mode) && properties.st_size > 0)
+    {
+      void* address = mmap(NULL, (size_t) properties.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address != MAP_FAILED)
+      {
+        container->data = (unsigned char*) address;
+        container->size = (size_t) properties.st_size;
+        container->isMapped = true;
+      }
+    }
+    if (fd >= 0)
+      close(fd);
+  }
+#endif /* CMR_WITH_MMAP */
+
+  if (!container->isMapped)
+  {
+    FILE* inputFile = isStdin ? stdin : fopen(fileName, "rb");
+    if (inputFile)
+    {
+      error = containerReadStream(cmr, inputFile, &container->data, &container->size);
+      if (inputFile != stdin)
+        fclose(inputFile);
+    }
+    else
+    {
+      CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
+      error = CMR_ERROR_INPUT;
+    }
+  }
+
+  if (!error)
+    error = containerParse(cmr, container);
+  if (error)
+    CMR_CALL( CMRmatrixContainerFree(cmr, pcontainer) );
+
+  return error;
+}
+
+CMR_ERROR CMRmatrixContainerFree(CMR* cmr, CMR_MATRIX_CONTAINER** pcontainer)
+{
+  assert(cmr);
+  assert(pcontainer);
+
+  CMR_MATRIX_CONTAINER* container = *pcontainer;
+  if (!container)
+    return CMR_OKAY;
+
+#if defined(CMR_WITH_MMAP)
+  if (container->isMapped)
+    munmap(container->data, container->size);
+#endif /* CMR_WITH_MMAP */
+  if (!container->isMapped)
+    CMR_CALL( CMRfreeBlockArray(cmr, &container->data) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &container->entries) );
+  CMR_CALL( CMRfreeBlock(cmr, pcontainer) );
+
+  return CMR_OKAY;
+}
+
+size_t CMRmatrixContainerNumRecords(CMR_MATRIX_CONTAINER* container)
+{
+  assert(container);
+
+  return container->numRecords;
+}
+
+const char* CMRmatrixContainerRecordName(CMR_MATRIX_CONTAINER* container, size_t record)
+{
+  assert(container);
+  assert(record < container->numRecords);
+
+  return (const char*) &container->data[container->entries[CONTAINER_ENTRY_WORDS * record
+    + CONTAINER_ENTRY_NAME_OFFSET]];
+}
+
+const char* CMRmatrixContainerRecordMetadata(CMR_MATRIX_CONTAINER* container, size_t record)
+{
+  assert(container);
+  assert(record < container->numRecords);
+
+  return (const char*) &container->data[container->entries[CONTAINER_ENTRY_WORDS * record
+    + CONTAINER_ENTRY_METADATA_OFFSET]];
+}
+
+/**
+ * \brief Creates a matrix with values of type \p targetType from record \p record of \p container.
+ */
+
+static
+CMR_ERROR containerReadMatrix(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  CMR_MATRIX_CONTAINER* container,/**< Container. */
+  size_t record,                  /**< Index of the record. */
+  BinaryValueType targetType,     /**< Type of the values of the created matrix. */
+  CMR_MATRIX** presult            /**< Pointer for storing the matrix. */
+)
+{
+  assert(cmr);
+  assert(container);
+  assert(presult);
+  assert(!*presult);
+
+  if (record >= container->numRecords)
+  {
+    CMRraiseErrorMessage(cmr, "Matrix container has no record #%zu.", record + 1);
+    return CMR_ERROR_INPUT;
+  }
+
+  /* The headers were checked when opening the container. */
+  const unsigned char* bytes = &container->data[container->entries[CONTAINER_ENTRY_WORDS * record
+    + CONTAINER_ENTRY_OFFSET]];
+  BinaryHeader header;
+  CMR_CALL( binaryParseHeader(cmr, bytes, &header) );
+
+  if (targetType == BINARY_VALUES_CHAR)
+  {
+    CMR_CALL( CMRchrmatCreate(cmr, (CMR_CHRMAT**) presult, header.numRows, header.numColumns,
+      header.numNonzeros) );
+  }
+  else if (targetType == BINARY_VALUES_INT)
+  {
+    CMR_CALL( CMRintmatCreate(cmr, (CMR_INTMAT**) presult, header.numRows, header.numColumns,
+      header.numNonzeros) );
+  }
+  else
+  {
+    CMR_CALL( CMRdblmatCreate(cmr, (CMR_DBLMAT**) presult, header.numRows, header.numColumns,
+      header.numNonzeros) );
+  }
+  CMR_MATRIX* result = *presult;
+
+  const unsigned char* rowSliceBytes = &bytes[BINARY_HEADER_SIZE];
+  const unsigned char* columnBytes = rowSliceBytes + 8 * (header.numRows + 1);
+  const unsigned char* valueBytes = columnBytes + 8 * header.numNonzeros;
+  CMR_ERROR error = CMR_OKAY;
+  if (binaryIsNative(header.valueType))
+  {
+    memcpy(result->rowSlice, rowSliceBytes, 8 * (header.numRows + 1));
+    memcpy(result->entryColumns, columnBytes, 8 * header.numNonzeros);
+  }
+  else
+  {
+    error = binaryDecodeArray(cmr, rowSliceBytes, header.numRows + 1, result->rowSlice, header.valueType, NULL,
+      targetType);
+    if (!error)
+    {
+      error = binaryDecodeArray(cmr, columnBytes, header.numNonzeros, result->entryColumns, header.valueType, NULL,
+        targetType);
+    }
+  }
+  if (!error && header.valueType == targetType && binaryIsNative(header.valueType))
+    memcpy(result->entryValues, valueBytes, binaryValueSize(header.valueType) * header.numNonzeros);
+  else if (!error)
+  {
+    error = binaryDecodeArray(cmr, valueBytes, header.numNonzeros, NULL, header.valueType, result->entryValues,
+      targetType);
+  }
+  if (!error)
+    error = binaryCheckMatrix(cmr, result, targetType);
+
+  if (error)
+  {
+    if (targetType == BINARY_VALUES_CHAR)
+      CMR_CALL( CMRchrmatFree(cmr, (CMR_CHRMAT**) presult) );
+    else if (targetType == BINARY_VALUES_INT)
+      CMR_CALL( CMRintmatFree(cmr, (CMR_INTMAT**) presult) );
+    else
+      CMR_CALL( CMRdblmatFree(cmr, (CMR_DBLMAT**) presult) );
+  }
+
+  return error;
+}
+
+CMR_ERROR CMRdblmatCreateFromContainer(CMR* cmr, CMR_MATRIX_CONTAINER* container, size_t record,
+  CMR_DBLMAT** presult)
+{
+  return containerReadMatrix(cmr, container, record, BINARY_VALUES_DOUBLE, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRintmatCreateFromContainer(CMR* cmr, CMR_MATRIX_CONTAINER* container, size_t record,
+  CMR_INTMAT** presult)
+{
+  return containerReadMatrix(cmr, container, record, BINARY_VALUES_INT, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRchrmatCreateFromContainer(CMR* cmr, CMR_MATRIX_CONTAINER* container, size_t record,
+  CMR_CHRMAT** presult)
+{
+  return containerReadMatrix(cmr, container, record, BINARY_VALUES_CHAR, (CMR_MATRIX**) presult);
+}
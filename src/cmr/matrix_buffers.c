@@ -0,0 +1,354 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/matrix.h>
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "env_internal.h"
+#include "matrix_internal.h"
+
+/**
+ * \brief Returns the entry at \p position of the slice or index array \p array.
+ */
+
+static inline
+int64_t bufferIndex(
+  const void* array,  /**< Slice or index array. */
+  bool indices64,     /**< Whether \p array consists of 64-bit integers. */
+  size_t position     /**< Position. */
+)
+{
+  return indices64 ? ((const int64_t*) array)[position] : ((const int32_t*) array)[position];
+}
+
+/**
+ * \brief Reads the value at \p position of \p buffers as a \c char.
+ *
+ * Returns \ref CMR_ERROR_INPUT if the value is not an integer in the range of \c char.
+ */
+
+static inline
+CMR_ERROR bufferValue(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  const CMR_SPARSE_BUFFERS* buffers,  /**< Sparse buffers. */
+  size_t position,                    /**< Position. */
+  char* pvalue                        /**< Pointer for storing the value. */
+)
+{
+  if (buffers->valueType == CMR_BUFFER_VALUES_CHAR)
+  {
+    *pvalue = ((const char*) buffers->values)[position];
+    return CMR_OKAY;
+  }
+
+  double value = (buffers->valueType == CMR_BUFFER_VALUES_INT) ? ((const int*) buffers->values)[position]
+    : ((const double*) buffers->values)[position];
+  if (value < CHAR_MIN || value > CHAR_MAX || value != (double) (int) value)
+  {
+    CMRraiseErrorMessage(cmr, "Value %g at position %zu is not an integer in the range of char.", value, position);
+    return CMR_ERROR_INPUT;
+  }
+  *pvalue = (char) value;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Checks that the slice array of \p buffers with \p numMajor rows (resp. columns) is nondecreasing.
+ */
+
+static
+CMR_ERROR buffersCheckSlice(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  const CMR_SPARSE_BUFFERS* buffers,  /**< Sparse buffers. */
+  size_t numMajor                     /**< Number of rows (resp. columns) of the buffers. */
+)
+{
+  if (bufferIndex(buffers->slice, buffers->indices64, 0) < 0)
+  {
+    CMRraiseErrorMessage(cmr, "First slice entry is negative.");
+    return CMR_ERROR_INPUT;
+  }
+  for (size_t major = 0; major < numMajor; ++major)
+  {
+    if (bufferIndex(buffers->slice, buffers->indices64, major + 1)
+      < bufferIndex(buffers->slice, buffers->indices64, major))
+    {
+      CMRraiseErrorMessage(cmr, "Slice entries %zu and %zu are decreasing.", major, major + 1);
+      return CMR_ERROR_INPUT;
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the minor index at \p position of \p buffers after checking that it is in \f$ [0, n) \f$.
+ */
+
+static inline
+CMR_ERROR bufferMinor(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  const CMR_SPARSE_BUFFERS* buffers,  /**< Sparse buffers. */
+  size_t position,                    /**< Position. */
+  size_t numMinor,                    /**< Number of columns (resp. rows) of the buffers. */
+  size_t* pminor                      /**< Pointer for storing the index. */
+)
+{
+  int64_t minor = bufferIndex(buffers->indices, buffers->indices64, position);
+  if (minor < 0 || (uint64_t) minor >= numMinor)
+  {
+    CMRraiseErrorMessage(cmr, "Index %lld at position %zu is out of range.", (long long) minor, position);
+    return CMR_ERROR_INPUT;
+  }
+  *pminor = (size_t) minor;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns \c true if the arrays of \p buffers can be used directly as those of a \ref CMR_CHRMAT.
+ */
+
+static
+bool buffersBorrowable(
+  const CMR_SPARSE_BUFFERS* buffers,  /**< Sparse buffers. */
+  size_t numMajor                     /**< Number of rows (resp. columns) of the buffers. */
+)
+{
+  if (!buffers->indices64 || sizeof(size_t) != sizeof(int64_t) || !buffers->sorted
+    || buffers->valueType != CMR_BUFFER_VALUES_CHAR)
+  {
+    return false;
+  }
+
+  const int64_t* slice = (const int64_t*) buffers->slice;
+  if (slice[0] != 0 || slice[numMajor] < 0)
+    return false;
+
+  /* Explicit zeros are not allowed in a CMR_CHRMAT. */
+  const char* values = (const char*) buffers->values;
+  for (size_t position = 0; position < (size_t) slice[numMajor]; ++position)
+  {
+    if (!values[position])
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * \brief Creates a matrix whose rows are the rows (resp. columns) of \p buffers and whose arrays are those of
+ *        \p buffers.
+ */
+
+static
+CMR_ERROR buffersBorrow(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  const CMR_SPARSE_BUFFERS* buffers,  /**< Sparse buffers. */
+  size_t numMajor,                    /**< Number of rows (resp. columns) of the buffers. */
+  size_t numMinor,                    /**< Number of columns (resp. rows) of the buffers. */
+  CMR_CHRMAT** presult                /**< Pointer for storing the matrix. */
+)
+{
+  CMR_CALL( CMRallocBlock(cmr, presult) );
+  CMR_CHRMAT* result = *presult;
+  result->numRows = numMajor;
+  result->numColumns = numMinor;
+  result->numNonzeros = ((const size_t*) buffers->slice)[numMajor];
+  result->rowSlice = (size_t*) buffers->slice;
+  result->entryColumns = (size_t*) buffers->indices;
+  result->entryValues = (char*) buffers->values;
+  CMR_CALL( CMRmatrixRegisterBorrowed(cmr, result) );
+
+  CMRconsistencyAssert( CMRchrmatConsistency(result) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Copies the rows (resp. columns) of \p buffers into a new matrix, sorting them only if necessary.
+ */
+
+static
+CMR_ERROR buffersCompress(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  const CMR_SPARSE_BUFFERS* buffers,  /**< Sparse buffers. */
+  size_t numMajor,                    /**< Number of rows (resp. columns) of the buffers. */
+  size_t numMinor,                    /**< Number of columns (resp. rows) of the buffers. */
+  CMR_CHRMAT* result                  /**< Matrix with enough memory for all positions of \p buffers. */
+)
+{
+  bool isSorted = true;
+  size_t entry = 0;
+  for (size_t major = 0; major < numMajor; ++major)
+  {
+    result->rowSlice[major] = entry;
+    size_t beyond = bufferIndex(buffers->slice, buffers->indices64, major + 1);
+    size_t previous = SIZE_MAX;
+    for (size_t position = bufferIndex(buffers->slice, buffers->indices64, major); position < beyond; ++position)
+    {
+      size_t minor;
+      CMR_CALL( bufferMinor(cmr, buffers, position, numMinor, &minor) );
+      char value;
+      CMR_CALL( bufferValue(cmr, buffers, position, &value) );
+      if (!value)
+        continue;
+
+      if (previous != SIZE_MAX && minor <= previous)
+      {
+        if (minor == previous)
+        {
+          CMRraiseErrorMessage(cmr, "Duplicate index %zu at position %zu.", minor, position);
+          return CMR_ERROR_INPUT;
+        }
+        isSorted = false;
+      }
+      previous = minor;
+      result->entryColumns[entry] = minor;
+      result->entryValues[entry] = value;
+      ++entry;
+    }
+  }
+  result->rowSlice[numMajor] = entry;
+  result->numNonzeros = entry;
+
+  if (isSorted)
+    return CMR_OKAY;
+
+  /* Sorting may reveal duplicates that were not adjacent. */
+  CMR_CALL( CMRmatrixSortNonzeros(cmr, (CMR_MATRIX*) result, sizeof(char)) );
+  for (size_t major = 0; major < numMajor; ++major)
+  {
+    for (size_t e = result->rowSlice[major] + 1; e < result->rowSlice[major + 1]; ++e)
+    {
+      if (result->entryColumns[e] == result->entryColumns[e - 1])
+      {
+        CMRraiseErrorMessage(cmr, "Duplicate index %zu in row (resp. column) %zu.", result->entryColumns[e], major);
+        return CMR_ERROR_INPUT;
+      }
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Transposes the rows (resp. columns) of \p buffers into a new matrix by a counting sort.
+ *
+ * The rows of the result are sorted regardless of whether the buffers are sorted.
+ */
+
+static
+CMR_ERROR buffersTransposeCompress(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  const CMR_SPARSE_BUFFERS* buffers,  /**< Sparse buffers. */
+  size_t numMajor,                    /**< Number of rows (resp. columns) of the buffers. */
+  size_t numMinor,                    /**< Number of columns (resp. rows) of the buffers. */
+  CMR_CHRMAT* result                  /**< Matrix with enough memory for all positions of \p buffers. */
+)
+{
+  size_t first = bufferIndex(buffers->slice, buffers->indices64, 0);
+  size_t beyond = bufferIndex(buffers->slice, buffers->indices64, numMajor);
+
+  /* Count the nonzeros of each row of the result. */
+  for (size_t minor = 0; minor <= numMinor; ++minor)
+    result->rowSlice[minor] = 0;
+  for (size_t position = first; position < beyond; ++position)
+  {
+    size_t minor;
+    CMR_CALL( bufferMinor(cmr, buffers, position, numMinor, &minor) );
+    char value;
+    CMR_CALL( bufferValue(cmr, buffers, position, &value) );
+    if (value)
+      result->rowSlice[minor + 1]++;
+  }
+  for (size_t minor = 0; minor < numMinor; ++minor)
+    result->rowSlice[minor + 1] += result->rowSlice[minor];
+  result->numNonzeros = result->rowSlice[numMinor];
+
+  size_t* next = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &next, numMinor + 1) );
+  for (size_t minor = 0; minor < numMinor; ++minor)
+    next[minor] = result->rowSlice[minor];
+
+  CMR_ERROR error = CMR_OKAY;
+  for (size_t major = 0; major < numMajor && !error; ++major)
+  {
+    size_t beyondMajor = bufferIndex(buffers->slice, buffers->indices64, major + 1);
+    for (size_t position = bufferIndex(buffers->slice, buffers->indices64, major); position < beyondMajor;
+      ++position)
+    {
+      size_t minor = bufferIndex(buffers->indices, buffers->indices64, position);
+      char value = 0;
+      bufferValue(cmr, buffers, position, &value);
+      if (!value)
+        continue;
+
+      size_t entry = next[minor]++;
+      if (entry > result->rowSlice[minor] && result->entryColumns[entry - 1] == major)
+      {
+        CMRraiseErrorMessage(cmr, "Duplicate index %zu at position %zu.", minor, position);
+        error = CMR_ERROR_INPUT;
+        break;
+      }
+      result->entryColumns[entry] = major;
+      result->entryValues[entry] = value;
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &next) );
+
+  return error;
+}
+
+CMR_ERROR CMRchrmatCreateFromBuffers(CMR* cmr, const CMR_SPARSE_BUFFERS* buffers, CMR_CHRMAT** presult,
+  bool* ptransposed)
+{
+  assert(cmr);
+  assert(buffers);
+  assert(presult);
+  assert(!*presult);
+
+  size_t numMajor = buffers->columnWise ? buffers->numColumns : buffers->numRows;
+  size_t numMinor = buffers->columnWise ? buffers->numRows : buffers->numColumns;
+  bool borrowable = buffersBorrowable(buffers, numMajor);
+  bool keepOrientation = !buffers->columnWise || ptransposed;
+  if (ptransposed)
+    *ptransposed = buffers->columnWise;
+
+  if (keepOrientation && borrowable)
+    return buffersBorrow(cmr, buffers, numMajor, numMinor, presult);
+
+  CMR_CALL( buffersCheckSlice(cmr, buffers, numMajor) );
+  size_t numPositions = bufferIndex(buffers->slice, buffers->indices64, numMajor)
+    - bufferIndex(buffers->slice, buffers->indices64, 0);
+  CMR_CALL( CMRchrmatCreate(cmr, presult, keepOrientation ? numMajor : numMinor,
+    keepOrientation ? numMinor : numMajor, numPositions) );
+
+  CMR_ERROR error;
+  if (keepOrientation)
+    error = buffersCompress(cmr, buffers, numMajor, numMinor, *presult);
+  else
+    error = buffersTransposeCompress(cmr, buffers, numMajor, numMinor, *presult);
+  if (error)
+  {
+    CMR_CALL( CMRchrmatFree(cmr, presult) );
+    return error;
+  }
+
+  CMRconsistencyAssert( CMRchrmatConsistency(*presult) );
+
+  /* The CSC buffers themselves are the transpose. */
+  if (!keepOrientation && borrowable)
+  {
+    CMR_CHRMAT* transpose = NULL;
+    CMR_CALL( buffersBorrow(cmr, buffers, numMajor, numMinor, &transpose) );
+    CMR_CALL( CMRchrmatCacheTranspose(cmr, *presult, &transpose) );
+  }
+
+  return CMR_OKAY;
+}
@@ -0,0 +1,208 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/matrix.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "env_internal.h"
+
+bool CMRchrmat32Fits(size_t numRows, size_t numColumns, size_t numNonzeros)
+{
+  return numRows <= UINT32_MAX && numColumns <= UINT32_MAX && numNonzeros < UINT32_MAX;
+}
+
+CMR_ERROR CMRchrmat32Create(CMR* cmr, CMR_CHRMAT32** presult, size_t numRows, size_t numColumns, size_t numNonzeros)
+{
+  assert(cmr);
+  assert(presult);
+  assert(!*presult);
+
+  if (!CMRchrmat32Fits(numRows, numColumns, numNonzeros))
+  {
+    CMRraiseErrorMessage(cmr, "A %zux%zu matrix with %zu nonzeros cannot be stored with 32-bit indices.", numRows,
+      numColumns, numNonzeros);
+    return CMR_ERROR_INPUT;
+  }
+
+  CMR_CALL( CMRallocBlock(cmr, presult) );
+  CMR_CHRMAT32* result = *presult;
+  result->numRows = numRows;
+  result->numColumns = numColumns;
+  result->numNonzeros = numNonzeros;
+  result->rowSlice = NULL;
+  result->entryColumns = NULL;
+  result->entryValues = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &result->rowSlice, numRows + 1) );
+  if (numNonzeros > 0)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, &result->entryColumns, numNonzeros) );
+    CMR_CALL( CMRallocBlockArray(cmr, &result->entryValues, numNonzeros) );
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmat32Free(CMR* cmr, CMR_CHRMAT32** pmatrix)
+{
+  assert(pmatrix);
+
+  CMR_CHRMAT32* matrix = *pmatrix;
+  if (!matrix)
+    return CMR_OKAY;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &matrix->rowSlice) );
+  if (matrix->entryColumns)
+    CMR_CALL( CMRfreeBlockArray(cmr, &matrix->entryColumns) );
+  if (matrix->entryValues)
+    CMR_CALL( CMRfreeBlockArray(cmr, &matrix->entryValues) );
+  CMR_CALL( CMRfreeBlock(cmr, pmatrix) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmatToCompact(CMR* cmr, CMR_CHRMAT* matrix, CMR_CHRMAT32** presult)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(presult);
+  CMRconsistencyAssert( CMRchrmatConsistency(matrix) );
+
+  CMR_CALL( CMRchrmat32Create(cmr, presult, matrix->numRows, matrix->numColumns, matrix->numNonzeros) );
+  CMR_CHRMAT32* result = *presult;
+  for (size_t row = 0; row <= matrix->numRows; ++row)
+    result->rowSlice[row] = (uint32_t) matrix->rowSlice[row];
+  for (size_t entry = 0; entry < matrix->numNonzeros; ++entry)
+  {
+    result->entryColumns[entry] = (uint32_t) matrix->entryColumns[entry];
+    result->entryValues[entry] = matrix->entryValues[entry];
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmat32ToChrmat(CMR* cmr, CMR_CHRMAT32* matrix, CMR_CHRMAT** presult)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(presult);
+  CMRconsistencyAssert( CMRchrmat32Consistency(matrix) );
+
+  CMR_CALL( CMRchrmatCreate(cmr, presult, matrix->numRows, matrix->numColumns, matrix->numNonzeros) );
+  CMR_CHRMAT* result = *presult;
+  for (size_t row = 0; row <= matrix->numRows; ++row)
+    result->rowSlice[row] = matrix->rowSlice[row];
+  for (size_t entry = 0; entry < matrix->numNonzeros; ++entry)
+  {
+    result->entryColumns[entry] = matrix->entryColumns[entry];
+    result->entryValues[entry] = matrix->entryValues[entry];
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmat32Transpose(CMR* cmr, CMR_CHRMAT32* matrix, CMR_CHRMAT32** presult)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(presult);
+  assert(!*presult);
+  CMRconsistencyAssert( CMRchrmat32Consistency(matrix) );
+
+  CMR_CALL( CMRchrmat32Create(cmr, presult, matrix->numColumns, matrix->numRows, matrix->numNonzeros) );
+  CMR_CHRMAT32* result = *presult;
+
+  /* Count number of nonzeros in each column, storing in the next entry. */
+  for (size_t c = 0; c <= matrix->numColumns; ++c)
+    result->rowSlice[c] = 0;
+  for (size_t e = 0; e < matrix->numNonzeros; ++e)
+    result->rowSlice[matrix->entryColumns[e] + 1]++;
+
+  /* Compute start indices for columns. */
+  for (size_t c = 1; c < matrix->numColumns; ++c)
+    result->rowSlice[c] += result->rowSlice[c-1];
+
+  /* Create nonzeros. */
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    uint32_t first = matrix->rowSlice[row];
+    uint32_t beyond = matrix->rowSlice[row + 1];
+    for (uint32_t entry = first; entry < beyond; ++entry)
+    {
+      uint32_t column = matrix->entryColumns[entry];
+      uint32_t transEntry = result->rowSlice[column]++;
+      result->entryColumns[transEntry] = (uint32_t) row;
+      result->entryValues[transEntry] = matrix->entryValues[entry];
+    }
+  }
+
+  /* We shifted rowSlice of result, so we shift it back. */
+  for (size_t c = matrix->numColumns; c > 0; --c)
+    result->rowSlice[c] = result->rowSlice[c-1];
+  result->rowSlice[0] = 0;
+
+  return CMR_OKAY;
+}
+
+bool CMRchrmat32CheckEqual(CMR_CHRMAT32* matrix1, CMR_CHRMAT* matrix2)
+{
+  CMRconsistencyAssert( CMRchrmat32Consistency(matrix1) );
+  CMRconsistencyAssert( CMRchrmatConsistency(matrix2) );
+
+  if (matrix1->numRows != matrix2->numRows || matrix1->numColumns != matrix2->numColumns
+    || matrix1->numNonzeros != matrix2->numNonzeros)
+  {
+    return false;
+  }
+
+  for (size_t row = 0; row <= matrix1->numRows; ++row)
+  {
+    if (matrix1->rowSlice[row] != matrix2->rowSlice[row])
+      return false;
+  }
+  for (size_t entry = 0; entry < matrix1->numNonzeros; ++entry)
+  {
+    if (matrix1->entryColumns[entry] != matrix2->entryColumns[entry]
+      || matrix1->entryValues[entry] != matrix2->entryValues[entry])
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+char* CMRchrmat32Consistency(CMR_CHRMAT32* matrix)
+{
+  if (!matrix)
+    return CMRconsistencyMessage("CMR_CHRMAT32 is NULL.");
+  if (!matrix->rowSlice)
+    return CMRconsistencyMessage("CMR_CHRMAT32 is does not have rowSlice array.");
+  if (matrix->rowSlice[matrix->numRows] != matrix->numNonzeros)
+  {
+    return CMRconsistencyMessage("CMR_CHRMAT32 has inconsistent last slice index (%u) and #nonzeros (%zu)",
+      (unsigned) matrix->rowSlice[matrix->numRows], matrix->numNonzeros);
+  }
+
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    uint32_t first = matrix->rowSlice[row];
+    uint32_t beyond = matrix->rowSlice[row + 1];
+    for (uint32_t entry = first; entry < beyond; ++entry)
+    {
+      if (matrix->entryValues[entry] == 0)
+      {
+        return CMRconsistencyMessage("CMR_CHRMAT32 contains zero entry #%u in row %zu, column %u.\n",
+          (unsigned) entry, row, (unsigned) matrix->entryColumns[entry]);
+      }
+      if (entry > first && matrix->entryColumns[entry - 1] >= matrix->entryColumns[entry])
+      {
+        return CMRconsistencyMessage("CMR_CHRMAT32 contains nonzeros in row %zu that are not sorted by column.\n",
+          row);
+      }
+    }
+  }
+
+  return NULL;
+}
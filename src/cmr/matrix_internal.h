@@ -21,6 +21,85 @@ typedef struct
   void* entryValues;    /**< \brief Array mapping each entry to its value. */
 } CMR_MATRIX;
 
+/**
+ * \brief Unmaps the file whose contents are used by \p matrix, if any.
+ *
+ * Is called when freeing a matrix. If \p *pisMapped is set to \c true, the arrays of \p matrix must not be freed.
+ */
+
+CMR_ERROR CMRmatrixReleaseMapping(
+  CMR* cmr,       /**< \ref CMR environment. */
+  void* matrix,   /**< Matrix to be freed. */
+  bool* pisMapped /**< Pointer for storing whether the arrays of \p matrix were mapped. */
+);
+
+/**
+ * \brief Unmaps all files that are still mapped and frees the corresponding matrices.
+ */
+
+void CMRmatrixReleaseAllMappings(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
+/**
+ * \brief Writes the transpose of \p matrix into \p result, whose arrays must already have the right sizes.
+ *
+ * Runs a counting sort in \f$ \mathcal{O}(m + n + k) \f$ time for an \f$ m \times n \f$ matrix with \f$ k \f$
+ * nonzeros. The rows of \p matrix need not be sorted, while those of \p result always are. Large matrices are
+ * transposed in parallel.
+ */
+
+CMR_ERROR CMRmatrixTransposeInto(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_MATRIX* matrix, /**< Matrix. */
+  size_t valueSize,   /**< Size of a matrix entry, i.e., \c sizeof(double), \c sizeof(int) or \c sizeof(char). */
+  CMR_MATRIX* result  /**< Matrix for storing the transpose. */
+);
+
+/**
+ * \brief Sorts the nonzeros of each row of \p matrix by column.
+ *
+ * Short unsorted rows are sorted by insertion sort. If a longer row is unsorted, then the matrix is transposed twice
+ * by \ref CMRmatrixTransposeInto(), which takes linear time.
+ */
+
+CMR_ERROR CMRmatrixSortNonzeros(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_MATRIX* matrix, /**< Matrix. */
+  size_t valueSize    /**< Size of a matrix entry, i.e., \c sizeof(double), \c sizeof(int) or \c sizeof(char). */
+);
+
+/**
+ * \brief Stores \p *ptranspose as the cached transpose of \p matrix, which then owns it.
+ *
+ * Replaces a previously cached transpose. Sets \p *ptranspose to \c NULL.
+ */
+
+CMR_ERROR CMRchrmatCacheTranspose(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,     /**< Matrix. */
+  CMR_CHRMAT** ptranspose /**< Pointer to the transpose of \p matrix. */
+);
+
+/**
+ * \brief Registers \p matrix as a matrix whose arrays are owned by the caller.
+ *
+ * Freeing \p matrix then only frees the matrix itself but not its arrays.
+ */
+
+CMR_ERROR CMRmatrixRegisterBorrowed(
+  CMR* cmr,     /**< \ref CMR environment. */
+  void* matrix  /**< Matrix whose arrays must not be freed. */
+);
+
+/**
+ * \brief Frees all cached transposes.
+ */
+
+void CMRmatrixReleaseAllTransposes(
+  CMR* cmr  /**< \ref CMR environment. */
+);
+
 /**
  * \brief Sorts the row and column indices of \p submatrix.
  */
@@ -45,6 +124,167 @@ CMR_ERROR CMRchrmatFilter(
   CMR_CHRMAT** presult  /**< Pointer for storing the created submatrix. */
 );
 
+/**
+ * \brief Reads the whole file \p fileName into a null-terminated buffer, which shall be freed via
+ *        \ref CMRfreeBlockArray.
+ *
+ * Files compressed in gzip or Zstandard format are decompressed. Returns \ref CMR_ERROR_INPUT if the file cannot be
+ * read.
+ */
+
+CMR_ERROR CMRtextReadFileContents(
+  CMR* cmr,               /**< \ref CMR environment. */
+  const char* fileName,   /**< Name of the file. */
+  const char* stdinName,  /**< If not \c NULL, indicates which file name represents stdin. */
+  char** pbuffer,         /**< Pointer for storing the buffer. */
+  size_t* plength         /**< Pointer for storing the number of bytes read, excluding the null character. */
+);
+
+/**
+ * \brief Buffered writer for text output.
+ *
+ * Output is collected in a buffer of \ref CMR_TEXT_WRITER_SIZE bytes that is written to the stream in one call
+ * whenever it is full.
+ */
+
+typedef struct
+{
+  FILE* stream;   /**< \brief Stream to write to. */
+  char* buffer;   /**< \brief Buffered output. */
+  size_t length;  /**< \brief Number of buffered bytes. */
+  bool failed;    /**< \brief Whether writing to \ref stream failed. */
+} CMR_TEXT_WRITER;
+
+#define CMR_TEXT_WRITER_SIZE (1UL << 16)  /**< Size of the buffer of a \ref CMR_TEXT_WRITER. */
+#define CMR_TEXT_WRITER_MAX_TOKEN 32      /**< Maximum number of bytes written by a single call. */
+
+/**
+ * \brief Initializes \p writer for writing to \p stream.
+ */
+
+CMR_ERROR CMRtextWriterInit(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  FILE* stream              /**< Stream to write to. */
+);
+
+/**
+ * \brief Writes the buffered output of \p writer to its stream.
+ */
+
+void CMRtextWriterFlush(
+  CMR_TEXT_WRITER* writer /**< Writer. */
+);
+
+/**
+ * \brief Flushes and frees \p writer.
+ *
+ * \returns \ref CMR_ERROR_OUTPUT if writing to the stream failed at some point.
+ */
+
+CMR_ERROR CMRtextWriterFree(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_TEXT_WRITER* writer   /**< Writer. */
+);
+
+/**
+ * \brief Makes sure that \ref CMR_TEXT_WRITER_MAX_TOKEN bytes can be buffered.
+ */
+
+static inline
+void CMRtextWriterReserve(
+  CMR_TEXT_WRITER* writer /**< Writer. */
+)
+{
+  if (writer->length + CMR_TEXT_WRITER_MAX_TOKEN > CMR_TEXT_WRITER_SIZE)
+    CMRtextWriterFlush(writer);
+}
+
+/**
+ * \brief Writes the character \p c.
+ */
+
+static inline
+void CMRtextWriterChar(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  char c                    /**< Character. */
+)
+{
+  CMRtextWriterReserve(writer);
+  writer->buffer[writer->length++] = c;
+}
+
+/**
+ * \brief Writes the null-terminated \p string.
+ */
+
+static inline
+void CMRtextWriterString(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  const char* string        /**< String. */
+)
+{
+  for (; *string; ++string)
+    CMRtextWriterChar(writer, *string);
+}
+
+/**
+ * \brief Writes the decimal representation of \p value.
+ */
+
+static inline
+void CMRtextWriterSize(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  size_t value              /**< Value. */
+)
+{
+  char digits[24];
+  size_t numDigits = 0;
+  do
+  {
+    digits[numDigits++] = (char) ('0' + value % 10);
+    value /= 10;
+  }
+  while (value);
+
+  CMRtextWriterReserve(writer);
+  char* output = &writer->buffer[writer->length];
+  writer->length += numDigits;
+  while (numDigits)
+    *output++ = digits[--numDigits];
+}
+
+/**
+ * \brief Writes the decimal representation of \p value.
+ */
+
+static inline
+void CMRtextWriterInt(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  long long value           /**< Value. */
+)
+{
+  if (value < 0)
+  {
+    CMRtextWriterChar(writer, '-');
+    CMRtextWriterSize(writer, (size_t) -(unsigned long long) value);
+  }
+  else
+    CMRtextWriterSize(writer, (size_t) value);
+}
+
+/**
+ * \brief Writes \p value such that it is read back exactly.
+ *
+ * Integers of absolute value less than \f$ 2^{53} \f$ are written without exponent. Other values are written with the
+ * smallest number of at least 15 significant digits that represents them exactly.
+ */
+
+void CMRtextWriterDouble(
+  CMR_TEXT_WRITER* writer,  /**< Writer. */
+  double value              /**< Value. */
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1148 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/matrix.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <math.h>
+
+#include "env_internal.h"
+#include "matrix_internal.h"
+#include "hashtable.h"
+#include "text_internal.h"
+
+#define MODEL_MAX_NUMBER 64 /**< Maximum length of a number token. */
+#define MODEL_MAX_TOKENS 7  /**< Maximum number of tokens of a line of an MPS file that are considered. */
+
+/**
+ * \brief Coefficient of a constraint matrix that is being read.
+ */
+
+typedef struct
+{
+  size_t row;     /**< \brief Row of the coefficient. */
+  size_t column;  /**< \brief Column of the coefficient. */
+  double value;   /**< \brief Value of the coefficient. */
+} ModelNonzero;
+
+/**
+ * \brief Constraints, variables and coefficients of a model that is being read.
+ */
+
+typedef struct
+{
+  CMR* cmr;                                 /**< \brief \ref CMR environment. */
+  const char* fileName;                     /**< \brief Name of the file for error messages. */
+  size_t line;                              /**< \brief Current line for error messages. */
+  CMR_LINEARHASHTABLE_ARRAY* rowNames;      /**< \brief Hash table mapping row names to rows. */
+  CMR_LINEARHASHTABLE_ARRAY* columnNames;   /**< \brief Hash table mapping column names to columns. */
+  char* rowTypes;                           /**< \brief Array with the type \c N, \c E, \c L, \c G or \c R of each
+                                             **  row, where \c R indicates a ranged row. */
+  size_t numRows;                           /**< \brief Number of rows. */
+  size_t memRows;                           /**< \brief Memory allocated for \ref rowTypes. */
+  bool* columnsInteger;                     /**< \brief Array indicating whether each column is integer. */
+  size_t numColumns;                        /**< \brief Number of columns. */
+  size_t memColumns;                        /**< \brief Memory allocated for \ref columnsInteger. */
+  ModelNonzero* nonzeros;                   /**< \brief Array with the coefficients. */
+  size_t numNonzeros;                       /**< \brief Number of coefficients. */
+  size_t memNonzeros;                       /**< \brief Memory allocated for \ref nonzeros. */
+} ModelReader;
+
+/**
+ * \brief Returns \c true if and only if the token from \p begin to \p end equals \p keyword, ignoring case.
+ */
+
+static
+bool modelTokenEquals(
+  const char* begin,  /**< Beginning of the token. */
+  const char* end,    /**< End of the token. */
+  const char* keyword /**< Keyword in lower case. */
+)
+{
+  for (; begin < end; ++begin, ++keyword)
+  {
+    char c = *begin;
+    if (c >= 'A' && c <= 'Z')
+      c = (char) (c - 'A' + 'a');
+    if (c != *keyword)
+      return false;
+  }
+
+  return *keyword == '\0';
+}
+
+/**
+ * \brief Parses the token from \p begin to \p end as a number.
+ *
+ * \returns Whether the token is a number.
+ */
+
+static
+bool modelParseNumber(
+  const char* begin,  /**< Beginning of the token. */
+  const char* end,    /**< End of the token. */
+  double* pvalue      /**< Pointer for storing the value. */
+)
+{
+  char number[MODEL_MAX_NUMBER];
+  size_t length = (size_t) (end - begin);
+  if (length == 0 || length >= MODEL_MAX_NUMBER)
+    return false;
+  memcpy(number, begin, length);
+  number[length] = '\0';
+
+  return CMRtextParseDouble(number, &number[length], pvalue);
+}
+
+/**
+ * \brief Raises an error message for the current line of the file.
+ */
+
+static
+CMR_ERROR modelRaiseError(
+  ModelReader* reader,  /**< Reader. */
+  const char* message,  /**< Message. */
+  const char* begin,    /**< Beginning of the token the message refers to, or \c NULL. */
+  const char* end       /**< End of the token the message refers to. */
+)
+{
+  if (begin)
+  {
+    int length = end - begin > 32 ? 32 : (int) (end - begin);
+    CMRraiseErrorMessage(reader->cmr, "Error in line %zu of <%s>: %s <%.*s>.", reader->line, reader->fileName, message,
+      length, begin);
+  }
+  else
+    CMRraiseErrorMessage(reader->cmr, "Error in line %zu of <%s>: %s.", reader->line, reader->fileName, message);
+
+  return CMR_ERROR_INPUT;
+}
+
+/**
+ * \brief Adds a row of the given \p type.
+ *
+ * If \p begin is not \c NULL, the token from \p begin to \p end is its name, which must be new.
+ */
+
+static
+CMR_ERROR modelAddRow(
+  ModelReader* reader,  /**< Reader. */
+  char type,            /**< Type of the row. */
+  const char* begin,    /**< Beginning of the name, or \c NULL. */
+  const char* end,      /**< End of the name. */
+  size_t* prow          /**< Pointer for storing the row. */
+)
+{
+  if (begin)
+  {
+    CMR_LINEARHASHTABLE_BUCKET bucket;
+    CMR_LINEARHASHTABLE_HASH hash;
+    if (CMRlinearhashtableArrayFind(reader->rowNames, begin, (size_t) (end - begin), &bucket, &hash))
+      return modelRaiseError(reader, "duplicate row", begin, end);
+    CMR_CALL( CMRlinearhashtableArrayInsertBucketHash(reader->cmr, reader->rowNames, begin, (size_t) (end - begin),
+      bucket, hash, (void*) reader->numRows) );
+  }
+
+  if (reader->numRows == reader->memRows)
+  {
+    reader->memRows *= 2;
+    CMR_CALL( CMRreallocBlockArray(reader->cmr, &reader->rowTypes, reader->memRows) );
+  }
+  reader->rowTypes[reader->numRows] = type;
+  *prow = reader->numRows++;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Finds the column with the name from \p begin to \p end, adding it if it does not exist.
+ */
+
+static
+CMR_ERROR modelFindColumn(
+  ModelReader* reader,  /**< Reader. */
+  const char* begin,    /**< Beginning of the name. */
+  const char* end,      /**< End of the name. */
+  size_t* pcolumn       /**< Pointer for storing the column. */
+)
+{
+  CMR_LINEARHASHTABLE_BUCKET bucket;
+  CMR_LINEARHASHTABLE_HASH hash;
+  if (CMRlinearhashtableArrayFind(reader->columnNames, begin, (size_t) (end - begin), &bucket, &hash))
+  {
+    *pcolumn = (size_t) CMRlinearhashtableArrayValue(reader->columnNames, bucket);
+    return CMR_OKAY;
+  }
+
+  CMR_CALL( CMRlinearhashtableArrayInsertBucketHash(reader->cmr, reader->columnNames, begin, (size_t) (end - begin),
+    bucket, hash, (void*) reader->numColumns) );
+  if (reader->numColumns == reader->memColumns)
+  {
+    reader->memColumns *= 2;
+    CMR_CALL( CMRreallocBlockArray(reader->cmr, &reader->columnsInteger, reader->memColumns) );
+  }
+  reader->columnsInteger[reader->numColumns] = false;
+  *pcolumn = reader->numColumns++;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Adds the coefficient \p value for \p row and \p column.
+ */
+
+static
+CMR_ERROR modelAddNonzero(
+  ModelReader* reader,  /**< Reader. */
+  size_t row,           /**< Row. */
+  size_t column,        /**< Column. */
+  double value          /**< Value. */
+)
+{
+  if (value == 0.0)
+    return CMR_OKAY;
+
+  if (reader->numNonzeros == reader->memNonzeros)
+  {
+    reader->memNonzeros *= 2;
+    CMR_CALL( CMRreallocBlockArray(reader->cmr, &reader->nonzeros, reader->memNonzeros) );
+  }
+  ModelNonzero* nonzero = &reader->nonzeros[reader->numNonzeros++];
+  nonzero->row = row;
+  nonzero->column = column;
+  nonzero->value = value;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Sections of an MPS file.
+ */
+
+typedef enum
+{
+  MPS_SECTION_NONE = 0,   /**< Before the first section or in a section that is skipped. */
+  MPS_SECTION_ROWS,       /**< ROWS section. */
+  MPS_SECTION_COLUMNS,    /**< COLUMNS section. */
+  MPS_SECTION_BOUNDS,     /**< BOUNDS section. */
+  MPS_SECTION_END         /**< After ENDATA. */
+} MpsSection;
+
+/**
+ * \brief Returns the section started by a line that starts with the token from \p begin to \p end, or
+ *        \c MPS_SECTION_END + 1 if it is no section header.
+ */
+
+static
+int mpsSectionHeader(
+  const char* begin,  /**< Beginning of the token. */
+  const char* end     /**< End of the token. */
+)
+{
+  static const char* skipped[] = { "name", "objsense", "objsen", "objname", "rhs", "ranges", "sos", "qsection",
+    "qmatrix", "quadobj", "qcmatrix", "csection", "indicators", "gencons", "pwlobj", "pwlnam", "pwlcon", NULL };
+
+  if (modelTokenEquals(begin, end, "rows"))
+    return MPS_SECTION_ROWS;
+  if (modelTokenEquals(begin, end, "columns"))
+    return MPS_SECTION_COLUMNS;
+  if (modelTokenEquals(begin, end, "bounds"))
+    return MPS_SECTION_BOUNDS;
+  if (modelTokenEquals(begin, end, "endata"))
+    return MPS_SECTION_END;
+  for (size_t i = 0; skipped[i]; ++i)
+  {
+    if (modelTokenEquals(begin, end, skipped[i]))
+      return MPS_SECTION_NONE;
+  }
+
+  return MPS_SECTION_END + 1;
+}
+
+/**
+ * \brief Reads a model in MPS format from the null-terminated \p buffer.
+ *
+ * Fixed and free MPS are both read by splitting lines at whitespace.
+ */
+
+static
+CMR_ERROR mpsRead(
+  ModelReader* reader,  /**< Reader. */
+  const char* buffer,   /**< Buffer. */
+  const char* bufferEnd /**< End of \p buffer. */
+)
+{
+  MpsSection section = MPS_SECTION_NONE;
+  bool integerMarker = false;
+  const char* tokenBegins[MODEL_MAX_TOKENS];
+  const char* tokenEnds[MODEL_MAX_TOKENS];
+
+  /* The coefficients of a column are usually consecutive, so we remember the last one. */
+  const char* lastColumnName = NULL;
+  size_t lastColumnNameLength = 0;
+  size_t lastColumn = SIZE_MAX;
+
+  for (const char* p = buffer; p < bufferEnd && section != MPS_SECTION_END; )
+  {
+    const char* lineBegin = p;
+    const char* lineEnd = memchr(p, '\n', (size_t) (bufferEnd - p));
+    if (!lineEnd)
+      lineEnd = bufferEnd;
+    p = lineEnd + 1;
+    reader->line++;
+
+    if (lineBegin == lineEnd || *lineBegin == '*')
+      continue;
+
+    size_t numTokens = 0;
+    for (const char* q = lineBegin; q < lineEnd && numTokens < MODEL_MAX_TOKENS; )
+    {
+      while (q < lineEnd && CMRtextIsSpace(*q))
+        ++q;
+      if (q == lineEnd)
+        break;
+      tokenBegins[numTokens] = q;
+      while (q < lineEnd && !CMRtextIsSpace(*q))
+        ++q;
+      tokenEnds[numTokens++] = q;
+    }
+    if (numTokens == 0)
+      continue;
+
+    if (!CMRtextIsSpace(*lineBegin))
+    {
+      int header = mpsSectionHeader(tokenBegins[0], tokenEnds[0]);
+      if (header <= MPS_SECTION_END)
+      {
+        section = (MpsSection) header;
+        continue;
+      }
+    }
+
+    if (section == MPS_SECTION_ROWS)
+    {
+      if (numTokens < 2 || tokenEnds[0] - tokenBegins[0] != 1)
+        return modelRaiseError(reader, "invalid row", tokenBegins[0], tokenEnds[numTokens - 1]);
+      char type = *tokenBegins[0];
+      if (type >= 'a' && type <= 'z')
+        type = (char) (type - 'a' + 'A');
+      if (type != 'N' && type != 'E' && type != 'L' && type != 'G')
+        return modelRaiseError(reader, "invalid row type", tokenBegins[0], tokenEnds[0]);
+      size_t row;
+      CMR_CALL( modelAddRow(reader, type, tokenBegins[1], tokenEnds[1], &row) );
+    }
+    else if (section == MPS_SECTION_COLUMNS)
+    {
+      if (numTokens >= 3 && tokenEnds[1] - tokenBegins[1] == 8 && !memcmp(tokenBegins[1], "'MARKER'", 8))
+      {
+        if (tokenEnds[2] - tokenBegins[2] == 8 && !memcmp(tokenBegins[2], "'INTORG'", 8))
+          integerMarker = true;
+        else if (tokenEnds[2] - tokenBegins[2] == 8 && !memcmp(tokenBegins[2], "'INTEND'", 8))
+          integerMarker = false;
+        else
+          return modelRaiseError(reader, "invalid marker", tokenBegins[2], tokenEnds[2]);
+        continue;
+      }
+
+      if (numTokens != 3 && numTokens != 5)
+        return modelRaiseError(reader, "invalid coefficients of column", tokenBegins[0], tokenEnds[0]);
+
+      size_t nameLength = (size_t) (tokenEnds[0] - tokenBegins[0]);
+      if (!lastColumnName || nameLength != lastColumnNameLength || memcmp(tokenBegins[0], lastColumnName, nameLength))
+      {
+        CMR_CALL( modelFindColumn(reader, tokenBegins[0], tokenEnds[0], &lastColumn) );
+        lastColumnName = tokenBegins[0];
+        lastColumnNameLength = nameLength;
+      }
+      if (integerMarker)
+        reader->columnsInteger[lastColumn] = true;
+
+      for (size_t t = 1; t < numTokens; t += 2)
+      {
+        CMR_LINEARHASHTABLE_BUCKET bucket;
+        CMR_LINEARHASHTABLE_HASH hash;
+        if (!CMRlinearhashtableArrayFind(reader->rowNames, tokenBegins[t], (size_t) (tokenEnds[t] - tokenBegins[t]),
+          &bucket, &hash))
+        {
+          return modelRaiseError(reader, "unknown row", tokenBegins[t], tokenEnds[t]);
+        }
+        size_t row = (size_t) CMRlinearhashtableArrayValue(reader->rowNames, bucket);
+        double value;
+        if (!modelParseNumber(tokenBegins[t+1], tokenEnds[t+1], &value))
+          return modelRaiseError(reader, "invalid coefficient", tokenBegins[t+1], tokenEnds[t+1]);
+        CMR_CALL( modelAddNonzero(reader, row, lastColumn, value) );
+      }
+    }
+    else if (section == MPS_SECTION_BOUNDS)
+    {
+      /* Only bounds that declare integrality matter. The name of the bound vector may be missing. */
+      if (numTokens >= 2 && (modelTokenEquals(tokenBegins[0], tokenEnds[0], "bv")
+        || modelTokenEquals(tokenBegins[0], tokenEnds[0], "li") || modelTokenEquals(tokenBegins[0], tokenEnds[0], "ui")))
+      {
+        bool found = false;
+        for (size_t t = numTokens >= 3 ? 2 : 1; t >= 1 && !found; --t)
+        {
+          CMR_LINEARHASHTABLE_BUCKET bucket;
+          CMR_LINEARHASHTABLE_HASH hash;
+          if (CMRlinearhashtableArrayFind(reader->columnNames, tokenBegins[t],
+            (size_t) (tokenEnds[t] - tokenBegins[t]), &bucket, &hash))
+          {
+            reader->columnsInteger[(size_t) CMRlinearhashtableArrayValue(reader->columnNames, bucket)] = true;
+            found = true;
+          }
+        }
+        if (!found)
+          return modelRaiseError(reader, "unknown column in bound", tokenBegins[numTokens >= 3 ? 2 : 1],
+            tokenEnds[numTokens >= 3 ? 2 : 1]);
+      }
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Types of tokens of an LP file.
+ */
+
+typedef enum
+{
+  LP_TOKEN_END = 0,   /**< End of the input. */
+  LP_TOKEN_NAME,      /**< Name or keyword. */
+  LP_TOKEN_NUMBER,    /**< Number. */
+  LP_TOKEN_PLUS,      /**< Plus sign. */
+  LP_TOKEN_MINUS,     /**< Minus sign. */
+  LP_TOKEN_SENSE,     /**< One of \c <, \c <=, \c =<, \c >, \c >=, \c => and \c =. */
+  LP_TOKEN_COLON,     /**< Colon. */
+  LP_TOKEN_LBRACKET,  /**< Opening bracket of a quadratic term. */
+  LP_TOKEN_RBRACKET,  /**< Closing bracket of a quadratic term. */
+  LP_TOKEN_OTHER      /**< Any other character, or \c -> of an indicator constraint. */
+} LpTokenType;
+
+/**
+ * \brief Token of an LP file.
+ */
+
+typedef struct
+{
+  LpTokenType type;   /**< \brief Type of the token. */
+  const char* begin;  /**< \brief Beginning of the token. */
+  const char* end;    /**< \brief End of the token. */
+  double value;       /**< \brief Value of a number. */
+  char sense;         /**< \brief One of \c <, \c > and \c = for a sense. */
+  bool lineStart;     /**< \brief Whether the token is the first of its line. */
+} LpToken;
+
+/**
+ * \brief Scanner for LP files.
+ */
+
+typedef struct
+{
+  const char* current;  /**< \brief Next character. */
+  const char* end;      /**< \brief End of the input. */
+  size_t line;          /**< \brief Current line. */
+  bool lineStart;       /**< \brief Whether no token was read in the current line. */
+} LpScanner;
+
+/**
+ * \brief Returns \c true if and only if \p c may appear in a name of an LP file.
+ */
+
+static inline
+bool lpIsNameChar(
+  char c  /**< Character. */
+)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+    || (c && strchr("!\"#$%&()/,.;?@_`'{}|~", c));
+}
+
+/**
+ * \brief Scans the next token of an LP file.
+ */
+
+static
+void lpNextToken(
+  LpScanner* scanner, /**< Scanner. */
+  LpToken* token      /**< Pointer for storing the token. */
+)
+{
+  const char* p = scanner->current;
+  while (p < scanner->end)
+  {
+    if (*p == '\n')
+    {
+      scanner->line++;
+      scanner->lineStart = true;
+      ++p;
+    }
+    else if (CMRtextIsSpace(*p))
+      ++p;
+    else if (*p == '\\')
+    {
+      while (p < scanner->end && *p != '\n')
+        ++p;
+    }
+    else
+      break;
+  }
+
+  token->begin = p;
+  token->lineStart = scanner->lineStart;
+  scanner->lineStart = false;
+  if (p == scanner->end)
+  {
+    token->type = LP_TOKEN_END;
+    token->end = p;
+    scanner->current = p;
+    return;
+  }
+
+  char c = *p;
+  char next = p + 1 < scanner->end ? p[1] : '\0';
+  if ((c >= '0' && c <= '9') || (c == '.' && next >= '0' && next <= '9'))
+  {
+    char number[MODEL_MAX_NUMBER];
+    size_t length = 0;
+    while (p + length < scanner->end && length + 1 < MODEL_MAX_NUMBER && (strchr("0123456789.eE+-", p[length])
+      && p[length]))
+    {
+      number[length] = p[length];
+      ++length;
+    }
+    number[length] = '\0';
+    char* numberEnd = NULL;
+    token->value = strtod(number, &numberEnd);
+    token->type = LP_TOKEN_NUMBER;
+    p += numberEnd - number;
+  }
+  else if (c == '+')
+  {
+    token->type = LP_TOKEN_PLUS;
+    ++p;
+  }
+  else if (c == '-')
+  {
+    token->type = next == '>' ? LP_TOKEN_OTHER : LP_TOKEN_MINUS;
+    p += next == '>' ? 2 : 1;
+  }
+  else if (c == '<' || c == '>' || c == '=')
+  {
+    token->type = LP_TOKEN_SENSE;
+    token->sense = c;
+    ++p;
+    if (c == '=' && (next == '<' || next == '>'))
+    {
+      token->sense = next;
+      ++p;
+    }
+    else if (next == '=')
+      ++p;
+  }
+  else if (c == ':')
+  {
+    token->type = LP_TOKEN_COLON;
+    ++p;
+  }
+  else if (c == '[')
+  {
+    token->type = LP_TOKEN_LBRACKET;
+    ++p;
+  }
+  else if (c == ']')
+  {
+    token->type = LP_TOKEN_RBRACKET;
+    ++p;
+  }
+  else if (lpIsNameChar(c))
+  {
+    token->type = LP_TOKEN_NAME;
+    while (p < scanner->end && lpIsNameChar(*p))
+      ++p;
+  }
+  else
+  {
+    token->type = LP_TOKEN_OTHER;
+    ++p;
+  }
+
+  token->end = p;
+  scanner->current = p;
+}
+
+/**
+ * \brief Sections of an LP file.
+ */
+
+typedef enum
+{
+  LP_SECTION_NONE = 0,    /**< Before the objective. */
+  LP_SECTION_OBJECTIVE,   /**< Objective function. */
+  LP_SECTION_CONSTRAINTS, /**< Constraints. */
+  LP_SECTION_BOUNDS,      /**< Bounds. */
+  LP_SECTION_INTEGERS,    /**< Integer variables. */
+  LP_SECTION_BINARIES,    /**< Binary variables. */
+  LP_SECTION_SEMIS,       /**< Semi-continuous variables. */
+  LP_SECTION_SKIP,        /**< Section that is skipped. */
+  LP_SECTION_END          /**< After the end. */
+} LpSection;
+
+/**
+ * \brief Returns the section started by the name \p token at the beginning of a line, or \c LP_SECTION_NONE.
+ *
+ * If the keyword consists of several tokens, the remaining ones are consumed.
+ */
+
+static
+LpSection lpSectionKeyword(
+  LpScanner* scanner, /**< Scanner. */
+  LpToken* token      /**< Name token at the beginning of a line. */
+)
+{
+  static const char* objectiveKeywords[] = { "minimize", "minimum", "min", "maximize", "maximum", "max", NULL };
+  for (size_t i = 0; objectiveKeywords[i]; ++i)
+  {
+    if (modelTokenEquals(token->begin, token->end, objectiveKeywords[i]))
+      return LP_SECTION_OBJECTIVE;
+  }
+  if (modelTokenEquals(token->begin, token->end, "st") || modelTokenEquals(token->begin, token->end, "s.t.")
+    || modelTokenEquals(token->begin, token->end, "st."))
+  {
+    return LP_SECTION_CONSTRAINTS;
+  }
+  if (modelTokenEquals(token->begin, token->end, "bounds") || modelTokenEquals(token->begin, token->end, "bound"))
+    return LP_SECTION_BOUNDS;
+  if (modelTokenEquals(token->begin, token->end, "binary") || modelTokenEquals(token->begin, token->end, "binaries")
+    || modelTokenEquals(token->begin, token->end, "bin"))
+  {
+    return LP_SECTION_BINARIES;
+  }
+  if (modelTokenEquals(token->begin, token->end, "semis") || modelTokenEquals(token->begin, token->end, "sos"))
+    return modelTokenEquals(token->begin, token->end, "sos") ? LP_SECTION_SKIP : LP_SECTION_SEMIS;
+  if (modelTokenEquals(token->begin, token->end, "end"))
+    return LP_SECTION_END;
+
+  /* Keywords with several tokens. */
+  LpScanner saved = *scanner;
+  LpToken next;
+  lpNextToken(scanner, &next);
+  if (next.type == LP_TOKEN_NAME && !next.lineStart)
+  {
+    if ((modelTokenEquals(token->begin, token->end, "subject") && modelTokenEquals(next.begin, next.end, "to"))
+      || (modelTokenEquals(token->begin, token->end, "such") && modelTokenEquals(next.begin, next.end, "that")))
+    {
+      return LP_SECTION_CONSTRAINTS;
+    }
+    if ((modelTokenEquals(token->begin, token->end, "lazy") && modelTokenEquals(next.begin, next.end, "constraints"))
+      || (modelTokenEquals(token->begin, token->end, "user") && modelTokenEquals(next.begin, next.end, "cuts"))
+      || (modelTokenEquals(token->begin, token->end, "general")
+      && modelTokenEquals(next.begin, next.end, "constraints")))
+    {
+      return LP_SECTION_SKIP;
+    }
+  }
+  if (next.type == LP_TOKEN_MINUS && !next.lineStart && modelTokenEquals(token->begin, token->end, "semi"))
+  {
+    lpNextToken(scanner, &next);
+    if (next.type == LP_TOKEN_NAME && modelTokenEquals(next.begin, next.end, "continuous"))
+      return LP_SECTION_SEMIS;
+  }
+  *scanner = saved;
+
+  if (modelTokenEquals(token->begin, token->end, "general") || modelTokenEquals(token->begin, token->end, "generals")
+    || modelTokenEquals(token->begin, token->end, "gen") || modelTokenEquals(token->begin, token->end, "integer")
+    || modelTokenEquals(token->begin, token->end, "integers") || modelTokenEquals(token->begin, token->end, "semi"))
+  {
+    return modelTokenEquals(token->begin, token->end, "semi") ? LP_SECTION_SEMIS : LP_SECTION_INTEGERS;
+  }
+
+  return LP_SECTION_NONE;
+}
+
+/**
+ * \brief Reads the linear terms of a constraint up to its next sense, adding them to \p row.
+ *
+ * A constant without a variable is ignored; \p *phasConstant indicates whether there was one. On return, \p token is
+ * the sense.
+ */
+
+static
+CMR_ERROR lpReadTerms(
+  ModelReader* reader,  /**< Reader. */
+  LpScanner* scanner,   /**< Scanner. */
+  LpToken* token,       /**< Current token. */
+  size_t row,           /**< Row of the constraint. */
+  size_t* pnumTerms,    /**< Pointer for storing the number of terms. */
+  bool* phasConstant    /**< Pointer for storing whether there was a constant. */
+)
+{
+  double sign = 1.0;
+  double coefficient = 1.0;
+  bool hasCoefficient = false;
+  *pnumTerms = 0;
+  *phasConstant = false;
+  while (token->type != LP_TOKEN_SENSE)
+  {
+    reader->line = scanner->line;
+    if (token->type == LP_TOKEN_PLUS || token->type == LP_TOKEN_MINUS)
+    {
+      if (hasCoefficient)
+      {
+        *phasConstant = true;
+        hasCoefficient = false;
+        coefficient = 1.0;
+        sign = 1.0;
+      }
+      if (token->type == LP_TOKEN_MINUS)
+        sign = -sign;
+    }
+    else if (token->type == LP_TOKEN_NUMBER || (token->type == LP_TOKEN_NAME
+      && (modelTokenEquals(token->begin, token->end, "inf") || modelTokenEquals(token->begin, token->end, "infinity"))))
+    {
+      if (hasCoefficient)
+        return modelRaiseError(reader, "unexpected number", token->begin, token->end);
+      coefficient = token->type == LP_TOKEN_NUMBER ? token->value : INFINITY;
+      hasCoefficient = true;
+    }
+    else if (token->type == LP_TOKEN_NAME)
+    {
+      size_t column;
+      CMR_CALL( modelFindColumn(reader, token->begin, token->end, &column) );
+      CMR_CALL( modelAddNonzero(reader, row, column, sign * coefficient) );
+      ++(*pnumTerms);
+      sign = 1.0;
+      coefficient = 1.0;
+      hasCoefficient = false;
+    }
+    else if (token->type == LP_TOKEN_LBRACKET)
+      return modelRaiseError(reader, "quadratic constraints are not supported", NULL, NULL);
+    else if (token->type == LP_TOKEN_END)
+      return modelRaiseError(reader, "unexpected end of file in constraint", NULL, NULL);
+    else
+      return modelRaiseError(reader, "unexpected token in constraint", token->begin, token->end);
+    lpNextToken(scanner, token);
+  }
+  if (hasCoefficient)
+    *phasConstant = true;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads the right-hand side of a constraint after its sense; on return, \p token is the next token.
+ */
+
+static
+CMR_ERROR lpReadRightHandSide(
+  ModelReader* reader,  /**< Reader. */
+  LpScanner* scanner,   /**< Scanner. */
+  LpToken* token        /**< Current token. */
+)
+{
+  lpNextToken(scanner, token);
+  if (token->type == LP_TOKEN_PLUS || token->type == LP_TOKEN_MINUS)
+    lpNextToken(scanner, token);
+  if (token->type != LP_TOKEN_NUMBER && !(token->type == LP_TOKEN_NAME
+    && (modelTokenEquals(token->begin, token->end, "inf") || modelTokenEquals(token->begin, token->end, "infinity"))))
+  {
+    return modelRaiseError(reader, "expected right-hand side instead of", token->begin, token->end);
+  }
+  lpNextToken(scanner, token);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads a constraint starting at \p token; on return, \p token is the token after it.
+ */
+
+static
+CMR_ERROR lpReadConstraint(
+  ModelReader* reader,  /**< Reader. */
+  LpScanner* scanner,   /**< Scanner. */
+  LpToken* token        /**< Current token. */
+)
+{
+  /* Skip the name of the constraint. */
+  if (token->type == LP_TOKEN_NAME)
+  {
+    LpScanner saved = *scanner;
+    LpToken next;
+    lpNextToken(scanner, &next);
+    if (next.type == LP_TOKEN_COLON)
+      lpNextToken(scanner, token);
+    else
+      *scanner = saved;
+  }
+
+  size_t row;
+  CMR_CALL( modelAddRow(reader, 'L', NULL, NULL, &row) );
+  size_t numTerms;
+  bool hasConstant;
+  CMR_CALL( lpReadTerms(reader, scanner, token, row, &numTerms, &hasConstant) );
+  if (numTerms == 0 && hasConstant)
+  {
+    /* Ranged constraint of the form lower <= terms <= upper. */
+    lpNextToken(scanner, token);
+    CMR_CALL( lpReadTerms(reader, scanner, token, row, &numTerms, &hasConstant) );
+    reader->rowTypes[row] = 'R';
+  }
+  else
+    reader->rowTypes[row] = token->sense == '=' ? 'E' : (token->sense == '<' ? 'L' : 'G');
+  CMR_CALL( lpReadRightHandSide(reader, scanner, token) );
+
+  if (token->type == LP_TOKEN_OTHER && token->end - token->begin == 2)
+    return modelRaiseError(reader, "indicator constraints are not supported", NULL, NULL);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads a model in CPLEX LP format from \p buffer.
+ */
+
+static
+CMR_ERROR lpRead(
+  ModelReader* reader,  /**< Reader. */
+  const char* buffer,   /**< Buffer. */
+  const char* bufferEnd /**< End of \p buffer. */
+)
+{
+  LpScanner scanner = { buffer, bufferEnd, 1, true };
+  LpSection section = LP_SECTION_NONE;
+  LpToken token;
+  lpNextToken(&scanner, &token);
+  while (token.type != LP_TOKEN_END && section != LP_SECTION_END)
+  {
+    reader->line = scanner.line;
+    if (token.type == LP_TOKEN_NAME && token.lineStart)
+    {
+      LpSection newSection = lpSectionKeyword(&scanner, &token);
+      if (newSection != LP_SECTION_NONE)
+      {
+        section = newSection;
+        lpNextToken(&scanner, &token);
+        continue;
+      }
+    }
+
+    switch (section)
+    {
+    case LP_SECTION_NONE:
+      return modelRaiseError(reader, "expected objective sense instead of", token.begin, token.end);
+    case LP_SECTION_OBJECTIVE:
+      if (token.type == LP_TOKEN_NAME)
+      {
+        LpScanner saved = scanner;
+        LpToken next;
+        lpNextToken(&scanner, &next);
+        if (next.type != LP_TOKEN_COLON)
+        {
+          scanner = saved;
+          size_t column;
+          CMR_CALL( modelFindColumn(reader, token.begin, token.end, &column) );
+        }
+      }
+      else if (token.type == LP_TOKEN_LBRACKET)
+      {
+        /* The variables of quadratic terms, possibly followed by "/ 2", are ignored. */
+        while (token.type != LP_TOKEN_RBRACKET && token.type != LP_TOKEN_END)
+          lpNextToken(&scanner, &token);
+        LpScanner saved = scanner;
+        lpNextToken(&scanner, &token);
+        if (token.type == LP_TOKEN_NAME && token.end - token.begin == 1 && *token.begin == '/')
+          lpNextToken(&scanner, &token);
+        else
+          scanner = saved;
+      }
+      lpNextToken(&scanner, &token);
+      break;
+    case LP_SECTION_CONSTRAINTS:
+      CMR_CALL( lpReadConstraint(reader, &scanner, &token) );
+      break;
+    case LP_SECTION_BOUNDS:
+    case LP_SECTION_SEMIS:
+      if (token.type == LP_TOKEN_NAME && !modelTokenEquals(token.begin, token.end, "inf")
+        && !modelTokenEquals(token.begin, token.end, "infinity") && !modelTokenEquals(token.begin, token.end, "free"))
+      {
+        size_t column;
+        CMR_CALL( modelFindColumn(reader, token.begin, token.end, &column) );
+      }
+      lpNextToken(&scanner, &token);
+      break;
+    case LP_SECTION_INTEGERS:
+    case LP_SECTION_BINARIES:
+      if (token.type != LP_TOKEN_NAME)
+        return modelRaiseError(reader, "expected variable instead of", token.begin, token.end);
+      size_t column;
+      CMR_CALL( modelFindColumn(reader, token.begin, token.end, &column) );
+      reader->columnsInteger[column] = true;
+      lpNextToken(&scanner, &token);
+      break;
+    default:
+      lpNextToken(&scanner, &token);
+      break;
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmodelParamsInit(CMR_MODEL_PARAMS* params)
+{
+  assert(params);
+
+  params->format = CMR_MODEL_FORMAT_AUTO;
+  params->rows = CMR_MODEL_ROWS_ALL;
+  params->integerColumnsOnly = false;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns \c true if and only if \p fileName ends with \p suffix.
+ */
+
+static
+bool modelHasSuffix(
+  const char* fileName, /**< File name. */
+  const char* suffix    /**< Suffix in lower case. */
+)
+{
+  size_t length = strlen(fileName);
+  size_t suffixLength = strlen(suffix);
+
+  return length >= suffixLength && modelTokenEquals(&fileName[length - suffixLength], &fileName[length], suffix);
+}
+
+/**
+ * \brief Creates the matrix with the selected rows and columns of the coefficients read by \p reader.
+ *
+ * Coefficients of the same row and column are added up.
+ */
+
+static
+CMR_ERROR modelBuildMatrix(
+  ModelReader* reader,      /**< Reader. */
+  CMR_MODEL_PARAMS* params, /**< Parameters. */
+  CMR_DBLMAT** presult      /**< Pointer for storing the matrix. */
+)
+{
+  CMR* cmr = reader->cmr;
+
+  size_t* rowsMap = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsMap, reader->numRows + 1) );
+  size_t numRows = 0;
+  for (size_t row = 0; row < reader->numRows; ++row)
+  {
+    char type = reader->rowTypes[row];
+    bool selected = type != 'N' && (params->rows == CMR_MODEL_ROWS_ALL
+      || (params->rows == CMR_MODEL_ROWS_EQUALITIES && type == 'E')
+      || (params->rows == CMR_MODEL_ROWS_INEQUALITIES && type != 'E'));
+    rowsMap[row] = selected ? numRows++ : SIZE_MAX;
+  }
+  size_t* columnsMap = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsMap, reader->numColumns + 1) );
+  size_t numColumns = 0;
+  for (size_t column = 0; column < reader->numColumns; ++column)
+  {
+    bool selected = !params->integerColumnsOnly || reader->columnsInteger[column];
+    columnsMap[column] = selected ? numColumns++ : SIZE_MAX;
+  }
+  size_t numNonzeros = 0;
+  for (size_t i = 0; i < reader->numNonzeros; ++i)
+  {
+    if (rowsMap[reader->nonzeros[i].row] != SIZE_MAX && columnsMap[reader->nonzeros[i].column] != SIZE_MAX)
+      ++numNonzeros;
+  }
+
+  if (numRows > INT_MAX || numColumns > INT_MAX || numNonzeros > INT_MAX)
+  {
+    CMR_CALL( CMRfreeStackArray(cmr, &columnsMap) );
+    CMR_CALL( CMRfreeStackArray(cmr, &rowsMap) );
+    CMRraiseErrorMessage(cmr, "Constraint matrix of <%s> is too large.", reader->fileName);
+    return CMR_ERROR_INPUT;
+  }
+
+  /* Distribute the coefficients to the rows. */
+  CMR_DBLMAT* matrix = NULL;
+  CMR_CALL( CMRdblmatCreate(cmr, &matrix, (int) numRows, (int) numColumns, (int) numNonzeros) );
+  for (size_t row = 0; row <= numRows; ++row)
+    matrix->rowSlice[row] = 0;
+  for (size_t i = 0; i < reader->numNonzeros; ++i)
+  {
+    size_t row = rowsMap[reader->nonzeros[i].row];
+    if (row != SIZE_MAX && columnsMap[reader->nonzeros[i].column] != SIZE_MAX)
+      matrix->rowSlice[row + 1]++;
+  }
+  for (size_t row = 0; row < numRows; ++row)
+    matrix->rowSlice[row + 1] += matrix->rowSlice[row];
+  for (size_t i = 0; i < reader->numNonzeros; ++i)
+  {
+    size_t row = rowsMap[reader->nonzeros[i].row];
+    size_t column = columnsMap[reader->nonzeros[i].column];
+    if (row != SIZE_MAX && column != SIZE_MAX)
+    {
+      size_t entry = matrix->rowSlice[row]++;
+      matrix->entryColumns[entry] = column;
+      matrix->entryValues[entry] = reader->nonzeros[i].value;
+    }
+  }
+  for (size_t row = numRows; row > 0; --row)
+    matrix->rowSlice[row] = matrix->rowSlice[row - 1];
+  matrix->rowSlice[0] = 0;
+
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsMap) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsMap) );
+
+  /* Duplicates are merged below, so the consistency check of CMRdblmatSortNonzeros does not apply yet. */
+  CMR_CALL( CMRmatrixSortNonzeros(cmr, (CMR_MATRIX*) matrix, sizeof(double)) );
+
+  /* Add up coefficients of the same row and column and remove resulting zeros. */
+  size_t entry = 0;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    matrix->rowSlice[row] = entry;
+    for (size_t e = first; e < beyond; )
+    {
+      size_t column = matrix->entryColumns[e];
+      double value = 0.0;
+      for (; e < beyond && matrix->entryColumns[e] == column; ++e)
+        value += matrix->entryValues[e];
+      if (value != 0.0)
+      {
+        matrix->entryColumns[entry] = column;
+        matrix->entryValues[entry] = value;
+        ++entry;
+      }
+    }
+  }
+  matrix->rowSlice[numRows] = entry;
+  matrix->numNonzeros = entry;
+  CMRconsistencyAssert( CMRdblmatConsistency(matrix) );
+
+  *presult = matrix;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads the constraint matrix of the model in file \p fileName.
+ */
+
+static
+CMR_ERROR modelReadFile(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  const char* fileName,     /**< File name to read from. */
+  const char* stdinName,    /**< If not \c NULL, indicates which file name represents stdin. */
+  CMR_MODEL_PARAMS* params, /**< Parameters (may be \c NULL for defaults). */
+  CMR_DBLMAT** presult      /**< Pointer for storing the matrix. */
+)
+{
+  assert(cmr);
+  assert(fileName);
+  assert(presult);
+  assert(!*presult);
+
+  CMR_MODEL_PARAMS defaultParams;
+  if (!params)
+  {
+    CMR_CALL( CMRmodelParamsInit(&defaultParams) );
+    params = &defaultParams;
+  }
+
+  CMR_MODEL_FORMAT format = params->format;
+  if (format == CMR_MODEL_FORMAT_AUTO)
+  {
+    bool isStdin = stdinName && !strcmp(fileName, stdinName);
+    format = (!isStdin && (modelHasSuffix(fileName, ".lp") || modelHasSuffix(fileName, ".lp.gz")
+      || modelHasSuffix(fileName, ".lp.zst"))) ? CMR_MODEL_FORMAT_LP : CMR_MODEL_FORMAT_MPS;
+  }
+
+  char* buffer = NULL;
+  size_t length = 0;
+  CMR_CALL( CMRtextReadFileContents(cmr, fileName, stdinName, &buffer, &length) );
+
+  ModelReader reader;
+  reader.cmr = cmr;
+  reader.fileName = fileName;
+  reader.line = 0;
+  reader.rowNames = NULL;
+  reader.columnNames = NULL;
+  CMR_CALL( CMRlinearhashtableArrayCreate(cmr, &reader.rowNames, 1024, 16 * 1024) );
+  CMR_CALL( CMRlinearhashtableArrayCreate(cmr, &reader.columnNames, 1024, 16 * 1024) );
+  reader.numRows = 0;
+  reader.memRows = 256;
+  reader.rowTypes = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &reader.rowTypes, reader.memRows) );
+  reader.numColumns = 0;
+  reader.memColumns = 256;
+  reader.columnsInteger = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &reader.columnsInteger, reader.memColumns) );
+  reader.numNonzeros = 0;
+  reader.memNonzeros = 1024;
+  reader.nonzeros = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &reader.nonzeros, reader.memNonzeros) );
+
+  CMR_ERROR error = format == CMR_MODEL_FORMAT_LP ? lpRead(&reader, buffer, buffer + length)
+    : mpsRead(&reader, buffer, buffer + length);
+  if (!error)
+    error = modelBuildMatrix(&reader, params, presult);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &reader.nonzeros) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &reader.columnsInteger) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &reader.rowTypes) );
+  CMR_CALL( CMRlinearhashtableArrayFree(cmr, &reader.columnNames) );
+  CMR_CALL( CMRlinearhashtableArrayFree(cmr, &reader.rowNames) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &buffer) );
+
+  return error;
+}
+
+CMR_ERROR CMRdblmatCreateFromModelFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_MODEL_PARAMS* params,
+  CMR_DBLMAT** presult)
+{
+  return modelReadFile(cmr, fileName, stdinName, params, presult);
+}
+
+CMR_ERROR CMRintmatCreateFromModelFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_MODEL_PARAMS* params,
+  CMR_INTMAT** presult)
+{
+  assert(presult);
+  assert(!*presult);
+
+  CMR_DBLMAT* matrix = NULL;
+  CMR_CALL( modelReadFile(cmr, fileName, stdinName, params, &matrix) );
+
+  for (size_t entry = 0; entry < matrix->numNonzeros; ++entry)
+  {
+    double value = matrix->entryValues[entry];
+    if (value != floor(value) || value < INT_MIN || value > INT_MAX)
+    {
+      CMRraiseErrorMessage(cmr, "Coefficient %g of <%s> is not an int.", value, fileName);
+      CMR_CALL( CMRdblmatFree(cmr, &matrix) );
+      return CMR_ERROR_INPUT;
+    }
+  }
+
+  CMR_CALL( CMRintmatCreate(cmr, presult, (int) matrix->numRows, (int) matrix->numColumns,
+    (int) matrix->numNonzeros) );
+  CMR_INTMAT* result = *presult;
+  for (size_t row = 0; row <= matrix->numRows; ++row)
+    result->rowSlice[row] = matrix->rowSlice[row];
+  for (size_t entry = 0; entry < matrix->numNonzeros; ++entry)
+  {
+    result->entryColumns[entry] = matrix->entryColumns[entry];
+    result->entryValues[entry] = (int) matrix->entryValues[entry];
+  }
+
+  CMR_CALL( CMRdblmatFree(cmr, &matrix) );
+
+  return CMR_OKAY;
+}
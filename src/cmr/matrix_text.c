@@ -0,0 +1,1994 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/matrix.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <math.h>
+
+#include "env_internal.h"
+#include "matrix_internal.h"
+#include "text_internal.h"
+#include "threads.h"
+
+#if defined(CMR_WITH_ZLIB)
+#include <zlib.h>
+#endif /* CMR_WITH_ZLIB */
+
+#if defined(CMR_WITH_ZSTD)
+#include <zstd.h>
+#endif /* CMR_WITH_ZSTD */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TEXT_LOCK(stream) flockfile(stream)
+#define TEXT_UNLOCK(stream) funlockfile(stream)
+#define TEXT_GETC(stream) getc_unlocked(stream)
+#else
+#define TEXT_LOCK(stream)
+#define TEXT_UNLOCK(stream)
+#define TEXT_GETC(stream) getc(stream)
+#endif /* __unix__ || __APPLE__ */
+
+#define TEXT_PARALLEL_THRESHOLD (1UL << 20) /**< Minimum number of buffered bytes for parsing in parallel. */
+#define TEXT_MAX_REPORTED_TOKEN 16          /**< Maximum length of an unexpected token in error messages. */
+#define TEXT_COMPRESSED_CHUNK (1UL << 20)   /**< Number of compressed bytes that are read at once. */
+
+/**
+ * \brief Types of the values of the matrix to be read.
+ */
+
+typedef enum
+{
+  TEXT_VALUES_CHAR = 1,   /**< Values are stored as \c char. */
+  TEXT_VALUES_INT = 2,    /**< Values are stored as \c int. */
+  TEXT_VALUES_DOUBLE = 3  /**< Values are stored as \c double. */
+} TextValueType;
+
+/**
+ * \brief Nonzero of a matrix that is being read.
+ */
+
+typedef struct
+{
+  size_t row;     /**< \brief Row of the nonzero. */
+  size_t column;  /**< \brief Column of the nonzero. */
+  double value;   /**< \brief Value of the nonzero; integer values are represented exactly. */
+} TextNonzero;
+
+/**
+ * \brief Scanner for whitespace-separated tokens.
+ *
+ * The input is either completely buffered in memory or it is a stream that is read character by character such that
+ * nothing beyond the last token is consumed. Buffered input must be followed by a null character.
+ */
+
+typedef struct
+{
+  const char* current;  /**< \brief Next character of the buffered input. */
+  const char* end;      /**< \brief End of the buffered input. */
+  FILE* stream;         /**< \brief Stream to read from, or \c NULL if the input is buffered. */
+  char* token;          /**< \brief Buffer for the last token read from \ref stream. */
+  size_t memToken;      /**< \brief Memory allocated for \ref token. */
+} TextScanner;
+
+/**
+ * \brief Scans the next token.
+ *
+ * Sets \p *pbegin and \p *pend to the range of the token, which is empty at the end of the input. The character at
+ * \p *pend is either a whitespace or a null character.
+ */
+
+static inline
+CMR_ERROR textNextToken(
+  CMR* cmr,               /**< \ref CMR environment. */
+  TextScanner* scanner,   /**< Scanner. */
+  const char** pbegin,    /**< Pointer for storing the beginning of the token. */
+  const char** pend       /**< Pointer for storing the end of the token. */
+)
+{
+  if (!scanner->stream)
+  {
+    const char* p = scanner->current;
+    while (p < scanner->end && CMRtextIsSpace(*p))
+      ++p;
+    *pbegin = p;
+    while (p < scanner->end && !CMRtextIsSpace(*p))
+      ++p;
+    *pend = p;
+    scanner->current = p;
+    return CMR_OKAY;
+  }
+
+  int c;
+  do
+    c = TEXT_GETC(scanner->stream);
+  while (c != EOF && CMRtextIsSpace((char) c));
+
+  size_t length = 0;
+  while (c != EOF && !CMRtextIsSpace((char) c))
+  {
+    if (length + 1 >= scanner->memToken)
+    {
+      scanner->memToken *= 2;
+      CMR_CALL( CMRreallocBlockArray(cmr, &scanner->token, scanner->memToken) );
+    }
+    scanner->token[length++] = (char) c;
+    c = TEXT_GETC(scanner->stream);
+  }
+
+  /* Like fscanf, we leave the delimiter in the stream. */
+  if (c != EOF)
+    ungetc(c, scanner->stream);
+  scanner->token[length] = '\0';
+  *pbegin = scanner->token;
+  *pend = &scanner->token[length];
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Parses the token from \p begin to \p end as a nonnegative integer.
+ */
+
+static inline
+bool textParseSize(
+  const char* begin,  /**< Beginning of the token. */
+  const char* end,    /**< End of the token. */
+  size_t* pvalue      /**< Pointer for storing the value. */
+)
+{
+  if (begin < end && *begin == '+')
+    ++begin;
+  if (begin == end)
+    return false;
+
+  size_t value = 0;
+  for (; begin < end; ++begin)
+  {
+    size_t digit = (size_t) (unsigned char) *begin - '0';
+    if (digit > 9 || value > (SIZE_MAX - digit) / 10)
+      return false;
+    value = 10 * value + digit;
+  }
+  *pvalue = value;
+
+  return true;
+}
+
+/**
+ * \brief Parses the token from \p begin to \p end as an \c int.
+ */
+
+static inline
+bool textParseInt(
+  const char* begin,  /**< Beginning of the token. */
+  const char* end,    /**< End of the token. */
+  int* pvalue         /**< Pointer for storing the value. */
+)
+{
+  bool negative = false;
+  if (begin < end && (*begin == '+' || *begin == '-'))
+    negative = *begin++ == '-';
+  if (begin == end)
+    return false;
+
+  long long bound = negative ? -(long long) INT_MIN : INT_MAX;
+  long long value = 0;
+  for (; begin < end; ++begin)
+  {
+    long long digit = (long long) (unsigned char) *begin - '0';
+    if (digit < 0 || digit > 9)
+      return false;
+    value = 10 * value + digit;
+    if (value > bound)
+      return false;
+  }
+  *pvalue = (int) (negative ? -value : value);
+
+  return true;
+}
+
+/**
+ * \brief Scans the next token as a nonnegative integer.
+ */
+
+static inline
+CMR_ERROR textScanSize(
+  CMR* cmr,             /**< \ref CMR environment. */
+  TextScanner* scanner, /**< Scanner. */
+  size_t* pvalue,       /**< Pointer for storing the value. */
+  bool* psuccess        /**< Pointer for storing whether a value was read. */
+)
+{
+  const char* begin;
+  const char* end;
+  CMR_CALL( textNextToken(cmr, scanner, &begin, &end) );
+  *psuccess = textParseSize(begin, end, pvalue);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Parses the token from \p begin to \p end as a \c double or as an \c int.
+ */
+
+static inline
+bool textParseValue(
+  const char* begin,  /**< Beginning of the token. */
+  const char* end,    /**< End of the token. */
+  bool isDouble,      /**< Whether to parse a \c double instead of an \c int. */
+  double* pvalue      /**< Pointer for storing the value. */
+)
+{
+  if (isDouble)
+    return CMRtextParseDouble(begin, end, pvalue);
+
+  int value;
+  if (!textParseInt(begin, end, &value))
+    return false;
+  *pvalue = value;
+  return true;
+}
+
+/**
+ * \brief Scans the next token as a \c double or as an \c int.
+ */
+
+static inline
+CMR_ERROR textScanValue(
+  CMR* cmr,             /**< \ref CMR environment. */
+  TextScanner* scanner, /**< Scanner. */
+  bool isDouble,        /**< Whether to parse a \c double instead of an \c int. */
+  double* pvalue,       /**< Pointer for storing the value. */
+  bool* psuccess        /**< Pointer for storing whether a value was read. */
+)
+{
+  const char* begin;
+  const char* end;
+  CMR_CALL( textNextToken(cmr, scanner, &begin, &end) );
+  *psuccess = textParseValue(begin, end, isDouble, pvalue);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the number of workers for parsing the buffered input of \p scanner.
+ */
+
+static
+size_t textNumParallelWorkers(
+  CMR* cmr,             /**< \ref CMR environment. */
+  TextScanner* scanner  /**< Scanner. */
+)
+{
+  if (scanner->stream || (size_t) (scanner->end - scanner->current) < TEXT_PARALLEL_THRESHOLD)
+    return 1;
+
+  return CMRthreadsNumWorkers(cmr, (size_t) (scanner->end - scanner->current) / (TEXT_PARALLEL_THRESHOLD / 4));
+}
+
+/**
+ * \brief Data shared by the workers that parse chunks of a buffered input.
+ *
+ * Every chunk begins at a whitespace character (or at the beginning of the input) and a token belongs to the chunk
+ * that contains its first character.
+ */
+
+typedef struct
+{
+  const char** boundaries;  /**< \brief Array with the \c numChunks + 1 boundaries of the chunks. */
+  const char* end;          /**< \brief End of the buffered input. */
+  size_t* chunkTokens;      /**< \brief Array with the number of tokens before each chunk. */
+  bool isDouble;            /**< \brief Whether values are parsed as \c double. */
+  size_t numRows;           /**< \brief Number of rows of the matrix. */
+  size_t numColumns;        /**< \brief Number of columns of the matrix. */
+  TextNonzero* nonzeros;    /**< \brief Array for the nonzeros of a sparse input, indexed by their position. */
+  TextNonzero** chunkNonzeros;  /**< \brief Array with the nonzeros of each chunk of a dense input. */
+  size_t* chunkNumNonzeros;     /**< \brief Array with the number of nonzeros of each chunk of a dense input. */
+  bool failed;              /**< \brief Whether parsing failed; the input is then parsed sequentially. */
+} TextParallelData;
+
+/**
+ * \brief Worker that counts the tokens of one chunk.
+ */
+
+static
+CMR_ERROR textCountTokensWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker, which is the index of its chunk. */
+  void* data      /**< Pointer to the \ref TextParallelData. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  TextParallelData* parallel = (TextParallelData*) data;
+  const char* end = parallel->boundaries[worker + 1];
+  size_t count = 0;
+  bool inToken = false;
+  for (const char* p = parallel->boundaries[worker]; p < end; ++p)
+  {
+    bool isSpace = CMRtextIsSpace(*p);
+    count += !isSpace && !inToken;
+    inToken = !isSpace;
+  }
+  parallel->chunkTokens[worker] = count;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Worker that parses the nonzeros of a sparse matrix that start in one chunk.
+ *
+ * The last nonzero may extend into the next chunk. Nonzeros are stored at their position in the input.
+ */
+
+static
+CMR_ERROR textParseSparseWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker, which is the index of its chunk. */
+  void* data      /**< Pointer to the \ref TextParallelData. */
+)
+{
+  TextParallelData* parallel = (TextParallelData*) data;
+  const char* chunkEnd = parallel->boundaries[worker + 1];
+  TextScanner scanner = { parallel->boundaries[worker], parallel->end, NULL, NULL, 0 };
+  const char* begin;
+  const char* end;
+
+  /* Skip the tokens of a nonzero that started in the previous chunk. */
+  size_t token = parallel->chunkTokens[worker];
+  for (; token % 3; ++token)
+    CMR_CALL( textNextToken(cmr, &scanner, &begin, &end) );
+
+  while (!CMRatomicLoadFlag(&parallel->failed))
+  {
+    while (scanner.current < chunkEnd && CMRtextIsSpace(*scanner.current))
+      ++scanner.current;
+    if (scanner.current >= chunkEnd)
+      break;
+
+    size_t row, column;
+    double value;
+    bool success;
+    CMR_CALL( textScanSize(cmr, &scanner, &row, &success) );
+    if (success)
+      CMR_CALL( textScanSize(cmr, &scanner, &column, &success) );
+    if (success)
+    {
+      CMR_CALL( textNextToken(cmr, &scanner, &begin, &end) );
+      success = textParseValue(begin, end, parallel->isDouble, &value);
+    }
+    if (!success || row == 0 || column == 0 || row > parallel->numRows || column > parallel->numColumns)
+    {
+      CMRatomicStoreFlag(&parallel->failed, true);
+      break;
+    }
+
+    TextNonzero* nonzero = &parallel->nonzeros[token / 3];
+    nonzero->row = row - 1;
+    nonzero->column = column - 1;
+    nonzero->value = value;
+    token += 3;
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Worker that parses the entries of a dense matrix of one chunk.
+ */
+
+static
+CMR_ERROR textParseDenseWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker, which is the index of its chunk. */
+  void* data      /**< Pointer to the \ref TextParallelData. */
+)
+{
+  TextParallelData* parallel = (TextParallelData*) data;
+  TextScanner scanner = { parallel->boundaries[worker], parallel->boundaries[worker + 1], NULL, NULL, 0 };
+  size_t token = parallel->chunkTokens[worker];
+  size_t numTokens = parallel->chunkTokens[worker + 1] - token;
+
+  size_t memNonzeros = numTokens < 256 ? numTokens + 1 : 256;
+  size_t numNonzeros = 0;
+  TextNonzero* nonzeros = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &nonzeros, memNonzeros) );
+  for (size_t i = 0; i < numTokens && !CMRatomicLoadFlag(&parallel->failed); ++i, ++token)
+  {
+    const char* begin;
+    const char* end;
+    double value;
+    CMR_CALL( textNextToken(cmr, &scanner, &begin, &end) );
+    if (!textParseValue(begin, end, parallel->isDouble, &value))
+    {
+      CMRatomicStoreFlag(&parallel->failed, true);
+      break;
+    }
+    if (value == 0.0)
+      continue;
+
+    if (numNonzeros == memNonzeros)
+    {
+      memNonzeros *= 2;
+      CMR_CALL( CMRreallocBlockArray(cmr, &nonzeros, memNonzeros) );
+    }
+    nonzeros[numNonzeros].row = token / parallel->numColumns;
+    nonzeros[numNonzeros].column = token % parallel->numColumns;
+    nonzeros[numNonzeros].value = value;
+    ++numNonzeros;
+  }
+
+  parallel->chunkNonzeros[worker] = nonzeros;
+  parallel->chunkNumNonzeros[worker] = numNonzeros;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Parses the rest of the buffered input of \p scanner in parallel.
+ *
+ * For sparse matrices, \p nonzeros must have space for \p numTokens / 3 nonzeros and \p *pnumNonzeros is set to the
+ * number of those whose value is nonzero. For dense matrices, \p *pnonzeros is allocated.
+ *
+ * If the input does not consist of exactly \p numTokens valid tokens, \p *psuccess is set to \c false and the input
+ * shall be parsed sequentially in order to report the error.
+ */
+
+static
+CMR_ERROR textParseParallel(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextScanner* scanner,     /**< Scanner with buffered input. */
+  size_t numWorkers,        /**< Number of workers. */
+  bool isDense,             /**< Whether the input is a dense matrix. */
+  bool isDouble,            /**< Whether values are parsed as \c double. */
+  size_t numRows,           /**< Number of rows of the matrix. */
+  size_t numColumns,        /**< Number of columns of the matrix. */
+  size_t numTokens,         /**< Expected number of tokens. */
+  TextNonzero** pnonzeros,  /**< Pointer to the array of nonzeros. */
+  size_t* pnumNonzeros,     /**< Pointer for storing the number of nonzeros. */
+  bool* psuccess            /**< Pointer for storing whether the input was parsed. */
+)
+{
+  assert(numWorkers > 1);
+
+  TextParallelData parallel;
+  parallel.end = scanner->end;
+  parallel.isDouble = isDouble;
+  parallel.numRows = numRows;
+  parallel.numColumns = numColumns;
+  parallel.nonzeros = *pnonzeros;
+  parallel.chunkNonzeros = NULL;
+  parallel.chunkNumNonzeros = NULL;
+  parallel.failed = false;
+  parallel.boundaries = NULL;
+  parallel.chunkTokens = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &parallel.boundaries, numWorkers + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &parallel.chunkTokens, numWorkers + 1) );
+
+  /* Split the input at whitespace characters. */
+  size_t length = (size_t) (scanner->end - scanner->current);
+  parallel.boundaries[0] = scanner->current;
+  for (size_t w = 1; w < numWorkers; ++w)
+  {
+    const char* boundary = scanner->current + (length / numWorkers) * w;
+    if (boundary < parallel.boundaries[w-1])
+      boundary = parallel.boundaries[w-1];
+    while (boundary < scanner->end && !CMRtextIsSpace(*boundary))
+      ++boundary;
+    parallel.boundaries[w] = boundary;
+  }
+  parallel.boundaries[numWorkers] = scanner->end;
+
+  CMR_CALL( CMRthreadsRun(cmr, numWorkers, textCountTokensWorker, &parallel) );
+
+  /* Turn the numbers of tokens into the number of tokens before each chunk. */
+  size_t totalTokens = 0;
+  for (size_t w = 0; w < numWorkers; ++w)
+  {
+    size_t count = parallel.chunkTokens[w];
+    parallel.chunkTokens[w] = totalTokens;
+    totalTokens += count;
+  }
+  parallel.chunkTokens[numWorkers] = totalTokens;
+
+  *psuccess = false;
+  if (totalTokens == numTokens)
+  {
+    if (isDense)
+    {
+      CMR_CALL( CMRallocBlockArray(cmr, &parallel.chunkNonzeros, numWorkers) );
+      CMR_CALL( CMRallocBlockArray(cmr, &parallel.chunkNumNonzeros, numWorkers) );
+      CMR_CALL( CMRthreadsRun(cmr, numWorkers, textParseDenseWorker, &parallel) );
+
+      /* Merge the nonzeros of the chunks, which are already ordered. */
+      if (!parallel.failed)
+      {
+        size_t numNonzeros = 0;
+        for (size_t w = 0; w < numWorkers; ++w)
+          numNonzeros += parallel.chunkNumNonzeros[w];
+        CMR_CALL( CMRallocBlockArray(cmr, pnonzeros, numNonzeros > 0 ? numNonzeros : 1) );
+        TextNonzero* nonzeros = *pnonzeros;
+        for (size_t w = 0; w < numWorkers; ++w)
+        {
+          memcpy(nonzeros, parallel.chunkNonzeros[w], parallel.chunkNumNonzeros[w] * sizeof(TextNonzero));
+          nonzeros += parallel.chunkNumNonzeros[w];
+        }
+        *pnumNonzeros = numNonzeros;
+      }
+
+      for (size_t w = 0; w < numWorkers; ++w)
+        CMR_CALL( CMRfreeBlockArray(cmr, &parallel.chunkNonzeros[w]) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &parallel.chunkNumNonzeros) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &parallel.chunkNonzeros) );
+    }
+    else
+    {
+      CMR_CALL( CMRthreadsRun(cmr, numWorkers, textParseSparseWorker, &parallel) );
+
+      /* Remove explicit zeros. */
+      if (!parallel.failed)
+      {
+        TextNonzero* nonzeros = *pnonzeros;
+        size_t numNonzeros = 0;
+        for (size_t i = 0; i < numTokens / 3; ++i)
+        {
+          if (nonzeros[i].value != 0.0)
+            nonzeros[numNonzeros++] = nonzeros[i];
+        }
+        *pnumNonzeros = numNonzeros;
+      }
+    }
+
+    if (!parallel.failed)
+    {
+      scanner->current = scanner->end;
+      *psuccess = true;
+    }
+  }
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &parallel.chunkTokens) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &parallel.boundaries) );
+
+  return CMR_OKAY;
+}
+
+static
+int textCompareNonzeros(const void* pa, const void* pb)
+{
+  const TextNonzero* a = (const TextNonzero*) pa;
+  const TextNonzero* b = (const TextNonzero*) pb;
+  if (a->row != b->row)
+    return a->row < b->row ? -1 : +1;
+  if (a->column != b->column)
+    return a->column < b->column ? -1 : +1;
+  return 0;
+}
+
+/**
+ * \brief Distributes \p source to \p target stably by rows or by columns.
+ */
+
+static
+void textDistributeNonzeros(
+  size_t numNonzeros,   /**< Number of nonzeros. */
+  TextNonzero* source,  /**< Array of nonzeros to distribute. */
+  TextNonzero* target,  /**< Array for the distributed nonzeros. */
+  size_t* starts,       /**< Array with the numbers of nonzeros in each row or column; is overwritten. */
+  size_t numStarts,     /**< Number of rows or columns. */
+  bool byRow            /**< Whether to distribute by rows instead of by columns. */
+)
+{
+  size_t start = 0;
+  for (size_t i = 0; i < numStarts; ++i)
+  {
+    size_t count = starts[i];
+    starts[i] = start;
+    start += count;
+  }
+  for (size_t entry = 0; entry < numNonzeros; ++entry)
+  {
+    size_t index = byRow ? source[entry].row : source[entry].column;
+    target[starts[index]++] = source[entry];
+  }
+}
+
+/**
+ * \brief Sorts \p nonzeros by row and then by column via two counting sorts.
+ */
+
+static
+CMR_ERROR textSortNonzeros(
+  CMR* cmr,               /**< \ref CMR environment. */
+  size_t numRows,         /**< Number of rows. */
+  size_t numColumns,      /**< Number of columns. */
+  size_t numNonzeros,     /**< Number of nonzeros. */
+  TextNonzero* nonzeros   /**< Array of nonzeros. */
+)
+{
+  TextNonzero* sorted = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &sorted, numNonzeros) );
+  size_t* starts = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &starts, (numRows > numColumns ? numRows : numColumns) + 1) );
+
+  for (size_t column = 0; column < numColumns; ++column)
+    starts[column] = 0;
+  for (size_t entry = 0; entry < numNonzeros; ++entry)
+    ++starts[nonzeros[entry].column];
+  textDistributeNonzeros(numNonzeros, nonzeros, sorted, starts, numColumns, false);
+
+  for (size_t row = 0; row < numRows; ++row)
+    starts[row] = 0;
+  for (size_t entry = 0; entry < numNonzeros; ++entry)
+    ++starts[sorted[entry].row];
+  textDistributeNonzeros(numNonzeros, sorted, nonzeros, starts, numRows, true);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &starts) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &sorted) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Creates a matrix with values of type \p valueType.
+ */
+
+static
+CMR_ERROR textCreateMatrix(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextValueType valueType,  /**< Type of the values. */
+  size_t numRows,           /**< Number of rows. */
+  size_t numColumns,        /**< Number of columns. */
+  size_t numNonzeros,       /**< Number of nonzeros. */
+  CMR_MATRIX** presult      /**< Pointer for storing the matrix. */
+)
+{
+  if (valueType == TEXT_VALUES_CHAR)
+    return CMRchrmatCreate(cmr, (CMR_CHRMAT**) presult, numRows, numColumns, numNonzeros);
+  else if (valueType == TEXT_VALUES_INT)
+    return CMRintmatCreate(cmr, (CMR_INTMAT**) presult, numRows, numColumns, numNonzeros);
+  else
+    return CMRdblmatCreate(cmr, (CMR_DBLMAT**) presult, numRows, numColumns, numNonzeros);
+}
+
+/**
+ * \brief Frees a matrix with values of type \p valueType.
+ */
+
+static
+CMR_ERROR textFreeMatrix(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextValueType valueType,  /**< Type of the values. */
+  CMR_MATRIX** pmatrix      /**< Pointer to the matrix. */
+)
+{
+  if (valueType == TEXT_VALUES_CHAR)
+    return CMRchrmatFree(cmr, (CMR_CHRMAT**) pmatrix);
+  else if (valueType == TEXT_VALUES_INT)
+    return CMRintmatFree(cmr, (CMR_INTMAT**) pmatrix);
+  else
+    return CMRdblmatFree(cmr, (CMR_DBLMAT**) pmatrix);
+}
+
+/**
+ * \brief Creates a matrix from \p nonzeros, which must be sorted by row and then by column.
+ *
+ * Returns \ref CMR_ERROR_INPUT if a nonzero appears twice.
+ */
+
+static
+CMR_ERROR textBuildMatrix(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextValueType valueType,  /**< Type of the values. */
+  size_t numRows,           /**< Number of rows. */
+  size_t numColumns,        /**< Number of columns. */
+  size_t numNonzeros,       /**< Number of nonzeros. */
+  TextNonzero* nonzeros,    /**< Sorted array of nonzeros. */
+  CMR_MATRIX** presult      /**< Pointer for storing the matrix. */
+)
+{
+  CMR_CALL( textCreateMatrix(cmr, valueType, numRows, numColumns, numNonzeros, presult) );
+  CMR_MATRIX* result = *presult;
+
+  size_t row = 0;
+  for (size_t entry = 0; entry < numNonzeros; ++entry)
+  {
+    TextNonzero* nonzero = &nonzeros[entry];
+    if (entry > 0 && nonzero->row == nonzeros[entry-1].row && nonzero->column == nonzeros[entry-1].column)
+    {
+      CMRraiseErrorMessage(cmr, "Duplicate nonzero at row %zu and column %zu.", nonzero->row, nonzero->column);
+      CMR_CALL( textFreeMatrix(cmr, valueType, presult) );
+      return CMR_ERROR_INPUT;
+    }
+    while (row <= nonzero->row)
+      result->rowSlice[row++] = entry;
+    result->entryColumns[entry] = nonzero->column;
+    if (valueType == TEXT_VALUES_CHAR)
+      ((char*) result->entryValues)[entry] = (char) (int) nonzero->value;
+    else if (valueType == TEXT_VALUES_INT)
+      ((int*) result->entryValues)[entry] = (int) nonzero->value;
+    else
+      ((double*) result->entryValues)[entry] = nonzero->value;
+  }
+  while (row <= numRows)
+    result->rowSlice[row++] = numNonzeros;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads a matrix in \ref sparse-matrix format from \p scanner.
+ */
+
+static
+CMR_ERROR textReadSparse(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextScanner* scanner,     /**< Scanner. */
+  TextValueType valueType,  /**< Type of the values. */
+  CMR_MATRIX** presult      /**< Pointer for storing the matrix. */
+)
+{
+  size_t numRows, numColumns, numNonzeros;
+  bool success;
+  CMR_CALL( textScanSize(cmr, scanner, &numRows, &success) );
+  if (success)
+    CMR_CALL( textScanSize(cmr, scanner, &numColumns, &success) );
+  if (success)
+    CMR_CALL( textScanSize(cmr, scanner, &numNonzeros, &success) );
+  if (!success)
+  {
+    CMRraiseErrorMessage(cmr, "Could not read number of rows, columns and nonzeros.");
+    return CMR_ERROR_INPUT;
+  }
+
+  /* Read all nonzeros. */
+
+  bool isDouble = valueType == TEXT_VALUES_DOUBLE;
+  TextNonzero* nonzeros = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &nonzeros, numNonzeros > 0 ? numNonzeros : 1) );
+  size_t numWorkers = textNumParallelWorkers(cmr, scanner);
+  success = false;
+  if (numWorkers > 1 && numNonzeros <= SIZE_MAX / 3)
+  {
+    size_t numParsed = 0;
+    CMR_CALL( textParseParallel(cmr, scanner, numWorkers, false, isDouble, numRows, numColumns, 3 * numNonzeros,
+      &nonzeros, &numParsed, &success) );
+    if (success)
+      numNonzeros = numParsed;
+  }
+
+  if (!success)
+  {
+    size_t entry = 0;
+    for (size_t i = 0; i < numNonzeros; ++i)
+    {
+      size_t row, column;
+      double value;
+      bool readIndices;
+      CMR_CALL( textScanSize(cmr, scanner, &row, &readIndices) );
+      if (readIndices)
+        CMR_CALL( textScanSize(cmr, scanner, &column, &readIndices) );
+      bool readValue = false;
+      if (readIndices)
+        CMR_CALL( textScanValue(cmr, scanner, isDouble, &value, &readValue) );
+      if (!readValue || row == 0 || column == 0 || row > numRows || column > numColumns)
+      {
+        CMR_CALL( CMRfreeBlockArray(cmr, &nonzeros) );
+        if (readIndices && !readValue)
+        {
+          CMRraiseErrorMessage(cmr, "Could not read %s value of nonzero #%zu.", isDouble ? "a double" : "an integer",
+            entry);
+        }
+        else
+          CMRraiseErrorMessage(cmr, "Could not read nonzero #%zu.", entry);
+        return CMR_ERROR_INPUT;
+      }
+      if (value != 0.0)
+      {
+        nonzeros[entry].row = row - 1;
+        nonzeros[entry].column = column - 1;
+        nonzeros[entry].value = value;
+        ++entry;
+      }
+    }
+    numNonzeros = entry;
+  }
+
+  /* We sort all nonzeros by row and then by column unless they are already sorted. */
+  size_t entry = 1;
+  while (entry < numNonzeros && textCompareNonzeros(&nonzeros[entry-1], &nonzeros[entry]) <= 0)
+    ++entry;
+  if (entry < numNonzeros)
+    CMR_CALL( textSortNonzeros(cmr, numRows, numColumns, numNonzeros, nonzeros) );
+
+  CMR_ERROR error = textBuildMatrix(cmr, valueType, numRows, numColumns, numNonzeros, nonzeros, presult);
+  CMR_CALL( CMRfreeBlockArray(cmr, &nonzeros) );
+
+  return error;
+}
+
+/**
+ * \brief Reads a matrix in \ref dense-matrix format from \p scanner.
+ */
+
+static
+CMR_ERROR textReadDense(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextScanner* scanner,     /**< Scanner. */
+  TextValueType valueType,  /**< Type of the values. */
+  CMR_MATRIX** presult      /**< Pointer for storing the matrix. */
+)
+{
+  size_t numRows, numColumns;
+  bool success;
+  CMR_CALL( textScanSize(cmr, scanner, &numRows, &success) );
+  if (success)
+    CMR_CALL( textScanSize(cmr, scanner, &numColumns, &success) );
+  if (!success)
+  {
+    CMRraiseErrorMessage(cmr, "Could not read number of rows and columns.");
+    return CMR_ERROR_INPUT;
+  }
+
+  /* Char matrices are read like double matrices, which allows for entries such as "1.0". */
+  bool isDouble = valueType != TEXT_VALUES_INT;
+  TextNonzero* nonzeros = NULL;
+  size_t numNonzeros = 0;
+  size_t numWorkers = textNumParallelWorkers(cmr, scanner);
+  success = false;
+  if (numWorkers > 1 && numColumns > 0 && numRows <= SIZE_MAX / numColumns)
+  {
+    CMR_CALL( textParseParallel(cmr, scanner, numWorkers, true, isDouble, numRows, numColumns, numRows * numColumns,
+      &nonzeros, &numNonzeros, &success) );
+  }
+
+  if (!success)
+  {
+    size_t memNonzeros = (numRows * numColumns < 256) ? numRows * numColumns + 1 : 256;
+    CMR_CALL( CMRallocBlockArray(cmr, &nonzeros, memNonzeros) );
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        double value;
+        CMR_CALL( textScanValue(cmr, scanner, isDouble, &value, &success) );
+        if (!success)
+        {
+          CMR_CALL( CMRfreeBlockArray(cmr, &nonzeros) );
+          CMRraiseErrorMessage(cmr, "Could not read matrix entry in row %zu and column %zu.", row, column);
+          return CMR_ERROR_INPUT;
+        }
+
+        if (value == 0.0)
+          continue;
+
+        if (numNonzeros == memNonzeros)
+        {
+          memNonzeros *= 2;
+          CMR_CALL( CMRreallocBlockArray(cmr, &nonzeros, memNonzeros) );
+        }
+        nonzeros[numNonzeros].row = row;
+        nonzeros[numNonzeros].column = column;
+        nonzeros[numNonzeros].value = value;
+        ++numNonzeros;
+      }
+    }
+  }
+
+  CMR_ERROR error = textBuildMatrix(cmr, valueType, numRows, numColumns, numNonzeros, nonzeros, presult);
+  CMR_CALL( CMRfreeBlockArray(cmr, &nonzeros) );
+
+  return error;
+}
+
+/**
+ * \brief Reads the remaining contents of \p stream into a null-terminated buffer.
+ */
+
+static
+CMR_ERROR textReadBuffer(
+  CMR* cmr,             /**< \ref CMR environment. */
+  FILE* stream,         /**< File stream to read from. */
+  char** pbuffer,       /**< Pointer for storing the buffer. */
+  size_t* plength       /**< Pointer for storing the number of bytes read. */
+)
+{
+  /* We start with the size of the file, if available. */
+  size_t memBuffer = 1UL << 16;
+  long position = ftell(stream);
+  if (position >= 0 && !fseek(stream, 0, SEEK_END))
+  {
+    long size = ftell(stream);
+    if (size > position)
+      memBuffer = (size_t) (size - position) + 1;
+    fseek(stream, position, SEEK_SET);
+  }
+
+  char* buffer = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &buffer, memBuffer) );
+  size_t length = 0;
+  while (true)
+  {
+    length += fread(&buffer[length], 1, memBuffer - 1 - length, stream);
+    if (length < memBuffer - 1)
+      break;
+    memBuffer *= 2;
+    CMR_CALL( CMRreallocBlockArray(cmr, &buffer, memBuffer) );
+  }
+  if (ferror(stream))
+  {
+    CMR_CALL( CMRfreeBlockArray(cmr, &buffer) );
+    CMRraiseErrorMessage(cmr, "Could not read from file.");
+    return CMR_ERROR_INPUT;
+  }
+  buffer[length] = '\0';
+
+  *pbuffer = buffer;
+  *plength = length;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Compression formats of the input.
+ */
+
+typedef enum
+{
+  TEXT_COMPRESSION_NONE = 0,  /**< Plain text. */
+  TEXT_COMPRESSION_GZIP = 1,  /**< gzip format. */
+  TEXT_COMPRESSION_ZSTD = 2   /**< Zstandard format. */
+} TextCompression;
+
+/**
+ * \brief Detects the compression format of \p stream by peeking at its next character.
+ *
+ * The first bytes of the gzip and Zstandard formats, 0x1f and 0x28, cannot start a matrix in text format.
+ */
+
+static
+TextCompression textDetectCompression(
+  FILE* stream  /**< File stream. */
+)
+{
+  int c = getc(stream);
+  if (c == EOF)
+    return TEXT_COMPRESSION_NONE;
+  ungetc(c, stream);
+
+  if (c == 0x1f)
+    return TEXT_COMPRESSION_GZIP;
+  else if (c == 0x28)
+    return TEXT_COMPRESSION_ZSTD;
+  else
+    return TEXT_COMPRESSION_NONE;
+}
+
+/**
+ * \brief Data shared by the workers that read and decompress a compressed input.
+ *
+ * Compressed chunks are read into two alternating buffers. While one chunk is decompressed, the next one is read. Each
+ * worker repeatedly takes over whichever of the two tasks is available, such that a single worker does both in turn.
+ */
+
+typedef struct
+{
+  CMR_MUTEX mutex;              /**< \brief Mutex protecting the remaining members. */
+  CMR_CONDITION condition;      /**< \brief Condition that is signaled whenever a task is finished. */
+  FILE* stream;                 /**< \brief Stream to read from. */
+  TextCompression compression;  /**< \brief Compression format. */
+  unsigned char* chunks[2];     /**< \brief Buffers for compressed chunks. */
+  size_t chunkLengths[2];       /**< \brief Number of bytes of each compressed chunk. */
+  size_t numRead;               /**< \brief Number of chunks read. */
+  size_t numDecompressed;       /**< \brief Number of chunks decompressed. */
+  bool reading;                 /**< \brief Whether a worker is reading a chunk. */
+  bool decompressing;           /**< \brief Whether a worker is decompressing a chunk. */
+  bool endOfInput;              /**< \brief Whether the end of the stream was reached. */
+  const char* failure;          /**< \brief Error message if reading or decompressing failed. */
+  bool inFrame;                 /**< \brief Whether the last compressed frame is incomplete. */
+  char* buffer;                 /**< \brief Buffer for the decompressed input. */
+  size_t memBuffer;             /**< \brief Memory allocated for \ref buffer. */
+  size_t length;                /**< \brief Number of decompressed bytes. */
+#if defined(CMR_WITH_ZLIB)
+  z_stream zlib;                /**< \brief Decompression state for the gzip format. */
+#endif /* CMR_WITH_ZLIB */
+#if defined(CMR_WITH_ZSTD)
+  ZSTD_DStream* zstd;           /**< \brief Decompression state for the Zstandard format. */
+#endif /* CMR_WITH_ZSTD */
+} TextDecompression;
+
+/**
+ * \brief Decompresses a chunk and appends the result to the buffer of \p decompression.
+ *
+ * \returns An error message or \c NULL on success.
+ */
+
+static
+const char* textDecompressChunk(
+  CMR* cmr,                         /**< \ref CMR environment. */
+  TextDecompression* decompression, /**< Decompression data. */
+  const unsigned char* chunk,       /**< Compressed chunk. */
+  size_t chunkLength                /**< Number of bytes of \p chunk. */
+)
+{
+#if defined(CMR_WITH_ZLIB)
+  if (decompression->compression == TEXT_COMPRESSION_GZIP)
+  {
+    z_stream* zlib = &decompression->zlib;
+    zlib->next_in = (unsigned char*) chunk;
+    zlib->avail_in = (uInt) chunkLength;
+    bool outputFull = false;
+    while (zlib->avail_in > 0 || outputFull)
+    {
+      /* Keep memory for the terminating null character. */
+      if (decompression->memBuffer - decompression->length < (1UL << 16))
+      {
+        decompression->memBuffer *= 2;
+        if (CMRreallocBlockArray(cmr, &decompression->buffer, decompression->memBuffer))
+          return "Memory (re)allocation failed.";
+      }
+      size_t available = decompression->memBuffer - 1 - decompression->length;
+      if (available > UINT_MAX)
+        available = UINT_MAX;
+      zlib->next_out = (unsigned char*) &decompression->buffer[decompression->length];
+      zlib->avail_out = (uInt) available;
+      int status = inflate(zlib, Z_NO_FLUSH);
+      decompression->length += available - zlib->avail_out;
+      outputFull = zlib->avail_out == 0;
+      if (status == Z_STREAM_END)
+      {
+        /* A gzip file may consist of several members. */
+        decompression->inFrame = false;
+        if (inflateReset(zlib) != Z_OK)
+          return "Could not decompress gzip input.";
+      }
+      else if (status == Z_OK)
+        decompression->inFrame = true;
+      else if (status != Z_BUF_ERROR)
+        return "Could not decompress gzip input.";
+      else if (!outputFull)
+        break;
+    }
+
+    return NULL;
+  }
+#endif /* CMR_WITH_ZLIB */
+
+#if defined(CMR_WITH_ZSTD)
+  if (decompression->compression == TEXT_COMPRESSION_ZSTD)
+  {
+    ZSTD_inBuffer input = { chunk, chunkLength, 0 };
+    bool outputFull = false;
+    while (input.pos < input.size || outputFull)
+    {
+      if (decompression->memBuffer - decompression->length < (1UL << 16))
+      {
+        decompression->memBuffer *= 2;
+        if (CMRreallocBlockArray(cmr, &decompression->buffer, decompression->memBuffer))
+          return "Memory (re)allocation failed.";
+      }
+      ZSTD_outBuffer output = { &decompression->buffer[decompression->length],
+        decompression->memBuffer - 1 - decompression->length, 0 };
+      size_t status = ZSTD_decompressStream(decompression->zstd, &output, &input);
+      if (ZSTD_isError(status))
+        return "Could not decompress zstd input.";
+      decompression->length += output.pos;
+      decompression->inFrame = status != 0;
+      outputFull = output.pos == output.size;
+    }
+
+    return NULL;
+  }
+#endif /* CMR_WITH_ZSTD */
+
+  CMR_UNUSED(cmr);
+  CMR_UNUSED(decompression);
+  CMR_UNUSED(chunk);
+  CMR_UNUSED(chunkLength);
+
+  return "Compression format not supported.";
+}
+
+/**
+ * \brief Worker that reads and decompresses chunks until the input is exhausted.
+ */
+
+static
+CMR_ERROR textDecompressionWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Decompression data. */
+)
+{
+  CMR_UNUSED(worker);
+
+  TextDecompression* decompression = (TextDecompression*) data;
+
+  CMRmutexLock(&decompression->mutex);
+  while (!decompression->failure)
+  {
+    if (!decompression->decompressing && decompression->numDecompressed < decompression->numRead)
+    {
+      decompression->decompressing = true;
+      size_t slot = decompression->numDecompressed % 2;
+      CMRmutexUnlock(&decompression->mutex);
+
+      const char* failure = textDecompressChunk(cmr, decompression, decompression->chunks[slot],
+        decompression->chunkLengths[slot]);
+
+      CMRmutexLock(&decompression->mutex);
+      decompression->decompressing = false;
+      decompression->numDecompressed++;
+      if (failure)
+        decompression->failure = failure;
+      CMRconditionBroadcast(&decompression->condition);
+    }
+    else if (!decompression->reading && !decompression->endOfInput
+      && decompression->numRead < decompression->numDecompressed + 2)
+    {
+      decompression->reading = true;
+      size_t slot = decompression->numRead % 2;
+      CMRmutexUnlock(&decompression->mutex);
+
+      size_t length = fread(decompression->chunks[slot], 1, TEXT_COMPRESSED_CHUNK, decompression->stream);
+      bool failed = length < TEXT_COMPRESSED_CHUNK && ferror(decompression->stream);
+
+      CMRmutexLock(&decompression->mutex);
+      decompression->reading = false;
+      decompression->chunkLengths[slot] = length;
+      if (length > 0)
+        decompression->numRead++;
+      if (length < TEXT_COMPRESSED_CHUNK)
+        decompression->endOfInput = true;
+      if (failed)
+        decompression->failure = "Could not read from file.";
+      CMRconditionBroadcast(&decompression->condition);
+    }
+    else if (decompression->endOfInput && !decompression->reading && !decompression->decompressing
+      && decompression->numDecompressed == decompression->numRead)
+    {
+      break;
+    }
+    else
+      CMRconditionWait(&decompression->condition, &decompression->mutex);
+  }
+  CMRmutexUnlock(&decompression->mutex);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads the remaining contents of the compressed \p stream into a null-terminated buffer.
+ *
+ * If the environment has several threads, then reading the compressed input overlaps with its decompression.
+ */
+
+static
+CMR_ERROR textReadCompressedBuffer(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  FILE* stream,                 /**< File stream to read from. */
+  TextCompression compression,  /**< Compression format. */
+  char** pbuffer,               /**< Pointer for storing the buffer. */
+  size_t* plength               /**< Pointer for storing the number of decompressed bytes. */
+)
+{
+  assert(cmr);
+  assert(stream);
+  assert(compression != TEXT_COMPRESSION_NONE);
+
+  TextDecompression decompression;
+  decompression.stream = stream;
+  decompression.compression = compression;
+  decompression.numRead = 0;
+  decompression.numDecompressed = 0;
+  decompression.reading = false;
+  decompression.decompressing = false;
+  decompression.endOfInput = false;
+  decompression.failure = NULL;
+  decompression.inFrame = false;
+  decompression.length = 0;
+
+#if defined(CMR_WITH_ZLIB)
+  if (compression == TEXT_COMPRESSION_GZIP)
+  {
+    decompression.zlib.zalloc = Z_NULL;
+    decompression.zlib.zfree = Z_NULL;
+    decompression.zlib.opaque = Z_NULL;
+    decompression.zlib.next_in = Z_NULL;
+    decompression.zlib.avail_in = 0;
+    /* Window size of 2^15 with automatic detection of the gzip header. */
+    if (inflateInit2(&decompression.zlib, 15 + 32) != Z_OK)
+      return CMR_ERROR_MEMORY;
+  }
+#else /* !CMR_WITH_ZLIB */
+  if (compression == TEXT_COMPRESSION_GZIP)
+  {
+    CMRraiseErrorMessage(cmr, "Input is gzip-compressed, but CMR was compiled without zlib support.");
+    return CMR_ERROR_INPUT;
+  }
+#endif /* CMR_WITH_ZLIB */
+
+#if defined(CMR_WITH_ZSTD)
+  if (compression == TEXT_COMPRESSION_ZSTD)
+  {
+    decompression.zstd = ZSTD_createDStream();
+    if (!decompression.zstd)
+      return CMR_ERROR_MEMORY;
+  }
+#else /* !CMR_WITH_ZSTD */
+  if (compression == TEXT_COMPRESSION_ZSTD)
+  {
+    CMRraiseErrorMessage(cmr, "Input is zstd-compressed, but CMR was compiled without Zstandard support.");
+    return CMR_ERROR_INPUT;
+  }
+#endif /* CMR_WITH_ZSTD */
+
+  decompression.chunks[0] = NULL;
+  decompression.chunks[1] = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &decompression.chunks[0], TEXT_COMPRESSED_CHUNK) );
+  CMR_CALL( CMRallocBlockArray(cmr, &decompression.chunks[1], TEXT_COMPRESSED_CHUNK) );
+  decompression.memBuffer = 4 * TEXT_COMPRESSED_CHUNK;
+  decompression.buffer = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &decompression.buffer, decompression.memBuffer) );
+  CMRmutexInit(&decompression.mutex);
+  CMRconditionInit(&decompression.condition);
+
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, 2);
+  if (numWorkers > 1)
+    CMR_CALL( CMRthreadsRun(cmr, numWorkers, textDecompressionWorker, &decompression) );
+  else
+    CMR_CALL( textDecompressionWorker(cmr, 0, &decompression) );
+
+  CMRconditionFree(&decompression.condition);
+  CMRmutexFree(&decompression.mutex);
+  CMR_CALL( CMRfreeBlockArray(cmr, &decompression.chunks[1]) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &decompression.chunks[0]) );
+
+#if defined(CMR_WITH_ZLIB)
+  if (compression == TEXT_COMPRESSION_GZIP)
+    inflateEnd(&decompression.zlib);
+#endif /* CMR_WITH_ZLIB */
+#if defined(CMR_WITH_ZSTD)
+  if (compression == TEXT_COMPRESSION_ZSTD)
+    ZSTD_freeDStream(decompression.zstd);
+#endif /* CMR_WITH_ZSTD */
+
+  if (!decompression.failure && decompression.inFrame)
+    decompression.failure = "Compressed input is truncated.";
+  if (decompression.failure)
+  {
+    CMR_CALL( CMRfreeBlockArray(cmr, &decompression.buffer) );
+    CMRraiseErrorMessage(cmr, "%s", decompression.failure);
+    return CMR_ERROR_INPUT;
+  }
+  decompression.buffer[decompression.length] = '\0';
+
+  *pbuffer = decompression.buffer;
+  *plength = decompression.length;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Parses a matrix from the null-terminated \p buffer, which must not contain anything else.
+ */
+
+static
+CMR_ERROR textParseBuffer(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  const char* buffer,       /**< Buffer. */
+  size_t length,            /**< Length of \p buffer. */
+  bool isDense,             /**< Whether to read a dense instead of a sparse matrix. */
+  TextValueType valueType,  /**< Type of the values. */
+  CMR_MATRIX** presult      /**< Pointer for storing the matrix. */
+)
+{
+  TextScanner scanner = { buffer, buffer + length, NULL, NULL, 0 };
+  CMR_ERROR error = isDense ? textReadDense(cmr, &scanner, valueType, presult)
+    : textReadSparse(cmr, &scanner, valueType, presult);
+  if (!error)
+  {
+    /* Attempt to read another token. */
+    const char* begin;
+    const char* end;
+    CMR_CALL( textNextToken(cmr, &scanner, &begin, &end) );
+    if (begin < end)
+    {
+      char token[TEXT_MAX_REPORTED_TOKEN + 4];
+      size_t tokenLength = (size_t) (end - begin);
+      if (tokenLength > TEXT_MAX_REPORTED_TOKEN)
+        tokenLength = TEXT_MAX_REPORTED_TOKEN;
+      memcpy(token, begin, tokenLength);
+      strcpy(&token[tokenLength], tokenLength == TEXT_MAX_REPORTED_TOKEN ? "..." : "");
+      CMRraiseErrorMessage(cmr, "Found unexpected token \"%s\" after having read a *%s* %zux%zu matrix with %zu nonzeros.",
+        token, isDense ? "dense" : "sparse", (*presult)->numRows, (*presult)->numColumns, (*presult)->numNonzeros);
+      CMR_CALL( textFreeMatrix(cmr, valueType, presult) );
+      error = CMR_ERROR_INPUT;
+    }
+  }
+
+  return error;
+}
+
+/**
+ * \brief Reads a matrix from \p stream without consuming anything beyond its last token.
+ *
+ * A stream compressed in gzip or Zstandard format is consumed completely and must not contain anything else.
+ */
+
+static
+CMR_ERROR textReadStream(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  FILE* stream,             /**< File stream to read from. */
+  bool isDense,             /**< Whether to read a dense instead of a sparse matrix. */
+  TextValueType valueType,  /**< Type of the values. */
+  CMR_MATRIX** presult      /**< Pointer for storing the matrix. */
+)
+{
+  assert(cmr);
+  assert(stream);
+  assert(presult);
+  assert(!*presult);
+
+  /* A compressed input is decompressed completely. */
+  TextCompression compression = textDetectCompression(stream);
+  if (compression != TEXT_COMPRESSION_NONE)
+  {
+    char* buffer = NULL;
+    size_t length = 0;
+    CMR_CALL( textReadCompressedBuffer(cmr, stream, compression, &buffer, &length) );
+    CMR_ERROR error = textParseBuffer(cmr, buffer, length, isDense, valueType, presult);
+    CMR_CALL( CMRfreeBlockArray(cmr, &buffer) );
+    return error;
+  }
+
+  TextScanner scanner = { NULL, NULL, stream, NULL, 64 };
+  CMR_CALL( CMRallocBlockArray(cmr, &scanner.token, scanner.memToken) );
+
+  TEXT_LOCK(stream);
+  CMR_ERROR error = isDense ? textReadDense(cmr, &scanner, valueType, presult)
+    : textReadSparse(cmr, &scanner, valueType, presult);
+  TEXT_UNLOCK(stream);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &scanner.token) );
+
+  return error;
+}
+
+CMR_ERROR CMRtextReadFileContents(CMR* cmr, const char* fileName, const char* stdinName, char** pbuffer,
+  size_t* plength)
+{
+  assert(cmr);
+  assert(fileName);
+  assert(pbuffer);
+  assert(plength);
+
+  FILE* inputFile = (!stdinName || strcmp(fileName, stdinName)) ? fopen(fileName, "r") : stdin;
+  if (!inputFile)
+  {
+    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
+    return CMR_ERROR_INPUT;
+  }
+
+  TextCompression compression = textDetectCompression(inputFile);
+  CMR_ERROR error = compression == TEXT_COMPRESSION_NONE ? textReadBuffer(cmr, inputFile, pbuffer, plength)
+    : textReadCompressedBuffer(cmr, inputFile, compression, pbuffer, plength);
+  if (inputFile != stdin)
+    fclose(inputFile);
+
+  return error;
+}
+
+/**
+ * \brief Reads a matrix from the file \p fileName, which must not contain anything else.
+ *
+ * The whole file is read into memory by \ref CMRtextReadFileContents, which allows for parsing large files in parallel.
+ */
+
+static
+CMR_ERROR textReadFile(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  const char* fileName,     /**< Name of the file. */
+  const char* stdinName,    /**< If not \c NULL, indicates which file name represents stdin. */
+  bool isDense,             /**< Whether to read a dense instead of a sparse matrix. */
+  TextValueType valueType,  /**< Type of the values. */
+  CMR_MATRIX** presult      /**< Pointer for storing the matrix. */
+)
+{
+  assert(cmr);
+  assert(fileName);
+  assert(presult);
+  assert(!*presult);
+
+  char* buffer = NULL;
+  size_t length = 0;
+  CMR_CALL( CMRtextReadFileContents(cmr, fileName, stdinName, &buffer, &length) );
+
+  CMR_ERROR error = textParseBuffer(cmr, buffer, length, isDense, valueType, presult);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &buffer) );
+
+  return error;
+}
+
+CMR_ERROR CMRdblmatCreateFromSparseStream(CMR* cmr, FILE* stream, CMR_DBLMAT** presult)
+{
+  return textReadStream(cmr, stream, false, TEXT_VALUES_DOUBLE, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRintmatCreateFromSparseStream(CMR* cmr, FILE* stream, CMR_INTMAT** presult)
+{
+  return textReadStream(cmr, stream, false, TEXT_VALUES_INT, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRchrmatCreateFromSparseStream(CMR* cmr, FILE* stream, CMR_CHRMAT** presult)
+{
+  return textReadStream(cmr, stream, false, TEXT_VALUES_CHAR, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRdblmatCreateFromSparseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_DBLMAT** presult)
+{
+  return textReadFile(cmr, fileName, stdinName, false, TEXT_VALUES_DOUBLE, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRintmatCreateFromSparseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_INTMAT** presult)
+{
+  return textReadFile(cmr, fileName, stdinName, false, TEXT_VALUES_INT, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRchrmatCreateFromSparseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_CHRMAT** presult)
+{
+  return textReadFile(cmr, fileName, stdinName, false, TEXT_VALUES_CHAR, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRdblmatCreateFromDenseStream(CMR* cmr, FILE* stream, CMR_DBLMAT** presult)
+{
+  return textReadStream(cmr, stream, true, TEXT_VALUES_DOUBLE, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRintmatCreateFromDenseStream(CMR* cmr, FILE* stream, CMR_INTMAT** presult)
+{
+  return textReadStream(cmr, stream, true, TEXT_VALUES_INT, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRchrmatCreateFromDenseStream(CMR* cmr, FILE* stream, CMR_CHRMAT** presult)
+{
+  return textReadStream(cmr, stream, true, TEXT_VALUES_CHAR, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRdblmatCreateFromDenseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_DBLMAT** presult)
+{
+  return textReadFile(cmr, fileName, stdinName, true, TEXT_VALUES_DOUBLE, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRintmatCreateFromDenseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_INTMAT** presult)
+{
+  return textReadFile(cmr, fileName, stdinName, true, TEXT_VALUES_INT, (CMR_MATRIX**) presult);
+}
+
+CMR_ERROR CMRchrmatCreateFromDenseFile(CMR* cmr, const char* fileName, const char* stdinName, CMR_CHRMAT** presult)
+{
+  return textReadFile(cmr, fileName, stdinName, true, TEXT_VALUES_CHAR, (CMR_MATRIX**) presult);
+}
+
+#define TEXT_STREAM_CHUNK (1UL << 16)   /**< Number of nonzeros that are parsed at once when streaming columns. */
+#define TEXT_STREAM_BUFFER (1UL << 20)  /**< Number of bytes that are read at once when streaming columns. */
+
+/**
+ * \brief Data shared by the workers that parse a column-sorted sparse matrix and pass its columns on.
+ *
+ * Nonzeros are parsed into two alternating chunks. While the nonzeros of one chunk are assembled into columns that
+ * are passed to the user function, the next chunk is parsed. As for \ref TextDecompression, each worker repeatedly
+ * takes over whichever of the two tasks is available.
+ */
+
+typedef struct
+{
+  CMR_MUTEX mutex;                      /**< \brief Mutex protecting the members up to \ref error. */
+  CMR_CONDITION condition;              /**< \brief Condition that is signaled whenever a task is finished. */
+  size_t numParsed;                     /**< \brief Number of chunks parsed. */
+  size_t numConsumed;                   /**< \brief Number of chunks passed on. */
+  bool parsing;                         /**< \brief Whether a worker is parsing a chunk. */
+  bool consuming;                       /**< \brief Whether a worker is passing on a chunk. */
+  bool endOfInput;                      /**< \brief Whether all nonzeros were parsed. */
+  bool stop;                            /**< \brief Whether no further chunks shall be parsed. */
+  CMR_ERROR error;                      /**< \brief Error of parsing or of the user function. */
+  FILE* file;                           /**< \brief Stream to read from, or \c NULL if the input is buffered. */
+  char* buffer;                         /**< \brief Buffer with the input that was read but not parsed yet. */
+  size_t memBuffer;                     /**< \brief Memory allocated for \ref buffer. */
+  size_t bufferBegin;                   /**< \brief Beginning of the unparsed part of \ref buffer. */
+  size_t bufferEnd;                     /**< \brief End of the input in \ref buffer. */
+  bool endOfFile;                       /**< \brief Whether \ref buffer contains the remaining input. */
+  size_t numRows;                       /**< \brief Number of rows of the matrix. */
+  size_t numColumns;                    /**< \brief Number of columns of the matrix. */
+  size_t numNonzeros;                   /**< \brief Number of nonzeros of the matrix. */
+  size_t numScanned;                    /**< \brief Number of nonzeros parsed so far. */
+  size_t* chunkRows[2];                 /**< \brief Rows of the nonzeros of each chunk. */
+  size_t* chunkColumns[2];              /**< \brief Columns of the nonzeros of each chunk. */
+  char* chunkValues[2];                 /**< \brief Values of the nonzeros of each chunk. */
+  size_t chunkLengths[2];               /**< \brief Number of nonzeros of each chunk. */
+  CMR_SPARSE_COLUMN_FUNCTION function;  /**< \brief User function receiving the columns. */
+  void* data;                           /**< \brief User data. */
+  size_t column;                        /**< \brief Column whose nonzeros are being collected. */
+  size_t numEntries;                    /**< \brief Number of nonzeros of \ref column collected so far. */
+  size_t memEntries;                    /**< \brief Memory for nonzeros of \ref column. */
+  size_t* rows;                         /**< \brief Rows of the nonzeros of \ref column. */
+  char* values;                         /**< \brief Values of the nonzeros of \ref column. */
+  size_t* rowsColumn;                   /**< \brief For each row, one plus the last column with a nonzero in it. */
+  bool isStopped;                       /**< \brief Whether the user function asked to stop; only accessed by the
+                                         **  worker that passes chunks on. */
+} TextColumnStream;
+
+/**
+ * \brief Scans the next token of a column stream, reading blocks of the input as needed.
+ *
+ * Sets \p *pbegin and \p *pend to the range of the token, which is empty at the end of the input. The token is
+ * valid until the next call.
+ */
+
+static
+CMR_ERROR textStreamNextToken(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextColumnStream* stream, /**< Column stream. */
+  const char** pbegin,      /**< Pointer for storing the beginning of the token. */
+  const char** pend         /**< Pointer for storing the end of the token. */
+)
+{
+  size_t begin = stream->bufferBegin;
+  while (true)
+  {
+    while (begin < stream->bufferEnd && CMRtextIsSpace(stream->buffer[begin]))
+      ++begin;
+    size_t end = begin;
+    while (end < stream->bufferEnd && !CMRtextIsSpace(stream->buffer[end]))
+      ++end;
+    if (end < stream->bufferEnd || stream->endOfFile)
+    {
+      *pbegin = &stream->buffer[begin];
+      *pend = &stream->buffer[end];
+      stream->bufferBegin = end;
+      return CMR_OKAY;
+    }
+
+    /* The token may continue after the buffered input, so we keep it and read the next block behind it. */
+    size_t length = stream->bufferEnd - begin;
+    memmove(stream->buffer, &stream->buffer[begin], length);
+    begin = 0;
+    if (stream->memBuffer - length < TEXT_STREAM_BUFFER)
+    {
+      stream->memBuffer *= 2;
+      CMR_CALL( CMRreallocBlockArray(cmr, &stream->buffer, stream->memBuffer) );
+    }
+    size_t numRead = fread(&stream->buffer[length], 1, TEXT_STREAM_BUFFER, stream->file);
+    if (numRead < TEXT_STREAM_BUFFER)
+    {
+      if (ferror(stream->file))
+      {
+        CMRraiseErrorMessage(cmr, "Could not read from file.");
+        return CMR_ERROR_INPUT;
+      }
+      stream->endOfFile = true;
+    }
+    stream->bufferEnd = length + numRead;
+  }
+}
+
+/**
+ * \brief Parses the next chunk of nonzeros of a column stream.
+ *
+ * Zero entries are skipped. After the last nonzero it is checked that the input contains nothing else.
+ */
+
+static
+CMR_ERROR textStreamParseChunk(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  TextColumnStream* stream,   /**< Column stream. */
+  size_t slot,                /**< Slot of the chunk. */
+  bool* pendOfInput           /**< Pointer for storing whether all nonzeros were parsed. */
+)
+{
+  size_t length = 0;
+  while (length < TEXT_STREAM_CHUNK && stream->numScanned < stream->numNonzeros)
+  {
+    const char* begin;
+    const char* end;
+    size_t row = 0;
+    size_t column = 0;
+    int value;
+    CMR_CALL( textStreamNextToken(cmr, stream, &begin, &end) );
+    bool readIndices = textParseSize(begin, end, &row);
+    if (readIndices)
+    {
+      CMR_CALL( textStreamNextToken(cmr, stream, &begin, &end) );
+      readIndices = textParseSize(begin, end, &column);
+    }
+    bool readValue = false;
+    if (readIndices)
+    {
+      CMR_CALL( textStreamNextToken(cmr, stream, &begin, &end) );
+      readValue = textParseInt(begin, end, &value);
+    }
+    if (!readValue || row == 0 || column == 0 || row > stream->numRows || column > stream->numColumns)
+    {
+      if (readIndices && !readValue)
+        CMRraiseErrorMessage(cmr, "Could not read an integer value of nonzero #%zu.", stream->numScanned);
+      else
+        CMRraiseErrorMessage(cmr, "Could not read nonzero #%zu.", stream->numScanned);
+      return CMR_ERROR_INPUT;
+    }
+    if (value < CHAR_MIN || value > CHAR_MAX)
+    {
+      CMRraiseErrorMessage(cmr, "Value %d of nonzero #%zu does not fit into a char.", value, stream->numScanned);
+      return CMR_ERROR_INPUT;
+    }
+    stream->numScanned++;
+    if (value != 0)
+    {
+      stream->chunkRows[slot][length] = row - 1;
+      stream->chunkColumns[slot][length] = column - 1;
+      stream->chunkValues[slot][length] = (char) value;
+      ++length;
+    }
+  }
+  stream->chunkLengths[slot] = length;
+  *pendOfInput = stream->numScanned == stream->numNonzeros;
+
+  if (*pendOfInput)
+  {
+    const char* begin;
+    const char* end;
+    CMR_CALL( textStreamNextToken(cmr, stream, &begin, &end) );
+    if (begin < end)
+    {
+      CMRraiseErrorMessage(cmr, "Found unexpected token after having read a *sparse* %zux%zu matrix with %zu nonzeros.",
+        stream->numRows, stream->numColumns, stream->numNonzeros);
+      return CMR_ERROR_INPUT;
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Passes the collected column and all empty columns before \p nextColumn to the user function.
+ */
+
+static
+CMR_ERROR textStreamEmitColumns(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextColumnStream* stream, /**< Column stream. */
+  size_t nextColumn         /**< Next column that shall be collected. */
+)
+{
+  while (stream->column < nextColumn)
+  {
+    bool stop = false;
+    CMR_CALL( stream->function(cmr, stream->column, stream->numEntries, stream->rows, stream->values, stream->data,
+      &stop) );
+    stream->column++;
+    stream->numEntries = 0;
+    if (stop)
+    {
+      stream->isStopped = true;
+      break;
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Assembles the nonzeros of a parsed chunk into columns and passes the completed ones to the user function.
+ */
+
+static
+CMR_ERROR textStreamConsumeChunk(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  TextColumnStream* stream, /**< Column stream. */
+  size_t slot               /**< Slot of the chunk. */
+)
+{
+  for (size_t e = 0; e < stream->chunkLengths[slot]; ++e)
+  {
+    size_t row = stream->chunkRows[slot][e];
+    size_t column = stream->chunkColumns[slot][e];
+    if (column < stream->column)
+    {
+      CMRraiseErrorMessage(cmr, "Nonzero in row %zu and column %zu is not sorted by column.", row + 1, column + 1);
+      return CMR_ERROR_INPUT;
+    }
+    CMR_CALL( textStreamEmitColumns(cmr, stream, column) );
+    if (stream->isStopped)
+      break;
+
+    if (stream->rowsColumn[row] == column + 1)
+    {
+      CMRraiseErrorMessage(cmr, "Duplicate nonzero in row %zu and column %zu.", row + 1, column + 1);
+      return CMR_ERROR_INPUT;
+    }
+    stream->rowsColumn[row] = column + 1;
+    if (stream->numEntries == stream->memEntries)
+    {
+      stream->memEntries *= 2;
+      CMR_CALL( CMRreallocBlockArray(cmr, &stream->rows, stream->memEntries) );
+      CMR_CALL( CMRreallocBlockArray(cmr, &stream->values, stream->memEntries) );
+    }
+    stream->rows[stream->numEntries] = row;
+    stream->values[stream->numEntries] = stream->chunkValues[slot][e];
+    stream->numEntries++;
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Worker that parses chunks and passes them on until the input is exhausted.
+ */
+
+static
+CMR_ERROR textStreamWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Column stream. */
+)
+{
+  CMR_UNUSED(worker);
+
+  TextColumnStream* stream = (TextColumnStream*) data;
+
+  CMRmutexLock(&stream->mutex);
+  while (!stream->error && !stream->stop)
+  {
+    if (!stream->consuming && stream->numConsumed < stream->numParsed)
+    {
+      stream->consuming = true;
+      size_t slot = stream->numConsumed % 2;
+      CMRmutexUnlock(&stream->mutex);
+
+      CMR_ERROR error = textStreamConsumeChunk(cmr, stream, slot);
+
+      CMRmutexLock(&stream->mutex);
+      stream->consuming = false;
+      stream->numConsumed++;
+      if (error && !stream->error)
+        stream->error = error;
+      if (stream->isStopped)
+        stream->stop = true;
+      CMRconditionBroadcast(&stream->condition);
+    }
+    else if (!stream->parsing && !stream->endOfInput && stream->numParsed < stream->numConsumed + 2)
+    {
+      stream->parsing = true;
+      size_t slot = stream->numParsed % 2;
+      CMRmutexUnlock(&stream->mutex);
+
+      bool endOfInput = false;
+      CMR_ERROR error = textStreamParseChunk(cmr, stream, slot, &endOfInput);
+
+      CMRmutexLock(&stream->mutex);
+      stream->parsing = false;
+      stream->numParsed++;
+      stream->endOfInput = endOfInput;
+      if (error && !stream->error)
+        stream->error = error;
+      CMRconditionBroadcast(&stream->condition);
+    }
+    else if (stream->endOfInput && !stream->parsing && !stream->consuming && stream->numConsumed == stream->numParsed)
+    {
+      break;
+    }
+    else
+      CMRconditionWait(&stream->condition, &stream->mutex);
+  }
+  CMRconditionBroadcast(&stream->condition);
+  CMRmutexUnlock(&stream->mutex);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Streams the columns of a column-sorted sparse matrix to the user functions.
+ *
+ * The members of \p stream concerning the input must be initialized.
+ */
+
+static
+CMR_ERROR textStreamColumns(
+  CMR* cmr,                                   /**< \ref CMR environment. */
+  TextColumnStream* stream,                   /**< Column stream. */
+  CMR_SPARSE_HEADER_FUNCTION headerFunction,  /**< User function receiving the dimensions (may be \c NULL). */
+  CMR_SPARSE_COLUMN_FUNCTION columnFunction,  /**< User function receiving the columns. */
+  void* data                                  /**< User data. */
+)
+{
+  size_t* dimensions[3] = { &stream->numRows, &stream->numColumns, &stream->numNonzeros };
+  for (size_t d = 0; d < 3; ++d)
+  {
+    const char* begin;
+    const char* end;
+    CMR_CALL( textStreamNextToken(cmr, stream, &begin, &end) );
+    if (!textParseSize(begin, end, dimensions[d]))
+    {
+      CMRraiseErrorMessage(cmr, "Could not read number of rows, columns and nonzeros.");
+      return CMR_ERROR_INPUT;
+    }
+  }
+
+  bool stop = false;
+  if (headerFunction)
+    CMR_CALL( headerFunction(cmr, stream->numRows, stream->numColumns, stream->numNonzeros, data, &stop) );
+  if (stop)
+    return CMR_OKAY;
+
+  stream->numParsed = 0;
+  stream->numConsumed = 0;
+  stream->parsing = false;
+  stream->consuming = false;
+  stream->endOfInput = false;
+  stream->stop = false;
+  stream->isStopped = false;
+  stream->error = CMR_OKAY;
+  stream->numScanned = 0;
+  stream->function = columnFunction;
+  stream->data = data;
+  stream->column = 0;
+  stream->numEntries = 0;
+  stream->memEntries = 16;
+  stream->rows = NULL;
+  stream->values = NULL;
+  stream->rowsColumn = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &stream->rows, stream->memEntries) );
+  CMR_CALL( CMRallocBlockArray(cmr, &stream->values, stream->memEntries) );
+  CMR_CALL( CMRallocBlockArray(cmr, &stream->rowsColumn, stream->numRows > 0 ? stream->numRows : 1) );
+  for (size_t row = 0; row < stream->numRows; ++row)
+    stream->rowsColumn[row] = 0;
+  size_t chunkLength = stream->numNonzeros < TEXT_STREAM_CHUNK ? stream->numNonzeros + 1 : TEXT_STREAM_CHUNK;
+  for (size_t slot = 0; slot < 2; ++slot)
+  {
+    stream->chunkRows[slot] = NULL;
+    stream->chunkColumns[slot] = NULL;
+    stream->chunkValues[slot] = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &stream->chunkRows[slot], chunkLength) );
+    CMR_CALL( CMRallocBlockArray(cmr, &stream->chunkColumns[slot], chunkLength) );
+    CMR_CALL( CMRallocBlockArray(cmr, &stream->chunkValues[slot], chunkLength) );
+  }
+  CMRmutexInit(&stream->mutex);
+  CMRconditionInit(&stream->condition);
+
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, 2);
+  CMR_ERROR error = CMR_OKAY;
+  if (numWorkers > 1)
+    error = CMRthreadsRun(cmr, numWorkers, textStreamWorker, stream);
+  else
+    error = textStreamWorker(cmr, 0, stream);
+  if (!error)
+    error = stream->error;
+
+  /* The last column and the empty columns after it are passed on in the end. */
+  if (!error && !stream->isStopped)
+    error = textStreamEmitColumns(cmr, stream, stream->numColumns);
+
+  CMRconditionFree(&stream->condition);
+  CMRmutexFree(&stream->mutex);
+  for (size_t slot = 2; slot > 0; --slot)
+  {
+    CMR_CALL( CMRfreeBlockArray(cmr, &stream->chunkValues[slot - 1]) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &stream->chunkColumns[slot - 1]) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &stream->chunkRows[slot - 1]) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &stream->rowsColumn) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &stream->values) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &stream->rows) );
+
+  return error;
+}
+
+CMR_ERROR CMRchrmatStreamSparseColumns(CMR* cmr, const char* fileName, const char* stdinName,
+  CMR_SPARSE_HEADER_FUNCTION headerFunction, CMR_SPARSE_COLUMN_FUNCTION columnFunction, void* data)
+{
+  assert(cmr);
+  assert(fileName);
+  assert(columnFunction);
+
+  FILE* inputFile = (!stdinName || strcmp(fileName, stdinName)) ? fopen(fileName, "r") : stdin;
+  if (!inputFile)
+  {
+    CMRraiseErrorMessage(cmr, "Could not open file <%s>.", fileName);
+    return CMR_ERROR_INPUT;
+  }
+
+  TextColumnStream stream;
+  stream.buffer = NULL;
+  stream.bufferBegin = 0;
+  CMR_ERROR error = CMR_OKAY;
+  TextCompression compression = textDetectCompression(inputFile);
+  if (compression != TEXT_COMPRESSION_NONE)
+  {
+    /* A compressed input is decompressed completely. */
+    stream.file = NULL;
+    stream.endOfFile = true;
+    error = textReadCompressedBuffer(cmr, inputFile, compression, &stream.buffer, &stream.bufferEnd);
+    stream.memBuffer = stream.bufferEnd;
+  }
+  else
+  {
+    stream.file = inputFile;
+    stream.endOfFile = false;
+    stream.bufferEnd = 0;
+    stream.memBuffer = 2 * TEXT_STREAM_BUFFER;
+    error = CMRallocBlockArray(cmr, &stream.buffer, stream.memBuffer);
+  }
+
+  if (!error)
+    error = textStreamColumns(cmr, &stream, headerFunction, columnFunction, data);
+  if (stream.buffer)
+    CMR_CALL( CMRfreeBlockArray(cmr, &stream.buffer) );
+
+  if (inputFile != stdin)
+    fclose(inputFile);
+
+  return error;
+}
+
+CMR_ERROR CMRtextWriterInit(CMR* cmr, CMR_TEXT_WRITER* writer, FILE* stream)
+{
+  assert(cmr);
+  assert(writer);
+  assert(stream);
+
+  writer->stream = stream;
+  writer->buffer = NULL;
+  writer->length = 0;
+  writer->failed = false;
+  CMR_CALL( CMRallocBlockArray(cmr, &writer->buffer, CMR_TEXT_WRITER_SIZE) );
+
+  return CMR_OKAY;
+}
+
+void CMRtextWriterFlush(CMR_TEXT_WRITER* writer)
+{
+  assert(writer);
+
+  if (writer->length > 0 && fwrite(writer->buffer, 1, writer->length, writer->stream) != writer->length)
+    writer->failed = true;
+  writer->length = 0;
+}
+
+CMR_ERROR CMRtextWriterFree(CMR* cmr, CMR_TEXT_WRITER* writer)
+{
+  assert(cmr);
+  assert(writer);
+
+  CMRtextWriterFlush(writer);
+  CMR_CALL( CMRfreeBlockArray(cmr, &writer->buffer) );
+
+  return writer->failed ? CMR_ERROR_OUTPUT : CMR_OKAY;
+}
+
+void CMRtextWriterDouble(CMR_TEXT_WRITER* writer, double value)
+{
+  assert(writer);
+
+  if (value == trunc(value) && fabs(value) < 9007199254740992.0)
+  {
+    /* Also -0 is read back exactly. */
+    if (value == 0.0 && signbit(value))
+      CMRtextWriterChar(writer, '-');
+    CMRtextWriterInt(writer, (long long) value);
+    return;
+  }
+
+  CMRtextWriterReserve(writer);
+  char* output = &writer->buffer[writer->length];
+  int length = 0;
+  for (int precision = 15; precision <= 17; ++precision)
+  {
+    length = snprintf(output, CMR_TEXT_WRITER_MAX_TOKEN, "%.*g", precision, value);
+    if (precision == 17 || strtod(output, NULL) == value)
+      break;
+  }
+  writer->length += (size_t) length;
+}
@@ -0,0 +1,283 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/matrix.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "env_internal.h"
+#include "matrix_internal.h"
+#include "threads.h"
+
+#define TRANSPOSE_PARALLEL_THRESHOLD (1UL << 20) /**< Minimum number of nonzeros for transposing in parallel. */
+#define SORT_INSERTION_LENGTH 16                 /**< Maximum length of a row that is sorted by insertion sort. */
+
+/**
+ * \brief Data shared by the workers of a transpose.
+ */
+
+typedef struct
+{
+  CMR_MATRIX* matrix;   /**< \brief Matrix to be transposed. */
+  CMR_MATRIX* result;   /**< \brief Transpose. */
+  size_t valueSize;     /**< \brief Size of a matrix entry. */
+  size_t* firstRows;    /**< \brief Array with the first row of each worker, followed by the number of rows. */
+  size_t** positions;   /**< \brief Array with each worker's per-column counts, later turned into positions. */
+} TransposeData;
+
+/**
+ * \brief Counts the nonzeros per column in the rows of a worker.
+ */
+
+static
+CMR_ERROR transposeCountWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref TransposeData. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  TransposeData* transpose = (TransposeData*) data;
+  CMR_MATRIX* matrix = transpose->matrix;
+  size_t* counts = transpose->positions[worker];
+
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+    counts[column] = 0;
+  size_t first = matrix->rowSlice[transpose->firstRows[worker]];
+  size_t beyond = matrix->rowSlice[transpose->firstRows[worker + 1]];
+  for (size_t entry = first; entry < beyond; ++entry)
+    counts[matrix->entryColumns[entry]]++;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Moves the nonzeros of the rows of a worker into the transpose, where \p TYPE is the type of the entries.
+ */
+
+#define TRANSPOSE_SCATTER(TYPE) \
+  do \
+  { \
+    TYPE* values = (TYPE*) matrix->entryValues; \
+    TYPE* resultValues = (TYPE*) result->entryValues; \
+    for (size_t row = firstRow; row < beyondRow; ++row) \
+    { \
+      size_t beyond = matrix->rowSlice[row + 1]; \
+      for (size_t entry = matrix->rowSlice[row]; entry < beyond; ++entry) \
+      { \
+        size_t resultEntry = positions[matrix->entryColumns[entry]]++; \
+        result->entryColumns[resultEntry] = row; \
+        resultValues[resultEntry] = values[entry]; \
+      } \
+    } \
+  } \
+  while (false)
+
+/**
+ * \brief Moves the nonzeros of the rows of a worker to their positions in the transpose.
+ */
+
+static
+CMR_ERROR transposeScatterWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref TransposeData. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  TransposeData* transpose = (TransposeData*) data;
+  CMR_MATRIX* matrix = transpose->matrix;
+  CMR_MATRIX* result = transpose->result;
+  size_t* positions = transpose->positions[worker];
+  size_t firstRow = transpose->firstRows[worker];
+  size_t beyondRow = transpose->firstRows[worker + 1];
+
+  if (transpose->valueSize == sizeof(char))
+    TRANSPOSE_SCATTER(char);
+  else if (transpose->valueSize == sizeof(int))
+    TRANSPOSE_SCATTER(int);
+  else
+  {
+    assert(transpose->valueSize == sizeof(double));
+    TRANSPOSE_SCATTER(double);
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmatrixTransposeInto(CMR* cmr, CMR_MATRIX* matrix, size_t valueSize, CMR_MATRIX* result)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(result);
+  assert(result->numRows == matrix->numColumns);
+  assert(result->numColumns == matrix->numRows);
+
+  size_t numNonzeros = matrix->rowSlice[matrix->numRows];
+
+  /* Every worker needs a count per column, so we only parallelize if there are many nonzeros per column. */
+  size_t numWorkers = 1;
+  if (numNonzeros >= TRANSPOSE_PARALLEL_THRESHOLD && matrix->numRows > 1)
+  {
+    size_t maxWorkers = numNonzeros / (TRANSPOSE_PARALLEL_THRESHOLD / 4);
+    if (matrix->numColumns > 0 && maxWorkers > numNonzeros / matrix->numColumns)
+      maxWorkers = numNonzeros / matrix->numColumns;
+    if (maxWorkers > 1)
+      numWorkers = CMRthreadsNumWorkers(cmr, maxWorkers);
+  }
+
+  TransposeData transpose;
+  transpose.matrix = matrix;
+  transpose.result = result;
+  transpose.valueSize = valueSize;
+  transpose.firstRows = NULL;
+  transpose.positions = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &transpose.firstRows, numWorkers + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &transpose.positions, numWorkers) );
+  for (size_t w = 0; w < numWorkers; ++w)
+  {
+    transpose.positions[w] = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &transpose.positions[w], matrix->numColumns + 1) );
+  }
+
+  /* Split the rows such that all workers get roughly the same number of nonzeros. */
+  transpose.firstRows[0] = 0;
+  size_t row = 0;
+  for (size_t w = 1; w < numWorkers; ++w)
+  {
+    size_t targetEntry = (numNonzeros / numWorkers) * w;
+    while (row < matrix->numRows && matrix->rowSlice[row] < targetEntry)
+      ++row;
+    transpose.firstRows[w] = row;
+  }
+  transpose.firstRows[numWorkers] = matrix->numRows;
+
+  if (numWorkers > 1)
+    CMR_CALL( CMRthreadsRun(cmr, numWorkers, transposeCountWorker, &transpose) );
+  else
+    CMR_CALL( transposeCountWorker(cmr, 0, &transpose) );
+
+  /* Turn the counts into the first position of each worker's nonzeros of each column. */
+  size_t position = 0;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+  {
+    result->rowSlice[column] = position;
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+      size_t count = transpose.positions[w][column];
+      transpose.positions[w][column] = position;
+      position += count;
+    }
+  }
+  result->rowSlice[matrix->numColumns] = position;
+  assert(position == numNonzeros);
+
+  if (numWorkers > 1)
+    CMR_CALL( CMRthreadsRun(cmr, numWorkers, transposeScatterWorker, &transpose) );
+  else
+    CMR_CALL( transposeScatterWorker(cmr, 0, &transpose) );
+
+  for (size_t w = 0; w < numWorkers; ++w)
+    CMR_CALL( CMRfreeBlockArray(cmr, &transpose.positions[w]) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &transpose.positions) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &transpose.firstRows) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Sorts the nonzeros of the range [\p first, \p beyond) by insertion sort, where \p TYPE is the type of the
+ *        entries.
+ */
+
+#define SORT_INSERTION(TYPE) \
+  do \
+  { \
+    TYPE* values = (TYPE*) matrix->entryValues; \
+    for (size_t entry = first + 1; entry < beyond; ++entry) \
+    { \
+      size_t column = matrix->entryColumns[entry]; \
+      TYPE value = values[entry]; \
+      size_t target = entry; \
+      while (target > first && matrix->entryColumns[target - 1] > column) \
+      { \
+        matrix->entryColumns[target] = matrix->entryColumns[target - 1]; \
+        values[target] = values[target - 1]; \
+        --target; \
+      } \
+      matrix->entryColumns[target] = column; \
+      values[target] = value; \
+    } \
+  } \
+  while (false)
+
+CMR_ERROR CMRmatrixSortNonzeros(CMR* cmr, CMR_MATRIX* matrix, size_t valueSize)
+{
+  assert(cmr);
+  assert(matrix);
+
+  /* Find out whether only short rows are unsorted. */
+  bool isSorted = true;
+  bool hasLongUnsortedRow = false;
+  for (size_t row = 0; row < matrix->numRows && !hasLongUnsortedRow; ++row)
+  {
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t entry = first + 1; entry < beyond; ++entry)
+    {
+      if (matrix->entryColumns[entry - 1] > matrix->entryColumns[entry])
+      {
+        isSorted = false;
+        hasLongUnsortedRow = beyond - first > SORT_INSERTION_LENGTH;
+        break;
+      }
+    }
+  }
+
+  if (isSorted)
+    return CMR_OKAY;
+
+  if (hasLongUnsortedRow)
+  {
+    /* The rows of a transpose are always sorted, so we transpose twice. */
+    CMR_MATRIX transpose;
+    transpose.numRows = matrix->numColumns;
+    transpose.numColumns = matrix->numRows;
+    transpose.numNonzeros = matrix->rowSlice[matrix->numRows];
+    transpose.rowSlice = NULL;
+    transpose.entryColumns = NULL;
+    transpose.entryValues = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &transpose.rowSlice, transpose.numRows + 1) );
+    CMR_CALL( CMRallocBlockArray(cmr, &transpose.entryColumns, transpose.numNonzeros) );
+    CMR_CALL( _CMRallocBlockArray(cmr, &transpose.entryValues, valueSize, transpose.numNonzeros) );
+
+    CMR_CALL( CMRmatrixTransposeInto(cmr, matrix, valueSize, &transpose) );
+    CMR_CALL( CMRmatrixTransposeInto(cmr, &transpose, valueSize, matrix) );
+
+    CMR_CALL( CMRfreeBlockArray(cmr, &transpose.entryValues) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &transpose.entryColumns) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &transpose.rowSlice) );
+
+    return CMR_OKAY;
+  }
+
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    if (valueSize == sizeof(char))
+      SORT_INSERTION(char);
+    else if (valueSize == sizeof(int))
+      SORT_INSERTION(int);
+    else
+    {
+      assert(valueSize == sizeof(double));
+      SORT_INSERTION(double);
+    }
+  }
+
+  return CMR_OKAY;
+}
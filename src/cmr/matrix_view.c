@@ -0,0 +1,267 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/matrix.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "env_internal.h"
+
+/**
+ * \brief Allocates a view with \p numRows rows and \p numColumns columns of \p matrix whose maps are uninitialized,
+ *        except for \c parentColumns, which maps everything to \c SIZE_MAX.
+ */
+
+static
+CMR_ERROR viewCreateEmpty(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,         /**< Parent matrix. */
+  size_t numRows,             /**< Number of rows of the view. */
+  size_t numColumns,          /**< Number of columns of the view. */
+  CMR_CHRMAT_VIEW** pview     /**< Pointer for storing the view. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pview);
+
+  CMR_CALL( CMRallocBlock(cmr, pview) );
+  CMR_CHRMAT_VIEW* view = *pview;
+  view->parent = matrix;
+  view->numRows = numRows;
+  view->numColumns = numColumns;
+  view->rows = NULL;
+  view->columns = NULL;
+  view->parentColumns = NULL;
+  view->rowFilter = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &view->rows, numRows) );
+  CMR_CALL( CMRallocBlockArray(cmr, &view->columns, numColumns) );
+  CMR_CALL( CMRallocBlockArray(cmr, &view->parentColumns, matrix->numColumns) );
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+    view->parentColumns[column] = SIZE_MAX;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmatViewCreate(CMR* cmr, CMR_CHRMAT* matrix, CMR_SUBMAT* submatrix, CMR_CHRMAT_VIEW** pview)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pview);
+  assert(!*pview);
+
+  size_t numRows = submatrix ? submatrix->numRows : matrix->numRows;
+  size_t numColumns = submatrix ? submatrix->numColumns : matrix->numColumns;
+  CMR_CALL( viewCreateEmpty(cmr, matrix, numRows, numColumns, pview) );
+  CMR_CHRMAT_VIEW* view = *pview;
+
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    view->rows[row] = submatrix ? submatrix->rows[row] : row;
+    assert(view->rows[row] < matrix->numRows);
+  }
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    size_t parentColumn = submatrix ? submatrix->columns[column] : column;
+    assert(parentColumn < matrix->numColumns);
+    view->columns[column] = parentColumn;
+    view->parentColumns[parentColumn] = column;
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmatViewFree(CMR* cmr, CMR_CHRMAT_VIEW** pview)
+{
+  assert(cmr);
+  assert(pview);
+
+  CMR_CHRMAT_VIEW* view = *pview;
+  if (!view)
+    return CMR_OKAY;
+
+  if (view->rowFilter)
+    CMR_CALL( CMRfreeBlockArray(cmr, &view->rowFilter) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &view->parentColumns) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &view->columns) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &view->rows) );
+  CMR_CALL( CMRfreeBlock(cmr, pview) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmatViewRestrict(CMR* cmr, CMR_CHRMAT_VIEW* view, CMR_SUBMAT* submatrix, CMR_CHRMAT_VIEW** presult)
+{
+  assert(cmr);
+  assert(view);
+  assert(submatrix);
+  assert(presult);
+  assert(!*presult);
+
+  CMR_CALL( viewCreateEmpty(cmr, view->parent, submatrix->numRows, submatrix->numColumns, presult) );
+  CMR_CHRMAT_VIEW* result = *presult;
+
+  for (size_t r = 0; r < submatrix->numRows; ++r)
+  {
+    size_t row = submatrix->rows[r];
+    assert(row < view->numRows);
+    result->rows[r] = view->rows[row];
+    if (CMRchrmatViewIsRowHidden(view, row))
+      CMR_CALL( CMRchrmatViewSetRowHidden(cmr, result, r, true) );
+  }
+  for (size_t c = 0; c < submatrix->numColumns; ++c)
+  {
+    size_t column = submatrix->columns[c];
+    assert(column < view->numColumns);
+    size_t parentColumn = view->columns[column];
+    result->columns[c] = parentColumn;
+    if (!CMRchrmatViewIsColumnHidden(view, column))
+      result->parentColumns[parentColumn] = c;
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmatViewSetRowHidden(CMR* cmr, CMR_CHRMAT_VIEW* view, size_t row, bool hidden)
+{
+  assert(cmr);
+  assert(view);
+  assert(row < view->numRows);
+
+  if (!view->rowFilter)
+  {
+    if (!hidden)
+      return CMR_OKAY;
+
+    size_t numWords = (view->numRows + 63) / 64;
+    CMR_CALL( CMRallocBlockArray(cmr, &view->rowFilter, numWords) );
+    for (size_t w = 0; w < numWords; ++w)
+      view->rowFilter[w] = 0;
+  }
+
+  if (hidden)
+    view->rowFilter[row / 64] |= (uint64_t) 1 << (row % 64);
+  else
+    view->rowFilter[row / 64] &= ~((uint64_t) 1 << (row % 64));
+
+  return CMR_OKAY;
+}
+
+void CMRchrmatViewSetColumnHidden(CMR_CHRMAT_VIEW* view, size_t column, bool hidden)
+{
+  assert(view);
+  assert(column < view->numColumns);
+
+  view->parentColumns[view->columns[column]] = hidden ? SIZE_MAX : column;
+}
+
+size_t CMRchrmatViewNumNonzeros(CMR_CHRMAT_VIEW* view)
+{
+  assert(view);
+
+  CMR_CHRMAT* parent = view->parent;
+  size_t numNonzeros = 0;
+  for (size_t row = 0; row < view->numRows; ++row)
+  {
+    if (CMRchrmatViewIsRowHidden(view, row))
+      continue;
+
+    size_t parentRow = view->rows[row];
+    size_t first = parent->rowSlice[parentRow];
+    size_t beyond = parent->rowSlice[parentRow + 1];
+    for (size_t entry = first; entry < beyond; ++entry)
+    {
+      if (view->parentColumns[parent->entryColumns[entry]] != SIZE_MAX)
+        ++numNonzeros;
+    }
+  }
+
+  return numNonzeros;
+}
+
+CMR_ERROR CMRchrmatViewToSubmat(CMR* cmr, CMR_CHRMAT_VIEW* view, CMR_SUBMAT** psubmatrix)
+{
+  assert(cmr);
+  assert(view);
+  assert(psubmatrix);
+
+  size_t numRows = 0;
+  for (size_t row = 0; row < view->numRows; ++row)
+  {
+    if (!CMRchrmatViewIsRowHidden(view, row))
+      ++numRows;
+  }
+  size_t numColumns = 0;
+  for (size_t column = 0; column < view->numColumns; ++column)
+  {
+    if (!CMRchrmatViewIsColumnHidden(view, column))
+      ++numColumns;
+  }
+
+  CMR_CALL( CMRsubmatCreate(cmr, numRows, numColumns, psubmatrix) );
+  CMR_SUBMAT* submatrix = *psubmatrix;
+  numRows = 0;
+  for (size_t row = 0; row < view->numRows; ++row)
+  {
+    if (!CMRchrmatViewIsRowHidden(view, row))
+      submatrix->rows[numRows++] = view->rows[row];
+  }
+  numColumns = 0;
+  for (size_t column = 0; column < view->numColumns; ++column)
+  {
+    if (!CMRchrmatViewIsColumnHidden(view, column))
+      submatrix->columns[numColumns++] = view->columns[column];
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRchrmatViewMaterialize(CMR* cmr, CMR_CHRMAT_VIEW* view, CMR_CHRMAT** presult)
+{
+  assert(cmr);
+  assert(view);
+  assert(presult);
+  assert(!*presult);
+
+  CMR_CHRMAT* parent = view->parent;
+  CMR_CALL( CMRchrmatCreate(cmr, presult, view->numRows, view->numColumns, CMRchrmatViewNumNonzeros(view)) );
+  CMR_CHRMAT* result = *presult;
+
+  size_t resultEntry = 0;
+  for (size_t row = 0; row < view->numRows; ++row)
+  {
+    result->rowSlice[row] = resultEntry;
+    if (CMRchrmatViewIsRowHidden(view, row))
+      continue;
+
+    size_t parentRow = view->rows[row];
+    size_t first = parent->rowSlice[parentRow];
+    size_t beyond = parent->rowSlice[parentRow + 1];
+    for (size_t entry = first; entry < beyond; ++entry)
+    {
+      size_t column = view->parentColumns[parent->entryColumns[entry]];
+      if (column == SIZE_MAX)
+        continue;
+      result->entryColumns[resultEntry] = column;
+      result->entryValues[resultEntry] = parent->entryValues[entry];
+      ++resultEntry;
+    }
+  }
+  result->rowSlice[view->numRows] = resultEntry;
+  assert(resultEntry == result->numNonzeros);
+
+  /* The nonzeros are only sorted if the column map is monotone. */
+  for (size_t column = 1; column < view->numColumns; ++column)
+  {
+    if (view->columns[column - 1] > view->columns[column])
+    {
+      CMR_CALL( CMRchrmatSortNonzeros(cmr, result) );
+      break;
+    }
+  }
+
+  CMRconsistencyAssert( CMRchrmatConsistency(result) );
+
+  return CMR_OKAY;
+}
@@ -1,15 +1,213 @@
 // #define CMR_DEBUG /* Uncomment to debug this file. */
 
 #include <cmr/matroid.h>
+#include <cmr/graphic.h>
+#include <cmr/network.h>
 
 #include "env_internal.h"
 #include "matroid_internal.h"
 #include "matrix_internal.h"
 #include "listmatrix.h"
+#include "densematrix.h"
 
 #include <assert.h>
+#include <float.h>
 #include <string.h>
 
+/**
+ * \brief The pivots are carried out on bit-packed rows as soon as at least one in this many entries is a nonzero.
+ */
+
+#define PIVOTS_DENSE_RATIO 64
+
+/**
+ * \brief Adds \p factor times row \p sourceRow to row \p targetRow over GF(3).
+ *
+ * The two bit planes \p plus and \p minus store the entries equal to \f$ 1 \f$ and to \f$ -1 \f$, respectively.
+ */
+
+static
+void denseTernaryRowAdd(
+  DenseBinaryMatrix* plus,  /**< Bit plane of entries equal to 1. */
+  DenseBinaryMatrix* minus, /**< Bit plane of entries equal to -1. */
+  size_t targetRow,         /**< Row that is modified. */
+  size_t sourceRow,         /**< Row that is added. */
+  int factor                /**< Factor; either 1 or -1. */
+)
+{
+  uint64_t* targetPlus = CMRdensebinmatrixRow(plus, targetRow);
+  uint64_t* targetMinus = CMRdensebinmatrixRow(minus, targetRow);
+  const uint64_t* sourcePlus = CMRdensebinmatrixRow(factor > 0 ? plus : minus, sourceRow);
+  const uint64_t* sourceMinus = CMRdensebinmatrixRow(factor > 0 ? minus : plus, sourceRow);
+  for (size_t w = 0; w < plus->stride; ++w)
+  {
+    uint64_t t = (targetPlus[w] | sourceMinus[w]) ^ (targetMinus[w] | sourcePlus[w]);
+    uint64_t resultPlus = (targetMinus[w] | sourceMinus[w]) ^ t;
+    targetMinus[w] = (targetPlus[w] | sourcePlus[w]) ^ t;
+    targetPlus[w] = resultPlus;
+  }
+}
+
+/**
+ * \brief Returns the entry of the bit-packed matrix in \f$ \{-1,0,1\} \f$; \p minus is \c NULL over GF(2).
+ */
+
+static inline
+int denseGet(
+  DenseBinaryMatrix* plus,  /**< Bit plane of entries equal to 1. */
+  DenseBinaryMatrix* minus, /**< Bit plane of entries equal to -1, or \c NULL. */
+  size_t row,               /**< Row. */
+  size_t column             /**< Column. */
+)
+{
+  if (CMRdensebinmatrixGet(plus, row, column))
+    return 1;
+  return (minus && CMRdensebinmatrixGet(minus, row, column)) ? -1 : 0;
+}
+
+/**
+ * \brief Sets the entry of the bit-packed matrix to \p value, which is taken modulo the characteristic.
+ */
+
+static inline
+void denseSet(
+  DenseBinaryMatrix* plus,  /**< Bit plane of entries equal to 1. */
+  DenseBinaryMatrix* minus, /**< Bit plane of entries equal to -1, or \c NULL. */
+  size_t row,               /**< Row. */
+  size_t column,            /**< Column. */
+  int value                 /**< New value. */
+)
+{
+  int characteristic = minus ? 3 : 2;
+  value = ((value % characteristic) + characteristic) % characteristic;
+  CMRdensebinmatrixSet(plus, row, column, value == 1);
+  if (minus)
+    CMRdensebinmatrixSet(minus, row, column, value == 2);
+}
+
+/**
+ * \brief Carries out the remaining pivots of \ref computePivots on bit-packed rows.
+ *
+ * The matrix is given by \p listmat, whose duplicate entries are summed up. Each pivot adds a multiple of the pivot row
+ * to every other row with a nonzero in the pivot column, word by word.
+ */
+
+static
+CMR_ERROR computePivotsDense(
+  CMR* cmr,               /**< \ref CMR environment. */
+  ListMat8* listmat,      /**< Current matrix. */
+  size_t numPivots,       /**< Number of remaining pivots. */
+  size_t* pivotRows,      /**< Array with rows of the remaining pivots. */
+  size_t* pivotColumns,   /**< Array with columns of the remaining pivots. */
+  int8_t characteristic,  /**< Characteristic of the field; either 2 or 3. */
+  CMR_CHRMAT** presult    /**< Pointer for storing the resulting matrix. */
+)
+{
+  assert(cmr);
+  assert(listmat);
+  assert(presult);
+
+  size_t numRows = listmat->numRows;
+  size_t numColumns = listmat->numColumns;
+
+  CMRdbgMsg(2, "Switching to bit-packed rows for the remaining %zu pivots.\n", numPivots);
+
+  DenseBinaryMatrix* plus = NULL;
+  CMR_CALL( CMRdensebinmatrixCreate(cmr, numRows, numColumns, &plus) );
+  DenseBinaryMatrix* minus = NULL;
+  if (characteristic == 3)
+    CMR_CALL( CMRdensebinmatrixCreate(cmr, numRows, numColumns, &minus) );
+
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    ListMat8Nonzero* head = &listmat->rowElements[row].head;
+    for (ListMat8Nonzero* nz = head->right; nz != head; nz = nz->right)
+      denseSet(plus, minus, row, nz->column, denseGet(plus, minus, row, nz->column) + nz->value);
+  }
+
+  CMR_ERROR error = CMR_OKAY;
+  for (size_t pivot = 0; pivot < numPivots; ++pivot)
+  {
+    size_t pivotRow = pivotRows[pivot];
+    size_t pivotColumn = pivotColumns[pivot];
+    int pivotValue = denseGet(plus, minus, pivotRow, pivotColumn);
+    if (pivotValue == 0)
+    {
+      error = CMR_ERROR_INPUT;
+      break;
+    }
+
+    /* Row i becomes row i - pivotValue * A[i][pivotColumn] * pivot row, followed by pivotValue * A[i][pivotColumn] in
+     * the pivot column. */
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      int rowValue;
+      if (row == pivotRow || !(rowValue = denseGet(plus, minus, row, pivotColumn)))
+        continue;
+
+      if (minus)
+        denseTernaryRowAdd(plus, minus, row, pivotRow, -pivotValue * rowValue);
+      else
+        CMRdensebinmatrixRowXor(plus, row, pivotRow);
+      denseSet(plus, minus, row, pivotColumn, pivotValue * rowValue);
+    }
+
+    /* Over GF(3), the pivot row is scaled by the pivot value. */
+    if (pivotValue < 0)
+    {
+      uint64_t* rowPlus = CMRdensebinmatrixRow(plus, pivotRow);
+      uint64_t* rowMinus = CMRdensebinmatrixRow(minus, pivotRow);
+      for (size_t w = 0; w < plus->stride; ++w)
+      {
+        uint64_t temp = rowPlus[w];
+        rowPlus[w] = rowMinus[w];
+        rowMinus[w] = temp;
+      }
+    }
+    denseSet(plus, minus, pivotRow, pivotColumn, -pivotValue);
+  }
+
+  if (error == CMR_OKAY)
+  {
+    size_t numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      numNonzeros += CMRdensebinmatrixRowCount(plus, row);
+      if (minus)
+        numNonzeros += CMRdensebinmatrixRowCount(minus, row);
+    }
+
+    CMR_CALL( CMRchrmatCreate(cmr, presult, numRows, numColumns, numNonzeros) );
+    CMR_CHRMAT* result = *presult;
+    size_t entry = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      result->rowSlice[row] = entry;
+      const uint64_t* rowPlus = CMRdensebinmatrixRow(plus, row);
+      const uint64_t* rowMinus = minus ? CMRdensebinmatrixRow(minus, row) : NULL;
+      for (size_t w = 0; w < plus->stride; ++w)
+      {
+        uint64_t word = rowPlus[w] | (rowMinus ? rowMinus[w] : 0);
+        while (word)
+        {
+          size_t bit = CMRbitsetLowest(word);
+          result->entryColumns[entry] = 64 * w + bit;
+          result->entryValues[entry] = ((rowPlus[w] >> bit) & 1) ? 1 : -1;
+          ++entry;
+          word &= word - 1;
+        }
+      }
+    }
+    result->rowSlice[numRows] = entry;
+    assert(entry == numNonzeros);
+  }
+
+  CMR_CALL( CMRdensebinmatrixFree(cmr, &minus) );
+  CMR_CALL( CMRdensebinmatrixFree(cmr, &plus) );
+
+  return error;
+}
+
 static
 CMR_ERROR computePivots(CMR* cmr, CMR_CHRMAT* matrix, size_t numPivots, size_t* pivotRows, size_t* pivotColumns,
   int8_t characteristic, CMR_CHRMAT** presult)
@@ -50,6 +248,17 @@ CMR_ERROR computePivots(CMR* cmr, CMR_CHRMAT* matrix, size_t numPivots, size_t*
 
   for (size_t pivot = 0; pivot < numPivots; ++pivot)
   {
+    /* Once the matrix is dense enough, word-parallel row operations are faster than inserting entries. The dense
+     * copies are only created if they fit into the memory limit with room to spare. */
+    if (matrix->numRows > 0 && matrix->numColumns > 0
+      && listmat->numNonzeros / matrix->numColumns >= matrix->numRows / PIVOTS_DENSE_RATIO
+      && !CMRisMemoryShort(cmr, 2 * (matrix->numRows * matrix->numColumns / 8)))
+    {
+      error = computePivotsDense(cmr, listmat, numPivots - pivot, &pivotRows[pivot], &pivotColumns[pivot],
+        characteristic, presult);
+      goto cleanup;
+    }
+
     size_t pivotRow = pivotRows[pivot];
     size_t pivotColumn = pivotColumns[pivot];
 
@@ -279,6 +488,8 @@ CMR_ERROR CMRminorCreate(CMR* cmr, CMR_MINOR** pminor, size_t numPivots, CMR_SUB
   CMR_CALL( CMRallocBlock(cmr, pminor) );
   CMR_MINOR* minor = *pminor;
   minor->numPivots = numPivots;
+  minor->pivotRows = NULL;
+  minor->pivotColumns = NULL;
   CMR_CALL( CMRallocBlockArray(cmr, &minor->pivotRows, numPivots) );
   CMR_CALL( CMRallocBlockArray(cmr, &minor->pivotColumns, numPivots) );
   minor->remainingSubmatrix = submatrix;
@@ -309,6 +520,13 @@ CMR_ERROR CMRminorPrint(CMR* cmr, CMR_MINOR* minor, size_t numRows, size_t numCo
   assert(minor);
   assert(stream);
 
+  /* The pivots precede the submatrix, one per line and 1-based, such that minors without pivots look as before. */
+  if (minor->numPivots > 0)
+  {
+    fprintf(stream, "%zu pivots\n", minor->numPivots);
+    for (size_t p = 0; p < minor->numPivots; ++p)
+      fprintf(stream, "%zu %zu\n", minor->pivotRows[p] + 1, minor->pivotColumns[p] + 1);
+  }
   CMR_CALL( CMRsubmatPrint(cmr, minor->remainingSubmatrix, numRows, numColumns, stream) );
 
   return CMR_OKAY;
@@ -576,6 +794,84 @@ bool* CMRmatroiddecCographArcsReversed(CMR_MATROID_DEC* dec)
   return dec->cographArcsReversed;
 }
 
+CMR_ERROR CMRmatroiddecConstructGraph(CMR* cmr, CMR_MATROID_DEC* dec)
+{
+  assert(cmr);
+  assert(dec);
+
+  if (dec->graph)
+    return CMR_OKAY;
+
+  if (dec->graphicness <= 0)
+  {
+    CMRraiseErrorMessage(cmr, "Decomposition node is not known to be %s.", dec->isTernary ? "network" : "graphic");
+    return CMR_ERROR_INPUT;
+  }
+
+  /* We carry out the same test as CMRregularityTestGraphicness. */
+  bool isGraphic;
+  if (dec->isTernary)
+  {
+    if (!dec->transpose)
+      CMR_CALL( CMRchrmatTranspose(cmr, dec->matrix, &dec->transpose) );
+    CMR_CALL( CMRnetworkTestTranspose(cmr, dec->transpose, &isGraphic, NULL, &dec->graph, &dec->graphForest,
+      &dec->graphCoforest, &dec->graphArcsReversed, NULL, NULL, DBL_MAX) );
+  }
+  else
+  {
+    if (!dec->matrix)
+      CMR_CALL( CMRchrmatTranspose(cmr, dec->transpose, &dec->matrix) );
+    CMR_CALL( CMRgraphicTestMatrix(cmr, dec->matrix, &isGraphic, &dec->graph, &dec->graphForest, &dec->graphCoforest,
+      NULL, NULL, DBL_MAX) );
+  }
+
+  if (!isGraphic)
+  {
+    CMRraiseErrorMessage(cmr, "Decomposition node is not %s.", dec->isTernary ? "network" : "graphic");
+    return CMR_ERROR_INPUT;
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmatroiddecConstructCograph(CMR* cmr, CMR_MATROID_DEC* dec)
+{
+  assert(cmr);
+  assert(dec);
+
+  if (dec->cograph)
+    return CMR_OKAY;
+
+  if (dec->cographicness <= 0)
+  {
+    CMRraiseErrorMessage(cmr, "Decomposition node is not known to be %s.", dec->isTernary ? "conetwork" : "cographic");
+    return CMR_ERROR_INPUT;
+  }
+
+  /* We carry out the same test as CMRregularityTestCographicness. */
+  if (!dec->matrix)
+    CMR_CALL( CMRchrmatTranspose(cmr, dec->transpose, &dec->matrix) );
+  bool isCographic;
+  if (dec->isTernary)
+  {
+    CMR_CALL( CMRnetworkTestTranspose(cmr, dec->matrix, &isCographic, NULL, &dec->cograph, &dec->cographForest,
+      &dec->cographCoforest, &dec->cographArcsReversed, NULL, NULL, DBL_MAX) );
+  }
+  else
+  {
+    CMR_CALL( CMRgraphicTestTranspose(cmr, dec->matrix, &isCographic, &dec->cograph, &dec->cographForest,
+      &dec->cographCoforest, NULL, NULL, DBL_MAX) );
+  }
+
+  if (!isCographic)
+  {
+    CMRraiseErrorMessage(cmr, "Decomposition node is not %s.", dec->isTernary ? "conetwork" : "cographic");
+    return CMR_ERROR_INPUT;
+  }
+
+  return CMR_OKAY;
+}
+
 size_t CMRmatroiddecNumPivots(CMR_MATROID_DEC* dec)
 {
   assert(dec);
@@ -632,15 +928,27 @@ CMR_ERROR CMRmatroiddecPrint(CMR* cmr, CMR_MATROID_DEC* dec, FILE* stream, size_
     fprintf(stream, "3-sum node {");
   break;
   case CMR_MATROID_DEC_TYPE_GRAPH:
-    fprintf(stream, "graphic matrix with %zu nodes and %zu edges {", CMRgraphNumNodes(dec->graph), CMRgraphNumEdges(dec->graph));
+    /* The graphs may not have been kept, see CMR_REGULAR_PARAMS::graphs. */
+    if (dec->graph)
+      fprintf(stream, "graphic matrix with %zu nodes and %zu edges {", CMRgraphNumNodes(dec->graph), CMRgraphNumEdges(dec->graph));
+    else
+      fprintf(stream, "graphic matrix {");
   break;
   case CMR_MATROID_DEC_TYPE_COGRAPH:
-    fprintf(stream, "cographic matrix with %zu nodes and %zu edges {", CMRgraphNumNodes(dec->cograph), CMRgraphNumEdges(dec->cograph));
+    if (dec->cograph)
+      fprintf(stream, "cographic matrix with %zu nodes and %zu edges {", CMRgraphNumNodes(dec->cograph), CMRgraphNumEdges(dec->cograph));
+    else
+      fprintf(stream, "cographic matrix {");
   break;
   case CMR_MATROID_DEC_TYPE_PLANAR:
-    assert(CMRgraphNumEdges(dec->graph) == CMRgraphNumEdges(dec->cograph));
-    fprintf(stream, "planar matrix with %zu nodes, %zu faces and %zu edges {", CMRgraphNumNodes(dec->graph),
-      CMRgraphNumNodes(dec->cograph), CMRgraphNumEdges(dec->graph));
+    if (dec->graph && dec->cograph)
+    {
+      assert(CMRgraphNumEdges(dec->graph) == CMRgraphNumEdges(dec->cograph));
+      fprintf(stream, "planar matrix with %zu nodes, %zu faces and %zu edges {", CMRgraphNumNodes(dec->graph),
+        CMRgraphNumNodes(dec->cograph), CMRgraphNumEdges(dec->graph));
+    }
+    else
+      fprintf(stream, "planar matrix {");
   break;
   case CMR_MATROID_DEC_TYPE_SERIES_PARALLEL:
     if (dec->numChildren)
@@ -818,26 +1126,10 @@ CMR_ERROR CMRmatroiddecPrint(CMR* cmr, CMR_MATROID_DEC* dec, FILE* stream, size_
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRmatroiddecFreeNode(CMR* cmr, CMR_MATROID_DEC** pdec)
+CMR_ERROR CMRmatroiddecFreeGraphs(CMR* cmr, CMR_MATROID_DEC* dec)
 {
   assert(cmr);
-  assert(pdec);
-
-  CMR_MATROID_DEC* dec = *pdec;
-  if (!dec)
-    return CMR_OKAY;
-
-  CMR_CALL( CMRchrmatFree(cmr, &dec->matrix) );
-  CMR_CALL( CMRchrmatFree(cmr, &dec->transpose) );
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->children) );
-
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->rowsChild) );
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->rowsParent) );
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->rowsRootElement) );
-
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->columnsChild) );
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->columnsParent) );
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->columnsRootElement) );
+  assert(dec);
 
   CMR_CALL( CMRgraphFree(cmr, &dec->graph) );
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->graphForest) );
@@ -849,10 +1141,16 @@ CMR_ERROR CMRmatroiddecFreeNode(CMR* cmr, CMR_MATROID_DEC** pdec)
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->cographCoforest) );
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->cographArcsReversed) );
 
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->seriesParallelReductions) );
+  return CMR_OKAY;
+}
 
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->pivotRows) );
-  CMR_CALL( CMRfreeBlockArray(cmr, &dec->pivotColumns) );
+CMR_ERROR CMRmatroiddecFreeIntermediate(CMR* cmr, CMR_MATROID_DEC* dec)
+{
+  assert(cmr);
+  assert(dec);
+
+  if (dec->matrix)
+    CMR_CALL( CMRchrmatFree(cmr, &dec->transpose) );
 
   CMR_CALL( CMRdensebinmatrixFree(cmr, &dec->denseMatrix) );
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->denseRowsOriginal) );
@@ -860,6 +1158,7 @@ CMR_ERROR CMRmatroiddecFreeNode(CMR* cmr, CMR_MATROID_DEC** pdec)
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->nestedMinorsRowsDense) );
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->nestedMinorsColumnsDense) );
 
+  dec->nestedMinorsLength = 0;
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->nestedMinorsSequenceNumRows) );
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->nestedMinorsSequenceNumColumns) );
 
@@ -868,6 +1167,41 @@ CMR_ERROR CMRmatroiddecFreeNode(CMR* cmr, CMR_MATROID_DEC** pdec)
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->nestedMinorsRowsOriginal) );
   CMR_CALL( CMRfreeBlockArray(cmr, &dec->nestedMinorsColumnsOriginal) );
 
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmatroiddecFreeNode(CMR* cmr, CMR_MATROID_DEC** pdec)
+{
+  assert(cmr);
+  assert(pdec);
+
+  CMR_MATROID_DEC* dec = *pdec;
+  if (!dec)
+    return CMR_OKAY;
+
+  CMR_CALL( CMRchrmatFree(cmr, &dec->matrix) );
+  CMR_CALL( CMRchrmatFree(cmr, &dec->transpose) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->children) );
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->rowsChild) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->rowsParent) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->rowsRootElement) );
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->columnsChild) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->columnsParent) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->columnsRootElement) );
+
+  CMR_CALL( CMRmatroiddecFreeGraphs(cmr, dec) );
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->seriesParallelReductions) );
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->pivotRows) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->pivotColumns) );
+
+  CMR_CALL( CMRmatroiddecFreeIntermediate(cmr, dec) );
+
+  CMR_CALL( CMRminorFree(cmr, &dec->irregularMinor) );
+
   CMR_CALL( CMRfreeBlock(cmr, pdec) );
 
   return CMR_OKAY;
@@ -957,6 +1291,7 @@ CMR_ERROR createNode(
   }
 
   dec->testedTwoConnected = false;
+  dec->testedTwoSum = false;
   dec->testedR10 = false;
 
   dec->graph = NULL;
@@ -995,6 +1330,8 @@ CMR_ERROR createNode(
   dec->nestedMinorsLastGraphic = SIZE_MAX;
   dec->nestedMinorsLastCographic = SIZE_MAX;
 
+  dec->irregularMinor = NULL;
+
   return CMR_OKAY;
 }
 
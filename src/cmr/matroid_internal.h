@@ -17,6 +17,8 @@ struct _CMR_MATROID_DEC
   CMR_MATROID_DEC_TYPE type;                  /**< \brief Type of this node. */
   bool isTernary;                             /**< \brief Indicates whether this node belongs to a ternary matrix. */
   bool testedTwoConnected;                    /**< \brief Indicates that no 1-separation exists. */
+  bool testedTwoSum;                          /**< \brief Already searched for 2-separations at cut vertices of the
+                                               **         support graph. */
   int8_t regularity;                          /**< \brief Matrix is (not) regular/totally unimodularity if positive
                                                **         (negative), or not determined if zero. */
   int8_t graphicness;                         /**< \brief Matrix is (not) graphic/network if positive
@@ -84,6 +86,9 @@ struct _CMR_MATROID_DEC
 
   size_t nestedMinorsLastGraphic;             /**< \brief Last minor in sequence of nested minors that is graphic. */
   size_t nestedMinorsLastCographic;           /**< \brief Last minor in sequence of nested minors that is cographic. */
+
+  CMR_MINOR* irregularMinor;                  /**< \brief \f$ F_7 \f$ or \f$ F_7^\star \f$ minor of \ref matrix found at
+                                               **         this irregular node, or \c NULL. */
 };
 
 /**
@@ -234,6 +239,27 @@ CMR_ERROR CMRmatroiddecUpdateThreeSumCreateWideSecondChild(
   int8_t extraEntry           /**< Sign of the extra entry, if known. */
 );
 
+/**
+ * \brief Frees the graph and the cograph of a decomposition node, keeping its (co)graphicness.
+ */
+
+CMR_ERROR CMRmatroiddecFreeGraphs(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec  /**< Decomposition node. */
+);
+
+/**
+ * \brief Frees the data of a decomposition node that is only needed while it is processed.
+ *
+ * This affects the transpose (unless it is the only representation of the matrix), the dense matrix and the sequence
+ * of nested minors.
+ */
+
+CMR_ERROR CMRmatroiddecFreeIntermediate(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec  /**< Decomposition node. */
+);
+
 /**
  * \brief Set regularity and (co)graphicness attributes of a decomposition tree.
  */
@@ -0,0 +1,960 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/matroid.h>
+
+#include "env_internal.h"
+#include "io_internal.h"
+#include "matroid_internal.h"
+#include "densematrix.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * \brief Magic bytes at the beginning of each binary decomposition file.
+ */
+
+static const char DEC_MAGIC[8] = { 'C', 'M', 'R', '-', 'D', 'E', 'C', '\n' };
+
+#define DEC_VERSION 1       /**< Version of the binary decomposition format written by this implementation. */
+#define DEC_HEADER_SIZE 64  /**< Size of the header of a binary decomposition file in bytes. */
+#define DEC_NONE UINT64_MAX /**< Encoding of a missing array, graph or matrix as well as of \c SIZE_MAX. */
+
+/* Bits of the flags byte of a node record. */
+#define DEC_FLAG_TERNARY              1   /**< Node belongs to a ternary matrix. */
+#define DEC_FLAG_TWO_CONNECTED        2   /**< Node was tested for 1-separations. */
+#define DEC_FLAG_R10                  4   /**< Node was tested for representing \f$ R_{10} \f$. */
+#define DEC_FLAG_SERIES_PARALLEL      8   /**< Node was tested for series-parallel reductions. */
+#define DEC_FLAG_TRANSPOSE            16  /**< Node has the transpose of its matrix. */
+#define DEC_FLAG_NESTED_TRANSPOSE     32  /**< Node has the transpose of its nested minors matrix. */
+#define DEC_FLAG_TWO_SUM              64  /**< Node was tested for 2-separations at cut vertices. */
+
+/**
+ * \brief Growable array of bytes.
+ */
+
+typedef struct
+{
+  unsigned char* bytes; /**< \brief Bytes. */
+  size_t length;        /**< \brief Number of used bytes. */
+  size_t memory;        /**< \brief Number of allocated bytes. */
+} DecBuffer;
+
+/**
+ * \brief State of a writer of a binary decomposition file.
+ */
+
+typedef struct
+{
+  DecBuffer records;      /**< \brief Node records. */
+  size_t numNodes;        /**< \brief Number of written nodes. */
+  size_t dataLength;      /**< \brief Length of the data section in bytes. */
+  CMR_CHRMAT** matrices;  /**< \brief Matrices of the data section in the order of their offsets. */
+  size_t numMatrices;     /**< \brief Length of \ref matrices. */
+  size_t memMatrices;     /**< \brief Memory of \ref matrices. */
+} DecWriter;
+
+/**
+ * \brief Returns the number of bytes of \p matrix in the binary matrix format.
+ */
+
+static
+size_t decMatrixBlobSize(
+  CMR_CHRMAT* matrix  /**< Matrix. */
+)
+{
+  return 64 + 8 * (matrix->numRows + 1) + 9 * matrix->numNonzeros;
+}
+
+/**
+ * \brief Returns the number of bytes that \p matrix occupies in the data section.
+ *
+ * The matrix is stored in the binary matrix format, padded to a multiple of 8 bytes.
+ */
+
+static
+size_t decMatrixSize(
+  CMR_CHRMAT* matrix  /**< Matrix. */
+)
+{
+  return (decMatrixBlobSize(matrix) + 7) & ~((size_t) 7);
+}
+
+/**
+ * \brief Appends \p value with \p numBytes bytes in little-endian order to \p buffer.
+ */
+
+static
+CMR_ERROR decWriteNumber(
+  CMR* cmr,           /**< \ref CMR environment. */
+  DecBuffer* buffer,  /**< Buffer. */
+  size_t numBytes,    /**< Number of bytes. */
+  uint64_t value      /**< Value to write. */
+)
+{
+  if (buffer->length + numBytes > buffer->memory)
+  {
+    buffer->memory = 2 * buffer->memory + numBytes + 256;
+    CMR_CALL( CMRreallocBlockArray(cmr, &buffer->bytes, buffer->memory) );
+  }
+  CMRstoreLittleEndian(&buffer->bytes[buffer->length], numBytes, value);
+  buffer->length += numBytes;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Appends an index, mapping \c SIZE_MAX to \ref DEC_NONE.
+ */
+
+static
+CMR_ERROR decWriteIndex(
+  CMR* cmr,           /**< \ref CMR environment. */
+  DecBuffer* buffer,  /**< Buffer. */
+  size_t value        /**< Index to write. */
+)
+{
+  return decWriteNumber(cmr, buffer, 8, value == SIZE_MAX ? DEC_NONE : (uint64_t) value);
+}
+
+/**
+ * \brief Appends the length of \p array followed by its entries, or just \ref DEC_NONE if it is \c NULL.
+ */
+
+static
+CMR_ERROR decWriteIndexArray(
+  CMR* cmr,           /**< \ref CMR environment. */
+  DecBuffer* buffer,  /**< Buffer. */
+  size_t* array,      /**< Array (may be \c NULL). */
+  size_t length       /**< Length of \p array. */
+)
+{
+  if (!array)
+    return decWriteNumber(cmr, buffer, 8, DEC_NONE);
+
+  CMR_CALL( decWriteNumber(cmr, buffer, 8, length) );
+  for (size_t i = 0; i < length; ++i)
+    CMR_CALL( decWriteIndex(cmr, buffer, array[i]) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Appends the length of \p array followed by its entries, or just \ref DEC_NONE if it is \c NULL.
+ */
+
+static
+CMR_ERROR decWriteElementArray(
+  CMR* cmr,             /**< \ref CMR environment. */
+  DecBuffer* buffer,    /**< Buffer. */
+  CMR_ELEMENT* array,   /**< Array (may be \c NULL). */
+  size_t length         /**< Length of \p array. */
+)
+{
+  if (!array)
+    return decWriteNumber(cmr, buffer, 8, DEC_NONE);
+
+  CMR_CALL( decWriteNumber(cmr, buffer, 8, length) );
+  for (size_t i = 0; i < length; ++i)
+    CMR_CALL( decWriteNumber(cmr, buffer, 4, (uint32_t) (int32_t) array[i]) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Appends the offset of \p matrix in the data section, or \ref DEC_NONE if it is \c NULL.
+ */
+
+static
+CMR_ERROR decWriteMatrix(
+  CMR* cmr,           /**< \ref CMR environment. */
+  DecWriter* writer,  /**< Writer. */
+  CMR_CHRMAT* matrix  /**< Matrix (may be \c NULL). */
+)
+{
+  if (!matrix)
+    return decWriteNumber(cmr, &writer->records, 8, DEC_NONE);
+
+  CMR_CALL( decWriteNumber(cmr, &writer->records, 8, writer->dataLength) );
+  if (writer->numMatrices == writer->memMatrices)
+  {
+    writer->memMatrices = 2 * writer->memMatrices + 16;
+    CMR_CALL( CMRreallocBlockArray(cmr, &writer->matrices, writer->memMatrices) );
+  }
+  writer->matrices[writer->numMatrices++] = matrix;
+  writer->dataLength += decMatrixSize(matrix);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Appends a (co)graph with its forest, coforest and arc directions.
+ *
+ * Nodes and edges are numbered consecutively in the order of their indices, and the (co)forest refers to positions in
+ * the edge list.
+ */
+
+static
+CMR_ERROR decWriteGraph(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  DecBuffer* buffer,        /**< Buffer. */
+  CMR_GRAPH* graph,         /**< Graph (may be \c NULL). */
+  CMR_GRAPH_EDGE* forest,   /**< Array with forest edges (may be \c NULL). */
+  size_t forestLength,      /**< Length of \p forest. */
+  CMR_GRAPH_EDGE* coforest, /**< Array with coforest edges (may be \c NULL). */
+  size_t coforestLength,    /**< Length of \p coforest. */
+  bool* arcsReversed        /**< Array indicating reversed arcs (may be \c NULL). */
+)
+{
+  if (!graph)
+    return decWriteNumber(cmr, buffer, 8, DEC_NONE);
+
+  /* Nodes and edges are written in the order of their indices, such that compact graphs retain their indices. */
+  size_t memNodes = CMRgraphMemNodes(graph);
+  size_t memEdges = CMRgraphMemEdges(graph);
+  size_t* nodeIndices = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &nodeIndices, memNodes + 1) );
+  size_t* edgeIndices = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &edgeIndices, memEdges + 1) );
+  for (size_t v = 0; v < memNodes; ++v)
+    nodeIndices[v] = SIZE_MAX;
+  for (size_t e = 0; e < memEdges; ++e)
+    edgeIndices[e] = SIZE_MAX;
+  for (CMR_GRAPH_NODE v = CMRgraphNodesFirst(graph); CMRgraphNodesValid(graph, v);
+    v = CMRgraphNodesNext(graph, v))
+  {
+    nodeIndices[v] = 0;
+  }
+  for (CMR_GRAPH_ITER i = CMRgraphEdgesFirst(graph); CMRgraphEdgesValid(graph, i); i = CMRgraphEdgesNext(graph, i))
+    edgeIndices[CMRgraphEdgesEdge(graph, i)] = 0;
+
+  size_t numNodes = 0;
+  for (size_t v = 0; v < memNodes; ++v)
+  {
+    if (nodeIndices[v] != SIZE_MAX)
+      nodeIndices[v] = numNodes++;
+  }
+  CMR_CALL( decWriteNumber(cmr, buffer, 8, numNodes) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 8, CMRgraphNumEdges(graph)) );
+
+  size_t numEdges = 0;
+  for (size_t e = 0; e < memEdges; ++e)
+  {
+    if (edgeIndices[e] == SIZE_MAX)
+      continue;
+    edgeIndices[e] = numEdges++;
+    CMR_CALL( decWriteNumber(cmr, buffer, 8, nodeIndices[CMRgraphEdgeU(graph, e)]) );
+    CMR_CALL( decWriteNumber(cmr, buffer, 8, nodeIndices[CMRgraphEdgeV(graph, e)]) );
+  }
+
+  for (int f = 0; f < 2; ++f)
+  {
+    CMR_GRAPH_EDGE* edges = f ? coforest : forest;
+    size_t length = f ? coforestLength : forestLength;
+    if (!edges)
+    {
+      CMR_CALL( decWriteNumber(cmr, buffer, 8, DEC_NONE) );
+      continue;
+    }
+    CMR_CALL( decWriteNumber(cmr, buffer, 8, length) );
+    for (size_t i = 0; i < length; ++i)
+      CMR_CALL( decWriteNumber(cmr, buffer, 8, edgeIndices[edges[i]]) );
+  }
+
+  CMR_CALL( decWriteNumber(cmr, buffer, 1, arcsReversed ? 1 : 0) );
+  if (arcsReversed)
+  {
+    for (size_t e = 0; e < memEdges; ++e)
+    {
+      if (edgeIndices[e] != SIZE_MAX)
+        CMR_CALL( decWriteNumber(cmr, buffer, 1, arcsReversed[e] ? 1 : 0) );
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &edgeIndices) );
+  CMR_CALL( CMRfreeStackArray(cmr, &nodeIndices) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Appends the record of \p dec and, recursively, of its children.
+ */
+
+static
+CMR_ERROR decWriteNode(
+  CMR* cmr,             /**< \ref CMR environment. */
+  DecWriter* writer,    /**< Writer. */
+  CMR_MATROID_DEC* dec  /**< Decomposition node. */
+)
+{
+  DecBuffer* buffer = &writer->records;
+  writer->numNodes++;
+
+  int flags = (dec->isTernary ? DEC_FLAG_TERNARY : 0) | (dec->testedTwoConnected ? DEC_FLAG_TWO_CONNECTED : 0)
+    | (dec->testedR10 ? DEC_FLAG_R10 : 0) | (dec->testedSeriesParallel ? DEC_FLAG_SERIES_PARALLEL : 0)
+    | (dec->transpose ? DEC_FLAG_TRANSPOSE : 0) | (dec->nestedMinorsTranspose ? DEC_FLAG_NESTED_TRANSPOSE : 0)
+    | (dec->testedTwoSum ? DEC_FLAG_TWO_SUM : 0);
+  CMR_CALL( decWriteNumber(cmr, buffer, 4, (uint32_t) (int32_t) dec->type) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 4, (uint32_t) dec->threesumFlags) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 1, (uint8_t) flags) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 1, (uint8_t) dec->regularity) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 1, (uint8_t) dec->graphicness) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 1, (uint8_t) dec->cographicness) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 8, dec->numChildren) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 8, dec->numRows) );
+  CMR_CALL( decWriteNumber(cmr, buffer, 8, dec->numColumns) );
+
+  /* A transpose is stored only if the matrix itself is missing. */
+  CMR_CALL( decWriteMatrix(cmr, writer, dec->matrix) );
+  CMR_CALL( decWriteMatrix(cmr, writer, dec->matrix ? NULL : dec->transpose) );
+
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->rowsChild, dec->numRows) );
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->rowsParent, dec->numRows) );
+  CMR_CALL( decWriteElementArray(cmr, buffer, dec->rowsRootElement, dec->numRows) );
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->columnsChild, dec->numColumns) );
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->columnsParent, dec->numColumns) );
+  CMR_CALL( decWriteElementArray(cmr, buffer, dec->columnsRootElement, dec->numColumns) );
+
+  CMR_CALL( decWriteGraph(cmr, buffer, dec->graph, dec->graphForest, CMRmatroiddecGraphSizeForest(dec),
+    dec->graphCoforest, CMRmatroiddecGraphSizeCoforest(dec), dec->graphArcsReversed) );
+  CMR_CALL( decWriteGraph(cmr, buffer, dec->cograph, dec->cographForest, CMRmatroiddecCographSizeForest(dec),
+    dec->cographCoforest, CMRmatroiddecCographSizeCoforest(dec), dec->cographArcsReversed) );
+
+  if (dec->seriesParallelReductions)
+  {
+    CMR_CALL( decWriteNumber(cmr, buffer, 8, dec->numSeriesParallelReductions) );
+    for (size_t r = 0; r < dec->numSeriesParallelReductions; ++r)
+    {
+      CMR_CALL( decWriteNumber(cmr, buffer, 4, (uint32_t) (int32_t) dec->seriesParallelReductions[r].element) );
+      CMR_CALL( decWriteNumber(cmr, buffer, 4, (uint32_t) (int32_t) dec->seriesParallelReductions[r].mate) );
+    }
+  }
+  else
+    CMR_CALL( decWriteNumber(cmr, buffer, 8, DEC_NONE) );
+
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->pivotRows, dec->numPivots) );
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->pivotColumns, dec->numPivots) );
+
+  /* State of the construction of a sequence of nested minors. */
+  DenseBinaryMatrix* dense = dec->denseMatrix;
+  if (dense)
+  {
+    size_t numWords = (dense->numColumns + 63) / 64;
+    CMR_CALL( decWriteNumber(cmr, buffer, 8, dense->numRows) );
+    CMR_CALL( decWriteNumber(cmr, buffer, 8, dense->numColumns) );
+    for (size_t row = 0; row < dense->numRows; ++row)
+    {
+      uint64_t* words = CMRdensebinmatrixRow(dense, row);
+      for (size_t w = 0; w < numWords; ++w)
+        CMR_CALL( decWriteNumber(cmr, buffer, 8, words[w]) );
+    }
+  }
+  else
+    CMR_CALL( decWriteNumber(cmr, buffer, 8, DEC_NONE) );
+  CMR_CALL( decWriteElementArray(cmr, buffer, dec->denseRowsOriginal, dense ? dense->numRows : 0) );
+  CMR_CALL( decWriteElementArray(cmr, buffer, dec->denseColumnsOriginal, dense ? dense->numColumns : 0) );
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->nestedMinorsRowsDense, dense ? dense->numRows : 0) );
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->nestedMinorsColumnsDense, dense ? dense->numColumns : 0) );
+
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->nestedMinorsSequenceNumRows, dec->nestedMinorsLength) );
+  CMR_CALL( decWriteIndexArray(cmr, buffer, dec->nestedMinorsSequenceNumColumns, dec->nestedMinorsLength) );
+  CMR_CALL( decWriteMatrix(cmr, writer, dec->nestedMinorsMatrix) );
+  CMR_CALL( decWriteElementArray(cmr, buffer, dec->nestedMinorsRowsOriginal, dec->numRows) );
+  CMR_CALL( decWriteElementArray(cmr, buffer, dec->nestedMinorsColumnsOriginal, dec->numColumns) );
+  CMR_CALL( decWriteIndex(cmr, buffer, dec->nestedMinorsLastGraphic) );
+  CMR_CALL( decWriteIndex(cmr, buffer, dec->nestedMinorsLastCographic) );
+
+  for (size_t c = 0; c < dec->numChildren; ++c)
+    CMR_CALL( decWriteNode(cmr, writer, dec->children[c]) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRmatroiddecPrintBinary(CMR* cmr, CMR_MATROID_DEC* dec, FILE* stream)
+{
+  assert(cmr);
+  assert(dec);
+  assert(stream);
+
+  DecWriter writer;
+  writer.records.bytes = NULL;
+  writer.records.length = 0;
+  writer.records.memory = 0;
+  writer.numNodes = 0;
+  writer.dataLength = 0;
+  writer.matrices = NULL;
+  writer.numMatrices = 0;
+  writer.memMatrices = 0;
+  CMR_CALL( decWriteNode(cmr, &writer, dec) );
+
+  /* The data section starts at a multiple of 8 bytes, such that all arrays of all matrices are aligned. */
+  size_t recordsPadding = (8 - writer.records.length % 8) % 8;
+  unsigned char header[DEC_HEADER_SIZE];
+  memset(header, 0, DEC_HEADER_SIZE);
+  memcpy(header, DEC_MAGIC, sizeof(DEC_MAGIC));
+  DecBuffer headerBuffer = { header, 8, DEC_HEADER_SIZE };
+  CMR_CALL( decWriteNumber(cmr, &headerBuffer, 4, DEC_VERSION) );
+  CMR_CALL( decWriteNumber(cmr, &headerBuffer, 4, 0) );
+  CMR_CALL( decWriteNumber(cmr, &headerBuffer, 8, writer.numNodes) );
+  CMR_CALL( decWriteNumber(cmr, &headerBuffer, 8, writer.records.length) );
+  CMR_CALL( decWriteNumber(cmr, &headerBuffer, 8, DEC_HEADER_SIZE + writer.records.length + recordsPadding) );
+  CMR_CALL( decWriteNumber(cmr, &headerBuffer, 8, writer.dataLength) );
+
+  static const unsigned char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  CMR_ERROR error = CMR_OKAY;
+  if (fwrite(header, 1, DEC_HEADER_SIZE, stream) != DEC_HEADER_SIZE
+    || fwrite(writer.records.bytes, 1, writer.records.length, stream) != writer.records.length
+    || fwrite(zeros, 1, recordsPadding, stream) != recordsPadding)
+  {
+    CMRraiseErrorMessage(cmr, "Could not write binary decomposition file.");
+    error = CMR_ERROR_OUTPUT;
+  }
+
+  for (size_t m = 0; m < writer.numMatrices && !error; ++m)
+  {
+    CMR_CHRMAT* matrix = writer.matrices[m];
+    error = CMRchrmatPrintBinary(cmr, matrix, stream);
+    size_t padding = decMatrixSize(matrix) - decMatrixBlobSize(matrix);
+    if (!error && fwrite(zeros, 1, padding, stream) != padding)
+    {
+      CMRraiseErrorMessage(cmr, "Could not write binary decomposition file.");
+      error = CMR_ERROR_OUTPUT;
+    }
+  }
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &writer.matrices) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &writer.records.bytes) );
+
+  return error;
+}
+
+/**
+ * \brief Pending read of a matrix from the data section.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT** pmatrix;     /**< \brief Pointer for storing the matrix. */
+  CMR_CHRMAT** ptranspose;  /**< \brief Pointer for storing its transpose, or \c NULL if it is not needed. */
+  uint64_t offset;          /**< \brief Offset in the data section. */
+  size_t numRows;           /**< \brief Expected number of rows. */
+  size_t numColumns;        /**< \brief Expected number of columns. */
+} DecPendingMatrix;
+
+/**
+ * \brief State of a reader of a binary decomposition file.
+ */
+
+typedef struct
+{
+  unsigned char* bytes;       /**< \brief Node records. */
+  size_t length;              /**< \brief Length of \ref bytes. */
+  size_t position;            /**< \brief Current position in \ref bytes. */
+  bool invalid;               /**< \brief Whether the records ended prematurely or contained invalid values. */
+  size_t numNodes;            /**< \brief Number of nodes read so far. */
+  size_t maxNodes;            /**< \brief Number of nodes according to the header. */
+  DecPendingMatrix* pending;  /**< \brief Matrices to be read from the data section. */
+  size_t numPending;          /**< \brief Length of \ref pending. */
+  size_t memPending;          /**< \brief Memory of \ref pending. */
+} DecReader;
+
+/**
+ * \brief Reads a number with \p numBytes bytes in little-endian order from the records.
+ *
+ * Marks the reader as invalid if the records end prematurely.
+ */
+
+static
+uint64_t decReadNumber(
+  DecReader* reader,  /**< Reader. */
+  size_t numBytes     /**< Number of bytes. */
+)
+{
+  if (reader->invalid || reader->length - reader->position < numBytes)
+  {
+    reader->invalid = true;
+    return 0;
+  }
+
+  uint64_t value = CMRloadLittleEndian(&reader->bytes[reader->position], numBytes);
+  reader->position += numBytes;
+
+  return value;
+}
+
+/**
+ * \brief Reads an index, mapping \ref DEC_NONE to \c SIZE_MAX.
+ */
+
+static
+size_t decReadIndex(
+  DecReader* reader   /**< Reader. */
+)
+{
+  uint64_t value = decReadNumber(reader, 8);
+  if (value == DEC_NONE)
+    return SIZE_MAX;
+  if (value >= SIZE_MAX)
+    reader->invalid = true;
+  return (size_t) value;
+}
+
+/**
+ * \brief Reads the length of an array with entries of \p entrySize bytes and checks that they can be read.
+ *
+ * \returns \c false if the array is missing or the reader is invalid.
+ */
+
+static
+bool decReadLength(
+  DecReader* reader,  /**< Reader. */
+  size_t entrySize,   /**< Size of each entry in bytes. */
+  size_t* plength     /**< Pointer for storing the length. */
+)
+{
+  uint64_t length = decReadNumber(reader, 8);
+  if (reader->invalid || length == DEC_NONE)
+    return false;
+  if (length > (reader->length - reader->position) / entrySize)
+  {
+    reader->invalid = true;
+    return false;
+  }
+  *plength = (size_t) length;
+  return true;
+}
+
+/**
+ * \brief Reads an array of indices of the given \p length, or a missing one.
+ *
+ * The array may be allocated with at least \p capacity entries.
+ */
+
+static
+CMR_ERROR decReadIndexArray(
+  CMR* cmr,           /**< \ref CMR environment. */
+  DecReader* reader,  /**< Reader. */
+  size_t length,      /**< Expected length. */
+  size_t capacity,    /**< Number of entries to allocate; at least \p length. */
+  size_t** parray     /**< Pointer for storing the array. */
+)
+{
+  size_t actualLength;
+  if (!decReadLength(reader, 8, &actualLength))
+    return CMR_OKAY;
+  if (actualLength != length)
+  {
+    reader->invalid = true;
+    return CMR_OKAY;
+  }
+
+  CMR_CALL( CMRallocBlockArray(cmr, parray, capacity > 0 ? capacity : 1) );
+  for (size_t i = 0; i < length; ++i)
+    (*parray)[i] = decReadIndex(reader);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads an array of elements of the given \p length, or a missing one.
+ */
+
+static
+CMR_ERROR decReadElementArray(
+  CMR* cmr,               /**< \ref CMR environment. */
+  DecReader* reader,      /**< Reader. */
+  size_t length,          /**< Expected length. */
+  CMR_ELEMENT** parray    /**< Pointer for storing the array. */
+)
+{
+  size_t actualLength;
+  if (!decReadLength(reader, 4, &actualLength))
+    return CMR_OKAY;
+  if (actualLength != length)
+  {
+    reader->invalid = true;
+    return CMR_OKAY;
+  }
+
+  CMR_CALL( CMRallocBlockArray(cmr, parray, length > 0 ? length : 1) );
+  for (size_t i = 0; i < length; ++i)
+    (*parray)[i] = (CMR_ELEMENT) (int32_t) (uint32_t) decReadNumber(reader, 4);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads the offset of a matrix and schedules its reading from the data section.
+ */
+
+static
+CMR_ERROR decReadMatrix(
+  CMR* cmr,               /**< \ref CMR environment. */
+  DecReader* reader,      /**< Reader. */
+  size_t numRows,         /**< Expected number of rows. */
+  size_t numColumns,      /**< Expected number of columns. */
+  CMR_CHRMAT** pmatrix,   /**< Pointer for storing the matrix. */
+  CMR_CHRMAT** ptranspose /**< Pointer for storing its transpose (may be \c NULL). */
+)
+{
+  uint64_t offset = decReadNumber(reader, 8);
+  if (reader->invalid || offset == DEC_NONE)
+    return CMR_OKAY;
+
+  if (reader->numPending == reader->memPending)
+  {
+    reader->memPending = 2 * reader->memPending + 16;
+    CMR_CALL( CMRreallocBlockArray(cmr, &reader->pending, reader->memPending) );
+  }
+  DecPendingMatrix* pending = &reader->pending[reader->numPending++];
+  pending->pmatrix = pmatrix;
+  pending->ptranspose = ptranspose;
+  pending->offset = offset;
+  pending->numRows = numRows;
+  pending->numColumns = numColumns;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads a (co)graph with its forest, coforest and arc directions.
+ */
+
+static
+CMR_ERROR decReadGraph(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  DecReader* reader,          /**< Reader. */
+  CMR_GRAPH** pgraph,         /**< Pointer for storing the graph. */
+  CMR_GRAPH_EDGE** pforest,   /**< Pointer for storing the forest edges. */
+  CMR_GRAPH_EDGE** pcoforest, /**< Pointer for storing the coforest edges. */
+  bool** parcsReversed        /**< Pointer for storing the array indicating reversed arcs. */
+)
+{
+  uint64_t numNodes = decReadNumber(reader, 8);
+  if (reader->invalid || numNodes == DEC_NONE)
+    return CMR_OKAY;
+  size_t numEdges;
+  if (numNodes > INT32_MAX || !decReadLength(reader, 16, &numEdges) || numEdges > INT32_MAX)
+  {
+    reader->invalid = true;
+    return CMR_OKAY;
+  }
+
+  CMR_CALL( CMRgraphCreateEmpty(cmr, pgraph, (int) numNodes, (int) numEdges) );
+  CMR_GRAPH* graph = *pgraph;
+  CMR_GRAPH_NODE* nodes = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &nodes, numNodes + 1) );
+  CMR_GRAPH_EDGE* edges = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &edges, numEdges + 1) );
+  for (size_t v = 0; v < numNodes; ++v)
+    CMR_CALL( CMRgraphAddNode(cmr, graph, &nodes[v]) );
+  for (size_t e = 0; e < numEdges && !reader->invalid; ++e)
+  {
+    uint64_t u = decReadNumber(reader, 8);
+    uint64_t v = decReadNumber(reader, 8);
+    if (u >= numNodes || v >= numNodes)
+      reader->invalid = true;
+    else
+      CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[u], nodes[v], &edges[e]) );
+  }
+
+  for (int f = 0; f < 2 && !reader->invalid; ++f)
+  {
+    CMR_GRAPH_EDGE** parray = f ? pcoforest : pforest;
+    size_t length;
+    if (!decReadLength(reader, 8, &length))
+      continue;
+    CMR_CALL( CMRallocBlockArray(cmr, parray, length > 0 ? length : 1) );
+    for (size_t i = 0; i < length; ++i)
+    {
+      uint64_t e = decReadNumber(reader, 8);
+      if (e >= numEdges)
+        reader->invalid = true;
+      else
+        (*parray)[i] = edges[e];
+    }
+  }
+
+  if (decReadNumber(reader, 1) && !reader->invalid)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, parcsReversed, CMRgraphMemEdges(graph) > 0 ? CMRgraphMemEdges(graph) : 1) );
+    for (size_t e = 0; e < numEdges; ++e)
+      (*parcsReversed)[edges[e]] = decReadNumber(reader, 1) != 0;
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &edges) );
+  CMR_CALL( CMRfreeStackArray(cmr, &nodes) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reads the record of a node and, recursively, of its children.
+ */
+
+static
+CMR_ERROR decReadNode(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  DecReader* reader,        /**< Reader. */
+  CMR_MATROID_DEC* parent,  /**< Parent node, or \c NULL for the root. */
+  CMR_MATROID_DEC** pdec    /**< Pointer for storing the node. */
+)
+{
+  if (reader->numNodes == reader->maxNodes)
+  {
+    reader->invalid = true;
+    return CMR_OKAY;
+  }
+  reader->numNodes++;
+
+  CMR_CALL( CMRallocBlock(cmr, pdec) );
+  CMR_MATROID_DEC* dec = *pdec;
+  *dec = (struct _CMR_MATROID_DEC) { .parent = parent, .nestedMinorsLastGraphic = SIZE_MAX,
+    .nestedMinorsLastCographic = SIZE_MAX };
+
+  dec->type = (CMR_MATROID_DEC_TYPE) (int32_t) (uint32_t) decReadNumber(reader, 4);
+  dec->threesumFlags = (CMR_MATROID_DEC_THREESUM_FLAG) decReadNumber(reader, 4);
+  int flags = (int) decReadNumber(reader, 1);
+  dec->isTernary = flags & DEC_FLAG_TERNARY;
+  dec->testedTwoConnected = flags & DEC_FLAG_TWO_CONNECTED;
+  dec->testedTwoSum = flags & DEC_FLAG_TWO_SUM;
+  dec->testedR10 = flags & DEC_FLAG_R10;
+  dec->testedSeriesParallel = flags & DEC_FLAG_SERIES_PARALLEL;
+  dec->regularity = (int8_t) (uint8_t) decReadNumber(reader, 1);
+  dec->graphicness = (int8_t) (uint8_t) decReadNumber(reader, 1);
+  dec->cographicness = (int8_t) (uint8_t) decReadNumber(reader, 1);
+  size_t numChildren = decReadIndex(reader);
+  dec->numRows = decReadIndex(reader);
+  dec->numColumns = decReadIndex(reader);
+  if (reader->invalid || numChildren > reader->maxNodes - reader->numNodes || dec->numRows > INT32_MAX
+    || dec->numColumns > INT32_MAX)
+  {
+    reader->invalid = true;
+    return CMR_OKAY;
+  }
+
+  /* A transpose of an existing matrix is recomputed after reading the matrix. */
+  CMR_CALL( decReadMatrix(cmr, reader, dec->numRows, dec->numColumns, &dec->matrix,
+    (flags & DEC_FLAG_TRANSPOSE) ? &dec->transpose : NULL) );
+  CMR_CALL( decReadMatrix(cmr, reader, dec->numColumns, dec->numRows, &dec->transpose, NULL) );
+
+  CMR_CALL( decReadIndexArray(cmr, reader, dec->numRows, dec->numRows, &dec->rowsChild) );
+  CMR_CALL( decReadIndexArray(cmr, reader, dec->numRows, dec->numRows, &dec->rowsParent) );
+  CMR_CALL( decReadElementArray(cmr, reader, dec->numRows, &dec->rowsRootElement) );
+  CMR_CALL( decReadIndexArray(cmr, reader, dec->numColumns, dec->numColumns, &dec->columnsChild) );
+  CMR_CALL( decReadIndexArray(cmr, reader, dec->numColumns, dec->numColumns, &dec->columnsParent) );
+  CMR_CALL( decReadElementArray(cmr, reader, dec->numColumns, &dec->columnsRootElement) );
+
+  CMR_CALL( decReadGraph(cmr, reader, &dec->graph, &dec->graphForest, &dec->graphCoforest,
+    &dec->graphArcsReversed) );
+  CMR_CALL( decReadGraph(cmr, reader, &dec->cograph, &dec->cographForest, &dec->cographCoforest,
+    &dec->cographArcsReversed) );
+
+  size_t numReductions;
+  if (decReadLength(reader, 8, &numReductions))
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, &dec->seriesParallelReductions, numReductions > 0 ? numReductions : 1) );
+    dec->numSeriesParallelReductions = numReductions;
+    for (size_t r = 0; r < numReductions; ++r)
+    {
+      dec->seriesParallelReductions[r].element = (CMR_ELEMENT) (int32_t) (uint32_t) decReadNumber(reader, 4);
+      dec->seriesParallelReductions[r].mate = (CMR_ELEMENT) (int32_t) (uint32_t) decReadNumber(reader, 4);
+    }
+  }
+
+  size_t numPivots = 0;
+  size_t position = reader->position;
+  decReadLength(reader, 8, &numPivots);
+  if (!reader->invalid)
+    reader->position = position;
+  CMR_CALL( decReadIndexArray(cmr, reader, numPivots, numPivots, &dec->pivotRows) );
+  CMR_CALL( decReadIndexArray(cmr, reader, numPivots, numPivots, &dec->pivotColumns) );
+  dec->numPivots = dec->pivotRows ? numPivots : 0;
+
+  /* State of the construction of a sequence of nested minors. */
+  uint64_t denseRows = decReadNumber(reader, 8);
+  size_t denseColumns = 0;
+  if (!reader->invalid && denseRows != DEC_NONE)
+  {
+    denseColumns = decReadIndex(reader);
+    size_t numWords = (denseColumns + 63) / 64;
+    if (reader->invalid || denseRows != dec->numRows || denseColumns != dec->numColumns
+      || (numWords > 0 && denseRows > (reader->length - reader->position) / (8 * numWords)))
+    {
+      reader->invalid = true;
+      return CMR_OKAY;
+    }
+    CMR_CALL( CMRdensebinmatrixCreate(cmr, denseRows, denseColumns, &dec->denseMatrix) );
+    for (size_t row = 0; row < denseRows; ++row)
+    {
+      uint64_t* words = CMRdensebinmatrixRow(dec->denseMatrix, row);
+      for (size_t w = 0; w < numWords; ++w)
+        words[w] = decReadNumber(reader, 8);
+      if (numWords > 0 && denseColumns % 64)
+        words[numWords - 1] &= (UINT64_C(1) << (denseColumns % 64)) - 1;
+    }
+  }
+  else
+    denseRows = 0;
+  CMR_CALL( decReadElementArray(cmr, reader, denseRows, &dec->denseRowsOriginal) );
+  CMR_CALL( decReadElementArray(cmr, reader, denseColumns, &dec->denseColumnsOriginal) );
+  CMR_CALL( decReadIndexArray(cmr, reader, denseRows, denseRows, &dec->nestedMinorsRowsDense) );
+  CMR_CALL( decReadIndexArray(cmr, reader, denseColumns, denseColumns, &dec->nestedMinorsColumnsDense) );
+
+  /* The sequence may grow up to one minor per element. */
+  size_t nestedMinorsLength = 0;
+  position = reader->position;
+  decReadLength(reader, 8, &nestedMinorsLength);
+  if (!reader->invalid)
+    reader->position = position;
+  size_t capacity = dec->numRows + dec->numColumns;
+  if (capacity < nestedMinorsLength)
+    capacity = nestedMinorsLength;
+  CMR_CALL( decReadIndexArray(cmr, reader, nestedMinorsLength, capacity, &dec->nestedMinorsSequenceNumRows) );
+  CMR_CALL( decReadIndexArray(cmr, reader, nestedMinorsLength, capacity, &dec->nestedMinorsSequenceNumColumns) );
+  dec->nestedMinorsLength = dec->nestedMinorsSequenceNumRows ? nestedMinorsLength : 0;
+  CMR_CALL( decReadMatrix(cmr, reader, dec->numRows, dec->numColumns, &dec->nestedMinorsMatrix,
+    (flags & DEC_FLAG_NESTED_TRANSPOSE) ? &dec->nestedMinorsTranspose : NULL) );
+  CMR_CALL( decReadElementArray(cmr, reader, dec->numRows, &dec->nestedMinorsRowsOriginal) );
+  CMR_CALL( decReadElementArray(cmr, reader, dec->numColumns, &dec->nestedMinorsColumnsOriginal) );
+  dec->nestedMinorsLastGraphic = decReadIndex(reader);
+  dec->nestedMinorsLastCographic = decReadIndex(reader);
+
+  if (reader->invalid)
+    return CMR_OKAY;
+
+  if (numChildren > 0)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, &dec->children, numChildren) );
+    for (size_t c = 0; c < numChildren; ++c)
+      dec->children[c] = NULL;
+    dec->numChildren = numChildren;
+    for (size_t c = 0; c < numChildren && !reader->invalid; ++c)
+      CMR_CALL( decReadNode(cmr, reader, dec, &dec->children[c]) );
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Skips \p numBytes bytes of \p stream.
+ *
+ * \returns \c false if the stream ended prematurely.
+ */
+
+static
+bool decSkip(
+  FILE* stream,     /**< File stream. */
+  uint64_t numBytes /**< Number of bytes to skip. */
+)
+{
+  for (uint64_t i = 0; i < numBytes; ++i)
+  {
+    if (fgetc(stream) == EOF)
+      return false;
+  }
+  return true;
+}
+
+CMR_ERROR CMRmatroiddecCreateFromBinaryStream(CMR* cmr, FILE* stream, CMR_MATROID_DEC** pdec)
+{
+  assert(cmr);
+  assert(stream);
+  assert(pdec);
+
+  *pdec = NULL;
+
+  unsigned char header[DEC_HEADER_SIZE];
+  if (fread(header, 1, DEC_HEADER_SIZE, stream) != DEC_HEADER_SIZE)
+  {
+    CMRraiseErrorMessage(cmr, "Could not read header of binary decomposition file.");
+    return CMR_ERROR_INPUT;
+  }
+  if (memcmp(header, DEC_MAGIC, sizeof(DEC_MAGIC)))
+  {
+    CMRraiseErrorMessage(cmr, "Input is not a binary decomposition file.");
+    return CMR_ERROR_INPUT;
+  }
+
+  DecReader reader = { header, DEC_HEADER_SIZE, 8, false, 0, 0, NULL, 0, 0 };
+  uint32_t version = (uint32_t) decReadNumber(&reader, 4);
+  decReadNumber(&reader, 4);
+  uint64_t numNodes = decReadNumber(&reader, 8);
+  uint64_t recordsLength = decReadNumber(&reader, 8);
+  uint64_t dataOffset = decReadNumber(&reader, 8);
+  uint64_t dataLength = decReadNumber(&reader, 8);
+  if (version != DEC_VERSION)
+  {
+    CMRraiseErrorMessage(cmr, "Binary decomposition file has unsupported version %u.", (unsigned int) version);
+    return CMR_ERROR_INPUT;
+  }
+  if (numNodes == 0 || numNodes > recordsLength || recordsLength >= SIZE_MAX / 2
+    || dataOffset != DEC_HEADER_SIZE + recordsLength + (8 - recordsLength % 8) % 8)
+  {
+    CMRraiseErrorMessage(cmr, "Binary decomposition file has an invalid header.");
+    return CMR_ERROR_INPUT;
+  }
+
+  reader.bytes = NULL;
+  reader.length = (size_t) recordsLength;
+  reader.position = 0;
+  reader.maxNodes = (size_t) numNodes;
+  CMR_CALL( CMRallocBlockArray(cmr, &reader.bytes, reader.length) );
+  CMR_ERROR error = CMR_OKAY;
+  if (fread(reader.bytes, 1, reader.length, stream) != reader.length
+    || !decSkip(stream, dataOffset - DEC_HEADER_SIZE - recordsLength))
+  {
+    CMRraiseErrorMessage(cmr, "Binary decomposition file ended prematurely.");
+    error = CMR_ERROR_INPUT;
+  }
+
+  if (!error)
+  {
+    CMR_CALL( decReadNode(cmr, &reader, NULL, pdec) );
+    if (reader.invalid || reader.numNodes != reader.maxNodes || reader.position != reader.length)
+    {
+      CMRraiseErrorMessage(cmr, "Binary decomposition file has invalid node records.");
+      error = CMR_ERROR_INPUT;
+    }
+  }
+
+  /* Read the matrices, which appear in the data section in the order of the records. */
+  uint64_t position = 0;
+  for (size_t p = 0; p < reader.numPending && !error; ++p)
+  {
+    DecPendingMatrix* pending = &reader.pending[p];
+    if (pending->offset < position || pending->offset > dataLength || !decSkip(stream, pending->offset - position))
+    {
+      CMRraiseErrorMessage(cmr, "Binary decomposition file has an invalid matrix offset.");
+      error = CMR_ERROR_INPUT;
+      break;
+    }
+    error = CMRchrmatCreateFromBinaryStream(cmr, stream, pending->pmatrix);
+    if (error)
+      break;
+    CMR_CHRMAT* matrix = *pending->pmatrix;
+    if (matrix->numRows != pending->numRows || matrix->numColumns != pending->numColumns)
+    {
+      CMRraiseErrorMessage(cmr, "Binary decomposition file has a matrix of wrong dimensions.");
+      error = CMR_ERROR_INPUT;
+      break;
+    }
+    if (pending->ptranspose)
+      CMR_CALL( CMRchrmatTranspose(cmr, matrix, pending->ptranspose) );
+    position = pending->offset + decMatrixSize(matrix);
+    if (!decSkip(stream, decMatrixSize(matrix) - decMatrixBlobSize(matrix)))
+    {
+      CMRraiseErrorMessage(cmr, "Binary decomposition file ended prematurely.");
+      error = CMR_ERROR_INPUT;
+    }
+  }
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &reader.pending) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &reader.bytes) );
+  if (error)
+    CMR_CALL( CMRmatroiddecFree(cmr, pdec) );
+
+  return error;
+}
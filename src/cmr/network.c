@@ -14,11 +14,12 @@
 #include "block_decomposition.h"
 #include "heap.h"
 #include "sort.h"
+#include "deadline.h"
 
 #include <assert.h>
 #include <limits.h>
+#include <float.h>
 #include <stdlib.h>
-#include <time.h>
 
 CMR_ERROR CMRnetworkStatsInit(CMR_NETWORK_STATISTICS* stats)
 {
@@ -55,6 +56,33 @@ CMR_ERROR CMRnetworkStatsPrint(FILE* stream, CMR_NETWORK_STATISTICS* stats, cons
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRnetworkStatsPrintJson(FILE* stream, CMR_NETWORK_STATISTICS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"camion\":");
+  CMR_CALL( CMRcamionStatsPrintJson(stream, &stats->camion) );
+  fprintf(stream, ",\"graphic\":");
+  CMR_CALL( CMRgraphicStatsPrintJson(stream, &stats->graphic) );
+  fprintf(stream, ",\"total\":{\"count\":%lu,\"time\":%.9g}}", (unsigned long)stats->totalCount, stats->totalTime);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRnetworkStatsAdd(CMR_NETWORK_STATISTICS* target, CMR_NETWORK_STATISTICS* source)
+{
+  assert(target);
+  assert(source);
+
+  target->totalCount += source->totalCount;
+  target->totalTime += source->totalTime;
+  CMR_CALL( CMRcamionStatsAdd(&target->camion, &source->camion) );
+  CMR_CALL( CMRgraphicStatsAdd(&target->graphic, &source->graphic) );
+
+  return CMR_OKAY;
+}
+
 typedef enum
 {
   UNKNOWN = 0,    /**< \brief The node was not considered by the shortest-path, yet. */
@@ -73,20 +101,11 @@ CMR_ERROR CMRnetworkComputeMatrix(CMR* cmr, CMR_GRAPH* digraph, CMR_CHRMAT** pma
   assert(!pmatrix || !*pmatrix);
   assert(!ptranspose || !*ptranspose);
 
-  CMR_CHRMAT* transpose = NULL;
-  CMR_CALL( CMRcomputeRepresentationMatrix(cmr, digraph, true, &transpose, arcsReversed, numForestArcs, forestArcs,
-    numCoforestArcs, coforestArcs, pisCorrectForest) );
-
-  CMRconsistencyAssert( CMRchrmatConsistency(transpose) );
+  CMR_CALL( CMRcomputeRepresentationMatrix(cmr, digraph, true, pmatrix, ptranspose, arcsReversed, numForestArcs,
+    forestArcs, numCoforestArcs, coforestArcs, pisCorrectForest) );
 
-  if (pmatrix)
-    CMR_CALL( CMRchrmatTranspose(cmr, transpose, pmatrix) );
-
-  /* Return or free the transpose matrix. */
-  if (ptranspose)
-    *ptranspose = transpose;
-  else
-    CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+  CMRconsistencyAssert( pmatrix ? CMRchrmatConsistency(*pmatrix) : NULL );
+  CMRconsistencyAssert( ptranspose ? CMRchrmatConsistency(*ptranspose) : NULL );
 
   return CMR_OKAY;
 }
@@ -107,6 +126,56 @@ typedef struct
   bool fixed;           /**< Whether the orientation of this edge is already fixed. */
 } NetworkNodeData;
 
+/**
+ * \brief Data of the orientation of prefixes of the rows during a conetwork test.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* matrix;           /**< \brief Matrix to be tested for being conetwork. */
+  bool isCamionSigned;          /**< \brief Whether all oriented prefixes are Camion-signed. */
+  CMR_SUBMAT** psubmatrix;      /**< \brief Pointer for storing a non-Camion submatrix (may be \c NULL). */
+  CMR_CAMION_STATISTICS* stats; /**< \brief Statistics for the orientations (may be \c NULL). */
+} NetworkCheckpointData;
+
+/**
+ * \brief Orients the graph of a prefix of the rows and stops the cographicness test if this fails.
+ *
+ * Since every submatrix of a network matrix is a network matrix, the test can be stopped as soon as a prefix of the
+ * rows of \f$ M \f$ is not Camion-signed.
+ */
+
+static
+CMR_ERROR networkCheckpoint(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  size_t numRows,                 /**< Number of rows of the prefix. */
+  CMR_GRAPH* graph,               /**< Graph of the prefix. */
+  CMR_GRAPH_EDGE* forestEdges,    /**< Spanning forest, indexed by the columns of the matrix. */
+  CMR_GRAPH_EDGE* coforestEdges,  /**< Complementary edges, indexed by the rows of the prefix. */
+  void* data,                     /**< Pointer to the \ref NetworkCheckpointData. */
+  bool* pstop                     /**< Pointer for storing whether the test shall be stopped. */
+)
+{
+  NetworkCheckpointData* checkpoint = (NetworkCheckpointData*) data;
+
+  /* The prefix shares the arrays of the matrix. */
+  CMR_CHRMAT prefix = *checkpoint->matrix;
+  prefix.numRows = numRows;
+  prefix.numNonzeros = prefix.rowSlice[numRows];
+
+  bool* arcsReversed = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &arcsReversed, CMRgraphMemEdges(graph)) );
+  CMR_CALL( CMRcamionCographicOrient(cmr, &prefix, graph, forestEdges, coforestEdges, arcsReversed,
+    &checkpoint->isCamionSigned, checkpoint->psubmatrix, checkpoint->stats) );
+  CMR_CALL( CMRfreeStackArray(cmr, &arcsReversed) );
+
+  CMRdbgMsg(2, "Orientation of the first %zu rows %s.\n", numRows,
+    checkpoint->isCamionSigned ? "succeeded" : "failed");
+  *pstop = !checkpoint->isCamionSigned;
+
+  return CMR_OKAY;
+}
+
 CMR_ERROR CMRnetworkTestTranspose(CMR* cmr, CMR_CHRMAT* matrix, bool* pisConetwork, bool* psupportIsCographic,
   CMR_GRAPH** pdigraph, CMR_GRAPH_EDGE** pforestArcs, CMR_GRAPH_EDGE** pcoforestArcs, bool** parcsReversed,
   CMR_SUBMAT** psubmatrix, CMR_NETWORK_STATISTICS* stats, double timeLimit)
@@ -125,15 +194,24 @@ CMR_ERROR CMRnetworkTestTranspose(CMR* cmr, CMR_CHRMAT* matrix, bool* pisConetwo
   CMR_CALL( CMRchrmatPrintDense(cmr, matrix, stdout, '0', true) );
 #endif /* CMR_DEBUG */
 
-  clock_t totalClock = clock();
+  double totalClock = CMRclockNow();
+
+  /* Unless the cographicness of the support is requested, which would require to continue the test anyway, the
+   * orientation of prefixes of the rows is checked while the cographic decomposition is built. */
+  NetworkCheckpointData checkpoint;
+  checkpoint.matrix = matrix;
+  checkpoint.isCamionSigned = true;
+  checkpoint.psubmatrix = psubmatrix;
+  checkpoint.stats = stats ? &stats->camion : NULL;
 
-  double remainingTime = timeLimit - (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
   CMR_GRAPH_EDGE* forestEdges = NULL;
   CMR_GRAPH_EDGE* coforestEdges = NULL;
   CMR_GRAPH* graph = NULL;
   bool isConetwork;
-  CMR_CALL( CMRgraphicTestTranspose(cmr, matrix, &isConetwork, &graph, &forestEdges, &coforestEdges,
-    psubmatrix, stats ? &stats->graphic : NULL, remainingTime) );
+  bool stopped;
+  CMR_CALL( CMRgraphicTestTransposeCheckpoints(cmr, matrix, &isConetwork, &stopped, &graph, &forestEdges,
+    &coforestEdges, psubmatrix, psupportIsCographic ? NULL : networkCheckpoint, &checkpoint,
+    stats ? &stats->graphic : NULL, timeLimit) );
 
 #if defined(CMR_DEBUG)
   CMRdbgMsg(2, "CMRtestCographicMatrix() returned %s.\n", isConetwork ? "TRUE": "FALSE");
@@ -141,6 +219,8 @@ CMR_ERROR CMRnetworkTestTranspose(CMR* cmr, CMR_CHRMAT* matrix, bool* pisConetwo
 
   if (psupportIsCographic)
     *psupportIsCographic = isConetwork;
+  if (stopped)
+    isConetwork = false;
 
   bool* arcsReversed = NULL;
   if (isConetwork)
@@ -198,7 +278,7 @@ CMR_ERROR CMRnetworkTestTranspose(CMR* cmr, CMR_CHRMAT* matrix, bool* pisConetwo
   if (stats)
   {
     stats->totalCount++;
-    stats->totalTime += (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
+    stats->totalTime += CMRclockNow() - totalClock;
   }
 
   return CMR_OKAY;
@@ -216,9 +296,9 @@ CMR_ERROR CMRnetworkTestMatrix(CMR* cmr, CMR_CHRMAT* matrix, bool* pisNetwork, b
   assert(!pcoforestArcs || pdigraph);
   assert(!parcsReversed || pdigraph);
 
-  /* Create transpose of matrix. */
+  /* Get the (cached) transpose of matrix. */
   CMR_CHRMAT* transpose = NULL;
-  CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+  CMR_CALL( CMRchrmatGetTranspose(cmr, matrix, &transpose) );
   
 #if defined(CMR_DEBUG)
   CMRdbgMsg(0, "CMRnetworkTestMatrix called for a %dx%d matrix \n", matrix->numRows,
@@ -233,9 +313,76 @@ CMR_ERROR CMRnetworkTestMatrix(CMR* cmr, CMR_CHRMAT* matrix, bool* pisNetwork, b
   if (psubmatrix && *psubmatrix)
     CMR_CALL( CMRsubmatTranspose(*psubmatrix) );
 
-  CMR_CALL( CMRchrmatFree(cmr, &transpose) );
 
   return CMR_OKAY;
 }
 
 /**@}*/
+
+/**
+ * \brief Removes columns from a set of columns with graphic support until the induced submatrix is Camion-signed.
+ *
+ * In each round, the last appended column of a non-Camion submatrix is removed.
+ */
+
+static
+CMR_ERROR camionFilterColumns(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CMR_CHRMAT* transpose,  /**< \f$ M^{\mathsf{T}} \f$. */
+  size_t* columns,        /**< Array with the columns in the order of appending. */
+  size_t* pnumColumns,    /**< Pointer to the number of columns. */
+  void* data              /**< Unused. */
+)
+{
+  CMR_UNUSED(data);
+
+  while (*pnumColumns > 0)
+  {
+    /* Since Camion-signedness is invariant under transposition, we test the rows of the transpose. */
+    CMR_SUBMAT* rows = NULL;
+    CMR_CALL( CMRsubmatCreate(cmr, *pnumColumns, transpose->numColumns, &rows) );
+    for (size_t r = 0; r < *pnumColumns; ++r)
+      rows->rows[r] = columns[r];
+    for (size_t c = 0; c < transpose->numColumns; ++c)
+      rows->columns[c] = c;
+    CMR_CHRMAT* slice = NULL;
+    CMR_CALL( CMRchrmatZoomSubmat(cmr, transpose, rows, &slice) );
+    CMR_CALL( CMRsubmatFree(cmr, &rows) );
+
+    bool isCamionSigned;
+    CMR_SUBMAT* violator = NULL;
+    CMR_CALL( CMRcamionTestSigns(cmr, slice, &isCamionSigned, &violator, NULL, DBL_MAX) );
+    CMR_CALL( CMRchrmatFree(cmr, &slice) );
+    if (isCamionSigned)
+      break;
+
+    assert(violator && violator->numRows > 0);
+    size_t last = 0;
+    for (size_t r = 0; r < violator->numRows; ++r)
+    {
+      if (violator->rows[r] > last)
+        last = violator->rows[r];
+    }
+    CMR_CALL( CMRsubmatFree(cmr, &violator) );
+
+    CMRdbgMsg(2, "Removing column %zu of a non-Camion submatrix.\n", columns[last]);
+    for (size_t r = last + 1; r < *pnumColumns; ++r)
+      columns[r - 1] = columns[r];
+    --(*pnumColumns);
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRnetworkTestColumnSubmatrixPortfolio(CMR* cmr, CMR_CHRMAT* transpose, size_t numOrders, unsigned int seed,
+  CMR_SUBMAT** psubmatrix)
+{
+  assert(cmr);
+  assert(transpose);
+  assert(psubmatrix);
+
+  CMR_CALL( CMRgraphicTestColumnSubmatrixPortfolioFilter(cmr, transpose, numOrders, seed, camionFilterColumns, NULL,
+    psubmatrix) );
+
+  return CMR_OKAY;
+}
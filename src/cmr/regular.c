@@ -1,14 +1,17 @@
-#define CMR_DEBUG /** Uncomment to debug this file. */
+// #define CMR_DEBUG /** Uncomment to debug this file. */
 
 #include <cmr/regular.h>
+#include <cmr/camion.h>
 
 #include <assert.h>
 #include <stdlib.h>
-#include <time.h>
 
 #include "env_internal.h"
 #include "matroid_internal.h"
 #include "regularity_internal.h"
+#include "counters.h"
+#include "deadline.h"
+#include "small_matrix.h"
 
 CMR_ERROR CMRregularParamsInit(CMR_REGULAR_PARAMS* params)
 {
@@ -16,13 +19,21 @@ CMR_ERROR CMRregularParamsInit(CMR_REGULAR_PARAMS* params)
 
   params->directGraphicness = true;
   params->seriesParallel = true;
+  params->directTwoSums = true;
   params->planarityCheck = false;
   params->completeTree = false;
   params->threeSumPivotChildren = false;
   params->threeSumStrategy = CMR_MATROID_DEC_THREESUM_FLAG_DISTRIBUTED_RANKS /* TODO: Later no pivots. */
     | CMR_MATROID_DEC_THREESUM_FLAG_FIRST_WIDE | CMR_MATROID_DEC_THREESUM_FLAG_FIRST_MIXED
     | CMR_MATROID_DEC_THREESUM_FLAG_SECOND_WIDE | CMR_MATROID_DEC_THREESUM_FLAG_SECOND_MIXED;
-  params->graphs = CMR_DEC_CONSTRUCT_NONE;
+  params->graphs = CMR_DEC_CONSTRUCT_ALL;
+  params->keepIntermediate = false;
+  params->schedule = CMR_REGULAR_SCHEDULE_DEPTH_FIRST;
+  params->deterministic = false;
+  params->cache = NULL;
+  params->checkpoint = NULL;
+  params->nodeTimeLimit = 0.0;
+  params->smallMatrices = true;
 
   return CMR_OKAY;
 }
@@ -39,11 +50,54 @@ CMR_ERROR CMRregularStatsInit(CMR_REGULAR_STATS* stats)
   CMR_CALL( CMRcamionStatsInit(&stats->camion) );
   stats->sequenceExtensionCount = 0;
   stats->sequenceExtensionTime = 0.0;  
+  CMRcountersInit(&stats->sequenceExtensionCounters);
   stats->sequenceGraphicCount = 0;
   stats->sequenceGraphicTime = 0.0;
   stats->enumerationCount = 0;
   stats->enumerationTime = 0.0;
+  CMRcountersInit(&stats->enumerationCounters);
   stats->enumerationCandidatesCount = 0;
+  stats->cacheLookupCount = 0;
+  stats->cacheHitCount = 0;
+  stats->skippedCount = 0;
+  for (int phase = 0; phase < CMR_REGULAR_NUM_PHASES; ++phase)
+  {
+    CMR_REGULAR_PHASE_STATS* phaseStats = &stats->phases[phase];
+    phaseStats->count = 0;
+    phaseStats->time = 0.0;
+    phaseStats->maxTime = 0.0;
+    for (int bin = 0; bin < CMR_REGULAR_HISTOGRAM_BINS; ++bin)
+    {
+      phaseStats->sizeHistogram[bin] = 0;
+      phaseStats->timeHistogram[bin] = 0;
+    }
+  }
+  stats->numWorkers = 0;
+  for (int worker = 0; worker < CMR_REGULAR_MAX_WORKERS; ++worker)
+  {
+    stats->workers[worker].count = 0;
+    stats->workers[worker].time = 0.0;
+  }
+  stats->nodeLog = NULL;
+
+  return CMR_OKAY;
+}
+
+const char* CMRregularPhaseName(CMR_REGULAR_PHASE phase)
+{
+  static const char* names[CMR_REGULAR_NUM_PHASES] = { "one-sum", "graphic", "cographic", "r10", "series-parallel",
+    "sequence-extension", "sequence-graphic", "sequence-cographic", "three-separation", "two-sum" };
+
+  assert(phase >= 0 && phase < CMR_REGULAR_NUM_PHASES);
+
+  return names[phase];
+}
+
+CMR_ERROR CMRregularNodeLogHeader(FILE* stream)
+{
+  assert(stream);
+
+  fprintf(stream, "phase,rows,columns,nonzeros,time,type,regularity\n");
 
   return CMR_OKAY;
 }
@@ -71,17 +125,146 @@ CMR_ERROR CMRregularStatsPrint(FILE* stream, CMR_REGULAR_STATS* stats, const cha
 
   fprintf(stream, "%ssequence extensions: %lu in %f seconds\n", prefix, (unsigned long)stats->sequenceExtensionCount,
     stats->sequenceExtensionTime);
+  CMRcountersPrint(stream, &stats->sequenceExtensionCounters, prefix, "sequence extensions");
   fprintf(stream, "%ssequence (co)graphic: %lu in %f seconds\n", prefix, (unsigned long)stats->sequenceGraphicCount,
     stats->sequenceGraphicTime);
   fprintf(stream, "%senumeration: %lu in %f seconds\n", prefix, (unsigned long)stats->enumerationCount,
     stats->enumerationTime);
+  CMRcountersPrint(stream, &stats->enumerationCounters, prefix, "enumeration");
   fprintf(stream, "%s3-separation candidates: %lu in %f seconds\n", prefix,
     (unsigned long)stats->enumerationCandidatesCount, stats->enumerationTime);
+  fprintf(stream, "%scache: %lu hits in %lu lookups\n", prefix, (unsigned long)stats->cacheHitCount,
+    (unsigned long)stats->cacheLookupCount);
+  fprintf(stream, "%sskipped nodes: %lu\n", prefix, (unsigned long)stats->skippedCount);
+  for (int phase = 0; phase < CMR_REGULAR_NUM_PHASES; ++phase)
+  {
+    CMR_REGULAR_PHASE_STATS* phaseStats = &stats->phases[phase];
+    fprintf(stream, "%sphase %s: %lu nodes in %f seconds, at most %f seconds per node\n", prefix,
+      CMRregularPhaseName(phase), (unsigned long)phaseStats->count, phaseStats->time, phaseStats->maxTime);
+  }
+  for (uint32_t worker = 0; worker < stats->numWorkers; ++worker)
+  {
+    fprintf(stream, "%sworker %lu: %lu nodes in %f seconds\n", prefix, (unsigned long)worker,
+      (unsigned long)stats->workers[worker].count, stats->workers[worker].time);
+  }
   fprintf(stream, "%stotal: %lu in %f seconds\n", prefix, (unsigned long)stats->totalCount, stats->totalTime);
 
   return CMR_OKAY;
 }
 
+/**
+ * \brief Prints a histogram as a JSON array, omitting trailing empty bins.
+ */
+
+static
+void printHistogramJson(
+  FILE* stream,       /**< File stream to print to. */
+  uint32_t* histogram /**< Histogram with \ref CMR_REGULAR_HISTOGRAM_BINS bins. */
+)
+{
+  int numBins = CMR_REGULAR_HISTOGRAM_BINS;
+  while (numBins > 0 && histogram[numBins - 1] == 0)
+    --numBins;
+
+  fputc('[', stream);
+  for (int bin = 0; bin < numBins; ++bin)
+    fprintf(stream, "%s%lu", bin ? "," : "", (unsigned long) histogram[bin]);
+  fputc(']', stream);
+}
+
+CMR_ERROR CMRregularStatsPrintJson(FILE* stream, CMR_REGULAR_STATS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"series-parallel\":");
+  CMR_CALL( CMRspStatsPrintJson(stream, &stats->seriesParallel) );
+  fprintf(stream, ",\"graphic\":");
+  CMR_CALL( CMRgraphicStatsPrintJson(stream, &stats->graphic) );
+  fprintf(stream, ",\"network\":");
+  CMR_CALL( CMRnetworkStatsPrintJson(stream, &stats->network) );
+  fprintf(stream, ",\"camion\":");
+  CMR_CALL( CMRcamionStatsPrintJson(stream, &stats->camion) );
+  fprintf(stream, ",\"sequence-extensions\":{\"count\":%lu,\"time\":%.9g}",
+    (unsigned long)stats->sequenceExtensionCount, stats->sequenceExtensionTime);
+  fprintf(stream, ",\"sequence-graphic\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->sequenceGraphicCount,
+    stats->sequenceGraphicTime);
+  fprintf(stream, ",\"enumeration\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->enumerationCount,
+    stats->enumerationTime);
+  fprintf(stream, ",\"3-separation-candidates\":%lu", (unsigned long)stats->enumerationCandidatesCount);
+  fprintf(stream, ",\"cache\":{\"lookups\":%lu,\"hits\":%lu}", (unsigned long)stats->cacheLookupCount,
+    (unsigned long)stats->cacheHitCount);
+  fprintf(stream, ",\"skipped-nodes\":%lu", (unsigned long)stats->skippedCount);
+  fprintf(stream, ",\"phases\":{");
+  for (int phase = 0; phase < CMR_REGULAR_NUM_PHASES; ++phase)
+  {
+    CMR_REGULAR_PHASE_STATS* phaseStats = &stats->phases[phase];
+    fprintf(stream, "%s\"%s\":{\"count\":%lu,\"time\":%.9g,\"max-time\":%.9g,\"size-histogram\":", phase ? "," : "",
+      CMRregularPhaseName(phase), (unsigned long)phaseStats->count, phaseStats->time, phaseStats->maxTime);
+    printHistogramJson(stream, phaseStats->sizeHistogram);
+    fprintf(stream, ",\"time-histogram\":");
+    printHistogramJson(stream, phaseStats->timeHistogram);
+    fputc('}', stream);
+  }
+  fprintf(stream, "},\"workers\":[");
+  for (uint32_t worker = 0; worker < stats->numWorkers; ++worker)
+  {
+    fprintf(stream, "%s{\"count\":%lu,\"time\":%.9g}", worker ? "," : "",
+      (unsigned long)stats->workers[worker].count, stats->workers[worker].time);
+  }
+  fprintf(stream, "],\"total\":{\"count\":%lu,\"time\":%.9g}}", (unsigned long)stats->totalCount, stats->totalTime);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularStatsAdd(CMR_REGULAR_STATS* target, CMR_REGULAR_STATS* source)
+{
+  assert(target);
+  assert(source);
+
+  target->totalCount += source->totalCount;
+  target->totalTime += source->totalTime;
+  CMR_CALL( CMRspStatsAdd(&target->seriesParallel, &source->seriesParallel) );
+  CMR_CALL( CMRgraphicStatsAdd(&target->graphic, &source->graphic) );
+  CMR_CALL( CMRnetworkStatsAdd(&target->network, &source->network) );
+  CMR_CALL( CMRcamionStatsAdd(&target->camion, &source->camion) );
+  target->sequenceExtensionCount += source->sequenceExtensionCount;
+  target->sequenceExtensionTime += source->sequenceExtensionTime;
+  CMRcountersAdd(&target->sequenceExtensionCounters, &source->sequenceExtensionCounters);
+  target->sequenceGraphicCount += source->sequenceGraphicCount;
+  target->sequenceGraphicTime += source->sequenceGraphicTime;
+  target->enumerationCount += source->enumerationCount;
+  target->enumerationTime += source->enumerationTime;
+  CMRcountersAdd(&target->enumerationCounters, &source->enumerationCounters);
+  target->enumerationCandidatesCount += source->enumerationCandidatesCount;
+  target->cacheLookupCount += source->cacheLookupCount;
+  target->cacheHitCount += source->cacheHitCount;
+  target->skippedCount += source->skippedCount;
+  for (int phase = 0; phase < CMR_REGULAR_NUM_PHASES; ++phase)
+  {
+    CMR_REGULAR_PHASE_STATS* targetPhase = &target->phases[phase];
+    CMR_REGULAR_PHASE_STATS* sourcePhase = &source->phases[phase];
+    targetPhase->count += sourcePhase->count;
+    targetPhase->time += sourcePhase->time;
+    if (sourcePhase->maxTime > targetPhase->maxTime)
+      targetPhase->maxTime = sourcePhase->maxTime;
+    for (int bin = 0; bin < CMR_REGULAR_HISTOGRAM_BINS; ++bin)
+    {
+      targetPhase->sizeHistogram[bin] += sourcePhase->sizeHistogram[bin];
+      targetPhase->timeHistogram[bin] += sourcePhase->timeHistogram[bin];
+    }
+  }
+  if (source->numWorkers > target->numWorkers)
+    target->numWorkers = source->numWorkers;
+  for (uint32_t worker = 0; worker < source->numWorkers; ++worker)
+  {
+    target->workers[worker].count += source->workers[worker].count;
+    target->workers[worker].time += source->workers[worker].time;
+  }
+
+  return CMR_OKAY;
+}
+
 
 CMR_ERROR CMRregularTest(CMR* cmr, CMR_CHRMAT* matrix, bool *pisRegular, CMR_MATROID_DEC** pdec,
   CMR_MINOR** pminor, CMR_REGULAR_PARAMS* params, CMR_REGULAR_STATS* stats, double timeLimit)
@@ -106,6 +289,28 @@ CMR_ERROR CMRregularTest(CMR* cmr, CMR_CHRMAT* matrix, bool *pisRegular, CMR_MAT
     return CMR_OKAY;
   }
 
+  /* The support is regular if and only if its Camion signing is totally unimodular. */
+  double totalClock = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
+  if (params->smallMatrices && !pdec && !pminor && CMRsmallFits(matrix) && !CMRdeadlinePassed(&deadline))
+  {
+    CMR_CHRMAT* signedMatrix = NULL;
+    CMR_CALL( CMRchrmatCopy(cmr, matrix, &signedMatrix) );
+    bool decided;
+    CMR_CALL( CMRcamionComputeSigns(cmr, signedMatrix, NULL, NULL, NULL, timeLimit) );
+    CMR_CALL( CMRsmallTestTotallyUnimodular(cmr, signedMatrix, &decided, pisRegular, NULL) );
+    CMR_CALL( CMRchrmatFree(cmr, &signedMatrix) );
+    if (decided)
+    {
+      if (stats)
+      {
+        stats->totalCount++;
+        stats->totalTime += CMRclockNow() - totalClock;
+      }
+      return CMR_OKAY;
+    }
+  }
+
   CMR_CALL( CMRregularityTest(cmr, matrix, false, pisRegular, pdec, pminor, params, stats, timeLimit) );
 
   return CMR_OKAY;
@@ -125,7 +330,7 @@ CMR_ERROR CMRregularCompleteDecomposition(CMR* cmr, CMR_MATROID_DEC* dec, CMR_RE
     params = &defaultParams;
   }
 
-  if (!CMRmatroiddecIsTernary(dec))
+  if (CMRmatroiddecIsTernary(dec))
     return CMR_ERROR_INPUT;
 
   CMR_CALL( CMRregularityCompleteDecomposition(cmr, dec, params, stats, timeLimit) );
@@ -1,12 +1,14 @@
-#define CMR_DEBUG /** Uncomment to debug this file. */
+// #define CMR_DEBUG /** Uncomment to debug this file. */
+
+#include <stdint.h>
 
 #include "env_internal.h"
 #include "regularity_internal.h"
-
-#include <time.h>
+#include "threads.h"
+#include "trace.h"
 
 CMR_ERROR CMRregularityTaskCreateRoot(CMR* cmr, CMR_MATROID_DEC* dec, DecompositionTask** ptask,
-  CMR_REGULAR_PARAMS* params, CMR_REGULAR_STATS* stats, clock_t startClock, double timeLimit)
+  CMR_REGULAR_PARAMS* params, CMR_REGULAR_STATS* stats, CMR_DEADLINE deadline)
 {
   assert(cmr);
   assert(dec);
@@ -21,8 +23,10 @@ CMR_ERROR CMRregularityTaskCreateRoot(CMR* cmr, CMR_MATROID_DEC* dec, Decomposit
 
   task->params = params;
   task->stats = stats;
-  task->startClock = startClock;
-  task->timeLimit = timeLimit;
+  task->deadline = deadline;
+  task->stepDeadline = deadline;
+  task->priority = 0.0;
+  task->sequenceKey = SIZE_MAX;
 
   return CMR_OKAY;
 }
@@ -40,7 +44,7 @@ CMR_ERROR CMRregularityTaskFree(CMR* cmr, DecompositionTask** ptask)
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRregularityQueueCreate(CMR* cmr, DecompositionQueue** pqueue)
+CMR_ERROR CMRregularityQueueCreate(CMR* cmr, DecompositionQueue** pqueue, CMR_REGULAR_SCHEDULE schedule)
 {
   assert(cmr);
   assert(pqueue);
@@ -48,7 +52,10 @@ CMR_ERROR CMRregularityQueueCreate(CMR* cmr, DecompositionQueue** pqueue)
   CMR_CALL( CMRallocBlock(cmr, pqueue) );
   DecompositionQueue* queue = *pqueue;
   queue->head = NULL;
+  queue->numTasks = 0;
   queue->foundIrregularity = false;
+  queue->schedule = schedule;
+  queue->skipped = NULL;
 
   return CMR_OKAY;
 }
@@ -68,6 +75,12 @@ CMR_ERROR CMRregularityQueueFree(CMR* cmr, DecompositionQueue** pqueue)
     queue->head = task->next;
     CMR_CALL( CMRregularityTaskFree(cmr, &task) );
   }
+  while (queue->skipped)
+  {
+    DecompositionTask* task = queue->skipped;
+    queue->skipped = task->next;
+    CMR_CALL( CMRregularityTaskFree(cmr, &task) );
+  }
 
   CMR_CALL( CMRfreeBlock(cmr, pqueue) );
 
@@ -88,15 +101,207 @@ DecompositionTask* CMRregularityQueueRemove(DecompositionQueue* queue)
   DecompositionTask* task = queue->head;
   queue->head = task->next;
   task->next = NULL;
+  queue->numTasks--;
   return task;
 }
 
+/**
+ * \brief Returns the priority of \p task according to \p schedule.
+ */
+
+static
+double taskPriority(
+  DecompositionTask* task,      /**< Task. */
+  CMR_REGULAR_SCHEDULE schedule /**< Order of the queue. */
+)
+{
+  CMR_CHRMAT* matrix = task->dec->matrix;
+  if (!matrix)
+    return 0.0;
+
+  double size = (double) (matrix->numRows + matrix->numColumns);
+  switch (schedule)
+  {
+  case CMR_REGULAR_SCHEDULE_SMALLEST_FIRST:
+    return size;
+  case CMR_REGULAR_SCHEDULE_LARGEST_FIRST:
+    return -size;
+  case CMR_REGULAR_SCHEDULE_SMALL_DENSE_FIRST:
+    /* Size divided by the fraction of nonzero entries. */
+    return size * matrix->numRows * matrix->numColumns / (matrix->numNonzeros + 1.0);
+  default:
+    return 0.0;
+  }
+}
+
+void CMRregularityQueueInsert(DecompositionTask** phead, DecompositionTask* task, CMR_REGULAR_SCHEDULE schedule)
+{
+  assert(phead);
+  assert(task);
+
+  if (schedule != CMR_REGULAR_SCHEDULE_DEPTH_FIRST)
+  {
+    task->priority = taskPriority(task, schedule);
+    while (*phead && (*phead)->priority < task->priority)
+      phead = &(*phead)->next;
+  }
+
+  task->next = *phead;
+  *phead = task;
+}
+
 void CMRregularityQueueAdd(DecompositionQueue* queue, DecompositionTask* task)
 {
   assert(queue);
 
-  task->next = queue->head;
-  queue->head = task;
+  CMRregularityQueueInsert(&queue->head, task, queue->schedule);
+  queue->numTasks++;
+}
+
+/**
+ * \brief Returns the histogram bin of \p value, i.e., its number of binary digits, capped at the last bin.
+ */
+
+static
+int histogramBin(
+  size_t value  /**< Value to be counted. */
+)
+{
+  int bin = 0;
+  while (value > 0 && bin < CMR_REGULAR_HISTOGRAM_BINS - 1)
+  {
+    value >>= 1;
+    ++bin;
+  }
+  return bin;
+}
+
+/**
+ * \brief Records the processing of a decomposition node in the statistics of its phase and in the node log.
+ */
+
+static
+void regularityStatsRecordNode(
+  CMR_REGULAR_STATS* stats, /**< Statistics. */
+  CMR_REGULAR_PHASE phase,  /**< Phase that was carried out. */
+  CMR_MATROID_DEC* dec,     /**< Processed decomposition node. */
+  size_t numRows,           /**< Number of rows of the node's matrix before the processing. */
+  size_t numColumns,        /**< Number of columns of the node's matrix before the processing. */
+  size_t numNonzeros,       /**< Number of nonzeros of the node's matrix before the processing. */
+  double time               /**< Time of the processing. */
+)
+{
+  CMR_REGULAR_PHASE_STATS* phaseStats = &stats->phases[phase];
+  phaseStats->count++;
+  phaseStats->time += time;
+  if (time > phaseStats->maxTime)
+    phaseStats->maxTime = time;
+  phaseStats->sizeHistogram[histogramBin(numNonzeros)]++;
+  phaseStats->timeHistogram[histogramBin((size_t) (time * 1.0e6))]++;
+
+  if (stats->nodeLog)
+  {
+    fprintf(stats->nodeLog, "%s,%zu,%zu,%zu,%.9g,%d,%d\n", CMRregularPhaseName(phase), numRows, numColumns,
+      numNonzeros, time, (int) dec->type, (int) dec->regularity);
+  }
+}
+
+/**
+ * \brief Returns the phase that has to be carried out next for the decomposition node of \p task.
+ */
+
+static
+CMR_REGULAR_PHASE regularityTaskPhase(
+  DecompositionTask* task /**< Task. */
+)
+{
+  CMR_MATROID_DEC* dec = task->dec;
+  bool isSmall = task->params->directGraphicness || dec->matrix->numRows <= 3 || dec->matrix->numColumns <= 3;
+
+  if (!dec->testedTwoConnected)
+    return CMR_REGULAR_PHASE_ONE_SUM;
+  else if (!dec->graphicness && isSmall)
+    return CMR_REGULAR_PHASE_GRAPHIC;
+  else if (!dec->cographicness && isSmall)
+    return CMR_REGULAR_PHASE_COGRAPHIC;
+  else if (!dec->testedR10)
+    return CMR_REGULAR_PHASE_R10;
+  else if (!dec->testedTwoSum && task->params->directTwoSums)
+    return CMR_REGULAR_PHASE_TWO_SUM;
+  else if (!dec->testedSeriesParallel)
+    return CMR_REGULAR_PHASE_SERIES_PARALLEL;
+  else if (dec->denseMatrix)
+    return CMR_REGULAR_PHASE_SEQUENCE_EXTENSION;
+  else if (dec->nestedMinorsMatrix && (dec->nestedMinorsLastGraphic == SIZE_MAX))
+    return CMR_REGULAR_PHASE_SEQUENCE_GRAPHIC;
+  else if (dec->nestedMinorsMatrix && (dec->nestedMinorsLastCographic == SIZE_MAX))
+    return CMR_REGULAR_PHASE_SEQUENCE_COGRAPHIC;
+  else
+    return CMR_REGULAR_PHASE_THREE_SEPARATION;
+}
+
+/**
+ * \brief Carries out \p phase for the decomposition node of \p task.
+ */
+
+static
+CMR_ERROR regularityTaskRunPhase(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  DecompositionTask* task,    /**< Task to be processed; already removed from the list of unprocessed tasks. */
+  DecompositionQueue* queue,  /**< Queue of unprocessed tasks. */
+  CMR_REGULAR_PHASE phase     /**< Phase to carry out. */
+)
+{
+  switch (phase)
+  {
+  case CMR_REGULAR_PHASE_ONE_SUM:
+    CMRdbgMsg(4, "Searching for 1-separations.\n");
+    return CMRregularitySearchOneSum(cmr, task, queue);
+  case CMR_REGULAR_PHASE_GRAPHIC:
+    CMRdbgMsg(4, "Testing directly for %s.\n", task->dec->isTernary ? "being network" : "graphicness");
+    return CMRregularityTestGraphicness(cmr, task, queue);
+  case CMR_REGULAR_PHASE_COGRAPHIC:
+    CMRdbgMsg(4, "Testing directly for %s.\n", task->dec->isTernary ? "being conetwork" : "cographicness");
+    return CMRregularityTestCographicness(cmr, task, queue);
+  case CMR_REGULAR_PHASE_R10:
+    CMRdbgMsg(4, "Testing for being R_10.\n");
+    return CMRregularityTestR10(cmr, task, queue);
+  case CMR_REGULAR_PHASE_TWO_SUM:
+    CMRdbgMsg(4, "Searching for 2-separations at cut vertices.\n");
+    return CMRregularitySearchTwoSum(cmr, task, queue);
+  case CMR_REGULAR_PHASE_SERIES_PARALLEL:
+    CMRdbgMsg(4, "Testing for series-parallel reductions.\n");
+    return CMRregularityDecomposeSeriesParallel(cmr, task, queue);
+  case CMR_REGULAR_PHASE_SEQUENCE_EXTENSION:
+    CMRdbgMsg(4, "Attempting to construct a sequence of nested minors.\n");
+    return CMRregularityExtendNestedMinorSequence(cmr, task, queue);
+  case CMR_REGULAR_PHASE_SEQUENCE_GRAPHIC:
+  case CMR_REGULAR_PHASE_SEQUENCE_COGRAPHIC:
+    CMRdbgMsg(4, "Testing along the sequence for %s.\n", task->dec->isTernary ? "being (co)network"
+      : "(co)graphicness");
+    return CMRregularityNestedMinorSequenceGraphicness(cmr, task, queue);
+  default:
+    assert(phase == CMR_REGULAR_PHASE_THREE_SEPARATION);
+    CMRdbgMsg(4, "Searching for 3-separations along the sequence.\n");
+    return CMRregularityNestedMinorSequenceSearchThreeSeparation(cmr, task, queue);
+  }
+}
+
+/**
+ * \brief Returns whether \p dec is a leaf that is regular due to its own type and may thus be cached.
+ */
+
+static
+bool regularityCacheableLeaf(
+  CMR_MATROID_DEC* dec, /**< Decomposition node. */
+  bool planarityCheck   /**< Whether graphic or cographic nodes are also tested for the other property. */
+)
+{
+  if (dec->numChildren > 0)
+    return false;
+  if (dec->type == CMR_MATROID_DEC_TYPE_R10 || dec->type == CMR_MATROID_DEC_TYPE_PLANAR)
+    return true;
+  return !planarityCheck && (dec->type == CMR_MATROID_DEC_TYPE_GRAPH || dec->type == CMR_MATROID_DEC_TYPE_COGRAPH);
 }
 
 /**
@@ -116,52 +321,748 @@ CMR_ERROR CMRregularityTaskRun(
 
   CMRdbgMsg(2, "Processing %p.\n", task);
 
-  if (!task->dec->testedTwoConnected)
+  /* The task may be freed during its processing. */
+  CMR_MATROID_DEC* dec = task->dec;
+  CMR_REGULAR_STATS* stats = task->stats;
+  size_t numRows = dec->matrix->numRows;
+  size_t numColumns = dec->matrix->numColumns;
+  size_t numNonzeros = dec->matrix->numNonzeros;
+  double time = stats ? CMRclockNow() : 0.0;
+  CMR_REGULAR_PHASE phase = regularityTaskPhase(task);
+
+  bool trace = CMRtraceEnabled(cmr);
+  if (trace)
   {
-    CMRdbgMsg(4, "Searching for 1-separations.\n");
-    CMR_CALL( CMRregularitySearchOneSum(cmr, task, queue) );
+    /* Nodes are identified by their addresses, where the parent of the root is 0x0. */
+    CMRtraceWriteBegin(cmr, CMRregularPhaseName(phase),
+      "\"node\":\"0x%zx\",\"parent\":\"0x%zx\",\"rows\":%zu,\"columns\":%zu,\"nonzeros\":%zu",
+      (size_t) (uintptr_t) dec, (size_t) (uintptr_t) dec->parent, numRows, numColumns, numNonzeros);
   }
-  else if (!task->dec->graphicness
-    && (task->params->directGraphicness || task->dec->matrix->numRows <= 3 || task->dec->matrix->numColumns <= 3))
+
+  /* Nodes whose processing has not started are looked up in the cache. */
+  CMR_REGULAR_CACHE* cache = task->params->cache;
+  bool planarityCheck = task->params->planarityCheck;
+  RegularityCacheKey cacheKey;
+  cacheKey.words = NULL;
+  if (cache && dec->testedTwoConnected && dec->type == CMR_MATROID_DEC_TYPE_UNKNOWN && dec->numChildren == 0
+    && !dec->graphicness && !dec->cographicness && !dec->testedR10 && !dec->denseMatrix && !dec->nestedMinorsMatrix
+    && numRows > 0 && numColumns > 0)
   {
-    CMRdbgMsg(4, "Testing directly for %s.\n", task->dec->isTernary ? "being network" : "graphicness");
-    CMR_CALL( CMRregularityTestGraphicness(cmr, task, queue) );
+    bool found;
+    CMR_CALL( CMRregularityCacheKeyCreate(cmr, dec, planarityCheck, &cacheKey) );
+    CMR_CALL( CMRregularityCacheLookup(cmr, cache, dec, &cacheKey, task->params->graphs != CMR_DEC_CONSTRUCT_NONE,
+      &found) );
+    if (stats)
+      stats->cacheLookupCount++;
+    if (found)
+    {
+      if (stats)
+        stats->cacheHitCount++;
+      if (trace)
+        CMRtraceWriteEnd(cmr, CMRregularPhaseName(phase));
+      CMR_CALL( CMRregularityCacheKeyFree(cmr, &cacheKey) );
+      CMR_CALL( CMRregularityTaskFree(cmr, &task) );
+      return CMR_OKAY;
+    }
   }
-  else if (!task->dec->cographicness
-    && (task->params->directGraphicness || task->dec->matrix->numRows <= 3 || task->dec->matrix->numColumns <= 3))
+
+  bool wasCacheable = regularityCacheableLeaf(dec, planarityCheck);
+  CMR_REGULAR_PARAMS* params = task->params;
+  DecompositionTask* oldHead = queue->head;
+
+  /* The node's budget only applies to this step, while new tasks inherit the deadline of the computation. */
+  bool hasBudget = params->nodeTimeLimit > 0.0 && !params->deterministic;
+  task->stepDeadline = task->deadline;
+  if (hasBudget)
   {
-    CMRdbgMsg(4, "Testing directly for %s.\n", task->dec->isTernary ? "being conetwork" : "cographicness");
-    CMR_CALL( CMRregularityTestCographicness(cmr, task, queue) );
+    double budgetEnd = CMRclockNow() + params->nodeTimeLimit;
+    if (budgetEnd < task->stepDeadline.end)
+      task->stepDeadline.end = budgetEnd;
   }
-  else if (!task->dec->testedR10)
+
+  CMR_STACK_MARK stackMark;
+  CMR_CALL( CMRstackMark(cmr, &stackMark) );
+  CMR_ERROR error = regularityTaskRunPhase(cmr, task, queue, phase);
+
+  if (trace)
+    CMRtraceWriteEnd(cmr, CMRregularPhaseName(phase));
+
+  /* A phase that runs out of time leaves its node such that the phase can be carried out again. If only the node's
+   * budget was exceeded, then the node is skipped and the remaining ones are processed. */
+  if (error == CMR_ERROR_TIMEOUT)
   {
-    CMRdbgMsg(4, "Testing for being R_10.\n");
-    CMR_CALL( CMRregularityTestR10(cmr, task, queue) );
+    CMRstackRestore(cmr, &stackMark);
+    if (cacheKey.words)
+      CMR_CALL( CMRregularityCacheKeyFree(cmr, &cacheKey) );
+    if (hasBudget && !CMRdeadlinePassed(&task->deadline))
+    {
+      CMRdbgMsg(4, "Skipping node %p since it exceeded its budget.\n", dec);
+      task->next = queue->skipped;
+      queue->skipped = task;
+      if (stats)
+        stats->skippedCount++;
+      return CMR_OKAY;
+    }
+    CMRregularityQueueAdd(queue, task);
   }
-  else if (!task->dec->testedSeriesParallel)
+  CMR_CALL( error );
+
+  /* New tasks only become visible to other workers after this function returns, so dec may still be inspected. */
+  /* Close to the memory limit, the cache does not grow anymore. */
+  if (cache && !wasCacheable && regularityCacheableLeaf(dec, planarityCheck) && !CMRisMemoryShort(cmr, 0))
   {
-    CMRdbgMsg(4, "Testing for series-parallel reductions.\n");
-    CMR_CALL( CMRregularityDecomposeSeriesParallel(cmr, task, queue) );
+    if (!cacheKey.words)
+      CMR_CALL( CMRregularityCacheKeyCreate(cmr, dec, planarityCheck, &cacheKey) );
+    CMR_CALL( CMRregularityCacheInsert(cmr, cache, dec, &cacheKey) );
   }
-  else if (task->dec->denseMatrix)
+  if (cacheKey.words)
+    CMR_CALL( CMRregularityCacheKeyFree(cmr, &cacheKey) );
+
+  /* The node is finished unless one of the tasks that were added to the queue belongs to it. Close to the memory
+   * limit, its intermediate data is released even if it shall be kept. */
+  bool keepIntermediate = params->keepIntermediate && !CMRisMemoryShort(cmr, 0);
+  if (!keepIntermediate || params->graphs != CMR_DEC_CONSTRUCT_ALL)
   {
-    CMRdbgMsg(4, "Attempting to construct a sequence of nested minors.\n");
-    CMR_CALL( CMRregularityExtendNestedMinorSequence(cmr, task, queue) );
+    bool isFinished = true;
+    for (DecompositionTask* added = queue->head; added != oldHead; added = added->next)
+    {
+      if (added->dec == dec)
+      {
+        isFinished = false;
+        break;
+      }
+    }
+    if (isFinished)
+    {
+      if (!keepIntermediate)
+        CMR_CALL( CMRmatroiddecFreeIntermediate(cmr, dec) );
+      if (params->graphs == CMR_DEC_CONSTRUCT_NONE
+        || (params->graphs == CMR_DEC_CONSTRUCT_LEAVES && dec->numChildren > 0))
+      {
+        CMR_CALL( CMRmatroiddecFreeGraphs(cmr, dec) );
+      }
+    }
   }
-  else if (task->dec->nestedMinorsMatrix && (task->dec->nestedMinorsLastGraphic == SIZE_MAX))
+
+  if (stats)
+    regularityStatsRecordNode(stats, phase, dec, numRows, numColumns, numNonzeros, CMRclockNow() - time);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Position of a task in the order in which the sequential depth-first processing removes the tasks.
+ *
+ * The tasks form a tree in which the parent of a task is the task whose processing added it, and in which the
+ * children are ordered as in the LIFO list after that processing. The sequential processing removes the tasks in
+ * preorder of this tree.
+ */
+
+typedef struct
+{
+  size_t parent;    /**< \brief Index of the key of the task that added this task, or \c SIZE_MAX for initial tasks. */
+  size_t position;  /**< \brief Position among the tasks added by the same task. */
+  size_t depth;     /**< \brief Number of ancestors in the tree of tasks. */
+} SequenceKey;
+
+/**
+ * \brief Record of a task that was processed in deterministic mode.
+ */
+
+typedef struct
+{
+  size_t key;             /**< \brief Index of the key of the task. */
+  CMR_MATROID_DEC* dec;   /**< \brief Node of the task. */
+  CMR_MATROID_DEC state;  /**< \brief Copy of the node before the processing. */
+  CMR_DEADLINE deadline;  /**< \brief Deadline of the task. */
+} ProcessedTask;
+
+/**
+ * \brief Shared state of the workers that process a decomposition queue in parallel.
+ *
+ * Every worker owns a list of tasks that is ordered according to \ref CMR_REGULAR_PARAMS::schedule, i.e., a LIFO list
+ * by default. A worker processes its own tasks first and steals the first task of another worker if its own list is
+ * empty. All lists are protected by a single mutex since the processing of
+ * a task is much more expensive than the list operations.
+ *
+ * In deterministic mode, every task has a \ref SequenceKey. Tasks beyond the smallest key of a task that found
+ * irregularity are not processed anymore, and those processed before that task was found are undone afterwards.
+ */
+
+typedef struct
+{
+  CMR_REGULAR_PARAMS* params;     /**< \brief Parameters for the computation. */
+  size_t numWorkers;              /**< \brief Number of workers. */
+  DecompositionTask** heads;      /**< \brief Array with the first task of each worker's list. */
+  size_t numTasks;                /**< \brief Total number of tasks in all lists. */
+  size_t numProcessed;            /**< \brief Number of processed tasks. */
+  CMR_REGULAR_STATS* workerStats; /**< \brief Array with statistics of each worker (or \c NULL). */
+  size_t numBusy;                 /**< \brief Number of workers that are currently processing a task. */
+  bool foundIrregularity;         /**< \brief Whether irregularity was detected for some node. */
+  bool deterministic;             /**< \brief Whether the tree shall be that of the sequential processing. */
+  SequenceKey* keys;              /**< \brief Array with the keys of the tasks in deterministic mode. */
+  size_t numKeys;                 /**< \brief Number of keys. */
+  size_t memKeys;                 /**< \brief Memory for keys. */
+  ProcessedTask* processed;       /**< \brief Array with the records of processed tasks in deterministic mode. */
+  size_t numRecords;              /**< \brief Number of records of processed tasks. */
+  size_t memRecords;              /**< \brief Memory for records of processed tasks. */
+  size_t irregularKey;            /**< \brief Smallest key of a task that found irregularity, or \c SIZE_MAX. */
+  DecompositionTask* skipped;     /**< \brief List of tasks beyond \ref irregularKey that were not processed. */
+  DecompositionTask* exceeded;    /**< \brief List of tasks whose node exceeded
+                                   **         \ref CMR_REGULAR_PARAMS::nodeTimeLimit. */
+  CMR_ERROR error;                /**< \brief First error that occurred. */
+  CMR_MUTEX mutex;                /**< \brief Mutex protecting all other members. */
+  CMR_CONDITION condition;        /**< \brief Condition for signaling new tasks or termination. */
+} ParallelQueue;
+
+/**
+ * \brief Compares the keys with indices \p a and \p b in the order of the sequential processing.
+ *
+ * \returns A negative value if \p a comes first, a positive value if \p b comes first, and 0 if they are equal.
+ */
+
+static
+int sequenceKeyCompare(
+  SequenceKey* keys,  /**< Array with all keys. */
+  size_t a,           /**< Index of first key. */
+  size_t b            /**< Index of second key. */
+)
+{
+  if (a == b)
+    return 0;
+
+  /* A task precedes all tasks that were added by it or its descendants. */
+  while (keys[a].depth > keys[b].depth)
   {
-    CMRdbgMsg(4, "Testing along the sequence for %s.\n", task->dec->isTernary ? "being network" : "graphicness");
-    CMR_CALL( CMRregularityNestedMinorSequenceGraphicness(cmr, task, queue) );
+    a = keys[a].parent;
+    if (a == b)
+      return 1;
   }
-  else if (task->dec->nestedMinorsMatrix && (task->dec->nestedMinorsLastCographic == SIZE_MAX))
+  while (keys[b].depth > keys[a].depth)
   {
-    CMRdbgMsg(4, "Testing along the sequence for %s.\n", task->dec->isTernary ? "being conetwork" : "cographicness");
-    CMR_CALL( CMRregularityNestedMinorSequenceCographicness(cmr, task, queue) );
+    b = keys[b].parent;
+    if (a == b)
+      return -1;
   }
-  else
+
+  while (keys[a].parent != keys[b].parent)
   {
-    CMRdbgMsg(4, "Searching for 3-separations along the sequence.\n");
-    CMR_CALL( CMRregularityNestedMinorSequenceSearchThreeSeparation(cmr, task, queue) );
+    a = keys[a].parent;
+    b = keys[b].parent;
+  }
+
+  return keys[a].position < keys[b].position ? -1 : 1;
+}
+
+/**
+ * \brief Creates the key of a task.
+ *
+ * Must be called while holding the mutex.
+ */
+
+static
+CMR_ERROR sequenceKeyCreate(
+  CMR* cmr,               /**< \ref CMR environment. */
+  ParallelQueue* pqueue,  /**< Shared queue. */
+  size_t parent,          /**< Index of the key of the task that added the task, or \c SIZE_MAX. */
+  size_t position,        /**< Position among the tasks added by the same task. */
+  size_t* pkey            /**< Pointer for storing the index of the new key. */
+)
+{
+  if (pqueue->numKeys == pqueue->memKeys)
+  {
+    pqueue->memKeys = 2 * pqueue->memKeys + 16;
+    CMR_CALL( CMRreallocBlockArray(cmr, &pqueue->keys, pqueue->memKeys) );
+  }
+
+  SequenceKey* key = &pqueue->keys[pqueue->numKeys];
+  key->parent = parent;
+  key->position = position;
+  key->depth = (parent == SIZE_MAX) ? 0 : pqueue->keys[parent].depth + 1;
+  *pkey = pqueue->numKeys++;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Records the state of the node of \p task before its processing in deterministic mode.
+ *
+ * Must be called while holding the mutex.
+ */
+
+static
+CMR_ERROR parallelQueueRecord(
+  CMR* cmr,               /**< \ref CMR environment. */
+  ParallelQueue* pqueue,  /**< Shared queue. */
+  DecompositionTask* task /**< Task that is about to be processed. */
+)
+{
+  if (pqueue->numRecords == pqueue->memRecords)
+  {
+    pqueue->memRecords = 2 * pqueue->memRecords + 16;
+    CMR_CALL( CMRreallocBlockArray(cmr, &pqueue->processed, pqueue->memRecords) );
+  }
+
+  ProcessedTask* record = &pqueue->processed[pqueue->numRecords++];
+  record->key = task->sequenceKey;
+  record->dec = task->dec;
+  record->state = *task->dec;
+  record->deadline = task->deadline;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Pops a task from the list of \p worker or steals one from another worker's list.
+ *
+ * Must be called while holding the mutex.
+ */
+
+static
+DecompositionTask* parallelQueueRemove(
+  ParallelQueue* pqueue,  /**< Shared queue. */
+  size_t worker           /**< Index of the worker. */
+)
+{
+  for (size_t i = 0; i < pqueue->numWorkers; ++i)
+  {
+    size_t victim = (worker + i) % pqueue->numWorkers;
+    DecompositionTask* task = pqueue->heads[victim];
+    if (task)
+    {
+      pqueue->heads[victim] = task->next;
+      task->next = NULL;
+      pqueue->numTasks--;
+      return task;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * \brief Main function of each worker of a parallel decomposition.
+ */
+
+static
+CMR_ERROR parallelQueueWorker(
+  CMR* cmr,       /**< \ref CMR environment of the worker. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref ParallelQueue. */
+)
+{
+  ParallelQueue* pqueue = (ParallelQueue*) data;
+  CMR_REGULAR_SCHEDULE schedule = pqueue->params->schedule;
+
+  /* In deterministic mode, the order of the new tasks is that of the sequential processing. */
+  DecompositionQueue localQueue;
+  localQueue.head = NULL;
+  localQueue.numTasks = 0;
+  localQueue.foundIrregularity = false;
+  localQueue.schedule = pqueue->deterministic ? CMR_REGULAR_SCHEDULE_DEPTH_FIRST : schedule;
+  localQueue.skipped = NULL;
+
+  CMRmutexLock(&pqueue->mutex);
+  while (!pqueue->error && (pqueue->params->completeTree || pqueue->deterministic || !pqueue->foundIrregularity))
+  {
+    if (CMRisInterrupted(cmr))
+    {
+      pqueue->error = CMR_ERROR_TIMEOUT;
+      break;
+    }
+
+    DecompositionTask* task = parallelQueueRemove(pqueue, worker);
+    if (!task)
+    {
+      if (pqueue->numBusy == 0)
+        break;
+
+      CMRconditionWait(&pqueue->condition, &pqueue->mutex);
+      continue;
+    }
+
+    size_t key = task->sequenceKey;
+    if (pqueue->deterministic)
+    {
+      /* The sequential processing stops before it reaches tasks beyond the first irregular one. */
+      if (pqueue->irregularKey != SIZE_MAX && sequenceKeyCompare(pqueue->keys, key, pqueue->irregularKey) > 0)
+      {
+        task->next = pqueue->skipped;
+        pqueue->skipped = task;
+        continue;
+      }
+
+      CMR_ERROR error = parallelQueueRecord(cmr, pqueue, task);
+      if (error)
+      {
+        pqueue->error = error;
+        task->next = pqueue->skipped;
+        pqueue->skipped = task;
+        break;
+      }
+    }
+
+    pqueue->numBusy++;
+    CMRmutexUnlock(&pqueue->mutex);
+
+    if (pqueue->workerStats)
+      task->stats = &pqueue->workerStats[worker];
+    CMR_ERROR error = CMRregularityTaskRun(cmr, task, &localQueue);
+
+    CMRmutexLock(&pqueue->mutex);
+    pqueue->numBusy--;
+    if (error && !pqueue->error)
+      pqueue->error = error;
+    if (localQueue.foundIrregularity)
+    {
+      pqueue->foundIrregularity = true;
+      if (pqueue->deterministic && (pqueue->irregularKey == SIZE_MAX
+        || sequenceKeyCompare(pqueue->keys, key, pqueue->irregularKey) < 0))
+      {
+        pqueue->irregularKey = key;
+      }
+      localQueue.foundIrregularity = false;
+    }
+    if (localQueue.skipped)
+    {
+      assert(!localQueue.skipped->next);
+      localQueue.skipped->next = pqueue->exceeded;
+      pqueue->exceeded = localQueue.skipped;
+      localQueue.skipped = NULL;
+    }
+
+    if (pqueue->deterministic)
+    {
+      size_t position = 0;
+      for (DecompositionTask* added = localQueue.head; added; added = added->next)
+      {
+        error = sequenceKeyCreate(cmr, pqueue, key, position++, &added->sequenceKey);
+        if (error && !pqueue->error)
+          pqueue->error = error;
+      }
+    }
+
+    /* Move the new tasks to the front of the worker's list, keeping their order, or merge them into it. */
+    if (localQueue.head && schedule != CMR_REGULAR_SCHEDULE_DEPTH_FIRST)
+    {
+      while (localQueue.head)
+      {
+        DecompositionTask* task = localQueue.head;
+        localQueue.head = task->next;
+        CMRregularityQueueInsert(&pqueue->heads[worker], task, schedule);
+      }
+      pqueue->numTasks += localQueue.numTasks;
+      localQueue.numTasks = 0;
+    }
+    else if (localQueue.head)
+    {
+      DecompositionTask* last = localQueue.head;
+      while (last->next)
+        last = last->next;
+      last->next = pqueue->heads[worker];
+      pqueue->heads[worker] = localQueue.head;
+      pqueue->numTasks += localQueue.numTasks;
+      localQueue.head = NULL;
+      localQueue.numTasks = 0;
+    }
+
+    CMR_PROGRESS progress;
+    progress.numProcessedNodes = ++pqueue->numProcessed;
+    progress.queueLength = pqueue->numTasks;
+    CMRreportProgress(cmr, &progress);
+
+    CMRconditionBroadcast(&pqueue->condition);
+  }
+
+  /* Wake up all waiting workers since we may have terminated due to cancellation. */
+  CMRconditionBroadcast(&pqueue->condition);
+  CMRmutexUnlock(&pqueue->mutex);
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Resets \p dec to \p state if the node was fresh in that state, i.e., if its processing had not started.
+ *
+ * The processing of a fresh node only adds data to it. The transpose is dropped since it is only a cache.
+ */
+
+static
+CMR_ERROR parallelQueueResetNode(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec,     /**< Decomposition node. */
+  CMR_MATROID_DEC* state,   /**< Copy of \p dec before its processing. */
+  bool* preset              /**< Pointer for storing whether \p dec was reset. */
+)
+{
+  *preset = false;
+  if (state->children || state->graph || state->cograph || state->seriesParallelReductions || state->pivotRows
+    || state->denseMatrix || state->nestedMinorsSequenceNumRows || state->nestedMinorsMatrix
+    || state->irregularMinor)
+  {
+    return CMR_OKAY;
+  }
+
+  for (size_t c = 0; c < dec->numChildren; ++c)
+    CMR_CALL( CMRmatroiddecFree(cmr, &dec->children[c]) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->children) );
+  CMR_CALL( CMRmatroiddecFreeGraphs(cmr, dec) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->seriesParallelReductions) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->pivotRows) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &dec->pivotColumns) );
+  CMR_CALL( CMRmatroiddecFreeIntermediate(cmr, dec) );
+  CMR_CALL( CMRchrmatFree(cmr, &dec->transpose) );
+  CMR_CALL( CMRminorFree(cmr, &dec->irregularMinor) );
+
+  *dec = *state;
+  dec->transpose = NULL;
+  for (size_t row = 0; row < dec->numRows; ++row)
+    dec->rowsChild[row] = SIZE_MAX;
+  for (size_t column = 0; column < dec->numColumns; ++column)
+    dec->columnsChild[column] = SIZE_MAX;
+  *preset = true;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Establishes the state in which the sequential processing stops after the first irregular task.
+ *
+ * Unprocessed tasks that the sequential processing does not create are freed. The nodes of processed tasks beyond the
+ * first irregular one that the sequential processing creates are reset and get a new task.
+ */
+
+static
+CMR_ERROR parallelQueueRestore(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  ParallelQueue* pqueue,    /**< Shared queue. */
+  CMR_REGULAR_STATS* stats  /**< Statistics for the computation (may be \c NULL). */
+)
+{
+  SequenceKey* keys = pqueue->keys;
+  size_t irregularKey = pqueue->irregularKey;
+
+  /* Gather all unprocessed tasks. */
+  DecompositionTask* remaining = pqueue->skipped;
+  pqueue->skipped = NULL;
+  for (size_t w = 0; w < pqueue->numWorkers; ++w)
+  {
+    while (pqueue->heads[w])
+    {
+      DecompositionTask* task = pqueue->heads[w];
+      pqueue->heads[w] = task->next;
+      task->next = remaining;
+      remaining = task;
+    }
+  }
+  pqueue->numTasks = 0;
+
+  while (remaining)
+  {
+    DecompositionTask* task = remaining;
+    remaining = task->next;
+    size_t parent = (task->sequenceKey == SIZE_MAX) ? SIZE_MAX : keys[task->sequenceKey].parent;
+    if (parent != SIZE_MAX && sequenceKeyCompare(keys, parent, irregularKey) > 0)
+      CMR_CALL( CMRregularityTaskFree(cmr, &task) );
+    else
+    {
+      task->next = pqueue->heads[0];
+      pqueue->heads[0] = task;
+      pqueue->numTasks++;
+    }
+  }
+
+  /* The nodes of the other tasks are freed together with the nodes that are reset. */
+  for (size_t r = 0; r < pqueue->numRecords; ++r)
+  {
+    ProcessedTask* record = &pqueue->processed[r];
+    size_t parent = keys[record->key].parent;
+    if (sequenceKeyCompare(keys, record->key, irregularKey) <= 0
+      || (parent != SIZE_MAX && sequenceKeyCompare(keys, parent, irregularKey) > 0))
+    {
+      continue;
+    }
+
+    bool reset;
+    CMR_CALL( parallelQueueResetNode(cmr, record->dec, &record->state, &reset) );
+    if (reset)
+    {
+      DecompositionTask* task = NULL;
+      CMR_CALL( CMRregularityTaskCreateRoot(cmr, record->dec, &task, pqueue->params, stats, record->deadline) );
+      task->sequenceKey = record->key;
+      task->next = pqueue->heads[0];
+      pqueue->heads[0] = task;
+      pqueue->numTasks++;
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularityQueueProcess(CMR* cmr, DecompositionQueue* queue, CMR_REGULAR_PARAMS* params,
+  CMR_REGULAR_STATS* stats)
+{
+  assert(cmr);
+  assert(queue);
+  assert(params);
+
+  if (queue->foundIrregularity && !params->completeTree)
+    return CMR_OKAY;
+
+  /* The single-threaded processing is the reference of the deterministic mode unless another schedule is used. */
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, 0);
+  bool deterministic = params->deterministic && !params->completeTree;
+  if (numWorkers == 1 && (!deterministic || queue->schedule == CMR_REGULAR_SCHEDULE_DEPTH_FIRST))
+  {
+    CMR_PROGRESS progress;
+    progress.numProcessedNodes = 0;
+    while (!CMRregularityQueueEmpty(queue) && (params->completeTree || !queue->foundIrregularity))
+    {
+      if (CMRisInterrupted(cmr))
+        return CMR_ERROR_TIMEOUT;
+
+      DecompositionTask* task = CMRregularityQueueRemove(queue);
+      CMR_CALL( CMRregularityTaskRun(cmr, task, queue) );
+
+      progress.numProcessedNodes++;
+      progress.queueLength = queue->numTasks;
+      CMRreportProgress(cmr, &progress);
+    }
+
+    return CMR_OKAY;
+  }
+
+  CMRdbgMsg(0, "Processing decomposition queue with %zu workers.\n", numWorkers);
+
+  ParallelQueue pqueue;
+  pqueue.params = params;
+  pqueue.numWorkers = numWorkers;
+  pqueue.heads = NULL;
+  pqueue.workerStats = NULL;
+  pqueue.numBusy = 0;
+  pqueue.foundIrregularity = queue->foundIrregularity;
+  pqueue.deterministic = deterministic;
+  pqueue.keys = NULL;
+  pqueue.numKeys = 0;
+  pqueue.memKeys = 0;
+  pqueue.processed = NULL;
+  pqueue.numRecords = 0;
+  pqueue.memRecords = 0;
+  pqueue.irregularKey = SIZE_MAX;
+  pqueue.skipped = NULL;
+  pqueue.exceeded = NULL;
+  pqueue.error = CMR_OKAY;
+  CMR_CALL( CMRallocBlockArray(cmr, &pqueue.heads, numWorkers) );
+  for (size_t w = 0; w < numWorkers; ++w)
+    pqueue.heads[w] = NULL;
+  pqueue.heads[0] = queue->head;
+  pqueue.numTasks = queue->numTasks;
+  pqueue.numProcessed = 0;
+  queue->head = NULL;
+  queue->numTasks = 0;
+  if (deterministic)
+  {
+    size_t position = 0;
+    for (DecompositionTask* task = pqueue.heads[0]; task; task = task->next)
+      CMR_CALL( sequenceKeyCreate(cmr, &pqueue, SIZE_MAX, position++, &task->sequenceKey) );
+  }
+  if (stats)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, &pqueue.workerStats, numWorkers) );
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+      CMR_CALL( CMRregularStatsInit(&pqueue.workerStats[w]) );
+      pqueue.workerStats[w].nodeLog = stats->nodeLog;
+    }
+  }
+  CMRmutexInit(&pqueue.mutex);
+  CMRconditionInit(&pqueue.condition);
+
+  CMR_ERROR error = CMRthreadsRun(cmr, numWorkers, parallelQueueWorker, &pqueue);
+  if (!error)
+    error = pqueue.error;
+
+  CMRconditionFree(&pqueue.condition);
+  CMRmutexFree(&pqueue.mutex);
+
+  if (pqueue.irregularKey != SIZE_MAX && (!error || error == CMR_ERROR_TIMEOUT))
+    CMR_CALL( parallelQueueRestore(cmr, &pqueue, stats) );
+
+  /* Return the remaining tasks to the queue such that the caller frees them. */
+  queue->foundIrregularity = pqueue.foundIrregularity;
+  for (size_t w = 0; w < numWorkers; ++w)
+  {
+    while (pqueue.heads[w])
+    {
+      DecompositionTask* task = pqueue.heads[w];
+      pqueue.heads[w] = task->next;
+      CMRregularityQueueAdd(queue, task);
+    }
+  }
+  while (pqueue.skipped)
+  {
+    DecompositionTask* task = pqueue.skipped;
+    pqueue.skipped = task->next;
+    CMRregularityQueueAdd(queue, task);
+  }
+  while (pqueue.exceeded)
+  {
+    DecompositionTask* task = pqueue.exceeded;
+    pqueue.exceeded = task->next;
+    task->next = queue->skipped;
+    queue->skipped = task;
+  }
+
+  /* An interruption after the last task does not affect the result. */
+  if (error == CMR_ERROR_TIMEOUT && CMRregularityQueueEmpty(queue))
+    error = CMR_OKAY;
+
+  if (stats)
+  {
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+      CMR_REGULAR_WORKER_STATS* workerStats = &stats->workers[w % CMR_REGULAR_MAX_WORKERS];
+      for (int phase = 0; phase < CMR_REGULAR_NUM_PHASES; ++phase)
+      {
+        workerStats->count += pqueue.workerStats[w].phases[phase].count;
+        workerStats->time += pqueue.workerStats[w].phases[phase].time;
+      }
+      CMR_CALL( CMRregularStatsAdd(stats, &pqueue.workerStats[w]) );
+    }
+    if (numWorkers > stats->numWorkers)
+      stats->numWorkers = numWorkers < CMR_REGULAR_MAX_WORKERS ? numWorkers : CMR_REGULAR_MAX_WORKERS;
+    CMR_CALL( CMRfreeBlockArray(cmr, &pqueue.workerStats) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &pqueue.processed) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &pqueue.keys) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &pqueue.heads) );
+
+  return error;
+}
+
+/**
+ * \brief Frees the (co)graphs of the nodes of the tree rooted at \p dec that shall not be constructed.
+ *
+ * They can be constructed again via \ref CMRmatroiddecConstructGraph and \ref CMRmatroiddecConstructCograph.
+ */
+
+static
+CMR_ERROR regularityDiscardGraphs(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec,       /**< Decomposition node. */
+  CMR_DEC_CONSTRUCT construct /**< Which (co)graphs to keep. */
+)
+{
+  assert(cmr);
+  assert(dec);
+
+  if (construct == CMR_DEC_CONSTRUCT_NONE || (construct == CMR_DEC_CONSTRUCT_LEAVES && dec->numChildren > 0))
+    CMR_CALL( CMRmatroiddecFreeGraphs(cmr, dec) );
+
+  for (size_t c = 0; c < dec->numChildren; ++c)
+  {
+    if (dec->children[c])
+      CMR_CALL( regularityDiscardGraphs(cmr, dec->children[c], construct) );
   }
 
   return CMR_OKAY;
@@ -180,41 +1081,87 @@ CMR_ERROR CMRregularityTest(CMR* cmr, CMR_CHRMAT* matrix, bool ternary, bool *pi
   CMR_CALL( CMRchrmatPrintDense(cmr, matrix, stdout, '0', false) );
 #endif /* CMR_DEBUG */
 
-  clock_t time = clock();
+  double time = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
   if (stats)
     stats->totalCount++;
 
+  /* The phases allocate a few arrays per row, column and nonzero on the stack, so reserve that at once. */
+  CMR_CALL( CMRreserveStack(cmr, sizeof(size_t) * (8 * (matrix->numRows + matrix->numColumns)
+    + 2 * matrix->numNonzeros)) );
+
+  /* Either continue from the checkpoint or start with the root. */
   CMR_MATROID_DEC* root = NULL;
-  CMR_CALL( CMRmatroiddecCreateMatrixRoot(cmr, &root, ternary, matrix) );
+  DecompositionQueue* queue = NULL;
+  CMR_CALL( CMRregularityQueueCreate(cmr, &queue, params->schedule) );
+  CMR_REGULAR_CHECKPOINT* checkpoint = params->checkpoint;
+  if (checkpoint && CMRregularCheckpointNumPending(checkpoint) > 0)
+  {
+    CMR_ERROR error = CMRregularityCheckpointRestore(cmr, checkpoint, matrix, ternary, &root, queue, params, stats,
+      deadline);
+    if (error)
+    {
+      CMR_CALL( CMRregularityQueueFree(cmr, &queue) );
+      return error;
+    }
+  }
+  else
+  {
+    CMR_CALL( CMRmatroiddecCreateMatrixRoot(cmr, &root, ternary, matrix) );
+    DecompositionTask* rootTask = NULL;
+    CMR_CALL( CMRregularityTaskCreateRoot(cmr, root, &rootTask, params, stats, deadline) );
+    CMRregularityQueueAdd(queue, rootTask);
+  }
   assert(root);
 
-  DecompositionQueue* queue = NULL;
-  CMR_CALL( CMRregularityQueueCreate(cmr, &queue) );
-  DecompositionTask* rootTask = NULL;
-  CMR_CALL( CMRregularityTaskCreateRoot(cmr, root, &rootTask, params, stats, time, timeLimit) );
-  CMRregularityQueueAdd(queue, rootTask);
+  CMR_ERROR error = CMRregularityQueueProcess(cmr, queue, params, stats);
 
-  while (!CMRregularityQueueEmpty(queue) && (params->completeTree || !queue->foundIrregularity))
+  /* Skipped nodes are pending again if the result depends on them or if the time limit is exceeded anyway. */
+  if (queue->skipped && !error)
+  {
+    CMR_CALL( CMRmatroiddecSetAttributes(root) );
+    if (root->regularity == 0)
+      error = CMR_ERROR_TIMEOUT;
+  }
+  if (error == CMR_ERROR_TIMEOUT)
   {
-    DecompositionTask* task = CMRregularityQueueRemove(queue);
-    CMR_CALL( CMRregularityTaskRun(cmr, task, queue) );
+    while (queue->skipped)
+    {
+      DecompositionTask* task = queue->skipped;
+      queue->skipped = task->next;
+      CMRregularityQueueAdd(queue, task);
+    }
   }
 
+  if (error == CMR_ERROR_TIMEOUT && checkpoint)
+    CMR_CALL( CMRregularityCheckpointStore(cmr, checkpoint, &root, queue) );
   CMR_CALL( CMRregularityQueueFree(cmr, &queue) );
+  if (error)
+  {
+    if (root)
+      CMR_CALL( CMRmatroiddecFree(cmr, &root) );
+    return error;
+  }
 
   CMR_CALL( CMRmatroiddecSetAttributes(root) );
   assert(root->regularity != 0);
   if (pisRegular)
     *pisRegular = root->regularity > 0;
+  if (pminor && root->regularity < 0)
+    CMR_CALL( CMRregularityExtractMinor(cmr, root, matrix, pminor) );
 
   /* Either store or free the decomposition. */
   if (pdec)
+  {
+    if (params->graphs != CMR_DEC_CONSTRUCT_ALL)
+      CMR_CALL( regularityDiscardGraphs(cmr, root, params->graphs) );
     *pdec = root;
+  }
   else
     CMR_CALL( CMRmatroiddecFree(cmr, &root) );
 
   if (stats)
-    stats->totalTime += (clock() - time) * 1.0 / CLOCKS_PER_SEC;
+    stats->totalTime += CMRclockNow() - time;
 
   return CMR_OKAY;
 }
@@ -239,7 +1186,8 @@ CMR_ERROR CMRregularityCompleteDecomposition(CMR* cmr, CMR_MATROID_DEC* dec, CMR
   CMR_CALL( CMRchrmatPrintDense(cmr, dec->matrix, stdout, '0', false) );
 #endif /* CMR_DEBUG */
 
-  clock_t time = clock();
+  double time = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
   if (stats)
     stats->totalCount++;
 
@@ -249,24 +1197,28 @@ CMR_ERROR CMRregularityCompleteDecomposition(CMR* cmr, CMR_MATROID_DEC* dec, CMR
   dec->type = CMR_MATROID_DEC_TYPE_UNKNOWN;
 
   DecompositionQueue* queue = NULL;
-  CMR_CALL( CMRregularityQueueCreate(cmr, &queue) );
+  CMR_CALL( CMRregularityQueueCreate(cmr, &queue, params->schedule) );
   DecompositionTask* decTask = NULL;
-  CMR_CALL( CMRregularityTaskCreateRoot(cmr, dec, &decTask, params, stats, time, timeLimit) );
+  CMR_CALL( CMRregularityTaskCreateRoot(cmr, dec, &decTask, params, stats, deadline) );
   CMRregularityQueueAdd(queue, decTask);
 
-  while (!CMRregularityQueueEmpty(queue) && (params->completeTree || !queue->foundIrregularity))
+  CMR_ERROR error = CMRregularityQueueProcess(cmr, queue, params, stats);
+  if (!error)
   {
-    DecompositionTask* task = CMRregularityQueueRemove(queue);
-    CMR_CALL( CMRregularityTaskRun(cmr, task, queue) );
-  }
+    error = CMRmatroiddecSetAttributes(root);
 
+    /* Skipped nodes remain unknown leaves. */
+    assert(error || root->regularity != 0 || queue->skipped);
+  }
   CMR_CALL( CMRregularityQueueFree(cmr, &queue) );
+  if (error)
+    return error;
 
-  CMR_CALL( CMRmatroiddecSetAttributes(root) );
-  assert(root->regularity != 0);
+  if (params->graphs != CMR_DEC_CONSTRUCT_ALL)
+    CMR_CALL( regularityDiscardGraphs(cmr, dec, params->graphs) );
 
   if (stats)
-    stats->totalTime += (clock() - time) * 1.0 / CLOCKS_PER_SEC;
+    stats->totalTime += CMRclockNow() - time;
 
   return CMR_OKAY;
 }
@@ -0,0 +1,793 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "env_internal.h"
+#include "io_internal.h"
+#include "regularity_internal.h"
+#include "hashtable.h"
+#include "sort.h"
+#include "threads.h"
+
+#define CACHE_REFINEMENT_ROUNDS 4 /**< Number of rounds of each color refinement of the rows and columns. */
+#define CACHE_MAX_INDIVIDUALIZATIONS 64 /**< Maximum number of rows or columns that are individualized. */
+
+/**
+ * \brief (Co)graph of a cached leaf, stored by the canonical order of the elements.
+ */
+
+typedef struct
+{
+  size_t numNodes;        /**< \brief Number of nodes. */
+  size_t* ends;           /**< \brief Array with the two end nodes of the edge of each element. */
+  bool* reversed;         /**< \brief Array indicating for each element whether its arc is reversed (may be \c NULL). */
+} CacheGraph;
+
+/**
+ * \brief Cached leaf of a decomposition.
+ */
+
+typedef struct
+{
+  uint32_t* key;              /**< \brief Array with the words of the key of the leaf. */
+  size_t keyLength;           /**< \brief Length of \ref key. */
+  CMR_MATROID_DEC_TYPE type;  /**< \brief Type of the leaf. */
+  int8_t graphicness;         /**< \brief Graphicness of the leaf. */
+  int8_t cographicness;       /**< \brief Cographicness of the leaf. */
+  CacheGraph graph;           /**< \brief Graph if \ref graphicness is positive and it was constructed. */
+  CacheGraph cograph;         /**< \brief Cograph if \ref cographicness is positive and it was constructed. */
+} CacheEntry;
+
+struct CMR_REGULAR_CACHE
+{
+  CMR_LINEARHASHTABLE_ARRAY* table; /**< \brief Hash table mapping canonical matrices to indices of \ref entries. */
+  CacheEntry* entries;              /**< \brief Array of cached leaves. */
+  size_t numEntries;                /**< \brief Number of cached leaves. */
+  size_t memEntries;                /**< \brief Memory of \ref entries. */
+  CMR_MUTEX mutex;                  /**< \brief Mutex for accesses by parallel workers. */
+};
+
+CMR_ERROR CMRregularCacheCreate(CMR* cmr, CMR_REGULAR_CACHE** pcache)
+{
+  assert(cmr);
+  assert(pcache);
+
+  CMR_CALL( CMRallocBlock(cmr, pcache) );
+  CMR_REGULAR_CACHE* cache = *pcache;
+  cache->table = NULL;
+  CMR_CALL( CMRlinearhashtableArrayCreate(cmr, &cache->table, 256, 4096) );
+  cache->numEntries = 0;
+  cache->memEntries = 16;
+  cache->entries = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &cache->entries, cache->memEntries) );
+  CMRmutexInit(&cache->mutex);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularCacheFree(CMR* cmr, CMR_REGULAR_CACHE** pcache)
+{
+  assert(cmr);
+  assert(pcache);
+
+  CMR_REGULAR_CACHE* cache = *pcache;
+  if (!cache)
+    return CMR_OKAY;
+
+  for (size_t e = 0; e < cache->numEntries; ++e)
+  {
+    CacheEntry* entry = &cache->entries[e];
+    CMR_CALL( CMRfreeBlockArray(cmr, &entry->key) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &entry->graph.ends) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &entry->graph.reversed) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &entry->cograph.ends) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &entry->cograph.reversed) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &cache->entries) );
+  CMR_CALL( CMRlinearhashtableArrayFree(cmr, &cache->table) );
+  CMRmutexFree(&cache->mutex);
+  CMR_CALL( CMRfreeBlock(cmr, pcache) );
+
+  return CMR_OKAY;
+}
+
+size_t CMRregularCacheNumEntries(CMR_REGULAR_CACHE* cache)
+{
+  assert(cache);
+
+  return cache->numEntries;
+}
+
+/**
+ * \brief Mixes the bits of \p x such that sums of mixed values are good multiset hashes.
+ */
+
+static inline
+uint64_t cacheMix(
+  uint64_t x  /**< Value to be mixed. */
+)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+ * \brief Color of a row or column together with its index.
+ */
+
+typedef struct
+{
+  uint64_t color; /**< \brief Color after refinement. */
+  size_t index;   /**< \brief Row or column index. */
+} CacheColoredIndex;
+
+#define CACHE_COLORED_LESS(a, b) ((a).color < (b).color || ((a).color == (b).color && (a).index < (b).index))
+
+CMR_SORT_DEFINE(sortCacheColoredIndices, CacheColoredIndex, CACHE_COLORED_LESS)
+
+#define CACHE_WORD_LESS(a, b) ((a) < (b))
+
+CMR_SORT_DEFINE(sortCacheWords, uint32_t, CACHE_WORD_LESS)
+
+/**
+ * \brief Refines the colors of the rows and columns by summing mixed colors of their neighbors in the signed
+ *        bipartite graph of \p matrix.
+ */
+
+static
+void cacheRefine(
+  CMR_CHRMAT* matrix,     /**< Matrix. */
+  uint64_t* rowColors,    /**< Array with the colors of the rows, followed by space for as many new ones. */
+  uint64_t* columnColors  /**< Array with the colors of the columns, followed by space for as many new ones. */
+)
+{
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+  uint64_t* newRowColors = &rowColors[numRows];
+  uint64_t* newColumnColors = &columnColors[numColumns];
+  for (size_t round = 0; round < CACHE_REFINEMENT_ROUNDS; ++round)
+  {
+    for (size_t row = 0; row < numRows; ++row)
+      newRowColors[row] = 0;
+    for (size_t column = 0; column < numColumns; ++column)
+      newColumnColors[column] = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+      {
+        size_t column = matrix->entryColumns[e];
+        uint64_t sign = matrix->entryValues[e] < 0 ? 1 : 0;
+        newRowColors[row] += cacheMix(2 * columnColors[column] + sign);
+        newColumnColors[column] += cacheMix(2 * rowColors[row] + sign);
+      }
+    }
+    for (size_t row = 0; row < numRows; ++row)
+      rowColors[row] = cacheMix(rowColors[row] ^ cacheMix(newRowColors[row]));
+    for (size_t column = 0; column < numColumns; ++column)
+      columnColors[column] = cacheMix(columnColors[column] ^ cacheMix(newColumnColors[column]));
+  }
+}
+
+/**
+ * \brief Sorts the rows or columns by their colors, where ties are broken by the indices.
+ *
+ * \returns The first row or column of the color class with the smallest color among those with at least two members,
+ *          or \c SIZE_MAX if all colors are distinct.
+ */
+
+static
+size_t cacheOrder(
+  uint64_t* colors,           /**< Array with the colors of the rows or columns. */
+  size_t length,              /**< Number of rows or columns. */
+  CacheColoredIndex* colored, /**< Array of length \p length for sorting. */
+  size_t* order               /**< Array for storing the row or column at each canonical position. */
+)
+{
+  for (size_t i = 0; i < length; ++i)
+  {
+    colored[i].color = colors[i];
+    colored[i].index = i;
+  }
+  sortCacheColoredIndices(colored, length);
+  size_t tied = SIZE_MAX;
+  for (size_t i = 0; i < length; ++i)
+  {
+    order[i] = colored[i].index;
+    if (tied == SIZE_MAX && i + 1 < length && colored[i].color == colored[i + 1].color)
+      tied = colored[i].index;
+  }
+  return tied;
+}
+
+CMR_ERROR CMRregularityCacheKeyCreate(CMR* cmr, CMR_MATROID_DEC* dec, bool planarityCheck, RegularityCacheKey* key)
+{
+  assert(cmr);
+  assert(dec);
+  assert(key);
+
+  CMR_CHRMAT* matrix = dec->matrix;
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+
+  uint64_t* rowColors = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowColors, 2 * numRows) );
+  uint64_t* columnColors = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnColors, 2 * numColumns) );
+  CacheColoredIndex* colored = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &colored, numRows > numColumns ? numRows : numColumns) );
+  key->rowsOrder = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &key->rowsOrder, numRows) );
+  key->columnsOrder = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &key->columnsOrder, numColumns) );
+
+  for (size_t row = 0; row < numRows; ++row)
+    rowColors[row] = 0;
+  for (size_t column = 0; column < numColumns; ++column)
+    columnColors[column] = 1;
+  cacheRefine(matrix, rowColors, columnColors);
+
+  /* Color refinement does not distinguish elements of the same orbit of an automorphism. For such an orbit, the
+   * choice of its element that is individualized does not matter. Remaining ties are broken by the indices. */
+  for (size_t individualization = 0; ; ++individualization)
+  {
+    size_t tiedRow = cacheOrder(rowColors, numRows, colored, key->rowsOrder);
+    size_t tiedColumn = cacheOrder(columnColors, numColumns, colored, key->columnsOrder);
+    if ((tiedRow == SIZE_MAX && tiedColumn == SIZE_MAX) || individualization == CACHE_MAX_INDIVIDUALIZATIONS)
+      break;
+
+    if (tiedRow != SIZE_MAX)
+      rowColors[tiedRow] = cacheMix(rowColors[tiedRow] + 1);
+    else
+      columnColors[tiedColumn] = cacheMix(columnColors[tiedColumn] + 1);
+    cacheRefine(matrix, rowColors, columnColors);
+  }
+
+  size_t* columnsPosition = (size_t*) colored;
+  assert(sizeof(CacheColoredIndex) >= sizeof(size_t));
+  for (size_t i = 0; i < numColumns; ++i)
+    columnsPosition[key->columnsOrder[i]] = i;
+
+  /* The key lists the row lengths and the entries of the permuted matrix row by row. */
+  key->length = 3 + numRows + matrix->numNonzeros;
+  key->words = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &key->words, key->length) );
+  key->words[0] = (uint32_t) numRows;
+  key->words[1] = (uint32_t) numColumns;
+  key->words[2] = (dec->isTernary ? 1 : 0) | (planarityCheck ? 2 : 0);
+  size_t k = 3;
+  for (size_t i = 0; i < numRows; ++i)
+  {
+    size_t row = key->rowsOrder[i];
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    key->words[k++] = (uint32_t) (beyond - first);
+    uint32_t* rowWords = &key->words[k];
+    for (size_t e = first; e < beyond; ++e)
+    {
+      key->words[k++] = (uint32_t) (2 * columnsPosition[matrix->entryColumns[e]]
+        + (matrix->entryValues[e] < 0 ? 1 : 0));
+    }
+    sortCacheWords(rowWords, beyond - first);
+  }
+  assert(k == key->length);
+
+  CMR_CALL( CMRfreeStackArray(cmr, &colored) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnColors) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowColors) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularityCacheKeyFree(CMR* cmr, RegularityCacheKey* key)
+{
+  assert(cmr);
+  assert(key);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &key->words) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &key->columnsOrder) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &key->rowsOrder) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Stores a (co)graph of a decomposition node by the canonical order of its elements.
+ *
+ * The edges of the rows are in \p rowEdges and those of the columns in \p columnEdges.
+ */
+
+static
+CMR_ERROR cacheStoreGraph(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  RegularityCacheKey* key,      /**< Key of the node. */
+  CMR_GRAPH* graph,             /**< (Co)graph. */
+  CMR_GRAPH_EDGE* rowEdges,     /**< Array with the edge of each row. */
+  CMR_GRAPH_EDGE* columnEdges,  /**< Array with the edge of each column. */
+  bool* arcsReversed,           /**< Array indicating whether an arc is reversed (may be \c NULL). */
+  CacheGraph* cached            /**< Pointer for storing the graph. */
+)
+{
+  size_t numRows = key->words[0];
+  size_t numColumns = key->words[1];
+  size_t numElements = numRows + numColumns;
+
+  cached->ends = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &cached->ends, 2 * numElements) );
+  cached->reversed = NULL;
+  if (arcsReversed)
+    CMR_CALL( CMRallocBlockArray(cmr, &cached->reversed, numElements) );
+
+  size_t* nodeIndices = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &nodeIndices, CMRgraphMemNodes(graph)) );
+  for (size_t v = 0; v < CMRgraphMemNodes(graph); ++v)
+    nodeIndices[v] = SIZE_MAX;
+  size_t numNodes = 0;
+  for (size_t i = 0; i < numElements; ++i)
+  {
+    CMR_GRAPH_EDGE edge = i < numRows ? rowEdges[key->rowsOrder[i]] : columnEdges[key->columnsOrder[i - numRows]];
+    CMR_GRAPH_NODE ends[2] = { CMRgraphEdgeU(graph, edge), CMRgraphEdgeV(graph, edge) };
+    for (int j = 0; j < 2; ++j)
+    {
+      if (nodeIndices[ends[j]] == SIZE_MAX)
+        nodeIndices[ends[j]] = numNodes++;
+      cached->ends[2 * i + j] = nodeIndices[ends[j]];
+    }
+    if (arcsReversed)
+      cached->reversed[i] = arcsReversed[edge];
+  }
+  assert(numNodes <= CMRgraphNumNodes(graph));
+  cached->numNodes = CMRgraphNumNodes(graph);
+
+  CMR_CALL( CMRfreeStackArray(cmr, &nodeIndices) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Constructs a (co)graph of a decomposition node from a cached one.
+ */
+
+static
+CMR_ERROR cacheRestoreGraph(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  RegularityCacheKey* key,        /**< Key of the node. */
+  CacheGraph* cached,             /**< Cached graph. */
+  CMR_GRAPH** pgraph,             /**< Pointer for storing the (co)graph. */
+  CMR_GRAPH_EDGE** prowEdges,     /**< Pointer for storing the array with the edge of each row. */
+  CMR_GRAPH_EDGE** pcolumnEdges,  /**< Pointer for storing the array with the edge of each column. */
+  bool** parcsReversed            /**< Pointer for storing the array indicating reversed arcs (may be \c NULL). */
+)
+{
+  size_t numRows = key->words[0];
+  size_t numColumns = key->words[1];
+  size_t numElements = numRows + numColumns;
+
+  CMR_CALL( CMRgraphCreateEmpty(cmr, pgraph, (int) cached->numNodes, (int) numElements) );
+  CMR_GRAPH* graph = *pgraph;
+  CMR_GRAPH_NODE* nodes = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &nodes, cached->numNodes) );
+  for (size_t v = 0; v < cached->numNodes; ++v)
+    CMR_CALL( CMRgraphAddNode(cmr, graph, &nodes[v]) );
+
+  CMR_CALL( CMRallocBlockArray(cmr, prowEdges, numRows) );
+  CMR_CALL( CMRallocBlockArray(cmr, pcolumnEdges, numColumns) );
+  for (size_t i = 0; i < numElements; ++i)
+  {
+    CMR_GRAPH_EDGE edge;
+    CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[cached->ends[2 * i]], nodes[cached->ends[2 * i + 1]], &edge) );
+    if (i < numRows)
+      (*prowEdges)[key->rowsOrder[i]] = edge;
+    else
+      (*pcolumnEdges)[key->columnsOrder[i - numRows]] = edge;
+  }
+
+  if (cached->reversed && parcsReversed)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, parcsReversed, CMRgraphMemEdges(graph)) );
+    for (size_t i = 0; i < numElements; ++i)
+    {
+      CMR_GRAPH_EDGE edge = i < numRows ? (*prowEdges)[key->rowsOrder[i]]
+        : (*pcolumnEdges)[key->columnsOrder[i - numRows]];
+      (*parcsReversed)[edge] = cached->reversed[i];
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &nodes) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Makes sure that \p cache has memory for another entry.
+ */
+
+static
+CMR_ERROR cacheEnsureEntryMemory(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE* cache  /**< Cache. */
+)
+{
+  if (cache->numEntries == cache->memEntries)
+  {
+    cache->memEntries *= 2;
+    CMR_CALL( CMRreallocBlockArray(cmr, &cache->entries, cache->memEntries) );
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Looks up \p dec in \p cache, whose mutex must be locked.
+ */
+
+static
+CMR_ERROR cacheLookupLocked(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE* cache, /**< Cache. */
+  CMR_MATROID_DEC* dec,     /**< Decomposition node. */
+  RegularityCacheKey* key,  /**< Key of \p dec. */
+  bool restoreGraphs,       /**< Whether to construct the stored (co)graphs. */
+  bool* pfound              /**< Pointer for storing whether \p dec was found. */
+)
+{
+  CMR_LINEARHASHTABLE_BUCKET bucket;
+  CMR_LINEARHASHTABLE_HASH hash;
+  *pfound = CMRlinearhashtableArrayFind(cache->table, key->words, key->length * sizeof(uint32_t), &bucket, &hash);
+  if (!*pfound)
+    return CMR_OKAY;
+
+  CacheEntry* entry = &cache->entries[(size_t) CMRlinearhashtableArrayValue(cache->table, bucket)];
+
+  CMRdbgMsg(6, "Found %zux%zu matrix of type %d in the cache.\n", dec->matrix->numRows, dec->matrix->numColumns,
+    entry->type);
+
+  dec->type = entry->type;
+  dec->graphicness = entry->graphicness;
+  dec->cographicness = entry->cographicness;
+  dec->testedR10 = true;
+  dec->testedSeriesParallel = true;
+  if (restoreGraphs && entry->graph.ends)
+  {
+    CMR_CALL( cacheRestoreGraph(cmr, key, &entry->graph, &dec->graph, &dec->graphForest, &dec->graphCoforest,
+      &dec->graphArcsReversed) );
+  }
+  if (restoreGraphs && entry->cograph.ends)
+  {
+    CMR_CALL( cacheRestoreGraph(cmr, key, &entry->cograph, &dec->cograph, &dec->cographCoforest,
+      &dec->cographForest, &dec->cographArcsReversed) );
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularityCacheLookup(CMR* cmr, CMR_REGULAR_CACHE* cache, CMR_MATROID_DEC* dec, RegularityCacheKey* key,
+  bool restoreGraphs, bool* pfound)
+{
+  assert(cmr);
+  assert(cache);
+  assert(dec);
+  assert(key);
+  assert(pfound);
+
+  /* Errors must not leave the mutex locked since other workers would wait forever. */
+  CMRmutexLock(&cache->mutex);
+  CMR_ERROR error = cacheLookupLocked(cmr, cache, dec, key, restoreGraphs, pfound);
+  CMRmutexUnlock(&cache->mutex);
+
+  return error;
+}
+
+/**
+ * \brief Inserts \p dec into \p cache, whose mutex must be locked.
+ *
+ * On failure, the cache is unchanged.
+ */
+
+static
+CMR_ERROR cacheInsertLocked(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE* cache, /**< Cache. */
+  CMR_MATROID_DEC* dec,     /**< Decomposition node. */
+  RegularityCacheKey* key   /**< Key of \p dec. */
+)
+{
+  /* Another worker may have inserted the same matrix in the meantime. */
+  CMR_LINEARHASHTABLE_BUCKET bucket;
+  CMR_LINEARHASHTABLE_HASH hash;
+  if (CMRlinearhashtableArrayFind(cache->table, key->words, key->length * sizeof(uint32_t), &bucket, &hash))
+    return CMR_OKAY;
+
+  CMR_CALL( cacheEnsureEntryMemory(cmr, cache) );
+  CacheEntry* entry = &cache->entries[cache->numEntries];
+  entry->key = NULL;
+  entry->keyLength = key->length;
+  entry->type = dec->type;
+  entry->graphicness = dec->graphicness;
+  entry->cographicness = dec->cographicness;
+  entry->graph.ends = NULL;
+  entry->graph.reversed = NULL;
+  entry->cograph.ends = NULL;
+  entry->cograph.reversed = NULL;
+
+  CMR_ERROR error = CMRduplicateBlockArray(cmr, &entry->key, key->length, key->words);
+
+  /* Graphs that do not consist of exactly the elements of the matrix cannot be restored. */
+  size_t numElements = dec->matrix->numRows + dec->matrix->numColumns;
+  if (!error && dec->graph && dec->graphForest && dec->graphCoforest && CMRgraphNumEdges(dec->graph) == numElements)
+  {
+    error = cacheStoreGraph(cmr, key, dec->graph, dec->graphForest, dec->graphCoforest, dec->graphArcsReversed,
+      &entry->graph);
+  }
+  if (!error && dec->cograph && dec->cographForest && dec->cographCoforest
+    && CMRgraphNumEdges(dec->cograph) == numElements)
+  {
+    error = cacheStoreGraph(cmr, key, dec->cograph, dec->cographCoforest, dec->cographForest,
+      dec->cographArcsReversed, &entry->cograph);
+  }
+  if (!error)
+  {
+    error = CMRlinearhashtableArrayInsertBucketHash(cmr, cache->table, key->words, key->length * sizeof(uint32_t),
+      bucket, hash, (const void*) cache->numEntries);
+  }
+
+  if (error)
+  {
+    CMRfreeBlockArray(cmr, &entry->key);
+    CMRfreeBlockArray(cmr, &entry->graph.ends);
+    CMRfreeBlockArray(cmr, &entry->graph.reversed);
+    CMRfreeBlockArray(cmr, &entry->cograph.ends);
+    CMRfreeBlockArray(cmr, &entry->cograph.reversed);
+    return error;
+  }
+
+  cache->numEntries++;
+
+  CMRdbgMsg(6, "Inserted %zux%zu matrix of type %d into the cache.\n", dec->matrix->numRows,
+    dec->matrix->numColumns, dec->type);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularityCacheInsert(CMR* cmr, CMR_REGULAR_CACHE* cache, CMR_MATROID_DEC* dec, RegularityCacheKey* key)
+{
+  assert(cmr);
+  assert(cache);
+  assert(dec);
+  assert(key);
+
+  CMRmutexLock(&cache->mutex);
+  CMR_ERROR error = cacheInsertLocked(cmr, cache, dec, key);
+  CMRmutexUnlock(&cache->mutex);
+
+  return error;
+}
+
+static const char CACHE_MAGIC[8] = { 'C', 'M', 'R', '-', 'L', 'E', 'A', 'F' };
+#define CACHE_VERSION 1 /**< Version of the file format of caches. */
+
+/**
+ * \brief Writes a cached (co)graph to \p stream.
+ */
+
+static
+void cacheWriteGraph(
+  FILE* stream,       /**< File stream to write to. */
+  CacheGraph* graph,  /**< Cached graph. */
+  size_t numElements  /**< Number of rows plus number of columns. */
+)
+{
+  CMRwriteLittleEndian(stream, 1, (graph->ends ? 1 : 0) | (graph->reversed ? 2 : 0));
+  if (!graph->ends)
+    return;
+
+  CMRwriteLittleEndian(stream, 8, graph->numNodes);
+  for (size_t i = 0; i < 2 * numElements; ++i)
+    CMRwriteLittleEndian(stream, 8, graph->ends[i]);
+  if (graph->reversed)
+  {
+    for (size_t i = 0; i < numElements; ++i)
+      CMRwriteLittleEndian(stream, 1, graph->reversed[i] ? 1 : 0);
+  }
+}
+
+CMR_ERROR CMRregularCacheWrite(CMR* cmr, CMR_REGULAR_CACHE* cache, FILE* stream)
+{
+  CMR_UNUSED(cmr);
+  assert(cmr);
+  assert(cache);
+  assert(stream);
+
+  CMRmutexLock(&cache->mutex);
+
+  fwrite(CACHE_MAGIC, 1, sizeof(CACHE_MAGIC), stream);
+  CMRwriteLittleEndian(stream, 4, CACHE_VERSION);
+  CMRwriteLittleEndian(stream, 8, cache->numEntries);
+  for (size_t e = 0; e < cache->numEntries; ++e)
+  {
+    CacheEntry* entry = &cache->entries[e];
+    CMRwriteLittleEndian(stream, 8, entry->keyLength);
+    for (size_t k = 0; k < entry->keyLength; ++k)
+      CMRwriteLittleEndian(stream, 4, entry->key[k]);
+    CMRwriteLittleEndian(stream, 4, (uint32_t) (int32_t) entry->type);
+    CMRwriteLittleEndian(stream, 1, (uint8_t) entry->graphicness);
+    CMRwriteLittleEndian(stream, 1, (uint8_t) entry->cographicness);
+    size_t numElements = (size_t) entry->key[0] + entry->key[1];
+    cacheWriteGraph(stream, &entry->graph, numElements);
+    cacheWriteGraph(stream, &entry->cograph, numElements);
+  }
+
+  CMRmutexUnlock(&cache->mutex);
+
+  if (ferror(stream))
+    return CMR_ERROR_OUTPUT;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns whether \p key has the structure of a key created by \ref CMRregularityCacheKeyCreate.
+ */
+
+static
+bool cacheKeyValid(
+  uint32_t* key,  /**< Array with the words of the key. */
+  size_t length   /**< Length of \p key. */
+)
+{
+  size_t k = 3;
+  for (size_t row = 0; row < key[0]; ++row)
+  {
+    if (k >= length || key[k] > length - k - 1)
+      return false;
+    size_t beyond = k + 1 + key[k];
+    for (++k; k < beyond; ++k)
+    {
+      if (key[k] / 2 >= key[1])
+        return false;
+    }
+  }
+  return k == length && key[2] <= 3;
+}
+
+/**
+ * \brief Reads a cached (co)graph from \p stream.
+ *
+ * \returns \c false if the data is invalid.
+ */
+
+static
+bool cacheReadGraph(
+  CMR* cmr,           /**< \ref CMR environment. */
+  FILE* stream,       /**< File stream to read from. */
+  CacheGraph* graph,  /**< Pointer for storing the cached graph. */
+  size_t numElements  /**< Number of rows plus number of columns. */
+)
+{
+  uint64_t flags, value;
+  if (!CMRreadLittleEndian(stream, 1, &flags) || flags > 3 || flags == 2)
+    return false;
+  if (!flags)
+    return true;
+
+  if (!CMRreadLittleEndian(stream, 8, &value) || value > 2 * numElements)
+    return false;
+  graph->numNodes = value;
+  if (CMRallocBlockArray(cmr, &graph->ends, 2 * numElements) != CMR_OKAY)
+    return false;
+  for (size_t i = 0; i < 2 * numElements; ++i)
+  {
+    if (!CMRreadLittleEndian(stream, 8, &value) || value >= graph->numNodes)
+      return false;
+    graph->ends[i] = value;
+  }
+  if (flags & 2)
+  {
+    if (CMRallocBlockArray(cmr, &graph->reversed, numElements) != CMR_OKAY)
+      return false;
+    for (size_t i = 0; i < numElements; ++i)
+    {
+      if (!CMRreadLittleEndian(stream, 1, &value) || value > 1)
+        return false;
+      graph->reversed[i] = value;
+    }
+  }
+
+  return true;
+}
+
+CMR_ERROR CMRregularCacheRead(CMR* cmr, CMR_REGULAR_CACHE* cache, FILE* stream)
+{
+  assert(cmr);
+  assert(cache);
+  assert(stream);
+
+  char magic[sizeof(CACHE_MAGIC)];
+  uint64_t version, numEntries;
+  if (fread(magic, 1, sizeof(magic), stream) != sizeof(magic) || memcmp(magic, CACHE_MAGIC, sizeof(magic))
+    || !CMRreadLittleEndian(stream, 4, &version) || !CMRreadLittleEndian(stream, 8, &numEntries))
+  {
+    CMRraiseErrorMessage(cmr, "Stream does not start with the header of a regularity cache.");
+    return CMR_ERROR_INPUT;
+  }
+  if (version != CACHE_VERSION)
+  {
+    CMRraiseErrorMessage(cmr, "Regularity cache has unsupported version %lu.", (unsigned long) version);
+    return CMR_ERROR_INPUT;
+  }
+
+  CMRmutexLock(&cache->mutex);
+
+  CMR_ERROR error = CMR_OKAY;
+  for (uint64_t e = 0; e < numEntries && !error; ++e)
+  {
+    CacheEntry entry;
+    entry.key = NULL;
+    entry.graph.ends = NULL;
+    entry.graph.reversed = NULL;
+    entry.cograph.ends = NULL;
+    entry.cograph.reversed = NULL;
+
+    uint64_t keyLength = 0, type, graphicness, cographicness;
+    bool valid = CMRreadLittleEndian(stream, 8, &keyLength) && keyLength >= 3 && keyLength <= SIZE_MAX / 8
+      && CMRallocBlockArray(cmr, &entry.key, keyLength) == CMR_OKAY;
+    entry.keyLength = keyLength;
+    for (size_t k = 0; valid && k < keyLength; ++k)
+    {
+      uint64_t word = 0;
+      valid = CMRreadLittleEndian(stream, 4, &word);
+      entry.key[k] = (uint32_t) word;
+    }
+    valid = valid && CMRreadLittleEndian(stream, 4, &type) && CMRreadLittleEndian(stream, 1, &graphicness)
+      && CMRreadLittleEndian(stream, 1, &cographicness);
+    if (valid)
+    {
+      entry.type = (CMR_MATROID_DEC_TYPE) (int32_t) (uint32_t) type;
+      entry.graphicness = (int8_t) (uint8_t) graphicness;
+      entry.cographicness = (int8_t) (uint8_t) cographicness;
+      valid = (entry.type == CMR_MATROID_DEC_TYPE_GRAPH || entry.type == CMR_MATROID_DEC_TYPE_COGRAPH
+        || entry.type == CMR_MATROID_DEC_TYPE_PLANAR || entry.type == CMR_MATROID_DEC_TYPE_R10)
+        && cacheKeyValid(entry.key, entry.keyLength);
+    }
+    size_t numElements = valid ? (size_t) entry.key[0] + entry.key[1] : 0;
+    valid = valid && cacheReadGraph(cmr, stream, &entry.graph, numElements)
+      && cacheReadGraph(cmr, stream, &entry.cograph, numElements);
+
+    CMR_LINEARHASHTABLE_BUCKET bucket;
+    CMR_LINEARHASHTABLE_HASH hash;
+    if (!valid)
+    {
+      CMRraiseErrorMessage(cmr, "Entry %lu of regularity cache is invalid.", (unsigned long) (e + 1));
+      error = CMR_ERROR_INPUT;
+    }
+    else if (!CMRlinearhashtableArrayFind(cache->table, entry.key, entry.keyLength * sizeof(uint32_t), &bucket,
+      &hash))
+    {
+      error = cacheEnsureEntryMemory(cmr, cache);
+      if (!error)
+      {
+        error = CMRlinearhashtableArrayInsertBucketHash(cmr, cache->table, entry.key,
+          entry.keyLength * sizeof(uint32_t), bucket, hash, (const void*) cache->numEntries);
+      }
+      if (!error)
+      {
+        cache->entries[cache->numEntries++] = entry;
+        continue;
+      }
+    }
+
+    CMRfreeBlockArray(cmr, &entry.key);
+    CMRfreeBlockArray(cmr, &entry.graph.ends);
+    CMRfreeBlockArray(cmr, &entry.graph.reversed);
+    CMRfreeBlockArray(cmr, &entry.cograph.ends);
+    CMRfreeBlockArray(cmr, &entry.cograph.reversed);
+  }
+
+  CMRmutexUnlock(&cache->mutex);
+
+  return error;
+}
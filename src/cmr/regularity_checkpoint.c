@@ -0,0 +1,331 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include "env_internal.h"
+#include "io_internal.h"
+#include "regularity_internal.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct CMR_REGULAR_CHECKPOINT
+{
+  CMR_MATROID_DEC* root;      /**< \brief Root of the partial decomposition tree, or \c NULL if empty. */
+  CMR_MATROID_DEC** pending;  /**< \brief Nodes of the unprocessed tasks, starting with the next one to process. */
+  size_t numPending;          /**< \brief Length of \ref pending. */
+  bool foundIrregularity;     /**< \brief Whether irregularity was detected for some node. */
+};
+
+/**
+ * \brief Magic bytes at the beginning of each checkpoint file.
+ */
+
+static const char CHECKPOINT_MAGIC[8] = { 'C', 'M', 'R', '-', 'C', 'K', 'P', 'T' };
+#define CHECKPOINT_VERSION 1            /**< Version of the file format of checkpoints. */
+#define CHECKPOINT_FLAG_IRREGULARITY 1  /**< Flag indicating that irregularity was detected. */
+
+/**
+ * \brief Empties a checkpoint.
+ */
+
+static
+CMR_ERROR checkpointClear(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  CMR_REGULAR_CHECKPOINT* checkpoint  /**< Checkpoint. */
+)
+{
+  if (checkpoint->root)
+    CMR_CALL( CMRmatroiddecFree(cmr, &checkpoint->root) );
+  if (checkpoint->pending)
+    CMR_CALL( CMRfreeBlockArray(cmr, &checkpoint->pending) );
+  checkpoint->numPending = 0;
+  checkpoint->foundIrregularity = false;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularCheckpointCreate(CMR* cmr, CMR_REGULAR_CHECKPOINT** pcheckpoint)
+{
+  assert(cmr);
+  assert(pcheckpoint);
+
+  CMR_CALL( CMRallocBlock(cmr, pcheckpoint) );
+  CMR_REGULAR_CHECKPOINT* checkpoint = *pcheckpoint;
+  checkpoint->root = NULL;
+  checkpoint->pending = NULL;
+  checkpoint->numPending = 0;
+  checkpoint->foundIrregularity = false;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularCheckpointFree(CMR* cmr, CMR_REGULAR_CHECKPOINT** pcheckpoint)
+{
+  assert(cmr);
+  assert(pcheckpoint);
+
+  if (!*pcheckpoint)
+    return CMR_OKAY;
+
+  CMR_CALL( checkpointClear(cmr, *pcheckpoint) );
+  CMR_CALL( CMRfreeBlock(cmr, pcheckpoint) );
+
+  return CMR_OKAY;
+}
+
+size_t CMRregularCheckpointNumPending(CMR_REGULAR_CHECKPOINT* checkpoint)
+{
+  assert(checkpoint);
+
+  return checkpoint->numPending;
+}
+
+CMR_ERROR CMRregularityCheckpointStore(CMR* cmr, CMR_REGULAR_CHECKPOINT* checkpoint, CMR_MATROID_DEC** proot,
+  DecompositionQueue* queue)
+{
+  assert(cmr);
+  assert(checkpoint);
+  assert(!checkpoint->root);
+  assert(proot);
+  assert(*proot);
+  assert(queue);
+
+  CMR_CALL( CMRallocBlockArray(cmr, &checkpoint->pending, queue->numTasks > 0 ? queue->numTasks : 1) );
+  checkpoint->numPending = 0;
+  while (!CMRregularityQueueEmpty(queue))
+  {
+    DecompositionTask* task = CMRregularityQueueRemove(queue);
+    checkpoint->pending[checkpoint->numPending++] = task->dec;
+    CMR_CALL( CMRregularityTaskFree(cmr, &task) );
+  }
+  checkpoint->foundIrregularity = queue->foundIrregularity;
+  checkpoint->root = *proot;
+  *proot = NULL;
+
+  CMRdbgMsg(0, "Stored checkpoint with %zu pending nodes.\n", checkpoint->numPending);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularityCheckpointRestore(CMR* cmr, CMR_REGULAR_CHECKPOINT* checkpoint, CMR_CHRMAT* matrix,
+  bool ternary, CMR_MATROID_DEC** proot, DecompositionQueue* queue, CMR_REGULAR_PARAMS* params,
+  CMR_REGULAR_STATS* stats, CMR_DEADLINE deadline)
+{
+  assert(cmr);
+  assert(checkpoint);
+  assert(checkpoint->root);
+  assert(matrix);
+  assert(proot);
+  assert(queue);
+
+  if (checkpoint->root->isTernary != ternary || !CMRchrmatCheckEqual(checkpoint->root->matrix, matrix))
+  {
+    CMRraiseErrorMessage(cmr, "Checkpoint of regularity test belongs to a different matrix.");
+    return CMR_ERROR_INPUT;
+  }
+
+  CMRdbgMsg(0, "Restoring checkpoint with %zu pending nodes.\n", checkpoint->numPending);
+
+  /* The queue is a stack, so we add the tasks in reverse order. */
+  for (size_t p = checkpoint->numPending; p > 0; --p)
+  {
+    DecompositionTask* task = NULL;
+    CMR_CALL( CMRregularityTaskCreateRoot(cmr, checkpoint->pending[p - 1], &task, params, stats, deadline) );
+    CMRregularityQueueAdd(queue, task);
+  }
+  queue->foundIrregularity = checkpoint->foundIrregularity;
+  *proot = checkpoint->root;
+  checkpoint->root = NULL;
+  CMR_CALL( CMRfreeBlockArray(cmr, &checkpoint->pending) );
+  checkpoint->numPending = 0;
+  checkpoint->foundIrregularity = false;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Stores the nodes of the tree rooted at \p dec in preorder, starting at \p *pnumNodes.
+ */
+
+static
+CMR_ERROR checkpointCollectNodes(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec,       /**< Decomposition node. */
+  CMR_MATROID_DEC*** pnodes,  /**< Pointer to the array of nodes, which is enlarged as necessary. */
+  size_t* pmemNodes,          /**< Pointer to the memory of \p *pnodes. */
+  size_t* pnumNodes           /**< Pointer to the number of stored nodes. */
+)
+{
+  if (*pnumNodes == *pmemNodes)
+  {
+    *pmemNodes = 2 * *pmemNodes + 16;
+    CMR_CALL( CMRreallocBlockArray(cmr, pnodes, *pmemNodes) );
+  }
+  (*pnodes)[(*pnumNodes)++] = dec;
+
+  for (size_t c = 0; c < dec->numChildren; ++c)
+    CMR_CALL( checkpointCollectNodes(cmr, dec->children[c], pnodes, pmemNodes, pnumNodes) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Node of a decomposition tree together with its preorder index.
+ */
+
+typedef struct
+{
+  CMR_MATROID_DEC* dec; /**< \brief Decomposition node. */
+  size_t index;         /**< \brief Preorder index of \ref dec. */
+} CheckpointNode;
+
+/**
+ * \brief Compares two nodes by their addresses.
+ */
+
+static
+int compareCheckpointNodes(
+  const void* a,  /**< First node. */
+  const void* b   /**< Second node. */
+)
+{
+  uintptr_t first = (uintptr_t) ((const CheckpointNode*) a)->dec;
+  uintptr_t second = (uintptr_t) ((const CheckpointNode*) b)->dec;
+  return first < second ? -1 : (first > second ? 1 : 0);
+}
+
+CMR_ERROR CMRregularCheckpointWrite(CMR* cmr, CMR_REGULAR_CHECKPOINT* checkpoint, FILE* stream)
+{
+  assert(cmr);
+  assert(checkpoint);
+  assert(checkpoint->root);
+  assert(stream);
+
+  /* Pending nodes are identified by their preorder indices, which we find by binary search on the addresses. */
+  CMR_MATROID_DEC** nodes = NULL;
+  size_t memNodes = 0;
+  size_t numNodes = 0;
+  CMR_CALL( checkpointCollectNodes(cmr, checkpoint->root, &nodes, &memNodes, &numNodes) );
+  CheckpointNode* sortedNodes = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &sortedNodes, numNodes) );
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    sortedNodes[i].dec = nodes[i];
+    sortedNodes[i].index = i;
+  }
+  qsort(sortedNodes, numNodes, sizeof(CheckpointNode), compareCheckpointNodes);
+
+  fwrite(CHECKPOINT_MAGIC, 1, sizeof(CHECKPOINT_MAGIC), stream);
+  CMRwriteLittleEndian(stream, 4, CHECKPOINT_VERSION);
+  CMRwriteLittleEndian(stream, 4, checkpoint->foundIrregularity ? CHECKPOINT_FLAG_IRREGULARITY : 0);
+  CMRwriteLittleEndian(stream, 8, checkpoint->numPending);
+  for (size_t p = 0; p < checkpoint->numPending; ++p)
+  {
+    CheckpointNode key = { checkpoint->pending[p], 0 };
+    CheckpointNode* found = bsearch(&key, sortedNodes, numNodes, sizeof(CheckpointNode), compareCheckpointNodes);
+    assert(found);
+    CMRwriteLittleEndian(stream, 8, found->index);
+  }
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &sortedNodes) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &nodes) );
+
+  CMR_CALL( CMRmatroiddecPrintBinary(cmr, checkpoint->root, stream) );
+  if (ferror(stream))
+  {
+    CMRraiseErrorMessage(cmr, "Could not write checkpoint of regularity test.");
+    return CMR_ERROR_OUTPUT;
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularCheckpointRead(CMR* cmr, CMR_REGULAR_CHECKPOINT* checkpoint, FILE* stream)
+{
+  assert(cmr);
+  assert(checkpoint);
+  assert(stream);
+
+  CMR_CALL( checkpointClear(cmr, checkpoint) );
+
+  char magic[sizeof(CHECKPOINT_MAGIC)];
+  uint64_t version, flags, numPending;
+  if (fread(magic, 1, sizeof(magic), stream) != sizeof(magic) || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic))
+    || !CMRreadLittleEndian(stream, 4, &version) || !CMRreadLittleEndian(stream, 4, &flags)
+    || !CMRreadLittleEndian(stream, 8, &numPending))
+  {
+    CMRraiseErrorMessage(cmr, "Stream does not start with the header of a checkpoint of a regularity test.");
+    return CMR_ERROR_INPUT;
+  }
+  if (version != CHECKPOINT_VERSION)
+  {
+    CMRraiseErrorMessage(cmr, "Checkpoint of regularity test has unsupported version %lu.", (unsigned long) version);
+    return CMR_ERROR_INPUT;
+  }
+  if (numPending == 0 || numPending > SIZE_MAX / 16)
+  {
+    CMRraiseErrorMessage(cmr, "Checkpoint of regularity test has an invalid number of pending nodes.");
+    return CMR_ERROR_INPUT;
+  }
+
+  /* The indices are validated once the tree is known. The array grows while reading to not trust the count. */
+  size_t* indices = NULL;
+  size_t memIndices = 0;
+  CMR_ERROR error = CMR_OKAY;
+  for (size_t p = 0; p < numPending; ++p)
+  {
+    uint64_t index;
+    if (!CMRreadLittleEndian(stream, 8, &index))
+    {
+      CMRraiseErrorMessage(cmr, "Checkpoint of regularity test ended prematurely.");
+      error = CMR_ERROR_INPUT;
+      break;
+    }
+    if (p == memIndices)
+    {
+      memIndices = 2 * memIndices + 16;
+      CMR_CALL( CMRreallocBlockArray(cmr, &indices, memIndices) );
+    }
+    indices[p] = index < SIZE_MAX ? (size_t) index : SIZE_MAX;
+  }
+
+  if (!error)
+    error = CMRmatroiddecCreateFromBinaryStream(cmr, stream, &checkpoint->root);
+
+  CMR_MATROID_DEC** nodes = NULL;
+  size_t memNodes = 0;
+  size_t numNodes = 0;
+  bool* isPending = NULL;
+  if (!error)
+  {
+    CMR_CALL( checkpointCollectNodes(cmr, checkpoint->root, &nodes, &memNodes, &numNodes) );
+    CMR_CALL( CMRallocBlockArray(cmr, &isPending, numNodes) );
+    for (size_t i = 0; i < numNodes; ++i)
+      isPending[i] = false;
+    CMR_CALL( CMRallocBlockArray(cmr, &checkpoint->pending, numPending) );
+    for (size_t p = 0; p < numPending; ++p)
+    {
+      if (indices[p] >= numNodes || isPending[indices[p]] || !nodes[indices[p]]->matrix)
+      {
+        CMRraiseErrorMessage(cmr, "Checkpoint of regularity test has an invalid pending node.");
+        error = CMR_ERROR_INPUT;
+        break;
+      }
+      isPending[indices[p]] = true;
+      checkpoint->pending[p] = nodes[indices[p]];
+    }
+    checkpoint->numPending = (size_t) numPending;
+    checkpoint->foundIrregularity = flags & CHECKPOINT_FLAG_IRREGULARITY;
+  }
+
+  if (isPending)
+    CMR_CALL( CMRfreeBlockArray(cmr, &isPending) );
+  if (nodes)
+    CMR_CALL( CMRfreeBlockArray(cmr, &nodes) );
+  if (indices)
+    CMR_CALL( CMRfreeBlockArray(cmr, &indices) );
+  if (error)
+    CMR_CALL( checkpointClear(cmr, checkpoint) );
+
+  return error;
+}
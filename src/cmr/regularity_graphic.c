@@ -9,7 +9,6 @@
 #include "hashtable.h"
 
 #include <stdint.h>
-#include <time.h>
 
 /**
  * \brief Recursive DFS for finding all articulation points of a graph.
@@ -1254,7 +1253,8 @@ CMR_ERROR CMRregularSequenceGraphic(CMR* cmr, CMR_CHRMAT* matrix, CMR_CHRMAT* tr
 
   CMRdbgMsg(8, "Testing sequence for (co)graphicness.\n");
 
-  clock_t time = clock();
+  double time = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
 
   CMR_CALL( CMRgraphCreateEmpty(cmr, pgraph, matrix->numRows, matrix->numRows + matrix->numColumns) );
   CMR_GRAPH* graph = *pgraph;
@@ -1287,7 +1287,7 @@ CMR_ERROR CMRregularSequenceGraphic(CMR* cmr, CMR_CHRMAT* matrix, CMR_CHRMAT* tr
   size_t extensionTimeFactor = lengthSequence / 100 + 1;
   for (size_t extension = 1; extension < lengthSequence; ++extension)
   { 
-    if ((extension % extensionTimeFactor == 0) && (clock() - time) * 1.0 / CLOCKS_PER_SEC > timeLimit)
+    if ((extension % extensionTimeFactor == 0) && CMRdeadlinePassed(&deadline))
     {
       CMR_CALL( CMRfreeStackArray(cmr, &columnHashValues) );
       CMR_CALL( CMRfreeStackArray(cmr, &rowHashValues) );
@@ -1404,7 +1404,7 @@ CMR_ERROR CMRregularSequenceGraphic(CMR* cmr, CMR_CHRMAT* matrix, CMR_CHRMAT* tr
   if (stats)
   {
     stats->sequenceGraphicCount++;
-    stats->sequenceGraphicTime += (clock() - time) * 1.0 / CLOCKS_PER_SEC;
+    stats->sequenceGraphicTime += CMRclockNow() - time;
   }
 
   CMR_CALL( CMRfreeStackArray(cmr, &columnHashValues) );
@@ -1417,51 +1417,132 @@ CMR_ERROR CMRregularSequenceGraphic(CMR* cmr, CMR_CHRMAT* matrix, CMR_CHRMAT* tr
 }
 
 /**
- * \brief Tests each minor of the sequence of nested 3-connected minors for graphicness.
+ * \brief Graph that is grown along a sequence of nested 3-connected minors.
+ */
+
+typedef struct
+{
+  CMR_GRAPH* graph;             /**< \brief Graph of the last minor that was processed. */
+  CMR_GRAPH_EDGE* rowEdges;     /**< \brief Array mapping rows to edges. */
+  CMR_GRAPH_EDGE* columnEdges;  /**< \brief Array mapping columns to edges. */
+  bool active;                  /**< \brief Whether all minors processed so far are graphic. */
+  size_t lastGraphicMinor;      /**< \brief Last minor that is known to be graphic. */
+} SequenceGraph;
+
+/**
+ * \brief Extends a \ref SequenceGraph by the new rows and columns of the next minor of the sequence.
+ *
+ * For a cographicness test, \p matrix is the transpose of the sequence's matrix and vice versa.
+ */
+
+static
+CMR_ERROR sequenceGraphExtend(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  SequenceGraph* sgraph,    /**< Graph to extend. */
+  CMR_CHRMAT* matrix,       /**< Matrix that displays the nested minor sequences. */
+  CMR_CHRMAT* transpose,    /**< Transpose of \p matrix. */
+  size_t numRows,           /**< Number of rows of the previous minor. */
+  size_t numColumns,        /**< Number of columns of the previous minor. */
+  size_t newRows,           /**< Number of new rows. */
+  size_t newColumns,        /**< Number of new columns. */
+  CMR_ELEMENT* parallels    /**< Elements parallel to the new rows and columns, if there are two new ones. */
+)
+{
+  assert(cmr);
+  assert(sgraph);
+  assert(sgraph->active);
+
+  bool isGraphic;
+  if (newRows == 1 && newColumns == 1)
+  {
+    CMR_CALL( addToGraph1Row1Column(cmr, sgraph->graph, sgraph->rowEdges, sgraph->columnEdges, numRows, numColumns,
+      parallels[0], parallels[1], &isGraphic) );
+  }
+  else if (newRows == 2 && newColumns == 1)
+  {
+    CMR_CALL( addToGraph2Rows1Column(cmr, sgraph->graph, sgraph->rowEdges, sgraph->columnEdges, numRows, numColumns,
+      parallels[0], parallels[1], &isGraphic) );
+  }
+  else if (newRows == 1 && newColumns == 2)
+  {
+    CMR_CALL( addToGraph1Row2Columns(cmr, sgraph->graph, sgraph->rowEdges, sgraph->columnEdges, numRows, numColumns,
+      parallels[0], parallels[1], &isGraphic) );
+  }
+  else if (newRows == 0 && newColumns == 1)
+  {
+    size_t first = transpose->rowSlice[numColumns];
+    size_t beyond = transpose->rowSlice[numColumns + 1];
+    for (size_t e = first; e < beyond; ++e)
+    {
+      if (transpose->entryColumns[e] >= numRows)
+        beyond = e;
+    }
+    CMR_CALL( addToGraph1Column(cmr, sgraph->graph, sgraph->rowEdges, sgraph->columnEdges, numColumns,
+      &transpose->entryColumns[first], beyond-first, &isGraphic) );
+  }
+  else
+  {
+    assert(newRows == 1 && newColumns == 0);
+
+    size_t first = matrix->rowSlice[numRows];
+    size_t beyond = matrix->rowSlice[numRows + 1];
+    for (size_t e = first; e < beyond; ++e)
+    {
+      if (matrix->entryColumns[e] >= numColumns)
+        beyond = e;
+    }
+    CMR_CALL( addToGraph1Row(cmr, sgraph->graph, sgraph->rowEdges, sgraph->columnEdges, numRows,
+      &matrix->entryColumns[first], beyond-first, &isGraphic) );
+  }
+
+  sgraph->active = isGraphic;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Tests the minors of the sequence of nested 3-connected minors for graphicness and for cographicness in one
+ *        traversal.
+ *
+ * Both graphs are grown in lockstep such that the parallel elements of each extension are computed once, and the
+ * traversal stops as soon as neither graph can be extended. A graph is only returned if all minors are
+ * (co)graphic.
  */
 
 static
 CMR_ERROR sequenceGraphicness(
-  CMR* cmr,                     /**< \ref CMR environment. */
-  DecompositionTask* task,      /**< Task to be processed; already removed from the list of unprocessed tasks. */
-  CMR_CHRMAT* matrix,           /**< Matrix that displays the nested minor sequences. */
-  CMR_CHRMAT* transpose,        /**< Transpose of \p matrix. */
-  size_t length,                /**< Length of sequence of nested minors. */
-  size_t* sequenceNumRows,      /**< Number of rows of sequence of nested minors. */
-  size_t* sequenceNumColumns,   /**< Number of columns of sequence of nested minors. */
-  CMR_ELEMENT* rowsOriginal,    /**< Maps rows of \p matrix to elements of original matrix. */
-  CMR_ELEMENT* columnsOriginal, /**< Maps columns of \p matrix to elements of original matrix. */
-  bool cographicness,           /**< Whether we actually received the transpose as input. */
-  CMR_GRAPH** pgraph,           /**< Pointer for storing the constructed graph. */
-  CMR_ELEMENT** pedgeElements,  /**< Pointer for storing the mapping from edges to elements. */
-  size_t* plastGraphicMinor     /**< Pointer for storing the last graphic minor. */
+  CMR* cmr,                       /**< \ref CMR environment. */
+  DecompositionTask* task,        /**< Task to be processed; already removed from the list of unprocessed tasks. */
+  bool testGraphic,               /**< Whether to test for graphicness. */
+  bool testCographic,             /**< Whether to test for cographicness. */
+  CMR_GRAPH** pgraph,             /**< Pointer for storing the graph, if all minors are graphic. */
+  CMR_ELEMENT** pgraphElements,   /**< Pointer for storing the mapping from edges of the graph to elements. */
+  CMR_GRAPH** pcograph,           /**< Pointer for storing the cograph, if all minors are cographic. */
+  CMR_ELEMENT** pcographElements  /**< Pointer for storing the mapping from edges of the cograph to elements. */
 )
 {
   assert(cmr);
   assert(task);
-  assert(matrix);
-  assert(transpose);
-  assert(sequenceNumRows);
-  assert(sequenceNumColumns);
-  assert(rowsOriginal);
-  assert(columnsOriginal);
   assert(pgraph);
-  assert(pedgeElements);
-  assert(plastGraphicMinor);
+  assert(pgraphElements);
+  assert(pcograph);
+  assert(pcographElements);
 
-  CMRdbgMsg(6, "Testing sequence of nested minors of length %zu for %sgraphicness.\n", length,
-    cographicness ? "co" : "");
+  CMR_MATROID_DEC* dec = task->dec;
+  CMR_CHRMAT* matrix = dec->nestedMinorsMatrix;
+  CMR_CHRMAT* transpose = dec->nestedMinorsTranspose;
+  size_t length = dec->nestedMinorsLength;
+  size_t* sequenceNumRows = dec->nestedMinorsSequenceNumRows;
+  size_t* sequenceNumColumns = dec->nestedMinorsSequenceNumColumns;
 
-  CMR_CALL( CMRgraphCreateEmpty(cmr, pgraph, matrix->numRows, matrix->numRows + matrix->numColumns) );
-  CMR_GRAPH* graph = *pgraph;
+  CMRdbgMsg(6, "Testing sequence of nested minors of length %zu for %s%s%s.\n", length,
+    testGraphic ? "graphicness" : "", testGraphic && testCographic ? " and " : "", testCographic ? "cographicness" : "");
+
+  double time = CMRclockNow();
 
   long long* hashVector = NULL;
   CMR_CALL( createHashVector(cmr, &hashVector,
     matrix->numRows > matrix->numColumns ? matrix->numRows : matrix->numColumns) );
-  CMR_GRAPH_EDGE* rowEdges = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &rowEdges, matrix->numRows) );
-  CMR_GRAPH_EDGE* columnEdges = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &columnEdges, matrix->numColumns) );
   long long* rowHashValues = NULL;
   CMR_CALL( CMRallocStackArray(cmr, &rowHashValues, matrix->numRows) );
   for (size_t row = 0; row < matrix->numRows; ++row)
@@ -1471,249 +1552,305 @@ CMR_ERROR sequenceGraphicness(
   for (size_t column = 0; column < matrix->numColumns; ++column)
     columnHashValues[column] = 0;
 
-  /* Create graph for first minor. */
+  /* Create (co)graphs for first minor. */
 
   assert(sequenceNumRows[0] == sequenceNumColumns[0]);
-  CMR_CALL( createWheel(cmr, graph, matrix, transpose, sequenceNumRows[0], rowEdges, columnEdges) );
-  *plastGraphicMinor = 0;
+  SequenceGraph graph = { NULL, NULL, NULL, testGraphic, 0 };
+  SequenceGraph cograph = { NULL, NULL, NULL, testCographic, 0 };
+  CMR_CALL( CMRallocStackArray(cmr, &graph.rowEdges, matrix->numRows) );
+  CMR_CALL( CMRallocStackArray(cmr, &graph.columnEdges, matrix->numColumns) );
+  CMR_CALL( CMRallocStackArray(cmr, &cograph.rowEdges, matrix->numColumns) );
+  CMR_CALL( CMRallocStackArray(cmr, &cograph.columnEdges, matrix->numRows) );
+  if (testGraphic)
+  {
+    CMR_CALL( CMRgraphCreateEmpty(cmr, &graph.graph, matrix->numRows, matrix->numRows + matrix->numColumns) );
+    CMR_CALL( createWheel(cmr, graph.graph, matrix, transpose, sequenceNumRows[0], graph.rowEdges,
+      graph.columnEdges) );
+  }
+  if (testCographic)
+  {
+    CMR_CALL( CMRgraphCreateEmpty(cmr, &cograph.graph, matrix->numColumns, matrix->numRows + matrix->numColumns) );
+    CMR_CALL( createWheel(cmr, cograph.graph, transpose, matrix, sequenceNumColumns[0], cograph.rowEdges,
+      cograph.columnEdges) );
+  }
 
   CMR_CALL( updateHashValues(matrix, rowHashValues, columnHashValues, hashVector, 0, sequenceNumRows[0],
     sequenceNumColumns[0]) );
 
-//   size_t extensionTimeFactor = length / 100 + 1;
-  for (size_t extension = 1; extension < length; ++extension)
+  for (size_t extension = 1; extension < length && (graph.active || cograph.active); ++extension)
   {
-//     if ((extension % extensionTimeFactor == 0) && (clock() - time) * 1.0 / CLOCKS_PER_SEC > timeLimit)
-//     {
-//       CMR_CALL( CMRfreeStackArray(cmr, &columnHashValues) );
-//       CMR_CALL( CMRfreeStackArray(cmr, &rowHashValues) );
-//       CMR_CALL( CMRfreeStackArray(cmr, &columnEdges) );
-//       CMR_CALL( CMRfreeStackArray(cmr, &rowEdges) );
-//       CMR_CALL( CMRfreeStackArray(cmr, &hashVector) );
-//       return CMR_ERROR_TIMEOUT;
-//     }
-
-    size_t newRows = sequenceNumRows[extension] - sequenceNumRows[extension-1];
-    size_t newColumns = sequenceNumColumns[extension] - sequenceNumColumns[extension-1];
+    size_t numRows = sequenceNumRows[extension-1];
+    size_t numColumns = sequenceNumColumns[extension-1];
+    size_t newRows = sequenceNumRows[extension] - numRows;
+    size_t newColumns = sequenceNumColumns[extension] - numColumns;
 
     CMRdbgMsg(8, "Processing extension step %zu with %zu new rows and %zu new columns.\n", extension, newRows,
       newColumns);
 
-    bool isGraphic;
+    /* The parallel elements only depend on the matrix, so they are shared by both graphs. */
+    CMR_ELEMENT parallels[2] = { 0, 0 };
     if (newRows == 1 && newColumns == 1)
     {
-      CMR_ELEMENT rowParallel = findParallel(matrix, sequenceNumRows[extension-1], sequenceNumRows[extension-1],
-        sequenceNumColumns[extension-1], rowHashValues, hashVector);
-      CMR_ELEMENT columnParallel = CMRelementTranspose(findParallel(transpose, sequenceNumColumns[extension-1],
-        sequenceNumColumns[extension-1], sequenceNumRows[extension-1], columnHashValues, hashVector));
+      parallels[0] = findParallel(matrix, numRows, numRows, numColumns, rowHashValues, hashVector);
+      parallels[1] = CMRelementTranspose(findParallel(transpose, numColumns, numColumns, numRows, columnHashValues,
+        hashVector));
 
-      CMRdbgMsg(10, "The new row is parallel to %c%zu", CMRelementIsRow(rowParallel) ? 'x' : 'y',
-        CMRelementIsRow(rowParallel) ? CMRelementToRowIndex(rowParallel) + 1 : CMRelementToColumnIndex(rowParallel) + 1);
-      CMRdbgMsg(0, " and the new column is parallel to %c%zu.\n", CMRelementIsRow(columnParallel) ? 'x' : 'y',
-        CMRelementIsRow(columnParallel) ? CMRelementToRowIndex(columnParallel) + 1
-        : CMRelementToColumnIndex(columnParallel) + 1);
-
-      CMR_CALL( addToGraph1Row1Column(cmr, graph, rowEdges, columnEdges, sequenceNumRows[extension-1],
-        sequenceNumColumns[extension-1], rowParallel, columnParallel, &isGraphic) );
+      CMRdbgMsg(10, "The new row is parallel to %s", CMRelementString(parallels[0], 0));
+      CMRdbgMsg(0, " and the new column is parallel to %s.\n", CMRelementString(parallels[1], 0));
     }
     else if (newRows == 2 && newColumns == 1)
     {
-      CMR_ELEMENT row1Parallel = findParallel(matrix, sequenceNumRows[extension-1], sequenceNumRows[extension-1],
-        sequenceNumColumns[extension-1], rowHashValues, hashVector);
-      CMR_ELEMENT row2Parallel = findParallel(matrix, sequenceNumRows[extension-1] + 1, sequenceNumRows[extension-1],
-        sequenceNumColumns[extension-1], rowHashValues, hashVector);
-
-      CMRdbgMsg(10, "Row 1 is parallel to %s", CMRelementString(row1Parallel, 0));
-      CMRdbgMsg(0, " and row 2 is parallel to %s.\n", CMRelementString(row2Parallel, 0));
+      parallels[0] = findParallel(matrix, numRows, numRows, numColumns, rowHashValues, hashVector);
+      parallels[1] = findParallel(matrix, numRows + 1, numRows, numColumns, rowHashValues, hashVector);
 
-      CMR_CALL( addToGraph2Rows1Column(cmr, graph, rowEdges, columnEdges, sequenceNumRows[extension-1],
-        sequenceNumColumns[extension-1], row1Parallel, row2Parallel, &isGraphic) );
+      CMRdbgMsg(10, "Row 1 is parallel to %s", CMRelementString(parallels[0], 0));
+      CMRdbgMsg(0, " and row 2 is parallel to %s.\n", CMRelementString(parallels[1], 0));
     }
     else if (newRows == 1 && newColumns == 2)
     {
-      CMR_ELEMENT column1Parallel = CMRelementTranspose(findParallel(transpose, sequenceNumColumns[extension-1],
-        sequenceNumColumns[extension-1], sequenceNumRows[extension-1], columnHashValues, hashVector));
-      CMR_ELEMENT column2Parallel = CMRelementTranspose(findParallel(transpose, sequenceNumColumns[extension-1] + 1,
-        sequenceNumColumns[extension-1], sequenceNumRows[extension-1], columnHashValues, hashVector));
+      parallels[0] = CMRelementTranspose(findParallel(transpose, numColumns, numColumns, numRows, columnHashValues,
+        hashVector));
+      parallels[1] = CMRelementTranspose(findParallel(transpose, numColumns + 1, numColumns, numRows,
+        columnHashValues, hashVector));
 
-      CMRdbgMsg(10, "Column 1 is parallel to %s", CMRelementString(column1Parallel, 0));
-      CMRdbgMsg(0, " and column 2 is parallel to %s.\n", CMRelementString(column2Parallel, 0));
-
-      CMR_CALL( addToGraph1Row2Columns(cmr, graph, rowEdges, columnEdges, sequenceNumRows[extension-1],
-        sequenceNumColumns[extension-1], column1Parallel, column2Parallel, &isGraphic) );
+      CMRdbgMsg(10, "Column 1 is parallel to %s", CMRelementString(parallels[0], 0));
+      CMRdbgMsg(0, " and column 2 is parallel to %s.\n", CMRelementString(parallels[1], 0));
     }
-    else if (newRows == 0 && newColumns == 1)
+
+    if (graph.active)
     {
-      size_t first = transpose->rowSlice[sequenceNumColumns[extension-1]];
-      size_t beyond = transpose->rowSlice[sequenceNumColumns[extension-1] + 1];
-      for (size_t e = first; e < beyond; ++e)
-      {
-        if (transpose->entryColumns[e] >= sequenceNumRows[extension-1])
-          beyond = e;
-      }
-      CMR_CALL( addToGraph1Column(cmr, graph, rowEdges, columnEdges, sequenceNumColumns[extension-1],
-        &transpose->entryColumns[first], beyond-first, &isGraphic) );
+      CMR_CALL( sequenceGraphExtend(cmr, &graph, matrix, transpose, numRows, numColumns, newRows, newColumns,
+        parallels) );
+      if (graph.active)
+        graph.lastGraphicMinor = extension;
     }
-    else
+    if (cograph.active)
     {
-      assert(newRows == 1 && newColumns == 0);
-
-      size_t first = matrix->rowSlice[sequenceNumRows[extension-1]];
-      size_t beyond = matrix->rowSlice[sequenceNumRows[extension-1] + 1];
-      for (size_t e = first; e < beyond; ++e)
+      /* For one new row and column, these swap their roles. */
+      CMR_ELEMENT transposedParallels[2] = { CMRelementTranspose(parallels[0]), CMRelementTranspose(parallels[1]) };
+      if (newRows == 1 && newColumns == 1)
       {
-        if (matrix->entryColumns[e] >= sequenceNumColumns[extension-1])
-          beyond = e;
+        transposedParallels[0] = CMRelementTranspose(parallels[1]);
+        transposedParallels[1] = CMRelementTranspose(parallels[0]);
       }
-      CMR_CALL( addToGraph1Row(cmr, graph, rowEdges, columnEdges, sequenceNumRows[extension-1],
-        &matrix->entryColumns[first], beyond-first, &isGraphic) );
+      CMR_CALL( sequenceGraphExtend(cmr, &cograph, transpose, matrix, numColumns, numRows, newColumns, newRows,
+        transposedParallels) );
+      if (cograph.active)
+        cograph.lastGraphicMinor = extension;
     }
 
-    if (isGraphic)
-      *plastGraphicMinor = extension;
-    else
-      break;
-
-    CMR_CALL( updateHashValues(matrix, rowHashValues, columnHashValues, hashVector, sequenceNumRows[extension-1],
-      sequenceNumRows[extension], sequenceNumColumns[extension - 1]) );
-    CMR_CALL( updateHashValues(transpose, columnHashValues, rowHashValues, hashVector, sequenceNumColumns[extension-1],
+    CMR_CALL( updateHashValues(matrix, rowHashValues, columnHashValues, hashVector, numRows,
+      sequenceNumRows[extension], numColumns) );
+    CMR_CALL( updateHashValues(transpose, columnHashValues, rowHashValues, hashVector, numColumns,
       sequenceNumColumns[extension], sequenceNumRows[extension]) );
   }
 
-  if (*plastGraphicMinor == length - 1)
+  if (testGraphic)
   {
-    CMR_CALL( CMRallocBlockArray(cmr, pedgeElements, matrix->numRows + matrix->numColumns) );
-    CMR_ELEMENT* edgeElements = *pedgeElements;
+    dec->nestedMinorsLastGraphic = graph.lastGraphicMinor;
+    CMRdbgMsg(8, "Sequence of nested minors is graphic up to and including minor 0 <= %zu <= %zu.\n",
+      graph.lastGraphicMinor, length - 1);
+  }
+  if (testCographic)
+  {
+    dec->nestedMinorsLastCographic = cograph.lastGraphicMinor;
+    CMRdbgMsg(8, "Sequence of nested minors is cographic up to and including minor 0 <= %zu <= %zu.\n",
+      cograph.lastGraphicMinor, length - 1);
+  }
+
+  if (testGraphic && graph.lastGraphicMinor == length - 1)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, pgraphElements, matrix->numRows + matrix->numColumns) );
+    CMR_ELEMENT* edgeElements = *pgraphElements;
     for (size_t e = 0; e < matrix->numRows + matrix->numColumns; ++e)
       edgeElements[e] = 0;
-
-    if (cographicness)
-    {
-      for (size_t row = 0; row < matrix->numRows; ++row)
-        edgeElements[rowEdges[row]] = task->dec->nestedMinorsColumnsOriginal[row];
-      for (size_t column = 0; column < matrix->numColumns; ++column)
-        edgeElements[columnEdges[column]] = task->dec->nestedMinorsRowsOriginal[column];
-    }
-    else
-    {
-      for (size_t row = 0; row < matrix->numRows; ++row)
-        edgeElements[rowEdges[row]] = task->dec->nestedMinorsRowsOriginal[row];
-      for (size_t column = 0; column < matrix->numColumns; ++column)
-        edgeElements[columnEdges[column]] = task->dec->nestedMinorsColumnsOriginal[column];
-    }
+    for (size_t row = 0; row < matrix->numRows; ++row)
+      edgeElements[graph.rowEdges[row]] = dec->nestedMinorsRowsOriginal[row];
+    for (size_t column = 0; column < matrix->numColumns; ++column)
+      edgeElements[graph.columnEdges[column]] = dec->nestedMinorsColumnsOriginal[column];
+    *pgraph = graph.graph;
   }
-  else
+  else if (graph.graph)
+    CMR_CALL( CMRgraphFree(cmr, &graph.graph) );
+
+  if (testCographic && cograph.lastGraphicMinor == length - 1 && !*pgraph)
   {
-    CMR_CALL( CMRgraphFree(cmr, pgraph) );
+    CMR_CALL( CMRallocBlockArray(cmr, pcographElements, matrix->numRows + matrix->numColumns) );
+    CMR_ELEMENT* edgeElements = *pcographElements;
+    for (size_t e = 0; e < matrix->numRows + matrix->numColumns; ++e)
+      edgeElements[e] = 0;
+    for (size_t row = 0; row < matrix->numColumns; ++row)
+      edgeElements[cograph.rowEdges[row]] = dec->nestedMinorsColumnsOriginal[row];
+    for (size_t column = 0; column < matrix->numRows; ++column)
+      edgeElements[cograph.columnEdges[column]] = dec->nestedMinorsRowsOriginal[column];
+    *pcograph = cograph.graph;
   }
+  else if (cograph.graph)
+    CMR_CALL( CMRgraphFree(cmr, &cograph.graph) );
 
   if (task->stats)
   {
     task->stats->sequenceGraphicCount++;
-//     task->stats->sequenceGraphicTime += (clock() - time) * 1.0 / CLOCKS_PER_SEC;
+    task->stats->sequenceGraphicTime += CMRclockNow() - time;
   }
 
+  CMR_CALL( CMRfreeStackArray(cmr, &cograph.columnEdges) );
+  CMR_CALL( CMRfreeStackArray(cmr, &cograph.rowEdges) );
+  CMR_CALL( CMRfreeStackArray(cmr, &graph.columnEdges) );
+  CMR_CALL( CMRfreeStackArray(cmr, &graph.rowEdges) );
   CMR_CALL( CMRfreeStackArray(cmr, &columnHashValues) );
   CMR_CALL( CMRfreeStackArray(cmr, &rowHashValues) );
-  CMR_CALL( CMRfreeStackArray(cmr, &columnEdges) );
-  CMR_CALL( CMRfreeStackArray(cmr, &rowEdges) );
   CMR_CALL( CMRfreeStackArray(cmr, &hashVector) );
 
-  CMRdbgMsg(8, "Sequence of nested minors is %sgraphic up to and including minor 0 <= %zu <= %zu.\n",
-    cographicness ? "co" : "", *plastGraphicMinor, length - 1);
-
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRregularityNestedMinorSequenceGraphicness(CMR* cmr, DecompositionTask* task, DecompositionQueue* queue)
-{
-  assert(cmr);
-  assert(task);
-  assert(queue);
+/**
+ * \brief Turns the node of \p task into a graphic leaf with a graph found along the sequence of nested minors.
+ */
 
+static
+CMR_ERROR sequenceStoreGraph(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  DecompositionTask* task,    /**< Task to be processed; already removed from the list of unprocessed tasks. */
+  DecompositionQueue* queue,  /**< Queue of unprocessed nodes. */
+  CMR_GRAPH* graph,           /**< Graph of the node. */
+  CMR_ELEMENT* edgeElements   /**< Mapping from edges of \p graph to elements. */
+)
+{
   CMR_MATROID_DEC* dec = task->dec;
-  assert(dec);
 
-  CMR_GRAPH* graph = NULL;
-  CMR_ELEMENT* edgeElements = NULL;
+  dec->type = (dec->type == CMR_MATROID_DEC_TYPE_COGRAPH) ? CMR_MATROID_DEC_TYPE_PLANAR : CMR_MATROID_DEC_TYPE_GRAPH;
+  CMRdbgMsg(8, "Whole sequence is %s.\n", dec->type == CMR_MATROID_DEC_TYPE_PLANAR ? "planar" : "graphic");
+  dec->graph = graph;
+  dec->graphForest = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &dec->graphForest, dec->matrix->numRows) );
+  dec->graphCoforest = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &dec->graphCoforest, dec->matrix->numColumns) );
+  dec->graphArcsReversed = NULL;
+  if (dec->isTernary)
+    CMR_CALL( CMRallocBlockArray(cmr, &dec->graphArcsReversed, CMRgraphMemEdges(dec->graph)) );
 
-  CMR_CALL( sequenceGraphicness(cmr, task, dec->nestedMinorsMatrix, dec->nestedMinorsTranspose, dec->nestedMinorsLength,
-    dec->nestedMinorsSequenceNumRows, dec->nestedMinorsSequenceNumColumns, dec->nestedMinorsRowsOriginal,
-    dec->nestedMinorsColumnsOriginal, false, &graph, &edgeElements, &dec->nestedMinorsLastGraphic) );
+  assert(CMRgraphNumEdges(graph) == dec->matrix->numRows + dec->matrix->numColumns);
+  for (CMR_GRAPH_ITER iter = CMRgraphEdgesFirst(graph); CMRgraphEdgesValid(graph, iter);
+    iter = CMRgraphEdgesNext(graph, iter))
+  {
+    CMR_GRAPH_EDGE edge = CMRgraphEdgesEdge(graph, iter);
+    CMR_ELEMENT element = edgeElements[edge];
+    if (CMRelementIsRow(element))
+      dec->graphForest[CMRelementToRowIndex(element)] = edge;
+    else
+      dec->graphCoforest[CMRelementToColumnIndex(element)] = edge;
+  }
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &edgeElements) );
 
-  if (dec->nestedMinorsLastGraphic + 1 == dec->nestedMinorsLength)
+  if (dec->isTernary)
   {
-    dec->type = (dec->type == CMR_MATROID_DEC_TYPE_COGRAPH) ? CMR_MATROID_DEC_TYPE_PLANAR : CMR_MATROID_DEC_TYPE_GRAPH;
-    CMRdbgMsg(8, "Whole sequence is %s.\n", dec->type == CMR_MATROID_DEC_TYPE_PLANAR ? "planar" : "graphic");
-    dec->graph = graph;
-    dec->graphForest = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &dec->graphForest, dec->matrix->numRows) );
-    dec->graphCoforest = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &dec->graphCoforest, dec->matrix->numColumns) );
-    dec->graphArcsReversed = NULL;
-    if (dec->isTernary)
-      CMR_CALL( CMRallocBlockArray(cmr, &dec->graphArcsReversed, CMRgraphMemEdges(dec->graph)) );
-
-    assert(CMRgraphNumEdges(graph) == dec->matrix->numRows + dec->matrix->numColumns);
-    for (CMR_GRAPH_ITER iter = CMRgraphEdgesFirst(graph); CMRgraphEdgesValid(graph, iter);
-      iter = CMRgraphEdgesNext(graph, iter))
-    {
-      CMR_GRAPH_EDGE edge = CMRgraphEdgesEdge(graph, iter);
-      CMR_ELEMENT element = edgeElements[edge];
-      if (CMRelementIsRow(element))
-        dec->graphForest[CMRelementToRowIndex(element)] = edge;
-      else
-        dec->graphCoforest[CMRelementToColumnIndex(element)] = edge;
-    }
+    /* Check Camion signs. */
 
-    CMR_CALL( CMRfreeBlockArray(cmr, &edgeElements) );
+    if (dec->transpose == NULL)
+      CMR_CALL( CMRchrmatTranspose(cmr, dec->matrix, &dec->transpose) );
+
+    bool isCamionSigned;
+    CMR_SUBMAT* violatorSubmatrix = NULL;
+    CMR_CALL( CMRcamionCographicOrient(cmr, dec->transpose, dec->graph, dec->graphForest,
+      dec->graphCoforest, dec->graphArcsReversed, &isCamionSigned, &violatorSubmatrix,
+      task->stats ? &task->stats->camion : NULL) );
 
-    if (dec->isTernary)
+    if (violatorSubmatrix)
     {
-      /* Check Camion signs. */
+      CMR_CALL( CMRsubmatTranspose(violatorSubmatrix) );
 
-      if (dec->transpose == NULL)
-        CMR_CALL( CMRchrmatTranspose(cmr, dec->matrix, &dec->transpose) );
+      CMRdbgMsg(8, "-> %zux%zu submatrix with bad determinant.\n", violatorSubmatrix->numRows,
+        violatorSubmatrix->numColumns);
 
-      bool isCamionSigned;
-      CMR_SUBMAT* violatorSubmatrix = NULL;
-      CMR_CALL( CMRcamionCographicOrient(cmr, dec->transpose, dec->graph, dec->graphForest,
-        dec->graphCoforest, dec->graphArcsReversed, &isCamionSigned, &violatorSubmatrix,
-        task->stats ? &task->stats->camion : NULL) );
+      CMR_CALL( CMRmatroiddecUpdateSubmatrix(cmr, dec, violatorSubmatrix, CMR_MATROID_DEC_TYPE_DETERMINANT) );
+      assert(dec->type == CMR_MATROID_DEC_TYPE_SUBMATRIX || dec->type == CMR_MATROID_DEC_TYPE_DETERMINANT);
 
-      if (violatorSubmatrix)
-      {
-        CMR_CALL( CMRsubmatTranspose(violatorSubmatrix) );
+      CMR_CALL( CMRgraphFree(cmr, &dec->graph) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &dec->graphForest) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &dec->graphCoforest) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &dec->graphArcsReversed) );
+      CMR_CALL( CMRsubmatFree(cmr, &violatorSubmatrix) );
+      queue->foundIrregularity = true;
+    }
+  }
 
-        CMRdbgMsg(8, "-> %zux%zu submatrix with bad determinant.\n", violatorSubmatrix->numRows,
-          violatorSubmatrix->numColumns);
+  return CMR_OKAY;
+}
 
-        CMR_CALL( CMRmatroiddecUpdateSubmatrix(cmr, dec, violatorSubmatrix, CMR_MATROID_DEC_TYPE_DETERMINANT) );
-        assert(dec->type == CMR_MATROID_DEC_TYPE_SUBMATRIX || dec->type == CMR_MATROID_DEC_TYPE_DETERMINANT);
+/**
+ * \brief Turns the node of \p task into a cographic leaf with a cograph found along the sequence of nested minors.
+ */
 
-        CMR_CALL( CMRgraphFree(cmr, &dec->graph) );
-        CMR_CALL( CMRfreeBlockArray(cmr, &dec->graphForest) );
-        CMR_CALL( CMRfreeBlockArray(cmr, &dec->graphCoforest) );
-        CMR_CALL( CMRfreeBlockArray(cmr, &dec->graphArcsReversed) );
-        CMR_CALL( CMRsubmatFree(cmr, &violatorSubmatrix) );
-        queue->foundIrregularity = true;
-      }
-    }
+static
+CMR_ERROR sequenceStoreCograph(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  DecompositionTask* task,    /**< Task to be processed; already removed from the list of unprocessed tasks. */
+  DecompositionQueue* queue,  /**< Queue of unprocessed nodes. */
+  CMR_GRAPH* cograph,         /**< Cograph of the node. */
+  CMR_ELEMENT* edgeElements   /**< Mapping from edges of \p cograph to elements. */
+)
+{
+  CMR_MATROID_DEC* dec = task->dec;
 
-    CMR_CALL( CMRregularityTaskFree(cmr, &task) );
+  dec->type = (dec->type == CMR_MATROID_DEC_TYPE_GRAPH) ? CMR_MATROID_DEC_TYPE_PLANAR : CMR_MATROID_DEC_TYPE_COGRAPH;
+  CMRdbgMsg(8, "Whole sequence is %s.\n", dec->type == CMR_MATROID_DEC_TYPE_PLANAR ? "planar" : "cographic");
+  dec->cograph = cograph;
+  dec->cographForest = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &dec->cographForest, dec->matrix->numColumns) );
+  dec->cographCoforest = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &dec->cographCoforest, dec->matrix->numRows) );
+  dec->graphArcsReversed = NULL;
+  if (dec->isTernary)
+    CMR_CALL( CMRallocBlockArray(cmr, &dec->cographArcsReversed, CMRgraphMemEdges(dec->cograph)) );
+
+  assert(CMRgraphNumEdges(cograph) == dec->matrix->numRows + dec->matrix->numColumns);
+  for (CMR_GRAPH_ITER iter = CMRgraphEdgesFirst(cograph); CMRgraphEdgesValid(cograph, iter);
+    iter = CMRgraphEdgesNext(cograph, iter))
+  {
+    CMR_GRAPH_EDGE edge = CMRgraphEdgesEdge(cograph, iter);
+    CMR_ELEMENT element = edgeElements[edge];
+    if (CMRelementIsColumn(element))
+      dec->cographForest[CMRelementToColumnIndex(element)] = edge;
+    else
+      dec->cographCoforest[CMRelementToRowIndex(element)] = edge;
   }
-  else
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &edgeElements) );
+
+  if (dec->isTernary)
   {
-    dec->graphicness = -1;
+    /* Check Camion signs. */
 
-    /* Add task back to list of unprocessed tasks to test cographicness. */
-    CMRregularityQueueAdd(queue, task);
+    bool isCamionSigned;
+    CMR_SUBMAT* violatorSubmatrix = NULL;
+    CMR_CALL( CMRcamionCographicOrient(cmr, dec->matrix, dec->cograph, dec->cographForest,
+      dec->cographCoforest, dec->cographArcsReversed, &isCamionSigned, &violatorSubmatrix,
+      task->stats ? &task->stats->camion : NULL) );
+
+    if (violatorSubmatrix)
+    {
+      CMRdbgMsg(8, "-> %zux%zu submatrix with bad determinant.\n", violatorSubmatrix->numRows,
+        violatorSubmatrix->numColumns);
+
+      CMR_CALL( CMRmatroiddecUpdateSubmatrix(cmr, dec, violatorSubmatrix, CMR_MATROID_DEC_TYPE_DETERMINANT) );
+      assert(dec->type != CMR_MATROID_DEC_TYPE_DETERMINANT);
+
+      CMR_CALL( CMRgraphFree(cmr, &dec->cograph) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &dec->cographForest) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &dec->cographCoforest) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &dec->cographArcsReversed) );
+      CMR_CALL( CMRsubmatFree(cmr, &violatorSubmatrix) );
+      queue->foundIrregularity = true;
+    }
   }
 
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRregularityNestedMinorSequenceCographicness(CMR* cmr, DecompositionTask* task, DecompositionQueue* queue)
+CMR_ERROR CMRregularityNestedMinorSequenceGraphicness(CMR* cmr, DecompositionTask* task, DecompositionQueue* queue)
 {
   assert(cmr);
   assert(task);
@@ -1722,72 +1859,37 @@ CMR_ERROR CMRregularityNestedMinorSequenceCographicness(CMR* cmr, DecompositionT
   CMR_MATROID_DEC* dec = task->dec;
   assert(dec);
 
-  CMR_GRAPH* cograph = NULL;
-  CMR_ELEMENT* edgeElements = NULL;
+  bool testGraphic = dec->nestedMinorsLastGraphic == SIZE_MAX;
+  bool testCographic = dec->nestedMinorsLastCographic == SIZE_MAX;
+  assert(testGraphic || testCographic);
 
-  CMR_CALL( sequenceGraphicness(cmr, task, dec->nestedMinorsTranspose, dec->nestedMinorsMatrix, dec->nestedMinorsLength,
-    dec->nestedMinorsSequenceNumColumns, dec->nestedMinorsSequenceNumRows, dec->nestedMinorsColumnsOriginal,
-    dec->nestedMinorsRowsOriginal, true, &cograph, &edgeElements, &dec->nestedMinorsLastCographic) );
+  CMR_GRAPH* graph = NULL;
+  CMR_ELEMENT* graphElements = NULL;
+  CMR_GRAPH* cograph = NULL;
+  CMR_ELEMENT* cographElements = NULL;
+  CMR_CALL( sequenceGraphicness(cmr, task, testGraphic, testCographic, &graph, &graphElements, &cograph,
+    &cographElements) );
 
-  if (dec->nestedMinorsLastCographic + 1 == dec->nestedMinorsLength)
+  /* Cographicness only matters if the node is not graphic. */
+  if (graph)
   {
-    dec->type = (dec->type == CMR_MATROID_DEC_TYPE_GRAPH) ? CMR_MATROID_DEC_TYPE_PLANAR : CMR_MATROID_DEC_TYPE_COGRAPH;
-    CMRdbgMsg(8, "Whole sequence is %s.\n", dec->type == CMR_MATROID_DEC_TYPE_PLANAR ? "planar" : "cographic");
-    dec->cograph = cograph;
-    dec->cographForest = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &dec->cographForest, dec->matrix->numColumns) );
-    dec->cographCoforest = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &dec->cographCoforest, dec->matrix->numRows) );
-    dec->graphArcsReversed = NULL;
-    if (dec->isTernary)
-      CMR_CALL( CMRallocBlockArray(cmr, &dec->cographArcsReversed, CMRgraphMemEdges(dec->cograph)) );
-
-    assert(CMRgraphNumEdges(cograph) == dec->matrix->numRows + dec->matrix->numColumns);
-    for (CMR_GRAPH_ITER iter = CMRgraphEdgesFirst(cograph); CMRgraphEdgesValid(cograph, iter);
-      iter = CMRgraphEdgesNext(cograph, iter))
-    {
-      CMR_GRAPH_EDGE edge = CMRgraphEdgesEdge(cograph, iter);
-      CMR_ELEMENT element = edgeElements[edge];
-      if (CMRelementIsColumn(element))
-        dec->cographForest[CMRelementToColumnIndex(element)] = edge;
-      else
-        dec->cographCoforest[CMRelementToRowIndex(element)] = edge;
-    }
-
-    CMR_CALL( CMRfreeBlockArray(cmr, &edgeElements) );
-
-    if (dec->isTernary)
-    {
-      /* Check Camion signs. */
-
-      bool isCamionSigned;
-      CMR_SUBMAT* violatorSubmatrix = NULL;
-      CMR_CALL( CMRcamionCographicOrient(cmr, dec->matrix, dec->cograph, dec->cographForest,
-        dec->cographCoforest, dec->cographArcsReversed, &isCamionSigned, &violatorSubmatrix,
-        task->stats ? &task->stats->camion : NULL) );
-
-      if (violatorSubmatrix)
-      {
-        CMRdbgMsg(8, "-> %zux%zu submatrix with bad determinant.\n", violatorSubmatrix->numRows,
-          violatorSubmatrix->numColumns);
-
-        CMR_CALL( CMRmatroiddecUpdateSubmatrix(cmr, dec, violatorSubmatrix, CMR_MATROID_DEC_TYPE_DETERMINANT) );
-        assert(dec->type != CMR_MATROID_DEC_TYPE_DETERMINANT);
+    CMR_CALL( sequenceStoreGraph(cmr, task, queue, graph, graphElements) );
+    CMR_CALL( CMRregularityTaskFree(cmr, &task) );
+    return CMR_OKAY;
+  }
 
-        CMR_CALL( CMRgraphFree(cmr, &dec->cograph) );
-        CMR_CALL( CMRfreeBlockArray(cmr, &dec->cographForest) );
-        CMR_CALL( CMRfreeBlockArray(cmr, &dec->cographCoforest) );
-        CMR_CALL( CMRfreeBlockArray(cmr, &dec->cographArcsReversed) );
-        CMR_CALL( CMRsubmatFree(cmr, &violatorSubmatrix) );
-        queue->foundIrregularity = true;
-      }
-    }
+  if (testGraphic)
+    dec->graphicness = -1;
 
+  if (cograph)
+  {
+    CMR_CALL( sequenceStoreCograph(cmr, task, queue, cograph, cographElements) );
     CMR_CALL( CMRregularityTaskFree(cmr, &task) );
   }
   else
   {
-    dec->cographicness = -1;
+    if (testCographic)
+      dec->cographicness = -1;
 
     /* Add task back to list of unprocessed tasks to search for 3-separations. */
     CMRregularityQueueAdd(queue, task);
@@ -1796,7 +1898,6 @@ CMR_ERROR CMRregularityNestedMinorSequenceCographicness(CMR* cmr, DecompositionT
   return CMR_OKAY;
 }
 
-
 CMR_ERROR CMRregularityTestGraphicness(CMR* cmr, DecompositionTask* task, DecompositionQueue* queue)
 {
   assert(cmr);
@@ -1811,21 +1912,23 @@ CMR_ERROR CMRregularityTestGraphicness(CMR* cmr, DecompositionTask* task, Decomp
   CMR_CALL( CMRchrmatPrintDense(cmr, dec->matrix, stdout, '0', true) );
 #endif /* CMR_DEBUG */
 
-  if (!dec->transpose)
-  {
-    assert(dec->matrix);
-    CMR_CALL( CMRchrmatTranspose(cmr, dec->matrix, &dec->transpose) );
-  }
+  assert(dec->matrix);
 
-  double remainingTime = task->timeLimit - (clock() - task->startClock) * 1.0 / CLOCKS_PER_SEC;
+  /* Graphs are only constructed if they are kept in the decomposition tree. */
+  bool keepGraphs = task->params->graphs != CMR_DEC_CONSTRUCT_NONE;
+  double remainingTime = CMRdeadlineRemaining(&task->stepDeadline);
   bool isGraphic;
   if (dec->isTernary)
   {
     CMR_SUBMAT* violatorSubmatrix = NULL;
     bool supportGraphic;
 
-    CMR_CALL( CMRnetworkTestTranspose(cmr, dec->transpose, &isGraphic, &supportGraphic, &dec->graph, &dec->graphForest,
-      &dec->graphCoforest, &dec->graphArcsReversed, &violatorSubmatrix, task->stats ? &task->stats->network : NULL,
+    if (!dec->transpose)
+      CMR_CALL( CMRchrmatTranspose(cmr, dec->matrix, &dec->transpose) );
+
+    CMR_CALL( CMRnetworkTestTranspose(cmr, dec->transpose, &isGraphic, &supportGraphic,
+      keepGraphs ? &dec->graph : NULL, keepGraphs ? &dec->graphForest : NULL, keepGraphs ? &dec->graphCoforest : NULL,
+      keepGraphs ? &dec->graphArcsReversed : NULL, &violatorSubmatrix, task->stats ? &task->stats->network : NULL,
       remainingTime) );
 
     if (violatorSubmatrix)
@@ -1851,8 +1954,12 @@ CMR_ERROR CMRregularityTestGraphicness(CMR* cmr, DecompositionTask* task, Decomp
   }
   else
   {
-    CMR_CALL( CMRgraphicTestTranspose(cmr, dec->transpose, &isGraphic, &dec->graph, &dec->graphForest,
-      &dec->graphCoforest, NULL, task->stats ? &task->stats->graphic : NULL, remainingTime) );
+    /* The graphicness test only needs a transient column view, so we avoid storing the transpose. Without the
+     * planarity check, most nodes that reach this test are expected not to be graphic. */
+    CMR_CALL( CMRgraphicTestMatrixOrdered(cmr, dec->matrix,
+      task->params->planarityCheck ? CMR_GRAPHIC_ORDER_INPUT : CMR_GRAPHIC_ORDER_REJECT, &isGraphic,
+      keepGraphs ? &dec->graph : NULL, keepGraphs ? &dec->graphForest : NULL, keepGraphs ? &dec->graphCoforest : NULL,
+      NULL, task->stats ? &task->stats->graphic : NULL, remainingTime) );
   }
 
   CMRdbgMsg(8, "-> %s%s\n", isGraphic ? "" : "NOT ", dec->isTernary ? "network" : "graphic");
@@ -1896,15 +2003,17 @@ CMR_ERROR CMRregularityTestCographicness(CMR* cmr, DecompositionTask* task, Deco
     CMR_CALL( CMRchrmatTranspose(cmr, dec->transpose, &dec->matrix) );
   }
 
-  double remainingTime = task->timeLimit - (clock() - task->startClock) * 1.0 / CLOCKS_PER_SEC;
+  bool keepGraphs = task->params->graphs != CMR_DEC_CONSTRUCT_NONE;
+  double remainingTime = CMRdeadlineRemaining(&task->stepDeadline);
   bool isCographic;
   if (dec->isTernary)
   {
     CMR_SUBMAT* violatorSubmatrix = NULL;
     bool supportCographic;
 
-    CMR_CALL( CMRnetworkTestTranspose(cmr, dec->matrix, &isCographic, &supportCographic, &dec->cograph,
-      &dec->cographForest, &dec->cographCoforest, &dec->cographArcsReversed, &violatorSubmatrix,
+    CMR_CALL( CMRnetworkTestTranspose(cmr, dec->matrix, &isCographic, &supportCographic,
+      keepGraphs ? &dec->cograph : NULL, keepGraphs ? &dec->cographForest : NULL,
+      keepGraphs ? &dec->cographCoforest : NULL, keepGraphs ? &dec->cographArcsReversed : NULL, &violatorSubmatrix,
       task->stats ? &task->stats->network : NULL, remainingTime) );
 
     if (violatorSubmatrix)
@@ -1928,8 +2037,10 @@ CMR_ERROR CMRregularityTestCographicness(CMR* cmr, DecompositionTask* task, Deco
   }
   else
   {
-    CMR_CALL( CMRgraphicTestTranspose(cmr, dec->matrix, &isCographic, &dec->cograph, &dec->cographForest,
-      &dec->cographCoforest, NULL, task->stats ? &task->stats->graphic : NULL, remainingTime) );
+    CMR_CALL( CMRgraphicTestTransposeOrdered(cmr, dec->matrix,
+      task->params->planarityCheck ? CMR_GRAPHIC_ORDER_INPUT : CMR_GRAPHIC_ORDER_REJECT, &isCographic,
+      keepGraphs ? &dec->cograph : NULL, keepGraphs ? &dec->cographForest : NULL,
+      keepGraphs ? &dec->cographCoforest : NULL, NULL, task->stats ? &task->stats->graphic : NULL, remainingTime) );
   }
 
   CMRdbgMsg(8, "-> %s%s\n", isCographic ? "" : "NOT ", dec->isTernary ? "conetwork" : "cographic");
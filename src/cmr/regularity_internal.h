@@ -1,11 +1,10 @@
 #ifndef CMR_REGULAR_INTERNAL_H
 #define CMR_REGULAR_INTERNAL_H
 
-#include <time.h>
-
 #include <cmr/regular.h>
 
 #include "matroid_internal.h"
+#include "deadline.h"
 
 typedef struct DecompositionTask
 {
@@ -13,8 +12,12 @@ typedef struct DecompositionTask
   struct DecompositionTask* next; /**< \brief Next task in queue. */
   CMR_REGULAR_PARAMS* params;     /**< \brief Parameters for the computation. */
   CMR_REGULAR_STATS* stats;       /**< \brief Statistics for the computation (may be \c NULL). */
-  clock_t startClock;             /**< \brief Clock for the start time. */
-  double timeLimit;               /**< \brief Time limit to impose. */
+  CMR_DEADLINE deadline;          /**< \brief Deadline of the computation. */
+  CMR_DEADLINE stepDeadline;      /**< \brief Deadline of the current processing step, i.e., \ref deadline
+                                   **         shortened by \ref CMR_REGULAR_PARAMS::nodeTimeLimit. */
+  double priority;                /**< \brief Key of the task in the queue; smaller keys are processed first. */
+  size_t sequenceKey;             /**< \brief Index of the task's position in the sequential order in the
+                                   **         deterministic parallel processing, or \c SIZE_MAX. */
 } DecompositionTask;
 
 /**
@@ -27,8 +30,7 @@ CMR_ERROR CMRregularityTaskCreateRoot(
   DecompositionTask** ptask,      /**< Pointer for storing the new task. */
   CMR_REGULAR_PARAMS* params,     /**< Parameters for the computation. */
   CMR_REGULAR_STATS* stats,       /**< Statistics for the computation (may be \c NULL). */
-  clock_t startClock,             /**< Clock for the start time. */
-  double timeLimit                /**< Time limit to impose. */
+  CMR_DEADLINE deadline           /**< Deadline of the computation. */
 );
 
 /**
@@ -43,7 +45,10 @@ CMR_ERROR CMRregularityTaskFree(
 typedef struct DecompositionQueue
 {
   DecompositionTask* head;  /**< \brief Next task to be processed. */
+  size_t numTasks;          /**< \brief Number of tasks in the queue. */
   bool foundIrregularity;   /**< \brief Whether irregularity was detected for some node. */
+  CMR_REGULAR_SCHEDULE schedule; /**< \brief Order in which the tasks are removed. */
+  DecompositionTask* skipped; /**< \brief List of tasks whose node exceeded \ref CMR_REGULAR_PARAMS::nodeTimeLimit. */
 } DecompositionQueue;
 
 /**
@@ -51,8 +56,9 @@ typedef struct DecompositionQueue
  */
 
 CMR_ERROR CMRregularityQueueCreate(
-  CMR* cmr,                   /**< \ref CMR environment. */
-  DecompositionQueue** pqueue /**< Pointer for storing the queue. */
+  CMR* cmr,                       /**< \ref CMR environment. */
+  DecompositionQueue** pqueue,    /**< Pointer for storing the queue. */
+  CMR_REGULAR_SCHEDULE schedule   /**< Order in which the tasks are removed. */
 );
 
 /**
@@ -81,6 +87,18 @@ DecompositionTask* CMRregularityQueueRemove(
 );
 
 
+/**
+ * \brief Inserts \p task into the list starting at \p *phead, which is sorted according to \p schedule.
+ *
+ * Among tasks with equal priorities, the new one comes first.
+ */
+
+void CMRregularityQueueInsert(
+  DecompositionTask** phead,    /**< Pointer to the first task of the list. */
+  DecompositionTask* task,      /**< Task. */
+  CMR_REGULAR_SCHEDULE schedule /**< Order of the list. */
+);
+
 /**
  * \brief Adds a task to a decomposition queue.
  */
@@ -90,6 +108,117 @@ void CMRregularityQueueAdd(
   DecompositionTask* task     /**< Task. */
 );
 
+/**
+ * \brief Key of a decomposition node in a \ref CMR_REGULAR_CACHE.
+ *
+ * The rows and columns of the node's matrix are ordered by colors obtained from color refinement on its signed
+ * bipartite graph, where tied rows or columns are individualized one after another and remaining ties are broken by
+ * the indices. The key consists of the dimensions, a word with
+ * flags, and the sorted entries of all rows of the permuted matrix, each preceded by the row's length.
+ * Hence, row and column permutations of a matrix usually, but not always, yield the same key, and equal keys
+ * certify that the matrices agree up to the permutations.
+ */
+
+typedef struct
+{
+  uint32_t* words;      /**< \brief Array with the words of the key. */
+  size_t length;        /**< \brief Length of \ref words. */
+  size_t* rowsOrder;    /**< \brief Array with the row at each position of the canonical order. */
+  size_t* columnsOrder; /**< \brief Array with the column at each position of the canonical order. */
+} RegularityCacheKey;
+
+/**
+ * \brief Computes the cache key of a decomposition node.
+ */
+
+CMR_ERROR CMRregularityCacheKeyCreate(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec,     /**< Decomposition node. */
+  bool planarityCheck,      /**< Whether the computation checks for planarity; entries are not shared otherwise. */
+  RegularityCacheKey* key   /**< Pointer for storing the key. */
+);
+
+/**
+ * \brief Frees the arrays of a cache key.
+ */
+
+CMR_ERROR CMRregularityCacheKeyFree(
+  CMR* cmr,               /**< \ref CMR environment. */
+  RegularityCacheKey* key /**< Key. */
+);
+
+/**
+ * \brief Looks up a decomposition node in the cache and, if found, turns it into the cached leaf.
+ *
+ * Besides the type, it sets the (co)graphicness and, if requested, constructs the (co)graphs if these were stored.
+ */
+
+CMR_ERROR CMRregularityCacheLookup(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE* cache, /**< Cache. */
+  CMR_MATROID_DEC* dec,     /**< Decomposition node without children whose type is not determined, yet. */
+  RegularityCacheKey* key,  /**< Key of \p dec. */
+  bool restoreGraphs,       /**< Whether to construct the stored (co)graphs. */
+  bool* pfound              /**< Pointer for storing whether \p dec was found. */
+);
+
+/**
+ * \brief Inserts a regular leaf of a decomposition into the cache unless its key is already present.
+ */
+
+CMR_ERROR CMRregularityCacheInsert(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_REGULAR_CACHE* cache, /**< Cache. */
+  CMR_MATROID_DEC* dec,     /**< Decomposition leaf. */
+  RegularityCacheKey* key   /**< Key of \p dec. */
+);
+
+/**
+ * \brief Processes the tasks of a decomposition queue until it is empty or irregularity was detected.
+ *
+ * If the environment allows more than one thread, the tasks are processed in parallel by a pool of workers that
+ * steal tasks from each other. Processing stops as soon as irregularity is detected unless
+ * \p params->completeTree is \c true. Unprocessed tasks remain in \p queue.
+ */
+
+CMR_ERROR CMRregularityQueueProcess(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  DecompositionQueue* queue,  /**< Queue of unprocessed tasks. */
+  CMR_REGULAR_PARAMS* params, /**< Parameters for the computation. */
+  CMR_REGULAR_STATS* stats    /**< Statistics for the computation (may be \c NULL). */
+);
+
+/**
+ * \brief Moves the decomposition tree and the nodes of the unprocessed tasks of \p queue into an empty checkpoint.
+ *
+ * The tasks are freed and \p *proot is set to \c NULL.
+ */
+
+CMR_ERROR CMRregularityCheckpointStore(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  CMR_REGULAR_CHECKPOINT* checkpoint, /**< Empty checkpoint. */
+  CMR_MATROID_DEC** proot,            /**< Pointer to the root of the decomposition tree. */
+  DecompositionQueue* queue           /**< Queue of unprocessed tasks. */
+);
+
+/**
+ * \brief Moves the state of a non-empty checkpoint into \p queue and \p *proot, which leaves the checkpoint empty.
+ *
+ * Returns \ref CMR_ERROR_INPUT if the checkpoint belongs to a different matrix.
+ */
+
+CMR_ERROR CMRregularityCheckpointRestore(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  CMR_REGULAR_CHECKPOINT* checkpoint, /**< Non-empty checkpoint. */
+  CMR_CHRMAT* matrix,                 /**< Matrix to be tested. */
+  bool ternary,                       /**< Whether the matrix is tested for total unimodularity. */
+  CMR_MATROID_DEC** proot,            /**< Pointer for storing the root of the decomposition tree. */
+  DecompositionQueue* queue,          /**< Queue to add the tasks of the pending nodes to. */
+  CMR_REGULAR_PARAMS* params,         /**< Parameters for the computation. */
+  CMR_REGULAR_STATS* stats,           /**< Statistics for the computation (may be \c NULL). */
+  CMR_DEADLINE deadline               /**< Deadline of the computation. */
+);
+
 /**
  * \brief Applies a 3-sum decomposition.
  */
@@ -114,9 +243,11 @@ CMRregularityNestedMinorSequenceSearchThreeSeparation(
 );
 
 /**
- * \brief Tests each minor of the sequence of nested 3-connected minors for graphicness.
+ * \brief Tests each minor of the sequence of nested 3-connected minors for graphicness and cographicness in one
+ *        traversal.
  *
- * Sets \c task->dec->CMRregularityNestedMinorSequenceGraphicness accordingly.
+ * Only the properties for which \c task->dec->nestedMinorsLastGraphic (resp. \c nestedMinorsLastCographic) is
+ * \c SIZE_MAX are tested, and these members are set accordingly.
  */
 
 CMR_ERROR
@@ -126,19 +257,6 @@ CMRregularityNestedMinorSequenceGraphicness(
   DecompositionQueue* queue /**< Queue of unprocessed nodes. */
 );
 
-/**
- * \brief Tests each minor of the sequence of nested 3-connected minors for graphicness.
- *
- * Sets \c task->dec->CMRregularityNestedMinorSequenceCographicness accordingly.
- */
-
-CMR_ERROR
-CMRregularityNestedMinorSequenceCographicness(
-  CMR* cmr,                 /**< \ref CMR environment. */
-  DecompositionTask* task,  /**< Task to be processed; already removed from the list of unprocessed tasks. */
-  DecompositionQueue* queue /**< Queue of unprocessed nodes. */
-);
-
 /**
  * \brief Extends an incomplete sequence of nested 3-connected minors for the matrix of a decomposition node.
  *
@@ -223,6 +341,50 @@ CMR_ERROR CMRregularitySearchOneSum(
   DecompositionQueue* queue /**< Queue of unprocessed nodes. */
 );
 
+/**
+ * \brief Searches the minor with index \p minorIndex of the sequence of nested minors of \p dec for an \f$ F_7 \f$ or
+ *        \f$ F_7^\star \f$ minor.
+ *
+ * Only binary nested minors with few elements are searched. If such a minor is found, then it is stored in
+ * \p dec as a minor of its matrix.
+ */
+
+CMR_ERROR CMRregularityNestedMinorSequenceFindFano(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec, /**< Irregular decomposition node with a sequence of nested minors. */
+  size_t minorIndex     /**< Index of a minor in the sequence that is neither graphic nor cographic. */
+);
+
+/**
+ * \brief Maps an \f$ F_7 \f$ or \f$ F_7^\star \f$ minor of an irregular node of the decomposition tree to \p matrix.
+ *
+ * The rows and columns of the nodes along the path from \p root to that node are mapped to elements of \p matrix.
+ * Elements that are removed along the path are contracted (rows) or deleted (columns), and the pivots of the minor
+ * are replayed on \p matrix. Only if the resulting submatrix indeed represents \f$ F_7 \f$ or \f$ F_7^\star \f$,
+ * then \p *pminor is set.
+ */
+
+CMR_ERROR CMRregularityExtractMinor(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* root,/**< Root of the decomposition tree. */
+  CMR_CHRMAT* matrix,   /**< Matrix of \p root. */
+  CMR_MINOR** pminor    /**< Pointer for storing the minor; remains unchanged if none is found. */
+);
+
+/**
+ * \brief Searches for a 2-separation of \p task's matrix at a cut vertex of its bipartite support graph.
+ *
+ * Such a 2-separation has a single row or column that contains the nonzeros of its off-diagonal blocks. The search
+ * takes linear time. If a 2-separation is found, then the node becomes a \ref CMR_MATROID_DEC_TYPE_TWO_SUM node whose
+ * two children are added to \p queue. Otherwise, the task is added to \p queue again.
+ */
+
+CMR_ERROR CMRregularitySearchTwoSum(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  DecompositionTask* task,  /**< Task to be processed; already removed from the list of unprocessed tasks. */
+  DecompositionQueue* queue /**< Queue of unprocessed nodes. */
+);
+
 /**
  * \brief Tests ternary or binary linear matroid for regularity.
  *
@@ -0,0 +1,630 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include "env_internal.h"
+#include "regularity_internal.h"
+#include "matroid_internal.h"
+
+#include <stdint.h>
+
+/**
+ * \brief Maximum number of elements of a nested minor that is searched for an \f$ F_7 \f$ or \f$ F_7^\star \f$ minor.
+ *
+ * Then there are at most \f$ \binom{12}{6} = 924 \f$ bases to consider.
+ */
+
+#define FANO_SEARCH_MAX_ELEMENTS 12
+
+/**
+ * \brief Binary representation of a matroid with at most \ref FANO_SEARCH_MAX_ELEMENTS elements.
+ */
+
+typedef struct
+{
+  uint16_t rows[FANO_SEARCH_MAX_ELEMENTS];          /**< \brief Bitmask of the nonzero columns of each row. */
+  uint8_t rowsElement[FANO_SEARCH_MAX_ELEMENTS];    /**< \brief Element of each row. */
+  uint8_t columnsElement[FANO_SEARCH_MAX_ELEMENTS]; /**< \brief Element of each column. */
+} SmallRepresentation;
+
+/**
+ * \brief Searches for 3 lines and 4 other lines that induce the representation of \f$ F_7 \f$.
+ *
+ * Each line is a bitmask of the other lines. The chosen 4 other lines must restrict to the 4 vectors in
+ * \f$ \mathbb{F}_2^3 \f$ with at least 2 ones. If the lines are rows, this is \f$ F_7 \f$, and if they are columns,
+ * it is \f$ F_7^\star \f$.
+ */
+
+static
+bool findFanoLines(
+  const uint16_t* lines,  /**< Array with the bitmask of each line. */
+  size_t numLines,        /**< Number of lines. */
+  size_t numOthers,       /**< Number of other lines. */
+  size_t* fanoLines,      /**< Array for storing the 3 lines. */
+  size_t* fanoOthers      /**< Array for storing the 4 other lines. */
+)
+{
+  assert(lines);
+
+  for (size_t a = 0; a < numLines; ++a)
+  {
+    for (size_t b = a + 1; b < numLines; ++b)
+    {
+      for (size_t c = b + 1; c < numLines; ++c)
+      {
+        size_t vectorOther[8] = { SIZE_MAX, SIZE_MAX, SIZE_MAX, SIZE_MAX, SIZE_MAX, SIZE_MAX, SIZE_MAX, SIZE_MAX };
+        for (size_t other = 0; other < numOthers; ++other)
+        {
+          size_t vector = ((lines[a] >> other) & 1) | (((lines[b] >> other) & 1) << 1)
+            | (((lines[c] >> other) & 1) << 2);
+          vectorOther[vector] = other;
+        }
+        if (vectorOther[3] != SIZE_MAX && vectorOther[5] != SIZE_MAX && vectorOther[6] != SIZE_MAX
+          && vectorOther[7] != SIZE_MAX)
+        {
+          fanoLines[0] = a;
+          fanoLines[1] = b;
+          fanoLines[2] = c;
+          fanoOthers[0] = vectorOther[3];
+          fanoOthers[1] = vectorOther[5];
+          fanoOthers[2] = vectorOther[6];
+          fanoOthers[3] = vectorOther[7];
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * \brief Searches the representations of a small binary matroid with respect to all its bases for a submatrix that
+ *        represents \f$ F_7 \f$ or \f$ F_7^\star \f$.
+ *
+ * The bases are visited by a breadth-first search in which two bases are adjacent if they differ by a pivot.
+ */
+
+static
+CMR_ERROR searchSmallFano(
+  CMR* cmr,                       /**< \ref CMR environment. */
+  SmallRepresentation* initial,   /**< Representation to start with. */
+  size_t numRows,                 /**< Number of rows. */
+  size_t numColumns,              /**< Number of columns. */
+  SmallRepresentation* result,    /**< Pointer for storing the representation that contains the minor. */
+  size_t* fanoRows,               /**< Array for storing the rows of the minor. */
+  size_t* fanoColumns,            /**< Array for storing the columns of the minor. */
+  size_t* pnumFanoRows            /**< Pointer for storing 3 for \f$ F_7 \f$, 4 for \f$ F_7^\star \f$ and 0 if
+                                   **  there is no such minor. */
+)
+{
+  assert(cmr);
+  assert(initial);
+  assert(numRows + numColumns <= FANO_SEARCH_MAX_ELEMENTS);
+
+  size_t numElements = numRows + numColumns;
+  size_t maxNumBases = 1;
+  for (size_t i = 0; i < numRows; ++i)
+    maxNumBases = maxNumBases * (numElements - i) / (i + 1);
+
+  bool* visited = NULL; /* Indexed by the bitmask of the elements of a basis. */
+  CMR_CALL( CMRallocStackArray(cmr, &visited, (size_t) 1 << numElements) );
+  for (size_t mask = 0; mask < ((size_t) 1 << numElements); ++mask)
+    visited[mask] = false;
+  SmallRepresentation* queue = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &queue, maxNumBases) );
+
+  size_t basisMask = 0;
+  for (size_t row = 0; row < numRows; ++row)
+    basisMask |= (size_t) 1 << initial->rowsElement[row];
+  visited[basisMask] = true;
+  queue[0] = *initial;
+  size_t queueBeyond = 1;
+  *pnumFanoRows = 0;
+  for (size_t queueFirst = 0; queueFirst < queueBeyond; ++queueFirst)
+  {
+    SmallRepresentation* current = &queue[queueFirst];
+    if (findFanoLines(current->rows, numRows, numColumns, fanoRows, fanoColumns))
+    {
+      *result = *current;
+      *pnumFanoRows = 3;
+      break;
+    }
+
+    uint16_t columns[FANO_SEARCH_MAX_ELEMENTS];
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      columns[column] = 0;
+      for (size_t row = 0; row < numRows; ++row)
+        columns[column] |= ((current->rows[row] >> column) & 1) << row;
+    }
+    if (findFanoLines(columns, numColumns, numRows, fanoColumns, fanoRows))
+    {
+      *result = *current;
+      *pnumFanoRows = 4;
+      break;
+    }
+
+    basisMask = 0;
+    for (size_t row = 0; row < numRows; ++row)
+      basisMask |= (size_t) 1 << current->rowsElement[row];
+    for (size_t pivotRow = 0; pivotRow < numRows; ++pivotRow)
+    {
+      for (size_t pivotColumn = 0; pivotColumn < numColumns; ++pivotColumn)
+      {
+        if (!((current->rows[pivotRow] >> pivotColumn) & 1))
+          continue;
+
+        size_t pivotMask = basisMask ^ ((size_t) 1 << current->rowsElement[pivotRow])
+          ^ ((size_t) 1 << current->columnsElement[pivotColumn]);
+        if (visited[pivotMask])
+          continue;
+        visited[pivotMask] = true;
+
+        assert(queueBeyond < maxNumBases);
+        SmallRepresentation* pivoted = &queue[queueBeyond++];
+        *pivoted = *current;
+        for (size_t row = 0; row < numRows; ++row)
+        {
+          if (row != pivotRow && ((pivoted->rows[row] >> pivotColumn) & 1))
+            pivoted->rows[row] ^= pivoted->rows[pivotRow] ^ (1 << pivotColumn);
+        }
+        pivoted->rowsElement[pivotRow] = current->columnsElement[pivotColumn];
+        pivoted->columnsElement[pivotColumn] = current->rowsElement[pivotRow];
+      }
+    }
+  }
+
+  CMRdbgMsg(8, "Visited %zu of at most %zu bases of the %zux%zu minor.\n", queueBeyond, maxNumBases, numRows,
+    numColumns);
+
+  CMR_CALL( CMRfreeStackArray(cmr, &queue) );
+  CMR_CALL( CMRfreeStackArray(cmr, &visited) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the index of \p element of a matrix with \p numRows rows among all its rows and columns.
+ */
+
+static inline
+size_t elementIndex(
+  size_t numRows,     /**< Number of rows. */
+  CMR_ELEMENT element /**< Element. */
+)
+{
+  return CMRelementIsRow(element) ? CMRelementToRowIndex(element) : numRows + CMRelementToColumnIndex(element);
+}
+
+/**
+ * \brief Creates an \f$ F_7 \f$ or \f$ F_7^\star \f$ minor of \p matrix whose pivots yield a given basis.
+ *
+ * Pivots \p matrix greedily until the rows are the elements marked in \p inBasis. Then checks that the submatrix
+ * indexed by \p fanoRows and \p fanoColumns represents \f$ F_7 \f$ (3 rows) or \f$ F_7^\star \f$ (4 rows). If this
+ * succeeds, the minor is stored in \p *pminor, and otherwise \p *pminor remains \c NULL.
+ */
+
+static
+CMR_ERROR createFanoMinor(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,       /**< Binary matrix. */
+  bool* inBasis,            /**< Array indicating for each row and then each column whether it shall be a row. */
+  CMR_ELEMENT* fanoRows,    /**< Array with the elements of \p matrix that form the rows of the minor. */
+  size_t numFanoRows,       /**< Number of rows of the minor; 3 or 4. */
+  CMR_ELEMENT* fanoColumns, /**< Array with the elements of \p matrix that form the columns of the minor. */
+  CMR_MINOR** pminor        /**< Pointer for storing the minor. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(inBasis);
+  assert(numFanoRows == 3 || numFanoRows == 4);
+  assert(pminor);
+
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+  size_t numFanoColumns = 7 - numFanoRows;
+
+  size_t basisSize = 0;
+  for (size_t e = 0; e < numRows + numColumns; ++e)
+    basisSize += inBasis[e] ? 1 : 0;
+  if (basisSize != numRows)
+    return CMR_OKAY;
+
+  size_t* rowsLabel = NULL; /* Index of the element of each row. */
+  CMR_CALL( CMRallocStackArray(cmr, &rowsLabel, numRows) );
+  size_t* columnsLabel = NULL; /* Index of the element of each column. */
+  CMR_CALL( CMRallocStackArray(cmr, &columnsLabel, numColumns) );
+  size_t* pivotRows = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &pivotRows, numRows) );
+  size_t* pivotColumns = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &pivotColumns, numRows) );
+  size_t* position = NULL; /* Row or column of each element after the pivots. */
+  CMR_CALL( CMRallocStackArray(cmr, &position, numRows + numColumns) );
+
+  for (size_t row = 0; row < numRows; ++row)
+    rowsLabel[row] = row;
+  for (size_t column = 0; column < numColumns; ++column)
+    columnsLabel[column] = numRows + column;
+
+  CMR_CHRMAT* current = matrix;
+  size_t numPivots = 0;
+  bool isBasis = true;
+  while (true)
+  {
+    bool isFinal = true;
+    size_t pivotRow = SIZE_MAX;
+    size_t pivotColumn = SIZE_MAX;
+    for (size_t row = 0; row < numRows && pivotRow == SIZE_MAX; ++row)
+    {
+      if (inBasis[rowsLabel[row]])
+        continue;
+
+      isFinal = false;
+      size_t beyond = current->rowSlice[row + 1];
+      for (size_t entry = current->rowSlice[row]; entry < beyond; ++entry)
+      {
+        size_t column = current->entryColumns[entry];
+        if (inBasis[columnsLabel[column]])
+        {
+          pivotRow = row;
+          pivotColumn = column;
+          break;
+        }
+      }
+
+      /* By the exchange property, such a pivot exists if the target is a basis. */
+      if (pivotRow == SIZE_MAX)
+        break;
+    }
+    if (isFinal)
+      break;
+    if (pivotRow == SIZE_MAX)
+    {
+      isBasis = false;
+      break;
+    }
+
+    CMR_CHRMAT* pivoted = NULL;
+    CMR_CALL( CMRchrmatBinaryPivot(cmr, current, pivotRow, pivotColumn, &pivoted) );
+    if (current != matrix)
+      CMR_CALL( CMRchrmatFree(cmr, &current) );
+    current = pivoted;
+
+    assert(numPivots < numRows);
+    pivotRows[numPivots] = pivotRow;
+    pivotColumns[numPivots] = pivotColumn;
+    ++numPivots;
+    size_t temp = rowsLabel[pivotRow];
+    rowsLabel[pivotRow] = columnsLabel[pivotColumn];
+    columnsLabel[pivotColumn] = temp;
+  }
+
+  CMRdbgMsg(8, "Carried out %zu pivots to reach %s basis.\n", numPivots, isBasis ? "the" : "no");
+
+  if (isBasis)
+  {
+    for (size_t row = 0; row < numRows; ++row)
+      position[rowsLabel[row]] = row;
+    for (size_t column = 0; column < numColumns; ++column)
+      position[columnsLabel[column]] = column;
+
+    CMR_SUBMAT* submatrix = NULL;
+    CMR_CALL( CMRsubmatCreate(cmr, numFanoRows, numFanoColumns, &submatrix) );
+    uint16_t rowMasks[4] = { 0, 0, 0, 0 };
+    uint16_t columnMasks[4] = { 0, 0, 0, 0 };
+    bool isValid = true;
+    for (size_t i = 0; i < numFanoRows; ++i)
+    {
+      size_t index = elementIndex(numRows, fanoRows[i]);
+      isValid = isValid && inBasis[index];
+      submatrix->rows[i] = position[index];
+    }
+    for (size_t j = 0; j < numFanoColumns; ++j)
+    {
+      size_t index = elementIndex(numRows, fanoColumns[j]);
+      isValid = isValid && !inBasis[index];
+      submatrix->columns[j] = position[index];
+    }
+    for (size_t i = 0; i < numFanoRows && isValid; ++i)
+    {
+      for (size_t j = 0; j < numFanoColumns; ++j)
+      {
+        size_t entry;
+        CMR_CALL( CMRchrmatFindEntry(current, submatrix->rows[i], submatrix->columns[j], &entry) );
+        if (entry != SIZE_MAX)
+        {
+          rowMasks[i] |= 1 << j;
+          columnMasks[j] |= 1 << i;
+        }
+      }
+    }
+
+    size_t lines[3];
+    size_t others[4];
+    if (isValid && (numFanoRows == 3 ? findFanoLines(rowMasks, 3, 4, lines, others)
+      : findFanoLines(columnMasks, 3, 4, lines, others)))
+    {
+      CMR_CALL( CMRminorCreate(cmr, pminor, numPivots, submatrix) );
+      for (size_t p = 0; p < numPivots; ++p)
+      {
+        (*pminor)->pivotRows[p] = pivotRows[p];
+        (*pminor)->pivotColumns[p] = pivotColumns[p];
+      }
+    }
+    else
+    {
+      CMRdbgMsg(8, "Submatrix does not represent F_7 or its dual.\n");
+      CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    }
+  }
+
+  if (current != matrix)
+    CMR_CALL( CMRchrmatFree(cmr, &current) );
+
+  CMR_CALL( CMRfreeStackArray(cmr, &position) );
+  CMR_CALL( CMRfreeStackArray(cmr, &pivotColumns) );
+  CMR_CALL( CMRfreeStackArray(cmr, &pivotRows) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsLabel) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsLabel) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularityNestedMinorSequenceFindFano(CMR* cmr, CMR_MATROID_DEC* dec, size_t minorIndex)
+{
+  assert(cmr);
+  assert(dec);
+  assert(dec->nestedMinorsMatrix);
+
+  if (dec->isTernary || dec->irregularMinor || minorIndex >= dec->nestedMinorsLength)
+    return CMR_OKAY;
+
+  size_t numMinorRows = dec->nestedMinorsSequenceNumRows[minorIndex];
+  size_t numMinorColumns = dec->nestedMinorsSequenceNumColumns[minorIndex];
+  if (numMinorRows + numMinorColumns > FANO_SEARCH_MAX_ELEMENTS)
+  {
+    CMRdbgMsg(8, "Not searching for F_7 or its dual in the %zux%zu minor.\n", numMinorRows, numMinorColumns);
+    return CMR_OKAY;
+  }
+
+  CMRdbgMsg(8, "Searching for F_7 or its dual in the %zux%zu minor.\n", numMinorRows, numMinorColumns);
+
+  /* The minor is the top-left submatrix of the nested minors matrix. */
+  SmallRepresentation initial;
+  for (size_t row = 0; row < numMinorRows; ++row)
+  {
+    initial.rows[row] = 0;
+    initial.rowsElement[row] = row;
+    size_t beyond = dec->nestedMinorsMatrix->rowSlice[row + 1];
+    for (size_t entry = dec->nestedMinorsMatrix->rowSlice[row]; entry < beyond; ++entry)
+    {
+      size_t column = dec->nestedMinorsMatrix->entryColumns[entry];
+      if (column < numMinorColumns)
+        initial.rows[row] |= 1 << column;
+    }
+  }
+  for (size_t column = 0; column < numMinorColumns; ++column)
+    initial.columnsElement[column] = numMinorRows + column;
+
+  SmallRepresentation representation;
+  size_t fanoRows[4];
+  size_t fanoColumns[4];
+  size_t numFanoRows;
+  CMR_CALL( searchSmallFano(cmr, &initial, numMinorRows, numMinorColumns, &representation, fanoRows, fanoColumns,
+    &numFanoRows) );
+  if (!numFanoRows)
+    return CMR_OKAY;
+
+  /* Translate the elements of the minor into those of the matrix. */
+  CMR_ELEMENT smallElements[FANO_SEARCH_MAX_ELEMENTS] = { 0 };
+  for (size_t row = 0; row < numMinorRows; ++row)
+    smallElements[row] = dec->nestedMinorsRowsOriginal[row];
+  for (size_t column = 0; column < numMinorColumns; ++column)
+    smallElements[numMinorRows + column] = dec->nestedMinorsColumnsOriginal[column];
+  CMR_ELEMENT fanoRowElements[4];
+  CMR_ELEMENT fanoColumnElements[4];
+  for (size_t i = 0; i < numFanoRows; ++i)
+    fanoRowElements[i] = smallElements[representation.rowsElement[fanoRows[i]]];
+  for (size_t j = 0; j < 7 - numFanoRows; ++j)
+    fanoColumnElements[j] = smallElements[representation.columnsElement[fanoColumns[j]]];
+
+  /* The rows beyond the minor are contracted, so they belong to the basis together with that of the minor. */
+  bool* inBasis = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &inBasis, dec->numRows + dec->numColumns) );
+  for (size_t e = 0; e < dec->numRows + dec->numColumns; ++e)
+    inBasis[e] = false;
+  for (size_t row = numMinorRows; row < dec->numRows; ++row)
+    inBasis[elementIndex(dec->numRows, dec->nestedMinorsRowsOriginal[row])] = true;
+  for (size_t row = 0; row < numMinorRows; ++row)
+    inBasis[elementIndex(dec->numRows, smallElements[representation.rowsElement[row]])] = true;
+
+  CMR_CALL( createFanoMinor(cmr, dec->matrix, inBasis, fanoRowElements, numFanoRows, fanoColumnElements,
+    &dec->irregularMinor) );
+
+  CMR_CALL( CMRfreeStackArray(cmr, &inBasis) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the first node of the decomposition tree rooted at \p dec that has an \f$ F_7 \f$ or
+ *        \f$ F_7^\star \f$ minor.
+ */
+
+static
+CMR_MATROID_DEC* findMinorNode(
+  CMR_MATROID_DEC* dec  /**< Decomposition node. */
+)
+{
+  if (dec->irregularMinor)
+    return dec;
+
+  for (size_t c = 0; c < dec->numChildren; ++c)
+  {
+    CMR_MATROID_DEC* node = dec->children[c] ? findMinorNode(dec->children[c]) : NULL;
+    if (node)
+      return node;
+  }
+
+  return NULL;
+}
+
+CMR_ERROR CMRregularityExtractMinor(CMR* cmr, CMR_MATROID_DEC* root, CMR_CHRMAT* matrix, CMR_MINOR** pminor)
+{
+  assert(cmr);
+  assert(root);
+  assert(matrix);
+  assert(pminor);
+
+  CMR_MATROID_DEC* leaf = findMinorNode(root);
+  if (!leaf)
+    return CMR_OKAY;
+
+  size_t numRootRows = matrix->numRows;
+  size_t numRootElements = matrix->numRows + matrix->numColumns;
+
+  /* Removed rows are contracted and removed columns are deleted, unless the leaf decides otherwise. */
+  bool* inBasis = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &inBasis, numRootElements) );
+  for (size_t e = 0; e < numRootElements; ++e)
+    inBasis[e] = e < numRootRows;
+
+  size_t depth = 0;
+  for (CMR_MATROID_DEC* node = leaf; node != root; node = node->parent)
+    ++depth;
+  CMR_MATROID_DEC** path = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &path, depth + 1) );
+  path[depth] = leaf;
+  for (size_t level = depth; level > 0; --level)
+    path[level - 1] = path[level]->parent;
+  assert(path[0] == root);
+
+  /* Map the rows and columns of the nodes along the path to elements of the root. */
+  CMR_ELEMENT* rowsRoot = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &rowsRoot, root->numRows) );
+  CMR_ELEMENT* columnsRoot = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &columnsRoot, root->numColumns) );
+  for (size_t row = 0; row < root->numRows; ++row)
+    rowsRoot[row] = CMRrowToElement(row);
+  for (size_t column = 0; column < root->numColumns; ++column)
+    columnsRoot[column] = CMRcolumnToElement(column);
+
+  for (size_t level = 1; level <= depth; ++level)
+  {
+    CMR_MATROID_DEC* parent = path[level - 1];
+    CMR_MATROID_DEC* child = path[level];
+    CMR_ELEMENT* childRowsRoot = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &childRowsRoot, child->numRows) );
+    CMR_ELEMENT* childColumnsRoot = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &childColumnsRoot, child->numColumns) );
+
+    if (parent->type == CMR_MATROID_DEC_TYPE_PIVOTS)
+    {
+      /* Each pivot exchanges the elements of its row and column. */
+      assert(child->numRows == parent->numRows && child->numColumns == parent->numColumns);
+      for (size_t row = 0; row < child->numRows; ++row)
+        childRowsRoot[row] = rowsRoot[row];
+      for (size_t column = 0; column < child->numColumns; ++column)
+        childColumnsRoot[column] = columnsRoot[column];
+      for (size_t p = 0; p < parent->numPivots; ++p)
+      {
+        CMR_ELEMENT temp = childRowsRoot[parent->pivotRows[p]];
+        childRowsRoot[parent->pivotRows[p]] = childColumnsRoot[parent->pivotColumns[p]];
+        childColumnsRoot[parent->pivotColumns[p]] = temp;
+      }
+    }
+    else
+    {
+      bool* rowsUsed = NULL;
+      CMR_CALL( CMRallocBlockArray(cmr, &rowsUsed, parent->numRows) );
+      bool* columnsUsed = NULL;
+      CMR_CALL( CMRallocBlockArray(cmr, &columnsUsed, parent->numColumns) );
+      for (size_t row = 0; row < parent->numRows; ++row)
+        rowsUsed[row] = false;
+      for (size_t column = 0; column < parent->numColumns; ++column)
+        columnsUsed[column] = false;
+
+      for (size_t row = 0; row < child->numRows; ++row)
+      {
+        size_t parentRow = child->rowsParent[row];
+        childRowsRoot[row] = (parentRow == SIZE_MAX) ? 0 : rowsRoot[parentRow];
+        if (parentRow != SIZE_MAX)
+          rowsUsed[parentRow] = true;
+      }
+      for (size_t column = 0; column < child->numColumns; ++column)
+      {
+        size_t parentColumn = child->columnsParent[column];
+        childColumnsRoot[column] = (parentColumn == SIZE_MAX) ? 0 : columnsRoot[parentColumn];
+        if (parentColumn != SIZE_MAX)
+          columnsUsed[parentColumn] = true;
+      }
+
+      for (size_t row = 0; row < parent->numRows; ++row)
+      {
+        if (!rowsUsed[row] && CMRelementIsValid(rowsRoot[row]))
+          inBasis[elementIndex(numRootRows, rowsRoot[row])] = true;
+      }
+      for (size_t column = 0; column < parent->numColumns; ++column)
+      {
+        if (!columnsUsed[column] && CMRelementIsValid(columnsRoot[column]))
+          inBasis[elementIndex(numRootRows, columnsRoot[column])] = false;
+      }
+
+      CMR_CALL( CMRfreeBlockArray(cmr, &columnsUsed) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &rowsUsed) );
+    }
+
+    CMR_CALL( CMRfreeBlockArray(cmr, &columnsRoot) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &rowsRoot) );
+    rowsRoot = childRowsRoot;
+    columnsRoot = childColumnsRoot;
+  }
+
+  /* Apply the pivots of the leaf's minor to the root elements of its rows and columns. */
+  CMR_MINOR* leafMinor = leaf->irregularMinor;
+  for (size_t p = 0; p < leafMinor->numPivots; ++p)
+  {
+    CMR_ELEMENT temp = rowsRoot[leafMinor->pivotRows[p]];
+    rowsRoot[leafMinor->pivotRows[p]] = columnsRoot[leafMinor->pivotColumns[p]];
+    columnsRoot[leafMinor->pivotColumns[p]] = temp;
+  }
+  for (size_t row = 0; row < leaf->numRows; ++row)
+  {
+    if (CMRelementIsValid(rowsRoot[row]))
+      inBasis[elementIndex(numRootRows, rowsRoot[row])] = true;
+  }
+  for (size_t column = 0; column < leaf->numColumns; ++column)
+  {
+    if (CMRelementIsValid(columnsRoot[column]))
+      inBasis[elementIndex(numRootRows, columnsRoot[column])] = false;
+  }
+
+  CMR_SUBMAT* leafSubmatrix = leafMinor->remainingSubmatrix;
+  CMR_ELEMENT fanoRows[4];
+  CMR_ELEMENT fanoColumns[4];
+  bool isMapped = true;
+  for (size_t i = 0; i < leafSubmatrix->numRows; ++i)
+  {
+    fanoRows[i] = rowsRoot[leafSubmatrix->rows[i]];
+    isMapped = isMapped && CMRelementIsValid(fanoRows[i]);
+  }
+  for (size_t j = 0; j < leafSubmatrix->numColumns; ++j)
+  {
+    fanoColumns[j] = columnsRoot[leafSubmatrix->columns[j]];
+    isMapped = isMapped && CMRelementIsValid(fanoColumns[j]);
+  }
+
+  /* Marker elements of the leaf's minor have no counterpart in the root. */
+  if (isMapped)
+  {
+    CMR_CALL( createFanoMinor(cmr, matrix, inBasis, fanoRows, leafSubmatrix->numRows, fanoColumns, pminor) );
+  }
+  CMRdbgMsg(0, "Extracting the minor of a node at depth %zu %s.\n", depth, *pminor ? "succeeded" : "failed");
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &columnsRoot) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &rowsRoot) );
+  CMR_CALL( CMRfreeStackArray(cmr, &path) );
+  CMR_CALL( CMRfreeStackArray(cmr, &inBasis) );
+
+  return CMR_OKAY;
+}
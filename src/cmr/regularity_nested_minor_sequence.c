@@ -3,11 +3,11 @@
 #include "matroid_internal.h"
 #include "regularity_internal.h"
 #include "env_internal.h"
+#include "counters.h"
 
 #include "densematrix.h"
 #include "hashtable.h"
 
-#include <time.h>
 
 typedef struct
 {
@@ -99,11 +99,15 @@ CMR_ERROR createHashVector(
 
   CMR_CALL( CMRallocStackArray(cmr, phashVector, size) );
   long long* hashVector = *phashVector;
-  size_t h = 1;
+  uint64_t h = 0;
   for (size_t e = 0; e < size; ++e)
   {
-    hashVector[e] = h;
-    h = projectSignedHash(3 * h);
+    /* Pseudo-random words (splitmix64) such that XORs of distinct subsets rarely collide. */
+    h += UINT64_C(0x9E3779B97F4A7C15);
+    uint64_t z = h;
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    hashVector[e] = (long long) (z ^ (z >> 31));
   }
 
   return CMR_OKAY;
@@ -113,7 +117,8 @@ CMR_ERROR createHashVector(
  * \brief Initializes the hashtable \p majorHashtable for unprocessed rows/columns.
  *
  * Initializes the hashtable \p majorHashtable for row/column vectors of unprocessed rows/columns with respect to those
- * columns/rows that were already processed.
+ * columns/rows that were already processed. The hash value of a vector is the XOR of the hash vector entries of its
+ * support, such that adding two vectors over GF(2) amounts to XORing their hash values.
  */
 
 static
@@ -146,7 +151,7 @@ CMR_ERROR initializeHashing(
       size_t minor = processedMinors[j];
       if (CMRdensebinmatrixGet(dense, isRow ? major : minor, isRow ? minor : major))
       {
-        majorData[major].hashValue = projectSignedHash( majorData[major].hashValue + hashVector[minor] );
+        majorData[major].hashValue ^= hashVector[minor];
         majorData[major].numNonzeros++;
         majorData[major].representative = isRow ? CMRcolumnToElement(minor) : CMRrowToElement(minor);
       }
@@ -318,9 +323,10 @@ CMR_ERROR prepareSearch(
   if (CMRelementIsRow(*pstartElement))
   {
     size_t row = CMRelementToRowIndex(*pstartElement);
-    for (size_t column = 0; column < matrix->numColumns; ++column)
+    for (size_t column = CMRdensebinmatrixRowFindNext(matrix, row, 0); column != SIZE_MAX;
+      column = CMRdensebinmatrixRowFindNext(matrix, row, column + 1))
     {
-      if (CMRdensebinmatrixGet(matrix, row, column) && columnData[column].isTarget)
+      if (columnData[column].isTarget)
         columnData[column].isFlipped = true;
     }
   }
@@ -338,6 +344,15 @@ CMR_ERROR prepareSearch(
 }
 
 
+/**
+ * \brief Searches for a shortest path from the sources to some target by a breadth-first search.
+ *
+ * The search is carried out layer by layer on bitsets. The columns reached from the rows of the current layer are
+ * obtained by adding the flipped columns to each such row (if it is flipped) and masking out the visited columns.
+ * The rows reached from the columns of the current layer are those unvisited rows whose (possibly flipped) row
+ * vector intersects the bitset of these columns. In both cases 64 elements are handled per word operation.
+ */
+
 static
 CMR_ERROR searchShortestPath(
   CMR* cmr,                   /**< \ref CMR environment. */
@@ -356,84 +371,152 @@ CMR_ERROR searchShortestPath(
   CMRdbgMsg(6, "Searching for shortest path.\n");
   *preachedTarget = 0;
 
+  size_t numRows = dense->numRows;
+  size_t numColumns = dense->numColumns;
+  size_t stride = dense->stride;
+
+  /* Bitsets of flipped columns, of visited columns and of the columns of the current layer. Bits beyond the last
+   * column are marked as visited such that they are never reached. */
+  uint64_t* flippedColumns = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &flippedColumns, 3 * stride) );
+  uint64_t* visitedColumns = &flippedColumns[stride];
+  uint64_t* layerColumns = &flippedColumns[2 * stride];
+  for (size_t w = 0; w < stride; ++w)
+  {
+    flippedColumns[w] = 0;
+    visitedColumns[w] = (64 * w + 64 <= numColumns) ? 0
+      : ((64 * w >= numColumns) ? ~UINT64_C(0) : (~UINT64_C(0) << (numColumns % 64)));
+    layerColumns[w] = 0;
+  }
+
+  /* Elements of the current layer occupy queue[layerFirst..layerBeyond). */
   CMR_ELEMENT* queue = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &queue, dense->numRows + dense->numColumns) );
-  size_t queueFirst = 0;
-  size_t queueBeyond = 0;
-  for (size_t row = 0; row < dense->numRows; ++row)
+  CMR_CALL( CMRallocStackArray(cmr, &queue, numRows + numColumns) );
+  size_t layerFirst = 0;
+  size_t layerBeyond = 0;
+
+  /* Unvisited rows that may still be reached. */
+  size_t* unvisitedRows = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &unvisitedRows, numRows) );
+  size_t numUnvisitedRows = 0;
+
+  for (size_t row = 0; row < numRows; ++row)
   {
     rowData[row].inQueue = rowData[row].isSource;
     if (rowData[row].isSource)
-      queue[queueBeyond++] = CMRrowToElement(row);
+      queue[layerBeyond++] = CMRrowToElement(row);
+    else if (!rowData[row].isProcessed)
+      unvisitedRows[numUnvisitedRows++] = row;
     rowData[row].predecessor = 0;
   }
-  for (size_t column = 0; column < dense->numColumns; ++column)
+  for (size_t column = 0; column < numColumns; ++column)
   {
     columnData[column].inQueue = columnData[column].isSource;
     if (columnData[column].isSource)
-      queue[queueBeyond++] = CMRcolumnToElement(column);
+      queue[layerBeyond++] = CMRcolumnToElement(column);
+    if (columnData[column].isFlipped)
+      flippedColumns[column / 64] |= UINT64_C(1) << (column % 64);
+    if (columnData[column].isSource || columnData[column].isProcessed)
+      visitedColumns[column / 64] |= UINT64_C(1) << (column % 64);
     columnData[column].predecessor = 0;
   }
 
-  while (queueFirst < queueBeyond)
+  while (layerFirst < layerBeyond)
   {
-    CMRdbgMsg(8, "BFS queue contains %ld elements. Top element is %s.\n", queueBeyond - queueFirst,
-    CMRelementString(queue[queueFirst], NULL));
+    CMRdbgMsg(8, "BFS layer contains %zu elements.\n", layerBeyond - layerFirst);
 
-    CMR_ELEMENT top = queue[queueFirst++];
-    if (CMRelementIsRow(top))
+    /* Targets are checked in queue order before the layer is expanded. */
+    for (size_t q = layerFirst; q < layerBeyond; ++q)
     {
-      size_t row = CMRelementToRowIndex(top);
-      if (rowData[row].isTarget)
+      CMR_ELEMENT element = queue[q];
+      if (CMRelementIsRow(element) ? rowData[CMRelementToRowIndex(element)].isTarget
+        : columnData[CMRelementToColumnIndex(element)].isTarget)
       {
-        *preachedTarget = CMRrowToElement(row);
-        break;
+        *preachedTarget = element;
+        goto cleanup;
       }
-      else
+    }
+
+    size_t nextBeyond = layerBeyond;
+
+    /* Collect the columns of the layer before any new columns are appended. */
+    bool hasLayerColumns = false;
+    for (size_t q = layerFirst; q < layerBeyond; ++q)
+    {
+      if (CMRelementIsColumn(queue[q]))
+      {
+        size_t column = CMRelementToColumnIndex(queue[q]);
+        layerColumns[column / 64] |= UINT64_C(1) << (column % 64);
+        hasLayerColumns = true;
+      }
+    }
+
+    /* Expand rows of the layer. */
+    for (size_t q = layerFirst; q < layerBeyond; ++q)
+    {
+      if (!CMRelementIsRow(queue[q]))
+        continue;
+
+      size_t row = CMRelementToRowIndex(queue[q]);
+      const uint64_t* rowWords = CMRdensebinmatrixRow(dense, row);
+      uint64_t flipMask = rowData[row].isFlipped ? ~UINT64_C(0) : 0;
+      for (size_t w = 0; w < stride; ++w)
       {
-        bool rowFlipped = rowData[row].isFlipped;
-        for (size_t column = 0; column < dense->numColumns; ++column)
+        uint64_t reached = (rowWords[w] ^ (flippedColumns[w] & flipMask)) & ~visitedColumns[w];
+        visitedColumns[w] |= reached;
+        while (reached)
         {
-          bool flip = rowFlipped && columnData[column].isFlipped;
-          if (flip == CMRdensebinmatrixGet(dense, row, column))
-            continue;
-          if (columnData[column].inQueue || columnData[column].isProcessed)
-            continue;
-  
-          queue[queueBeyond++] = CMRcolumnToElement(column);
+          size_t column = 64 * w + CMRbitsetLowest(reached);
+          reached &= reached - 1;
+          queue[nextBeyond++] = CMRcolumnToElement(column);
           columnData[column].inQueue = true;
           columnData[column].predecessor = CMRrowToElement(row);
         }
       }
     }
-    else
+
+    /* Expand columns of the layer. */
+    if (hasLayerColumns)
     {
-      size_t column = CMRelementToColumnIndex(top);
-      if (columnData[column].isTarget)
+      size_t numRemainingRows = 0;
+      for (size_t u = 0; u < numUnvisitedRows; ++u)
       {
-        *preachedTarget = CMRcolumnToElement(column);
-        break;
-      }
-      else
-      {
-        bool columnFlipped = columnData[column].isFlipped;
-        for (size_t row = 0; row < dense->numRows; ++row)
+        size_t row = unvisitedRows[u];
+        const uint64_t* rowWords = CMRdensebinmatrixRow(dense, row);
+        uint64_t flipMask = rowData[row].isFlipped ? ~UINT64_C(0) : 0;
+        size_t w = 0;
+        uint64_t reached = 0;
+        for (; w < stride; ++w)
         {
-          bool flip = columnFlipped && rowData[row].isFlipped;
-          if (flip == CMRdensebinmatrixGet(dense, row, column))
-            continue;
-          if (rowData[row].inQueue || rowData[row].isProcessed)
-            continue;
-  
-          queue[queueBeyond++] = CMRrowToElement(row);
+          reached = (rowWords[w] ^ (flippedColumns[w] & flipMask)) & layerColumns[w];
+          if (reached)
+            break;
+        }
+
+        if (reached)
+        {
+          queue[nextBeyond++] = CMRrowToElement(row);
           rowData[row].inQueue = true;
-          rowData[row].predecessor = CMRcolumnToElement(column);
+          rowData[row].predecessor = CMRcolumnToElement(64 * w + CMRbitsetLowest(reached));
         }
+        else
+          unvisitedRows[numRemainingRows++] = row;
       }
+      numUnvisitedRows = numRemainingRows;
+
+      for (size_t w = 0; w < stride; ++w)
+        layerColumns[w] = 0;
     }
+
+    layerFirst = layerBeyond;
+    layerBeyond = nextBeyond;
   }
 
+cleanup:
+
+  CMR_CALL( CMRfreeStackArray(cmr, &unvisitedRows) );
   CMR_CALL( CMRfreeStackArray(cmr, &queue) );
+  CMR_CALL( CMRfreeStackArray(cmr, &flippedColumns) );
 
   return CMR_OKAY;
 }
@@ -455,54 +538,146 @@ CMR_ERROR pivot(
   assert(cmr);
   assert(dec);
 
-  /* Collect rows to be modified. */
-  size_t* rows = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &rows, dec->numRows) );
-  size_t numRows = 0;
+  CMR_UNUSED(cmr);
+
+  /* Every other row with a 1 in the pivot column gets the pivot row added, except for the pivot column itself. */
   for (size_t row = 0; row < dec->numRows; ++row)
   {
     if (row != pivotRow && CMRdensebinmatrixGet(dec->denseMatrix, row, pivotColumn))
-      rows[numRows++] = row;
+    {
+      CMRdensebinmatrixRowXor(dec->denseMatrix, row, pivotRow);
+      CMRdensebinmatrixSet1(dec->denseMatrix, row, pivotColumn);
+    }
   }
 
-  /* Collect rows to be modified. */
-  size_t* columns = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &columns, dec->numColumns) );
-  size_t numColumns = 0;
-  for (size_t column = 0; column < dec->numColumns; ++column)
+  CMR_ELEMENT temp = dec->denseRowsOriginal[pivotRow];
+  dec->denseRowsOriginal[pivotRow] = dec->denseColumnsOriginal[pivotColumn];
+  dec->denseColumnsOriginal[pivotColumn] = temp;
+  
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Recounts the nonzeros of row/column \p major in processed columns/rows after its hash value changed.
+ *
+ * If \p major is processed, its outdated entry is removed from \p majorHashtable; \ref updateHashtable re-inserts it.
+ */
+
+static
+CMR_ERROR refreshChangedMajor(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  DenseBinaryMatrix* dense,           /**< Matrix. */
+  ElementData* majorData,             /**< Major index data. */
+  CMR_LISTHASHTABLE* majorHashtable,  /**< Major index hashtable. */
+  size_t* processedMinors,            /**< Array of processed minor indices. */
+  size_t numProcessedMinors,          /**< Number of processed minor indices. */
+  size_t major,                       /**< Major index whose hash value changed. */
+  bool isRow                          /**< Whether major means row. */
+)
+{
+  assert(cmr);
+
+  if (majorData[major].isProcessed)
   {
-    if (column != pivotColumn && CMRdensebinmatrixGet(dec->denseMatrix, pivotRow, column))
-      columns[numColumns++] = column;
+    if (majorData[major].hashEntry != SIZE_MAX)
+    {
+      CMR_CALL( CMRlisthashtableRemove(cmr, majorHashtable, majorData[major].hashEntry) );
+      majorData[major].hashEntry = SIZE_MAX;
+    }
+    return CMR_OKAY;
   }
 
-  for (size_t r = 0; r < numRows; ++r)
+  majorData[major].numNonzeros = 0;
+  majorData[major].representative = 0;
+  for (size_t j = 0; j < numProcessedMinors; ++j)
   {
-    size_t row = rows[r];
-    for (size_t c = 0; c < numColumns; ++c)
+    size_t minor = processedMinors[j];
+    if (CMRdensebinmatrixGet(dense, isRow ? major : minor, isRow ? minor : major))
     {
-      size_t column = columns[c];
-      CMRdensebinmatrixFlip(dec->denseMatrix, row, column);
+      majorData[major].numNonzeros++;
+      majorData[major].representative = isRow ? CMRcolumnToElement(minor) : CMRrowToElement(minor);
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Updates the hash values of the rows and columns that were changed by a pivot at (\p pivotRow, \p pivotColumn).
+ *
+ * The pivot adds the pivot row to every other row with a 1 in the pivot column, and, equivalently, the pivot column
+ * without the pivot row to every other column with a 1 in the pivot row. Since the pivot row and column are
+ * unprocessed, their hash values are not affected, and the hash values of the changed rows and columns are updated
+ * by a single XOR each. Only if such an update changes a hash value, the nonzeros of that row/column are recounted.
+ */
+
+static
+CMR_ERROR updatePivotHashes(
+  CMR* cmr,                           /**< \ref CMR environment. */
+  DenseBinaryMatrix* dense,           /**< Matrix after the pivot. */
+  ElementData* rowData,               /**< Row data. */
+  ElementData* columnData,            /**< Column data. */
+  CMR_LISTHASHTABLE* rowHashtable,    /**< Row hashtable. */
+  CMR_LISTHASHTABLE* columnHashtable, /**< Column hashtable. */
+  size_t* processedRows,              /**< Array of processed rows. */
+  size_t numProcessedRows,            /**< Number of processed rows. */
+  size_t* processedColumns,           /**< Array of processed columns. */
+  size_t numProcessedColumns,         /**< Number of processed columns. */
+  size_t pivotRow,                    /**< Pivot row. */
+  size_t pivotColumn                  /**< Pivot column. */
+)
+{
+  assert(cmr);
+  assert(dense);
+  assert(!rowData[pivotRow].isProcessed);
+  assert(!columnData[pivotColumn].isProcessed);
+
+  long long rowDelta = rowData[pivotRow].hashValue;
+  if (rowDelta)
+  {
+    for (size_t row = 0; row < dense->numRows; ++row)
+    {
+      if (row == pivotRow || !CMRdensebinmatrixGet(dense, row, pivotColumn))
+        continue;
+
+      rowData[row].hashValue ^= rowDelta;
+      CMR_CALL( refreshChangedMajor(cmr, dense, rowData, rowHashtable, processedColumns, numProcessedColumns, row,
+        true) );
+    }
+  }
+
+  long long columnDelta = columnData[pivotColumn].hashValue;
+  if (columnDelta)
+  {
+    for (size_t column = CMRdensebinmatrixRowFindNext(dense, pivotRow, 0); column != SIZE_MAX;
+      column = CMRdensebinmatrixRowFindNext(dense, pivotRow, column + 1))
+    {
+      if (column == pivotColumn)
+        continue;
+
+      columnData[column].hashValue ^= columnDelta;
+      CMR_CALL( refreshChangedMajor(cmr, dense, columnData, columnHashtable, processedRows, numProcessedRows, column,
+        false) );
     }
   }
-  
-  CMR_CALL( CMRfreeStackArray(cmr, &columns) );
-  CMR_CALL( CMRfreeStackArray(cmr, &rows) );
 
-  CMR_ELEMENT temp = dec->denseRowsOriginal[pivotRow];
-  dec->denseRowsOriginal[pivotRow] = dec->denseColumnsOriginal[pivotColumn];
-  dec->denseColumnsOriginal[pivotColumn] = temp;
-  
   return CMR_OKAY;
 }
 
 static
 CMR_ERROR applyPivots(
   CMR* cmr,                   /**< \ref CMR environment. */
-  CMR_MATROID_DEC* dec,       /**< Decomposition node. */
-  ElementData* rowData,       /**< Row data. */
-  ElementData* columnData,    /**< Column data. */
-  CMR_ELEMENT reachedTarget,  /**< Reached target row/column. */
-  CMR_ELEMENT* newElements    /**< Array of length 3 for storing the new elements (followed by 0s). */
+  CMR_MATROID_DEC* dec,               /**< Decomposition node. */
+  ElementData* rowData,               /**< Row data. */
+  ElementData* columnData,            /**< Column data. */
+  CMR_LISTHASHTABLE* rowHashtable,    /**< Row hashtable. */
+  CMR_LISTHASHTABLE* columnHashtable, /**< Column hashtable. */
+  size_t* processedRows,              /**< Array of processed rows. */
+  size_t numProcessedRows,            /**< Number of processed rows. */
+  size_t* processedColumns,           /**< Array of processed columns. */
+  size_t numProcessedColumns,         /**< Number of processed columns. */
+  CMR_ELEMENT reachedTarget,          /**< Reached target row/column. */
+  CMR_ELEMENT* newElements            /**< Array of length 3 for storing the new elements (followed by 0s). */
 )
 {
   assert(cmr);
@@ -533,6 +708,8 @@ CMR_ERROR applyPivots(
         size_t pivotRow = CMRelementToRowIndex(newElements[rowElement]);
         size_t pivotColumn = CMRelementToColumnIndex(newElements[3-rowElement]);
         CMR_CALL( pivot(cmr, dec, pivotRow, pivotColumn) );
+        CMR_CALL( updatePivotHashes(cmr, dec->denseMatrix, rowData, columnData, rowHashtable, columnHashtable,
+          processedRows, numProcessedRows, processedColumns, numProcessedColumns, pivotRow, pivotColumn) );
 
         newElements[2] = 0;
         newElements[1] = 0;
@@ -611,7 +788,7 @@ CMR_ERROR addElement(
         minorData[minor].representative = isRow ? CMRrowToElement(newMajor) : CMRcolumnToElement(newMajor);
       }
       /* In any case, update the hash value. */
-      minorData[minor].hashValue = projectSignedHash( minorData[minor].hashValue + hashVector[newMajor] );
+      minorData[minor].hashValue ^= hashVector[newMajor];
     }
   }
 
@@ -633,6 +810,10 @@ CMR_ERROR CMRregularityExtendNestedMinorSequence(CMR* cmr, DecompositionTask* ta
   CMR_MATROID_DEC* dec = task->dec;
   assert(dec);
 
+  double time = CMRclockNow();
+  CMR_COUNTERS_SAMPLE sample;
+  CMRcountersStart(cmr, &sample);
+
   CMRdbgMsg(6, "Attempting to extend a sequence of 3-connected nested minors of length %zu with "
     "last minor of size %zux%zu with the following dense matrix:\n",
     dec->nestedMinorsLength, dec->nestedMinorsSequenceNumRows[dec->nestedMinorsLength-1],
@@ -707,8 +888,9 @@ CMR_ERROR CMRregularityExtendNestedMinorSequence(CMR* cmr, DecompositionTask* ta
   while (numProcessedRows < numRows || numProcessedColumns < numColumns)
   {
     if (((numProcessedRows + numProcessedColumns) % elementTimeFactor == 0)
-      && (clock() - task->startClock) * 1.0 / CLOCKS_PER_SEC > task->timeLimit)
+      && CMRdeadlinePassed(&task->stepDeadline))
     {
+      result = CMR_ERROR_TIMEOUT;
       goto cleanup;
     }
 
@@ -851,7 +1033,8 @@ CMR_ERROR CMRregularityExtendNestedMinorSequence(CMR* cmr, DecompositionTask* ta
         = dec->nestedMinorsSequenceNumColumns[dec->nestedMinorsLength-1];
       dec->nestedMinorsLength++;
       CMR_ELEMENT newElements[4];
-      CMR_CALL( applyPivots(cmr, dec, rowData, columnData, reachedTarget, newElements) );
+      CMR_CALL( applyPivots(cmr, dec, rowData, columnData, rowHashtable, columnHashtable, processedRows,
+        numProcessedRows, processedColumns, numProcessedColumns, reachedTarget, newElements) );
 
       for (size_t i = 0; CMRelementIsValid(newElements[i]); ++i)
       {
@@ -935,7 +1118,7 @@ CMR_ERROR CMRregularityExtendNestedMinorSequence(CMR* cmr, DecompositionTask* ta
 
       DecompositionTask* childTasks[2] = { task, NULL };
       CMR_CALL( CMRregularityTaskCreateRoot(cmr, dec->children[1], &childTasks[1], task->params, task->stats,
-        task->startClock, task->timeLimit) );
+        task->deadline) );
 
       childTasks[0]->dec = dec->children[0];
       dec->children[0]->testedSeriesParallel = false; /* TODO: we may carry over the found sequence including W_k. */
@@ -951,7 +1134,8 @@ CMR_ERROR CMRregularityExtendNestedMinorSequence(CMR* cmr, DecompositionTask* ta
 
   if (task->stats)
   {
-    task->stats->sequenceExtensionTime += (clock() - task->startClock) * 1.0 / CLOCKS_PER_SEC;
+    task->stats->sequenceExtensionTime += CMRclockNow() - time;
+    CMRcountersStop(&sample, &task->stats->sequenceExtensionCounters);
   }
 
   if (dec->type == CMR_MATROID_DEC_TYPE_TWO_SUM)
@@ -976,13 +1160,7 @@ CMR_ERROR CMRregularityExtendNestedMinorSequence(CMR* cmr, DecompositionTask* ta
     /* Count the nonzeros. */
     size_t entry = 0;
     for (size_t row = 0; row < numRows; ++row)
-    {
-      for (size_t column = 0; column < numColumns; ++column)
-      {
-        if (CMRdensebinmatrixGet(dec->denseMatrix, row, column))
-          ++entry;
-      }
-    }
+      entry += CMRdensebinmatrixRowCount(dec->denseMatrix, row);
 
     /* Create a sparse copy of dense, permuted such that the nested sequence is displayed from top-left on. */
     CMR_CALL( CMRchrmatCreate(cmr, &dec->nestedMinorsMatrix, numRows, numColumns, entry) );
@@ -11,12 +11,16 @@
 #include "sort.h"
 #include "block_decomposition.h"
 
-int compareOneSumComponents(const void* a, const void* b)
-{
-  return ((CMR_BLOCK*)b)->matrix->numNonzeros -
-    ((CMR_BLOCK*)a)->matrix->numNonzeros;
-}
+/**
+ * \brief Orders components by descending number of nonzeros; ties are broken by the order of the components to make
+ *        the decomposition deterministic.
+ */
+
+#define ONESUM_COMPONENT_LESS(a, b) \
+  ((a)->matrix->numNonzeros > (b)->matrix->numNonzeros \
+  || ((a)->matrix->numNonzeros == (b)->matrix->numNonzeros && (a) < (b)))
 
+CMR_SORT_DEFINE(sortOneSumComponents, CMR_BLOCK*, ONESUM_COMPONENT_LESS)
 
 CMR_ERROR CMRregularitySearchOneSum(CMR* cmr, DecompositionTask* task, DecompositionQueue* queue)
 {
@@ -60,7 +64,7 @@ CMR_ERROR CMRregularitySearchOneSum(CMR* cmr, DecompositionTask* task, Decomposi
     CMR_CALL( CMRallocStackArray(cmr, &orderedComponents, numComponents) );
     for (size_t comp = 0; comp < numComponents; ++comp)
       orderedComponents[comp] = &components[comp];
-    CMR_CALL( CMRsort(cmr, numComponents, orderedComponents, sizeof(CMR_BLOCK*), &compareOneSumComponents) );
+    sortOneSumComponents(orderedComponents, numComponents);
 
     /* We now create the children. */
     CMR_CALL( CMRmatroiddecUpdateOneSum(cmr, task->dec, numComponents) );
@@ -82,7 +86,7 @@ CMR_ERROR CMRregularitySearchOneSum(CMR* cmr, DecompositionTask* task, Decomposi
       task->dec->children[child]->testedTwoConnected = true;
       DecompositionTask* childTask = NULL;
       CMR_CALL( CMRregularityTaskCreateRoot(cmr, task->dec->children[child], &childTask, task->params, task->stats,
-        task->startClock, task->timeLimit) );
+        task->deadline) );
       CMRregularityQueueAdd(queue, childTask);
     }
 
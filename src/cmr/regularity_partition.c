@@ -4,8 +4,9 @@
 
 #include "env_internal.h"
 #include "matroid_internal.h"
+#include "threads.h"
+#include "counters.h"
 
-#include <time.h>
 
 /**
  * \brief Element specific data for the enumeration of 3-separations.
@@ -17,51 +18,244 @@ typedef struct
   short type[2];    /**< \brief Type of row/column for each part; element lies in span if and only if nonnegative. */
 } ElementData;
 
+/**
+ * \brief Assignment of the elements of a candidate 3-separation, together with counters for rank checks.
+ *
+ * For each row, the numbers of its nonzeros in the columns of each part are maintained, as is the number of nonzeros
+ * of each off-diagonal submatrix. Moving an element between parts updates them in time linear in its degree, which
+ * makes the check for a zero off-diagonal submatrix constant-time.
+ */
+
+typedef struct
+{
+  size_t numRows;                 /**< \brief Number of rows that may be assigned. */
+  size_t numColumns;              /**< \brief Number of columns that may be assigned. */
+  short* rowParts;                /**< \brief Part of each row of the matrix; -1 indicates being unassigned. */
+  short* columnParts;             /**< \brief Part of each column of the matrix; -1 indicates being unassigned. */
+  short* rowTargets;              /**< \brief Temporary parts for the assignable rows. */
+  short* columnTargets;           /**< \brief Temporary parts for the assignable columns. */
+  size_t* rowNonzeros[2];         /**< \brief For each part, the number of nonzeros of each row in its columns. */
+  size_t crossNonzeros[2];        /**< \brief For each part, the number of nonzeros in its rows and the other part's
+                                   **< columns. */
+  size_t rowRepresentative[2];    /**< \brief For each part, a row that had a nonzero in the other part's columns, or
+                                   **< \c SIZE_MAX. */
+} CandidateParts;
+
+/**
+ * \brief Initializes \p parts with all elements being unassigned.
+ */
+
+static
+CMR_ERROR candidatePartsInit(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CandidateParts* parts,  /**< Candidate parts. */
+  CMR_CHRMAT* matrix,     /**< Matrix. */
+  size_t numRows,         /**< Number of rows that may be assigned. */
+  size_t numColumns       /**< Number of columns that may be assigned. */
+)
+{
+  assert(cmr);
+  assert(parts);
+  assert(matrix);
+  assert(numRows <= matrix->numRows);
+  assert(numColumns <= matrix->numColumns);
+
+  parts->numRows = numRows;
+  parts->numColumns = numColumns;
+  parts->rowParts = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &parts->rowParts, matrix->numRows) );
+  parts->columnParts = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &parts->columnParts, matrix->numColumns) );
+  parts->rowTargets = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &parts->rowTargets, numRows) );
+  parts->columnTargets = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &parts->columnTargets, numColumns) );
+  for (short part = 0; part < 2; ++part)
+  {
+    parts->rowNonzeros[part] = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &parts->rowNonzeros[part], matrix->numRows) );
+    for (size_t row = 0; row < matrix->numRows; ++row)
+      parts->rowNonzeros[part][row] = 0;
+    parts->crossNonzeros[part] = 0;
+    parts->rowRepresentative[part] = SIZE_MAX;
+  }
+  for (size_t row = 0; row < matrix->numRows; ++row)
+    parts->rowParts[row] = -1;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+    parts->columnParts[column] = -1;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Frees the arrays of \p parts.
+ */
+
+static
+CMR_ERROR candidatePartsFree(
+  CMR* cmr,               /**< \ref CMR environment. */
+  CandidateParts* parts   /**< Candidate parts. */
+)
+{
+  assert(cmr);
+  assert(parts);
+
+  CMR_CALL( CMRfreeStackArray(cmr, &parts->rowNonzeros[1]) );
+  CMR_CALL( CMRfreeStackArray(cmr, &parts->rowNonzeros[0]) );
+  CMR_CALL( CMRfreeStackArray(cmr, &parts->columnTargets) );
+  CMR_CALL( CMRfreeStackArray(cmr, &parts->rowTargets) );
+  CMR_CALL( CMRfreeStackArray(cmr, &parts->columnParts) );
+  CMR_CALL( CMRfreeStackArray(cmr, &parts->rowParts) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Moves \p row to \p part.
+ */
+
+static
+void candidatePartsMoveRow(
+  CandidateParts* parts,  /**< Candidate parts. */
+  size_t row,             /**< Row to be moved. */
+  short part              /**< New part of \p row, or -1 for being unassigned. */
+)
+{
+  short oldPart = parts->rowParts[row];
+  if (oldPart >= 0)
+    parts->crossNonzeros[oldPart] -= parts->rowNonzeros[1-oldPart][row];
+  if (part >= 0)
+    parts->crossNonzeros[part] += parts->rowNonzeros[1-part][row];
+  parts->rowParts[row] = part;
+}
+
+/**
+ * \brief Moves \p column to \p part.
+ */
+
+static
+void candidatePartsMoveColumn(
+  CandidateParts* parts,  /**< Candidate parts. */
+  CMR_CHRMAT* transpose,  /**< Transpose of the matrix. */
+  size_t column,          /**< Column to be moved. */
+  short part              /**< New part of \p column, or -1 for being unassigned. */
+)
+{
+  short oldPart = parts->columnParts[column];
+  size_t beyond = transpose->rowSlice[column + 1];
+  for (size_t entry = transpose->rowSlice[column]; entry < beyond; ++entry)
+  {
+    size_t row = transpose->entryColumns[entry];
+    short rowPart = parts->rowParts[row];
+    if (oldPart >= 0)
+    {
+      parts->rowNonzeros[oldPart][row]--;
+      if (rowPart == 1-oldPart)
+        parts->crossNonzeros[rowPart]--;
+    }
+    if (part >= 0)
+    {
+      parts->rowNonzeros[part][row]++;
+      if (rowPart == 1-part)
+        parts->crossNonzeros[rowPart]++;
+    }
+  }
+  parts->columnParts[column] = part;
+}
+
+/**
+ * \brief Changes \p parts to the given assignment, moving only the elements whose part changes.
+ */
+
+static
+void candidatePartsAssign(
+  CandidateParts* parts,    /**< Candidate parts. */
+  CMR_CHRMAT* transpose,    /**< Transpose of the matrix. */
+  size_t* partRows[2],      /**< For each part, an array with its assigned rows. */
+  size_t partNumRows[2],    /**< For each part, the number of assigned rows. */
+  size_t* partColumns[2],   /**< For each part, an array with its assigned columns. */
+  size_t partNumColumns[2]  /**< For each part, the number of assigned columns. */
+)
+{
+  for (size_t row = 0; row < parts->numRows; ++row)
+    parts->rowTargets[row] = -1;
+  for (size_t column = 0; column < parts->numColumns; ++column)
+    parts->columnTargets[column] = -1;
+  for (short part = 0; part < 2; ++part)
+  {
+    for (size_t r = 0; r < partNumRows[part]; ++r)
+      parts->rowTargets[partRows[part][r]] = part;
+    for (size_t c = 0; c < partNumColumns[part]; ++c)
+      parts->columnTargets[partColumns[part][c]] = part;
+  }
+
+  for (size_t row = 0; row < parts->numRows; ++row)
+  {
+    if (parts->rowParts[row] != parts->rowTargets[row])
+      candidatePartsMoveRow(parts, row, parts->rowTargets[row]);
+  }
+  for (size_t column = 0; column < parts->numColumns; ++column)
+  {
+    if (parts->columnParts[column] != parts->columnTargets[column])
+      candidatePartsMoveColumn(parts, transpose, column, parts->columnTargets[column]);
+  }
+}
+
 /**
  * \brief Checks whether the submatrix with rows assigned to \p part and columns assigned to the other has at least
  *        rank 1.
  *
  * If the rank is at least 1, the row and column of a corresponding nonzero are stored in \p rowRepresentative and
- * \p columnRepresentative, respectively.
+ * \p columnRepresentative, respectively. The check itself takes constant time and the row is taken from a cache if
+ * possible.
  */
 
 static
 bool findRank1(
   CMR_CHRMAT* matrix,                 /**< Matrix. */
-  ElementData* rowData,               /**< Row element data. */
-  ElementData* columnData,            /**< Column element data. */
+  CandidateParts* parts,              /**< Candidate parts. */
   size_t rowRepresentative[2][2],     /**< Row representatives for each part. */
   size_t columnRepresentative[2][2],  /**< Column representatives for each part. */
   short part                          /**< Part to which the investigated rows belong. */
 )
 {
   assert(matrix);
-  assert(rowData);
+  assert(parts);
   assert(rowRepresentative);
   assert(columnRepresentative);
   assert(part >=0 && part < 2);
   assert(rowRepresentative[part][0] == SIZE_MAX);
   assert(columnRepresentative[1-part][0] == SIZE_MAX);
 
-  for (size_t row = 0; row < matrix->numRows; ++row)
+  if (parts->crossNonzeros[part] == 0)
+    return false;
+
+  size_t row = parts->rowRepresentative[part];
+  if (row == SIZE_MAX || parts->rowParts[row] != part || parts->rowNonzeros[1-part][row] == 0)
   {
-    if (rowData[row].part == part)
+    for (row = 0; row < parts->numRows; ++row)
     {
-      size_t first = matrix->rowSlice[row];
-      size_t beyond = matrix->rowSlice[row + 1];
-      for (size_t entry = first; entry < beyond; ++entry)
-      {
-        size_t column = matrix->entryColumns[entry];
-        if (columnData[column].part == 1-part)
-        {
-          rowRepresentative[part][0] = row;
-          columnRepresentative[1-part][0] = column;
-          return true;
-        }
-      }
+      if (parts->rowParts[row] == part && parts->rowNonzeros[1-part][row] > 0)
+        break;
     }
+    assert(row < parts->numRows);
+    parts->rowRepresentative[part] = row;
   }
 
+  size_t first = matrix->rowSlice[row];
+  size_t beyond = matrix->rowSlice[row + 1];
+  for (size_t entry = first; entry < beyond; ++entry)
+  {
+    size_t column = matrix->entryColumns[entry];
+    if (parts->columnParts[column] == 1-part)
+    {
+      rowRepresentative[part][0] = row;
+      columnRepresentative[1-part][0] = column;
+      return true;
+    }
+  }
+
+  assert(false);
   return false;
 }
 
@@ -69,7 +263,7 @@ bool findRank1(
  * \brief Checks whether the submatrix with rows assigned to \p part and columns assigned to the other has at least
  *        rank 2.
  *
- * Assumes that \p rowRepresentative already contains the first nonzero row in that matrix.
+ * Assumes that \p rowRepresentative already contains a nonzero row of that submatrix.
  * If the rank is at least 2, \p rowRepresentative and \p columnRepresentative are extended as to indicate a rank-2
  * submatrix.
  */
@@ -77,15 +271,14 @@ bool findRank1(
 static
 bool findRank2(
   CMR_CHRMAT* matrix,                 /**< Matrix. */
-  ElementData* rowData,               /**< Row element data. */
-  ElementData* columnData,            /**< Column element data. */
+  CandidateParts* parts,              /**< Candidate parts. */
   size_t rowRepresentative[2][2],     /**< Row representatives for each part. */
   size_t columnRepresentative[2][2],  /**< Column representatives for each part. */
   short part                          /**< Part to which the investigated rows belong. */
 )
 {
   assert(matrix);
-  assert(rowData);
+  assert(parts);
   assert(rowRepresentative);
   assert(columnRepresentative);
   assert(part >=0 && part < 2);
@@ -96,9 +289,10 @@ bool findRank2(
 
   CMRdbgMsg(14, "findRank2(): first nonzero is in row r%ld.\n", rowRepresentative[part][0]+1);
 
-  for (size_t row = rowRepresentative[part][0] + 1; row < matrix->numRows; ++row)
+  for (size_t row = 0; row < parts->numRows; ++row)
   {
-    if (rowData[row].part == part)
+    /* Rows without nonzeros in the submatrix cannot increase the rank. */
+    if (parts->rowParts[row] == part && row != rowRepresentative[part][0] && parts->rowNonzeros[1-part][row] > 0)
     {
       CMRdbgMsg(14, "findRank2(): processing row r%ld.\n", row+1);
       size_t entry = matrix->rowSlice[row];
@@ -116,7 +310,7 @@ bool findRank2(
         if (column < columnRep)
         {
           CMRdbgMsg(14, "findRank2(): current row has a 1, representative row has a 0.\n");
-          if (columnData[column].part == 1-part)
+          if (parts->columnParts[column] == 1-part)
           {
             CMRdbgMsg(14, "findRank2(): inside submatrix!\n");
             /* New row has a 1-entry but representative does not. */
@@ -134,7 +328,7 @@ bool findRank2(
         else if (columnRep < column)
         {
           CMRdbgMsg(14, "findRank2(): current row has a 0, representative row has a 1.\n");
-          if (columnData[columnRep].part == 1-part)
+          if (parts->columnParts[columnRep] == 1-part)
           {
             CMRdbgMsg(14, "findRank2(): inside submatrix!\n");
             if (!isZero)
@@ -155,7 +349,7 @@ bool findRank2(
         else
         {
           CMRdbgMsg(14, "findRank2(): current row has a 1, representative row has a 1.\n");
-          if (columnData[column].part == 1-part)
+          if (parts->columnParts[column] == 1-part)
           {
             CMRdbgMsg(14, "findRank2(): inside submatrix!\n");
             if (!equalRep)
@@ -192,22 +386,23 @@ bool findRank2(
 static
 bool findRank3(
   CMR_CHRMAT* matrix,                 /**< Matrix. */
-  ElementData* rowData,               /**< Row element data. */
-  ElementData* columnData,            /**< Column element data. */
+  CandidateParts* parts,              /**< Candidate parts. */
   size_t rowRepresentative[2][2],     /**< Row representatives for each part. */
   short part                          /**< Part to which the investigated rows belong. */
 )
 {
   assert(matrix);
-  assert(rowData);
+  assert(parts);
   assert(rowRepresentative);
   assert(part >=0 && part < 2);
   assert(rowRepresentative[part][0] < SIZE_MAX);
   assert(rowRepresentative[part][1] < SIZE_MAX);
 
-  for (size_t row = rowRepresentative[part][1] + 1; row < matrix->numRows; ++row)
+  for (size_t row = 0; row < parts->numRows; ++row)
   {
-    if (rowData[row].part == part)
+    /* The representatives and rows without nonzeros in the submatrix lie in the span. */
+    if (parts->rowParts[row] == part && row != rowRepresentative[part][0] && row != rowRepresentative[part][1]
+      && parts->rowNonzeros[1-part][row] > 0)
     {
       CMRdbgMsg(14, "findRank3(): inspecting row r%ld.\n", row+1);
       size_t entry[3] = {
@@ -233,7 +428,7 @@ bool findRank3(
           minColumn = column[2];
         bool nonzero[3] = { column[0] == minColumn, column[1] == minColumn, column[2] == minColumn };
 
-        if (columnData[minColumn].part == 1-part)
+        if (parts->columnParts[minColumn] == 1-part)
         {
           CMRdbgMsg(14, "findRank3(): nonzeros are (%d,%d,%d).\n", nonzero[0] ? 1 : 0, nonzero[1] ? 1 : 0,
             nonzero[2] ? 1 : 0);
@@ -456,45 +651,20 @@ CMR_ERROR extendMinorSeparation(
   CMR_CHRMAT* transpose,    /**< Transpose of \p matrix. */
   ElementData* rowData,     /**< Row element data. */
   ElementData* columnData,  /**< Column element data. */
-  size_t* partRows[2],      /**< For each part, an array with its already assigned rows. */
-  size_t partNumRows[2],    /**< For each part, the number of already assigned rows. */
-  size_t* partColumns[2],   /**< For each part, an array with its already assigned columns. */
-  size_t partNumColumns[2], /**< For each part, the number of already assigned columns. */
+  CandidateParts* parts,    /**< Already assigned rows and columns. */
   CMR_ELEMENT* queue,       /**< Memory for a queue of elements. */
   CMR_SEPA** pseparation    /**< Pointer for storing the 3-separation or \c NULL if none was found. */
 )
 {
   assert(matrix);
   assert(transpose);
-  assert(partRows);
-  assert(partRows[0]);
-  assert(partRows[1]);
-  assert(partNumRows);
-  assert(partColumns);
-  assert(partColumns[0]);
-  assert(partColumns[1]);
-  assert(partNumColumns);
+  assert(parts);
   assert(queue);
   assert(pseparation);
 
   size_t numRows = matrix->numRows;
   size_t numColumns = matrix->numColumns;
 
-  for (size_t row = 0; row < numRows; ++row)
-    rowData[row].part = -1;
-
-  for (size_t column = 0; column < numColumns; ++column)
-    columnData[column].part = -1;
-
-  /* Set already asigned rows and columns.. */
-  for (short part = 0; part < 2; ++part)
-  {
-    for (size_t r = 0; r < partNumRows[part]; ++r)
-      rowData[partRows[part][r]].part = part;
-    for (size_t c = 0; c < partNumColumns[part]; ++c)
-      columnData[partColumns[part][c]].part = part;
-  }
-
   size_t rowRepresentative[2][2] = { {SIZE_MAX, SIZE_MAX}, {SIZE_MAX, SIZE_MAX} };
   size_t columnRepresentative[2][2] = { {SIZE_MAX, SIZE_MAX}, {SIZE_MAX, SIZE_MAX} };
 
@@ -502,19 +672,19 @@ CMR_ERROR extendMinorSeparation(
   CMRdbgMsg(12, "Checking the ranks for the following matrix:\n");
   CMR_CALL( CMRchrmatPrintDense(cmr, matrix, stdout, '0', true) );
   for (size_t row = 0; row < numRows; ++row)
-    CMRdbgMsg(14, "Initially, row r%ld belongs to part %d.\n", row+1, rowData[row].part);
+    CMRdbgMsg(14, "Initially, row r%ld belongs to part %d.\n", row+1, parts->rowParts[row]);
   for (size_t column = 0; column < numColumns; ++column)
-    CMRdbgMsg(14, "Initially, column c%ld belongs to part %d.\n", column+1, columnData[column].part);
+    CMRdbgMsg(14, "Initially, column c%ld belongs to part %d.\n", column+1, parts->columnParts[column]);
 #endif /* CMR_DEBUG */
 
   size_t totalRank = 0;
-  if (findRank1(matrix, rowData, columnData, rowRepresentative, columnRepresentative, 0))
+  if (findRank1(matrix, parts, rowRepresentative, columnRepresentative, 0))
   {
     CMRdbgMsg(12, "Top-right part has rank at least 1.\n");
-    if (findRank2(matrix, rowData, columnData, rowRepresentative, columnRepresentative, 0))
+    if (findRank2(matrix, parts, rowRepresentative, columnRepresentative, 0))
     {
       CMRdbgMsg(12, "Top-right part has rank at least 2.\n");
-      if (findRank3(matrix, rowData, columnData, rowRepresentative, 0))
+      if (findRank3(matrix, parts, rowRepresentative, 0))
       {
         CMRdbgMsg(12, "Top-right part has rank at least 3.\n");
         return CMR_OKAY;
@@ -532,19 +702,19 @@ CMR_ERROR extendMinorSeparation(
     CMRdbgMsg(12, "Top-right part has rank 0.\n");
   }
 
-  if (findRank1(matrix, rowData, columnData, rowRepresentative, columnRepresentative, 1))
+  if (findRank1(matrix, parts, rowRepresentative, columnRepresentative, 1))
   {
     CMRdbgMsg(12, "Bottom-left part has rank at least 1.\n");
     ++totalRank;
     if (totalRank >= 3)
       return CMR_OKAY;
-    if (findRank2(matrix, rowData, columnData, rowRepresentative, columnRepresentative, 1))
+    if (findRank2(matrix, parts, rowRepresentative, columnRepresentative, 1))
     {
       CMRdbgMsg(12, "Bottom-left part has rank at least 2.\n");
       ++totalRank;
       if (totalRank >= 3)
         return CMR_OKAY;
-      if (findRank3(matrix, rowData, columnData, rowRepresentative, 1))
+      if (findRank3(matrix, parts, rowRepresentative, 1))
       {
         CMRdbgMsg(12, "Bottom-left part has rank at least 3.\n");
         return CMR_OKAY;
@@ -574,6 +744,10 @@ CMR_ERROR extendMinorSeparation(
     columnRepresentative[0][1]+1);
 
   /* Total rank is 2. We now have to determine the types of the unassigned rows. */
+  for (size_t row = 0; row < numRows; ++row)
+    rowData[row].part = parts->rowParts[row];
+  for (size_t column = 0; column < numColumns; ++column)
+    columnData[column].part = parts->columnParts[column];
   for (size_t row = 0; row < matrix->numRows; ++row)
   {
     if (rowData[row].part == -1)
@@ -714,6 +888,251 @@ CMR_ERROR extendMinorSeparation(
   return CMR_OKAY;
 }
 
+#define THREE_SEPARATION_CHUNK_SIZE 64 /**< Number of consecutive candidates that a worker processes at once. */
+
+/**
+ * \brief Shared data for the enumeration of candidate 3-separations along a sequence of nested minors.
+ *
+ * The candidates are numbered in the order of the sequential enumeration. First come the \ref numFirstCandidates
+ * distributions of the elements of the first minor. For each later minor follows a block of candidates, one for each
+ * choice of at most one of the previous minor's elements together with each distribution of the new elements.
+ */
+
+typedef struct
+{
+  CMR_MATROID_DEC* dec;         /**< \brief Decomposition node. */
+  size_t firstMinor;            /**< \brief Index of the first minor with at least 8 elements. */
+  size_t lastMinor;             /**< \brief Index of the first minor that is neither graphic nor cographic. */
+  size_t numFirstCandidates;    /**< \brief Number of candidates for the first minor. */
+  size_t* minorFirstCandidate;  /**< \brief Maps \c firstMinor+1+i to the first candidate of that minor's block. */
+  size_t numCandidates;         /**< \brief Total number of candidates. */
+  size_t nextCandidate;         /**< \brief Next candidate to be processed; accessed atomically. */
+  size_t witnessCandidate;      /**< \brief Smallest candidate that yielded a 3-separation, or \c SIZE_MAX. */
+  CMR_SEPA* separation;         /**< \brief 3-separation of \ref witnessCandidate. */
+  CMR_MUTEX mutex;              /**< \brief Mutex for \ref witnessCandidate and \ref separation. */
+  bool cancel;                  /**< \brief Whether a worker failed; accessed atomically. */
+} ThreeSeparationEnumeration;
+
+/**
+ * \brief Returns \c true if and only if the candidate for the first minor given by \p bits has a first part that
+ *        is not larger than the second.
+ */
+
+static
+bool isFirstMinorCandidateUsed(
+  size_t bits,        /**< Bits indicating the elements of the second part. */
+  size_t numElements  /**< Number of elements of the first minor. */
+)
+{
+  size_t numSecond = 0;
+  for (size_t e = 0; e < numElements; ++e)
+  {
+    if (bits & ((size_t) 1 << e))
+      ++numSecond;
+  }
+  return numElements - numSecond <= numSecond;
+}
+
+/**
+ * \brief Fills the parts of the nested minors matrix according to candidate \p candidate.
+ *
+ * \returns \c false if the candidate is skipped since its first part is too large.
+ */
+
+static
+bool decodeCandidate(
+  ThreeSeparationEnumeration* enumeration,  /**< Enumeration data. */
+  size_t candidate,                         /**< Candidate. */
+  size_t* partRows[2],                      /**< For each part, an array for its rows. */
+  size_t partNumRows[2],                    /**< For each part, the number of its rows. */
+  size_t* partColumns[2],                   /**< For each part, an array for its columns. */
+  size_t partNumColumns[2]                  /**< For each part, the number of its columns. */
+)
+{
+  CMR_MATROID_DEC* dec = enumeration->dec;
+  partNumRows[0] = 0;
+  partNumRows[1] = 0;
+  partNumColumns[0] = 0;
+  partNumColumns[1] = 0;
+
+  if (candidate < enumeration->numFirstCandidates)
+  {
+    /* Distribution of the elements of the first minor. */
+    size_t firstMinorNumRows = dec->nestedMinorsSequenceNumRows[enumeration->firstMinor];
+    size_t firstMinorNumColumns = dec->nestedMinorsSequenceNumColumns[enumeration->firstMinor];
+    size_t bits = candidate;
+    for (size_t row = 0; row < firstMinorNumRows; ++row)
+    {
+      short part = (bits & ((size_t) 1 << row)) ? 1 : 0;
+      partRows[part][partNumRows[part]++] = row;
+    }
+    for (size_t column = 0; column < firstMinorNumColumns; ++column)
+    {
+      short part = (bits & ((size_t) 1 << (firstMinorNumRows + column))) ? 1 : 0;
+      partColumns[part][partNumColumns[part]++] = column;
+    }
+
+    return partNumRows[0] + partNumColumns[0] <= partNumRows[1] + partNumColumns[1];
+  }
+
+  /* Find the block of the minor by binary search. */
+  size_t numBlocks = enumeration->lastMinor - enumeration->firstMinor;
+  size_t lower = 0;
+  size_t upper = numBlocks;
+  while (upper - lower > 1)
+  {
+    size_t middle = (lower + upper) / 2;
+    if (enumeration->minorFirstCandidate[middle] <= candidate)
+      lower = middle;
+    else
+      upper = middle;
+  }
+  size_t minor = enumeration->firstMinor + 1 + lower;
+  size_t local = candidate - enumeration->minorFirstCandidate[lower];
+
+  size_t numOldRows = dec->nestedMinorsSequenceNumRows[minor-1];
+  size_t numOldColumns = dec->nestedMinorsSequenceNumColumns[minor-1];
+  size_t numNewRows = dec->nestedMinorsSequenceNumRows[minor] - numOldRows;
+  size_t numNewColumns = dec->nestedMinorsSequenceNumColumns[minor] - numOldColumns;
+  size_t numDistributions = ((size_t) 1 << (numNewRows + numNewColumns)) - 1; /* Part 0 gets a new element. */
+  size_t old = local / numDistributions;
+  size_t bits = local % numDistributions;
+
+  /* Distribute previous minors' rows and columns to part 1 unless equal to the old element. */
+  for (size_t row = 0; row < numOldRows; ++row)
+  {
+    if (row == old)
+      partRows[0][partNumRows[0]++] = row;
+    else
+      partRows[1][partNumRows[1]++] = row;
+  }
+  for (size_t column = 0; column < numOldColumns; ++column)
+  {
+    if (numOldRows + column == old)
+      partColumns[0][partNumColumns[0]++] = column;
+    else
+      partColumns[1][partNumColumns[1]++] = column;
+  }
+
+  /* Distribute the new rows and columns. */
+  for (size_t newRow = 0; newRow < numNewRows; ++newRow)
+  {
+    short part = (bits & ((size_t) 1 << newRow)) ? 1 : 0;
+    partRows[part][partNumRows[part]++] = numOldRows + newRow;
+  }
+  for (size_t newColumn = 0; newColumn < numNewColumns; ++newColumn)
+  {
+    short part = (bits & ((size_t) 1 << (numNewRows + newColumn))) ? 1 : 0;
+    partColumns[part][partNumColumns[part]++] = numOldColumns + newColumn;
+  }
+
+  return true;
+}
+
+/**
+ * \brief Worker for the enumeration of candidate 3-separations.
+ *
+ * Processes candidates in increasing order, skipping those beyond the smallest one that already yielded a
+ * 3-separation, such that the result equals that of the sequential enumeration.
+ */
+
+static
+CMR_ERROR threeSeparationWorker(
+  CMR* cmr,     /**< \ref CMR environment of the worker. */
+  size_t worker,  /**< Index of the worker. */
+  void* data    /**< Pointer to the \ref ThreeSeparationEnumeration. */
+)
+{
+  CMR_UNUSED(worker);
+
+  ThreeSeparationEnumeration* enumeration = (ThreeSeparationEnumeration*) data;
+  CMR_MATROID_DEC* dec = enumeration->dec;
+
+  ElementData* rowData = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowData, dec->matrix->numRows) );
+  ElementData* columnData = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnData, dec->matrix->numColumns) );
+  size_t* partRows[2] = { NULL, NULL };
+  size_t partNumRows[2];
+  size_t* partColumns[2] = { NULL, NULL };
+  size_t partNumColumns[2];
+  CMR_ELEMENT* queueMemory = NULL;
+  size_t maxNumRows = dec->nestedMinorsSequenceNumRows[enumeration->lastMinor];
+  size_t maxNumColumns = dec->nestedMinorsSequenceNumColumns[enumeration->lastMinor];
+  CMR_CALL( CMRallocStackArray(cmr, &partRows[0], maxNumRows) );
+  CMR_CALL( CMRallocStackArray(cmr, &partRows[1], maxNumRows) );
+  CMR_CALL( CMRallocStackArray(cmr, &partColumns[0], maxNumColumns) );
+  CMR_CALL( CMRallocStackArray(cmr, &partColumns[1], maxNumColumns) );
+  CMR_CALL( CMRallocStackArray(cmr, &queueMemory, dec->matrix->numRows + dec->matrix->numColumns) );
+  CandidateParts parts;
+  CMR_CALL( candidatePartsInit(cmr, &parts, dec->nestedMinorsMatrix, maxNumRows, maxNumColumns) );
+
+  CMR_ERROR error = CMR_OKAY;
+  size_t candidate = 0;
+  size_t chunkBeyond = 0;
+  for (; !CMRatomicLoadFlag(&enumeration->cancel); ++candidate)
+  {
+    /* Consecutive candidates differ in few elements, which keeps the updates of the parts cheap. */
+    if (candidate == chunkBeyond)
+    {
+      candidate = CMRatomicFetchAdd(&enumeration->nextCandidate, THREE_SEPARATION_CHUNK_SIZE);
+      chunkBeyond = candidate + THREE_SEPARATION_CHUNK_SIZE;
+    }
+    if (candidate >= enumeration->numCandidates)
+      break;
+
+    CMRmutexLock(&enumeration->mutex);
+    bool pending = candidate < enumeration->witnessCandidate;
+    CMRmutexUnlock(&enumeration->mutex);
+    if (!pending)
+      break;
+
+    if (!decodeCandidate(enumeration, candidate, partRows, partNumRows, partColumns, partNumColumns))
+      continue;
+
+    CMRdbgMsg(10, "Considering candidate %zu in which the first part has %zu rows and %zu columns.\n", candidate,
+      partNumRows[0], partNumColumns[0]);
+
+    CMR_SEPA* separation = NULL;
+    candidatePartsAssign(&parts, dec->nestedMinorsTranspose, partRows, partNumRows, partColumns, partNumColumns);
+    error = extendMinorSeparation(cmr, dec->nestedMinorsMatrix, dec->nestedMinorsTranspose, rowData, columnData,
+      &parts, queueMemory, &separation);
+    if (error)
+      break;
+
+    if (separation)
+    {
+      CMRmutexLock(&enumeration->mutex);
+      if (candidate < enumeration->witnessCandidate)
+      {
+        CMR_SEPA* previous = enumeration->separation;
+        enumeration->witnessCandidate = candidate;
+        enumeration->separation = separation;
+        separation = previous;
+      }
+      CMRmutexUnlock(&enumeration->mutex);
+      if (separation)
+        error = CMRsepaFree(cmr, &separation);
+      break;
+    }
+  }
+
+  /* A failing worker stops all others. */
+  if (error)
+    CMRatomicStoreFlag(&enumeration->cancel, true);
+
+  CMR_CALL( candidatePartsFree(cmr, &parts) );
+  CMR_CALL( CMRfreeStackArray(cmr, &queueMemory) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partColumns[1]) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partColumns[0]) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partRows[1]) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partRows[0]) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnData) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowData) );
+
+  return error;
+}
+
 CMR_ERROR CMRregularityNestedMinorSequenceSearchThreeSeparation(CMR* cmr, DecompositionTask* task,
   DecompositionQueue* queue)
 {
@@ -750,6 +1169,7 @@ CMR_ERROR CMRregularityNestedMinorSequenceSearchThreeSeparation(CMR* cmr, Decomp
     CMRdbgMsg(8, "-> irregular since fewer than 8 elements in total.\n");
 
     dec->type = CMR_MATROID_DEC_TYPE_IRREGULAR;
+    CMR_CALL( CMRregularityNestedMinorSequenceFindFano(cmr, dec, firstNonCoGraphicMinor) );
 
     /* Free the task. */
     CMR_CALL( CMRregularityTaskFree(cmr, &task) );
@@ -767,6 +1187,7 @@ CMR_ERROR CMRregularityNestedMinorSequenceSearchThreeSeparation(CMR* cmr, Decomp
       firstNonCoGraphicMinorSize);
 
     dec->type = CMR_MATROID_DEC_TYPE_IRREGULAR;
+    CMR_CALL( CMRregularityNestedMinorSequenceFindFano(cmr, dec, firstNonCoGraphicMinor) );
     queue->foundIrregularity = true;
 
     /* Free the task. */
@@ -778,172 +1199,73 @@ CMR_ERROR CMRregularityNestedMinorSequenceSearchThreeSeparation(CMR* cmr, Decomp
   CMRdbgMsg(8, "-> searching for induced 3-separations for minor indices in [%zu,%zu].\n", firstMinor,
     firstNonCoGraphicMinor);
 
-  /* Prepare calls to the separation-extension algorithm. */
-  ElementData* rowData = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &rowData, dec->matrix->numRows) );
-  ElementData* columnData = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &columnData, dec->matrix->numColumns) );
-
   assert(firstMinor <= firstNonCoGraphicMinor);
 
-  size_t* partRows[2] = { NULL, NULL };
-  size_t partNumRows[2];
-  size_t* partColumns[2] = { NULL, NULL };;
-  size_t partNumColumns[2];
-  CMR_ELEMENT* queueMemory = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &partRows[0], dec->nestedMinorsSequenceNumRows[firstNonCoGraphicMinor]) );
-  CMR_CALL( CMRallocStackArray(cmr, &partRows[1], dec->nestedMinorsSequenceNumRows[firstNonCoGraphicMinor]) );
-  CMR_CALL( CMRallocStackArray(cmr, &partColumns[0], dec->nestedMinorsSequenceNumColumns[firstNonCoGraphicMinor]) );
-  CMR_CALL( CMRallocStackArray(cmr, &partColumns[1], dec->nestedMinorsSequenceNumColumns[firstNonCoGraphicMinor]) );
-  CMR_CALL( CMRallocStackArray(cmr, &queueMemory, dec->matrix->numRows + dec->matrix->numColumns) );
-
-  size_t firstMinorNumRows = dec->nestedMinorsSequenceNumRows[firstMinor];
-  size_t firstMinorNumColumns = dec->nestedMinorsSequenceNumColumns[firstMinor];
-
-  CMRdbgMsg(8, "Initial minor has %zu rows and %zu columns.\n", firstMinorNumRows, firstMinorNumColumns);
+  CMRdbgMsg(8, "Initial minor has %zu rows and %zu columns.\n", dec->nestedMinorsSequenceNumRows[firstMinor],
+    dec->nestedMinorsSequenceNumColumns[firstMinor]);
   CMRdbgMsg(8, "First non-(co)graphic minor has %zu rows and %zu columns.\n",
     dec->nestedMinorsSequenceNumRows[firstNonCoGraphicMinor],
     dec->nestedMinorsSequenceNumColumns[firstNonCoGraphicMinor]);
 
+  double enumerationClock = CMRclockNow();
+  CMR_COUNTERS_SAMPLE enumerationSample;
+  CMRcountersStart(cmr, &enumerationSample);
   if (task->stats)
     task->stats->enumerationCount++;
 
-  /* Enumerate all cardinality-at-most-half subsets of the element set of the first minor. */
-  short beyondBits = 1 << (firstMinorNumRows + firstMinorNumColumns);
-  CMR_SEPA* separation = NULL;
-  for (short bits = 0; bits < beyondBits && !separation; ++bits)
+  /* Number the candidates: all subsets of the element set of the first minor with at most half of the elements, then,
+   * for each later minor, all subsets with at most 1 element from the previous minor and at least one new. */
+  ThreeSeparationEnumeration enumeration;
+  enumeration.dec = dec;
+  enumeration.firstMinor = firstMinor;
+  enumeration.lastMinor = firstNonCoGraphicMinor;
+  size_t firstMinorNumElements = dec->nestedMinorsSequenceNumRows[firstMinor]
+    + dec->nestedMinorsSequenceNumColumns[firstMinor];
+  enumeration.numFirstCandidates = (size_t) 1 << firstMinorNumElements;
+  enumeration.minorFirstCandidate = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &enumeration.minorFirstCandidate, firstNonCoGraphicMinor - firstMinor + 1) );
+  enumeration.numCandidates = enumeration.numFirstCandidates;
+  for (size_t minor = firstMinor + 1; minor <= firstNonCoGraphicMinor; ++minor)
   {
-    partNumRows[0] = 0;
-    partNumRows[1] = 0;
-    for (size_t row = 0; row < firstMinorNumRows; ++row)
-    {
-      short part = (bits & (1 << row)) ? 1 : 0;
-      partRows[part][partNumRows[part]++] = row;
-    }
-
-    partNumColumns[0] = 0;
-    partNumColumns[1] = 0;
-    for (size_t column = 0; column < firstMinorNumColumns; ++column)
-    {
-      short part = (bits & (1 << (firstMinorNumRows + column))) ? 1 : 0;
-      partColumns[part][partNumColumns[part]++] = column;
-    }
-    if (partNumRows[0] + partNumColumns[0] > partNumRows[1] + partNumColumns[1])
-      continue;
-
-    CMRdbgMsg(10, "Considering initial minor partition in which the first part has %zu rows and %zu columns.\n",
-      partNumRows[0], partNumColumns[0]);
-
-    if (task->stats)
-      task->stats->enumerationCandidatesCount++;
-
-    CMR_CALL( extendMinorSeparation(cmr, dec->nestedMinorsMatrix, dec->nestedMinorsTranspose, rowData, columnData,
-      partRows, partNumRows, partColumns, partNumColumns, queueMemory, &separation) );
+    enumeration.minorFirstCandidate[minor - firstMinor - 1] = enumeration.numCandidates;
+    size_t numOld = dec->nestedMinorsSequenceNumRows[minor-1] + dec->nestedMinorsSequenceNumColumns[minor-1];
+    size_t numNew = dec->nestedMinorsSequenceNumRows[minor] + dec->nestedMinorsSequenceNumColumns[minor] - numOld;
+    enumeration.numCandidates += (numOld + 1) * (((size_t) 1 << numNew) - 1);
   }
-
-  if (!separation)
+  enumeration.minorFirstCandidate[firstNonCoGraphicMinor - firstMinor] = enumeration.numCandidates;
+  enumeration.nextCandidate = 0;
+  enumeration.witnessCandidate = SIZE_MAX;
+  enumeration.separation = NULL;
+  enumeration.cancel = false;
+  CMRmutexInit(&enumeration.mutex);
+
+  CMR_ERROR error = CMRthreadsRun(cmr, CMRthreadsNumWorkers(cmr, enumeration.numCandidates), threeSeparationWorker,
+    &enumeration);
+
+  CMRmutexFree(&enumeration.mutex);
+  CMR_CALL( CMRfreeStackArray(cmr, &enumeration.minorFirstCandidate) );
+  if (error)
   {
-    /* Enumerate all subsets of elements of later minors that have at most 1 element from the previous minor and
-    * at least one new. */
-
-    for (size_t minor = firstMinor+1; minor <= firstNonCoGraphicMinor && !separation; ++minor)
-    {
-//       double remainingTime = timeLimit - (clock() - time) * 1.0 / CLOCKS_PER_SEC;
-//       if (remainingTime < 0)
-//       {
-//         CMR_CALL( CMRfreeStackArray(cmr, &queueMemory) );
-//         CMR_CALL( CMRfreeStackArray(cmr, &partColumns[1]) );
-//         CMR_CALL( CMRfreeStackArray(cmr, &partColumns[0]) );
-//         CMR_CALL( CMRfreeStackArray(cmr, &partRows[1]) );
-//         CMR_CALL( CMRfreeStackArray(cmr, &partRows[0]) );
-//         CMR_CALL( CMRfreeStackArray(cmr, &columnData) );
-//         CMR_CALL( CMRfreeStackArray(cmr, &rowData) );
-//         return CMR_ERROR_TIMEOUT;
-//       }
-
-      CMRdbgMsg(8, "Next minor has %zu rows and %zu columns.\n", dec->nestedMinorsSequenceNumRows[minor],
-        dec->nestedMinorsSequenceNumColumns[minor]);
-
-      size_t numOldRows = dec->nestedMinorsSequenceNumRows[minor-1];
-      size_t numOldColumns = dec->nestedMinorsSequenceNumColumns[minor-1];
-      for (size_t old = 0; (old <= numOldRows + numOldColumns) && !separation; ++old)
-      {
-        partNumRows[0] = 0;
-        partNumRows[1] = 0;
-        partNumColumns[0] = 0;
-        partNumColumns[1] = 0;
-
-        CMR_ELEMENT oldElement = (old < numOldRows) ? CMRrowToElement(old) :
-          ((old < numOldRows + numOldColumns) ? CMRcolumnToElement(old - numOldRows) : 0 );
-
-        /* Distribute previous minors' rows to part 1 unless equal to oldElement. */
-        for (size_t row = 0; row < numOldRows; ++row)
-        {
-          if (CMRrowToElement(row) == oldElement)
-            partRows[0][partNumRows[0]++] = row;
-          else
-            partRows[1][partNumRows[1]++] = row;
-        }
-
-        /* Distribute previous minors' columns to part 1 unless equal to oldElement. */
-        for (size_t column = 0; column < numOldColumns; ++column)
-        {
-          if (CMRcolumnToElement(column) == oldElement)
-            partColumns[0][partNumColumns[0]++] = column;
-          else
-            partColumns[1][partNumColumns[1]++] = column;
-        }
-
-        CMRdbgMsg(10, "Created partition of previous minors in which the first part has %zu rows and %zu columns.\n",
-          partNumRows[0], partNumColumns[0]);
-
-        /* Enumerate distribution of new elements.
-         * We store the numbers of rows and columns of the old one to skip recalculation. */
-
-        size_t savedPartNumRows[2] = { partNumRows[0], partNumRows[1] };
-        size_t savedPartNumColumns[2] = { partNumColumns[0], partNumColumns[1] };
-        size_t numNewRows = dec->nestedMinorsSequenceNumRows[minor] - dec->nestedMinorsSequenceNumRows[minor-1];
-        size_t numNewColumns = dec->nestedMinorsSequenceNumColumns[minor] - dec->nestedMinorsSequenceNumColumns[minor-1];
-        short beyondBits = (1 << (numNewRows + numNewColumns)) - 1; /* Subtracting 1 ensures that part 0 is non-empty. */
-        for (short bits = 0; bits < beyondBits && !separation; ++bits)
-        {
-          for (size_t newRow = 0; newRow < numNewRows; ++newRow)
-          {
-            size_t row = dec->nestedMinorsSequenceNumRows[minor-1] + newRow;
-            short part = (bits & (1 << newRow)) ? 1 : 0;
-            partRows[part][partNumRows[part]++] = row;
-          }
-
-          for (size_t newColumn = 0; newColumn < numNewColumns; ++newColumn)
-          {
-            size_t column = dec->nestedMinorsSequenceNumColumns[minor-1] + newColumn;
-            short part = (bits & (1 << (numNewRows + newColumn))) ? 1 : 0;
-            partColumns[part][partNumColumns[part]++] = column;
-          }
-
-          /* Skip this distribution if no new element chosen. */
-          CMRdbgMsg(12, "Considering partition in which the first part has %zu rows and %zu columns.\n", partNumRows[0],
-            partNumColumns[0]);
-
-          if (task->stats)
-            task->stats->enumerationCandidatesCount++;
-
-          CMR_CALL( extendMinorSeparation(cmr, dec->nestedMinorsMatrix, dec->nestedMinorsTranspose, rowData, columnData,
-            partRows, partNumRows, partColumns, partNumColumns, queueMemory, &separation) );
-
-          /* Restore distribution of previous minors. */
-          partNumRows[0] = savedPartNumRows[0];
-          partNumRows[1] = savedPartNumRows[1];
-          partNumColumns[0] = savedPartNumColumns[0];
-          partNumColumns[1] = savedPartNumColumns[1];
-        }
-      }
-    }
+    if (enumeration.separation)
+      CMR_CALL( CMRsepaFree(cmr, &enumeration.separation) );
+    return error;
   }
+  CMR_SEPA* separation = enumeration.separation;
 
   if (task->stats)
   {
-//     task->stats->enumerationTime += (clock() - time) * 1.0 / CLOCKS_PER_SEC;
+    /* Count the candidates that the sequential enumeration considers. */
+    size_t beyond = enumeration.witnessCandidate == SIZE_MAX ? enumeration.numCandidates
+      : enumeration.witnessCandidate + 1;
+    for (size_t candidate = 0; candidate < beyond && candidate < enumeration.numFirstCandidates; ++candidate)
+    {
+      if (isFirstMinorCandidateUsed(candidate, firstMinorNumElements))
+        task->stats->enumerationCandidatesCount++;
+    }
+    if (beyond > enumeration.numFirstCandidates)
+      task->stats->enumerationCandidatesCount += beyond - enumeration.numFirstCandidates;
+    task->stats->enumerationTime += CMRclockNow() - enumerationClock;
+    CMRcountersStop(&enumerationSample, &task->stats->enumerationCounters);
   }
 
   if (separation)
@@ -995,7 +1317,7 @@ CMR_ERROR CMRregularityNestedMinorSequenceSearchThreeSeparation(CMR* cmr, Decomp
       CMR_CALL( CMRsepaFree(cmr, &originalSeparation) );
       CMR_CALL( CMRregularityTaskFree(cmr, &task) );
 
-      goto cleanupSearch;
+      goto cleanupSequence;
     }
 
     CMR_CALL( CMRregularityDecomposeThreeSum(cmr, task, queue, originalSeparation) );
@@ -1006,23 +1328,13 @@ CMR_ERROR CMRregularityNestedMinorSequenceSearchThreeSeparation(CMR* cmr, Decomp
   {
     // TODO: Add a dedicated unittest.
     task->dec->type = CMR_MATROID_DEC_TYPE_IRREGULAR;
+    CMR_CALL( CMRregularityNestedMinorSequenceFindFano(cmr, task->dec, firstNonCoGraphicMinor) );
 
     /* Free the task. */
     CMR_CALL( CMRregularityTaskFree(cmr, &task) );
     queue->foundIrregularity = true;
   }
 
-cleanupSearch:
-
-  /* Free working storage. */
-  CMR_CALL( CMRfreeStackArray(cmr, &queueMemory) );
-  CMR_CALL( CMRfreeStackArray(cmr, &partColumns[1]) );
-  CMR_CALL( CMRfreeStackArray(cmr, &partColumns[0]) );
-  CMR_CALL( CMRfreeStackArray(cmr, &partRows[1]) );
-  CMR_CALL( CMRfreeStackArray(cmr, &partRows[0]) );
-  CMR_CALL( CMRfreeStackArray(cmr, &columnData) );
-  CMR_CALL( CMRfreeStackArray(cmr, &rowData) );
-
 cleanupSequence:
 
   /* Free the sequence of nested minors. */
@@ -7,7 +7,6 @@
 #include "env_internal.h"
 #include "matroid_internal.h"
 
-#include <time.h>
 
 CMR_ERROR CMRregularityDecomposeSeriesParallel(CMR* cmr, DecompositionTask* task, DecompositionQueue* queue)
 {
@@ -24,7 +23,7 @@ CMR_ERROR CMRregularityDecomposeSeriesParallel(CMR* cmr, DecompositionTask* task
   CMR_CALL( CMRchrmatPrintDense(cmr, dec->matrix, stndout, '0', true) );
 #endif /* CMR_DEBUG */
 
-  double remainingTime = task->timeLimit - (clock() - task->startClock) * 1.0 / CLOCKS_PER_SEC;
+  double remainingTime = CMRdeadlineRemaining(&task->stepDeadline);
 
   bool isSeriesParallel = true;
   CMR_SP_REDUCTION* reductions = NULL;
@@ -137,6 +136,8 @@ CMR_ERROR CMRregularityDecomposeSeriesParallel(CMR* cmr, DecompositionTask* task
         separation->columnsFlags[CMRelementToColumnIndex(reductions[0].mate)] = CMR_SEPA_FIRST;
       }
 
+      if (!dec->transpose)
+        CMR_CALL( CMRchrmatTranspose(cmr, dec->matrix, &dec->transpose) );
       CMR_CALL( CMRsepaFindBinaryRepresentatives(cmr, separation, dec->matrix, dec->transpose, NULL, NULL) );
       assert(separation->type == CMR_SEPA_TYPE_TWO);
     }
@@ -158,7 +159,7 @@ CMR_ERROR CMRregularityDecomposeSeriesParallel(CMR* cmr, DecompositionTask* task
 
     DecompositionTask* childTasks[2] = { task, NULL };
     CMR_CALL( CMRregularityTaskCreateRoot(cmr, decReduced->children[1], &childTasks[1], task->params, task->stats,
-      task->startClock, task->timeLimit) );
+      task->deadline) );
 
     childTasks[0]->dec = decReduced->children[0];
 
@@ -214,7 +215,7 @@ CMR_ERROR CMRregularityDecomposeSeriesParallel(CMR* cmr, DecompositionTask* task
       CMR_CALL( CMRfreeStackArray(cmr, &originalToReduced) );
     }
 
-    remainingTime = task->timeLimit - (clock() - task->startClock) * 1.0 / CLOCKS_PER_SEC;
+    remainingTime = CMRdeadlineRemaining(&task->stepDeadline);
     task->dec = decReduced;
     decReduced->testedTwoConnected = true;
     decReduced->graphicness = dec->graphicness;
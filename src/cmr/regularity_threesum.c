@@ -3,11 +3,13 @@
 #include <cmr/regular.h>
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "env_internal.h"
 #include "matroid_internal.h"
 #include "regularity_internal.h"
+#include "trace.h"
 
 typedef enum
 {
@@ -201,11 +203,16 @@ CMR_ERROR findSubmatrixCycle(
   return CMR_OKAY;
 }
 
-CMR_ERROR CMRregularityDecomposeThreeSum(
-  CMR* cmr,
-  DecompositionTask* task,
-  DecompositionQueue* queue,
-  CMR_SEPA* separation
+/**
+ * \brief Carries out the work of \ref CMRregularityDecomposeThreeSum.
+ */
+
+static
+CMR_ERROR decomposeThreeSum(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  DecompositionTask* task,    /**< Task to be processed; already removed from the list of unprocessed tasks. */
+  DecompositionQueue* queue,  /**< Queue of unprocessed tasks. */
+  CMR_SEPA* separation        /**< 3-separation. */
 )
 {
   assert(cmr);
@@ -218,6 +225,9 @@ CMR_ERROR CMRregularityDecomposeThreeSum(
   size_t* rowsToChild = NULL;
   size_t* columnsToChild = NULL;
 
+  if (!dec->transpose)
+    CMR_CALL( CMRchrmatTranspose(cmr, dec->matrix, &dec->transpose) );
+
 #if defined(CMR_DEBUG)
   CMRdbgMsg(8, "Processing 3-separation to produce a 3-sum for the following matrix:\n");
   CMRchrmatPrintDense(cmr, dec->matrix, stdout, '0', true);
@@ -552,7 +562,7 @@ cleanup:
   {
     DecompositionTask* childTasks[2] = { task, NULL };
     CMR_CALL( CMRregularityTaskCreateRoot(cmr, dec->children[1], &childTasks[1], task->params, task->stats,
-      task->startClock, task->timeLimit) );
+      task->deadline) );
 
     childTasks[0]->dec = dec->children[0];
     dec->children[0]->testedSeriesParallel = false;
@@ -569,3 +579,25 @@ cleanup:
 
   return CMR_OKAY;
 }
+
+CMR_ERROR CMRregularityDecomposeThreeSum(
+  CMR* cmr,
+  DecompositionTask* task,
+  DecompositionQueue* queue,
+  CMR_SEPA* separation
+)
+{
+  assert(cmr);
+  assert(task);
+
+  if (!CMRtraceEnabled(cmr))
+    return decomposeThreeSum(cmr, task, queue, separation);
+
+  CMR_MATROID_DEC* dec = task->dec;
+  CMRtraceWriteBegin(cmr, "3-sum", "\"node\":\"0x%zx\",\"rows\":%zu,\"columns\":%zu", (size_t) (uintptr_t) dec,
+    dec->numRows, dec->numColumns);
+  CMR_ERROR error = decomposeThreeSum(cmr, task, queue, separation);
+  CMRtraceWriteEnd(cmr, "3-sum");
+
+  return error;
+}
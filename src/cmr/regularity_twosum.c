@@ -0,0 +1,209 @@
+// #define CMR_DEBUG /** Uncomment to debug this file. */
+
+#include "regularity_internal.h"
+
+#include <cmr/separation.h>
+
+#include "env_internal.h"
+#include "matroid_internal.h"
+
+/**
+ * \brief Searches for a cut vertex of the bipartite support graph of \p matrix that yields a 2-separation.
+ *
+ * The graph has a node for each row and each column and an edge for each nonzero. If removing a row (resp. column)
+ * node \f$ v \f$ disconnects a set \f$ K \f$ of nodes from the remaining ones, then the off-diagonal blocks of the
+ * separation \f$ (K, \bar{K}) \f$ are a zero matrix and a part of the row (resp. column) of \f$ v \f$, i.e., it is a
+ * 2-separation if both sides have at least 2 elements. The cut vertices are found by one depth-first search that
+ * computes low points, and among the valid separations the most balanced one is returned.
+ *
+ * Stores in \p *pnodeOrder the preorder of the nodes, where nodes \f$ 0, 1, \dotsc, m-1 \f$ are the rows and the
+ * remaining ones are the columns, and in \p *pfirst and \p *pbeyond the range of the side \f$ K \f$ in this order.
+ * If there is no such separation, then \p *pfirst equals \p *pbeyond.
+ */
+
+static
+CMR_ERROR searchCutVertex(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,   /**< Matrix. */
+  CMR_CHRMAT* transpose,/**< Transpose of \p matrix. */
+  size_t* nodeOrder,    /**< Array of length \f$ m + n \f$ for storing the preorder of the nodes. */
+  size_t* pfirst,       /**< Pointer for storing the first position of \f$ K \f$ in \p nodeOrder. */
+  size_t* pbeyond       /**< Pointer for storing the position beyond \f$ K \f$ in \p nodeOrder. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(transpose);
+
+  size_t numRows = matrix->numRows;
+  size_t numNodes = numRows + matrix->numColumns;
+  *pfirst = 0;
+  *pbeyond = 0;
+
+  size_t* discovery = NULL; /* Preorder index of each node, or SIZE_MAX if not yet discovered. */
+  CMR_CALL( CMRallocStackArray(cmr, &discovery, numNodes) );
+  size_t* low = NULL; /* Smallest preorder index reachable from the subtree via at most one back edge. */
+  CMR_CALL( CMRallocStackArray(cmr, &low, numNodes) );
+  size_t* subtreeSize = NULL; /* Number of nodes in the DFS subtree of each node. */
+  CMR_CALL( CMRallocStackArray(cmr, &subtreeSize, numNodes) );
+  size_t* nextEntry = NULL; /* Next entry of the node's row or column to be scanned. */
+  CMR_CALL( CMRallocStackArray(cmr, &nextEntry, numNodes) );
+  size_t* dfsStack = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &dfsStack, numNodes) );
+
+  for (size_t node = 0; node < numNodes; ++node)
+    discovery[node] = SIZE_MAX;
+
+  size_t bestBalance = 1;
+  size_t numDiscovered = 0;
+  size_t stackSize = 1;
+  dfsStack[0] = 0;
+  discovery[0] = 0;
+  low[0] = 0;
+  subtreeSize[0] = 1;
+  nextEntry[0] = matrix->rowSlice[0];
+  nodeOrder[numDiscovered++] = 0;
+  while (stackSize > 0)
+  {
+    size_t node = dfsStack[stackSize - 1];
+    bool isRow = node < numRows;
+    CMR_CHRMAT* lines = isRow ? matrix : transpose;
+    size_t line = isRow ? node : node - numRows;
+    size_t parent = stackSize >= 2 ? dfsStack[stackSize - 2] : SIZE_MAX;
+
+    if (nextEntry[node] < lines->rowSlice[line + 1])
+    {
+      size_t neighbor = lines->entryColumns[nextEntry[node]] + (isRow ? numRows : 0);
+      nextEntry[node]++;
+      if (discovery[neighbor] == SIZE_MAX)
+      {
+        discovery[neighbor] = numDiscovered;
+        low[neighbor] = numDiscovered;
+        subtreeSize[neighbor] = 1;
+        nextEntry[neighbor] = (neighbor < numRows) ? matrix->rowSlice[neighbor]
+          : transpose->rowSlice[neighbor - numRows];
+        nodeOrder[numDiscovered++] = neighbor;
+        dfsStack[stackSize++] = neighbor;
+      }
+      else if (neighbor != parent && discovery[neighbor] < low[node])
+        low[node] = discovery[neighbor];
+      continue;
+    }
+
+    /* All neighbors are scanned, so we return to the parent. */
+    --stackSize;
+    if (parent == SIZE_MAX)
+      break;
+
+    if (low[node] < low[parent])
+      low[parent] = low[node];
+    subtreeSize[parent] += subtreeSize[node];
+
+    /* The parent separates the subtree of node from the remaining nodes. */
+    if (low[node] >= discovery[parent])
+    {
+      size_t balance = subtreeSize[node] < numNodes - subtreeSize[node] ? subtreeSize[node]
+        : numNodes - subtreeSize[node];
+      if (balance > bestBalance)
+      {
+        CMRdbgMsg(8, "Cut vertex %s%zu separates %zu of %zu nodes.\n", parent < numRows ? "r" : "c",
+          (parent < numRows ? parent : parent - numRows) + 1, subtreeSize[node], numNodes);
+        bestBalance = balance;
+        *pfirst = discovery[node];
+        *pbeyond = discovery[node] + subtreeSize[node];
+      }
+    }
+  }
+
+  /* A disconnected matrix is left to the search for 1-separations. */
+  if (numDiscovered < numNodes)
+    *pbeyond = *pfirst;
+
+  CMR_CALL( CMRfreeStackArray(cmr, &dfsStack) );
+  CMR_CALL( CMRfreeStackArray(cmr, &nextEntry) );
+  CMR_CALL( CMRfreeStackArray(cmr, &subtreeSize) );
+  CMR_CALL( CMRfreeStackArray(cmr, &low) );
+  CMR_CALL( CMRfreeStackArray(cmr, &discovery) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRregularitySearchTwoSum(CMR* cmr, DecompositionTask* task, DecompositionQueue* queue)
+{
+  assert(cmr);
+  assert(task);
+  assert(queue);
+
+  CMR_MATROID_DEC* dec = task->dec;
+  assert(dec);
+  assert(dec->matrix);
+
+#if defined(CMR_DEBUG)
+  CMRdbgMsg(6, "Searching for 2-separations at cut vertices for the following matrix:\n");
+  CMR_CALL( CMRchrmatPrintDense(cmr, dec->matrix, stdout, '0', true) );
+#endif /* CMR_DEBUG */
+
+  dec->testedTwoSum = true;
+
+  size_t numRows = dec->matrix->numRows;
+  size_t numColumns = dec->matrix->numColumns;
+  if (numRows == 0 || numColumns == 0 || numRows + numColumns < 4)
+  {
+    CMRregularityQueueAdd(queue, task);
+    return CMR_OKAY;
+  }
+
+  if (!dec->transpose)
+    CMR_CALL( CMRchrmatTranspose(cmr, dec->matrix, &dec->transpose) );
+
+  size_t* nodeOrder = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &nodeOrder, numRows + numColumns) );
+  size_t first, beyond;
+  CMR_CALL( searchCutVertex(cmr, dec->matrix, dec->transpose, nodeOrder, &first, &beyond) );
+
+  if (first == beyond)
+  {
+    CMRdbgMsg(6, "No cut vertex yields a 2-separation.\n");
+    CMR_CALL( CMRfreeStackArray(cmr, &nodeOrder) );
+    CMRregularityQueueAdd(queue, task);
+    return CMR_OKAY;
+  }
+
+  CMRdbgMsg(6, "Splitting off %zu of %zu rows and columns.\n", beyond - first, numRows + numColumns);
+
+  CMR_SEPA* separation = NULL;
+  CMR_CALL( CMRsepaCreate(cmr, numRows, numColumns, &separation) );
+  for (size_t row = 0; row < numRows; ++row)
+    separation->rowsFlags[row] = CMR_SEPA_FIRST;
+  for (size_t column = 0; column < numColumns; ++column)
+    separation->columnsFlags[column] = CMR_SEPA_FIRST;
+  for (size_t i = first; i < beyond; ++i)
+  {
+    size_t node = nodeOrder[i];
+    if (node < numRows)
+      separation->rowsFlags[node] = CMR_SEPA_SECOND;
+    else
+      separation->columnsFlags[node - numRows] = CMR_SEPA_SECOND;
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &nodeOrder) );
+
+  /* The nonzero off-diagonal block is part of a single row or column, so its ternary rank is 1 as well. */
+  CMR_CALL( CMRsepaFindBinaryRepresentatives(cmr, separation, dec->matrix, dec->transpose, NULL, NULL) );
+  assert(separation->type == CMR_SEPA_TYPE_TWO);
+
+  CMR_CALL( CMRmatroiddecUpdateTwoSum(cmr, dec, separation) );
+  CMR_CALL( CMRsepaFree(cmr, &separation) );
+
+  /* The children of a 2-sum of a connected matroid are connected. */
+  DecompositionTask* childTasks[2] = { task, NULL };
+  CMR_CALL( CMRregularityTaskCreateRoot(cmr, dec->children[1], &childTasks[1], task->params, task->stats,
+    task->deadline) );
+  childTasks[0]->dec = dec->children[0];
+  dec->children[0]->testedTwoConnected = true;
+  dec->children[1]->testedTwoConnected = true;
+
+  CMRregularityQueueAdd(queue, childTasks[0]);
+  CMRregularityQueueAdd(queue, childTasks[1]);
+
+  return CMR_OKAY;
+}
@@ -1,8 +1,9 @@
-#define CMR_DEBUG /* Uncomment to debug this file. */
+// #define CMR_DEBUG /* Uncomment to debug this file. */
 
 #include <cmr/separation.h>
 
 #include "env_internal.h"
+#include "bitset.h"
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -87,226 +88,354 @@ typedef struct
 } ElementData;
 
 /**
- * \brief Compute the binary and ternary of a submatrix of \p matrix (if at most 2).
+ * \brief Defines a function \p NAME that computes the binary rank of a submatrix of \p matrix (if at most 2).
+ *
+ * If \p TERNARY is \c true, the function also maintains the indicators of the ternary span of the representative
+ * vectors, which allows it to find a submatrix with absolute determinant 2. Otherwise, only the supports of the
+ * entries are compared and all ternary bookkeeping compiles away.
+ */
+
+#define COMPUTE_SUBMATRIX_RANK(NAME, TERNARY) \
+static \
+CMR_ERROR NAME( \
+  CMR* cmr,                       /* CMR environment. */ \
+  CMR_CHRMAT* matrix,             /* Matrix. */ \
+  size_t numRows,                 /* Number of rows. */ \
+  size_t* rows,                   /* Array with row indices. */ \
+  bool* columnsConsidered,        /* Array indicating for each column of matrix whether it shall be considered. */ \
+  CMR_SEPA_FLAGS* rowsFlags,      /* Array of length numRows for storing the flags for representatives. */ \
+  size_t* prank,                  /* Pointer for storing the computed rank. */ \
+  CMR_SUBMAT** pviolatorSubmatrix /* Pointer for storing a submatrix of absolute determinant 2 (or NULL). */ \
+) \
+{ \
+  assert(matrix); \
+  assert(rows); \
+  assert(columnsConsidered); \
+  assert(rowsFlags); \
+  assert(TERNARY || !pviolatorSubmatrix); \
+ \
+  size_t rank = 0; \
+  size_t theRows[3]; /* The (up to two) representative rows and the current row. */ \
+  size_t theColumns[3] = { SIZE_MAX, SIZE_MAX, SIZE_MAX }; /* The representative columns and the current one. */ \
+  size_t beyond[3]; \
+  size_t entry[3]; \
+  size_t column[3]; \
+  int8_t values[3] = { INT8_MAX, INT8_MAX, INT8_MAX }; \
+ \
+  CMRdbgMsg(12, #NAME "() for a submatrix with %zu rows.\n", numRows); \
+ \
+  for (size_t r = 0; r < numRows && rank <= 2; ++r) \
+  { \
+    theRows[rank] = rows[r]; \
+ \
+    CMRdbgMsg(14, "Considering row r%zu.\n", rows[r]+1); \
+ \
+    /* Prepare data for iterating simultaneously through all relevant rows. */ \
+    for (size_t i = 0; i <= rank; ++i) \
+    { \
+      beyond[i] = matrix->rowSlice[theRows[i] + 1]; \
+      entry[i] = matrix->rowSlice[theRows[i]]; \
+      column[i] = entry[i] < beyond[i] ? matrix->entryColumns[entry[i]] : SIZE_MAX; \
+    } \
+ \
+    /* Indicators (indexed by the representative vectors). */ \
+    bool zero = true; \
+    bool binary_x = rank >= 1; \
+    bool binary_y = rank >= 2; \
+    bool binary_x_plus_y = rank >= 2; \
+ \
+    bool ternary_x = TERNARY && rank >= 1; \
+    bool ternary_minus_x = TERNARY && rank >= 1; \
+    bool ternary_y = TERNARY && rank >= 2; \
+    size_t ternary_y_column = SIZE_MAX; \
+    bool ternary_minus_y = TERNARY && rank >= 2; \
+    bool ternary_x_plus_y = TERNARY && rank >= 2; \
+    bool ternary_x_minus_y = TERNARY && rank >= 2; \
+    bool ternary_minus_x_plus_y = TERNARY && rank >= 2; \
+    bool ternary_minus_x_minus_y = TERNARY && rank >= 2; \
+ \
+    CMRdbgMsg(16, "Rank = %zu; initial indicators are %d|%d|%d (binary) and %d%d|%d%d|%d%d%d%d (ternary).\n", rank, \
+      binary_x, binary_y, binary_x_plus_y, ternary_x, ternary_minus_x, ternary_y, ternary_minus_y, \
+      ternary_x_plus_y, ternary_x_minus_y, ternary_minus_x_plus_y, ternary_minus_x_minus_y); \
+ \
+    /* Loop over all columns of the representative rows. */ \
+    while ( (rank > 0 && column[0] < SIZE_MAX) || (rank > 1 && column[1] < SIZE_MAX) || (column[rank] < SIZE_MAX) ) \
+    { \
+      /* Which column are we looking at? */ \
+      size_t currentColumn = SIZE_MAX; \
+      for (size_t i = 0; i <= rank; ++i) \
+      { \
+        if (entry[i] < beyond[i] && column[i] < currentColumn) \
+          currentColumn = column[i]; \
+      } \
+      if (currentColumn == SIZE_MAX) \
+        break; \
+ \
+      if (columnsConsidered[currentColumn]) \
+      { \
+        /* Bit i of support indicates a nonzero of the i-th involved row. */ \
+        unsigned int support = 0; \
+        for (size_t i = 0; i <= rank; ++i) \
+        { \
+          values[i] = (column[i] == currentColumn) ? matrix->entryValues[entry[i]] : 0; \
+          support |= (values[i] ? 1U : 0U) << i; \
+        } \
+        unsigned int current = (support >> rank) & 1U; \
+ \
+        if (current) \
+          zero = false; \
+ \
+        /* Update indicators for each vector in the binary span of the found ones. */ \
+        binary_x = binary_x && ((support ^ current) & 1U) == 0; \
+        binary_y = binary_y && (((support >> 1) ^ current) & 1U) == 0; \
+        binary_x_plus_y = binary_x_plus_y && ((support ^ (support >> 1) ^ current) & 1U) == 0; \
+ \
+        if (TERNARY) \
+        { \
+          /* Update indicators for each vector in the ternary span of the found ones. */ \
+          ternary_x = ternary_x && ((values[0] - values[rank]) % 3 == 0); \
+          ternary_minus_x = ternary_minus_x && ((-values[0] - values[rank]) % 3 == 0); \
+          ternary_y = ternary_y && ((values[1] - values[rank]) % 3 == 0); \
+          ternary_minus_y = ternary_minus_y && ((-values[1] - values[rank]) % 3 == 0); \
+          ternary_x_plus_y = ternary_x_plus_y && ((values[0] + values[1] - values[rank]) % 3 == 0); \
+          ternary_x_minus_y = ternary_x_minus_y && ((values[0] - values[1] - values[rank]) % 3 == 0); \
+          ternary_minus_x_plus_y = ternary_minus_x_plus_y && ((-values[0] + values[1] - values[rank]) % 3 == 0); \
+          ternary_minus_x_minus_y = ternary_minus_x_minus_y && ((-values[0] - values[1] - values[rank]) % 3 == 0); \
+        } \
+ \
+        CMRdbgMsg(16, "Considering column c%zu (values %d,%d,%d); indicators are %d|%d|%d (binary) " \
+          "and %d%d|%d%d|%d%d%d%d (ternary).\n", currentColumn+1, values[0], values[1], values[2], \
+          binary_x, binary_y, binary_x_plus_y, ternary_x, ternary_minus_x, ternary_y, ternary_minus_y, \
+          ternary_x_plus_y, ternary_x_minus_y, ternary_minus_x_plus_y, ternary_minus_x_minus_y); \
+ \
+        if (TERNARY && pviolatorSubmatrix) \
+        { \
+          /* Update indicator columns. */ \
+          if ( (ternary_y_column == SIZE_MAX) && binary_y && (!ternary_y || !ternary_minus_y) ) \
+            ternary_y_column = currentColumn; \
+ \
+          if (binary_x && !ternary_x && !ternary_minus_x) \
+          { \
+            CMR_CALL( CMRsubmatCreate(cmr, 2, 2, pviolatorSubmatrix) ); \
+            CMR_SUBMAT* violatorSubmatrix = *pviolatorSubmatrix; \
+            violatorSubmatrix->rows[0] = theRows[0]; \
+            violatorSubmatrix->rows[1] = theRows[rank]; \
+            violatorSubmatrix->columns[0] = theColumns[0]; \
+            violatorSubmatrix->columns[1] = currentColumn; \
+ \
+            CMRdbgMsg(16, "Found 2-by-2 submatrix with absolute determinant 2: r%zu,r%zu,c%zu,c%zu.\n", \
+              theRows[0]+1, theRows[rank]+1, theColumns[0]+1, currentColumn+1); \
+ \
+            *prank = rank; \
+            return CMR_OKAY; \
+          } \
+ \
+          if (binary_y && !ternary_y && !ternary_minus_y) \
+          { \
+            CMR_CALL( CMRsubmatCreate(cmr, 2, 2, pviolatorSubmatrix) ); \
+            CMR_SUBMAT* violatorSubmatrix = *pviolatorSubmatrix; \
+            violatorSubmatrix->rows[0] = theRows[1]; \
+            violatorSubmatrix->rows[1] = theRows[rank]; \
+            violatorSubmatrix->columns[0] = ternary_y_column; \
+            violatorSubmatrix->columns[1] = currentColumn; \
+ \
+            CMRdbgMsg(16, "Found 2-by-2 submatrix with absolute determinant 2: r%zu,r%zu,c%zu,c%zu.\n", \
+              theRows[1]+1, theRows[rank]+1, ternary_y_column+1, currentColumn+1); \
+ \
+            assert(ternary_y_column != currentColumn); \
+ \
+            *prank = rank; \
+            return CMR_OKAY; \
+          } \
+ \
+          if (binary_x_plus_y && !ternary_x_plus_y && !ternary_x_minus_y && !ternary_minus_x_plus_y \
+            && !ternary_minus_x_minus_y) \
+          { \
+            CMR_CALL( CMRsubmatCreate(cmr, 3, 3, pviolatorSubmatrix) ); \
+            CMR_SUBMAT* violatorSubmatrix = *pviolatorSubmatrix; \
+            violatorSubmatrix->rows[0] = theRows[0]; \
+            violatorSubmatrix->rows[1] = theRows[1]; \
+            violatorSubmatrix->rows[2] = theRows[2]; \
+            violatorSubmatrix->columns[0] = theColumns[0]; \
+            violatorSubmatrix->columns[1] = theColumns[1]; \
+            violatorSubmatrix->columns[2] = currentColumn; \
+ \
+            CMRdbgMsg(16, "Found 3-by-3 submatrix with absolute determinant 2: r%zu,r%zu,r%zu,c%zu,c%zu,c%zu.\n", \
+              theRows[0]+1, theRows[1]+1, theRows[2]+1, theColumns[0]+1, theColumns[1]+1, currentColumn+1); \
+ \
+            return CMR_OKAY; \
+          } \
+        } \
+ \
+        /* No need to continue if it increases the rank. */ \
+        if (!zero && !binary_x && !binary_y && !binary_x_plus_y) \
+        { \
+          theColumns[rank] = currentColumn; \
+          break; \
+        } \
+      } \
+ \
+      /* Advance all entries whose column is the current one. */ \
+      for (size_t i = 0; i <= rank; ++i) \
+      { \
+        if (entry[i] < beyond[i] && column[i] == currentColumn) \
+        { \
+          entry[i]++; \
+          column[i] = (entry[i] < beyond[i]) ? matrix->entryColumns[entry[i]] : SIZE_MAX; \
+        } \
+      } \
+    } \
+ \
+    if (zero) \
+    { \
+      CMRdbgMsg(14, "-> zero vector.\n"); \
+    } \
+    else if (binary_x) \
+    { \
+      rowsFlags[r] = CMR_SEPA_FLAG_RANK1; \
+      CMRdbgMsg(14, "-> 1st representative vector.\n"); \
+    } \
+    else if (binary_y) \
+    { \
+      rowsFlags[r] = CMR_SEPA_FLAG_RANK2; \
+      CMRdbgMsg(14, "-> 2nd representative vector.\n"); \
+    } \
+    else if (binary_x_plus_y) \
+    { \
+      rowsFlags[r] = CMR_SEPA_FLAG_RANK1 | CMR_SEPA_FLAG_RANK2; \
+      CMRdbgMsg(14, "-> 1st + 2nd representative vector.\n"); \
+    } \
+    else \
+    { \
+      ++rank; \
+      rowsFlags[r] = (rank == 1) ? CMR_SEPA_FLAG_RANK1 : CMR_SEPA_FLAG_RANK2; \
+      CMRdbgMsg(14, "-> New %s representative vector.\n", rank == 1 ? "1st" : "2nd"); \
+    } \
+  } \
+ \
+  *prank = rank; \
+  return CMR_OKAY; \
+}
+
+COMPUTE_SUBMATRIX_RANK(computeSubmatrixBinaryRank, false)
+COMPUTE_SUBMATRIX_RANK(computeSubmatrixTernaryRank, true)
+
+/**
+ * \brief Computes the binary rank of a submatrix of \p matrix (if at most 2) like \ref computeSubmatrixBinaryRank,
+ *        but compares packed bitsets.
+ *
+ * The considered columns are numbered consecutively, and the supports of the (up to two) representative rows, of
+ * their sum and of the current row are stored as bitsets over these numbers. Each row is then compared to the span
+ * with 64 columns per word operation. If the rows are so sparse that the bitsets have more words than the rows have
+ * nonzeros on average, then \ref computeSubmatrixBinaryRank is used instead.
  */
 
 static
-CMR_ERROR computeSubmatrixRank(
-  CMR* cmr,                       /**< \ref CMR environment. */
-  CMR_CHRMAT* matrix,             /**< Matrix. */
-  size_t numRows,                 /**< Number of rows. */
-  size_t* rows,                   /**< Array with row indices. */
-  bool* columnsConsidered,        /**< Array indicating for each column of \p matrix whether it shall be considered. */
-  CMR_SEPA_FLAGS* rowsFlags,      /**< Array of length \p numRows for storing the flags for representatives. */
-  size_t* prank,                  /**< Pointer for storing the computed rank. */
-  CMR_SUBMAT** pviolatorSubmatrix /**< Pointer for storing a submatrix of absolute determinant 2 (or \c NULL). */
+CMR_ERROR computeSubmatrixBinaryRankBitset(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,         /**< Matrix. */
+  size_t numRows,             /**< Number of rows. */
+  size_t* rows,               /**< Array with row indices. */
+  bool* columnsConsidered,    /**< Array indicating for each column of matrix whether it shall be considered. */
+  CMR_SEPA_FLAGS* rowsFlags,  /**< Array of length \p numRows for storing the flags for representatives. */
+  size_t* prank               /**< Pointer for storing the computed rank. */
 )
 {
+  assert(cmr);
   assert(matrix);
   assert(rows);
   assert(columnsConsidered);
   assert(rowsFlags);
+  assert(prank);
 
-  size_t rank = 0;
-  size_t theRows[3]; /* The (up to two) representative rows and the current row. */
-  size_t theColumns[3] = { SIZE_MAX, SIZE_MAX, SIZE_MAX }; /* The (up to two) representative columns and the current column. */
-  size_t beyond[3];
-  size_t entry[3];
-  size_t column[3];
-  int8_t values[3] = { INT8_MAX, INT8_MAX, INT8_MAX };
+  size_t numBits = 0;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+  {
+    if (columnsConsidered[column])
+      ++numBits;
+  }
+  size_t numWords = (numBits + 63) / 64;
+  size_t numNonzeros = 0;
+  for (size_t r = 0; r < numRows; ++r)
+    numNonzeros += matrix->rowSlice[rows[r] + 1] - matrix->rowSlice[rows[r]];
+  if (numWords == 0 || numWords * numRows > numNonzeros)
+  {
+    CMR_CALL( computeSubmatrixBinaryRank(cmr, matrix, numRows, rows, columnsConsidered, rowsFlags, prank, NULL) );
+    return CMR_OKAY;
+  }
+
+  size_t* columnsBit = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsBit, matrix->numColumns) );
+  numBits = 0;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+    columnsBit[column] = columnsConsidered[column] ? numBits++ : SIZE_MAX;
 
-  CMRdbgMsg(12, "computeSubmatrixRank() for a submatrix with %zu rows.\n", numRows);
+  /* The bitsets of the 1st and 2nd representative, of their sum and of the current row. */
+  uint64_t* words = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &words, 4 * numWords) );
+  uint64_t* x = &words[0];
+  uint64_t* y = &words[numWords];
+  uint64_t* xPlusY = &words[2 * numWords];
+  uint64_t* current = &words[3 * numWords];
 
+  size_t rank = 0;
   for (size_t r = 0; r < numRows && rank <= 2; ++r)
   {
-    theRows[rank] = rows[r];
-
-    CMRdbgMsg(14, "Considering row r%zu.\n", rows[r]+1);
-
-    /* Prepare data for iterating simultaneously through all relevant rows. */
-    for (size_t i = 0; i <= rank; ++i)
+    for (size_t w = 0; w < numWords; ++w)
+      current[w] = 0;
+    size_t row = rows[r];
+    for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
     {
-      beyond[i] = matrix->rowSlice[theRows[i] + 1];
-      entry[i] = matrix->rowSlice[theRows[i]];
-      column[i] = entry[i] < beyond[i] ? matrix->entryColumns[entry[i]] : SIZE_MAX;
+      size_t bit = columnsBit[matrix->entryColumns[e]];
+      if (bit != SIZE_MAX)
+        current[bit / 64] |= 1ULL << (bit % 64);
     }
 
-    /* Indicators (indexed by the representative vectors). */
     bool zero = true;
-    bool binary_x = rank >= 1;
-    bool binary_y = rank >= 2;
-    bool binary_x_plus_y = rank >= 2;
-
-    bool ternary_x = rank >= 1;
-    bool ternary_minus_x = rank >= 1;
-    bool ternary_y = rank >= 2;
-    size_t ternary_y_column = SIZE_MAX;
-    bool ternary_minus_y = rank >= 2;
-    bool ternary_x_plus_y = rank >= 2;
-    bool ternary_x_minus_y = rank >= 2;
-    bool ternary_minus_x_plus_y = rank >= 2;
-    bool ternary_minus_x_minus_y = rank >= 2;
-
-    CMRdbgMsg(16, "Rank = %zu; initial indicators are %d|%d|%d (binary) and %d%d|%d%d|%d%d%d%d (ternary).\n", rank,
-      binary_x, binary_y, binary_x_plus_y, ternary_x, ternary_minus_x, ternary_y, ternary_minus_y,
-      ternary_x_plus_y, ternary_x_minus_y, ternary_minus_x_plus_y, ternary_minus_x_minus_y);
-
-    /* Loop over all columns of the representative rows. */
-    while ( (rank > 0 && column[0] < SIZE_MAX) || (rank > 1 && column[1] < SIZE_MAX) || (column[rank] < SIZE_MAX) )
+    bool isX = rank >= 1;
+    bool isY = rank >= 2;
+    bool isXPlusY = rank >= 2;
+    for (size_t w = 0; w < numWords; ++w)
     {
-      CMRdbgMsg(16, "Iteration:\n");
-      for (size_t i = 0; i <= rank; ++i)
-      {
-        CMRdbgMsg(18, "Entry #%zu is #%zu in [#%zu,#%zu) (c%zu).\n", i, entry[i], matrix->rowSlice[theRows[i]],
-          beyond[i], column[i]+1);
-      }
-
-      /* Which column are we looking at? */
-      size_t currentColumn = SIZE_MAX;
-      for (size_t i = 0; i <= rank; ++i)
-      {
-        if (entry[i] < beyond[i] && column[i] < currentColumn)
-          currentColumn = column[i];
-      }
-      if (currentColumn == SIZE_MAX)
+      zero = zero && !current[w];
+      isX = isX && current[w] == x[w];
+      isY = isY && current[w] == y[w];
+      isXPlusY = isXPlusY && current[w] == xPlusY[w];
+      if (!zero && !isX && !isY && !isXPlusY)
         break;
-
-      if (columnsConsidered[currentColumn])
-      {
-        for (size_t i = 0; i <= rank; ++i)
-          values[i] = (column[i] == currentColumn) ? matrix->entryValues[entry[i]] : 0;
-
-        if (values[rank])
-          zero = false;
-
-        /* Update indicators for each vector in the binary span of the found ones. */
-        binary_x = binary_x && (abs(values[0]) - abs(values[rank]) == 0);
-        binary_y = binary_y && (abs(values[1]) - abs(values[rank]) == 0);
-        binary_x_plus_y = binary_x_plus_y && ((abs(values[0]) + abs(values[1]) - abs(values[rank])) % 2 == 0);
-
-        /* Update indicators for each vector in the ternary span of the found ones. */
-        ternary_x = ternary_x && ((values[0] - values[rank]) % 3 == 0);
-        ternary_minus_x = ternary_minus_x && ((-values[0] - values[rank]) % 3 == 0);
-        ternary_y = ternary_y && ((values[1] - values[rank]) % 3 == 0);
-        ternary_minus_y = ternary_minus_y && ((-values[1] - values[rank]) % 3 == 0);
-        ternary_x_plus_y = ternary_x_plus_y && ((values[0] + values[1] - values[rank]) % 3 == 0);
-        ternary_x_minus_y = ternary_x_minus_y && ((values[0] - values[1] - values[rank]) % 3 == 0);
-        ternary_minus_x_plus_y = ternary_minus_x_plus_y && ((-values[0] + values[1] - values[rank]) % 3 == 0);
-        ternary_minus_x_minus_y = ternary_minus_x_minus_y && ((-values[0] - values[1] - values[rank]) % 3 == 0);
-
-        CMRdbgMsg(16, "Considering column c%zu (values %d,%d,%d); indicators are %d|%d|%d (binary) "
-          "and %d%d|%d%d|%d%d%d%d (ternary).\n", currentColumn+1, values[0], values[1], values[2],
-          binary_x, binary_y, binary_x_plus_y, ternary_x, ternary_minus_x, ternary_y, ternary_minus_y,
-          ternary_x_plus_y, ternary_x_minus_y, ternary_minus_x_plus_y, ternary_minus_x_minus_y);
-
-        /** Update indicator columns. */
-        if ( (ternary_y_column == SIZE_MAX) && binary_y && (!ternary_y || !ternary_minus_y) )
-          ternary_y_column = currentColumn;
-
-        if (pviolatorSubmatrix)
-        {
-          if (binary_x && !ternary_x && !ternary_minus_x)
-          {
-            CMR_CALL( CMRsubmatCreate(cmr, 2, 2, pviolatorSubmatrix) );
-            CMR_SUBMAT* violatorSubmatrix = *pviolatorSubmatrix;
-            violatorSubmatrix->rows[0] = theRows[0];
-            violatorSubmatrix->rows[1] = theRows[rank];
-            violatorSubmatrix->columns[0] = theColumns[0];
-            violatorSubmatrix->columns[1] = currentColumn;
-
-            CMRdbgMsg(16, "Found 2-by-2 submatrix with absolute determinant 2: r%zu,r%zu,c%zu,c%zu.\n",
-              theRows[0]+1, theRows[rank]+1, theColumns[0]+1, currentColumn+1);
-
-            *prank = rank;
-            return CMR_OKAY;
-          }
-
-          if (binary_y && !ternary_y && !ternary_minus_y)
-          {
-            CMR_CALL( CMRsubmatCreate(cmr, 2, 2, pviolatorSubmatrix) );
-            CMR_SUBMAT* violatorSubmatrix = *pviolatorSubmatrix;
-            violatorSubmatrix->rows[0] = theRows[1];
-            violatorSubmatrix->rows[1] = theRows[rank];
-            violatorSubmatrix->columns[0] = ternary_y_column;
-            violatorSubmatrix->columns[1] = currentColumn;
-
-            CMRdbgMsg(16, "Found 2-by-2 submatrix with absolute determinant 2: r%zu,r%zu,c%zu,c%zu.\n",
-              theRows[1]+1, theRows[rank]+1, ternary_y_column+1, currentColumn+1);
-
-            assert(ternary_y_column != currentColumn);
-
-            *prank = rank;
-            return CMR_OKAY;
-          }
-
-          if (binary_x_plus_y && !ternary_x_plus_y && !ternary_x_minus_y && !ternary_minus_x_plus_y
-            && !ternary_minus_x_minus_y)
-          {
-            CMR_CALL( CMRsubmatCreate(cmr, 3, 3, pviolatorSubmatrix) );
-            CMR_SUBMAT* violatorSubmatrix = *pviolatorSubmatrix;
-            violatorSubmatrix->rows[0] = theRows[0];
-            violatorSubmatrix->rows[1] = theRows[1];
-            violatorSubmatrix->rows[2] = theRows[2];
-            violatorSubmatrix->columns[0] = theColumns[0];
-            violatorSubmatrix->columns[1] = theColumns[1];
-            violatorSubmatrix->columns[2] = currentColumn;
-
-            CMRdbgMsg(16, "Found 3-by-3 submatrix with absolute determinant 2: r%zu,r%zu,r%zu,c%zu,c%zu,c%zu.\n",
-              theRows[0]+1, theRows[1]+1, theRows[2]+1, theColumns[0]+1, theColumns[1]+1, currentColumn+1);
-
-            return CMR_OKAY;
-          }
-        }
-
-        /* No need to continue if it increases the rank. */
-        if (!zero && !binary_x && !binary_y && !binary_x_plus_y)
-        {
-          theColumns[rank] = currentColumn;
-          break;
-        }
-      }
-
-      /* Advance all entries whose column is the current one. */
-      CMRdbgMsg(16, "Advancing subset of the entries.\n");
-      for (size_t i = 0; i <= rank; ++i)
-      {
-        if (entry[i] < beyond[i] && column[i] == currentColumn)
-        {
-          entry[i]++;
-          column[i] = (entry[i] < beyond[i]) ? matrix->entryColumns[entry[i]] : SIZE_MAX;
-        }
-      }
     }
 
-    CMRdbgMsg(16, "Completed iteration over rows.\n");
-
     if (zero)
-    {
-      CMRdbgMsg(14, "-> zero vector.\n");
-    }
-    else if (binary_x)
-    {
+      continue;
+    else if (isX)
       rowsFlags[r] = CMR_SEPA_FLAG_RANK1;
-      CMRdbgMsg(14, "-> 1st representative vector.\n");
-    }
-    else if (binary_y)
-    {
+    else if (isY)
       rowsFlags[r] = CMR_SEPA_FLAG_RANK2;
-      CMRdbgMsg(14, "-> 2nd representative vector.\n");
-    }
-    else if (binary_x_plus_y)
-    {
+    else if (isXPlusY)
       rowsFlags[r] = CMR_SEPA_FLAG_RANK1 | CMR_SEPA_FLAG_RANK2;
-      CMRdbgMsg(14, "-> 1st + 2nd representative vector.\n");
-    }
     else
     {
+      if (rank == 0)
+      {
+        for (size_t w = 0; w < numWords; ++w)
+          x[w] = current[w];
+      }
+      else if (rank == 1)
+      {
+        for (size_t w = 0; w < numWords; ++w)
+        {
+          y[w] = current[w];
+          xPlusY[w] = x[w] ^ current[w];
+        }
+      }
       ++rank;
       rowsFlags[r] = (rank == 1) ? CMR_SEPA_FLAG_RANK1 : CMR_SEPA_FLAG_RANK2;
-      CMRdbgMsg(14, "-> New %s representative vector.\n", rank == 1 ? "1st" : "2nd");
     }
   }
 
+  CMR_CALL( CMRfreeStackArray(cmr, &words) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsBit) );
+
   *prank = rank;
   return CMR_OKAY;
 }
@@ -417,8 +546,16 @@ CMR_ERROR findRepresentatives(
 
   size_t rankBottomLeft;
   CMRdbgMsg(10, "Computing bottom-left row-rank...\n");
-  CMR_CALL( computeSubmatrixRank(cmr, matrix, numMajors, majors, minorsConsidered, majorsFlags, &rankBottomLeft,
-    pviolatorSubmatrix) );
+  if (pviolatorSubmatrix)
+  {
+    CMR_CALL( computeSubmatrixTernaryRank(cmr, matrix, numMajors, majors, minorsConsidered, majorsFlags,
+      &rankBottomLeft, pviolatorSubmatrix) );
+  }
+  else
+  {
+    CMR_CALL( computeSubmatrixBinaryRankBitset(cmr, matrix, numMajors, majors, minorsConsidered, majorsFlags,
+      &rankBottomLeft) );
+  }
 
   if (pviolatorSubmatrix && *pviolatorSubmatrix)
   {
@@ -475,8 +612,16 @@ CMR_ERROR findRepresentatives(
 
   size_t rankTopRight;
   CMRdbgMsg(10, "Computing top-right row-rank...\n");
-  CMR_CALL( computeSubmatrixRank(cmr, matrix, numMajors, majors, minorsConsidered, majorsFlags, &rankTopRight,
-    pviolatorSubmatrix) );
+  if (pviolatorSubmatrix)
+  {
+    CMR_CALL( computeSubmatrixTernaryRank(cmr, matrix, numMajors, majors, minorsConsidered, majorsFlags,
+      &rankTopRight, pviolatorSubmatrix) );
+  }
+  else
+  {
+    CMR_CALL( computeSubmatrixBinaryRankBitset(cmr, matrix, numMajors, majors, minorsConsidered, majorsFlags,
+      &rankTopRight) );
+  }
 
   if (pviolatorSubmatrix && *pviolatorSubmatrix)
   {
@@ -530,7 +675,8 @@ CMR_ERROR findRepresentatives(
 
   size_t rank;
   CMRdbgMsg(10, "Computing bottom-left column-rank...\n");
-  CMR_CALL( computeSubmatrixRank(cmr, transpose, numMajors, majors, minorsConsidered, majorsFlags, &rank, NULL) );
+  CMR_CALL( computeSubmatrixBinaryRankBitset(cmr, transpose, numMajors, majors, minorsConsidered, majorsFlags,
+    &rank) );
   CMRdbgMsg(10, "Bottom-left rank is confirmed to be %zu.\n", rank);
   assert(rank == rankBottomLeft);
 
@@ -563,7 +709,8 @@ CMR_ERROR findRepresentatives(
   }
 
   CMRdbgMsg(10, "Computing top-right column-rank...\n");
-  CMR_CALL( computeSubmatrixRank(cmr, transpose, numMajors, majors, minorsConsidered, majorsFlags, &rank, NULL) );
+  CMR_CALL( computeSubmatrixBinaryRankBitset(cmr, transpose, numMajors, majors, minorsConsidered, majorsFlags,
+    &rank) );
   CMRdbgMsg(10, "Top-right rank is confirmed to be %zu.\n", rank);
   assert(rank == rankTopRight);
 
@@ -793,6 +940,172 @@ CMR_ERROR CMRsepaGetProjection(CMR_SEPA* sepa, size_t part, size_t* rowsToPart,
   return CMR_OKAY;
 }
 
+/**
+ * \brief Stores the entries of \p row in the numbered columns as a support plane and a plane of negative entries.
+ *
+ * \returns The number of the first column of \p row that has a number, or \c SIZE_MAX if there is none.
+ */
+
+static
+size_t fillTernaryPlanes(
+  CMR_CHRMAT* matrix, /**< Matrix. */
+  size_t row,         /**< Row of \p matrix. */
+  size_t* columnsBit, /**< Array mapping each column of \p matrix to its number or to \c SIZE_MAX. */
+  size_t numWords,    /**< Number of words of each plane. */
+  uint64_t* support,  /**< Support plane. */
+  uint64_t* negative  /**< Plane of negative entries. */
+)
+{
+  for (size_t w = 0; w < numWords; ++w)
+  {
+    support[w] = 0;
+    negative[w] = 0;
+  }
+
+  size_t firstBit = SIZE_MAX;
+  for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+  {
+    size_t bit = columnsBit[matrix->entryColumns[e]];
+    if (bit == SIZE_MAX)
+      continue;
+
+    if (firstBit == SIZE_MAX)
+      firstBit = bit;
+    support[bit / 64] |= 1ULL << (bit % 64);
+    if (matrix->entryValues[e] < 0)
+      negative[bit / 64] |= 1ULL << (bit % 64);
+  }
+
+  return firstBit;
+}
+
+/**
+ * \brief Checks the rank-1 part of a 2-separation for being ternary using two bitset planes per row.
+ *
+ * The entries of a row in the considered columns are stored as a support plane and a plane of negative entries.
+ * The support of each row of the bottom-left part agrees with that of the representative row, and the row is a
+ * ternary multiple of it if and only if the negative planes differ either nowhere or everywhere on the support.
+ * If the rows are so sparse that the planes have more words than the rows have nonzeros on average, then
+ * \p *pisChecked is set to \c false and nothing else is done.
+ */
+
+static
+CMR_ERROR checkTernaryTwoSeparationBitset(
+  CMR* cmr,                          /**< \ref CMR environment. */
+  CMR_SEPA* sepa,                    /**< Separation of type \ref CMR_SEPA_TYPE_TWO. */
+  CMR_CHRMAT* matrix,                /**< Matrix. */
+  size_t* submatrixRows,             /**< Array mapping a submatrix row to a row of \p matrix. */
+  size_t* columnsToSubmatrixColumn,  /**< Array mapping a column of \p matrix to a column of the submatrix. */
+  size_t representativeSubmatrixRow, /**< Submatrix row of the representative of the bottom-left part. */
+  bool* pisChecked,                  /**< Pointer for storing whether the check was carried out. */
+  bool* pisTernary,                  /**< Pointer for storing whether the check passed. */
+  CMR_SUBMAT** pviolator             /**< Pointer for storing a violator submatrix (may be \c NULL). */
+)
+{
+  assert(cmr);
+  assert(sepa);
+  assert(matrix);
+  assert(pisChecked);
+  assert(pisTernary);
+
+  /* Number the considered columns in the order of the columns of the matrix. */
+  size_t numBits = 0;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+  {
+    size_t submatrixColumn = columnsToSubmatrixColumn[column];
+    if (submatrixColumn != SIZE_MAX && (sepa->columnsFlags[submatrixColumn] & CMR_SEPA_MASK_CHILD) == CMR_SEPA_FIRST)
+      ++numBits;
+  }
+  size_t numWords = (numBits + 63) / 64;
+  size_t numCheckedRows = 0;
+  size_t numNonzeros = 0;
+  for (size_t submatrixRow = 0; submatrixRow < sepa->numRows; ++submatrixRow)
+  {
+    if (sepa->rowsFlags[submatrixRow] == (CMR_SEPA_SECOND | CMR_SEPA_FLAG_RANK1))
+    {
+      size_t row = submatrixRows[submatrixRow];
+      ++numCheckedRows;
+      numNonzeros += matrix->rowSlice[row + 1] - matrix->rowSlice[row];
+    }
+  }
+  *pisChecked = numWords > 0 && numWords * numCheckedRows <= numNonzeros;
+  if (!*pisChecked)
+    return CMR_OKAY;
+
+  size_t* columnsBit = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsBit, matrix->numColumns) );
+  size_t* bitsSubmatrixColumn = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &bitsSubmatrixColumn, numBits) );
+  numBits = 0;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+  {
+    size_t submatrixColumn = columnsToSubmatrixColumn[column];
+    if (submatrixColumn != SIZE_MAX && (sepa->columnsFlags[submatrixColumn] & CMR_SEPA_MASK_CHILD) == CMR_SEPA_FIRST)
+    {
+      bitsSubmatrixColumn[numBits] = submatrixColumn;
+      columnsBit[column] = numBits++;
+    }
+    else
+      columnsBit[column] = SIZE_MAX;
+  }
+
+  /* The support and negative planes of the representative and of the current row. */
+  uint64_t* words = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &words, 4 * numWords) );
+  uint64_t* representativeSupport = &words[0];
+  uint64_t* representativeNegative = &words[numWords];
+  uint64_t* support = &words[2 * numWords];
+  uint64_t* negative = &words[3 * numWords];
+  size_t representativeBit = fillTernaryPlanes(matrix, submatrixRows[representativeSubmatrixRow], columnsBit,
+    numWords, representativeSupport, representativeNegative);
+  assert(representativeBit != SIZE_MAX);
+
+  *pisTernary = true;
+  for (size_t submatrixRow = 0; submatrixRow < sepa->numRows; ++submatrixRow)
+  {
+    /* Skip top-left rows, zero rows and the representative row. */
+    if ((sepa->rowsFlags[submatrixRow] != (CMR_SEPA_SECOND | CMR_SEPA_FLAG_RANK1))
+      || (submatrixRow == representativeSubmatrixRow))
+    {
+      continue;
+    }
+
+    size_t firstBit = fillTernaryPlanes(matrix, submatrixRows[submatrixRow], columnsBit, numWords, support, negative);
+    assert(firstBit != SIZE_MAX);
+
+    /* The first entry determines the scaling, and all other entries must agree up to it. */
+    bool flip = ((negative[firstBit / 64] ^ representativeNegative[firstBit / 64]) >> (firstBit % 64)) & 1U;
+    for (size_t w = 0; w < numWords; ++w)
+    {
+      assert(support[w] == representativeSupport[w]); /* Rank > 1 ??? */
+      uint64_t difference = negative[w] ^ representativeNegative[w] ^ (flip ? representativeSupport[w] : 0);
+      if (difference)
+      {
+        if (pviolator)
+        {
+          CMRdbgMsg(6, "-> not ternary!\n");
+          CMR_CALL( CMRsubmatCreate(cmr, 2, 2, pviolator) );
+          CMR_SUBMAT* violator = *pviolator;
+          violator->rows[0] = representativeSubmatrixRow;
+          violator->rows[1] = submatrixRow;
+          violator->columns[0] = bitsSubmatrixColumn[representativeBit];
+          violator->columns[1] = bitsSubmatrixColumn[64 * w + CMRbitsetLowest(difference)];
+        }
+        *pisTernary = false;
+        goto cleanup;
+      }
+    }
+  }
+
+cleanup:
+
+  CMR_CALL( CMRfreeStackArray(cmr, &words) );
+  CMR_CALL( CMRfreeStackArray(cmr, &bitsSubmatrixColumn) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsBit) );
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Implementation of \p CMRsepaCheckTernary and \p CMRsepaCheckTernarySubmatrix.
  */
@@ -840,6 +1153,12 @@ CMR_ERROR checkTernary(
     }
     assert(representativeSubmatrixRow < SIZE_MAX);
 
+    bool isBitsetChecked;
+    CMR_CALL( checkTernaryTwoSeparationBitset(cmr, sepa, matrix, submatrixRows, columnsToSubmatrixColumn,
+      representativeSubmatrixRow, &isBitsetChecked, pisTernary, pviolator) );
+    if (isBitsetChecked)
+      return CMR_OKAY;
+
     /* We then copy the nonzeros of that rank-1 subpart. */
     int8_t* representativeSubmatrixDense = NULL;
     size_t representativeSubmatrixColumn = SIZE_MAX;
@@ -1703,3 +2022,321 @@ cleanup:
 
   return error;
 }
+
+/**
+ * \brief Row of one of the matrices of a 2-sum tree that is reached from a row of the result, together with the
+ *        product of the marker entries along the tree path.
+ */
+
+typedef struct
+{
+  size_t matrix;  /**< \brief Index of the matrix. */
+  size_t row;     /**< \brief Row of that matrix. */
+  int value;      /**< \brief Product of the marker entries along the path; 1 for the row itself. */
+} TwoSumTreeRow;
+
+/**
+ * \brief Data of \ref CMRtwoSumTree.
+ */
+
+typedef struct
+{
+  size_t numMatrices;             /**< \brief Number of matrices. */
+  CMR_CHRMAT** matrices;          /**< \brief Matrices. */
+  CMR_TWOSUM_EDGE* edges;         /**< \brief Edges. */
+  int8_t characteristic;          /**< \brief Field characteristic. */
+  size_t* rowsStart;              /**< \brief Offset of the rows of each matrix in \ref rowsEdge. */
+  size_t* columnsStart;           /**< \brief Offset of the columns of each matrix in \ref columnsEdge. */
+  size_t* rowsEdge;               /**< \brief Edge of each marker row, or \c SIZE_MAX. */
+  size_t* columnsEdge;            /**< \brief Edge of each marker column, or \c SIZE_MAX. */
+  size_t* columnsResultColumn;    /**< \brief Column of the result of each non-marker column, or \c SIZE_MAX. */
+  TwoSumTreeRow* stack;           /**< \brief Stack for the traversal of the tree. */
+  TwoSumTreeRow* reached;         /**< \brief Rows reached by the traversal. */
+} TwoSumTree;
+
+/**
+ * \brief Returns \p value modulo \p characteristic as for \ref CMRtwoSum.
+ */
+
+static inline
+int twoSumTreeReduce(
+  int value,            /**< Value. */
+  int8_t characteristic /**< Field characteristic. */
+)
+{
+  if (characteristic != 0)
+  {
+    value = value % characteristic;
+    if (value < 0)
+      value += characteristic;
+    if (characteristic == 3 && value == 2)
+      value -= 3;
+  }
+
+  return value;
+}
+
+/**
+ * \brief Counts or writes the nonzeros of the result row that corresponds to \p row of \p matrix.
+ *
+ * The rows of the other matrices that contribute to the result row are found by following the marker columns. They
+ * are sorted by their matrices, such that the nonzeros are written with increasing columns.
+ */
+
+static
+CMR_ERROR twoSumTreeRow(
+  TwoSumTree* tree,     /**< Data of the tree. */
+  size_t matrix,        /**< Index of matrix. */
+  size_t row,           /**< Non-marker row of that matrix. */
+  CMR_CHRMAT* result,   /**< Result matrix for storing the nonzeros, or \c NULL for only counting them. */
+  size_t* pnumNonzeros  /**< Pointer to the number of nonzeros so far, which is increased. */
+)
+{
+  size_t stackSize = 1;
+  tree->stack[0].matrix = matrix;
+  tree->stack[0].row = row;
+  tree->stack[0].value = 1;
+  size_t numReached = 0;
+  while (stackSize > 0)
+  {
+    TwoSumTreeRow current = tree->stack[--stackSize];
+
+    /* Insert into the reached rows, which are kept sorted by their matrices. */
+    size_t position = numReached++;
+    while (position > 0 && tree->reached[position - 1].matrix > current.matrix)
+    {
+      tree->reached[position] = tree->reached[position - 1];
+      --position;
+    }
+    tree->reached[position] = current;
+
+    CMR_CHRMAT* currentMatrix = tree->matrices[current.matrix];
+    size_t* columnsEdge = &tree->columnsEdge[tree->columnsStart[current.matrix]];
+    size_t beyond = currentMatrix->rowSlice[current.row + 1];
+    for (size_t e = currentMatrix->rowSlice[current.row]; e < beyond; ++e)
+    {
+      size_t edge = columnsEdge[currentMatrix->entryColumns[e]];
+      if (edge == SIZE_MAX)
+        continue;
+
+      int value = twoSumTreeReduce(current.value * currentMatrix->entryValues[e], tree->characteristic);
+      if (value == 0)
+        continue;
+      if (value > INT8_MAX || value < INT8_MIN)
+        return CMR_ERROR_OVERFLOW;
+
+      /* The forest ensures that the other matrix was not reached before; its marker is a row. */
+      CMR_TWOSUM_EDGE* twoSumEdge = &tree->edges[edge];
+      bool isFirst = twoSumEdge->first == current.matrix;
+      assert(stackSize < tree->numMatrices);
+      tree->stack[stackSize].matrix = isFirst ? twoSumEdge->second : twoSumEdge->first;
+      tree->stack[stackSize].row = CMRelementToRowIndex(isFirst ? twoSumEdge->secondMarker : twoSumEdge->firstMarker);
+      tree->stack[stackSize].value = value;
+      ++stackSize;
+    }
+  }
+
+  size_t numNonzeros = *pnumNonzeros;
+  for (size_t i = 0; i < numReached; ++i)
+  {
+    TwoSumTreeRow* reached = &tree->reached[i];
+    CMR_CHRMAT* reachedMatrix = tree->matrices[reached->matrix];
+    size_t* columnsResultColumn = &tree->columnsResultColumn[tree->columnsStart[reached->matrix]];
+    size_t beyond = reachedMatrix->rowSlice[reached->row + 1];
+    for (size_t e = reachedMatrix->rowSlice[reached->row]; e < beyond; ++e)
+    {
+      size_t resultColumn = columnsResultColumn[reachedMatrix->entryColumns[e]];
+      if (resultColumn == SIZE_MAX)
+        continue;
+
+      int value = reachedMatrix->entryValues[e];
+      if (i > 0 || reached->value != 1)
+      {
+        value = twoSumTreeReduce(reached->value * value, tree->characteristic);
+        if (value == 0)
+          continue;
+        if (value > INT8_MAX || value < INT8_MIN)
+          return CMR_ERROR_OVERFLOW;
+      }
+
+      if (result)
+      {
+        result->entryColumns[numNonzeros] = resultColumn;
+        result->entryValues[numNonzeros] = value;
+      }
+      ++numNonzeros;
+    }
+  }
+  *pnumNonzeros = numNonzeros;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Checks that \p element is a valid marker of \p matrix and assigns \p edge to it.
+ *
+ * \returns \c false if the marker is invalid or already assigned.
+ */
+
+static
+bool twoSumTreeAssignMarker(
+  TwoSumTree* tree,     /**< Data of the tree. */
+  size_t matrix,        /**< Index of matrix. */
+  CMR_ELEMENT element,  /**< Marker element. */
+  size_t edge           /**< Edge. */
+)
+{
+  size_t* pedge;
+  if (CMRelementIsRow(element) && CMRelementToRowIndex(element) < tree->matrices[matrix]->numRows)
+    pedge = &tree->rowsEdge[tree->rowsStart[matrix] + CMRelementToRowIndex(element)];
+  else if (CMRelementIsColumn(element) && CMRelementToColumnIndex(element) < tree->matrices[matrix]->numColumns)
+    pedge = &tree->columnsEdge[tree->columnsStart[matrix] + CMRelementToColumnIndex(element)];
+  else
+    return false;
+
+  if (*pedge != SIZE_MAX)
+    return false;
+  *pedge = edge;
+
+  return true;
+}
+
+CMR_ERROR CMRtwoSumTree(CMR* cmr, size_t numMatrices, CMR_CHRMAT** matrices, size_t numEdges, CMR_TWOSUM_EDGE* edges,
+  int8_t characteristic, CMR_CHRMAT** presult)
+{
+  assert(cmr);
+  assert(numMatrices == 0 || matrices);
+  assert(numEdges == 0 || edges);
+  assert(presult);
+
+  CMRdbgMsg(0, "CMRtwoSumTree of %zu matrices with %zu edges.\n", numMatrices, numEdges);
+
+  if (numEdges >= numMatrices && numEdges > 0)
+    return CMR_ERROR_INPUT;
+
+  TwoSumTree tree;
+  tree.numMatrices = numMatrices;
+  tree.matrices = matrices;
+  tree.edges = edges;
+  tree.characteristic = characteristic;
+  tree.rowsStart = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.rowsStart, numMatrices + 1) );
+  tree.columnsStart = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.columnsStart, numMatrices + 1) );
+  tree.rowsStart[0] = 0;
+  tree.columnsStart[0] = 0;
+  for (size_t m = 0; m < numMatrices; ++m)
+  {
+    tree.rowsStart[m + 1] = tree.rowsStart[m] + matrices[m]->numRows;
+    tree.columnsStart[m + 1] = tree.columnsStart[m] + matrices[m]->numColumns;
+  }
+  size_t totalRows = tree.rowsStart[numMatrices];
+  size_t totalColumns = tree.columnsStart[numMatrices];
+
+  tree.rowsEdge = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.rowsEdge, totalRows) );
+  for (size_t r = 0; r < totalRows; ++r)
+    tree.rowsEdge[r] = SIZE_MAX;
+  tree.columnsEdge = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.columnsEdge, totalColumns) );
+  for (size_t c = 0; c < totalColumns; ++c)
+    tree.columnsEdge[c] = SIZE_MAX;
+  tree.columnsResultColumn = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.columnsResultColumn, totalColumns) );
+  tree.stack = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.stack, numMatrices) );
+  tree.reached = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &tree.reached, numMatrices) );
+
+  /* Check the markers and check via union-find that the edges form a forest. */
+  CMR_ERROR error = CMR_OKAY;
+  size_t* component = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &component, numMatrices) );
+  for (size_t m = 0; m < numMatrices; ++m)
+    component[m] = m;
+  for (size_t edge = 0; edge < numEdges; ++edge)
+  {
+    CMR_TWOSUM_EDGE* twoSumEdge = &edges[edge];
+    if (twoSumEdge->first >= numMatrices || twoSumEdge->second >= numMatrices
+      || CMRelementIsRow(twoSumEdge->firstMarker) == CMRelementIsRow(twoSumEdge->secondMarker)
+      || !twoSumTreeAssignMarker(&tree, twoSumEdge->first, twoSumEdge->firstMarker, edge)
+      || !twoSumTreeAssignMarker(&tree, twoSumEdge->second, twoSumEdge->secondMarker, edge))
+    {
+      error = CMR_ERROR_INPUT;
+      break;
+    }
+
+    size_t first = twoSumEdge->first;
+    while (component[first] != first)
+      first = component[first] = component[component[first]];
+    size_t second = twoSumEdge->second;
+    while (component[second] != second)
+      second = component[second] = component[component[second]];
+    if (first == second)
+    {
+      error = CMR_ERROR_INPUT;
+      break;
+    }
+    component[first] = second;
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &component) );
+  if (error != CMR_OKAY)
+    goto cleanup;
+
+  /* Number the non-marker rows and columns. */
+  size_t numResultRows = 0;
+  for (size_t r = 0; r < totalRows; ++r)
+  {
+    if (tree.rowsEdge[r] == SIZE_MAX)
+      ++numResultRows;
+  }
+  size_t numResultColumns = 0;
+  for (size_t c = 0; c < totalColumns; ++c)
+    tree.columnsResultColumn[c] = (tree.columnsEdge[c] == SIZE_MAX) ? numResultColumns++ : SIZE_MAX;
+
+  /* Count the nonzeros and then write them. */
+  size_t numNonzeros = 0;
+  for (size_t m = 0; m < numMatrices && error == CMR_OKAY; ++m)
+  {
+    for (size_t row = 0; row < matrices[m]->numRows && error == CMR_OKAY; ++row)
+    {
+      if (tree.rowsEdge[tree.rowsStart[m] + row] == SIZE_MAX)
+        error = twoSumTreeRow(&tree, m, row, NULL, &numNonzeros);
+    }
+  }
+  if (error != CMR_OKAY)
+    goto cleanup;
+
+  CMRdbgMsg(2, "The result is a %zux%zu matrix with %zu nonzeros.\n", numResultRows, numResultColumns, numNonzeros);
+  CMR_CALL( CMRchrmatCreate(cmr, presult, numResultRows, numResultColumns, numNonzeros) );
+  CMR_CHRMAT* result = *presult;
+  size_t resultRow = 0;
+  numNonzeros = 0;
+  for (size_t m = 0; m < numMatrices; ++m)
+  {
+    for (size_t row = 0; row < matrices[m]->numRows; ++row)
+    {
+      if (tree.rowsEdge[tree.rowsStart[m] + row] != SIZE_MAX)
+        continue;
+
+      result->rowSlice[resultRow++] = numNonzeros;
+      CMR_CALL( twoSumTreeRow(&tree, m, row, result, &numNonzeros) );
+    }
+  }
+  result->rowSlice[numResultRows] = numNonzeros;
+  assert(numNonzeros == result->numNonzeros);
+
+  CMRconsistencyAssert( CMRchrmatConsistency(result) );
+
+cleanup:
+
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.reached) );
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.stack) );
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.columnsResultColumn) );
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.columnsEdge) );
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.rowsEdge) );
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.columnsStart) );
+  CMR_CALL( CMRfreeStackArray(cmr, &tree.rowsStart) );
+
+  return error;
+}
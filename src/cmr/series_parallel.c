@@ -8,9 +8,13 @@
 #include "hashtable.h"
 #include "sort.h"
 #include "listmatrix.h"
+#include "threads.h"
+#include "deadline.h"
+#include "counters.h"
 
 #include <stdint.h>
-#include <time.h>
+
+#define HASH_PARALLEL_THRESHOLD (1UL << 18) /**< Minimum number of nonzeros for hashing rows and columns in parallel. */
 
 typedef enum
 {
@@ -46,6 +50,7 @@ CMR_ERROR CMRspStatsInit(CMR_SP_STATISTICS* stats)
   stats->nonbinaryTime = 0.0;
   stats->wheelCount = 0;
   stats->wheelTime = 0.0;
+  CMRcountersInit(&stats->reduceCounters);
 
   return CMR_OKAY;
 }
@@ -61,6 +66,7 @@ CMR_ERROR CMRspStatsPrint(FILE* stream, CMR_SP_STATISTICS* stats, const char* pr
     prefix = "  ";
   }
   fprintf(stream, "%sreduction calls: %ld in %f seconds\n", prefix, (unsigned long)stats->reduceCount, stats->reduceTime);
+  CMRcountersPrint(stream, &stats->reduceCounters, prefix, "reduction calls");
   fprintf(stream, "%swheel searches: %ld in %f seconds\n", prefix, (unsigned long)stats->wheelCount, stats->wheelTime);
   fprintf(stream, "%sternary certificates: %ld in %f seconds\n", prefix, (unsigned long)stats->nonbinaryCount, stats->nonbinaryTime);
   fprintf(stream, "%stotal: %lu in %f seconds\n", prefix, (unsigned long)stats->totalCount, stats->totalTime);
@@ -68,7 +74,41 @@ CMR_ERROR CMRspStatsPrint(FILE* stream, CMR_SP_STATISTICS* stats, const char* pr
   return CMR_OKAY;
 }
 
-static char seriesParallelStringBuffer[32]; /**< Static buffer for \ref CMRspString. */
+CMR_ERROR CMRspStatsPrintJson(FILE* stream, CMR_SP_STATISTICS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"reductions\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->reduceCount,
+    stats->reduceTime);
+  fprintf(stream, ",\"wheel-searches\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->wheelCount,
+    stats->wheelTime);
+  fprintf(stream, ",\"ternary-certificates\":{\"count\":%lu,\"time\":%.9g}", (unsigned long)stats->nonbinaryCount,
+    stats->nonbinaryTime);
+  fprintf(stream, ",\"total\":{\"count\":%lu,\"time\":%.9g}}", (unsigned long)stats->totalCount, stats->totalTime);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRspStatsAdd(CMR_SP_STATISTICS* target, CMR_SP_STATISTICS* source)
+{
+  assert(target);
+  assert(source);
+
+  target->totalCount += source->totalCount;
+  target->totalTime += source->totalTime;
+  target->reduceCount += source->reduceCount;
+  target->reduceTime += source->reduceTime;
+  target->wheelCount += source->wheelCount;
+  target->wheelTime += source->wheelTime;
+  CMRcountersAdd(&target->reduceCounters, &source->reduceCounters);
+  target->nonbinaryCount += source->nonbinaryCount;
+  target->nonbinaryTime += source->nonbinaryTime;
+
+  return CMR_OKAY;
+}
+
+static CMR_THREAD_LOCAL char seriesParallelStringBuffer[32]; /**< Static buffer for \ref CMRspString. */
 
 char* CMRspReductionString(CMR_SP_REDUCTION reduction, char* buffer)
 {
@@ -105,16 +145,47 @@ char* CMRspReductionString(CMR_SP_REDUCTION reduction, char* buffer)
 
 static inline
 void unlinkNonzero(
-    ListMat8Nonzero* nonzero /**< Nonzero to be removed from the linked lists. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  ListMat8Index nonzero         /**< Nonzero to be removed from the linked lists. */
+)
+{
+  assert(listmatrix);
+
+  CMRdbgMsg(4, "Removing r%d,c%d from linked list.\n", listmatrix->row[nonzero]+1, listmatrix->column[nonzero]+1);
+  listmatrix->below[listmatrix->above[nonzero]] = listmatrix->below[nonzero];
+  listmatrix->above[listmatrix->below[nonzero]] = listmatrix->above[nonzero];
+  listmatrix->right[listmatrix->left[nonzero]] = listmatrix->right[nonzero];
+  listmatrix->left[listmatrix->right[nonzero]] = listmatrix->left[nonzero];
+}
+
+/**
+ * \brief Removes the head of \p row from the list of rows.
+ */
+
+static inline
+void unlinkRow(
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  size_t row                    /**< Row to be removed. */
 )
 {
-  assert(nonzero);
+  ListMat8Index head = CMRlistmat8CompactRowHead(listmatrix, row);
+  listmatrix->below[listmatrix->above[head]] = listmatrix->below[head];
+  listmatrix->above[listmatrix->below[head]] = listmatrix->above[head];
+}
 
-  CMRdbgMsg(4, "Removing r%d,c%d from linked list.\n", nonzero->row+1, nonzero->column+1);
-  nonzero->above->below = nonzero->below;
-  nonzero->below->above = nonzero->above;
-  nonzero->left->right = nonzero->right;
-  nonzero->right->left = nonzero->left;
+/**
+ * \brief Removes the head of \p column from the list of columns.
+ */
+
+static inline
+void unlinkColumn(
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  size_t column                 /**< Column to be removed. */
+)
+{
+  ListMat8Index head = CMRlistmat8CompactColumnHead(listmatrix, column);
+  listmatrix->right[listmatrix->left[head]] = listmatrix->right[head];
+  listmatrix->left[listmatrix->right[head]] = listmatrix->left[head];
 }
 
 /**
@@ -139,6 +210,7 @@ CMR_ERROR createElementData(
     elementData[e].hashEntry = SIZE_MAX;
     elementData[e].inQueue = false;
     elementData[e].lastBFS = 0;
+    elementData[e].specialBFS = false;
   }
 
   return CMR_OKAY;
@@ -166,27 +238,131 @@ CMR_ERROR createHashVector(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Data shared by the workers that compute the hashes of rows and columns.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* matrix;       /**< \brief Matrix. */
+  CMR_CHRMAT* transpose;    /**< \brief Transpose of \c matrix. */
+  ListMat8Compact* listmatrix;  /**< \brief List matrix representation. */
+  ElementData* rowData;     /**< \brief Other row element data. */
+  ElementData* columnData;  /**< \brief Other column element data. */
+  long long* hashVector;    /**< \brief Hash vector. */
+  size_t* firstRows;        /**< \brief Array with the first row of each worker, followed by the number of rows. */
+  size_t* firstColumns;     /**< \brief Array with the first column of each worker, followed by the number of
+                             **< columns. */
+} HashWorkerData;
+
+/**
+ * \brief Computes the number of nonzeros and the hash of each row of \p matrix in the range [\p first, \p beyond).
+ *
+ * The nonzeros of each row are processed in the order of \p matrix. Applied to the transpose, this yields the same
+ * hash values for the columns as \ref calcNonzeroCountHashFromMatrix.
+ */
+
+static
+void calcNonzeroCountHashRows(
+  CMR_CHRMAT* matrix,         /**< Matrix. */
+  size_t first,               /**< First row. */
+  size_t beyond,              /**< Beyond the last row. */
+  size_t* numNonzeros,        /**< Array for storing the number of nonzeros of each row. */
+  ElementData* data,          /**< Other element data of the rows. */
+  long long* hashVector       /**< Hash vector. */
+)
+{
+  for (size_t row = first; row < beyond; ++row)
+  {
+    size_t firstEntry = matrix->rowSlice[row];
+    size_t beyondEntry = matrix->rowSlice[row + 1];
+    long long hash = data[row].hashValue;
+    for (size_t e = firstEntry; e < beyondEntry; ++e)
+    {
+      char value = matrix->entryValues[e];
+      assert(value == 1 || value == -1);
+      hash = projectSignedHash(hash + value * hashVector[matrix->entryColumns[e]]);
+    }
+    data[row].hashValue = hash;
+    numNonzeros[row] += beyondEntry - firstEntry;
+  }
+}
+
+/**
+ * \brief Computes the number of nonzeros and the hashes of the rows and columns of a worker.
+ */
+
+static
+CMR_ERROR calcNonzeroCountHashWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref HashWorkerData. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  HashWorkerData* hashData = (HashWorkerData*) data;
+  calcNonzeroCountHashRows(hashData->matrix, hashData->firstRows[worker], hashData->firstRows[worker + 1],
+    hashData->listmatrix->rowNumNonzeros, hashData->rowData, hashData->hashVector);
+  calcNonzeroCountHashRows(hashData->transpose, hashData->firstColumns[worker], hashData->firstColumns[worker + 1],
+    hashData->listmatrix->columnNumNonzeros, hashData->columnData, hashData->hashVector);
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Scan the matrix to compute the number of nonzeros and the hash of each row and each column.
+ *
+ * For large matrices, the rows and columns are processed in parallel, where the columns are processed as the rows of
+ * the transpose. In both cases, the hash values are exactly the same.
  */
 
 static
 CMR_ERROR calcNonzeroCountHashFromMatrix(
   CMR* cmr,                 /**< \ref CMR environment. */
   CMR_CHRMAT* matrix,       /**< Matrix. */
-  ListMat8* listmatrix,     /**< List matrix representation. */
-  ElementData* rowData,     /**< Other row element data. */
+  ListMat8Compact* listmatrix,  /**< List matrix representation. */
+  ElementData* rowData,         /**< Other row element data. */
   ElementData* columnData,  /**< Other column element data. */
   long long* hashVector     /**< Hash vector. */
 )
 {
-  CMR_UNUSED(cmr);
-
   assert(cmr);
   assert(matrix);
   assert(rowData);
   assert(columnData);
 
+  size_t numWorkers = 1;
+  if (matrix->numNonzeros >= HASH_PARALLEL_THRESHOLD)
+    numWorkers = CMRthreadsNumWorkers(cmr, matrix->numNonzeros / (HASH_PARALLEL_THRESHOLD / 4));
+
+  if (numWorkers > 1)
+  {
+    HashWorkerData hashData;
+    hashData.matrix = matrix;
+    hashData.transpose = NULL;
+    hashData.listmatrix = listmatrix;
+    hashData.rowData = rowData;
+    hashData.columnData = columnData;
+    hashData.hashVector = hashVector;
+    hashData.firstRows = NULL;
+    hashData.firstColumns = NULL;
+    CMR_CALL( CMRchrmatTranspose(cmr, matrix, &hashData.transpose) );
+    CMR_CALL( CMRallocBlockArray(cmr, &hashData.firstRows, numWorkers + 1) );
+    CMR_CALL( CMRallocBlockArray(cmr, &hashData.firstColumns, numWorkers + 1) );
+    CMRthreadsSplitRows(matrix->rowSlice, matrix->numRows, NULL, numWorkers, hashData.firstRows);
+    CMRthreadsSplitRows(hashData.transpose->rowSlice, hashData.transpose->numRows, NULL, numWorkers,
+      hashData.firstColumns);
+
+    CMR_CALL( CMRthreadsRun(cmr, numWorkers, calcNonzeroCountHashWorker, &hashData) );
+
+    CMR_CALL( CMRfreeBlockArray(cmr, &hashData.firstColumns) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &hashData.firstRows) );
+    CMR_CALL( CMRchrmatFree(cmr, &hashData.transpose) );
+
+    return CMR_OKAY;
+  }
+
   for (size_t row = 0; row < matrix->numRows; ++row)
   {
     size_t first = matrix->rowSlice[row];
@@ -198,12 +374,12 @@ CMR_ERROR calcNonzeroCountHashFromMatrix(
       assert(value == 1 || value == -1);
 
       /* Update row data. */
-      listmatrix->rowElements[row].numNonzeros++;
+      listmatrix->rowNumNonzeros[row]++;
       long long newHash = projectSignedHash(rowData[row].hashValue + value * hashVector[column]);
       rowData[row].hashValue  = newHash;
 
       /* Update column data. */
-      listmatrix->columnElements[column].numNonzeros++;
+      listmatrix->columnNumNonzeros[column]++;
       newHash = projectSignedHash(columnData[column].hashValue + value * hashVector[row]);
       columnData[column].hashValue = newHash;
     }
@@ -219,10 +395,10 @@ CMR_ERROR calcNonzeroCountHashFromMatrix(
 static
 CMR_ERROR calcBinaryHashFromListMatrix(
   CMR* cmr,                 /**< \ref CMR environment. */
-  ListMat8* listmatrix,   /**< List matrix. */
-  ElementData* rowData,     /**< Other row element data. */
-  ElementData* columnData,  /**< Other column element data. */
-  long long* hashVector     /**< Hash vector. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  ElementData* rowData,         /**< Other row element data. */
+  ElementData* columnData,      /**< Other column element data. */
+  long long* hashVector         /**< Hash vector. */
 )
 {
   CMR_UNUSED(cmr);
@@ -233,25 +409,29 @@ CMR_ERROR calcBinaryHashFromListMatrix(
   assert(columnData);
 
   /* Reset hash values. */
-  for (ListMat8Nonzero* rowHead = listmatrix->anchor.below; rowHead->row != SIZE_MAX; rowHead = rowHead->below)
-    rowData[rowHead->row].hashValue = 0;
-  for (ListMat8Nonzero* columnHead = listmatrix->anchor.right; columnHead->column != SIZE_MAX;
-    columnHead = columnHead->right)
+  ListMat8Index anchor = CMRlistmat8CompactAnchor(listmatrix);
+  for (ListMat8Index rowHead = listmatrix->below[anchor]; rowHead != anchor; rowHead = listmatrix->below[rowHead])
+    rowData[listmatrix->row[rowHead]].hashValue = 0;
+  for (ListMat8Index columnHead = listmatrix->right[anchor]; columnHead != anchor;
+    columnHead = listmatrix->right[columnHead])
   {
-    columnData[columnHead->column].hashValue = 0;
+    columnData[listmatrix->column[columnHead]].hashValue = 0;
   }
 
-  for (ListMat8Nonzero* rowHead = listmatrix->anchor.below; rowHead->row != SIZE_MAX; rowHead = rowHead->below)
+  for (ListMat8Index rowHead = listmatrix->below[anchor]; rowHead != anchor; rowHead = listmatrix->below[rowHead])
   {
-    for (ListMat8Nonzero* nz = rowHead->right; nz != rowHead; nz = nz->right)
+    for (ListMat8Index nz = listmatrix->right[rowHead]; nz != rowHead; nz = listmatrix->right[nz])
     {
+      size_t row = listmatrix->row[nz];
+      size_t column = listmatrix->column[nz];
+
       /* Update row data. */
-      long long newHash = projectSignedHash(rowData[nz->row].hashValue + hashVector[nz->column]);
-      rowData[nz->row].hashValue  = newHash;
+      long long newHash = projectSignedHash(rowData[row].hashValue + hashVector[column]);
+      rowData[row].hashValue  = newHash;
 
       /* Update column data. */
-      newHash = projectSignedHash(columnData[nz->column].hashValue + hashVector[nz->row]);
-      columnData[nz->column].hashValue = newHash;
+      newHash = projectSignedHash(columnData[column].hashValue + hashVector[row]);
+      columnData[column].hashValue = newHash;
     }
   }
 
@@ -266,9 +446,9 @@ static
 CMR_ERROR initializeQueueHashtableFromMatrix(
   CMR* cmr,                               /**< \ref CMR environment. */
   CMR_LISTHASHTABLE* hashtable,           /**< Row or column hashtable. */
-  ListMat8Element* listmatrixElements,  /**< Row or column list matrix elements. */
+  size_t* numNonzeros,                    /**< Number of nonzeros of each row or column. */
   ElementData* data,                      /**< Other row/column data. */
-  size_t sizeData,                        /**< Length of \p ListMatrixElements and \p data. */
+  size_t sizeData,                        /**< Length of \p numNonzeros and \p data. */
   CMR_ELEMENT* queue,                     /**< Queue. */
   size_t* pqueueEnd,                      /**< Pointer to end of queue. */
   bool isRow                              /**< Whether we are deadling with rows. */
@@ -279,10 +459,10 @@ CMR_ERROR initializeQueueHashtableFromMatrix(
 
   for (size_t i = 0; i < sizeData; ++i)
   {
-    CMRdbgMsg(2, "%s %d has %d nonzeros.\n", isRow ? "Row" : "Column", i, listmatrixElements[i].numNonzeros);
+    CMRdbgMsg(2, "%s %d has %d nonzeros.\n", isRow ? "Row" : "Column", i, numNonzeros[i]);
 
     /* Check if it qualifies for addition to the hashtable. */
-    if (listmatrixElements[i].numNonzeros > 1)
+    if (numNonzeros[i] > 1)
     {
       CMR_LISTHASHTABLE_ENTRY entry = CMRlisthashtableFindFirst(hashtable, llabs(data[i].hashValue));
       CMRdbgMsg(2, "Search for hash %ld of %s %d yields entry %d.\n", data[i].hashValue, isRow ? "row" : "column", i, entry);
@@ -311,7 +491,7 @@ static
 CMR_ERROR initializeQueueHashtableFromListMatrix(
   CMR* cmr,                     /**< \ref CMR environment. */
   CMR_LISTHASHTABLE* hashtable, /**< Row or column hashtable. */
-  ListMat8* listmatrix,       /**< List matrix. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
   ElementData* data,            /**< Other row/column data array. */
   CMR_ELEMENT* queue,           /**< Queue. */
   size_t* pqueueEnd,            /**< Pointer to end of queue. */
@@ -323,14 +503,13 @@ CMR_ERROR initializeQueueHashtableFromListMatrix(
   CMRdbgMsg(2, "Initializing queue and hashtable from list representation. Inspecting %s.\n",
     isRow ? "rows" : "columns");
 
-    ListMat8Nonzero* anchor = &listmatrix->anchor;
-
-  for (ListMat8Nonzero* head = isRow ? anchor->below : anchor->right; head != anchor;
-    head = (isRow ? head->below : head->right))
+  ListMat8Index anchor = CMRlistmat8CompactAnchor(listmatrix);
+  for (ListMat8Index head = isRow ? listmatrix->below[anchor] : listmatrix->right[anchor]; head != anchor;
+    head = (isRow ? listmatrix->below[head] : listmatrix->right[head]))
   {
-    size_t i = isRow ? head->row : head->column;
+    size_t i = isRow ? listmatrix->row[head] : listmatrix->column[head];
     CMRdbgMsg(4, "%s %d has %d nonzeros.\n", isRow ? "Row" : "Column", i,
-      isRow ? listmatrix->rowElements[i].numNonzeros : listmatrix->columnElements[i].numNonzeros);
+      isRow ? listmatrix->rowNumNonzeros[i] : listmatrix->columnNumNonzeros[i]);
 
     /* Check if it qualifies for addition to the hashtable. */
     CMR_LISTHASHTABLE_ENTRY entry = CMRlisthashtableFindFirst(hashtable, llabs(data[i].hashValue));
@@ -358,7 +537,7 @@ CMR_ERROR initializeQueueHashtableFromListMatrix(
 
 static
 size_t findCopy(
-  ListMat8Element* listData,  /**< Row/column list data. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
   ElementData* data,            /**< Other row/column data. */
   CMR_LISTHASHTABLE* hashtable, /**< Row/column hashtable. */
   size_t index,                 /**< Index in \p data. */
@@ -378,48 +557,48 @@ size_t findCopy(
     bool negated = true;
     if (isRow)
     {
-            ListMat8Nonzero* nz1 = listData[index].head.right;
-            ListMat8Nonzero* nz2 = listData[collisionIndex].head.right;
+      ListMat8Index nz1 = listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, index)];
+      ListMat8Index nz2 = listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, collisionIndex)];
       while (equal || negated || support)
       {
-        if (nz1->column != nz2->column)
+        if (listmatrix->column[nz1] != listmatrix->column[nz2])
         {
           equal = false;
           negated = false;
           support = false;
           break;
         }
-        if (nz1->column == SIZE_MAX)
+        if (listmatrix->column[nz1] == LISTMAT8_NONE)
           break;
-        if (nz1->value == nz2->value)
+        if (listmatrix->value[nz1] == listmatrix->value[nz2])
           negated = false;
         else
           equal = false;
-        nz1 = nz1->right;
-        nz2 = nz2->right;
+        nz1 = listmatrix->right[nz1];
+        nz2 = listmatrix->right[nz2];
       }
     }
     else
     {
-            ListMat8Nonzero* nz1 = listData[index].head.below;
-            ListMat8Nonzero* nz2 = listData[collisionIndex].head.below;
+      ListMat8Index nz1 = listmatrix->below[CMRlistmat8CompactColumnHead(listmatrix, index)];
+      ListMat8Index nz2 = listmatrix->below[CMRlistmat8CompactColumnHead(listmatrix, collisionIndex)];
       while (equal || negated || support)
       {
-        if (nz1->row != nz2->row)
+        if (listmatrix->row[nz1] != listmatrix->row[nz2])
         {
           equal = false;
           negated = false;
           support = false;
           break;
         }
-        if (nz1->row == SIZE_MAX)
+        if (listmatrix->row[nz1] == LISTMAT8_NONE)
           break;
-        if (nz1->value == nz2->value)
+        if (listmatrix->value[nz1] == listmatrix->value[nz2])
           negated = false;
         else
           equal = false;
-        nz1 = nz1->below;
-        nz2 = nz2->below;
+        nz1 = listmatrix->below[nz1];
+        nz2 = listmatrix->below[nz2];
       }
     }
 
@@ -440,7 +619,7 @@ CMR_ERROR processNonzero(
   CMR_LISTHASHTABLE* hashtable,     /**< Row/column hashtable. */
   long long hashChange,             /**< Modification of the hash value. */
   size_t index,                     /**< Index of row/column. */
-  ListMat8Element* indexListData, /**< Row/column list data. */
+  size_t* indexNumNonzeros,         /**< Pointer to the number of nonzeros of the row/column. */
   ElementData* indexData,           /**< Other row/column data. */
   CMR_ELEMENT* queue,               /**< Queue. */
   size_t* pqueueEnd,                /**< Pointer to end of queue. */
@@ -453,7 +632,7 @@ CMR_ERROR processNonzero(
   assert(hashtable);
   assert(queue);
 
-  indexListData->numNonzeros--;
+  (*indexNumNonzeros)--;
   long long newHash = projectSignedHash(indexData->hashValue + hashChange);
   CMRdbgMsg(4, "Processing nonzero. Old hash is %ld, change is %ld, new hash is %ld.\n", indexData->hashValue,
     hashChange, newHash);
@@ -484,7 +663,7 @@ CMR_ERROR processNonzero(
 static
 CMR_ERROR reduceListMatrix(
   CMR* cmr,                           /**< \ref CMR environment. */
-  ListMat8* listmatrix,               /**< List matrix. */
+  ListMat8Compact* listmatrix,        /**< List matrix. */
   ElementData* rowData,               /**< Row data. */
   ElementData* columnData,            /**< Column data. */
   CMR_LISTHASHTABLE* rowHashtable,    /**< Row hashtable. */
@@ -510,10 +689,11 @@ CMR_ERROR reduceListMatrix(
   {
 #if defined(CMR_DEBUG)
     CMRdbgMsg(0, "\n    Status:\n");
-    for (ListMat8Nonzero* nz = listmatrix->anchor.below; nz != &listmatrix->anchor; nz = nz->below)
+    ListMat8Index anchor = CMRlistmat8CompactAnchor(listmatrix);
+    for (ListMat8Index nz = listmatrix->below[anchor]; nz != anchor; nz = listmatrix->below[nz])
     {
-      size_t row = nz->row;
-      CMRdbgMsg(6, "Row r%d: %d nonzeros, hashed = %s, hash = %ld", row+1, listmatrix->rowElements[row].numNonzeros,
+      size_t row = listmatrix->row[nz];
+      CMRdbgMsg(6, "Row r%d: %d nonzeros, hashed = %s, hash = %ld", row+1, listmatrix->rowNumNonzeros[row],
         rowData[row].hashEntry == SIZE_MAX ? "NO" : "YES", rowData[row].hashValue);
       if (rowData[row].hashEntry != SIZE_MAX)
       {
@@ -523,11 +703,11 @@ CMR_ERROR reduceListMatrix(
       }
       CMRdbgMsg(0, "\n");
     }
-    for (ListMat8Nonzero* nz = listmatrix->anchor.right; nz != &listmatrix->anchor; nz = nz->right)
+    for (ListMat8Index nz = listmatrix->right[anchor]; nz != anchor; nz = listmatrix->right[nz])
     {
-      size_t column = nz->column;
+      size_t column = listmatrix->column[nz];
       CMRdbgMsg(6, "Column c%d: %d nonzeros, hashed = %s, hash = %ld", column+1,
-        listmatrix->columnElements[column].numNonzeros, columnData[column].hashEntry == SIZE_MAX ? "NO" : "YES",
+        listmatrix->columnNumNonzeros[column], columnData[column].hashEntry == SIZE_MAX ? "NO" : "YES",
         columnData[column].hashValue);
       if (columnData[column].hashEntry != SIZE_MAX)
       {
@@ -552,18 +732,18 @@ CMR_ERROR reduceListMatrix(
 
     CMRdbgMsg(2, "Top element is %s %d with %d nonzeros.\n", CMRelementIsRow(element) ? "row" : "column",
       CMRelementIsRow(element) ? CMRelementToRowIndex(element) : CMRelementToColumnIndex(element),
-      CMRelementIsRow(element) ? listmatrix->rowElements[CMRelementToRowIndex(element)].numNonzeros :
-      listmatrix->columnElements[CMRelementToColumnIndex(element)].numNonzeros);
+      CMRelementIsRow(element) ? listmatrix->rowNumNonzeros[CMRelementToRowIndex(element)] :
+      listmatrix->columnNumNonzeros[CMRelementToColumnIndex(element)]);
 
     if (CMRelementIsRow(element))
     {
       /* We consider a row. */
 
       size_t row1 = CMRelementToRowIndex(element);
-      if (listmatrix->rowElements[row1].numNonzeros > 1)
+      if (listmatrix->rowNumNonzeros[row1] > 1)
       {
         rowData[row1].inQueue = false;
-        size_t row2 = findCopy(listmatrix->rowElements, rowData, rowHashtable, row1, true, false);
+        size_t row2 = findCopy(listmatrix, rowData, rowHashtable, row1, true, false);
 
         if (row2 == SIZE_MAX)
         {
@@ -585,22 +765,22 @@ CMR_ERROR reduceListMatrix(
           (*pnumReductions)++;
           (*pnumRowReductions)++;
 
-          for (ListMat8Nonzero* entry = listmatrix->rowElements[row1].head.right; entry->column != SIZE_MAX;
-            entry = entry->right)
+          ListMat8Index head = CMRlistmat8CompactRowHead(listmatrix, row1);
+          for (ListMat8Index entry = listmatrix->right[head]; entry != head; entry = listmatrix->right[entry])
           {
-            CMRdbgMsg(8, "Processing nonzero at column %d.\n", entry->column);
+            size_t column = listmatrix->column[entry];
+            CMRdbgMsg(8, "Processing nonzero at column %d.\n", column);
 
-            unlinkNonzero(entry);
-            CMR_CALL( processNonzero(cmr, columnHashtable, -entryToHash[entry->row] * entry->value, entry->column,
-              &listmatrix->columnElements[entry->column], &columnData[entry->column], queue, pqueueEnd, queueMemory, false) );
+            unlinkNonzero(listmatrix, entry);
+            CMR_CALL( processNonzero(cmr, columnHashtable, -entryToHash[row1] * listmatrix->value[entry], column,
+              &listmatrix->columnNumNonzeros[column], &columnData[column], queue, pqueueEnd, queueMemory, false) );
           }
-          listmatrix->rowElements[row1].numNonzeros = 0;
+          listmatrix->rowNumNonzeros[row1] = 0;
           rowData[row1].lastBFS = -2;
-          listmatrix->rowElements[row1].head.above->below = listmatrix->rowElements[row1].head.below;
-          listmatrix->rowElements[row1].head.below->above = listmatrix->rowElements[row1].head.above;
+          unlinkRow(listmatrix, row1);
 
-          assert(listmatrix->rowElements[row1].head.left == &listmatrix->rowElements[row1].head);
-          assert(listmatrix->rowElements[row1].head.right == &listmatrix->rowElements[row1].head);
+          assert(listmatrix->left[head] == head);
+          assert(listmatrix->right[head] == head);
         }
       }
       else
@@ -612,20 +792,20 @@ CMR_ERROR reduceListMatrix(
           return CMR_OKAY;
         }
 
-        CMRdbgMsg(4, "Processing %s row %d.\n", listmatrix->rowElements[row1].numNonzeros == 0 ? "zero" : "unit", row1);
+        CMRdbgMsg(4, "Processing %s row %d.\n", listmatrix->rowNumNonzeros[row1] == 0 ? "zero" : "unit", row1);
 
         rowData[row1].inQueue = false;
-        if (listmatrix->rowElements[row1].numNonzeros)
+        if (listmatrix->rowNumNonzeros[row1])
         {
-                    ListMat8Nonzero* entry = listmatrix->rowElements[row1].head.right;
-          size_t column = entry->column;
+          ListMat8Index entry = listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, row1)];
+          size_t column = listmatrix->column[entry];
 
           CMRdbgMsg(4, "Processing unit row %d with 1 in column %d.\n", row1, column);
 
-          unlinkNonzero(entry);
-          listmatrix->rowElements[row1].numNonzeros--;
-          CMR_CALL( processNonzero(cmr, columnHashtable, -entryToHash[entry->row] * entry->value, column,
-            &listmatrix->columnElements[column], &columnData[column], queue, pqueueEnd, queueMemory, false) );
+          unlinkNonzero(listmatrix, entry);
+          listmatrix->rowNumNonzeros[row1]--;
+          CMR_CALL( processNonzero(cmr, columnHashtable, -entryToHash[row1] * listmatrix->value[entry], column,
+            &listmatrix->columnNumNonzeros[column], &columnData[column], queue, pqueueEnd, queueMemory, false) );
           reductions[*pnumReductions].mate = CMRcolumnToElement(column);
         }
         else
@@ -634,8 +814,7 @@ CMR_ERROR reduceListMatrix(
         (*pnumReductions)++;
         (*pnumRowReductions)++;
         rowData[row1].lastBFS = -2;
-        listmatrix->rowElements[row1].head.above->below = listmatrix->rowElements[row1].head.below;
-        listmatrix->rowElements[row1].head.below->above = listmatrix->rowElements[row1].head.above;
+        unlinkRow(listmatrix, row1);
       }
     }
     else
@@ -643,10 +822,10 @@ CMR_ERROR reduceListMatrix(
       /* We consider a column. */
 
       size_t column1 = CMRelementToColumnIndex(element);
-      if (listmatrix->columnElements[column1].numNonzeros > 1)
+      if (listmatrix->columnNumNonzeros[column1] > 1)
       {
         columnData[column1].inQueue = false;
-        size_t column2 = findCopy(listmatrix->columnElements, columnData, columnHashtable, column1, false, false);
+        size_t column2 = findCopy(listmatrix, columnData, columnHashtable, column1, false, false);
 
         if (column2 == SIZE_MAX)
         {
@@ -670,21 +849,21 @@ CMR_ERROR reduceListMatrix(
           (*pnumColumnReductions)++;
           columnData[column1].lastBFS = -2;
 
-          for (ListMat8Nonzero* entry = listmatrix->columnElements[column1].head.below; entry->row != SIZE_MAX;
-            entry = entry->below)
+          ListMat8Index head = CMRlistmat8CompactColumnHead(listmatrix, column1);
+          for (ListMat8Index entry = listmatrix->below[head]; entry != head; entry = listmatrix->below[entry])
           {
-            CMRdbgMsg(8, "Processing nonzero at row %d.\n", entry->row);
+            size_t row = listmatrix->row[entry];
+            CMRdbgMsg(8, "Processing nonzero at row %d.\n", row);
 
-            unlinkNonzero(entry);
-            CMR_CALL( processNonzero(cmr, rowHashtable, -entryToHash[entry->column] * entry->value, entry->row,
-              &listmatrix->rowElements[entry->row], &rowData[entry->row], queue, pqueueEnd, queueMemory, true) );
+            unlinkNonzero(listmatrix, entry);
+            CMR_CALL( processNonzero(cmr, rowHashtable, -entryToHash[column1] * listmatrix->value[entry], row,
+              &listmatrix->rowNumNonzeros[row], &rowData[row], queue, pqueueEnd, queueMemory, true) );
           }
-          listmatrix->columnElements[column1].numNonzeros = 0;
-          listmatrix->columnElements[column1].head.left->right = listmatrix->columnElements[column1].head.right;
-          listmatrix->columnElements[column1].head.right->left = listmatrix->columnElements[column1].head.left;
+          listmatrix->columnNumNonzeros[column1] = 0;
+          unlinkColumn(listmatrix, column1);
 
-          assert(listmatrix->columnElements[column1].head.above == &listmatrix->columnElements[column1].head);
-          assert(listmatrix->columnElements[column1].head.below == &listmatrix->columnElements[column1].head);
+          assert(listmatrix->above[head] == head);
+          assert(listmatrix->below[head] == head);
         }
       }
       else
@@ -697,20 +876,20 @@ CMR_ERROR reduceListMatrix(
         }
 
         CMRdbgMsg(4, "Processing %s column %d.\n",
-          listmatrix->columnElements[column1].numNonzeros == 0 ? "zero" : "unit", column1);
+          listmatrix->columnNumNonzeros[column1] == 0 ? "zero" : "unit", column1);
 
         columnData[column1].inQueue = false;
-        if (listmatrix->columnElements[column1].numNonzeros)
+        if (listmatrix->columnNumNonzeros[column1])
         {
-                    ListMat8Nonzero* entry = listmatrix->columnElements[column1].head.below;
-          size_t row = entry->row;
+          ListMat8Index entry = listmatrix->below[CMRlistmat8CompactColumnHead(listmatrix, column1)];
+          size_t row = listmatrix->row[entry];
 
           CMRdbgMsg(4, "Processing unit column %d with 1 in row %d.\n", column1, row);
 
-          unlinkNonzero(entry);
-          listmatrix->columnElements[column1].numNonzeros--;
-          CMR_CALL( processNonzero(cmr, rowHashtable, -entryToHash[entry->column] * entry->value, row,
-            &listmatrix->rowElements[row], &rowData[row], queue, pqueueEnd, queueMemory, true) );
+          unlinkNonzero(listmatrix, entry);
+          listmatrix->columnNumNonzeros[column1]--;
+          CMR_CALL( processNonzero(cmr, rowHashtable, -entryToHash[column1] * listmatrix->value[entry], row,
+            &listmatrix->rowNumNonzeros[row], &rowData[row], queue, pqueueEnd, queueMemory, true) );
           reductions[*pnumReductions].mate = CMRrowToElement(row);
         }
         else
@@ -719,8 +898,7 @@ CMR_ERROR reduceListMatrix(
         (*pnumReductions)++;
         (*pnumColumnReductions)++;
         columnData[column1].lastBFS = -2;
-        listmatrix->columnElements[column1].head.left->right = listmatrix->columnElements[column1].head.right;
-        listmatrix->columnElements[column1].head.right->left = listmatrix->columnElements[column1].head.left;
+        unlinkColumn(listmatrix, column1);
       }
     }
   }
@@ -736,7 +914,7 @@ CMR_ERROR reduceListMatrix(
 static
 CMR_ERROR extractNonbinarySubmatrix(
   CMR* cmr,                           /**< \ref CMR environment. */
-  ListMat8* listmatrix,             /**< List matrix. */
+  ListMat8Compact* listmatrix,        /**< List matrix. */
   ElementData* rowData,               /**< Row data. */
   ElementData* columnData,            /**< Column data. */
   CMR_LISTHASHTABLE* rowHashtable,    /**< Row hashtable. */
@@ -780,9 +958,9 @@ CMR_ERROR extractNonbinarySubmatrix(
       /* We consider a row. */
 
       size_t row1 = CMRelementToRowIndex(element);
-      assert(listmatrix->rowElements[row1].numNonzeros > 1);
+      assert(listmatrix->rowNumNonzeros[row1] > 1);
       rowData[row1].inQueue = false;
-      size_t row2 = findCopy(listmatrix->rowElements, rowData, rowHashtable, row1, true, true);
+      size_t row2 = findCopy(listmatrix, rowData, rowHashtable, row1, true, true);
 
       if (row2 == SIZE_MAX)
       {
@@ -796,22 +974,22 @@ CMR_ERROR extractNonbinarySubmatrix(
         /* We found a row copy. */
         size_t column1 = SIZE_MAX;
         size_t column2 = SIZE_MAX;
-                ListMat8Nonzero* nz1 = listmatrix->rowElements[row1].head.right;
-                ListMat8Nonzero* nz2 = listmatrix->rowElements[row2].head.right;
+        ListMat8Index nz1 = listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, row1)];
+        ListMat8Index nz2 = listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, row2)];
         while (column1 == SIZE_MAX || column2 == SIZE_MAX)
         {
-          if (nz1->value == nz2->value)
+          if (listmatrix->value[nz1] == listmatrix->value[nz2])
           {
             if (column1 == SIZE_MAX)
-              column1 = nz1->column;
+              column1 = listmatrix->column[nz1];
           }
           else
           {
             if (column2 == SIZE_MAX)
-              column2 = nz1->column;
+              column2 = listmatrix->column[nz1];
           }
-          nz1 = nz1->right;
-          nz2 = nz2->right;
+          nz1 = listmatrix->right[nz1];
+          nz2 = listmatrix->right[nz2];
         }
 
         CMR_CALL( CMRsubmatCreate(cmr, 2, 2, pviolatorSubmatrix) );
@@ -828,9 +1006,9 @@ CMR_ERROR extractNonbinarySubmatrix(
       /* We consider a column. */
 
       size_t column1 = CMRelementToColumnIndex(element);
-      assert(listmatrix->columnElements[column1].numNonzeros > 1);
+      assert(listmatrix->columnNumNonzeros[column1] > 1);
       columnData[column1].inQueue = false;
-      size_t column2 = findCopy(listmatrix->columnElements, columnData, columnHashtable, column1, false, true);
+      size_t column2 = findCopy(listmatrix, columnData, columnHashtable, column1, false, true);
 
       if (column2 == SIZE_MAX)
       {
@@ -845,22 +1023,22 @@ CMR_ERROR extractNonbinarySubmatrix(
         /* We found a column copy. */
         size_t row1 = SIZE_MAX;
         size_t row2 = SIZE_MAX;
-                ListMat8Nonzero* nz1 = listmatrix->columnElements[column1].head.below;
-                ListMat8Nonzero* nz2 = listmatrix->columnElements[column2].head.below;
+        ListMat8Index nz1 = listmatrix->below[CMRlistmat8CompactColumnHead(listmatrix, column1)];
+        ListMat8Index nz2 = listmatrix->below[CMRlistmat8CompactColumnHead(listmatrix, column2)];
         while (row1 == SIZE_MAX || row2 == SIZE_MAX)
         {
-          if (nz1->value == nz2->value)
+          if (listmatrix->value[nz1] == listmatrix->value[nz2])
           {
             if (row1 == SIZE_MAX)
-              row1 = nz1->row;
+              row1 = listmatrix->row[nz1];
           }
           else
           {
             if (row2 == SIZE_MAX)
-              row2 = nz1->row;
+              row2 = listmatrix->row[nz1];
           }
-          nz1 = nz1->below;
-          nz2 = nz2->below;
+          nz1 = listmatrix->below[nz1];
+          nz2 = listmatrix->below[nz2];
         }
 
         CMR_CALL( CMRsubmatCreate(cmr, 2, 2, pviolatorSubmatrix) );
@@ -881,8 +1059,7 @@ static
 CMR_ERROR breadthFirstSearch(
   CMR* cmr,                           /**< \ref CMR environment. */
   int currentBFS,                     /**< Number of this execution of breadth-first search. */
-  ListMat8Element* rowListData,     /**< Row data. */
-  ListMat8Element* columnListData,  /**< Column data. */
+  ListMat8Compact* listmatrix,        /**< List matrix. */
   ElementData* rowData,               /**< Row data. */
   ElementData* columnData,            /**< Column data. */
   CMR_ELEMENT* queue,                 /**< Queue. */
@@ -946,18 +1123,19 @@ CMR_ERROR breadthFirstSearch(
     if (CMRelementIsRow(element))
     {
       size_t row = CMRelementToRowIndex(element);
-      for (ListMat8Nonzero* nz = rowListData[row].head.right; nz->column != SIZE_MAX; nz = nz->right)
+      ListMat8Index head = CMRlistmat8CompactRowHead(listmatrix, row);
+      for (ListMat8Index nz = listmatrix->right[head]; nz != head; nz = listmatrix->right[nz])
       {
         /* Skip edge if disabled. */
-        if (nz->special)
+        if (listmatrix->special[nz])
         {
-          CMRdbgMsg(10, "Edge r%d,c%d is disabled.\n", nz->row+1, nz->column+1);
+          CMRdbgMsg(10, "Edge r%d,c%d is disabled.\n", listmatrix->row[nz]+1, listmatrix->column[nz]+1);
           continue;
         }
 
         if (pnumEdges)
           (*pnumEdges)++;
-        size_t column = nz->column;
+        size_t column = listmatrix->column[nz];
         if (columnData[column].lastBFS != currentBFS)
         {
           /* We found a new column node. */
@@ -995,18 +1173,19 @@ CMR_ERROR breadthFirstSearch(
     else
     {
       size_t column = CMRelementToColumnIndex(element);
-      for (ListMat8Nonzero* nz = columnListData[column].head.below; nz->row != SIZE_MAX; nz = nz->below)
+      ListMat8Index head = CMRlistmat8CompactColumnHead(listmatrix, column);
+      for (ListMat8Index nz = listmatrix->below[head]; nz != head; nz = listmatrix->below[nz])
       {
         /* Skip edge if disabled. */
-        if (nz->special)
+        if (listmatrix->special[nz])
         {
-          CMRdbgMsg(10, "Edge r%d,c%d is disabled.\n", nz->row+1, nz->column+1);
+          CMRdbgMsg(10, "Edge r%d,c%d is disabled.\n", listmatrix->row[nz]+1, listmatrix->column[nz]+1);
           continue;
         }
 
         if (pnumEdges)
           (*pnumEdges)++;
-        size_t row = nz->row;
+        size_t row = listmatrix->row[nz];
         if (rowData[row].lastBFS != currentBFS)
         {
           /* We found a new row node. */
@@ -1058,6 +1237,134 @@ CMR_ERROR breadthFirstSearch(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Searches for a shortest path from \p sourceRow to \p targetColumn by breadth-first searches from both
+ *        ends.
+ *
+ * The searches mark the elements they find with \p currentBFS and \p currentBFS + 1, respectively, such that no
+ * reset is needed if the caller increases \p currentBFS by 2 for the next search. In each step, the search with the
+ * smaller queue is advanced by one level, and both stop as soon as they meet. If a path is found, then the
+ * predecessors and distances along it are those of a search from \p sourceRow. Otherwise, the elements reachable from
+ * \p sourceRow are exactly those marked with \p currentBFS.
+ */
+
+static
+CMR_ERROR bidirectionalSearch(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  int currentBFS,               /**< Number of this execution of breadth-first search. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
+  ElementData* rowData,         /**< Row data. */
+  ElementData* columnData,      /**< Column data. */
+  CMR_ELEMENT* forwardQueue,    /**< Queue for the search from \p sourceRow. */
+  CMR_ELEMENT* backwardQueue,   /**< Queue for the search from \p targetColumn. */
+  size_t sourceRow,             /**< Row to start at. */
+  size_t targetColumn,          /**< Column to reach. */
+  bool* pfound                  /**< Pointer for storing whether a path was found. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  assert(cmr);
+  assert(rowData);
+  assert(columnData);
+  assert(forwardQueue);
+  assert(backwardQueue);
+  assert(pfound);
+
+  CMRdbgMsg(6, "Bidirectional BFS #%d from r%zu to c%zu.\n", currentBFS, sourceRow+1, targetColumn+1);
+
+  rowData[sourceRow].lastBFS = currentBFS;
+  rowData[sourceRow].distance = 0;
+  rowData[sourceRow].predecessor = SIZE_MAX;
+  columnData[targetColumn].lastBFS = currentBFS + 1;
+  columnData[targetColumn].distance = 0;
+  columnData[targetColumn].predecessor = SIZE_MAX;
+  forwardQueue[0] = CMRrowToElement(sourceRow);
+  backwardQueue[0] = CMRcolumnToElement(targetColumn);
+  size_t forwardStart = 0;
+  size_t forwardEnd = 1;
+  size_t backwardStart = 0;
+  size_t backwardEnd = 1;
+  CMR_ELEMENT forwardMeet = 0;
+  CMR_ELEMENT backwardMeet = 0;
+  *pfound = false;
+
+  /* If the backward search is exhausted without meeting, the forward search continues to find the reachable part. */
+  while (forwardStart < forwardEnd && !*pfound)
+  {
+    bool forward = backwardStart == backwardEnd || forwardEnd - forwardStart <= backwardEnd - backwardStart;
+    CMR_ELEMENT* queue = forward ? forwardQueue : backwardQueue;
+    size_t* pqueueStart = forward ? &forwardStart : &backwardStart;
+    size_t* pqueueEnd = forward ? &forwardEnd : &backwardEnd;
+    int ownBFS = forward ? currentBFS : currentBFS + 1;
+    int otherBFS = forward ? currentBFS + 1 : currentBFS;
+
+    size_t levelEnd = *pqueueEnd;
+    while (*pqueueStart < levelEnd && !*pfound)
+    {
+      CMR_ELEMENT element = queue[(*pqueueStart)++];
+      bool isRow = CMRelementIsRow(element);
+      size_t index = isRow ? CMRelementToRowIndex(element) : CMRelementToColumnIndex(element);
+      ElementData* data = isRow ? &rowData[index] : &columnData[index];
+      ElementData* neighborData = isRow ? columnData : rowData;
+      ListMat8Index* next = isRow ? listmatrix->right : listmatrix->below;
+      ListMat8Index* neighbors = isRow ? listmatrix->column : listmatrix->row;
+      ListMat8Index head = isRow ? CMRlistmat8CompactRowHead(listmatrix, index)
+        : CMRlistmat8CompactColumnHead(listmatrix, index);
+      for (ListMat8Index nz = next[head]; nz != head; nz = next[nz])
+      {
+        /* Skip edge if disabled. */
+        if (listmatrix->special[nz])
+          continue;
+
+        size_t neighbor = neighbors[nz];
+        if (neighborData[neighbor].lastBFS == ownBFS)
+          continue;
+
+        CMR_ELEMENT neighborElement = isRow ? CMRcolumnToElement(neighbor) : CMRrowToElement(neighbor);
+        if (neighborData[neighbor].lastBFS == otherBFS)
+        {
+          forwardMeet = forward ? element : neighborElement;
+          backwardMeet = forward ? neighborElement : element;
+          *pfound = true;
+          break;
+        }
+
+        neighborData[neighbor].lastBFS = ownBFS;
+        neighborData[neighbor].distance = data->distance + 1;
+        neighborData[neighbor].predecessor = index;
+        queue[(*pqueueEnd)++] = neighborElement;
+      }
+    }
+  }
+
+  if (!*pfound)
+    return CMR_OKAY;
+
+  /* Reverse the predecessors from the meeting point to the target such that they lead to the source. */
+  size_t previous = CMRelementIsRow(forwardMeet) ? CMRelementToRowIndex(forwardMeet)
+    : CMRelementToColumnIndex(forwardMeet);
+  size_t previousDistance = CMRelementIsRow(forwardMeet) ? rowData[previous].distance
+    : columnData[previous].distance;
+  CMR_ELEMENT element = backwardMeet;
+  while (true)
+  {
+    bool isRow = CMRelementIsRow(element);
+    size_t index = isRow ? CMRelementToRowIndex(element) : CMRelementToColumnIndex(element);
+    ElementData* data = isRow ? &rowData[index] : &columnData[index];
+    size_t successor = data->predecessor;
+    data->predecessor = previous;
+    data->distance = ++previousDistance;
+    if (successor == SIZE_MAX)
+      break;
+    previous = index;
+    element = isRow ? CMRcolumnToElement(successor) : CMRrowToElement(successor);
+  }
+  assert(element == CMRcolumnToElement(targetColumn));
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Extract remaining submatrix.
  */
@@ -1068,7 +1375,7 @@ CMR_ERROR extractRemainingSubmatrix(
   CMR_CHRMAT* matrix,             /**< Matrix. */
   size_t numRowReductions,        /**< Number of row SP reductions. */
   size_t numColumnReductions,     /**< Number of column SP reductions. */
-  ListMat8* listmatrix,           /**< List matrix. */
+  ListMat8Compact* listmatrix,    /**< List matrix. */
   CMR_SUBMAT** preducedSubmatrix  /**< Pointer for storing the reduced submatrix. */
 )
 {
@@ -1083,7 +1390,7 @@ CMR_ERROR extractRemainingSubmatrix(
   size_t rowSubmatrix = 0;
   for (size_t row = 0; row < matrix->numRows; ++row)
   {
-    if (listmatrix->rowElements[row].numNonzeros > 0)
+    if (listmatrix->rowNumNonzeros[row] > 0)
       remainingSubmatrix->rows[rowSubmatrix++] = row;
   }
   assert(rowSubmatrix + numRowReductions == matrix->numRows);
@@ -1091,7 +1398,7 @@ CMR_ERROR extractRemainingSubmatrix(
   size_t columnSubmatrix = 0;
   for (size_t column = 0; column < matrix->numColumns; ++column)
   {
-    if (listmatrix->columnElements[column].numNonzeros > 0)
+    if (listmatrix->columnNumNonzeros[column] > 0)
       remainingSubmatrix->columns[columnSubmatrix++] = column;
   }
   assert(columnSubmatrix + numColumnReductions == matrix->numColumns);
@@ -1127,7 +1434,7 @@ CMR_ERROR createFullRemainingMatrix(
 static
 CMR_ERROR extractWheelSubmatrix(
   CMR* cmr,                     /**< \ref CMR environment. */
-  ListMat8* listmatrix,       /**< List matrix. */
+  ListMat8Compact* listmatrix,  /**< List matrix. */
   ElementData* rowData,         /**< Row element data. */
   ElementData* columnData,      /**< Column element data. */
   CMR_ELEMENT* queue,           /**< Queue memory. */
@@ -1146,38 +1453,37 @@ CMR_ERROR extractWheelSubmatrix(
   size_t numRows = listmatrix->numRows;
   size_t numColumns = listmatrix->numColumns;
   
+  /* The element data is marked with increasing search numbers such that it never needs to be reset. */
   int currentBFS = 0;
-  for (size_t row = 0; row < numRows; ++row)
-    rowData[row].specialBFS = false;
-  for (size_t column = 0; column < numColumns; ++column)
-    columnData[column].specialBFS = false;
-  ListMat8Nonzero** nzBlock = NULL; /* Pointers for simultaneously traversing columns of block. */
+  ListMat8Index* nzBlock = NULL; /* Nonzeros for simultaneously traversing columns of block. */
   CMR_CALL( CMRallocStackArray(cmr, &nzBlock, numColumns) );
   CMR_ELEMENT* sources = NULL;
   CMR_CALL( CMRallocStackArray(cmr, &sources, numRows) );
   CMR_ELEMENT* targets = NULL;
   CMR_CALL( CMRallocStackArray(cmr, &targets, numColumns) );
+  CMR_ELEMENT* backwardQueue = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &backwardQueue, queueMemory) );
   size_t numEdges = 0;
-  for (size_t row = 0; row < numRows; ++row)
-    numEdges += listmatrix->rowElements[row].numNonzeros;
+  ListMat8Index anchor = CMRlistmat8CompactAnchor(listmatrix);
+  for (ListMat8Index head = listmatrix->below[anchor]; head != anchor; head = listmatrix->below[head])
+    numEdges += listmatrix->rowNumNonzeros[listmatrix->row[head]];
   while (true)
   {
-    size_t sourceRow = listmatrix->anchor.below->row;
-    rowData[sourceRow].lastBFS = currentBFS;
-    rowData[sourceRow].predecessor = SIZE_MAX;
-    rowData[sourceRow].distance = 0;
-    size_t targetColumn = listmatrix->rowElements[sourceRow].head.right->column;
-    listmatrix->rowElements[sourceRow].head.right->special = 1;
+    size_t sourceRow = listmatrix->row[listmatrix->below[anchor]];
+    ListMat8Index sourceNonzero = listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, sourceRow)];
+    size_t targetColumn = listmatrix->column[sourceNonzero];
+    listmatrix->special[sourceNonzero] = 1;
 
     CMRdbgMsg(4, "Searching for a chordless cycle from r%d to c%d.\n", sourceRow+1, targetColumn+1);
 
     sources[0] = CMRrowToElement(sourceRow);
     targets[0] = CMRcolumnToElement(targetColumn);
-    size_t foundTarget = SIZE_MAX;
-    currentBFS++;
-    CMR_CALL( breadthFirstSearch(cmr, currentBFS, listmatrix->rowElements, listmatrix->columnElements, rowData,
-      columnData, queue, queueMemory, sources, 1, targets, 1, &foundTarget, 0) );
-    listmatrix->rowElements[sourceRow].head.right->special = 0;
+    bool foundPath;
+    currentBFS += 2;
+    CMR_CALL( bidirectionalSearch(cmr, currentBFS, listmatrix, rowData, columnData, queue, backwardQueue, sourceRow,
+      targetColumn, &foundPath) );
+    size_t foundTarget = foundPath ? 0 : SIZE_MAX;
+    listmatrix->special[sourceNonzero] = 0;
     size_t length = (foundTarget == SIZE_MAX) ? SIZE_MAX : columnData[targetColumn].distance + 1;
     CMRdbgMsg(4, "Length of cycle is %zu.\n", length);
      
@@ -1215,25 +1521,27 @@ CMR_ERROR extractWheelSubmatrix(
         targetColumn+1, rowData[row2].predecessor+1);
 
       /* Go trough the two nonzeros of the two rows simultaneously. */
-      ListMat8Nonzero* nz1 = listmatrix->rowElements[row1].head.right;
-      ListMat8Nonzero* nz2 = listmatrix->rowElements[row2].head.right;
+      ListMat8Index nz1 = listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, row1)];
+      ListMat8Index nz2 = listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, row2)];
       numTargets = 0;
-      while (nz1->column != SIZE_MAX)
+      while (listmatrix->column[nz1] != LISTMAT8_NONE)
       {
-        CMRdbgMsg(6, "nonzeros at column indices %d and %d.\n", nz1->column, nz2->column);
-        if (nz1->column < nz2->column)
+        size_t column1 = listmatrix->column[nz1];
+        size_t column2 = listmatrix->column[nz2];
+        CMRdbgMsg(6, "nonzeros at column indices %d and %d.\n", column1, column2);
+        if (column1 < column2)
         {
-          nz1 = nz1->right;
+          nz1 = listmatrix->right[nz1];
         }
-        else if (nz1->column > nz2->column)
-          nz2 = nz2->right;
+        else if (column1 > column2)
+          nz2 = listmatrix->right[nz2];
         else
         {
-          columnData[nz1->column].specialBFS = true;
-          nzBlock[numTargets] = listmatrix->columnElements[nz1->column].head.below;
-          targets[numTargets++] = CMRcolumnToElement(nz1->column);
-          nz1 = nz1->right;
-          nz2 = nz2->right;
+          columnData[column1].specialBFS = true;
+          nzBlock[numTargets] = listmatrix->below[CMRlistmat8CompactColumnHead(listmatrix, column1)];
+          targets[numTargets++] = CMRcolumnToElement(column1);
+          nz1 = listmatrix->right[nz1];
+          nz2 = listmatrix->right[nz2];
         }
       }
       CMRdbgMsg(4, "Identified %d target columns.\n", numTargets);
@@ -1241,26 +1549,26 @@ CMR_ERROR extractWheelSubmatrix(
 
       /* Go through the nonzeros of all marked columns simultaneously. */
       size_t maxIndex = 0;
-      size_t maxRow = nzBlock[0]->row;
+      size_t maxRow = listmatrix->row[nzBlock[0]];
       size_t currentIndex = 1;
       numSources = 0;
-      while (maxRow != SIZE_MAX)
+      while (maxRow != LISTMAT8_NONE)
       {
         if (currentIndex == maxIndex)
         {
           /* All nonzeros now have the same row. */
           for (size_t j = 0; j < numTargets; ++j)
-            nzBlock[j]->special = 1;
+            listmatrix->special[nzBlock[j]] = 1;
           rowData[maxRow].specialBFS = true;
           sources[numSources++] = CMRrowToElement(maxRow);
           ++maxRow;
         }
-        while (nzBlock[currentIndex]->row < maxRow)
-          nzBlock[currentIndex] = nzBlock[currentIndex]->below;
-        if (nzBlock[currentIndex]->row > maxRow)
+        while (listmatrix->row[nzBlock[currentIndex]] < maxRow)
+          nzBlock[currentIndex] = listmatrix->below[nzBlock[currentIndex]];
+        if (listmatrix->row[nzBlock[currentIndex]] > maxRow)
         {
           maxIndex = currentIndex;
-          maxRow = nzBlock[currentIndex]->row;
+          maxRow = listmatrix->row[nzBlock[currentIndex]];
         }
         currentIndex = (currentIndex + 1) % numTargets;
       }
@@ -1268,11 +1576,11 @@ CMR_ERROR extractWheelSubmatrix(
       CMRdbgMsg(4, "Identified %zu source rows.\n", numSources);
       assert(numSources >= 2);
 
-      currentBFS++;
+      currentBFS += 2;
       foundTarget = SIZE_MAX;
       numTraversedEdges = 0;
-      CMR_CALL( breadthFirstSearch(cmr, currentBFS, listmatrix->rowElements, listmatrix->columnElements, rowData,
-        columnData, queue, queueMemory, sources, numSources, targets, numTargets, &foundTarget, &numTraversedEdges) );
+      CMR_CALL( breadthFirstSearch(cmr, currentBFS, listmatrix, rowData, columnData, queue, queueMemory, sources,
+        numSources, targets, numTargets, &foundTarget, &numTraversedEdges) );
     }
 
     if (foundTarget < SIZE_MAX && pwheelSubmatrix)
@@ -1309,8 +1617,9 @@ CMR_ERROR extractWheelSubmatrix(
         CMRdbgMsg(4, "Short cycle is induced by r%d,r%d,c%d,c%d.\n", row1+1, row2+1, column1+1, column2+1);
 
         /* Go through nonzeros of row2 and mark them. */
-        for (ListMat8Nonzero* nz = listmatrix->rowElements[row2].head.right; nz->column != SIZE_MAX; nz = nz->right)
-          columnData[nz->column].lastBFS = -1;
+        ListMat8Index head = CMRlistmat8CompactRowHead(listmatrix, row2);
+        for (ListMat8Index nz = listmatrix->right[head]; nz != head; nz = listmatrix->right[nz])
+          columnData[listmatrix->column[nz]].lastBFS = -1;
 
         /* Find a non-marked source column. */
         size_t column3 = SIZE_MAX;
@@ -1324,8 +1633,9 @@ CMR_ERROR extractWheelSubmatrix(
         CMRdbgMsg(4, "Adding c%d\n", column3+1);
 
         /* Go through nonzeros of column 2 and mark them. */
-        for (ListMat8Nonzero* nz = listmatrix->columnElements[column2].head.below; nz->row != SIZE_MAX; nz = nz->below)
-          rowData[nz->row].lastBFS = -1;
+        head = CMRlistmat8CompactColumnHead(listmatrix, column2);
+        for (ListMat8Index nz = listmatrix->below[head]; nz != head; nz = listmatrix->below[nz])
+          rowData[listmatrix->row[nz]].lastBFS = -1;
 
         /* Find a non-marked source column. */
         size_t row3 = SIZE_MAX;
@@ -1365,7 +1675,7 @@ CMR_ERROR extractWheelSubmatrix(
       size_t reducedRow = 0;
       for (size_t row = 0; row < numRows; ++row)
       {
-        if (listmatrix->rowElements[row].numNonzeros == 0)
+        if (listmatrix->rowNumNonzeros[row] == 0)
           continue;
 
         if (rowData[row].lastBFS != -2)
@@ -1381,7 +1691,7 @@ CMR_ERROR extractWheelSubmatrix(
       size_t reducedColumn = 0;
       for (size_t column = 0; column < numColumns; ++column)
       {
-        if (listmatrix->columnElements[column].numNonzeros == 0)
+        if (listmatrix->columnNumNonzeros[column] == 0)
           continue;
 
         if (columnData[column].lastBFS != -2)
@@ -1413,23 +1723,23 @@ CMR_ERROR extractWheelSubmatrix(
       for (size_t t = 0; t < numTargets; ++t)
       {
         size_t column = CMRelementToColumnIndex(targets[t]);
-        for (ListMat8Nonzero* nz = listmatrix->columnElements[column].head.below; nz->row != SIZE_MAX; nz = nz->below)
+        ListMat8Index head = CMRlistmat8CompactColumnHead(listmatrix, column);
+        for (ListMat8Index nz = listmatrix->below[head]; nz != head; nz = listmatrix->below[nz])
         {
-          if (t > 0 || !rowData[nz->row].specialBFS)
+          if (t > 0 || !rowData[listmatrix->row[nz]].specialBFS)
           {
-            listmatrix->rowElements[nz->row].numNonzeros--;
-            unlinkNonzero(nz);
+            listmatrix->rowNumNonzeros[listmatrix->row[nz]]--;
+            unlinkNonzero(listmatrix, nz);
           }
           else
-            nz->special = 0;
+            listmatrix->special[nz] = 0;
         }
         if (t == 0)
-          listmatrix->columnElements[column].numNonzeros = numSources;
+          listmatrix->columnNumNonzeros[column] = numSources;
         else
         {
-          listmatrix->columnElements[column].numNonzeros = 0;
-          listmatrix->columnElements[column].head.left->right = listmatrix->columnElements[column].head.right;
-          listmatrix->columnElements[column].head.right->left = listmatrix->columnElements[column].head.left;
+          listmatrix->columnNumNonzeros[column] = 0;
+          unlinkColumn(listmatrix, column);
         }
       }
       
@@ -1446,23 +1756,23 @@ CMR_ERROR extractWheelSubmatrix(
       for (size_t s = 0; s < numSources; ++s)
       {
         size_t row = CMRelementToRowIndex(sources[s]);
-        for (ListMat8Nonzero* nz = listmatrix->rowElements[row].head.right; nz->column != SIZE_MAX; nz = nz->right)
+        ListMat8Index head = CMRlistmat8CompactRowHead(listmatrix, row);
+        for (ListMat8Index nz = listmatrix->right[head]; nz != head; nz = listmatrix->right[nz])
         {
-          if (s > 0 || !columnData[nz->column].specialBFS)
+          if (s > 0 || !columnData[listmatrix->column[nz]].specialBFS)
           {
-            listmatrix->columnElements[nz->column].numNonzeros--;
-            unlinkNonzero(nz);
+            listmatrix->columnNumNonzeros[listmatrix->column[nz]]--;
+            unlinkNonzero(listmatrix, nz);
           }
           else
-            nz->special = 0;
+            listmatrix->special[nz] = 0;
         }
         if (s == 0)
-          listmatrix->rowElements[row].numNonzeros = numTargets;
+          listmatrix->rowNumNonzeros[row] = numTargets;
         else
         {
-          listmatrix->rowElements[row].numNonzeros = 0;
-          listmatrix->rowElements[row].head.left->right = listmatrix->rowElements[row].head.right;
-          listmatrix->rowElements[row].head.right->left = listmatrix->rowElements[row].head.left;
+          listmatrix->rowNumNonzeros[row] = 0;
+          unlinkRow(listmatrix, row);
         }
       }
 
@@ -1474,6 +1784,7 @@ CMR_ERROR extractWheelSubmatrix(
     
     CMRdbgMsg(0, "!!! Recursing.\n");
   }
+  CMR_CALL( CMRfreeStackArray(cmr, &backwardQueue) );
   CMR_CALL( CMRfreeStackArray(cmr, &targets) );
   CMR_CALL( CMRfreeStackArray(cmr, &sources) );
   CMR_CALL( CMRfreeStackArray(cmr, &nzBlock) );
@@ -1503,19 +1814,22 @@ CMR_ERROR decomposeBinarySeriesParallel(
   CMRdbgMsg(0, "decomposeBinarySeriesParallel for a %dx%d matrix with %d nonzeros.\n", matrix->numRows,
     matrix->numColumns, matrix->numNonzeros);
 
-  clock_t time = clock();
-  clock_t reduceClock = time;
+  double time = CMRclockNow();
+  double reduceClock = time;
+  CMR_COUNTERS_SAMPLE reduceSample;
+  CMRcountersStart(cmr, &reduceSample);
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
 
   size_t numRows = matrix->numRows;
   size_t numColumns = matrix->numColumns;
   
   /* Create list matrix to use numNonzeros. */
-  ListMat8* listmatrix = NULL;
-  CMR_CALL( CMRlistmat8Alloc(cmr, numRows, numColumns, matrix->numNonzeros, &listmatrix) );
+  ListMat8Compact* listmatrix = NULL;
+  CMR_CALL( CMRlistmat8CompactAlloc(cmr, numRows, numColumns, matrix->numNonzeros, &listmatrix) );
   for (size_t row = 0; row < numRows; ++row)
-    listmatrix->rowElements[row].numNonzeros = 0;
+    listmatrix->rowNumNonzeros[row] = 0;
   for (size_t column = 0; column < numColumns; ++column)
-    listmatrix->columnElements[column].numNonzeros = 0;
+    listmatrix->columnNumNonzeros[column] = 0;
 
   /* Initialize element data and hash vector. */
   ElementData* rowData = NULL;
@@ -1541,22 +1855,22 @@ CMR_ERROR decomposeBinarySeriesParallel(
   if (numRows > 0)
   {
     CMR_CALL( CMRlisthashtableCreate(cmr, &rowHashtable, nextPower2(numRows), numRows) );
-    CMR_CALL( initializeQueueHashtableFromMatrix(cmr, rowHashtable, listmatrix->rowElements, rowData, numRows, queue, &queueEnd,
-      true) );
+    CMR_CALL( initializeQueueHashtableFromMatrix(cmr, rowHashtable, listmatrix->rowNumNonzeros, rowData, numRows,
+      queue, &queueEnd, true) );
   }
   CMR_LISTHASHTABLE* columnHashtable = NULL;
   if (numColumns > 0)
   {
     CMR_CALL( CMRlisthashtableCreate(cmr, &columnHashtable, nextPower2(numColumns), numColumns) );
-    CMR_CALL( initializeQueueHashtableFromMatrix(cmr, columnHashtable, listmatrix->columnElements, columnData, numColumns, queue,
-      &queueEnd, false) );
+    CMR_CALL( initializeQueueHashtableFromMatrix(cmr, columnHashtable, listmatrix->columnNumNonzeros, columnData,
+      numColumns, queue, &queueEnd, false) );
   }
 
   *pnumReductions = 0;
   if (queueEnd > queueStart || (pviolatorSubmatrix && (numRows + numColumns > 0)))
   {
     /* Initialize list matrix representation. */
-    CMR_CALL( CMRlistmat8InitializeFromChrMatrix(cmr, listmatrix, matrix) );
+    CMR_CALL( CMRlistmat8CompactInitializeFromChrMatrix(cmr, listmatrix, matrix) );
 
     /* We now start main loop. */
     size_t numRowReductions = 0;
@@ -1565,9 +1879,8 @@ CMR_ERROR decomposeBinarySeriesParallel(
       queue, &queueStart, &queueEnd, queueMemory, reductions, maxNumReductions, pnumReductions, &numRowReductions,
       &numColumnReductions) );
 
-    clock_t now = clock();
-    double remainingTime = timeLimit - (now - time) * 1.0 / CLOCKS_PER_SEC;
-    if (remainingTime < 0)
+    double now = CMRclockNow();
+    if (CMRdeadlinePassedAt(&deadline, now))
     {
       CMR_CALL( CMRlisthashtableFree(cmr, &columnHashtable) );
       CMR_CALL( CMRlisthashtableFree(cmr, &rowHashtable) );
@@ -1577,13 +1890,14 @@ CMR_ERROR decomposeBinarySeriesParallel(
       CMR_CALL( CMRfreeStackArray(cmr, &columnData) );
       CMR_CALL( CMRfreeStackArray(cmr, &rowData) );
       
-      CMR_CALL( CMRlistmat8Free(cmr, &listmatrix) );
+      CMR_CALL( CMRlistmat8CompactFree(cmr, &listmatrix) );
       return CMR_ERROR_TIMEOUT;
     }
     if (stats)
     {
       stats->reduceCount++;
-      stats->reduceTime += (now - reduceClock) * 1.0 / CLOCKS_PER_SEC;
+      stats->reduceTime += (now - reduceClock);
+      CMRcountersStop(&reduceSample, &stats->reduceCounters);
     }
 
     /* Extract SP-reduced submatrix. */
@@ -1600,9 +1914,9 @@ CMR_ERROR decomposeBinarySeriesParallel(
     if ((pviolatorSubmatrix || pseparation) && (*pnumReductions != SIZE_MAX)
       && (*pnumReductions != (matrix->numRows + matrix->numColumns)))
     {
-      clock_t wheelClock = 0;
+      double wheelClock = 0.0;
       if (stats)
-        wheelClock = clock();
+        wheelClock = CMRclockNow();
 
       CMR_CALL( extractWheelSubmatrix(cmr, listmatrix, rowData, columnData, queue, queueMemory,
         numRows - numRowReductions, numColumns - numColumnReductions, pviolatorSubmatrix, pseparation) );
@@ -1610,10 +1924,9 @@ CMR_ERROR decomposeBinarySeriesParallel(
       if (pseparation && *pseparation)
       {
         CMR_CHRMAT* transpose = NULL;
-        CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+        CMR_CALL( CMRchrmatGetTranspose(cmr, matrix, &transpose) );
         CMR_CALL( CMRsepaFindBinaryRepresentativesSubmatrix(cmr, *pseparation, matrix, transpose, reducedSubmatrix,
           NULL, NULL) );
-        CMR_CALL( CMRchrmatFree(cmr, &transpose) );
 
         assert((*pseparation)->type == CMR_SEPA_TYPE_TWO);
       }
@@ -1621,7 +1934,7 @@ CMR_ERROR decomposeBinarySeriesParallel(
       if (stats)
       {
         stats->wheelCount++;
-        stats->wheelTime += (clock() - wheelClock) * 1.0 / CLOCKS_PER_SEC;
+        stats->wheelTime += CMRclockNow() - wheelClock;
       }
     }
 
@@ -1644,12 +1957,12 @@ CMR_ERROR decomposeBinarySeriesParallel(
   CMR_CALL( CMRfreeStackArray(cmr, &columnData) );
   CMR_CALL( CMRfreeStackArray(cmr, &rowData) );
   
-  CMR_CALL( CMRlistmat8Free(cmr, &listmatrix) );
+  CMR_CALL( CMRlistmat8CompactFree(cmr, &listmatrix) );
 
   if (stats)
   {
     stats->totalCount++;
-    stats->totalTime += (clock() - time) * 1.0 / CLOCKS_PER_SEC;
+    stats->totalTime += CMRclockNow() - time;
   }
 
   return CMR_OKAY;
@@ -1673,7 +1986,7 @@ CMR_ERROR CMRtestBinarySeriesParallel(CMR* cmr, CMR_CHRMAT* matrix, bool* pisSer
     &localNumReductions, preducedSubmatrix, pviolatorSubmatrix, NULL, stats, timeLimit) );
 
   if (pisSeriesParallel)
-    *pisSeriesParallel = (*pnumReductions == matrix->numRows + matrix->numColumns);
+    *pisSeriesParallel = (localNumReductions == matrix->numRows + matrix->numColumns);
   if (reductions)
     *pnumReductions = localNumReductions;
   else
@@ -1732,19 +2045,22 @@ CMR_ERROR decomposeTernarySeriesParallel(
   CMRdbgMsg(0, "decomposeTernarySeriesParallel for a %dx%d matrix with %d nonzeros.\n", matrix->numRows,
     matrix->numColumns, matrix->numNonzeros);
 
-  clock_t time = clock();
-  clock_t reduceClock = time;
+  double time = CMRclockNow();
+  double reduceClock = time;
+  CMR_COUNTERS_SAMPLE reduceSample;
+  CMRcountersStart(cmr, &reduceSample);
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
 
   size_t numRows = matrix->numRows;
   size_t numColumns = matrix->numColumns;
 
   /* Create list matrix to use numNonzeros. */
-  ListMat8* listmatrix = NULL;
-  CMR_CALL( CMRlistmat8Alloc(cmr, numRows, numColumns, matrix->numNonzeros, &listmatrix) );
+  ListMat8Compact* listmatrix = NULL;
+  CMR_CALL( CMRlistmat8CompactAlloc(cmr, numRows, numColumns, matrix->numNonzeros, &listmatrix) );
   for (size_t row = 0; row < numRows; ++row)
-    listmatrix->rowElements[row].numNonzeros = 0;
+    listmatrix->rowNumNonzeros[row] = 0;
   for (size_t column = 0; column < numColumns; ++column)
-    listmatrix->columnElements[column].numNonzeros = 0;
+    listmatrix->columnNumNonzeros[column] = 0;
 
   /* Initialize element data and hash vector. */
   ElementData* rowData = NULL;
@@ -1770,20 +2086,20 @@ CMR_ERROR decomposeTernarySeriesParallel(
   if (numRows > 0)
   {
     CMR_CALL( CMRlisthashtableCreate(cmr, &rowHashtable, nextPower2(numRows), numRows) );
-    CMR_CALL( initializeQueueHashtableFromMatrix(cmr, rowHashtable, listmatrix->rowElements, rowData, numRows, queue, &queueEnd, true) );
+    CMR_CALL( initializeQueueHashtableFromMatrix(cmr, rowHashtable, listmatrix->rowNumNonzeros, rowData, numRows, queue, &queueEnd, true) );
   }
   CMR_LISTHASHTABLE* columnHashtable = NULL;
   if (numColumns > 0)
   {
     CMR_CALL( CMRlisthashtableCreate(cmr, &columnHashtable, nextPower2(numColumns), numColumns) );
-    CMR_CALL( initializeQueueHashtableFromMatrix(cmr, columnHashtable, listmatrix->columnElements, columnData, numColumns, queue, &queueEnd, false) );
+    CMR_CALL( initializeQueueHashtableFromMatrix(cmr, columnHashtable, listmatrix->columnNumNonzeros, columnData, numColumns, queue, &queueEnd, false) );
   }
 
   *pnumReductions = 0;
   if (queueEnd > queueStart || (pviolatorSubmatrix && (numRows + numColumns > 0)))
   {
     /* Create list matrix representation. */
-    CMR_CALL( CMRlistmat8InitializeFromChrMatrix(cmr, listmatrix, matrix) );
+    CMR_CALL( CMRlistmat8CompactInitializeFromChrMatrix(cmr, listmatrix, matrix) );
 
     /* We now start main loop. */
     size_t numRowReductions = 0;
@@ -1792,9 +2108,8 @@ CMR_ERROR decomposeTernarySeriesParallel(
       &queueStart, &queueEnd, queueMemory, reductions, maxNumReductions, pnumReductions, &numRowReductions,
       &numColumnReductions) );
 
-    clock_t now = clock();
-    double remainingTime = timeLimit - (now - time) * 1.0 / CLOCKS_PER_SEC;
-    if (remainingTime < 0)
+    double now = CMRclockNow();
+    if (CMRdeadlinePassedAt(&deadline, now))
     {
       CMR_CALL( CMRlisthashtableFree(cmr, &columnHashtable) );
       CMR_CALL( CMRlisthashtableFree(cmr, &rowHashtable) );
@@ -1804,13 +2119,14 @@ CMR_ERROR decomposeTernarySeriesParallel(
       CMR_CALL( CMRfreeStackArray(cmr, &columnData) );
       CMR_CALL( CMRfreeStackArray(cmr, &rowData) );
 
-      CMR_CALL( CMRlistmat8Free(cmr, &listmatrix) );
+      CMR_CALL( CMRlistmat8CompactFree(cmr, &listmatrix) );
       return CMR_ERROR_TIMEOUT;
     }
     if (stats)
     {
       stats->reduceCount++;
-      stats->reduceTime += (now - reduceClock) * 1.0 / CLOCKS_PER_SEC;
+      stats->reduceTime += (now - reduceClock);
+      CMRcountersStop(&reduceSample, &stats->reduceCounters);
     }
 
     /* Extract SP-reduced submatrix. */
@@ -1827,9 +2143,9 @@ CMR_ERROR decomposeTernarySeriesParallel(
     if ((pviolatorSubmatrix || pseparation) && (*pnumReductions != SIZE_MAX)
       && (*pnumReductions != (matrix->numRows + matrix->numColumns)))
     {
-      clock_t nonbinaryClock = 0;
+      double nonbinaryClock = 0.0;
       if (stats)
-        nonbinaryClock = clock();
+        nonbinaryClock = CMRclockNow();
 
       CMR_CALL( calcBinaryHashFromListMatrix(cmr, listmatrix, rowData, columnData, hashVector) );
 
@@ -1854,7 +2170,7 @@ CMR_ERROR decomposeTernarySeriesParallel(
       if (stats)
       {
         stats->nonbinaryCount++;
-        stats->nonbinaryTime += (clock() - nonbinaryClock) * 1.0 / CLOCKS_PER_SEC;
+        stats->nonbinaryTime += CMRclockNow() - nonbinaryClock;
       }
 
       if (pviolatorSubmatrix && *pviolatorSubmatrix)
@@ -1863,9 +2179,9 @@ CMR_ERROR decomposeTernarySeriesParallel(
       }
       else if (!violatorSubmatrix)
       {
-        clock_t wheelClock = 0;
+        double wheelClock = 0.0;
         if (stats)
-          wheelClock = clock();
+          wheelClock = CMRclockNow();
 
         CMR_CALL( extractWheelSubmatrix(cmr, listmatrix, rowData, columnData, queue, queueMemory,
           numRows - numRowReductions, numColumns - numColumnReductions, &violatorSubmatrix, pseparation) );
@@ -1873,11 +2189,10 @@ CMR_ERROR decomposeTernarySeriesParallel(
         if (pseparation && *pseparation)
         {
           CMR_CHRMAT* transpose = NULL;
-          CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+          CMR_CALL( CMRchrmatGetTranspose(cmr, matrix, &transpose) );
 
           CMR_CALL( CMRsepaFindBinaryRepresentativesSubmatrix(cmr, *pseparation, matrix, transpose, reducedSubmatrix,
             NULL, &violatorSubmatrix) );
-          CMR_CALL( CMRchrmatFree(cmr, &transpose) );
 
           if (violatorSubmatrix)
           {
@@ -1898,7 +2213,7 @@ CMR_ERROR decomposeTernarySeriesParallel(
         if (stats)
         {
           stats->wheelCount++;
-          stats->wheelTime += (clock() - wheelClock) * 1.0 / CLOCKS_PER_SEC;
+          stats->wheelTime += CMRclockNow() - wheelClock;
         }
       }
       else
@@ -1928,12 +2243,12 @@ CMR_ERROR decomposeTernarySeriesParallel(
   CMR_CALL( CMRfreeStackArray(cmr, &columnData) );
   CMR_CALL( CMRfreeStackArray(cmr, &rowData) );
 
-  CMR_CALL( CMRlistmat8Free(cmr, &listmatrix) );
+  CMR_CALL( CMRlistmat8CompactFree(cmr, &listmatrix) );
 
   if (stats)
   {
     stats->totalCount++;
-    stats->totalTime += (clock() - time) * 1.0 / CLOCKS_PER_SEC;
+    stats->totalTime += CMRclockNow() - time;
   }
 
   return CMR_OKAY;
@@ -0,0 +1,498 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include "small_matrix.h"
+
+#include "bitset.h"
+#include "env_internal.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#define SMALL_WORK_LIMIT 4096 /**< Number of enumeration steps after which a small-matrix test gives up. */
+
+/**
+ * \brief Small ternary matrix whose rows and columns are stored as bitmasks.
+ */
+
+typedef struct
+{
+  size_t numRows;                           /**< \brief Number of rows. */
+  size_t numColumns;                        /**< \brief Number of columns. */
+  uint16_t rowsPositive[CMR_SMALL_MAX];     /**< \brief For each column, the rows with a \f$ +1 \f$-entry. */
+  uint16_t rowsNegative[CMR_SMALL_MAX];     /**< \brief For each column, the rows with a \f$ -1 \f$-entry. */
+  uint16_t columnsPositive[CMR_SMALL_MAX];  /**< \brief For each row, the columns with a \f$ +1 \f$-entry. */
+  uint16_t columnsNegative[CMR_SMALL_MAX];  /**< \brief For each row, the columns with a \f$ -1 \f$-entry. */
+  size_t rowsToOriginal[CMR_SMALL_MAX];     /**< \brief For each row, the corresponding row of the input matrix. */
+  size_t columnsToOriginal[CMR_SMALL_MAX];  /**< \brief For each column, the corresponding column of the input
+                                             **  matrix. */
+} SmallMatrix;
+
+/**
+ * \brief Enumeration of square submatrices of a \ref SmallMatrix.
+ *
+ * The rows of the submatrix are a subset of the \em subset \em side, and its columns are chosen among the \em lines,
+ * where the shorter dimension of the matrix is the subset side.
+ */
+
+typedef struct
+{
+  bool exactlyTwo;                        /**< \brief Whether each row and column must have exactly two nonzeros
+                                           **  (balancedness) instead of an even number (total unimodularity). */
+  size_t numLines;                        /**< \brief Number of lines. */
+  uint16_t linesPositive[CMR_SMALL_MAX];  /**< \brief For each line, the elements with a \f$ +1 \f$-entry. */
+  uint16_t linesNegative[CMR_SMALL_MAX];  /**< \brief For each line, the elements with a \f$ -1 \f$-entry. */
+  size_t cardinality;                     /**< \brief Size of the enumerated submatrices. */
+  uint16_t subset;                        /**< \brief Currently enumerated subset. */
+  size_t numUsable;                       /**< \brief Number of lines that are usable for \ref subset. */
+  size_t usableLines[CMR_SMALL_MAX];      /**< \brief Usable lines. */
+  uint16_t usableSupports[CMR_SMALL_MAX]; /**< \brief Support of each usable line within \ref subset. */
+  int usableSums[CMR_SMALL_MAX];          /**< \brief Sum of each usable line within \ref subset. */
+  uint16_t suffixSupports[CMR_SMALL_MAX + 1]; /**< \brief Union of the supports of each usable line and all later
+                                               **  ones. */
+  size_t chosen[CMR_SMALL_MAX];           /**< \brief Positions of the chosen usable lines. */
+  size_t work;                            /**< \brief Number of enumeration steps so far. */
+  size_t workLimit;                       /**< \brief Number of enumeration steps after which the test gives up. */
+} SmallEnumeration;
+
+/**
+ * \brief Stores \p matrix as a \ref SmallMatrix.
+ */
+
+static
+void smallLoad(
+  CMR_CHRMAT* matrix, /**< Ternary matrix. */
+  SmallMatrix* small  /**< Small matrix to fill. */
+)
+{
+  assert(matrix);
+  assert(CMRsmallFits(matrix));
+
+  small->numRows = matrix->numRows;
+  small->numColumns = matrix->numColumns;
+  for (size_t column = 0; column < matrix->numColumns; ++column)
+  {
+    small->rowsPositive[column] = 0;
+    small->rowsNegative[column] = 0;
+    small->columnsToOriginal[column] = column;
+  }
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    small->columnsPositive[row] = 0;
+    small->columnsNegative[row] = 0;
+    small->rowsToOriginal[row] = row;
+    for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+    {
+      size_t column = matrix->entryColumns[e];
+      if (matrix->entryValues[e] > 0)
+      {
+        small->columnsPositive[row] |= (uint16_t) (1u << column);
+        small->rowsPositive[column] |= (uint16_t) (1u << row);
+      }
+      else
+      {
+        small->columnsNegative[row] |= (uint16_t) (1u << column);
+        small->rowsNegative[column] |= (uint16_t) (1u << row);
+      }
+    }
+  }
+}
+
+/**
+ * \brief Removes lines from \p *pactive that have at most one nonzero or that are copies of other lines up to scaling
+ *        by \f$ -1 \f$, both restricted to \p activeOther.
+ *
+ * \returns \c true if some line was removed.
+ */
+
+static
+bool smallReduceLines(
+  const uint16_t* positive, /**< For each line, the elements with a \f$ +1 \f$-entry. */
+  const uint16_t* negative, /**< For each line, the elements with a \f$ -1 \f$-entry. */
+  size_t numLines,          /**< Number of lines. */
+  uint16_t* pactive,        /**< Pointer to the mask of active lines. */
+  uint16_t activeOther      /**< Mask of active elements. */
+)
+{
+  bool removed = false;
+  for (size_t line = 0; line < numLines; ++line)
+  {
+    if (!(*pactive & (1u << line)))
+      continue;
+
+    uint16_t linePositive = positive[line] & activeOther;
+    uint16_t lineNegative = negative[line] & activeOther;
+    if (CMRbitsetCount(linePositive | lineNegative) <= 1)
+    {
+      *pactive &= (uint16_t) ~(1u << line);
+      removed = true;
+      continue;
+    }
+
+    for (size_t other = line + 1; other < numLines; ++other)
+    {
+      if (!(*pactive & (1u << other)))
+        continue;
+
+      uint16_t otherPositive = positive[other] & activeOther;
+      uint16_t otherNegative = negative[other] & activeOther;
+      if ((otherPositive == linePositive && otherNegative == lineNegative)
+        || (otherPositive == lineNegative && otherNegative == linePositive))
+      {
+        *pactive &= (uint16_t) ~(1u << other);
+        removed = true;
+      }
+    }
+  }
+
+  return removed;
+}
+
+/**
+ * \brief Removes rows and columns with at most one nonzero as well as copies of rows and columns up to scaling by
+ *        \f$ -1 \f$ from \p small until no more such rows or columns exist.
+ *
+ * A submatrix of the reduced matrix that is a minimal violator for total unimodularity or balancedness is one of the
+ * input matrix, and the reduced matrix has such a violator if the input matrix has one.
+ */
+
+static
+void smallReduce(
+  SmallMatrix* small  /**< Small matrix. */
+)
+{
+  uint16_t activeRows = (uint16_t) ((1u << small->numRows) - 1);
+  uint16_t activeColumns = (uint16_t) ((1u << small->numColumns) - 1);
+  bool removed = true;
+  while (removed)
+  {
+    removed = smallReduceLines(small->columnsPositive, small->columnsNegative, small->numRows, &activeRows,
+      activeColumns);
+    removed = smallReduceLines(small->rowsPositive, small->rowsNegative, small->numColumns, &activeColumns,
+      activeRows) || removed;
+  }
+
+  /* Renumber the remaining rows and columns. */
+  SmallMatrix reduced;
+  reduced.numRows = 0;
+  reduced.numColumns = 0;
+  size_t columnsReduced[CMR_SMALL_MAX];
+  for (size_t column = 0; column < small->numColumns; ++column)
+  {
+    if (activeColumns & (1u << column))
+    {
+      columnsReduced[column] = reduced.numColumns;
+      reduced.rowsPositive[reduced.numColumns] = 0;
+      reduced.rowsNegative[reduced.numColumns] = 0;
+      reduced.columnsToOriginal[reduced.numColumns++] = small->columnsToOriginal[column];
+    }
+  }
+  for (size_t row = 0; row < small->numRows; ++row)
+  {
+    if (!(activeRows & (1u << row)))
+      continue;
+
+    size_t reducedRow = reduced.numRows++;
+    reduced.rowsToOriginal[reducedRow] = small->rowsToOriginal[row];
+    reduced.columnsPositive[reducedRow] = 0;
+    reduced.columnsNegative[reducedRow] = 0;
+    for (size_t column = 0; column < small->numColumns; ++column)
+    {
+      if (!(activeColumns & (1u << column)))
+        continue;
+
+      uint16_t columnBit = (uint16_t) (1u << columnsReduced[column]);
+      uint16_t rowBit = (uint16_t) (1u << reducedRow);
+      if (small->columnsPositive[row] & (1u << column))
+      {
+        reduced.columnsPositive[reducedRow] |= columnBit;
+        reduced.rowsPositive[columnsReduced[column]] |= rowBit;
+      }
+      else if (small->columnsNegative[row] & (1u << column))
+      {
+        reduced.columnsNegative[reducedRow] |= columnBit;
+        reduced.rowsNegative[columnsReduced[column]] |= rowBit;
+      }
+    }
+  }
+
+  CMRdbgMsg(4, "Reduced the %zux%zu matrix to %zux%zu.\n", small->numRows, small->numColumns, reduced.numRows,
+    reduced.numColumns);
+
+  *small = reduced;
+}
+
+/**
+ * \brief Recursively chooses \ref SmallEnumeration::cardinality many usable lines such that each element of the
+ *        subset is covered an even number of times and the sum of the entries is not divisible by 4.
+ *
+ * \returns \c true if such lines were found.
+ */
+
+static
+bool smallSearchEulerian(
+  SmallEnumeration* enumeration,  /**< Enumeration. */
+  size_t numChosen,               /**< Number of already chosen lines. */
+  size_t firstUsable,             /**< First usable line that may be chosen. */
+  uint16_t parities,              /**< Elements that are covered an odd number of times so far. */
+  int sum                         /**< Sum of the entries so far. */
+)
+{
+  if (numChosen == enumeration->cardinality)
+    return !parities && sum % 4 != 0;
+
+  /* Elements that are covered an odd number of times must be covered by a later line. */
+  if (parities & ~enumeration->suffixSupports[firstUsable])
+    return false;
+
+  for (size_t usable = firstUsable; usable + enumeration->cardinality - numChosen <= enumeration->numUsable; ++usable)
+  {
+    if (++enumeration->work > enumeration->workLimit)
+      return false;
+
+    enumeration->chosen[numChosen] = usable;
+    if (smallSearchEulerian(enumeration, numChosen + 1, usable + 1, parities ^ enumeration->usableSupports[usable],
+      sum + enumeration->usableSums[usable]))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * \brief Recursively chooses \ref SmallEnumeration::cardinality many usable lines such that each element of the
+ *        subset is covered exactly twice and the sum of the entries is not divisible by 4.
+ *
+ * \returns \c true if such lines were found.
+ */
+
+static
+bool smallSearchCycle(
+  SmallEnumeration* enumeration,  /**< Enumeration. */
+  size_t numChosen,               /**< Number of already chosen lines. */
+  size_t firstUsable,             /**< First usable line that may be chosen. */
+  uint16_t once,                  /**< Elements that are covered exactly once so far. */
+  uint16_t twice,                 /**< Elements that are covered twice so far. */
+  int sum                         /**< Sum of the entries so far. */
+)
+{
+  /* Since every line covers two elements, all of them are covered twice at the end. */
+  if (numChosen == enumeration->cardinality)
+    return sum % 4 != 0;
+
+  /* Elements that are covered once must be covered by a later line. */
+  if (once & ~enumeration->suffixSupports[firstUsable])
+    return false;
+
+  for (size_t usable = firstUsable; usable + enumeration->cardinality - numChosen <= enumeration->numUsable; ++usable)
+  {
+    if (++enumeration->work > enumeration->workLimit)
+      return false;
+
+    uint16_t support = enumeration->usableSupports[usable];
+    if (support & twice)
+      continue;
+
+    enumeration->chosen[numChosen] = usable;
+    if (smallSearchCycle(enumeration, numChosen + 1, usable + 1, once ^ support, twice | (once & support),
+      sum + enumeration->usableSums[usable]))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * \brief Determines the usable lines for the subset of \p enumeration.
+ *
+ * \returns \c false if no violating submatrix with these rows can exist.
+ */
+
+static
+bool smallPrepareSubset(
+  SmallEnumeration* enumeration /**< Enumeration. */
+)
+{
+  uint16_t subset = enumeration->subset;
+  uint16_t covered = 0;
+  uint16_t coveredTwice = 0;
+  enumeration->numUsable = 0;
+  for (size_t line = 0; line < enumeration->numLines; ++line)
+  {
+    uint16_t positive = enumeration->linesPositive[line] & subset;
+    uint16_t negative = enumeration->linesNegative[line] & subset;
+    uint16_t support = positive | negative;
+    size_t count = CMRbitsetCount(support);
+    if (enumeration->exactlyTwo ? count != 2 : (count == 0 || count % 2 == 1))
+      continue;
+
+    enumeration->usableLines[enumeration->numUsable] = line;
+    enumeration->usableSupports[enumeration->numUsable] = support;
+    enumeration->usableSums[enumeration->numUsable] = (int) CMRbitsetCount(positive) - (int) CMRbitsetCount(negative);
+    enumeration->numUsable++;
+    coveredTwice |= covered & support;
+    covered |= support;
+  }
+
+  enumeration->suffixSupports[enumeration->numUsable] = 0;
+  for (size_t usable = enumeration->numUsable; usable > 0; --usable)
+  {
+    enumeration->suffixSupports[usable - 1] = enumeration->suffixSupports[usable]
+      | enumeration->usableSupports[usable - 1];
+  }
+
+  /* A minimal violator has no zero row, and with exactly two nonzeros per column, every row must be hit twice. */
+  if (enumeration->numUsable < enumeration->cardinality)
+    return false;
+  return (enumeration->exactlyTwo ? coveredTwice : covered) == subset;
+}
+
+/**
+ * \brief Searches the reduced \p small for a smallest violating submatrix.
+ */
+
+static
+CMR_ERROR smallEnumerate(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  SmallMatrix* small,       /**< Reduced small matrix. */
+  bool exactlyTwo,          /**< Whether to test balancedness instead of total unimodularity. */
+  bool* pdecided,           /**< Pointer for storing whether the test was completed. */
+  bool* pisValid,           /**< Pointer for storing whether no violating submatrix exists. */
+  CMR_SUBMAT** psubmatrix   /**< Pointer for storing a violating submatrix (may be \c NULL). */
+)
+{
+  assert(cmr);
+  assert(small);
+
+  /* The shorter dimension is the subset side. */
+  bool transposed = small->numRows > small->numColumns;
+  size_t numElements = transposed ? small->numColumns : small->numRows;
+
+  SmallEnumeration enumeration;
+  enumeration.exactlyTwo = exactlyTwo;
+  enumeration.numLines = transposed ? small->numRows : small->numColumns;
+  for (size_t line = 0; line < enumeration.numLines; ++line)
+  {
+    enumeration.linesPositive[line] = transposed ? small->columnsPositive[line] : small->rowsPositive[line];
+    enumeration.linesNegative[line] = transposed ? small->columnsNegative[line] : small->rowsNegative[line];
+  }
+  enumeration.work = 0;
+
+  /* If not all subsets can be enumerated within the budget, then the test can only find a violator, and hence it only
+   * spends a fraction of the budget on searching for small ones. */
+  enumeration.workLimit = SMALL_WORK_LIMIT;
+  if (enumeration.numLines * ((((size_t) 1) << numElements) - numElements - 1) > SMALL_WORK_LIMIT)
+    enumeration.workLimit = SMALL_WORK_LIMIT / 8;
+
+  *pdecided = true;
+  *pisValid = true;
+  for (enumeration.cardinality = 2; enumeration.cardinality <= numElements; ++enumeration.cardinality)
+  {
+    /* Enumerate the subsets of the given cardinality in lexicographic order of their masks (Gosper's hack). */
+    uint32_t subset = (1u << enumeration.cardinality) - 1;
+    while (subset < (1u << numElements))
+    {
+      enumeration.subset = (uint16_t) subset;
+      enumeration.work += enumeration.numLines;
+      if (enumeration.work > enumeration.workLimit)
+        break;
+
+      if (smallPrepareSubset(&enumeration))
+      {
+        bool found = exactlyTwo ? smallSearchCycle(&enumeration, 0, 0, 0, 0, 0)
+          : smallSearchEulerian(&enumeration, 0, 0, 0, 0);
+        if (found)
+        {
+          *pisValid = false;
+          break;
+        }
+      }
+
+      uint32_t lowest = subset & -subset;
+      uint32_t ripple = subset + lowest;
+      subset = (((ripple ^ subset) >> 2) / lowest) | ripple;
+    }
+
+    if (!*pisValid || enumeration.work > enumeration.workLimit)
+      break;
+  }
+
+  if (*pisValid && enumeration.work > enumeration.workLimit)
+  {
+    CMRdbgMsg(4, "Giving up after %zu enumeration steps.\n", enumeration.work);
+    *pdecided = false;
+    return CMR_OKAY;
+  }
+
+  CMRdbgMsg(4, "Decided after %zu enumeration steps.\n", enumeration.work);
+
+  if (!*pisValid && psubmatrix)
+  {
+    size_t cardinality = enumeration.cardinality;
+    size_t* elements = NULL;
+    size_t* lines = NULL;
+    CMR_CALL( CMRsubmatCreate(cmr, cardinality, cardinality, psubmatrix) );
+    elements = transposed ? (*psubmatrix)->columns : (*psubmatrix)->rows;
+    lines = transposed ? (*psubmatrix)->rows : (*psubmatrix)->columns;
+
+    size_t i = 0;
+    for (size_t element = 0; element < numElements; ++element)
+    {
+      if (enumeration.subset & (1u << element))
+        elements[i++] = transposed ? small->columnsToOriginal[element] : small->rowsToOriginal[element];
+    }
+    for (i = 0; i < cardinality; ++i)
+    {
+      size_t line = enumeration.usableLines[enumeration.chosen[i]];
+      lines[i] = transposed ? small->rowsToOriginal[line] : small->columnsToOriginal[line];
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRsmallTestTotallyUnimodular(CMR* cmr, CMR_CHRMAT* matrix, bool* pdecided, bool* pisTotallyUnimodular,
+  CMR_SUBMAT** psubmatrix)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pdecided);
+  assert(pisTotallyUnimodular);
+
+  CMRdbgMsg(2, "Testing the %zux%zu matrix for total unimodularity with bitmasks.\n", matrix->numRows,
+    matrix->numColumns);
+
+  SmallMatrix small;
+  smallLoad(matrix, &small);
+  smallReduce(&small);
+  bool isTotallyUnimodular;
+  CMR_CALL( smallEnumerate(cmr, &small, false, pdecided, &isTotallyUnimodular, psubmatrix) );
+  if (*pdecided)
+    *pisTotallyUnimodular = isTotallyUnimodular;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRsmallTestBalanced(CMR* cmr, CMR_CHRMAT* matrix, bool* pdecided, bool* pisBalanced,
+  CMR_SUBMAT** psubmatrix)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pdecided);
+  assert(pisBalanced);
+
+  CMRdbgMsg(2, "Testing the %zux%zu matrix for balancedness with bitmasks.\n", matrix->numRows, matrix->numColumns);
+
+  SmallMatrix small;
+  smallLoad(matrix, &small);
+  smallReduce(&small);
+  bool isBalanced;
+  CMR_CALL( smallEnumerate(cmr, &small, true, pdecided, &isBalanced, psubmatrix) );
+  if (*pdecided)
+    *pisBalanced = isBalanced;
+
+  return CMR_OKAY;
+}
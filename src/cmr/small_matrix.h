@@ -0,0 +1,75 @@
+#ifndef CMR_SMALL_MATRIX_INTERNAL_H
+#define CMR_SMALL_MATRIX_INTERNAL_H
+
+/**
+ * \file small_matrix.h
+ *
+ * \brief Tests of tiny ternary matrices for total unimodularity and balancedness that keep the whole matrix in bitmasks.
+ *
+ * The general algorithms set up a decomposition tree, graphs and several auxiliary matrices, which dominates their
+ * running time for matrices with only a few rows and columns. For matrices with at most \ref CMR_SMALL_MAX rows and
+ * columns, each row and each column is stored as a pair of 16-bit masks of its \f$ +1 \f$- and \f$ -1 \f$-entries.
+ * Rows and columns with at most one nonzero and copies of rows or columns up to scaling by \f$ -1 \f$ are removed, and
+ * the remaining matrix is searched for a smallest violating submatrix by enumeration. Since this is exponential, the
+ * enumeration gives up after a fixed amount of work, in which case the caller shall use the general algorithm.
+ */
+
+#include <cmr/matrix.h>
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMR_SMALL_MAX 16 /**< Maximum number of rows and of columns of a matrix for the small-matrix tests. */
+
+/**
+ * \brief Returns \c true if and only if \p matrix has at most \ref CMR_SMALL_MAX rows and columns.
+ */
+
+static inline
+bool CMRsmallFits(
+  CMR_CHRMAT* matrix  /**< Matrix. */
+)
+{
+  return matrix->numRows <= CMR_SMALL_MAX && matrix->numColumns <= CMR_SMALL_MAX;
+}
+
+/**
+ * \brief Tests the small ternary \p matrix for total unimodularity.
+ *
+ * Searches for a smallest square Eulerian submatrix whose sum of entries is not divisible by 4, which is a minimal
+ * non-totally unimodular submatrix by Camion's theorem. If the work budget is exceeded, then \p *pdecided is set to
+ * \c false and nothing else is stored.
+ */
+
+CMR_ERROR CMRsmallTestTotallyUnimodular(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,         /**< Ternary matrix with at most \ref CMR_SMALL_MAX rows and columns. */
+  bool* pdecided,             /**< Pointer for storing whether the test was completed. */
+  bool* pisTotallyUnimodular, /**< Pointer for storing whether \p matrix is totally unimodular. */
+  CMR_SUBMAT** psubmatrix     /**< Pointer for storing a minimal non-totally unimodular submatrix (may be \c NULL). */
+);
+
+/**
+ * \brief Tests the small ternary \p matrix for balancedness.
+ *
+ * Searches for a smallest square submatrix with exactly two nonzeros in each row and in each column whose sum of
+ * entries is not divisible by 4. If the work budget is exceeded, then \p *pdecided is set to \c false and nothing else
+ * is stored.
+ */
+
+CMR_ERROR CMRsmallTestBalanced(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,       /**< Ternary matrix with at most \ref CMR_SMALL_MAX rows and columns. */
+  bool* pdecided,           /**< Pointer for storing whether the test was completed. */
+  bool* pisBalanced,        /**< Pointer for storing whether \p matrix is balanced. */
+  CMR_SUBMAT** psubmatrix   /**< Pointer for storing a minimal nonbalanced submatrix (may be \c NULL). */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_SMALL_MATRIX_INTERNAL_H */
@@ -7,37 +7,197 @@
 extern "C" {
 #endif
 
+#define CMR_SORT_INSERTION_LENGTH 16 /**< Maximum length of a range that introsort sorts by insertion sort. */
+
 /**
- * \brief Sorts an array.
+ * \brief Defines the introsort functions \p NAME##Insertion, \p NAME##Heap and \p NAME##Intro on a \p NAME##Data.
  *
- * The user must provide a \p compare function that is called several times with pointers into the first array.
- * The arguments must be dereferenced once in order to access the actual element.
+ * Requires static inline functions \p NAME##Less(data, i, j) and \p NAME##Swap(data, i, j) that compare and swap the
+ * elements with indices \p i and \p j.
  */
 
-CMR_ERROR CMRsort(
-  CMR* cmr,                                 /**< \ref CMR environment. */
-  size_t length,                            /**< Number of elements in both arrays. */
-  void *array,                              /**< Pointer to the first element of the array.  */
-  size_t elementSize,                       /**< Size (in bytes) of each element of the array. */
-  int (*compare)(const void*, const void*)  /**< Comparison function for comparing two elements. */
-);
+#define CMR_SORT_DEFINE_INTRO(NAME) \
+  static inline void NAME##Insertion(NAME##Data* data, size_t first, size_t beyond) \
+  { \
+    for (size_t i = first + 1; i < beyond; ++i) \
+    { \
+      for (size_t j = i; j > first && NAME##Less(data, j, j - 1); --j) \
+        NAME##Swap(data, j, j - 1); \
+    } \
+  } \
+  \
+  static inline void NAME##SiftDown(NAME##Data* data, size_t first, size_t root, size_t length) \
+  { \
+    for (size_t child = 2 * root + 1; child < length; child = 2 * root + 1) \
+    { \
+      if (child + 1 < length && NAME##Less(data, first + child, first + child + 1)) \
+        ++child; \
+      if (!NAME##Less(data, first + root, first + child)) \
+        return; \
+      NAME##Swap(data, first + root, first + child); \
+      root = child; \
+    } \
+  } \
+  \
+  static inline void NAME##Heap(NAME##Data* data, size_t first, size_t beyond) \
+  { \
+    size_t length = beyond - first; \
+    for (size_t root = length / 2; root > 0; --root) \
+      NAME##SiftDown(data, first, root - 1, length); \
+    for (size_t last = length - 1; last > 0; --last) \
+    { \
+      NAME##Swap(data, first, first + last); \
+      NAME##SiftDown(data, first, 0, last); \
+    } \
+  } \
+  \
+  static inline void NAME##Intro(NAME##Data* data, size_t first, size_t beyond, size_t depth) \
+  { \
+    while (beyond - first > CMR_SORT_INSERTION_LENGTH) \
+    { \
+      if (depth == 0) \
+      { \
+        NAME##Heap(data, first, beyond); \
+        return; \
+      } \
+      --depth; \
+      \
+      /* Move the median of the first, middle and last element to the front as the pivot. */ \
+      size_t middle = first + (beyond - first) / 2; \
+      size_t last = beyond - 1; \
+      if (NAME##Less(data, middle, first)) \
+        NAME##Swap(data, middle, first); \
+      if (NAME##Less(data, last, middle)) \
+      { \
+        NAME##Swap(data, last, middle); \
+        if (NAME##Less(data, middle, first)) \
+          NAME##Swap(data, middle, first); \
+      } \
+      NAME##Swap(data, first, middle); \
+      \
+      size_t i = first; \
+      size_t j = beyond; \
+      while (true) \
+      { \
+        do \
+          ++i; \
+        while (i < beyond && NAME##Less(data, i, first)); \
+        do \
+          --j; \
+        while (NAME##Less(data, first, j)); \
+        if (i >= j) \
+          break; \
+        NAME##Swap(data, i, j); \
+      } \
+      NAME##Swap(data, first, j); \
+      \
+      /* Recurse into the smaller part and continue with the larger one. */ \
+      if (j - first < beyond - j) \
+      { \
+        NAME##Intro(data, first, j, depth); \
+        first = j + 1; \
+      } \
+      else \
+      { \
+        NAME##Intro(data, j + 1, beyond, depth); \
+        beyond = j; \
+      } \
+    } \
+    NAME##Insertion(data, first, beyond); \
+  } \
+  \
+  static inline size_t NAME##Depth(size_t length) \
+  { \
+    size_t depth = 0; \
+    while (length > 1) \
+    { \
+      length /= 2; \
+      depth += 2; \
+    } \
+    return depth; \
+  }
+
+/**
+ * \brief Defines a static inline function \p NAME(TYPE* array, size_t length) that sorts \p array by introsort.
+ *
+ * The macro \p LESS(a, b) must evaluate to \c true if and only if element \p a must be placed before \p b.
+ */
+
+#define CMR_SORT_DEFINE(NAME, TYPE, LESS) \
+  typedef struct \
+  { \
+    TYPE* array; \
+  } NAME##Data; \
+  \
+  static inline bool NAME##Less(NAME##Data* data, size_t i, size_t j) \
+  { \
+    return LESS(data->array[i], data->array[j]); \
+  } \
+  \
+  static inline void NAME##Swap(NAME##Data* data, size_t i, size_t j) \
+  { \
+    TYPE temp = data->array[i]; \
+    data->array[i] = data->array[j]; \
+    data->array[j] = temp; \
+  } \
+  \
+  CMR_SORT_DEFINE_INTRO(NAME) \
+  \
+  static inline void NAME(TYPE* array, size_t length) \
+  { \
+    NAME##Data data = { array }; \
+    if (length > 1) \
+      NAME##Intro(&data, 0, length, NAME##Depth(length)); \
+  }
+
+/**
+ * \brief Defines a static inline function \p NAME(KEYTYPE* keys, VALUETYPE* values, size_t length) that sorts
+ *        \p keys by introsort and permutes \p values in the same way.
+ *
+ * The macro \p LESS(a, b) must evaluate to \c true if and only if key \p a must be placed before key \p b.
+ */
+
+#define CMR_SORT_DEFINE_PAIRS(NAME, KEYTYPE, VALUETYPE, LESS) \
+  typedef struct \
+  { \
+    KEYTYPE* keys; \
+    VALUETYPE* values; \
+  } NAME##Data; \
+  \
+  static inline bool NAME##Less(NAME##Data* data, size_t i, size_t j) \
+  { \
+    return LESS(data->keys[i], data->keys[j]); \
+  } \
+  \
+  static inline void NAME##Swap(NAME##Data* data, size_t i, size_t j) \
+  { \
+    KEYTYPE tempKey = data->keys[i]; \
+    data->keys[i] = data->keys[j]; \
+    data->keys[j] = tempKey; \
+    VALUETYPE tempValue = data->values[i]; \
+    data->values[i] = data->values[j]; \
+    data->values[j] = tempValue; \
+  } \
+  \
+  CMR_SORT_DEFINE_INTRO(NAME) \
+  \
+  static inline void NAME(KEYTYPE* keys, VALUETYPE* values, size_t length) \
+  { \
+    NAME##Data data = { keys, values }; \
+    if (length > 1) \
+      NAME##Intro(&data, 0, length, NAME##Depth(length)); \
+  }
 
 /**
- * \brief Sorts two arrays simultaneously.
+ * \brief Sorts an array of \c size_t in ascending order.
  *
- * Sorts two arrays using the qsort function from the C library. The user must provide a \p compare function that is
- * called several times with pointers to pointers into the first array. Hence, the arguments must be dereferenced twice
- * in order to access the actual element.
+ * Short arrays are sorted by introsort and long ones by a radix sort that uses stack memory for a copy of the array.
  */
 
-CMR_ERROR CMRsort2(
-  CMR* cmr,                                     /**< \ref CMR environment. */
-  size_t length,                              /**< Number of elements in both arrays. */
-  void *array1,                               /**< Pointer to the first element of the first array.  */
-  size_t elementSize1,                        /**< Size (in bytes) of each element of the first array. */
-  void* array2,                               /**< Pointer to the first element of the second array.  */
-  size_t elementSize2,                        /**< Size (in bytes) of each element of the second array. */
-  int (*compare)(const void**, const void**)  /**< Comparison function for comparing two elements. */
+CMR_ERROR CMRsortSizet(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t* array,  /**< Array to be sorted. */
+  size_t length   /**< Number of elements of the array. */
 );
 
 #ifdef __cplusplus
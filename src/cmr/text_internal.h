@@ -0,0 +1,119 @@
+#ifndef CMR_TEXT_INTERNAL_H
+#define CMR_TEXT_INTERNAL_H
+
+/**
+ * \file text_internal.h
+ *
+ * \brief Locale-independent scanning of tokens for the text file formats.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Returns \c true if and only if \p c is a whitespace character in the "C" locale.
+ */
+
+static inline
+bool CMRtextIsSpace(
+  char c  /**< Character. */
+)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * \brief Parses the token from \p begin to \p end as a \c double.
+ *
+ * Decimal numbers with at most 19 significant digits whose mantissa and power of 10 are exactly representable are
+ * converted directly, which is correctly rounded. All other tokens are converted by \c strtod.
+ */
+
+static inline
+bool CMRtextParseDouble(
+  const char* begin,  /**< Beginning of the token. */
+  const char* end,    /**< End of the token; must point to a whitespace or null character. */
+  double* pvalue      /**< Pointer for storing the value. */
+)
+{
+  static const double powersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+    1e20, 1e21, 1e22
+  };
+
+  const char* p = begin;
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-'))
+    negative = *p++ == '-';
+
+  uint64_t mantissa = 0;
+  int numDigits = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p)
+  {
+    if (numDigits >= 19)
+      goto fallback;
+    mantissa = 10 * mantissa + (uint64_t) (*p - '0');
+    if (mantissa)
+      ++numDigits;
+    hasDigits = true;
+  }
+  if (p < end && *p == '.')
+  {
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
+    {
+      if (numDigits >= 19)
+        goto fallback;
+      mantissa = 10 * mantissa + (uint64_t) (*p - '0');
+      if (mantissa)
+        ++numDigits;
+      --exponent;
+      hasDigits = true;
+    }
+  }
+  if (!hasDigits)
+    goto fallback;
+  if (p < end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool negativeExponent = false;
+    if (p < end && (*p == '+' || *p == '-'))
+      negativeExponent = *p++ == '-';
+    if (p == end || end - p > 4)
+      goto fallback;
+    int value = 0;
+    for (; p < end; ++p)
+    {
+      if (*p < '0' || *p > '9')
+        goto fallback;
+      value = 10 * value + (*p - '0');
+    }
+    exponent += negativeExponent ? -value : value;
+  }
+  if (p != end || mantissa > (UINT64_C(1) << 53) || exponent < -22 || exponent > 22)
+    goto fallback;
+
+  double value = (double) mantissa;
+  value = exponent < 0 ? value / powersOf10[-exponent] : value * powersOf10[exponent];
+  *pvalue = negative ? -value : value;
+  return true;
+
+fallback:
+  {
+    char* stop = NULL;
+    *pvalue = strtod(begin, &stop);
+    return begin < end && stop == end;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_TEXT_INTERNAL_H */
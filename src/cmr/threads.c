@@ -0,0 +1,286 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* For binding threads to processors. */
+#endif /* __linux__ && !_GNU_SOURCE */
+
+#include "threads.h"
+#include "env_internal.h"
+#include "counters.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(CMR_WITH_THREADS) && defined(__linux__) && defined(CPU_SETSIZE)
+#define CMR_WITH_AFFINITY
+#endif /* CMR_WITH_THREADS && __linux__ && CPU_SETSIZE */
+
+#define MAX_NUMA_NODES 64 /**< Number of NUMA nodes whose processors are looked up. */
+
+static CMR_THREAD_LOCAL bool insideWorker = false; /**< Whether this thread executes a worker of \ref CMRthreadsRun. */
+static CMR_THREAD_LOCAL size_t pinnedProcessor = 0; /**< Processor plus 1 this thread was bound to, or 0. */
+
+size_t CMRthreadsProcessor(void)
+{
+  return pinnedProcessor;
+}
+
+size_t CMRthreadsNumWorkers(CMR* cmr, size_t maxWorkers)
+{
+  assert(cmr);
+
+#if defined(CMR_WITH_THREADS)
+  /* Nested parallel computations are carried out sequentially. */
+  size_t numWorkers = (cmr->numThreads > 1 && !insideWorker) ? (size_t) cmr->numThreads : 1;
+#else
+  size_t numWorkers = 1;
+#endif /* CMR_WITH_THREADS */
+
+  if (maxWorkers > 0 && numWorkers > maxWorkers)
+    numWorkers = maxWorkers;
+
+  return numWorkers;
+}
+
+/**
+ * \brief Data of a single worker of \ref CMRthreadsRun.
+ */
+
+typedef struct
+{
+  CMR* cmr;                     /**< \brief Environment of the worker. */
+  size_t worker;                /**< \brief Index of the worker. */
+  CMR_WORKER_FUNCTION function; /**< \brief Function to execute. */
+  void* data;                   /**< \brief User data. */
+  size_t processor;             /**< \brief Processor plus 1 to bind the worker to, or 0. */
+  CMR_ERROR error;              /**< \brief Return code of \ref function. */
+} WorkerData;
+
+#if defined(CMR_WITH_THREADS)
+
+static
+void* workerMain(void* arg)
+{
+  WorkerData* workerData = (WorkerData*) arg;
+  insideWorker = true;
+  pinnedProcessor = workerData->processor;
+  workerData->error = workerData->function(workerData->cmr, workerData->worker, workerData->data);
+  CMRreleaseStackChain(workerData->cmr);
+  CMRcountersCloseThread();
+
+  return NULL;
+}
+
+#endif /* CMR_WITH_THREADS */
+
+#if defined(CMR_WITH_AFFINITY)
+
+/**
+ * \brief Computes the processors that the calling thread may use, grouped by their NUMA node.
+ *
+ * The nodes' processors are read from sysfs. Processors whose node is unknown come last. If the affinity of the
+ * calling thread cannot be determined, \p *pnumProcessors is 0.
+ */
+
+static
+CMR_ERROR computeProcessorOrder(
+  CMR* cmr,               /**< \ref CMR environment. */
+  size_t** pprocessors,   /**< Pointer for storing the array of processors, to be freed by the caller. */
+  size_t* pnumProcessors  /**< Pointer for storing the number of processors. */
+)
+{
+  assert(cmr);
+  assert(pprocessors);
+  assert(pnumProcessors);
+
+  *pprocessors = NULL;
+  *pnumProcessors = 0;
+
+  cpu_set_t allowed;
+  if (pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0)
+    return CMR_OKAY;
+
+  size_t* processors = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &processors, (size_t) CPU_COUNT(&allowed)) );
+  size_t numProcessors = 0;
+  cpu_set_t added;
+  CPU_ZERO(&added);
+
+  for (int node = 0; node < MAX_NUMA_NODES; ++node)
+  {
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE* file = fopen(fileName, "r");
+    if (!file)
+      continue;
+
+    /* The list consists of ranges such as "0-7,16-23". */
+    unsigned long first;
+    while (fscanf(file, "%lu", &first) == 1)
+    {
+      unsigned long last = first;
+      int c = fgetc(file);
+      if (c == '-')
+      {
+        if (fscanf(file, "%lu", &last) != 1)
+          break;
+        c = fgetc(file);
+      }
+      for (unsigned long p = first; p <= last && p < CPU_SETSIZE; ++p)
+      {
+        if (CPU_ISSET(p, &allowed) && !CPU_ISSET(p, &added))
+        {
+          CPU_SET(p, &added);
+          processors[numProcessors++] = p;
+        }
+      }
+      if (c != ',')
+        break;
+    }
+    fclose(file);
+  }
+
+  for (size_t p = 0; p < CPU_SETSIZE; ++p)
+  {
+    if (CPU_ISSET(p, &allowed) && !CPU_ISSET(p, &added))
+      processors[numProcessors++] = p;
+  }
+
+  *pprocessors = processors;
+  *pnumProcessors = numProcessors;
+
+  return CMR_OKAY;
+}
+
+#endif /* CMR_WITH_AFFINITY */
+
+CMR_ERROR CMRthreadsRun(CMR* cmr, size_t numWorkers, CMR_WORKER_FUNCTION function, void* data)
+{
+  assert(cmr);
+  assert(numWorkers > 0);
+  assert(function);
+
+  if (numWorkers == 1)
+    return function(cmr, 0, data);
+
+  WorkerData* workers = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &workers, numWorkers) );
+  for (size_t w = 0; w < numWorkers; ++w)
+  {
+    workers[w].cmr = cmr;
+    workers[w].worker = w;
+    workers[w].function = function;
+    workers[w].data = data;
+    workers[w].processor = 0;
+    workers[w].error = CMR_OKAY;
+  }
+
+#if defined(CMR_WITH_THREADS)
+  pthread_t* threads = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &threads, numWorkers) );
+  bool* started = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &started, numWorkers) );
+#endif /* CMR_WITH_THREADS */
+
+#if defined(CMR_WITH_AFFINITY)
+  /* Consecutive workers are bound to processors of the same node. */
+  size_t* processors = NULL;
+  size_t numProcessors = 0;
+  if (cmr->pinThreads)
+    CMR_CALL( computeProcessorOrder(cmr, &processors, &numProcessors) );
+  for (size_t w = 0; w < numWorkers && numProcessors > 0; ++w)
+    workers[w].processor = processors[w % numProcessors] + 1;
+
+  /* The calling thread runs worker 0 and keeps its own memory, but is bound to its processor meanwhile. */
+  cpu_set_t callerAffinity;
+  bool restoreAffinity = false;
+  if (workers[0].processor)
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(workers[0].processor - 1, &set);
+    restoreAffinity = pthread_getaffinity_np(pthread_self(), sizeof(callerAffinity), &callerAffinity) == 0
+      && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+  }
+#endif /* CMR_WITH_AFFINITY */
+
+  /* Nothing below may return before the flag and the affinity are reset. */
+  insideWorker = true;
+
+#if defined(CMR_WITH_THREADS)
+  for (size_t w = 1; w < numWorkers; ++w)
+  {
+    /* A bound worker starts on its processor such that all its memory is touched first there. */
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+#if defined(CMR_WITH_AFFINITY)
+    if (workers[w].processor)
+    {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(workers[w].processor - 1, &set);
+      pthread_attr_setaffinity_np(&attributes, sizeof(set), &set);
+    }
+#endif /* CMR_WITH_AFFINITY */
+    started[w] = pthread_create(&threads[w], &attributes, workerMain, &workers[w]) == 0;
+    pthread_attr_destroy(&attributes);
+  }
+
+  /* Workers that could not be started are run on the calling thread afterwards. */
+  workers[0].error = function(cmr, 0, data);
+  for (size_t w = 1; w < numWorkers; ++w)
+  {
+    if (started[w])
+      pthread_join(threads[w], NULL);
+    else
+      workers[w].error = function(cmr, w, data);
+  }
+
+#else
+  for (size_t w = 0; w < numWorkers; ++w)
+    workers[w].error = function(cmr, w, data);
+#endif /* CMR_WITH_THREADS */
+
+  insideWorker = false;
+
+#if defined(CMR_WITH_AFFINITY)
+  if (restoreAffinity)
+    pthread_setaffinity_np(pthread_self(), sizeof(callerAffinity), &callerAffinity);
+  if (processors)
+    CMR_CALL( CMRfreeBlockArray(cmr, &processors) );
+#endif /* CMR_WITH_AFFINITY */
+#if defined(CMR_WITH_THREADS)
+  CMR_CALL( CMRfreeBlockArray(cmr, &started) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &threads) );
+#endif /* CMR_WITH_THREADS */
+
+  CMR_ERROR error = CMR_OKAY;
+  for (size_t w = 0; w < numWorkers && !error; ++w)
+    error = workers[w].error;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &workers) );
+
+  return error;
+}
+
+void CMRthreadsSplitRows(const size_t* rowSlice, size_t numRows, const size_t* rows, size_t numWorkers,
+  size_t* firstRows)
+{
+  size_t numNonzeros = rowSlice[numRows];
+  size_t row = 0;
+  size_t entries = 0;
+  firstRows[0] = 0;
+  for (size_t w = 1; w < numWorkers; ++w)
+  {
+    size_t targetEntry = (numNonzeros / numWorkers) * w;
+    while (row < numRows && entries < targetEntry)
+    {
+      size_t original = rows ? rows[row] : row;
+      entries += rowSlice[original + 1] - rowSlice[original];
+      ++row;
+    }
+    firstRows[w] = row;
+  }
+  firstRows[numWorkers] = numRows;
+}
@@ -0,0 +1,334 @@
+#ifndef CMR_THREADS_INTERNAL_H
+#define CMR_THREADS_INTERNAL_H
+
+/**
+ * \file threads.h
+ *
+ * \brief Minimal portability layer for multi-threading.
+ *
+ * If the library is compiled without thread support (see \ref CMR_WITH_THREADS), mutexes and condition variables are
+ * no-ops and \ref CMRthreadsRun executes all workers one after another on the calling thread.
+ */
+
+#include <cmr/env.h>
+
+#if defined(CMR_WITH_THREADS)
+#include <pthread.h>
+#endif /* CMR_WITH_THREADS */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Storage class specifier for variables that have one instance per thread.
+ */
+
+#if defined(CMR_WITH_THREADS)
+#define CMR_THREAD_LOCAL __thread
+#else
+#define CMR_THREAD_LOCAL
+#endif /* CMR_WITH_THREADS */
+
+/**
+ * \brief Mutex.
+ */
+
+typedef struct
+{
+#if defined(CMR_WITH_THREADS)
+  pthread_mutex_t mutex;  /**< \brief POSIX mutex. */
+#else
+  int dummy;              /**< \brief Unused. */
+#endif /* CMR_WITH_THREADS */
+} CMR_MUTEX;
+
+/**
+ * \brief Condition variable.
+ */
+
+typedef struct
+{
+#if defined(CMR_WITH_THREADS)
+  pthread_cond_t condition; /**< \brief POSIX condition variable. */
+#else
+  int dummy;                /**< \brief Unused. */
+#endif /* CMR_WITH_THREADS */
+} CMR_CONDITION;
+
+#if defined(CMR_WITH_THREADS)
+
+static inline
+void CMRmutexInit(CMR_MUTEX* mutex)
+{
+  pthread_mutex_init(&mutex->mutex, NULL);
+}
+
+static inline
+void CMRmutexFree(CMR_MUTEX* mutex)
+{
+  pthread_mutex_destroy(&mutex->mutex);
+}
+
+static inline
+void CMRmutexLock(CMR_MUTEX* mutex)
+{
+  pthread_mutex_lock(&mutex->mutex);
+}
+
+static inline
+void CMRmutexUnlock(CMR_MUTEX* mutex)
+{
+  pthread_mutex_unlock(&mutex->mutex);
+}
+
+static inline
+void CMRconditionInit(CMR_CONDITION* condition)
+{
+  pthread_cond_init(&condition->condition, NULL);
+}
+
+static inline
+void CMRconditionFree(CMR_CONDITION* condition)
+{
+  pthread_cond_destroy(&condition->condition);
+}
+
+/**
+ * \brief Releases \p mutex, waits for \p condition to be signaled and reacquires \p mutex.
+ */
+
+static inline
+void CMRconditionWait(CMR_CONDITION* condition, CMR_MUTEX* mutex)
+{
+  pthread_cond_wait(&condition->condition, &mutex->mutex);
+}
+
+static inline
+void CMRconditionBroadcast(CMR_CONDITION* condition)
+{
+  pthread_cond_broadcast(&condition->condition);
+}
+
+/**
+ * \brief Atomically adds \p increment to \p *pvalue and returns the previous value.
+ */
+
+static inline
+size_t CMRatomicFetchAdd(size_t* pvalue, size_t increment)
+{
+  return __atomic_fetch_add(pvalue, increment, __ATOMIC_RELAXED);
+}
+
+/**
+ * \brief Atomically reads a flag.
+ */
+
+static inline
+bool CMRatomicLoadFlag(bool* pflag)
+{
+  return __atomic_load_n(pflag, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * \brief Atomically sets a flag.
+ */
+
+static inline
+void CMRatomicStoreFlag(bool* pflag, bool value)
+{
+  __atomic_store_n(pflag, value, __ATOMIC_RELEASE);
+}
+
+/**
+ * \brief Atomically reads a value without ordering constraints.
+ */
+
+static inline
+size_t CMRatomicLoad(size_t* pvalue)
+{
+  return __atomic_load_n(pvalue, __ATOMIC_RELAXED);
+}
+
+/**
+ * \brief Atomically writes a value without ordering constraints.
+ */
+
+static inline
+void CMRatomicStore(size_t* pvalue, size_t value)
+{
+  __atomic_store_n(pvalue, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * \brief Atomically replaces \p *pvalue by \p desired if it is equal to \p expected.
+ *
+ * \returns Whether \p *pvalue was replaced.
+ */
+
+static inline
+bool CMRatomicCompareExchange(size_t* pvalue, size_t expected, size_t desired)
+{
+  return __atomic_compare_exchange_n(pvalue, &expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+#else /* !CMR_WITH_THREADS */
+
+static inline
+void CMRmutexInit(CMR_MUTEX* mutex)
+{
+  CMR_UNUSED(mutex);
+}
+
+static inline
+void CMRmutexFree(CMR_MUTEX* mutex)
+{
+  CMR_UNUSED(mutex);
+}
+
+static inline
+void CMRmutexLock(CMR_MUTEX* mutex)
+{
+  CMR_UNUSED(mutex);
+}
+
+static inline
+void CMRmutexUnlock(CMR_MUTEX* mutex)
+{
+  CMR_UNUSED(mutex);
+}
+
+static inline
+void CMRconditionInit(CMR_CONDITION* condition)
+{
+  CMR_UNUSED(condition);
+}
+
+static inline
+void CMRconditionFree(CMR_CONDITION* condition)
+{
+  CMR_UNUSED(condition);
+}
+
+static inline
+void CMRconditionWait(CMR_CONDITION* condition, CMR_MUTEX* mutex)
+{
+  CMR_UNUSED(condition);
+  CMR_UNUSED(mutex);
+}
+
+static inline
+void CMRconditionBroadcast(CMR_CONDITION* condition)
+{
+  CMR_UNUSED(condition);
+}
+
+static inline
+size_t CMRatomicFetchAdd(size_t* pvalue, size_t increment)
+{
+  size_t old = *pvalue;
+  *pvalue += increment;
+  return old;
+}
+
+static inline
+bool CMRatomicLoadFlag(bool* pflag)
+{
+  return *pflag;
+}
+
+static inline
+void CMRatomicStoreFlag(bool* pflag, bool value)
+{
+  *pflag = value;
+}
+
+static inline
+size_t CMRatomicLoad(size_t* pvalue)
+{
+  return *pvalue;
+}
+
+static inline
+void CMRatomicStore(size_t* pvalue, size_t value)
+{
+  *pvalue = value;
+}
+
+static inline
+bool CMRatomicCompareExchange(size_t* pvalue, size_t expected, size_t desired)
+{
+  if (*pvalue != expected)
+    return false;
+  *pvalue = desired;
+  return true;
+}
+
+#endif /* CMR_WITH_THREADS */
+
+/**
+ * \brief Function executed by each worker of \ref CMRthreadsRun.
+ *
+ * Every worker has its own stack memory in the shared \ref CMR environment.
+ */
+
+typedef CMR_ERROR (*CMR_WORKER_FUNCTION)(
+  CMR* cmr,       /**< \ref CMR environment of the worker. */
+  size_t worker,  /**< Index of the worker in \f$ \{0,1,\dotsc,\mathtt{numWorkers}-1\} \f$. */
+  void* data      /**< User data. */
+);
+
+/**
+ * \brief Returns the number of workers that shall be used for a parallel computation.
+ *
+ * This is the number of threads of the environment, but at most \p maxWorkers (unless \p maxWorkers is 0). Within a
+ * worker of \ref CMRthreadsRun, it is always 1, i.e., nested parallel computations run sequentially.
+ */
+
+size_t CMRthreadsNumWorkers(
+  CMR* cmr,         /**< \ref CMR environment. */
+  size_t maxWorkers /**< Upper bound on the useful number of workers, or 0 for no bound. */
+);
+
+/**
+ * \brief Returns the processor plus 1 that the calling thread was bound to by \ref CMRthreadsRun, or 0 if it is not
+ *        bound to a processor.
+ */
+
+size_t CMRthreadsProcessor(void);
+
+/**
+ * \brief Runs \p function on \p numWorkers workers and waits for all of them to finish.
+ *
+ * Worker 0 runs on the calling thread. The function must distribute the actual work itself, e.g., via
+ * \ref CMRatomicFetchAdd on a shared counter. If thread pinning is enabled (see \ref CMRsetThreadPinning), every
+ * worker is bound to a processor before it starts, such that memory it allocates is local to its NUMA node.
+ *
+ * \returns The first error reported by any of the workers, or \ref CMR_OKAY.
+ */
+
+CMR_ERROR CMRthreadsRun(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  size_t numWorkers,            /**< Number of workers. */
+  CMR_WORKER_FUNCTION function, /**< Function to execute. */
+  void* data                    /**< User data passed to \p function. */
+);
+
+/**
+ * \brief Splits the rows of a row-wise sparse matrix into \p numWorkers ranges with roughly the same number of
+ *        nonzeros.
+ */
+
+void CMRthreadsSplitRows(
+  const size_t* rowSlice, /**< Array of size \p numRows + 1 with the first nonzero of each row. */
+  size_t numRows,         /**< Number of rows. */
+  const size_t* rows,     /**< Permutation of the rows, or \c NULL for the identity. */
+  size_t numWorkers,      /**< Number of workers. */
+  size_t* firstRows       /**< Array of size \p numWorkers + 1 for storing the first (permuted) row of each worker. */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_THREADS_INTERNAL_H */
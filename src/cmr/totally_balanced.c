@@ -0,0 +1,552 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/balanced.h>
+
+#include "env_internal.h"
+#include "matrix_internal.h"
+#include "deadline.h"
+#include "sort.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * \file totally_balanced.c
+ *
+ * The test follows Lubiw (Doubly lexical orderings of matrices, SIAM Journal on Computing, 1987): a binary matrix is
+ * totally balanced if and only if a doubly lexical ordering of it does not contain \f$ \Gamma \f$ as a submatrix.
+ * Internally, rows and columns are ordered such that each row (read from its first entry) is lexicographically at least
+ * every later row and each column (read from its first entry) is lexicographically at least every later column. Then
+ * \f$ \Gamma \f$ appears with its rows and columns reversed, i.e., as rows \f$ i < j \f$ and columns \f$ k < l \f$ with
+ * \f$ M_{i,k} = 0 \f$ and \f$ M_{i,l} = M_{j,k} = M_{j,l} = 1 \f$. Both orders are reversed for the output.
+ *
+ * The columns are chosen greedily. The rows form an ordered partition that is refined by each chosen column, putting
+ * the rows with a 1 first. The next column is one whose vector of numbers of 1's in the parts (in their order) is
+ * lexicographically maximum. Hence, the rows are sorted by the chosen columns, and each chosen column is
+ * lexicographically at least the next one. The maximum is found by filtering the candidates part by part, skipping
+ * parts whose rows have no remaining columns. The filtering stops as soon as only one candidate remains or as soon as
+ * the candidates have fewer nonzeros than the next part, in which case their sorted part positions are compared
+ * directly. In the worst case, a choice takes time linear in the number of nonzeros.
+ */
+
+#define NONE SIZE_MAX /**< Marker for a missing row or part. */
+
+/**
+ * \brief Chooses among the candidate columns one whose vector of numbers of 1's in the parts is lexicographically
+ *        maximum by comparing the sorted starting positions of the parts of their rows.
+ */
+
+static
+CMR_ERROR totallyBalancedBestCandidate(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* transpose,    /**< Transpose of the matrix. */
+  size_t* rowsPart,         /**< Part of each row. */
+  size_t* partsFirst,       /**< First position of each part. */
+  size_t numCandidates,     /**< Number of candidate columns. */
+  size_t* candidates,       /**< Candidate columns. */
+  size_t* bestKey,          /**< Array of length equal to the number of rows for the key of the best candidate. */
+  size_t* key,              /**< Array of length equal to the number of rows for the key of a candidate. */
+  size_t* pbest             /**< Pointer for storing the best candidate. */
+)
+{
+  assert(cmr);
+  assert(numCandidates > 0);
+
+  size_t best = NONE;
+  size_t bestLength = 0;
+  for (size_t i = 0; i < numCandidates; ++i)
+  {
+    size_t column = candidates[i];
+    size_t length = 0;
+    for (size_t t = transpose->rowSlice[column]; t < transpose->rowSlice[column + 1]; ++t)
+      key[length++] = partsFirst[rowsPart[transpose->entryColumns[t]]];
+    CMR_CALL( CMRsortSizet(cmr, key, length) );
+
+    /* A smaller position at the first difference or a longer key means more 1's in an earlier part. */
+    bool isBetter = best == NONE;
+    if (!isBetter)
+    {
+      size_t j = 0;
+      while (j < length && j < bestLength && key[j] == bestKey[j])
+        ++j;
+      if (j < length && j < bestLength)
+        isBetter = key[j] < bestKey[j];
+      else
+        isBetter = length > bestLength;
+    }
+    if (isBetter)
+    {
+      best = column;
+      bestLength = length;
+      size_t* temp = bestKey;
+      bestKey = key;
+      key = temp;
+    }
+  }
+  *pbest = best;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Computes a doubly lexical ordering in which rows and columns are lexicographically nonincreasing.
+ */
+
+static
+CMR_ERROR totallyBalancedOrder(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,           /**< Binary matrix. */
+  CMR_CHRMAT* transpose,        /**< Transpose of \p matrix. */
+  size_t* rowsAtPosition,       /**< Array for storing the row at each position. */
+  size_t* columnsAtPosition,    /**< Array for storing the column at each position. */
+  CMR_DEADLINE* deadline        /**< Deadline. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(transpose);
+
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+
+  size_t* rowsPosition = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsPosition, numRows) );
+  size_t* rowsPart = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsPart, numRows) );
+  size_t* rowsNumRemaining = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsNumRemaining, numRows) );
+  size_t* partsFirst = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &partsFirst, numRows + 1) );
+  size_t* partsSize = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &partsSize, numRows + 1) );
+  size_t* partsMoved = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &partsMoved, numRows + 1) );
+  size_t* partsNumRemaining = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &partsNumRemaining, numRows + 1) );
+  size_t* partsPrev = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &partsPrev, numRows + 1) );
+  size_t* partsNext = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &partsNext, numRows + 1) );
+  size_t* touchedParts = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &touchedParts, numRows + 1) );
+  size_t* entriesColumn = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &entriesColumn, matrix->numNonzeros) );
+  size_t* entriesTranspose = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &entriesTranspose, matrix->numNonzeros) );
+  size_t* transposeEntries = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &transposeEntries, matrix->numNonzeros) );
+  size_t* remaining = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &remaining, numColumns) );
+  size_t* remainingIndex = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &remainingIndex, numColumns) );
+  size_t* candidates = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &candidates, numColumns) );
+  size_t* counted = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &counted, numColumns) );
+  size_t* columnsCount = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsCount, numColumns) );
+  size_t* columnsCountStamp = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsCountStamp, numColumns) );
+  size_t* columnsCandidate = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsCandidate, numColumns) );
+  size_t* bestKey = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &bestKey, numRows) );
+  size_t* key = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &key, numRows) );
+
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    remaining[column] = column;
+    remainingIndex[column] = column;
+    columnsCountStamp[column] = 0;
+    columnsCandidate[column] = 0;
+    columnsCount[column] = transpose->rowSlice[column];
+  }
+  size_t numRemaining = numColumns;
+  size_t countStamp = 0;
+  size_t candidateStamp = 0;
+
+  /* The not yet chosen columns of each row come first in its slice, and entries know their transpose entries. */
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    rowsNumRemaining[row] = matrix->rowSlice[row + 1] - matrix->rowSlice[row];
+    for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+    {
+      size_t column = matrix->entryColumns[e];
+      entriesColumn[e] = column;
+      entriesTranspose[e] = columnsCount[column];
+      transposeEntries[columnsCount[column]++] = e;
+    }
+  }
+
+  /* Initially, all rows form one part (if any). */
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    rowsAtPosition[row] = row;
+    rowsPosition[row] = row;
+    rowsPart[row] = 0;
+  }
+  partsFirst[0] = 0;
+  partsSize[0] = numRows;
+  partsMoved[0] = 0;
+  partsNumRemaining[0] = matrix->numNonzeros;
+  partsPrev[0] = NONE;
+  partsNext[0] = NONE;
+  size_t numParts = numRows ? 1 : 0;
+
+  /* The parts whose rows have remaining columns are linked in their order. */
+  size_t firstPart = matrix->numNonzeros ? 0 : NONE;
+
+  CMR_ERROR error = CMR_OKAY;
+  for (size_t chosen = 0; chosen < numColumns; ++chosen)
+  {
+    if (CMRdeadlinePassed(deadline))
+    {
+      error = CMR_ERROR_TIMEOUT;
+      break;
+    }
+
+    /* Filter the candidates part by part. As long as all remaining columns are candidates, they are implicit. */
+    bool allCandidates = true;
+    size_t numCandidates = numRemaining;
+    size_t candidatesNumEntries = 0;
+    size_t column = NONE;
+    for (size_t part = firstPart; part != NONE && numCandidates > 1; part = partsNext[part])
+    {
+      /* If the part has more entries than the candidates, we compare the candidates directly. */
+      if (!allCandidates && candidatesNumEntries < partsNumRemaining[part])
+      {
+        CMR_CALL( totallyBalancedBestCandidate(cmr, transpose, rowsPart, partsFirst, numCandidates, candidates,
+          bestKey, key, &column) );
+        break;
+      }
+
+      ++countStamp;
+      size_t maxCount = 0;
+      size_t numCounted = 0;
+      for (size_t position = partsFirst[part]; position < partsFirst[part] + partsSize[part]; ++position)
+      {
+        size_t row = rowsAtPosition[position];
+        size_t first = matrix->rowSlice[row];
+        for (size_t e = first; e < first + rowsNumRemaining[row]; ++e)
+        {
+          size_t column = entriesColumn[e];
+          if (!allCandidates && columnsCandidate[column] != candidateStamp)
+            continue;
+          if (columnsCountStamp[column] != countStamp)
+          {
+            columnsCountStamp[column] = countStamp;
+            columnsCount[column] = 0;
+            counted[numCounted++] = column;
+          }
+          if (++columnsCount[column] > maxCount)
+            maxCount = columnsCount[column];
+        }
+      }
+
+      /* If no candidate has a 1 in the part, then all candidates remain. */
+      if (maxCount == 0)
+        continue;
+
+      ++candidateStamp;
+      numCandidates = 0;
+      candidatesNumEntries = 0;
+      for (size_t i = 0; i < numCounted; ++i)
+      {
+        size_t column = counted[i];
+        if (columnsCount[column] == maxCount)
+        {
+          candidates[numCandidates++] = column;
+          columnsCandidate[column] = candidateStamp;
+          candidatesNumEntries += transpose->rowSlice[column + 1] - transpose->rowSlice[column];
+        }
+      }
+      allCandidates = false;
+    }
+
+    if (column == NONE)
+      column = allCandidates ? remaining[0] : candidates[0];
+    CMRdbgMsg(2, "Position %zu is column c%zu.\n", chosen, column+1);
+    columnsAtPosition[chosen] = column;
+    --numRemaining;
+    remaining[remainingIndex[column]] = remaining[numRemaining];
+    remainingIndex[remaining[numRemaining]] = remainingIndex[column];
+
+    /* Remove the column from the remaining ones of its rows. */
+    for (size_t t = transpose->rowSlice[column]; t < transpose->rowSlice[column + 1]; ++t)
+    {
+      size_t row = transpose->entryColumns[t];
+      size_t e = transposeEntries[t];
+      size_t last = matrix->rowSlice[row] + --rowsNumRemaining[row];
+      entriesColumn[e] = entriesColumn[last];
+      entriesColumn[last] = column;
+      size_t lastTranspose = entriesTranspose[last];
+      entriesTranspose[last] = t;
+      entriesTranspose[e] = lastTranspose;
+      transposeEntries[lastTranspose] = e;
+      transposeEntries[t] = last;
+      --partsNumRemaining[rowsPart[row]];
+    }
+
+    /* Refine the rows such that those with a 1 in the column come first within their part. */
+    size_t numTouchedParts = 0;
+    for (size_t t = transpose->rowSlice[column]; t < transpose->rowSlice[column + 1]; ++t)
+    {
+      size_t row = transpose->entryColumns[t];
+      size_t part = rowsPart[row];
+      if (partsMoved[part] == 0)
+        touchedParts[numTouchedParts++] = part;
+      size_t target = partsFirst[part] + partsMoved[part];
+      size_t otherRow = rowsAtPosition[target];
+      rowsAtPosition[rowsPosition[row]] = otherRow;
+      rowsPosition[otherRow] = rowsPosition[row];
+      rowsAtPosition[target] = row;
+      rowsPosition[row] = target;
+      ++partsMoved[part];
+    }
+    for (size_t i = 0; i < numTouchedParts; ++i)
+    {
+      size_t part = touchedParts[i];
+      size_t moved = partsMoved[part];
+      partsMoved[part] = 0;
+      bool isListed = partsPrev[part] != NONE || firstPart == part;
+      if (moved < partsSize[part])
+      {
+        size_t newPart = numParts++;
+        partsFirst[newPart] = partsFirst[part];
+        partsSize[newPart] = moved;
+        partsMoved[newPart] = 0;
+        partsNumRemaining[newPart] = 0;
+        partsPrev[newPart] = NONE;
+        partsNext[newPart] = NONE;
+        partsFirst[part] += moved;
+        partsSize[part] -= moved;
+        for (size_t position = partsFirst[newPart]; position < partsFirst[part]; ++position)
+        {
+          size_t row = rowsAtPosition[position];
+          rowsPart[row] = newPart;
+          partsNumRemaining[newPart] += rowsNumRemaining[row];
+        }
+        partsNumRemaining[part] -= partsNumRemaining[newPart];
+
+        /* The new part is inserted before the old one. */
+        if (isListed && partsNumRemaining[newPart] > 0)
+        {
+          partsPrev[newPart] = partsPrev[part];
+          partsNext[newPart] = part;
+          if (partsPrev[part] == NONE)
+            firstPart = newPart;
+          else
+            partsNext[partsPrev[part]] = newPart;
+          partsPrev[part] = newPart;
+        }
+      }
+
+      /* Parts whose rows have no remaining columns are removed from the list. */
+      if (isListed && partsNumRemaining[part] == 0)
+      {
+        if (partsPrev[part] == NONE)
+          firstPart = partsNext[part];
+        else
+          partsNext[partsPrev[part]] = partsNext[part];
+        if (partsNext[part] != NONE)
+          partsPrev[partsNext[part]] = partsPrev[part];
+        partsPrev[part] = NONE;
+        partsNext[part] = NONE;
+      }
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &key) );
+  CMR_CALL( CMRfreeStackArray(cmr, &bestKey) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsCandidate) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsCountStamp) );
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsCount) );
+  CMR_CALL( CMRfreeStackArray(cmr, &counted) );
+  CMR_CALL( CMRfreeStackArray(cmr, &candidates) );
+  CMR_CALL( CMRfreeStackArray(cmr, &remainingIndex) );
+  CMR_CALL( CMRfreeStackArray(cmr, &remaining) );
+  CMR_CALL( CMRfreeStackArray(cmr, &transposeEntries) );
+  CMR_CALL( CMRfreeStackArray(cmr, &entriesTranspose) );
+  CMR_CALL( CMRfreeStackArray(cmr, &entriesColumn) );
+  CMR_CALL( CMRfreeStackArray(cmr, &touchedParts) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partsNext) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partsPrev) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partsNumRemaining) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partsMoved) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partsSize) );
+  CMR_CALL( CMRfreeStackArray(cmr, &partsFirst) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsNumRemaining) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsPart) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsPosition) );
+
+  return error;
+}
+
+/**
+ * \brief Searches the ordered matrix for \f$ \Gamma \f$ with rows and columns reversed.
+ *
+ * It suffices to check, for each 1 at \f$ (j,l) \f$, the previous 1 \f$ (i,l) \f$ in its column and the previous
+ * 1 \f$ (j,k) \f$ in its row: a minimal occurrence of \f$ \Gamma \f$ always has \f$ M_{i,k} = 0 \f$ for these.
+ */
+
+static
+CMR_ERROR totallyBalancedSearchGamma(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,           /**< Binary matrix. */
+  CMR_CHRMAT* transpose,        /**< Transpose of \p matrix. */
+  size_t* rowsAtPosition,       /**< Row at each position. */
+  size_t* columnsAtPosition,    /**< Column at each position. */
+  size_t* gamma                 /**< Array for storing the positions \f$ i, j, k, l \f$ of an occurrence, or
+                                 **  \ref NONE as its first entry if there is none. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(transpose);
+  assert(gamma);
+
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+
+  /* Sort the entries of each row by the positions of their columns. */
+  size_t* sortedColumns = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &sortedColumns, matrix->numNonzeros) );
+  size_t* rowsFill = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsFill, numRows) );
+  for (size_t row = 0; row < numRows; ++row)
+    rowsFill[row] = matrix->rowSlice[row];
+  for (size_t position = 0; position < numColumns; ++position)
+  {
+    size_t column = columnsAtPosition[position];
+    for (size_t e = transpose->rowSlice[column]; e < transpose->rowSlice[column + 1]; ++e)
+      sortedColumns[rowsFill[transpose->entryColumns[e]]++] = position;
+  }
+
+  size_t* columnsLastRow = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsLastRow, numColumns) );
+  for (size_t position = 0; position < numColumns; ++position)
+    columnsLastRow[position] = NONE;
+
+  gamma[0] = NONE;
+  for (size_t j = 0; j < numRows && gamma[0] == NONE; ++j)
+  {
+    size_t row = rowsAtPosition[j];
+    size_t first = matrix->rowSlice[row];
+    for (size_t e = first; e < matrix->rowSlice[row + 1]; ++e)
+    {
+      size_t l = sortedColumns[e];
+      size_t i = columnsLastRow[l];
+      columnsLastRow[l] = j;
+      if (e == first || i == NONE)
+        continue;
+
+      /* Binary search for the previous column of row j in row i. */
+      size_t k = sortedColumns[e - 1];
+      size_t otherRow = rowsAtPosition[i];
+      size_t lower = matrix->rowSlice[otherRow];
+      size_t upper = matrix->rowSlice[otherRow + 1];
+      while (lower < upper)
+      {
+        size_t middle = (lower + upper) / 2;
+        if (sortedColumns[middle] < k)
+          lower = middle + 1;
+        else
+          upper = middle;
+      }
+      if (lower == matrix->rowSlice[otherRow + 1] || sortedColumns[lower] != k)
+      {
+        CMRdbgMsg(2, "Found Gamma at row positions %zu and %zu and column positions %zu and %zu.\n", i, j, k, l);
+        gamma[0] = i;
+        gamma[1] = j;
+        gamma[2] = k;
+        gamma[3] = l;
+        break;
+      }
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsLastRow) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsFill) );
+  CMR_CALL( CMRfreeStackArray(cmr, &sortedColumns) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRtotallyBalancedTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisTotallyBalanced, size_t* rowsOrder,
+  size_t* columnsOrder, CMR_SUBMAT** psubmatrix, CMR_BALANCED_STATS* stats, double timeLimit)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pisTotallyBalanced);
+
+  CMRdbgMsg(0, "Called CMRtotallyBalancedTest for a %zux%zu matrix.\n", matrix->numRows, matrix->numColumns);
+
+  double startClock = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
+
+  if (!CMRchrmatIsBinary(cmr, matrix, psubmatrix))
+  {
+    *pisTotallyBalanced = false;
+    if (stats)
+    {
+      stats->totalCount++;
+      stats->totalTime += CMRclockNow() - startClock;
+    }
+    return CMR_OKAY;
+  }
+
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+
+  CMR_CHRMAT* transpose = NULL;
+  CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+  size_t* rowsAtPosition = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsAtPosition, numRows) );
+  size_t* columnsAtPosition = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnsAtPosition, numColumns) );
+
+  CMR_ERROR error = totallyBalancedOrder(cmr, matrix, transpose, rowsAtPosition, columnsAtPosition, &deadline);
+  if (error == CMR_OKAY)
+  {
+    size_t gamma[4] = { NONE, NONE, NONE, NONE };
+    CMR_CALL( totallyBalancedSearchGamma(cmr, matrix, transpose, rowsAtPosition, columnsAtPosition, gamma) );
+    *pisTotallyBalanced = gamma[0] == NONE;
+
+    /* The occurrence of Gamma is stored as in the reversed orders. */
+    if (!*pisTotallyBalanced && psubmatrix)
+    {
+      CMR_CALL( CMRsubmatCreate(cmr, 2, 2, psubmatrix) );
+      (*psubmatrix)->rows[0] = rowsAtPosition[gamma[1]];
+      (*psubmatrix)->rows[1] = rowsAtPosition[gamma[0]];
+      (*psubmatrix)->columns[0] = columnsAtPosition[gamma[3]];
+      (*psubmatrix)->columns[1] = columnsAtPosition[gamma[2]];
+    }
+
+    if (rowsOrder)
+    {
+      for (size_t position = 0; position < numRows; ++position)
+        rowsOrder[position] = rowsAtPosition[numRows - 1 - position];
+    }
+    if (columnsOrder)
+    {
+      for (size_t position = 0; position < numColumns; ++position)
+        columnsOrder[position] = columnsAtPosition[numColumns - 1 - position];
+    }
+  }
+  else if (error != CMR_ERROR_TIMEOUT)
+    CMR_CALL( error );
+
+  CMR_CALL( CMRfreeStackArray(cmr, &columnsAtPosition) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsAtPosition) );
+  CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+
+  if (stats)
+  {
+    stats->totalCount++;
+    stats->totalTime += CMRclockNow() - startClock;
+  }
+
+  return error;
+}
@@ -0,0 +1,122 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include "trace.h"
+#include "deadline.h"
+#include "env_internal.h"
+
+#include <assert.h>
+#include <stdarg.h>
+
+static size_t nextTraceId = 1; /**< Identifier of the next trace; accessed atomically. */
+
+/**
+ * \brief Index of the calling thread in the trace with identifier \ref traceThreadId.
+ */
+
+static CMR_THREAD_LOCAL size_t traceThread = 0;
+
+/**
+ * \brief Identifier of the trace for which \ref traceThread is valid, or 0.
+ */
+
+static CMR_THREAD_LOCAL size_t traceThreadId = 0;
+
+CMR_ERROR CMRtraceStart(CMR* cmr, FILE* stream)
+{
+  assert(cmr);
+  assert(stream);
+
+  if (cmr->trace)
+    CMR_CALL( CMRtraceStop(cmr) );
+
+  if (fputs("[\n", stream) == EOF)
+    return CMR_ERROR_OUTPUT;
+
+  cmr->trace = stream;
+  cmr->traceId = CMRatomicFetchAdd(&nextTraceId, 1);
+  cmr->traceStart = CMRclockNow();
+  cmr->traceNumEvents = 0;
+  cmr->traceNumThreads = 0;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRtraceStop(CMR* cmr)
+{
+  assert(cmr);
+
+  if (!cmr->trace)
+    return CMR_OKAY;
+
+  FILE* stream = cmr->trace;
+  cmr->trace = NULL;
+  if (fputs("\n]\n", stream) == EOF || fflush(stream) == EOF)
+    return CMR_ERROR_OUTPUT;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Writes the common members of an event of the calling thread, leaving the JSON object open.
+ *
+ * Must be called while holding the mutex of \p cmr.
+ */
+
+static
+void traceWriteHeader(
+  CMR* cmr,         /**< \ref CMR environment. */
+  const char* name, /**< Name of the event. */
+  char phase        /**< Phase of the event, i.e., \c 'B' or \c 'E'. */
+)
+{
+  double timestamp = (CMRclockNow() - cmr->traceStart) * 1.0e6;
+
+  /* Threads get consecutive indices in the order of their first event; each is announced by a metadata event. */
+  if (traceThreadId != cmr->traceId)
+  {
+    traceThreadId = cmr->traceId;
+    traceThread = cmr->traceNumThreads++;
+    fprintf(cmr->trace, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,"
+      "\"args\":{\"name\":\"thread %zu\"}}", cmr->traceNumEvents++ ? ",\n" : "", traceThread, traceThread);
+  }
+
+  fprintf(cmr->trace, "%s{\"name\":\"%s\",\"cat\":\"cmr\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%zu",
+    cmr->traceNumEvents++ ? ",\n" : "", name, phase, timestamp, traceThread);
+}
+
+void CMRtraceWriteBegin(CMR* cmr, const char* name, const char* argsFormat, ...)
+{
+  assert(cmr);
+  assert(name);
+
+  CMRmutexLock(&cmr->mutex);
+  if (cmr->trace)
+  {
+    traceWriteHeader(cmr, name, 'B');
+    if (argsFormat)
+    {
+      va_list args;
+      fputs(",\"args\":{", cmr->trace);
+      va_start(args, argsFormat);
+      vfprintf(cmr->trace, argsFormat, args);
+      va_end(args);
+      fputc('}', cmr->trace);
+    }
+    fputc('}', cmr->trace);
+  }
+  CMRmutexUnlock(&cmr->mutex);
+}
+
+void CMRtraceWriteEnd(CMR* cmr, const char* name)
+{
+  assert(cmr);
+  assert(name);
+
+  CMRmutexLock(&cmr->mutex);
+  if (cmr->trace)
+  {
+    traceWriteHeader(cmr, name, 'E');
+    fputc('}', cmr->trace);
+  }
+  CMRmutexUnlock(&cmr->mutex);
+}
@@ -0,0 +1,61 @@
+#ifndef CMR_TRACE_INTERNAL_H
+#define CMR_TRACE_INTERNAL_H
+
+/**
+ * \file trace.h
+ *
+ * \brief Recording of begin and end events in the Chrome trace-event format.
+ *
+ * Tracing is enabled via \ref CMRtraceStart. Every event is written as one line of the JSON array, together with the
+ * time since the start of the trace in microseconds and the index of the calling thread. Events of the same thread
+ * must be properly nested.
+ */
+
+#include <cmr/env.h>
+
+#include "env_internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Writes a begin event named \p name, whose members of the \c args object are given in printf-style.
+ *
+ * \p argsFormat must produce a comma-separated list of JSON members, e.g., <tt>"rows":%zu,"columns":%zu</tt>, or be
+ * \c NULL.
+ */
+
+void CMRtraceWriteBegin(
+  CMR* cmr,               /**< \ref CMR environment. */
+  const char* name,       /**< Name of the event. */
+  const char* argsFormat, /**< Format of the members of the \c args object, or \c NULL. */
+  ...                     /**< Variadic arguments in printf-style. */
+);
+
+/**
+ * \brief Writes an end event named \p name.
+ */
+
+void CMRtraceWriteEnd(
+  CMR* cmr,         /**< \ref CMR environment. */
+  const char* name  /**< Name of the event. */
+);
+
+/**
+ * \brief Returns \c true if and only if tracing is enabled for \p cmr.
+ */
+
+static inline
+bool CMRtraceEnabled(
+  CMR* cmr  /**< \ref CMR environment. */
+)
+{
+  return cmr->trace != NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_TRACE_INTERNAL_H */
@@ -1,16 +1,22 @@
 // #define CMR_DEBUG /* Uncomment to debug this file. */
 
 #include <cmr/tu.h>
+#include <cmr/consecutive_ones.h>
+#include <cmr/series_parallel.h>
 
 #include "matrix_internal.h"
 #include "block_decomposition.h"
 #include "camion_internal.h"
 #include "regularity_internal.h"
 #include "hereditary_property.h"
+#include "threads.h"
+#include "bitset.h"
+#include "deadline.h"
+#include "intersect.h"
+#include "small_matrix.h"
 
 #include <stdlib.h>
 #include <assert.h>
-#include <time.h>
 
 CMR_ERROR CMRtuParamsInit(CMR_TU_PARAMS* params)
 {
@@ -18,6 +24,8 @@ CMR_ERROR CMRtuParamsInit(CMR_TU_PARAMS* params)
 
   params->algorithm = CMR_TU_ALGORITHM_DECOMPOSITION;
   params->directCamion = false;
+  params->directTwoByTwo = false;
+  params->directConsecutiveOnes = false;
   CMR_CALL( CMRregularParamsInit(&params->regular) );
 
   return CMR_OKAY;
@@ -40,6 +48,22 @@ CMR_ERROR CMRtuStatsInit(CMR_TU_STATS* stats)
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRtuStatsAdd(CMR_TU_STATS* target, CMR_TU_STATS* source)
+{
+  assert(target);
+  assert(source);
+
+  CMR_CALL( CMRregularStatsAdd(&target->decomposition, &source->decomposition) );
+  target->enumerationRowSubsets += source->enumerationRowSubsets;
+  target->enumerationColumnSubsets += source->enumerationColumnSubsets;
+  target->enumerationTime += source->enumerationTime;
+  target->partitionRowSubsets += source->partitionRowSubsets;
+  target->partitionColumnSubsets += source->partitionColumnSubsets;
+  target->partitionTime += source->partitionTime;
+
+  return CMR_OKAY;
+}
+
 CMR_ERROR CMRtuStatsPrint(FILE* stream, CMR_TU_STATS* stats, const char* prefix)
 {
   assert(stream);
@@ -66,6 +90,23 @@ CMR_ERROR CMRtuStatsPrint(FILE* stream, CMR_TU_STATS* stats, const char* prefix)
   return CMR_OKAY;
 }
 
+CMR_ERROR CMRtuStatsPrintJson(FILE* stream, CMR_TU_STATS* stats)
+{
+  assert(stream);
+  assert(stats);
+
+  fprintf(stream, "{\"regularity\":");
+  CMR_CALL( CMRregularStatsPrintJson(stream, &stats->decomposition) );
+  fprintf(stream, ",\"enumeration-row-subsets\":%lu", (unsigned long)stats->enumerationRowSubsets);
+  fprintf(stream, ",\"enumeration-column-subsets\":%lu", (unsigned long)stats->enumerationColumnSubsets);
+  fprintf(stream, ",\"enumeration-time\":%.9g", stats->enumerationTime);
+  fprintf(stream, ",\"partition-row-subsets\":%lu", (unsigned long)stats->partitionRowSubsets);
+  fprintf(stream, ",\"partition-column-subsets\":%lu", (unsigned long)stats->partitionColumnSubsets);
+  fprintf(stream, ",\"partition-time\":%.9g}", stats->partitionTime);
+
+  return CMR_OKAY;
+}
+
 static
 CMR_ERROR tuDecomposition(
   CMR* cmr,                   /**< \ref CMR environment. */
@@ -92,18 +133,58 @@ CMR_ERROR tuDecomposition(
 #endif /* CMR_DEBUG */
 
   *pisTotallyUnimodular = true;
-  clock_t time = clock();
 
   CMR_TU_PARAMS params; /* TODO: We should supply some params?! */
   CMR_CALL( CMRtuParamsInit(&params) );
-  double remainingTime = timeLimit - ((clock() - time) * 1.0 / CLOCKS_PER_SEC);
   CMR_CALL( CMRtuTest(cmr, matrix, pisTotallyUnimodular, NULL, NULL, &params,
-    stats ? stats : NULL, remainingTime) );
+    stats ? stats : NULL, timeLimit) );
 
   return CMR_OKAY;
 }
 
 
+/**
+ * \brief Searches for a minimal non-totally unimodular submatrix of \p matrix.
+ *
+ * Several removals of rows and columns are tested concurrently, each worker with its own statistics.
+ */
+
+static
+CMR_ERROR tuSearchSubmatrix(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,       /**< Non-totally unimodular matrix. */
+  CMR_TU_STATS* stats,      /**< Statistics for the computation (may be \c NULL). */
+  CMR_SUBMAT** psubmatrix,  /**< Pointer for storing the submatrix. */
+  double timeLimit          /**< Time limit to impose. */
+)
+{
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, matrix->numRows + matrix->numColumns);
+  void** testData = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &testData, numWorkers) );
+  CMR_TU_STATS* workerStats = NULL;
+  if (stats)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, &workerStats, numWorkers) );
+    for (size_t w = 0; w < numWorkers; ++w)
+      CMR_CALL( CMRtuStatsInit(&workerStats[w]) );
+  }
+  for (size_t w = 0; w < numWorkers; ++w)
+    testData[w] = stats ? &workerStats[w] : NULL;
+
+  CMR_ERROR error = CMRtestHereditaryPropertyParallel(cmr, matrix, tuDecomposition, numWorkers, testData, psubmatrix,
+    timeLimit);
+
+  if (stats)
+  {
+    for (size_t w = 0; w < numWorkers; ++w)
+      CMR_CALL( CMRtuStatsAdd(stats, &workerStats[w]) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &workerStats) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &testData) );
+
+  return error;
+}
+
 /**
  * \brief Data for enumeration.
  */
@@ -112,12 +193,16 @@ typedef struct
 {
   CMR* cmr;                     /**< \ref CMR environment. */
   CMR_CHRMAT* matrix;           /**< Matrix \f$ M \f$. */
+  CMR_CHRMAT* transpose;        /**< Transpose of \f$ M \f$ (if more than 64 rows). */
+  size_t* commonRows;           /**< Array for the positions of a column's rows in \ref subsetRows. */
+  size_t* commonEntries;        /**< Array for the entries of \ref transpose in a column and in \ref subsetRows. */
   bool* pisTotallyUnimodular;   /**< Pointer for storing whether \f$ M \f$ is totally unimodular. */
   CMR_SUBMAT** psubmatrix;      /**< Pointer for storing a minimal nonbalanced submatrix (may be \c NULL). */
   CMR_TU_STATS* stats;          /**< Statistics for the computation (may be \c NULL). */
-  double timeLimit;             /**< Time limit to impose. */
+  CMR_DEADLINE deadline;        /**< Deadline of the computation. */
+  size_t deadlineTicks;         /**< Counter for checking the deadline. */
+  bool timeout;                 /**< Whether the deadline has passed. */
   bool isTransposed;            /**< Whether we're dealing with the transposed matrix. */
-  clock_t startClock;           /**< Clock for when we started. */
   size_t cardinality;           /**< Current cardinality of row/column subsets. */
   size_t* subsetRows;           /**< Array for the enumerated row subset. */
   size_t* usableColumns;        /**< Array of columns usable for enumeration. */
@@ -126,6 +211,9 @@ typedef struct
   size_t* columnsNumNonzeros;   /**< Array with the number of nonzeros per column. */
   size_t* rowsNumNonzeros;      /**< Array with the number of nonzeros per row. */
   int sumEntries;               /**< Sum of the entries of the selected submatrix. */
+  uint64_t* columnsPositive;    /**< Array with the bitset of rows with a +1-entry per column (if at most 64 rows). */
+  uint64_t* columnsNegative;    /**< Array with the bitset of rows with a -1-entry per column (if at most 64 rows). */
+  uint64_t rowSubset;           /**< Bitset of the enumerated row subset (if at most 64 rows). */
 } CMR_TU_ENUMERATION;
 
 
@@ -157,16 +245,15 @@ CMR_ERROR tuEulerianColumns(
       enumeration->subsetUsable[numColumns] = usable;
 
       /* Increment row nonzero counters. */
-      for (size_t i = 0; i < enumeration->cardinality; ++i)
+      CMR_CHRMAT* transpose = enumeration->transpose;
+      size_t first = transpose->rowSlice[column];
+      size_t numCommon = CMRintersectEmit(enumeration->subsetRows, enumeration->cardinality,
+        &transpose->entryColumns[first], transpose->rowSlice[column + 1] - first, enumeration->commonRows,
+        enumeration->commonEntries);
+      for (size_t i = 0; i < numCommon; ++i)
       {
-        size_t row = enumeration->subsetRows[i];
-        size_t entry;
-        CMRchrmatFindEntry(enumeration->matrix, row, column, &entry);
-        if (entry != SIZE_MAX)
-        {
-          enumeration->sumEntries += enumeration->matrix->entryValues[entry];
-          enumeration->rowsNumNonzeros[row]++;
-        }
+        enumeration->sumEntries += transpose->entryValues[first + enumeration->commonEntries[i]];
+        enumeration->rowsNumNonzeros[enumeration->subsetRows[enumeration->commonRows[i]]]++;
       }
 
       /* Recurse. */
@@ -174,17 +261,14 @@ CMR_ERROR tuEulerianColumns(
       if (!*enumeration->pisTotallyUnimodular)
         return CMR_OKAY;
 
-      /* Decrement row nonzero counters. */
-      for (size_t i = 0; i < enumeration->cardinality; ++i)
+      /* Decrement row nonzero counters; the recursion has overwritten the common entries. */
+      numCommon = CMRintersectEmit(enumeration->subsetRows, enumeration->cardinality,
+        &transpose->entryColumns[first], transpose->rowSlice[column + 1] - first, enumeration->commonRows,
+        enumeration->commonEntries);
+      for (size_t i = 0; i < numCommon; ++i)
       {
-        size_t row = enumeration->subsetRows[i];
-        size_t entry;
-        CMRchrmatFindEntry(enumeration->matrix, row, column, &entry);
-        if (entry != SIZE_MAX)
-        {
-          enumeration->sumEntries -= enumeration->matrix->entryValues[entry];
-          enumeration->rowsNumNonzeros[row]--;
-        }
+        enumeration->sumEntries -= transpose->entryValues[first + enumeration->commonEntries[i]];
+        enumeration->rowsNumNonzeros[enumeration->subsetRows[enumeration->commonRows[i]]]--;
       }
     }
   }
@@ -271,7 +355,7 @@ bool tuEulerianRows(
 
       /* Recurse. */
       CMR_CALL( tuEulerianRows(enumeration, numRows + 1) );
-      if (!*(enumeration->pisTotallyUnimodular) || enumeration->timeLimit <= 0)
+      if (!*(enumeration->pisTotallyUnimodular) || enumeration->timeout)
         return CMR_OKAY;
 
       /* Decrement column nonzero counters again. */
@@ -289,10 +373,9 @@ bool tuEulerianRows(
         enumeration->stats->enumerationRowSubsets++;
     }
 
-    double remainingTime = enumeration->timeLimit - (clock() - enumeration->startClock) * 1.0 / CLOCKS_PER_SEC;
-    if (remainingTime <= 0)
+    if (CMRdeadlineTick(&enumeration->deadline, &enumeration->deadlineTicks))
     {
-      enumeration->timeLimit = 0;
+      enumeration->timeout = true;
       return CMR_OKAY;
     }
 
@@ -319,6 +402,138 @@ bool tuEulerianRows(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Recursive enumeration of column subsets and subsequent testing of Eulerian submatrix, based on bitsets.
+ *
+ * Variant of \ref tuEulerianColumns for matrices with at most 64 rows. The parities of the row counts are maintained
+ * as a single bitset and the sum of the entries is updated by two population counts per selected column.
+ */
+
+static
+CMR_ERROR tuEulerianBitsColumns(
+  CMR_TU_ENUMERATION* enumeration,  /**< Enumeration information. */
+  size_t numColumns,                /**< Number of already selected columns. */
+  uint64_t rowParities,             /**< Bitset of selected rows with an odd number of nonzeros so far. */
+  int sumEntries                    /**< Sum of the entries of the selected submatrix so far. */
+)
+{
+  assert(enumeration);
+
+  if (numColumns < enumeration->cardinality)
+  {
+    /* Recursion step: pick one column and enumerate over the other columns. */
+
+    size_t firstUsable = (numColumns == 0) ? 0 : enumeration->subsetUsable[numColumns - 1] + 1;
+    size_t beyondUsable = enumeration->numUsableColumns - enumeration->cardinality + numColumns + 1;
+    for (size_t usable = firstUsable; usable < beyondUsable; ++usable)
+    {
+      size_t column = enumeration->usableColumns[usable];
+      uint64_t positive = enumeration->columnsPositive[column] & enumeration->rowSubset;
+      uint64_t negative = enumeration->columnsNegative[column] & enumeration->rowSubset;
+      enumeration->subsetUsable[numColumns] = usable;
+
+      CMR_CALL( tuEulerianBitsColumns(enumeration, numColumns + 1, rowParities ^ positive ^ negative,
+        sumEntries + (int) CMRbitsetCount(positive) - (int) CMRbitsetCount(negative)) );
+      if (!*enumeration->pisTotallyUnimodular)
+        return CMR_OKAY;
+    }
+  }
+  else
+  {
+    if (enumeration->stats)
+    {
+      if (enumeration->isTransposed)
+        enumeration->stats->enumerationRowSubsets++;
+      else
+        enumeration->stats->enumerationColumnSubsets++;
+    }
+
+    if (sumEntries % 4 != 0 && !rowParities)
+    {
+      *(enumeration->pisTotallyUnimodular) = false;
+      if (enumeration->psubmatrix)
+      {
+        CMR_SUBMAT* submatrix = NULL;
+        CMR_CALL( CMRsubmatCreate(enumeration->cmr, enumeration->cardinality, enumeration->cardinality, &submatrix) );
+        for (size_t i = 0; i < enumeration->cardinality; ++i)
+        {
+          submatrix->rows[i] = enumeration->subsetRows[i];
+          submatrix->columns[i] = enumeration->usableColumns[enumeration->subsetUsable[i]];
+        }
+
+        *(enumeration->psubmatrix) = submatrix;
+      }
+    }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Recursive enumeration of row subsets and subsequent testing of total unimodularity, based on bitsets.
+ *
+ * Variant of \ref tuEulerianRows for matrices with at most 64 rows.
+ */
+
+static
+CMR_ERROR tuEulerianBitsRows(
+  CMR_TU_ENUMERATION* enumeration,  /**< Enumeration information. */
+  size_t numRows                    /**< Number of already selected rows. */
+)
+{
+  assert(enumeration);
+
+  if (numRows < enumeration->cardinality)
+  {
+    /* Recursion step: pick one row and enumerate over the other rows. */
+
+    size_t firstRow = (numRows == 0) ? 0 : enumeration->subsetRows[numRows - 1] + 1;
+    size_t beyondRow = enumeration->matrix->numRows - enumeration->cardinality + numRows + 1;
+    for (size_t row = firstRow; row < beyondRow; ++row)
+    {
+      enumeration->subsetRows[numRows] = row;
+      enumeration->rowSubset |= ((uint64_t) 1) << row;
+
+      CMR_CALL( tuEulerianBitsRows(enumeration, numRows + 1) );
+
+      enumeration->rowSubset &= ~(((uint64_t) 1) << row);
+      if (!*(enumeration->pisTotallyUnimodular) || enumeration->timeout)
+        return CMR_OKAY;
+    }
+  }
+  else
+  {
+    if (enumeration->stats)
+    {
+      if (enumeration->isTransposed)
+        enumeration->stats->enumerationColumnSubsets++;
+      else
+        enumeration->stats->enumerationRowSubsets++;
+    }
+
+    if (CMRdeadlineTick(&enumeration->deadline, &enumeration->deadlineTicks))
+    {
+      enumeration->timeout = true;
+      return CMR_OKAY;
+    }
+
+    /* Only columns with an even number of nonzeros in the selected rows can be part of an Eulerian submatrix. */
+    enumeration->numUsableColumns = 0;
+    for (size_t column = 0; column < enumeration->matrix->numColumns; ++column)
+    {
+      uint64_t support = (enumeration->columnsPositive[column] | enumeration->columnsNegative[column])
+        & enumeration->rowSubset;
+      if (CMRbitsetCount(support) % 2 == 0)
+        enumeration->usableColumns[enumeration->numUsableColumns++] = column;
+    }
+
+    if (enumeration->numUsableColumns >= enumeration->cardinality)
+      CMR_CALL( tuEulerianBitsColumns(enumeration, 0, 0, 0) );
+  }
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Submatrix test.
  */
@@ -331,12 +546,13 @@ CMR_ERROR tuEulerian(
   bool* pisTotallyUnimodular, /**< Pointer for storing whether \f$ M \f$ is totally unimodular. */
   CMR_SUBMAT** psubmatrix,    /**< Pointer for storing the submatrix. */
   CMR_TU_STATS* stats,        /**< Statistics. */
-  double timeLimit            /**< Time limit to impose. */
+  const CMR_DEADLINE* deadline  /**< Deadline of the computation. */
 )
 {
   assert(cmr);
   assert(matrix);
   assert(pisTotallyUnimodular);
+  assert(deadline);
 
 #if defined(CMR_DEBUG)
   CMRdbgMsg(2, "tuEulerian called for a %zux%zu matrix\n", matrix->numRows, matrix->numColumns);
@@ -354,17 +570,16 @@ CMR_ERROR tuEulerian(
     assert(!isTransposed);
 
     CMR_CHRMAT* transpose = NULL;
-    CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+    CMR_CALL( CMRchrmatGetTranspose(cmr, matrix, &transpose) );
 
     CMRdbgMsg(6, "Transposing matrix to have fewer rows than columns.\n");
 
-    error = tuEulerian(cmr, transpose, true, pisTotallyUnimodular, psubmatrix, stats, timeLimit);
+    error = tuEulerian(cmr, transpose, true, pisTotallyUnimodular, psubmatrix, stats, deadline);
 
     /* Transpose the violator. */
     if (psubmatrix && *psubmatrix)
       CMR_CALL( CMRsubmatTranspose(*psubmatrix) );
 
-    CMR_CALL( CMRchrmatFree(cmr, &transpose) );
     return error;
   }
 
@@ -374,15 +589,22 @@ CMR_ERROR tuEulerian(
   enumeration.pisTotallyUnimodular = pisTotallyUnimodular;
   enumeration.psubmatrix = psubmatrix;
   enumeration.stats = stats;
-  enumeration.timeLimit = timeLimit;
+  enumeration.deadline = *deadline;
+  enumeration.deadlineTicks = 0;
+  enumeration.timeout = false;
   enumeration.isTransposed = isTransposed;
-  enumeration.startClock = clock();
   enumeration.subsetRows = NULL;
   enumeration.usableColumns = NULL;
   enumeration.subsetUsable = NULL;
   enumeration.rowsNumNonzeros = NULL;
   enumeration.columnsNumNonzeros = NULL;
   enumeration.sumEntries = 0;
+  enumeration.columnsPositive = NULL;
+  enumeration.columnsNegative = NULL;
+  enumeration.rowSubset = 0;
+  enumeration.transpose = NULL;
+  enumeration.commonRows = NULL;
+  enumeration.commonEntries = NULL;
   *pisTotallyUnimodular = true;
 
   CMR_CALL( CMRallocStackArray(cmr, &enumeration.subsetRows, matrix->numRows) );
@@ -395,7 +617,38 @@ CMR_ERROR tuEulerian(
   for (size_t column = 0; column < matrix->numColumns; ++column)
     enumeration.columnsNumNonzeros[column] = 0;
 
-  CMRdbgMsg(6, "Starting enumeration algorithm with a time limit of %g.\n", timeLimit);
+  /* If the rows fit into a word, we store the columns as bitsets. */
+  bool useBitsets = matrix->numRows <= 64;
+  if (useBitsets)
+  {
+    CMR_CALL( CMRallocStackArray(cmr, &enumeration.columnsPositive, matrix->numColumns) );
+    CMR_CALL( CMRallocStackArray(cmr, &enumeration.columnsNegative, matrix->numColumns) );
+    for (size_t column = 0; column < matrix->numColumns; ++column)
+    {
+      enumeration.columnsPositive[column] = 0;
+      enumeration.columnsNegative[column] = 0;
+    }
+    for (size_t row = 0; row < matrix->numRows; ++row)
+    {
+      size_t first = matrix->rowSlice[row];
+      size_t beyond = matrix->rowSlice[row + 1];
+      for (size_t e = first; e < beyond; ++e)
+      {
+        uint64_t* columns = (matrix->entryValues[e] > 0) ? enumeration.columnsPositive : enumeration.columnsNegative;
+        columns[matrix->entryColumns[e]] |= ((uint64_t) 1) << row;
+      }
+    }
+  }
+  else
+  {
+    /* The rows of a column that are in the subset are found by intersecting the sorted arrays. */
+    CMR_CALL( CMRchrmatTranspose(cmr, matrix, &enumeration.transpose) );
+    CMR_CALL( CMRallocStackArray(cmr, &enumeration.commonRows, matrix->numRows) );
+    CMR_CALL( CMRallocStackArray(cmr, &enumeration.commonEntries, matrix->numRows) );
+  }
+
+  CMRdbgMsg(6, "Starting %senumeration algorithm with a time limit of %g.\n", useBitsets ? "bitset-based " : "",
+    CMRdeadlineRemaining(deadline));
 
   CMRassertStackConsistency(cmr);
 
@@ -404,13 +657,28 @@ CMR_ERROR tuEulerian(
     CMRassertStackConsistency(cmr);
     CMRdbgMsg(8, "Considering submatrices of size %zux%zu.\n", enumeration.cardinality, enumeration.cardinality);
     CMRassertStackConsistency(cmr);
-    CMR_CALL( tuEulerianRows(&enumeration, 0) );
-    if (!*pisTotallyUnimodular || enumeration.timeLimit <= 0)
+    if (useBitsets)
+      CMR_CALL( tuEulerianBitsRows(&enumeration, 0) );
+    else
+      CMR_CALL( tuEulerianRows(&enumeration, 0) );
+    if (!*pisTotallyUnimodular || enumeration.timeout)
       break;
   }
 
   CMRassertStackConsistency(cmr);
 
+  if (useBitsets)
+  {
+    CMR_CALL( CMRfreeStackArray(cmr, &enumeration.columnsNegative) );
+    CMR_CALL( CMRfreeStackArray(cmr, &enumeration.columnsPositive) );
+  }
+  else
+  {
+    CMR_CALL( CMRfreeStackArray(cmr, &enumeration.commonEntries) );
+    CMR_CALL( CMRfreeStackArray(cmr, &enumeration.commonRows) );
+    CMR_CALL( CMRchrmatFree(cmr, &enumeration.transpose) );
+  }
+
   CMR_CALL( CMRfreeStackArray(cmr, &enumeration.columnsNumNonzeros) );
   CMR_CALL( CMRfreeStackArray(cmr, &enumeration.rowsNumNonzeros) );
   CMR_CALL( CMRfreeStackArray(cmr, &enumeration.subsetUsable) );
@@ -419,7 +687,7 @@ CMR_ERROR tuEulerian(
 
   CMRassertStackConsistency(cmr);
 
-  if (enumeration.timeLimit <= 0)
+  if (enumeration.timeout)
     return CMR_ERROR_TIMEOUT;
 
   return CMR_OKAY;
@@ -485,7 +753,7 @@ bool tuPartitionSearch(
 /**
  * \brief Recursively selects a row subset and tests Ghouila-Houri for each.
  *
- * \return 1 if totally unimodular, 0 if not, and -1 if time limit was reached.
+ * \return 1 if totally unimodular, 0 if not, -1 if time limit was reached, and -2 if \p *pcancel was set.
  */
 
 static
@@ -497,8 +765,9 @@ int tuPartitionSubset(
   size_t current,       /**< Index to decide for selection. */
   int* columnSum,       /**< Array for computing column sums. */
   CMR_TU_STATS* stats,  /**< Statistics. */
-  clock_t startClock,   /**< Clock for start for computation. */
-  double timeLimit      /**< Time limit for computation. */
+  const CMR_DEADLINE* deadline, /**< Deadline of the computation. */
+  size_t* pticks,       /**< Pointer to the worker's counter for checking the deadline. */
+  bool* pcancel         /**< Pointer to a flag that is set when the enumeration shall stop, accessed atomically. */
 )
 {
   assert(cmr);
@@ -509,7 +778,8 @@ int tuPartitionSubset(
   {
     /* Recurse by not selecting a column. */
     selection[current] = 0;
-    int result = tuPartitionSubset(cmr, matrix, transposed, selection, current + 1, columnSum, stats, startClock, timeLimit);
+    int result = tuPartitionSubset(cmr, matrix, transposed, selection, current + 1, columnSum, stats, deadline,
+      pticks, pcancel);
     if (result <= 0)
       return result;
 
@@ -520,7 +790,8 @@ int tuPartitionSubset(
     for (size_t i = first; i < beyond; ++i)
       columnSum[matrix->entryColumns[i]] += matrix->entryValues[i];
 
-    result = tuPartitionSubset(cmr, matrix, transposed, selection, current + 1, columnSum, stats, startClock, timeLimit);
+    result = tuPartitionSubset(cmr, matrix, transposed, selection, current + 1, columnSum, stats, deadline,
+      pticks, pcancel);
 
     for (size_t i = first; i < beyond; ++i)
       columnSum[matrix->entryColumns[i]] -= matrix->entryValues[i];
@@ -529,8 +800,10 @@ int tuPartitionSubset(
   }
   else
   {
-    if (((clock() * 1.0 / CLOCKS_PER_SEC) - startClock) > timeLimit)
+    if (CMRdeadlineTick(deadline, pticks))
       return -1;
+    if (CMRatomicLoadFlag(pcancel))
+      return -2;
 
 #if defined(CMR_DEBUG)
     size_t count = 0;
@@ -555,6 +828,84 @@ int tuPartitionSubset(
   }
 }
 
+/**
+ * \brief Data shared by all workers of the partition test.
+ */
+
+typedef struct
+{
+  CMR_CHRMAT* matrix;         /**< \brief Matrix \f$ M \f$. */
+  bool transposed;            /**< \brief Whether we're dealing with the transpose. */
+  CMR_TU_STATS* workerStats;  /**< \brief Array with statistics for each worker, or \c NULL. */
+  CMR_DEADLINE deadline;      /**< \brief Deadline of the computation. */
+  size_t splitDepth;          /**< \brief Number of leading rows whose selection defines a subtree. */
+  size_t numSubtrees;         /**< \brief Number of subtrees, i.e., \f$ 2^{\mathtt{splitDepth}} \f$. */
+  size_t nextSubtree;         /**< \brief Index of the next subtree to be enumerated, accessed atomically. */
+  bool foundViolation;        /**< \brief Whether a row subset without a valid partition was found, set atomically. */
+  bool timeout;               /**< \brief Whether the time limit was reached, set atomically. */
+  bool cancel;                /**< \brief Whether all workers shall stop, accessed atomically. */
+} TuPartition;
+
+/**
+ * \brief Worker of the partition test that enumerates the row subsets of complete subtrees.
+ */
+
+static
+CMR_ERROR tuPartitionWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref TuPartition. */
+)
+{
+  assert(cmr);
+
+  TuPartition* partition = (TuPartition*) data;
+  CMR_CHRMAT* matrix = partition->matrix;
+
+  int8_t* selection = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &selection, matrix->numRows) );
+  int* columnSum = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &columnSum, matrix->numColumns) );
+  size_t deadlineTicks = 0;
+
+  while (!CMRatomicLoadFlag(&partition->cancel))
+  {
+    size_t subtree = CMRatomicFetchAdd(&partition->nextSubtree, 1);
+    if (subtree >= partition->numSubtrees)
+      break;
+
+    /* Fix the selection of the leading rows; the first row corresponds to the most significant bit. */
+    for (size_t column = 0; column < matrix->numColumns; ++column)
+      columnSum[column] = 0;
+    for (size_t row = 0; row < partition->splitDepth; ++row)
+    {
+      selection[row] = (subtree >> (partition->splitDepth - 1 - row)) & 1;
+      if (selection[row])
+      {
+        size_t first = matrix->rowSlice[row];
+        size_t beyond = matrix->rowSlice[row + 1];
+        for (size_t i = first; i < beyond; ++i)
+          columnSum[matrix->entryColumns[i]] += matrix->entryValues[i];
+      }
+    }
+
+    int result = tuPartitionSubset(cmr, matrix, partition->transposed, selection, partition->splitDepth, columnSum,
+      partition->workerStats ? &partition->workerStats[worker] : NULL, &partition->deadline, &deadlineTicks,
+      &partition->cancel);
+    if (result == 0)
+      CMRatomicStoreFlag(&partition->foundViolation, true);
+    else if (result == -1)
+      CMRatomicStoreFlag(&partition->timeout, true);
+    if (result <= 0)
+      CMRatomicStoreFlag(&partition->cancel, true);
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &columnSum) );
+  CMR_CALL( CMRfreeStackArray(cmr, &selection) );
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Partition test based on Ghouila-Houri.
  */
@@ -566,12 +917,13 @@ CMR_ERROR tuPartition(
   bool transposed,            /**< Whether we're dealing with the transposed .*/
   bool* pisTotallyUnimodular, /**< Pointer for storing whether \f$ M \f$ is totally unimodular. */
   CMR_TU_STATS* stats,        /**< Statistics. */
-  double timeLimit            /**< Time limit to impose. */
+  const CMR_DEADLINE* deadline  /**< Deadline of the computation. */
 )
 {
   assert(cmr);
   assert(matrix);
   assert(pisTotallyUnimodular);
+  assert(deadline);
 
 #if defined(CMR_DEBUG)
   CMRdbgMsg(2, "testPartition called for a %zux%zu matrix\n", matrix->numRows, matrix->numColumns);
@@ -585,35 +937,215 @@ CMR_ERROR tuPartition(
   if (matrix->numRows > matrix->numColumns)
   {
     CMR_CHRMAT* transpose = NULL;
-    CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
-    CMR_CALL( tuPartition(cmr, transpose, true, pisTotallyUnimodular, stats, timeLimit) );
-    CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+    CMR_CALL( CMRchrmatGetTranspose(cmr, matrix, &transpose) );
+    CMR_CALL( tuPartition(cmr, transpose, true, pisTotallyUnimodular, stats, deadline) );
     return CMR_OKAY;
   }
 
-  int8_t* selection = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &selection, matrix->numRows) );
-  int* columnSum = NULL;
-  CMR_CALL( CMRallocStackArray(cmr, &columnSum, matrix->numColumns) );
-  for (size_t column = 0; column < matrix->numColumns; ++column)
-    columnSum[column] = 0;
+  double time = CMRclockNow();
+
+  /* With several workers, the first rows are fixed to split the enumeration into independent subtrees. */
+  TuPartition partition;
+  partition.matrix = matrix;
+  partition.transposed = transposed;
+  partition.deadline = *deadline;
+  partition.nextSubtree = 0;
+  partition.foundViolation = false;
+  partition.timeout = false;
+  partition.cancel = false;
+
+  size_t numWorkers = CMRthreadsNumWorkers(cmr, 0);
+  partition.splitDepth = 0;
+  if (numWorkers > 1)
+  {
+    while (partition.splitDepth < matrix->numRows && (((size_t) 1) << partition.splitDepth) < 16 * numWorkers)
+      partition.splitDepth++;
+  }
+  partition.numSubtrees = ((size_t) 1) << partition.splitDepth;
+  if (numWorkers > partition.numSubtrees)
+    numWorkers = partition.numSubtrees;
+
+  partition.workerStats = NULL;
+  if (stats)
+  {
+    CMR_CALL( CMRallocBlockArray(cmr, &partition.workerStats, numWorkers) );
+    for (size_t w = 0; w < numWorkers; ++w)
+      CMR_CALL( CMRtuStatsInit(&partition.workerStats[w]) );
+  }
+
+  CMR_CALL( CMRthreadsRun(cmr, numWorkers, tuPartitionWorker, &partition) );
 
-  clock_t startClock = clock();
-  int result = tuPartitionSubset(cmr, matrix, transposed, selection, 0, columnSum, stats, startClock, timeLimit);
-  if (result < 0)
+  if (stats)
+  {
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+      stats->partitionRowSubsets += partition.workerStats[w].partitionRowSubsets;
+      stats->partitionColumnSubsets += partition.workerStats[w].partitionColumnSubsets;
+    }
+    CMR_CALL( CMRfreeBlockArray(cmr, &partition.workerStats) );
+  }
+
+  if (partition.foundViolation)
+    *pisTotallyUnimodular = false;
+  else if (partition.timeout)
     error = CMR_ERROR_TIMEOUT;
   else
-    *pisTotallyUnimodular = (result > 0);
-
-  CMR_CALL( CMRfreeStackArray(cmr, &columnSum) );
-  CMR_CALL( CMRfreeStackArray(cmr, &selection) );
+    *pisTotallyUnimodular = true;
 
   if (stats)
-    stats->partitionTime += (clock() - startClock) * 1.0 / CLOCKS_PER_SEC;
+    stats->partitionTime += CMRclockNow() - time;
+
+  return error;
+}
+
+/**
+ * \brief Searches for a 2-by-2 submatrix of a ternary matrix with determinant \f$ \pm 2 \f$.
+ *
+ * For every row \f$ r \f$, all rows \f$ r' > r \f$ that share a nonzero column with \f$ r \f$ are reached via
+ * the transpose, and the signs of the products \f$ M_{r,c} M_{r',c} \f$ are recorded per \f$ r' \f$. Two distinct
+ * signs for the same \f$ r' \f$ indicate such a submatrix. The running time is linear in the sum of the squared
+ * numbers of nonzeros of the columns.
+ */
+
+static
+CMR_ERROR tuSearchTwoByTwo(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,       /**< Ternary matrix. */
+  bool* pfound,             /**< Pointer for storing whether such a submatrix was found. */
+  CMR_SUBMAT** psubmatrix,  /**< Pointer for storing the submatrix (may be \c NULL). */
+  CMR_DEADLINE* deadline    /**< Deadline of the computation. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pfound);
+
+  CMR_CHRMAT* transpose = NULL;
+  CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+
+  signed char* rowsSign = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsSign, matrix->numRows) );
+  size_t* rowsFirstColumn = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rowsFirstColumn, matrix->numRows) );
+  size_t* touchedRows = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &touchedRows, matrix->numRows) );
+  for (size_t row = 0; row < matrix->numRows; ++row)
+    rowsSign[row] = 0;
+
+  CMR_ERROR error = CMR_OKAY;
+  size_t ticks = 0;
+  *pfound = false;
+  for (size_t row = 0; row < matrix->numRows && !*pfound; ++row)
+  {
+    size_t numTouched = 0;
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    for (size_t e = first; e < beyond && !*pfound; ++e)
+    {
+      size_t column = matrix->entryColumns[e];
+      for (size_t f = transpose->rowSlice[column + 1]; f > transpose->rowSlice[column]; --f)
+      {
+        size_t otherRow = transpose->entryColumns[f - 1];
+        if (otherRow <= row)
+          break;
+
+        signed char sign = (matrix->entryValues[e] == transpose->entryValues[f - 1]) ? 1 : -1;
+        if (rowsSign[otherRow] == 0)
+        {
+          rowsSign[otherRow] = sign;
+          rowsFirstColumn[otherRow] = column;
+          touchedRows[numTouched++] = otherRow;
+        }
+        else if (rowsSign[otherRow] != sign)
+        {
+          CMRdbgMsg(2, "Found 2x2 submatrix with rows %zu,%zu and columns %zu,%zu.\n", row, otherRow,
+            rowsFirstColumn[otherRow], column);
+          *pfound = true;
+          if (psubmatrix)
+          {
+            CMR_CALL( CMRsubmatCreate(cmr, 2, 2, psubmatrix) );
+            (*psubmatrix)->rows[0] = row;
+            (*psubmatrix)->rows[1] = otherRow;
+            (*psubmatrix)->columns[0] = rowsFirstColumn[otherRow];
+            (*psubmatrix)->columns[1] = column;
+          }
+          break;
+        }
+      }
+    }
+
+    for (size_t t = 0; t < numTouched; ++t)
+      rowsSign[touchedRows[t]] = 0;
+
+    if (CMRdeadlineTick(deadline, &ticks))
+    {
+      error = CMR_ERROR_TIMEOUT;
+      break;
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &touchedRows) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsFirstColumn) );
+  CMR_CALL( CMRfreeStackArray(cmr, &rowsSign) );
+  CMR_CALL( CMRchrmatFree(cmr, &transpose) );
 
   return error;
 }
 
+/**
+ * \brief Tests the Camion signs of the ternary series-parallel reduced submatrix \f$ A' \f$ of \p matrix
+ *        \f$ A \f$.
+ *
+ * The ternary series-parallel reductions only remove zero vectors, unit vectors and vectors that agree with another
+ * one up to a factor of \f$ -1 \f$, and these preserve total unimodularity in both directions. Hence, if the
+ * support of \f$ A \f$ is regular, then \f$ A \f$ is totally unimodular if and only if \f$ A' \f$ is Camion-signed.
+ * A non-Camion submatrix of \f$ A' \f$, e.g., a \f$ 2 \times 2 \f$ submatrix with determinant \f$ \pm 2 \f$ that
+ * blocked a reduction, is one of \f$ A \f$, which is then not totally unimodular.
+ */
+
+static
+CMR_ERROR tuTestCamionReduced(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix,         /**< Ternary matrix \f$ A \f$. */
+  bool* pisCamionSigned,      /**< Pointer for storing whether \f$ A' \f$ is Camion-signed. */
+  CMR_CHRMAT** preduced,      /**< Pointer for storing \f$ A' \f$. */
+  CMR_SUBMAT** psubmatrix,    /**< Pointer for storing a non-Camion submatrix of \f$ A \f$ (may be \c NULL). */
+  CMR_TU_STATS* stats,        /**< Statistics for the computation (may be \c NULL). */
+  CMR_DEADLINE* deadline      /**< Deadline of the computation. */
+)
+{
+  assert(cmr);
+  assert(matrix);
+  assert(pisCamionSigned);
+  assert(preduced);
+
+  bool isSeriesParallel;
+  CMR_SUBMAT* reducedSubmatrix = NULL;
+  CMR_CALL( CMRtestTernarySeriesParallel(cmr, matrix, &isSeriesParallel, NULL, NULL, &reducedSubmatrix, NULL,
+    stats ? &stats->decomposition.seriesParallel : NULL, CMRdeadlineRemaining(deadline)) );
+  CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, reducedSubmatrix, preduced) );
+
+  CMRdbgMsg(2, "Testing Camion signs of the %zux%zu series-parallel reduced submatrix.\n", (*preduced)->numRows,
+    (*preduced)->numColumns);
+
+  CMR_SUBMAT* violator = NULL;
+  CMR_CALL( CMRcamionTestSigns(cmr, *preduced, pisCamionSigned, psubmatrix ? &violator : NULL,
+    stats ? &stats->decomposition.camion : NULL, CMRdeadlineRemaining(deadline)) );
+
+  /* Translate the violator into the indices of the matrix. */
+  if (violator)
+  {
+    for (size_t row = 0; row < violator->numRows; ++row)
+      violator->rows[row] = reducedSubmatrix->rows[violator->rows[row]];
+    for (size_t column = 0; column < violator->numColumns; ++column)
+      violator->columns[column] = reducedSubmatrix->columns[violator->columns[column]];
+    *psubmatrix = violator;
+  }
+  CMR_CALL( CMRsubmatFree(cmr, &reducedSubmatrix) );
+
+  return CMR_OKAY;
+}
+
 CMR_ERROR CMRtuTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisTotallyUnimodular, CMR_MATROID_DEC** pdec,
   CMR_SUBMAT** psubmatrix, CMR_TU_PARAMS* params, CMR_TU_STATS* stats, double timeLimit)
 {
@@ -628,53 +1160,114 @@ CMR_ERROR CMRtuTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisTotallyUnimodular, CM
     params = &defaultParams;
   }
 
-  clock_t totalClock = clock();
+  double totalClock = CMRclockNow();
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
 
   if (!CMRchrmatIsTernary(cmr, matrix, psubmatrix))
     return CMR_OKAY;
 
-  double remainingTime = timeLimit - ((clock() - totalClock) * 1.0 / CLOCKS_PER_SEC);
-
   CMRdbgMsg(0, "CMRtuTest called with algorithm = %d.\n", params->algorithm);
 
+  if (params->algorithm == CMR_TU_ALGORITHM_DECOMPOSITION && params->regular.smallMatrices && !pdec
+    && CMRsmallFits(matrix) && !CMRdeadlinePassed(&deadline))
+  {
+    bool decided;
+    CMR_CALL( CMRsmallTestTotallyUnimodular(cmr, matrix, &decided, pisTotallyUnimodular, psubmatrix) );
+    if (decided)
+    {
+      if (stats)
+      {
+        stats->decomposition.totalCount++;
+        stats->decomposition.totalTime += CMRclockNow() - totalClock;
+      }
+      return CMR_OKAY;
+    }
+  }
+
+  if (params->directConsecutiveOnes && !pdec)
+  {
+    bool isBinary = true;
+    for (size_t e = 0; e < matrix->numNonzeros && isBinary; ++e)
+      isBinary = matrix->entryValues[e] == 1;
+
+    if (isBinary)
+    {
+      CMRdbgMsg(2, "Testing for the consecutive ones property.\n");
+      bool hasConsecutiveOnes;
+      CMR_CALL( CMRconsecutiveOnesTestColumns(cmr, matrix, &hasConsecutiveOnes, NULL) );
+      if (!hasConsecutiveOnes)
+        CMR_CALL( CMRconsecutiveOnesTestRows(cmr, matrix, &hasConsecutiveOnes, NULL) );
+      if (hasConsecutiveOnes)
+      {
+        *pisTotallyUnimodular = true;
+        if (stats)
+        {
+          stats->decomposition.totalCount++;
+          stats->decomposition.totalTime += CMRclockNow() - totalClock;
+        }
+        return CMR_OKAY;
+      }
+    }
+  }
+
+  if (params->directTwoByTwo)
+  {
+    CMRdbgMsg(2, "Searching for 2x2 submatrices with determinant -2 or +2.\n");
+    bool found;
+    CMR_CALL( tuSearchTwoByTwo(cmr, matrix, &found, psubmatrix, &deadline) );
+    if (found)
+    {
+      *pisTotallyUnimodular = false;
+      if (stats)
+      {
+        stats->decomposition.totalCount++;
+        stats->decomposition.totalTime += CMRclockNow() - totalClock;
+      }
+      return CMR_OKAY;
+    }
+  }
+
   if (params->algorithm == CMR_TU_ALGORITHM_DECOMPOSITION)
   {
+    /* The signs are only tested on the series-parallel reduced submatrix, whose binary support is regular if and
+     * only if that of the matrix is. */
+    CMR_CHRMAT* reduced = NULL;
     if (params->directCamion)
     {
       CMRdbgMsg(2, "Testing Camion signs directly.\n");
-      CMR_CALL( CMRcamionTestSigns(cmr, matrix, pisTotallyUnimodular, psubmatrix,
-        stats ? &stats->decomposition.camion : NULL, remainingTime) );
+      CMR_CALL( tuTestCamionReduced(cmr, matrix, pisTotallyUnimodular, &reduced, psubmatrix, stats, &deadline) );
 
-      if (!*pisTotallyUnimodular)
+      if (!*pisTotallyUnimodular || (!pdec && reduced->numRows == 0))
       {
+        CMR_CALL( CMRchrmatFree(cmr, &reduced) );
         if (stats)
         {
           stats->decomposition.totalCount++;
-          stats->decomposition.totalTime += (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
+          stats->decomposition.totalTime += CMRclockNow() - totalClock;
         }
         return CMR_OKAY;
       }
     }
 
-    double remainingTime = timeLimit - ((clock() - totalClock) * 1.0 / CLOCKS_PER_SEC);
-
-    CMR_CALL( CMRregularityTest(cmr, matrix, !params->directCamion, pisTotallyUnimodular, pdec, NULL, &params->regular,
-      stats ? &stats->decomposition : NULL, remainingTime) );
+    CMR_ERROR error = CMRregularityTest(cmr, (reduced && !pdec) ? reduced : matrix, !params->directCamion,
+      pisTotallyUnimodular, pdec, NULL, &params->regular, stats ? &stats->decomposition : NULL,
+      CMRdeadlineRemaining(&deadline));
+    CMR_CALL( CMRchrmatFree(cmr, &reduced) );
+    CMR_CALL( error );
 
     if (!*pisTotallyUnimodular && psubmatrix)
     {
       assert(!*psubmatrix);
-      remainingTime = timeLimit - (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
-      CMR_CALL( CMRtestHereditaryPropertySimple(cmr, matrix, tuDecomposition, stats, psubmatrix, remainingTime) );
+      CMR_CALL( tuSearchSubmatrix(cmr, matrix, stats, psubmatrix, CMRdeadlineRemaining(&deadline)) );
     }
   }
   else if (params->algorithm == CMR_TU_ALGORITHM_EULERIAN)
   {
-    CMR_CALL( tuEulerian(cmr, matrix, false, pisTotallyUnimodular, psubmatrix, stats, remainingTime) );
+    CMR_CALL( tuEulerian(cmr, matrix, false, pisTotallyUnimodular, psubmatrix, stats, &deadline) );
   }
   else if (params->algorithm == CMR_TU_ALGORITHM_PARTITION)
   {
-    CMR_CALL( tuPartition(cmr, matrix, false, pisTotallyUnimodular, stats, remainingTime) );
+    CMR_CALL( tuPartition(cmr, matrix, false, pisTotallyUnimodular, stats, &deadline) );
   }
   else
   {
@@ -684,12 +1277,103 @@ CMR_ERROR CMRtuTest(CMR* cmr, CMR_CHRMAT* matrix, bool* pisTotallyUnimodular, CM
   if (stats)
   {
     stats->decomposition.totalCount++;
-    stats->decomposition.totalTime += (clock() - totalClock) * 1.0 / CLOCKS_PER_SEC;
+    stats->decomposition.totalTime += CMRclockNow() - totalClock;
   }
 
   return CMR_OKAY;
 }
 
+/**
+ * \brief Data shared by all workers of \ref CMRtuTestBatch.
+ */
+
+typedef struct
+{
+  size_t numMatrices;         /**< \brief Number of matrices. */
+  CMR_CHRMAT** matrices;      /**< \brief Array of matrices. */
+  bool* isTotallyUnimodular;  /**< \brief Array for storing the results. */
+  CMR_TU_PARAMS* params;      /**< \brief Parameters for the computation. */
+  CMR_TU_STATS* stats;        /**< \brief Array with statistics for each matrix, or \c NULL. */
+  CMR_DEADLINE deadline;      /**< \brief Deadline of the whole batch. */
+  size_t nextMatrix;          /**< \brief Index of the next matrix to be tested, accessed atomically. */
+  bool cancel;                /**< \brief Whether all workers shall stop, accessed atomically. */
+} TuBatch;
+
+/**
+ * \brief Worker of \ref CMRtuTestBatch.
+ *
+ * All matrices processed by one worker share that worker's stack memory.
+ */
+
+static
+CMR_ERROR tuBatchWorker(
+  CMR* cmr,       /**< \ref CMR environment. */
+  size_t worker,  /**< Index of the worker. */
+  void* data      /**< Pointer to the \ref TuBatch. */
+)
+{
+  assert(cmr);
+  CMR_UNUSED(worker);
+
+  TuBatch* batch = (TuBatch*) data;
+  CMR_ERROR error = CMR_OKAY;
+  while (!CMRatomicLoadFlag(&batch->cancel))
+  {
+    size_t m = CMRatomicFetchAdd(&batch->nextMatrix, 1);
+    if (m >= batch->numMatrices)
+      break;
+
+    double remainingTime = CMRdeadlineRemaining(&batch->deadline);
+    if (remainingTime <= 0)
+    {
+      error = CMR_ERROR_TIMEOUT;
+      break;
+    }
+
+    batch->isTotallyUnimodular[m] = false;
+    error = CMRtuTest(cmr, batch->matrices[m], &batch->isTotallyUnimodular[m], NULL, NULL, batch->params,
+      batch->stats ? &batch->stats[m] : NULL, remainingTime);
+    if (error)
+      break;
+  }
+
+  /* A failing worker stops all others. */
+  if (error)
+    CMRatomicStoreFlag(&batch->cancel, true);
+
+  return error;
+}
+
+CMR_ERROR CMRtuTestBatch(CMR* cmr, size_t numMatrices, CMR_CHRMAT** matrices, bool* isTotallyUnimodular,
+  CMR_TU_PARAMS* params, CMR_TU_STATS* stats, double timeLimit)
+{
+  assert(cmr);
+  assert(matrices || numMatrices == 0);
+  assert(isTotallyUnimodular || numMatrices == 0);
+
+  CMR_TU_PARAMS defaultParams;
+  if (!params)
+  {
+    CMR_CALL( CMRtuParamsInit(&defaultParams) );
+    params = &defaultParams;
+  }
+
+  TuBatch batch;
+  batch.numMatrices = numMatrices;
+  batch.matrices = matrices;
+  batch.isTotallyUnimodular = isTotallyUnimodular;
+  batch.params = params;
+  batch.stats = stats;
+  batch.deadline = CMRdeadlineCreate(cmr, timeLimit);
+  batch.nextMatrix = 0;
+  batch.cancel = false;
+
+  if (numMatrices == 0)
+    return CMR_OKAY;
+
+  return CMRthreadsRun(cmr, CMRthreadsNumWorkers(cmr, numMatrices), tuBatchWorker, &batch);
+}
+
 CMR_ERROR CMRtuCompleteDecomposition(CMR* cmr, CMR_MATROID_DEC* dec, CMR_TU_PARAMS* params, CMR_TU_STATS* stats,
   double timeLimit)
 {
@@ -0,0 +1,894 @@
+// #define CMR_DEBUG /* Uncomment to debug this file. */
+
+#include <cmr/tu.h>
+#include <cmr/graphic.h>
+
+#include "env_internal.h"
+#include "deadline.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/**
+ * \file tu_online.c
+ *
+ * The matrix is maintained as the 1-sum of its connected components. Each component knows its rows and columns and
+ * whether it is totally unimodular. If a component is totally unimodular and its support is known to be graphic, it
+ * additionally keeps the graphic decomposition of \ref CMR_GRAPHIC_ONLINE whose columns are those of the component in
+ * their order. Since columns cannot be removed from that structure, it is discarded whenever a column of the
+ * component is removed and rebuilt when the next column is added to the component.
+ */
+
+#define NONE SIZE_MAX /**< Marker for a missing component or slot. */
+
+/**
+ * \brief Column of the matrix.
+ *
+ * Columns are stored in slots that remain stable when other columns are removed.
+ */
+
+typedef struct
+{
+  size_t numEntries;      /**< \brief Number of nonzeros of the column, or \ref NONE if the slot is unused. */
+  size_t memEntries;      /**< \brief Memory for nonzeros. */
+  size_t* rows;           /**< \brief Rows of the nonzeros. */
+  char* values;           /**< \brief Values of the nonzeros. */
+  size_t component;       /**< \brief Component of the column, or \ref NONE if the column is zero. */
+  size_t componentIndex;  /**< \brief Index of the column in its component. */
+} TuOnlineColumn;
+
+/**
+ * \brief Connected component of the matrix.
+ */
+
+typedef struct
+{
+  bool isUsed;                  /**< \brief Whether the component exists. */
+  bool isTotallyUnimodular;     /**< \brief Whether the component is totally unimodular. */
+  bool tryGraphic;              /**< \brief Whether \ref graphic shall be rebuilt when needed. */
+  CMR_GRAPHIC_ONLINE* graphic;  /**< \brief Graphic decomposition of the component's support, or \c NULL. */
+  size_t numRows;               /**< \brief Number of rows. */
+  size_t memRows;               /**< \brief Memory for rows. */
+  size_t* rows;                 /**< \brief Rows of the component. */
+  size_t numColumns;            /**< \brief Number of columns. */
+  size_t memColumns;            /**< \brief Memory for columns. */
+  size_t* columns;              /**< \brief Slots of the columns of the component. */
+} TuOnlineComponent;
+
+struct _CMR_TU_ONLINE
+{
+  CMR* cmr;                       /**< \brief \ref CMR environment. */
+  CMR_TU_PARAMS params;           /**< \brief Parameters for the re-tests. */
+  size_t numRows;                 /**< \brief Number of rows of the matrix. */
+  size_t* rowsComponent;          /**< \brief Component of each row, or \ref NONE if the row is zero. */
+  size_t* rowsLocal;              /**< \brief Index of each row in its component. */
+  size_t* rowsMark;               /**< \brief Marker of each row for detecting duplicate entries. */
+  size_t currentMark;             /**< \brief Last value used for marking. */
+  size_t numColumns;              /**< \brief Number of columns of the matrix. */
+  size_t memColumns;              /**< \brief Memory for columns. */
+  size_t* columnsSlot;            /**< \brief Slot of each column. */
+  size_t numSlots;                /**< \brief Number of slots. */
+  size_t memSlots;                /**< \brief Memory for slots. */
+  TuOnlineColumn* slots;          /**< \brief Slots of the columns. */
+  size_t numFreeSlots;            /**< \brief Number of unused slots. */
+  size_t* freeSlots;              /**< \brief Stack of unused slots. */
+  size_t numComponents;           /**< \brief Number of component entries, including unused ones. */
+  size_t memComponents;           /**< \brief Memory for components. */
+  TuOnlineComponent* components;  /**< \brief Components. */
+  size_t* componentsMark;         /**< \brief Marker of each component for collecting touched components. */
+  size_t numFreeComponents;       /**< \brief Number of unused component entries. */
+  size_t* freeComponents;         /**< \brief Stack of unused component entries. */
+  size_t numUsedComponents;       /**< \brief Number of existing components. */
+  size_t numIrregular;            /**< \brief Number of existing components that are not totally unimodular. */
+};
+
+CMR_ERROR CMRtuOnlineCreate(CMR* cmr, CMR_TU_ONLINE** ponline, size_t numRows, CMR_TU_PARAMS* params)
+{
+  assert(cmr);
+  assert(ponline);
+
+  if (params && params->algorithm != CMR_TU_ALGORITHM_DECOMPOSITION)
+  {
+    CMRraiseErrorMessage(cmr, "Online total unimodularity tests require the decomposition algorithm.");
+    return CMR_ERROR_INPUT;
+  }
+
+  CMR_CALL( CMRallocBlock(cmr, ponline) );
+  CMR_TU_ONLINE* online = *ponline;
+  online->cmr = cmr;
+  if (params)
+    online->params = *params;
+  else
+    CMR_CALL( CMRtuParamsInit(&online->params) );
+  online->numRows = numRows;
+  online->rowsComponent = NULL;
+  online->rowsLocal = NULL;
+  online->rowsMark = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &online->rowsComponent, numRows) );
+  CMR_CALL( CMRallocBlockArray(cmr, &online->rowsLocal, numRows) );
+  CMR_CALL( CMRallocBlockArray(cmr, &online->rowsMark, numRows) );
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    online->rowsComponent[row] = NONE;
+    online->rowsMark[row] = 0;
+  }
+  online->currentMark = 0;
+
+  online->numColumns = 0;
+  online->memColumns = 16;
+  online->columnsSlot = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &online->columnsSlot, online->memColumns) );
+  online->numSlots = 0;
+  online->memSlots = 16;
+  online->slots = NULL;
+  online->freeSlots = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &online->slots, online->memSlots) );
+  CMR_CALL( CMRallocBlockArray(cmr, &online->freeSlots, online->memSlots) );
+  online->numFreeSlots = 0;
+
+  online->numComponents = 0;
+  online->memComponents = 16;
+  online->components = NULL;
+  online->componentsMark = NULL;
+  online->freeComponents = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &online->components, online->memComponents) );
+  CMR_CALL( CMRallocBlockArray(cmr, &online->componentsMark, online->memComponents) );
+  CMR_CALL( CMRallocBlockArray(cmr, &online->freeComponents, online->memComponents) );
+  online->numFreeComponents = 0;
+  online->numUsedComponents = 0;
+  online->numIrregular = 0;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRtuOnlineFree(CMR* cmr, CMR_TU_ONLINE** ponline)
+{
+  assert(cmr);
+  assert(ponline);
+
+  if (!*ponline)
+    return CMR_OKAY;
+
+  CMR_TU_ONLINE* online = *ponline;
+  for (size_t c = 0; c < online->numComponents; ++c)
+  {
+    TuOnlineComponent* component = &online->components[c];
+    CMR_CALL( CMRgraphicOnlineFree(cmr, &component->graphic) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &component->columns) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &component->rows) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->freeComponents) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->componentsMark) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->components) );
+  for (size_t s = 0; s < online->numSlots; ++s)
+  {
+    CMR_CALL( CMRfreeBlockArray(cmr, &online->slots[s].values) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &online->slots[s].rows) );
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->freeSlots) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->slots) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->columnsSlot) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->rowsMark) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->rowsLocal) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &online->rowsComponent) );
+  CMR_CALL( CMRfreeBlock(cmr, ponline) );
+
+  return CMR_OKAY;
+}
+
+size_t CMRtuOnlineNumColumns(CMR_TU_ONLINE* online)
+{
+  assert(online);
+
+  return online->numColumns;
+}
+
+size_t CMRtuOnlineNumComponents(CMR_TU_ONLINE* online)
+{
+  assert(online);
+
+  return online->numUsedComponents;
+}
+
+/**
+ * \brief Returns a new marker value for rows and components.
+ */
+
+static
+size_t nextMark(
+  CMR_TU_ONLINE* online /**< Online total unimodularity structure. */
+)
+{
+  assert(online);
+
+  if (online->currentMark == SIZE_MAX - 1)
+  {
+    for (size_t row = 0; row < online->numRows; ++row)
+      online->rowsMark[row] = 0;
+    for (size_t c = 0; c < online->numComponents; ++c)
+      online->componentsMark[c] = 0;
+    online->currentMark = 0;
+  }
+
+  return ++online->currentMark;
+}
+
+/**
+ * \brief Creates a new empty component that is totally unimodular.
+ *
+ * Pointers to components are invalidated.
+ */
+
+static
+CMR_ERROR componentCreate(
+  CMR_TU_ONLINE* online,  /**< Online total unimodularity structure. */
+  size_t* pcomponent      /**< Pointer for storing the index of the new component. */
+)
+{
+  assert(online);
+  assert(pcomponent);
+
+  CMR* cmr = online->cmr;
+  size_t c;
+  if (online->numFreeComponents)
+    c = online->freeComponents[--online->numFreeComponents];
+  else
+  {
+    if (online->numComponents == online->memComponents)
+    {
+      online->memComponents *= 2;
+      CMR_CALL( CMRreallocBlockArray(cmr, &online->components, online->memComponents) );
+      CMR_CALL( CMRreallocBlockArray(cmr, &online->componentsMark, online->memComponents) );
+      CMR_CALL( CMRreallocBlockArray(cmr, &online->freeComponents, online->memComponents) );
+    }
+    c = online->numComponents++;
+    TuOnlineComponent* component = &online->components[c];
+    component->graphic = NULL;
+    component->memRows = 4;
+    component->rows = NULL;
+    component->memColumns = 4;
+    component->columns = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &component->rows, component->memRows) );
+    CMR_CALL( CMRallocBlockArray(cmr, &component->columns, component->memColumns) );
+    online->componentsMark[c] = 0;
+  }
+
+  TuOnlineComponent* component = &online->components[c];
+  assert(!component->graphic);
+  component->isUsed = true;
+  component->isTotallyUnimodular = true;
+  component->tryGraphic = true;
+  component->numRows = 0;
+  component->numColumns = 0;
+  online->numUsedComponents++;
+  *pcomponent = c;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Removes a component, which must not have rows or columns anymore.
+ */
+
+static
+CMR_ERROR componentRelease(
+  CMR_TU_ONLINE* online,  /**< Online total unimodularity structure. */
+  size_t c                /**< Component. */
+)
+{
+  assert(online);
+
+  TuOnlineComponent* component = &online->components[c];
+  assert(component->isUsed);
+
+  CMR_CALL( CMRgraphicOnlineFree(online->cmr, &component->graphic) );
+  if (!component->isTotallyUnimodular)
+    online->numIrregular--;
+  component->isUsed = false;
+  online->freeComponents[online->numFreeComponents++] = c;
+  online->numUsedComponents--;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Sets whether a component is totally unimodular.
+ */
+
+static
+void componentSetTotallyUnimodular(
+  CMR_TU_ONLINE* online,    /**< Online total unimodularity structure. */
+  size_t c,                 /**< Component. */
+  bool isTotallyUnimodular  /**< Whether the component is totally unimodular. */
+)
+{
+  assert(online);
+
+  TuOnlineComponent* component = &online->components[c];
+  if (component->isTotallyUnimodular && !isTotallyUnimodular)
+    online->numIrregular++;
+  else if (!component->isTotallyUnimodular && isTotallyUnimodular)
+    online->numIrregular--;
+  component->isTotallyUnimodular = isTotallyUnimodular;
+}
+
+/**
+ * \brief Adds a row to a component.
+ */
+
+static
+CMR_ERROR componentAddRow(
+  CMR_TU_ONLINE* online,  /**< Online total unimodularity structure. */
+  size_t c,               /**< Component. */
+  size_t row              /**< Row. */
+)
+{
+  assert(online);
+
+  TuOnlineComponent* component = &online->components[c];
+  if (component->numRows == component->memRows)
+  {
+    component->memRows *= 2;
+    CMR_CALL( CMRreallocBlockArray(online->cmr, &component->rows, component->memRows) );
+  }
+  online->rowsComponent[row] = c;
+  online->rowsLocal[row] = component->numRows;
+  component->rows[component->numRows++] = row;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Adds a column to a component.
+ */
+
+static
+CMR_ERROR componentAddColumn(
+  CMR_TU_ONLINE* online,  /**< Online total unimodularity structure. */
+  size_t c,               /**< Component. */
+  size_t slot             /**< Slot of the column. */
+)
+{
+  assert(online);
+
+  TuOnlineComponent* component = &online->components[c];
+  if (component->numColumns == component->memColumns)
+  {
+    component->memColumns *= 2;
+    CMR_CALL( CMRreallocBlockArray(online->cmr, &component->columns, component->memColumns) );
+  }
+  online->slots[slot].component = c;
+  online->slots[slot].componentIndex = component->numColumns;
+  component->columns[component->numColumns++] = slot;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Creates the matrix of a component, whose rows and columns are ordered as in the component.
+ */
+
+static
+CMR_ERROR componentCreateMatrix(
+  CMR_TU_ONLINE* online,  /**< Online total unimodularity structure. */
+  size_t c,               /**< Component. */
+  CMR_CHRMAT** pmatrix    /**< Pointer for storing the matrix. */
+)
+{
+  assert(online);
+  assert(pmatrix);
+
+  CMR* cmr = online->cmr;
+  TuOnlineComponent* component = &online->components[c];
+  size_t numNonzeros = 0;
+  for (size_t j = 0; j < component->numColumns; ++j)
+    numNonzeros += online->slots[component->columns[j]].numEntries;
+
+  CMR_CALL( CMRchrmatCreate(cmr, pmatrix, component->numRows, component->numColumns, numNonzeros) );
+  CMR_CHRMAT* matrix = *pmatrix;
+
+  /* Count the nonzeros per row and then fill the rows in the order of the columns. */
+  for (size_t i = 0; i <= component->numRows; ++i)
+    matrix->rowSlice[i] = 0;
+  for (size_t j = 0; j < component->numColumns; ++j)
+  {
+    TuOnlineColumn* column = &online->slots[component->columns[j]];
+    for (size_t e = 0; e < column->numEntries; ++e)
+      matrix->rowSlice[online->rowsLocal[column->rows[e]] + 1]++;
+  }
+  for (size_t i = 0; i < component->numRows; ++i)
+    matrix->rowSlice[i + 1] += matrix->rowSlice[i];
+  for (size_t j = 0; j < component->numColumns; ++j)
+  {
+    TuOnlineColumn* column = &online->slots[component->columns[j]];
+    for (size_t e = 0; e < column->numEntries; ++e)
+    {
+      size_t entry = matrix->rowSlice[online->rowsLocal[column->rows[e]]]++;
+      matrix->entryColumns[entry] = j;
+      matrix->entryValues[entry] = column->values[e];
+    }
+  }
+  for (size_t i = component->numRows; i > 0; --i)
+    matrix->rowSlice[i] = matrix->rowSlice[i - 1];
+  matrix->rowSlice[0] = 0;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Tests a component for total unimodularity from scratch.
+ */
+
+static
+CMR_ERROR componentTest(
+  CMR_TU_ONLINE* online,    /**< Online total unimodularity structure. */
+  size_t c,                 /**< Component. */
+  CMR_TU_STATS* stats,      /**< Statistics for the computation (may be \c NULL). */
+  CMR_DEADLINE* deadline    /**< Deadline. */
+)
+{
+  assert(online);
+
+  CMR* cmr = online->cmr;
+  CMR_CALL( CMRgraphicOnlineFree(cmr, &online->components[c].graphic) );
+
+  CMR_CHRMAT* matrix = NULL;
+  CMR_CALL( componentCreateMatrix(online, c, &matrix) );
+
+  CMRdbgMsg(2, "Re-testing component %zu with %zux%zu matrix.\n", c, matrix->numRows, matrix->numColumns);
+
+  bool isTotallyUnimodular = false;
+  CMR_ERROR error = CMRtuTest(cmr, matrix, &isTotallyUnimodular, NULL, NULL, &online->params, stats,
+    CMRdeadlineRemaining(deadline));
+  CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  if (error)
+    return error;
+
+  componentSetTotallyUnimodular(online, c, isTotallyUnimodular);
+  online->components[c].tryGraphic = isTotallyUnimodular;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Constructs the graphic decomposition of a component from scratch if its support is graphic.
+ */
+
+static
+CMR_ERROR componentBuildGraphic(
+  CMR_TU_ONLINE* online,  /**< Online total unimodularity structure. */
+  size_t c                /**< Component. */
+)
+{
+  assert(online);
+
+  CMR* cmr = online->cmr;
+  TuOnlineComponent* component = &online->components[c];
+  assert(!component->graphic);
+
+  component->tryGraphic = false;
+  CMR_CALL( CMRgraphicOnlineCreate(cmr, &component->graphic, component->numRows) );
+
+  size_t* localRows = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &localRows, component->numRows) );
+  bool isGraphic = true;
+  for (size_t j = 0; j < component->numColumns && isGraphic; ++j)
+  {
+    TuOnlineColumn* column = &online->slots[component->columns[j]];
+    for (size_t e = 0; e < column->numEntries; ++e)
+      localRows[e] = online->rowsLocal[column->rows[e]];
+    CMR_CALL( CMRgraphicOnlineTryColumn(component->graphic, column->numEntries, localRows, &isGraphic) );
+    if (isGraphic)
+      CMR_CALL( CMRgraphicOnlineAddColumn(component->graphic, column->numEntries, localRows) );
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &localRows) );
+
+  if (!isGraphic)
+    CMR_CALL( CMRgraphicOnlineFree(cmr, &component->graphic) );
+
+  CMRdbgMsg(2, "Support of component %zu is %sgraphic.\n", c, isGraphic ? "" : "not ");
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Adds a column to the only component it touches, which is totally unimodular.
+ *
+ * If the support of the component is graphic, then the column is added to its graphic decomposition, and if the
+ * support remains graphic, then only the signs are checked. Otherwise, the component is re-tested.
+ */
+
+static
+CMR_ERROR componentExtend(
+  CMR_TU_ONLINE* online,  /**< Online total unimodularity structure. */
+  size_t c,               /**< Component. */
+  size_t slot,            /**< Slot of the new column. */
+  CMR_TU_STATS* stats,    /**< Statistics for the computation (may be \c NULL). */
+  CMR_DEADLINE* deadline  /**< Deadline. */
+)
+{
+  assert(online);
+
+  CMR* cmr = online->cmr;
+  assert(online->components[c].isTotallyUnimodular);
+
+  if (!online->components[c].graphic && online->components[c].tryGraphic)
+    CMR_CALL( componentBuildGraphic(online, c) );
+
+  TuOnlineComponent* component = &online->components[c];
+  TuOnlineColumn* column = &online->slots[slot];
+  bool isGraphic = false;
+  if (component->graphic)
+  {
+    size_t* localRows = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &localRows, column->numEntries) );
+    for (size_t e = 0; e < column->numEntries; ++e)
+      localRows[e] = online->rowsLocal[column->rows[e]];
+    CMR_CALL( CMRgraphicOnlineTryColumn(component->graphic, column->numEntries, localRows, &isGraphic) );
+    if (isGraphic)
+      CMR_CALL( CMRgraphicOnlineAddColumn(component->graphic, column->numEntries, localRows) );
+    CMR_CALL( CMRfreeStackArray(cmr, &localRows) );
+  }
+
+  CMR_CALL( componentAddColumn(online, c, slot) );
+
+  if (!isGraphic)
+    return componentTest(online, c, stats, deadline);
+
+  /* A ternary matrix with graphic support is totally unimodular if and only if it is Camion-signed. */
+  CMRdbgMsg(2, "Support of component %zu remains graphic; checking signs.\n", c);
+  double time = CMRclockNow();
+  CMR_CHRMAT* matrix = NULL;
+  CMR_CALL( componentCreateMatrix(online, c, &matrix) );
+  bool isCamionSigned = false;
+  CMR_ERROR error = CMRcamionTestSigns(cmr, matrix, &isCamionSigned, NULL,
+    stats ? &stats->decomposition.camion : NULL, CMRdeadlineRemaining(deadline));
+  CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  if (error)
+    return error;
+
+  componentSetTotallyUnimodular(online, c, isCamionSigned);
+  if (!isCamionSigned)
+    CMR_CALL( CMRgraphicOnlineFree(cmr, &online->components[c].graphic) );
+
+  if (stats)
+  {
+    stats->decomposition.totalCount++;
+    stats->decomposition.totalTime += CMRclockNow() - time;
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRtuOnlineAddColumn(CMR_TU_ONLINE* online, size_t numEntries, size_t* rows, char* values,
+  bool* pisTotallyUnimodular, CMR_TU_STATS* stats, double timeLimit)
+{
+  assert(online);
+  assert(rows || !numEntries);
+  assert(values || !numEntries);
+  assert(pisTotallyUnimodular);
+
+  CMR* cmr = online->cmr;
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
+
+  size_t mark = nextMark(online);
+  for (size_t e = 0; e < numEntries; ++e)
+  {
+    if (rows[e] >= online->numRows)
+    {
+      CMRraiseErrorMessage(cmr, "Row %zu of new column exceeds number %zu of rows.", rows[e], online->numRows);
+      return CMR_ERROR_INPUT;
+    }
+    if (values[e] != 1 && values[e] != -1)
+    {
+      CMRraiseErrorMessage(cmr, "Entry %d of new column in row %zu is not -1 or +1.", values[e], rows[e]);
+      return CMR_ERROR_INPUT;
+    }
+    if (online->rowsMark[rows[e]] == mark)
+    {
+      CMRraiseErrorMessage(cmr, "Row %zu of new column appears twice.", rows[e]);
+      return CMR_ERROR_INPUT;
+    }
+    online->rowsMark[rows[e]] = mark;
+  }
+
+  /* Store the new column in a slot. */
+  size_t slot;
+  if (online->numFreeSlots)
+    slot = online->freeSlots[--online->numFreeSlots];
+  else
+  {
+    if (online->numSlots == online->memSlots)
+    {
+      online->memSlots *= 2;
+      CMR_CALL( CMRreallocBlockArray(cmr, &online->slots, online->memSlots) );
+      CMR_CALL( CMRreallocBlockArray(cmr, &online->freeSlots, online->memSlots) );
+    }
+    slot = online->numSlots++;
+    online->slots[slot].memEntries = 0;
+    online->slots[slot].rows = NULL;
+    online->slots[slot].values = NULL;
+  }
+  TuOnlineColumn* column = &online->slots[slot];
+  if (column->memEntries < numEntries)
+  {
+    column->memEntries = numEntries;
+    CMR_CALL( CMRreallocBlockArray(cmr, &column->rows, numEntries) );
+    CMR_CALL( CMRreallocBlockArray(cmr, &column->values, numEntries) );
+  }
+  column->numEntries = numEntries;
+  if (numEntries)
+  {
+    memcpy(column->rows, rows, numEntries * sizeof(size_t));
+    memcpy(column->values, values, numEntries * sizeof(char));
+  }
+  column->component = NONE;
+
+  if (online->numColumns == online->memColumns)
+  {
+    online->memColumns *= 2;
+    CMR_CALL( CMRreallocBlockArray(cmr, &online->columnsSlot, online->memColumns) );
+  }
+  online->columnsSlot[online->numColumns++] = slot;
+
+  if (numEntries)
+  {
+    /* Collect the touched components and find the largest one. */
+    size_t* touched = NULL;
+    CMR_CALL( CMRallocStackArray(cmr, &touched, numEntries) );
+    size_t numTouched = 0;
+    size_t numNewRows = 0;
+    size_t largest = NONE;
+    bool isTotallyUnimodular = true;
+    for (size_t e = 0; e < numEntries; ++e)
+    {
+      size_t c = online->rowsComponent[rows[e]];
+      if (c == NONE)
+        ++numNewRows;
+      else if (online->componentsMark[c] != mark)
+      {
+        online->componentsMark[c] = mark;
+        touched[numTouched++] = c;
+        TuOnlineComponent* component = &online->components[c];
+        isTotallyUnimodular = isTotallyUnimodular && component->isTotallyUnimodular;
+        if (largest == NONE || component->numRows + component->numColumns
+          > online->components[largest].numRows + online->components[largest].numColumns)
+        {
+          largest = c;
+        }
+      }
+    }
+
+    CMRdbgMsg(0, "Adding column %zu with %zu nonzeros touching %zu components and %zu new rows.\n",
+      online->numColumns - 1, numEntries, numTouched, numNewRows);
+
+    CMR_ERROR error = CMR_OKAY;
+    if (numTouched == 1 && !numNewRows && isTotallyUnimodular)
+      error = componentExtend(online, largest, slot, stats, &deadline);
+    else
+    {
+      /* Merge all touched components into the largest one. */
+      size_t target = largest;
+      if (target == NONE)
+        error = componentCreate(online, &target);
+      for (size_t t = 0; t < numTouched && !error; ++t)
+      {
+        size_t c = touched[t];
+        if (c == target)
+          continue;
+
+        TuOnlineComponent* component = &online->components[c];
+        for (size_t i = 0; i < component->numRows && !error; ++i)
+          error = componentAddRow(online, target, component->rows[i]);
+        for (size_t j = 0; j < component->numColumns && !error; ++j)
+          error = componentAddColumn(online, target, component->columns[j]);
+        component = &online->components[c];
+        component->numRows = 0;
+        component->numColumns = 0;
+        if (!error)
+          error = componentRelease(online, c);
+      }
+      for (size_t e = 0; e < numEntries && !error; ++e)
+      {
+        if (online->rowsComponent[rows[e]] == NONE)
+          error = componentAddRow(online, target, rows[e]);
+      }
+      if (!error)
+        error = componentAddColumn(online, target, slot);
+      if (!error)
+      {
+        CMR_CALL( CMRgraphicOnlineFree(cmr, &online->components[target].graphic) );
+        if (isTotallyUnimodular)
+          error = componentTest(online, target, stats, &deadline);
+        else
+        {
+          /* A matrix with a submatrix that is not totally unimodular is not totally unimodular. */
+          componentSetTotallyUnimodular(online, target, false);
+          online->components[target].tryGraphic = false;
+        }
+      }
+    }
+
+    CMR_CALL( CMRfreeStackArray(cmr, &touched) );
+    if (error)
+      return error;
+  }
+
+  *pisTotallyUnimodular = online->numIrregular == 0;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Finds the representative of \p element in the union-find structure \p parent, compressing paths.
+ */
+
+static
+size_t findRepresentative(
+  size_t* parent, /**< Parent array of the union-find structure. */
+  size_t element  /**< Element. */
+)
+{
+  size_t root = element;
+  while (parent[root] != root)
+    root = parent[root];
+  while (parent[element] != root)
+  {
+    size_t next = parent[element];
+    parent[element] = root;
+    element = next;
+  }
+
+  return root;
+}
+
+CMR_ERROR CMRtuOnlineRemoveColumn(CMR_TU_ONLINE* online, size_t column, bool* pisTotallyUnimodular,
+  CMR_TU_STATS* stats, double timeLimit)
+{
+  assert(online);
+  assert(pisTotallyUnimodular);
+
+  CMR* cmr = online->cmr;
+  CMR_DEADLINE deadline = CMRdeadlineCreate(cmr, timeLimit);
+
+  if (column >= online->numColumns)
+  {
+    CMRraiseErrorMessage(cmr, "Column %zu exceeds number %zu of columns.", column, online->numColumns);
+    return CMR_ERROR_INPUT;
+  }
+
+  size_t slot = online->columnsSlot[column];
+  memmove(&online->columnsSlot[column], &online->columnsSlot[column + 1],
+    (online->numColumns - column - 1) * sizeof(size_t));
+  online->numColumns--;
+
+  size_t c = online->slots[slot].component;
+  online->slots[slot].numEntries = NONE;
+  online->freeSlots[online->numFreeSlots++] = slot;
+  if (c == NONE)
+  {
+    *pisTotallyUnimodular = online->numIrregular == 0;
+    return CMR_OKAY;
+  }
+
+  CMRdbgMsg(0, "Removing column %zu from component %zu.\n", column, c);
+
+  /* Remove the column from its component, moving the last column to its place. */
+  TuOnlineComponent* component = &online->components[c];
+  size_t index = online->slots[slot].componentIndex;
+  size_t lastSlot = component->columns[--component->numColumns];
+  if (lastSlot != slot)
+  {
+    component->columns[index] = lastSlot;
+    online->slots[lastSlot].componentIndex = index;
+  }
+  CMR_CALL( CMRgraphicOnlineFree(cmr, &component->graphic) );
+  bool wasTotallyUnimodular = component->isTotallyUnimodular;
+  component->tryGraphic = wasTotallyUnimodular;
+
+  /* Compute the connected components of the remaining columns via union-find on the rows. */
+  size_t numRows = component->numRows;
+  size_t numColumns = component->numColumns;
+  size_t* oldRows = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &oldRows, numRows) );
+  size_t* oldColumns = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &oldColumns, numColumns) );
+  size_t* parent = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &parent, numRows) );
+  size_t* pieceComponent = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &pieceComponent, numRows) );
+  bool* isRowUsed = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &isRowUsed, numRows) );
+
+  for (size_t i = 0; i < numRows; ++i)
+  {
+    oldRows[i] = component->rows[i];
+    parent[i] = i;
+    pieceComponent[i] = NONE;
+    isRowUsed[i] = false;
+  }
+  for (size_t j = 0; j < numColumns; ++j)
+  {
+    oldColumns[j] = component->columns[j];
+    TuOnlineColumn* col = &online->slots[oldColumns[j]];
+    size_t first = findRepresentative(parent, online->rowsLocal[col->rows[0]]);
+    isRowUsed[online->rowsLocal[col->rows[0]]] = true;
+    for (size_t e = 1; e < col->numEntries; ++e)
+    {
+      size_t local = online->rowsLocal[col->rows[e]];
+      isRowUsed[local] = true;
+      size_t root = findRepresentative(parent, local);
+      if (root != first)
+        parent[root] = first;
+    }
+  }
+
+  /* The piece of the first used row keeps the component; the other pieces get new components. */
+  for (size_t i = 0; i < numRows; ++i)
+    parent[i] = findRepresentative(parent, i);
+  component->numRows = 0;
+  component->numColumns = 0;
+  size_t numPieces = 0;
+  CMR_ERROR error = CMR_OKAY;
+  for (size_t i = 0; i < numRows && !error; ++i)
+  {
+    size_t row = oldRows[i];
+    if (!isRowUsed[i])
+    {
+      online->rowsComponent[row] = NONE;
+      continue;
+    }
+    size_t root = parent[i];
+    if (pieceComponent[root] == NONE)
+    {
+      if (numPieces == 0)
+        pieceComponent[root] = c;
+      else
+      {
+        error = componentCreate(online, &pieceComponent[root]);
+        if (!error)
+        {
+          componentSetTotallyUnimodular(online, pieceComponent[root], wasTotallyUnimodular);
+          online->components[pieceComponent[root]].tryGraphic = wasTotallyUnimodular;
+        }
+      }
+      ++numPieces;
+    }
+    if (!error)
+      error = componentAddRow(online, pieceComponent[root], row);
+  }
+  for (size_t j = 0; j < numColumns && !error; ++j)
+  {
+    TuOnlineColumn* col = &online->slots[oldColumns[j]];
+    error = componentAddColumn(online, online->rowsComponent[col->rows[0]], oldColumns[j]);
+  }
+
+  CMRdbgMsg(2, "Component %zu was split into %zu pieces.\n", c, numPieces);
+
+  if (!error && numPieces == 0)
+    error = componentRelease(online, c);
+
+  /* Only pieces of a component that was not totally unimodular must be re-tested. */
+  if (!wasTotallyUnimodular)
+  {
+    for (size_t i = 0; i < numRows && !error; ++i)
+    {
+      if (isRowUsed[i] && parent[i] == i)
+        error = componentTest(online, pieceComponent[i], stats, &deadline);
+    }
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &isRowUsed) );
+  CMR_CALL( CMRfreeStackArray(cmr, &pieceComponent) );
+  CMR_CALL( CMRfreeStackArray(cmr, &parent) );
+  CMR_CALL( CMRfreeStackArray(cmr, &oldColumns) );
+  CMR_CALL( CMRfreeStackArray(cmr, &oldRows) );
+  if (error)
+    return error;
+
+  *pisTotallyUnimodular = online->numIrregular == 0;
+
+  return CMR_OKAY;
+}
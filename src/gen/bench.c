@@ -0,0 +1,667 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <cmr/graphic.h>
+#include <cmr/network.h>
+#include <cmr/series_parallel.h>
+#include <cmr/regular.h>
+#include <cmr/tu.h>
+
+#include "bench_common.h"
+#include "generators.h"
+
+#define MAX_VALUES 64 /**< Maximum number of values of a swept parameter. */
+#define MAX_BASELINES 4096 /**< Maximum number of measurements in a baseline file. */
+#define MIN_TIME_DIFFERENCE 1.0e-3 /**< Slowdowns of fewer seconds are never reported as regressions. */
+
+typedef enum
+{
+  FAMILY_GRAPHIC = 0,           /**< Graphic matrices from \ref CMRgenerateGraphicMatrix. */
+  FAMILY_NETWORK = 1,           /**< Network matrices from \ref CMRgenerateNetworkMatrix. */
+  FAMILY_SERIES_PARALLEL = 2,   /**< Matrices from \ref CMRgenerateSeriesParallelMatrix. */
+  FAMILY_RANDOM = 3,            /**< Random matrices from \ref CMRgenerateRandomMatrix. */
+  NUM_FAMILIES = 4
+} Family;
+
+static const char* familyNames[NUM_FAMILIES] = { "graphic", "network", "series-parallel", "random" };
+
+typedef enum
+{
+  ENTRY_GRAPHIC = 0,          /**< \ref CMRgraphicTestMatrix. */
+  ENTRY_NETWORK = 1,          /**< \ref CMRnetworkTestMatrix. */
+  ENTRY_SERIES_PARALLEL = 2,  /**< \ref CMRtestBinarySeriesParallel or \ref CMRtestTernarySeriesParallel. */
+  ENTRY_REGULAR = 3,          /**< \ref CMRregularTest. */
+  ENTRY_TU = 4,               /**< \ref CMRtuTest. */
+  NUM_ENTRIES = 5
+} Entry;
+
+static const char* entryNames[NUM_ENTRIES] = { "graphic", "network", "series-parallel", "regular", "tu" };
+
+/**
+ * \brief Entry points that are benchmarked for the matrices of each family.
+ */
+
+static const bool familyEntries[NUM_FAMILIES][NUM_ENTRIES] = {
+  { true, false, false, true, false },
+  { false, true, false, false, true },
+  { false, false, true, true, false },
+  { false, false, false, true, false }
+};
+
+/**
+ * \brief Measurement of a previous run that is compared to the current one.
+ */
+
+typedef struct
+{
+  char family[32];    /**< \brief Name of the matrix family. */
+  char entry[32];     /**< \brief Name of the entry point. */
+  size_t numRows;     /**< \brief Number of rows. */
+  size_t numColumns;  /**< \brief Number of columns. */
+  double probability; /**< \brief Probability of a nonzero. */
+  double median;      /**< \brief Median time in seconds. */
+  size_t peakMemory;  /**< \brief Peak memory in bytes. */
+} Baseline;
+
+/**
+ * \brief Settings for comparing the measurements to a baseline.
+ */
+
+typedef struct
+{
+  Baseline* baselines;    /**< \brief Array of baseline measurements. */
+  size_t numBaselines;    /**< \brief Length of \ref baselines. */
+  double timeThreshold;   /**< \brief Maximum allowed ratio of the median time to that of the baseline. */
+  double memoryThreshold; /**< \brief Maximum allowed ratio of the peak memory to that of the baseline. */
+  FILE* report;           /**< \brief Stream for the report with the deltas, or \c NULL. */
+  size_t numRegressions;  /**< \brief Number of measurements that exceeded a threshold. */
+} Comparison;
+
+int printUsage(const char* program)
+{
+  fprintf(stderr, "Usage: %s [OPTION]...\n\n", program);
+  fputs("  generates random matrices of several families and sizes, times the library functions for them and writes\n"
+    "  one CSV line per family, entry point and size.\n\n", stderr);
+  fputs("Options:\n", stderr);
+  fputs("  -f FAMILIES  Comma-separated matrix families among `graphic', `network', `series-parallel' and `random';\n"
+    "               default: all.\n", stderr);
+  fputs("  -e ENTRIES   Comma-separated entry points among `graphic', `network', `series-parallel', `regular' and\n"
+    "               `tu'; default: all that apply to a family.\n", stderr);
+  fputs("  -m ROWS      Comma-separated numbers of rows; default: 100,200,400,800.\n", stderr);
+  fputs("  -c RATIOS    Comma-separated ratios of columns to rows; default: 1.\n", stderr);
+  fputs("  -p PROBS     Comma-separated probabilities of nonzeros for the series-parallel and random families;\n"
+    "               default: 0.05.\n", stderr);
+  fputs("  -w NUM       Number of untimed warmup runs per measurement; default: 1.\n", stderr);
+  fputs("  -n NUM       Number of timed repetitions per measurement; default: 5.\n", stderr);
+  fputs("  -o FILE      Write the CSV to FILE; default: stdout.\n\n", stderr);
+  fputs("Advanced options:\n", stderr);
+  fputs("  --seed SEED          Seed of the random number generator; default: 1.\n", stderr);
+  fputs("  --threads NUM        Use NUM threads, where 0 means all available processors; default: 1.\n", stderr);
+  fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for each run.\n\n", stderr);
+  fputs("Regression options:\n", stderr);
+  fputs("  --baseline FILE      Compare the measurements to those in the CSV FILE written by an earlier run.\n",
+    stderr);
+  fputs("  --threshold FACTOR   Report a regression if the median time exceeds FACTOR times that of the baseline;\n"
+    "                       default: 3.\n", stderr);
+  fputs("  --memory-threshold FACTOR\n"
+    "                       Report a regression if the peak memory exceeds FACTOR times that of the baseline;\n"
+    "                       default: 1.5.\n", stderr);
+  fputs("  --perf-report FILE   Write one CSV line with the deltas to the baseline per measurement to FILE; `-' for\n"
+    "                       stdout.\n\n", stderr);
+  fputs("Each family is generated once per combination of rows, ratio and probability. For the series-parallel family,\n"
+    "the base matrix has half of the rows and columns, and the remaining ones are unit or copied rows and columns.\n",
+    stderr);
+  fputs("Reported times are in seconds; the percentiles are computed by the nearest-rank method. The peak memory is\n"
+    "the maximum number of bytes of block and stack memory of the library during a run.\n", stderr);
+  fputs("With --baseline, the exit code is nonzero if a measurement exceeds a threshold. Slowdowns by less than one\n"
+    "millisecond are ignored.\n", stderr);
+
+  return EXIT_FAILURE;
+}
+
+/**
+ * \brief Reads the measurements of an earlier run from the CSV file \p fileName.
+ *
+ * Returns \c false if the file cannot be read or has too many lines.
+ */
+
+static
+bool readBaselines(
+  const char* fileName,   /**< Name of the CSV file. */
+  Baseline* baselines,    /**< Array of length \ref MAX_BASELINES for storing the measurements. */
+  size_t* pnumBaselines   /**< Pointer for storing the number of measurements. */
+)
+{
+  FILE* file = fopen(fileName, "r");
+  if (!file)
+    return false;
+
+  *pnumBaselines = 0;
+  char line[1024];
+  bool valid = true;
+  while (valid && fgets(line, sizeof(line), file))
+  {
+    Baseline baseline;
+    double values[10];
+    if (sscanf(line, "%31[^,],%31[^,],%zu,%zu,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%zu", baseline.family,
+      baseline.entry, &baseline.numRows, &baseline.numColumns, &baseline.probability, &values[0], &values[1],
+      &values[2], &values[3], &values[4], &values[5], &values[6], &values[7], &values[8], &baseline.peakMemory) != 15)
+    {
+      /* Header line. */
+      continue;
+    }
+    baseline.median = values[5];
+    if (*pnumBaselines == MAX_BASELINES)
+      valid = false;
+    else
+      baselines[(*pnumBaselines)++] = baseline;
+  }
+
+  fclose(file);
+
+  return valid;
+}
+
+/**
+ * \brief Compares a measurement to the matching one of the baseline, writes the deltas to the report and counts it if
+ *        it exceeds a threshold.
+ */
+
+static
+void compareToBaseline(
+  Comparison* comparison, /**< Baseline and thresholds. */
+  Family family,          /**< Matrix family. */
+  Entry entry,            /**< Entry point. */
+  CMR_CHRMAT* matrix,     /**< Matrix. */
+  double probability,     /**< Probability of a nonzero. */
+  double median,          /**< Median time in seconds. */
+  size_t peakMemory       /**< Peak memory in bytes. */
+)
+{
+  Baseline* baseline = NULL;
+  for (size_t b = 0; b < comparison->numBaselines && !baseline; ++b)
+  {
+    Baseline* candidate = &comparison->baselines[b];
+    if (!strcmp(candidate->family, familyNames[family]) && !strcmp(candidate->entry, entryNames[entry])
+      && candidate->numRows == matrix->numRows && candidate->numColumns == matrix->numColumns
+      && fabs(candidate->probability - probability) < 1.0e-9)
+    {
+      baseline = candidate;
+    }
+  }
+
+  const char* status = "new";
+  double timeRatio = 0.0;
+  double memoryRatio = 0.0;
+  if (baseline)
+  {
+    timeRatio = baseline->median > 0.0 ? median / baseline->median : 1.0;
+    memoryRatio = baseline->peakMemory > 0 ? peakMemory * 1.0 / baseline->peakMemory
+      : (peakMemory > 0 ? DBL_MAX : 1.0);
+    status = "ok";
+    if (timeRatio > comparison->timeThreshold && median - baseline->median >= MIN_TIME_DIFFERENCE)
+      status = "slower";
+    else if (memoryRatio > comparison->memoryThreshold)
+      status = "larger";
+    if (strcmp(status, "ok"))
+      comparison->numRegressions++;
+  }
+
+  if (comparison->report)
+  {
+    fprintf(comparison->report, "%s,%s,%zu,%zu,%g,%.9g,%.9g,%.3f,%zu,%zu,%.3f,%s\n", familyNames[family],
+      entryNames[entry], matrix->numRows, matrix->numColumns, probability, baseline ? baseline->median : 0.0, median,
+      timeRatio, baseline ? baseline->peakMemory : 0, peakMemory, memoryRatio, status);
+    fflush(comparison->report);
+  }
+}
+
+/**
+ * \brief Generates a matrix of the given family.
+ */
+
+static
+CMR_ERROR generateMatrix(
+  CMR* cmr,             /**< \ref CMR environment. */
+  Family family,        /**< Matrix family. */
+  size_t numRows,       /**< Number of rows. */
+  size_t numColumns,    /**< Number of columns. */
+  double probability,   /**< Probability of a nonzero for the series-parallel and random families. */
+  CMR_CHRMAT** pmatrix  /**< Pointer for storing the matrix. */
+)
+{
+  switch (family)
+  {
+  case FAMILY_GRAPHIC:
+    return CMRgenerateGraphicMatrix(cmr, numRows, numColumns, pmatrix);
+  case FAMILY_NETWORK:
+    return CMRgenerateNetworkMatrix(cmr, numRows, numColumns, false, pmatrix);
+  case FAMILY_SERIES_PARALLEL:
+  {
+    size_t numBaseRows = (numRows + 1) / 2;
+    size_t numBaseColumns = (numColumns + 1) / 2;
+    size_t numUnitRows = (numRows - numBaseRows) / 2;
+    size_t numUnitColumns = (numColumns - numBaseColumns) / 2;
+    return CMRgenerateSeriesParallelMatrix(cmr, numBaseRows, numBaseColumns, 0, 0, numUnitRows, numUnitColumns,
+      numRows - numBaseRows - numUnitRows, numColumns - numBaseColumns - numUnitColumns, false, probability, true,
+      pmatrix, NULL);
+  }
+  default:
+    return CMRgenerateRandomMatrix(cmr, numRows, numColumns, probability, pmatrix);
+  }
+}
+
+/**
+ * \brief Runs \p entry once for \p matrix.
+ */
+
+static
+CMR_ERROR runEntry(
+  CMR* cmr,           /**< \ref CMR environment. */
+  Entry entry,        /**< Entry point to run. */
+  CMR_CHRMAT* matrix, /**< Matrix. */
+  double timeLimit    /**< Time limit to impose. */
+)
+{
+  switch (entry)
+  {
+  case ENTRY_GRAPHIC:
+  {
+    bool isGraphic;
+    CMR_CALL( CMRgraphicTestMatrix(cmr, matrix, &isGraphic, NULL, NULL, NULL, NULL, NULL, timeLimit) );
+    break;
+  }
+  case ENTRY_NETWORK:
+  {
+    bool isNetwork;
+    CMR_CALL( CMRnetworkTestMatrix(cmr, matrix, &isNetwork, NULL, NULL, NULL, NULL, NULL, NULL, NULL, timeLimit) );
+    break;
+  }
+  case ENTRY_SERIES_PARALLEL:
+  {
+    CMR_SP_REDUCTION* reductions = NULL;
+    CMR_CALL( CMRallocBlockArray(cmr, &reductions, matrix->numRows + matrix->numColumns) );
+    size_t numReductions;
+    CMR_CALL( CMRtestBinarySeriesParallel(cmr, matrix, NULL, reductions, &numReductions, NULL, NULL, NULL,
+      timeLimit) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &reductions) );
+    break;
+  }
+  case ENTRY_REGULAR:
+  {
+    bool isRegular;
+    CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, NULL, NULL, timeLimit) );
+    break;
+  }
+  default:
+  {
+    bool isTotallyUnimodular;
+    CMR_CALL( CMRtuTest(cmr, matrix, &isTotallyUnimodular, NULL, NULL, NULL, NULL, timeLimit) );
+    break;
+  }
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Times \p entry for \p matrix and writes the CSV line.
+ *
+ * Every run works on a fresh copy of \p matrix such that no run benefits from data cached by the library for the
+ * previous one. The peak memory of a run does not include the copy.
+ */
+
+static
+CMR_ERROR benchmarkEntry(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  FILE* output,             /**< Stream for the CSV line. */
+  Family family,            /**< Matrix family. */
+  Entry entry,              /**< Entry point to benchmark. */
+  CMR_CHRMAT* matrix,       /**< Matrix. */
+  double probability,       /**< Probability of a nonzero, written to the CSV line. */
+  size_t numWarmups,        /**< Number of untimed runs. */
+  size_t numRepetitions,    /**< Number of timed runs. */
+  double timeLimit,         /**< Time limit to impose for each run. */
+  Comparison* comparison    /**< Baseline to compare to, or \c NULL. */
+)
+{
+  double* times = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &times, numRepetitions) );
+  size_t peakMemory = 0;
+
+  for (size_t run = 0; run < numWarmups + numRepetitions; ++run)
+  {
+    CMR_CHRMAT* copy = NULL;
+    CMR_CALL( CMRchrmatCopy(cmr, matrix, &copy) );
+
+    size_t usage = CMRgetMemoryUsage(cmr);
+    CMR_CALL( CMRresetMemoryStats(cmr) );
+
+    double start = CMRbenchClock();
+    CMR_CALL( runEntry(cmr, entry, copy, timeLimit) );
+    if (run >= numWarmups)
+      times[run - numWarmups] = CMRbenchClock() - start;
+
+    size_t peak = CMRgetMemoryPeak(cmr) - usage;
+    if (peak > peakMemory)
+      peakMemory = peak;
+
+    CMR_CALL( CMRchrmatFree(cmr, &copy) );
+  }
+
+  CMR_BENCH_TIMES stats;
+  CMRbenchSummarizeTimes(times, numRepetitions, &stats);
+
+  fprintf(output, "%s,%s,%zu,%zu,%g,%zu,%zu,%zu,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%zu\n", familyNames[family],
+    entryNames[entry], matrix->numRows, matrix->numColumns, probability, matrix->numNonzeros, numWarmups,
+    numRepetitions, stats.min, stats.percentile10, stats.median, stats.percentile90, stats.max, stats.mean, peakMemory);
+  fflush(output);
+
+  if (comparison)
+    compareToBaseline(comparison, family, entry, matrix, probability, stats.median, peakMemory);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &times) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Runs the whole benchmark.
+ */
+
+static
+CMR_ERROR benchmark(
+  FILE* output,                 /**< Stream for the CSV. */
+  bool* families,               /**< Array indicating the families to generate. */
+  bool* entries,                /**< Array indicating the entry points to benchmark. */
+  double* rows,                 /**< Array with the numbers of rows. */
+  size_t numRowValues,          /**< Length of \p rows. */
+  double* ratios,               /**< Array with the ratios of columns to rows. */
+  size_t numRatioValues,        /**< Length of \p ratios. */
+  double* probabilities,        /**< Array with the probabilities of nonzeros. */
+  size_t numProbabilityValues,  /**< Length of \p probabilities. */
+  size_t numWarmups,            /**< Number of untimed runs per measurement. */
+  size_t numRepetitions,        /**< Number of timed runs per measurement. */
+  double timeLimit,             /**< Time limit to impose for each run. */
+  int numThreads,               /**< Number of threads to use. */
+  Comparison* comparison        /**< Baseline to compare to, or \c NULL. */
+)
+{
+  CMR* cmr = NULL;
+  CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+  fputs("family,entry,rows,columns,probability,nonzeros,warmups,repetitions,min,p10,median,p90,max,mean,peakmemory\n",
+    output);
+  if (comparison && comparison->report)
+  {
+    fputs("family,entry,rows,columns,probability,basemedian,median,timeratio,basepeakmemory,peakmemory,memoryratio,"
+      "status\n", comparison->report);
+  }
+
+  for (int family = 0; family < NUM_FAMILIES; ++family)
+  {
+    if (!families[family])
+      continue;
+
+    /* The probability only affects some families. */
+    bool hasProbability = family == FAMILY_SERIES_PARALLEL || family == FAMILY_RANDOM;
+    for (size_t p = 0; p < (hasProbability ? numProbabilityValues : 1); ++p)
+    {
+      double probability = hasProbability ? probabilities[p] : 0.0;
+      for (size_t r = 0; r < numRowValues; ++r)
+      {
+        for (size_t c = 0; c < numRatioValues; ++c)
+        {
+          size_t numRows = (size_t) rows[r];
+          size_t numColumns = (size_t) (rows[r] * ratios[c] + 0.5);
+          if (numRows == 0 || numColumns == 0)
+            continue;
+
+          CMR_CHRMAT* matrix = NULL;
+          CMR_CALL( generateMatrix(cmr, (Family) family, numRows, numColumns, probability, &matrix) );
+          for (int entry = 0; entry < NUM_ENTRIES; ++entry)
+          {
+            if (entries[entry] && familyEntries[family][entry])
+            {
+              CMR_CALL( benchmarkEntry(cmr, output, (Family) family, (Entry) entry, matrix, probability, numWarmups,
+                numRepetitions, timeLimit, comparison) );
+            }
+          }
+          CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+        }
+      }
+    }
+  }
+
+  CMR_CALL( CMRfreeEnvironment(&cmr) );
+
+  return CMR_OKAY;
+}
+
+int main(int argc, char** argv)
+{
+  bool families[NUM_FAMILIES] = { true, true, true, true };
+  bool entries[NUM_ENTRIES] = { true, true, true, true, true };
+  double rows[MAX_VALUES] = { 100, 200, 400, 800 };
+  size_t numRowValues = 4;
+  double ratios[MAX_VALUES] = { 1.0 };
+  size_t numRatioValues = 1;
+  double probabilities[MAX_VALUES] = { 0.05 };
+  size_t numProbabilityValues = 1;
+  size_t numWarmups = 1;
+  size_t numRepetitions = 5;
+  char* outputFileName = NULL;
+  unsigned int seed = 1;
+  int numThreads = 1;
+  double timeLimit = DBL_MAX;
+  char* baselineFileName = NULL;
+  char* reportFileName = NULL;
+  double timeThreshold = 3.0;
+  double memoryThreshold = 1.5;
+  for (int a = 1; a < argc; ++a)
+  {
+    if (!strcmp(argv[a], "-h"))
+    {
+      printUsage(argv[0]);
+      return EXIT_SUCCESS;
+    }
+    else if (!strcmp(argv[a], "-f") && a+1 < argc)
+    {
+      if (!CMRbenchParseNames(argv[++a], familyNames, NUM_FAMILIES, families))
+      {
+        fprintf(stderr, "Error: invalid families <%s>.\n\n", argv[a]);
+        return printUsage(argv[0]);
+      }
+    }
+    else if (!strcmp(argv[a], "-e") && a+1 < argc)
+    {
+      if (!CMRbenchParseNames(argv[++a], entryNames, NUM_ENTRIES, entries))
+      {
+        fprintf(stderr, "Error: invalid entry points <%s>.\n\n", argv[a]);
+        return printUsage(argv[0]);
+      }
+    }
+    else if (!strcmp(argv[a], "-m") && a+1 < argc)
+    {
+      if (!CMRbenchParseList(argv[++a], 0.0, MAX_VALUES, rows, &numRowValues))
+      {
+        fprintf(stderr, "Error: invalid numbers of rows <%s>.\n\n", argv[a]);
+        return printUsage(argv[0]);
+      }
+    }
+    else if (!strcmp(argv[a], "-c") && a+1 < argc)
+    {
+      if (!CMRbenchParseList(argv[++a], 0.0, MAX_VALUES, ratios, &numRatioValues))
+      {
+        fprintf(stderr, "Error: invalid ratios <%s>.\n\n", argv[a]);
+        return printUsage(argv[0]);
+      }
+    }
+    else if (!strcmp(argv[a], "-p") && a+1 < argc)
+    {
+      if (!CMRbenchParseList(argv[++a], 0.0, MAX_VALUES, probabilities, &numProbabilityValues))
+      {
+        fprintf(stderr, "Error: invalid probabilities <%s>.\n\n", argv[a]);
+        return printUsage(argv[0]);
+      }
+      for (size_t p = 0; p < numProbabilityValues; ++p)
+      {
+        if (probabilities[p] > 1.0)
+        {
+          fprintf(stderr, "Error: probability %g is not in [0,1].\n\n", probabilities[p]);
+          return printUsage(argv[0]);
+        }
+      }
+    }
+    else if ((!strcmp(argv[a], "-w") || !strcmp(argv[a], "-n")) && a+1 < argc)
+    {
+      char* p = NULL;
+      size_t value = strtoull(argv[a+1], &p, 10);
+      if (*p != '\0' || (argv[a][1] == 'n' && value == 0))
+      {
+        fprintf(stderr, "Error: invalid number of runs <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      if (argv[a][1] == 'w')
+        numWarmups = value;
+      else
+        numRepetitions = value;
+      ++a;
+    }
+    else if (!strcmp(argv[a], "-o") && a+1 < argc)
+      outputFileName = argv[++a];
+    else if (!strcmp(argv[a], "--seed") && a+1 < argc)
+    {
+      char* p = NULL;
+      seed = (unsigned int) strtoul(argv[a+1], &p, 10);
+      if (*p != '\0')
+      {
+        fprintf(stderr, "Error: invalid seed <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--threads") && a+1 < argc)
+    {
+      char* p = NULL;
+      numThreads = (int) strtol(argv[a+1], &p, 10);
+      if (*p != '\0' || numThreads < 0)
+      {
+        fprintf(stderr, "Error: invalid number of threads <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--time-limit") && a+1 < argc)
+    {
+      if (sscanf(argv[a+1], "%lf", &timeLimit) == 0 || timeLimit <= 0)
+      {
+        fprintf(stderr, "Error: Invalid time limit <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--baseline") && a+1 < argc)
+      baselineFileName = argv[++a];
+    else if (!strcmp(argv[a], "--perf-report") && a+1 < argc)
+      reportFileName = argv[++a];
+    else if ((!strcmp(argv[a], "--threshold") || !strcmp(argv[a], "--memory-threshold")) && a+1 < argc)
+    {
+      double threshold;
+      if (sscanf(argv[a+1], "%lf", &threshold) == 0 || threshold < 1.0)
+      {
+        fprintf(stderr, "Error: Invalid threshold <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      if (!strcmp(argv[a], "--threshold"))
+        timeThreshold = threshold;
+      else
+        memoryThreshold = threshold;
+      ++a;
+    }
+    else
+    {
+      fprintf(stderr, "Error: Unknown option <%s>.\n\n", argv[a]);
+      return printUsage(argv[0]);
+    }
+  }
+
+  FILE* output = stdout;
+  if (outputFileName && strcmp(outputFileName, "-"))
+  {
+    output = fopen(outputFileName, "w");
+    if (!output)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", outputFileName);
+      return EXIT_FAILURE;
+    }
+  }
+
+  Comparison comparison;
+  comparison.baselines = NULL;
+  comparison.numBaselines = 0;
+  comparison.timeThreshold = timeThreshold;
+  comparison.memoryThreshold = memoryThreshold;
+  comparison.report = NULL;
+  comparison.numRegressions = 0;
+  if (baselineFileName)
+  {
+    comparison.baselines = malloc(MAX_BASELINES * sizeof(Baseline));
+    if (!comparison.baselines || !readBaselines(baselineFileName, comparison.baselines, &comparison.numBaselines))
+    {
+      fprintf(stderr, "Error: Cannot read baseline file <%s>.\n", baselineFileName);
+      free(comparison.baselines);
+      if (output != stdout)
+        fclose(output);
+      return EXIT_FAILURE;
+    }
+  }
+  if (reportFileName)
+  {
+    comparison.report = strcmp(reportFileName, "-") ? fopen(reportFileName, "w") : stdout;
+    if (!comparison.report)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", reportFileName);
+      free(comparison.baselines);
+      if (output != stdout)
+        fclose(output);
+      return EXIT_FAILURE;
+    }
+  }
+
+  srand(seed);
+  CMR_ERROR error = benchmark(output, families, entries, rows, numRowValues, ratios, numRatioValues, probabilities,
+    numProbabilityValues, numWarmups, numRepetitions, timeLimit, numThreads,
+    (baselineFileName || reportFileName) ? &comparison : NULL);
+
+  if (output != stdout)
+    fclose(output);
+  if (comparison.report && comparison.report != stdout)
+    fclose(comparison.report);
+  free(comparison.baselines);
+
+  switch (error)
+  {
+  case CMR_OKAY:
+    if (comparison.numRegressions > 0)
+    {
+      fprintf(stderr, "Error: %zu measurements exceed the thresholds of the baseline.\n", comparison.numRegressions);
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  case CMR_ERROR_MEMORY:
+    fputs("Error: Memory limit exceeded.\n", stderr);
+    return EXIT_FAILURE;
+  case CMR_ERROR_TIMEOUT:
+    fputs("Error: Time limit exceeded.\n", stderr);
+    return EXIT_FAILURE;
+  default:
+    fputs("Error: Unknown error.\n", stderr);
+    return EXIT_FAILURE;
+  }
+}
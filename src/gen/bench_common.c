@@ -0,0 +1,106 @@
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 199309L
+#endif /* !_WIN32 */
+
+#include "bench_common.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+double CMRbenchClock(void)
+{
+#if defined(_WIN32)
+  return clock() * 1.0 / CLOCKS_PER_SEC;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1.0e-9;
+#endif /* _WIN32 */
+}
+
+bool CMRbenchParseList(const char* string, double minValue, size_t maxValues, double* values, size_t* pnumValues)
+{
+  *pnumValues = 0;
+  const char* p = string;
+  while (*p)
+  {
+    char* end = NULL;
+    double value = strtod(p, &end);
+    if (end == p || value < minValue || *pnumValues == maxValues)
+      return false;
+    values[(*pnumValues)++] = value;
+    p = end;
+    if (*p == ',')
+      ++p;
+    else if (*p)
+      return false;
+  }
+
+  return *pnumValues > 0;
+}
+
+bool CMRbenchParseNames(const char* string, const char** names, size_t numNames, bool* selected)
+{
+  for (size_t i = 0; i < numNames; ++i)
+    selected[i] = false;
+
+  const char* p = string;
+  while (*p)
+  {
+    size_t length = strcspn(p, ",");
+    size_t i;
+    for (i = 0; i < numNames; ++i)
+    {
+      if (strlen(names[i]) == length && !strncmp(p, names[i], length))
+        break;
+    }
+    if (i == numNames)
+      return false;
+    selected[i] = true;
+    p += length;
+    if (*p == ',')
+      ++p;
+  }
+
+  return true;
+}
+
+static
+int compareDoubles(const void* pa, const void* pb)
+{
+  double a = *((double*)(pa));
+  double b = *((double*)(pb));
+  return a < b ? -1 : (a > b);
+}
+
+/**
+ * \brief Returns the \p q-quantile of the sorted array \p times according to the nearest-rank method.
+ */
+
+static
+double percentile(
+  double* times,    /**< Sorted array of times. */
+  size_t numTimes,  /**< Length of \p times. */
+  double q          /**< Quantile in [0,1]. */
+)
+{
+  size_t rank = (size_t) ceil(q * numTimes);
+  return times[rank > 0 ? rank - 1 : 0];
+}
+
+void CMRbenchSummarizeTimes(double* times, size_t numTimes, CMR_BENCH_TIMES* stats)
+{
+  double sum = 0.0;
+  for (size_t r = 0; r < numTimes; ++r)
+    sum += times[r];
+  qsort(times, numTimes, sizeof(double), compareDoubles);
+
+  stats->min = times[0];
+  stats->percentile10 = percentile(times, numTimes, 0.1);
+  stats->median = (numTimes % 2) ? times[numTimes / 2] : 0.5 * (times[numTimes / 2 - 1] + times[numTimes / 2]);
+  stats->percentile90 = percentile(times, numTimes, 0.9);
+  stats->max = times[numTimes - 1];
+  stats->mean = sum / numTimes;
+}
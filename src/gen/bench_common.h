@@ -0,0 +1,80 @@
+#ifndef CMR_BENCH_COMMON_H
+#define CMR_BENCH_COMMON_H
+
+/**
+ * \file bench_common.h
+ *
+ * \brief Command-line parsing and timing statistics shared by cmr-bench and cmr-bench-containers.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Statistics of the times of repeated runs of a measurement.
+ *
+ * The percentiles are computed by the nearest-rank method.
+ */
+
+typedef struct
+{
+  double min;           /**< \brief Minimum time. */
+  double percentile10;  /**< \brief 10th percentile. */
+  double median;        /**< \brief Median time. */
+  double percentile90;  /**< \brief 90th percentile. */
+  double max;           /**< \brief Maximum time. */
+  double mean;          /**< \brief Mean time. */
+} CMR_BENCH_TIMES;
+
+/**
+ * \brief Returns the current time in seconds according to a monotonic wall clock.
+ */
+
+double CMRbenchClock(void);
+
+/**
+ * \brief Parses a comma-separated list of numbers that are at least \p minValue.
+ *
+ * Returns \c false if \p string is invalid, is empty or has more than \p maxValues values.
+ */
+
+bool CMRbenchParseList(
+  const char* string, /**< String to parse. */
+  double minValue,    /**< Minimum allowed value. */
+  size_t maxValues,   /**< Length of \p values. */
+  double* values,     /**< Array for storing the values. */
+  size_t* pnumValues  /**< Pointer for storing the number of values. */
+);
+
+/**
+ * \brief Parses a comma-separated list of names from \p names into \p selected.
+ *
+ * Returns \c false if \p string contains an unknown name.
+ */
+
+bool CMRbenchParseNames(
+  const char* string,   /**< String to parse. */
+  const char** names,   /**< Array with the known names. */
+  size_t numNames,      /**< Number of known names. */
+  bool* selected        /**< Array of length \p numNames for storing which names occur. */
+);
+
+/**
+ * \brief Sorts the \p numTimes > 0 entries of \p times and computes their statistics.
+ */
+
+void CMRbenchSummarizeTimes(
+  double* times,          /**< Array of times; sorted afterwards. */
+  size_t numTimes,        /**< Length of \p times. */
+  CMR_BENCH_TIMES* stats  /**< Pointer for storing the statistics. */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_BENCH_COMMON_H */
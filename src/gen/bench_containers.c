@@ -0,0 +1,895 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+
+#include <cmr/matrix.h>
+
+#include "../cmr/listmatrix.h"
+#include "../cmr/hashtable.h"
+#include "../cmr/heap.h"
+#include "../cmr/densematrix.h"
+
+#include "bench_common.h"
+#include "generators.h"
+
+#define MAX_VALUES 64           /**< Maximum number of values of a swept parameter. */
+#define MAX_PIVOTS 64           /**< Maximum number of pivots carried out in a dense matrix. */
+#define MAX_ARC_LENGTH 100      /**< Maximum length of an arc for Dijkstra's algorithm. */
+
+typedef enum
+{
+  CONTAINER_LISTMAT8 = 0,         /**< \ref ListMat8. */
+  CONTAINER_LISTMAT8COMPACT = 1,  /**< \ref ListMat8Compact. */
+  CONTAINER_LISTMAT64 = 2,        /**< \ref ListMat64. */
+  CONTAINER_LISTMATGMP = 3,       /**< \c ListMatGMP; only available if compiled with GMP. */
+  CONTAINER_LISTHASHTABLE = 4,    /**< \ref CMR_LISTHASHTABLE. */
+  CONTAINER_LINEARHASHTABLE = 5,  /**< \ref CMR_LINEARHASHTABLE_ARRAY. */
+  CONTAINER_INTHEAP = 6,          /**< Binary \ref CMR_INTHEAP. */
+  CONTAINER_INTHEAP4 = 7,         /**< 4-ary \ref CMR_INTHEAP. */
+  CONTAINER_DENSEMATRIX = 8,      /**< \ref DenseBinaryMatrix. */
+  NUM_CONTAINERS = 9
+} Container;
+
+static const char* containerNames[NUM_CONTAINERS] = { "listmat8", "listmat8compact", "listmat64",
+  "listmatgmp", "listhashtable",
+  "linearhashtable", "intheap", "intheap4", "densebinmatrix" };
+
+/**
+ * \brief Algorithm whose access pattern is imitated for each container.
+ */
+
+static const char* patternNames[NUM_CONTAINERS] = { "series-parallel", "series-parallel", "series-parallel",
+  "series-parallel", "series-parallel", "graph-parsing", "dijkstra", "dijkstra", "pivoting" };
+
+/**
+ * \brief Random data of one size from which the access patterns of all containers are derived.
+ */
+
+typedef struct
+{
+  size_t size;              /**< \brief Number of rows, hashed vectors, nodes or node names. */
+  CMR_CHRMAT* matrix;       /**< \brief Sparse ternary matrix with \c size rows and columns. */
+  CMR_INTMAT* intMatrix;    /**< \brief Copy of \c matrix with \c int entries. */
+  size_t* elements;         /**< \brief Random order of the rows and columns of \c matrix. */
+  size_t* hashes;           /**< \brief Array with \c size random hash values. */
+  size_t* updates;          /**< \brief Array with \c size random indices of \c hashes to be updated. */
+  size_t* arcsFirst;        /**< \brief Array with the first arc of each node, followed by the number of arcs. */
+  int* arcsTarget;          /**< \brief Array with the target of each arc. */
+  int* arcsLength;          /**< \brief Array with the length of each arc. */
+  char* names;              /**< \brief Node names of the end nodes of the arcs, separated by null characters. */
+  size_t numNames;          /**< \brief Number of strings in \c names. */
+} Instance;
+
+/**
+ * \brief Sink for values computed by the access patterns such that the compiler cannot discard them.
+ */
+
+static volatile size_t benchSink = 0;
+
+int printUsage(const char* program)
+{
+  fprintf(stderr, "Usage: %s [OPTION]...\n\n", program);
+  fputs("  times the internal containers of the library with access patterns taken from the algorithms that use them\n"
+    "  and writes one CSV line per container and size.\n\n", stderr);
+  fputs("Options:\n", stderr);
+  fputs("  -c CONTAINERS  Comma-separated containers among `listmat8', `listmat8compact', `listmat64', `listmatgmp',\n"
+    "                 `listhashtable', `linearhashtable', `intheap', `intheap4' and `densebinmatrix';\n"
+    "                 default: all.\n", stderr);
+  fputs("  -m SIZES       Comma-separated sizes; default: 1000,4000,16000.\n", stderr);
+  fputs("  -d DEGREE      Average number of nonzeros per row and of arcs per node; default: 8.\n", stderr);
+  fputs("  -w NUM         Number of untimed warmup runs per measurement; default: 1.\n", stderr);
+  fputs("  -n NUM         Number of timed repetitions per measurement; default: 5.\n", stderr);
+  fputs("  -o FILE        Write the CSV to FILE; default: stdout.\n\n", stderr);
+  fputs("Advanced options:\n", stderr);
+  fputs("  --seed SEED    Seed of the random number generator; default: 1.\n\n", stderr);
+  fputs("The access patterns are:\n", stderr);
+  fputs("  series-parallel  The list matrices are built from a random square matrix whose rows and columns are then\n"
+    "                   removed in random order, traversing each column (row) whose nonzero was removed as for\n"
+    "                   updating its hash value. The list hash table stores one hash value per row, looks up the\n"
+    "                   colliding rows for random rows and updates their hash values.\n", stderr);
+  fputs("  graph-parsing    The linear hash table maps the names of the end nodes of random arcs to node indices.\n",
+    stderr);
+  fputs("  dijkstra         The heap is used by Dijkstra's algorithm on a random digraph.\n", stderr);
+  fprintf(stderr, "  pivoting         The dense matrix is pivoted up to %d times as for nested minor sequences.\n\n",
+    MAX_PIVOTS);
+  fputs("Reported times are in seconds; the percentiles are computed by the nearest-rank method.\n", stderr);
+
+  return EXIT_FAILURE;
+}
+
+/**
+ * \brief Returns a random number in [0, \p beyond).
+ */
+
+static
+size_t randomIndex(
+  size_t beyond /**< Number of possible values. */
+)
+{
+  return (size_t) (rand() * 1.0 * beyond / (RAND_MAX + 1.0));
+}
+
+/**
+ * \brief Returns a random 64-bit number.
+ */
+
+static
+size_t randomHash(void)
+{
+  size_t hash = 0;
+  for (int i = 0; i < 4; ++i)
+    hash = (hash << 16) ^ (size_t) rand();
+  return hash;
+}
+
+/**
+ * \brief Creates the random data of the given \p size.
+ */
+
+static
+CMR_ERROR instanceCreate(
+  CMR* cmr,             /**< \ref CMR environment. */
+  size_t size,          /**< Size of the instance. */
+  double degree,        /**< Average number of nonzeros per row and of arcs per node. */
+  Instance* instance    /**< Instance to be initialized. */
+)
+{
+  instance->size = size;
+  instance->matrix = NULL;
+  instance->intMatrix = NULL;
+  instance->elements = NULL;
+  instance->hashes = NULL;
+  instance->updates = NULL;
+  instance->arcsFirst = NULL;
+  instance->arcsTarget = NULL;
+  instance->arcsLength = NULL;
+  instance->names = NULL;
+
+  double probability = degree < size ? degree / size : 1.0;
+  CMR_CALL( CMRgenerateRandomMatrix(cmr, size, size, probability, &instance->matrix) );
+  for (size_t entry = 0; entry < instance->matrix->numNonzeros; ++entry)
+  {
+    if (rand() % 2)
+      instance->matrix->entryValues[entry] = -1;
+  }
+  CMR_CALL( CMRchrmatToInt(cmr, instance->matrix, &instance->intMatrix) );
+
+  /* Rows are 0, ..., size-1 and columns are size, ..., 2*size-1. */
+  CMR_CALL( CMRallocBlockArray(cmr, &instance->elements, 2 * size) );
+  for (size_t e = 0; e < 2 * size; ++e)
+    instance->elements[e] = e;
+  for (size_t e = 2 * size - 1; e > 0; --e)
+  {
+    size_t other = randomIndex(e + 1);
+    size_t temp = instance->elements[e];
+    instance->elements[e] = instance->elements[other];
+    instance->elements[other] = temp;
+  }
+
+  /* Hash values of distinct vectors rarely coincide since vectors with equal hash values are reduced right away. */
+  CMR_CALL( CMRallocBlockArray(cmr, &instance->hashes, size) );
+  CMR_CALL( CMRallocBlockArray(cmr, &instance->updates, size) );
+  for (size_t i = 0; i < size; ++i)
+  {
+    instance->hashes[i] = randomHash();
+    instance->updates[i] = randomIndex(size);
+  }
+
+  size_t numArcs = (size_t) (degree * size + 0.5);
+  CMR_CALL( CMRallocBlockArray(cmr, &instance->arcsFirst, size + 1) );
+  CMR_CALL( CMRallocBlockArray(cmr, &instance->arcsTarget, numArcs) );
+  CMR_CALL( CMRallocBlockArray(cmr, &instance->arcsLength, numArcs) );
+  for (size_t v = 0; v <= size; ++v)
+    instance->arcsFirst[v] = 0;
+  size_t* sources = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &sources, numArcs) );
+  for (size_t a = 0; a < numArcs; ++a)
+  {
+    sources[a] = randomIndex(size);
+    instance->arcsFirst[sources[a] + 1]++;
+  }
+  for (size_t v = 0; v < size; ++v)
+    instance->arcsFirst[v + 1] += instance->arcsFirst[v];
+  for (size_t a = 0; a < numArcs; ++a)
+  {
+    size_t position = instance->arcsFirst[sources[a]]++;
+    instance->arcsTarget[position] = (int) randomIndex(size);
+    instance->arcsLength[position] = 1 + (int) randomIndex(MAX_ARC_LENGTH);
+  }
+  for (size_t v = size; v > 0; --v)
+    instance->arcsFirst[v] = instance->arcsFirst[v - 1];
+  instance->arcsFirst[0] = 0;
+
+  /* The names of the end nodes of all arcs. */
+  instance->numNames = 2 * numArcs;
+  size_t maxNameLength = 3 * sizeof(size_t) + 2;
+  CMR_CALL( CMRallocBlockArray(cmr, &instance->names, instance->numNames * maxNameLength) );
+  char* name = instance->names;
+  for (size_t a = 0; a < numArcs; ++a)
+  {
+    name += sprintf(name, "v%zu", sources[a]) + 1;
+    name += sprintf(name, "v%d", instance->arcsTarget[a]) + 1;
+  }
+
+  CMR_CALL( CMRfreeStackArray(cmr, &sources) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Frees the random data of \p instance.
+ */
+
+static
+CMR_ERROR instanceFree(
+  CMR* cmr,           /**< \ref CMR environment. */
+  Instance* instance  /**< Instance. */
+)
+{
+  CMR_CALL( CMRfreeBlockArray(cmr, &instance->names) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &instance->arcsLength) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &instance->arcsTarget) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &instance->arcsFirst) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &instance->updates) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &instance->hashes) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &instance->elements) );
+  CMR_CALL( CMRintmatFree(cmr, &instance->intMatrix) );
+  CMR_CALL( CMRchrmatFree(cmr, &instance->matrix) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Removes the rows and columns of \p listmatrix in the order given by \p instance, where \p ELEMENT and
+ *        \p NONZERO are the element and nonzero types and \p DELETE is the deletion function.
+ *
+ * Whenever a nonzero is removed, the remaining nonzeros of its column (row) are traversed, which is what the
+ * series-parallel reduction does for updating the hash value of that column (row).
+ */
+
+#define LISTMAT_REDUCE(ELEMENT, NONZERO, DELETE) \
+  do \
+  { \
+    size_t numRows = instance->size; \
+    for (size_t i = 0; i < 2 * numRows; ++i) \
+    { \
+      size_t element = instance->elements[i]; \
+      if (element < numRows) \
+      { \
+        ELEMENT* rowElement = &listmatrix->rowElements[element]; \
+        while (rowElement->head.right != &rowElement->head) \
+        { \
+          NONZERO* nz = rowElement->head.right; \
+          ELEMENT* columnElement = &listmatrix->columnElements[nz->column]; \
+          CMR_CALL( DELETE(cmr, listmatrix, nz) ); \
+          for (nz = columnElement->head.below; nz != &columnElement->head; nz = nz->below) \
+            checksum += nz->row; \
+          ++numOperations; \
+        } \
+      } \
+      else \
+      { \
+        ELEMENT* columnElement = &listmatrix->columnElements[element - numRows]; \
+        while (columnElement->head.below != &columnElement->head) \
+        { \
+          NONZERO* nz = columnElement->head.below; \
+          ELEMENT* rowElement = &listmatrix->rowElements[nz->row]; \
+          CMR_CALL( DELETE(cmr, listmatrix, nz) ); \
+          for (nz = rowElement->head.right; nz != &rowElement->head; nz = nz->right) \
+            checksum += nz->column; \
+          ++numOperations; \
+        } \
+      } \
+    } \
+  } \
+  while (false)
+
+/**
+ * \brief Builds a \ref ListMat8 and carries out the series-parallel access pattern.
+ */
+
+static
+CMR_ERROR runListMat8(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Instance* instance,       /**< Instance. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations. */
+)
+{
+  size_t numOperations = 0;
+  size_t checksum = 0;
+  CMR_CHRMAT* matrix = instance->matrix;
+
+  ListMat8* listmatrix = NULL;
+  CMR_CALL( CMRlistmat8Alloc(cmr, matrix->numRows, matrix->numColumns, matrix->numNonzeros, &listmatrix) );
+  CMR_CALL( CMRlistmat8InitializeFromChrMatrix(cmr, listmatrix, matrix) );
+  LISTMAT_REDUCE(ListMat8Element, ListMat8Nonzero, CMRlistmat8Delete);
+  CMR_CALL( CMRlistmat8Free(cmr, &listmatrix) );
+
+  benchSink += checksum;
+  *pnumOperations = numOperations;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Builds a \ref ListMat8Compact and carries out the series-parallel access pattern.
+ */
+
+static
+CMR_ERROR runListMat8Compact(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Instance* instance,       /**< Instance. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations. */
+)
+{
+  size_t numOperations = 0;
+  size_t checksum = 0;
+  CMR_CHRMAT* matrix = instance->matrix;
+
+  ListMat8Compact* listmatrix = NULL;
+  CMR_CALL( CMRlistmat8CompactAlloc(cmr, matrix->numRows, matrix->numColumns, matrix->numNonzeros, &listmatrix) );
+  CMR_CALL( CMRlistmat8CompactInitializeFromChrMatrix(cmr, listmatrix, matrix) );
+  size_t numRows = instance->size;
+  for (size_t i = 0; i < 2 * numRows; ++i)
+  {
+    size_t element = instance->elements[i];
+    if (element < numRows)
+    {
+      ListMat8Index rowHead = CMRlistmat8CompactRowHead(listmatrix, element);
+      while (listmatrix->right[rowHead] != rowHead)
+      {
+        ListMat8Index nz = listmatrix->right[rowHead];
+        ListMat8Index columnHead = CMRlistmat8CompactColumnHead(listmatrix, listmatrix->column[nz]);
+        CMR_CALL( CMRlistmat8CompactDelete(cmr, listmatrix, nz) );
+        for (nz = listmatrix->below[columnHead]; nz != columnHead; nz = listmatrix->below[nz])
+          checksum += listmatrix->row[nz];
+        ++numOperations;
+      }
+    }
+    else
+    {
+      ListMat8Index columnHead = CMRlistmat8CompactColumnHead(listmatrix, element - numRows);
+      while (listmatrix->below[columnHead] != columnHead)
+      {
+        ListMat8Index nz = listmatrix->below[columnHead];
+        ListMat8Index rowHead = CMRlistmat8CompactRowHead(listmatrix, listmatrix->row[nz]);
+        CMR_CALL( CMRlistmat8CompactDelete(cmr, listmatrix, nz) );
+        for (nz = listmatrix->right[rowHead]; nz != rowHead; nz = listmatrix->right[nz])
+          checksum += listmatrix->column[nz];
+        ++numOperations;
+      }
+    }
+  }
+  CMR_CALL( CMRlistmat8CompactFree(cmr, &listmatrix) );
+
+  benchSink += checksum;
+  *pnumOperations = numOperations;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Builds a \ref ListMat64 and carries out the series-parallel access pattern.
+ */
+
+static
+CMR_ERROR runListMat64(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Instance* instance,       /**< Instance. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations. */
+)
+{
+  size_t numOperations = 0;
+  size_t checksum = 0;
+  CMR_INTMAT* matrix = instance->intMatrix;
+
+  ListMat64* listmatrix = NULL;
+  CMR_CALL( CMRlistmat64Alloc(cmr, matrix->numRows, matrix->numColumns, matrix->numNonzeros, &listmatrix) );
+  CMR_CALL( CMRlistmat64InitializeFromIntMatrix(cmr, listmatrix, matrix) );
+  LISTMAT_REDUCE(ListMat64Element, ListMat64Nonzero, CMRlistmat64Delete);
+  CMR_CALL( CMRlistmat64Free(cmr, &listmatrix) );
+
+  benchSink += checksum;
+  *pnumOperations = numOperations;
+
+  return CMR_OKAY;
+}
+
+#if defined(CMR_WITH_GMP)
+
+/**
+ * \brief Builds a \ref ListMatGMP and carries out the series-parallel access pattern.
+ */
+
+static
+CMR_ERROR runListMatGMP(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Instance* instance,       /**< Instance. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations. */
+)
+{
+  size_t numOperations = 0;
+  size_t checksum = 0;
+  CMR_INTMAT* matrix = instance->intMatrix;
+
+  ListMatGMP* listmatrix = NULL;
+  CMR_CALL( CMRlistmatGMPAlloc(cmr, matrix->numRows, matrix->numColumns, matrix->numNonzeros, &listmatrix) );
+  CMR_CALL( CMRlistmatGMPInitializeFromIntMatrix(cmr, listmatrix, matrix) );
+  LISTMAT_REDUCE(ListMatGMPElement, ListMatGMPNonzero, CMRlistmatGMPDelete);
+  CMR_CALL( CMRlistmatGMPFree(cmr, &listmatrix) );
+
+  benchSink += checksum;
+  *pnumOperations = numOperations;
+
+  return CMR_OKAY;
+}
+
+#endif /* CMR_WITH_GMP */
+
+/**
+ * \brief Carries out the series-parallel access pattern for a \ref CMR_LISTHASHTABLE.
+ *
+ * All vectors are inserted with their hash values. For each update, the vectors with the same hash value as the
+ * updated one are enumerated as for finding copies, and the vector is reinserted with a new hash value as after the
+ * removal of a nonzero.
+ */
+
+static
+CMR_ERROR runListHashtable(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Instance* instance,       /**< Instance. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations. */
+)
+{
+  size_t size = instance->size;
+  size_t numOperations = 0;
+  size_t checksum = 0;
+
+  size_t* hashes = NULL;
+  CMR_CALL( CMRduplicateBlockArray(cmr, &hashes, size, instance->hashes) );
+  CMR_LISTHASHTABLE_ENTRY* entries = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &entries, size) );
+
+  CMR_LISTHASHTABLE* hashtable = NULL;
+  CMR_CALL( CMRlisthashtableCreate(cmr, &hashtable, nextPower2(size), size) );
+  for (size_t i = 0; i < size; ++i)
+  {
+    CMR_CALL( CMRlisthashtableInsert(cmr, hashtable, hashes[i], i, &entries[i]) );
+    ++numOperations;
+  }
+
+  for (size_t u = 0; u < size; ++u)
+  {
+    size_t i = instance->updates[u];
+    for (CMR_LISTHASHTABLE_ENTRY entry = CMRlisthashtableFindFirst(hashtable, hashes[i]); entry != SIZE_MAX;
+      entry = CMRlisthashtableFindNext(hashtable, hashes[i], entry))
+    {
+      checksum += CMRlisthashtableValue(hashtable, entry);
+    }
+    CMR_CALL( CMRlisthashtableRemove(cmr, hashtable, entries[i]) );
+    hashes[i] = hashes[i] * 31 + u;
+    CMR_CALL( CMRlisthashtableInsert(cmr, hashtable, hashes[i], i, &entries[i]) );
+    numOperations += 3;
+  }
+
+  CMR_CALL( CMRlisthashtableFree(cmr, &hashtable) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &entries) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &hashes) );
+
+  benchSink += checksum;
+  *pnumOperations = numOperations;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Carries out the graph-parsing access pattern for a \ref CMR_LINEARHASHTABLE_ARRAY.
+ *
+ * Each node name is looked up and inserted if it is new, as done when reading an edge list.
+ */
+
+static
+CMR_ERROR runLinearHashtable(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Instance* instance,       /**< Instance. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations. */
+)
+{
+  size_t numNodes = 0;
+  size_t checksum = 0;
+
+  CMR_LINEARHASHTABLE_ARRAY* hashtable = NULL;
+  CMR_CALL( CMRlinearhashtableArrayCreate(cmr, &hashtable, 8, 1024) );
+  const char* name = instance->names;
+  for (size_t n = 0; n < instance->numNames; ++n)
+  {
+    size_t length = strlen(name);
+    CMR_LINEARHASHTABLE_BUCKET bucket;
+    CMR_LINEARHASHTABLE_HASH hash;
+    if (CMRlinearhashtableArrayFind(hashtable, name, length, &bucket, &hash))
+      checksum += (size_t) CMRlinearhashtableArrayValue(hashtable, bucket);
+    else
+    {
+      CMR_CALL( CMRlinearhashtableArrayInsertBucketHash(cmr, hashtable, name, length, bucket, hash,
+        (void*) numNodes) );
+      ++numNodes;
+    }
+    name += length + 1;
+  }
+  CMR_CALL( CMRlinearhashtableArrayFree(cmr, &hashtable) );
+
+  benchSink += checksum;
+  *pnumOperations = instance->numNames;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Carries out Dijkstra's algorithm from every unreached node with a \ref CMR_INTHEAP.
+ */
+
+static
+CMR_ERROR runIntHeap(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Instance* instance,       /**< Instance. */
+  int arity,                /**< Number of children of each heap node. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations. */
+)
+{
+  int numNodes = (int) instance->size;
+  size_t numOperations = 0;
+  size_t checksum = 0;
+
+  bool* completed = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &completed, numNodes) );
+  for (int v = 0; v < numNodes; ++v)
+    completed[v] = false;
+  CMR_INTHEAP heap;
+  CMR_CALL( CMRintheapInitStackArity(cmr, &heap, numNodes, arity) );
+
+  for (int s = 0; s < numNodes; ++s)
+  {
+    if (completed[s])
+      continue;
+
+    CMR_CALL( CMRintheapInsert(&heap, s, 0) );
+    ++numOperations;
+    while (!CMRintheapEmpty(&heap))
+    {
+      int distance = CMRintheapMinimumValue(&heap);
+      int v = CMRintheapExtractMinimum(&heap);
+      ++numOperations;
+      completed[v] = true;
+      checksum += distance;
+      for (size_t a = instance->arcsFirst[v]; a < instance->arcsFirst[v + 1]; ++a)
+      {
+        int w = instance->arcsTarget[a];
+        if (completed[w])
+          continue;
+
+        int newDistance = distance + instance->arcsLength[a];
+        if (newDistance < CMRintheapGetValueInfinity(&heap, w))
+        {
+          CMR_CALL( CMRintheapDecreaseInsert(&heap, w, newDistance) );
+          ++numOperations;
+        }
+      }
+    }
+  }
+
+  CMR_CALL( CMRintheapClearStack(cmr, &heap) );
+  CMR_CALL( CMRfreeStackArray(cmr, &completed) );
+
+  benchSink += checksum;
+  *pnumOperations = numOperations;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Carries out the pivoting access pattern for a \ref DenseBinaryMatrix.
+ *
+ * The support of the instance's matrix is copied into the dense matrix. Then pivots are carried out on random nonzeros
+ * in distinct rows, where each pivot adds the pivot row to all affected rows, as done when extending a nested minor
+ * sequence.
+ */
+
+static
+CMR_ERROR runDenseMatrix(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Instance* instance,       /**< Instance. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations. */
+)
+{
+  CMR_CHRMAT* matrix = instance->matrix;
+  size_t numRows = matrix->numRows;
+  size_t numColumns = matrix->numColumns;
+  size_t numOperations = 0;
+
+  DenseBinaryMatrix* dense = NULL;
+  CMR_CALL( CMRdensebinmatrixCreate(cmr, numRows, numColumns, &dense) );
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    for (size_t entry = matrix->rowSlice[row]; entry < matrix->rowSlice[row + 1]; ++entry)
+      CMRdensebinmatrixSet1(dense, row, matrix->entryColumns[entry]);
+  }
+  numOperations += matrix->numNonzeros;
+
+  size_t* rows = NULL;
+  CMR_CALL( CMRallocStackArray(cmr, &rows, numRows) );
+  size_t numPivots = 0;
+  for (size_t i = 0; i < 2 * numRows && numPivots < MAX_PIVOTS; ++i)
+  {
+    if (instance->elements[i] >= numRows)
+      continue;
+
+    size_t pivotRow = instance->elements[i];
+    size_t pivotColumn = CMRdensebinmatrixRowFindNext(dense, pivotRow, 0);
+    if (pivotColumn == SIZE_MAX)
+      continue;
+
+    size_t numPivotRows = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      if (row != pivotRow && CMRdensebinmatrixGet(dense, row, pivotColumn))
+        rows[numPivotRows++] = row;
+    }
+    for (size_t r = 0; r < numPivotRows; ++r)
+    {
+      CMRdensebinmatrixRowXor(dense, rows[r], pivotRow);
+      CMRdensebinmatrixSet1(dense, rows[r], pivotColumn);
+    }
+    numOperations += numRows + numPivotRows * dense->stride;
+    ++numPivots;
+  }
+  CMR_CALL( CMRfreeStackArray(cmr, &rows) );
+
+  CMR_CALL( CMRdensebinmatrixFree(cmr, &dense) );
+
+  *pnumOperations = numOperations;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Runs the access pattern of \p container once for \p instance.
+ */
+
+static
+CMR_ERROR runContainer(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  Container container,      /**< Container to run. */
+  Instance* instance,       /**< Instance. */
+  size_t* pnumOperations    /**< Pointer for storing the number of operations on the container. */
+)
+{
+  switch (container)
+  {
+  case CONTAINER_LISTMAT8:
+    return runListMat8(cmr, instance, pnumOperations);
+  case CONTAINER_LISTMAT8COMPACT:
+    return runListMat8Compact(cmr, instance, pnumOperations);
+  case CONTAINER_LISTMAT64:
+    return runListMat64(cmr, instance, pnumOperations);
+#if defined(CMR_WITH_GMP)
+  case CONTAINER_LISTMATGMP:
+    return runListMatGMP(cmr, instance, pnumOperations);
+#endif /* CMR_WITH_GMP */
+  case CONTAINER_LISTHASHTABLE:
+    return runListHashtable(cmr, instance, pnumOperations);
+  case CONTAINER_LINEARHASHTABLE:
+    return runLinearHashtable(cmr, instance, pnumOperations);
+  case CONTAINER_INTHEAP:
+    return runIntHeap(cmr, instance, 2, pnumOperations);
+  case CONTAINER_INTHEAP4:
+    return runIntHeap(cmr, instance, 4, pnumOperations);
+  case CONTAINER_DENSEMATRIX:
+    return runDenseMatrix(cmr, instance, pnumOperations);
+  default:
+    return CMR_ERROR_INVALID;
+  }
+}
+
+/**
+ * \brief Times \p container for \p instance and writes the CSV line.
+ */
+
+static
+CMR_ERROR benchmarkContainer(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  FILE* output,             /**< Stream for the CSV line. */
+  Container container,      /**< Container to benchmark. */
+  Instance* instance,       /**< Instance. */
+  size_t numWarmups,        /**< Number of untimed runs. */
+  size_t numRepetitions     /**< Number of timed runs. */
+)
+{
+  double* times = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &times, numRepetitions) );
+
+  size_t numOperations = 0;
+  for (size_t run = 0; run < numWarmups + numRepetitions; ++run)
+  {
+    double start = CMRbenchClock();
+    CMR_CALL( runContainer(cmr, container, instance, &numOperations) );
+    if (run >= numWarmups)
+      times[run - numWarmups] = CMRbenchClock() - start;
+  }
+
+  CMR_BENCH_TIMES stats;
+  CMRbenchSummarizeTimes(times, numRepetitions, &stats);
+
+  fprintf(output, "%s,%s,%zu,%zu,%zu,%zu,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g\n", containerNames[container],
+    patternNames[container], instance->size, numOperations, numWarmups, numRepetitions, stats.min, stats.percentile10,
+    stats.median, stats.percentile90, stats.max, stats.mean, numOperations ? stats.median * 1.0e9 / numOperations : 0.0);
+  fflush(output);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &times) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Runs the whole benchmark.
+ */
+
+static
+CMR_ERROR benchmark(
+  FILE* output,           /**< Stream for the CSV. */
+  bool* containers,       /**< Array indicating the containers to benchmark. */
+  double* sizes,          /**< Array with the sizes. */
+  size_t numSizeValues,   /**< Length of \p sizes. */
+  double degree,          /**< Average number of nonzeros per row and of arcs per node. */
+  size_t numWarmups,      /**< Number of untimed runs per measurement. */
+  size_t numRepetitions   /**< Number of timed runs per measurement. */
+)
+{
+  CMR* cmr = NULL;
+  CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  fputs("container,pattern,size,operations,warmups,repetitions,min,p10,median,p90,max,mean,median-ns-per-operation\n",
+    output);
+
+  for (size_t s = 0; s < numSizeValues; ++s)
+  {
+    Instance instance;
+    CMR_CALL( instanceCreate(cmr, (size_t) sizes[s], degree, &instance) );
+    for (int container = 0; container < NUM_CONTAINERS; ++container)
+    {
+      if (containers[container])
+      {
+        CMR_CALL( benchmarkContainer(cmr, output, (Container) container, &instance, numWarmups,
+          numRepetitions) );
+      }
+    }
+    CMR_CALL( instanceFree(cmr, &instance) );
+  }
+
+  CMR_CALL( CMRfreeEnvironment(&cmr) );
+
+  return CMR_OKAY;
+}
+
+int main(int argc, char** argv)
+{
+  bool containers[NUM_CONTAINERS] = { true, true, true, true, true, true, true, true, true };
+  double sizes[MAX_VALUES] = { 1000, 4000, 16000 };
+  size_t numSizeValues = 3;
+  double degree = 8.0;
+  size_t numWarmups = 1;
+  size_t numRepetitions = 5;
+  char* outputFileName = NULL;
+  unsigned int seed = 1;
+  for (int a = 1; a < argc; ++a)
+  {
+    if (!strcmp(argv[a], "-h"))
+    {
+      printUsage(argv[0]);
+      return EXIT_SUCCESS;
+    }
+    else if (!strcmp(argv[a], "-c") && a+1 < argc)
+    {
+      if (!CMRbenchParseNames(argv[++a], containerNames, NUM_CONTAINERS, containers))
+      {
+        fprintf(stderr, "Error: invalid containers <%s>.\n\n", argv[a]);
+        return printUsage(argv[0]);
+      }
+    }
+    else if (!strcmp(argv[a], "-m") && a+1 < argc)
+    {
+      if (!CMRbenchParseList(argv[++a], 1.0, MAX_VALUES, sizes, &numSizeValues))
+      {
+        fprintf(stderr, "Error: invalid sizes <%s>.\n\n", argv[a]);
+        return printUsage(argv[0]);
+      }
+      for (size_t s = 0; s < numSizeValues; ++s)
+      {
+        if (sizes[s] > INT_MAX)
+        {
+          fprintf(stderr, "Error: size %g is too large.\n\n", sizes[s]);
+          return printUsage(argv[0]);
+        }
+      }
+    }
+    else if (!strcmp(argv[a], "-d") && a+1 < argc)
+    {
+      char* p = NULL;
+      degree = strtod(argv[a+1], &p);
+      if (*p != '\0' || degree <= 0.0)
+      {
+        fprintf(stderr, "Error: invalid degree <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if ((!strcmp(argv[a], "-w") || !strcmp(argv[a], "-n")) && a+1 < argc)
+    {
+      char* p = NULL;
+      size_t value = strtoull(argv[a+1], &p, 10);
+      if (*p != '\0' || (argv[a][1] == 'n' && value == 0))
+      {
+        fprintf(stderr, "Error: invalid number of runs <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      if (argv[a][1] == 'w')
+        numWarmups = value;
+      else
+        numRepetitions = value;
+      ++a;
+    }
+    else if (!strcmp(argv[a], "-o") && a+1 < argc)
+      outputFileName = argv[++a];
+    else if (!strcmp(argv[a], "--seed") && a+1 < argc)
+    {
+      char* p = NULL;
+      seed = (unsigned int) strtoul(argv[a+1], &p, 10);
+      if (*p != '\0')
+      {
+        fprintf(stderr, "Error: invalid seed <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else
+    {
+      fprintf(stderr, "Error: Unknown option <%s>.\n\n", argv[a]);
+      return printUsage(argv[0]);
+    }
+  }
+
+#if !defined(CMR_WITH_GMP)
+  containers[CONTAINER_LISTMATGMP] = false;
+#endif /* !CMR_WITH_GMP */
+
+  FILE* output = stdout;
+  if (outputFileName && strcmp(outputFileName, "-"))
+  {
+    output = fopen(outputFileName, "w");
+    if (!output)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", outputFileName);
+      return EXIT_FAILURE;
+    }
+  }
+
+  srand(seed);
+  CMR_ERROR error = benchmark(output, containers, sizes, numSizeValues, degree, numWarmups, numRepetitions);
+
+  if (output != stdout)
+    fclose(output);
+
+  switch (error)
+  {
+  case CMR_OKAY:
+    return EXIT_SUCCESS;
+  case CMR_ERROR_MEMORY:
+    fputs("Error: Memory limit exceeded.\n", stderr);
+    return EXIT_FAILURE;
+  default:
+    fputs("Error: Unknown error.\n", stderr);
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,1026 @@
+#include "generators.h"
+
+#include <cmr/camion.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(CMR_WITH_THREADS)
+#include <pthread.h>
+#endif /* CMR_WITH_THREADS */
+
+#define STREAM_CHUNK_COLUMNS 4096 /**< Number of columns that a worker generates at once. */
+#define STREAM_CHUNK_NODES 65536  /**< Number of tree nodes whose parents a worker draws at once. */
+
+static inline
+size_t randRange(size_t first, size_t beyond)
+{
+  size_t N = beyond - first;
+  size_t representatives = (RAND_MAX + 1u) / N;
+  size_t firstInvalid = N * representatives;
+  size_t x;
+  do
+  {
+    x = rand();
+  }
+  while (x >= firstInvalid);
+  return first + x / representatives;
+}
+
+static
+int compareSize(const void* pa, const void* pb)
+{
+  size_t a = *((size_t*)(pa));
+  size_t b = *((size_t*)(pb));
+  return a < b ? -1 : (a > b);
+}
+
+/**
+ * \brief Appends the sorted row indices in \p rows as a new row of \p transposed, which has \p *pmemNonzeros
+ *        allocated nonzeros.
+ */
+
+static
+CMR_ERROR appendTransposedRow(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_CHRMAT* transposed,   /**< Transposed matrix whose next row is to be filled. */
+  size_t* pmemNonzeros,     /**< Pointer to the number of allocated nonzeros of \p transposed. */
+  size_t e,                 /**< Index of the row of \p transposed. */
+  size_t* rows,             /**< Array with the row indices. */
+  size_t numRows            /**< Length of \p rows. */
+)
+{
+  transposed->rowSlice[e] = transposed->numNonzeros;
+
+  qsort(rows, numRows, sizeof(size_t), &compareSize);
+
+  for (size_t i = 0; i < numRows; ++i)
+  {
+    if (transposed->numNonzeros == *pmemNonzeros)
+    {
+      *pmemNonzeros *= 2;
+      CMR_CALL( CMRreallocBlockArray(cmr, &transposed->entryColumns, *pmemNonzeros) );
+      CMR_CALL( CMRreallocBlockArray(cmr, &transposed->entryValues, *pmemNonzeros) );
+    }
+    transposed->entryColumns[transposed->numNonzeros] = rows[i];
+    transposed->entryValues[transposed->numNonzeros] = 1;
+    transposed->numNonzeros++;
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Allocates the transpose of a matrix to be generated from a tree with \p numNodes nodes and \p numEdges
+ *        non-tree edges.
+ */
+
+static
+CMR_ERROR createTransposed(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  size_t numNodes,          /**< Number of nodes of the tree. */
+  size_t numEdges,          /**< Number of non-tree edges. */
+  CMR_CHRMAT** ptransposed, /**< Pointer for storing the transpose. */
+  size_t* pmemNonzeros      /**< Pointer for storing the number of allocated nonzeros. */
+)
+{
+  size_t memNonzeros = 1;
+  for (size_t x = numNodes - 1; x; x >>= 1)
+    ++memNonzeros;
+  memNonzeros *= numEdges;
+  CMR_CALL( CMRchrmatCreate(cmr, ptransposed, numEdges, numNodes - 1, memNonzeros) );
+  (*ptransposed)->numNonzeros = 0;
+  *pmemNonzeros = memNonzeros;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgenerateGraphicMatrix(CMR* cmr, size_t numRows, size_t numColumns, CMR_CHRMAT** pmatrix)
+{
+  assert(cmr);
+  assert(pmatrix);
+
+  size_t numNodes = numRows + 1;
+  size_t numEdges = numColumns;
+
+  CMR_CHRMAT* transposed = NULL;
+  size_t transposedMemNonzeros;
+  CMR_CALL( createTransposed(cmr, numNodes, numEdges, &transposed, &transposedMemNonzeros) );
+
+  /* Create random arborescence. */
+  int* nextTreeNode = NULL;
+  int* treeDistance = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &nextTreeNode, numNodes) );
+  CMR_CALL( CMRallocBlockArray(cmr, &treeDistance, numNodes) );
+  nextTreeNode[0] = 0;
+  treeDistance[0] = 0;
+  for (int v = 1; v < (int) numNodes; ++v)
+  {
+    int w = (int)(rand() * 1.0 * v / RAND_MAX);
+    nextTreeNode[v] = w;
+    treeDistance[v] = treeDistance[w] + 1;
+  }
+
+  size_t* columnNonzeros = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &columnNonzeros, numNodes - 1) );
+  for (int e = 0; e < (int)numEdges; ++e)
+  {
+    size_t numColumNonzeros = 0;
+    int first = (int)(rand() * 1.0 * numNodes / RAND_MAX);
+    int second = (int)(rand() * 1.0 * numNodes / RAND_MAX);
+    while (treeDistance[first] > treeDistance[second])
+    {
+      columnNonzeros[numColumNonzeros++] = first-1;
+      first = nextTreeNode[first];
+    }
+    while (treeDistance[second] > treeDistance[first])
+    {
+      columnNonzeros[numColumNonzeros++] = second-1;
+      second = nextTreeNode[second];
+    }
+    while (first != second && first)
+    {
+      columnNonzeros[numColumNonzeros++] = first-1;
+      first = nextTreeNode[first];
+      columnNonzeros[numColumNonzeros++] = second-1;
+      second = nextTreeNode[second];
+    }
+    CMR_CALL( appendTransposedRow(cmr, transposed, &transposedMemNonzeros, e, columnNonzeros, numColumNonzeros) );
+  }
+  transposed->rowSlice[transposed->numRows] = transposed->numNonzeros;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &columnNonzeros) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &treeDistance) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &nextTreeNode) );
+
+  CMR_CALL( CMRchrmatTranspose(cmr, transposed, pmatrix) );
+  CMR_CALL( CMRchrmatFree(cmr, &transposed) );
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgenerateNetworkMatrix(CMR* cmr, size_t numRows, size_t numColumns, bool binary, CMR_CHRMAT** pmatrix)
+{
+  assert(cmr);
+  assert(pmatrix);
+
+  size_t numNodes = numRows + 1;
+  size_t numEdges = numColumns;
+
+  CMR_CHRMAT* transposed = NULL;
+  size_t transposedMemNonzeros;
+  CMR_CALL( createTransposed(cmr, numNodes, numEdges, &transposed, &transposedMemNonzeros) );
+
+  /* Create random arborescence. */
+  int* nextTreeNode = NULL;
+  int* treeDistance = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &nextTreeNode, numNodes) );
+  CMR_CALL( CMRallocBlockArray(cmr, &treeDistance, numNodes) );
+  nextTreeNode[0] = 0;
+  treeDistance[0] = 0;
+  for (int v = 1; v < (int)numNodes; ++v)
+  {
+    int w = v;
+    while (w == v)
+      w = (int)(rand() * 1.0 * v / RAND_MAX);
+    nextTreeNode[v] = w;
+    treeDistance[v] = treeDistance[w] + 1;
+  }
+
+  size_t* columnNonzeros = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &columnNonzeros, numNodes - 1) );
+  for (int e = 0; e < (int) numEdges; ++e)
+  {
+    size_t numColumNonzeros = 0;
+    int first = (int) numNodes;
+    int second;
+    while (first == (int) numNodes)
+      first = (int)(rand() * 1.0 * numNodes / RAND_MAX);
+
+    if (binary)
+    {
+      int N = treeDistance[first];
+      if (N == 0)
+        second = first;
+      else
+      {
+        /* If we're not the root, then we make at least one step to not produce zero columns. */
+        int steps = N;
+        while (steps == N)
+          steps = (int)(rand() * 1.0 * N / RAND_MAX);
+        ++steps;
+        for (second = first; steps; --steps)
+          second = nextTreeNode[second];
+      }
+    }
+    else
+    {
+      /* second is chosen uniformly at random from all nodes. */
+      second = numNodes;
+      while (second == (int) numNodes)
+        second = (int)(rand() * 1.0 * numNodes / RAND_MAX);
+      while (treeDistance[second] > treeDistance[first])
+      {
+        columnNonzeros[numColumNonzeros++] = second-1;
+        second = nextTreeNode[second];
+      }
+    }
+
+    while (treeDistance[first] > treeDistance[second])
+    {
+      columnNonzeros[numColumNonzeros++] = first-1;
+      first = nextTreeNode[first];
+    }
+    while (first != second && first)
+    {
+      columnNonzeros[numColumNonzeros++] = first-1;
+      first = nextTreeNode[first];
+      columnNonzeros[numColumNonzeros++] = second-1;
+      second = nextTreeNode[second];
+    }
+    CMR_CALL( appendTransposedRow(cmr, transposed, &transposedMemNonzeros, e, columnNonzeros, numColumNonzeros) );
+  }
+  transposed->rowSlice[transposed->numRows] = transposed->numNonzeros;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &columnNonzeros) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &treeDistance) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &nextTreeNode) );
+
+  CMR_CALL( CMRchrmatTranspose(cmr, transposed, pmatrix) );
+  CMR_CALL( CMRchrmatFree(cmr, &transposed) );
+
+  if (!binary)
+  {
+    /* Make it a network matrix via Camion's signing algorithm. */
+    CMR_CALL( CMRcamionComputeSigns(cmr, *pmatrix, NULL, NULL, NULL, DBL_MAX) );
+  }
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRgenerateRandomMatrix(CMR* cmr, size_t numRows, size_t numColumns, double probability,
+  CMR_CHRMAT** pmatrix)
+{
+  assert(cmr);
+  assert(pmatrix);
+
+  size_t estimatedNumNonzeros = 1.1 * numRows * numColumns * probability + 1024;
+
+  CMR_CALL( CMRchrmatCreate(cmr, pmatrix, numRows, numColumns, estimatedNumNonzeros) );
+  CMR_CHRMAT* matrix = *pmatrix;
+  size_t entry = 0;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    matrix->rowSlice[row] = entry;
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      bool isNonzero = (rand() * 1.0 / RAND_MAX) < probability;
+      if (isNonzero)
+      {
+        if (entry == matrix->numNonzeros)
+        {
+          CMR_CALL( CMRreallocBlockArray(cmr, &matrix->entryColumns, 2*matrix->numNonzeros) );
+          CMR_CALL( CMRreallocBlockArray(cmr, &matrix->entryValues, 2*matrix->numNonzeros) );
+          matrix->numNonzeros *= 2;
+        }
+        matrix->entryColumns[entry] = column;
+        matrix->entryValues[entry] = 1;
+        ++entry;
+      }
+    }
+  }
+  matrix->rowSlice[numRows] = entry;
+  matrix->numNonzeros = entry;
+
+  return CMR_OKAY;
+}
+
+typedef struct _ListNonzero
+{
+  struct _ListNonzero* left;
+  struct _ListNonzero* right;
+  struct _ListNonzero* above;
+  struct _ListNonzero* below;
+  size_t row;
+  size_t column;
+  char value;
+} ListNonzero;
+
+static
+CMR_ERROR addNonzero(
+  CMR* cmr,
+  ListNonzero* rowHeads,
+  ListNonzero* columnHeads,
+  size_t* pnumNonzeros,
+  size_t row,
+  size_t column,
+  char value
+)
+{
+  assert(cmr);
+
+  ListNonzero* nz = NULL;
+  CMR_CALL( CMRallocBlock(cmr, &nz) );
+  nz->right = &rowHeads[row];
+  nz->left = rowHeads[row].left;
+  nz->left->right = nz;
+  nz->right->left = nz;
+  nz->below = &columnHeads[column];
+  nz->above = columnHeads[column].above;
+  nz->below->above = nz;
+  nz->above->below = nz;
+  nz->row = row;
+  nz->column = column;
+  nz->value = value;
+  (*pnumNonzeros)++;
+
+  return CMR_OKAY;
+}
+
+typedef struct
+{
+  size_t row;
+  size_t column;
+  char value;
+} Nonzero;
+
+static
+int compareNonzeros(const void* a, const void* b)
+{
+  Nonzero* nza = (Nonzero*) a;
+  Nonzero* nzb = (Nonzero*) b;
+  if (nza->row != nzb->row)
+    return nza->row < nzb->row ? -1 : +1;
+  else
+    return nza->column < nzb->column ? -1 : (nza->column > nzb->column);
+}
+
+CMR_ERROR CMRgenerateSeriesParallelMatrix(CMR* cmr, size_t numBaseRows, size_t numBaseColumns, size_t numZeroRows,
+  size_t numZeroColumns, size_t numUnitRows, size_t numUnitColumns, size_t numCopiedRows, size_t numCopiedColumns,
+  bool ternary, double probability, bool randomize, CMR_CHRMAT** pmatrix, size_t* pnumBaseNonzeros)
+{
+  assert(cmr);
+  assert(pmatrix);
+
+  size_t numTotalRows = numBaseRows + numZeroRows + numUnitRows + numCopiedRows;
+  size_t numTotalColumns = numBaseColumns + numZeroColumns + numUnitColumns + numCopiedColumns;
+
+  ListNonzero* rowHeads = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &rowHeads, numTotalRows) );
+  ListNonzero* columnHeads = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &columnHeads, numTotalColumns) );
+
+  for (size_t row = 0; row < numTotalRows; ++row)
+  {
+    rowHeads[row].left = &rowHeads[row];
+    rowHeads[row].right = &rowHeads[row];
+    rowHeads[row].above = NULL;
+    rowHeads[row].below = NULL;
+    rowHeads[row].row = row;
+    rowHeads[row].column = SIZE_MAX;
+  }
+  for (size_t column = 0; column < numTotalColumns; ++column)
+  {
+    columnHeads[column].left = NULL;
+    columnHeads[column].right = NULL;
+    columnHeads[column].below = &columnHeads[column];
+    columnHeads[column].above = &columnHeads[column];
+    columnHeads[column].column = column;
+    columnHeads[column].row = SIZE_MAX;
+  }
+
+  /* Create base matrix. */
+  size_t numBaseNonzeros = 0;
+  for (size_t row = 0; row < numBaseRows; ++row)
+  {
+    for (size_t column = 0; column < numBaseColumns; ++column)
+    {
+      if ((rand() * 1.0 / RAND_MAX) > probability)
+        continue;
+
+      char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
+      CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numBaseNonzeros, row, column, sign) );
+    }
+  }
+  size_t numTotalNonzeros = numBaseNonzeros;
+  if (pnumBaseNonzeros)
+    *pnumBaseNonzeros = numBaseNonzeros;
+
+  /* Create a list of all operations. */
+  char* operations = NULL;
+  size_t numOperations = numZeroRows + numZeroColumns + numUnitRows + numUnitColumns + numCopiedRows + numCopiedColumns;
+  CMR_CALL( CMRallocBlockArray(cmr, &operations, numOperations) );
+  char* op = operations;
+  for (size_t i = 0; i < numZeroRows; ++i)
+    (*op++) = 'z';
+  for (size_t i = 0; i < numZeroColumns; ++i)
+    (*op++) = 'Z';
+  for (size_t i = 0; i < numUnitRows; ++i)
+    (*op++) = 'u';
+  for (size_t i = 0; i < numUnitColumns; ++i)
+    (*op++) = 'U';
+  for (size_t i = 0; i < numCopiedRows; ++i)
+    (*op++) = 'c';
+  for (size_t i = 0; i < numCopiedColumns; ++i)
+    (*op++) = 'C';
+  assert(op == &operations[numOperations]);
+
+  /* Shuffle operations array. */
+  for (size_t i = 0; i+1 < numOperations; ++i)
+  {
+    size_t j = randRange(i, numOperations);
+    char tmp = operations[i];
+    operations[i] = operations[j];
+    operations[j] = tmp;
+  }
+
+  /* Start applying operations. */
+  size_t numRows = numBaseRows;
+  size_t numColumns = numBaseColumns;
+  for (size_t i = 0; i < numOperations; ++i)
+  {
+    switch(operations[i])
+    {
+      case 'z':
+      {
+        ++numRows;
+        break;
+      }
+      case 'Z':
+      {
+        ++numColumns;
+        break;
+      }
+      case 'u':
+      {
+        size_t column = randRange(0, numColumns);
+        char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
+        CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numTotalNonzeros, numRows, column, sign) );
+        ++numRows;
+        break;
+      }
+      case 'U':
+      {
+        size_t row = randRange(0, numRows);
+        char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
+        CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numTotalNonzeros, row, numColumns, sign) );
+        ++numColumns;
+        break;
+      }
+      case 'c':
+      {
+        size_t row = randRange(0, numRows);
+        char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
+        for (ListNonzero* nz = rowHeads[row].right; nz->column != SIZE_MAX; nz = nz->right)
+          CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numTotalNonzeros, numRows, nz->column, sign * nz->value) );
+        ++numRows;
+        break;
+      }
+      case 'C':
+      {
+        size_t column = randRange(0, numColumns);
+        char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
+        for (ListNonzero* nz = columnHeads[column].below; nz->row != SIZE_MAX; nz = nz->below)
+          CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numTotalNonzeros, nz->row, numColumns, sign * nz->value) );
+        ++numColumns;
+        break;
+      }
+    }
+  }
+  CMR_CALL( CMRfreeBlockArray(cmr, &operations) );
+
+  /* Create permutations. */
+  size_t* rowPermutation = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &rowPermutation, numTotalRows) );
+  for (size_t row = 0; row < numTotalRows; ++row)
+    rowPermutation[row] = row;
+  size_t* columnPermutation = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &columnPermutation, numTotalColumns) );
+  for (size_t column = 0; column < numTotalColumns; ++column)
+    columnPermutation[column] = column;
+  if (randomize)
+  {
+    for (size_t row = 0; row < numTotalRows; ++row)
+    {
+      size_t r = randRange(row, numTotalRows);
+      size_t tmp = rowPermutation[row];
+      rowPermutation[row] = rowPermutation[r];
+      rowPermutation[r] = tmp;
+    }
+    for (size_t column = 0; column < numTotalColumns; ++column)
+    {
+      size_t c = randRange(column, numTotalColumns);
+      size_t tmp = columnPermutation[column];
+      columnPermutation[column] = columnPermutation[c];
+      columnPermutation[c] = tmp;
+    }
+  }
+
+  /* Create array of all nonzeros and free the lists. */
+  Nonzero* nzs = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &nzs, numTotalNonzeros) );
+  size_t i = 0;
+  for (size_t row = 0; row < numTotalRows; ++row)
+  {
+    for (ListNonzero* nz = rowHeads[row].right; nz != &rowHeads[row]; )
+    {
+      nzs[i].row = rowPermutation[nz->row];
+      nzs[i].column = columnPermutation[nz->column];
+      nzs[i].value = nz->value;
+      ++i;
+      ListNonzero* current = nz;
+      nz = nz->right;
+      CMR_CALL( CMRfreeBlock(cmr, &current) );
+    }
+  }
+  assert(i == numTotalNonzeros);
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &columnPermutation) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &rowPermutation) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &columnHeads) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &rowHeads) );
+
+  qsort(nzs, numTotalNonzeros, sizeof(Nonzero), compareNonzeros);
+
+  /* Create matrix. */
+  CMR_CALL( CMRchrmatCreate(cmr, pmatrix, numTotalRows, numTotalColumns, numTotalNonzeros) );
+  CMR_CHRMAT* matrix = *pmatrix;
+  size_t row = 0;
+  for (size_t e = 0; e < numTotalNonzeros; ++e)
+  {
+    while (row <= nzs[e].row)
+      matrix->rowSlice[row++] = e;
+
+    matrix->entryColumns[e] = nzs[e].column;
+    matrix->entryValues[e] = nzs[e].value;
+  }
+  while (row <= matrix->numRows)
+    matrix->rowSlice[row++] = matrix->numNonzeros;
+
+  CMR_CALL( CMRfreeBlockArray(cmr, &nzs) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Returns the next number of the SplitMix64 generator with state \p *pstate.
+ */
+
+static inline
+uint64_t streamRandom(
+  uint64_t* pstate  /**< Pointer to the state. */
+)
+{
+  uint64_t z = (*pstate += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * \brief Returns a random number in \f$ \{0,1,\dotsc,N-1\} \f$.
+ *
+ * The bias of the modulo is negligible for the sizes of generated matrices.
+ */
+
+static inline
+size_t streamRandomRange(
+  uint64_t* pstate, /**< Pointer to the state. */
+  size_t N          /**< Number of values. */
+)
+{
+  return streamRandom(pstate) % N;
+}
+
+/**
+ * \brief Returns a uniform random number in \f$ [0,1) \f$.
+ */
+
+static inline
+double streamRandomUniform(
+  uint64_t* pstate  /**< Pointer to the state. */
+)
+{
+  return (streamRandom(pstate) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * \brief Returns the initial state of the generator for chunk \p chunk of phase \p phase.
+ */
+
+static
+uint64_t streamSeed(
+  uint64_t seed,  /**< Seed given by the user. */
+  int phase,      /**< Phase. */
+  size_t chunk    /**< Index of the chunk. */
+)
+{
+  uint64_t state = seed;
+  state = streamRandom(&state) ^ ((uint64_t) phase * 0xD1B54A32D192ED03ULL)
+    ^ ((uint64_t) (chunk + 1) * 0xABC98388FB8FAC03ULL);
+  streamRandom(&state);
+  return state;
+}
+
+/**
+ * \brief Data shared by the workers of \ref CMRgenerateSparseStream.
+ */
+
+typedef struct
+{
+  CMR* cmr;                     /**< \ref CMR environment. */
+  CMR_GENERATE_KIND kind;       /**< Kind of matrix. */
+  size_t numRows;               /**< Number of rows. */
+  size_t numColumns;            /**< Number of columns. */
+  double probability;           /**< Probability of a 1-entry for \ref CMR_GENERATE_RANDOM. */
+  uint64_t seed;                /**< Seed of the random number generators. */
+  FILE* stream;                 /**< File stream to write to. */
+  size_t* treeParent;           /**< Array mapping each tree node to its parent; node 0 is the root. */
+  size_t* treeDepth;            /**< Array mapping each tree node to its distance from the root. */
+  size_t* chunkNonzeros;        /**< Array mapping each chunk of columns to its number of nonzeros. */
+  int phase;                    /**< 0 for drawing the tree, 1 for counting and 2 for writing the nonzeros. */
+  size_t numChunks;             /**< Number of chunks of the current phase. */
+  size_t nextChunk;             /**< Next chunk to be processed. */
+  size_t nextWrite;             /**< Next chunk to be written. */
+  CMR_ERROR error;              /**< First error of a worker. */
+#if defined(CMR_WITH_THREADS)
+  pthread_mutex_t mutex;        /**< Mutex protecting the chunk counters and the error. */
+  pthread_cond_t condition;     /**< Condition signaled whenever a chunk was written or an error occurred. */
+#endif /* CMR_WITH_THREADS */
+} SparseStream;
+
+static inline
+void sparseStreamLock(SparseStream* sparse)
+{
+#if defined(CMR_WITH_THREADS)
+  pthread_mutex_lock(&sparse->mutex);
+#else
+  CMR_UNUSED(sparse);
+#endif /* CMR_WITH_THREADS */
+}
+
+static inline
+void sparseStreamUnlock(SparseStream* sparse)
+{
+#if defined(CMR_WITH_THREADS)
+  pthread_mutex_unlock(&sparse->mutex);
+#else
+  CMR_UNUSED(sparse);
+#endif /* CMR_WITH_THREADS */
+}
+
+/**
+ * \brief Generates a single column, storing its row indices in \p rows and its values in \p values.
+ *
+ * \returns The number of nonzeros of the column.
+ */
+
+static
+size_t sparseStreamColumn(
+  SparseStream* sparse, /**< Shared data. */
+  uint64_t* pstate,     /**< Pointer to the state of the random number generator. */
+  size_t* rows,         /**< Array of length \c numRows for storing the row indices. */
+  char* values          /**< Array of length \c numRows for storing the values. */
+)
+{
+  size_t numNonzeros = 0;
+  size_t numNodes = sparse->numRows + 1;
+  size_t* parent = sparse->treeParent;
+  size_t* depth = sparse->treeDepth;
+
+  if (sparse->kind == CMR_GENERATE_RANDOM)
+  {
+    /* We skip geometrically distributed numbers of zeros. */
+    double probability = sparse->probability;
+    if (probability <= 0.0)
+      return 0;
+    double logZero = probability < 1.0 ? log1p(-probability) : -INFINITY;
+    double row = -1.0;
+    while (true)
+    {
+      double skip = logZero == -INFINITY ? 0.0 : floor(log1p(-streamRandomUniform(pstate)) / logZero);
+      row += skip + 1.0;
+      if (row >= (double) sparse->numRows)
+        break;
+      rows[numNonzeros] = (size_t) row;
+      values[numNonzeros] = 1;
+      ++numNonzeros;
+    }
+    return numNonzeros;
+  }
+
+  size_t first = streamRandomRange(pstate, numNodes);
+  size_t second;
+  if (sparse->kind == CMR_GENERATE_NETWORK_BINARY)
+  {
+    /* If first is not the root, then we go at least one step towards it to not produce zero columns. */
+    size_t steps = depth[first] ? 1 + streamRandomRange(pstate, depth[first]) : 0;
+    for (second = first; steps; --steps)
+      second = parent[second];
+  }
+  else
+    second = streamRandomRange(pstate, numNodes);
+
+  /* Tree arcs point towards the root, i.e., those on the path from second have the opposite direction. */
+  char secondSign = sparse->kind == CMR_GENERATE_NETWORK ? -1 : 1;
+  while (depth[first] > depth[second])
+  {
+    rows[numNonzeros] = first - 1;
+    values[numNonzeros++] = 1;
+    first = parent[first];
+  }
+  while (depth[second] > depth[first])
+  {
+    rows[numNonzeros] = second - 1;
+    values[numNonzeros++] = secondSign;
+    second = parent[second];
+  }
+  while (first != second)
+  {
+    rows[numNonzeros] = first - 1;
+    values[numNonzeros++] = 1;
+    first = parent[first];
+    rows[numNonzeros] = second - 1;
+    values[numNonzeros++] = secondSign;
+    second = parent[second];
+  }
+
+  return numNonzeros;
+}
+
+/**
+ * \brief Writes the decimal representation of \p number to \p buffer and returns the position beyond it.
+ */
+
+static inline
+char* sparseStreamPrintSize(
+  char* buffer, /**< Buffer with space for at least 20 characters. */
+  size_t number /**< Number to print. */
+)
+{
+  char digits[24];
+  size_t numDigits = 0;
+  do
+  {
+    digits[numDigits++] = (char) ('0' + number % 10);
+    number /= 10;
+  }
+  while (number);
+  while (numDigits)
+    *buffer++ = digits[--numDigits];
+  return buffer;
+}
+
+/**
+ * \brief Processes chunks of the current phase until there are no more.
+ */
+
+static
+CMR_ERROR sparseStreamWork(
+  SparseStream* sparse, /**< Shared data. */
+  size_t* rows,         /**< Array of length \c numRows. */
+  char* values,         /**< Array of length \c numRows. */
+  char** pbuffer,       /**< Pointer to the output buffer. */
+  size_t* pmemBuffer    /**< Pointer to the size of the output buffer. */
+)
+{
+  while (true)
+  {
+    sparseStreamLock(sparse);
+    size_t chunk = sparse->error ? SIZE_MAX : sparse->nextChunk++;
+    sparseStreamUnlock(sparse);
+    if (chunk >= sparse->numChunks)
+      break;
+
+    uint64_t state = streamSeed(sparse->seed, sparse->phase ? 1 : 0, chunk);
+    if (sparse->phase == 0)
+    {
+      size_t numNodes = sparse->numRows + 1;
+      size_t beyond = (chunk + 1) * STREAM_CHUNK_NODES < numNodes ? (chunk + 1) * STREAM_CHUNK_NODES : numNodes;
+      for (size_t v = chunk * STREAM_CHUNK_NODES; v < beyond; ++v)
+        sparse->treeParent[v] = v ? streamRandomRange(&state, v) : 0;
+      continue;
+    }
+
+    size_t firstColumn = chunk * STREAM_CHUNK_COLUMNS;
+    size_t beyondColumn = firstColumn + STREAM_CHUNK_COLUMNS < sparse->numColumns ? firstColumn + STREAM_CHUNK_COLUMNS
+      : sparse->numColumns;
+    size_t numNonzeros = 0;
+    size_t length = 0;
+    for (size_t column = firstColumn; column < beyondColumn; ++column)
+    {
+      size_t numColumnNonzeros = sparseStreamColumn(sparse, &state, rows, values);
+      numNonzeros += numColumnNonzeros;
+      if (sparse->phase == 1)
+        continue;
+
+      /* Each nonzero needs at most 2 * 20 digits, the sign, the digit and 3 separators. */
+      if (length + 45 * numColumnNonzeros > *pmemBuffer)
+      {
+        *pmemBuffer = 2 * (length + 45 * numColumnNonzeros);
+        CMR_CALL( CMRreallocBlockArray(sparse->cmr, pbuffer, *pmemBuffer) );
+      }
+      char* p = *pbuffer + length;
+      for (size_t i = 0; i < numColumnNonzeros; ++i)
+      {
+        p = sparseStreamPrintSize(p, rows[i] + 1);
+        *p++ = ' ';
+        p = sparseStreamPrintSize(p, column + 1);
+        *p++ = ' ';
+        if (values[i] < 0)
+          *p++ = '-';
+        *p++ = '1';
+        *p++ = '\n';
+      }
+      length = p - *pbuffer;
+    }
+
+    if (sparse->phase == 1)
+    {
+      sparse->chunkNonzeros[chunk] = numNonzeros;
+      continue;
+    }
+
+    /* We wait until all previous chunks are written. */
+    sparseStreamLock(sparse);
+#if defined(CMR_WITH_THREADS)
+    while (sparse->nextWrite != chunk && !sparse->error)
+      pthread_cond_wait(&sparse->condition, &sparse->mutex);
+#endif /* CMR_WITH_THREADS */
+    bool failed = sparse->error != CMR_OKAY;
+    sparseStreamUnlock(sparse);
+    if (failed)
+      break;
+
+    assert(numNonzeros == sparse->chunkNonzeros[chunk]);
+    if (fwrite(*pbuffer, 1, length, sparse->stream) != length)
+      return CMR_ERROR_OUTPUT;
+
+    sparseStreamLock(sparse);
+    sparse->nextWrite++;
+#if defined(CMR_WITH_THREADS)
+    pthread_cond_broadcast(&sparse->condition);
+#endif /* CMR_WITH_THREADS */
+    sparseStreamUnlock(sparse);
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Runs a single worker of \ref CMRgenerateSparseStream.
+ */
+
+static
+void* sparseStreamWorker(
+  void* data  /**< Shared data. */
+)
+{
+  SparseStream* sparse = (SparseStream*) data;
+  CMR* cmr = sparse->cmr;
+
+  size_t* rows = NULL;
+  char* values = NULL;
+  char* buffer = NULL;
+  size_t memBuffer = 0;
+  CMR_ERROR error = CMRallocBlockArray(cmr, &rows, sparse->numRows + 1);
+  if (!error)
+    error = CMRallocBlockArray(cmr, &values, sparse->numRows + 1);
+  if (!error)
+    error = sparseStreamWork(sparse, rows, values, &buffer, &memBuffer);
+
+  if (buffer)
+    CMRfreeBlockArray(cmr, &buffer);
+  if (values)
+    CMRfreeBlockArray(cmr, &values);
+  if (rows)
+    CMRfreeBlockArray(cmr, &rows);
+
+  if (error)
+  {
+    sparseStreamLock(sparse);
+    if (!sparse->error)
+      sparse->error = error;
+#if defined(CMR_WITH_THREADS)
+    pthread_cond_broadcast(&sparse->condition);
+#endif /* CMR_WITH_THREADS */
+    sparseStreamUnlock(sparse);
+  }
+
+  return NULL;
+}
+
+/**
+ * \brief Processes the \p numChunks chunks of phase \p phase by up to \p numWorkers workers.
+ */
+
+static
+CMR_ERROR sparseStreamRun(
+  SparseStream* sparse, /**< Shared data. */
+  int phase,            /**< Phase. */
+  size_t numChunks,     /**< Number of chunks. */
+  size_t numWorkers     /**< Maximum number of workers. */
+)
+{
+  sparse->phase = phase;
+  sparse->numChunks = numChunks;
+  sparse->nextChunk = 0;
+  sparse->nextWrite = 0;
+  if (numWorkers > numChunks)
+    numWorkers = numChunks;
+
+#if defined(CMR_WITH_THREADS)
+  if (numWorkers > 1)
+  {
+    pthread_t* threads = NULL;
+    CMR_CALL( CMRallocBlockArray(sparse->cmr, &threads, numWorkers) );
+    size_t numStarted = 1;
+    while (numStarted < numWorkers && !pthread_create(&threads[numStarted], NULL, sparseStreamWorker, sparse))
+      ++numStarted;
+    sparseStreamWorker(sparse);
+    for (size_t w = 1; w < numStarted; ++w)
+      pthread_join(threads[w], NULL);
+    CMR_CALL( CMRfreeBlockArray(sparse->cmr, &threads) );
+  }
+  else
+#endif /* CMR_WITH_THREADS */
+  {
+    sparseStreamWorker(sparse);
+  }
+
+  return sparse->error;
+}
+
+CMR_ERROR CMRgenerateSparseStream(CMR* cmr, CMR_GENERATE_KIND kind, size_t numRows, size_t numColumns,
+  double probability, uint64_t seed, FILE* stream, size_t* pnumNonzeros)
+{
+  assert(cmr);
+  assert(stream);
+
+  SparseStream sparse;
+  sparse.cmr = cmr;
+  sparse.kind = kind;
+  sparse.numRows = numRows;
+  sparse.numColumns = numColumns;
+  sparse.probability = probability;
+  sparse.seed = seed;
+  sparse.stream = stream;
+  sparse.treeParent = NULL;
+  sparse.treeDepth = NULL;
+  sparse.chunkNonzeros = NULL;
+  sparse.error = CMR_OKAY;
+#if defined(CMR_WITH_THREADS)
+  pthread_mutex_init(&sparse.mutex, NULL);
+  pthread_cond_init(&sparse.condition, NULL);
+#endif /* CMR_WITH_THREADS */
+
+  int numThreads = CMRgetNumThreads(cmr);
+  size_t numWorkers = numThreads > 1 ? (size_t) numThreads : 1;
+  CMR_ERROR error = CMR_OKAY;
+
+  if (kind != CMR_GENERATE_RANDOM)
+  {
+    /* The parents of the nodes of the random tree are drawn independently, but the depths depend on each other. */
+    size_t numNodes = numRows + 1;
+    CMR_CALL( CMRallocBlockArray(cmr, &sparse.treeParent, numNodes) );
+    CMR_CALL( CMRallocBlockArray(cmr, &sparse.treeDepth, numNodes) );
+    error = sparseStreamRun(&sparse, 0, (numNodes + STREAM_CHUNK_NODES - 1) / STREAM_CHUNK_NODES, numWorkers);
+    sparse.treeDepth[0] = 0;
+    for (size_t v = 1; v < numNodes && !error; ++v)
+      sparse.treeDepth[v] = sparse.treeDepth[sparse.treeParent[v]] + 1;
+  }
+
+  size_t numChunks = (numColumns + STREAM_CHUNK_COLUMNS - 1) / STREAM_CHUNK_COLUMNS;
+  size_t numNonzeros = 0;
+  if (!error)
+    error = CMRallocBlockArray(cmr, &sparse.chunkNonzeros, numChunks + 1);
+  if (!error)
+    error = sparseStreamRun(&sparse, 1, numChunks, numWorkers);
+  if (!error)
+  {
+    for (size_t chunk = 0; chunk < numChunks; ++chunk)
+      numNonzeros += sparse.chunkNonzeros[chunk];
+    if (fprintf(stream, "%zu %zu %zu\n\n", numRows, numColumns, numNonzeros) < 0)
+      error = CMR_ERROR_OUTPUT;
+  }
+  if (!error)
+    error = sparseStreamRun(&sparse, 2, numChunks, numWorkers);
+
+  if (sparse.chunkNonzeros)
+    CMR_CALL( CMRfreeBlockArray(cmr, &sparse.chunkNonzeros) );
+  if (sparse.treeDepth)
+    CMR_CALL( CMRfreeBlockArray(cmr, &sparse.treeDepth) );
+  if (sparse.treeParent)
+    CMR_CALL( CMRfreeBlockArray(cmr, &sparse.treeParent) );
+#if defined(CMR_WITH_THREADS)
+  pthread_cond_destroy(&sparse.condition);
+  pthread_mutex_destroy(&sparse.mutex);
+#endif /* CMR_WITH_THREADS */
+
+  if (pnumNonzeros)
+    *pnumNonzeros = numNonzeros;
+
+  return error;
+}
@@ -0,0 +1,122 @@
+#ifndef CMR_GENERATORS_H
+#define CMR_GENERATORS_H
+
+/**
+ * \file generators.h
+ *
+ * \brief Random matrix generators shared by the generator executables and by cmr-bench.
+ *
+ * All generators draw their random numbers from \c rand(), i.e., the caller seeds them via \c srand().
+ */
+
+#include <cmr/matrix.h>
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Creates a random graphic 0/1 matrix.
+ *
+ * The matrix represents a random spanning tree with \p numRows edges and \p numColumns random non-tree edges.
+ */
+
+CMR_ERROR CMRgenerateGraphicMatrix(
+  CMR* cmr,             /**< \ref CMR environment. */
+  size_t numRows,       /**< Number of rows. */
+  size_t numColumns,    /**< Number of columns. */
+  CMR_CHRMAT** pmatrix  /**< Pointer for storing the generated matrix. */
+);
+
+/**
+ * \brief Creates a random network matrix.
+ *
+ * The matrix represents a random spanning arborescence with \p numRows arcs and \p numColumns random non-tree arcs.
+ * If \p binary is \c true, then all non-tree arcs point towards the root such that the matrix is a 0/1 matrix.
+ */
+
+CMR_ERROR CMRgenerateNetworkMatrix(
+  CMR* cmr,             /**< \ref CMR environment. */
+  size_t numRows,       /**< Number of rows. */
+  size_t numColumns,    /**< Number of columns. */
+  bool binary,          /**< Whether to generate a binary network matrix. */
+  CMR_CHRMAT** pmatrix  /**< Pointer for storing the generated matrix. */
+);
+
+/**
+ * \brief Creates a random 0/1 matrix in which each entry is 1 with probability \p probability.
+ */
+
+CMR_ERROR CMRgenerateRandomMatrix(
+  CMR* cmr,             /**< \ref CMR environment. */
+  size_t numRows,       /**< Number of rows. */
+  size_t numColumns,    /**< Number of columns. */
+  double probability,   /**< Probability of a 1-entry. */
+  CMR_CHRMAT** pmatrix  /**< Pointer for storing the generated matrix. */
+);
+
+/**
+ * \brief Creates a random 0/1 or -1/0/+1 base matrix and augments it by series-parallel operations in random order.
+ */
+
+CMR_ERROR CMRgenerateSeriesParallelMatrix(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  size_t numBaseRows,       /**< Number of rows of base matrix. */
+  size_t numBaseColumns,    /**< Number of columns of base matrix. */
+  size_t numZeroRows,       /**< Number of added zero rows. */
+  size_t numZeroColumns,    /**< Number of added zero columns. */
+  size_t numUnitRows,       /**< Number of added unit rows. */
+  size_t numUnitColumns,    /**< Number of added unit columns. */
+  size_t numCopiedRows,     /**< Number of added copied rows. */
+  size_t numCopiedColumns,  /**< Number of added copied columns. */
+  bool ternary,             /**< Whether to create a ternary matrix. */
+  double probability,       /**< Probability for each entry of base matrix to be a nonzero. */
+  bool randomize,           /**< Whether to randomize afterwards via row/column permutations. */
+  CMR_CHRMAT** pmatrix,     /**< Pointer for storing the generated matrix. */
+  size_t* pnumBaseNonzeros  /**< Pointer for storing the number of nonzeros of the base matrix (may be \c NULL). */
+);
+
+/**
+ * \brief Kinds of matrices that \ref CMRgenerateSparseStream can generate.
+ */
+
+typedef enum
+{
+  CMR_GENERATE_GRAPHIC = 0,         /**< Random graphic 0/1 matrix as by \ref CMRgenerateGraphicMatrix. */
+  CMR_GENERATE_NETWORK = 1,         /**< Random network matrix whose non-tree arcs join uniform random nodes. */
+  CMR_GENERATE_NETWORK_BINARY = 2,  /**< Random binary network matrix whose non-tree arcs point towards the root. */
+  CMR_GENERATE_RANDOM = 3           /**< Random 0/1 matrix as by \ref CMRgenerateRandomMatrix. */
+} CMR_GENERATE_KIND;
+
+/**
+ * \brief Generates a random matrix and writes it to \p stream in the [sparse format](\ref sparse-matrix) without
+ *        storing it.
+ *
+ * The nonzeros are written column by column, i.e., the output can be read by \ref CMRchrmatStreamSparseColumns. The
+ * columns are generated in chunks by the threads of \p cmr, each of which draws its random numbers from a generator
+ * that is seeded by \p seed and the index of the chunk. Hence, the output only depends on \p seed and not on the
+ * number of threads. Since the header contains the number of nonzeros, every chunk is generated twice, first to count
+ * its nonzeros and then to write them. Apart from the random tree, the memory does not depend on \p numColumns.
+ *
+ * The signs of a network matrix are determined by the directions of the tree arcs on the path of each non-tree arc,
+ * i.e., unlike \ref CMRgenerateNetworkMatrix, Camion's signing algorithm is not needed.
+ */
+
+CMR_ERROR CMRgenerateSparseStream(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_GENERATE_KIND kind,   /**< Kind of matrix. */
+  size_t numRows,           /**< Number of rows. */
+  size_t numColumns,        /**< Number of columns. */
+  double probability,       /**< Probability of a 1-entry for \ref CMR_GENERATE_RANDOM. */
+  uint64_t seed,            /**< Seed of the random number generators. */
+  FILE* stream,             /**< File stream to write to. */
+  size_t* pnumNonzeros      /**< Pointer for storing the number of nonzeros (may be \c NULL). */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_GENERATORS_H */
@@ -9,6 +9,8 @@
 
 #include <cmr/graphic.h>
 
+#include "generators.h"
+
 typedef enum
 {
   FILEFORMAT_UNDEFINED = 0,       /**< Whether the file format of output was defined by the user. */
@@ -16,21 +18,6 @@ typedef enum
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
 } FileFormat;
 
-static inline
-size_t randRange(size_t first, size_t beyond)
-{
-  size_t N = beyond - first;
-  size_t representatives = (RAND_MAX + 1u) / N;
-  size_t firstInvalid = N * representatives;
-  size_t x;
-  do
-  {
-    x = rand();
-  }
-  while (x >= firstInvalid);
-  return first + x / representatives;
-}
-
 int printUsage(const char* program)
 {
   printf("Usage: %s [OPTIONS] ROWS COLS\n\n", program);
@@ -38,17 +25,13 @@ int printUsage(const char* program)
   puts("Options:\n");
   puts("  -B NUM     Benchmarks the recognition algorithm for the created matrix with NUM repetitions.\n");
   puts("  -o FORMAT  Format of output FILE; default: `dense'.");
+  puts("  --stream   Write the matrix column by column while generating it; implies `-o sparse'.");
+  puts("  --seed SEED  Seed of the random number generators of --stream; default: current time.");
+  puts("  --threads NUM  Use NUM threads for --stream, where 0 means all available processors; default: 1.");
   puts("Formats for matrices: dense, sparse");
   return EXIT_FAILURE;
 }
 
-int compare(const void* pa, const void* pb)
-{
-  size_t a = *((size_t*)(pa));
-  size_t b = *((size_t*)(pb));
-  return a < b ? -1 : (a > b);
-}
-
 CMR_ERROR genMatrixGraphic(
   size_t numRows,               /**< Number of rows of base matrix. */
   size_t numColumns,            /**< Number of columns of base matrix. */
@@ -59,88 +42,14 @@ CMR_ERROR genMatrixGraphic(
   CMR* cmr = NULL;
   CMR_CALL( CMRcreateEnvironment(&cmr) );
 
-  size_t numNodes = numRows + 1;
-  size_t numEdges = numColumns;
   CMR_GRAPHIC_STATISTICS stats;
   CMR_CALL( CMRgraphicStatsInit(&stats) );
   for (size_t benchmark = benchmarkRepetitions ? benchmarkRepetitions : 1; benchmark > 0; --benchmark)
   {
     clock_t startTime = clock();
 
-    /* Init transpose of matrix. */
-    size_t transposedMemNonzeros = 1;
-    for (size_t x = numRows; x; x >>= 1)
-      ++transposedMemNonzeros;
-    transposedMemNonzeros *= numColumns;
-    CMR_CHRMAT* transposed = NULL;
-    CMR_CALL( CMRchrmatCreate(cmr, &transposed, numEdges, numNodes-1, transposedMemNonzeros) );
-    transposed->numNonzeros = 0;
-
-    /* Create random arborescence. */
-    int* nextTreeNode = NULL;
-    int* treeDistance = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &nextTreeNode, numNodes) );
-    CMR_CALL( CMRallocBlockArray(cmr, &treeDistance, numNodes) );
-    nextTreeNode[0] = 0;
-    treeDistance[0] = 0;
-    for (int v = 1; v < (int) numNodes; ++v)
-    {
-      int w = (int)(rand() * 1.0 * v / RAND_MAX);
-      nextTreeNode[v] = w;
-      treeDistance[v] = treeDistance[w] + 1;
-    }
-
-    size_t* columnNonzeros = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &columnNonzeros, numNodes - 1) );
-    for (int e = 0; e < (int)numEdges; ++e)
-    {
-      size_t numColumNonzeros = 0;
-      int first = (int)(rand() * 1.0 * numNodes / RAND_MAX);
-      int second = (int)(rand() * 1.0 * numNodes / RAND_MAX);
-      while (treeDistance[first] > treeDistance[second])
-      {
-        columnNonzeros[numColumNonzeros++] = first-1;
-        first = nextTreeNode[first];
-      }
-      while (treeDistance[second] > treeDistance[first])
-      {
-        columnNonzeros[numColumNonzeros++] = second-1;
-        second = nextTreeNode[second];
-      }
-      while (first != second && first)
-      {
-        columnNonzeros[numColumNonzeros++] = first-1;
-        first = nextTreeNode[first];
-        columnNonzeros[numColumNonzeros++] = second-1;
-        second = nextTreeNode[second];
-      }
-      transposed->rowSlice[e] = transposed->numNonzeros;
-
-      qsort( columnNonzeros, numColumNonzeros, sizeof(size_t), &compare);
-
-      for (size_t i = 0; i < numColumNonzeros; ++i)
-      {
-        size_t row = columnNonzeros[i];
-        if (transposed->numNonzeros == transposedMemNonzeros)
-        {
-          transposedMemNonzeros *= 2;
-          CMR_CALL( CMRreallocBlockArray(cmr, &transposed->entryColumns, transposedMemNonzeros) );
-          CMR_CALL( CMRreallocBlockArray(cmr, &transposed->entryValues, transposedMemNonzeros) );
-        }
-        transposed->entryColumns[transposed->numNonzeros] = row;
-        transposed->entryValues[transposed->numNonzeros] = 1;
-        transposed->numNonzeros++;
-      }
-    }
-    transposed->rowSlice[transposed->numRows] = transposed->numNonzeros;
-
-    CMR_CALL( CMRfreeBlockArray(cmr, &columnNonzeros) );
-    CMR_CALL( CMRfreeBlockArray(cmr, &nextTreeNode) );
-    CMR_CALL( CMRfreeBlockArray(cmr, &treeDistance) );
-
     CMR_CHRMAT* matrix = NULL;
-    CMR_CALL( CMRchrmatTranspose(cmr, transposed, &matrix) );
-    CMR_CALL( CMRchrmatFree(cmr, &transposed) );
+    CMR_CALL( CMRgenerateGraphicMatrix(cmr, numRows, numColumns, &matrix) );
 
     if (benchmarkRepetitions)
     {
@@ -173,6 +82,38 @@ CMR_ERROR genMatrixGraphic(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Generates the matrix column by column and writes it to stdout in sparse format.
+ */
+
+static
+CMR_ERROR genMatrixGraphicStream(
+  size_t numRows,         /**< Number of rows. */
+  size_t numColumns,      /**< Number of columns. */
+  uint64_t seed,          /**< Seed of the random number generators. */
+  int numThreads          /**< Number of threads. */
+)
+{
+  CMR* cmr = NULL;
+  CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+  struct timeval startTime;
+  gettimeofday(&startTime, NULL);
+  size_t numNonzeros;
+  CMR_CALL( CMRgenerateSparseStream(cmr, CMR_GENERATE_GRAPHIC, numRows, numColumns, 0.0, seed, stdout,
+    &numNonzeros) );
+  struct timeval endTime;
+  gettimeofday(&endTime, NULL);
+  double generationTime = (endTime.tv_sec - startTime.tv_sec) + 1.0e-6 * (endTime.tv_usec - startTime.tv_usec);
+  fprintf(stderr, "Generated a %zux%zu matrix with %zu nonzeros in %f seconds.\n", numRows, numColumns, numNonzeros,
+    generationTime);
+
+  CMR_CALL( CMRfreeEnvironment(&cmr) );
+
+  return CMR_OKAY;
+}
+
 int main(int argc, char** argv)
 {
   struct timeval curTime;
@@ -182,6 +123,9 @@ int main(int argc, char** argv)
   FileFormat outputFormat = FILEFORMAT_UNDEFINED;
   size_t numRows = SIZE_MAX;
   size_t numColumns = SIZE_MAX;
+  bool stream = false;
+  uint64_t seed = curTime.tv_usec;
+  int numThreads = 1;
   size_t benchmarkRepetitions = 0;
   for (int a = 1; a < argc; ++a)
   {
@@ -202,6 +146,30 @@ int main(int argc, char** argv)
       }
       a++;
     }
+    else if (!strcmp(argv[a], "--stream"))
+      stream = true;
+    else if (!strcmp(argv[a], "--seed") && a+1 < argc)
+    {
+      char* p;
+      seed = strtoull(argv[a+1], &p, 10);
+      if (*p != '\0')
+      {
+        printf("Error: invalid seed <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      a++;
+    }
+    else if (!strcmp(argv[a], "--threads") && a+1 < argc)
+    {
+      char* p;
+      numThreads = (int) strtol(argv[a+1], &p, 10);
+      if (*p != '\0' || numThreads < 0)
+      {
+        printf("Error: invalid number of threads <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      a++;
+    }
     else if (!strcmp(argv[a], "-o") && (a+1 < argc))
     {
       if (!strcmp(argv[a+1], "dense"))
@@ -257,10 +225,25 @@ int main(int argc, char** argv)
     puts("Error: matrix must have at least 1 row and 1 column.\n");
     return printUsage(argv[0]);
   }
+  if (stream)
+  {
+    if (outputFormat == FILEFORMAT_MATRIX_DENSE)
+    {
+      puts("Error: --stream requires sparse output.\n");
+      return printUsage(argv[0]);
+    }
+    if (benchmarkRepetitions)
+    {
+      puts("Error: --stream cannot be combined with -B.\n");
+      return printUsage(argv[0]);
+    }
+    outputFormat = FILEFORMAT_MATRIX_SPARSE;
+  }
   if (outputFormat == FILEFORMAT_UNDEFINED)
     outputFormat = FILEFORMAT_MATRIX_DENSE;
 
-  CMR_ERROR error = genMatrixGraphic(numRows, numColumns, benchmarkRepetitions, outputFormat);
+  CMR_ERROR error = stream ? genMatrixGraphicStream(numRows, numColumns, seed, numThreads)
+    : genMatrixGraphic(numRows, numColumns, benchmarkRepetitions, outputFormat);
   switch (error)
   {
   case CMR_ERROR_INPUT:
@@ -269,6 +252,9 @@ int main(int argc, char** argv)
   case CMR_ERROR_MEMORY:
     puts("Memory error.");
     return EXIT_FAILURE;
+  case CMR_ERROR_OUTPUT:
+    fputs("Output error.\n", stderr);
+    return EXIT_FAILURE;
   default:
     return EXIT_SUCCESS;
   }
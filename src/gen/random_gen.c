@@ -8,6 +8,8 @@
 
 #include <cmr/graphic.h>
 
+#include "generators.h"
+
 typedef enum
 {
   FILEFORMAT_UNDEFINED = 0,       /**< Whether the file format of output was defined by the user. */
@@ -15,27 +17,15 @@ typedef enum
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
 } FileFormat;
 
-static inline
-size_t randRange(size_t first, size_t beyond)
-{
-  size_t N = beyond - first;
-  size_t representatives = (RAND_MAX + 1u) / N;
-  size_t firstInvalid = N * representatives;
-  size_t x;
-  do
-  {
-    x = rand();
-  }
-  while (x >= firstInvalid);
-  return first + x / representatives;
-}
-
 int printUsage(const char* program)
 {
   printf("Usage: %s [OPTIONS] ROWS COLS p\n\n", program);
   puts("Creates a random ROWS-by-COLS 0/1 matrix in which each entry is 1 with probability p.\n");
   puts("Options:\n");
   puts("  -o FORMAT  Format of output FILE; default: `dense'.");
+  puts("  --stream   Write the matrix column by column while generating it; implies `-o sparse'.");
+  puts("  --seed SEED  Seed of the random number generators of --stream; default: current time.");
+  puts("  --threads NUM  Use NUM threads for --stream, where 0 means all available processors; default: 1.");
   puts("Formats for matrices: dense, sparse");
   return EXIT_FAILURE;
 }
@@ -51,33 +41,8 @@ CMR_ERROR genMatrixRandom(
   CMR* cmr = NULL;
   CMR_CALL( CMRcreateEnvironment(&cmr) );
   
-  size_t estimatedNumNonzeros = 1.1 * numRows * numColumns * probability1 + 1024;
-
   CMR_CHRMAT* matrix = NULL;
-  CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, estimatedNumNonzeros) );
-  size_t entry = 0;
-  for (size_t row = 0; row < numRows; ++row)
-  {
-    matrix->rowSlice[row] = entry;
-    for (size_t column = 0; column < numColumns; ++column)
-    {
-      bool isNonzero = (rand() * 1.0 / RAND_MAX) < probability1;
-      if (isNonzero)
-      {
-        if (entry == matrix->numNonzeros)
-        {
-          CMR_CALL( CMRreallocBlockArray(cmr, &matrix->entryColumns, 2*matrix->numNonzeros) );
-          CMR_CALL( CMRreallocBlockArray(cmr, &matrix->entryValues, 2*matrix->numNonzeros) );
-          matrix->numNonzeros *= 2;
-        }
-        matrix->entryColumns[entry] = column;
-        matrix->entryValues[entry] = 1;
-        ++entry;
-      }
-    }
-  }
-  matrix->rowSlice[numRows] = entry;
-  matrix->numNonzeros = entry;
+  CMR_CALL( CMRgenerateRandomMatrix(cmr, numRows, numColumns, probability1, &matrix) );
 
   /* Print matrix. */
   if (outputFormat == FILEFORMAT_MATRIX_DENSE)
@@ -93,6 +58,39 @@ CMR_ERROR genMatrixRandom(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Generates the matrix column by column and writes it to stdout in sparse format.
+ */
+
+static
+CMR_ERROR genMatrixRandomStream(
+  size_t numRows,         /**< Number of rows. */
+  size_t numColumns,      /**< Number of columns. */
+  double probability1,    /**< Probability for a 1-entry. */
+  uint64_t seed,          /**< Seed of the random number generators. */
+  int numThreads          /**< Number of threads. */
+)
+{
+  CMR* cmr = NULL;
+  CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+  struct timeval startTime;
+  gettimeofday(&startTime, NULL);
+  size_t numNonzeros;
+  CMR_CALL( CMRgenerateSparseStream(cmr, CMR_GENERATE_RANDOM, numRows, numColumns, probability1, seed, stdout,
+    &numNonzeros) );
+  struct timeval endTime;
+  gettimeofday(&endTime, NULL);
+  double generationTime = (endTime.tv_sec - startTime.tv_sec) + 1.0e-6 * (endTime.tv_usec - startTime.tv_usec);
+  fprintf(stderr, "Generated a %zux%zu matrix with %zu nonzeros in %f seconds.\n", numRows, numColumns, numNonzeros,
+    generationTime);
+
+  CMR_CALL( CMRfreeEnvironment(&cmr) );
+
+  return CMR_OKAY;
+}
+
 int main(int argc, char** argv)
 {
   struct timeval curTime;
@@ -102,6 +100,9 @@ int main(int argc, char** argv)
   FileFormat outputFormat = FILEFORMAT_UNDEFINED;
   size_t numRows = SIZE_MAX;
   size_t numColumns = SIZE_MAX;
+  bool stream = false;
+  uint64_t seed = curTime.tv_usec;
+  int numThreads = 1;
   double probability1 = 0.5;
   bool readProbability1 = false;
   for (int a = 1; a < argc; ++a)
@@ -111,6 +112,30 @@ int main(int argc, char** argv)
       printUsage(argv[0]);
       return EXIT_SUCCESS;
     }
+    else if (!strcmp(argv[a], "--stream"))
+      stream = true;
+    else if (!strcmp(argv[a], "--seed") && a+1 < argc)
+    {
+      char* p;
+      seed = strtoull(argv[a+1], &p, 10);
+      if (*p != '\0')
+      {
+        printf("Error: invalid seed <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      a++;
+    }
+    else if (!strcmp(argv[a], "--threads") && a+1 < argc)
+    {
+      char* p;
+      numThreads = (int) strtol(argv[a+1], &p, 10);
+      if (*p != '\0' || numThreads < 0)
+      {
+        printf("Error: invalid number of threads <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      a++;
+    }
     else if (!strcmp(argv[a], "-o") && (a+1 < argc))
     {
       if (!strcmp(argv[a+1], "dense"))
@@ -187,10 +212,20 @@ int main(int argc, char** argv)
     puts("Error: probability must be in [0,1].\n");
     return printUsage(argv[0]);
   }
+  if (stream)
+  {
+    if (outputFormat == FILEFORMAT_MATRIX_DENSE)
+    {
+      puts("Error: --stream requires sparse output.\n");
+      return printUsage(argv[0]);
+    }
+    outputFormat = FILEFORMAT_MATRIX_SPARSE;
+  }
   if (outputFormat == FILEFORMAT_UNDEFINED)
     outputFormat = FILEFORMAT_MATRIX_DENSE;
 
-  CMR_ERROR error = genMatrixRandom(numRows, numColumns, probability1, outputFormat);
+  CMR_ERROR error = stream ? genMatrixRandomStream(numRows, numColumns, probability1, seed, numThreads)
+    : genMatrixRandom(numRows, numColumns, probability1, outputFormat);
   switch (error)
   {
   case CMR_ERROR_INPUT:
@@ -199,6 +234,9 @@ int main(int argc, char** argv)
   case CMR_ERROR_MEMORY:
     puts("Memory error.");
     return EXIT_FAILURE;
+  case CMR_ERROR_OUTPUT:
+    fputs("Output error.\n", stderr);
+    return EXIT_FAILURE;
   default:
     return EXIT_SUCCESS;
   }
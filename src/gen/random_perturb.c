@@ -6,7 +6,11 @@
 #include <stdint.h>
 #include <math.h>
 
-#include <cmr/graphic.h>
+#include <float.h>
+
+#include <cmr/network.h>
+#include <cmr/regular.h>
+#include <cmr/tu.h>
 
 typedef enum
 {
@@ -61,35 +65,36 @@ int compareDblNonzeros(const void* pa, const void* pb)
   return bOrigin - aOrigin;
 }
 
-CMR_ERROR perturbMatrix(
-  const char* inputMatrixFileName,  /**< Input matrix file name. */
-  FileFormat inputFormat,           /**< Input file format. */
-  const char* outputMatrixFileName, /**< Output matrix file name. */
-  FileFormat outputFormat,          /**< Output file format. */
-  size_t makeZero,                  /**< Number of nonzeros to be turned into zeros. */
-  size_t makeOne,                   /**< Number of zeros to be turned into 1s. */
-  size_t makeMinusOne,              /**< Number of zeros to be turned into -1s. */
-  size_t flipBinary,                /**< Number of entries to be flipped over {0,1}. */
-  size_t flipTernary                /**< Number of entries to be flipped over {-1,0,1}. */
-)
+/**
+ * \brief Recognition algorithms that can be applied to each perturbed matrix.
+ */
+
+typedef enum
 {
-  /* Read the matrix. */
-  FILE* inputMatrixFile = strcmp(inputMatrixFileName, "-") ? fopen(inputMatrixFileName, "r") : stdin;
-  if (!inputMatrixFile)
-    return CMR_ERROR_INPUT;
-  
-  CMR* cmr = NULL;
-  CMR_CALL( CMRcreateEnvironment(&cmr) );
+  TEST_NONE = 0,    /**< No test. */
+  TEST_TU = 1,      /**< Test for total unimodularity. */
+  TEST_NETWORK = 2, /**< Test for being network. */
+  TEST_REGULAR = 3  /**< Test for regularity. */
+} Test;
+
+/**
+ * \brief Applies the perturbations to a copy of \p base and stores the result in \p *presult.
+ */
 
+static
+CMR_ERROR applyPerturbations(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_DBLMAT* base,     /**< Matrix to be perturbed; is not modified. */
+  size_t makeZero,      /**< Number of nonzeros to be turned into zeros. */
+  size_t makeOne,       /**< Number of zeros to be turned into 1s. */
+  size_t makeMinusOne,  /**< Number of zeros to be turned into -1s. */
+  size_t flipBinary,    /**< Number of entries to be flipped over {0,1}. */
+  size_t flipTernary,   /**< Number of entries to be flipped over {-1,0,1}. */
+  CMR_DBLMAT** presult  /**< Pointer for storing the perturbed matrix. */
+)
+{
   CMR_DBLMAT* matrix = NULL;
-  if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
-    CMR_CALL( CMRdblmatCreateFromSparseStream(cmr, inputMatrixFile, &matrix) );
-  else if (inputFormat == FILEFORMAT_MATRIX_DENSE)
-    CMR_CALL( CMRdblmatCreateFromDenseStream(cmr, inputMatrixFile, &matrix) );
-  else
-    return CMR_ERROR_INPUT;
-  if (inputMatrixFile != stdin)
-    fclose(inputMatrixFile);
+  CMR_CALL( CMRdblmatCopy(cmr, base, &matrix) );
 
   /* Make zeros. */
   size_t numNonzeros = matrix->numNonzeros;
@@ -223,19 +228,185 @@ CMR_ERROR perturbMatrix(
   result->numNonzeros = entry;
 
   CMR_CALL( CMRfreeBlockArray(cmr, &nonzeros) );
+  CMR_CALL( CMRdblmatFree(cmr, &matrix) );
+  *presult = result;
+
+  return CMR_OKAY;
+}
 
-  /* Output the matrix. */
-  FILE* outputMatrixFile = strcmp(outputMatrixFileName, "-") ? fopen(outputMatrixFileName, "w") : stdout;
+/**
+ * \brief Runs the recognition algorithm \p test on \p matrix and prints the verdict and the time to \p stream.
+ */
+
+static
+CMR_ERROR testPerturbedMatrix(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_DBLMAT* matrix,   /**< Perturbed matrix. */
+  Test test,            /**< Recognition algorithm. */
+  double timeLimit,     /**< Time limit for the recognition algorithm. */
+  size_t variant,       /**< Index of the variant. */
+  unsigned int seed,    /**< Seed of the variant. */
+  FILE* stream          /**< File stream to write the result to. */
+)
+{
+  static const char* testNames[] = { "", "tu", "network", "regular" };
+
+  /* The recognition algorithms expect a char matrix. */
+  CMR_CHRMAT* chrMatrix = NULL;
+  CMR_CALL( CMRchrmatCreate(cmr, &chrMatrix, matrix->numRows, matrix->numColumns, matrix->numNonzeros) );
+  for (size_t row = 0; row <= matrix->numRows; ++row)
+    chrMatrix->rowSlice[row] = matrix->rowSlice[row];
+  bool isChar = true;
+  for (size_t e = 0; e < matrix->numNonzeros; ++e)
+  {
+    double value = matrix->entryValues[e];
+    chrMatrix->entryColumns[e] = matrix->entryColumns[e];
+    chrMatrix->entryValues[e] = (char) value;
+    if (value != (double) chrMatrix->entryValues[e])
+      isChar = false;
+  }
+
+  const char* verdict = "nonintegral";
+  clock_t startTime = clock();
+  if (isChar)
+  {
+    bool hasProperty = false;
+    CMR_ERROR error = CMR_OKAY;
+    if (test == TEST_TU)
+      error = CMRtuTest(cmr, chrMatrix, &hasProperty, NULL, NULL, NULL, NULL, timeLimit);
+    else if (test == TEST_NETWORK)
+    {
+      error = CMRnetworkTestMatrix(cmr, chrMatrix, &hasProperty, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+        timeLimit);
+    }
+    else if (test == TEST_REGULAR)
+      error = CMRregularTest(cmr, chrMatrix, &hasProperty, NULL, NULL, NULL, NULL, timeLimit);
+
+    if (error == CMR_ERROR_TIMEOUT)
+      verdict = "timeout";
+    else
+    {
+      CMR_CALL( error );
+      verdict = hasProperty ? "yes" : "no";
+    }
+  }
+  double time = (clock() - startTime) * 1.0 / CLOCKS_PER_SEC;
+
+  fprintf(stream, "%zu,%u,%zu,%zu,%zu,%s,%s,%f\n", variant, seed, matrix->numRows, matrix->numColumns,
+    matrix->numNonzeros, testNames[test], verdict, time);
+
+  CMR_CALL( CMRchrmatFree(cmr, &chrMatrix) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Writes \p matrix to the file \p fileName, or appends it to \p outputMatrixFile if that is not \c NULL.
+ */
+
+static
+CMR_ERROR writePerturbedMatrix(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  CMR_DBLMAT* matrix,       /**< Perturbed matrix. */
+  FileFormat outputFormat,  /**< Output file format. */
+  const char* fileName,     /**< Output file name if \p outputMatrixFile is \c NULL. */
+  FILE* outputMatrixFile    /**< Output file stream for all variants (may be \c NULL). */
+)
+{
+  FILE* stream = outputMatrixFile ? outputMatrixFile : fopen(fileName, "w");
+  if (!stream)
+    return CMR_ERROR_OUTPUT;
 
   if (outputFormat == FILEFORMAT_MATRIX_DENSE)
-    CMR_CALL( CMRdblmatPrintDense(cmr, result, outputMatrixFile, '0', false) );
+    CMR_CALL( CMRdblmatPrintDense(cmr, matrix, stream, '0', false) );
   else if (outputFormat == FILEFORMAT_MATRIX_SPARSE)
-    CMR_CALL( CMRdblmatPrintSparse(cmr, result, outputMatrixFile) );
-  if (outputMatrixFile != stdout)
-    fclose(outputMatrixFile);
+    CMR_CALL( CMRdblmatPrintSparse(cmr, matrix, stream) );
+
+  if (!outputMatrixFile)
+    fclose(stream);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR perturbMatrix(
+  const char* inputMatrixFileName,  /**< Input matrix file name. */
+  FileFormat inputFormat,           /**< Input file format. */
+  const char* outputMatrixFileName, /**< Output matrix file name (may be \c NULL). */
+  FileFormat outputFormat,          /**< Output file format. */
+  size_t makeZero,                  /**< Number of nonzeros to be turned into zeros. */
+  size_t makeOne,                   /**< Number of zeros to be turned into 1s. */
+  size_t makeMinusOne,              /**< Number of zeros to be turned into -1s. */
+  size_t flipBinary,                /**< Number of entries to be flipped over {0,1}. */
+  size_t flipTernary,               /**< Number of entries to be flipped over {-1,0,1}. */
+  size_t numVariants,               /**< Number of perturbed variants. */
+  unsigned int seed,                /**< Seed of the first variant; variant \c k uses \p seed + \c k. */
+  Test test,                        /**< Recognition algorithm to run for each variant. */
+  double timeLimit                  /**< Time limit for each run of the recognition algorithm. */
+)
+{
+  /* Read the matrix. */
+  FILE* inputMatrixFile = strcmp(inputMatrixFileName, "-") ? fopen(inputMatrixFileName, "r") : stdin;
+  if (!inputMatrixFile)
+    return CMR_ERROR_INPUT;
+  
+  CMR* cmr = NULL;
+  CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_DBLMAT* matrix = NULL;
+  if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
+    CMR_CALL( CMRdblmatCreateFromSparseStream(cmr, inputMatrixFile, &matrix) );
+  else if (inputFormat == FILEFORMAT_MATRIX_DENSE)
+    CMR_CALL( CMRdblmatCreateFromDenseStream(cmr, inputMatrixFile, &matrix) );
+  else
+    return CMR_ERROR_INPUT;
+  if (inputMatrixFile != stdin)
+    fclose(inputMatrixFile);
+
+  /* Unless the name contains a '#', all variants are written one after another to the same file. */
+  const char* placeholder = outputMatrixFileName ? strchr(outputMatrixFileName, '#') : NULL;
+  FILE* outputMatrixFile = NULL;
+  if (outputMatrixFileName && !placeholder)
+  {
+    outputMatrixFile = strcmp(outputMatrixFileName, "-") ? fopen(outputMatrixFileName, "w") : stdout;
+    if (!outputMatrixFile)
+      return CMR_ERROR_OUTPUT;
+  }
+  char* variantFileName = NULL;
+  if (placeholder)
+    CMR_CALL( CMRallocBlockArray(cmr, &variantFileName, strlen(outputMatrixFileName) + 24) );
+
+  /* The results of the tests go to stderr if the matrices are written to stdout. */
+  FILE* testFile = (outputMatrixFile == stdout) ? stderr : stdout;
+  if (test != TEST_NONE)
+    fputs("variant,seed,rows,columns,nonzeros,test,verdict,time\n", testFile);
+
+  for (size_t variant = 0; variant < numVariants; ++variant)
+  {
+    srand(seed + variant);
+
+    CMR_DBLMAT* result = NULL;
+    CMR_CALL( applyPerturbations(cmr, matrix, makeZero, makeOne, makeMinusOne, flipBinary, flipTernary, &result) );
+
+    if (placeholder)
+    {
+      sprintf(variantFileName, "%.*s%zu%s", (int)(placeholder - outputMatrixFileName), outputMatrixFileName, variant,
+        placeholder + 1);
+      CMR_CALL( writePerturbedMatrix(cmr, result, outputFormat, variantFileName, NULL) );
+    }
+    else if (outputMatrixFile)
+      CMR_CALL( writePerturbedMatrix(cmr, result, outputFormat, NULL, outputMatrixFile) );
+
+    if (test != TEST_NONE)
+      CMR_CALL( testPerturbedMatrix(cmr, result, test, timeLimit, variant, seed + variant, testFile) );
+
+    CMR_CALL( CMRdblmatFree(cmr, &result) );
+  }
 
   /* Cleanup. */
-  CMR_CALL( CMRdblmatFree(cmr, &result) );
+  if (variantFileName)
+    CMR_CALL( CMRfreeBlockArray(cmr, &variantFileName) );
+  if (outputMatrixFile && outputMatrixFile != stdout)
+    fclose(outputMatrixFile);
   CMR_CALL( CMRdblmatFree(cmr, &matrix) );
 
   CMR_CALL( CMRfreeEnvironment(&cmr) );
@@ -245,7 +416,7 @@ CMR_ERROR perturbMatrix(
 
 int printUsage(const char* program)
 {
-  fprintf(stderr, "Usage: %s IN-MAT OUT-MAT [OPTION]...\n\n", program);
+  fprintf(stderr, "Usage: %s IN-MAT [OUT-MAT] [OPTION]...\n\n", program);
   fputs("Copies the matrix from file IN-MAT to the file OUT-MAT after applying perturbations.\n\n", stderr);
   fputs("Options:\n", stderr);
   fputs("  -i FORMAT Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
@@ -254,9 +425,20 @@ int printUsage(const char* program)
   fputs("  -1 NUM    Turn NUM randomly chosen zero entries into 1s.\n", stderr);
   fputs("  --1 NUM   Turn NUM randomly chosen zero entries into -1s.\n", stderr);
   fputs("  -b NUM    Flip NUM randomly chosen entries over the binary field.\n", stderr);
-  fputs("  -t NUM    Flip NUM randomly chosen entries over the ternary field.\n\n", stderr);
+  fputs("  -t NUM    Flip NUM randomly chosen entries over the ternary field.\n", stderr);
+  fputs("  -n NUM    Create NUM perturbed variants of the input matrix; default: 1.\n", stderr);
+  fputs("  -r TEST   Test each variant for being `tu', `network' or `regular' and print CSV lines with the verdicts.\n",
+    stderr);
+  fputs("  --seed SEED  Seed of the random number generator of the first variant; default: current time.\n", stderr);
+  fputs("  --time-limit LIMIT  Allow at most LIMIT seconds for each test.\n\n", stderr);
   fputs("If IN-MAT is `-' then the input matrix is read from stdin.\n", stderr);
   fputs("If OUT-MAT is `-' then the output matrix is written to stdout.\n", stderr);
+  fputs("If OUT-MAT contains a `#', then it is replaced by the index of the variant to obtain the name of its file.\n",
+    stderr);
+  fputs("Otherwise, all variants are written one after another to OUT-MAT.\n", stderr);
+  fputs("With -r, OUT-MAT can be omitted. The CSV lines are written to stdout, or to stderr if OUT-MAT is `-'.\n",
+    stderr);
+  fputs("Variant k uses the seed SEED + k.\n", stderr);
   
   return EXIT_FAILURE;
 }
@@ -265,7 +447,6 @@ int main(int argc, char** argv)
 {
   struct timeval curTime;
   gettimeofday(&curTime, NULL);
-  srand(curTime.tv_usec);
 
   char* inputMatrixFileName = NULL;
   char* outputMatrixFileName = NULL;
@@ -276,6 +457,10 @@ int main(int argc, char** argv)
   size_t makeMinusOne = 0;
   size_t flipBinary = 0;
   size_t flipTernary = 0;
+  size_t numVariants = 1;
+  unsigned int seed = curTime.tv_usec;
+  Test test = TEST_NONE;
+  double timeLimit = DBL_MAX;
   for (int a = 1; a < argc; ++a)
   {
     if (!strcmp(argv[a], "-h"))
@@ -364,6 +549,54 @@ int main(int argc, char** argv)
       }
       ++a;
     }
+    else if (!strcmp(argv[a], "-n") && (a+1 < argc))
+    {
+      char* p = NULL;
+      numVariants = strtoul(argv[a+1], &p, 10);
+      if (*p != '\0' || numVariants == 0)
+      {
+        fprintf(stderr, "Error: invalid number of variants <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "-r") && (a+1 < argc))
+    {
+      if (!strcmp(argv[a+1], "tu"))
+        test = TEST_TU;
+      else if (!strcmp(argv[a+1], "network"))
+        test = TEST_NETWORK;
+      else if (!strcmp(argv[a+1], "regular"))
+        test = TEST_REGULAR;
+      else
+      {
+        fprintf(stderr, "Error: unknown test <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--seed") && (a+1 < argc))
+    {
+      char* p = NULL;
+      seed = (unsigned int) strtoul(argv[a+1], &p, 10);
+      if (*p != '\0')
+      {
+        fprintf(stderr, "Error: invalid seed <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--time-limit") && (a+1 < argc))
+    {
+      char* p = NULL;
+      timeLimit = strtod(argv[a+1], &p);
+      if (*p != '\0' || timeLimit <= 0.0)
+      {
+        fprintf(stderr, "Error: invalid time limit <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
     else if (!inputMatrixFileName)
       inputMatrixFileName = argv[a];
     else if (!outputMatrixFileName)
@@ -381,7 +614,7 @@ int main(int argc, char** argv)
     fputs("Error: No input matrix specified.\n\n", stderr);
     return printUsage(argv[0]);
   }
-  if (!outputMatrixFileName)
+  if (!outputMatrixFileName && test == TEST_NONE)
   {
     fputs("Error: No output matrix specified.\n\n", stderr);
     return printUsage(argv[0]);
@@ -390,13 +623,16 @@ int main(int argc, char** argv)
     outputFormat = inputFormat;
 
   CMR_ERROR error = perturbMatrix(inputMatrixFileName, inputFormat, outputMatrixFileName, outputFormat, makeZero,
-    makeOne, makeMinusOne, flipBinary, flipTernary);
+    makeOne, makeMinusOne, flipBinary, flipTernary, numVariants, seed, test, timeLimit);
 
   switch (error)
   {
   case CMR_ERROR_INPUT:
     fputs("Input error.\n", stderr);
     return EXIT_FAILURE;
+  case CMR_ERROR_OUTPUT:
+    fputs("Output error.\n", stderr);
+    return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
     fputs("Memory error.\n", stderr);
     return EXIT_FAILURE;
@@ -9,20 +9,7 @@
 #include <cmr/tu.h>
 #include <cmr/series_parallel.h>
 
-static inline
-size_t randRange(size_t first, size_t beyond)
-{
-  size_t N = beyond - first;
-  size_t representatives = (RAND_MAX + 1u) / N;
-  size_t firstInvalid = N * representatives;
-  size_t x;
-  do
-  {
-    x = rand();
-  }
-  while (x >= firstInvalid);
-  return first + x / representatives;
-}
+#include "generators.h"
 
 int printUsage(const char* program)
 {
@@ -43,67 +30,6 @@ int printUsage(const char* program)
   return EXIT_FAILURE;
 }
 
-typedef struct _ListNonzero
-{
-  struct _ListNonzero* left;
-  struct _ListNonzero* right;
-  struct _ListNonzero* above;
-  struct _ListNonzero* below;
-  size_t row;
-  size_t column;
-  char value;
-} ListNonzero;
-
-static
-CMR_ERROR addNonzero(
-  CMR* cmr,
-  ListNonzero* rowHeads,
-  ListNonzero* columnHeads,
-  size_t* pnumNonzeros,
-  size_t row,
-  size_t column,
-  char value
-)
-{
-  assert(cmr);
-
-  ListNonzero* nz = NULL;
-  CMR_CALL( CMRallocBlock(cmr, &nz) );
-  nz->right = &rowHeads[row];
-  nz->left = rowHeads[row].left;
-  nz->left->right = nz;
-  nz->right->left = nz;
-  nz->below = &columnHeads[column];
-  nz->above = columnHeads[column].above;
-  nz->below->above = nz;
-  nz->above->below = nz;
-  nz->row = row;
-  nz->column = column;
-  nz->value = value;
-  (*pnumNonzeros)++;
-  
-  return CMR_OKAY;
-}
-
-typedef struct
-{
-  size_t row;
-  size_t column;
-  char value;
-} Nonzero;
-
-int compareNonzeros(const void* a, const void* b)
-{
-  Nonzero* nza = (Nonzero*) a;
-  Nonzero* nzb = (Nonzero*) b;
-  if (nza->row < nzb->row)
-    return -1;
-  else if (nza->row > nzb->row)
-    return +1;
-  else
-    return (int) nza->column - (int) nzb->column;
-}
-
 CMR_ERROR genMatrixSeriesParallel(
   size_t numBaseRows,         /**< Number of rows of base matrix. */
   size_t numBaseColumns,      /**< Number of columns of base matrix. */
@@ -130,225 +56,23 @@ CMR_ERROR genMatrixSeriesParallel(
   size_t numBenchmarkNonzeros = 0;
   for (size_t benchmark = benchmarkRepetitions ? benchmarkRepetitions : 1; benchmark > 0; --benchmark)
   {
-    size_t totalMemory = 0;
-    ListNonzero* rowHeads = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &rowHeads, numTotalRows) );
-    totalMemory += sizeof(ListNonzero) * numTotalRows;
-    ListNonzero* columnHeads = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &columnHeads, numTotalColumns) );
-    totalMemory += sizeof(ListNonzero) * numTotalColumns;
-
-    for (size_t row = 0; row < numTotalRows; ++row)
-    {
-      rowHeads[row].left = &rowHeads[row];
-      rowHeads[row].right = &rowHeads[row];
-      rowHeads[row].above = NULL;
-      rowHeads[row].below = NULL;
-      rowHeads[row].row = row;
-      rowHeads[row].column = SIZE_MAX;
-    }
-    for (size_t column = 0; column < numTotalColumns; ++column)
-    {
-      columnHeads[column].left = NULL;
-      columnHeads[column].right = NULL;
-      columnHeads[column].below = &columnHeads[column];
-      columnHeads[column].above = &columnHeads[column];
-      columnHeads[column].column = column;
-      columnHeads[column].row = SIZE_MAX;
-    }
-
-    /* Create base matrix. */
-    size_t numBaseNonzeros = 0;
-    for (size_t row = 0; row < numBaseRows; ++row)
-    {
-      for (size_t column = 0; column < numBaseColumns; ++column)
-      {
-        if ((rand() * 1.0 / RAND_MAX) > probability)
-          continue;
-
-        char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
-        CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numBaseNonzeros, row, column, sign) );
-        totalMemory += sizeof(ListNonzero);
-      }
-    }
-    size_t numTotalNonzeros = numBaseNonzeros;
-
-    /* Create a list of all operations. */
-    char* operations = NULL;
-    size_t numOperations = numZeroRows + numZeroColumns + numUnitRows + numUnitColumns + numCopiedRows + numCopiedColumns;
-    CMR_CALL( CMRallocBlockArray(cmr, &operations, numOperations) );
-    totalMemory += sizeof(char) * numOperations;
-    char* op = operations;
-    for (size_t i = 0; i < numZeroRows; ++i)
-      (*op++) = 'z';
-    for (size_t i = 0; i < numZeroColumns; ++i)
-      (*op++) = 'Z';
-    for (size_t i = 0; i < numUnitRows; ++i)
-      (*op++) = 'u';
-    for (size_t i = 0; i < numUnitColumns; ++i)
-      (*op++) = 'U';
-    for (size_t i = 0; i < numCopiedRows; ++i)
-      (*op++) = 'c';
-    for (size_t i = 0; i < numCopiedColumns; ++i)
-      (*op++) = 'C';
-    assert(op == &operations[numOperations]);
-
-    /* Shuffle operations array. */
-    for (size_t i = 0; i+1 < numOperations; ++i)
-    {
-      size_t j = randRange(i, numOperations);
-      char tmp = operations[i];
-      operations[i] = operations[j];
-      operations[j] = tmp;
-    }
-
-    /* Start applying operations. */
-    size_t numRows = numBaseRows;
-    size_t numColumns = numBaseColumns;
-    for (size_t i = 0; i < numOperations; ++i)
-    {
-      switch(operations[i])
-      {
-        case 'z':
-        {
-          ++numRows;
-          break;
-        }
-        case 'Z':
-        {
-          ++numColumns;
-          break;
-        }
-        case 'u':
-        {
-          size_t column = randRange(0, numColumns);
-          char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
-          CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numTotalNonzeros, numRows, column, sign) );
-          totalMemory += sizeof(ListNonzero);
-          ++numRows;
-          break;
-        }
-        case 'U':
-        {
-          size_t row = randRange(0, numRows);
-          char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
-          CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numTotalNonzeros, row, numColumns, sign) );
-          totalMemory += sizeof(ListNonzero);
-          ++numColumns;
-          break;
-        }
-        case 'c':
-        {
-          size_t row = randRange(0, numRows);
-          char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
-          for (ListNonzero* nz = rowHeads[row].right; nz->column != SIZE_MAX; nz = nz->right)
-          {
-            CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numTotalNonzeros, numRows, nz->column, sign * nz->value) );
-            totalMemory += sizeof(ListNonzero);
-          }
-          ++numRows;
-          break;
-        }
-        case 'C':
-        {
-          size_t column = randRange(0, numColumns);
-          char sign = (ternary && (rand() * 1.0 / RAND_MAX >= 0.5)) ? -1 : 1;
-          for (ListNonzero* nz = columnHeads[column].below; nz->row != SIZE_MAX; nz = nz->below)
-          {
-            CMR_CALL( addNonzero(cmr, rowHeads, columnHeads, &numTotalNonzeros, nz->row, numColumns, sign * nz->value) );
-            totalMemory += sizeof(ListNonzero);
-          }
-          ++numColumns;
-          break;
-        }
-      }
-    }
-
-    /* Create permutations. */
-    size_t* rowPermutation = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &rowPermutation, numTotalRows) );
-    totalMemory += sizeof(size_t) * numTotalRows;
-    for (size_t row = 0; row < numTotalRows; ++row)
-      rowPermutation[row] = row;
-    size_t* columnPermutation = NULL;
-    CMR_CALL( CMRallocBlockArray(cmr, &columnPermutation, numTotalColumns) );
-    totalMemory += sizeof(size_t) * numTotalColumns;
-    for (size_t column = 0; column < numTotalColumns; ++column)
-      columnPermutation[column] = column;
-    if (randomize)
-    {
-      for (size_t row = 0; row < numTotalRows; ++row)
-      {
-        size_t r = randRange(row, numTotalRows);
-        size_t tmp = rowPermutation[row];
-        rowPermutation[row] = rowPermutation[r];
-        rowPermutation[r] = tmp;
-      }
-      for (size_t column = 0; column < numTotalColumns; ++column)
-      {
-        size_t c = randRange(column, numTotalColumns);
-        size_t tmp = columnPermutation[column];
-        columnPermutation[column] = columnPermutation[c];
-        columnPermutation[c] = tmp;
-      }
-    }
-
-    fprintf(stderr, "Generated a %zux%zu matrix with %zu nonzeros.\n", numTotalRows, numTotalColumns, numTotalNonzeros);
+    CMR_CHRMAT* matrix = NULL;
+    size_t numBaseNonzeros;
+    CMR_CALL( CMRgenerateSeriesParallelMatrix(cmr, numBaseRows, numBaseColumns, numZeroRows, numZeroColumns,
+      numUnitRows, numUnitColumns, numCopiedRows, numCopiedColumns, ternary, probability, randomize, &matrix,
+      &numBaseNonzeros) );
+
+    fprintf(stderr, "Generated a %zux%zu matrix with %zu nonzeros.\n", numTotalRows, numTotalColumns,
+      matrix->numNonzeros);
     fprintf(stderr, "It contains a %zux%zu base matrix with %zu nonzeros, 1-entries generated with probability %g.\n",
       numBaseRows, numBaseColumns, numBaseNonzeros, probability);
     fprintf(stderr, "Series-parallel operations: %zux%zu zero, %zux%zu unit, %zux%zu copied\n", numZeroRows,
       numZeroColumns, numUnitRows, numUnitColumns, numCopiedRows, numCopiedColumns);
     if (randomize)
       fputs("Random row and column permutations were applied.\n", stderr);
-    fprintf(stderr, "Amount of memory used: %.2g GB.\n", totalMemory / (1024.0*1024.0*1024.0));
-
-    CMR_CALL( CMRfreeBlockArray(cmr, &operations) );
 
     if (benchmarkRepetitions)
     {
-      /* Create array of all nonzeros. */
-      
-      Nonzero* nzs = NULL;
-      CMR_CALL( CMRallocBlockArray(cmr, &nzs, numTotalNonzeros) );
-      size_t* numRowNonzeros = NULL;
-      CMR_CALL( CMRallocBlockArray(cmr, &numRowNonzeros, numRows) );
-      for (size_t row = 0; row < numTotalRows; ++row)
-        numRowNonzeros[row] = 0;
-      size_t i = 0;
-      for (size_t row = 0; row < numTotalRows; ++row)
-      {
-        for (ListNonzero* nz = rowHeads[row].right; nz->column != SIZE_MAX; nz = nz->right)
-        {
-          nzs[i].row = rowPermutation[nz->row];
-          nzs[i].column = columnPermutation[nz->column];
-          nzs[i].value = nz->value;
-          numRowNonzeros[nzs[i].row]++;
-          ++i;
-        }
-      }
-
-      qsort(nzs, numTotalNonzeros, sizeof(Nonzero), compareNonzeros);
-
-      /* Create matrix. */
-
-      CMR_CHRMAT* matrix = NULL;
-      CMR_CALL( CMRchrmatCreate(cmr, &matrix, numTotalRows, numTotalColumns, numTotalNonzeros) );
-
-      size_t row = 0;
-      for (size_t i = 0; i < numTotalNonzeros; ++i)
-      {
-        while (row <= nzs[i].row)
-          matrix->rowSlice[row++] = i;
-
-        matrix->entryColumns[i] = nzs[i].column;
-        matrix->entryValues[i] = nzs[i].value;
-      }
-      while (row <= matrix->numRows)
-        matrix->rowSlice[row++] = matrix->numNonzeros;
-
-      CMR_CALL( CMRfreeBlockArray(cmr, &numRowNonzeros) );
-      CMR_CALL( CMRfreeBlockArray(cmr, &nzs) );
-
       CMR_SP_REDUCTION* reductions = NULL;
       CMR_CALL( CMRallocBlockArray(cmr, &reductions, matrix->numRows + matrix->numColumns) );
       size_t numReductions;
@@ -366,42 +90,21 @@ CMR_ERROR genMatrixSeriesParallel(
         CMR_CALL( CMRtestBinarySeriesParallel(cmr, matrix, NULL, reductions, &numReductions, NULL, &wheelMatrix,
           &stats, DBL_MAX) );
       }
-      numBenchmarkNonzeros += numTotalNonzeros;
+      numBenchmarkNonzeros += matrix->numNonzeros;
 
       CMR_CALL( CMRsubmatFree(cmr, &wheelMatrix) );
       CMR_CALL( CMRfreeBlockArray(cmr, &reductions) );
-      CMR_CALL( CMRchrmatFree(cmr, &matrix) );
     }
     else
     {
       /* Print matrix. */
 
-      printf("%zu %zu %zu\n\n", numTotalRows, numTotalColumns, numTotalNonzeros);
-      for (size_t row = 0; row < numTotalRows; ++row)
-      {
-        for (ListNonzero* nz = rowHeads[row].right; nz->column != SIZE_MAX; nz = nz->right)
-        {
-          printf("%zu %zu %d\n", rowPermutation[nz->row]+1, columnPermutation[nz->column]+1, nz->value);
-        }
-      }
+      CMR_CALL( CMRchrmatPrintSparse(cmr, matrix, stdout) );
     }
 
     /* Cleanup. */
 
-    CMR_CALL( CMRfreeBlockArray(cmr, &columnPermutation) );
-    CMR_CALL( CMRfreeBlockArray(cmr, &rowPermutation) );
-    for (size_t row = 0; row < numTotalRows; ++row)
-    {
-      for (ListNonzero* nz = rowHeads[row].right; nz != &rowHeads[row]; )
-      {
-        ListNonzero* current = nz;
-        nz = nz->right;
-        CMR_CALL( CMRfreeBlock(cmr, &current) );
-      }
-    }
-
-    CMR_CALL( CMRfreeBlockArray(cmr, &columnHeads) );
-    CMR_CALL( CMRfreeBlockArray(cmr, &rowHeads) );
+    CMR_CALL( CMRchrmatFree(cmr, &matrix) );
   }
 
   if (benchmarkRepetitions > 0)
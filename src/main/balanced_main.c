@@ -11,6 +11,7 @@ typedef enum
 {
   FILEFORMAT_MATRIX_DENSE = 1,    /**< Dense matrix format. */
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3,   /**< Binary matrix format. */
 } FileFormat;
 
 /**
@@ -23,13 +24,17 @@ CMR_ERROR testBalanced(
   FileFormat inputFormat,               /**< Format of the input matrix. */
   const char* outputSubmatrixFileName,  /**< File name of output file for non-balanced submatrix. */
   bool printStats,                      /**< Whether to print statistics to stderr. */
+  const char* statsJsonFileName,        /**< File name to write statistics in JSON format to, or \c NULL. */
   CMR_BALANCED_ALGORITHM algorithm,     /**< Algorithm to use. */
   bool seriesParallel,                  /**< Whether to carry out series-parallel reductions. */
-  double timeLimit                      /**< Time limit to impose. */
+  bool totallyBalanced,                 /**< Whether to test for total balancedness instead. */
+  double timeLimit,                     /**< Time limit to impose. */
+  int numThreads                        /**< Number of threads to use. */
 )
 {
   CMR* cmr = NULL;
   CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
 
   /* Read matrix. */
 
@@ -40,6 +45,8 @@ CMR_ERROR testBalanced(
     error = CMRchrmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRchrmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRchrmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -64,18 +71,41 @@ CMR_ERROR testBalanced(
   CMR_BALANCED_STATS stats;
   CMR_CALL( CMRbalancedStatsInit(&stats));
 
-  CMR_CALL( CMRbalancedTest(cmr, matrix, &isBalanced, &submatrix, &params, &stats, timeLimit) );
+  if (totallyBalanced)
+    CMR_CALL( CMRtotallyBalancedTest(cmr, matrix, &isBalanced, NULL, NULL, &submatrix, &stats, timeLimit) );
+  else
+    CMR_CALL( CMRbalancedTest(cmr, matrix, &isBalanced, &submatrix, &params, &stats, timeLimit) );
   
-  printf("Matrix %sbalanced.\n", isBalanced ? "IS " : "IS NOT ");
+  printf("Matrix %s%sbalanced.\n", isBalanced ? "IS " : "IS NOT ", totallyBalanced ? "totally " : "");
 
   if (printStats)
+  {
     CMR_CALL( CMRbalancedStatsPrint(stderr, &stats, NULL) );
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRbalancedStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
   if (submatrix && outputSubmatrixFileName)
   {
     bool outputSubmatrixToFile = strcmp(outputSubmatrixFileName, "-");
-    fprintf(stderr, "Writing minimal non-balanced submatrix to %s%s%s.\n", outputSubmatrixToFile ? "file <" : "",
-      outputSubmatrixToFile ? outputSubmatrixFileName : "stdout", outputSubmatrixToFile ? ">" : "");
+    fprintf(stderr, "Writing %s to %s%s%s.\n",
+      totallyBalanced ? "Gamma submatrix of doubly lexical ordering" : "minimal non-balanced submatrix",
+      outputSubmatrixToFile ? "file <" : "", outputSubmatrixToFile ? outputSubmatrixFileName : "stdout",
+      outputSubmatrixToFile ? ">" : "");
 
     CMR_CALL( CMRsubmatWriteToFile(cmr, submatrix, matrix->numRows, matrix->numColumns, outputSubmatrixFileName) );
   }
@@ -100,13 +130,17 @@ int printUsage(const char* program)
   fprintf(stderr, "%s IN-MAT [OPTION]...\n\n", program);
   fputs("  determines whether the matrix given in file IN-MAT is balanced.\n\n", stderr);
   fputs("Options:\n", stderr);
-  fputs("  -i FORMAT  Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT  Format of file IN-MAT, among `dense', `sparse' and `binary'; default: dense.\n", stderr);
   fputs("  -N NON-SUB Write a minimal non-balanced submatrix to file NON-SUB; default: skip computation.\n", stderr);
   fputs("  -s         Print statistics about the computation to stderr.\n\n", stderr);
   fputs("Advanced options:\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format; `-' for stdout.\n", stderr);
   fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n", stderr);
   fputs("  --algorithm ALGO     Algorithm to use, among `submatrix` and `graph`; default: choose best.\n", stderr);
-  fputs("  --no-series-parallel Do not try series-parallel operations for preprocessing.\n\n", stderr);
+  fputs("  --no-series-parallel Do not try series-parallel operations for preprocessing.\n", stderr);
+  fputs("  --totally            Test a binary matrix for being totally balanced instead; NON-SUB is then a 2-by-2\n"
+    "                       submatrix Gamma of a doubly lexical ordering.\n", stderr);
+  fputs("  --threads NUM        Use NUM threads, where 0 means all available processors; default: 1.\n\n", stderr);
   fputs("If IN-MAT is `-' then the matrix is read from stdin.\n", stderr);
   fputs("If NON-SUB is `-' then the submatrix is written to stdout.\n", stderr);
 
@@ -119,9 +153,12 @@ int main(int argc, char** argv)
   FileFormat inputFormat = FILEFORMAT_MATRIX_DENSE;
   char* outputSubmatrix = NULL;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
   CMR_BALANCED_ALGORITHM algorithm = CMR_BALANCED_ALGORITHM_AUTO;
   double timeLimit = DBL_MAX;
   bool seriesParallel = true;
+  bool totallyBalanced = false;
+  int numThreads = 1;
   for (int a = 1; a < argc; ++a)
   {
     if (!strcmp(argv[a], "-h"))
@@ -135,6 +172,8 @@ int main(int argc, char** argv)
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         fprintf(stderr, "Error: unknown input file format <%s>.\n\n", argv[a+1]);
@@ -146,8 +185,12 @@ int main(int argc, char** argv)
       outputSubmatrix = argv[++a];
     else if (!strcmp(argv[a], "-s"))
       printStats = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
     else if (!strcmp(argv[a], "--no-series-parallel"))
       seriesParallel = false;
+    else if (!strcmp(argv[a], "--totally"))
+      totallyBalanced = true;
     else if (!strcmp(argv[a], "--algorithm") && a+1 < argc)
     {
       if (!strcmp(argv[a+1], "submatrix"))
@@ -161,6 +204,15 @@ int main(int argc, char** argv)
       }
       ++a;
     }
+    else if (!strcmp(argv[a], "--threads") && (a+1 < argc))
+    {
+      if (sscanf(argv[a+1], "%d", &numThreads) == 0 || numThreads < 0)
+      {
+        fprintf(stderr, "Error: Invalid number of threads <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
     else if (!strcmp(argv[a], "--time-limit") && (a+1 < argc))
     {
       if (sscanf(argv[a+1], "%lf", &timeLimit) == 0 || timeLimit <= 0)
@@ -186,12 +238,13 @@ int main(int argc, char** argv)
   }
 
   CMR_ERROR error;
-  error = testBalanced(inputMatrixFileName, inputFormat, outputSubmatrix, printStats, algorithm, seriesParallel,
-    timeLimit);
+  error = testBalanced(inputMatrixFileName, inputFormat, outputSubmatrix, printStats, statsJsonFileName, algorithm,
+    seriesParallel, totallyBalanced, timeLimit, numThreads);
 
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     /* The actual function will have reported the details. */
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
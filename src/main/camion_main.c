@@ -19,6 +19,7 @@ typedef enum
   FILEFORMAT_UNDEFINED = 0,       /**< Whether the file format of input/output was defined by the user. */
   FILEFORMAT_MATRIX_DENSE = 1,    /**< Dense matrix format. */
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3,   /**< Binary matrix format. */
 } FileFormat;
 
 /**
@@ -31,6 +32,7 @@ CMR_ERROR checkCamionSigned(
   FileFormat inputFormat,               /**< Format of the input matrix. */
   const char* outputSubmatrixFileName,  /**< File name of output file for non-Camion submatrix. */
   bool printStats,                      /**< Whether to print statistics to stderr. */
+  const char* statsJsonFileName,        /**< File name to write statistics in JSON format to, or \c NULL. */
   double timeLimit                      /**< Time limit to impose. */
 )
 {
@@ -45,6 +47,8 @@ CMR_ERROR checkCamionSigned(
     error = CMRchrmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRchrmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRchrmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -68,7 +72,25 @@ CMR_ERROR checkCamionSigned(
 
   fprintf(stderr, "Matrix %sCamion-signed.\n", isCamion ? "IS " : "IS NOT ");
   if (printStats)
+  {
     CMR_CALL( CMRcamionStatsPrint(stderr, &stats, NULL) );
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRcamionStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
   if (submatrix)
   {
@@ -104,6 +126,7 @@ CMR_ERROR computeCamionSigned(
   const char* outputMatrixFileName, /**< File name of output file for Camion-signed matrix. */
   FileFormat outputFormat,          /**< Format of the output matrix. */
   bool printStats,                  /**< Whether to print statistics to stderr. */
+  const char* statsJsonFileName,    /**< File name to write statistics in JSON format to, or \c NULL. */
   double timeLimit                  /**< Time limit to impose. */
 )
 {
@@ -119,6 +142,8 @@ CMR_ERROR computeCamionSigned(
     error = CMRchrmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRchrmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRchrmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -138,7 +163,25 @@ CMR_ERROR computeCamionSigned(
   CMR_CALL( CMRcamionStatsInit(&stats) );
   CMR_CALL( CMRcamionComputeSigns(cmr, matrix, NULL, NULL, &stats, timeLimit) );
   if (printStats)
+  {
     CMR_CALL( CMRcamionStatsPrint(stderr, &stats, NULL) );
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRcamionStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
   /* Write to file. */
 
@@ -184,9 +227,10 @@ int printUsage(const char* program)
   fputs("  -o FORMAT    Format of file OUT-MAT, among `dense' and `sparse'; default: same as format of IN-MAT.\n\n",
     stderr);
   fputs("Common options:\n", stderr);
-  fputs("  -i FORMAT    Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT    Format of file IN-MAT, among `dense', `sparse' and `binary'; default: dense.\n", stderr);
   fputs("  -s           Print statistics about the computation to stderr.\n\n", stderr);
   fputs("Advanced options:\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format; `-' for stdout.\n", stderr);
   fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n\n", stderr);
   fputs("If IN-MAT is `-' then the matrix is read from stdin.\n", stderr);
   fputs("If NON-SUB or OUT-MAT is `-' then the submatrix (resp. the Camion-signed matrix) is written to stdout.\n",
@@ -204,6 +248,7 @@ int main(int argc, char** argv)
   char* outputSubmatrixFileName = NULL;
   char* outputMatrixFileName = NULL;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
   double timeLimit = DBL_MAX;
   for (int a = 1; a < argc; ++a)
   {
@@ -221,12 +266,16 @@ int main(int argc, char** argv)
     }
     else if (!strcmp(argv[a], "-s"))
       printStats = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
     else if (!strcmp(argv[a], "-i") && a+1 < argc)
     {
       if (!strcmp(argv[a+1], "dense"))
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         fprintf(stderr, "Error: Unknown input file format <%s>.\n\n", argv[a+1]);
@@ -277,17 +326,18 @@ int main(int argc, char** argv)
   }
 
   if (outputFormat == FILEFORMAT_UNDEFINED)
-    outputFormat = inputFormat;
+    outputFormat = (inputFormat == FILEFORMAT_MATRIX_BINARY) ? FILEFORMAT_MATRIX_SPARSE : inputFormat;
   
   CMR_ERROR error;
   if (task == TASK_CHECK)
   {
-    error = checkCamionSigned(inputMatrixFileName, inputFormat, outputSubmatrixFileName, printStats, timeLimit);
+    error = checkCamionSigned(inputMatrixFileName, inputFormat, outputSubmatrixFileName, printStats, statsJsonFileName,
+      timeLimit);
   }
   else if (task == TASK_SIGN)
   {
     error = computeCamionSigned(inputMatrixFileName, inputFormat, outputMatrixFileName, outputFormat, printStats,
-      timeLimit);
+      statsJsonFileName, timeLimit);
   }
   else
     assert(false);
@@ -295,6 +345,7 @@ int main(int argc, char** argv)
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     /* The actual function will have reported the details. */
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
@@ -0,0 +1,110 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "checkpoint_file.h"
+
+#include <assert.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static CMR* interruptedEnvironment = NULL; /**< Environment that is interrupted by \c SIGINT and \c SIGTERM. */
+
+/**
+ * \brief Signal handler that interrupts the computations in \ref interruptedEnvironment.
+ */
+
+static
+void interruptOnSignal(
+  int signalNumber  /**< Number of the signal. */
+)
+{
+  (void) signalNumber;
+
+  if (interruptedEnvironment)
+    CMRinterrupt(interruptedEnvironment);
+}
+
+CMR_ERROR CMRcheckpointFileLoad(CMR* cmr, const char* fileName, CMR_REGULAR_CHECKPOINT** pcheckpoint)
+{
+  assert(cmr);
+  assert(fileName);
+  assert(pcheckpoint);
+
+  CMR_CALL( CMRregularCheckpointCreate(cmr, pcheckpoint) );
+
+  FILE* stream = fopen(fileName, "rb");
+  if (stream)
+  {
+    CMR_ERROR error = CMRregularCheckpointRead(cmr, *pcheckpoint, stream);
+    fclose(stream);
+    if (error)
+    {
+      fprintf(stderr, "Input error in checkpoint file <%s>: %s\n", fileName, CMRgetErrorMessage(cmr));
+      CMR_CALL( CMRregularCheckpointFree(cmr, pcheckpoint) );
+      return error;
+    }
+    fprintf(stderr, "Resuming from checkpoint file <%s> with %zu pending decomposition nodes.\n", fileName,
+      CMRregularCheckpointNumPending(*pcheckpoint));
+  }
+
+  interruptedEnvironment = cmr;
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = interruptOnSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRcheckpointFileStore(CMR* cmr, const char* fileName, CMR_REGULAR_CHECKPOINT** pcheckpoint)
+{
+  assert(cmr);
+  assert(fileName);
+  assert(pcheckpoint);
+  assert(*pcheckpoint);
+
+  signal(SIGINT, SIG_DFL);
+  signal(SIGTERM, SIG_DFL);
+  interruptedEnvironment = NULL;
+
+  CMR_ERROR error = CMR_OKAY;
+  size_t numPending = CMRregularCheckpointNumPending(*pcheckpoint);
+  if (numPending == 0)
+    remove(fileName);
+  else
+  {
+    /* Write to a temporary file first such that a job that is killed while writing keeps the previous checkpoint. */
+    size_t length = strlen(fileName);
+    char* temporaryPath = malloc(length + 32);
+    if (!temporaryPath)
+      return CMR_ERROR_MEMORY;
+    snprintf(temporaryPath, length + 32, "%s.tmp.%ld", fileName, (long) getpid());
+    FILE* stream = fopen(temporaryPath, "wb");
+    if (stream)
+    {
+      error = CMRregularCheckpointWrite(cmr, *pcheckpoint, stream);
+      if (fclose(stream) && !error)
+        error = CMR_ERROR_OUTPUT;
+      if (!error && rename(temporaryPath, fileName))
+        error = CMR_ERROR_OUTPUT;
+    }
+    else
+      error = CMR_ERROR_OUTPUT;
+
+    if (error)
+    {
+      fprintf(stderr, "Error: Cannot write checkpoint file <%s>.\n", fileName);
+      remove(temporaryPath);
+    }
+    else
+      fprintf(stderr, "Wrote checkpoint file <%s> with %zu pending decomposition nodes.\n", fileName, numPending);
+    free(temporaryPath);
+  }
+
+  CMR_CALL( CMRregularCheckpointFree(cmr, pcheckpoint) );
+
+  return error;
+}
@@ -0,0 +1,47 @@
+#ifndef CMR_CHECKPOINT_FILE_H
+#define CMR_CHECKPOINT_FILE_H
+
+/**
+ * \file checkpoint_file.h
+ *
+ * \brief Checkpoint files that let the recognition executables continue regularity tests that ran out of time.
+ *
+ * A checkpoint file is read before the test if it exists. It is replaced atomically by the state of a test that is
+ * stopped due to the time limit or due to \c SIGINT or \c SIGTERM, and it is removed once the test completes.
+ */
+
+#include <cmr/regular.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Creates a checkpoint and loads the file \p fileName into it if that exists.
+ *
+ * Also makes \c SIGINT and \c SIGTERM interrupt the computations in \p cmr.
+ */
+
+CMR_ERROR CMRcheckpointFileLoad(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  const char* fileName,                 /**< Name of the checkpoint file. */
+  CMR_REGULAR_CHECKPOINT** pcheckpoint  /**< Pointer for storing the checkpoint. */
+);
+
+/**
+ * \brief Writes a non-empty checkpoint to the file \p fileName, or removes that file if \p checkpoint is empty.
+ *
+ * Restores the default handling of \c SIGINT and \c SIGTERM and frees the checkpoint.
+ */
+
+CMR_ERROR CMRcheckpointFileStore(
+  CMR* cmr,                             /**< \ref CMR environment. */
+  const char* fileName,                 /**< Name of the checkpoint file. */
+  CMR_REGULAR_CHECKPOINT** pcheckpoint  /**< Pointer to the checkpoint. */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_CHECKPOINT_FILE_H */
@@ -19,6 +19,7 @@ typedef enum
   FILEFORMAT_UNDEFINED = 0,
   FILEFORMAT_MATRIX_DENSE = 1,    /**< Dense matrix format. */
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3,   /**< Binary matrix format. */
 } FileFormat;
 
 /**
@@ -33,7 +34,9 @@ CMR_ERROR testComplementTotalUnimodularity(
   char* outputOperationsFileName,   /**< File name for the operations; may be `-' for stdout. */
   char* outputMatrixFileName,       /**< File name for the matrix; may be `-' for stdout. */
   bool printStats,                  /**< Whether to print statistics to stderr. */
-  double timeLimit                  /**< Time limit to impose. */
+  const char* statsJsonFileName,    /**< File name to write statistics in JSON format to, or \c NULL. */
+  double timeLimit,                 /**< Time limit to impose. */
+  int numThreads                    /**< Number of threads to use. */
 )
 {
   clock_t readClock = clock();
@@ -43,6 +46,7 @@ CMR_ERROR testComplementTotalUnimodularity(
 
   CMR* cmr = NULL;
   CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
 
   /* Read matrix. */
 
@@ -51,6 +55,8 @@ CMR_ERROR testComplementTotalUnimodularity(
     CMR_CALL( CMRchrmatCreateFromDenseStream(cmr, inputMatrixFile, &matrix) );
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     CMR_CALL( CMRchrmatCreateFromSparseStream(cmr, inputMatrixFile, &matrix) );
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    CMR_CALL( CMRchrmatCreateFromBinaryStream(cmr, inputMatrixFile, &matrix) );
   if (inputMatrixFile != stdin)
     fclose(inputMatrixFile);
   fprintf(stderr, "Read %zux%zu matrix with %zu nonzeros in %f seconds.\n", matrix->numRows, matrix->numColumns,
@@ -70,6 +76,19 @@ CMR_ERROR testComplementTotalUnimodularity(
   fprintf(stderr, "Matrix %scomplement totally unimodular.\n", isCTU ? "IS " : "IS NOT ");
   if (printStats)
     CMR_CALL( CMRstatsComplementTotalUnimodularityPrint(stderr, &stats, NULL) );
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRstatsComplementTotalUnimodularityPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
   if (complementRow < SIZE_MAX || complementColumn < SIZE_MAX)
   {
@@ -147,6 +166,8 @@ CMR_ERROR complementMatrix(
     CMR_CALL( CMRchrmatCreateFromDenseStream(cmr, inputMatrixFile, &matrix) );
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     CMR_CALL( CMRchrmatCreateFromSparseStream(cmr, inputMatrixFile, &matrix) );
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    CMR_CALL( CMRchrmatCreateFromBinaryStream(cmr, inputMatrixFile, &matrix) );
   if (inputMatrixFile != stdin)
     fclose(inputMatrixFile);
   fprintf(stderr, "Read %zux%zu matrix with %zu nonzeros.\n", matrix->numRows, matrix->numColumns,
@@ -201,11 +222,13 @@ int printUsage(const char* program)
   fputs("  -r ROW    Apply row complement operation to row ROW.\n", stderr);
   fputs("  -c COLUMN Apply column complement operation to column COLUMN.\n", stderr);
   fputs("Common options:\n", stderr);
-  fputs("  -i FORMAT   Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT   Format of file IN-MAT, among `dense', `sparse' and `binary'; default: dense.\n", stderr);
   fputs("  -o FORMAT   Format of file OUT-MAT, among `dense' and `sparse'; default: same as for IN-MAT.\n", stderr);
   fputs("  -s          Print statistics about the computation to stderr.\n\n", stderr);
   fputs("Advanced options:\n", stderr);
-  fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format; `-' for stdout.\n", stderr);
+  fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n", stderr);
+  fputs("  --threads NUM        Use NUM threads, where 0 means all available processors; default: 1.\n\n", stderr);
   fputs("If IN-MAT is `-' then the matrix is read from stdin.\n", stderr);
   fputs("If OUT-OPS or OUT-MAT is `-` then the list of operations (resp. the matrix) is written to stdout.\n", stderr);
 
@@ -223,7 +246,9 @@ int main(int argc, char** argv)
   char* outputMatrixFileName = NULL;
   char* outputOperationsFileName = NULL;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
   double timeLimit = DBL_MAX;
+  int numThreads = 1;
   for (int a = 1; a < argc; ++a)
   {
     if (!strcmp(argv[a], "-h"))
@@ -268,12 +293,16 @@ int main(int argc, char** argv)
     }
     else if (!strcmp(argv[a], "-s"))
       printStats = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
     else if (!strcmp(argv[a], "-i") && a+1 < argc)
     {
       if (!strcmp(argv[a+1], "dense"))
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         fprintf(stderr, "Error: Unknown input file format <%s>.\n\n", argv[a+1]);
@@ -294,6 +323,15 @@ int main(int argc, char** argv)
       }
       ++a;
     }
+    else if (!strcmp(argv[a], "--threads") && (a+1 < argc))
+    {
+      if (sscanf(argv[a+1], "%d", &numThreads) == 0 || numThreads < 0)
+      {
+        fprintf(stderr, "Error: Invalid number of threads <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
     else if (!strcmp(argv[a], "--time-limit") && (a+1 < argc))
     {
       if (sscanf(argv[a+1], "%lf", &timeLimit) == 0 || timeLimit <= 0)
@@ -327,13 +365,13 @@ int main(int argc, char** argv)
   }
 
   if (outputFormat == FILEFORMAT_UNDEFINED)
-    outputFormat = inputFormat;
+    outputFormat = (inputFormat == FILEFORMAT_MATRIX_BINARY) ? FILEFORMAT_MATRIX_SPARSE : inputFormat;
 
   CMR_ERROR error;
   if (task == TASK_RECOGNIZE)
   {
     error = testComplementTotalUnimodularity(inputMatrixFileName, inputFormat, outputFormat, outputOperationsFileName,
-      outputMatrixFileName, printStats, timeLimit);
+      outputMatrixFileName, printStats, statsJsonFileName, timeLimit, numThreads);
   }
   else
   {
@@ -345,6 +383,7 @@ int main(int argc, char** argv)
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     puts("Input error.");
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
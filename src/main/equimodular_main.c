@@ -15,6 +15,7 @@ typedef enum
   FILEFORMAT_UNDEFINED = 0,       /**< Whether the file format of input/output was defined by the user. */
   FILEFORMAT_MATRIX_DENSE = 1,    /**< Dense matrix format. */
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3,   /**< Binary matrix format. */
 } FileFormat;
 
 /**
@@ -29,13 +30,16 @@ CMR_ERROR testEquimodularity(
   bool strong,                      /**< Whether to test for strong equimodularity. */
   bool unimodular,                  /**< Whether to only test for unimodularity. */
   bool printStats,                  /**< Whether to print statistics to stderr. */
-  double timeLimit                  /**< Time limit to impose. */
+  const char* statsJsonFileName,    /**< File name to write statistics in JSON format to, or \c NULL. */
+  double timeLimit,                 /**< Time limit to impose. */
+  size_t memoryLimit                /**< Memory limit in bytes, or 0 for none. */
 )
 {
   assert(!transpose || !strong);
 
   CMR* cmr = NULL;
   CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetMemoryLimit(cmr, memoryLimit) );
 
   /* Read matrix. */
 
@@ -46,6 +50,8 @@ CMR_ERROR testEquimodularity(
     error = CMRintmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRintmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRintmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -139,7 +145,25 @@ CMR_ERROR testEquimodularity(
   }
 
   if (printStats)
+  {
     CMR_CALL( CMRequimodularStatsPrint(stderr, &stats, "") );
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRequimodularStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
   /* Cleanup. */
 
@@ -161,13 +185,15 @@ int printUsage(const char* program)
   fprintf(stderr, "%s IN-MAT [OPTION]...\n\n", program);
   fputs("  determines whether the matrix given in file IN-MAT is (strongly) equimodular for determinant gcd k.\n\n", stderr);
   fputs("Options:\n", stderr);
-  fputs("  -i FORMAT  Format of input FILE; default: `dense'.\n", stderr);
+  fputs("  -i FORMAT  Format of input FILE, among `dense', `sparse' and `binary'; default: `dense'.\n", stderr);
   fputs("  -t         Test the transpose matrix instead.\n", stderr);
   fputs("  -s         Test for strong equimodularity.\n", stderr);
   fputs("  -u         Test only for unimodularity, i.e., k = 1.\n", stderr);
   fputs("Advanced options:\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format; `-' for stdout.\n", stderr);
   fputs("  --stats              Print statistics about the computation to stderr.\n\n", stderr);
   fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n", stderr);
+  fputs("  --memory-limit MB    Allow at most MB megabytes of memory for the computation.\n", stderr);
   fputs("Formats for matrices: dense, sparse\n", stderr);
   fputs("If FILE is `-', then the input will be read from stdin.\n", stderr);
 
@@ -181,8 +207,10 @@ int main(int argc, char** argv)
   bool strong = false;
   bool unimodular = false;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
   char* instanceFileName = NULL;
   double timeLimit = DBL_MAX;
+  size_t memoryLimit = 0;
   for (int a = 1; a < argc; ++a)
   {
     if (!strcmp(argv[a], "-h"))
@@ -198,12 +226,16 @@ int main(int argc, char** argv)
       unimodular = true;
     else if (!strcmp(argv[a], "--stats"))
       printStats = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
     else if (!strcmp(argv[a], "-i") && a+1 < argc)
     {
       if (!strcmp(argv[a+1], "dense"))
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         printf("Error: unknown input file format <%s>.\n\n", argv[a+1]);
@@ -220,6 +252,17 @@ int main(int argc, char** argv)
       }
       ++a;
     }
+    else if (!strcmp(argv[a], "--memory-limit") && (a+1 < argc))
+    {
+      double megabytes;
+      if (sscanf(argv[a+1], "%lf", &megabytes) == 0 || megabytes <= 0)
+      {
+        fprintf(stderr, "Error: Invalid memory limit <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      memoryLimit = (size_t) (megabytes * 1024 * 1024);
+      ++a;
+    }
     else if (!instanceFileName)
       instanceFileName = argv[a];
     else
@@ -244,11 +287,13 @@ int main(int argc, char** argv)
     inputFormat = FILEFORMAT_MATRIX_DENSE;
 
   CMR_ERROR error;
-  error = testEquimodularity(instanceFileName, inputFormat, transpose, strong, unimodular, printStats, timeLimit);
+  error = testEquimodularity(instanceFileName, inputFormat, transpose, strong, unimodular, printStats, statsJsonFileName,
+    timeLimit, memoryLimit);
 
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     puts("Input error.");
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
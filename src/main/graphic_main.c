@@ -20,9 +20,145 @@ typedef enum
 {
   FILEFORMAT_UNDEFINED = 0,     /**< Whether the file format of input/output was defined by the user. */
   FILEFORMAT_MATRIX_DENSE = 1,  /**< Dense matrix format. */
-  FILEFORMAT_MATRIX_SPARSE = 2  /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_SPARSE = 2, /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3  /**< Binary matrix format. */
 } FileFormat;
 
+/**
+ * \brief Writes the graph of a (co)graphic matrix as an edge list and as a dot file.
+ */
+
+static
+CMR_ERROR writeGraph(
+  const char* outputGraphFileName,  /**< File name of the output graph (may be NULL; may be `-' for stdout). */
+  const char* outputDotFileName,    /**< File name of the output dot file (may be NULL; may be `-' for stdout). */
+  bool cographic,                   /**< Whether the graph belongs to the cographic matrix. */
+  CMR_GRAPH* graph,                 /**< Graph. */
+  size_t numRows,                   /**< Number of rows of the matrix. */
+  CMR_GRAPH_EDGE* rowEdges,         /**< Edges of the rows. */
+  size_t numColumns,                /**< Number of columns of the matrix. */
+  CMR_GRAPH_EDGE* columnEdges,      /**< Edges of the columns. */
+  bool* edgesReversed               /**< Whether each edge is reversed (may be \c NULL). */
+)
+{
+  if (outputGraphFileName)
+  {
+    bool outputGraphToFile = strcmp(outputGraphFileName, "-");
+    FILE* outputGraphFile = outputGraphToFile ? fopen(outputGraphFileName, "w") : stdout;
+    fprintf(stderr, "Writing %sgraph to %s%s%s.\n", cographic ? "co" : "", outputGraphToFile ? "file <" : "",
+      outputGraphToFile ? outputGraphFileName : "stdout", outputGraphToFile ? ">" : "");
+
+    if (cographic)
+    {
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        CMR_GRAPH_EDGE e = columnEdges[column];
+        CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
+        CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
+        if (edgesReversed && edgesReversed[e])
+        {
+          CMR_GRAPH_NODE temp = u;
+          u = v;
+          v = temp;
+        }
+        fprintf(outputGraphFile, "%d %d c%zu\n", u, v, column+1);
+      }
+      for (size_t row = 0; row < numRows; ++row)
+      {
+        CMR_GRAPH_EDGE e = rowEdges[row];
+        CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
+        CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
+        if (edgesReversed && edgesReversed[e])
+        {
+          CMR_GRAPH_NODE temp = u;
+          u = v;
+          v = temp;
+        }
+        fprintf(outputGraphFile, "%d %d r%zu\n", u, v, row+1);
+      }
+    }
+    else
+    {
+      for (size_t row = 0; row < numRows; ++row)
+      {
+        CMR_GRAPH_EDGE e = rowEdges[row];
+        CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
+        CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
+        if (edgesReversed && edgesReversed[e])
+        {
+          CMR_GRAPH_NODE temp = u;
+          u = v;
+          v = temp;
+        }
+        fprintf(outputGraphFile, "%d %d r%zu\n", u, v, row+1);
+      }
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        CMR_GRAPH_EDGE e = columnEdges[column];
+        CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
+        CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
+        if (edgesReversed && edgesReversed[e])
+        {
+          CMR_GRAPH_NODE temp = u;
+          u = v;
+          v = temp;
+        }
+        fprintf(outputGraphFile, "%d %d c%zu\n", u, v, column+1);
+      }
+    }
+
+    if (outputGraphToFile)
+      fclose(outputGraphFile);
+  }
+
+  if (outputDotFileName)
+  {
+    bool outputDotToFile = strcmp(outputDotFileName, "-");
+    FILE* outputDotFile = outputDotToFile ? fopen(outputDotFileName, "w") : stdout;
+    fprintf(stderr, "Writing %sgraph to %s%s%s.\n", cographic ? "co" : "", outputDotToFile ? "file <" : "",
+      outputDotToFile ? outputDotFileName : "stdout", outputDotToFile ? ">" : "");
+
+    char buffer[16];
+    fputs("graph G {\n", outputDotFile);
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      CMR_GRAPH_EDGE e = rowEdges[row];
+      CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
+      CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
+      if (edgesReversed && edgesReversed[e])
+      {
+        CMR_GRAPH_NODE temp = u;
+        u = v;
+        v = temp;
+      }
+      const char* style = cographic ? "" : ",style=bold,color=red";
+      fprintf(outputDotFile, " v_%d -- v_%d [label=\"%s\"%s];\n", u, v,
+        CMRelementString(CMRrowToElement(row), buffer), style);
+    }
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      CMR_GRAPH_EDGE e = columnEdges[column];
+      CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
+      CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
+      if (edgesReversed && edgesReversed[e])
+      {
+        CMR_GRAPH_NODE temp = u;
+        u = v;
+        v = temp;
+      }
+      const char* style = cographic ? ",style=bold,color=red" : "";
+      fprintf(outputDotFile, " v_%d -- v_%d [label=\"%s\"%s];\n", u, v,
+        CMRelementString(CMRcolumnToElement(column), buffer), style);
+    }
+    fputs("}\n", outputDotFile);
+
+    if (outputDotToFile)
+      fclose(outputDotFile);
+  }
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Converts matrix from a file to a graph if the former is (co)graphic.
  */
@@ -38,6 +174,8 @@ CMR_ERROR recognizeGraphic(
   const char* outputSubmatrixFileName,  /**< File name of the output non-(co)graphic submatrix (may be NULL; may be `-'
                                          **  for stdout). */
   bool printStats,                      /**< Whether to print statistics to stderr. */
+  const char* statsJsonFileName,        /**< File name to write statistics in JSON format to, or \c NULL. */
+  CMR_GRAPHIC_ORDER order,              /**< Order in which the columns (resp. rows) are processed. */
   double timeLimit                      /**< Time limit to impose. */
 )
 {
@@ -53,6 +191,8 @@ CMR_ERROR recognizeGraphic(
     error = CMRchrmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRchrmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRchrmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -98,91 +238,42 @@ CMR_ERROR recognizeGraphic(
   CMR_CALL( CMRgraphicStatsInit(&stats) );
   if (cographic)
   {
-    CMR_CALL( CMRgraphicTestTranspose(cmr, matrix, &isCoGraphic, &graph, &columnEdges, &rowEdges,
+    CMR_CALL( CMRgraphicTestTransposeOrdered(cmr, matrix, order, &isCoGraphic, &graph, &columnEdges, &rowEdges,
       outputSubmatrixFileName ? &submatrix : NULL, &stats, timeLimit) );
   }
   else
   {
-    CMR_CALL( CMRgraphicTestMatrix(cmr, matrix, &isCoGraphic, &graph, &rowEdges, &columnEdges,
+    CMR_CALL( CMRgraphicTestMatrixOrdered(cmr, matrix, order, &isCoGraphic, &graph, &rowEdges, &columnEdges,
       outputSubmatrixFileName ? &submatrix : NULL, &stats, timeLimit) );
   }
 
   fprintf(stderr, "Matrix %s%sgraphic.\n", isCoGraphic ? "IS " : "is NOT ", cographic ? "co" : "");
   if (printStats)
+  {
     CMR_CALL( CMRgraphicStatsPrint(stderr, &stats, NULL) );
-
-  if (isCoGraphic)
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
   {
-    if (outputGraphFileName)
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
     {
-      bool outputGraphToFile = strcmp(outputGraphFileName, "-");
-      FILE* outputGraphFile = outputGraphToFile ? fopen(outputGraphFileName, "w") : stdout;
-      fprintf(stderr, "Writing %sgraph to %s%s%s.\n", cographic ? "co" : "", outputGraphToFile ? "file <" : "",
-        outputGraphToFile ? outputGraphFileName : "stdout", outputGraphToFile ? ">" : "");
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRgraphicStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
-      if (cographic)
-      {
-        for (size_t column = 0; column < matrix->numColumns; ++column)
-        {
-          CMR_GRAPH_EDGE e = columnEdges[column];
-          CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
-          CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
-          if (edgesReversed && edgesReversed[e])
-          {
-            CMR_GRAPH_NODE temp = u;
-            u = v;
-            v = temp;
-          }
-          fprintf(outputGraphFile, "%d %d c%zu\n", u, v, column+1);
-        }
-        for (size_t row = 0; row < matrix->numRows; ++row)
-        {
-          CMR_GRAPH_EDGE e = rowEdges[row];
-          CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
-          CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
-          if (edgesReversed && edgesReversed[e])
-          {
-            CMR_GRAPH_NODE temp = u;
-            u = v;
-            v = temp;
-          }
-          fprintf(outputGraphFile, "%d %d r%zu\n", u, v, row+1);
-        }
-      }
-      else
-      {
-        for (size_t row = 0; row < matrix->numRows; ++row)
-        {
-          CMR_GRAPH_EDGE e = rowEdges[row];
-          CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
-          CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
-          if (edgesReversed && edgesReversed[e])
-          {
-            CMR_GRAPH_NODE temp = u;
-            u = v;
-            v = temp;
-          }
-          fprintf(outputGraphFile, "%d %d r%zu\n", u, v, row+1);
-        }
-        for (size_t column = 0; column < matrix->numColumns; ++column)
-        {
-          CMR_GRAPH_EDGE e = columnEdges[column];
-          CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
-          CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
-          if (edgesReversed && edgesReversed[e])
-          {
-            CMR_GRAPH_NODE temp = u;
-            u = v;
-            v = temp;
-          }
-          fprintf(outputGraphFile, "%d %d c%zu\n", u, v, column+1);
-        }
-      }
+  if (isCoGraphic)
+  {
+    CMR_CALL( writeGraph(outputGraphFileName, outputDotFileName, cographic, graph, matrix->numRows, rowEdges,
+      matrix->numColumns, columnEdges, edgesReversed) );
 
-      if (outputGraphToFile)
-        fclose(outputGraphFile);
-    }
-    
     if (outputTreeFileName)
     {
       // TODO: implement
@@ -190,51 +281,6 @@ CMR_ERROR recognizeGraphic(
       exit(EXIT_FAILURE);
     }
 
-    if (outputDotFileName)
-    {
-      bool outputDotToFile = strcmp(outputDotFileName, "-");
-      FILE* outputDotFile = outputDotToFile ? fopen(outputDotFileName, "w") : stdout;
-      fprintf(stderr, "Writing %sgraph to %s%s%s.\n", cographic ? "co" : "", outputDotToFile ? "file <" : "",
-        outputDotToFile ? outputDotFileName : "stdout", outputDotToFile ? ">" : "");
-
-      char buffer[16];
-      fputs("graph G {\n", outputDotFile);
-      for (size_t row = 0; row < matrix->numRows; ++row)
-      {
-        CMR_GRAPH_EDGE e = rowEdges[row];
-        CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
-        CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
-        if (edgesReversed && edgesReversed[e])
-        {
-          CMR_GRAPH_NODE temp = u;
-          u = v;
-          v = temp;
-        }
-        const char* style = cographic ? "" : ",style=bold,color=red";
-        fprintf(outputDotFile, " v_%d -- v_%d [label=\"%s\"%s];\n", u, v,
-          CMRelementString(CMRrowToElement(row), buffer), style);
-      }
-      for (size_t column = 0; column < matrix->numColumns; ++column)
-      {
-        CMR_GRAPH_EDGE e = columnEdges[column];
-        CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
-        CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
-        if (edgesReversed && edgesReversed[e])
-        {
-          CMR_GRAPH_NODE temp = u;
-          u = v;
-          v = temp;
-        }
-        const char* style = cographic ? ",style=bold,color=red" : "";
-        fprintf(outputDotFile, " v_%d -- v_%d [label=\"%s\"%s];\n", u, v,
-          CMRelementString(CMRcolumnToElement(column), buffer), style);
-      }
-      fputs("}\n", outputDotFile);
-
-      if (outputDotToFile)
-        fclose(outputDotFile);
-    }
-
     if (edgesReversed)
       CMR_CALL( CMRfreeBlockArray(cmr, &edgesReversed) );
     CMR_CALL( CMRfreeBlockArray(cmr, &rowEdges) );
@@ -262,6 +308,187 @@ CMR_ERROR recognizeGraphic(
   return CMR_OKAY;
 }
 
+/**
+ * \brief State of the streaming graphicness test.
+ */
+
+typedef struct
+{
+  CMR_GRAPHIC_ONLINE* online; /**< \brief Online graphicness structure of the columns read so far. */
+  bool isGraphic;             /**< \brief Whether the columns read so far form a graphic matrix. */
+  bool isBinary;              /**< \brief Whether all entries read so far are binary. */
+  size_t numRows;             /**< \brief Number of rows of the matrix. */
+  size_t numColumns;          /**< \brief Number of columns of the matrix. */
+  size_t numNonzeros;         /**< \brief Number of nonzeros read so far. */
+  size_t violatingRow;        /**< \brief Row of a non-binary entry. */
+  size_t violatingColumn;     /**< \brief Column that violates binarity or graphicness. */
+  char violatingValue;        /**< \brief Value of a non-binary entry. */
+  clock_t startClock;         /**< \brief Time at which reading started. */
+  double timeLimit;           /**< \brief Time limit to impose. */
+} GraphicStream;
+
+/**
+ * \brief Creates the online graphicness structure when the dimensions of the streamed matrix are known.
+ */
+
+static
+CMR_ERROR graphicStreamHeader(
+  CMR* cmr,           /**< \ref CMR environment. */
+  size_t numRows,     /**< Number of rows of the matrix. */
+  size_t numColumns,  /**< Number of columns of the matrix. */
+  size_t numNonzeros, /**< Number of nonzeros of the matrix. */
+  void* data,         /**< Pointer to the \ref GraphicStream. */
+  bool* pstop         /**< Pointer for storing whether to stop. */
+)
+{
+  CMR_UNUSED(numNonzeros);
+  CMR_UNUSED(pstop);
+
+  GraphicStream* stream = (GraphicStream*) data;
+  stream->numRows = numRows;
+  stream->numColumns = numColumns;
+  CMR_CALL( CMRgraphicOnlineCreate(cmr, &stream->online, numRows) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Appends a streamed column to the online graphicness structure, stopping at the first violation.
+ */
+
+static
+CMR_ERROR graphicStreamColumn(
+  CMR* cmr,           /**< \ref CMR environment. */
+  size_t column,      /**< Column. */
+  size_t numEntries,  /**< Number of nonzeros of the column. */
+  size_t* rows,       /**< Rows of the nonzeros. */
+  char* values,       /**< Values of the nonzeros. */
+  void* data,         /**< Pointer to the \ref GraphicStream. */
+  bool* pstop         /**< Pointer for storing whether to stop. */
+)
+{
+  CMR_UNUSED(cmr);
+
+  GraphicStream* stream = (GraphicStream*) data;
+  if ((clock() - stream->startClock) * 1.0 / CLOCKS_PER_SEC > stream->timeLimit)
+    return CMR_ERROR_TIMEOUT;
+
+  for (size_t e = 0; e < numEntries; ++e)
+  {
+    if (values[e] != 1)
+    {
+      stream->isBinary = false;
+      stream->violatingRow = rows[e];
+      stream->violatingColumn = column;
+      stream->violatingValue = values[e];
+      *pstop = true;
+      return CMR_OKAY;
+    }
+  }
+
+  CMR_CALL( CMRgraphicOnlineTryColumn(stream->online, numEntries, rows, &stream->isGraphic) );
+  if (!stream->isGraphic)
+  {
+    stream->violatingColumn = column;
+    *pstop = true;
+    return CMR_OKAY;
+  }
+  CMR_CALL( CMRgraphicOnlineAddColumn(stream->online, numEntries, rows) );
+  stream->numNonzeros += numEntries;
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Tests the column-sorted sparse matrix from a file for graphicness without storing it.
+ */
+
+CMR_ERROR recognizeGraphicStream(
+  const char* inputMatrixFileName,  /**< File name of the input matrix (may be `-' for stdin). */
+  const char* outputGraphFileName,  /**< File name of the output graph (may be NULL; may be `-' for stdout). */
+  const char* outputDotFileName,    /**< File name of the output dot file (may be NULL; may be `-' for stdout). */
+  bool printStats,                  /**< Whether to print statistics to stderr. */
+  double timeLimit,                 /**< Time limit to impose. */
+  int numThreads                    /**< Number of threads to use. */
+)
+{
+  CMR* cmr = NULL;
+  CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+  GraphicStream stream;
+  stream.online = NULL;
+  stream.isGraphic = true;
+  stream.isBinary = true;
+  stream.numRows = 0;
+  stream.numColumns = 0;
+  stream.numNonzeros = 0;
+  stream.startClock = clock();
+  stream.timeLimit = timeLimit;
+
+  CMR_ERROR error = CMRchrmatStreamSparseColumns(cmr, inputMatrixFileName, "-", graphicStreamHeader,
+    graphicStreamColumn, &stream);
+  if (error == CMR_ERROR_INPUT)
+  {
+    fprintf(stderr, "Input error: %s\n", CMRgetErrorMessage(cmr));
+    CMR_CALL( CMRgraphicOnlineFree(cmr, &stream.online) );
+    CMR_CALL( CMRfreeEnvironment(&cmr) );
+    return CMR_ERROR_INPUT;
+  }
+  else if (error == CMR_ERROR_TIMEOUT)
+  {
+    fprintf(stderr, "Time limit exceeded after %zu columns.\n", CMRgraphicOnlineNumColumns(stream.online));
+    CMR_CALL( CMRgraphicOnlineFree(cmr, &stream.online) );
+    CMR_CALL( CMRfreeEnvironment(&cmr) );
+    return CMR_ERROR_TIMEOUT;
+  }
+  CMR_CALL( error );
+
+  fprintf(stderr, "Streamed %zux%zu matrix, processing %zu columns with %zu nonzeros in %f seconds.\n",
+    stream.numRows, stream.numColumns, CMRgraphicOnlineNumColumns(stream.online), stream.numNonzeros,
+    (clock() - stream.startClock) * 1.0 / CLOCKS_PER_SEC);
+
+  if (!stream.isBinary)
+  {
+    fprintf(stderr, "Matrix is NOT graphic since it is not binary: entry at row %zu, column %zu is %d.\n",
+      stream.violatingRow + 1, stream.violatingColumn + 1, stream.violatingValue);
+  }
+  else if (!stream.isGraphic)
+  {
+    fprintf(stderr, "Matrix is NOT graphic since the submatrix of columns 1 to %zu is not graphic.\n",
+      stream.violatingColumn + 1);
+  }
+  else
+  {
+    fputs("Matrix IS graphic.\n", stderr);
+
+    if (outputGraphFileName || outputDotFileName)
+    {
+      CMR_GRAPH* graph = NULL;
+      CMR_GRAPH_EDGE* rowEdges = NULL;
+      CMR_GRAPH_EDGE* columnEdges = NULL;
+      CMR_CALL( CMRgraphicOnlineComputeGraph(stream.online, &graph, &rowEdges, &columnEdges) );
+      CMR_CALL( writeGraph(outputGraphFileName, outputDotFileName, false, graph, stream.numRows, rowEdges,
+        stream.numColumns, columnEdges, NULL) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &rowEdges) );
+      CMR_CALL( CMRfreeBlockArray(cmr, &columnEdges) );
+      CMR_CALL( CMRgraphFree(cmr, &graph) );
+    }
+  }
+
+  if (printStats)
+  {
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+
+  CMR_CALL( CMRgraphicOnlineFree(cmr, &stream.online) );
+  CMR_CALL( CMRfreeEnvironment(&cmr) );
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Converts the given graph file to the corresponding (co)graphic matrix.
  */
@@ -381,9 +608,9 @@ CMR_ERROR computeGraphic(
 
   CMR_CALL( CMRchrmatFree(cmr, &matrix) );
 
-  free(coforestEdges);
-  free(forestEdges);
-  free(edgeElements);
+  CMR_CALL( CMRfreeBlockArray(cmr, &coforestEdges) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &forestEdges) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &edgeElements) );
   CMR_CALL( CMRgraphFree(cmr, &graph) );
 
   CMR_CALL( CMRfreeEnvironment(&cmr) );
@@ -406,12 +633,17 @@ int printUsage(const char* program)
   fputs("  (2) computes a (co)graphic matrix corresponding to the graph from file IN-GRAPH and writes it to OUT-MAT.\n\n\n",
     stderr);
   fputs("Options specific to (1):\n", stderr);
-  fputs("  -i FORMAT    Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT    Format of file IN-MAT, among `dense', `sparse' and `binary'; default: dense.\n", stderr);
   fputs("  -t           Test for being cographic; default: test for being graphic.\n", stderr);
   fputs("  -G OUT-GRAPH Write a graph to file OUT-GRAPH; default: skip computation.\n", stderr);
   fputs("  -T OUT-TREE  Write a spanning tree to file OUT-TREE; default: skip computation.\n", stderr);
   fputs("  -D OUT-DOT   Write a dot file OUT-DOT with the graph and the spanning tree; default: skip computation.\n", stderr);
-  fputs("  -N NON-SUB   Write a minimal non-(co)graphic submatrix to file NON-SUB; default: skip computation.\n\n", stderr);
+  fputs("  -N NON-SUB   Write a minimal non-(co)graphic submatrix to file NON-SUB; default: skip computation.\n", stderr);
+  fputs("  --stream     Test graphicness while reading the sparse IN-MAT, whose nonzeros must be sorted by column, without\n", stderr);
+  fputs("               storing the matrix; not available for -t and -N.\n", stderr);
+  fputs("  --order ORD  Order in which the columns (rows for -t) are processed, among `input', `connected', which\n", stderr);
+  fputs("               starts at the densest column and adds columns sharing rows with earlier ones, and `reject', which\n", stderr);
+  fputs("               next adds a column with most nonzeros in covered rows to find violations early; default: input.\n\n", stderr);
   fputs("Options specific to (2):\n", stderr);
   fputs("  -o FORMAT    Format of file OUT-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
   fputs("  -t           Return the transpose of the graphic matrix.\n", stderr);
@@ -419,7 +651,9 @@ int printUsage(const char* program)
   fputs("Common options:\n", stderr);
   fputs("  -s           Print statistics about the computation to stderr.\n\n", stderr);
   fputs("Advanced options:\n", stderr);
-  fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format; `-' for stdout.\n", stderr);
+  fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n", stderr);
+  fputs("  --threads NUM        Use NUM threads, where 0 means all available processors; default: 1.\n\n", stderr);
   fputs("If IN-MAT, IN-GRAPH or IN-TREE is `-' then the matrix (resp. the graph or tree) is read from stdin.\n", stderr);
   fputs("If OUT-GRAPH, OUT-TREE, OUT-DOT or NON-SUB is `-' then the graph (resp. the tree, dot file or non-(co)graphic submatrix) is written to stdout.\n",
     stderr);
@@ -434,6 +668,7 @@ int main(int argc, char** argv)
   FileFormat outputFormat = FILEFORMAT_UNDEFINED;
   bool transposed = false;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
   char* inputFileName = NULL;
   char* treeFileName = NULL;
   char* outputFileName = NULL;
@@ -441,6 +676,9 @@ int main(int argc, char** argv)
   char* outputDotFileName = NULL;
   char* outputSubmatrixFileName = NULL;
   double timeLimit = DBL_MAX;
+  bool stream = false;
+  CMR_GRAPHIC_ORDER order = CMR_GRAPHIC_ORDER_INPUT;
+  int numThreads = 1;
   for (int a = 1; a < argc; ++a)
   {
     if (!strcmp(argv[a], "-h"))
@@ -454,12 +692,33 @@ int main(int argc, char** argv)
       transposed = true;
     else if (!strcmp(argv[a], "-s"))
       printStats = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
+    else if (!strcmp(argv[a], "--order") && a+1 < argc)
+    {
+      if (!strcmp(argv[a+1], "input"))
+        order = CMR_GRAPHIC_ORDER_INPUT;
+      else if (!strcmp(argv[a+1], "connected"))
+        order = CMR_GRAPHIC_ORDER_CONNECTED;
+      else if (!strcmp(argv[a+1], "reject"))
+        order = CMR_GRAPHIC_ORDER_REJECT;
+      else
+      {
+        fprintf(stderr, "Error: Unknown order <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--stream"))
+      stream = true;
     else if (!strcmp(argv[a], "-i") && a+1 < argc)
     {
       if (!strcmp(argv[a+1], "dense"))
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         fprintf(stderr, "Error: Unknown input file format <%s>.\n\n", argv[a+1]);
@@ -488,6 +747,15 @@ int main(int argc, char** argv)
       outputDotFileName = argv[++a];
     else if (!strcmp(argv[a], "-N") && a+1 < argc)
       outputSubmatrixFileName = argv[++a];
+    else if (!strcmp(argv[a], "--threads") && (a+1 < argc))
+    {
+      if (sscanf(argv[a+1], "%d", &numThreads) == 0 || numThreads < 0)
+      {
+        fprintf(stderr, "Error: Invalid number of threads <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
     else if (!strcmp(argv[a], "--time-limit") && (a+1 < argc))
     {
       if (sscanf(argv[a+1], "%lf", &timeLimit) == 0 || timeLimit <= 0)
@@ -532,8 +800,26 @@ int main(int argc, char** argv)
     if (inputFormat == FILEFORMAT_UNDEFINED)
       inputFormat = FILEFORMAT_MATRIX_DENSE;
 
-    error = recognizeGraphic(inputFileName, inputFormat, transposed, outputGraphFileName, treeFileName,
-      outputDotFileName, outputSubmatrixFileName, printStats, timeLimit);
+    if (stream)
+    {
+      if (inputFormat != FILEFORMAT_MATRIX_SPARSE)
+      {
+        fputs("Error: Option --stream requires -i sparse.\n\n", stderr);
+        return printUsage(argv[0]);
+      }
+      if (transposed || treeFileName || outputSubmatrixFileName || statsJsonFileName)
+      {
+        fputs("Error: Option --stream is invalid together with -t, -T, -N or --stats-json.\n\n", stderr);
+        return printUsage(argv[0]);
+      }
+      error = recognizeGraphicStream(inputFileName, outputGraphFileName, outputDotFileName, printStats, timeLimit,
+        numThreads);
+    }
+    else
+    {
+      error = recognizeGraphic(inputFileName, inputFormat, transposed, outputGraphFileName, treeFileName,
+        outputDotFileName, outputSubmatrixFileName, printStats, statsJsonFileName, order, timeLimit);
+    }
   }
   else if (task == TASK_COMPUTE)
   {
@@ -566,6 +852,11 @@ int main(int argc, char** argv)
         "Error: Option -N is invalid for computation.\n\n");
       return printUsage(argv[0]);
     }
+    if (stream)
+    {
+      fputs("Error: Option --stream is invalid for computation.\n\n", stderr);
+      return printUsage(argv[0]);
+    }
     if (outputFormat == FILEFORMAT_UNDEFINED)
       outputFormat = FILEFORMAT_MATRIX_DENSE;
 
@@ -579,6 +870,7 @@ int main(int argc, char** argv)
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     /* The actual function will have reported the details. */
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
@@ -18,6 +18,7 @@ typedef enum
 {
   FILEFORMAT_MATRIX_DENSE = 1,    /**< Dense matrix format. */
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3,   /**< Binary matrix format. */
 } FileFormat;
 
 static
@@ -44,6 +45,8 @@ CMR_ERROR recognize(
     CMR_CALL( CMRdblmatCreateFromDenseStream(cmr, inputMatrixFile, &matrix) );
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     CMR_CALL( CMRdblmatCreateFromSparseStream(cmr, inputMatrixFile, &matrix) );
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    CMR_CALL( CMRdblmatCreateFromBinaryStream(cmr, inputMatrixFile, &matrix) );
   if (inputMatrixFile != stdin)
     fclose(inputMatrixFile);
   fprintf(stderr, "Read %zux%zu matrix with %zu nonzeros in %f seconds.\n", matrix->numRows, matrix->numColumns,
@@ -115,6 +118,8 @@ CMR_ERROR findLargeSubmatrix(
     CMR_CALL( CMRdblmatCreateFromDenseStream(cmr, inputMatrixFile, &matrix) );
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     CMR_CALL( CMRdblmatCreateFromSparseStream(cmr, inputMatrixFile, &matrix) );
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    CMR_CALL( CMRdblmatCreateFromBinaryStream(cmr, inputMatrixFile, &matrix) );
   if (inputMatrixFile != stdin)
     fclose(inputMatrixFile);
   fprintf(stderr, "Read %zux%zu matrix with %zu nonzeros in %f seconds.\n", matrix->numRows, matrix->numColumns,
@@ -161,7 +166,7 @@ int printUsage(const char* program)
   fputs("  -b         Find a large binary submatrix, i.e., one with only entries in {0,+1}.\n", stderr);
   fputs("  -t         Find a large ternary submatrix, i.e., one with only entries in {-1,0,+1}.\n\n", stderr);
   fputs("Common options:\n", stderr);
-  fputs("  -i FORMAT    Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT    Format of file IN-MAT, among `dense', `sparse' and `binary'; default: dense.\n", stderr);
   fputs("  -s           Print statistics about the computation to stderr.\n", stderr);
   fputs("  -e EPSILON   Allows rounding of numbers up to tolerance EPSILON; default: 1.0e-9.\n\n", stderr);
   fputs("Advanced options:\n", stderr);
@@ -202,6 +207,8 @@ int main(int argc, char** argv)
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         fprintf(stderr, "Error: Unknown input file format <%s>.\n\n", argv[a+1]);
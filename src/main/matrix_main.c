@@ -17,7 +17,11 @@ typedef enum
 {
   FILEFORMAT_UNDEFINED = 0,     /**< Whether the file format of input/output was defined by the user. */
   FILEFORMAT_MATRIX_DENSE = 1,  /**< Dense matrix format. */
-  FILEFORMAT_MATRIX_SPARSE = 2  /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_SPARSE = 2, /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3, /**< Binary matrix format. */
+  FILEFORMAT_MODEL_MPS = 4,     /**< Constraint matrix of a model in MPS format. */
+  FILEFORMAT_MODEL_LP = 5,      /**< Constraint matrix of a model in LP format. */
+  FILEFORMAT_MATRIX_CONTAINER = 6 /**< Matrix container format. */
 } FileFormat;
 
 static
@@ -33,13 +37,16 @@ CMR_ERROR writeToFileDbl(CMR* cmr, CMR_DBLMAT* matrix, FileFormat outputFormat,
     output = matrix;
 
   bool outputMatrixToFile = strcmp(outputMatrixFileName, "-");
-  FILE* outputMatrixFile = outputMatrixToFile ? fopen(outputMatrixFileName, "w") : stdout;
+  FILE* outputMatrixFile = outputMatrixToFile ? fopen(outputMatrixFileName,
+    outputFormat == FILEFORMAT_MATRIX_BINARY ? "wb" : "w") : stdout;
 
   CMR_ERROR error = CMR_OKAY;
   if (outputFormat == FILEFORMAT_MATRIX_SPARSE)
     CMR_CALL( CMRdblmatPrintSparse(cmr, output, outputMatrixFile) );
   else if (outputFormat == FILEFORMAT_MATRIX_DENSE)
     CMR_CALL( CMRdblmatPrintDense(cmr, output, outputMatrixFile, '0', false) );
+  else if (outputFormat == FILEFORMAT_MATRIX_BINARY)
+    CMR_CALL( CMRdblmatPrintBinary(cmr, output, outputMatrixFile) );
   else
     error = CMR_ERROR_INPUT;
 
@@ -65,13 +72,16 @@ CMR_ERROR writeToFileInt(CMR* cmr, CMR_INTMAT* matrix, FileFormat outputFormat,
     output = matrix;
 
   bool outputMatrixToFile = strcmp(outputMatrixFileName, "-");
-  FILE* outputMatrixFile = outputMatrixToFile ? fopen(outputMatrixFileName, "w") : stdout;
+  FILE* outputMatrixFile = outputMatrixToFile ? fopen(outputMatrixFileName,
+    outputFormat == FILEFORMAT_MATRIX_BINARY ? "wb" : "w") : stdout;
 
   CMR_ERROR error = CMR_OKAY;
   if (outputFormat == FILEFORMAT_MATRIX_SPARSE)
     CMR_CALL( CMRintmatPrintSparse(cmr, output, outputMatrixFile) );
   else if (outputFormat == FILEFORMAT_MATRIX_DENSE)
     CMR_CALL( CMRintmatPrintDense(cmr, output, outputMatrixFile, '0', false) );
+  else if (outputFormat == FILEFORMAT_MATRIX_BINARY)
+    CMR_CALL( CMRintmatPrintBinary(cmr, output, outputMatrixFile) );
   else
     error = CMR_ERROR_INPUT;
 
@@ -97,13 +107,16 @@ CMR_ERROR writeToFileChr(CMR* cmr, CMR_CHRMAT* matrix, FileFormat outputFormat,
     output = matrix;
 
   bool outputMatrixToFile = strcmp(outputMatrixFileName, "-");
-  FILE* outputMatrixFile = outputMatrixToFile ? fopen(outputMatrixFileName, "w") : stdout;
+  FILE* outputMatrixFile = outputMatrixToFile ? fopen(outputMatrixFileName,
+    outputFormat == FILEFORMAT_MATRIX_BINARY ? "wb" : "w") : stdout;
 
   CMR_ERROR error = CMR_OKAY;
   if (outputFormat == FILEFORMAT_MATRIX_SPARSE)
     CMR_CALL( CMRchrmatPrintSparse(cmr, output, outputMatrixFile) );
   else if (outputFormat == FILEFORMAT_MATRIX_DENSE)
     CMR_CALL( CMRchrmatPrintDense(cmr, output, outputMatrixFile, '0', false) );
+  else if (outputFormat == FILEFORMAT_MATRIX_BINARY)
+    CMR_CALL( CMRchrmatPrintBinary(cmr, output, outputMatrixFile) );
   else
     error = CMR_ERROR_INPUT;
 
@@ -123,7 +136,8 @@ CMR_ERROR runDbl(
   FileFormat outputFormat,
   const char* outputMatrixFileName,
   Task task,
-  bool transpose
+  bool transpose,
+  CMR_MODEL_PARAMS* modelParams
 )
 {
   FILE* inputMatrixFile = strcmp(inputMatrixFileName, "-") ? fopen(inputMatrixFileName, "r") : stdin;
@@ -138,6 +152,15 @@ CMR_ERROR runDbl(
     CMR_CALL( CMRdblmatCreateFromSparseStream(cmr, inputMatrixFile, &matrix) );
   else if (inputFormat == FILEFORMAT_MATRIX_DENSE)
     CMR_CALL( CMRdblmatCreateFromDenseStream(cmr, inputMatrixFile, &matrix) );
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    CMR_CALL( CMRdblmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix) );
+  else if (inputFormat == FILEFORMAT_MODEL_MPS || inputFormat == FILEFORMAT_MODEL_LP)
+  {
+    CMR_ERROR error = CMRdblmatCreateFromModelFile(cmr, inputMatrixFileName, "-", modelParams, &matrix);
+    if (error == CMR_ERROR_INPUT)
+      fprintf(stderr, "Error when reading model from <%s>: %s\n", inputMatrixFileName, CMRgetErrorMessage(cmr));
+    CMR_CALL( error );
+  }
   else
     return CMR_ERROR_INPUT;
   if (inputMatrixFile != stdin)
@@ -217,7 +240,8 @@ CMR_ERROR runInt(
   FileFormat outputFormat,
   const char* outputMatrixFileName,
   Task task,
-  bool transpose
+  bool transpose,
+  CMR_MODEL_PARAMS* modelParams
 )
 {
   FILE* inputMatrixFile = strcmp(inputMatrixFileName, "-") ? fopen(inputMatrixFileName, "r") : stdin;
@@ -241,6 +265,18 @@ CMR_ERROR runInt(
     if (error == CMR_ERROR_INPUT)
       fprintf(stderr, "Error when reading sparse matrix from <%s>: %s\n", inputMatrixFileName, CMRgetErrorMessage(cmr));
   }
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+  {
+    error = CMRintmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
+    if (error == CMR_ERROR_INPUT)
+      fprintf(stderr, "Error when reading binary matrix from <%s>: %s\n", inputMatrixFileName, CMRgetErrorMessage(cmr));
+  }
+  else if (inputFormat == FILEFORMAT_MODEL_MPS || inputFormat == FILEFORMAT_MODEL_LP)
+  {
+    error = CMRintmatCreateFromModelFile(cmr, inputMatrixFileName, "-", modelParams, &matrix);
+    if (error == CMR_ERROR_INPUT)
+      fprintf(stderr, "Error when reading model from <%s>: %s\n", inputMatrixFileName, CMRgetErrorMessage(cmr));
+  }
   else
     assert(false);
   if (inputMatrixFile != stdin)
@@ -315,14 +351,93 @@ CMR_ERROR runInt(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Writes all matrices that are stored one after another in a file to a matrix container.
+ */
+
+static
+CMR_ERROR packInt(
+  const char* inputMatrixFileName,  /**< File name containing the input matrices (may be `-' for stdin). */
+  FileFormat inputFormat,           /**< Format of the input matrices. */
+  const char* outputMatrixFileName  /**< File name of the container (may be `-' for stdout). */
+)
+{
+  FILE* inputMatrixFile = strcmp(inputMatrixFileName, "-") ? fopen(inputMatrixFileName, "rb") : stdin;
+  if (!inputMatrixFile)
+    return CMR_ERROR_INPUT;
+  FILE* outputMatrixFile = strcmp(outputMatrixFileName, "-") ? fopen(outputMatrixFileName, "wb") : stdout;
+  if (!outputMatrixFile)
+  {
+    if (inputMatrixFile != stdin)
+      fclose(inputMatrixFile);
+    return CMR_ERROR_OUTPUT;
+  }
+
+  CMR* cmr = NULL;
+  CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_MATRIX_CONTAINER_WRITER* writer = NULL;
+  CMR_ERROR error = CMRmatrixContainerWriterCreate(cmr, outputMatrixFile, &writer);
+  size_t numMatrices = 0;
+  while (!error)
+  {
+    int c;
+    do
+      c = fgetc(inputMatrixFile);
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+    if (c == EOF)
+      break;
+    ungetc(c, inputMatrixFile);
+
+    CMR_INTMAT* matrix = NULL;
+    if (inputFormat == FILEFORMAT_MATRIX_DENSE)
+      error = CMRintmatCreateFromDenseStream(cmr, inputMatrixFile, &matrix);
+    else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
+      error = CMRintmatCreateFromSparseStream(cmr, inputMatrixFile, &matrix);
+    else
+      error = CMRintmatCreateFromBinaryStream(cmr, inputMatrixFile, &matrix);
+    if (error)
+    {
+      fprintf(stderr, "Error when reading matrix #%zu from <%s>: %s\n", numMatrices + 1, inputMatrixFileName,
+        CMRgetErrorMessage(cmr));
+      break;
+    }
+
+    error = CMRintmatAddToContainer(cmr, matrix, writer, NULL, NULL);
+    CMR_CALL( CMRintmatFree(cmr, &matrix) );
+    ++numMatrices;
+  }
+
+  if (writer)
+  {
+    CMR_ERROR finishError = CMRmatrixContainerWriterFinish(cmr, &writer);
+    if (!error)
+      error = finishError;
+  }
+
+  CMR_CALL( CMRfreeEnvironment(&cmr) );
+  if (inputMatrixFile != stdin)
+    fclose(inputMatrixFile);
+  if (outputMatrixFile != stdout)
+    fclose(outputMatrixFile);
+
+  return error;
+}
+
 int printUsage(const char* program)
 {
   fputs("Usage:\n", stderr);
   fprintf(stderr, "%s IN-MAT OUT-MAT [OPTION]...\n\n", program);
   fputs("  copies the matrix from file IN-MAT to file OUT-MAT, potentially applying certain operations.\n\n", stderr);
   fputs("Options:\n", stderr);
-  fputs("  -i FORMAT Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
-  fputs("  -o FORMAT Format of file OUT-MAT, among `dense' and `sparse'; default: same format as of IN-MAT.\n", stderr);
+  fputs("  -i FORMAT Format of file IN-MAT, among `dense', `sparse', `binary', `mps' and `lp'; default: dense.\n", stderr);
+  fputs("  -o FORMAT Format of file OUT-MAT, among `dense', `sparse', `binary' and `container'; default: same format as\n"
+    "            of IN-MAT,\n",
+    stderr);
+  fputs("            or sparse for models.\n", stderr);
+  fputs("  -I        Only consider the integer variables of a model.\n", stderr);
+  fputs("  -R ROWS   Only consider the constraints of a model among `all', `equalities' and `inequalities'; default: all.\n",
+    stderr);
   fputs("  -S IN-SUB Consider the submatrix of IN-MAT specified in file IN-SUB instead of IN-MAT itself; can be combined with other operations.\n",
     stderr);
   fputs("  -t        Transpose the matrix; can be combined with other operations.\n", stderr);
@@ -330,7 +445,11 @@ int printUsage(const char* program)
   fputs("  -C        Compute the signed support matrix instead of copying.\n", stderr);
   fputs("  -d        Use double arithmetic instead of integers.\n\n", stderr);
   fputs("If IN-MAT is `-' then the input matrix is read from stdin.\n", stderr);
+  fputs("Models may be compressed with gzip or zstd; the constraint matrix consists of all rows except for the\n", stderr);
+  fputs("objective function.\n", stderr);
   fputs("If OUT-MAT is `-' then the output matrix is written to stdout.\n", stderr);
+  fputs("For output format `container', all matrices stored one after another in IN-MAT are packed into OUT-MAT.\n",
+    stderr);
 
   return EXIT_FAILURE;
 }
@@ -345,6 +464,8 @@ int main(int argc, char** argv)
   char* inputMatrixFileName = NULL;
   char* inputSubmatrixFileName = NULL;
   char* outputMatrixFileName = NULL;
+  CMR_MODEL_PARAMS modelParams;
+  CMRmodelParamsInit(&modelParams);
   for (int a = 1; a < argc; ++a)
   {
     if (!strcmp(argv[a], "-h"))
@@ -358,6 +479,18 @@ int main(int argc, char** argv)
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
+      else if (!strcmp(argv[a+1], "mps"))
+      {
+        inputFormat = FILEFORMAT_MODEL_MPS;
+        modelParams.format = CMR_MODEL_FORMAT_MPS;
+      }
+      else if (!strcmp(argv[a+1], "lp"))
+      {
+        inputFormat = FILEFORMAT_MODEL_LP;
+        modelParams.format = CMR_MODEL_FORMAT_LP;
+      }
       else
       {
         fprintf(stderr, "Error: Unknown input format <%s>.\n\n", argv[a+1]);
@@ -371,6 +504,10 @@ int main(int argc, char** argv)
         outputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         outputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        outputFormat = FILEFORMAT_MATRIX_BINARY;
+      else if (!strcmp(argv[a+1], "container"))
+        outputFormat = FILEFORMAT_MATRIX_CONTAINER;
       else
       {
         fprintf(stderr, "Error: Unknown output format <%s>.\n\n", argv[a+1]);
@@ -388,6 +525,23 @@ int main(int argc, char** argv)
       transpose = true;
     else if (!strcmp(argv[a], "-d"))
       doubleArithmetic = true;
+    else if (!strcmp(argv[a], "-I"))
+      modelParams.integerColumnsOnly = true;
+    else if (!strcmp(argv[a], "-R") && a+1 < argc)
+    {
+      if (!strcmp(argv[a+1], "all"))
+        modelParams.rows = CMR_MODEL_ROWS_ALL;
+      else if (!strcmp(argv[a+1], "equalities"))
+        modelParams.rows = CMR_MODEL_ROWS_EQUALITIES;
+      else if (!strcmp(argv[a+1], "inequalities"))
+        modelParams.rows = CMR_MODEL_ROWS_INEQUALITIES;
+      else
+      {
+        fprintf(stderr, "Error: Unknown constraint selection <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
     else if (!inputMatrixFileName)
       inputMatrixFileName = argv[a];
     else if (!outputMatrixFileName)
@@ -411,13 +565,28 @@ int main(int argc, char** argv)
     return printUsage(argv[0]);
   }
   if (outputFormat == FILEFORMAT_UNDEFINED)
-    outputFormat = inputFormat;
+  {
+    outputFormat = (inputFormat == FILEFORMAT_MODEL_MPS || inputFormat == FILEFORMAT_MODEL_LP)
+      ? FILEFORMAT_MATRIX_SPARSE : inputFormat;
+  }
 
   CMR_ERROR error;
-  if (doubleArithmetic)
-    error = runDbl(inputMatrixFileName, inputFormat, inputSubmatrixFileName, outputFormat, outputMatrixFileName, task, transpose);
+  if (outputFormat == FILEFORMAT_MATRIX_CONTAINER)
+  {
+    if (inputFormat == FILEFORMAT_MODEL_MPS || inputFormat == FILEFORMAT_MODEL_LP || inputSubmatrixFileName
+      || task != TASK_COPY || transpose || doubleArithmetic)
+    {
+      fputs("Error: Output format `container' requires matrix input and no further operation.\n\n", stderr);
+      return printUsage(argv[0]);
+    }
+    error = packInt(inputMatrixFileName, inputFormat, outputMatrixFileName);
+  }
+  else if (doubleArithmetic)
+    error = runDbl(inputMatrixFileName, inputFormat, inputSubmatrixFileName, outputFormat, outputMatrixFileName, task, transpose,
+      &modelParams);
   else
-    error = runInt(inputMatrixFileName, inputFormat, inputSubmatrixFileName, outputFormat, outputMatrixFileName, task, transpose);
+    error = runInt(inputMatrixFileName, inputFormat, inputSubmatrixFileName, outputFormat, outputMatrixFileName, task, transpose,
+      &modelParams);
   switch (error)
   {
   case CMR_ERROR_INPUT:
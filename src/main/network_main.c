@@ -10,6 +10,8 @@
 #include <cmr/graph.h>
 #include <cmr/network.h>
 
+#include "result_cache.h"
+
 typedef enum
 {
   TASK_RECOGNIZE = 0, /**< Determine whether a matrix is graphic. */
@@ -21,8 +23,61 @@ typedef enum
   FILEFORMAT_UNDEFINED = 0,     /**< Whether the file format of input/output was defined by the user. */
   FILEFORMAT_MATRIX_DENSE = 1,  /**< Dense matrix format. */
   FILEFORMAT_MATRIX_SPARSE = 2, /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3, /**< Binary matrix format. */
 } FileFormat;
 
+/**
+ * \brief Writes section \p name of a cached result to \p fileName and prints a note about it.
+ */
+
+static
+CMR_ERROR printCachedOutput(
+  CMR_RESULT_ENTRY* entry,  /**< Cached result. */
+  const char* name,         /**< Name of the section. */
+  const char* what,         /**< Description of the output for the note. */
+  const char* fileName      /**< File name to write to, or \c NULL to skip. */
+)
+{
+  CMR_RESULT_SECTION* section = CMRresultCacheSection(entry, name);
+  if (!fileName || !section)
+    return CMR_OKAY;
+
+  bool outputToFile = strcmp(fileName, "-");
+  fprintf(stderr, "Writing %s to %s%s%s.\n", what, outputToFile ? "file <" : "", outputToFile ? fileName : "stdout",
+    outputToFile ? ">" : "");
+  CMR_CALL( CMRresultCacheWriteSectionToFile(section, fileName) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reproduces the output of a (co)network test from a cached result.
+ */
+
+static
+CMR_ERROR printCachedResult(
+  CMR_RESULT_ENTRY* entry,              /**< Cached result. */
+  bool conetwork,                       /**< Whether the input was checked for being conetwork. */
+  const char* outputGraphFileName,      /**< File name of the output graph, or \c NULL. */
+  const char* outputDotFileName,        /**< File name of the output dot file, or \c NULL. */
+  const char* outputSubmatrixFileName   /**< File name of the output non-(co)network submatrix, or \c NULL. */
+)
+{
+  fprintf(stderr, "Matrix %s%snetwork.\n", entry->verdict ? "IS " : "is NOT ", conetwork ? "co" : "");
+  if (entry->verdict)
+  {
+    CMR_CALL( printCachedOutput(entry, "graph", conetwork ? "codigraph" : "digraph", outputGraphFileName) );
+    CMR_CALL( printCachedOutput(entry, "dot", conetwork ? "codigraph" : "digraph", outputDotFileName) );
+  }
+  else
+  {
+    CMR_CALL( printCachedOutput(entry, "submatrix", conetwork ? "minimal non-conetwork submatrix"
+      : "minimal non-network submatrix", outputSubmatrixFileName) );
+  }
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Converts matrix from a file to a digraph if the former is (co)network.
  */
@@ -38,6 +93,8 @@ CMR_ERROR recognizeNetwork(
   const char* outputSubmatrixFileName,  /**< File name of the output non-(co)network submatrix (may be NULL; may be `-'
                                          **  for stdout). */
   bool printStats,                      /**< Whether to print statistics to stderr. */
+  const char* statsJsonFileName,        /**< File name to write statistics in JSON format to, or \c NULL. */
+  const char* cacheDirectory,           /**< Directory of the result cache, or \c NULL. */
   double timeLimit                      /**< Time limit to impose. */
 )
 {
@@ -53,6 +110,8 @@ CMR_ERROR recognizeNetwork(
     error = CMRchrmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRchrmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRchrmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -87,6 +146,28 @@ CMR_ERROR recognizeNetwork(
     return CMR_OKAY;
   }
 
+  /* Consult the result cache. */
+
+  CMR_RESULT_ENTRY entry;
+  if (cacheDirectory)
+  {
+    CMR_CALL( CMRresultCacheOpen(cacheDirectory, "cmr-network", conetwork ? "conetwork=1" : "conetwork=0", matrix,
+      &entry) );
+    if (entry.hasVerdict && (entry.verdict
+      ? ((!outputGraphFileName || CMRresultCacheSection(&entry, "graph"))
+        && (!outputDotFileName || CMRresultCacheSection(&entry, "dot")))
+      : (!outputSubmatrixFileName || CMRresultCacheSection(&entry, "submatrix"))))
+    {
+      fprintf(stderr, "Found result in cache file <%s>.\n", entry.path);
+      CMR_CALL( printCachedResult(&entry, conetwork, outputGraphFileName, outputDotFileName,
+        outputSubmatrixFileName) );
+      CMRresultCacheClose(&entry);
+      CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+      CMR_CALL( CMRfreeEnvironment(&cmr) );
+      return CMR_OKAY;
+    }
+  }
+
   /* Test for being (co)network. */
 
   bool isCoNetwork;
@@ -98,25 +179,61 @@ CMR_ERROR recognizeNetwork(
   CMR_CALL( CMRnetworkStatsInit(&stats) );
   if (conetwork)
   {
-    CMR_CALL( CMRnetworkTestTranspose(cmr, matrix, &isCoNetwork, NULL, &digraph, &columnEdges, &rowEdges,
-      &edgesReversed, outputSubmatrixFileName ? &submatrix : NULL, &stats, timeLimit) );
+    error = CMRnetworkTestTranspose(cmr, matrix, &isCoNetwork, NULL, &digraph, &columnEdges, &rowEdges,
+      &edgesReversed, outputSubmatrixFileName ? &submatrix : NULL, &stats, timeLimit);
   }
   else
   {
-    CMR_CALL( CMRnetworkTestMatrix(cmr, matrix, &isCoNetwork, NULL, &digraph, &rowEdges, &columnEdges, &edgesReversed,
-      outputSubmatrixFileName ? &submatrix : NULL, &stats, timeLimit) );
+    error = CMRnetworkTestMatrix(cmr, matrix, &isCoNetwork, NULL, &digraph, &rowEdges, &columnEdges, &edgesReversed,
+      outputSubmatrixFileName ? &submatrix : NULL, &stats, timeLimit);
+  }
+  if (error == CMR_ERROR_TIMEOUT && cacheDirectory && entry.hasVerdict)
+  {
+    fprintf(stderr, "Warning: Time limit exceeded; using incomplete result from cache file <%s>.\n", entry.path);
+    CMR_CALL( printCachedResult(&entry, conetwork, outputGraphFileName, outputDotFileName, outputSubmatrixFileName) );
+    CMRresultCacheClose(&entry);
+    CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+    CMR_CALL( CMRfreeEnvironment(&cmr) );
+    return CMR_OKAY;
+  }
+  CMR_CALL( error );
+  if (cacheDirectory)
+  {
+    entry.hasVerdict = true;
+    entry.verdict = isCoNetwork;
   }
 
   fprintf(stderr, "Matrix %s%snetwork.\n", isCoNetwork ? "IS " : "is NOT ", conetwork ? "co" : "");
   if (printStats)
+  {
     CMR_CALL( CMRnetworkStatsPrint(stderr, &stats, NULL) );
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRnetworkStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
   if (isCoNetwork)
   {
     if (outputGraphFileName)
     {
       bool outputGraphToFile = strcmp(outputGraphFileName, "-");
-      FILE* outputGraphFile = outputGraphToFile ? fopen(outputGraphFileName, "w") : stdout;
+      FILE* outputGraphFile = cacheDirectory ? tmpfile() : (outputGraphToFile ? fopen(outputGraphFileName, "w")
+        : stdout);
+      if (!outputGraphFile)
+        return CMR_ERROR_OUTPUT;
       fprintf(stderr, "Writing %sdigraph to %s%s%s.\n", conetwork ? "co" : "", outputGraphToFile ? "file <" : "",
         outputGraphToFile ? outputGraphFileName : "stdout", outputGraphToFile ? ">" : "");
 
@@ -179,7 +296,12 @@ CMR_ERROR recognizeNetwork(
         }
       }
       
-      if (outputGraphToFile)
+      if (cacheDirectory)
+      {
+        CMR_CALL( CMRresultCacheCapture(&entry, "graph", outputGraphFile) );
+        CMR_CALL( CMRresultCacheWriteSectionToFile(CMRresultCacheSection(&entry, "graph"), outputGraphFileName) );
+      }
+      if (outputGraphToFile || cacheDirectory)
         fclose(outputGraphFile);
     }
 
@@ -193,7 +315,9 @@ CMR_ERROR recognizeNetwork(
     if (outputDotFileName)
     {
       bool outputDotToFile = strcmp(outputDotFileName, "-");
-      FILE* outputDotFile = outputDotToFile ? fopen(outputDotFileName, "w") : stdout;
+      FILE* outputDotFile = cacheDirectory ? tmpfile() : (outputDotToFile ? fopen(outputDotFileName, "w") : stdout);
+      if (!outputDotFile)
+        return CMR_ERROR_OUTPUT;
       fprintf(stderr, "Writing %sdigraph to %s%s%s.\n", conetwork ? "co" : "", outputDotToFile ? "file <" : "",
         outputDotToFile ? outputDotFileName : "stdout", outputDotToFile ? ">" : "");
 
@@ -231,7 +355,12 @@ CMR_ERROR recognizeNetwork(
       }
       fputs("}\n", outputDotFile);
 
-      if (outputDotToFile)
+      if (cacheDirectory)
+      {
+        CMR_CALL( CMRresultCacheCapture(&entry, "dot", outputDotFile) );
+        CMR_CALL( CMRresultCacheWriteSectionToFile(CMRresultCacheSection(&entry, "dot"), outputDotFileName) );
+      }
+      if (outputDotToFile || cacheDirectory)
         fclose(outputDotFile);
     }
 
@@ -251,10 +380,31 @@ CMR_ERROR recognizeNetwork(
         outputSubmatrixToFile ? ">" : "");
 
       assert(submatrix);
-      CMR_CALL( CMRsubmatWriteToFile(cmr, submatrix, matrix->numRows, matrix->numColumns, outputSubmatrixFileName) );
+      if (cacheDirectory)
+      {
+        FILE* stream = tmpfile();
+        if (!stream)
+          return CMR_ERROR_OUTPUT;
+        CMR_CALL( CMRsubmatPrint(cmr, submatrix, matrix->numRows, matrix->numColumns, stream) );
+        CMR_CALL( CMRresultCacheCapture(&entry, "submatrix", stream) );
+        fclose(stream);
+        CMR_CALL( CMRresultCacheWriteSectionToFile(CMRresultCacheSection(&entry, "submatrix"),
+          outputSubmatrixFileName) );
+      }
+      else
+      {
+        CMR_CALL( CMRsubmatWriteToFile(cmr, submatrix, matrix->numRows, matrix->numColumns,
+          outputSubmatrixFileName) );
+      }
     }
   }
 
+  if (cacheDirectory)
+  {
+    CMR_CALL( CMRresultCacheStore(&entry) );
+    CMRresultCacheClose(&entry);
+  }
+
   CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
   CMR_CALL( CMRchrmatFree(cmr, &matrix) );
   CMR_CALL( CMRfreeEnvironment(&cmr) );
@@ -381,9 +531,9 @@ CMR_ERROR computeNetwork(
 
   CMR_CALL( CMRchrmatFree(cmr, &matrix) );
 
-  free(coforestEdges);
-  free(forestEdges);
-  free(edgeElements);
+  CMR_CALL( CMRfreeBlockArray(cmr, &coforestEdges) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &forestEdges) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &edgeElements) );
   CMR_CALL( CMRgraphFree(cmr, &digraph) );
 
   CMR_CALL( CMRfreeEnvironment(&cmr) );
@@ -406,7 +556,7 @@ int printUsage(const char* program)
   fputs("  (2) computes a (co)network matrix corresponding to the digraph from file IN-GRAPH and writes it to OUT-MAT.\n\n\n",
     stderr);
   fputs("Options specific to (1):\n", stderr);
-  fputs("  -i FORMAT    Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT    Format of file IN-MAT, among `dense', `sparse' and `binary'; default: dense.\n", stderr);
   fputs("  -t           Test for being conetwork; default: test for being network.\n", stderr);
   fputs("  -G OUT-GRAPH Write a digraph to file OUT-GRAPH; default: skip computation.\n", stderr);
   fputs("  -T OUT-TREE  Write a directed spanning tree to file OUT-TREE; default: skip computation.\n", stderr);
@@ -419,7 +569,10 @@ int printUsage(const char* program)
   fputs("Common options:\n", stderr);
   fputs("  -s           Print statistics about the computation to stderr.\n\n", stderr);
   fputs("Advanced options:\n", stderr);
-  fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format; `-' for stdout.\n", stderr);
+  fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n", stderr);
+  fputs("  --cache-dir DIR      Store results in directory DIR and reuse them for equal matrices and parameters.\n\n",
+    stderr);
   fputs("If IN-MAT, IN-GRAPH or IN-TREE is `-' then the matrix (resp. the digraph or directed tree) is read from stdin.\n", stderr);
   fputs("If OUT-GRAPH, OUT-TREE, OUT-DOT or NON-SUB is `-' then the digraph (resp. the directed tree, dot file or non-(co)network submatrix) is written to stdout.\n",
     stderr);
@@ -434,12 +587,14 @@ int main(int argc, char** argv)
   FileFormat outputFormat = FILEFORMAT_UNDEFINED;
   bool transposed = false;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
   char* inputFileName = NULL;
   char* treeFileName = NULL;
   char* outputFileName = NULL;
   char* outputGraphFileName = NULL;
   char* outputDotFileName = NULL;
   char* outputSubmatrixFileName = NULL;
+  char* cacheDirectory = NULL;
   double timeLimit = DBL_MAX;
   for (int a = 1; a < argc; ++a)
   {
@@ -454,12 +609,16 @@ int main(int argc, char** argv)
       transposed = true;
     else if (!strcmp(argv[a], "-s"))
       printStats = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
     else if (!strcmp(argv[a], "-i") && a+1 < argc)
     {
       if (!strcmp(argv[a+1], "dense"))
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         fprintf(stderr, "Error: Unknown input file format <%s>.\n\n", argv[a+1]);
@@ -488,6 +647,8 @@ int main(int argc, char** argv)
       outputDotFileName = argv[++a];
     else if (!strcmp(argv[a], "-N") && a+1 < argc)
       outputSubmatrixFileName = argv[++a];
+    else if (!strcmp(argv[a], "--cache-dir") && a+1 < argc)
+      cacheDirectory = argv[++a];
     else if (!strcmp(argv[a], "--time-limit") && (a+1 < argc))
     {
       if (sscanf(argv[a+1], "%lf", &timeLimit) == 0 || timeLimit <= 0)
@@ -533,7 +694,7 @@ int main(int argc, char** argv)
       inputFormat = FILEFORMAT_MATRIX_DENSE;
 
     error = recognizeNetwork(inputFileName, inputFormat, transposed, outputGraphFileName, treeFileName, outputDotFileName,
-      outputSubmatrixFileName, printStats, timeLimit);
+      outputSubmatrixFileName, printStats, statsJsonFileName, cacheDirectory, timeLimit);
   }
   else if (task == TASK_COMPUTE)
   {
@@ -579,6 +740,7 @@ int main(int argc, char** argv)
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     /* The actual function will have reported the details. */
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
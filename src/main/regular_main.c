@@ -8,12 +8,60 @@
 #include <cmr/matrix.h>
 #include <cmr/regular.h>
 
+#include "checkpoint_file.h"
+#include "result_cache.h"
+
 typedef enum
 {
   FILEFORMAT_MATRIX_DENSE = 1,    /**< Dense matrix format. */
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3,   /**< Binary matrix format. */
 } FileFormat;
 
+/**
+ * \brief Writes the decomposition tree and the non-regular minor of a cached result.
+ */
+
+static
+CMR_ERROR printCachedOutputs(
+  CMR_RESULT_ENTRY* entry,          /**< Cached result. */
+  const char* outputTreeFileName,   /**< File name to print decomposition tree to, or \c NULL. */
+  const char* outputMinorFileName   /**< File name to print non-regular minor to, or \c NULL. */
+)
+{
+  CMR_RESULT_SECTION* section = CMRresultCacheSection(entry, "decomposition");
+  if (outputTreeFileName && section)
+    CMR_CALL( CMRresultCacheWriteSection(section, stderr) );
+
+  section = CMRresultCacheSection(entry, "minor");
+  if (outputMinorFileName && !entry->verdict && section)
+  {
+    bool outputMinorToFile = strcmp(outputMinorFileName, "-");
+    fprintf(stderr, "Writing minimal non-regular submatrix to %s%s%s.\n", outputMinorToFile ? "file <" : "",
+      outputMinorToFile ? outputMinorFileName : "stdout", outputMinorToFile ? ">" : "");
+    CMR_CALL( CMRresultCacheWriteSectionToFile(section, outputMinorFileName) );
+  }
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Reproduces the output of a regularity test from a cached result.
+ */
+
+static
+CMR_ERROR printCachedResult(
+  CMR_RESULT_ENTRY* entry,          /**< Cached result. */
+  const char* outputTreeFileName,   /**< File name to print decomposition tree to, or \c NULL. */
+  const char* outputMinorFileName   /**< File name to print non-regular minor to, or \c NULL. */
+)
+{
+  fprintf(stderr, "Matrix %sregular.\n", entry->verdict ? "IS " : "IS NOT ");
+  CMR_CALL( printCachedOutputs(entry, outputTreeFileName, outputMinorFileName) );
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Tests matrix from a file for regularity.
  */
@@ -25,13 +73,29 @@ CMR_ERROR testRegularity(
   const char* outputTreeFileName,   /**< File name to print decomposition tree to, or \c NULL. */
   const char* outputMinorFileName,  /**< File name to print non-regular minor to, or \c NULL. */
   bool printStats,                  /**< Whether to print statistics to stderr. */
+  const char* statsJsonFileName,    /**< File name to write statistics in JSON format to, or \c NULL. */
+  const char* statsNodesFileName,   /**< File name to write one line per decomposition node to, or \c NULL. */
+  const char* traceFileName,        /**< File name to write a trace of the computation to, or \c NULL. */
   bool directGraphicness,           /**< Whether to use fast graphicness routines. */
   bool seriesParallel,              /**< Whether to allow series-parallel operations in the decomposition tree. */
-  double timeLimit                  /**< Time limit to impose. */
+  bool directTwoSums,               /**< Whether to split off 2-sums at cut vertices of the support graph. */
+  CMR_REGULAR_SCHEDULE schedule,    /**< Order in which decomposition nodes are processed. */
+  bool useCache,                    /**< Whether to reuse the results for leaves with equal matrices. */
+  const char* cacheDirectory,       /**< Directory of the result cache, or \c NULL. */
+  const char* checkpointFileName,   /**< File name of the checkpoint for resuming the test, or \c NULL. */
+  double timeLimit,                 /**< Time limit to impose. */
+  double nodeTimeLimit,             /**< Time limit for each processing step of a decomposition node, or 0. */
+  size_t memoryLimit,               /**< Memory limit in bytes, or 0 for none. */
+  int numThreads,                   /**< Number of threads to use. */
+  bool hardwareCounters             /**< Whether to record hardware performance counters for the statistics. */
 )
 {
   CMR* cmr = NULL;
   CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+  if (hardwareCounters)
+    CMR_CALL( CMRsetHardwareCounters(cmr, true) );
+  CMR_CALL( CMRsetMemoryLimit(cmr, memoryLimit) );
 
   /* Read matrix. */
 
@@ -42,6 +106,8 @@ CMR_ERROR testRegularity(
     error = CMRchrmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRchrmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRchrmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -55,6 +121,27 @@ CMR_ERROR testRegularity(
   fprintf(stderr, "Read %zux%zu matrix with %zu nonzeros in %f seconds.\n", matrix->numRows, matrix->numColumns,
     matrix->numNonzeros, (clock() - readClock) * 1.0 / CLOCKS_PER_SEC);
 
+  /* Consult the result cache. */
+
+  CMR_RESULT_ENTRY entry;
+  if (cacheDirectory)
+  {
+    char parameters[64];
+    snprintf(parameters, sizeof(parameters), "direct-graphic=%d series-parallel=%d direct-two-sums=%d",
+      directGraphicness ? 1 : 0, seriesParallel ? 1 : 0, directTwoSums ? 1 : 0);
+    CMR_CALL( CMRresultCacheOpen(cacheDirectory, "cmr-regular", parameters, matrix, &entry) );
+    if (entry.hasVerdict && (!outputTreeFileName || CMRresultCacheSection(&entry, "decomposition"))
+      && (!outputMinorFileName || entry.verdict || CMRresultCacheSection(&entry, "minor")))
+    {
+      fprintf(stderr, "Found result in cache file <%s>.\n", entry.path);
+      CMR_CALL( printCachedResult(&entry, outputTreeFileName, outputMinorFileName) );
+      CMRresultCacheClose(&entry);
+      CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+      CMR_CALL( CMRfreeEnvironment(&cmr) );
+      return CMR_OKAY;
+    }
+  }
+
   /* Actual test. */
 
   bool isRegular;
@@ -65,29 +152,132 @@ CMR_ERROR testRegularity(
   params.completeTree = outputTreeFileName;
   params.directGraphicness = directGraphicness;
   params.seriesParallel = seriesParallel;
+  params.directTwoSums = directTwoSums;
+  params.schedule = schedule;
+  params.nodeTimeLimit = nodeTimeLimit;
+  if (cacheDirectory)
+    CMR_CALL( CMRresultCacheLoadLeaves(cmr, cacheDirectory, &params.cache) );
+  else if (useCache)
+    CMR_CALL( CMRregularCacheCreate(cmr, &params.cache) );
+  if (checkpointFileName)
+    CMR_CALL( CMRcheckpointFileLoad(cmr, checkpointFileName, &params.checkpoint) );
   CMR_REGULAR_STATS stats;
   CMR_CALL( CMRregularStatsInit(&stats) );
-  CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, outputTreeFileName ? &decomposition : NULL,
-    outputMinorFileName ? &minor : NULL, &params, &stats, timeLimit) );
+  if (statsNodesFileName)
+  {
+    stats.nodeLog = strcmp(statsNodesFileName, "-") ? fopen(statsNodesFileName, "w") : stdout;
+    if (!stats.nodeLog)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsNodesFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRregularNodeLogHeader(stats.nodeLog) );
+  }
+  FILE* traceFile = NULL;
+  if (traceFileName)
+  {
+    traceFile = strcmp(traceFileName, "-") ? fopen(traceFileName, "w") : stdout;
+    if (!traceFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", traceFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRtraceStart(cmr, traceFile) );
+  }
+  error = CMRregularTest(cmr, matrix, &isRegular, outputTreeFileName ? &decomposition : NULL,
+    outputMinorFileName ? &minor : NULL, &params, &stats, timeLimit);
+  if (checkpointFileName && (error == CMR_OKAY || error == CMR_ERROR_TIMEOUT))
+    CMR_CALL( CMRcheckpointFileStore(cmr, checkpointFileName, &params.checkpoint) );
+  if (stats.nodeLog && stats.nodeLog != stdout)
+    fclose(stats.nodeLog);
+  if (traceFile)
+  {
+    CMR_CALL( CMRtraceStop(cmr) );
+    if (traceFile != stdout)
+      fclose(traceFile);
+  }
+  if (error == CMR_ERROR_TIMEOUT && cacheDirectory && entry.hasVerdict)
+  {
+    fprintf(stderr, "Warning: Time limit exceeded; using incomplete result from cache file <%s>.\n", entry.path);
+    CMR_CALL( printCachedResult(&entry, outputTreeFileName, outputMinorFileName) );
+    CMRresultCacheClose(&entry);
+    CMR_CALL( CMRregularCacheFree(cmr, &params.cache) );
+    CMR_CALL( CMRmatroiddecFree(cmr, &decomposition) );
+    CMR_CALL( CMRminorFree(cmr, &minor) );
+    CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+    CMR_CALL( CMRfreeEnvironment(&cmr) );
+    return CMR_OKAY;
+  }
+  CMR_CALL( error );
 
   fprintf(stderr, "Matrix %sregular.\n", isRegular ? "IS " : "IS NOT ");
   if (printStats)
+  {
     CMR_CALL( CMRregularStatsPrint(stderr, &stats, NULL) );
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRregularStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
-  if (decomposition)
-    CMR_CALL( CMRmatroiddecPrint(cmr, decomposition, stderr, 0, true, true, true, true, true, true) );
-
-  if (minor && outputMinorFileName)
+  if (cacheDirectory)
   {
-    bool outputMinorToFile = strcmp(outputMinorFileName, "-");
-    fprintf(stderr, "Writing minimal non-regular submatrix to %s%s%s.\n", outputMinorToFile ? "file <" : "",
-      outputMinorToFile ? outputMinorFileName : "stdout", outputMinorToFile ? ">" : "");    
+    /* Print the outputs into temporary files such that they can be stored in the cache. */
+    entry.hasVerdict = true;
+    entry.verdict = isRegular;
+    if (decomposition)
+    {
+      FILE* stream = tmpfile();
+      if (!stream)
+        return CMR_ERROR_OUTPUT;
+      CMR_CALL( CMRmatroiddecPrint(cmr, decomposition, stream, 0, true, true, true, true, true, true) );
+      CMR_CALL( CMRresultCacheCapture(&entry, "decomposition", stream) );
+      fclose(stream);
+    }
+    if (minor && outputMinorFileName)
+    {
+      FILE* stream = tmpfile();
+      if (!stream)
+        return CMR_ERROR_OUTPUT;
+      CMR_CALL( CMRminorPrint(cmr, minor, matrix->numRows, matrix->numColumns, stream) );
+      CMR_CALL( CMRresultCacheCapture(&entry, "minor", stream) );
+      fclose(stream);
+    }
+    CMR_CALL( printCachedOutputs(&entry, outputTreeFileName, outputMinorFileName) );
+    CMR_CALL( CMRresultCacheStore(&entry) );
+    CMR_CALL( CMRresultCacheStoreLeaves(cmr, cacheDirectory, params.cache) );
+    CMRresultCacheClose(&entry);
+  }
+  else
+  {
+    if (decomposition)
+      CMR_CALL( CMRmatroiddecPrint(cmr, decomposition, stderr, 0, true, true, true, true, true, true) );
 
-    CMR_CALL( CMRminorWriteToFile(cmr, minor, matrix->numRows, matrix->numColumns, outputMinorFileName) );
+    if (minor && outputMinorFileName)
+    {
+      bool outputMinorToFile = strcmp(outputMinorFileName, "-");
+      fprintf(stderr, "Writing minimal non-regular submatrix to %s%s%s.\n", outputMinorToFile ? "file <" : "",
+        outputMinorToFile ? outputMinorFileName : "stdout", outputMinorToFile ? ">" : "");
+
+      CMR_CALL( CMRminorWriteToFile(cmr, minor, matrix->numRows, matrix->numColumns, outputMinorFileName) );
+    }
   }
 
   /* Cleanup. */
 
+  CMR_CALL( CMRregularCacheFree(cmr, &params.cache) );
   CMR_CALL( CMRmatroiddecFree(cmr, &decomposition) );
   CMR_CALL( CMRminorFree(cmr, &minor) );
   CMR_CALL( CMRchrmatFree(cmr, &matrix) );
@@ -108,16 +298,34 @@ int printUsage(const char* program)
   fprintf(stderr, "%s IN-MAT [OPTION]...\n\n", program);
   fputs("  determines whether the matrix given in file IN-MAT is regular.\n\n", stderr);
   fputs("Options:\n", stderr);
-  fputs("  -i FORMAT    Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT    Format of file IN-MAT, among `dense', `sparse' and `binary'; default: dense.\n", stderr);
   fputs("  -D OUT-DEC   Write a decomposition tree of the regular matroid to file OUT-DEC; default: skip computation.\n", stderr);
   fputs("  -N NON-MINOR Write a minimal non-regular minor to file NON-MINOR; default: skip computation.\n", stderr);
   fputs("  -s           Print statistics about the computation to stderr.\n\n", stderr);
   fputs("Advanced options:\n", stderr);
   fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n", stderr);
+  fputs("  --node-time-limit LIMIT Skip decomposition nodes whose processing step takes more than LIMIT seconds.\n",
+    stderr);
+  fputs("  --memory-limit MB    Allow at most MB megabytes of memory for the computation.\n", stderr);
+  fputs("  --threads NUM        Use NUM threads, where 0 means all available processors; default: 1.\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format.\n", stderr);
+  fputs("  --hw-counters        Add hardware performance counters of the phases to the statistics (Linux only).\n",
+    stderr);
+  fputs("  --stats-nodes FILE   Write one CSV line per processed decomposition node to FILE.\n", stderr);
+  fputs("  --trace FILE         Write a trace of the decomposition in Chrome's trace-event format to FILE.\n", stderr);
   fputs("  --no-direct-graphic  Check only 3-connected matrices for regularity.\n", stderr);
-  fputs("  --no-series-parallel Do not allow series-parallel operations in decomposition tree.\n\n", stderr);
+  fputs("  --no-series-parallel Do not allow series-parallel operations in decomposition tree.\n", stderr);
+  fputs("  --no-direct-two-sums Do not split off 2-sums at cut vertices before the series-parallel reductions.\n",
+    stderr);
+  fputs("  --schedule ORDER     Process decomposition nodes in ORDER, among `depth-first', `smallest', `largest' and\n"
+    "                       `small-dense'; default: depth-first.\n", stderr);
+  fputs("  --cache              Reuse the results for decomposition leaves that agree up to permutations.\n", stderr);
+  fputs("  --cache-dir DIR      Store results in directory DIR and reuse them for equal matrices and parameters.\n", stderr);
+  fputs("  --checkpoint FILE    Continue from checkpoint FILE if it exists, and write it if the test is stopped; the test\n"
+    "                       is stopped by the time limit, SIGINT or SIGTERM.\n\n", stderr);
   fputs("If IN-MAT is `-' then the matrix is read from stdin.\n", stderr);
   fputs("If OUT-DEC or NON-MINOR is `-' then the decomposition tree (resp. the minor) is written to stdout.\n", stderr);
+  fputs("If FILE is `-' then the statistics (resp. the trace) are written to stdout.\n", stderr);
 
   return EXIT_FAILURE;
 }
@@ -129,9 +337,21 @@ int main(int argc, char** argv)
   char* outputTree = NULL;
   char* outputMinor = NULL;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
+  bool hardwareCounters = false;
+  char* statsNodesFileName = NULL;
+  char* traceFileName = NULL;
   bool directGraphicness = true;
   bool seriesParallel = true;
+  bool directTwoSums = true;
+  CMR_REGULAR_SCHEDULE schedule = CMR_REGULAR_SCHEDULE_DEPTH_FIRST;
+  bool useCache = false;
+  char* cacheDirectory = NULL;
+  char* checkpointFileName = NULL;
   double timeLimit = DBL_MAX;
+  double nodeTimeLimit = 0.0;
+  size_t memoryLimit = 0;
+  int numThreads = 1;
   for (int a = 1; a < argc; ++a)
   {
     if (!strcmp(argv[a], "-h"))
@@ -145,6 +365,8 @@ int main(int argc, char** argv)
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         printf("Error: unknown input file format <%s>.\n\n", argv[a+1]);
@@ -158,10 +380,52 @@ int main(int argc, char** argv)
       outputMinor = argv[++a];
     else if (!strcmp(argv[a], "-s"))
       printStats = true;
+    else if (!strcmp(argv[a], "--hw-counters"))
+      hardwareCounters = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
+    else if (!strcmp(argv[a], "--stats-nodes") && a+1 < argc)
+      statsNodesFileName = argv[++a];
+    else if (!strcmp(argv[a], "--trace") && a+1 < argc)
+      traceFileName = argv[++a];
     else if (!strcmp(argv[a], "--no-direct-graphic"))
       directGraphicness = false;
     else if (!strcmp(argv[a], "--no-series-parallel"))
       seriesParallel = false;
+    else if (!strcmp(argv[a], "--no-direct-two-sums"))
+      directTwoSums = false;
+    else if (!strcmp(argv[a], "--schedule") && a+1 < argc)
+    {
+      if (!strcmp(argv[a+1], "depth-first"))
+        schedule = CMR_REGULAR_SCHEDULE_DEPTH_FIRST;
+      else if (!strcmp(argv[a+1], "smallest"))
+        schedule = CMR_REGULAR_SCHEDULE_SMALLEST_FIRST;
+      else if (!strcmp(argv[a+1], "largest"))
+        schedule = CMR_REGULAR_SCHEDULE_LARGEST_FIRST;
+      else if (!strcmp(argv[a+1], "small-dense"))
+        schedule = CMR_REGULAR_SCHEDULE_SMALL_DENSE_FIRST;
+      else
+      {
+        fprintf(stderr, "Error: Invalid schedule <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--cache"))
+      useCache = true;
+    else if (!strcmp(argv[a], "--cache-dir") && a+1 < argc)
+      cacheDirectory = argv[++a];
+    else if (!strcmp(argv[a], "--checkpoint") && a+1 < argc)
+      checkpointFileName = argv[++a];
+    else if (!strcmp(argv[a], "--threads") && (a+1 < argc))
+    {
+      if (sscanf(argv[a+1], "%d", &numThreads) == 0 || numThreads < 0)
+      {
+        fprintf(stderr, "Error: Invalid number of threads <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
     else if (!strcmp(argv[a], "--time-limit") && (a+1 < argc))
     {
       if (sscanf(argv[a+1], "%lf", &timeLimit) == 0 || timeLimit <= 0)
@@ -171,6 +435,26 @@ int main(int argc, char** argv)
       }
       ++a;
     }
+    else if (!strcmp(argv[a], "--node-time-limit") && (a+1 < argc))
+    {
+      if (sscanf(argv[a+1], "%lf", &nodeTimeLimit) == 0 || nodeTimeLimit <= 0)
+      {
+        fprintf(stderr, "Error: Invalid node time limit <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--memory-limit") && (a+1 < argc))
+    {
+      double megabytes;
+      if (sscanf(argv[a+1], "%lf", &megabytes) == 0 || megabytes <= 0)
+      {
+        fprintf(stderr, "Error: Invalid memory limit <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      memoryLimit = (size_t) (megabytes * 1024 * 1024);
+      ++a;
+    }
     else if (!inputMatrixFileName)
       inputMatrixFileName = argv[a];
     else
@@ -187,12 +471,14 @@ int main(int argc, char** argv)
   }
 
   CMR_ERROR error;
-  error = testRegularity(inputMatrixFileName, inputFormat, outputTree, outputMinor, printStats, directGraphicness,
-    seriesParallel, timeLimit);
+  error = testRegularity(inputMatrixFileName, inputFormat, outputTree, outputMinor, printStats, statsJsonFileName,
+    statsNodesFileName, traceFileName, directGraphicness, seriesParallel, directTwoSums, schedule, useCache, cacheDirectory, checkpointFileName, timeLimit,
+    nodeTimeLimit, memoryLimit, numThreads, hardwareCounters);
 
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     /* The actual function will have reported the details. */
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
@@ -0,0 +1,437 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "result_cache.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define RESULT_CACHE_VERSION 1  /**< Version of the file format of entries. */
+
+static const char* LEAVES_FILE_NAME = "regular-leaves.bin";
+
+/**
+ * \brief Mixes the bits of \p x.
+ */
+
+static inline
+uint64_t mixBits(
+  uint64_t x  /**< Value to be mixed. */
+)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+ * \brief Adds \p word to the 128-bit hash \p hash.
+ */
+
+static inline
+void hashWord(
+  uint64_t* hash, /**< Array with the two halves of the hash. */
+  uint64_t word   /**< Word to add. */
+)
+{
+  hash[0] = mixBits(hash[0] ^ word);
+  hash[1] = mixBits(hash[1] + word * 0x9e3779b97f4a7c15ULL);
+}
+
+/**
+ * \brief Adds the string \p text, including its length, to the 128-bit hash \p hash.
+ */
+
+static
+void hashString(
+  uint64_t* hash,   /**< Array with the two halves of the hash. */
+  const char* text  /**< String to add. */
+)
+{
+  size_t length = strlen(text);
+  hashWord(hash, length);
+  for (size_t i = 0; i < length; ++i)
+    hashWord(hash, (unsigned char) text[i]);
+}
+
+/**
+ * \brief Returns a copy of the concatenation of \p first, \p second and \p third allocated with \c malloc.
+ */
+
+static
+char* concatenate(
+  const char* first,  /**< First string. */
+  const char* second, /**< Second string. */
+  const char* third   /**< Third string. */
+)
+{
+  size_t length = strlen(first) + strlen(second) + strlen(third);
+  char* result = malloc(length + 1);
+  if (result)
+  {
+    strcpy(result, first);
+    strcat(result, second);
+    strcat(result, third);
+  }
+  return result;
+}
+
+/**
+ * \brief Frees the sections of \p entry.
+ */
+
+static
+void clearSections(
+  CMR_RESULT_ENTRY* entry /**< Entry. */
+)
+{
+  for (size_t s = 0; s < entry->numSections; ++s)
+  {
+    free(entry->sections[s].name);
+    free(entry->sections[s].data);
+  }
+  entry->numSections = 0;
+}
+
+/**
+ * \brief Reads the entry's file if it exists and belongs to the same matrix dimensions and parameters.
+ *
+ * \returns \c false if the file does not exist or is invalid, in which case \p entry is left without a verdict.
+ */
+
+static
+bool loadEntry(
+  CMR_RESULT_ENTRY* entry /**< Entry. */
+)
+{
+  FILE* stream = fopen(entry->path, "rb");
+  if (!stream)
+    return false;
+
+  bool valid = false;
+  size_t descriptionLength = strlen(entry->description);
+  char* line = malloc(descriptionLength + 64);
+  unsigned int version;
+  int verdict;
+  size_t numRows, numColumns, numNonzeros, numSections;
+  if (line && fscanf(stream, "CMR-RESULT %u\n", &version) == 1 && version == RESULT_CACHE_VERSION
+    && fgets(line, (int) descriptionLength + 64, stream) && !strncmp(line, "description ", 12)
+    && !strncmp(&line[12], entry->description, descriptionLength) && line[12 + descriptionLength] == '\n'
+    && fscanf(stream, "matrix %zu %zu %zu\n", &numRows, &numColumns, &numNonzeros) == 3
+    && numRows == entry->numRows && numColumns == entry->numColumns && numNonzeros == entry->numNonzeros
+    && fscanf(stream, "verdict %d\n", &verdict) == 1 && (verdict == 0 || verdict == 1)
+    && fscanf(stream, "sections %zu", &numSections) == 1 && numSections <= CMR_RESULT_CACHE_MAX_SECTIONS
+    && fgetc(stream) == '\n')
+  {
+    valid = true;
+    for (size_t s = 0; valid && s < numSections; ++s)
+    {
+      char name[64];
+      size_t length;
+      CMR_RESULT_SECTION* section = &entry->sections[s];
+      valid = fscanf(stream, "%63s %zu", name, &length) == 2 && fgetc(stream) == '\n'
+        && (section->name = strdup(name)) != NULL && (section->data = malloc(length + 1)) != NULL;
+      if (section->name)
+        entry->numSections++;
+      if (valid)
+      {
+        section->length = length;
+        valid = fread(section->data, 1, length, stream) == length && fgetc(stream) == '\n';
+        section->data[length] = '\0';
+      }
+    }
+    if (valid)
+    {
+      entry->hasVerdict = true;
+      entry->verdict = verdict;
+    }
+    else
+      clearSections(entry);
+  }
+
+  free(line);
+  fclose(stream);
+  return valid;
+}
+
+CMR_ERROR CMRresultCacheOpen(const char* directory, const char* tool, const char* parameters, CMR_CHRMAT* matrix,
+  CMR_RESULT_ENTRY* entry)
+{
+  assert(directory);
+  assert(tool);
+  assert(parameters);
+  assert(matrix);
+  assert(entry);
+
+  entry->path = NULL;
+  entry->description = NULL;
+  entry->numRows = matrix->numRows;
+  entry->numColumns = matrix->numColumns;
+  entry->numNonzeros = matrix->numNonzeros;
+  entry->hasVerdict = false;
+  entry->verdict = false;
+  entry->numSections = 0;
+
+  if (mkdir(directory, 0777) && errno != EEXIST)
+  {
+    fprintf(stderr, "Error: Cannot create cache directory <%s>: %s.\n", directory, strerror(errno));
+    return CMR_ERROR_OUTPUT;
+  }
+
+  /* The key covers the executable, its parameters and the matrix entries, but not the matrix's file format. */
+  uint64_t hash[2] = { 0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL };
+  hashString(hash, tool);
+  hashString(hash, parameters);
+  hashWord(hash, matrix->numRows);
+  hashWord(hash, matrix->numColumns);
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    size_t first = matrix->rowSlice[row];
+    size_t beyond = matrix->rowSlice[row + 1];
+    hashWord(hash, beyond - first);
+    for (size_t e = first; e < beyond; ++e)
+      hashWord(hash, ((uint64_t) matrix->entryColumns[e] << 8) | (uint8_t) matrix->entryValues[e]);
+  }
+
+  char fileName[64];
+  snprintf(fileName, sizeof(fileName), "/%016" PRIx64 "%016" PRIx64 ".result", hash[0], hash[1]);
+  entry->path = concatenate(directory, fileName, "");
+  entry->description = concatenate(tool, " ", parameters);
+  if (!entry->path || !entry->description)
+    return CMR_ERROR_MEMORY;
+
+  loadEntry(entry);
+
+  return CMR_OKAY;
+}
+
+void CMRresultCacheClose(CMR_RESULT_ENTRY* entry)
+{
+  assert(entry);
+
+  clearSections(entry);
+  free(entry->description);
+  entry->description = NULL;
+  free(entry->path);
+  entry->path = NULL;
+}
+
+CMR_RESULT_SECTION* CMRresultCacheSection(CMR_RESULT_ENTRY* entry, const char* name)
+{
+  assert(entry);
+  assert(name);
+
+  for (size_t s = 0; s < entry->numSections; ++s)
+  {
+    if (!strcmp(entry->sections[s].name, name))
+      return &entry->sections[s];
+  }
+
+  return NULL;
+}
+
+CMR_ERROR CMRresultCacheCapture(CMR_RESULT_ENTRY* entry, const char* name, FILE* stream)
+{
+  assert(entry);
+  assert(name);
+  assert(stream);
+
+  long length = ftell(stream);
+  if (length < 0)
+    return CMR_ERROR_OUTPUT;
+
+  CMR_RESULT_SECTION* section = CMRresultCacheSection(entry, name);
+  if (!section)
+  {
+    if (entry->numSections == CMR_RESULT_CACHE_MAX_SECTIONS)
+      return CMR_ERROR_INVALID;
+    section = &entry->sections[entry->numSections];
+    section->name = strdup(name);
+    section->data = NULL;
+    if (!section->name)
+      return CMR_ERROR_MEMORY;
+    entry->numSections++;
+  }
+
+  free(section->data);
+  section->length = (size_t) length;
+  section->data = malloc(section->length + 1);
+  if (!section->data)
+    return CMR_ERROR_MEMORY;
+  rewind(stream);
+  if (fread(section->data, 1, section->length, stream) != section->length)
+    return CMR_ERROR_OUTPUT;
+  section->data[section->length] = '\0';
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRresultCacheWriteSection(CMR_RESULT_SECTION* section, FILE* stream)
+{
+  assert(section);
+  assert(stream);
+
+  if (fwrite(section->data, 1, section->length, stream) != section->length)
+    return CMR_ERROR_OUTPUT;
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRresultCacheWriteSectionToFile(CMR_RESULT_SECTION* section, const char* fileName)
+{
+  assert(section);
+  assert(fileName);
+
+  FILE* stream = strcmp(fileName, "-") ? fopen(fileName, "w") : stdout;
+  if (!stream)
+  {
+    fprintf(stderr, "Error: Cannot write to file <%s>.\n", fileName);
+    return CMR_ERROR_OUTPUT;
+  }
+  CMR_ERROR error = CMRresultCacheWriteSection(section, stream);
+  if (stream != stdout)
+    fclose(stream);
+
+  return error;
+}
+
+/**
+ * \brief Opens a temporary file next to \p path for replacing it by \ref commitFile.
+ */
+
+static
+FILE* openTemporaryFile(
+  const char* path,       /**< Path of the file to replace. */
+  char** ptemporaryPath   /**< Pointer for storing the path of the temporary file, allocated with \c malloc. */
+)
+{
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".tmp.%ld", (long) getpid());
+  *ptemporaryPath = concatenate(path, suffix, "");
+  if (!*ptemporaryPath)
+    return NULL;
+
+  FILE* stream = fopen(*ptemporaryPath, "wb");
+  if (!stream)
+  {
+    free(*ptemporaryPath);
+    *ptemporaryPath = NULL;
+  }
+  return stream;
+}
+
+/**
+ * \brief Closes the stream of a temporary file and renames it to \p path, which makes the replacement atomic.
+ */
+
+static
+CMR_ERROR commitFile(
+  FILE* stream,         /**< Stream opened by \ref openTemporaryFile. */
+  char* temporaryPath,  /**< Path of the temporary file; freed by this function. */
+  const char* path      /**< Path of the file to replace. */
+)
+{
+  bool failed = ferror(stream);
+  if (fclose(stream))
+    failed = true;
+  if (!failed && rename(temporaryPath, path))
+    failed = true;
+  if (failed)
+  {
+    fprintf(stderr, "Error: Cannot write cache file <%s>.\n", path);
+    remove(temporaryPath);
+  }
+  free(temporaryPath);
+
+  return failed ? CMR_ERROR_OUTPUT : CMR_OKAY;
+}
+
+CMR_ERROR CMRresultCacheStore(CMR_RESULT_ENTRY* entry)
+{
+  assert(entry);
+  assert(entry->hasVerdict);
+
+  char* temporaryPath = NULL;
+  FILE* stream = openTemporaryFile(entry->path, &temporaryPath);
+  if (!stream)
+  {
+    fprintf(stderr, "Error: Cannot write cache file <%s>.\n", entry->path);
+    return CMR_ERROR_OUTPUT;
+  }
+
+  fprintf(stream, "CMR-RESULT %d\ndescription %s\nmatrix %zu %zu %zu\nverdict %d\nsections %zu\n",
+    RESULT_CACHE_VERSION, entry->description, entry->numRows, entry->numColumns, entry->numNonzeros,
+    entry->verdict ? 1 : 0, entry->numSections);
+  for (size_t s = 0; s < entry->numSections; ++s)
+  {
+    CMR_RESULT_SECTION* section = &entry->sections[s];
+    fprintf(stream, "%s %zu\n", section->name, section->length);
+    fwrite(section->data, 1, section->length, stream);
+    fputc('\n', stream);
+  }
+
+  return commitFile(stream, temporaryPath, entry->path);
+}
+
+CMR_ERROR CMRresultCacheLoadLeaves(CMR* cmr, const char* directory, CMR_REGULAR_CACHE** pcache)
+{
+  assert(cmr);
+  assert(directory);
+  assert(pcache);
+
+  CMR_CALL( CMRregularCacheCreate(cmr, pcache) );
+
+  char* path = concatenate(directory, "/", LEAVES_FILE_NAME);
+  if (!path)
+    return CMR_ERROR_MEMORY;
+  FILE* stream = fopen(path, "rb");
+  if (stream)
+  {
+    if (CMRregularCacheRead(cmr, *pcache, stream) != CMR_OKAY)
+    {
+      const char* message = CMRgetErrorMessage(cmr);
+      fprintf(stderr, "Warning: Ignoring invalid parts of cache file <%s>: %s\n", path, message ? message : "");
+      CMRclearErrorMessage(cmr);
+    }
+    fclose(stream);
+  }
+  free(path);
+
+  return CMR_OKAY;
+}
+
+CMR_ERROR CMRresultCacheStoreLeaves(CMR* cmr, const char* directory, CMR_REGULAR_CACHE* cache)
+{
+  assert(cmr);
+  assert(directory);
+  assert(cache);
+
+  char* path = concatenate(directory, "/", LEAVES_FILE_NAME);
+  if (!path)
+    return CMR_ERROR_MEMORY;
+
+  char* temporaryPath = NULL;
+  FILE* stream = openTemporaryFile(path, &temporaryPath);
+  CMR_ERROR error = CMR_ERROR_OUTPUT;
+  if (stream)
+  {
+    error = CMRregularCacheWrite(cmr, cache, stream);
+    CMR_ERROR commitError = commitFile(stream, temporaryPath, path);
+    if (!error)
+      error = commitError;
+  }
+  else
+    fprintf(stderr, "Error: Cannot write cache file <%s>.\n", path);
+  free(path);
+
+  return error;
+}
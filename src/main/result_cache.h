@@ -0,0 +1,148 @@
+#ifndef CMR_RESULT_CACHE_H
+#define CMR_RESULT_CACHE_H
+
+/**
+ * \file result_cache.h
+ *
+ * \brief Content-addressed cache of results of the recognition executables in a directory.
+ *
+ * An entry is keyed by a hash of the input matrix, the name of the executable and its effective parameters. It
+ * stores the verdict together with named sections, e.g., the text of a decomposition tree or of a violating
+ * submatrix. Entries are replaced atomically, such that several processes may share a directory.
+ *
+ * The directory also contains a file with the leaves of a \ref CMR_REGULAR_CACHE, which lets regularity tests reuse
+ * the results for unchanged blocks of edited matrices.
+ */
+
+#include <cmr/matrix.h>
+#include <cmr/regular.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMR_RESULT_CACHE_MAX_SECTIONS 8 /**< Maximum number of sections of an entry. */
+
+/**
+ * \brief Named section of a cached result.
+ */
+
+typedef struct
+{
+  char* name;     /**< \brief Name of the section. */
+  char* data;     /**< \brief Contents of the section. */
+  size_t length;  /**< \brief Length of \ref data in bytes. */
+} CMR_RESULT_SECTION;
+
+/**
+ * \brief Cached result for one matrix.
+ */
+
+typedef struct
+{
+  char* path;                   /**< \brief Path of the entry's file. */
+  char* description;            /**< \brief Executable and parameters. */
+  size_t numRows;               /**< \brief Number of rows of the matrix. */
+  size_t numColumns;            /**< \brief Number of columns of the matrix. */
+  size_t numNonzeros;           /**< \brief Number of nonzeros of the matrix. */
+  bool hasVerdict;              /**< \brief Whether \ref verdict is known. */
+  bool verdict;                 /**< \brief Whether the matrix has the tested property. */
+  size_t numSections;           /**< \brief Number of sections. */
+  CMR_RESULT_SECTION sections[CMR_RESULT_CACHE_MAX_SECTIONS]; /**< \brief Sections. */
+} CMR_RESULT_ENTRY;
+
+/**
+ * \brief Initializes the entry for \p matrix in \p directory and loads it if it exists.
+ *
+ * The directory is created if necessary. An entry that cannot be read or that belongs to different parameters is
+ * treated like a missing one.
+ */
+
+CMR_ERROR CMRresultCacheOpen(
+  const char* directory,    /**< Cache directory. */
+  const char* tool,         /**< Name of the executable. */
+  const char* parameters,   /**< Effective parameters of the executable in a canonical text form. */
+  CMR_CHRMAT* matrix,       /**< Input matrix. */
+  CMR_RESULT_ENTRY* entry   /**< Pointer to the entry to initialize. */
+);
+
+/**
+ * \brief Frees the memory of an entry.
+ */
+
+void CMRresultCacheClose(
+  CMR_RESULT_ENTRY* entry   /**< Entry. */
+);
+
+/**
+ * \brief Returns the section of \p entry with the given \p name, or \c NULL if it does not exist.
+ */
+
+CMR_RESULT_SECTION* CMRresultCacheSection(
+  CMR_RESULT_ENTRY* entry,  /**< Entry. */
+  const char* name          /**< Name of the section. */
+);
+
+/**
+ * \brief Sets the section of \p entry with the given \p name to the contents of \p stream.
+ *
+ * The stream is read from its beginning to its current position.
+ */
+
+CMR_ERROR CMRresultCacheCapture(
+  CMR_RESULT_ENTRY* entry,  /**< Entry. */
+  const char* name,         /**< Name of the section. */
+  FILE* stream              /**< Stream opened for reading and writing, e.g., by \c tmpfile. */
+);
+
+/**
+ * \brief Writes the contents of a section to \p stream.
+ */
+
+CMR_ERROR CMRresultCacheWriteSection(
+  CMR_RESULT_SECTION* section,  /**< Section. */
+  FILE* stream                  /**< File stream to write to. */
+);
+
+/**
+ * \brief Writes the contents of a section to the file \p fileName, or to stdout if it is `-'.
+ */
+
+CMR_ERROR CMRresultCacheWriteSectionToFile(
+  CMR_RESULT_SECTION* section,  /**< Section. */
+  const char* fileName          /**< File name. */
+);
+
+/**
+ * \brief Writes \p entry to its file in the cache directory.
+ */
+
+CMR_ERROR CMRresultCacheStore(
+  CMR_RESULT_ENTRY* entry   /**< Entry. */
+);
+
+/**
+ * \brief Creates a cache of regular leaves and adds the leaves stored in \p directory.
+ */
+
+CMR_ERROR CMRresultCacheLoadLeaves(
+  CMR* cmr,                   /**< \ref CMR environment. */
+  const char* directory,      /**< Cache directory. */
+  CMR_REGULAR_CACHE** pcache  /**< Pointer for storing the cache. */
+);
+
+/**
+ * \brief Writes the leaves of \p cache to \p directory.
+ */
+
+CMR_ERROR CMRresultCacheStoreLeaves(
+  CMR* cmr,                 /**< \ref CMR environment. */
+  const char* directory,    /**< Cache directory. */
+  CMR_REGULAR_CACHE* cache  /**< Cache. */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMR_RESULT_CACHE_H */
@@ -11,7 +11,8 @@
 typedef enum
 {
   FILEFORMAT_MATRIX_DENSE = 1,
-  FILEFORMAT_MATRIX_SPARSE = 2
+  FILEFORMAT_MATRIX_SPARSE = 2,
+  FILEFORMAT_MATRIX_BINARY = 3
 } FileFormat;
 
 CMR_ERROR recognizeSeriesParallel(
@@ -22,6 +23,7 @@ CMR_ERROR recognizeSeriesParallel(
   const char* outputSubmatrixFileName,  /**< File name for minimal non-series-parallel submatrix (may be `-` for stdout). */
   bool binary,                          /**< Whether to test for binary series-parallel. */
   bool printStats,                      /**< Whether to print statistics to stderr. */
+  const char* statsJsonFileName,        /**< File name to write statistics in JSON format to, or \c NULL. */
   double timeLimit                  /**< Time limit to impose. */
 )
 {
@@ -37,6 +39,8 @@ CMR_ERROR recognizeSeriesParallel(
     error = CMRchrmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRchrmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRchrmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -72,7 +76,25 @@ CMR_ERROR recognizeSeriesParallel(
   fprintf(stderr, "Matrix %sseries-parallel. %zu reductions can be applied.\n",
     numReductions == matrix->numRows + matrix->numColumns ? "IS " : "is NOT ", numReductions);
   if (printStats)
+  {
     CMR_CALL( CMRspStatsPrint(stderr, &stats, NULL) );
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRspStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
   if (outputReductionsFileName)
   {
@@ -127,13 +149,14 @@ int printUsage(const char* program)
   fprintf(stderr, "%s IN-MAT [OPTION]...\n\n", program);
   fputs("  determines whether the matrix given in file IN-MAT is series-parallel.\n\n", stderr);
   fputs("Options:\n", stderr);
-  fputs("  -i FORMAT       Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT       Format of file IN-MAT, among `dense', `sparse' and `binary'; default: dense.\n", stderr);
   fputs("  -S OUT-SP       Write the list of series-parallel reductions to file OUT-SP; default: skip computation.\n", stderr);
   fputs("  -R OUT-REDUCED  Write the reduced submatrix to file `OUT-REDUCED`; default: skip computation.\n", stderr);
   fputs("  -N NON-SUB      Write a minimal non-series-parallel submatrix to file `NON-SUB`; default: skip computation.\n", stderr);
   fputs("  -b              Test for being binary series-parallel; default: ternary.\n", stderr);
   fputs("  -s`             Print statistics about the computation to stderr.\n\n", stderr);
   fputs("Advanced options:\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format; `-' for stdout.\n", stderr);
   fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n\n", stderr);
   fputs("If IN-MAT is `-' then the matrix is read from stdin.\n", stderr);
   fputs("If OUT-SP, OUT-REDUCED or NON-SUB is `-' then the list of reductions (resp. the submatrix) is written to stdout.\n", stderr);
@@ -150,6 +173,7 @@ int main(int argc, char** argv)
   char* outputSubmatrixFileName = NULL;
   bool binary = false;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
   double timeLimit = DBL_MAX;
   for (int a = 1; a < argc; ++a)
   {
@@ -164,6 +188,8 @@ int main(int argc, char** argv)
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
       else
       {
         printf("Error: unknown input file format <%s>.\n\n", argv[a+1]);
@@ -181,6 +207,8 @@ int main(int argc, char** argv)
       binary = true;
     else if (!strcmp(argv[a], "-s"))
       printStats = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
     else if (!strcmp(argv[a], "--time-limit") && (a+1 < argc))
     {
       if (sscanf(argv[a+1], "%lf", &timeLimit) == 0 || timeLimit <= 0)
@@ -206,11 +234,12 @@ int main(int argc, char** argv)
   }
 
   CMR_ERROR error = recognizeSeriesParallel(inputMatrixFileName, inputFormat, outputReductionsFileName,
-    outputReducedFileName, outputSubmatrixFileName, binary, printStats, timeLimit);
+    outputReducedFileName, outputSubmatrixFileName, binary, printStats, statsJsonFileName, timeLimit);
 
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     /* The actual function will have reported the details. */
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
@@ -0,0 +1,666 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <cmr/env.h>
+#include <cmr/matrix.h>
+#include <cmr/graph.h>
+#include <cmr/graphic.h>
+#include <cmr/network.h>
+#include <cmr/tu.h>
+
+#if defined(CMR_WITH_THREADS)
+#include <pthread.h>
+#endif /* CMR_WITH_THREADS */
+
+#define HEADER_SIZE 24                      /**< Size of the headers of requests and responses. */
+#define DEFAULT_MAX_MATRIX_SIZE (64UL << 20) /**< Default maximum size of a matrix record. */
+#define READ_CHUNK_SIZE 4096                /**< Number of bytes by which a matrix record is read at least. */
+
+/**
+ * \brief Tasks that can be requested.
+ */
+
+typedef enum
+{
+  TASK_TU = 1,        /**< Test for total unimodularity. */
+  TASK_NETWORK = 2,   /**< Test for being network. */
+  TASK_CONETWORK = 3, /**< Test for being conetwork. */
+  TASK_GRAPHIC = 4,   /**< Test for being graphic. */
+  TASK_COGRAPHIC = 5  /**< Test for being cographic. */
+} Task;
+
+/**
+ * \brief Status of a response.
+ */
+
+typedef enum
+{
+  STATUS_OKAY = 0,    /**< The test was carried out. */
+  STATUS_INPUT = 1,   /**< The request was invalid; the payload is an error message. */
+  STATUS_TIMEOUT = 2, /**< The time limit was exceeded. */
+  STATUS_ERROR = 3    /**< Another error occurred. */
+} Status;
+
+#define FLAG_CERTIFICATE 1  /**< Flag of a request that asks for a certificate. */
+
+/**
+ * \brief A worker that serves requests with its own environment.
+ */
+
+typedef struct
+{
+  CMR* cmr;             /**< \ref CMR environment of the worker. */
+  int listenSocket;     /**< Listening socket, or -1 for serving stdin. */
+  int outputFd;         /**< File descriptor for the responses to requests from stdin. */
+  size_t maxMatrixSize; /**< Maximum size of a matrix record in bytes. */
+  size_t numRequests;   /**< Number of requests served. */
+  CMR_ERROR error;      /**< Error that terminated the worker. */
+} Worker;
+
+static
+uint32_t decode32(const unsigned char* bytes)
+{
+  return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+static
+uint64_t decode64(const unsigned char* bytes)
+{
+  return decode32(bytes) | ((uint64_t) decode32(bytes + 4) << 32);
+}
+
+static
+void encode32(unsigned char* bytes, uint32_t value)
+{
+  for (int i = 0; i < 4; ++i)
+    bytes[i] = (unsigned char) (value >> (8 * i));
+}
+
+static
+void encode64(unsigned char* bytes, uint64_t value)
+{
+  encode32(bytes, (uint32_t) value);
+  encode32(bytes + 4, (uint32_t) (value >> 32));
+}
+
+/**
+ * \brief Reads exactly \p size bytes from \p fd.
+ *
+ * \returns The number of bytes read, which is smaller than \p size only at the end of the input or on an error.
+ */
+
+static
+size_t readFully(int fd, void* buffer, size_t size)
+{
+  size_t done = 0;
+  while (done < size)
+  {
+    ssize_t count = read(fd, (char*) buffer + done, size - done);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      break;
+    done += (size_t) count;
+  }
+  return done;
+}
+
+/**
+ * \brief Reads a matrix record of \p length bytes from \p fd into a buffer that grows as the bytes arrive.
+ *
+ * If \p length exceeds \p maxLength or the buffer cannot be enlarged, then the remaining bytes are discarded and
+ * \p *precord is \c NULL.
+ *
+ * \returns Whether all \p length bytes were read.
+ */
+
+static
+bool readRecord(
+  CMR* cmr,         /**< \ref CMR environment. */
+  int fd,           /**< File descriptor to read from. */
+  size_t length,    /**< Length of the record. */
+  size_t maxLength, /**< Maximum length of a record that is stored. */
+  char** precord    /**< Pointer for storing the record, which has an additional byte. */
+)
+{
+  char* record = NULL;
+  size_t capacity = length < READ_CHUNK_SIZE ? length : READ_CHUNK_SIZE;
+  if (length > maxLength || CMRallocBlockArray(cmr, &record, capacity + 1))
+    record = NULL;
+
+  char discarded[READ_CHUNK_SIZE];
+  size_t done = 0;
+  while (done < length)
+  {
+    if (record && done == capacity)
+    {
+      size_t newCapacity = capacity > length - capacity ? length : 2 * capacity;
+      if (CMRreallocBlockArray(cmr, &record, newCapacity + 1) == CMR_OKAY)
+        capacity = newCapacity;
+      else
+        CMRfreeBlockArray(cmr, &record);
+    }
+
+    size_t count = record ? capacity - done : (length - done < READ_CHUNK_SIZE ? length - done : READ_CHUNK_SIZE);
+    if (readFully(fd, record ? &record[done] : discarded, count) != count)
+    {
+      if (record)
+        CMRfreeBlockArray(cmr, &record);
+      return false;
+    }
+    done += count;
+  }
+
+  *precord = record;
+  return true;
+}
+
+/**
+ * \brief Writes exactly \p size bytes to \p fd.
+ *
+ * \returns Whether all bytes were written.
+ */
+
+static
+bool writeFully(int fd, const void* buffer, size_t size)
+{
+  size_t done = 0;
+  while (done < size)
+  {
+    ssize_t count = write(fd, (const char*) buffer + done, size - done);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      return false;
+    done += (size_t) count;
+  }
+  return true;
+}
+
+/**
+ * \brief Sends a response with the given \p status, \p result and \p payload.
+ */
+
+static
+bool sendResponse(int fd, Status status, bool result, const char* payload, size_t payloadLength)
+{
+  unsigned char header[HEADER_SIZE];
+  memcpy(header, "CMRR", 4);
+  encode32(header + 4, status);
+  encode32(header + 8, result ? 1 : 0);
+  encode32(header + 12, 0);
+  encode64(header + 16, payloadLength);
+
+  return writeFully(fd, header, HEADER_SIZE) && (payloadLength == 0 || writeFully(fd, payload, payloadLength));
+}
+
+/**
+ * \brief Writes the edge list of the (di)graph of a (co)graphic or (co)network matrix to \p stream.
+ *
+ * The edges of rows are named \c r1, \c r2, etc. and those of columns \c c1, \c c2, etc.
+ */
+
+static
+void printEdgeList(
+  FILE* stream,             /**< Stream to write to. */
+  CMR_GRAPH* graph,         /**< (Di)graph. */
+  size_t numRows,           /**< Number of rows. */
+  CMR_GRAPH_EDGE* rowEdges, /**< Edges of the rows. */
+  size_t numColumns,        /**< Number of columns. */
+  CMR_GRAPH_EDGE* columnEdges,  /**< Edges of the columns. */
+  bool* edgesReversed       /**< Whether each edge is reversed (may be \c NULL). */
+)
+{
+  for (size_t i = 0; i < numRows + numColumns; ++i)
+  {
+    CMR_GRAPH_EDGE e = i < numRows ? rowEdges[i] : columnEdges[i - numRows];
+    CMR_GRAPH_NODE u = CMRgraphEdgeU(graph, e);
+    CMR_GRAPH_NODE v = CMRgraphEdgeV(graph, e);
+    if (edgesReversed && edgesReversed[e])
+    {
+      CMR_GRAPH_NODE temp = u;
+      u = v;
+      v = temp;
+    }
+    fprintf(stream, "%d %d %c%zu\n", u, v, i < numRows ? 'r' : 'c', (i < numRows ? i : i - numRows) + 1);
+  }
+}
+
+/**
+ * \brief Carries out the \p task for \p matrix and writes the certificate, if requested, to \p certificate.
+ */
+
+static
+CMR_ERROR runTask(
+  CMR* cmr,             /**< \ref CMR environment. */
+  Task task,            /**< Task. */
+  CMR_CHRMAT* matrix,   /**< Matrix. */
+  FILE* certificate,    /**< Stream for the certificate, or \c NULL. */
+  double timeLimit,     /**< Time limit to impose. */
+  bool* presult         /**< Pointer for storing the result. */
+)
+{
+  /* Non-ternary matrices have none of the properties. */
+  CMR_SUBMAT* submatrix = NULL;
+  bool graphicTask = task == TASK_GRAPHIC || task == TASK_COGRAPHIC;
+  if (graphicTask ? !CMRchrmatIsBinary(cmr, matrix, &submatrix) : !CMRchrmatIsTernary(cmr, matrix, &submatrix))
+  {
+    *presult = false;
+    if (certificate)
+      CMR_CALL( CMRsubmatPrint(cmr, submatrix, matrix->numRows, matrix->numColumns, certificate) );
+    CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    return CMR_OKAY;
+  }
+
+  CMR_SUBMAT** psubmatrix = certificate ? &submatrix : NULL;
+  CMR_GRAPH* graph = NULL;
+  CMR_GRAPH_EDGE* rowEdges = NULL;
+  CMR_GRAPH_EDGE* columnEdges = NULL;
+  bool* edgesReversed = NULL;
+  switch (task)
+  {
+  case TASK_TU:
+  {
+    CMR_TU_PARAMS params;
+    CMR_CALL( CMRtuParamsInit(&params) );
+    CMR_CALL( CMRtuTest(cmr, matrix, presult, NULL, psubmatrix, &params, NULL, timeLimit) );
+    break;
+  }
+  case TASK_NETWORK:
+    CMR_CALL( CMRnetworkTestMatrix(cmr, matrix, presult, NULL, certificate ? &graph : NULL,
+      certificate ? &rowEdges : NULL, certificate ? &columnEdges : NULL, certificate ? &edgesReversed : NULL,
+      psubmatrix, NULL, timeLimit) );
+    break;
+  case TASK_CONETWORK:
+    CMR_CALL( CMRnetworkTestTranspose(cmr, matrix, presult, NULL, certificate ? &graph : NULL,
+      certificate ? &columnEdges : NULL, certificate ? &rowEdges : NULL, certificate ? &edgesReversed : NULL,
+      psubmatrix, NULL, timeLimit) );
+    break;
+  case TASK_GRAPHIC:
+    CMR_CALL( CMRgraphicTestMatrix(cmr, matrix, presult, certificate ? &graph : NULL, certificate ? &rowEdges : NULL,
+      certificate ? &columnEdges : NULL, psubmatrix, NULL, timeLimit) );
+    break;
+  case TASK_COGRAPHIC:
+    CMR_CALL( CMRgraphicTestTranspose(cmr, matrix, presult, certificate ? &graph : NULL,
+      certificate ? &columnEdges : NULL, certificate ? &rowEdges : NULL, psubmatrix, NULL, timeLimit) );
+    break;
+  default:
+    return CMR_ERROR_INPUT;
+  }
+
+  if (certificate)
+  {
+    if (graph)
+      printEdgeList(certificate, graph, matrix->numRows, rowEdges, matrix->numColumns, columnEdges, edgesReversed);
+    else if (submatrix)
+      CMR_CALL( CMRsubmatPrint(cmr, submatrix, matrix->numRows, matrix->numColumns, certificate) );
+  }
+
+  if (edgesReversed)
+    CMR_CALL( CMRfreeBlockArray(cmr, &edgesReversed) );
+  if (rowEdges)
+    CMR_CALL( CMRfreeBlockArray(cmr, &rowEdges) );
+  if (columnEdges)
+    CMR_CALL( CMRfreeBlockArray(cmr, &columnEdges) );
+  if (graph)
+    CMR_CALL( CMRgraphFree(cmr, &graph) );
+  CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+
+  return CMR_OKAY;
+}
+
+/**
+ * \brief Serves the requests arriving at \p inputFd until the end of the input, answering them at \p outputFd.
+ */
+
+static
+CMR_ERROR serve(
+  Worker* worker, /**< Worker. */
+  int inputFd,    /**< File descriptor to read requests from. */
+  int outputFd    /**< File descriptor to write responses to. */
+)
+{
+  CMR* cmr = worker->cmr;
+  unsigned char header[HEADER_SIZE];
+  size_t headerLength;
+  while ((headerLength = readFully(inputFd, header, HEADER_SIZE)) == HEADER_SIZE)
+  {
+    uint32_t task = decode32(header + 4);
+    uint32_t flags = decode32(header + 8);
+    uint32_t timeLimitMilliseconds = decode32(header + 12);
+    uint64_t matrixLength = decode64(header + 16);
+    if (memcmp(header, "CMRQ", 4) || matrixLength > SIZE_MAX - 1)
+    {
+      static const char message[] = "Invalid request header.";
+      sendResponse(outputFd, STATUS_INPUT, false, message, sizeof(message) - 1);
+      return CMR_ERROR_INPUT;
+    }
+
+    /* Too large records and those that do not fit into memory are skipped such that the next request can be read.
+     * The former are answered immediately since the client may wait for the response before sending the record. */
+    char message[128];
+    if (matrixLength > worker->maxMatrixSize)
+    {
+      snprintf(message, sizeof(message), "Matrix of %llu bytes exceeds the maximum size of %zu bytes.",
+        (unsigned long long) matrixLength, worker->maxMatrixSize);
+      if (!sendResponse(outputFd, STATUS_INPUT, false, message, strlen(message)))
+        return CMR_ERROR_OUTPUT;
+    }
+    char* record = NULL;
+    if (!readRecord(cmr, inputFd, (size_t) matrixLength, worker->maxMatrixSize, &record))
+      return CMR_ERROR_INPUT;
+    ++worker->numRequests;
+    if (!record)
+    {
+      if (matrixLength > worker->maxMatrixSize)
+        continue;
+      CMRclearErrorMessage(cmr);
+      snprintf(message, sizeof(message), "Cannot allocate memory for a matrix of %llu bytes.",
+        (unsigned long long) matrixLength);
+      if (!sendResponse(outputFd, STATUS_ERROR, false, message, strlen(message)))
+        return CMR_ERROR_OUTPUT;
+      continue;
+    }
+
+    /* The payload is collected in memory since its length precedes it. */
+    char* payload = NULL;
+    size_t payloadLength = 0;
+    FILE* payloadStream = open_memstream(&payload, &payloadLength);
+    if (!payloadStream)
+    {
+      CMR_CALL( CMRfreeBlockArray(cmr, &record) );
+      if (!sendResponse(outputFd, STATUS_ERROR, false, NULL, 0))
+        return CMR_ERROR_OUTPUT;
+      continue;
+    }
+
+    Status status = STATUS_OKAY;
+    bool result = false;
+    CMR_CHRMAT* matrix = NULL;
+    FILE* recordStream = fmemopen(record, matrixLength ? matrixLength : 1, "rb");
+    CMR_ERROR error = recordStream ? CMRchrmatCreateFromBinaryStream(cmr, recordStream, &matrix) : CMR_ERROR_MEMORY;
+    if (recordStream)
+      fclose(recordStream);
+    if (!error && task >= TASK_TU && task <= TASK_COGRAPHIC)
+    {
+      double timeLimit = timeLimitMilliseconds ? timeLimitMilliseconds / 1000.0 : DBL_MAX;
+      error = runTask(cmr, (Task) task, matrix, (flags & FLAG_CERTIFICATE) ? payloadStream : NULL, timeLimit,
+        &result);
+    }
+    else if (!error)
+    {
+      fprintf(payloadStream, "Unknown task %u.", task);
+      status = STATUS_INPUT;
+    }
+    if (matrix)
+      CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+    CMR_CALL( CMRfreeBlockArray(cmr, &record) );
+
+    if (error)
+    {
+      /* An error invalidates a partially written certificate. */
+      fclose(payloadStream);
+      free(payload);
+      payload = NULL;
+      payloadLength = 0;
+      payloadStream = open_memstream(&payload, &payloadLength);
+      status = error == CMR_ERROR_INPUT ? STATUS_INPUT : (error == CMR_ERROR_TIMEOUT ? STATUS_TIMEOUT : STATUS_ERROR);
+      if (payloadStream && status == STATUS_INPUT && CMRgetErrorMessage(cmr))
+        fputs(CMRgetErrorMessage(cmr), payloadStream);
+      CMRclearErrorMessage(cmr);
+    }
+    if (payloadStream)
+      fclose(payloadStream);
+
+    bool sent = sendResponse(outputFd, status, result, payload, payloadLength);
+    free(payload);
+    if (!sent)
+      return CMR_ERROR_OUTPUT;
+
+    /* Running out of memory only fails the current request, whose memory was freed. Other errors may leave the
+     * environment in an unknown state, so the connection is closed. */
+    if (status == STATUS_ERROR && error != CMR_ERROR_MEMORY)
+      return error;
+  }
+
+  return headerLength == 0 ? CMR_OKAY : CMR_ERROR_INPUT;
+}
+
+/**
+ * \brief Main function of a worker, which accepts connections one after another or serves stdin.
+ */
+
+static
+void* workerMain(void* data)
+{
+  Worker* worker = (Worker*) data;
+  if (worker->listenSocket < 0)
+  {
+    worker->error = serve(worker, STDIN_FILENO, worker->outputFd);
+    return NULL;
+  }
+
+  while (true)
+  {
+    int connection = accept(worker->listenSocket, NULL, NULL);
+    if (connection < 0)
+    {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      worker->error = CMR_ERROR_OUTPUT;
+      return NULL;
+    }
+
+    /* Errors only terminate the connection in which they occur, such that the worker keeps serving. */
+    serve(worker, connection, connection);
+    close(connection);
+  }
+}
+
+/**
+ * \brief Prints the usage of the \p program to stderr.
+ *
+ * \returns \c EXIT_FAILURE.
+ */
+
+static
+int printUsage(const char* program)
+{
+  fputs("Usage:\n", stderr);
+  fprintf(stderr, "%s [OPTION]...\n\n", program);
+  fputs("  answers requests for recognizing matrices without restarting for each matrix.\n\n", stderr);
+  fputs("Options:\n", stderr);
+  fputs("  -s SOCKET  Listen on the UNIX domain socket SOCKET instead of reading requests from stdin.\n", stderr);
+  fputs("  -j NUM     Number of connections to the socket that are served concurrently; default: 1.\n", stderr);
+  fputs("  --max-matrix-size MB  Reject matrices of more than MB megabytes; default: 64.\n", stderr);
+  fputs("  --memory-limit MB     Allow at most MB megabytes of memory for each worker.\n\n", stderr);
+  fputs("Each request consists of a 24-byte header and a matrix in binary format. The header consists of the\n", stderr);
+  fputs("characters `CMRQ', the task (1: totally unimodular, 2: network, 3: conetwork, 4: graphic,\n", stderr);
+  fputs("5: cographic), the flags (1: certificate), the time limit in milliseconds (0 for none), each as a\n", stderr);
+  fputs("32-bit integer, and the size of the matrix in bytes as a 64-bit integer, all in little-endian byte order.\n",
+    stderr);
+  fputs("Each response consists of a 24-byte header and a payload. The header consists of the characters `CMRR',\n",
+    stderr);
+  fputs("the status (0: okay, 1: input error, 2: timeout, 3: other error), the result (1 if the matrix has the\n",
+    stderr);
+  fputs("property) and 0, each as a 32-bit integer, and the size of the payload as a 64-bit integer. The payload is\n",
+    stderr);
+  fputs("an error message, a violating submatrix or an edge list of the (di)graph.\n", stderr);
+
+  return EXIT_FAILURE;
+}
+
+int main(int argc, char** argv)
+{
+  const char* socketFileName = NULL;
+  int numWorkers = 1;
+  size_t maxMatrixSize = DEFAULT_MAX_MATRIX_SIZE;
+  size_t memoryLimit = 0;
+  for (int a = 1; a < argc; ++a)
+  {
+    if (!strcmp(argv[a], "-h"))
+    {
+      printUsage(argv[0]);
+      return EXIT_SUCCESS;
+    }
+    else if (!strcmp(argv[a], "-s") && a+1 < argc)
+      socketFileName = argv[++a];
+    else if (!strcmp(argv[a], "-j") && a+1 < argc)
+    {
+      char* p;
+      numWorkers = strtol(argv[a+1], &p, 10);
+      if (*p != '\0' || numWorkers < 1)
+      {
+        fprintf(stderr, "Error: invalid number of workers <%s>.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--max-matrix-size") && a+1 < argc)
+    {
+      double megabytes;
+      if (sscanf(argv[a+1], "%lf", &megabytes) != 1 || megabytes <= 0 || megabytes >= (double) (SIZE_MAX >> 20))
+      {
+        fprintf(stderr, "Error: Invalid maximum matrix size <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      maxMatrixSize = (size_t) (megabytes * 1024 * 1024);
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--memory-limit") && a+1 < argc)
+    {
+      double megabytes;
+      if (sscanf(argv[a+1], "%lf", &megabytes) != 1 || megabytes <= 0 || megabytes >= (double) (SIZE_MAX >> 20))
+      {
+        fprintf(stderr, "Error: Invalid memory limit <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      memoryLimit = (size_t) (megabytes * 1024 * 1024);
+      ++a;
+    }
+    else
+    {
+      fprintf(stderr, "Error: Unknown option <%s>.\n\n", argv[a]);
+      return printUsage(argv[0]);
+    }
+  }
+
+#if !defined(CMR_WITH_THREADS)
+  if (numWorkers > 1)
+  {
+    fputs("Warning: CMR was compiled without thread support; serving one connection at a time.\n", stderr);
+    numWorkers = 1;
+  }
+#endif /* !CMR_WITH_THREADS */
+  if (!socketFileName)
+    numWorkers = 1;
+
+  /* A client that disconnects early must not terminate the server. */
+  signal(SIGPIPE, SIG_IGN);
+
+  int listenSocket = -1;
+  if (socketFileName)
+  {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketFileName) >= sizeof(address.sun_path))
+    {
+      fprintf(stderr, "Error: Socket name <%s> is too long.\n", socketFileName);
+      return EXIT_FAILURE;
+    }
+    strcpy(address.sun_path, socketFileName);
+    listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket < 0 || bind(listenSocket, (struct sockaddr*) &address, sizeof(address))
+      || listen(listenSocket, 64))
+    {
+      fprintf(stderr, "Error: Cannot listen on socket <%s>: %s\n", socketFileName, strerror(errno));
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* Responses to requests from stdin are written to a duplicate of stdout, such that messages that are printed to
+   * stdout cannot interfere with them. */
+  int outputFd = -1;
+  if (!socketFileName)
+  {
+    outputFd = dup(STDOUT_FILENO);
+    if (outputFd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+    {
+      fprintf(stderr, "Error: Cannot redirect stdout: %s\n", strerror(errno));
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* The environments of the workers are created once and reused for all requests. */
+  Worker* workers = calloc(numWorkers, sizeof(Worker));
+  if (!workers)
+    return EXIT_FAILURE;
+  for (int w = 0; w < numWorkers; ++w)
+  {
+    workers[w].listenSocket = listenSocket;
+    workers[w].outputFd = outputFd;
+    workers[w].maxMatrixSize = maxMatrixSize;
+    if (CMRcreateEnvironment(&workers[w].cmr) || CMRsetMemoryLimit(workers[w].cmr, memoryLimit))
+      return EXIT_FAILURE;
+  }
+
+#if defined(CMR_WITH_THREADS)
+  pthread_t* threads = calloc(numWorkers, sizeof(pthread_t));
+  for (int w = 1; w < numWorkers; ++w)
+  {
+    if (pthread_create(&threads[w], NULL, workerMain, &workers[w]))
+    {
+      fprintf(stderr, "Error: Cannot start worker %d.\n", w);
+      return EXIT_FAILURE;
+    }
+  }
+  workerMain(&workers[0]);
+  for (int w = 1; w < numWorkers; ++w)
+    pthread_join(threads[w], NULL);
+  free(threads);
+#else
+  workerMain(&workers[0]);
+#endif /* CMR_WITH_THREADS */
+
+  CMR_ERROR error = CMR_OKAY;
+  for (int w = 0; w < numWorkers; ++w)
+  {
+    if (workers[w].error && !error)
+      error = workers[w].error;
+    CMRfreeEnvironment(&workers[w].cmr);
+  }
+  free(workers);
+  if (outputFd >= 0)
+    close(outputFd);
+  if (listenSocket >= 0)
+  {
+    close(listenSocket);
+    unlink(socketFileName);
+  }
+
+  switch (error)
+  {
+  case CMR_ERROR_INPUT:
+    fputs("Input error.\n", stderr);
+    return EXIT_FAILURE;
+  case CMR_ERROR_MEMORY:
+    fputs("Memory error.\n", stderr);
+    return EXIT_FAILURE;
+  case CMR_OKAY:
+    return EXIT_SUCCESS;
+  default:
+    fputs("Error.\n", stderr);
+    return EXIT_FAILURE;
+  }
+}
@@ -9,12 +9,46 @@
 #include <cmr/tu.h>
 #include <cmr/linear_algebra.h>
 
+#include "checkpoint_file.h"
+#include "result_cache.h"
+
 typedef enum
 {
   FILEFORMAT_MATRIX_DENSE = 1,    /**< Dense matrix format. */
   FILEFORMAT_MATRIX_SPARSE = 2,   /**< Sparse matrix format. */
+  FILEFORMAT_MATRIX_BINARY = 3,   /**< Binary matrix format. */
+  FILEFORMAT_MATRIX_CONTAINER = 4 /**< Matrix container format. */
 } FileFormat;
 
+/**
+ * \brief Writes the decomposition tree and the non-TU submatrix of a cached result.
+ */
+
+static
+CMR_ERROR printCachedOutputs(
+  CMR_RESULT_ENTRY* entry,              /**< Cached result. */
+  const char* outputTreeFileName,       /**< File name to print decomposition tree to, or \c NULL. */
+  const char* outputSubmatrixFileName   /**< File name to print non-TU submatrix to, or \c NULL. */
+)
+{
+  CMR_RESULT_SECTION* section = CMRresultCacheSection(entry, "decomposition");
+  if (outputTreeFileName && section)
+    CMR_CALL( CMRresultCacheWriteSection(section, stderr) );
+
+  section = CMRresultCacheSection(entry, "submatrix");
+  CMR_RESULT_SECTION* determinant = CMRresultCacheSection(entry, "determinant");
+  if (outputSubmatrixFileName && !entry->verdict && section && determinant)
+  {
+    bool outputSubmatrixToFile = strcmp(outputSubmatrixFileName, "-");
+    fprintf(stderr, "Writing minimal non-totally-unimodular submatrix with absolute determinant %s to %s%s%s.\n",
+      determinant->data, outputSubmatrixToFile ? "file <" : "",
+      outputSubmatrixToFile ? outputSubmatrixFileName : "stdout", outputSubmatrixToFile ? ">" : "");
+    CMR_CALL( CMRresultCacheWriteSectionToFile(section, outputSubmatrixFileName) );
+  }
+
+  return CMR_OKAY;
+}
+
 /**
  * \brief Tests matrix from a file for total unimodularity.
  */
@@ -26,14 +60,30 @@ CMR_ERROR testTotalUnimodularity(
   const char* outputTreeFileName,       /**< File name to print decomposition tree to, or \c NULL. */
   const char* outputSubmatrixFileName,  /**< File name to print non-TU submatrix to, or \c NULL. */
   bool printStats,                      /**< Whether to print statistics to stderr. */
+  const char* statsJsonFileName,        /**< File name to write statistics in JSON format to, or \c NULL. */
+  bool hardwareCounters,                /**< Whether to record hardware performance counters for the statistics. */
   bool directGraphicness,               /**< Whether to use fast graphicness routines. */
   bool seriesParallel,                  /**< Whether to allow series-parallel operations in the decomposition tree. */
+  CMR_REGULAR_SCHEDULE schedule,        /**< Order in which decomposition nodes are processed. */
+  bool twoByTwo,                        /**< Whether to first search for 2-by-2 submatrices with determinant -2 or +2. */
+  bool consecutiveOnes,                 /**< Whether to first test binary matrices for the consecutive ones property. */
+  bool useCache,                        /**< Whether to reuse the results for leaves with equal matrices. */
+  const char* cacheDirectory,           /**< Directory of the result cache, or \c NULL. */
+  const char* checkpointFileName,       /**< File name of the checkpoint for resuming the test, or \c NULL. */
   CMR_TU_ALGORITHM algorithm,           /**< Algorithm to use for TU test. */
-  double timeLimit                      /**< Time limit to impose. */
+  double timeLimit,                     /**< Time limit to impose. */
+  size_t memoryLimit,                   /**< Memory limit in bytes, or 0 for none. */
+  int numThreads,                       /**< Number of threads to use. */
+  bool pinThreads                       /**< Whether to bind the threads to processors. */
 )
 {
   CMR* cmr = NULL;
   CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+  CMR_CALL( CMRsetThreadPinning(cmr, pinThreads) );
+  if (hardwareCounters)
+    CMR_CALL( CMRsetHardwareCounters(cmr, true) );
+  CMR_CALL( CMRsetMemoryLimit(cmr, memoryLimit) );
 
   /* Read matrix. */
 
@@ -44,6 +94,8 @@ CMR_ERROR testTotalUnimodularity(
     error = CMRchrmatCreateFromDenseFile(cmr, inputMatrixFileName, "-", &matrix);
   else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
     error = CMRchrmatCreateFromSparseFile(cmr, inputMatrixFileName, "-", &matrix);
+  else if (inputFormat == FILEFORMAT_MATRIX_BINARY)
+    error = CMRchrmatCreateFromBinaryFile(cmr, inputMatrixFileName, "-", &matrix);
   else
     CMR_CALL(CMR_ERROR_INVALID);
 
@@ -57,6 +109,28 @@ CMR_ERROR testTotalUnimodularity(
   fprintf(stderr, "Read %zux%zu matrix with %zu nonzeros in %f seconds.\n", matrix->numRows, matrix->numColumns,
     matrix->numNonzeros, (clock() - readClock) * 1.0 / CLOCKS_PER_SEC);
 
+  /* Consult the result cache. */
+
+  CMR_RESULT_ENTRY entry;
+  if (cacheDirectory)
+  {
+    char parameters[96];
+    snprintf(parameters, sizeof(parameters), "algorithm=%d direct-graphic=%d series-parallel=%d", (int) algorithm,
+      directGraphicness ? 1 : 0, seriesParallel ? 1 : 0);
+    CMR_CALL( CMRresultCacheOpen(cacheDirectory, "cmr-tu", parameters, matrix, &entry) );
+    if (entry.hasVerdict && (!outputTreeFileName || CMRresultCacheSection(&entry, "decomposition"))
+      && (!outputSubmatrixFileName || entry.verdict || CMRresultCacheSection(&entry, "submatrix")))
+    {
+      fprintf(stderr, "Found result in cache file <%s>.\n", entry.path);
+      printf("Matrix %stotally unimodular.\n", entry.verdict ? "IS " : "IS NOT ");
+      CMR_CALL( printCachedOutputs(&entry, outputTreeFileName, outputSubmatrixFileName) );
+      CMRresultCacheClose(&entry);
+      CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+      CMR_CALL( CMRfreeEnvironment(&cmr) );
+      return CMR_OKAY;
+    }
+  }
+
   /* Actual test. */
 
   bool isTU;
@@ -68,19 +142,102 @@ CMR_ERROR testTotalUnimodularity(
   params.regular.completeTree = outputTreeFileName;
   params.regular.directGraphicness = directGraphicness;
   params.regular.seriesParallel = seriesParallel;
+  params.directTwoByTwo = twoByTwo;
+  params.directConsecutiveOnes = consecutiveOnes;
+  params.regular.schedule = schedule;
+  if (cacheDirectory)
+    CMR_CALL( CMRresultCacheLoadLeaves(cmr, cacheDirectory, &params.regular.cache) );
+  else if (useCache)
+    CMR_CALL( CMRregularCacheCreate(cmr, &params.regular.cache) );
+  if (checkpointFileName)
+    CMR_CALL( CMRcheckpointFileLoad(cmr, checkpointFileName, &params.regular.checkpoint) );
   CMR_TU_STATS stats;
   CMR_CALL( CMRtuStatsInit(&stats));
-  CMR_CALL( CMRtuTest(cmr, matrix, &isTU, outputTreeFileName ? &decomposition : NULL,
-    outputSubmatrixFileName ? &submatrix : NULL, &params, &stats, timeLimit) );
+  error = CMRtuTest(cmr, matrix, &isTU, outputTreeFileName ? &decomposition : NULL,
+    outputSubmatrixFileName ? &submatrix : NULL, &params, &stats, timeLimit);
+  if (checkpointFileName && (error == CMR_OKAY || error == CMR_ERROR_TIMEOUT))
+    CMR_CALL( CMRcheckpointFileStore(cmr, checkpointFileName, &params.regular.checkpoint) );
+  if (error == CMR_ERROR_TIMEOUT && cacheDirectory && entry.hasVerdict)
+  {
+    fprintf(stderr, "Warning: Time limit exceeded; using incomplete result from cache file <%s>.\n", entry.path);
+    printf("Matrix %stotally unimodular.\n", entry.verdict ? "IS " : "IS NOT ");
+    CMR_CALL( printCachedOutputs(&entry, outputTreeFileName, outputSubmatrixFileName) );
+    CMRresultCacheClose(&entry);
+    CMR_CALL( CMRregularCacheFree(cmr, &params.regular.cache) );
+    CMR_CALL( CMRmatroiddecFree(cmr, &decomposition) );
+    CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+    CMR_CALL( CMRfreeEnvironment(&cmr) );
+    return CMR_OKAY;
+  }
+  CMR_CALL( error );
 
   printf("Matrix %stotally unimodular.\n", isTU ? "IS " : "IS NOT ");
   if (printStats)
+  {
     CMR_CALL( CMRtuStatsPrint(stderr, &stats, NULL) );
+    CMR_MEMORY_STATS memoryStats;
+    CMR_CALL( CMRgetMemoryStats(cmr, &memoryStats) );
+    CMR_CALL( CMRmemoryStatsPrint(stderr, &memoryStats, NULL) );
+  }
+  if (statsJsonFileName)
+  {
+    FILE* statsJsonFile = strcmp(statsJsonFileName, "-") ? fopen(statsJsonFileName, "w") : stdout;
+    if (!statsJsonFile)
+    {
+      fprintf(stderr, "Error: Cannot write to file <%s>.\n", statsJsonFileName);
+      return CMR_ERROR_OUTPUT;
+    }
+    CMR_CALL( CMRtuStatsPrintJson(statsJsonFile, &stats) );
+    fputc('\n', statsJsonFile);
+    if (statsJsonFile != stdout)
+      fclose(statsJsonFile);
+  }
 
-  if (decomposition)
+  if (cacheDirectory)
+  {
+    /* Print the outputs into temporary files such that they can be stored in the cache. */
+    entry.hasVerdict = true;
+    entry.verdict = isTU;
+    if (decomposition)
+    {
+      FILE* stream = tmpfile();
+      if (!stream)
+        return CMR_ERROR_OUTPUT;
+      CMR_CALL( CMRmatroiddecPrint(cmr, decomposition, stream, 0, true, true, true, true, true, true) );
+      CMR_CALL( CMRresultCacheCapture(&entry, "decomposition", stream) );
+      fclose(stream);
+    }
+    if (submatrix && outputSubmatrixFileName)
+    {
+      CMR_CHRMAT* violator = NULL;
+      int64_t determinant = 0;
+      CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, submatrix, &violator) );
+      CMR_CALL( CMRchrmatDeterminant(cmr, violator, &determinant) );
+      CMR_CALL( CMRchrmatFree(cmr, &violator) );
+
+      FILE* stream = tmpfile();
+      if (!stream)
+        return CMR_ERROR_OUTPUT;
+      fprintf(stream, "%ld", determinant);
+      CMR_CALL( CMRresultCacheCapture(&entry, "determinant", stream) );
+      fclose(stream);
+      stream = tmpfile();
+      if (!stream)
+        return CMR_ERROR_OUTPUT;
+      CMR_CALL( CMRsubmatPrint(cmr, submatrix, matrix->numRows, matrix->numColumns, stream) );
+      CMR_CALL( CMRresultCacheCapture(&entry, "submatrix", stream) );
+      fclose(stream);
+    }
+    CMR_CALL( printCachedOutputs(&entry, outputTreeFileName, outputSubmatrixFileName) );
+    CMR_CALL( CMRresultCacheStore(&entry) );
+    CMR_CALL( CMRresultCacheStoreLeaves(cmr, cacheDirectory, params.regular.cache) );
+    CMRresultCacheClose(&entry);
+  }
+  else if (decomposition)
     CMR_CALL( CMRmatroiddecPrint(cmr, decomposition, stderr, 0, true, true, true, true, true, true) );
 
-  if (submatrix && outputSubmatrixFileName)
+  if (submatrix && outputSubmatrixFileName && !cacheDirectory)
   {
     /* Extract submatrix to compute its determinant. */
     CMR_CHRMAT* violator = NULL;
@@ -99,6 +256,7 @@ CMR_ERROR testTotalUnimodularity(
 
   /* Cleanup. */
 
+  CMR_CALL( CMRregularCacheFree(cmr, &params.regular.cache) );
   CMR_CALL( CMRmatroiddecFree(cmr, &decomposition) );
   CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
   CMR_CALL( CMRchrmatFree(cmr, &matrix) );
@@ -107,6 +265,199 @@ CMR_ERROR testTotalUnimodularity(
   return CMR_OKAY;
 }
 
+/**
+ * \brief Number of matrices that are read before they are tested in a batch.
+ */
+
+#define BATCH_SIZE 1024
+
+/**
+ * \brief Tests a stream of matrices from a file for total unimodularity.
+ *
+ * The matrices are read in chunks of \ref BATCH_SIZE, each of which is tested by \ref CMRtuTestBatch. For a matrix
+ * container, only the records of the given shard are tested, which is the \p shard'th of \p numShards ranges of
+ * consecutive records of almost equal lengths.
+ */
+
+static
+CMR_ERROR testTotalUnimodularityBatch(
+  const char* inputMatrixFileName,      /**< File name containing the input matrices (may be `-' for stdin). */
+  FileFormat inputFormat,               /**< Format of the input matrices. */
+  bool printStats,                      /**< Whether to print statistics to stderr. */
+  bool directGraphicness,               /**< Whether to use fast graphicness routines. */
+  bool seriesParallel,                  /**< Whether to allow series-parallel operations in the decomposition tree. */
+  CMR_REGULAR_SCHEDULE schedule,        /**< Order in which decomposition nodes are processed. */
+  bool twoByTwo,                        /**< Whether to first search for 2-by-2 submatrices with determinant -2 or +2. */
+  bool consecutiveOnes,                 /**< Whether to first test binary matrices for the consecutive ones property. */
+  bool useCache,                        /**< Whether to reuse the results for leaves with equal matrices. */
+  const char* cacheDirectory,           /**< Directory with the cache of regular leaves, or \c NULL. */
+  CMR_TU_ALGORITHM algorithm,           /**< Algorithm to use for TU test. */
+  double timeLimit,                     /**< Time limit to impose. */
+  size_t memoryLimit,                   /**< Memory limit in bytes, or 0 for none. */
+  int numThreads,                       /**< Number of threads to use. */
+  bool pinThreads,                      /**< Whether to bind the threads to processors. */
+  size_t shard,                         /**< Index of the shard of a matrix container to test. */
+  size_t numShards                      /**< Number of shards of a matrix container. */
+)
+{
+  FILE* inputMatrixFile = NULL;
+  if (inputFormat != FILEFORMAT_MATRIX_CONTAINER)
+  {
+    inputMatrixFile = strcmp(inputMatrixFileName, "-") ? fopen(inputMatrixFileName, "rb") : stdin;
+    if (!inputMatrixFile)
+      return CMR_ERROR_INPUT;
+  }
+
+  CMR* cmr = NULL;
+  CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+  CMR_CALL( CMRsetThreadPinning(cmr, pinThreads) );
+  CMR_CALL( CMRsetMemoryLimit(cmr, memoryLimit) );
+
+  CMR_TU_PARAMS params;
+  CMR_CALL( CMRtuParamsInit(&params) );
+  params.algorithm = algorithm;
+  params.regular.directGraphicness = directGraphicness;
+  params.regular.seriesParallel = seriesParallel;
+  params.directTwoByTwo = twoByTwo;
+  params.directConsecutiveOnes = consecutiveOnes;
+  params.regular.schedule = schedule;
+  if (cacheDirectory)
+    CMR_CALL( CMRresultCacheLoadLeaves(cmr, cacheDirectory, &params.regular.cache) );
+  else if (useCache)
+    CMR_CALL( CMRregularCacheCreate(cmr, &params.regular.cache) );
+
+  CMR_CHRMAT** matrices = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &matrices, BATCH_SIZE) );
+  bool* isTU = NULL;
+  CMR_CALL( CMRallocBlockArray(cmr, &isTU, BATCH_SIZE) );
+
+  CMR_ERROR error = CMR_OKAY;
+  CMR_MATRIX_CONTAINER* container = NULL;
+  size_t firstRecord = 0;
+  size_t beyondRecord = 0;
+  if (inputFormat == FILEFORMAT_MATRIX_CONTAINER)
+  {
+    error = CMRmatrixContainerOpen(cmr, inputMatrixFileName, "-", &container);
+    if (error)
+    {
+      fprintf(stderr, "Input error: %s\n", CMRgetErrorMessage(cmr));
+      error = CMR_ERROR_INPUT;
+    }
+    else
+    {
+      size_t numRecords = CMRmatrixContainerNumRecords(container);
+      firstRecord = numRecords / numShards * shard + (shard < numRecords % numShards ? shard : numRecords % numShards);
+      beyondRecord = firstRecord + numRecords / numShards + (shard < numRecords % numShards ? 1 : 0);
+    }
+  }
+
+  clock_t startClock = clock();
+  size_t numTested = 0;
+  size_t numTU = 0;
+  bool endOfFile = false;
+  while (!endOfFile && !error)
+  {
+    /* Read the next chunk of matrices. */
+    size_t numMatrices = 0;
+    while (container && numMatrices < BATCH_SIZE)
+    {
+      size_t record = firstRecord + numTested + numMatrices;
+      if (record >= beyondRecord)
+      {
+        endOfFile = true;
+        break;
+      }
+
+      matrices[numMatrices] = NULL;
+      error = CMRchrmatCreateFromContainer(cmr, container, record, &matrices[numMatrices]);
+      if (error)
+      {
+        fprintf(stderr, "Input error in record #%zu: %s\n", record + 1, CMRgetErrorMessage(cmr));
+        error = CMR_ERROR_INPUT;
+        break;
+      }
+      ++numMatrices;
+    }
+    while (!container && numMatrices < BATCH_SIZE)
+    {
+      int c;
+      do
+        c = fgetc(inputMatrixFile);
+      while (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+      if (c == EOF)
+      {
+        endOfFile = true;
+        break;
+      }
+      ungetc(c, inputMatrixFile);
+
+      matrices[numMatrices] = NULL;
+      if (inputFormat == FILEFORMAT_MATRIX_DENSE)
+        error = CMRchrmatCreateFromDenseStream(cmr, inputMatrixFile, &matrices[numMatrices]);
+      else if (inputFormat == FILEFORMAT_MATRIX_SPARSE)
+        error = CMRchrmatCreateFromSparseStream(cmr, inputMatrixFile, &matrices[numMatrices]);
+      else
+        error = CMRchrmatCreateFromBinaryStream(cmr, inputMatrixFile, &matrices[numMatrices]);
+      if (error)
+      {
+        fprintf(stderr, "Input error in matrix #%zu: %s\n", numTested + numMatrices + 1, CMRgetErrorMessage(cmr));
+        error = CMR_ERROR_INPUT;
+        break;
+      }
+      ++numMatrices;
+    }
+
+    if (!error)
+    {
+      double remainingTime = timeLimit - (clock() - startClock) * 1.0 / CLOCKS_PER_SEC;
+      error = CMRtuTestBatch(cmr, numMatrices, matrices, isTU, &params, NULL, remainingTime);
+    }
+
+    if (!error)
+    {
+      for (size_t m = 0; m < numMatrices; ++m)
+      {
+        if (container)
+        {
+          const char* name = CMRmatrixContainerRecordName(container, firstRecord + numTested + m);
+          printf("Matrix #%zu%s%s%s %stotally unimodular.\n", firstRecord + numTested + m + 1, *name ? " (" : "",
+            name, *name ? ")" : "", isTU[m] ? "IS " : "IS NOT ");
+        }
+        else
+          printf("Matrix #%zu %stotally unimodular.\n", numTested + m + 1, isTU[m] ? "IS " : "IS NOT ");
+        if (isTU[m])
+          ++numTU;
+      }
+      numTested += numMatrices;
+    }
+
+    for (size_t m = 0; m < numMatrices; ++m)
+      CMR_CALL( CMRchrmatFree(cmr, &matrices[m]) );
+  }
+
+  if (printStats)
+  {
+    fprintf(stderr, "Tested %zu matrices, %zu of which are totally unimodular, in %f seconds.\n", numTested, numTU,
+      (clock() - startClock) * 1.0 / CLOCKS_PER_SEC);
+  }
+
+  if (cacheDirectory && !error)
+    CMR_CALL( CMRresultCacheStoreLeaves(cmr, cacheDirectory, params.regular.cache) );
+
+  /* Cleanup. */
+
+  CMR_CALL( CMRregularCacheFree(cmr, &params.regular.cache) );
+  CMR_CALL( CMRmatrixContainerFree(cmr, &container) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &isTU) );
+  CMR_CALL( CMRfreeBlockArray(cmr, &matrices) );
+  CMR_CALL( CMRfreeEnvironment(&cmr) );
+  if (inputMatrixFile && inputMatrixFile != stdin)
+    fclose(inputMatrixFile);
+
+  return error;
+}
+
 /**
  * \brief Prints the usage of the \p program to stdout.
  * 
@@ -119,16 +470,38 @@ int printUsage(const char* program)
   fprintf(stderr, "%s IN-MAT [OPTION]...\n\n", program);
   fputs("  determines whether the matrix given in file IN-MAT is totally unimodular.\n\n", stderr);
   fputs("Options:\n", stderr);
-  fputs("  -i FORMAT  Format of file IN-MAT, among `dense' and `sparse'; default: dense.\n", stderr);
+  fputs("  -i FORMAT  Format of file IN-MAT, among `dense', `sparse', `binary' and `container' (only with --batch);\n"
+    "             default: dense.\n", stderr);
   fputs("  -D OUT-DEC Write a decomposition tree of the underlying regular matroid to file OUT-DEC; "
     "default: skip computation.\n", stderr);
   fputs("  -N NON-SUB Write a minimal non-totally-unimodular submatrix to file NON-SUB; default: skip computation.\n",
     stderr);
   fputs("Advanced options:\n", stderr);
+  fputs("  --stats-json FILE    Write statistics about the computation to FILE in JSON format; `-' for stdout.\n", stderr);
+  fputs("  --hw-counters        Add hardware performance counters of the phases to the statistics (Linux only).\n",
+    stderr);
   fputs("  --stats              Print statistics about the computation to stderr.\n\n", stderr);
   fputs("  --time-limit LIMIT   Allow at most LIMIT seconds for the computation.\n", stderr);
+  fputs("  --memory-limit MB    Allow at most MB megabytes of memory for the computation.\n", stderr);
+  fputs("  --threads NUM        Use NUM threads, where 0 means all available processors; default: 1.\n", stderr);
+  fputs("  --pin-threads        Bind the threads to processors, filling one NUMA node after another.\n", stderr);
+  fputs("  --batch              Test each of the matrices that are stored one after another in IN-MAT.\n", stderr);
+  fputs("  --shard K/N          With a matrix container, test only the K-th of N ranges of its records, where\n"
+    "                       K is from 0 to N-1; default: 0/1.\n", stderr);
   fputs("  --no-direct-graphic  Check only 3-connected matrices for regularity.\n", stderr);
-  fputs("  --no-series-parallel Do not allow series-parallel operations in decomposition tree.\n\n", stderr);
+  fputs("  --no-series-parallel Do not allow series-parallel operations in decomposition tree.\n", stderr);
+  fputs("  --two-by-two         Search for 2-by-2 submatrices with determinant -2 or +2 before the decomposition.\n",
+    stderr);
+  fputs("  --consecutive-ones   Test binary matrices for the consecutive ones property before the decomposition.\n",
+    stderr);
+  fputs("  --schedule ORDER     Process decomposition nodes in ORDER, among `depth-first', `smallest', `largest' and\n"
+    "                       `small-dense'; default: depth-first.\n", stderr);
+  fputs("  --cache              Reuse the results for decomposition leaves that agree up to permutations, also across\n"
+    "                       the matrices of a batch.\n", stderr);
+  fputs("  --cache-dir DIR      Store results in directory DIR and reuse them for equal matrices and parameters;\n"
+    "                       with --batch, only the results for decomposition leaves are stored.\n", stderr);
+  fputs("  --checkpoint FILE    Continue from checkpoint FILE if it exists, and write it if the test is stopped; the test\n"
+    "                       is stopped by the time limit, SIGINT or SIGTERM.\n\n", stderr);
   fputs("  --algo ALGO          Use algorithm from {decomposition, eulerian, partition}; default: decomposition.\n\n",
     stderr);
   fputs("If IN-MAT is `-' then the matrix is read from stdin.\n", stderr);
@@ -145,9 +518,23 @@ int main(int argc, char** argv)
   char* outputTree = NULL;
   char* outputSubmatrix = NULL;
   bool printStats = false;
+  char* statsJsonFileName = NULL;
+  bool hardwareCounters = false;
   bool directGraphicness = true;
   bool seriesParallel = true;
+  CMR_REGULAR_SCHEDULE schedule = CMR_REGULAR_SCHEDULE_DEPTH_FIRST;
+  bool twoByTwo = false;
+  bool consecutiveOnes = false;
+  bool useCache = false;
+  char* cacheDirectory = NULL;
+  char* checkpointFileName = NULL;
   double timeLimit = DBL_MAX;
+  size_t memoryLimit = 0;
+  int numThreads = 1;
+  bool pinThreads = false;
+  bool batch = false;
+  size_t shard = 0;
+  size_t numShards = 1;
   CMR_TU_ALGORITHM algorithm = CMR_TU_ALGORITHM_DECOMPOSITION;
   for (int a = 1; a < argc; ++a)
   {
@@ -162,6 +549,10 @@ int main(int argc, char** argv)
         inputFormat = FILEFORMAT_MATRIX_DENSE;
       else if (!strcmp(argv[a+1], "sparse"))
         inputFormat = FILEFORMAT_MATRIX_SPARSE;
+      else if (!strcmp(argv[a+1], "binary"))
+        inputFormat = FILEFORMAT_MATRIX_BINARY;
+      else if (!strcmp(argv[a+1], "container"))
+        inputFormat = FILEFORMAT_MATRIX_CONTAINER;
       else
       {
         fprintf(stderr, "Error: unknown input file format <%s>.\n\n", argv[a+1]);
@@ -175,10 +566,63 @@ int main(int argc, char** argv)
       outputSubmatrix = argv[++a];
     else if (!strcmp(argv[a], "--stats"))
       printStats = true;
+    else if (!strcmp(argv[a], "--hw-counters"))
+      hardwareCounters = true;
+    else if (!strcmp(argv[a], "--stats-json") && a+1 < argc)
+      statsJsonFileName = argv[++a];
     else if (!strcmp(argv[a], "--no-direct-graphic"))
       directGraphicness = false;
     else if (!strcmp(argv[a], "--no-series-parallel"))
       seriesParallel = false;
+    else if (!strcmp(argv[a], "--two-by-two"))
+      twoByTwo = true;
+    else if (!strcmp(argv[a], "--consecutive-ones"))
+      consecutiveOnes = true;
+    else if (!strcmp(argv[a], "--schedule") && a+1 < argc)
+    {
+      if (!strcmp(argv[a+1], "depth-first"))
+        schedule = CMR_REGULAR_SCHEDULE_DEPTH_FIRST;
+      else if (!strcmp(argv[a+1], "smallest"))
+        schedule = CMR_REGULAR_SCHEDULE_SMALLEST_FIRST;
+      else if (!strcmp(argv[a+1], "largest"))
+        schedule = CMR_REGULAR_SCHEDULE_LARGEST_FIRST;
+      else if (!strcmp(argv[a+1], "small-dense"))
+        schedule = CMR_REGULAR_SCHEDULE_SMALL_DENSE_FIRST;
+      else
+      {
+        fprintf(stderr, "Error: Invalid schedule <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--cache"))
+      useCache = true;
+    else if (!strcmp(argv[a], "--cache-dir") && a+1 < argc)
+      cacheDirectory = argv[++a];
+    else if (!strcmp(argv[a], "--checkpoint") && a+1 < argc)
+      checkpointFileName = argv[++a];
+    else if (!strcmp(argv[a], "--batch"))
+      batch = true;
+    else if (!strcmp(argv[a], "--shard") && (a+1 < argc))
+    {
+      if (sscanf(argv[a+1], "%zu/%zu", &shard, &numShards) != 2 || numShards == 0 || shard >= numShards)
+      {
+        fprintf(stderr, "Error: Invalid shard <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
+    else if (!strcmp(argv[a], "--pin-threads"))
+      pinThreads = true;
+    else if (!strcmp(argv[a], "--threads") && (a+1 < argc))
+    {
+      if (sscanf(argv[a+1], "%d", &numThreads) == 0 || numThreads < 0)
+      {
+        fprintf(stderr, "Error: Invalid number of threads <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      ++a;
+    }
     else if (!strcmp(argv[a], "--time-limit") && (a+1 < argc))
     {
       if (sscanf(argv[a+1], "%lf", &timeLimit) == 0 || timeLimit <= 0)
@@ -188,6 +632,17 @@ int main(int argc, char** argv)
       }
       ++a;
     }
+    else if (!strcmp(argv[a], "--memory-limit") && (a+1 < argc))
+    {
+      double megabytes;
+      if (sscanf(argv[a+1], "%lf", &megabytes) == 0 || megabytes <= 0)
+      {
+        fprintf(stderr, "Error: Invalid memory limit <%s> specified.\n\n", argv[a+1]);
+        return printUsage(argv[0]);
+      }
+      memoryLimit = (size_t) (megabytes * 1024 * 1024);
+      ++a;
+    }
     else if (!strcmp(argv[a], "--algo") && (a+1 < argc))
     {
       if (!strcmp(argv[a+1], "decomposition"))
@@ -218,13 +673,36 @@ int main(int argc, char** argv)
     return printUsage(argv[0]);
   }
 
+  if (batch && (outputTree || outputSubmatrix || checkpointFileName))
+  {
+    fputs("Error: Options -D, -N and --checkpoint are invalid for testing a batch of matrices.\n\n", stderr);
+    return printUsage(argv[0]);
+  }
+
+  if (!batch && inputFormat == FILEFORMAT_MATRIX_CONTAINER)
+  {
+    fputs("Error: Matrix containers can only be tested with --batch.\n\n", stderr);
+    return printUsage(argv[0]);
+  }
+
   CMR_ERROR error;
-  error = testTotalUnimodularity(inputMatrixFileName, inputFormat, outputTree, outputSubmatrix, printStats,
-    directGraphicness, seriesParallel, algorithm, timeLimit);
+  if (batch)
+  {
+    error = testTotalUnimodularityBatch(inputMatrixFileName, inputFormat, printStats, directGraphicness,
+      seriesParallel, schedule, twoByTwo, consecutiveOnes, useCache, cacheDirectory, algorithm, timeLimit,
+      memoryLimit, numThreads, pinThreads, shard, numShards);
+  }
+  else
+  {
+    error = testTotalUnimodularity(inputMatrixFileName, inputFormat, outputTree, outputSubmatrix, printStats,
+      statsJsonFileName, hardwareCounters, directGraphicness, seriesParallel, schedule, twoByTwo, consecutiveOnes,
+      useCache, cacheDirectory, checkpointFileName, algorithm, timeLimit, memoryLimit, numThreads, pinThreads);
+  }
 
   switch (error)
   {
   case CMR_ERROR_INPUT:
+  case CMR_ERROR_OUTPUT:
     /* The actual function will have reported the details. */
     return EXIT_FAILURE;
   case CMR_ERROR_MEMORY:
@@ -3,6 +3,9 @@
 #include "common.h"
 
 #include <cmr/balanced.h>
+#include <cmr/linear_algebra.h>
+
+#include <vector>
 
 TEST(Balanced, Submatrix)
 {
@@ -116,3 +119,378 @@ TEST(Balanced, Submatrix)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+
+TEST(Balanced, SubmatrixParallel)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  srand(1);
+  for (size_t m = 0; m < 60; ++m)
+  {
+    /* Random ternary matrices, some of which have more rows than columns. */
+    size_t numRows = (m % 2) ? 7 : 10;
+    size_t numColumns = (m % 2) ? 10 : 7;
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < matrix->numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < matrix->numColumns; ++column)
+      {
+        int r = rand() % 8;
+        if (r < 1 + (int) (m % 3))
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = (r == 0 && m % 4 < 2) ? -1 : 1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[matrix->numRows] = matrix->numNonzeros;
+
+    CMR_BALANCED_PARAMS params;
+    ASSERT_CMR_CALL( CMRbalancedParamsInit(&params) );
+    params.algorithm = CMR_BALANCED_ALGORITHM_SUBMATRIX;
+    params.seriesParallel = false;
+
+    bool expectedIsBalanced;
+    CMR_SUBMAT* expectedSubmatrix = NULL;
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+    ASSERT_CMR_CALL( CMRbalancedTest(cmr, matrix, &expectedIsBalanced, &expectedSubmatrix, &params, NULL, DBL_MAX) );
+
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 4) );
+    bool isBalanced;
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRbalancedTest(cmr, matrix, &isBalanced, &submatrix, &params, NULL, DBL_MAX) );
+
+    ASSERT_EQ( isBalanced, expectedIsBalanced );
+    if (isBalanced)
+    {
+      ASSERT_EQ( submatrix, (CMR_SUBMAT*) NULL );
+    }
+    else
+    {
+      /* The violator must have the same size and two nonzeros per row and column with nonzero determinant. */
+      ASSERT_NE( submatrix, (CMR_SUBMAT*) NULL );
+      ASSERT_EQ( submatrix->numRows, expectedSubmatrix->numRows );
+      ASSERT_EQ( submatrix->numRows, submatrix->numColumns );
+
+      CMR_CHRMAT* violator = NULL;
+      ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, submatrix, &violator) );
+      ASSERT_EQ( violator->numNonzeros, 2 * violator->numRows );
+      for (size_t row = 0; row < violator->numRows; ++row)
+        ASSERT_EQ( violator->rowSlice[row + 1] - violator->rowSlice[row], 2UL );
+      int64_t determinant;
+      ASSERT_CMR_CALL( CMRchrmatDeterminant(cmr, violator, &determinant) );
+      ASSERT_TRUE( determinant == 2 || determinant == -2 );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &violator) );
+    }
+
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &expectedSubmatrix) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Returns whether the dense 0/1 matrix \p dense contains the incidence matrix of a cycle of length at least 3.
+ */
+
+static
+bool containsCycleSubmatrix(const std::vector<std::vector<int>>& dense, size_t numRows, size_t numColumns)
+{
+  for (size_t rows = 0; rows < (1UL << numRows); ++rows)
+  {
+    size_t k = __builtin_popcountl(rows);
+    if (k < 3)
+      continue;
+    for (size_t columns = 0; columns < (1UL << numColumns); ++columns)
+    {
+      if ((size_t) __builtin_popcountl(columns) != k)
+        continue;
+
+      /* Each row and each column must have exactly two 1's. */
+      bool degreesTwo = true;
+      for (size_t row = 0; row < numRows && degreesTwo; ++row)
+      {
+        if (!(rows & (1UL << row)))
+          continue;
+        size_t count = 0;
+        for (size_t column = 0; column < numColumns; ++column)
+          count += (columns & (1UL << column)) && dense[row][column];
+        degreesTwo = count == 2;
+      }
+      for (size_t column = 0; column < numColumns && degreesTwo; ++column)
+      {
+        if (!(columns & (1UL << column)))
+          continue;
+        size_t count = 0;
+        for (size_t row = 0; row < numRows; ++row)
+          count += (rows & (1UL << row)) && dense[row][column];
+        degreesTwo = count == 2;
+      }
+      if (!degreesTwo)
+        continue;
+
+      /* The rows must be connected via the columns. */
+      size_t reached = rows & (~rows + 1);
+      bool changed = true;
+      while (changed)
+      {
+        changed = false;
+        for (size_t column = 0; column < numColumns; ++column)
+        {
+          if (!(columns & (1UL << column)))
+            continue;
+          size_t columnRows = 0;
+          for (size_t row = 0; row < numRows; ++row)
+          {
+            if ((rows & (1UL << row)) && dense[row][column])
+              columnRows |= 1UL << row;
+          }
+          if ((columnRows & reached) && (columnRows & ~reached))
+          {
+            reached |= columnRows;
+            changed = true;
+          }
+        }
+      }
+      if (reached == rows)
+        return true;
+    }
+  }
+
+  return false;
+}
+
+TEST(Balanced, SmallMatrices)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_BALANCED_PARAMS params;
+  ASSERT_CMR_CALL( CMRbalancedParamsInit(&params) );
+  params.algorithm = CMR_BALANCED_ALGORITHM_SUBMATRIX;
+
+  srand(7);
+  for (size_t r = 0; r < 200; ++r)
+  {
+    /* Random ternary matrix with up to 12 rows and columns. */
+    size_t numRows = 2 + rand() % 11;
+    size_t numColumns = 2 + rand() % 11;
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        int x = rand() % 10;
+        if (x < 2)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = x == 0 ? 1 : -1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = matrix->numNonzeros;
+
+    bool isBalanced;
+    ASSERT_CMR_CALL( CMRbalancedTest(cmr, matrix, &isBalanced, NULL, &params, NULL, DBL_MAX) );
+
+    bool smallIsBalanced;
+    CMR_SUBMAT* violator = NULL;
+    ASSERT_CMR_CALL( CMRbalancedTest(cmr, matrix, &smallIsBalanced, &violator, NULL, NULL, DBL_MAX) );
+    ASSERT_EQ( smallIsBalanced, isBalanced );
+
+    if (violator)
+    {
+      /* The violator has exactly two nonzeros per row and column, and their sum is not divisible by 4. */
+      ASSERT_EQ( violator->numRows, violator->numColumns );
+      CMR_CHRMAT* violatorMatrix = NULL;
+      ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, violator, &violatorMatrix) );
+      std::vector<size_t> columnCounts(violatorMatrix->numColumns, 0);
+      int sum = 0;
+      for (size_t row = 0; row < violatorMatrix->numRows; ++row)
+      {
+        ASSERT_EQ( violatorMatrix->rowSlice[row + 1] - violatorMatrix->rowSlice[row], 2UL );
+        for (size_t e = violatorMatrix->rowSlice[row]; e < violatorMatrix->rowSlice[row + 1]; ++e)
+        {
+          columnCounts[violatorMatrix->entryColumns[e]]++;
+          sum += violatorMatrix->entryValues[e];
+        }
+      }
+      for (size_t column = 0; column < violatorMatrix->numColumns; ++column)
+        ASSERT_EQ( columnCounts[column], 2UL );
+      ASSERT_NE( sum % 4, 0 );
+
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &violatorMatrix) );
+      ASSERT_CMR_CALL( CMRsubmatFree(cmr, &violator) );
+    }
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Balanced, TotallyBalanced)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  {
+    /* Incidence matrix of a cycle of length 3. */
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "3 3 "
+      " 1 1 0 "
+      " 0 1 1 "
+      " 1 0 1 "
+    ) );
+
+    bool isTotallyBalanced;
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRtotallyBalancedTest(cmr, matrix, &isTotallyBalanced, NULL, NULL, &submatrix, NULL,
+      DBL_MAX) );
+    ASSERT_FALSE( isTotallyBalanced );
+    ASSERT_TRUE( submatrix );
+    ASSERT_EQ( submatrix->numRows, 2UL );
+    ASSERT_EQ( submatrix->numColumns, 2UL );
+
+    CMR_CHRMAT* gamma = NULL;
+    ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, submatrix, &gamma) );
+    CMR_CHRMAT* expected = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &expected, "2 2 "
+      " 1 1 "
+      " 1 0 "
+    ) );
+    ASSERT_TRUE( CMRchrmatCheckEqual(gamma, expected) );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &expected) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &gamma) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  {
+    /* An interval matrix is totally balanced. */
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "4 5 "
+      " 1 1 1 0 0 "
+      " 0 1 1 1 0 "
+      " 0 0 0 1 1 "
+      " 1 1 1 1 1 "
+    ) );
+
+    bool isTotallyBalanced;
+    ASSERT_CMR_CALL( CMRtotallyBalancedTest(cmr, matrix, &isTotallyBalanced, NULL, NULL, NULL, NULL, DBL_MAX) );
+    ASSERT_TRUE( isTotallyBalanced );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  {
+    /* A non-binary matrix is not totally balanced. */
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "2 2 "
+      " 1  1 "
+      " 1 -1 "
+    ) );
+
+    bool isTotallyBalanced;
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRtotallyBalancedTest(cmr, matrix, &isTotallyBalanced, NULL, NULL, &submatrix, NULL,
+      DBL_MAX) );
+    ASSERT_FALSE( isTotallyBalanced );
+    ASSERT_TRUE( submatrix );
+    ASSERT_EQ( submatrix->numRows, 1UL );
+    ASSERT_EQ( submatrix->rows[0], 1UL );
+    ASSERT_EQ( submatrix->columns[0], 1UL );
+
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  srand(5);
+  for (size_t r = 0; r < 1000; ++r)
+  {
+    /* Random binary matrix, compared against an enumeration of cycle submatrices. */
+    size_t numRows = 1 + rand() % 6;
+    size_t numColumns = 1 + rand() % 6;
+    int density = 2 + rand() % 5;
+    std::vector<std::vector<int>> dense(numRows, std::vector<int>(numColumns, 0));
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        if (rand() % 8 < density)
+        {
+          dense[row][column] = 1;
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = 1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = matrix->numNonzeros;
+
+    bool isTotallyBalanced;
+    std::vector<size_t> rowsOrder(numRows);
+    std::vector<size_t> columnsOrder(numColumns);
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRtotallyBalancedTest(cmr, matrix, &isTotallyBalanced, &rowsOrder[0], &columnsOrder[0],
+      &submatrix, NULL, DBL_MAX) );
+    ASSERT_EQ( isTotallyBalanced, !containsCycleSubmatrix(dense, numRows, numColumns) );
+
+    /* Verify that the ordering is doubly lexical. */
+    for (size_t p = 0; p + 1 < numRows; ++p)
+    {
+      size_t q = numColumns;
+      while (q > 0 && dense[rowsOrder[p]][columnsOrder[q-1]] == dense[rowsOrder[p+1]][columnsOrder[q-1]])
+        --q;
+      ASSERT_TRUE( q == 0 || dense[rowsOrder[p]][columnsOrder[q-1]] < dense[rowsOrder[p+1]][columnsOrder[q-1]] );
+    }
+    for (size_t q = 0; q + 1 < numColumns; ++q)
+    {
+      size_t p = numRows;
+      while (p > 0 && dense[rowsOrder[p-1]][columnsOrder[q]] == dense[rowsOrder[p-1]][columnsOrder[q+1]])
+        --p;
+      ASSERT_TRUE( p == 0 || dense[rowsOrder[p-1]][columnsOrder[q]] < dense[rowsOrder[p-1]][columnsOrder[q+1]] );
+    }
+
+    if (submatrix)
+    {
+      std::vector<size_t> rowsPosition(numRows);
+      std::vector<size_t> columnsPosition(numColumns);
+      for (size_t p = 0; p < numRows; ++p)
+        rowsPosition[rowsOrder[p]] = p;
+      for (size_t q = 0; q < numColumns; ++q)
+        columnsPosition[columnsOrder[q]] = q;
+      size_t i = submatrix->rows[0];
+      size_t j = submatrix->rows[1];
+      size_t k = submatrix->columns[0];
+      size_t l = submatrix->columns[1];
+      ASSERT_LT( rowsPosition[i], rowsPosition[j] );
+      ASSERT_LT( columnsPosition[k], columnsPosition[l] );
+      ASSERT_EQ( dense[i][k] + dense[i][l] + dense[j][k], 3 );
+      ASSERT_EQ( dense[j][l], 0 );
+      ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    }
+    else
+      ASSERT_TRUE( isTotallyBalanced );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
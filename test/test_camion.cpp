@@ -96,3 +96,253 @@ TEST(Camion, Issue10)
 
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+/**
+ * \brief Creates the block-diagonal matrix with \p numCopies copies of \p first and \p second in alternating order.
+ */
+
+static
+CMR_ERROR createBlockDiagonal(CMR* cmr, CMR_CHRMAT* first, CMR_CHRMAT* second, size_t numCopies,
+  CMR_CHRMAT** presult)
+{
+  CMR_CHRMAT* blocks[2] = { first, second };
+  size_t numRows = numCopies * (first->numRows + second->numRows);
+  size_t numColumns = numCopies * (first->numColumns + second->numColumns);
+  size_t numNonzeros = numCopies * (first->numNonzeros + second->numNonzeros);
+  CMR_CALL( CMRchrmatCreate(cmr, presult, numRows, numColumns, numNonzeros) );
+  CMR_CHRMAT* result = *presult;
+
+  size_t row = 0;
+  size_t columnOffset = 0;
+  size_t entry = 0;
+  for (size_t b = 0; b < 2 * numCopies; ++b)
+  {
+    CMR_CHRMAT* block = blocks[b % 2];
+    for (size_t blockRow = 0; blockRow < block->numRows; ++blockRow)
+    {
+      result->rowSlice[row++] = entry;
+      for (size_t e = block->rowSlice[blockRow]; e < block->rowSlice[blockRow + 1]; ++e)
+      {
+        result->entryColumns[entry] = columnOffset + block->entryColumns[e];
+        result->entryValues[entry] = block->entryValues[e];
+        ++entry;
+      }
+    }
+    columnOffset += block->numColumns;
+  }
+  result->rowSlice[row] = entry;
+
+  return CMR_OKAY;
+}
+
+TEST(Camion, Threads)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* signedBlock = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &signedBlock, "2 2 "
+    "1 1 "
+    "1 1 "
+  ) );
+  CMR_CHRMAT* unsignedBlock = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &unsignedBlock, "4 4 "
+    "1 1 0 0 "
+    "1 0 1 1 "
+    "0 1 1 0 "
+    "0 0 1 1 "
+  ) );
+  CMR_CHRMAT* original = NULL;
+  ASSERT_CMR_CALL( createBlockDiagonal(cmr, signedBlock, unsignedBlock, 20, &original) );
+
+  /* The sequential computation yields the reference results. */
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+  bool sequentialSigned;
+  CMR_SUBMAT* sequentialSubmatrix = NULL;
+  ASSERT_CMR_CALL( CMRcamionTestSigns(cmr, original, &sequentialSigned, &sequentialSubmatrix, NULL, DBL_MAX) );
+  ASSERT_FALSE(sequentialSigned);
+  ASSERT_TRUE(sequentialSubmatrix != NULL);
+  CMR_CHRMAT* sequentialMatrix = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCopy(cmr, original, &sequentialMatrix) );
+  ASSERT_CMR_CALL( CMRcamionComputeSigns(cmr, sequentialMatrix, &sequentialSigned, NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE(sequentialSigned);
+
+  for (int numThreads = 2; numThreads <= 4; numThreads += 2)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+    bool isSigned;
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRcamionTestSigns(cmr, original, &isSigned, &submatrix, NULL, DBL_MAX) );
+    ASSERT_FALSE(isSigned);
+    ASSERT_TRUE(submatrix != NULL);
+    ASSERT_EQ(submatrix->numRows, sequentialSubmatrix->numRows);
+    ASSERT_EQ(submatrix->numColumns, sequentialSubmatrix->numColumns);
+    for (size_t r = 0; r < submatrix->numRows; ++r)
+      ASSERT_EQ(submatrix->rows[r], sequentialSubmatrix->rows[r]);
+    for (size_t c = 0; c < submatrix->numColumns; ++c)
+      ASSERT_EQ(submatrix->columns[c], sequentialSubmatrix->columns[c]);
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCopy(cmr, original, &matrix) );
+    ASSERT_CMR_CALL( CMRcamionComputeSigns(cmr, matrix, &isSigned, &submatrix, NULL, DBL_MAX) );
+    ASSERT_FALSE(isSigned);
+    ASSERT_TRUE(submatrix != NULL);
+    ASSERT_EQ(submatrix->rows[0], sequentialSubmatrix->rows[0]);
+    ASSERT_TRUE(CMRchrmatCheckEqual(matrix, sequentialMatrix));
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &sequentialMatrix) );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &sequentialSubmatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &original) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &unsignedBlock) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &signedBlock) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Camion, InterleavedBlocks)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* The rows and columns of the blocks are interleaved, row 3 and column 2 are zero, and only the block with rows 0
+   * and 2 is not Camion-signed. */
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "6 6 "
+    " 1  0  0  0  1  0 "
+    " 0  1  0  1  0  0 "
+    " 1  0  0  0 -1  0 "
+    " 0  0  0  0  0  0 "
+    " 0  1  0  1  0  0 "
+    " 0  0  0  0  0  1 "
+  ) );
+
+  bool isSigned;
+  CMR_SUBMAT* submatrix = NULL;
+  ASSERT_CMR_CALL( CMRcamionTestSigns(cmr, matrix, &isSigned, &submatrix, NULL, DBL_MAX) );
+  ASSERT_FALSE(isSigned);
+  ASSERT_TRUE(submatrix != NULL);
+  ASSERT_EQ(submatrix->numRows, 2UL);
+  ASSERT_EQ(submatrix->numColumns, 2UL);
+  ASSERT_EQ(submatrix->rows[0], 0UL);
+  ASSERT_EQ(submatrix->rows[1], 2UL);
+  ASSERT_EQ(submatrix->columns[0], 0UL);
+  ASSERT_EQ(submatrix->columns[1], 4UL);
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+
+  /* Signing in place only modifies the violating block. */
+  CMR_CHRMAT* original = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCopy(cmr, matrix, &original) );
+  ASSERT_CMR_CALL( CMRcamionComputeSigns(cmr, matrix, &isSigned, NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE(isSigned);
+  ASSERT_EQ(matrix->numNonzeros, original->numNonzeros);
+  size_t numChanged = 0;
+  for (size_t e = 0; e < matrix->numNonzeros; ++e)
+  {
+    ASSERT_EQ(matrix->entryColumns[e], original->entryColumns[e]);
+    if (matrix->entryValues[e] != original->entryValues[e])
+    {
+      ++numChanged;
+      ASSERT_TRUE(matrix->entryColumns[e] == 0 || matrix->entryColumns[e] == 4);
+    }
+  }
+  ASSERT_EQ(numChanged, 1UL);
+  ASSERT_CMR_CALL( CMRcamionTestSigns(cmr, matrix, &isSigned, NULL, NULL, DBL_MAX) );
+  ASSERT_TRUE(isSigned);
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &original) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Camion, LargeBlocksThreads)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Scatter three large and many small blocks over pseudo-randomly permuted rows and columns, such that the block
+   * decomposition runs in parallel and has to sort the rows of the large blocks. */
+  const size_t numLarge = 3;
+  const size_t largeSize = 300;
+  const size_t numSmall = 2000;
+  const size_t numRows = numLarge * largeSize + 2 * numSmall;
+  size_t* rowsPermutation = new size_t[numRows];
+  size_t* columnsPermutation = new size_t[numRows];
+  for (size_t i = 0; i < numRows; ++i)
+  {
+    rowsPermutation[i] = i;
+    columnsPermutation[i] = i;
+  }
+  size_t state = 1;
+  for (size_t i = numRows - 1; i > 0; --i)
+  {
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    std::swap(rowsPermutation[i], rowsPermutation[(state >> 33) % (i + 1)]);
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    std::swap(columnsPermutation[i], columnsPermutation[(state >> 33) % (i + 1)]);
+  }
+
+  size_t numNonzeros = numLarge * largeSize * largeSize + 4 * numSmall;
+  CMR_CHRMAT* original = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &original, numRows, numRows, numNonzeros) );
+  size_t entry = 0;
+  size_t largeBeyond = numLarge * largeSize;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    original->rowSlice[row] = entry;
+    size_t blockRow = rowsPermutation[row];
+    size_t first = blockRow < largeBeyond ? blockRow - blockRow % largeSize : blockRow - (blockRow - largeBeyond) % 2;
+    size_t beyond = blockRow < largeBeyond ? first + largeSize : first + 2;
+    for (size_t column = 0; column < numRows; ++column)
+    {
+      size_t blockColumn = columnsPermutation[column];
+      if (blockColumn < first || blockColumn >= beyond)
+        continue;
+      original->entryColumns[entry] = column;
+      original->entryValues[entry] = ((blockRow * 7 + blockColumn * 3) % 5 == 0) ? -1 : 1;
+      ++entry;
+    }
+  }
+  original->rowSlice[numRows] = entry;
+  ASSERT_EQ(entry, numNonzeros);
+  delete[] columnsPermutation;
+  delete[] rowsPermutation;
+
+  CMR_CHRMAT* sequentialMatrix = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCopy(cmr, original, &sequentialMatrix) );
+  bool sequentialSigned;
+  CMR_SUBMAT* sequentialSubmatrix = NULL;
+  ASSERT_CMR_CALL( CMRcamionComputeSigns(cmr, sequentialMatrix, &sequentialSigned, &sequentialSubmatrix, NULL,
+    DBL_MAX) );
+  ASSERT_FALSE(sequentialSigned);
+  ASSERT_TRUE(sequentialSubmatrix != NULL);
+
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 4) );
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCopy(cmr, original, &matrix) );
+  bool isSigned;
+  CMR_SUBMAT* submatrix = NULL;
+  ASSERT_CMR_CALL( CMRcamionComputeSigns(cmr, matrix, &isSigned, &submatrix, NULL, DBL_MAX) );
+  ASSERT_FALSE(isSigned);
+  ASSERT_TRUE(submatrix != NULL);
+  ASSERT_TRUE(CMRchrmatCheckEqual(matrix, sequentialMatrix));
+  ASSERT_EQ(submatrix->numRows, sequentialSubmatrix->numRows);
+  ASSERT_EQ(submatrix->numColumns, sequentialSubmatrix->numColumns);
+  for (size_t r = 0; r < submatrix->numRows; ++r)
+    ASSERT_EQ(submatrix->rows[r], sequentialSubmatrix->rows[r]);
+  for (size_t c = 0; c < submatrix->numColumns; ++c)
+    ASSERT_EQ(submatrix->columns[c], sequentialSubmatrix->columns[c]);
+
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &sequentialSubmatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &sequentialMatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &original) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
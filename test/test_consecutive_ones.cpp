@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include "common.h"
+#include <cmr/consecutive_ones.h>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * \brief Returns whether the nonzeros of each row of \p matrix are consecutive w.r.t. \p columnsOrder.
+ */
+
+static
+bool isConsecutiveOrder(CMR_CHRMAT* matrix, const std::vector<size_t>& columnsOrder)
+{
+  std::vector<size_t> position(matrix->numColumns);
+  for (size_t i = 0; i < columnsOrder.size(); ++i)
+    position[columnsOrder[i]] = i;
+
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    size_t first = SIZE_MAX;
+    size_t last = 0;
+    size_t count = 0;
+    for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+    {
+      if (!matrix->entryValues[e])
+        continue;
+      first = std::min(first, position[matrix->entryColumns[e]]);
+      last = std::max(last, position[matrix->entryColumns[e]]);
+      ++count;
+    }
+    if (count && last - first + 1 != count)
+      return false;
+  }
+
+  return true;
+}
+
+TEST(ConsecutiveOnes, Examples)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  {
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "4 5 "
+      "1 0 1 0 0 "
+      "0 1 0 0 1 "
+      "1 0 0 1 0 "
+      "0 0 1 0 1 "
+    ) );
+
+    bool hasC1P;
+    std::vector<size_t> columnsOrder(matrix->numColumns);
+    ASSERT_CMR_CALL( CMRconsecutiveOnesTestColumns(cmr, matrix, &hasC1P, &columnsOrder[0]) );
+    ASSERT_TRUE( hasC1P );
+    ASSERT_TRUE( isConsecutiveOrder(matrix, columnsOrder) );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  {
+    /* Vertex-edge incidence matrix of a triangle. */
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "3 3 "
+      "1 1 0 "
+      "0 1 1 "
+      "1 0 1 "
+    ) );
+
+    bool hasC1P;
+    ASSERT_CMR_CALL( CMRconsecutiveOnesTestColumns(cmr, matrix, &hasC1P, NULL) );
+    ASSERT_FALSE( hasC1P );
+    ASSERT_CMR_CALL( CMRconsecutiveOnesTestRows(cmr, matrix, &hasC1P, NULL) );
+    ASSERT_FALSE( hasC1P );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  {
+    /* Column 0 would need three neighbors, but the rows can be ordered arbitrarily. */
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "3 4 "
+      "1 1 0 0 "
+      "1 0 1 0 "
+      "1 0 0 1 "
+    ) );
+
+    bool hasC1P;
+    ASSERT_CMR_CALL( CMRconsecutiveOnesTestColumns(cmr, matrix, &hasC1P, NULL) );
+    ASSERT_FALSE( hasC1P );
+
+    std::vector<size_t> rowsOrder(matrix->numRows);
+    ASSERT_CMR_CALL( CMRconsecutiveOnesTestRows(cmr, matrix, &hasC1P, &rowsOrder[0]) );
+    ASSERT_TRUE( hasC1P );
+
+    CMR_CHRMAT* transpose = NULL;
+    ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+    ASSERT_TRUE( isConsecutiveOrder(transpose, rowsOrder) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(ConsecutiveOnes, Random)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  srand(4);
+  for (size_t r = 0; r < 2000; ++r)
+  {
+    /* Random binary matrix with at most 7 columns, compared against all column permutations. */
+    size_t numRows = 1 + rand() % 8;
+    size_t numColumns = 1 + rand() % 7;
+    int density = 2 + rand() % 5;
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        if (rand() % 8 < density)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = 1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = matrix->numNonzeros;
+
+    std::vector<size_t> permutation(numColumns);
+    for (size_t column = 0; column < numColumns; ++column)
+      permutation[column] = column;
+    bool bruteForce = false;
+    do
+    {
+      bruteForce = isConsecutiveOrder(matrix, permutation);
+    }
+    while (!bruteForce && std::next_permutation(permutation.begin(), permutation.end()));
+
+    bool hasC1P;
+    std::vector<size_t> columnsOrder(numColumns);
+    ASSERT_CMR_CALL( CMRconsecutiveOnesTestColumns(cmr, matrix, &hasC1P, &columnsOrder[0]) );
+    ASSERT_EQ( hasC1P, bruteForce );
+    if (hasC1P)
+    {
+      std::vector<size_t> sorted = columnsOrder;
+      std::sort(sorted.begin(), sorted.end());
+      for (size_t column = 0; column < numColumns; ++column)
+        ASSERT_EQ( sorted[column], column );
+      ASSERT_TRUE( isConsecutiveOrder(matrix, columnsOrder) );
+    }
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
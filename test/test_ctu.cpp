@@ -55,3 +55,135 @@ TEST(CTU, ExamplesWideWide)
 
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+TEST(CTU, Parallel)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_CHRMAT* matrix = NULL;
+
+  const char* matrices[] = {
+    " 4 5 "
+    "1 0 0 1 1 "
+    "1 1 0 0 1 "
+    "0 1 1 0 1 "
+    "0 0 1 1 1 ",
+    " 5 5 "
+    "0 1 0 1 0 "
+    "1 1 1 0 1 "
+    "0 1 0 0 1 "
+    "1 0 0 0 1 "
+    "0 1 1 1 1 ",
+    " 5 5 "
+    "0 0 1 0 0 "
+    "1 0 1 0 1 "
+    "0 1 1 0 0 "
+    "0 0 0 1 0 "
+    "0 1 0 0 1 ",
+  };
+
+  for (size_t m = 0; m < sizeof(matrices) / sizeof(matrices[0]); ++m)
+  {
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, matrices[m]) );
+
+    CMR_CTU_PARAMS params;
+    ASSERT_CMR_CALL( CMRctuParamsInit(&params) );
+
+    bool sequentialIsCTU;
+    size_t sequentialRow = SIZE_MAX;
+    size_t sequentialColumn = SIZE_MAX;
+    CMR_CTU_STATISTICS sequentialStats;
+    ASSERT_CMR_CALL( CMRstatsComplementTotalUnimodularityInit(&sequentialStats) );
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+    ASSERT_CMR_CALL( CMRctuTest(cmr, matrix, &sequentialIsCTU, &sequentialRow, &sequentialColumn, &params,
+      &sequentialStats, DBL_MAX) );
+
+    for (int numThreads = 2; numThreads <= 4; numThreads += 2)
+    {
+      bool isCTU;
+      size_t complementRow = SIZE_MAX;
+      size_t complementColumn = SIZE_MAX;
+      CMR_CTU_STATISTICS stats;
+      ASSERT_CMR_CALL( CMRstatsComplementTotalUnimodularityInit(&stats) );
+      ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+      ASSERT_CMR_CALL( CMRctuTest(cmr, matrix, &isCTU, &complementRow, &complementColumn, &params, &stats,
+        DBL_MAX) );
+
+      ASSERT_EQ(isCTU, sequentialIsCTU);
+      ASSERT_EQ(complementRow, sequentialRow);
+      ASSERT_EQ(complementColumn, sequentialColumn);
+      ASSERT_EQ(stats.totalCount, 1UL);
+      if (isCTU)
+      {
+        ASSERT_EQ(stats.tu.decomposition.totalCount, sequentialStats.tu.decomposition.totalCount);
+      }
+    }
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(CTU, WideMatrix)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* A 5x70 matrix whose last columns form a non-CTU matrix, such that the rows consist of two words. */
+  const char* block[5] = { "00100", "10101", "01100", "00010", "01001" };
+  const size_t numRows = 5;
+  const size_t numColumns = 70;
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, 25) );
+  matrix->numNonzeros = 0;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    matrix->rowSlice[row] = matrix->numNonzeros;
+    for (size_t column = 0; column < 5; ++column)
+    {
+      if (block[row][column] == '1')
+      {
+        matrix->entryColumns[matrix->numNonzeros] = numColumns - 5 + column;
+        matrix->entryValues[matrix->numNonzeros] = 1;
+        matrix->numNonzeros++;
+      }
+    }
+  }
+  matrix->rowSlice[numRows] = matrix->numNonzeros;
+
+  bool isCTU;
+  size_t complementRow = SIZE_MAX;
+  size_t complementColumn = SIZE_MAX;
+  ASSERT_CMR_CALL( CMRctuTest(cmr, matrix, &isCTU, &complementRow, &complementColumn, NULL, NULL, DBL_MAX) );
+
+  /* Compare with the first complemented matrix that is not TU. */
+  bool expectedIsCTU = true;
+  size_t expectedRow = SIZE_MAX;
+  size_t expectedColumn = SIZE_MAX;
+  for (size_t row = 0; row <= numRows && expectedIsCTU; ++row)
+  {
+    for (size_t column = 0; column <= numColumns && expectedIsCTU; ++column)
+    {
+      CMR_CHRMAT* complemented = NULL;
+      ASSERT_CMR_CALL( CMRcomplementRowColumn(cmr, matrix, row < numRows ? row : SIZE_MAX,
+        column < numColumns ? column : SIZE_MAX, &complemented) );
+      bool isTU;
+      ASSERT_CMR_CALL( CMRtuTest(cmr, complemented, &isTU, NULL, NULL, NULL, NULL, DBL_MAX) );
+      if (!isTU)
+      {
+        expectedIsCTU = false;
+        expectedRow = row < numRows ? row : SIZE_MAX;
+        expectedColumn = column < numColumns ? column : SIZE_MAX;
+      }
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &complemented) );
+    }
+  }
+
+  ASSERT_EQ(isCTU, expectedIsCTU);
+  ASSERT_EQ(complementRow, expectedRow);
+  ASSERT_EQ(complementColumn, expectedColumn);
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include "common.h"
+#include "../src/cmr/densematrix.h"
+
+#include <cstdlib>
+#include <vector>
+
+TEST(DenseMatrix, RowOperations)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  for (size_t numColumns : { 1, 63, 64, 65, 300 })
+  {
+    const size_t numRows = 5;
+    DenseBinaryMatrix* dense = NULL;
+    ASSERT_CMR_CALL( CMRdensebinmatrixCreate(cmr, numRows, numColumns, &dense) );
+    ASSERT_EQ(dense->stride % CMR_DENSEBINMATRIX_ROW_ALIGNMENT, 0);
+
+    srand(numColumns);
+    std::vector<std::vector<bool>> reference(numRows, std::vector<bool>(numColumns, false));
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        if (rand() % 3 == 0)
+        {
+          CMRdensebinmatrixSet1(dense, row, column);
+          reference[row][column] = true;
+        }
+      }
+    }
+
+    CMRdensebinmatrixRowXor(dense, 1, 0);
+    for (size_t column = 0; column < numColumns; ++column)
+      reference[1][column] = reference[1][column] != reference[0][column];
+
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      size_t count = 0;
+      size_t andCount = 0;
+      size_t next = CMRdensebinmatrixRowFindNext(dense, row, 0);
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        ASSERT_EQ(CMRdensebinmatrixGet(dense, row, column), reference[row][column]);
+        if (reference[row][column])
+        {
+          ASSERT_EQ(next, column);
+          next = CMRdensebinmatrixRowFindNext(dense, row, column + 1);
+          ++count;
+          if (reference[0][column])
+            ++andCount;
+        }
+      }
+      ASSERT_EQ(next, SIZE_MAX);
+      ASSERT_EQ(CMRdensebinmatrixRowCount(dense, row), count);
+      ASSERT_EQ(CMRdensebinmatrixRowAndCount(dense, row, 0), andCount);
+    }
+
+    ASSERT_CMR_CALL( CMRdensebinmatrixFree(cmr, &dense) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
@@ -0,0 +1,479 @@
+#include <gtest/gtest.h>
+
+#include "common.h"
+
+#include <cmr/tu.h>
+#include <cmr/regular.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(Environment, NumThreads)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  ASSERT_EQ( CMRgetNumThreads(cmr), 1 );
+  ASSERT_EQ( CMRsetNumThreads(cmr, -1), CMR_ERROR_INPUT );
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 0) );
+  ASSERT_GE( CMRgetNumThreads(cmr), 1 );
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+  ASSERT_EQ( CMRgetNumThreads(cmr), 1 );
+
+  ASSERT_FALSE( CMRgetThreadPinning(cmr) );
+  ASSERT_CMR_CALL( CMRsetThreadPinning(cmr, true) );
+  ASSERT_TRUE( CMRgetThreadPinning(cmr) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Environment, SharedBetweenThreads)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "6 6 "
+    "1 1 0 0 0 0 "
+    "0 1 1 0 0 0 "
+    "1 0 -1 0 0 0 "
+    "0 0 0 1 1 0 "
+    "0 0 0 0 1 1 "
+    "0 0 0 1 0 1 "
+  ) );
+
+  const size_t numThreads = 4;
+  std::vector<std::thread> threads;
+  std::vector<CMR_ERROR> errors(numThreads, CMR_OKAY);
+  std::vector<char> results(numThreads, 0);
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    threads.push_back(std::thread([&, t]()
+    {
+      for (int repetition = 0; repetition < 20 && !errors[t]; ++repetition)
+      {
+        bool isTU;
+        errors[t] = CMRtuTest(cmr, matrix, &isTU, NULL, NULL, NULL, NULL, DBL_MAX);
+        results[t] = isTU ? 1 : -1;
+      }
+    }));
+  }
+  for (size_t t = 0; t < numThreads; ++t)
+    threads[t].join();
+
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    ASSERT_EQ( errors[t], CMR_OKAY );
+    ASSERT_EQ( results[t], -1 );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Records progress reports and interrupts the computation after a given number of processed nodes.
+ */
+
+struct ProgressRecorder
+{
+  size_t numReports;
+  size_t lastProcessed;
+  size_t lastQueueLength;
+  size_t interruptAfter;
+};
+
+static void recordProgress(CMR* cmr, const CMR_PROGRESS* progress, void* data)
+{
+  ProgressRecorder* recorder = (ProgressRecorder*) data;
+  recorder->numReports++;
+  recorder->lastProcessed = progress->numProcessedNodes;
+  recorder->lastQueueLength = progress->queueLength;
+  if (progress->numProcessedNodes >= recorder->interruptAfter)
+    CMRinterrupt(cmr);
+}
+
+TEST(Environment, InterruptAndProgress)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "9 9 "
+    "1 1 0 0 0 0 0 0 0 "
+    "1 1 1 0 0 0 0 0 0 "
+    "1 0 0 1 0 0 0 0 0 "
+    "0 1 1 1 0 0 0 0 0 "
+    "0 0 1 1 0 0 0 0 0 "
+    "0 0 0 0 1 1 1 0 0 "
+    "0 0 0 0 1 1 0 1 0 "
+    "0 0 0 0 0 1 0 1 1 "
+    "0 0 0 0 0 0 1 1 1 "
+  ) );
+
+  for (int numThreads = 1; numThreads <= 2; ++numThreads)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+    /* Without interruption, all nodes are reported. */
+    ProgressRecorder recorder = { 0, 0, 0, SIZE_MAX };
+    ASSERT_CMR_CALL( CMRsetProgressCallback(cmr, recordProgress, &recorder) );
+    bool isRegular;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, NULL, NULL, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    ASSERT_GE( recorder.numReports, 3UL );
+    ASSERT_EQ( recorder.lastProcessed, recorder.numReports );
+    ASSERT_EQ( recorder.lastQueueLength, 0UL );
+    ASSERT_FALSE( CMRisInterrupted(cmr) );
+
+    /* An interruption from the callback stops the computation. */
+    recorder = { 0, 0, 0, 1 };
+    ASSERT_EQ( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, NULL, NULL, DBL_MAX), CMR_ERROR_TIMEOUT );
+    ASSERT_TRUE( CMRisInterrupted(cmr) );
+    ASSERT_EQ( recorder.numReports, 1UL );
+
+    /* Until the interruption is cleared, also other computations stop immediately. */
+    ASSERT_CMR_CALL( CMRsetProgressCallback(cmr, NULL, NULL) );
+    bool isTU;
+    ASSERT_EQ( CMRtuTest(cmr, matrix, &isTU, NULL, NULL, NULL, NULL, DBL_MAX), CMR_ERROR_TIMEOUT );
+    CMRclearInterrupt(cmr);
+    ASSERT_FALSE( CMRisInterrupted(cmr) );
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, NULL, NULL, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Environment, MemoryLimit)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  ASSERT_EQ( CMRgetMemoryLimit(cmr), 0UL );
+
+  /* Block memory is accounted for until it is freed. */
+  size_t usage = CMRgetMemoryUsage(cmr);
+  int* array = NULL;
+  ASSERT_CMR_CALL( CMRallocBlockArray(cmr, &array, 1000) );
+  ASSERT_GE( CMRgetMemoryUsage(cmr), usage + 1000 * sizeof(int) );
+  ASSERT_CMR_CALL( CMRreallocBlockArray(cmr, &array, 2000) );
+  ASSERT_GE( CMRgetMemoryUsage(cmr), usage + 2000 * sizeof(int) );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &array) );
+  ASSERT_EQ( CMRgetMemoryUsage(cmr), usage );
+  ASSERT_GE( CMRgetMemoryPeak(cmr), usage + 2000 * sizeof(int) );
+
+  /* Allocations beyond the limit fail without changing the usage. */
+  ASSERT_CMR_CALL( CMRsetMemoryLimit(cmr, usage + 1000 * sizeof(int)) );
+  ASSERT_EQ( CMRgetMemoryLimit(cmr), usage + 1000 * sizeof(int) );
+  ASSERT_EQ( CMRallocBlockArray(cmr, &array, 1000), CMR_ERROR_MEMORY );
+  ASSERT_EQ( CMRgetMemoryUsage(cmr), usage );
+  ASSERT_CMR_CALL( CMRallocBlockArray(cmr, &array, 500) );
+  ASSERT_EQ( CMRreallocBlockArray(cmr, &array, 1000), CMR_ERROR_MEMORY );
+  ASSERT_TRUE( array != NULL );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &array) );
+  ASSERT_EQ( CMRgetMemoryUsage(cmr), usage );
+  ASSERT_CMR_CALL( CMRsetMemoryLimit(cmr, 0) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "9 9 "
+    "1 1 0 0 0 0 0 0 0 "
+    "1 1 1 0 0 0 0 0 0 "
+    "1 0 0 1 0 0 0 0 0 "
+    "0 1 1 1 0 0 0 0 0 "
+    "0 0 1 1 0 0 0 0 0 "
+    "0 0 0 0 1 1 1 0 0 "
+    "0 0 0 0 1 1 0 1 0 "
+    "0 0 0 0 0 1 0 1 1 "
+    "0 0 0 0 0 0 1 1 1 "
+  ) );
+
+  /* A test that needs less memory than the limit, even when keeping intermediate data, gives the same result. */
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  params.keepIntermediate = true;
+  CMR_MATROID_DEC* dec = NULL;
+  bool isRegular;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+  size_t peak = CMRgetMemoryPeak(cmr);
+
+  ASSERT_CMR_CALL( CMRsetMemoryLimit(cmr, 2 * peak) );
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+  ASSERT_LE( CMRgetMemoryPeak(cmr), 2 * peak );
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Environment, MemoryStats)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "9 9 "
+    "1 1 0 0 0 0 0 0 0 "
+    "1 1 1 0 0 0 0 0 0 "
+    "1 0 0 1 0 0 0 0 0 "
+    "0 1 1 1 0 0 0 0 0 "
+    "0 0 1 1 0 0 0 0 0 "
+    "0 0 0 0 1 1 1 0 0 "
+    "0 0 0 0 1 1 0 1 0 "
+    "0 0 0 0 0 1 0 1 1 "
+    "0 0 0 0 0 0 1 1 1 "
+  ) );
+
+  CMR_MEMORY_STATS stats;
+  ASSERT_CMR_CALL( CMRresetMemoryStats(cmr) );
+  ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+  ASSERT_EQ( stats.numBlockAllocations, 0UL );
+  ASSERT_EQ( stats.numStackAllocations, 0UL );
+  ASSERT_EQ( stats.stackPeak, 0UL );
+  size_t blockMemory = stats.blockMemory;
+
+  int* block = NULL;
+  ASSERT_CMR_CALL( CMRallocBlockArray(cmr, &block, 100) );
+  ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+  ASSERT_EQ( stats.numBlockAllocations, 1UL );
+  ASSERT_GE( stats.blockMemory, blockMemory + 100 * sizeof(int) );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &block) );
+
+  /* A regularity test uses both kinds of memory, but releases all block memory that is not returned. */
+  bool isRegular;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, NULL, NULL, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+  ASSERT_GT( stats.numBlockAllocations, 1UL );
+  ASSERT_EQ( stats.blockMemory, blockMemory );
+  ASSERT_GT( stats.numStackAllocations, 0UL );
+  ASSERT_GT( stats.stackPeak, 0UL );
+  ASSERT_GE( stats.memoryPeak, blockMemory + stats.stackMemory + 100 * sizeof(int) );
+
+  /* After a reset, the peaks only reflect what is still in use. */
+  ASSERT_CMR_CALL( CMRresetMemoryStats(cmr) );
+  ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+  ASSERT_EQ( stats.numBlockAllocations, 0UL );
+  ASSERT_EQ( stats.stackPeak, 0UL );
+  ASSERT_EQ( stats.memoryPeak, stats.blockMemory + stats.stackMemory );
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Allocator that counts how often memory is obtained and returned.
+ */
+
+struct CountingAllocator
+{
+  std::atomic<size_t> numAllocations;
+  std::atomic<size_t> numReleases;
+};
+
+static void* countingAllocate(size_t size, void* data)
+{
+  ++((CountingAllocator*) data)->numAllocations;
+  return malloc(size);
+}
+
+static void* countingReallocate(void* ptr, size_t size, void* data)
+{
+  if (!ptr)
+    ++((CountingAllocator*) data)->numAllocations;
+  return realloc(ptr, size);
+}
+
+static void countingRelease(void* ptr, void* data)
+{
+  if (ptr)
+    ++((CountingAllocator*) data)->numReleases;
+  free(ptr);
+}
+
+TEST(Environment, Allocator)
+{
+  CountingAllocator counter;
+  counter.numAllocations = 0;
+  counter.numReleases = 0;
+  CMR_ALLOCATOR allocator = { countingAllocate, countingReallocate, countingRelease, &counter };
+
+  CMR* cmr = NULL;
+  CMR_ALLOCATOR incomplete = allocator;
+  incomplete.release = NULL;
+  ASSERT_EQ( CMRcreateEnvironmentAllocator(&cmr, &incomplete), CMR_ERROR_INPUT );
+  ASSERT_EQ( counter.numAllocations, 0UL );
+
+  ASSERT_CMR_CALL( CMRcreateEnvironmentAllocator(&cmr, &allocator) );
+  ASSERT_GT( counter.numAllocations, 0UL );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "9 9 "
+    "1 1 0 0 0 0 0 0 0 "
+    "1 1 1 0 0 0 0 0 0 "
+    "1 0 0 1 0 0 0 0 0 "
+    "0 1 1 1 0 0 0 0 0 "
+    "0 0 1 1 0 0 0 0 0 "
+    "0 0 0 0 1 1 1 0 0 "
+    "0 0 0 0 1 1 0 1 0 "
+    "0 0 0 0 0 1 0 1 1 "
+    "0 0 0 0 0 0 1 1 1 "
+  ) );
+
+  /* Both block and stack memory come from the allocator, also for worker threads. */
+  for (int numThreads = 1; numThreads <= 2; ++numThreads)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+    size_t numAllocations = counter.numAllocations;
+    bool isRegular;
+    CMR_MATROID_DEC* dec = NULL;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, NULL, NULL, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    ASSERT_GT( counter.numAllocations, numAllocations );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+  ASSERT_EQ( counter.numAllocations, counter.numReleases );
+}
+
+TEST(Environment, HardwareCounters)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  ASSERT_FALSE( CMRgetHardwareCounters(cmr) );
+  CMR_ERROR error = CMRsetHardwareCounters(cmr, true);
+  if (error == CMR_ERROR_INPUT)
+  {
+    /* The platform does not support performance counters. */
+    ASSERT_FALSE( CMRgetHardwareCounters(cmr) );
+    ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+    return;
+  }
+  ASSERT_CMR_CALL( error );
+  ASSERT_TRUE( CMRgetHardwareCounters(cmr) );
+
+  /* R10 is not graphic, such that the graphicness test is applied. */
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "5 5 "
+    "1 0 0 1 1 "
+    "1 1 0 0 1 "
+    "0 1 1 0 1 "
+    "0 0 1 1 1 "
+    "1 1 1 1 1 "
+  ) );
+
+  /* Without access to the counters, they remain 0. */
+  CMR_REGULAR_STATS stats;
+  ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+  bool isRegular;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, NULL, &stats, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  if (stats.graphic.checkCounters.cycles > 0)
+  {
+    ASSERT_GT( stats.graphic.checkCounters.instructions, 0UL );
+  }
+  ASSERT_CMR_CALL( CMRregularStatsPrint(stdout, &stats, NULL) );
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Environment, BlockPools)
+{
+  CountingAllocator counter;
+  counter.numAllocations = 0;
+  counter.numReleases = 0;
+  CMR_ALLOCATOR allocator = { countingAllocate, countingReallocate, countingRelease, &counter };
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironmentAllocator(&cmr, &allocator) );
+
+  /* A freed small block is handed out again for the next block of similar size. */
+  char* first = NULL;
+  ASSERT_CMR_CALL( CMRallocBlockArray(cmr, &first, 24) );
+  char* reused = first;
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &first) );
+  size_t numAllocations = counter.numAllocations;
+  char* second = NULL;
+  ASSERT_CMR_CALL( CMRallocBlockArray(cmr, &second, 30) );
+  ASSERT_EQ( second, reused );
+  ASSERT_EQ( counter.numAllocations, numAllocations );
+
+  /* Growing within the rounded size keeps the block. */
+  ASSERT_CMR_CALL( CMRreallocBlockArray(cmr, &second, 32) );
+  ASSERT_EQ( second, reused );
+  ASSERT_CMR_CALL( CMRreallocBlockArray(cmr, &second, 1000) );
+  for (size_t i = 0; i < 1000; ++i)
+    second[i] = (char) i;
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &second) );
+
+  /* Repeated allocations of small objects do not reach the allocator. */
+  numAllocations = counter.numAllocations;
+  for (int round = 0; round < 100; ++round)
+  {
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRsubmatCreate(cmr, 3, 4, &submatrix) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  }
+  ASSERT_LE( counter.numAllocations, numAllocations + 3 );
+
+  /* The pools are emptied when the environment is freed. */
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+  ASSERT_EQ( counter.numAllocations, counter.numReleases );
+}
+
+TEST(Environment, StackReservation)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Pre-reserving stack memory allocates it at once. */
+  CMR_MEMORY_STATS stats;
+  ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+  size_t stackMemory = stats.stackMemory;
+  ASSERT_CMR_CALL( CMRreserveStack(cmr, 1UL << 20) );
+  ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+  ASSERT_GE( stats.stackMemory, stackMemory + (1UL << 20) );
+  stackMemory = stats.stackMemory;
+  ASSERT_CMR_CALL( CMRreserveStack(cmr, 1UL << 20) );
+  ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+  ASSERT_EQ( stats.stackMemory, stackMemory );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+
+  /* A reservation is only accounted for as far as it is used. */
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_ERROR error = CMRsetStackReservation(cmr, 1UL << 30);
+  if (error == CMR_OKAY)
+  {
+    ASSERT_CMR_CALL( CMRreserveStack(cmr, 1UL << 24) );
+    ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+    ASSERT_EQ( stats.stackMemory, 0UL );
+
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "5 5 "
+      "1 1 0 0 1 "
+      "1 1 1 0 0 "
+      "0 1 1 1 0 "
+      "0 0 1 1 1 "
+      "1 0 0 1 1 "
+    ) );
+    bool isRegular;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, NULL, NULL, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+    ASSERT_CMR_CALL( CMRgetMemoryStats(cmr, &stats) );
+    ASSERT_EQ( stats.stackMemory % (1UL << 20), 0UL );
+    ASSERT_LT( stats.stackMemory, 1UL << 30 );
+  }
+  else
+    ASSERT_EQ( error, CMR_ERROR_INPUT );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
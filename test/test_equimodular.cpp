@@ -6,6 +6,9 @@
 #include <cmr/separation.h>
 #include <cmr/graphic.h>
 
+#include <cstdlib>
+#include <vector>
+
 TEST(Equimodular, Examples)
 {
   CMR* cmr = NULL;
@@ -84,6 +87,194 @@ TEST(Equimodular, Examples)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+TEST(Equimodular, PrescribedDeterminant)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_INTMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToIntMatrix(cmr, &matrix, "4 4 "
+    " 1 1 1 1 "
+    " 1 1 0 0 "
+    " 1 0 1 0 "
+    " 1 0 0 1 "
+  ) );
+
+  /* The elimination stops as soon as a pivot rules out k. */
+  const int64_t prescribed[4] = { 1, 2, 3, 4 };
+  const bool expectedEquimodular[4] = { false, true, false, false };
+  const int64_t expectedK[4] = { 0, 2, 0, 0 };
+  for (int i = 0; i < 4; ++i)
+  {
+    bool isEquimodular;
+    int64_t k = prescribed[i];
+    CMR_EQUIMODULAR_STATS stats;
+    ASSERT_CMR_CALL( CMRequimodularStatsInit(&stats) );
+    ASSERT_CMR_CALL( CMRequimodularTest(cmr, matrix, &isEquimodular, &k, NULL, &stats, DBL_MAX) );
+    ASSERT_EQ(isEquimodular, expectedEquimodular[i]);
+    ASSERT_EQ(k, expectedK[i]);
+  }
+
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+
+  /* The first pivot rules out unimodularity. */
+  ASSERT_CMR_CALL( stringToIntMatrix(cmr, &matrix, "3 4 "
+    " 2 0 0 1 "
+    " 0 2 0 1 "
+    " 0 0 2 1 "
+  ) );
+
+  bool isUnimodular;
+  CMR_EQUIMODULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRequimodularParamsInit(&params) );
+  CMR_EQUIMODULAR_STATS stats;
+  ASSERT_CMR_CALL( CMRequimodularStatsInit(&stats) );
+  ASSERT_CMR_CALL( CMRunimodularTest(cmr, matrix, &isUnimodular, &params, &stats, DBL_MAX) );
+  ASSERT_FALSE(isUnimodular);
+
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Equimodular, Sparse)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Interval matrices are totally unimodular, and scaling a row by 2 doubles all bases' determinants. */
+  for (int scale = 1; scale <= 2; ++scale)
+  {
+    const size_t numRows = 60;
+    const size_t numColumns = 400;
+    srand(scale);
+    std::vector<size_t> firstRows(numColumns);
+    std::vector<size_t> beyondRows(numColumns);
+    size_t numNonzeros = 0;
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      firstRows[column] = rand() % numRows;
+      beyondRows[column] = firstRows[column] + 1 + rand() % (numRows - firstRows[column]);
+      numNonzeros += beyondRows[column] - firstRows[column];
+    }
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      firstRows.push_back(row);
+      beyondRows.push_back(row + 1);
+      ++numNonzeros;
+    }
+
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRintmatCreate(cmr, &matrix, numRows, numColumns + numRows, numNonzeros) );
+    size_t entry = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = entry;
+      for (size_t column = 0; column < numColumns + numRows; ++column)
+      {
+        if (firstRows[column] <= row && row < beyondRows[column])
+        {
+          matrix->entryColumns[entry] = column;
+          matrix->entryValues[entry] = row == 0 ? scale : 1;
+          ++entry;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = entry;
+
+    bool isEquimodular;
+    int64_t k = 0;
+    ASSERT_CMR_CALL( CMRequimodularTest(cmr, matrix, &isEquimodular, &k, NULL, NULL, DBL_MAX) );
+    ASSERT_TRUE(isEquimodular);
+    ASSERT_EQ(k, scale);
+
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Equimodular, StrongThreads)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+  CMR_EQUIMODULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRequimodularParamsInit(&params) );
+
+  {
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToIntMatrix(cmr, &matrix, "2 3 "
+      "2 2 0 "
+      "0 2 2 "
+    ) );
+
+    for (int numThreads = 1; numThreads <= 2; ++numThreads)
+    {
+      ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+      bool isStronglyEquimodular;
+      int64_t k = 0;
+      CMR_EQUIMODULAR_STATS stats;
+      ASSERT_CMR_CALL( CMRequimodularStatsInit(&stats) );
+      ASSERT_CMR_CALL( CMRequimodularTestStrong(cmr, matrix, &isStronglyEquimodular, &k, &params, &stats, DBL_MAX) );
+      ASSERT_TRUE(isStronglyEquimodular);
+      ASSERT_EQ(k, 4);
+      ASSERT_EQ(stats.totalCount, 2UL);
+    }
+
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  /* The results of the sequential and concurrent tests agree on random matrices. */
+  srand(1);
+  for (int instance = 0; instance < 200; ++instance)
+  {
+    const size_t numRows = 3 + rand() % 3;
+    const size_t numColumns = 3 + rand() % 3;
+    std::vector<int> dense(numRows * numColumns);
+    size_t numNonzeros = 0;
+    for (size_t e = 0; e < numRows * numColumns; ++e)
+    {
+      dense[e] = (rand() % 4) - 1;
+      if (dense[e])
+        ++numNonzeros;
+    }
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRintmatCreate(cmr, &matrix, numRows, numColumns, numNonzeros) );
+    size_t entry = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = entry;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        if (dense[row * numColumns + column])
+        {
+          matrix->entryColumns[entry] = column;
+          matrix->entryValues[entry] = dense[row * numColumns + column];
+          ++entry;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = entry;
+
+    bool isStronglyEquimodular[2];
+    int64_t k[2] = { 0, 0 };
+    for (int numThreads = 1; numThreads <= 2; ++numThreads)
+    {
+      ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+      CMR_EQUIMODULAR_STATS stats;
+      ASSERT_CMR_CALL( CMRequimodularStatsInit(&stats) );
+      ASSERT_CMR_CALL( CMRequimodularTestStrong(cmr, matrix, &isStronglyEquimodular[numThreads - 1],
+        &k[numThreads - 1], &params, &stats, DBL_MAX) );
+    }
+    ASSERT_EQ(isStronglyEquimodular[0], isStronglyEquimodular[1]);
+    ASSERT_EQ(k[0], k[1]);
+
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
 #if defined(CMR_WITH_GMP)
 
 TEST(Equimodular, GMP)
@@ -58,3 +58,129 @@ TEST(Graph, Modifications)
   
   CMRfreeEnvironment(&cmr);
 }
+
+/**
+ * \brief Checks that \p frozen visits the incidences of all nodes of \p graph as the incidence iterators do.
+ */
+
+static
+void checkFrozen(CMR_GRAPH* graph, CMR_GRAPH_FROZEN* frozen)
+{
+  for (CMR_GRAPH_NODE v = CMRgraphNodesFirst(graph); CMRgraphNodesValid(graph, v); v = CMRgraphNodesNext(graph, v))
+  {
+    size_t f = CMRgraphFrozenIncFirst(frozen, v);
+    for (CMR_GRAPH_ITER i = CMRgraphIncFirst(graph, v); CMRgraphIncValid(graph, i); i = CMRgraphIncNext(graph, i))
+    {
+      ASSERT_LT(f, CMRgraphFrozenIncBeyond(frozen, v));
+      ASSERT_EQ(CMRgraphFrozenIncEdge(frozen, f), CMRgraphIncEdge(graph, i));
+      ASSERT_EQ(CMRgraphFrozenIncTarget(frozen, f), CMRgraphIncTarget(graph, i));
+      ++f;
+    }
+    ASSERT_EQ(f, CMRgraphFrozenIncBeyond(frozen, v));
+  }
+}
+
+TEST(Graph, Freeze)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_GRAPH* graph = NULL;
+  ASSERT_CMR_CALL( CMRgraphCreateEmpty(cmr, &graph, 1, 1) );
+
+  CMR_GRAPH_NODE nodes[5];
+  for (int v = 0; v < 5; ++v)
+    ASSERT_CMR_CALL( CMRgraphAddNode(cmr, graph, &nodes[v]) );
+
+  /* Add a path with a parallel edge, a loop and some chords. */
+  CMR_GRAPH_EDGE edges[8];
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[0], nodes[1], &edges[0]) );
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[1], nodes[2], &edges[1]) );
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[2], nodes[1], &edges[2]) );
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[2], nodes[3], &edges[3]) );
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[3], nodes[3], &edges[4]) );
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[3], nodes[4], &edges[5]) );
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[4], nodes[0], &edges[6]) );
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[0], nodes[2], &edges[7]) );
+
+  CMR_GRAPH_FROZEN* frozen = NULL;
+  ASSERT_CMR_CALL( CMRgraphFreeze(cmr, graph, &frozen) );
+  ASSERT_EQ(frozen->nodesFirst[frozen->memNodes], 2 * CMRgraphNumEdges(graph) - 1);
+  checkFrozen(graph, frozen);
+  ASSERT_CMR_CALL( CMRgraphFrozenFree(cmr, &frozen) );
+
+  /* Reusing the memory of deleted edges destroys the order of the incidence lists by decreasing arcs. */
+  ASSERT_CMR_CALL( CMRgraphDeleteEdge(cmr, graph, edges[1]) );
+  ASSERT_CMR_CALL( CMRgraphDeleteEdge(cmr, graph, edges[4]) );
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[1], nodes[4], NULL) );
+  ASSERT_CMR_CALL( CMRgraphFreeze(cmr, graph, &frozen) );
+  ASSERT_EQ(frozen->nodesFirst[frozen->memNodes], 2 * CMRgraphNumEdges(graph));
+  checkFrozen(graph, frozen);
+  ASSERT_CMR_CALL( CMRgraphFrozenFree(cmr, &frozen) );
+
+  ASSERT_CMR_CALL( CMRgraphDeleteNode(cmr, graph, nodes[2]) );
+  ASSERT_CMR_CALL( CMRgraphFreeze(cmr, graph, &frozen) );
+  checkFrozen(graph, frozen);
+  ASSERT_CMR_CALL( CMRgraphFrozenFree(cmr, &frozen) );
+
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Graph, CreateFromEdges)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  const CMR_GRAPH_NODE edgesU[] = { 0, 1, 2, 1, 3, 3, 4, 0 };
+  const CMR_GRAPH_NODE edgesV[] = { 1, 2, 1, 3, 3, 4, 0, 2 };
+
+  CMR_GRAPH* expected = NULL;
+  ASSERT_CMR_CALL( CMRgraphCreateEmpty(cmr, &expected, 0, 0) );
+  for (int v = 0; v < 5; ++v)
+    ASSERT_CMR_CALL( CMRgraphAddNode(cmr, expected, NULL) );
+  for (int e = 0; e < 8; ++e)
+    ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, expected, edgesU[e], edgesV[e], NULL) );
+
+  CMR_GRAPH* graph = NULL;
+  ASSERT_CMR_CALL( CMRgraphCreateFromEdges(cmr, &graph, 5, 8, edgesU, edgesV) );
+  ASSERT_EQ(CMRgraphNumNodes(graph), 5UL);
+  ASSERT_EQ(CMRgraphNumEdges(graph), 8UL);
+
+  CMR_GRAPH_NODE v = CMRgraphNodesFirst(graph);
+  for (CMR_GRAPH_NODE w = CMRgraphNodesFirst(expected); CMRgraphNodesValid(expected, w);
+    w = CMRgraphNodesNext(expected, w))
+  {
+    ASSERT_EQ(v, w);
+    CMR_GRAPH_ITER i = CMRgraphIncFirst(graph, v);
+    for (CMR_GRAPH_ITER j = CMRgraphIncFirst(expected, w); CMRgraphIncValid(expected, j);
+      j = CMRgraphIncNext(expected, j))
+    {
+      ASSERT_EQ(i, j);
+      ASSERT_EQ(CMRgraphIncTarget(graph, i), CMRgraphIncTarget(expected, j));
+      i = CMRgraphIncNext(graph, i);
+    }
+    ASSERT_FALSE(CMRgraphIncValid(graph, i));
+    v = CMRgraphNodesNext(graph, v);
+  }
+  ASSERT_FALSE(CMRgraphNodesValid(graph, v));
+
+  /* Reuse the memory for a smaller graph, which can be extended afterwards. */
+  ASSERT_CMR_CALL( CMRgraphAssignEdges(cmr, graph, 3, 2, edgesU, edgesV) );
+  ASSERT_EQ(CMRgraphNumNodes(graph), 3UL);
+  ASSERT_EQ(CMRgraphNumEdges(graph), 2UL);
+  CMR_GRAPH_NODE w;
+  ASSERT_CMR_CALL( CMRgraphAddNode(cmr, graph, &w) );
+  ASSERT_EQ(w, 3);
+  CMR_GRAPH_EDGE e;
+  ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, 0, w, &e) );
+  ASSERT_EQ(e, 2);
+  ASSERT_EQ(CMRgraphEdgeU(graph, e), 0);
+  ASSERT_EQ(CMRgraphEdgeV(graph, e), 3);
+
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &expected) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
@@ -59,10 +59,72 @@ void testBinaryGraphicMatrix(
   ASSERT_TRUE( CMRchrmatCheckEqual(matrix, result) );
   ASSERT_TRUE( isGraphic );
 
+  bool isVerified;
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, basis, cobasis, &isVerified) );
+  ASSERT_TRUE( isVerified );
+
   ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
   ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &basis) );
   ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &cobasis) );
   ASSERT_CMR_CALL( CMRchrmatFree(cmr, &result) );
+
+  /* Testing the matrix directly (without a transpose) must yield a valid graph as well. */
+  ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, matrix, &isGraphic, &graph, &basis, &cobasis, NULL, NULL, DBL_MAX) );
+  ASSERT_TRUE( isGraphic );
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, basis, cobasis, &isVerified) );
+  ASSERT_TRUE( isVerified );
+
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &basis) );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &cobasis) );
+
+  /* Adding the columns (resp. rows of the transpose) in another order must yield a graph for the original indices. */
+  for (CMR_GRAPHIC_ORDER order : { CMR_GRAPHIC_ORDER_CONNECTED, CMR_GRAPHIC_ORDER_REJECT })
+  {
+    ASSERT_CMR_CALL( CMRgraphicTestMatrixOrdered(cmr, matrix, order, &isGraphic, &graph, &basis, &cobasis, NULL, NULL,
+      DBL_MAX) );
+    ASSERT_TRUE( isGraphic );
+    ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, basis, cobasis, &isVerified) );
+    ASSERT_TRUE( isVerified );
+    ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+    ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &basis) );
+    ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &cobasis) );
+
+    ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+    ASSERT_CMR_CALL( CMRgraphicTestTransposeOrdered(cmr, transpose, order, &isGraphic, &graph, &basis, &cobasis, NULL,
+      NULL, DBL_MAX) );
+    ASSERT_TRUE( isGraphic );
+    ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, basis, cobasis, &isVerified) );
+    ASSERT_TRUE( isVerified );
+    ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+    ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &basis) );
+    ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &cobasis) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+  }
+
+  /* The variants for 32-bit indices must yield a valid graph as well. */
+  CMR_CHRMAT32* compact = NULL;
+  ASSERT_CMR_CALL( CMRchrmatToCompact(cmr, matrix, &compact) );
+  ASSERT_CMR_CALL( CMRgraphicTestMatrix32(cmr, compact, &isGraphic, &graph, &basis, &cobasis, NULL, DBL_MAX) );
+  ASSERT_TRUE( isGraphic );
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, basis, cobasis, &isVerified) );
+  ASSERT_TRUE( isVerified );
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &basis) );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &cobasis) );
+
+  CMR_CHRMAT32* compactTranspose = NULL;
+  ASSERT_CMR_CALL( CMRchrmat32Transpose(cmr, compact, &compactTranspose) );
+  ASSERT_CMR_CALL( CMRgraphicTestTranspose32(cmr, compactTranspose, &isGraphic, &graph, &basis, &cobasis, NULL,
+    DBL_MAX) );
+  ASSERT_TRUE( isGraphic );
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, basis, cobasis, &isVerified) );
+  ASSERT_TRUE( isVerified );
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &basis) );
+  ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &cobasis) );
+  ASSERT_CMR_CALL( CMRchrmat32Free(cmr, &compactTranspose) );
+  ASSERT_CMR_CALL( CMRchrmat32Free(cmr, &compact) );
 }
 
 void testBinaryNongraphicMatrix(
@@ -75,7 +137,20 @@ void testBinaryNongraphicMatrix(
   ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
   ASSERT_CMR_CALL( CMRgraphicTestTranspose(cmr, transpose, &isGraphic, NULL, NULL, NULL, NULL, NULL, DBL_MAX) );
   ASSERT_FALSE( isGraphic );
+  ASSERT_CMR_CALL( CMRgraphicTestTransposeOrdered(cmr, transpose, CMR_GRAPHIC_ORDER_CONNECTED, &isGraphic, NULL, NULL,
+    NULL, NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE( isGraphic );
+  ASSERT_CMR_CALL( CMRgraphicTestTransposeOrdered(cmr, transpose, CMR_GRAPHIC_ORDER_REJECT, &isGraphic, NULL, NULL,
+    NULL, NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE( isGraphic );
   ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+
+  ASSERT_CMR_CALL( CMRgraphicTestMatrixOrdered(cmr, matrix, CMR_GRAPHIC_ORDER_CONNECTED, &isGraphic, NULL, NULL, NULL,
+    NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE( isGraphic );
+  ASSERT_CMR_CALL( CMRgraphicTestMatrixOrdered(cmr, matrix, CMR_GRAPHIC_ORDER_REJECT, &isGraphic, NULL, NULL, NULL,
+    NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE( isGraphic );
 }
 
 void testBinaryMatrix(
@@ -1004,6 +1079,47 @@ TEST(Graphic, RepresentationMatrix)
   );
   ASSERT_TRUE( CMRchrmatCheckEqual(matrix, check) );
   ASSERT_CMR_CALL( CMRchrmatFree(cmr, &check) );
+
+  /* Verify the binary representation matrix, also for wrong matrices, forests and orderings. */
+  bool isVerified = false;
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, basis, cobasis, &isVerified) );
+  ASSERT_TRUE( isVerified );
+  stringToCharMatrix(cmr, &check, "5 6 "
+    "1 1 0 0 0 0 "
+    "1 0 1 0 0 0 "
+    "0 1 1 0 0 0 "
+    "0 1 0 0 0 0 "
+    "0 0 0 1 1 0 "
+  );
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, check, graph, basis, cobasis, &isVerified) );
+  ASSERT_FALSE( isVerified );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &check) );
+  stringToCharMatrix(cmr, &check, "5 6 "
+    "1 1 0 0 0 0 "
+    "1 0 1 0 0 0 "
+    "0 1 1 0 0 0 "
+    "0 1 1 0 0 1 "
+    "0 0 0 1 1 0 "
+  );
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, check, graph, basis, cobasis, &isVerified) );
+  ASSERT_FALSE( isVerified );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &check) );
+  CMR_GRAPH_EDGE wrongBasis[5] = { basis[0], basis[1], basis[2], basis[3], cobasis[3] };
+  CMR_GRAPH_EDGE wrongCobasis[6] = { cobasis[0], cobasis[1], cobasis[2], basis[4], cobasis[4], cobasis[5] };
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, wrongBasis, wrongCobasis, &isVerified) );
+  ASSERT_TRUE( isVerified );
+  wrongBasis[4] = cobasis[0];
+  wrongCobasis[0] = basis[4];
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, wrongBasis, wrongCobasis, &isVerified) );
+  ASSERT_FALSE( isVerified );
+  wrongBasis[4] = cobasis[5];
+  wrongCobasis[0] = cobasis[0];
+  wrongCobasis[5] = basis[4];
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, wrongBasis, wrongCobasis, &isVerified) );
+  ASSERT_FALSE( isVerified );
+  wrongCobasis[5] = cobasis[0];
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, basis, wrongCobasis, &isVerified) );
+  ASSERT_FALSE( isVerified );
   ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
 
   /* Check network matrix. */
@@ -1025,3 +1141,428 @@ TEST(Graphic, RepresentationMatrix)
   ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+TEST(Graphic, RepresentationMatrixThreads)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* A grid graph with enough coforest edges for the columns to be distributed among several workers. */
+  const size_t size = 80;
+  CMR_GRAPH* graph = NULL;
+  ASSERT_CMR_CALL( CMRgraphCreateEmpty(cmr, &graph, size * size, 2 * size * size) );
+  CMR_GRAPH_NODE nodes[size * size];
+  for (size_t v = 0; v < size * size; ++v)
+    ASSERT_CMR_CALL( CMRgraphAddNode(cmr, graph, &nodes[v]) );
+  for (size_t x = 0; x < size; ++x)
+  {
+    for (size_t y = 0; y < size; ++y)
+    {
+      if (x + 1 < size)
+        ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[x * size + y], nodes[(x + 1) * size + y], NULL) );
+      if (y + 1 < size)
+        ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, graph, nodes[x * size + y + 1], nodes[x * size + y], NULL) );
+    }
+  }
+
+  CMR_CHRMAT* sequentialMatrix = NULL;
+  CMR_CHRMAT* sequentialNetwork = NULL;
+  ASSERT_CMR_CALL( CMRgraphicComputeMatrix(cmr, graph, &sequentialMatrix, NULL, 0, NULL, 0, NULL, NULL) );
+  ASSERT_CMR_CALL( CMRnetworkComputeMatrix(cmr, graph, &sequentialNetwork, NULL, NULL, 0, NULL, 0, NULL, NULL) );
+  ASSERT_EQ( sequentialMatrix->numRows, size * size - 1 );
+  ASSERT_EQ( sequentialMatrix->numColumns, (size - 1) * (size - 1) );
+
+  /* The matrices must not depend on the number of threads, also if only the transposes are requested. */
+  for (int numThreads = 2; numThreads <= 4; numThreads += 2)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+    CMR_CHRMAT* matrix = NULL;
+    CMR_CHRMAT* transpose = NULL;
+    ASSERT_CMR_CALL( CMRgraphicComputeMatrix(cmr, graph, &matrix, &transpose, 0, NULL, 0, NULL, NULL) );
+    ASSERT_TRUE( CMRchrmatCheckEqual(matrix, sequentialMatrix) );
+    bool areTranspose = false;
+    ASSERT_CMR_CALL( CMRchrmatCheckTranspose(cmr, matrix, transpose, &areTranspose) );
+    ASSERT_TRUE( areTranspose );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+    ASSERT_CMR_CALL( CMRnetworkComputeMatrix(cmr, graph, NULL, &transpose, NULL, 0, NULL, 0, NULL, NULL) );
+    ASSERT_CMR_CALL( CMRchrmatCheckTranspose(cmr, sequentialNetwork, transpose, &areTranspose) );
+    ASSERT_TRUE( areTranspose );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &sequentialNetwork) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &sequentialMatrix) );
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Graphic, NongraphicSubmatrix)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* The Fano matrix in rows 1,3,4 and columns 0,2,5,6, extended by graphic parts. */
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "6 7 "
+    "1 0 0 1 0 0 0 "
+    "1 0 1 0 0 1 0 "
+    "0 1 0 1 0 0 0 "
+    "1 0 0 0 1 1 1 "
+    "0 0 1 0 0 1 1 "
+    "0 1 0 0 1 0 0 "
+  ) );
+
+  bool isGraphic;
+  CMR_SUBMAT* submatrix = NULL;
+  ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, matrix, &isGraphic, NULL, NULL, NULL, &submatrix, NULL, DBL_MAX) );
+  ASSERT_FALSE( isGraphic );
+  ASSERT_TRUE( submatrix );
+
+  /* The submatrix must be non-graphic, but removing any row or column must yield a graphic matrix. */
+  CMR_CHRMAT* violator = NULL;
+  ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, submatrix, &violator) );
+  ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, violator, &isGraphic, NULL, NULL, NULL, NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE( isGraphic );
+  for (size_t remove = 0; remove < violator->numRows + violator->numColumns; ++remove)
+  {
+    bool isRow = remove < violator->numRows;
+    CMR_SUBMAT* smaller = NULL;
+    ASSERT_CMR_CALL( CMRsubmatCreate(cmr, violator->numRows - (isRow ? 1 : 0),
+      violator->numColumns - (isRow ? 0 : 1), &smaller) );
+    smaller->numRows = 0;
+    for (size_t row = 0; row < violator->numRows; ++row)
+    {
+      if (row != remove)
+        smaller->rows[smaller->numRows++] = row;
+    }
+    smaller->numColumns = 0;
+    for (size_t column = 0; column < violator->numColumns; ++column)
+    {
+      if (column + violator->numRows != remove)
+        smaller->columns[smaller->numColumns++] = column;
+    }
+
+    CMR_CHRMAT* smallerMatrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, violator, smaller, &smallerMatrix) );
+    ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, smallerMatrix, &isGraphic, NULL, NULL, NULL, NULL, NULL, DBL_MAX) );
+    ASSERT_TRUE( isGraphic );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &smallerMatrix) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &smaller) );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &violator) );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Graphic, NongraphicSubmatrixThreads)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "6 7 "
+    "1 0 0 1 0 0 0 "
+    "1 0 1 0 0 1 0 "
+    "0 1 0 1 0 0 0 "
+    "1 0 0 0 1 1 1 "
+    "0 0 1 0 0 1 1 "
+    "0 1 0 0 1 0 0 "
+  ) );
+
+  /* The submatrix must not depend on the number of threads. */
+  bool isGraphic;
+  CMR_SUBMAT* sequentialSubmatrix = NULL;
+  ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, matrix, &isGraphic, NULL, NULL, NULL, &sequentialSubmatrix, NULL,
+    DBL_MAX) );
+  ASSERT_FALSE( isGraphic );
+  for (int numThreads = 2; numThreads <= 4; numThreads += 2)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, matrix, &isGraphic, NULL, NULL, NULL, &submatrix, NULL, DBL_MAX) );
+    ASSERT_FALSE( isGraphic );
+    ASSERT_EQ( submatrix->numRows, sequentialSubmatrix->numRows );
+    ASSERT_EQ( submatrix->numColumns, sequentialSubmatrix->numColumns );
+    for (size_t r = 0; r < submatrix->numRows; ++r)
+      ASSERT_EQ( submatrix->rows[r], sequentialSubmatrix->rows[r] );
+    for (size_t c = 0; c < submatrix->numColumns; ++c)
+      ASSERT_EQ( submatrix->columns[c], sequentialSubmatrix->columns[c] );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &sequentialSubmatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Graphic, Online)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* The Fano matrix is not graphic, so its last column is rejected. */
+  {
+    CMR_GRAPHIC_ONLINE* online = NULL;
+    ASSERT_CMR_CALL( CMRgraphicOnlineCreate(cmr, &online, 3) );
+    size_t columns[5][3] = { {0, 1}, {0, 2}, {1, 2}, {0, 1, 2}, {2} };
+    size_t columnsNumEntries[5] = { 2, 2, 2, 3, 1 };
+    bool expectedGraphic[5] = { true, true, true, false, true };
+    for (size_t c = 0; c < 5; ++c)
+    {
+      bool isGraphic;
+      ASSERT_CMR_CALL( CMRgraphicOnlineTryColumn(online, columnsNumEntries[c], columns[c], &isGraphic) );
+      ASSERT_EQ( isGraphic, expectedGraphic[c] );
+      if (isGraphic)
+        ASSERT_CMR_CALL( CMRgraphicOnlineAddColumn(online, columnsNumEntries[c], columns[c]) );
+      else
+        ASSERT_EQ( CMRgraphicOnlineAddColumn(online, columnsNumEntries[c], columns[c]), CMR_ERROR_INVALID );
+    }
+    ASSERT_EQ( CMRgraphicOnlineNumColumns(online), 4UL );
+    ASSERT_CMR_CALL( CMRgraphicOnlineFree(cmr, &online) );
+  }
+
+  /* Random binary columns are accepted if and only if the matrix remains graphic. */
+  srand(0);
+  for (int i = 0; i < 20; ++i)
+  {
+    const size_t numRows = 12;
+    const size_t numColumns = 30;
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, 0, 0) );
+    for (size_t row = 0; row <= numRows; ++row)
+      matrix->rowSlice[row] = 0;
+    CMR_GRAPHIC_ONLINE* online = NULL;
+    ASSERT_CMR_CALL( CMRgraphicOnlineCreate(cmr, &online, numRows) );
+
+    size_t column[numRows];
+    for (size_t c = 0; c < numColumns; ++c)
+    {
+      size_t numEntries = 0;
+      for (size_t row = 0; row < numRows; ++row)
+      {
+        if (rand() % 4 == 0)
+          column[numEntries++] = row;
+      }
+
+      bool isGraphic;
+      ASSERT_CMR_CALL( CMRgraphicOnlineTryColumn(online, numEntries, column, &isGraphic) );
+      if (isGraphic)
+        ASSERT_CMR_CALL( CMRgraphicOnlineAddColumn(online, numEntries, column) );
+
+      /* Compare with the matrix of the accepted columns plus the new column. */
+      size_t k = CMRgraphicOnlineNumColumns(online) - (isGraphic ? 1 : 0);
+      CMR_CHRMAT* test = NULL;
+      ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &test, numRows, k + 1, numRows * (k + 1)) );
+      test->numNonzeros = 0;
+      for (size_t row = 0; row < numRows; ++row)
+      {
+        test->rowSlice[row] = test->numNonzeros;
+        for (size_t e = matrix->rowSlice[row]; e < matrix->rowSlice[row + 1]; ++e)
+        {
+          if (matrix->entryColumns[e] < k)
+          {
+            test->entryColumns[test->numNonzeros] = matrix->entryColumns[e];
+            test->entryValues[test->numNonzeros++] = 1;
+          }
+        }
+        for (size_t j = 0; j < numEntries; ++j)
+        {
+          if (column[j] == row)
+          {
+            test->entryColumns[test->numNonzeros] = k;
+            test->entryValues[test->numNonzeros++] = 1;
+          }
+        }
+      }
+      test->rowSlice[numRows] = test->numNonzeros;
+
+      bool expectedGraphic;
+      ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, test, &expectedGraphic, NULL, NULL, NULL, NULL, NULL, DBL_MAX) );
+      ASSERT_EQ( isGraphic, expectedGraphic );
+
+      if (isGraphic)
+      {
+        ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+        matrix = test;
+      }
+      else
+        ASSERT_CMR_CALL( CMRchrmatFree(cmr, &test) );
+    }
+
+    /* The extracted graph must represent the accepted columns. */
+    CMR_GRAPH* graph = NULL;
+    CMR_GRAPH_EDGE* forest = NULL;
+    CMR_GRAPH_EDGE* coforest = NULL;
+    ASSERT_CMR_CALL( CMRgraphicOnlineComputeGraph(online, &graph, &forest, &coforest) );
+    ASSERT_EQ( matrix->numColumns, CMRgraphicOnlineNumColumns(online) );
+    bool isVerified;
+    ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, matrix, graph, forest, coforest, &isVerified) );
+    ASSERT_TRUE( isVerified );
+
+    ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &coforest) );
+    ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &forest) );
+    ASSERT_CMR_CALL( CMRgraphFree(cmr, &graph) );
+    ASSERT_CMR_CALL( CMRgraphicOnlineFree(cmr, &online) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Graphic, GreedyOrders)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  srand(1);
+  for (int i = 0; i < 10; ++i)
+  {
+    const size_t numRows = 10;
+    const size_t numColumns = 25;
+    const size_t numOrders = 4;
+    const size_t numPrefixColumns = 5;
+
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        if (rand() % 3 == 0)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros++] = 1;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = matrix->numNonzeros;
+    CMR_CHRMAT* transpose = NULL;
+    ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+
+    /* All orders start with the columns 0, ..., 4 and continue randomly. */
+    size_t orders[numOrders][numColumns];
+    size_t* orderedColumns[numOrders];
+    for (size_t k = 0; k < numOrders; ++k)
+    {
+      for (size_t c = 0; c < numColumns; ++c)
+        orders[k][c] = c;
+      for (size_t c = numColumns - 1; k > 0 && c > numPrefixColumns; --c)
+      {
+        size_t d = numPrefixColumns + rand() % (c - numPrefixColumns + 1);
+        size_t temp = orders[k][c];
+        orders[k][c] = orders[k][d];
+        orders[k][d] = temp;
+      }
+      orderedColumns[k] = orders[k];
+    }
+
+    /* The result is the first largest one of the individual greedy runs. */
+    CMR_SUBMAT* expected = NULL;
+    for (size_t k = 0; k < numOrders; ++k)
+    {
+      CMR_SUBMAT* submatrix = NULL;
+      ASSERT_CMR_CALL( CMRgraphicTestColumnSubmatrixGreedy(cmr, transpose, orderedColumns[k], &submatrix) );
+      if (!expected || submatrix->numColumns > expected->numColumns)
+      {
+        ASSERT_CMR_CALL( CMRsubmatFree(cmr, &expected) );
+        expected = submatrix;
+      }
+      else
+        ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    }
+
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRgraphicTestColumnSubmatrixGreedyOrders(cmr, transpose, numOrders, orderedColumns,
+      numPrefixColumns, &submatrix) );
+    ASSERT_EQ( submatrix->numRows, numRows );
+
+    CMR_CHRMAT* graphicSubmatrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, submatrix, &graphicSubmatrix) );
+    bool isGraphic;
+    ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, graphicSubmatrix, &isGraphic, NULL, NULL, NULL, NULL, NULL,
+      DBL_MAX) );
+    ASSERT_TRUE( isGraphic );
+
+    ASSERT_EQ( submatrix->numColumns, expected->numColumns );
+    for (size_t c = 0; c < submatrix->numColumns; ++c)
+      ASSERT_EQ( submatrix->columns[c], expected->columns[c] );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &graphicSubmatrix) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &expected) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Graphic, GreedyPortfolio)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  srand(2);
+  for (int i = 0; i < 10; ++i)
+  {
+    const size_t numRows = 12;
+    const size_t numColumns = 30;
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        if (rand() % 4 == 0)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros++] = 1;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = matrix->numNonzeros;
+    CMR_CHRMAT* transpose = NULL;
+    ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+
+    /* Order 2 is the natural one, so the portfolio is at least as good as the plain greedy search. */
+    CMR_SUBMAT* natural = NULL;
+    ASSERT_CMR_CALL( CMRgraphicTestColumnSubmatrixGreedy(cmr, transpose, NULL, &natural) );
+
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+    CMR_SUBMAT* sequential = NULL;
+    ASSERT_CMR_CALL( CMRgraphicTestColumnSubmatrixPortfolio(cmr, transpose, 8, 17, &sequential) );
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 4) );
+    CMR_SUBMAT* parallel = NULL;
+    ASSERT_CMR_CALL( CMRgraphicTestColumnSubmatrixPortfolio(cmr, transpose, 8, 17, &parallel) );
+
+    ASSERT_GE( sequential->numColumns, natural->numColumns );
+    ASSERT_EQ( sequential->numRows, numRows );
+    ASSERT_EQ( parallel->numColumns, sequential->numColumns );
+    for (size_t c = 0; c < sequential->numColumns; ++c)
+      ASSERT_EQ( parallel->columns[c], sequential->columns[c] );
+
+    CMR_CHRMAT* graphicSubmatrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, sequential, &graphicSubmatrix) );
+    bool isGraphic;
+    ASSERT_CMR_CALL( CMRgraphicTestMatrix(cmr, graphicSubmatrix, &isGraphic, NULL, NULL, NULL, NULL, NULL,
+      DBL_MAX) );
+    ASSERT_TRUE( isGraphic );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &graphicSubmatrix) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &parallel) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &sequential) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &natural) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
@@ -3,6 +3,9 @@
 #include "common.h"
 #include "../src/cmr/hashtable.h"
 
+#include <algorithm>
+#include <vector>
+
 TEST(Hashtable, Functionality)
 {
   CMR* cmr = NULL;
@@ -39,3 +42,58 @@ TEST(Hashtable, Functionality)
 
   CMRfreeEnvironment(&cmr);
 }
+
+TEST(Hashtable, ListHashtable)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Small initial sizes such that nodes and buckets are enlarged. */
+  CMR_LISTHASHTABLE* hashtable = NULL;
+  ASSERT_CMR_CALL( CMRlisthashtableCreate(cmr, &hashtable, 2, 2) );
+
+  /* Value v has hash v % 50, i.e., there are groups of values with equal hash values. */
+  const size_t numValues = 1000;
+  std::vector<CMR_LISTHASHTABLE_ENTRY> entries(numValues);
+  for (size_t v = 0; v < numValues; ++v)
+    ASSERT_CMR_CALL( CMRlisthashtableInsert(cmr, hashtable, v % 50, v, &entries[v]) );
+
+  /* Remove every third value. */
+  for (size_t v = 0; v < numValues; v += 3)
+    ASSERT_CMR_CALL( CMRlisthashtableRemove(cmr, hashtable, entries[v]) );
+
+  /* The remaining values of each group are found in an unspecified order. */
+  for (size_t hash = 0; hash < 100; ++hash)
+  {
+    std::vector<size_t> expected;
+    for (size_t v = 0; v < numValues; ++v)
+    {
+      if (v % 50 == hash && v % 3 != 0)
+        expected.push_back(v);
+    }
+    std::vector<size_t> found;
+    for (CMR_LISTHASHTABLE_ENTRY entry = CMRlisthashtableFindFirst(hashtable, hash); entry != SIZE_MAX;
+      entry = CMRlisthashtableFindNext(hashtable, hash, entry))
+    {
+      ASSERT_EQ( CMRlisthashtableHash(hashtable, entry), hash );
+      size_t value = CMRlisthashtableValue(hashtable, entry);
+      ASSERT_EQ( entries[value], entry );
+      found.push_back(value);
+    }
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ( found, expected );
+  }
+
+  /* Removed entries are reused. */
+  CMR_LISTHASHTABLE_ENTRY entry;
+  ASSERT_CMR_CALL( CMRlisthashtableInsert(cmr, hashtable, 4711, 17, &entry) );
+  ASSERT_EQ( CMRlisthashtableFindFirst(hashtable, 4711), entry );
+  ASSERT_EQ( CMRlisthashtableFindNext(hashtable, 4711, entry), SIZE_MAX );
+  ASSERT_EQ( CMRlisthashtableValue(hashtable, entry), 17UL );
+  ASSERT_LT( entry, numValues );
+  ASSERT_GE( CMRlisthashtableNumBuckets(hashtable), 2UL );
+
+  ASSERT_CMR_CALL( CMRlisthashtableFree(cmr, &hashtable) );
+
+  CMRfreeEnvironment(&cmr);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "common.h"
+#include "../src/cmr/heap.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+TEST(Heap, IntHeap)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  const int numKeys = 500;
+  for (int arity = 2; arity <= 8; arity *= 2)
+  {
+    CMR_INTHEAP heap;
+    ASSERT_CMR_CALL( CMRintheapInitStackArity(cmr, &heap, numKeys, arity) );
+
+    /* Insert all keys with random values and decrease some of them. */
+    srand(arity);
+    std::vector<int> values(numKeys);
+    for (int key = 0; key < numKeys; ++key)
+    {
+      values[key] = rand() % 1000;
+      ASSERT_CMR_CALL( CMRintheapInsert(&heap, key, values[key]) );
+    }
+    for (int key = 0; key < numKeys; key += 3)
+    {
+      values[key] -= rand() % 1000;
+      ASSERT_CMR_CALL( CMRintheapDecrease(&heap, key, values[key]) );
+    }
+
+    /* Extract half of them and reinsert some of those with smaller values. */
+    std::vector<int> extracted;
+    for (int i = 0; i < numKeys / 2; ++i)
+    {
+      ASSERT_FALSE( CMRintheapEmpty(&heap) );
+      int key = CMRintheapExtractMinimum(&heap);
+      ASSERT_FALSE( CMRintheapContains(&heap, key) );
+      extracted.push_back(key);
+    }
+    for (size_t i = 0; i < extracted.size(); i += 2)
+    {
+      int key = extracted[i];
+      values[key] = -1000 - rand() % 1000;
+      ASSERT_CMR_CALL( CMRintheapDecreaseInsert(&heap, key, values[key]) );
+      ASSERT_TRUE( CMRintheapContains(&heap, key) );
+    }
+
+    /* The remaining elements must come out sorted by value. */
+    std::vector<int> remaining;
+    while (!CMRintheapEmpty(&heap))
+    {
+      int value = CMRintheapMinimumValue(&heap);
+      int key = CMRintheapExtractMinimum(&heap);
+      ASSERT_EQ( value, values[key] );
+      remaining.push_back(value);
+    }
+    ASSERT_TRUE( std::is_sorted(remaining.begin(), remaining.end()) );
+    ASSERT_EQ( remaining.size(), (size_t) (numKeys - numKeys / 2 + (numKeys / 2 + 1) / 2) );
+
+    ASSERT_CMR_CALL( CMRintheapClearStack(cmr, &heap) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
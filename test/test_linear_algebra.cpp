@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include "common.h"
+
+#include <cmr/linear_algebra.h>
+#include "../src/cmr/hybrid_int.h"
+
+#include <cstdlib>
+#include <vector>
+
+/**
+ * \brief Computes the determinant of a dense matrix by fraction-free Gaussian elimination.
+ */
+
+static
+int64_t bareissDeterminant(std::vector<std::vector<__int128>> dense)
+{
+  size_t n = dense.size();
+  __int128 sign = 1;
+  __int128 previous = 1;
+  for (size_t k = 0; k < n; ++k)
+  {
+    size_t pivot = k;
+    while (pivot < n && dense[pivot][k] == 0)
+      ++pivot;
+    if (pivot == n)
+      return 0;
+    if (pivot != k)
+    {
+      std::swap(dense[pivot], dense[k]);
+      sign = -sign;
+    }
+    for (size_t i = k + 1; i < n; ++i)
+    {
+      for (size_t j = k + 1; j < n; ++j)
+        dense[i][j] = (dense[i][j] * dense[k][k] - dense[i][k] * dense[k][j]) / previous;
+    }
+    previous = dense[k][k];
+  }
+  return (int64_t) (sign * dense[n - 1][n - 1]);
+}
+
+TEST(LinearAlgebra, Determinant)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  {
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToIntMatrix(cmr, &matrix, "3 3 "
+      "0 1 1 "
+      "1 0 1 "
+      "1 1 0 "
+    ) );
+    int64_t determinant;
+    ASSERT_CMR_CALL( CMRintmatDeterminant(cmr, matrix, &determinant) );
+    ASSERT_EQ(determinant, 2);
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  {
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToIntMatrix(cmr, &matrix, "3 3 "
+      "1 2 3 "
+      "4 5 6 "
+      "7 8 9 "
+    ) );
+    int64_t determinant;
+    ASSERT_CMR_CALL( CMRintmatDeterminant(cmr, matrix, &determinant) );
+    ASSERT_EQ(determinant, 0);
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  {
+    /* The determinant is -10^18 - 1 and thus requires several primes. */
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToIntMatrix(cmr, &matrix, "2 2 "
+      "1000000000 1 "
+      "1 -1000000000 "
+    ) );
+    int64_t determinant;
+    ASSERT_CMR_CALL( CMRintmatDeterminant(cmr, matrix, &determinant) );
+    ASSERT_EQ(determinant, -1000000000000000001LL);
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  {
+    /* The leading 2-by-2 minor does not fit into 64 bits, but the determinant is 0. */
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToIntMatrix(cmr, &matrix, "3 3 "
+      "2147483647 2147483647 1 "
+      "-2147483647 2147483647 1 "
+      "2147483647 2147483647 1 "
+    ) );
+    int64_t determinant;
+    ASSERT_CMR_CALL( CMRintmatDeterminant(cmr, matrix, &determinant) );
+    ASSERT_EQ(determinant, 0);
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  {
+    /* The determinant is 2^90. */
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToIntMatrix(cmr, &matrix, "3 3 "
+      "1073741824 0 0 "
+      "0 1073741824 0 "
+      "0 0 1073741824 "
+    ) );
+    int64_t determinant;
+    ASSERT_EQ( CMRintmatDeterminant(cmr, matrix, &determinant), CMR_ERROR_OVERFLOW );
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(LinearAlgebra, DeterminantRandom)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 3) );
+
+  srand(1);
+  for (size_t test = 0; test < 48; ++test)
+  {
+    /* Sparse matrices are handled by the modular computation and dense ones by fraction-free elimination. */
+    size_t n = test / 2 + 1;
+    int sparsity = (test % 2) ? 2 : 6;
+    std::vector<std::vector<__int128>> dense(n, std::vector<__int128>(n, 0));
+    size_t numNonzeros = 0;
+    for (size_t row = 0; row < n; ++row)
+    {
+      for (size_t column = 0; column < n; ++column)
+      {
+        if (rand() % sparsity == 0)
+        {
+          dense[row][column] = (rand() % 7) - 3;
+          if (dense[row][column])
+            ++numNonzeros;
+        }
+      }
+    }
+
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRintmatCreate(cmr, &matrix, n, n, numNonzeros) );
+    size_t entry = 0;
+    for (size_t row = 0; row < n; ++row)
+    {
+      matrix->rowSlice[row] = entry;
+      for (size_t column = 0; column < n; ++column)
+      {
+        if (dense[row][column])
+        {
+          matrix->entryColumns[entry] = column;
+          matrix->entryValues[entry] = (int) dense[row][column];
+          ++entry;
+        }
+      }
+    }
+    matrix->rowSlice[n] = entry;
+
+    int64_t determinant;
+    ASSERT_CMR_CALL( CMRintmatDeterminant(cmr, matrix, &determinant) );
+    ASSERT_EQ(determinant, bareissDeterminant(dense));
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+#if defined(CMR_WITH_GMP)
+
+TEST(LinearAlgebra, HybridInt)
+{
+  mpz_t expected;
+  mpz_init(expected);
+  CMR_HYBRID_INT x, y, a, b;
+  CMRhybridInit(&x);
+  CMRhybridInit(&y);
+  CMRhybridInit(&a);
+  CMRhybridInit(&b);
+
+  /* 3037000500^2 overflows 64 bits. */
+  CMRhybridSetInt(&x, 3037000500LL);
+  CMRhybridSetInt(&a, 3037000500LL);
+  CMRhybridMul(&y, &a, &x);
+  ASSERT_TRUE(y.isBig);
+  mpz_set_si(expected, 3037000500LL);
+  mpz_mul(expected, expected, expected);
+  ASSERT_EQ(mpz_cmp(y.big, expected), 0);
+  ASSERT_EQ(CMRhybridCompareAbs(&y, &x), 1);
+
+  /* x^2 - y returns to the inline representation. */
+  CMRhybridSetInt(&b, -1);
+  CMRhybridLinearCombination(&y, &a, &x, &b, &y);
+  ASSERT_FALSE(y.isBig);
+  ASSERT_EQ(y.small, 0);
+
+  /* Divisions in both representations. */
+  CMRhybridSetInt(&x, -7);
+  CMRhybridSetInt(&a, 2);
+  CMRhybridDivide(&y, &x, &a, false);
+  ASSERT_EQ(y.small, -3);
+  CMRhybridDivide(&y, &x, &a, true);
+  ASSERT_EQ(y.small, -4);
+
+  mpz_set_si(expected, -1);
+  mpz_mul_2exp(expected, expected, 80);
+  mpz_sub_ui(expected, expected, 1);
+  CMRhybridSetMpz(&x, expected);
+  ASSERT_TRUE(x.isBig);
+  ASSERT_EQ(CMRhybridSign(&x), -1);
+  CMRhybridSetInt(&a, 1LL << 40);
+  CMRhybridDivide(&y, &x, &a, true);
+  ASSERT_FALSE(y.isBig);
+  ASSERT_EQ(y.small, -(1LL << 40) - 1);
+
+  /* The most negative 64-bit integer is not stored inline, such that negation cannot overflow. */
+  CMRhybridSetInt(&x, INT64_MIN);
+  ASSERT_TRUE(x.isBig);
+  CMRhybridNegate(&x);
+  ASSERT_EQ(mpz_sgn(x.big), 1);
+
+  CMRhybridClear(&b);
+  CMRhybridClear(&a);
+  CMRhybridClear(&y);
+  CMRhybridClear(&x);
+  mpz_clear(expected);
+}
+
+#endif /* CMR_WITH_GMP */
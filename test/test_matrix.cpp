@@ -1,9 +1,21 @@
 #include <gtest/gtest.h>
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
 
 #include "common.h"
 #include <cmr/matrix.h>
+#include "../src/cmr/listmatrix.h"
+#include "../src/cmr/entry_index.h"
+#include "../src/cmr/intersect.h"
+
+#if defined(CMR_WITH_ZLIB)
+#include <zlib.h>
+#endif /* CMR_WITH_ZLIB */
 
 TEST(Matrix, Read)
 {
@@ -169,6 +181,402 @@ TEST(Matrix, Read)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+TEST(Matrix, ReadParallel)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Two matrices in one stream; reading the first must not consume the second. */
+  {
+    const char* input = "2 2 1 1 2 -1 1 1\n"
+      "2 \n";
+    FILE* stream = fmemopen((char*) input, strlen(input), "r");
+    CMR_CHRMAT* first = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreateFromSparseStream(cmr, stream, &first) );
+    CMR_CHRMAT* second = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreateFromDenseStream(cmr, stream, &second) );
+    fclose(stream);
+    ASSERT_EQ( first->numNonzeros, 1UL );
+    ASSERT_EQ( first->entryValues[0], -1 );
+    ASSERT_EQ( second->numColumns, 1UL );
+    ASSERT_EQ( second->entryValues[0], 2 );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &second) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &first) );
+  }
+
+  /* Large files are parsed in parallel; the result must not depend on the number of threads. */
+  char sparseFileName[] = "/tmp/cmr-test-sparse-XXXXXX";
+  int fd = mkstemp(sparseFileName);
+  ASSERT_GE(fd, 0);
+  FILE* sparseFile = fdopen(fd, "w");
+  char denseFileName[] = "/tmp/cmr-test-dense-XXXXXX";
+  fd = mkstemp(denseFileName);
+  ASSERT_GE(fd, 0);
+  FILE* denseFile = fdopen(fd, "w");
+
+  const size_t numRows = 800;
+  const size_t numColumns = 900;
+  fprintf(sparseFile, "%zu %zu %zu\n", numRows, numColumns, numRows * numColumns / 2);
+  fprintf(denseFile, "%zu %zu\n", numRows, numColumns);
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      int value = (int) ((row * 7 + column * 13) % 5) - 2;
+      fprintf(denseFile, "%d ", value);
+      if ((row + column) % 2 == 0)
+      {
+        /* Nonzeros in reverse order to force sorting; values in various notations. */
+        size_t reverseRow = numRows - row;
+        size_t reverseColumn = numColumns - column;
+        fprintf(sparseFile, "%zu %zu %s\n", reverseRow, reverseColumn, value == 0 ? "0.0" : (value > 0 ? "+1e0" : "-1"));
+      }
+    }
+    fputc('\n', denseFile);
+  }
+  fclose(sparseFile);
+  fclose(denseFile);
+
+  CMR_DBLMAT* sparse[2] = { NULL, NULL };
+  CMR_INTMAT* dense[2] = { NULL, NULL };
+  for (int i = 0; i < 2; ++i)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, i == 0 ? 1 : 4) );
+    ASSERT_CMR_CALL( CMRdblmatCreateFromSparseFile(cmr, sparseFileName, NULL, &sparse[i]) );
+    ASSERT_CMR_CALL( CMRintmatCreateFromDenseFile(cmr, denseFileName, NULL, &dense[i]) );
+  }
+  ASSERT_TRUE( CMRdblmatCheckEqual(sparse[0], sparse[1]) );
+  ASSERT_TRUE( CMRintmatCheckEqual(dense[0], dense[1]) );
+  ASSERT_EQ( dense[0]->numNonzeros, numRows * numColumns * 4 / 5 );
+  ASSERT_EQ( sparse[0]->entryColumns[0], 0UL );
+  ASSERT_EQ( sparse[0]->entryValues[0], -1.0 );
+
+  /* A trailing token is detected by the parallel parser as well. */
+  denseFile = fopen(denseFileName, "a");
+  fputs("1\n", denseFile);
+  fclose(denseFile);
+  CMR_INTMAT* invalid = NULL;
+  ASSERT_EQ( CMRintmatCreateFromDenseFile(cmr, denseFileName, NULL, &invalid), CMR_ERROR_INPUT );
+  ASSERT_EQ( invalid, (CMR_INTMAT*) NULL );
+
+  remove(sparseFileName);
+  remove(denseFileName);
+
+  for (int i = 0; i < 2; ++i)
+  {
+    ASSERT_CMR_CALL( CMRdblmatFree(cmr, &sparse[i]) );
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &dense[i]) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Columns received by \ref streamColumn.
+ */
+
+struct StreamedColumns
+{
+  size_t numRows;
+  size_t stopColumn;
+  std::vector<std::vector<std::pair<size_t, char>>> columns;
+};
+
+static
+CMR_ERROR streamHeader(CMR* cmr, size_t numRows, size_t numColumns, size_t numNonzeros, void* data, bool* pstop)
+{
+  CMR_UNUSED(cmr);
+  CMR_UNUSED(numColumns);
+  CMR_UNUSED(numNonzeros);
+  CMR_UNUSED(pstop);
+  ((StreamedColumns*) data)->numRows = numRows;
+  return CMR_OKAY;
+}
+
+static
+CMR_ERROR streamColumn(CMR* cmr, size_t column, size_t numEntries, size_t* rows, char* values, void* data,
+  bool* pstop)
+{
+  CMR_UNUSED(cmr);
+  StreamedColumns* streamed = (StreamedColumns*) data;
+  if (column != streamed->columns.size())
+    return CMR_ERROR_INVALID;
+  std::vector<std::pair<size_t, char>> entries;
+  for (size_t e = 0; e < numEntries; ++e)
+    entries.push_back(std::make_pair(rows[e], values[e]));
+  std::sort(entries.begin(), entries.end());
+  streamed->columns.push_back(entries);
+  *pstop = column == streamed->stopColumn;
+  return CMR_OKAY;
+}
+
+TEST(Matrix, StreamSparseColumns)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  char fileName[] = "/tmp/cmr-test-stream-XXXXXX";
+  int fd = mkstemp(fileName);
+  ASSERT_GE(fd, 0);
+  FILE* file = fdopen(fd, "w");
+
+  /* Enough nonzeros for several chunks, with empty columns in between and at the end. */
+  const size_t numRows = 400;
+  const size_t numColumns = 700;
+  size_t numNonzeros = 0;
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    for (size_t row = 0; row < numRows; ++row)
+      numNonzeros += (column % 7 != 3 && column < numColumns - 2 && (row + 3 * column) % 3 == 0) ? 1 : 0;
+  }
+  fprintf(file, "%zu %zu %zu\n", numRows, numColumns, numNonzeros + 1);
+  fprintf(file, "1 1 0\n");
+  for (size_t column = 0; column < numColumns; ++column)
+  {
+    for (size_t r = numRows; r > 0; --r)
+    {
+      size_t row = r - 1;
+      if (column % 7 != 3 && column < numColumns - 2 && (row + 3 * column) % 3 == 0)
+        fprintf(file, "%zu %zu %d\n", row + 1, column + 1, (row + column) % 2 ? 1 : -1);
+    }
+  }
+  fclose(file);
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCreateFromSparseFile(cmr, fileName, NULL, &matrix) );
+  CMR_CHRMAT* transpose = NULL;
+  ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+
+  for (int threads = 1; threads <= 4; threads += 3)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, threads) );
+    StreamedColumns streamed;
+    streamed.stopColumn = SIZE_MAX;
+    ASSERT_CMR_CALL( CMRchrmatStreamSparseColumns(cmr, fileName, NULL, streamHeader, streamColumn, &streamed) );
+    ASSERT_EQ( streamed.numRows, numRows );
+    ASSERT_EQ( streamed.columns.size(), numColumns );
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      ASSERT_EQ( streamed.columns[column].size(), transpose->rowSlice[column + 1] - transpose->rowSlice[column] );
+      for (size_t i = 0; i < streamed.columns[column].size(); ++i)
+      {
+        size_t e = transpose->rowSlice[column] + i;
+        ASSERT_EQ( streamed.columns[column][i].first, transpose->entryColumns[e] );
+        ASSERT_EQ( streamed.columns[column][i].second, transpose->entryValues[e] );
+      }
+    }
+
+    /* Stopping early. */
+    StreamedColumns stopped;
+    stopped.stopColumn = 10;
+    ASSERT_CMR_CALL( CMRchrmatStreamSparseColumns(cmr, fileName, NULL, streamHeader, streamColumn, &stopped) );
+    ASSERT_EQ( stopped.columns.size(), 11UL );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  /* Nonzeros that are not sorted by column, duplicates and trailing tokens are rejected. */
+  const char* invalidInputs[3] = { "2 2 2 1 2 1 2 1 1", "2 2 2 1 1 1 1 1 -1", "2 2 1 1 1 1 2" };
+  for (int i = 0; i < 3; ++i)
+  {
+    file = fopen(fileName, "w");
+    fputs(invalidInputs[i], file);
+    fclose(file);
+    StreamedColumns streamed;
+    streamed.stopColumn = SIZE_MAX;
+    ASSERT_EQ( CMRchrmatStreamSparseColumns(cmr, fileName, NULL, streamHeader, streamColumn, &streamed),
+      CMR_ERROR_INPUT );
+  }
+
+  remove(fileName);
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Overwrites 8 bytes of a file at \p position by \p value in little-endian order.
+ */
+
+static
+void patchLittleEndian(const char* fileName, long position, uint64_t value)
+{
+  FILE* stream = fopen(fileName, "r+b");
+  ASSERT_NE( stream, (FILE*) NULL );
+  ASSERT_EQ( fseek(stream, position, SEEK_SET), 0 );
+  for (int i = 0; i < 8; ++i)
+    fputc((int) ((value >> (8 * i)) & 0xff), stream);
+  fclose(stream);
+}
+
+TEST(Matrix, Binary)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "4 5 "
+    " 1  0  0 -1  1 "
+    " 0  0  0  0  0 "
+    "-1  1  0  0  1 "
+    " 0  1  1  0 -1 "
+  ) );
+
+  char fileName[] = "/tmp/cmr-test-binary-XXXXXX";
+  int fd = mkstemp(fileName);
+  ASSERT_GE(fd, 0);
+  FILE* stream = fdopen(fd, "wb");
+  ASSERT_CMR_CALL( CMRchrmatPrintBinary(cmr, matrix, stream) );
+  fclose(stream);
+
+  /* Matching value type: the file is mapped. */
+  CMR_CHRMAT* mapped = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCreateFromBinaryFile(cmr, fileName, NULL, &mapped) );
+  ASSERT_TRUE( CMRchrmatCheckEqual(matrix, mapped) );
+
+  /* Different value types: the values are converted. */
+  CMR_INTMAT* intMatrix = NULL;
+  ASSERT_CMR_CALL( CMRintmatCreateFromBinaryFile(cmr, fileName, NULL, &intMatrix) );
+  CMR_DBLMAT* dblMatrix = NULL;
+  ASSERT_CMR_CALL( CMRdblmatCreateFromBinaryFile(cmr, fileName, NULL, &dblMatrix) );
+  ASSERT_EQ( intMatrix->numNonzeros, matrix->numNonzeros );
+  ASSERT_EQ( dblMatrix->numNonzeros, matrix->numNonzeros );
+  for (size_t row = 0; row <= matrix->numRows; ++row)
+  {
+    ASSERT_EQ( intMatrix->rowSlice[row], matrix->rowSlice[row] );
+    ASSERT_EQ( dblMatrix->rowSlice[row], matrix->rowSlice[row] );
+  }
+  for (size_t e = 0; e < matrix->numNonzeros; ++e)
+  {
+    ASSERT_EQ( intMatrix->entryColumns[e], matrix->entryColumns[e] );
+    ASSERT_EQ( intMatrix->entryValues[e], matrix->entryValues[e] );
+    ASSERT_EQ( dblMatrix->entryColumns[e], matrix->entryColumns[e] );
+    ASSERT_EQ( dblMatrix->entryValues[e], matrix->entryValues[e] );
+  }
+
+  /* Writing the int matrix must produce a file that is read back as the same char matrix. */
+  stream = fopen(fileName, "wb");
+  ASSERT_CMR_CALL( CMRintmatPrintBinary(cmr, intMatrix, stream) );
+  fclose(stream);
+  stream = fopen(fileName, "rb");
+  CMR_CHRMAT* streamed = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCreateFromBinaryStream(cmr, stream, &streamed) );
+  fclose(stream);
+  ASSERT_TRUE( CMRchrmatCheckEqual(matrix, streamed) );
+
+  /* A truncated file is rejected. */
+  ASSERT_EQ( truncate(fileName, 64 + 5 * 8), 0 );
+  CMR_CHRMAT* truncated = NULL;
+  ASSERT_EQ( CMRchrmatCreateFromBinaryFile(cmr, fileName, NULL, &truncated), CMR_ERROR_INPUT );
+  ASSERT_EQ( truncated, (CMR_CHRMAT*) NULL );
+
+  /* A file with a wrong magic number is rejected. */
+  const char* textInput = "4 5 0 ";
+  stream = fmemopen((char*) textInput, strlen(textInput), "r");
+  ASSERT_EQ( CMRchrmatCreateFromBinaryStream(cmr, stream, &truncated), CMR_ERROR_INPUT );
+  fclose(stream);
+  ASSERT_EQ( truncated, (CMR_CHRMAT*) NULL );
+
+  /* A header whose file size computation overflows is rejected: 64 + 8 * 2^61 + 9 is 65 modulo 2^64. */
+  stream = fopen(fileName, "wb");
+  ASSERT_CMR_CALL( CMRchrmatPrintBinary(cmr, matrix, stream) );
+  fclose(stream);
+  patchLittleEndian(fileName, 16, (UINT64_C(1) << 61) - 2);
+  patchLittleEndian(fileName, 32, 1);
+  ASSERT_EQ( truncate(fileName, 65), 0 );
+  ASSERT_EQ( CMRchrmatCreateFromBinaryFile(cmr, fileName, NULL, &truncated), CMR_ERROR_INPUT );
+  ASSERT_EQ( truncated, (CMR_CHRMAT*) NULL );
+
+  remove(fileName);
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &streamed) );
+  ASSERT_CMR_CALL( CMRdblmatFree(cmr, &dblMatrix) );
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &intMatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &mapped) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, Container)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "3 4 "
+    " 1  0  0 -1 "
+    " 0  0  0  0 "
+    "-1  1  0  1 "
+  ) );
+  CMR_INTMAT* intMatrix = NULL;
+  ASSERT_CMR_CALL( stringToIntMatrix(cmr, &intMatrix, "2 3 "
+    " 5  0 -7 "
+    " 0  2  0 "
+  ) );
+
+  char fileName[] = "/tmp/cmr-test-container-XXXXXX";
+  int fd = mkstemp(fileName);
+  ASSERT_GE(fd, 0);
+  FILE* stream = fdopen(fd, "wb");
+  CMR_MATRIX_CONTAINER_WRITER* writer = NULL;
+  ASSERT_CMR_CALL( CMRmatrixContainerWriterCreate(cmr, stream, &writer) );
+  ASSERT_CMR_CALL( CMRchrmatAddToContainer(cmr, matrix, writer, "first", NULL) );
+  ASSERT_CMR_CALL( CMRintmatAddToContainer(cmr, intMatrix, writer, NULL, "source=test") );
+  ASSERT_CMR_CALL( CMRchrmatAddToContainer(cmr, matrix, writer, "third", "x") );
+  ASSERT_CMR_CALL( CMRmatrixContainerWriterFinish(cmr, &writer) );
+  ASSERT_EQ( writer, (CMR_MATRIX_CONTAINER_WRITER*) NULL );
+  fclose(stream);
+
+  CMR_MATRIX_CONTAINER* container = NULL;
+  ASSERT_CMR_CALL( CMRmatrixContainerOpen(cmr, fileName, NULL, &container) );
+  ASSERT_EQ( CMRmatrixContainerNumRecords(container), 3UL );
+  ASSERT_STREQ( CMRmatrixContainerRecordName(container, 0), "first" );
+  ASSERT_STREQ( CMRmatrixContainerRecordMetadata(container, 0), "" );
+  ASSERT_STREQ( CMRmatrixContainerRecordName(container, 1), "" );
+  ASSERT_STREQ( CMRmatrixContainerRecordMetadata(container, 1), "source=test" );
+  ASSERT_STREQ( CMRmatrixContainerRecordName(container, 2), "third" );
+
+  /* Records are accessed in any order and converted if necessary. */
+  CMR_CHRMAT* third = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCreateFromContainer(cmr, container, 2, &third) );
+  ASSERT_TRUE( CMRchrmatCheckEqual(matrix, third) );
+  CMR_INTMAT* second = NULL;
+  ASSERT_CMR_CALL( CMRintmatCreateFromContainer(cmr, container, 1, &second) );
+  ASSERT_TRUE( CMRintmatCheckEqual(intMatrix, second) );
+  CMR_DBLMAT* first = NULL;
+  ASSERT_CMR_CALL( CMRdblmatCreateFromContainer(cmr, container, 0, &first) );
+  ASSERT_EQ( first->numNonzeros, matrix->numNonzeros );
+  for (size_t e = 0; e < matrix->numNonzeros; ++e)
+    ASSERT_EQ( first->entryValues[e], matrix->entryValues[e] );
+  CMR_CHRMAT* missing = NULL;
+  ASSERT_EQ( CMRchrmatCreateFromContainer(cmr, container, 3, &missing), CMR_ERROR_INPUT );
+  ASSERT_CMR_CALL( CMRmatrixContainerFree(cmr, &container) );
+
+  /* The matrices remain valid after closing the container. */
+  ASSERT_TRUE( CMRchrmatCheckEqual(matrix, third) );
+
+  /* A record header whose size computation overflows to the record's size of 64 + 8 * 4 + 9 * 5 bytes is rejected. */
+  patchLittleEndian(fileName, 64 + 16, (UINT64_C(1) << 61) - 6);
+  patchLittleEndian(fileName, 64 + 32, 13);
+  ASSERT_EQ( CMRmatrixContainerOpen(cmr, fileName, NULL, &container), CMR_ERROR_INPUT );
+  ASSERT_EQ( container, (CMR_MATRIX_CONTAINER*) NULL );
+
+  /* A truncated file is rejected. */
+  ASSERT_EQ( truncate(fileName, 200), 0 );
+  ASSERT_EQ( CMRmatrixContainerOpen(cmr, fileName, NULL, &container), CMR_ERROR_INPUT );
+  ASSERT_EQ( container, (CMR_MATRIX_CONTAINER*) NULL );
+
+  remove(fileName);
+
+  ASSERT_CMR_CALL( CMRdblmatFree(cmr, &first) );
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &second) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &third) );
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &intMatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
 TEST(Matrix, Transpose)
 {
   CMR* cmr = NULL;
@@ -258,6 +666,497 @@ TEST(Matrix, Transpose)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+TEST(Matrix, Compact)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* A = NULL;
+  stringToCharMatrix(cmr, &A, "4 5 "
+    "1 2 3 0 0 "
+    "0 4 5 0 6 "
+    "7 0 0 8 0 "
+    "0 0 9 0 0 "
+  );
+
+  CMR_CHRMAT32* compact = NULL;
+  ASSERT_CMR_CALL( CMRchrmatToCompact(cmr, A, &compact) );
+  ASSERT_TRUE( CMRchrmat32CheckEqual(compact, A) );
+
+  CMR_CHRMAT* B = NULL;
+  ASSERT_CMR_CALL( CMRchrmat32ToChrmat(cmr, compact, &B) );
+  ASSERT_TRUE( CMRchrmatCheckEqual(A, B) );
+  CMRchrmatFree(cmr, &B);
+
+  CMR_CHRMAT32* compactTranspose = NULL;
+  ASSERT_CMR_CALL( CMRchrmat32Transpose(cmr, compact, &compactTranspose) );
+  CMR_CHRMAT* AT = NULL;
+  ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, A, &AT) );
+  ASSERT_TRUE( CMRchrmat32CheckEqual(compactTranspose, AT) );
+  CMRchrmatFree(cmr, &AT);
+  CMRchrmat32Free(cmr, &compactTranspose);
+  CMRchrmat32Free(cmr, &compact);
+
+  ASSERT_TRUE( CMRchrmat32Fits(UINT32_MAX, UINT32_MAX, 0) );
+  ASSERT_FALSE( CMRchrmat32Fits((size_t) UINT32_MAX + 1, 1, 0) );
+  ASSERT_FALSE( CMRchrmat32Fits(1, 1, UINT32_MAX) );
+  ASSERT_EQ( CMRchrmat32Create(cmr, &compact, (size_t) UINT32_MAX + 1, 1, 0), CMR_ERROR_INPUT );
+
+  CMRchrmatFree(cmr, &A);
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, CreateFromBuffers)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* A = NULL;
+  stringToCharMatrix(cmr, &A, "3 4 "
+    "1 0 -1 0 "
+    "0 2 0 0 "
+    "3 0 0 -4 "
+  );
+
+  {
+    /* Sorted CSR with 64-bit indices and char values is borrowed. */
+    int64_t slice[] = { 0, 2, 3, 5 };
+    int64_t indices[] = { 0, 2, 1, 0, 3 };
+    char values[] = { 1, -1, 2, 3, -4 };
+    CMR_SPARSE_BUFFERS buffers = { 3, 4, false, true, true, slice, indices, CMR_BUFFER_VALUES_CHAR, values };
+    CMR_CHRMAT* B = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL) );
+    ASSERT_EQ( (void*) B->rowSlice, (void*) slice );
+    ASSERT_EQ( (void*) B->entryColumns, (void*) indices );
+    ASSERT_TRUE( CMRchrmatCheckEqual(A, B) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &B) );
+
+    /* An explicit zero prevents borrowing. */
+    values[1] = 0;
+    ASSERT_CMR_CALL( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL) );
+    ASSERT_NE( (void*) B->rowSlice, (void*) slice );
+    ASSERT_EQ( B->numNonzeros, 4UL );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &B) );
+  }
+
+  {
+    /* Unsorted CSR with 32-bit indices, int values and explicit zeros. */
+    int32_t slice[] = { 0, 3, 4, 7 };
+    int32_t indices[] = { 2, 0, 1, 1, 3, 0, 2 };
+    int values[] = { -1, 1, 0, 2, -4, 3, 0 };
+    CMR_SPARSE_BUFFERS buffers = { 3, 4, false, false, false, slice, indices, CMR_BUFFER_VALUES_INT, values };
+    CMR_CHRMAT* B = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL) );
+    ASSERT_TRUE( CMRchrmatCheckEqual(A, B) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &B) );
+
+    /* Duplicates, values that are no chars and indices out of range are rejected. */
+    indices[0] = 0;
+    ASSERT_EQ( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL), CMR_ERROR_INPUT );
+    ASSERT_EQ( B, (CMR_CHRMAT*) NULL );
+    indices[0] = 2;
+    values[0] = 300;
+    ASSERT_EQ( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL), CMR_ERROR_INPUT );
+    values[0] = -1;
+    indices[0] = 4;
+    ASSERT_EQ( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL), CMR_ERROR_INPUT );
+  }
+
+  {
+    /* Unsorted CSC with 32-bit indices and double values. */
+    int32_t slice[] = { 0, 2, 3, 4, 5 };
+    int32_t indices[] = { 2, 0, 1, 0, 2 };
+    double values[] = { 3.0, 1.0, 2.0, -1.0, -4.0 };
+    CMR_SPARSE_BUFFERS buffers = { 3, 4, true, false, false, slice, indices, CMR_BUFFER_VALUES_DOUBLE, values };
+    CMR_CHRMAT* B = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL) );
+    ASSERT_TRUE( CMRchrmatCheckEqual(A, B) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &B) );
+
+    bool transposed = false;
+    ASSERT_CMR_CALL( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, &transposed) );
+    ASSERT_TRUE( transposed );
+    bool isTranspose = false;
+    ASSERT_CMR_CALL( CMRchrmatCheckTranspose(cmr, A, B, &isTranspose) );
+    ASSERT_TRUE( isTranspose );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &B) );
+
+    values[0] = 0.5;
+    ASSERT_EQ( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL), CMR_ERROR_INPUT );
+  }
+
+  {
+    /* Sorted CSC with 64-bit indices and char values is borrowed as the transpose. */
+    int64_t slice[] = { 0, 2, 3, 4, 5 };
+    int64_t indices[] = { 0, 2, 1, 0, 2 };
+    char values[] = { 1, 3, 2, -1, -4 };
+    CMR_SPARSE_BUFFERS buffers = { 3, 4, true, true, true, slice, indices, CMR_BUFFER_VALUES_CHAR, values };
+    CMR_CHRMAT* B = NULL;
+    bool transposed = false;
+    ASSERT_CMR_CALL( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, &transposed) );
+    ASSERT_TRUE( transposed );
+    ASSERT_EQ( (void*) B->rowSlice, (void*) slice );
+    bool isTranspose = false;
+    ASSERT_CMR_CALL( CMRchrmatCheckTranspose(cmr, A, B, &isTranspose) );
+    ASSERT_TRUE( isTranspose );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &B) );
+
+    /* Without allowing the transpose, the buffers become the cached transpose. */
+    ASSERT_CMR_CALL( CMRchrmatCreateFromBuffers(cmr, &buffers, &B, NULL) );
+    ASSERT_TRUE( CMRchrmatCheckEqual(A, B) );
+    CMR_CHRMAT* transpose = NULL;
+    ASSERT_CMR_CALL( CMRchrmatGetTranspose(cmr, B, &transpose) );
+    ASSERT_EQ( (void*) transpose->rowSlice, (void*) slice );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &B) );
+  }
+
+  CMRchrmatFree(cmr, &A);
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, View)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* A = NULL;
+  stringToCharMatrix(cmr, &A, "4 5 "
+    "1 2 3 0 0 "
+    "0 4 5 0 6 "
+    "7 0 0 8 0 "
+    "0 0 9 0 0 "
+  );
+
+  /* A view of the whole matrix. */
+  CMR_CHRMAT_VIEW* view = NULL;
+  ASSERT_CMR_CALL( CMRchrmatViewCreate(cmr, A, NULL, &view) );
+  ASSERT_EQ( CMRchrmatViewNumNonzeros(view), A->numNonzeros );
+  CMR_CHRMAT* B = NULL;
+  ASSERT_CMR_CALL( CMRchrmatViewMaterialize(cmr, view, &B) );
+  ASSERT_TRUE( CMRchrmatCheckEqual(A, B) );
+  CMRchrmatFree(cmr, &B);
+
+  /* Hide a row and a column. */
+  ASSERT_CMR_CALL( CMRchrmatViewSetRowHidden(cmr, view, 1, true) );
+  CMRchrmatViewSetColumnHidden(view, 2, true);
+  ASSERT_TRUE( CMRchrmatViewIsRowHidden(view, 1) );
+  ASSERT_TRUE( CMRchrmatViewIsColumnHidden(view, 2) );
+  ASSERT_EQ( CMRchrmatViewNumNonzeros(view), 4UL );
+  ASSERT_CMR_CALL( CMRchrmatViewMaterialize(cmr, view, &B) );
+  CMR_CHRMAT* expected = NULL;
+  stringToCharMatrix(cmr, &expected, "4 5 "
+    "1 2 0 0 0 "
+    "0 0 0 0 0 "
+    "7 0 0 8 0 "
+    "0 0 0 0 0 "
+  );
+  ASSERT_TRUE( CMRchrmatCheckEqual(B, expected) );
+  CMRchrmatFree(cmr, &expected);
+  CMRchrmatFree(cmr, &B);
+
+  /* Restricting must agree with zooming into the visible submatrix. */
+  CMR_SUBMAT* submatrix = NULL;
+  ASSERT_CMR_CALL( CMRsubmatCreate(cmr, 3, 3, &submatrix) );
+  submatrix->rows[0] = 3;
+  submatrix->rows[1] = 1;
+  submatrix->rows[2] = 0;
+  submatrix->columns[0] = 0;
+  submatrix->columns[1] = 2;
+  submatrix->columns[2] = 4;
+  CMR_CHRMAT_VIEW* restricted = NULL;
+  ASSERT_CMR_CALL( CMRchrmatViewRestrict(cmr, view, submatrix, &restricted) );
+  ASSERT_TRUE( CMRchrmatViewIsRowHidden(restricted, 1) );
+  ASSERT_TRUE( CMRchrmatViewIsColumnHidden(restricted, 1) );
+  ASSERT_CMR_CALL( CMRchrmatViewMaterialize(cmr, restricted, &B) );
+  stringToCharMatrix(cmr, &expected, "3 3 "
+    "0 0 0 "
+    "0 0 0 "
+    "1 0 0 "
+  );
+  ASSERT_TRUE( CMRchrmatCheckEqual(B, expected) );
+  CMRchrmatFree(cmr, &expected);
+  CMRchrmatFree(cmr, &B);
+  CMRsubmatFree(cmr, &submatrix);
+
+  ASSERT_CMR_CALL( CMRchrmatViewToSubmat(cmr, restricted, &submatrix) );
+  ASSERT_EQ( submatrix->numRows, 2UL );
+  ASSERT_EQ( submatrix->rows[0], 3UL );
+  ASSERT_EQ( submatrix->rows[1], 0UL );
+  ASSERT_EQ( submatrix->numColumns, 2UL );
+  ASSERT_EQ( submatrix->columns[0], 0UL );
+  ASSERT_EQ( submatrix->columns[1], 4UL );
+  CMRsubmatFree(cmr, &submatrix);
+
+  /* Showing hidden rows and columns again. */
+  ASSERT_CMR_CALL( CMRchrmatViewSetRowHidden(cmr, view, 1, false) );
+  CMRchrmatViewSetColumnHidden(view, 2, false);
+  ASSERT_EQ( CMRchrmatViewNumNonzeros(view), A->numNonzeros );
+
+  CMRchrmatViewFree(cmr, &restricted);
+  CMRchrmatViewFree(cmr, &view);
+  CMRchrmatFree(cmr, &A);
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, CachedTranspose)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* A = NULL;
+  stringToCharMatrix(cmr, &A, "3 4 "
+    "1 1 0 0 "
+    "0 1 1 0 "
+    "1 0 0 1 "
+  );
+
+  CMR_CHRMAT* transpose = NULL;
+  ASSERT_CMR_CALL( CMRchrmatGetTranspose(cmr, A, &transpose) );
+  bool isTranspose;
+  ASSERT_CMR_CALL( CMRchrmatCheckTranspose(cmr, A, transpose, &isTranspose) );
+  ASSERT_TRUE( isTranspose );
+
+  /* A second request yields the same transpose. */
+  CMR_CHRMAT* transpose2 = NULL;
+  ASSERT_CMR_CALL( CMRchrmatGetTranspose(cmr, A, &transpose2) );
+  ASSERT_EQ( transpose, transpose2 );
+
+  /* After modifying A and invalidating it, the transpose is recomputed. */
+  A->entryValues[0] = -1;
+  ASSERT_CMR_CALL( CMRchrmatInvalidateTranspose(cmr, A) );
+  transpose = NULL;
+  ASSERT_CMR_CALL( CMRchrmatGetTranspose(cmr, A, &transpose) );
+  ASSERT_CMR_CALL( CMRchrmatCheckTranspose(cmr, A, transpose, &isTranspose) );
+  ASSERT_TRUE( isTranspose );
+
+  /* Changing the number of nonzeros invalidates as well. */
+  ASSERT_CMR_CALL( CMRchrmatChangeNumNonzeros(cmr, A, A->numNonzeros - 1) );
+  A->rowSlice[A->numRows] = A->numNonzeros;
+  ASSERT_CMR_CALL( CMRchrmatGetTranspose(cmr, A, &transpose) );
+  ASSERT_EQ( transpose->numNonzeros, A->numNonzeros );
+  ASSERT_CMR_CALL( CMRchrmatCheckTranspose(cmr, A, transpose, &isTranspose) );
+  ASSERT_TRUE( isTranspose );
+
+  /* Freeing A frees its transpose. */
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &A) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, EntryIndex)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  srand(42);
+  /* Narrow matrices use bitmaps and wide sparse ones use the hashtable. */
+  const size_t sizes[4][3] = { {30, 70, 2}, {5, 200, 3}, {200, 5000, 1000}, {1, 1, 1} };
+  for (int s = 0; s < 4; ++s)
+  {
+    size_t numRows = sizes[s][0];
+    size_t numColumns = sizes[s][1];
+    size_t density = sizes[s][2];
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    size_t entry = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = entry;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        if (rand() % density == 0)
+        {
+          matrix->entryColumns[entry] = column;
+          matrix->entryValues[entry] = (rand() % 2) ? 1 : -1;
+          ++entry;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = entry;
+    matrix->numNonzeros = entry;
+
+    CMR_ENTRY_INDEX index;
+    ASSERT_CMR_CALL( CMRentryIndexCreate(cmr, matrix, &index) );
+    if (s == 2)
+      ASSERT_EQ( index.numWords, 0UL );
+    else
+      ASSERT_GT( index.numWords, 0UL );
+
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        size_t expected;
+        ASSERT_CMR_CALL( CMRchrmatFindEntry(matrix, row, column, &expected) );
+        ASSERT_EQ( CMRentryIndexFind(&index, row, column), expected );
+      }
+    }
+
+    ASSERT_CMR_CALL( CMRentryIndexFree(cmr, &index) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, Intersect)
+{
+  srand(42);
+  /* Similar lengths use the merge and very different lengths use galloping. */
+  const size_t lengths[6][2] = { {0, 5}, {7, 9}, {40, 50}, {3, 200}, {300, 2}, {1000, 1000} };
+  for (int l = 0; l < 6; ++l)
+  {
+    std::vector<size_t> arrays[2];
+    for (int a = 0; a < 2; ++a)
+    {
+      size_t element = 0;
+      for (size_t i = 0; i < lengths[l][a]; ++i)
+      {
+        element += 1 + rand() % 3;
+        arrays[a].push_back(element);
+      }
+    }
+
+    std::vector<size_t> expectedFirst;
+    std::vector<size_t> expectedSecond;
+    for (size_t i = 0; i < arrays[0].size(); ++i)
+    {
+      for (size_t j = 0; j < arrays[1].size(); ++j)
+      {
+        if (arrays[0][i] == arrays[1][j])
+        {
+          expectedFirst.push_back(i);
+          expectedSecond.push_back(j);
+        }
+      }
+    }
+
+    ASSERT_EQ( CMRintersectCount(arrays[0].data(), arrays[0].size(), arrays[1].data(), arrays[1].size()),
+      expectedFirst.size() );
+
+    size_t firstPosition, secondPosition;
+    ASSERT_EQ( CMRintersectFirst(arrays[0].data(), arrays[0].size(), arrays[1].data(), arrays[1].size(),
+      &firstPosition, &secondPosition), !expectedFirst.empty() );
+    if (!expectedFirst.empty())
+    {
+      ASSERT_EQ( firstPosition, expectedFirst[0] );
+      ASSERT_EQ( secondPosition, expectedSecond[0] );
+    }
+
+    std::vector<size_t> firstPositions(std::min(arrays[0].size(), arrays[1].size()));
+    std::vector<size_t> secondPositions(firstPositions.size());
+    size_t numCommon = CMRintersectEmit(arrays[0].data(), arrays[0].size(), arrays[1].data(), arrays[1].size(),
+      firstPositions.data(), secondPositions.data());
+    ASSERT_EQ( numCommon, expectedFirst.size() );
+    for (size_t i = 0; i < numCommon; ++i)
+    {
+      ASSERT_EQ( firstPositions[i], expectedFirst[i] );
+      ASSERT_EQ( secondPositions[i], expectedSecond[i] );
+    }
+  }
+}
+
+TEST(Matrix, TransposeParallel)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* A matrix that is large enough to be transposed in parallel. */
+  const size_t numRows = 1100;
+  const size_t numColumns = 1000;
+  CMR_INTMAT* A = NULL;
+  ASSERT_CMR_CALL( CMRintmatCreate(cmr, &A, numRows, numColumns, numRows * numColumns) );
+  size_t entry = 0;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    A->rowSlice[row] = entry;
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      if ((row * 7 + column * 3) % 11 == 0)
+        continue;
+      A->entryColumns[entry] = column;
+      A->entryValues[entry] = (int) (row + column) % 5 + 1;
+      ++entry;
+    }
+  }
+  A->rowSlice[numRows] = entry;
+  ASSERT_CMR_CALL( CMRintmatChangeNumNonzeros(cmr, A, entry) );
+
+  for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+    CMR_INTMAT* B = NULL;
+    ASSERT_CMR_CALL( CMRintmatTranspose(cmr, A, &B) );
+    bool transposes;
+    ASSERT_CMR_CALL( CMRintmatCheckTranspose(cmr, A, B, &transposes) );
+    ASSERT_TRUE( transposes );
+    ASSERT_EQ( CMRintmatConsistency(B), (char*) NULL );
+    CMRintmatFree(cmr, &B);
+  }
+
+  CMRintmatFree(cmr, &A);
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, SortNonzeros)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Row 0 is short, and row 1 is short in the first and long in the second round such that both methods are used. */
+  for (size_t longLength = 3; longLength <= 40; longLength += 37)
+  {
+    size_t numNonzeros = 3 + longLength;
+    size_t columns[43] = { 7, 2, 5 };
+    for (size_t i = 0; i < longLength; ++i)
+      columns[3 + i] = (i * 17) % 41;
+
+    CMR_DBLMAT* dbl = NULL;
+    CMR_INTMAT* in = NULL;
+    CMR_CHRMAT* chr = NULL;
+    ASSERT_CMR_CALL( CMRdblmatCreate(cmr, &dbl, 2, 50, numNonzeros) );
+    ASSERT_CMR_CALL( CMRintmatCreate(cmr, &in, 2, 50, numNonzeros) );
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &chr, 2, 50, numNonzeros) );
+    dbl->rowSlice[0] = in->rowSlice[0] = chr->rowSlice[0] = 0;
+    dbl->rowSlice[1] = in->rowSlice[1] = chr->rowSlice[1] = 3;
+    dbl->rowSlice[2] = in->rowSlice[2] = chr->rowSlice[2] = numNonzeros;
+    for (size_t e = 0; e < numNonzeros; ++e)
+    {
+      dbl->entryColumns[e] = in->entryColumns[e] = chr->entryColumns[e] = columns[e];
+      dbl->entryValues[e] = columns[e] + 0.5;
+      in->entryValues[e] = (int) columns[e] + 1000;
+      chr->entryValues[e] = (char) (columns[e] + 1);
+    }
+
+    ASSERT_CMR_CALL( CMRdblmatSortNonzeros(cmr, dbl) );
+    ASSERT_CMR_CALL( CMRintmatSortNonzeros(cmr, in) );
+    ASSERT_CMR_CALL( CMRchrmatSortNonzeros(cmr, chr) );
+
+    for (size_t row = 0; row < 2; ++row)
+    {
+      ASSERT_EQ( dbl->rowSlice[row + 1], row == 0 ? 3 : numNonzeros );
+      for (size_t e = dbl->rowSlice[row]; e < dbl->rowSlice[row + 1]; ++e)
+      {
+        if (e > dbl->rowSlice[row])
+        {
+          ASSERT_LT( dbl->entryColumns[e - 1], dbl->entryColumns[e] );
+        }
+        ASSERT_EQ( dbl->entryValues[e], dbl->entryColumns[e] + 0.5 );
+        ASSERT_EQ( in->entryColumns[e], dbl->entryColumns[e] );
+        ASSERT_EQ( in->entryValues[e], (int) in->entryColumns[e] + 1000 );
+        ASSERT_EQ( chr->entryColumns[e], dbl->entryColumns[e] );
+        ASSERT_EQ( chr->entryValues[e], (char) (chr->entryColumns[e] + 1) );
+      }
+    }
+
+    CMRchrmatFree(cmr, &chr);
+    CMRintmatFree(cmr, &in);
+    CMRdblmatFree(cmr, &dbl);
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
 TEST(Matrix, Submatrix)
 {
   CMR* cmr = NULL;
@@ -307,3 +1206,378 @@ TEST(Matrix, Submatrix)
 
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+TEST(Matrix, ListMatrixCompact)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  stringToCharMatrix(cmr, &matrix, "3 4 "
+    "1  0 -1  1 "
+    "0  1  1  0 "
+    "1 -1  0  0 "
+  );
+
+  /* No memory for additional nonzeros, i.e., the insertion below reallocates the node arrays. */
+  ListMat8Compact* listmatrix = NULL;
+  ASSERT_CMR_CALL( CMRlistmat8CompactAlloc(cmr, 3, 4, matrix->numNonzeros, &listmatrix) );
+  ASSERT_CMR_CALL( CMRlistmat8CompactInitializeFromChrMatrix(cmr, listmatrix, matrix) );
+  ASSERT_EQ( listmatrix->numNonzeros, 7UL );
+  ASSERT_EQ( listmatrix->rowNumNonzeros[0], 3UL );
+  ASSERT_EQ( listmatrix->columnNumNonzeros[1], 2UL );
+
+  /* Row 0 contains columns 0, 2 and 3 in this order. */
+  ListMat8Index head = CMRlistmat8CompactRowHead(listmatrix, 0);
+  ListMat8Index nz = listmatrix->right[head];
+  ASSERT_EQ( listmatrix->column[nz], 0U );
+  ListMat8Index middle = listmatrix->right[nz];
+  ASSERT_EQ( listmatrix->column[middle], 2U );
+  ASSERT_EQ( listmatrix->value[middle], -1 );
+  ASSERT_EQ( listmatrix->column[listmatrix->right[middle]], 3U );
+  ASSERT_EQ( listmatrix->right[listmatrix->right[middle]], head );
+  ASSERT_EQ( listmatrix->column[head], LISTMAT8_NONE );
+
+  /* After deleting (0,2), the traversal of row 0 continues at column 3, and column 2 only contains row 1. */
+  ASSERT_CMR_CALL( CMRlistmat8CompactDelete(cmr, listmatrix, middle) );
+  ListMat8Index last = listmatrix->right[middle];
+  ASSERT_EQ( listmatrix->column[last], 3U );
+  ASSERT_EQ( listmatrix->right[nz], last );
+  ASSERT_EQ( listmatrix->rowNumNonzeros[0], 2UL );
+  ASSERT_EQ( listmatrix->columnNumNonzeros[2], 1UL );
+  ListMat8Index columnHead = CMRlistmat8CompactColumnHead(listmatrix, 2);
+  ASSERT_EQ( listmatrix->row[listmatrix->below[columnHead]], 1U );
+  ASSERT_EQ( listmatrix->below[listmatrix->below[columnHead]], columnHead );
+
+  /* The deleted node is reused. */
+  ListMat8Index inserted;
+  ASSERT_CMR_CALL( CMRlistmat8CompactInsert(cmr, listmatrix, 2, 2, 1, 0, &inserted) );
+  ASSERT_EQ( inserted, middle );
+
+  /* The next insertion enlarges the node arrays, but the indices of the nodes remain valid. */
+  ASSERT_CMR_CALL( CMRlistmat8CompactInsert(cmr, listmatrix, 1, 3, -1, 1, &inserted) );
+  ASSERT_EQ( listmatrix->numNonzeros, 8UL );
+  ASSERT_EQ( listmatrix->value[inserted], -1 );
+  ASSERT_EQ( listmatrix->special[inserted], 1 );
+  ASSERT_EQ( listmatrix->right[CMRlistmat8CompactRowHead(listmatrix, 1)], inserted );
+  ASSERT_EQ( listmatrix->below[CMRlistmat8CompactColumnHead(listmatrix, 3)], inserted );
+  ASSERT_EQ( listmatrix->below[inserted], last );
+  ASSERT_EQ( listmatrix->columnNumNonzeros[3], 2UL );
+  ASSERT_EQ( listmatrix->right[nz], last );
+
+  ASSERT_CMR_CALL( CMRlistmat8CompactFree(cmr, &listmatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, FindTernarySubmatrix)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_DBLMAT* matrix = NULL;
+  stringToDoubleMatrix(cmr, &matrix, "4 3 "
+    "-1  2  0 "
+    " 0  2  1.0000001 "
+    " 1  2  1 "
+    " 0  1  7 "
+  );
+
+  CMR_SUBMAT* submatrix = NULL;
+  ASSERT_FALSE( CMRdblmatIsBinary(cmr, matrix, 1.0e-3, &submatrix) );
+  ASSERT_EQ( submatrix->rows[0], 0UL );
+  ASSERT_EQ( submatrix->columns[0], 0UL );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+
+  ASSERT_FALSE( CMRdblmatIsTernary(cmr, matrix, 1.0e-3, &submatrix) );
+  ASSERT_EQ( submatrix->rows[0], 0UL );
+  ASSERT_EQ( submatrix->columns[0], 1UL );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+
+  /* Column 1 has the most bad entries, then rows 0 and 3 are removed. */
+  ASSERT_CMR_CALL( CMRdblmatFindBinarySubmatrix(cmr, matrix, 1.0e-3, &submatrix) );
+  ASSERT_EQ( submatrix->numRows, 2UL );
+  ASSERT_EQ( submatrix->rows[0], 1UL );
+  ASSERT_EQ( submatrix->rows[1], 2UL );
+  ASSERT_EQ( submatrix->numColumns, 2UL );
+  ASSERT_EQ( submatrix->columns[0], 0UL );
+  ASSERT_EQ( submatrix->columns[1], 2UL );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+
+  ASSERT_CMR_CALL( CMRdblmatFindTernarySubmatrix(cmr, matrix, 1.0e-3, &submatrix) );
+  ASSERT_EQ( submatrix->numRows, 3UL );
+  ASSERT_EQ( submatrix->rows[0], 0UL );
+  ASSERT_EQ( submatrix->rows[1], 1UL );
+  ASSERT_EQ( submatrix->rows[2], 2UL );
+  ASSERT_EQ( submatrix->numColumns, 2UL );
+  ASSERT_EQ( submatrix->columns[0], 0UL );
+  ASSERT_EQ( submatrix->columns[1], 2UL );
+  CMR_DBLMAT* good = NULL;
+  ASSERT_CMR_CALL( CMRdblmatZoomSubmat(cmr, matrix, submatrix, &good) );
+  ASSERT_TRUE( CMRdblmatIsTernary(cmr, good, 1.0e-3, NULL) );
+  ASSERT_CMR_CALL( CMRdblmatFree(cmr, &good) );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+
+  ASSERT_CMR_CALL( CMRdblmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Matrix, PrintRoundTrip)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_DBLMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRdblmatCreate(cmr, &matrix, 2, 3, 5) );
+  const double values[] = { 0.1, 1.0 / 3.0, 1.0e300, -1000000.0, -2.5e-310 };
+  const size_t columns[] = { 0, 2, 0, 1, 2 };
+  matrix->rowSlice[0] = 0;
+  matrix->rowSlice[1] = 2;
+  matrix->rowSlice[2] = 5;
+  for (size_t e = 0; e < 5; ++e)
+  {
+    matrix->entryColumns[e] = columns[e];
+    matrix->entryValues[e] = values[e];
+  }
+
+  char* buffer = NULL;
+  size_t bufferSize = 0;
+  FILE* stream = open_memstream(&buffer, &bufferSize);
+  ASSERT_CMR_CALL( CMRdblmatPrintSparse(cmr, matrix, stream) );
+  fclose(stream);
+  ASSERT_EQ( std::string(buffer, bufferSize).substr(0, 21), std::string("2 3 5\n\n1 1 0.1\n1 3 0.") );
+  ASSERT_NE( std::string(buffer, bufferSize).find("2 2 -1000000\n"), std::string::npos );
+
+  stream = fmemopen(buffer, bufferSize, "r");
+  CMR_DBLMAT* sparse = NULL;
+  ASSERT_CMR_CALL( CMRdblmatCreateFromSparseStream(cmr, stream, &sparse) );
+  fclose(stream);
+  free(buffer);
+  ASSERT_EQ( sparse->numNonzeros, 5UL );
+  for (size_t e = 0; e < 5; ++e)
+    ASSERT_EQ( sparse->entryValues[e], values[e] );
+
+  stream = open_memstream(&buffer, &bufferSize);
+  ASSERT_CMR_CALL( CMRdblmatPrintDense(cmr, matrix, stream, '0', false) );
+  fclose(stream);
+  stream = fmemopen(buffer, bufferSize, "r");
+  CMR_DBLMAT* dense = NULL;
+  ASSERT_CMR_CALL( CMRdblmatCreateFromDenseStream(cmr, stream, &dense) );
+  fclose(stream);
+  free(buffer);
+  ASSERT_TRUE( CMRdblmatCheckEqual(sparse, dense) );
+
+  CMR_CHRMAT* chrMatrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &chrMatrix, "2 3 "
+    " 1  0 -1 "
+    " 0 12  0 "
+  ) );
+  stream = open_memstream(&buffer, &bufferSize);
+  ASSERT_CMR_CALL( CMRchrmatPrintDense(cmr, chrMatrix, stream, '0', false) );
+  ASSERT_CMR_CALL( CMRchrmatPrintSparse(cmr, chrMatrix, stream) );
+  fclose(stream);
+  ASSERT_EQ( std::string(buffer, bufferSize), std::string("2 3\n1 0 -1 \n0 12 0 \n2 3 3\n\n1 1 1\n1 3 -1\n2 2 12\n") );
+  free(buffer);
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &chrMatrix) );
+  ASSERT_CMR_CALL( CMRdblmatFree(cmr, &dense) );
+  ASSERT_CMR_CALL( CMRdblmatFree(cmr, &sparse) );
+  ASSERT_CMR_CALL( CMRdblmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+#if defined(CMR_WITH_ZLIB)
+
+TEST(Matrix, ReadCompressed)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* A sparse 300x300 matrix, written in two gzip members. */
+  std::string text = "300 300 600\n";
+  for (size_t row = 1; row <= 300; ++row)
+    text += std::to_string(row) + " " + std::to_string(row) + " 1 " + std::to_string(row) + " "
+      + std::to_string(301 - row) + " -1\n";
+
+  char fileName[] = "/tmp/cmr-test-gzip-XXXXXX";
+  int fd = mkstemp(fileName);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  size_t half = text.size() / 2;
+  gzFile gzip = gzopen(fileName, "wb");
+  ASSERT_EQ( gzwrite(gzip, text.data(), (unsigned) half), (int) half );
+  gzclose(gzip);
+  gzip = gzopen(fileName, "ab");
+  ASSERT_EQ( gzwrite(gzip, text.data() + half, (unsigned) (text.size() - half)), (int) (text.size() - half) );
+  gzclose(gzip);
+
+  FILE* stream = fmemopen((void*) text.data(), text.size(), "r");
+  CMR_INTMAT* expected = NULL;
+  ASSERT_CMR_CALL( CMRintmatCreateFromSparseStream(cmr, stream, &expected) );
+  fclose(stream);
+
+  for (int numThreads = 1; numThreads <= 2; ++numThreads)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+    CMR_INTMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRintmatCreateFromSparseFile(cmr, fileName, NULL, &matrix) );
+    ASSERT_TRUE( CMRintmatCheckEqual(matrix, expected) );
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+
+    stream = fopen(fileName, "r");
+    ASSERT_CMR_CALL( CMRintmatCreateFromSparseStream(cmr, stream, &matrix) );
+    fclose(stream);
+    ASSERT_TRUE( CMRintmatCheckEqual(matrix, expected) );
+    ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  }
+
+  /* A truncated file is rejected. */
+  stream = fopen(fileName, "r");
+  fseek(stream, 0, SEEK_END);
+  long size = ftell(stream);
+  fclose(stream);
+  ASSERT_EQ( truncate(fileName, size - 16), 0 );
+  CMR_INTMAT* truncated = NULL;
+  ASSERT_EQ( CMRintmatCreateFromSparseFile(cmr, fileName, NULL, &truncated), CMR_ERROR_INPUT );
+  ASSERT_EQ( truncated, (CMR_INTMAT*) NULL );
+
+  remove(fileName);
+
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &expected) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+#endif /* CMR_WITH_ZLIB */
+
+static
+void writeTestFile(
+  char* fileName,
+  const char* text
+)
+{
+  int fd = mkstemp(fileName);
+  ASSERT_GE(fd, 0);
+  FILE* stream = fdopen(fd, "w");
+  fputs(text, stream);
+  fclose(stream);
+}
+
+TEST(Matrix, ReadModel)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  char mpsFileName[] = "/tmp/cmr-test-mps-XXXXXX";
+  writeTestFile(mpsFileName,
+    "NAME          TEST\n"
+    "ROWS\n"
+    " N  COST\n"
+    " L  LIM1\n"
+    " G  LIM2\n"
+    " E  MYEQN\n"
+    "COLUMNS\n"
+    "    MARKER    'MARKER'     'INTORG'\n"
+    "    X         COST         1   LIM1         1\n"
+    "    X         LIM2         1\n"
+    "    MARKER    'MARKER'     'INTEND'\n"
+    "    Y         COST         2   LIM1         1\n"
+    "    Y         MYEQN       -1\n"
+    "    Z         COST        -1   MYEQN        3\n"
+    "RHS\n"
+    "    RHS       LIM1         4   LIM2         1\n"
+    "BOUNDS\n"
+    " UI BND       Z            1\n"
+    "ENDATA\n");
+
+  char lpFileName[] = "/tmp/cmr-test-lp-XXXXXX";
+  writeTestFile(lpFileName,
+    "\\ Same constraint matrix as the MPS file.\n"
+    "Minimize\n"
+    " obj: x + 2 y - z\n"
+    "Subject To\n"
+    " lim1: x + y <= 4\n"
+    " lim2: x >= 1\n"
+    " myeqn: - y + 2 z + z = 0\n"
+    "Bounds\n"
+    " z <= 1\n"
+    "Generals\n"
+    " x z\n"
+    "End\n");
+
+  CMR_MODEL_PARAMS params;
+  ASSERT_CMR_CALL( CMRmodelParamsInit(&params) );
+
+  CMR_INTMAT* expected = NULL;
+  ASSERT_CMR_CALL( stringToIntMatrix(cmr, &expected, "3 3 "
+    "1 1 0 "
+    "1 0 0 "
+    "0 -1 3 "
+  ) );
+
+  params.format = CMR_MODEL_FORMAT_MPS;
+  CMR_INTMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRintmatCreateFromModelFile(cmr, mpsFileName, NULL, &params, &matrix) );
+  ASSERT_TRUE( CMRintmatCheckEqual(matrix, expected) );
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+
+  params.format = CMR_MODEL_FORMAT_LP;
+  ASSERT_CMR_CALL( CMRintmatCreateFromModelFile(cmr, lpFileName, NULL, &params, &matrix) );
+  ASSERT_TRUE( CMRintmatCheckEqual(matrix, expected) );
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &expected) );
+
+  /* Inequalities and integer columns only. */
+  ASSERT_CMR_CALL( stringToIntMatrix(cmr, &expected, "2 2 "
+    "1 0 "
+    "1 0 "
+  ) );
+  params.rows = CMR_MODEL_ROWS_INEQUALITIES;
+  params.integerColumnsOnly = true;
+  for (int format = CMR_MODEL_FORMAT_MPS; format <= CMR_MODEL_FORMAT_LP; ++format)
+  {
+    params.format = (CMR_MODEL_FORMAT) format;
+    CMR_DBLMAT* dblMatrix = NULL;
+    ASSERT_CMR_CALL( CMRdblmatCreateFromModelFile(cmr, format == CMR_MODEL_FORMAT_MPS ? mpsFileName : lpFileName,
+      NULL, &params, &dblMatrix) );
+    ASSERT_EQ( dblMatrix->numRows, 2UL );
+    ASSERT_EQ( dblMatrix->numColumns, 2UL );
+    ASSERT_EQ( dblMatrix->numNonzeros, 2UL );
+    ASSERT_EQ( dblMatrix->entryColumns[0], 0UL );
+    ASSERT_EQ( dblMatrix->entryColumns[1], 0UL );
+    ASSERT_CMR_CALL( CMRdblmatFree(cmr, &dblMatrix) );
+  }
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &expected) );
+
+  /* Equalities only. */
+  params.format = CMR_MODEL_FORMAT_MPS;
+  params.rows = CMR_MODEL_ROWS_EQUALITIES;
+  params.integerColumnsOnly = false;
+  ASSERT_CMR_CALL( CMRintmatCreateFromModelFile(cmr, mpsFileName, NULL, &params, &matrix) );
+  ASSERT_EQ( matrix->numRows, 1UL );
+  ASSERT_EQ( matrix->numNonzeros, 2UL );
+  ASSERT_CMR_CALL( CMRintmatFree(cmr, &matrix) );
+
+  remove(lpFileName);
+
+  /* Unsupported constraints and unknown rows are rejected. */
+  char badFileName[] = "/tmp/cmr-test-lp-XXXXXX";
+  writeTestFile(badFileName, "Minimize\n x\nSubject To\n c: [ x * y ] <= 1\nEnd\n");
+  params.format = CMR_MODEL_FORMAT_LP;
+  ASSERT_EQ( CMRintmatCreateFromModelFile(cmr, badFileName, NULL, &params, &matrix), CMR_ERROR_INPUT );
+  ASSERT_EQ( matrix, (CMR_INTMAT*) NULL );
+  remove(badFileName);
+
+  char badMpsFileName[] = "/tmp/cmr-test-mps-XXXXXX";
+  writeTestFile(badMpsFileName, "ROWS\n N obj\nCOLUMNS\n x unknown 1\nENDATA\n");
+  params.format = CMR_MODEL_FORMAT_MPS;
+  ASSERT_EQ( CMRintmatCreateFromModelFile(cmr, badMpsFileName, NULL, &params, &matrix), CMR_ERROR_INPUT );
+  remove(badMpsFileName);
+  remove(mpsFileName);
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
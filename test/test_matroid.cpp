@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <stdio.h>
+#include <cstdlib>
+#include <vector>
 
 #include "common.h"
 #include <cmr/matroid.h>
@@ -174,3 +176,114 @@ TEST(Matroid, TernaryPivot)
 
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+/**
+ * \brief Applies a pivot to a dense matrix with entries in \f$ \{0,1,\dotsc,\mathtt{characteristic}-1\} \f$.
+ */
+
+static
+void referencePivot(std::vector<std::vector<int>>& dense, size_t pivotRow, size_t pivotColumn, int characteristic)
+{
+  int pivotValue = dense[pivotRow][pivotColumn];
+  for (size_t row = 0; row < dense.size(); ++row)
+  {
+    if (row == pivotRow)
+      continue;
+    for (size_t column = 0; column < dense[row].size(); ++column)
+    {
+      if (column != pivotColumn)
+      {
+        dense[row][column] = ((dense[row][column] - pivotValue * dense[row][pivotColumn] * dense[pivotRow][column])
+          % characteristic + characteristic) % characteristic;
+      }
+    }
+    dense[row][pivotColumn] = (pivotValue * dense[row][pivotColumn]) % characteristic;
+  }
+  for (size_t column = 0; column < dense[pivotRow].size(); ++column)
+    dense[pivotRow][column] = (pivotValue * dense[pivotRow][column]) % characteristic;
+  dense[pivotRow][pivotColumn] = characteristic - pivotValue;
+}
+
+TEST(Matroid, PivotsRandom)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  srand(1);
+  for (int characteristic = 2; characteristic <= 3; ++characteristic)
+  {
+    /* Small and dense matrices are pivoted on bit-packed rows right away, large and sparse ones only after fill-in. */
+    for (size_t size : { 7, 100, 300 })
+    {
+      size_t numRows = size;
+      size_t numColumns = size + 13;
+      size_t numEntries = size <= 100 ? numRows * numColumns / 4 : 2 * numRows;
+      std::vector<std::vector<int>> dense(numRows, std::vector<int>(numColumns, 0));
+      for (size_t e = 0; e < numEntries; ++e)
+        dense[rand() % numRows][rand() % numColumns] = 1 + rand() % (characteristic - 1);
+
+      CMR_CHRMAT* matrix = NULL;
+      ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+      size_t entry = 0;
+      for (size_t row = 0; row < numRows; ++row)
+      {
+        matrix->rowSlice[row] = entry;
+        for (size_t column = 0; column < numColumns; ++column)
+        {
+          if (dense[row][column])
+          {
+            matrix->entryColumns[entry] = column;
+            matrix->entryValues[entry] = dense[row][column] == 1 ? 1 : -1;
+            ++entry;
+          }
+        }
+      }
+      matrix->rowSlice[numRows] = entry;
+      matrix->numNonzeros = entry;
+
+      /* Choose pivots on nonzeros in distinct rows and columns. */
+      std::vector<size_t> pivotRows;
+      std::vector<size_t> pivotColumns;
+      std::vector<bool> usedColumns(numColumns, false);
+      for (size_t row = 0; row < numRows && pivotRows.size() < 40; ++row)
+      {
+        for (size_t column = 0; column < numColumns; ++column)
+        {
+          if (dense[row][column] && !usedColumns[column])
+          {
+            referencePivot(dense, row, column, characteristic);
+            pivotRows.push_back(row);
+            pivotColumns.push_back(column);
+            usedColumns[column] = true;
+            break;
+          }
+        }
+      }
+
+      CMR_CHRMAT* result = NULL;
+      if (characteristic == 2)
+      {
+        ASSERT_CMR_CALL( CMRchrmatBinaryPivots(cmr, matrix, pivotRows.size(), pivotRows.data(), pivotColumns.data(),
+          &result) );
+      }
+      else
+      {
+        ASSERT_CMR_CALL( CMRchrmatTernaryPivots(cmr, matrix, pivotRows.size(), pivotRows.data(), pivotColumns.data(),
+          &result) );
+      }
+
+      std::vector<std::vector<int>> computed(numRows, std::vector<int>(numColumns, 0));
+      for (size_t row = 0; row < numRows; ++row)
+      {
+        for (size_t e = result->rowSlice[row]; e < result->rowSlice[row + 1]; ++e)
+          computed[row][result->entryColumns[e]] = (result->entryValues[e] + characteristic) % characteristic;
+      }
+      ASSERT_EQ(computed, dense);
+
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &result) );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+    }
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
@@ -117,3 +117,138 @@ TEST(Network, NonCamion)
   ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+TEST(Network, EarlySignConflict)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* The network matrix of a grid digraph. */
+  const size_t size = 20;
+  CMR_GRAPH* digraph = NULL;
+  ASSERT_CMR_CALL( CMRgraphCreateEmpty(cmr, &digraph, size * size, 2 * size * size) );
+  CMR_GRAPH_NODE nodes[size * size];
+  for (size_t v = 0; v < size * size; ++v)
+    ASSERT_CMR_CALL( CMRgraphAddNode(cmr, digraph, &nodes[v]) );
+  for (size_t x = 0; x < size; ++x)
+  {
+    for (size_t y = 0; y < size; ++y)
+    {
+      if (x + 1 < size)
+        ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, digraph, nodes[x * size + y], nodes[(x + 1) * size + y], NULL) );
+      if (y + 1 < size)
+        ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, digraph, nodes[x * size + y + 1], nodes[x * size + y], NULL) );
+    }
+  }
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRnetworkComputeMatrix(cmr, digraph, &matrix, NULL, NULL, 0, NULL, 0, NULL, NULL) );
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &digraph) );
+
+  /* Flipping the sign of an entry of the first column yields a first non-Camion column or leaves the matrix network
+   * after scaling. */
+  bool foundEarly = false;
+  for (size_t row = 0; row < matrix->numRows; ++row)
+  {
+    size_t entry = matrix->rowSlice[row];
+    if (entry == matrix->rowSlice[row + 1] || matrix->entryColumns[entry] != 0)
+      continue;
+
+    matrix->entryValues[entry] *= -1;
+    ASSERT_CMR_CALL( CMRchrmatInvalidateTranspose(cmr, matrix) );
+
+    CMR_NETWORK_STATISTICS stats;
+    ASSERT_CMR_CALL( CMRnetworkStatsInit(&stats) );
+    bool isNetwork;
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRnetworkTestMatrix(cmr, matrix, &isNetwork, NULL, NULL, NULL, NULL, NULL, &submatrix, &stats,
+      DBL_MAX) );
+
+    /* The result does not depend on whether the support is also tested. */
+    bool isNetworkSupport;
+    bool supportIsGraphic;
+    ASSERT_CMR_CALL( CMRnetworkTestMatrix(cmr, matrix, &isNetworkSupport, &supportIsGraphic, NULL, NULL, NULL, NULL,
+      NULL, NULL, DBL_MAX) );
+    ASSERT_EQ( isNetwork, isNetworkSupport );
+    ASSERT_TRUE( supportIsGraphic );
+
+    if (!isNetwork)
+    {
+      ASSERT_TRUE( submatrix );
+      CMR_CHRMAT* violator = NULL;
+      ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, submatrix, &violator) );
+      ASSERT_CMR_CALL( CMRnetworkTestMatrix(cmr, violator, &isNetwork, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+        DBL_MAX) );
+      ASSERT_FALSE( isNetwork );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &violator) );
+      ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+      if (stats.graphic.applyCount < matrix->numColumns)
+        foundEarly = true;
+    }
+
+    matrix->entryValues[entry] *= -1;
+    ASSERT_CMR_CALL( CMRchrmatInvalidateTranspose(cmr, matrix) );
+  }
+  ASSERT_TRUE( foundEarly );
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Network, GreedyPortfolio)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* The network matrix of a grid digraph, with some signs flipped. */
+  const size_t size = 6;
+  CMR_GRAPH* digraph = NULL;
+  ASSERT_CMR_CALL( CMRgraphCreateEmpty(cmr, &digraph, size * size, 2 * size * size) );
+  CMR_GRAPH_NODE nodes[size * size];
+  for (size_t v = 0; v < size * size; ++v)
+    ASSERT_CMR_CALL( CMRgraphAddNode(cmr, digraph, &nodes[v]) );
+  for (size_t x = 0; x < size; ++x)
+  {
+    for (size_t y = 0; y < size; ++y)
+    {
+      if (x + 1 < size)
+        ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, digraph, nodes[x * size + y], nodes[(x + 1) * size + y], NULL) );
+      if (y + 1 < size)
+        ASSERT_CMR_CALL( CMRgraphAddEdge(cmr, digraph, nodes[x * size + y + 1], nodes[x * size + y], NULL) );
+    }
+  }
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRnetworkComputeMatrix(cmr, digraph, &matrix, NULL, NULL, 0, NULL, 0, NULL, NULL) );
+  ASSERT_CMR_CALL( CMRgraphFree(cmr, &digraph) );
+  srand(3);
+  for (size_t e = 0; e < matrix->numNonzeros; ++e)
+  {
+    if (rand() % 8 == 0)
+      matrix->entryValues[e] *= -1;
+  }
+  CMR_CHRMAT* transpose = NULL;
+  ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+  CMR_SUBMAT* sequential = NULL;
+  ASSERT_CMR_CALL( CMRnetworkTestColumnSubmatrixPortfolio(cmr, transpose, 6, 5, &sequential) );
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 4) );
+  CMR_SUBMAT* parallel = NULL;
+  ASSERT_CMR_CALL( CMRnetworkTestColumnSubmatrixPortfolio(cmr, transpose, 6, 5, &parallel) );
+
+  ASSERT_GT( sequential->numColumns, 0UL );
+  ASSERT_LT( sequential->numColumns, matrix->numColumns );
+  ASSERT_EQ( parallel->numColumns, sequential->numColumns );
+  for (size_t c = 0; c < sequential->numColumns; ++c)
+    ASSERT_EQ( parallel->columns[c], sequential->columns[c] );
+
+  CMR_CHRMAT* networkSubmatrix = NULL;
+  ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, sequential, &networkSubmatrix) );
+  testNetworkMatrix(cmr, networkSubmatrix, true);
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &networkSubmatrix) );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &parallel) );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &sequential) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
@@ -6,6 +6,8 @@
 #include <cmr/separation.h>
 #include <cmr/graphic.h>
 
+#include <string>
+
 TEST(Regular, OneSum)
 {
   CMR* cmr = NULL;
@@ -100,7 +102,7 @@ TEST(Regular, SeriesParallelTwoSeparation)
 
     ASSERT_CMR_CALL( CMRmatroiddecPrint(cmr, dec, stdout, 0, true, true, true, true, true, true) );
     ASSERT_TRUE( isRegular );
-    ASSERT_TRUE( CMRmatroiddecHasTranspose(dec) ); /* As we test for graphicness, the transpose is constructed. */
+    ASSERT_FALSE( CMRmatroiddecHasTranspose(dec) ); /* Graphicness tests of binary matrices do not construct the transpose. */
     ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_TWO_SUM );
     ASSERT_EQ( CMRmatroiddecNumChildren(dec), 2UL );
     ASSERT_EQ( CMRmatroiddecType(CMRmatroiddecChild(dec, 0)), CMR_MATROID_DEC_TYPE_GRAPH );
@@ -156,7 +158,7 @@ TEST(Regular, NestedMinorSearchTwoSeparation)
 
     ASSERT_CMR_CALL( CMRmatroiddecPrint(cmr, dec, stdout, 0, true, true, true, true, true, true) );
     ASSERT_TRUE( isRegular );
-    ASSERT_TRUE( CMRmatroiddecHasTranspose(dec) ); /* As we test for graphicness, the transpose is constructed. */
+    ASSERT_FALSE( CMRmatroiddecHasTranspose(dec) ); /* The transpose is released once the node is finished. */
     ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_TWO_SUM );
     ASSERT_EQ( CMRmatroiddecNumChildren(dec), 2UL );
     ASSERT_GT( CMRmatroiddecGraphicness(CMRmatroiddecChild(dec, 0)), 0);
@@ -172,6 +174,26 @@ TEST(Regular, NestedMinorSearchTwoSeparation)
 
     ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
 
+    /* Unless requested otherwise. */
+    CMR_REGULAR_PARAMS params;
+    ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+    params.keepIntermediate = true;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    ASSERT_TRUE( CMRmatroiddecHasTranspose(dec) ); /* As we test for graphicness, the transpose is constructed. */
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+    /* Close to the memory limit, it is released nevertheless. */
+    char* ballast = NULL;
+    ASSERT_CMR_CALL( CMRallocBlockArray(cmr, &ballast, 8 << 20) );
+    ASSERT_CMR_CALL( CMRsetMemoryLimit(cmr, 10 << 20) );
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    ASSERT_FALSE( CMRmatroiddecHasTranspose(dec) );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+    ASSERT_CMR_CALL( CMRsetMemoryLimit(cmr, 0) );
+    ASSERT_CMR_CALL( CMRfreeBlockArray(cmr, &ballast) );
+
     ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
     ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
     ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3_dual) );
@@ -634,6 +656,43 @@ TEST(Regular, SequenceGraphicnessOneRow)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+TEST(Regular, SequenceGraphicnessSharedTraversal)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* R12 is neither graphic nor cographic, so both tests run along its sequence of nested minors. */
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "6 6 "
+    "1 0 1 1 0 0 "
+    "0 1 1 1 0 0 "
+    "1 0 1 0 1 1 "
+    "0 1 0 1 1 1 "
+    "1 0 1 0 1 0 "
+    "0 1 0 1 0 1 "
+  ) );
+
+  bool isRegular;
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  params.directGraphicness = false;
+  params.threeSumStrategy = CMR_MATROID_DEC_THREESUM_FLAG_SEYMOUR;
+  params.smallMatrices = false;
+  CMR_REGULAR_STATS stats;
+  ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, &params, &stats, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+
+  /* Each traversal tests for graphicness and cographicness together. */
+  ASSERT_GT( stats.phases[CMR_REGULAR_PHASE_SEQUENCE_GRAPHIC].count, 0UL );
+  ASSERT_EQ( stats.phases[CMR_REGULAR_PHASE_SEQUENCE_COGRAPHIC].count, 0UL );
+  ASSERT_EQ( stats.sequenceGraphicCount, stats.phases[CMR_REGULAR_PHASE_SEQUENCE_GRAPHIC].count );
+  ASSERT_GT( stats.sequenceGraphicTime, 0.0 );
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
 TEST(Regular, R10)
 {
   CMR* cmr = NULL;
@@ -822,3 +881,1240 @@ TEST(Regular, R12)
 
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+TEST(Regular, ParallelThreeSeparationSearch)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "6 6 "
+    "1 0 1 1 0 0 "
+    "0 1 1 1 0 0 "
+    "1 0 1 0 1 1 "
+    "0 1 0 1 1 1 "
+    "1 0 1 0 1 0 "
+    "0 1 0 1 0 1 "
+  ) );
+
+  /* The enumeration of candidate 3-separations must not depend on the number of threads. */
+  size_t sequentialCandidates = SIZE_MAX;
+  size_t sequentialChildren = SIZE_MAX;
+  for (int numThreads = 1; numThreads <= 4; numThreads *= 2)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+    CMR_REGULAR_PARAMS params;
+    ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+    params.threeSumStrategy = CMR_MATROID_DEC_THREESUM_FLAG_SEYMOUR;
+    CMR_REGULAR_STATS stats;
+    ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+
+    bool isRegular;
+    CMR_MATROID_DEC* dec = NULL;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, &stats, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    ASSERT_GT( stats.enumerationCount, 0UL );
+    if (numThreads == 1)
+    {
+      sequentialCandidates = stats.enumerationCandidatesCount;
+      sequentialChildren = CMRmatroiddecNumChildren(dec);
+    }
+    else
+    {
+      ASSERT_EQ( stats.enumerationCandidatesCount, sequentialCandidates );
+      ASSERT_EQ( CMRmatroiddecNumChildren(dec), sequentialChildren );
+    }
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Regular, ParallelQueue)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4 "
+    " 1 1 0 0 "
+    " 1 1 1 0 "
+    " 1 0 0 1 "
+    " 0 1 1 1 "
+    " 0 0 1 1 "
+  ) );
+  CMR_CHRMAT* R10 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &R10, "5 5 "
+    "1 0 0 1 1 "
+    "1 1 0 0 1 "
+    "0 1 1 0 1 "
+    "0 0 1 1 1 "
+    "1 1 1 1 1 "
+  ) );
+  CMR_CHRMAT* F7 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &F7, "3 4 "
+    "1 1 0 1 "
+    "1 0 1 1 "
+    "0 1 1 1 "
+  ) );
+
+  /* Regular matrix with many 1-connected components. */
+  CMR_CHRMAT* regular = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCopy(cmr, K_3_3, &regular) );
+  for (int i = 0; i < 5; ++i)
+  {
+    CMR_CHRMAT* oneSum = NULL;
+    ASSERT_CMR_CALL( CMRoneSum(cmr, regular, (i % 2) ? K_3_3 : R10, &oneSum) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &regular) );
+    regular = oneSum;
+  }
+
+  /* Irregular matrix. */
+  CMR_CHRMAT* irregular = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, regular, F7, &irregular) );
+
+  for (int numThreads = 1; numThreads <= 4; numThreads *= 2)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+    CMR_REGULAR_PARAMS params;
+    ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+    params.completeTree = true;
+    CMR_REGULAR_STATS stats;
+    ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+
+    bool isRegular;
+    CMR_MATROID_DEC* dec = NULL;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, regular, &isRegular, &dec, NULL, &params, &stats, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_ONE_SUM );
+    ASSERT_EQ( CMRmatroiddecNumChildren(dec), 6UL );
+    for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+      ASSERT_GT( CMRmatroiddecRegularity(CMRmatroiddecChild(dec, c)), 0 );
+    ASSERT_EQ( stats.totalCount, 1UL );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+    /* The nodes processed by the workers are those of all phases. */
+    uint32_t numNodes = 0;
+    for (int phase = 0; phase < CMR_REGULAR_NUM_PHASES; ++phase)
+      numNodes += stats.phases[phase].count;
+    ASSERT_LE( stats.numWorkers, (uint32_t) numThreads );
+    if (numThreads == 1)
+    {
+      ASSERT_EQ( stats.numWorkers, 0U );
+    }
+    if (stats.numWorkers)
+    {
+      uint32_t numWorkerNodes = 0;
+      for (uint32_t w = 0; w < stats.numWorkers; ++w)
+        numWorkerNodes += stats.workers[w].count;
+      ASSERT_EQ( numWorkerNodes, numNodes );
+    }
+
+    CMR_REGULAR_STATS sum;
+    ASSERT_CMR_CALL( CMRregularStatsInit(&sum) );
+    ASSERT_CMR_CALL( CMRregularStatsAdd(&sum, &stats) );
+    ASSERT_CMR_CALL( CMRregularStatsAdd(&sum, &stats) );
+    ASSERT_EQ( sum.totalCount, 2UL );
+    ASSERT_EQ( sum.seriesParallel.totalCount, 2 * stats.seriesParallel.totalCount );
+    ASSERT_EQ( sum.numWorkers, stats.numWorkers );
+    for (int phase = 0; phase < CMR_REGULAR_NUM_PHASES; ++phase)
+      ASSERT_EQ( sum.phases[phase].count, 2 * stats.phases[phase].count );
+
+    ASSERT_CMR_CALL( CMRregularTest(cmr, irregular, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+    ASSERT_FALSE( isRegular );
+    ASSERT_EQ( CMRmatroiddecNumChildren(dec), 7UL );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+    params.completeTree = false;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, irregular, &isRegular, NULL, NULL, &params, NULL, DBL_MAX) );
+    ASSERT_FALSE( isRegular );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &irregular) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &regular) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &F7) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &R10) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Regular, Schedule)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4 "
+    " 1 1 0 0 "
+    " 1 1 1 0 "
+    " 1 0 0 1 "
+    " 0 1 1 1 "
+    " 0 0 1 1 "
+  ) );
+  CMR_CHRMAT* F7 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &F7, "3 4 "
+    "1 1 0 1 "
+    "1 0 1 1 "
+    "0 1 1 1 "
+  ) );
+
+  /* Irregular matrix whose smallest 1-connected component is the only irregular one. */
+  CMR_CHRMAT* irregular = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCopy(cmr, F7, &irregular) );
+  for (int i = 0; i < 4; ++i)
+  {
+    CMR_CHRMAT* oneSum = NULL;
+    ASSERT_CMR_CALL( CMRoneSum(cmr, irregular, K_3_3, &oneSum) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &irregular) );
+    irregular = oneSum;
+  }
+
+  CMR_REGULAR_SCHEDULE schedules[4] = { CMR_REGULAR_SCHEDULE_DEPTH_FIRST, CMR_REGULAR_SCHEDULE_SMALLEST_FIRST,
+    CMR_REGULAR_SCHEDULE_LARGEST_FIRST, CMR_REGULAR_SCHEDULE_SMALL_DENSE_FIRST };
+  for (int numThreads = 1; numThreads <= 2; ++numThreads)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+    for (int s = 0; s < 4; ++s)
+    {
+      CMR_REGULAR_PARAMS params;
+      ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+      params.schedule = schedules[s];
+
+      /* The complete tree does not depend on the order. */
+      params.completeTree = true;
+      bool isRegular;
+      CMR_MATROID_DEC* dec = NULL;
+      ASSERT_CMR_CALL( CMRregularTest(cmr, irregular, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+      ASSERT_FALSE( isRegular );
+      ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_ONE_SUM );
+      ASSERT_EQ( CMRmatroiddecNumChildren(dec), 5UL );
+      size_t numIrregular = 0;
+      for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+      {
+        ASSERT_NE( CMRmatroiddecRegularity(CMRmatroiddecChild(dec, c)), 0 );
+        if (CMRmatroiddecRegularity(CMRmatroiddecChild(dec, c)) < 0)
+          ++numIrregular;
+      }
+      ASSERT_EQ( numIrregular, 1UL );
+      ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+      /* Without a complete tree, the order decides how many components are processed. */
+      params.completeTree = false;
+      ASSERT_CMR_CALL( CMRregularTest(cmr, irregular, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+      ASSERT_FALSE( isRegular );
+      size_t numProcessed = 0;
+      for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+      {
+        if (CMRmatroiddecRegularity(CMRmatroiddecChild(dec, c)) != 0)
+          ++numProcessed;
+      }
+      if (numThreads == 1 && params.schedule == CMR_REGULAR_SCHEDULE_SMALLEST_FIRST)
+      {
+        ASSERT_EQ( numProcessed, 1UL );
+      }
+      else if (numThreads == 1 && params.schedule == CMR_REGULAR_SCHEDULE_LARGEST_FIRST)
+      {
+        ASSERT_EQ( numProcessed, 5UL );
+      }
+      ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+    }
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &irregular) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &F7) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Returns the printed decomposition tree rooted at \p dec.
+ */
+
+static
+std::string decompositionString(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec  /**< Decomposition node. */
+)
+{
+  FILE* stream = tmpfile();
+  EXPECT_NE( stream, (FILE*) NULL );
+  EXPECT_EQ( CMRmatroiddecPrint(cmr, dec, stream, 0, true, true, true, true, true, true), CMR_OKAY );
+  std::string result;
+  rewind(stream);
+  int c;
+  while ((c = fgetc(stream)) != EOF)
+    result.push_back((char) c);
+  fclose(stream);
+  return result;
+}
+
+TEST(Regular, Deterministic)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4 "
+    " 1 1 0 0 "
+    " 1 1 1 0 "
+    " 1 0 0 1 "
+    " 0 1 1 1 "
+    " 0 0 1 1 "
+  ) );
+  CMR_CHRMAT* R10 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &R10, "5 5 "
+    "1 0 0 1 1 "
+    "1 1 0 0 1 "
+    "0 1 1 0 1 "
+    "0 0 1 1 1 "
+    "1 1 1 1 1 "
+  ) );
+  CMR_CHRMAT* F7 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &F7, "3 4 "
+    "1 1 0 1 "
+    "1 0 1 1 "
+    "0 1 1 1 "
+  ) );
+
+  /* Several irregular components between regular ones, such that the first irregular one depends on the order. */
+  CMR_CHRMAT* irregular = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCopy(cmr, K_3_3, &irregular) );
+  for (int i = 0; i < 9; ++i)
+  {
+    CMR_CHRMAT* oneSum = NULL;
+    ASSERT_CMR_CALL( CMRoneSum(cmr, irregular, (i % 3 == 1) ? F7 : ((i % 2) ? R10 : K_3_3), &oneSum) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &irregular) );
+    irregular = oneSum;
+  }
+
+  /* The reference is the single-threaded depth-first processing. */
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  bool isRegular;
+  CMR_MATROID_DEC* dec = NULL;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, irregular, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_FALSE( isRegular );
+  std::string reference = decompositionString(cmr, dec);
+  ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+  CMR_REGULAR_SCHEDULE schedules[4] = { CMR_REGULAR_SCHEDULE_DEPTH_FIRST, CMR_REGULAR_SCHEDULE_SMALLEST_FIRST,
+    CMR_REGULAR_SCHEDULE_LARGEST_FIRST, CMR_REGULAR_SCHEDULE_SMALL_DENSE_FIRST };
+  for (int numThreads = 1; numThreads <= 4; ++numThreads)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+    for (int s = 0; s < 4; ++s)
+    {
+      for (int round = 0; round < 5; ++round)
+      {
+        ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+        params.schedule = schedules[s];
+        params.deterministic = true;
+        ASSERT_CMR_CALL( CMRregularTest(cmr, irregular, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+        ASSERT_FALSE( isRegular );
+        ASSERT_EQ( decompositionString(cmr, dec), reference );
+        ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+      }
+    }
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &irregular) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &F7) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &R10) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Verifies the (co)graphs of all children of a 1-sum node against their matrices.
+ */
+
+static
+void verifyChildGraphs(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec  /**< 1-sum node. */
+)
+{
+  for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+  {
+    CMR_MATROID_DEC* child = CMRmatroiddecChild(dec, c);
+    ASSERT_GT( CMRmatroiddecRegularity(child), 0 );
+    bool isVerified;
+    if (CMRmatroiddecGraph(child))
+    {
+      ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, CMRmatroiddecGetMatrix(child), CMRmatroiddecGraph(child),
+        CMRmatroiddecGraphForest(child), CMRmatroiddecGraphCoforest(child), &isVerified) );
+      ASSERT_TRUE( isVerified );
+    }
+    if (CMRmatroiddecCograph(child))
+    {
+      CMR_CHRMAT* transpose = NULL;
+      ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, CMRmatroiddecGetMatrix(child), &transpose) );
+      ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, transpose, CMRmatroiddecCograph(child),
+        CMRmatroiddecCographForest(child), CMRmatroiddecCographCoforest(child), &isVerified) );
+      ASSERT_TRUE( isVerified );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+    }
+  }
+}
+
+TEST(Regular, Cache)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Three copies of K_3_3 and two of R10, with permuted rows and columns. */
+  const char* blocks[5] = {
+    "5 4  1 1 0 0  1 1 1 0  1 0 0 1  0 1 1 1  0 0 1 1 ",
+    "5 4  0 0 1 1  0 1 1 1  1 0 0 1  1 1 1 0  1 1 0 0 ",
+    "5 4  1 0 1 0  0 1 1 0  1 0 0 1  0 1 1 1  1 1 0 1 ",
+    "5 5  1 0 0 1 1  1 1 0 0 1  0 1 1 0 1  0 0 1 1 1  1 1 1 1 1 ",
+    "5 5  1 1 1 1 1  1 0 0 1 1  0 1 1 1 0  0 1 0 1 1  1 0 1 1 0 ",
+  };
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, blocks[0]) );
+  for (int i = 1; i < 5; ++i)
+  {
+    CMR_CHRMAT* block = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &block, blocks[i]) );
+    CMR_CHRMAT* oneSum = NULL;
+    ASSERT_CMR_CALL( CMRoneSum(cmr, matrix, block, &oneSum) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &block) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+    matrix = oneSum;
+  }
+
+  for (int numThreads = 1; numThreads <= 2; ++numThreads)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+    CMR_REGULAR_PARAMS params;
+    ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+    params.completeTree = true;
+    ASSERT_CMR_CALL( CMRregularCacheCreate(cmr, &params.cache) );
+
+    for (int run = 0; run < 2; ++run)
+    {
+      CMR_REGULAR_STATS stats;
+      ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+
+      bool isRegular;
+      CMR_MATROID_DEC* dec = NULL;
+      ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, &stats, DBL_MAX) );
+      ASSERT_TRUE( isRegular );
+      ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_ONE_SUM );
+      ASSERT_EQ( CMRmatroiddecNumChildren(dec), 5UL );
+      verifyChildGraphs(cmr, dec);
+      size_t numR10 = 0;
+      for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+      {
+        if (CMRmatroiddecType(CMRmatroiddecChild(dec, c)) == CMR_MATROID_DEC_TYPE_R10)
+          ++numR10;
+      }
+      ASSERT_EQ( numR10, 2UL );
+      ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+      ASSERT_EQ( stats.cacheLookupCount, 5U );
+      if (run > 0)
+      {
+        ASSERT_EQ( stats.cacheHitCount, 5U );
+      }
+      else if (numThreads == 1)
+      {
+        ASSERT_EQ( stats.cacheHitCount, 3U );
+      }
+      ASSERT_EQ( CMRregularCacheNumEntries(params.cache), 2UL );
+    }
+
+    ASSERT_CMR_CALL( CMRregularCacheFree(cmr, &params.cache) );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Regular, ConstructGraphs)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* K_3_3 is graphic but not cographic, and its transpose is cographic but not graphic. */
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4  1 1 0 0  1 1 1 0  1 0 0 1  0 1 1 1  0 0 1 1 ") );
+  CMR_CHRMAT* K_3_3_dual = NULL;
+  ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, K_3_3, &K_3_3_dual) );
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, K_3_3_dual, &matrix) );
+
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  params.completeTree = true;
+  params.graphs = CMR_DEC_CONSTRUCT_NONE;
+  bool isRegular;
+  CMR_MATROID_DEC* dec = NULL;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_ONE_SUM );
+  ASSERT_EQ( CMRmatroiddecNumChildren(dec), 2UL );
+  ASSERT_CMR_CALL( CMRmatroiddecPrint(cmr, dec, stdout, 0, true, true, true, true, true, true) );
+
+  size_t numGraphs = 0;
+  size_t numCographs = 0;
+  for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+  {
+    CMR_MATROID_DEC* child = CMRmatroiddecChild(dec, c);
+    ASSERT_FALSE( CMRmatroiddecGraph(child) );
+    ASSERT_FALSE( CMRmatroiddecCograph(child) );
+    if (CMRmatroiddecGraphicness(child) > 0)
+    {
+      ASSERT_CMR_CALL( CMRmatroiddecConstructGraph(cmr, child) );
+      CMR_GRAPH* graph = CMRmatroiddecGraph(child);
+      ASSERT_TRUE( graph );
+      ASSERT_CMR_CALL( CMRmatroiddecConstructGraph(cmr, child) );
+      ASSERT_EQ( CMRmatroiddecGraph(child), graph );
+      ++numGraphs;
+    }
+    else
+    {
+      ASSERT_EQ( CMRmatroiddecConstructGraph(cmr, child), CMR_ERROR_INPUT );
+      ASSERT_FALSE( CMRmatroiddecGraph(child) );
+    }
+    if (CMRmatroiddecCographicness(child) > 0)
+    {
+      ASSERT_CMR_CALL( CMRmatroiddecConstructCograph(cmr, child) );
+      ASSERT_TRUE( CMRmatroiddecCograph(child) );
+      ++numCographs;
+    }
+    else
+    {
+      ASSERT_EQ( CMRmatroiddecConstructCograph(cmr, child), CMR_ERROR_INPUT );
+    }
+  }
+  ASSERT_EQ( numGraphs, 1UL );
+  ASSERT_EQ( numCographs, 1UL );
+  verifyChildGraphs(cmr, dec);
+  ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+  /* The leaves keep their graphs. */
+  params.graphs = CMR_DEC_CONSTRUCT_LEAVES;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+  for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+  {
+    CMR_MATROID_DEC* child = CMRmatroiddecChild(dec, c);
+    ASSERT_TRUE( CMRmatroiddecGraph(child) || CMRmatroiddecCograph(child) );
+  }
+  verifyChildGraphs(cmr, dec);
+  ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3_dual) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Regular, CacheStream)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4  1 1 0 0  1 1 1 0  1 0 0 1  0 1 1 1  0 0 1 1 ") );
+  CMR_CHRMAT* R10 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &R10, "5 5  1 0 0 1 1  1 1 0 0 1  0 1 1 0 1  0 0 1 1 1  1 1 1 1 1 ") );
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, R10, &matrix) );
+
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  params.completeTree = true;
+  ASSERT_CMR_CALL( CMRregularCacheCreate(cmr, &params.cache) );
+  bool isRegular;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  ASSERT_EQ( CMRregularCacheNumEntries(params.cache), 2UL );
+
+  /* Write the leaves and read them twice into a fresh cache, which must ignore the duplicates. */
+  FILE* stream = tmpfile();
+  ASSERT_TRUE( stream );
+  ASSERT_CMR_CALL( CMRregularCacheWrite(cmr, params.cache, stream) );
+  ASSERT_CMR_CALL( CMRregularCacheFree(cmr, &params.cache) );
+  ASSERT_CMR_CALL( CMRregularCacheCreate(cmr, &params.cache) );
+  for (int i = 0; i < 2; ++i)
+  {
+    rewind(stream);
+    ASSERT_CMR_CALL( CMRregularCacheRead(cmr, params.cache, stream) );
+  }
+  ASSERT_EQ( CMRregularCacheNumEntries(params.cache), 2UL );
+
+  /* The restored leaves answer the lookups of the blocks in the other order. */
+  CMR_CHRMAT* reversed = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, R10, K_3_3, &reversed) );
+  CMR_REGULAR_STATS stats;
+  ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+  CMR_MATROID_DEC* dec = NULL;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, reversed, &isRegular, &dec, NULL, &params, &stats, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  ASSERT_EQ( stats.cacheLookupCount, 2U );
+  ASSERT_EQ( stats.cacheHitCount, 2U );
+  verifyChildGraphs(cmr, dec);
+  ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+  /* Truncated data is rejected. */
+  fflush(stream);
+  long length = ftell(stream);
+  rewind(stream);
+  FILE* truncated = tmpfile();
+  ASSERT_TRUE( truncated );
+  for (long i = 0; i < length / 2; ++i)
+    fputc(fgetc(stream), truncated);
+  rewind(truncated);
+  CMR_REGULAR_CACHE* other = NULL;
+  ASSERT_CMR_CALL( CMRregularCacheCreate(cmr, &other) );
+  ASSERT_EQ( CMRregularCacheRead(cmr, other, truncated), CMR_ERROR_INPUT );
+  CMRclearErrorMessage(cmr);
+  fclose(truncated);
+  fclose(stream);
+
+  ASSERT_CMR_CALL( CMRregularCacheFree(cmr, &other) );
+  ASSERT_CMR_CALL( CMRregularCacheFree(cmr, &params.cache) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &reversed) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &R10) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Returns the text representation of the decomposition tree rooted at \p dec without the graphs.
+ */
+
+static
+std::string printDecomposition(
+  CMR* cmr,             /**< \ref CMR environment. */
+  CMR_MATROID_DEC* dec  /**< Decomposition tree. */
+)
+{
+  FILE* stream = tmpfile();
+  EXPECT_TRUE( stream );
+  EXPECT_EQ( CMRmatroiddecPrint(cmr, dec, stream, 0, true, true, true, false, true, true), CMR_OKAY );
+  std::string text;
+  long length = ftell(stream);
+  rewind(stream);
+  for (long i = 0; i < length; ++i)
+    text.push_back((char) fgetc(stream));
+  fclose(stream);
+  return text;
+}
+
+/**
+ * \brief Checks that the (co)graphs of two decomposition trees have the same edges with the same indices.
+ */
+
+static
+void checkEqualGraphs(
+  CMR_MATROID_DEC* dec,   /**< Decomposition tree. */
+  CMR_MATROID_DEC* other  /**< Other decomposition tree. */
+)
+{
+  for (int g = 0; g < 2; ++g)
+  {
+    CMR_GRAPH* graph = g ? CMRmatroiddecCograph(dec) : CMRmatroiddecGraph(dec);
+    CMR_GRAPH* otherGraph = g ? CMRmatroiddecCograph(other) : CMRmatroiddecGraph(other);
+    ASSERT_EQ( graph == NULL, otherGraph == NULL );
+    if (!graph)
+      continue;
+    ASSERT_EQ( CMRgraphNumNodes(graph), CMRgraphNumNodes(otherGraph) );
+    ASSERT_EQ( CMRgraphNumEdges(graph), CMRgraphNumEdges(otherGraph) );
+    for (CMR_GRAPH_ITER i = CMRgraphEdgesFirst(graph); CMRgraphEdgesValid(graph, i); i = CMRgraphEdgesNext(graph, i))
+    {
+      CMR_GRAPH_EDGE e = CMRgraphEdgesEdge(graph, i);
+      ASSERT_EQ( CMRgraphEdgeU(graph, e), CMRgraphEdgeU(otherGraph, e) );
+      ASSERT_EQ( CMRgraphEdgeV(graph, e), CMRgraphEdgeV(otherGraph, e) );
+    }
+  }
+  ASSERT_EQ( CMRmatroiddecNumChildren(dec), CMRmatroiddecNumChildren(other) );
+  for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+    checkEqualGraphs(CMRmatroiddecChild(dec, c), CMRmatroiddecChild(other, c));
+}
+
+TEST(Regular, DecompositionBinary)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4  1 1 0 0  1 1 1 0  1 0 0 1  0 1 1 1  0 0 1 1 ") );
+  CMR_CHRMAT* R10 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &R10, "5 5  1 0 0 1 1  1 1 0 0 1  0 1 1 0 1  0 0 1 1 1  1 1 1 1 1 ") );
+  CMR_CHRMAT* matrices[3] = { NULL, NULL, NULL };
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, R10, &matrices[0]) );
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrices[1], "11 11  1 0 1 0 0 0 0 0 0 0 0  1 1 0 0 0 1 0 0 0 0 0 "
+    "0 1 1 0 0 0 0 0 0 0 0  0 0 0 0 1 1 0 0 0 0 0  0 0 0 1 1 0 0 0 0 0 1  0 1 1 1 0 0 0 0 0 1 0 "
+    "0 0 0 0 0 0 0 1 1 0 0  0 0 0 0 0 0 1 1 0 0 0  0 1 1 0 0 0 1 0 0 0 0  0 1 1 0 0 0 0 0 1 0 0 "
+    "0 0 0 0 0 0 0 0 0 1 1 ") );
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrices[2], "3 4  1 1 0 1  1 0 1 1  0 1 1 1 ") );
+
+  for (int m = 0; m < 3; ++m)
+  {
+    CMR_REGULAR_PARAMS params;
+    ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+    params.completeTree = true;
+    params.directGraphicness = false;
+    bool isRegular;
+    CMR_MATROID_DEC* dec = NULL;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrices[m], &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+
+    FILE* stream = tmpfile();
+    ASSERT_TRUE( stream );
+    ASSERT_CMR_CALL( CMRmatroiddecPrintBinary(cmr, dec, stream) );
+    long length = ftell(stream);
+    ASSERT_EQ( length % 8, 0L );
+    rewind(stream);
+    CMR_MATROID_DEC* restored = NULL;
+    ASSERT_CMR_CALL( CMRmatroiddecCreateFromBinaryStream(cmr, stream, &restored) );
+    ASSERT_EQ( printDecomposition(cmr, dec), printDecomposition(cmr, restored) );
+    ASSERT_EQ( CMRmatroiddecRegularity(dec), CMRmatroiddecRegularity(restored) );
+    checkEqualGraphs(dec, restored);
+    verifyChildGraphs(cmr, restored);
+
+    /* Every truncation is rejected. */
+    for (long cut = 0; cut < length; cut += 1 + length / 50)
+    {
+      rewind(stream);
+      FILE* truncated = tmpfile();
+      ASSERT_TRUE( truncated );
+      for (long i = 0; i < cut; ++i)
+        fputc(fgetc(stream), truncated);
+      rewind(truncated);
+      CMR_MATROID_DEC* invalid = NULL;
+      ASSERT_EQ( CMRmatroiddecCreateFromBinaryStream(cmr, truncated, &invalid), CMR_ERROR_INPUT );
+      ASSERT_EQ( invalid, (CMR_MATROID_DEC*) NULL );
+      CMRclearErrorMessage(cmr);
+      fclose(truncated);
+    }
+    fclose(stream);
+
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &restored) );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrices[m]) );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &R10) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Progress callback that interrupts the computation after every processed node.
+ */
+
+static
+void interruptAfterEachNode(
+  CMR* cmr,                     /**< \ref CMR environment. */
+  const CMR_PROGRESS* progress, /**< Current progress. */
+  void* data                    /**< Unused. */
+)
+{
+  CMR_UNUSED(progress);
+  CMR_UNUSED(data);
+
+  CMRinterrupt(cmr);
+}
+
+TEST(Regular, Checkpoint)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4  1 1 0 0  1 1 1 0  1 0 0 1  0 1 1 1  0 0 1 1 ") );
+  CMR_CHRMAT* R10 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &R10, "5 5  1 0 0 1 1  1 1 0 0 1  0 1 1 0 1  0 0 1 1 1  1 1 1 1 1 ") );
+  CMR_CHRMAT* sum = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, R10, &sum) );
+  CMR_CHRMAT* other = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &other, "11 11  1 0 1 0 0 0 0 0 0 0 0  1 1 0 0 0 1 0 0 0 0 0 "
+    "0 1 1 0 0 0 0 0 0 0 0  0 0 0 0 1 1 0 0 0 0 0  0 0 0 1 1 0 0 0 0 0 1  0 1 1 1 0 0 0 0 0 1 0 "
+    "0 0 0 0 0 0 0 1 1 0 0  0 0 0 0 0 0 1 1 0 0 0  0 1 1 0 0 0 1 0 0 0 0  0 1 1 0 0 0 0 0 1 0 0 "
+    "0 0 0 0 0 0 0 0 0 1 1 ") );
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, sum, other, &matrix) );
+
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  params.completeTree = true;
+  params.directGraphicness = false;
+  bool isRegular;
+  CMR_MATROID_DEC* expected = NULL;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, &expected, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+
+  for (int numThreads = 1; numThreads <= 2; ++numThreads)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+    /* Every call processes at least one node and stores the remaining ones in the checkpoint. */
+    ASSERT_CMR_CALL( CMRregularCheckpointCreate(cmr, &params.checkpoint) );
+    ASSERT_CMR_CALL( CMRsetProgressCallback(cmr, interruptAfterEachNode, NULL) );
+    CMR_MATROID_DEC* dec = NULL;
+    size_t numCalls = 0;
+    CMR_ERROR error;
+    while ((error = CMRregularTest(cmr, matrix, &isRegular, &dec, NULL, &params, NULL, DBL_MAX)) == CMR_ERROR_TIMEOUT)
+    {
+      CMRclearInterrupt(cmr);
+      ASSERT_GT( CMRregularCheckpointNumPending(params.checkpoint), 0UL );
+      ASSERT_LT( ++numCalls, 1000UL );
+
+      /* Every other state is passed through a stream. */
+      if (numCalls % 2)
+        continue;
+      FILE* stream = tmpfile();
+      ASSERT_TRUE( stream );
+      ASSERT_CMR_CALL( CMRregularCheckpointWrite(cmr, params.checkpoint, stream) );
+      size_t numPending = CMRregularCheckpointNumPending(params.checkpoint);
+      ASSERT_CMR_CALL( CMRregularCheckpointFree(cmr, &params.checkpoint) );
+      ASSERT_CMR_CALL( CMRregularCheckpointCreate(cmr, &params.checkpoint) );
+      rewind(stream);
+      ASSERT_CMR_CALL( CMRregularCheckpointRead(cmr, params.checkpoint, stream) );
+      ASSERT_EQ( CMRregularCheckpointNumPending(params.checkpoint), numPending );
+      fclose(stream);
+    }
+    ASSERT_CMR_CALL( error );
+    CMRclearInterrupt(cmr);
+    ASSERT_CMR_CALL( CMRsetProgressCallback(cmr, NULL, NULL) );
+    ASSERT_GT( numCalls, 3UL );
+    ASSERT_EQ( CMRregularCheckpointNumPending(params.checkpoint), 0UL );
+    ASSERT_TRUE( isRegular );
+    if (numThreads == 1)
+    {
+      ASSERT_EQ( printDecomposition(cmr, expected), printDecomposition(cmr, dec) );
+    }
+    verifyChildGraphs(cmr, dec);
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+    ASSERT_CMR_CALL( CMRregularCheckpointFree(cmr, &params.checkpoint) );
+  }
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+
+  /* A checkpoint cannot be used for another matrix, and truncated ones are rejected. */
+  ASSERT_CMR_CALL( CMRregularCheckpointCreate(cmr, &params.checkpoint) );
+  ASSERT_CMR_CALL( CMRsetProgressCallback(cmr, interruptAfterEachNode, NULL) );
+  ASSERT_EQ( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, &params, NULL, DBL_MAX), CMR_ERROR_TIMEOUT );
+  CMRclearInterrupt(cmr);
+  ASSERT_CMR_CALL( CMRsetProgressCallback(cmr, NULL, NULL) );
+  FILE* stream = tmpfile();
+  ASSERT_TRUE( stream );
+  ASSERT_CMR_CALL( CMRregularCheckpointWrite(cmr, params.checkpoint, stream) );
+  long length = ftell(stream);
+  ASSERT_EQ( CMRregularTest(cmr, sum, &isRegular, NULL, NULL, &params, NULL, DBL_MAX), CMR_ERROR_INPUT );
+  CMRclearErrorMessage(cmr);
+  for (long cut = 0; cut < length; cut += 1 + length / 20)
+  {
+    rewind(stream);
+    FILE* truncated = tmpfile();
+    ASSERT_TRUE( truncated );
+    for (long i = 0; i < cut; ++i)
+      fputc(fgetc(stream), truncated);
+    rewind(truncated);
+    ASSERT_EQ( CMRregularCheckpointRead(cmr, params.checkpoint, truncated), CMR_ERROR_INPUT );
+    ASSERT_EQ( CMRregularCheckpointNumPending(params.checkpoint), 0UL );
+    CMRclearErrorMessage(cmr);
+    fclose(truncated);
+  }
+  fclose(stream);
+  ASSERT_CMR_CALL( CMRregularCheckpointFree(cmr, &params.checkpoint) );
+
+  ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &expected) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &other) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &sum) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &R10) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Regular, NodeTimeLimit)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4  1 1 0 0  1 1 1 0  1 0 0 1  0 1 1 1  0 0 1 1 ") );
+  CMR_CHRMAT* R10 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &R10, "5 5  1 0 0 1 1  1 1 0 0 1  0 1 1 0 1  0 0 1 1 1  1 1 1 1 1 ") );
+  CMR_CHRMAT* F7 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &F7, "3 4  1 1 0 1  1 0 1 1  0 1 1 1 ") );
+  CMR_CHRMAT* regular = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, R10, &regular) );
+  CMR_CHRMAT* irregular = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, F7, &irregular) );
+
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  params.directGraphicness = false;
+
+  for (int numThreads = 1; numThreads <= 2; ++numThreads)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+
+    /* With a tiny budget, the K_3_3 block is skipped while the R10 block is still recognized. */
+    params.completeTree = true;
+    params.nodeTimeLimit = 1.0e-12;
+    CMR_REGULAR_STATS stats;
+    ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+    bool isRegular;
+    CMR_MATROID_DEC* dec = NULL;
+    ASSERT_EQ( CMRregularTest(cmr, regular, &isRegular, &dec, NULL, &params, NULL, DBL_MAX), CMR_ERROR_TIMEOUT );
+    ASSERT_FALSE( dec );
+    ASSERT_CMR_CALL( CMRregularCheckpointCreate(cmr, &params.checkpoint) );
+    ASSERT_EQ( CMRregularTest(cmr, regular, &isRegular, &dec, NULL, &params, &stats, DBL_MAX), CMR_ERROR_TIMEOUT );
+    ASSERT_GT( stats.skippedCount, 0UL );
+    ASSERT_EQ( CMRregularCheckpointNumPending(params.checkpoint), stats.skippedCount );
+
+    /* The skipped nodes are processed from the checkpoint without a budget. */
+    params.nodeTimeLimit = 0.0;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, regular, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    ASSERT_EQ( CMRregularCheckpointNumPending(params.checkpoint), 0UL );
+    ASSERT_CMR_CALL( CMRregularCheckpointFree(cmr, &params.checkpoint) );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+    /* Completing an unknown leaf with a tiny budget leaves it unknown, but the remaining tree is valid. */
+    params.completeTree = false;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, irregular, &isRegular, &dec, NULL, &params, NULL, DBL_MAX) );
+    ASSERT_FALSE( isRegular );
+    ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_ONE_SUM );
+    CMR_MATROID_DEC* unknown = NULL;
+    for (size_t c = 0; c < CMRmatroiddecNumChildren(dec); ++c)
+    {
+      if (CMRmatroiddecRegularity(CMRmatroiddecChild(dec, c)) == 0)
+        unknown = CMRmatroiddecChild(dec, c);
+    }
+    ASSERT_TRUE( unknown );
+    params.nodeTimeLimit = 1.0e-12;
+    ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+    ASSERT_CMR_CALL( CMRregularCompleteDecomposition(cmr, unknown, &params, &stats, DBL_MAX) );
+    ASSERT_GT( stats.skippedCount, 0UL );
+    ASSERT_EQ( CMRmatroiddecRegularity(dec), -1 );
+
+    params.nodeTimeLimit = 0.0;
+    ASSERT_CMR_CALL( CMRregularCompleteDecomposition(cmr, unknown, &params, NULL, DBL_MAX) );
+    ASSERT_EQ( CMRmatroiddecRegularity(unknown), 1 );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+  }
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &irregular) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &regular) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &F7) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &R10) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Regular, PhaseStatistics)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4 "
+    " 1 1 0 0 "
+    " 1 1 1 0 "
+    " 1 0 0 1 "
+    " 0 1 1 1 "
+    " 0 0 1 1 "
+  ) );
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, K_3_3, &matrix) );
+
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  params.smallMatrices = false;
+  CMR_REGULAR_STATS stats;
+  ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+  stats.nodeLog = tmpfile();
+  ASSERT_TRUE( stats.nodeLog );
+
+  bool isRegular;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, &params, &stats, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+
+  /* The root is split by a 1-sum and each child is processed at least once. */
+  ASSERT_EQ( stats.phases[CMR_REGULAR_PHASE_ONE_SUM].count, 1U );
+  uint32_t numNodes = 0;
+  for (int p = 0; p < CMR_REGULAR_NUM_PHASES; ++p)
+  {
+    uint32_t numSized = 0;
+    uint32_t numTimed = 0;
+    for (int b = 0; b < CMR_REGULAR_HISTOGRAM_BINS; ++b)
+    {
+      numSized += stats.phases[p].sizeHistogram[b];
+      numTimed += stats.phases[p].timeHistogram[b];
+    }
+    ASSERT_EQ( numSized, stats.phases[p].count );
+    ASSERT_EQ( numTimed, stats.phases[p].count );
+    ASSERT_LE( stats.phases[p].maxTime, stats.phases[p].time );
+    numNodes += stats.phases[p].count;
+  }
+  ASSERT_GE( numNodes, 3U );
+
+  /* The node log has one line per processed node. */
+  rewind(stats.nodeLog);
+  uint32_t numLines = 0;
+  for (int c = fgetc(stats.nodeLog); c != EOF; c = fgetc(stats.nodeLog))
+  {
+    if (c == '\n')
+      ++numLines;
+  }
+  ASSERT_EQ( numLines, numNodes );
+  fclose(stats.nodeLog);
+
+  FILE* json = tmpfile();
+  ASSERT_TRUE( json );
+  ASSERT_CMR_CALL( CMRregularStatsPrintJson(json, &stats) );
+  ASSERT_GT( ftell(json), 0L );
+  fclose(json);
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Regular, DirectTwoSums)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* R10 and K_3_3 glued along a row, which is a cut vertex of the support graph. */
+  CMR_CHRMAT* regular = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &regular, "9 9 "
+    " 1 0 0 1 1 0 0 0 0 "
+    " 1 1 0 0 1 0 0 0 0 "
+    " 0 1 1 0 1 0 0 0 0 "
+    " 0 0 1 1 1 0 0 0 0 "
+    " 1 1 1 1 1 1 1 0 0 "
+    " 0 0 0 0 0 1 1 1 0 "
+    " 0 0 0 0 0 1 0 0 1 "
+    " 0 0 0 0 0 0 1 1 1 "
+    " 0 0 0 0 0 0 0 1 1 "
+  ) );
+
+  /* F7 and K_3_3 glued along a row. */
+  CMR_CHRMAT* irregular = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &irregular, "7 8 "
+    " 1 1 0 1 0 0 0 0 "
+    " 1 0 1 1 0 0 0 0 "
+    " 0 1 1 1 1 1 0 0 "
+    " 0 0 0 0 1 1 1 0 "
+    " 0 0 0 0 1 0 0 1 "
+    " 0 0 0 0 0 1 1 1 "
+    " 0 0 0 0 0 0 1 1 "
+  ) );
+
+  for (int direct = 0; direct <= 1; ++direct)
+  {
+    CMR_REGULAR_PARAMS params;
+    ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+    params.directTwoSums = direct;
+    params.completeTree = true;
+
+    /* The root is split at the glued row. */
+    CMR_REGULAR_STATS stats;
+    ASSERT_CMR_CALL( CMRregularStatsInit(&stats) );
+    bool isRegular;
+    CMR_MATROID_DEC* dec = NULL;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, regular, &isRegular, &dec, NULL, &params, &stats, DBL_MAX) );
+    ASSERT_TRUE( isRegular );
+    if (direct)
+    {
+      ASSERT_GE( stats.phases[CMR_REGULAR_PHASE_TWO_SUM].count, 1U );
+      ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_TWO_SUM );
+      ASSERT_EQ( CMRmatroiddecNumChildren(dec), 2UL );
+    }
+    else
+      ASSERT_EQ( stats.phases[CMR_REGULAR_PHASE_TWO_SUM].count, 0U );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+    ASSERT_CMR_CALL( CMRregularTest(cmr, irregular, &isRegular, NULL, NULL, &params, NULL, DBL_MAX) );
+    ASSERT_FALSE( isRegular );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &irregular) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &regular) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Checks that \p minor of \p matrix represents \f$ F_7 \f$ or \f$ F_7^\star \f$.
+ */
+
+static
+void checkFanoMinor(
+  CMR* cmr,           /**< \ref CMR environment. */
+  CMR_CHRMAT* matrix, /**< Matrix. */
+  CMR_MINOR* minor    /**< Minor of \p matrix. */
+)
+{
+  ASSERT_TRUE( minor );
+  CMR_CHRMAT* pivoted = NULL;
+  ASSERT_CMR_CALL( CMRchrmatBinaryPivots(cmr, matrix, minor->numPivots, minor->pivotRows, minor->pivotColumns,
+    &pivoted) );
+  CMR_CHRMAT* fano = NULL;
+  ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, pivoted, minor->remainingSubmatrix, &fano) );
+  CMR_CHRMAT* transpose = NULL;
+  ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, fano, &transpose) );
+
+  /* The 4 long lines of a 3x4 (resp. 4x3) matrix must be the 4 binary vectors with at least 2 ones. */
+  CMR_CHRMAT* wide = fano->numRows == 3 ? fano : transpose;
+  ASSERT_EQ( wide->numRows, 3UL );
+  ASSERT_EQ( wide->numColumns, 4UL );
+  bool seen[8] = { false, false, false, false, false, false, false, false };
+  for (size_t column = 0; column < 4; ++column)
+  {
+    int vector = 0;
+    for (size_t row = 0; row < 3; ++row)
+    {
+      size_t entry;
+      ASSERT_CMR_CALL( CMRchrmatFindEntry(wide, row, column, &entry) );
+      if (entry != SIZE_MAX)
+        vector |= 1 << row;
+    }
+    ASSERT_TRUE( vector == 3 || vector == 5 || vector == 6 || vector == 7 );
+    ASSERT_FALSE( seen[vector] );
+    seen[vector] = true;
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &fano) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &pivoted) );
+}
+
+TEST(Regular, FanoMinor)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4  1 1 0 0  1 1 1 0  1 0 0 1  0 1 1 1  0 0 1 1 ") );
+  CMR_CHRMAT* F7 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &F7, "3 4  1 1 0 1  1 0 1 1  0 1 1 1 ") );
+  CMR_CHRMAT* F7dual = NULL;
+  ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, F7, &F7dual) );
+
+  /* F7 and K_3_3 glued along a row. */
+  CMR_CHRMAT* glued = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &glued, "7 8 "
+    " 1 1 0 1 0 0 0 0 "
+    " 1 0 1 1 0 0 0 0 "
+    " 0 1 1 1 1 1 0 0 "
+    " 0 0 0 0 1 1 1 0 "
+    " 0 0 0 0 1 0 0 1 "
+    " 0 0 0 0 0 1 1 1 "
+    " 0 0 0 0 0 0 1 1 "
+  ) );
+
+  /* F7* with an element added in series and pivots applied, such that F7* is not a submatrix. */
+  CMR_CHRMAT* extended = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &extended, "4 4 "
+    " 1 1 0 1 "
+    " 1 0 1 0 "
+    " 0 1 1 0 "
+    " 1 1 1 0 "
+  ) );
+  CMR_CHRMAT* pivotedExtended = NULL;
+  ASSERT_CMR_CALL( CMRchrmatBinaryPivot(cmr, extended, 0, 0, &pivotedExtended) );
+
+  CMR_CHRMAT* oneSum = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, F7dual, &oneSum) );
+
+  CMR_CHRMAT* matrices[] = { F7, F7dual, oneSum, glued, pivotedExtended };
+  for (size_t i = 0; i < sizeof(matrices) / sizeof(matrices[0]); ++i)
+  {
+    bool isRegular;
+    CMR_MINOR* minor = NULL;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, matrices[i], &isRegular, NULL, &minor, NULL, NULL, DBL_MAX) );
+    ASSERT_FALSE( isRegular );
+    checkFanoMinor(cmr, matrices[i], minor);
+    ASSERT_CMR_CALL( CMRminorFree(cmr, &minor) );
+  }
+
+  /* No minor is returned for regular matrices. */
+  bool isRegular;
+  CMR_MINOR* minor = NULL;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, K_3_3, &isRegular, NULL, &minor, NULL, NULL, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  ASSERT_FALSE( minor );
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &oneSum) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &pivotedExtended) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &extended) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &glued) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &F7dual) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &F7) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(Regular, Trace)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 2) );
+
+  CMR_CHRMAT* K_3_3 = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &K_3_3, "5 4 "
+    " 1 1 0 0 "
+    " 1 1 1 0 "
+    " 1 0 0 1 "
+    " 0 1 1 1 "
+    " 0 0 1 1 "
+  ) );
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRoneSum(cmr, K_3_3, K_3_3, &matrix) );
+
+  FILE* trace = tmpfile();
+  ASSERT_TRUE( trace );
+  ASSERT_CMR_CALL( CMRtraceStart(cmr, trace) );
+
+  CMR_REGULAR_PARAMS params;
+  ASSERT_CMR_CALL( CMRregularParamsInit(&params) );
+  params.smallMatrices = false;
+  bool isRegular;
+  ASSERT_CMR_CALL( CMRregularTest(cmr, matrix, &isRegular, NULL, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isRegular );
+  ASSERT_CMR_CALL( CMRtraceStop(cmr) );
+
+  /* Every line but the brackets is an event, and begin and end events match. */
+  rewind(trace);
+  char line[1024];
+  ASSERT_TRUE( fgets(line, sizeof(line), trace) );
+  ASSERT_STREQ( line, "[\n" );
+  size_t numBegin = 0;
+  size_t numEnd = 0;
+  bool hasOneSum = false;
+  while (fgets(line, sizeof(line), trace) && strcmp(line, "]\n"))
+  {
+    ASSERT_EQ( line[0], '{' );
+    if (strstr(line, "\"ph\":\"B\""))
+    {
+      ++numBegin;
+      ASSERT_TRUE( strstr(line, "\"rows\":") );
+      ASSERT_TRUE( strstr(line, "\"parent\":") );
+    }
+    if (strstr(line, "\"ph\":\"E\""))
+      ++numEnd;
+    if (strstr(line, "\"name\":\"one-sum\",") && strstr(line, "\"parent\":\"0x0\""))
+      hasOneSum = true;
+  }
+  ASSERT_STREQ( line, "]\n" );
+  ASSERT_GE( numBegin, 3UL );
+  ASSERT_EQ( numBegin, numEnd );
+  ASSERT_TRUE( hasOneSum );
+  fclose(trace);
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &K_3_3) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
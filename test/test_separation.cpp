@@ -301,3 +301,222 @@ TEST(Separation, ThreeSum)
 
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+TEST(Separation, TwoSumTree)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* first = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &first, "5 5 "
+    " 1  1  0  0  0 "
+    " 1  0  1 -1  1 "
+    " 0 -1  1  0 -1 "
+    " 0  0 -1  1  0 "
+    " 0  1  1  0  1 "
+  ) );
+  CMR_CHRMAT* second = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &second, "5 5 "
+    " 1 -1  1  0  0 "
+    " 1  1  1  1 -1 "
+    " 0  0 -1  0  1 "
+    " 1  0  0 -1  0 "
+    " 0  1  0  0  1 "
+  ) );
+  CMR_CHRMAT* third = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &third, "4 4 "
+    " 1  1  0 -1 "
+    "-1  0  1  0 "
+    " 0  1  1  1 "
+    " 1  0 -1  1 "
+  ) );
+  CMR_CHRMAT* matrices[3] = { first, second, third };
+
+  /* Without edges we obtain the 1-sum. */
+  {
+    CMR_CHRMAT* oneSum = NULL;
+    ASSERT_CMR_CALL( CMRoneSum(cmr, first, second, &oneSum) );
+    CMR_CHRMAT* result = NULL;
+    ASSERT_CMR_CALL( CMRtwoSumTree(cmr, 2, matrices, 0, NULL, 3, &result) );
+    ASSERT_TRUE( CMRchrmatCheckEqual(result, oneSum) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &result) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &oneSum) );
+  }
+
+  /* A path, where the second edge uses a row of the second matrix that lies in the bottom part of the first 2-sum. */
+  {
+    CMR_CHRMAT* twoSum = NULL;
+    ASSERT_CMR_CALL( CMRtwoSum(cmr, first, second, CMRrowToElement(1), CMRcolumnToElement(2), 3, &twoSum) );
+    CMR_CHRMAT* check = NULL;
+    ASSERT_CMR_CALL( CMRtwoSum(cmr, twoSum, third, CMRrowToElement(4 + 3), CMRcolumnToElement(0), 3, &check) );
+
+    CMR_TWOSUM_EDGE edges[2] = {
+      { 0, 1, CMRrowToElement(1), CMRcolumnToElement(2) },
+      { 1, 2, CMRrowToElement(3), CMRcolumnToElement(0) }
+    };
+    CMR_CHRMAT* result = NULL;
+    ASSERT_CMR_CALL( CMRtwoSumTree(cmr, 3, matrices, 2, edges, 3, &result) );
+    ASSERT_TRUE( CMRchrmatCheckEqual(result, check) );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &result) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &check) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &twoSum) );
+  }
+
+  /* A star at the first matrix whose second edge is given in reversed orientation. */
+  {
+    CMR_CHRMAT* twoSum = NULL;
+    ASSERT_CMR_CALL( CMRtwoSum(cmr, first, second, CMRrowToElement(1), CMRcolumnToElement(2), 3, &twoSum) );
+    CMR_CHRMAT* check = NULL;
+    ASSERT_CMR_CALL( CMRtwoSum(cmr, twoSum, third, CMRcolumnToElement(4), CMRrowToElement(0), 3, &check) );
+
+    CMR_TWOSUM_EDGE edges[2] = {
+      { 0, 1, CMRrowToElement(1), CMRcolumnToElement(2) },
+      { 2, 0, CMRrowToElement(0), CMRcolumnToElement(4) }
+    };
+    CMR_CHRMAT* result = NULL;
+    ASSERT_CMR_CALL( CMRtwoSumTree(cmr, 3, matrices, 2, edges, 3, &result) );
+    ASSERT_TRUE( CMRchrmatCheckEqual(result, check) );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &result) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &check) );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &twoSum) );
+  }
+
+  /* Invalid input: a cycle, two rows as markers and a marker that is used twice. */
+  {
+    CMR_TWOSUM_EDGE cycle[2] = {
+      { 0, 1, CMRrowToElement(1), CMRcolumnToElement(2) },
+      { 1, 0, CMRrowToElement(3), CMRcolumnToElement(0) }
+    };
+    CMR_CHRMAT* result = NULL;
+    ASSERT_EQ( CMRtwoSumTree(cmr, 3, matrices, 2, cycle, 3, &result), CMR_ERROR_INPUT );
+    CMR_TWOSUM_EDGE rows[1] = { { 0, 1, CMRrowToElement(1), CMRrowToElement(2) } };
+    ASSERT_EQ( CMRtwoSumTree(cmr, 3, matrices, 1, rows, 3, &result), CMR_ERROR_INPUT );
+    CMR_TWOSUM_EDGE twice[2] = {
+      { 0, 1, CMRrowToElement(1), CMRcolumnToElement(2) },
+      { 0, 2, CMRrowToElement(1), CMRcolumnToElement(0) }
+    };
+    ASSERT_EQ( CMRtwoSumTree(cmr, 3, matrices, 2, twice, 3, &result), CMR_ERROR_INPUT );
+    ASSERT_EQ( result, (CMR_CHRMAT*) NULL );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &third) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &second) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &first) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Creates a matrix with a 2-separation whose bottom-left part has two rows over \p numFirstColumns columns.
+ *
+ * The second of these rows is the negative of the first one, except for column \p flippedColumn.
+ */
+
+static
+CMR_ERROR createTwoSeparationMatrix(CMR* cmr, size_t numFirstColumns, size_t flippedColumn, CMR_CHRMAT** pmatrix,
+  CMR_SEPA** psepa)
+{
+  size_t numColumns = numFirstColumns + 2;
+  CMR_CALL( CMRchrmatCreate(cmr, pmatrix, 5, numColumns, 5 * numColumns) );
+  CMR_CHRMAT* matrix = *pmatrix;
+  matrix->numNonzeros = 0;
+  for (size_t row = 0; row < 5; ++row)
+  {
+    matrix->rowSlice[row] = matrix->numNonzeros;
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      char value = 0;
+      if (row == 0)
+        value = column <= 1 ? 1 : 0;
+      else if (row == 1)
+        value = (column == 1 || column == 2) ? 1 : 0;
+      else if (row == 2)
+        value = (column < numFirstColumns && column % 2 == 0) || column == numFirstColumns ? 1 : 0;
+      else if (row == 3 && column < numFirstColumns)
+        value = column % 2 == 0 ? (column == flippedColumn ? 1 : -1) : 0;
+      else if (row == 3)
+        value = 1;
+      else
+        value = column == numFirstColumns + 1 ? 1 : 0;
+      if (value)
+      {
+        matrix->entryColumns[matrix->numNonzeros] = column;
+        matrix->entryValues[matrix->numNonzeros] = value;
+        matrix->numNonzeros++;
+      }
+    }
+  }
+  matrix->rowSlice[5] = matrix->numNonzeros;
+
+  CMR_CALL( CMRsepaCreate(cmr, 5, numColumns, psepa) );
+  CMR_SEPA* sepa = *psepa;
+  for (size_t row = 0; row < 5; ++row)
+    sepa->rowsFlags[row] = row < 2 ? CMR_SEPA_FIRST : CMR_SEPA_SECOND;
+  for (size_t column = 0; column < numColumns; ++column)
+    sepa->columnsFlags[column] = column < numFirstColumns ? CMR_SEPA_FIRST : CMR_SEPA_SECOND;
+
+  return CMR_OKAY;
+}
+
+TEST(Separation, CheckTernary)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Narrow and wide bottom-left parts with the flipped sign in the first or in a later word. */
+  size_t numsFirstColumns[] = { 3, 150, 150 };
+  size_t flippedColumns[] = { 2, 0, 130 };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    size_t numFirstColumns = numsFirstColumns[i];
+    for (int flip = 0; flip < 2; ++flip)
+    {
+      CMR_CHRMAT* matrix = NULL;
+      CMR_SEPA* sepa = NULL;
+      ASSERT_CMR_CALL( createTwoSeparationMatrix(cmr, numFirstColumns, flip ? flippedColumns[i] : SIZE_MAX, &matrix,
+        &sepa) );
+      CMR_CHRMAT* transpose = NULL;
+      ASSERT_CMR_CALL( CMRchrmatTranspose(cmr, matrix, &transpose) );
+
+      bool swapped;
+      ASSERT_CMR_CALL( CMRsepaFindBinaryRepresentatives(cmr, sepa, matrix, transpose, &swapped, NULL) );
+      ASSERT_FALSE( swapped );
+      ASSERT_EQ( sepa->type, CMR_SEPA_TYPE_TWO );
+
+      bool isTernary;
+      CMR_SUBMAT* violator = NULL;
+      ASSERT_CMR_CALL( CMRsepaCheckTernary(cmr, sepa, matrix, &isTernary, &violator) );
+      if (flip && flippedColumns[i] == 0)
+      {
+        /* Flipping the first entry flips the scaling, so the violator is at the second column of the support. */
+        ASSERT_FALSE( isTernary );
+        ASSERT_TRUE( violator );
+        ASSERT_EQ( violator->columns[0], 0UL );
+        ASSERT_EQ( violator->columns[1], 2UL );
+      }
+      else if (flip)
+      {
+        ASSERT_FALSE( isTernary );
+        ASSERT_TRUE( violator );
+        ASSERT_EQ( violator->rows[0], 2UL );
+        ASSERT_EQ( violator->rows[1], 3UL );
+        ASSERT_EQ( violator->columns[0], 0UL );
+        ASSERT_EQ( violator->columns[1], flippedColumns[i] );
+      }
+      else
+      {
+        ASSERT_TRUE( isTernary );
+        ASSERT_FALSE( violator );
+      }
+
+      ASSERT_CMR_CALL( CMRsubmatFree(cmr, &violator) );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+      ASSERT_CMR_CALL( CMRsepaFree(cmr, &sepa) );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+    }
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
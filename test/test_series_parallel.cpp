@@ -3,6 +3,8 @@
 #include "common.h"
 #include <cmr/series_parallel.h>
 
+#include <vector>
+
 TEST(SeriesParallel, Empty)
 {
   CMR* cmr = NULL;
@@ -134,6 +136,54 @@ TEST(SeriesParallel, BinaryReduction)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+TEST(SeriesParallel, BinaryReductionParallelHashing)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* A matrix that is large enough to be hashed in parallel, with many parallel rows and columns. */
+  const size_t numRows = 600;
+  const size_t numColumns = 550;
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+  size_t entry = 0;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    matrix->rowSlice[row] = entry;
+    for (size_t column = 0; column < numColumns; ++column)
+    {
+      if ((row * 7 + column * 3) % 11 == 0)
+        continue;
+      matrix->entryColumns[entry] = column;
+      matrix->entryValues[entry] = 1;
+      ++entry;
+    }
+  }
+  matrix->rowSlice[numRows] = entry;
+  ASSERT_CMR_CALL( CMRchrmatChangeNumNonzeros(cmr, matrix, entry) );
+
+  std::vector<CMR_SP_REDUCTION> sequential(numRows + numColumns);
+  std::vector<CMR_SP_REDUCTION> parallel(numRows + numColumns);
+  size_t numSequential;
+  size_t numParallel;
+  ASSERT_CMR_CALL( CMRtestBinarySeriesParallel(cmr, matrix, NULL, &sequential[0], &numSequential, NULL, NULL, NULL,
+    DBL_MAX) );
+  ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 4) );
+  ASSERT_CMR_CALL( CMRtestBinarySeriesParallel(cmr, matrix, NULL, &parallel[0], &numParallel, NULL, NULL, NULL,
+    DBL_MAX) );
+
+  ASSERT_GT( numSequential, 0UL );
+  ASSERT_EQ( numParallel, numSequential );
+  for (size_t r = 0; r < numSequential; ++r)
+  {
+    ASSERT_EQ( parallel[r].element, sequential[r].element );
+    ASSERT_EQ( parallel[r].mate, sequential[r].mate );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
 TEST(SeriesParallel, BinaryShortWheel)
 {
   CMR* cmr = NULL;
@@ -666,3 +716,88 @@ TEST(SeriesParallel, TernaryBadSeparation)
   ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
+
+TEST(SeriesParallel, BinaryRandomWheels)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  srand(5);
+  size_t numWheels = 0;
+  for (size_t r = 0; r < 500; ++r)
+  {
+    size_t numRows = 3 + rand() % 10;
+    size_t numColumns = 3 + rand() % 10;
+    int density = 2 + rand() % 4;
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        if (rand() % 10 < density)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = 1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = matrix->numNonzeros;
+
+    bool isSeriesParallel;
+    CMR_SUBMAT* wheelSubmatrix = NULL;
+    ASSERT_CMR_CALL( CMRtestBinarySeriesParallel(cmr, matrix, &isSeriesParallel, NULL, NULL, NULL, &wheelSubmatrix,
+      NULL, DBL_MAX) );
+    if (!isSeriesParallel)
+    {
+      /* A wheel is not series-parallel, but removing any of its rows or columns yields a series-parallel matrix. */
+      ASSERT_TRUE( wheelSubmatrix );
+      ASSERT_EQ( wheelSubmatrix->numRows, wheelSubmatrix->numColumns );
+      ASSERT_GE( wheelSubmatrix->numRows, 3UL );
+      CMR_CHRMAT* wheelMatrix = NULL;
+      ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, wheelSubmatrix, &wheelMatrix) );
+      bool isWheelSeriesParallel;
+      ASSERT_CMR_CALL( CMRtestBinarySeriesParallel(cmr, wheelMatrix, &isWheelSeriesParallel, NULL, NULL, NULL, NULL,
+        NULL, DBL_MAX) );
+      ASSERT_FALSE( isWheelSeriesParallel );
+
+      size_t size = wheelSubmatrix->numRows;
+      for (size_t removed = 0; removed < 2 * size; ++removed)
+      {
+        CMR_SUBMAT* minorSubmatrix = NULL;
+        bool removeRow = removed < size;
+        ASSERT_CMR_CALL( CMRsubmatCreate(cmr, removeRow ? size - 1 : size, removeRow ? size : size - 1,
+          &minorSubmatrix) );
+        for (size_t i = 0, j = 0; i < size; ++i)
+        {
+          if (!removeRow || i != removed)
+            minorSubmatrix->rows[j++] = i;
+        }
+        for (size_t i = 0, j = 0; i < size; ++i)
+        {
+          if (removeRow || i != removed - size)
+            minorSubmatrix->columns[j++] = i;
+        }
+        CMR_CHRMAT* minorMatrix = NULL;
+        ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, wheelMatrix, minorSubmatrix, &minorMatrix) );
+        bool isMinorSeriesParallel;
+        ASSERT_CMR_CALL( CMRtestBinarySeriesParallel(cmr, minorMatrix, &isMinorSeriesParallel, NULL, NULL, NULL,
+          NULL, NULL, DBL_MAX) );
+        ASSERT_TRUE( isMinorSeriesParallel );
+        ASSERT_CMR_CALL( CMRchrmatFree(cmr, &minorMatrix) );
+        ASSERT_CMR_CALL( CMRsubmatFree(cmr, &minorSubmatrix) );
+      }
+
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &wheelMatrix) );
+      ASSERT_CMR_CALL( CMRsubmatFree(cmr, &wheelSubmatrix) );
+      ++numWheels;
+    }
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+  ASSERT_GT( numWheels, 0UL );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
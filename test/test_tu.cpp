@@ -12,6 +12,10 @@
 #include <cmr/graphic.h>
 #include <cmr/linear_algebra.h>
 
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 TEST(TU, EulerianAlgorithm)
 {
   CMR* cmr = NULL;
@@ -91,6 +95,68 @@ TEST(TU, EulerianAlgorithm)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+TEST(TU, EulerianAlgorithmRandom)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_TU_PARAMS params;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&params) );
+  params.algorithm = CMR_TU_ALGORITHM_EULERIAN;
+  CMR_TU_PARAMS decompositionParams;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&decompositionParams) );
+  decompositionParams.regular.smallMatrices = false;
+
+  srand(2);
+  for (size_t r = 0; r < 100; ++r)
+  {
+    /* Random ternary 7x9 matrix, transposed in every second round. */
+    size_t numRows = (r % 2) ? 9 : 7;
+    size_t numColumns = (r % 2) ? 7 : 9;
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        int x = rand() % 8;
+        if (x < 2)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = x == 0 ? 1 : -1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = matrix->numNonzeros;
+
+    bool isTU;
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, NULL, &decompositionParams, NULL, DBL_MAX) );
+
+    bool eulerianIsTU;
+    CMR_SUBMAT* violator = NULL;
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &eulerianIsTU, NULL, &violator, &params, NULL, DBL_MAX) );
+    ASSERT_EQ( eulerianIsTU, isTU );
+
+    if (violator)
+    {
+      CMR_CHRMAT* violatorMatrix = NULL;
+      ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, violator, &violatorMatrix) );
+      int64_t determinant;
+      ASSERT_CMR_CALL( CMRchrmatDeterminant(cmr, violatorMatrix, &determinant) );
+      ASSERT_TRUE( (determinant > 1) || (determinant < -1) );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &violatorMatrix) );
+      ASSERT_CMR_CALL( CMRsubmatFree(cmr, &violator) );
+    }
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
 TEST(TU, PartitionAlgorithm)
 {
   CMR* cmr = NULL;
@@ -214,6 +280,63 @@ CMR_ERROR checkDecompositionTreePartition(
 
 #endif /* MASSIVE_RANDOM */
 
+TEST(TU, PartitionAlgorithmParallel)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_TU_PARAMS params;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&params) );
+  params.algorithm = CMR_TU_ALGORITHM_PARTITION;
+  CMR_TU_PARAMS decompositionParams;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&decompositionParams) );
+  decompositionParams.regular.smallMatrices = false;
+
+  srand(3);
+  for (size_t r = 0; r < 40; ++r)
+  {
+    /* Random ternary 8x8 matrix. */
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, 8, 8, 64) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < matrix->numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < matrix->numColumns; ++column)
+      {
+        int x = rand() % 10;
+        if (x < 2)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = x == 0 ? 1 : -1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[matrix->numRows] = matrix->numNonzeros;
+
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 1) );
+    bool isTU;
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, NULL, &decompositionParams, NULL, DBL_MAX) );
+
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, 4) );
+    bool partitionIsTU;
+    CMR_TU_STATS stats;
+    ASSERT_CMR_CALL( CMRtuStatsInit(&stats) );
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &partitionIsTU, NULL, NULL, &params, &stats, DBL_MAX) );
+    ASSERT_EQ( partitionIsTU, isTU );
+    if (isTU)
+    {
+      /* All row subsets must have been considered. */
+      ASSERT_EQ( stats.partitionRowSubsets + stats.partitionColumnSubsets, 256UL );
+    }
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
 TEST(TU, OneSum)
 {
   CMR* cmr = NULL;
@@ -308,7 +431,7 @@ TEST(TU, SeriesParallelTwoSeparation)
 
     ASSERT_CMR_CALL( CMRmatroiddecPrint(cmr, dec, stdout, 0, true, true, true, true, true, true) );
     ASSERT_TRUE( isTU );
-    ASSERT_TRUE( CMRmatroiddecHasTranspose(dec) ); /* As we test for graphicness, the transpose is constructed. */
+    ASSERT_FALSE( CMRmatroiddecHasTranspose(dec) ); /* The transpose is released once the node is finished. */
     ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_TWO_SUM );
     ASSERT_EQ( CMRmatroiddecNumChildren(dec), 2UL );
     ASSERT_GT( CMRmatroiddecGraphicness(CMRmatroiddecChild(dec, 0)), 0 );
@@ -358,7 +481,7 @@ TEST(TU, NestedMinorSearchTwoSeparation)
 
     ASSERT_CMR_CALL( CMRmatroiddecPrint(cmr, dec, stdout, 0, true, true, true, true, true, true) );
     ASSERT_TRUE( isTU );
-    ASSERT_TRUE( CMRmatroiddecHasTranspose(dec) ); /* As we test for graphicness, the transpose is constructed. */
+    ASSERT_FALSE( CMRmatroiddecHasTranspose(dec) ); /* The transpose is released once the node is finished. */
     ASSERT_EQ( CMRmatroiddecType(dec), CMR_MATROID_DEC_TYPE_TWO_SUM );
     ASSERT_EQ( CMRmatroiddecNumChildren(dec), 2UL );
     ASSERT_GT( CMRmatroiddecGraphicness(CMRmatroiddecChild(dec, 0)), 0 );
@@ -1101,6 +1224,416 @@ TEST(TU, ForbiddenSubmatrixWideWide)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+TEST(TU, SmallMatrices)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_TU_PARAMS params;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&params) );
+  params.regular.smallMatrices = false;
+
+  srand(5);
+  for (size_t r = 0; r < 300; ++r)
+  {
+    /* Random ternary matrix with up to 16 rows and columns of varying density. */
+    size_t numRows = 2 + rand() % 15;
+    size_t numColumns = 2 + rand() % 15;
+    int density = 3 + (r % 4);
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrix, numRows, numColumns, numRows * numColumns) );
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < numColumns; ++column)
+      {
+        int x = rand() % (2 * density);
+        if (x < 2)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = x == 0 ? 1 : -1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[numRows] = matrix->numNonzeros;
+
+    bool isTU;
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, NULL, &params, NULL, DBL_MAX) );
+
+    bool smallIsTU;
+    CMR_SUBMAT* violator = NULL;
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &smallIsTU, NULL, &violator, NULL, NULL, DBL_MAX) );
+    ASSERT_EQ( smallIsTU, isTU );
+    ASSERT_EQ( violator != NULL, !isTU );
+
+    if (violator)
+    {
+      /* The violator is square with determinant -2 or +2, and removing any column yields a TU matrix. */
+      ASSERT_EQ( violator->numRows, violator->numColumns );
+      CMR_CHRMAT* violatorMatrix = NULL;
+      ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, violator, &violatorMatrix) );
+      int64_t determinant;
+      ASSERT_CMR_CALL( CMRchrmatDeterminant(cmr, violatorMatrix, &determinant) );
+      ASSERT_TRUE( determinant == 2 || determinant == -2 );
+
+      for (size_t remove = 0; remove < violator->numColumns; ++remove)
+      {
+        CMR_SUBMAT* smaller = NULL;
+        ASSERT_CMR_CALL( CMRsubmatCreate(cmr, violator->numRows, violator->numColumns - 1, &smaller) );
+        for (size_t row = 0; row < violator->numRows; ++row)
+          smaller->rows[row] = row;
+        for (size_t column = 0; column + 1 < violator->numColumns; ++column)
+          smaller->columns[column] = column < remove ? column : column + 1;
+        CMR_CHRMAT* smallerMatrix = NULL;
+        ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, violatorMatrix, smaller, &smallerMatrix) );
+        bool smallerIsTU;
+        ASSERT_CMR_CALL( CMRtuTest(cmr, smallerMatrix, &smallerIsTU, NULL, NULL, &params, NULL, DBL_MAX) );
+        ASSERT_TRUE( smallerIsTU );
+        ASSERT_CMR_CALL( CMRchrmatFree(cmr, &smallerMatrix) );
+        ASSERT_CMR_CALL( CMRsubmatFree(cmr, &smaller) );
+      }
+
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &violatorMatrix) );
+      ASSERT_CMR_CALL( CMRsubmatFree(cmr, &violator) );
+    }
+
+    /* The support is regular if and only if its Camion signing is TU. */
+    CMR_CHRMAT* support = NULL;
+    ASSERT_CMR_CALL( CMRchrmatSupport(cmr, matrix, &support) );
+    bool isRegular;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, support, &isRegular, NULL, NULL, &params.regular, NULL, DBL_MAX) );
+    bool smallIsRegular;
+    ASSERT_CMR_CALL( CMRregularTest(cmr, support, &smallIsRegular, NULL, NULL, NULL, NULL, DBL_MAX) );
+    ASSERT_EQ( smallIsRegular, isRegular );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &support) );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(TU, ForbiddenSubmatrixMinimal)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* A network matrix with consecutive ones next to a non-TU matrix that is attached via two rows. */
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "12 10 "
+    "1 1 1 0 0 0 0 0 0 0 "
+    "0 1 1 1 0 0 0 0 0 0 "
+    "0 0 1 1 1 0 0 0 0 0 "
+    "0 0 0 1 1 1 0 0 0 0 "
+    "0 0 0 0 1 1 1 0 0 0 "
+    "0 0 0 0 0 1 1 1 0 0 "
+    "0 0 0 0 0 0 1 1 1 1 "
+    "0 0 0 0 0 0 0 1 1 0 "
+    "0 0 0 0 0 0 0 0 1 1 "
+    "0 0 0 0 0 0 0 1 0 1 "
+    "1 0 0 0 0 0 0 0 0 0 "
+    "0 0 0 0 0 0 0 0 0 1 "
+  ) );
+
+  bool isTU;
+  CMR_SUBMAT* submatrix = NULL;
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, &submatrix, NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE( isTU );
+  ASSERT_TRUE( submatrix );
+
+  /* The submatrix must be non-TU, but removing any row or column must yield a TU matrix. */
+  CMR_CHRMAT* violator = NULL;
+  ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, submatrix, &violator) );
+  ASSERT_CMR_CALL( CMRtuTest(cmr, violator, &isTU, NULL, NULL, NULL, NULL, DBL_MAX) );
+  ASSERT_FALSE( isTU );
+  for (size_t remove = 0; remove < violator->numRows + violator->numColumns; ++remove)
+  {
+    bool isRow = remove < violator->numRows;
+    CMR_SUBMAT* smaller = NULL;
+    ASSERT_CMR_CALL( CMRsubmatCreate(cmr, violator->numRows - (isRow ? 1 : 0),
+      violator->numColumns - (isRow ? 0 : 1), &smaller) );
+    smaller->numRows = 0;
+    for (size_t row = 0; row < violator->numRows; ++row)
+    {
+      if (row != remove)
+        smaller->rows[smaller->numRows++] = row;
+    }
+    smaller->numColumns = 0;
+    for (size_t column = 0; column < violator->numColumns; ++column)
+    {
+      if (column + violator->numRows != remove)
+        smaller->columns[smaller->numColumns++] = column;
+    }
+
+    CMR_CHRMAT* smallerMatrix = NULL;
+    ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, violator, smaller, &smallerMatrix) );
+    ASSERT_CMR_CALL( CMRtuTest(cmr, smallerMatrix, &isTU, NULL, NULL, NULL, NULL, DBL_MAX) );
+    ASSERT_TRUE( isTU );
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &smallerMatrix) );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &smaller) );
+  }
+
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &violator) );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(TU, ForbiddenSubmatrixThreads)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "12 10 "
+    "1 1 1 0 0 0 0 0 0 0 "
+    "0 1 1 1 0 0 0 0 0 0 "
+    "0 0 1 1 1 0 0 0 0 0 "
+    "0 0 0 1 1 1 0 0 0 0 "
+    "0 0 0 0 1 1 1 0 0 0 "
+    "0 0 0 0 0 1 1 1 0 0 "
+    "0 0 0 0 0 0 1 1 1 1 "
+    "0 0 0 0 0 0 0 1 1 0 "
+    "0 0 0 0 0 0 0 0 1 1 "
+    "0 0 0 0 0 0 0 1 0 1 "
+    "1 0 0 0 0 0 0 0 0 0 "
+    "0 0 0 0 0 0 0 0 0 1 "
+  ) );
+
+  /* The submatrix must not depend on the number of threads, while speculative oracle calls may be discarded. */
+  CMR_TU_PARAMS params;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&params) );
+  params.regular.smallMatrices = false;
+  bool isTU;
+  CMR_SUBMAT* sequentialSubmatrix = NULL;
+  CMR_TU_STATS sequentialStats;
+  ASSERT_CMR_CALL( CMRtuStatsInit(&sequentialStats) );
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, &sequentialSubmatrix, &params, &sequentialStats, DBL_MAX) );
+  ASSERT_FALSE( isTU );
+  for (int numThreads = 2; numThreads <= 4; numThreads += 2)
+  {
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+    CMR_SUBMAT* submatrix = NULL;
+    CMR_TU_STATS stats;
+    ASSERT_CMR_CALL( CMRtuStatsInit(&stats) );
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, &submatrix, &params, &stats, DBL_MAX) );
+    ASSERT_FALSE( isTU );
+    ASSERT_EQ( submatrix->numRows, sequentialSubmatrix->numRows );
+    ASSERT_EQ( submatrix->numColumns, sequentialSubmatrix->numColumns );
+    for (size_t r = 0; r < submatrix->numRows; ++r)
+      ASSERT_EQ( submatrix->rows[r], sequentialSubmatrix->rows[r] );
+    for (size_t c = 0; c < submatrix->numColumns; ++c)
+      ASSERT_EQ( submatrix->columns[c], sequentialSubmatrix->columns[c] );
+    ASSERT_GE( stats.decomposition.totalCount, sequentialStats.decomposition.totalCount );
+    ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &sequentialSubmatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(TU, TwoByTwo)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_TU_PARAMS params;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&params) );
+  params.directTwoByTwo = true;
+
+  /* Rows 1 and 3 with columns 0 and 2 form a submatrix with determinant -2. */
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "4 4 "
+    " 1  1  0  0 "
+    " 1  0  1  0 "
+    " 0  1  1  1 "
+    " 1  0 -1  1 "
+  ) );
+  bool isTU;
+  CMR_SUBMAT* submatrix = NULL;
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, &submatrix, &params, NULL, DBL_MAX) );
+  ASSERT_FALSE( isTU );
+  ASSERT_TRUE( submatrix );
+  ASSERT_EQ( submatrix->numRows, 2UL );
+  ASSERT_EQ( submatrix->numColumns, 2UL );
+  ASSERT_EQ( submatrix->rows[0], 1UL );
+  ASSERT_EQ( submatrix->rows[1], 3UL );
+  ASSERT_EQ( submatrix->columns[0], 0UL );
+  ASSERT_EQ( submatrix->columns[1], 2UL );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  /* A totally unimodular matrix passes the search. */
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "4 4 "
+    " 1  1  0  0 "
+    " 0  1  1  0 "
+    " 0  0  1  1 "
+    " 1  1  1  1 "
+  ) );
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  /* The Fano matrix has no such submatrix, so the decomposition decides. */
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "3 4 "
+    "1 1 0 1 "
+    "1 0 1 1 "
+    "0 1 1 1 "
+  ) );
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, &submatrix, &params, NULL, DBL_MAX) );
+  ASSERT_FALSE( isTU );
+  ASSERT_TRUE( submatrix );
+  ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(TU, DirectCamion)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_TU_PARAMS params;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&params) );
+  CMR_TU_PARAMS directParams;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&directParams) );
+  directParams.directCamion = true;
+
+  srand(2);
+  for (int r = 0; r < 200; ++r)
+  {
+    /* A random Camion-signed core, extended by unit vectors and signed copies of its columns. */
+    CMR_CHRMAT* core = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &core, 6, 6, 36) );
+    core->numNonzeros = 0;
+    for (size_t row = 0; row < 6; ++row)
+    {
+      core->rowSlice[row] = core->numNonzeros;
+      for (size_t column = 0; column < 6; ++column)
+      {
+        if (rand() % 5 < 2)
+        {
+          core->entryColumns[core->numNonzeros] = column;
+          core->entryValues[core->numNonzeros] = 1;
+          core->numNonzeros++;
+        }
+      }
+    }
+    core->rowSlice[6] = core->numNonzeros;
+    ASSERT_CMR_CALL( CMRcamionComputeSigns(cmr, core, NULL, NULL, NULL, DBL_MAX) );
+
+    std::stringstream ss;
+    ss << "6 12 ";
+    int copies[6];
+    for (size_t c = 0; c < 6; ++c)
+      copies[c] = rand() % 8;
+    int flipped = (r % 2) ? rand() % 12 : -1;
+    for (size_t row = 0; row < 6; ++row)
+    {
+      char dense[6] = { 0, 0, 0, 0, 0, 0 };
+      for (size_t e = core->rowSlice[row]; e < core->rowSlice[row + 1]; ++e)
+        dense[core->entryColumns[e]] = core->entryValues[e];
+      for (size_t column = 0; column < 12; ++column)
+      {
+        int value;
+        if (column < 6)
+          value = dense[column];
+        else if (copies[column - 6] < 6)
+          value = ((column % 2) ? -1 : 1) * dense[copies[column - 6]];
+        else
+          value = (row == column - 6) ? 1 : 0;
+        if ((int) column == flipped && value && row == 0)
+          value = -value;
+        ss << value << " ";
+      }
+    }
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &core) );
+    CMR_CHRMAT* matrix = NULL;
+    ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, ss.str().c_str()) );
+
+    bool expectedIsTU;
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &expectedIsTU, NULL, NULL, &params, NULL, DBL_MAX) );
+
+    bool isTU;
+    CMR_SUBMAT* submatrix = NULL;
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, &submatrix, &directParams, NULL, DBL_MAX) );
+    ASSERT_EQ( isTU, expectedIsTU );
+    if (!isTU)
+    {
+      ASSERT_TRUE( submatrix );
+      CMR_CHRMAT* violator = NULL;
+      ASSERT_CMR_CALL( CMRchrmatZoomSubmat(cmr, matrix, submatrix, &violator) );
+      bool violatorIsTU;
+      ASSERT_CMR_CALL( CMRtuTest(cmr, violator, &violatorIsTU, NULL, NULL, &params, NULL, DBL_MAX) );
+      ASSERT_FALSE( violatorIsTU );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &violator) );
+      ASSERT_CMR_CALL( CMRsubmatFree(cmr, &submatrix) );
+    }
+
+    CMR_MATROID_DEC* dec = NULL;
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, &dec, NULL, &directParams, NULL, DBL_MAX) );
+    ASSERT_EQ( isTU, expectedIsTU );
+    ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(TU, ConsecutiveOnes)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_TU_PARAMS params;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&params) );
+  params.directConsecutiveOnes = true;
+
+  /* Columns 3, 0, 2, 4, 1 make the ones of each row consecutive. */
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "4 5 "
+    "1 0 1 0 0 "
+    "0 1 0 0 1 "
+    "1 0 0 1 0 "
+    "0 0 1 0 1 "
+  ) );
+  bool isTU;
+  CMR_TU_STATS stats;
+  ASSERT_CMR_CALL( CMRtuStatsInit(&stats) );
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, NULL, &params, &stats, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  ASSERT_EQ( stats.decomposition.totalCount, 1UL );
+  ASSERT_EQ( stats.decomposition.seriesParallel.totalCount, 0UL );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  /* Only the rows can be ordered such that the ones of each column are consecutive. */
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "3 4 "
+    "1 1 0 0 "
+    "1 0 1 0 "
+    "1 0 0 1 "
+  ) );
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  /* The Fano matrix has the property neither for rows nor for columns, so the decomposition decides. */
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "3 4 "
+    "1 1 0 1 "
+    "1 0 1 1 "
+    "0 1 1 1 "
+  ) );
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, NULL, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_FALSE( isTU );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
 TEST(TU, Fano)
 {
   CMR* cmr = NULL;
@@ -1528,6 +2061,254 @@ TEST(TU, CompleteTree)
   ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
 }
 
+TEST(TU, Batch)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* Random ternary 6x6 matrices. */
+  const size_t numMatrices = 64;
+  CMR_CHRMAT* matrices[numMatrices];
+  bool expectedIsTU[numMatrices];
+  srand(1);
+  for (size_t m = 0; m < numMatrices; ++m)
+  {
+    matrices[m] = NULL;
+    ASSERT_CMR_CALL( CMRchrmatCreate(cmr, &matrices[m], 6, 6, 36) );
+    CMR_CHRMAT* matrix = matrices[m];
+    matrix->numNonzeros = 0;
+    for (size_t row = 0; row < matrix->numRows; ++row)
+    {
+      matrix->rowSlice[row] = matrix->numNonzeros;
+      for (size_t column = 0; column < matrix->numColumns; ++column)
+      {
+        int r = rand() % 6;
+        if (r < 2)
+        {
+          matrix->entryColumns[matrix->numNonzeros] = column;
+          matrix->entryValues[matrix->numNonzeros] = r == 0 ? 1 : -1;
+          matrix->numNonzeros++;
+        }
+      }
+    }
+    matrix->rowSlice[matrix->numRows] = matrix->numNonzeros;
+
+    ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &expectedIsTU[m], NULL, NULL, NULL, NULL, DBL_MAX) );
+  }
+
+  for (int numThreads = 1; numThreads <= 8; numThreads *= 2)
+  {
+    /* With 8 threads, the workers are bound to processors. */
+    ASSERT_CMR_CALL( CMRsetNumThreads(cmr, numThreads) );
+    ASSERT_CMR_CALL( CMRsetThreadPinning(cmr, numThreads == 8) );
+
+    bool isTU[numMatrices];
+    CMR_TU_STATS stats[numMatrices];
+    for (size_t m = 0; m < numMatrices; ++m)
+      ASSERT_CMR_CALL( CMRtuStatsInit(&stats[m]) );
+    ASSERT_CMR_CALL( CMRtuTestBatch(cmr, numMatrices, matrices, isTU, NULL, stats, DBL_MAX) );
+
+    for (size_t m = 0; m < numMatrices; ++m)
+    {
+      ASSERT_EQ( isTU[m], expectedIsTU[m] );
+      if (CMRchrmatIsTernary(cmr, matrices[m], NULL))
+      {
+        ASSERT_GT( stats[m].decomposition.totalCount, 0UL );
+      }
+    }
+  }
+
+  for (size_t m = 0; m < numMatrices; ++m)
+    ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrices[m]) );
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(TU, ConstructGraph)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  /* An interval matrix, which is a network matrix whose digraph is only constructed on request. */
+  CMR_CHRMAT* matrix = NULL;
+  ASSERT_CMR_CALL( stringToCharMatrix(cmr, &matrix, "4 4 "
+    "1 0 1 0 "
+    "1 1 1 0 "
+    "0 1 1 1 "
+    "0 0 0 1 "
+  ) );
+
+  CMR_TU_PARAMS params;
+  ASSERT_CMR_CALL( CMRtuParamsInit(&params) );
+  params.regular.graphs = CMR_DEC_CONSTRUCT_NONE;
+  bool isTU;
+  CMR_MATROID_DEC* dec = NULL;
+  ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &isTU, &dec, NULL, &params, NULL, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  ASSERT_TRUE( dec );
+  ASSERT_GT( CMRmatroiddecGraphicness(dec), 0 );
+  ASSERT_FALSE( CMRmatroiddecGraph(dec) );
+
+  ASSERT_CMR_CALL( CMRmatroiddecConstructGraph(cmr, dec) );
+  ASSERT_TRUE( CMRmatroiddecGraph(dec) );
+  ASSERT_TRUE( CMRmatroiddecGraphArcsReversed(dec) );
+  bool isVerified;
+  ASSERT_CMR_CALL( CMRgraphicVerifyMatrix(cmr, CMRmatroiddecGetMatrix(dec), CMRmatroiddecGraph(dec),
+    CMRmatroiddecGraphForest(dec), CMRmatroiddecGraphCoforest(dec), &isVerified) );
+  ASSERT_TRUE( isVerified );
+
+  ASSERT_CMR_CALL( CMRmatroiddecFree(cmr, &dec) );
+  ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+/**
+ * \brief Creates the matrix whose columns are given by their rows and values.
+ */
+
+static
+CMR_ERROR createColumnsMatrix(CMR* cmr, size_t numRows, const std::vector<std::vector<size_t>>& columnsRows,
+  const std::vector<std::vector<char>>& columnsValues, CMR_CHRMAT** pmatrix)
+{
+  CMR_CHRMAT* transpose = NULL;
+  size_t numNonzeros = 0;
+  for (const std::vector<size_t>& rows : columnsRows)
+    numNonzeros += rows.size();
+  CMR_CALL( CMRchrmatCreate(cmr, &transpose, columnsRows.size(), numRows, numNonzeros) );
+  transpose->numNonzeros = 0;
+  for (size_t column = 0; column < columnsRows.size(); ++column)
+  {
+    transpose->rowSlice[column] = transpose->numNonzeros;
+    std::vector<std::pair<size_t, char>> entries;
+    for (size_t e = 0; e < columnsRows[column].size(); ++e)
+      entries.push_back(std::make_pair(columnsRows[column][e], columnsValues[column][e]));
+    std::sort(entries.begin(), entries.end());
+    for (const std::pair<size_t, char>& entry : entries)
+    {
+      transpose->entryColumns[transpose->numNonzeros] = entry.first;
+      transpose->entryValues[transpose->numNonzeros] = entry.second;
+      transpose->numNonzeros++;
+    }
+  }
+  transpose->rowSlice[columnsRows.size()] = transpose->numNonzeros;
+  CMR_CALL( CMRchrmatTranspose(cmr, transpose, pmatrix) );
+  CMR_CALL( CMRchrmatFree(cmr, &transpose) );
+
+  return CMR_OKAY;
+}
+
+TEST(TU, OnlineComponents)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  CMR_TU_ONLINE* online = NULL;
+  ASSERT_CMR_CALL( CMRtuOnlineCreate(cmr, &online, 6, NULL) );
+  bool isTU;
+
+  /* Two components on rows 0-2 and 3-5. */
+  size_t rows[3] = { 0, 1, 2 };
+  char values[3] = { 1, 1, 1 };
+  ASSERT_CMR_CALL( CMRtuOnlineAddColumn(online, 2, &rows[0], values, &isTU, NULL, DBL_MAX) );
+  ASSERT_CMR_CALL( CMRtuOnlineAddColumn(online, 2, &rows[1], values, &isTU, NULL, DBL_MAX) );
+  rows[0] = 3; rows[1] = 4; rows[2] = 5;
+  ASSERT_CMR_CALL( CMRtuOnlineAddColumn(online, 3, rows, values, &isTU, NULL, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  ASSERT_EQ( CMRtuOnlineNumComponents(online), 2UL );
+
+  /* Closing the odd cycle on rows 0, 1 and 2 yields determinant 2 in the first component only. */
+  CMR_TU_STATS stats;
+  ASSERT_CMR_CALL( CMRtuStatsInit(&stats) );
+  rows[0] = 0; rows[1] = 2;
+  ASSERT_CMR_CALL( CMRtuOnlineAddColumn(online, 2, rows, values, &isTU, &stats, DBL_MAX) );
+  ASSERT_FALSE( isTU );
+  ASSERT_EQ( stats.decomposition.totalCount, 1UL );
+  ASSERT_EQ( CMRtuOnlineNumComponents(online), 2UL );
+
+  /* An entry with the wrong sign repairs it. */
+  ASSERT_CMR_CALL( CMRtuOnlineRemoveColumn(online, 3, &isTU, NULL, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  values[1] = -1;
+  ASSERT_CMR_CALL( CMRtuOnlineAddColumn(online, 2, rows, values, &isTU, NULL, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  ASSERT_EQ( CMRtuOnlineNumColumns(online), 4UL );
+
+  /* Linking both components merges them, and removing the link splits them again. */
+  rows[0] = 2; rows[1] = 3;
+  ASSERT_CMR_CALL( CMRtuOnlineAddColumn(online, 2, rows, values, &isTU, NULL, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  ASSERT_EQ( CMRtuOnlineNumComponents(online), 1UL );
+  ASSERT_CMR_CALL( CMRtuOnlineRemoveColumn(online, 4, &isTU, NULL, DBL_MAX) );
+  ASSERT_TRUE( isTU );
+  ASSERT_EQ( CMRtuOnlineNumComponents(online), 2UL );
+
+  /* Duplicate rows and non-ternary values are rejected. */
+  rows[1] = 2;
+  ASSERT_EQ( CMRtuOnlineAddColumn(online, 2, rows, values, &isTU, NULL, DBL_MAX), CMR_ERROR_INPUT );
+  values[0] = 2;
+  ASSERT_EQ( CMRtuOnlineAddColumn(online, 1, rows, values, &isTU, NULL, DBL_MAX), CMR_ERROR_INPUT );
+  ASSERT_EQ( CMRtuOnlineNumColumns(online), 4UL );
+
+  ASSERT_CMR_CALL( CMRtuOnlineFree(cmr, &online) );
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
+
+TEST(TU, OnlineRandom)
+{
+  CMR* cmr = NULL;
+  ASSERT_CMR_CALL( CMRcreateEnvironment(&cmr) );
+
+  srand(5);
+  for (size_t r = 0; r < 40; ++r)
+  {
+    size_t numRows = 2 + rand() % 10;
+    CMR_TU_ONLINE* online = NULL;
+    ASSERT_CMR_CALL( CMRtuOnlineCreate(cmr, &online, numRows, NULL) );
+
+    std::vector<std::vector<size_t>> columnsRows;
+    std::vector<std::vector<char>> columnsValues;
+    for (size_t step = 0; step < 60; ++step)
+    {
+      bool isTU;
+      if (!columnsRows.empty() && rand() % 3 == 0)
+      {
+        size_t column = rand() % columnsRows.size();
+        columnsRows.erase(columnsRows.begin() + column);
+        columnsValues.erase(columnsValues.begin() + column);
+        ASSERT_CMR_CALL( CMRtuOnlineRemoveColumn(online, column, &isTU, NULL, DBL_MAX) );
+      }
+      else
+      {
+        std::vector<size_t> rows;
+        std::vector<char> values;
+        for (size_t row = 0; row < numRows; ++row)
+        {
+          if (rand() % 4 == 0)
+          {
+            rows.push_back(row);
+            values.push_back(rand() % 4 ? 1 : -1);
+          }
+        }
+        columnsRows.push_back(rows);
+        columnsValues.push_back(values);
+        ASSERT_CMR_CALL( CMRtuOnlineAddColumn(online, rows.size(), rows.empty() ? NULL : &rows[0],
+          values.empty() ? NULL : &values[0], &isTU, NULL, DBL_MAX) );
+      }
+      ASSERT_EQ( CMRtuOnlineNumColumns(online), columnsRows.size() );
+
+      CMR_CHRMAT* matrix = NULL;
+      ASSERT_CMR_CALL( createColumnsMatrix(cmr, numRows, columnsRows, columnsValues, &matrix) );
+      bool referenceIsTU;
+      ASSERT_CMR_CALL( CMRtuTest(cmr, matrix, &referenceIsTU, NULL, NULL, NULL, NULL, DBL_MAX) );
+      ASSERT_EQ( isTU, referenceIsTU );
+      ASSERT_CMR_CALL( CMRchrmatFree(cmr, &matrix) );
+    }
+
+    ASSERT_CMR_CALL( CMRtuOnlineFree(cmr, &online) );
+  }
+
+  ASSERT_CMR_CALL( CMRfreeEnvironment(&cmr) );
+}
 
 #if defined(MASSIVE_RANDOM)
 